@@ -0,0 +1,420 @@
+/******************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ *
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************/
+
+/*
+ * Benchmarks of the request and notification paths against a loopback server.
+ *
+ *   dispatch  sendRequest() of a single node read until resp_msg_cb
+ *   read      group read of groupSize nodes
+ *   write     group write of groupSize nodes
+ *   browse    browse of the folder of nodeCount variable nodes
+ *   notify    reports of a subscription of groupSize nodes which change without pause
+ *
+ * Each request benchmark runs a latency pass with one request in flight and a throughput pass
+ * with a window of requests in flight. The runs are repeatable: the counts are fixed by the
+ * options and the address space is generated the same way every time.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <inttypes.h>
+
+#include "bench_util.h"
+#include "edge_malloc.h"
+
+#define DEFAULT_ITERATIONS (2000)
+#define DEFAULT_WARMUP (200)
+#define DEFAULT_NODE_COUNT (1000)
+#define DEFAULT_GROUP_SIZE (100)
+#define DEFAULT_WINDOW (16)
+#define DEFAULT_NOTIFY_SECONDS (5)
+#define DEFAULT_PORT (12687)
+
+/* A browse returns nodeCount results, so it runs fewer times */
+#define BROWSE_ITERATION_DIVISOR (10)
+/* Intervals of the notify subscription in milliseconds */
+#define NOTIFY_SAMPLING_INTERVAL (10.0)
+#define NOTIFY_PUBLISHING_INTERVAL (10.0)
+#define NOTIFY_QUEUE_SIZE (50)
+#define NOTIFY_WARMUP_MS (1000)
+
+typedef struct BenchCase
+{
+    const char *name;
+    bool (*run)(const BenchOptions *options);
+} BenchCase;
+
+static EdgeMessage *createReadMessage(size_t count)
+{
+    EdgeMessage *msg = createEdgeAttributeMessage(benchEndpointUri(), count, CMD_READ);
+    if (NULL == msg)
+    {
+        return NULL;
+    }
+    char name[BENCH_NODE_NAME_SIZE];
+    for (size_t i = 0; i < count; i++)
+    {
+        benchRequestNodeName(i, name);
+        if (STATUS_OK != insertReadAccessNode(&msg, name).code)
+        {
+            destroyEdgeMessage(msg);
+            return NULL;
+        }
+    }
+    return msg;
+}
+
+static EdgeMessage *createWriteMessage(size_t count)
+{
+    EdgeMessage *msg = createEdgeAttributeMessage(benchEndpointUri(), count, CMD_WRITE);
+    if (NULL == msg)
+    {
+        return NULL;
+    }
+    char name[BENCH_NODE_NAME_SIZE];
+    for (size_t i = 0; i < count; i++)
+    {
+        /* The message owns the value */
+        double *value = (double *) EdgeMalloc(sizeof(double));
+        if (NULL == value)
+        {
+            destroyEdgeMessage(msg);
+            return NULL;
+        }
+        *value = (double) i + 0.5;
+        benchRequestNodeName(i, name);
+        if (STATUS_OK != insertWriteAccessNode(&msg, name, value, 1).code)
+        {
+            EdgeFree(value);
+            destroyEdgeMessage(msg);
+            return NULL;
+        }
+    }
+    return msg;
+}
+
+static EdgeMessage *createBrowseMessage(size_t nodeCount)
+{
+    EdgeMessage *msg = createEdgeMessage(benchEndpointUri(), 1, CMD_BROWSE);
+    if (NULL == msg)
+    {
+        return NULL;
+    }
+    EdgeNodeInfo *nodeInfo = createEdgeNodeInfo("{2;S;v=0}" BENCH_FOLDER);
+    EdgeBrowseParameter param;
+    memset(&param, 0, sizeof(EdgeBrowseParameter));
+    param.direction = DIRECTION_FORWARD;
+    param.maxDepth = 1;
+    param.nodeClassMask = EDGE_NODECLASS_VARIABLE;
+    param.maxResults = nodeCount;
+    param.resultCallback = benchBrowseResult;
+    if (NULL == nodeInfo || STATUS_OK != insertBrowseParameter(&msg, nodeInfo, param).code)
+    {
+        destroyEdgeMessage(msg);
+        return NULL;
+    }
+    return msg;
+}
+
+/* Sends msg and waits for its responses, one after the other */
+static bool sendSequential(EdgeMessage *msg, size_t count, size_t responsesPerRequest,
+        uint64_t *samplesUs)
+{
+    benchResetCounters();
+    for (size_t i = 0; i < count; i++)
+    {
+        uint64_t start = benchNowUs();
+        if (STATUS_OK != sendRequest(msg).code
+                || !benchWaitResponses((i + 1) * responsesPerRequest))
+        {
+            return false;
+        }
+        if (samplesUs)
+        {
+            samplesUs[i] = benchNowUs() - start;
+        }
+    }
+    return true;
+}
+
+/* Sends msg count times with up to window requests in flight, returns the elapsed time */
+static bool sendWindowed(EdgeMessage *msg, size_t count, size_t responsesPerRequest,
+        size_t window, uint64_t *elapsedUs)
+{
+    benchResetCounters();
+    uint64_t start = benchNowUs();
+    for (size_t sent = 0; sent < count; sent++)
+    {
+        if (sent >= window && !benchWaitResponses((sent - window + 1) * responsesPerRequest))
+        {
+            return false;
+        }
+        if (STATUS_OK != sendRequest(msg).code)
+        {
+            return false;
+        }
+    }
+    if (!benchWaitResponses(count * responsesPerRequest))
+    {
+        return false;
+    }
+    *elapsedUs = benchNowUs() - start;
+    return true;
+}
+
+static bool runRequests(const char *name, EdgeMessage *msg, size_t iterations,
+        size_t responsesPerRequest, const BenchOptions *options)
+{
+    if (NULL == msg)
+    {
+        printf("bench: %s: creating the request failed\n", name);
+        return false;
+    }
+    bool ok = false;
+    uint64_t *samplesUs = (uint64_t *) EdgeCalloc(iterations, sizeof(uint64_t));
+    if (NULL == samplesUs)
+    {
+        goto EXIT;
+    }
+
+    if (!sendSequential(msg, options->warmup, responsesPerRequest, NULL)
+            || !sendSequential(msg, iterations, responsesPerRequest, samplesUs))
+    {
+        printf("bench: %s: no response within %d ms\n", name, BENCH_RESPONSE_TIMEOUT_MS);
+        goto EXIT;
+    }
+    uint64_t errors = benchErrorCount();
+    uint64_t elapsedUs = 0;
+    BenchStats stats;
+    benchComputeStats(samplesUs, iterations, &stats);
+    benchPrintResult(name, &stats, 0, 0);
+
+    char windowName[64];
+    snprintf(windowName, sizeof(windowName), "%s/window=%zu", name, options->window);
+    if (!sendWindowed(msg, iterations, responsesPerRequest, options->window, &elapsedUs))
+    {
+        printf("bench: %s: no response within %d ms\n", windowName, BENCH_RESPONSE_TIMEOUT_MS);
+        goto EXIT;
+    }
+    errors += benchErrorCount();
+    double seconds = (elapsedUs > 0) ? elapsedUs / 1e6 : 1e-6;
+    benchPrintResult(windowName, NULL, iterations / seconds, benchValueCount() / seconds);
+    if (errors > 0)
+    {
+        printf("bench: %s: %" PRIu64 " error responses\n", name, errors);
+    }
+    ok = (0 == errors);
+
+EXIT:
+    EdgeFree(samplesUs);
+    destroyEdgeMessage(msg);
+    return ok;
+}
+
+static bool runDispatch(const BenchOptions *options)
+{
+    return runRequests("dispatch", createReadMessage(1), options->iterations, 1, options);
+}
+
+static bool runRead(const BenchOptions *options)
+{
+    char name[64];
+    snprintf(name, sizeof(name), "read/group=%zu", options->groupSize);
+    return runRequests(name, createReadMessage(options->groupSize), options->iterations, 1,
+            options);
+}
+
+static bool runWrite(const BenchOptions *options)
+{
+    char name[64];
+    snprintf(name, sizeof(name), "write/group=%zu", options->groupSize);
+    return runRequests(name, createWriteMessage(options->groupSize), options->iterations, 1,
+            options);
+}
+
+static bool runBrowse(const BenchOptions *options)
+{
+    char name[64];
+    snprintf(name, sizeof(name), "browse/nodes=%zu", options->nodeCount);
+    size_t iterations = options->iterations / BROWSE_ITERATION_DIVISOR;
+    return runRequests(name, createBrowseMessage(options->nodeCount),
+            (iterations > 0) ? iterations : 1, options->nodeCount, options);
+}
+
+static bool runNotify(const BenchOptions *options)
+{
+    char name[BENCH_NODE_NAME_SIZE];
+    benchRequestNodeName(0, name);
+    EdgeMessage *msg = createEdgeSubMessage(benchEndpointUri(), name, options->groupSize,
+            Edge_Create_Sub);
+    if (NULL == msg)
+    {
+        printf("bench: notify: creating the request failed\n");
+        return false;
+    }
+    for (size_t i = 0; i < options->groupSize; i++)
+    {
+        benchRequestNodeName(i, name);
+        insertSubParameter(&msg, name, Edge_Create_Sub, NOTIFY_SAMPLING_INTERVAL,
+                NOTIFY_PUBLISHING_INTERVAL, 1, 10000, 0, true, 0, NOTIFY_QUEUE_SIZE);
+    }
+    EdgeResult result = sendRequest(msg);
+    destroyEdgeMessage(msg);
+    if (STATUS_OK != result.code || !benchStartUpdater(options->groupSize))
+    {
+        printf("bench: notify: starting the subscription failed\n");
+        return false;
+    }
+
+    benchSleepMs(NOTIFY_WARMUP_MS);
+    benchCountReports(true);
+    uint64_t start = benchNowUs();
+    benchSleepMs(options->notifySeconds * 1000);
+    uint64_t reports = 0, values = 0;
+    benchReportCounts(&reports, &values);
+    double seconds = (benchNowUs() - start) / 1e6;
+    benchCountReports(false);
+    uint64_t updates = benchStopUpdater();
+
+    snprintf(name, sizeof(name), "notify/items=%zu", options->groupSize);
+    benchPrintResult(name, NULL, reports / seconds, values / seconds);
+    printf("bench: notify: %" PRIu64 " node updates written by the server\n", updates);
+    return reports > 0;
+}
+
+static const BenchCase cases[] =
+{
+    { "dispatch", runDispatch },
+    { "read", runRead },
+    { "write", runWrite },
+    { "browse", runBrowse },
+    /* Last, the subscription stays until the client disconnects */
+    { "notify", runNotify }
+};
+
+#define CASE_COUNT (sizeof(cases) / sizeof(cases[0]))
+
+static void usage(const char *program)
+{
+    printf("Usage: %s [options] [case...]\n", program);
+    printf("Cases: dispatch read write browse notify (default: all)\n");
+    printf("  -i <n>  measured iterations (default %d)\n", DEFAULT_ITERATIONS);
+    printf("  -w <n>  warm-up iterations (default %d)\n", DEFAULT_WARMUP);
+    printf("  -n <n>  variable nodes of the address space (default %d)\n", DEFAULT_NODE_COUNT);
+    printf("  -g <n>  nodes of a group read, write or subscription (default %d)\n",
+            DEFAULT_GROUP_SIZE);
+    printf("  -c <n>  requests in flight of the throughput runs (default %d)\n", DEFAULT_WINDOW);
+    printf("  -t <s>  seconds of the notify run (default %d)\n", DEFAULT_NOTIFY_SECONDS);
+    printf("  -p <n>  port of the loopback server (default %d)\n", DEFAULT_PORT);
+}
+
+static bool parseCount(const char *text, size_t *value)
+{
+    char *end = NULL;
+    unsigned long parsed = strtoul(text, &end, 10);
+    if (NULL == end || '\0' != *end || 0 == parsed)
+    {
+        return false;
+    }
+    *value = (size_t) parsed;
+    return true;
+}
+
+int main(int argc, char **argv)
+{
+    BenchOptions options;
+    options.iterations = DEFAULT_ITERATIONS;
+    options.warmup = DEFAULT_WARMUP;
+    options.nodeCount = DEFAULT_NODE_COUNT;
+    options.groupSize = DEFAULT_GROUP_SIZE;
+    options.window = DEFAULT_WINDOW;
+    options.notifySeconds = DEFAULT_NOTIFY_SECONDS;
+    options.port = DEFAULT_PORT;
+
+    bool selected[CASE_COUNT];
+    bool anySelected = false;
+    memset(selected, 0, sizeof(selected));
+
+    for (int i = 1; i < argc; i++)
+    {
+        const char *arg = argv[i];
+        if ('-' == arg[0] && '\0' != arg[1] && '\0' == arg[2])
+        {
+            size_t value = 0;
+            if (i + 1 >= argc || !parseCount(argv[++i], &value))
+            {
+                usage(argv[0]);
+                return 1;
+            }
+            switch (arg[1])
+            {
+                case 'i': options.iterations = value; break;
+                case 'w': options.warmup = value; break;
+                case 'n': options.nodeCount = value; break;
+                case 'g': options.groupSize = value; break;
+                case 'c': options.window = value; break;
+                case 't': options.notifySeconds = (unsigned int) value; break;
+                case 'p': options.port = (unsigned int) value; break;
+                default: usage(argv[0]); return 1;
+            }
+            continue;
+        }
+
+        size_t idx = 0;
+        while (idx < CASE_COUNT && 0 != strcmp(arg, cases[idx].name))
+        {
+            idx++;
+        }
+        if (idx == CASE_COUNT)
+        {
+            usage(argv[0]);
+            return 1;
+        }
+        selected[idx] = true;
+        anySelected = true;
+    }
+    if (options.groupSize > options.nodeCount)
+    {
+        options.groupSize = options.nodeCount;
+    }
+
+    printf("bench: iterations=%zu warmup=%zu nodes=%zu group=%zu window=%zu\n",
+            options.iterations, options.warmup, options.nodeCount, options.groupSize,
+            options.window);
+    if (!benchStart(&options))
+    {
+        benchStop();
+        return 1;
+    }
+
+    int failures = 0;
+    benchPrintHeader();
+    for (size_t idx = 0; idx < CASE_COUNT; idx++)
+    {
+        if ((!anySelected || selected[idx]) && !cases[idx].run(&options))
+        {
+            failures++;
+        }
+    }
+
+    benchStop();
+    return (failures > 0) ? 1 : 0;
+}
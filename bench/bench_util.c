@@ -0,0 +1,665 @@
+/******************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ *
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#ifndef _WIN32
+#include <pthread.h>
+#include <unistd.h>
+#else
+#include <windows.h>
+#include "pthread.h"
+#endif
+
+#include "bench_util.h"
+#include "edge_malloc.h"
+
+#define BENCH_HOST "localhost"
+#define BENCH_SERVER_NAME "edge-opc-bench"
+#define BENCH_APP_NAME "edge opcua bench"
+#define BENCH_APP_URI "urn:edge:opcua:bench"
+#define BENCH_PRODUCT_URI "urn:edge:opcua:bench:product"
+#define BENCH_ROOT_NODE "benchRootNode"
+#define BENCH_START_TIMEOUT_MS (10000)
+#define BENCH_ENDPOINT_URI_SIZE (512)
+
+static char endpointUri[BENCH_ENDPOINT_URI_SIZE];
+static EdgeEndPointInfo *serverInfo = NULL;
+static EdgeConfigure *config = NULL;
+
+static pthread_mutex_t benchMutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t benchCond = PTHREAD_COND_INITIALIZER;
+static bool serverStarted = false;
+static bool clientStarted = false;
+static bool clientRequested = false;
+static uint64_t responseCount = 0;
+static uint64_t errorCount = 0;
+static uint64_t valueCount = 0;
+static bool countReports = false;
+static uint64_t reportCount = 0;
+static uint64_t reportValueCount = 0;
+
+static pthread_t updaterThread;
+static volatile bool updaterRunning = false;
+static size_t updaterNodes = 0;
+static uint64_t updaterWrites = 0;
+
+uint64_t benchNowNs(void)
+{
+#ifndef _WIN32
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t) ts.tv_sec * 1000000000 + (uint64_t) ts.tv_nsec;
+#else
+    LARGE_INTEGER frequency, counter;
+    QueryPerformanceFrequency(&frequency);
+    QueryPerformanceCounter(&counter);
+    return (uint64_t) ((double) counter.QuadPart * 1e9 / frequency.QuadPart);
+#endif
+}
+
+uint64_t benchNowUs(void)
+{
+    return benchNowNs() / 1000;
+}
+
+void benchSleepMs(unsigned int ms)
+{
+#ifndef _WIN32
+    usleep(ms * 1000);
+#else
+    Sleep(ms);
+#endif
+}
+
+static int compareSamples(const void *a, const void *b)
+{
+    uint64_t left = *(const uint64_t *) a;
+    uint64_t right = *(const uint64_t *) b;
+    return (left > right) - (left < right);
+}
+
+/* Nearest rank percentile of sorted samples */
+static double percentile(const uint64_t *sorted, size_t count, unsigned int percent)
+{
+    size_t rank = (count * percent + 99) / 100;
+    return (double) sorted[(rank > 0) ? rank - 1 : 0];
+}
+
+void benchComputeStats(uint64_t *samples, size_t count, BenchStats *stats)
+{
+    memset(stats, 0, sizeof(BenchStats));
+    if (0 == count)
+    {
+        return;
+    }
+    qsort(samples, count, sizeof(uint64_t), compareSamples);
+
+    double sum = 0;
+    for (size_t i = 0; i < count; i++)
+    {
+        sum += samples[i];
+    }
+    stats->count = count;
+    stats->mean = sum / count;
+    stats->min = samples[0];
+    stats->p50 = percentile(samples, count, 50);
+    stats->p99 = percentile(samples, count, 99);
+    stats->max = samples[count - 1];
+}
+
+void benchPrintHeader(void)
+{
+    printf("%-24s %10s %10s %10s %10s %10s %10s %12s %12s\n", "benchmark", "count", "mean_us",
+            "min_us", "p50_us", "p99_us", "max_us", "ops/s", "values/s");
+}
+
+void benchPrintResult(const char *name, const BenchStats *stats, double opsPerSec,
+        double valuesPerSec)
+{
+    if (stats)
+    {
+        printf("%-24s %10zu %10.1f %10.1f %10.1f %10.1f %10.1f", name, stats->count,
+                stats->mean, stats->min, stats->p50, stats->p99, stats->max);
+    }
+    else
+    {
+        printf("%-24s %10s %10s %10s %10s %10s %10s", name, "-", "-", "-", "-", "-", "-");
+    }
+    printf(" %12.0f %12.0f\n", opsPerSec, valuesPerSec);
+    fflush(stdout);
+}
+
+void benchNodeName(size_t index, char *name)
+{
+    snprintf(name, BENCH_NODE_NAME_SIZE, BENCH_NODE_PREFIX "%zu", index);
+}
+
+void benchRequestNodeName(size_t index, char *name)
+{
+    /* The bench namespace is the first one created, index 2 */
+    snprintf(name, BENCH_NODE_NAME_SIZE, "{2;S;v=%d}" BENCH_NODE_PREFIX "%zu",
+            EDGE_NODEID_DOUBLE, index);
+}
+
+const char *benchEndpointUri(void)
+{
+    return endpointUri;
+}
+
+/* Absolute time for pthread_cond_timedwait() */
+static void deadlineAfterMs(struct timespec *deadline, unsigned int timeoutMs)
+{
+#ifndef _WIN32
+    clock_gettime(CLOCK_REALTIME, deadline);
+#else
+    timespec_get(deadline, TIME_UTC);
+#endif
+    deadline->tv_sec += timeoutMs / 1000;
+    deadline->tv_nsec += (long) (timeoutMs % 1000) * 1000000;
+    if (deadline->tv_nsec >= 1000000000)
+    {
+        deadline->tv_sec++;
+        deadline->tv_nsec -= 1000000000;
+    }
+}
+
+/* Waits until the flag is set or the timeout expires, benchMutex is held */
+static bool waitFlag(bool *flag, unsigned int timeoutMs)
+{
+    struct timespec deadline;
+    deadlineAfterMs(&deadline, timeoutMs);
+    while (!*flag)
+    {
+        if (0 != pthread_cond_timedwait(&benchCond, &benchMutex, &deadline))
+        {
+            return *flag;
+        }
+    }
+    return true;
+}
+
+static void setFlag(bool *flag)
+{
+    pthread_mutex_lock(&benchMutex);
+    *flag = true;
+    pthread_cond_broadcast(&benchCond);
+    pthread_mutex_unlock(&benchMutex);
+}
+
+static void countResponse(const EdgeMessage *data, bool error)
+{
+    pthread_mutex_lock(&benchMutex);
+    responseCount++;
+    if (error)
+    {
+        errorCount++;
+    }
+    else
+    {
+        valueCount += data->responseLength;
+    }
+    pthread_cond_broadcast(&benchCond);
+    pthread_mutex_unlock(&benchMutex);
+}
+
+static void response_msg_cb(EdgeMessage *data)
+{
+    countResponse(data, false);
+}
+
+static void error_msg_cb(EdgeMessage *data)
+{
+    countResponse(data, true);
+}
+
+static void monitored_msg_cb(EdgeMessage *data)
+{
+    pthread_mutex_lock(&benchMutex);
+    if (countReports)
+    {
+        reportCount++;
+        reportValueCount += data->responseLength;
+    }
+    pthread_mutex_unlock(&benchMutex);
+}
+
+static void browse_msg_cb(EdgeMessage *data)
+{
+    (void) data;
+}
+
+static void status_start_cb(EdgeEndPointInfo *epInfo, EdgeStatusCode status)
+{
+    (void) epInfo;
+    if (STATUS_SERVER_STARTED == status)
+    {
+        setFlag(&serverStarted);
+    }
+    else if (STATUS_CLIENT_STARTED == status)
+    {
+        setFlag(&clientStarted);
+    }
+}
+
+static void status_stop_cb(EdgeEndPointInfo *epInfo, EdgeStatusCode status)
+{
+    (void) epInfo;
+    (void) status;
+}
+
+static void status_network_cb(EdgeEndPointInfo *epInfo, EdgeStatusCode status)
+{
+    if (STATUS_DISCONNECTED == status)
+    {
+        printf("bench: disconnected from %s\n", epInfo->endpointUri);
+    }
+}
+
+static void startClient(EdgeDevice *device, EdgeEndPointInfo *endpoint)
+{
+    EdgeMessage *msg = createEdgeMessage(endpoint->endpointUri, 0, CMD_START_CLIENT);
+    if (NULL == msg)
+    {
+        return;
+    }
+    msg->endpointInfo->endpointConfig = (EdgeEndpointConfig *) EdgeCalloc(1,
+            sizeof(EdgeEndpointConfig));
+    if (NULL != msg->endpointInfo->endpointConfig)
+    {
+        msg->endpointInfo->endpointConfig->requestTimeout = 60000;
+        msg->endpointInfo->endpointConfig->serverName = copyString(BENCH_SERVER_NAME);
+        msg->endpointInfo->endpointConfig->bindAddress = copyString(device->address);
+        msg->endpointInfo->endpointConfig->bindPort = device->port;
+        msg->endpointInfo->securityPolicyUri = copyString(endpoint->securityPolicyUri);
+        sendRequest(msg);
+    }
+    destroyEdgeMessage(msg);
+}
+
+static void endpoint_found_cb(EdgeDevice *device)
+{
+    /* One session is enough, the first endpoint is taken */
+    if (NULL == device || device->num_endpoints < 1 || clientRequested)
+    {
+        return;
+    }
+    clientRequested = true;
+    startClient(device, device->endpointsInfo[0]);
+}
+
+static void device_found_cb(EdgeDevice *device)
+{
+    (void) device;
+}
+
+static bool configureCallbacks(void)
+{
+    config = (EdgeConfigure *) EdgeCalloc(1, sizeof(EdgeConfigure));
+    if (NULL == config)
+    {
+        return false;
+    }
+    config->recvCallback = (ReceivedMessageCallback *) EdgeCalloc(1,
+            sizeof(ReceivedMessageCallback));
+    config->statusCallback = (StatusCallback *) EdgeCalloc(1, sizeof(StatusCallback));
+    config->discoveryCallback = (DiscoveryCallback *) EdgeCalloc(1, sizeof(DiscoveryCallback));
+    if (NULL == config->recvCallback || NULL == config->statusCallback
+            || NULL == config->discoveryCallback)
+    {
+        return false;
+    }
+    config->recvCallback->resp_msg_cb = response_msg_cb;
+    config->recvCallback->monitored_msg_cb = monitored_msg_cb;
+    config->recvCallback->error_msg_cb = error_msg_cb;
+    config->recvCallback->browse_msg_cb = browse_msg_cb;
+    config->statusCallback->start_cb = status_start_cb;
+    config->statusCallback->stop_cb = status_stop_cb;
+    config->statusCallback->network_cb = status_network_cb;
+    config->discoveryCallback->endpoint_found_cb = endpoint_found_cb;
+    config->discoveryCallback->device_found_cb = device_found_cb;
+    config->supportedApplicationTypes = EDGE_APPLICATIONTYPE_SERVER;
+    configure(config);
+    return true;
+}
+
+static bool startServer(unsigned int port)
+{
+    serverInfo = (EdgeEndPointInfo *) EdgeCalloc(1, sizeof(EdgeEndPointInfo));
+    if (NULL == serverInfo)
+    {
+        return false;
+    }
+    serverInfo->endpointUri = endpointUri;
+    serverInfo->endpointConfig = (EdgeEndpointConfig *) EdgeCalloc(1, sizeof(EdgeEndpointConfig));
+    serverInfo->appConfig = (EdgeApplicationConfig *) EdgeCalloc(1, sizeof(EdgeApplicationConfig));
+    if (NULL == serverInfo->endpointConfig || NULL == serverInfo->appConfig)
+    {
+        return false;
+    }
+    serverInfo->endpointConfig->bindAddress = (char *) BENCH_HOST;
+    serverInfo->endpointConfig->bindPort = port;
+    serverInfo->endpointConfig->serverName = (char *) BENCH_SERVER_NAME;
+    serverInfo->appConfig->applicationName = (char *) BENCH_APP_NAME;
+    serverInfo->appConfig->applicationUri = (char *) BENCH_APP_URI;
+    serverInfo->appConfig->productUri = (char *) BENCH_PRODUCT_URI;
+    serverInfo->appConfig->applicationType = EDGE_APPLICATIONTYPE_SERVER;
+
+    EdgeResult ret = createServer(serverInfo);
+    if (STATUS_OK != ret.code)
+    {
+        printf("bench: createServer failed (%d)\n", ret.code);
+        return false;
+    }
+    pthread_mutex_lock(&benchMutex);
+    bool started = waitFlag(&serverStarted, BENCH_START_TIMEOUT_MS);
+    pthread_mutex_unlock(&benchMutex);
+    return started;
+}
+
+/* The address space is a folder of nodeCount Double variables, the value of node i is i */
+static bool createAddressSpace(size_t nodeCount)
+{
+    EdgeResult ret = createNamespace(BENCH_NAMESPACE, BENCH_ROOT_NODE, BENCH_ROOT_NODE,
+            BENCH_ROOT_NODE);
+    if (STATUS_OK != ret.code)
+    {
+        return false;
+    }
+
+    EdgeNodeId objectsFolder;
+    memset(&objectsFolder, 0, sizeof(EdgeNodeId));
+    EdgeNodeItem *item = createNodeItem(BENCH_FOLDER, OBJECT_NODE, &objectsFolder);
+    if (NULL == item)
+    {
+        return false;
+    }
+    ret = createNode(BENCH_NAMESPACE, item);
+    deleteNodeItem(item);
+    if (STATUS_OK != ret.code)
+    {
+        return false;
+    }
+
+    EdgeNodeId folder;
+    memset(&folder, 0, sizeof(EdgeNodeId));
+    folder.nodeId = (char *) BENCH_FOLDER;
+    char name[BENCH_NODE_NAME_SIZE];
+    for (size_t i = 0; i < nodeCount; i++)
+    {
+        double value = (double) i;
+        benchNodeName(i, name);
+        item = createVariableNodeItem(name, EDGE_NODEID_DOUBLE, &value, VARIABLE_NODE, 0);
+        if (NULL == item)
+        {
+            return false;
+        }
+        item->sourceNodeId = &folder;
+        ret = createNode(BENCH_NAMESPACE, item);
+        deleteNodeItem(item);
+        if (STATUS_OK != ret.code)
+        {
+            printf("bench: createNode of %s failed (%d)\n", name, ret.code);
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool connectClient(void)
+{
+    EdgeMessage *msg = createEdgeMessage(endpointUri, 1, CMD_GET_ENDPOINTS);
+    if (NULL == msg)
+    {
+        return false;
+    }
+    EdgeResult ret = getEndpointInfo(msg);
+    destroyEdgeMessage(msg);
+    if (STATUS_OK != ret.code)
+    {
+        printf("bench: getEndpointInfo failed (%d)\n", ret.code);
+        return false;
+    }
+    pthread_mutex_lock(&benchMutex);
+    bool started = waitFlag(&clientStarted, BENCH_START_TIMEOUT_MS);
+    pthread_mutex_unlock(&benchMutex);
+    return started;
+}
+
+bool benchStart(const BenchOptions *options)
+{
+    /* Log records of a debug build would be part of every measurement */
+    setLogLevel(EDGE_LOG_LEVEL_NONE);
+    snprintf(endpointUri, sizeof(endpointUri), "opc.tcp://%s:%u/%s", BENCH_HOST, options->port,
+            BENCH_SERVER_NAME);
+
+    if (!configureCallbacks())
+    {
+        printf("bench: out of memory\n");
+        return false;
+    }
+    if (!startServer(options->port))
+    {
+        printf("bench: the server did not start on port %u\n", options->port);
+        return false;
+    }
+    if (!createAddressSpace(options->nodeCount))
+    {
+        printf("bench: creating the address space failed\n");
+        return false;
+    }
+    if (!connectClient())
+    {
+        printf("bench: the client did not connect to %s\n", endpointUri);
+        return false;
+    }
+    return true;
+}
+
+void benchStop(void)
+{
+    if (clientStarted)
+    {
+        EdgeMessage *msg = createEdgeMessage(endpointUri, 1, CMD_STOP_CLIENT);
+        if (NULL != msg)
+        {
+            disconnectClient(msg->endpointInfo);
+            destroyEdgeMessage(msg);
+        }
+    }
+    if (serverInfo)
+    {
+        if (serverStarted)
+        {
+            closeServer(serverInfo);
+        }
+        EdgeFree(serverInfo->endpointConfig);
+        EdgeFree(serverInfo->appConfig);
+        EdgeFree(serverInfo);
+        serverInfo = NULL;
+    }
+    if (config)
+    {
+        EdgeFree(config->recvCallback);
+        EdgeFree(config->statusCallback);
+        EdgeFree(config->discoveryCallback);
+        EdgeFree(config);
+        config = NULL;
+    }
+}
+
+void benchResetCounters(void)
+{
+    pthread_mutex_lock(&benchMutex);
+    responseCount = 0;
+    errorCount = 0;
+    valueCount = 0;
+    pthread_mutex_unlock(&benchMutex);
+}
+
+bool benchWaitResponses(uint64_t responses)
+{
+    struct timespec deadline;
+    deadlineAfterMs(&deadline, BENCH_RESPONSE_TIMEOUT_MS);
+
+    bool arrived = true;
+    pthread_mutex_lock(&benchMutex);
+    while (responseCount < responses)
+    {
+        if (0 != pthread_cond_timedwait(&benchCond, &benchMutex, &deadline))
+        {
+            arrived = (responseCount >= responses);
+            break;
+        }
+    }
+    pthread_mutex_unlock(&benchMutex);
+    return arrived;
+}
+
+uint64_t benchResponseCount(void)
+{
+    pthread_mutex_lock(&benchMutex);
+    uint64_t count = responseCount;
+    pthread_mutex_unlock(&benchMutex);
+    return count;
+}
+
+uint64_t benchErrorCount(void)
+{
+    pthread_mutex_lock(&benchMutex);
+    uint64_t count = errorCount;
+    pthread_mutex_unlock(&benchMutex);
+    return count;
+}
+
+uint64_t benchValueCount(void)
+{
+    pthread_mutex_lock(&benchMutex);
+    uint64_t count = valueCount;
+    pthread_mutex_unlock(&benchMutex);
+    return count;
+}
+
+void benchCountReports(bool enable)
+{
+    pthread_mutex_lock(&benchMutex);
+    countReports = enable;
+    if (enable)
+    {
+        reportCount = 0;
+        reportValueCount = 0;
+    }
+    pthread_mutex_unlock(&benchMutex);
+}
+
+void benchReportCounts(uint64_t *reports, uint64_t *values)
+{
+    pthread_mutex_lock(&benchMutex);
+    *reports = reportCount;
+    *values = reportValueCount;
+    pthread_mutex_unlock(&benchMutex);
+}
+
+bool benchBrowseResult(EdgeMessage *result, void *context)
+{
+    (void) context;
+    countResponse(result, false);
+    return true;
+}
+
+static void *updaterLoop(void *arg)
+{
+    (void) arg;
+    const char **names = (const char **) EdgeCalloc(updaterNodes, sizeof(char *));
+    EdgeVersatility *values = (EdgeVersatility *) EdgeCalloc(updaterNodes,
+            sizeof(EdgeVersatility));
+    EdgeVersatility **valuePtrs = (EdgeVersatility **) EdgeCalloc(updaterNodes,
+            sizeof(EdgeVersatility *));
+    double *data = (double *) EdgeCalloc(updaterNodes, sizeof(double));
+    if (NULL == names || NULL == values || NULL == valuePtrs || NULL == data)
+    {
+        goto EXIT;
+    }
+    for (size_t i = 0; i < updaterNodes; i++)
+    {
+        char *name = (char *) EdgeMalloc(BENCH_NODE_NAME_SIZE);
+        if (NULL == name)
+        {
+            goto EXIT;
+        }
+        benchNodeName(i, name);
+        names[i] = name;
+        values[i].value = &data[i];
+        valuePtrs[i] = &values[i];
+    }
+
+    /* Every pass changes every node, so each sample of the server is a new value */
+    uint64_t pass = 0;
+    while (updaterRunning)
+    {
+        pass++;
+        for (size_t i = 0; i < updaterNodes; i++)
+        {
+            data[i] = (double) (pass * updaterNodes + i);
+        }
+        if (STATUS_OK == modifyVariableNodes(BENCH_NAMESPACE, names, valuePtrs,
+                updaterNodes).code)
+        {
+            updaterWrites += updaterNodes;
+        }
+    }
+
+EXIT:
+    if (names)
+    {
+        for (size_t i = 0; i < updaterNodes; i++)
+        {
+            EdgeFree((char *) names[i]);
+        }
+    }
+    EdgeFree(names);
+    EdgeFree(values);
+    EdgeFree(valuePtrs);
+    EdgeFree(data);
+    return NULL;
+}
+
+bool benchStartUpdater(size_t count)
+{
+    updaterNodes = count;
+    updaterWrites = 0;
+    updaterRunning = true;
+    if (0 != pthread_create(&updaterThread, NULL, updaterLoop, NULL))
+    {
+        updaterRunning = false;
+        return false;
+    }
+    return true;
+}
+
+uint64_t benchStopUpdater(void)
+{
+    updaterRunning = false;
+    pthread_join(updaterThread, NULL);
+    return updaterWrites;
+}
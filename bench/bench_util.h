@@ -0,0 +1,202 @@
+/******************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ *
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************/
+
+/**
+ * @file
+ *
+ * @brief This file contains the timing, statistics and loopback setup shared by the benchmarks.
+ *
+ * The benchmarks run a server and a client of the library in one process, connected over
+ * the loopback interface. Requests are sent with sendRequest() and are complete when their
+ * response reaches the application callback, so the dispatcher queues are part of each
+ * measurement.
+ */
+
+#ifndef EDGE_OPCUA_BENCH_UTIL_H_
+#define EDGE_OPCUA_BENCH_UTIL_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "opcua_manager.h"
+#include "opcua_common.h"
+
+/* Namespace of the synthetic address space */
+#define BENCH_NAMESPACE "bench-namespace"
+/* Object node which holds the variable nodes of the address space */
+#define BENCH_FOLDER "BenchFolder"
+/* Browse name of variable node i is BENCH_NODE_PREFIX followed by i */
+#define BENCH_NODE_PREFIX "Bench_"
+#define BENCH_NODE_NAME_SIZE (64)
+
+/* Time after which a response which did not arrive fails the benchmark */
+#define BENCH_RESPONSE_TIMEOUT_MS (10000)
+
+typedef struct BenchOptions
+{
+    /* Measured iterations of each benchmark */
+    size_t iterations;
+    /* Iterations run before the measurement, they are not recorded */
+    size_t warmup;
+    /* Variable nodes of the synthetic address space */
+    size_t nodeCount;
+    /* Nodes of a group read or write, at most nodeCount */
+    size_t groupSize;
+    /* Requests in flight in the throughput runs */
+    size_t window;
+    /* Seconds over which the notifications are counted */
+    unsigned int notifySeconds;
+    /* Port of the loopback server */
+    unsigned int port;
+} BenchOptions;
+
+/* Statistics of samples, in the unit of the samples */
+typedef struct BenchStats
+{
+    size_t count;
+    double mean;
+    double min;
+    double p50;
+    double p99;
+    double max;
+} BenchStats;
+
+/**
+ * @brief Monotonic time in microseconds.
+ */
+uint64_t benchNowUs(void);
+
+/**
+ * @brief Monotonic time in nanoseconds.
+ */
+uint64_t benchNowNs(void);
+
+/**
+ * @brief Sleeps for a number of milliseconds.
+ */
+void benchSleepMs(unsigned int ms);
+
+/**
+ * @brief Computes the statistics of samples, the samples are sorted.
+ * @param[in,out]  samples Samples such as latencies in microseconds.
+ * @param[in]  count Number of samples.
+ * @param[out]  stats Statistics.
+ */
+void benchComputeStats(uint64_t *samples, size_t count, BenchStats *stats);
+
+/**
+ * @brief Prints the header of the result table.
+ */
+void benchPrintHeader(void);
+
+/**
+ * @brief Prints one result line.
+ * @param[in]  name Benchmark name.
+ * @param[in]  stats Latency statistics, NULL for a throughput run.
+ * @param[in]  opsPerSec Requests or notifications per second, 0 if not measured.
+ * @param[in]  valuesPerSec Node values per second, 0 if not measured.
+ */
+void benchPrintResult(const char *name, const BenchStats *stats, double opsPerSec,
+        double valuesPerSec);
+
+/**
+ * @brief Formats the browse name of variable node index.
+ */
+void benchNodeName(size_t index, char *name);
+
+/**
+ * @brief Formats the node name of variable node index as used in requests.
+ */
+void benchRequestNodeName(size_t index, char *name);
+
+/**
+ * @brief Configures the callbacks, starts the loopback server with the synthetic address space
+ *        and connects the client to it.
+ * @param[in]  options Benchmark options.
+ * @return @c true when the client is connected.
+ */
+bool benchStart(const BenchOptions *options);
+
+/**
+ * @brief Disconnects the client and closes the server.
+ */
+void benchStop(void);
+
+/**
+ * @brief Endpoint uri of the loopback server.
+ */
+const char *benchEndpointUri(void);
+
+/**
+ * @brief Resets the response counters before a run.
+ */
+void benchResetCounters(void);
+
+/**
+ * @brief Waits until a number of responses were received since benchResetCounters().
+ * @param[in]  responses Responses to wait for.
+ * @return @c false if they did not arrive within BENCH_RESPONSE_TIMEOUT_MS.
+ */
+bool benchWaitResponses(uint64_t responses);
+
+/**
+ * @brief Responses received since benchResetCounters(), error responses included.
+ */
+uint64_t benchResponseCount(void);
+
+/**
+ * @brief Error responses received since benchResetCounters().
+ */
+uint64_t benchErrorCount(void);
+
+/**
+ * @brief Node values received in responses since benchResetCounters().
+ */
+uint64_t benchValueCount(void);
+
+/**
+ * @brief Enables or disables counting of the reports of subscriptions.
+ */
+void benchCountReports(bool enable);
+
+/**
+ * @brief Reports and their node values counted since benchCountReports() was enabled.
+ */
+void benchReportCounts(uint64_t *reports, uint64_t *values);
+
+/**
+ * @brief Browse result callback which counts the results, its context is ignored.
+ */
+bool benchBrowseResult(EdgeMessage *result, void *context);
+
+/**
+ * @brief Starts a thread which writes new values to the first count nodes without pause.
+ * @return @c false if the thread could not be started.
+ */
+bool benchStartUpdater(size_t count);
+
+/**
+ * @brief Stops the updater thread.
+ * @return Value updates written by the thread.
+ */
+uint64_t benchStopUpdater(void);
+
+#endif /* EDGE_OPCUA_BENCH_UTIL_H_ */
@@ -0,0 +1,957 @@
+/******************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ *
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************/
+
+/*
+ * Subscription load generator for soak tests, Linux only.
+ *
+ *   opcua-loadgen server [-p port] [-n nodes] [-r rate] [-i interval] [-d duration]
+ *     Serves nodes Double variables and writes all of them rate times per second. The value
+ *     of a node is the wall clock time of its update in microseconds.
+ *
+ *   opcua-loadgen client -e endpointUri [-n nodes] [-m items] [-k sessions] [-s sampling]
+ *                        [-q queueSize] [-i interval] [-d duration]
+ *     Subscribes items monitored items split over sessions. Each session is a process of its
+ *     own, since the subscriptions of a client share its first session. The latency of a
+ *     notification is the time from the update of the value on the server to the report
+ *     callback, so the clocks of two hosts must be synchronized.
+ *
+ * Both print one line per interval with the rates, latency percentiles, CPU usage and resident
+ * memory, and a summary at the end. A duration of 0 runs until SIGINT.
+ */
+
+#include <errno.h>
+#include <inttypes.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <sys/time.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+
+#include "bench_util.h"
+#include "edge_malloc.h"
+
+#define LOAD_NAMESPACE "load-namespace"
+#define LOAD_ROOT_NODE "loadRootNode"
+#define LOAD_NODE_PREFIX "Load_"
+#define LOAD_SERVER_NAME "edge-opc-load"
+#define LOAD_MAX_SESSIONS (256)
+#define LOAD_START_TIMEOUT_MS (10000)
+
+#define DEFAULT_PORT (12686)
+#define DEFAULT_NODES (1000)
+#define DEFAULT_RATE (10)
+#define DEFAULT_ITEMS (1000)
+#define DEFAULT_SESSIONS (1)
+#define DEFAULT_SAMPLING_MS (100)
+#define DEFAULT_QUEUE_SIZE (10)
+#define DEFAULT_INTERVAL_S (5)
+
+/* Latency histogram, 8 buckets per power of two of microseconds */
+#define LATENCY_BUCKETS (256)
+
+typedef struct LoadOptions
+{
+    unsigned int port;
+    size_t nodes;
+    unsigned int rate;
+    const char *endpointUri;
+    size_t items;
+    size_t sessions;
+    unsigned int samplingMs;
+    unsigned int queueSize;
+    unsigned int intervalS;
+    unsigned int durationS;
+} LoadOptions;
+
+/* Statistics of one session over one interval, sent from the session process to the parent */
+typedef struct LoadRecord
+{
+    uint32_t connected;
+    uint32_t skewed;
+    uint64_t reports;
+    uint64_t values;
+    uint64_t maxLatencyUs;
+    uint32_t histogram[LATENCY_BUCKETS];
+} LoadRecord;
+
+typedef struct ProcessUsage
+{
+    uint64_t cpuTicks;
+    uint64_t rssBytes;
+} ProcessUsage;
+
+static volatile sig_atomic_t stopRequested = 0;
+
+static pthread_mutex_t loadMutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t loadCond = PTHREAD_COND_INITIALIZER;
+static bool serverStarted = false;
+static bool clientStarted = false;
+static bool clientRequested = false;
+static LoadRecord current;
+
+static uint64_t serverUpdates = 0;
+static uint64_t serverLateTicks = 0;
+
+static void stopHandler(int sign)
+{
+    (void) sign;
+    stopRequested = 1;
+}
+
+static uint64_t wallTimeUs(void)
+{
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    return (uint64_t) tv.tv_sec * 1000000 + (uint64_t) tv.tv_usec;
+}
+
+static unsigned int latencyBucket(uint64_t us)
+{
+    if (us < 8)
+    {
+        return (unsigned int) us;
+    }
+    unsigned int msb = 63 - __builtin_clzll(us);
+    unsigned int sub = (unsigned int) (us >> (msb - 3)) & 7;
+    unsigned int index = 8 + (msb - 3) * 8 + sub;
+    return (index < LATENCY_BUCKETS) ? index : LATENCY_BUCKETS - 1;
+}
+
+/* Largest latency of a bucket */
+static uint64_t latencyBucketLimit(unsigned int index)
+{
+    if (index < 8)
+    {
+        return index;
+    }
+    unsigned int msb = (index - 8) / 8 + 3;
+    unsigned int sub = (index - 8) % 8;
+    return ((uint64_t) (8 + sub + 1) << (msb - 3)) - 1;
+}
+
+static double latencyPercentileMs(const LoadRecord *record, unsigned int percent)
+{
+    uint64_t total = 0;
+    for (unsigned int i = 0; i < LATENCY_BUCKETS; i++)
+    {
+        total += record->histogram[i];
+    }
+    if (0 == total)
+    {
+        return 0;
+    }
+    uint64_t rank = (total * percent + 99) / 100;
+    uint64_t seen = 0;
+    for (unsigned int i = 0; i < LATENCY_BUCKETS; i++)
+    {
+        seen += record->histogram[i];
+        if (seen >= rank)
+        {
+            return latencyBucketLimit(i) / 1000.0;
+        }
+    }
+    return record->maxLatencyUs / 1000.0;
+}
+
+static void mergeRecord(LoadRecord *total, const LoadRecord *record)
+{
+    total->connected += record->connected;
+    total->skewed += record->skewed;
+    total->reports += record->reports;
+    total->values += record->values;
+    if (record->maxLatencyUs > total->maxLatencyUs)
+    {
+        total->maxLatencyUs = record->maxLatencyUs;
+    }
+    for (unsigned int i = 0; i < LATENCY_BUCKETS; i++)
+    {
+        total->histogram[i] += record->histogram[i];
+    }
+}
+
+/* CPU time and resident memory of a process from /proc, pid 0 for this process */
+static bool readProcessUsage(pid_t pid, ProcessUsage *usage)
+{
+    char path[64];
+    char buffer[1024];
+    if (0 == pid)
+    {
+        snprintf(path, sizeof(path), "/proc/self/stat");
+    }
+    else
+    {
+        snprintf(path, sizeof(path), "/proc/%d/stat", (int) pid);
+    }
+    FILE *file = fopen(path, "r");
+    if (NULL == file)
+    {
+        return false;
+    }
+    size_t length = fread(buffer, 1, sizeof(buffer) - 1, file);
+    fclose(file);
+    buffer[length] = '\0';
+
+    /* The fields after the command name, which may contain spaces, start with the state */
+    char *fields = strrchr(buffer, ')');
+    unsigned long utime = 0, stime = 0;
+    long rssPages = 0;
+    if (NULL == fields || 3 != sscanf(fields + 2,
+            "%*c %*d %*d %*d %*d %*d %*u %*u %*u %*u %*u %lu %lu %*d %*d %*d %*d %*d %*d %*u %*u %ld",
+            &utime, &stime, &rssPages))
+    {
+        return false;
+    }
+    usage->cpuTicks = utime + stime;
+    usage->rssBytes = (uint64_t) rssPages * (uint64_t) sysconf(_SC_PAGESIZE);
+    return true;
+}
+
+static double cpuPercent(uint64_t ticks, double seconds)
+{
+    return (seconds > 0) ? 100.0 * ticks / ((double) sysconf(_SC_CLK_TCK) * seconds) : 0;
+}
+
+static void loadNodeName(size_t index, char *name)
+{
+    snprintf(name, BENCH_NODE_NAME_SIZE, LOAD_NODE_PREFIX "%zu", index);
+}
+
+static void setFlag(bool *flag)
+{
+    pthread_mutex_lock(&loadMutex);
+    *flag = true;
+    pthread_cond_broadcast(&loadCond);
+    pthread_mutex_unlock(&loadMutex);
+}
+
+static bool waitFlag(bool *flag)
+{
+    uint64_t deadline = benchNowUs() + LOAD_START_TIMEOUT_MS * 1000;
+    pthread_mutex_lock(&loadMutex);
+    while (!*flag && benchNowUs() < deadline && !stopRequested)
+    {
+        pthread_mutex_unlock(&loadMutex);
+        benchSleepMs(10);
+        pthread_mutex_lock(&loadMutex);
+    }
+    bool set = *flag;
+    pthread_mutex_unlock(&loadMutex);
+    return set;
+}
+
+/* Callbacks */
+
+static void response_msg_cb(EdgeMessage *data)
+{
+    (void) data;
+}
+
+static void error_msg_cb(EdgeMessage *data)
+{
+    if (data->responseLength > 0 && data->responses[0]->message
+            && data->responses[0]->message->value)
+    {
+        fprintf(stderr, "loadgen: error response: %s\n",
+                (char *) data->responses[0]->message->value);
+    }
+}
+
+static void monitored_msg_cb(EdgeMessage *data)
+{
+    uint64_t now = wallTimeUs();
+    pthread_mutex_lock(&loadMutex);
+    current.reports++;
+    for (size_t i = 0; i < data->responseLength; i++)
+    {
+        EdgeResponse *response = data->responses[i];
+        if (NULL == response || NULL == response->message || NULL == response->message->value
+                || EDGE_NODEID_DOUBLE != response->type || response->message->isArray)
+        {
+            continue;
+        }
+        current.values++;
+        uint64_t updated = (uint64_t) *(double *) response->message->value;
+        if (updated > now)
+        {
+            /* The clock of the server is ahead */
+            current.skewed++;
+            continue;
+        }
+        uint64_t latency = now - updated;
+        current.histogram[latencyBucket(latency)]++;
+        if (latency > current.maxLatencyUs)
+        {
+            current.maxLatencyUs = latency;
+        }
+    }
+    pthread_mutex_unlock(&loadMutex);
+}
+
+static void browse_msg_cb(EdgeMessage *data)
+{
+    (void) data;
+}
+
+static void status_start_cb(EdgeEndPointInfo *epInfo, EdgeStatusCode status)
+{
+    (void) epInfo;
+    if (STATUS_SERVER_STARTED == status)
+    {
+        setFlag(&serverStarted);
+    }
+    else if (STATUS_CLIENT_STARTED == status)
+    {
+        setFlag(&clientStarted);
+    }
+}
+
+static void status_stop_cb(EdgeEndPointInfo *epInfo, EdgeStatusCode status)
+{
+    (void) epInfo;
+    if (STATUS_STOP_CLIENT == status)
+    {
+        pthread_mutex_lock(&loadMutex);
+        clientStarted = false;
+        pthread_mutex_unlock(&loadMutex);
+    }
+}
+
+static void status_network_cb(EdgeEndPointInfo *epInfo, EdgeStatusCode status)
+{
+    if (STATUS_DISCONNECTED == status)
+    {
+        fprintf(stderr, "loadgen: disconnected from %s\n", epInfo->endpointUri);
+        pthread_mutex_lock(&loadMutex);
+        clientStarted = false;
+        pthread_mutex_unlock(&loadMutex);
+    }
+    else if (STATUS_CONNECTED == status)
+    {
+        setFlag(&clientStarted);
+    }
+}
+
+static void endpoint_found_cb(EdgeDevice *device)
+{
+    /* One session per process, the first endpoint is taken */
+    if (NULL == device || device->num_endpoints < 1 || clientRequested)
+    {
+        return;
+    }
+    clientRequested = true;
+    EdgeEndPointInfo *endpoint = device->endpointsInfo[0];
+    EdgeMessage *msg = createEdgeMessage(endpoint->endpointUri, 0, CMD_START_CLIENT);
+    if (NULL == msg)
+    {
+        return;
+    }
+    msg->endpointInfo->endpointConfig = (EdgeEndpointConfig *) EdgeCalloc(1,
+            sizeof(EdgeEndpointConfig));
+    if (NULL != msg->endpointInfo->endpointConfig)
+    {
+        msg->endpointInfo->endpointConfig->requestTimeout = 60000;
+        msg->endpointInfo->endpointConfig->serverName = copyString(LOAD_SERVER_NAME);
+        msg->endpointInfo->endpointConfig->bindAddress = copyString(device->address);
+        msg->endpointInfo->endpointConfig->bindPort = device->port;
+        msg->endpointInfo->securityPolicyUri = copyString(endpoint->securityPolicyUri);
+        sendRequest(msg);
+    }
+    destroyEdgeMessage(msg);
+}
+
+static void device_found_cb(EdgeDevice *device)
+{
+    (void) device;
+}
+
+static EdgeConfigure *configureCallbacks(void)
+{
+    EdgeConfigure *config = (EdgeConfigure *) EdgeCalloc(1, sizeof(EdgeConfigure));
+    if (NULL == config)
+    {
+        return NULL;
+    }
+    config->recvCallback = (ReceivedMessageCallback *) EdgeCalloc(1,
+            sizeof(ReceivedMessageCallback));
+    config->statusCallback = (StatusCallback *) EdgeCalloc(1, sizeof(StatusCallback));
+    config->discoveryCallback = (DiscoveryCallback *) EdgeCalloc(1, sizeof(DiscoveryCallback));
+    if (NULL == config->recvCallback || NULL == config->statusCallback
+            || NULL == config->discoveryCallback)
+    {
+        EdgeFree(config->recvCallback);
+        EdgeFree(config->statusCallback);
+        EdgeFree(config->discoveryCallback);
+        EdgeFree(config);
+        return NULL;
+    }
+    config->recvCallback->resp_msg_cb = response_msg_cb;
+    config->recvCallback->monitored_msg_cb = monitored_msg_cb;
+    config->recvCallback->error_msg_cb = error_msg_cb;
+    config->recvCallback->browse_msg_cb = browse_msg_cb;
+    config->statusCallback->start_cb = status_start_cb;
+    config->statusCallback->stop_cb = status_stop_cb;
+    config->statusCallback->network_cb = status_network_cb;
+    config->discoveryCallback->endpoint_found_cb = endpoint_found_cb;
+    config->discoveryCallback->device_found_cb = device_found_cb;
+    config->supportedApplicationTypes = EDGE_APPLICATIONTYPE_SERVER;
+    configure(config);
+    return config;
+}
+
+static void freeConfigure(EdgeConfigure *config)
+{
+    if (config)
+    {
+        EdgeFree(config->recvCallback);
+        EdgeFree(config->statusCallback);
+        EdgeFree(config->discoveryCallback);
+        EdgeFree(config);
+    }
+}
+
+/* Server */
+
+typedef struct UpdaterContext
+{
+    size_t nodes;
+    unsigned int rate;
+} UpdaterContext;
+
+static void *updaterLoop(void *arg)
+{
+    const UpdaterContext *context = (const UpdaterContext *) arg;
+    size_t nodes = context->nodes;
+    const char **names = (const char **) EdgeCalloc(nodes, sizeof(char *));
+    EdgeVersatility *values = (EdgeVersatility *) EdgeCalloc(nodes, sizeof(EdgeVersatility));
+    EdgeVersatility **valuePtrs = (EdgeVersatility **) EdgeCalloc(nodes,
+            sizeof(EdgeVersatility *));
+    double *data = (double *) EdgeCalloc(nodes, sizeof(double));
+    if (NULL == names || NULL == values || NULL == valuePtrs || NULL == data)
+    {
+        goto EXIT;
+    }
+    for (size_t i = 0; i < nodes; i++)
+    {
+        char *name = (char *) EdgeMalloc(BENCH_NODE_NAME_SIZE);
+        if (NULL == name)
+        {
+            goto EXIT;
+        }
+        loadNodeName(i, name);
+        names[i] = name;
+        values[i].value = &data[i];
+        valuePtrs[i] = &values[i];
+    }
+
+    /* Ticks are scheduled on absolute times, a tick which is late by a period is skipped */
+    uint64_t periodNs = 1000000000ULL / context->rate;
+    struct timespec next;
+    clock_gettime(CLOCK_MONOTONIC, &next);
+    while (!stopRequested)
+    {
+        double now = (double) wallTimeUs();
+        for (size_t i = 0; i < nodes; i++)
+        {
+            data[i] = now;
+        }
+        if (STATUS_OK == modifyVariableNodes(LOAD_NAMESPACE, names, valuePtrs, nodes).code)
+        {
+            __atomic_add_fetch(&serverUpdates, nodes, __ATOMIC_RELAXED);
+        }
+
+        uint64_t nextNs = (uint64_t) next.tv_sec * 1000000000ULL + next.tv_nsec + periodNs;
+        struct timespec current;
+        clock_gettime(CLOCK_MONOTONIC, &current);
+        uint64_t currentNs = (uint64_t) current.tv_sec * 1000000000ULL + current.tv_nsec;
+        if (currentNs > nextNs + periodNs)
+        {
+            __atomic_add_fetch(&serverLateTicks, 1, __ATOMIC_RELAXED);
+            nextNs = currentNs;
+        }
+        next.tv_sec = nextNs / 1000000000ULL;
+        next.tv_nsec = nextNs % 1000000000ULL;
+        clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &next, NULL);
+    }
+
+EXIT:
+    if (names)
+    {
+        for (size_t i = 0; i < nodes; i++)
+        {
+            EdgeFree((char *) names[i]);
+        }
+    }
+    EdgeFree(names);
+    EdgeFree(values);
+    EdgeFree(valuePtrs);
+    EdgeFree(data);
+    return NULL;
+}
+
+static bool createLoadNodes(size_t nodes)
+{
+    if (STATUS_OK != createNamespace(LOAD_NAMESPACE, LOAD_ROOT_NODE, LOAD_ROOT_NODE,
+            LOAD_ROOT_NODE).code)
+    {
+        return false;
+    }
+    char name[BENCH_NODE_NAME_SIZE];
+    for (size_t i = 0; i < nodes; i++)
+    {
+        double value = 0;
+        loadNodeName(i, name);
+        EdgeNodeItem *item = createVariableNodeItem(name, EDGE_NODEID_DOUBLE, &value,
+                VARIABLE_NODE, 0);
+        if (NULL == item)
+        {
+            return false;
+        }
+        EdgeResult ret = createNode(LOAD_NAMESPACE, item);
+        deleteNodeItem(item);
+        if (STATUS_OK != ret.code)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+static int runServer(const LoadOptions *options)
+{
+    char endpointUri[256];
+    snprintf(endpointUri, sizeof(endpointUri), "opc.tcp://localhost:%u/%s", options->port,
+            LOAD_SERVER_NAME);
+
+    EdgeConfigure *config = configureCallbacks();
+    EdgeEndPointInfo *epInfo = (EdgeEndPointInfo *) EdgeCalloc(1, sizeof(EdgeEndPointInfo));
+    EdgeEndpointConfig endpointConfig;
+    EdgeApplicationConfig appConfig;
+    if (NULL == config || NULL == epInfo)
+    {
+        fprintf(stderr, "loadgen: out of memory\n");
+        freeConfigure(config);
+        EdgeFree(epInfo);
+        return 1;
+    }
+    memset(&endpointConfig, 0, sizeof(endpointConfig));
+    memset(&appConfig, 0, sizeof(appConfig));
+    endpointConfig.bindAddress = (char *) "localhost";
+    endpointConfig.bindPort = options->port;
+    endpointConfig.serverName = (char *) LOAD_SERVER_NAME;
+    appConfig.applicationName = (char *) "edge opcua load generator";
+    appConfig.applicationUri = (char *) "urn:edge:opcua:loadgen";
+    appConfig.productUri = (char *) "urn:edge:opcua:loadgen:product";
+    appConfig.applicationType = EDGE_APPLICATIONTYPE_SERVER;
+    epInfo->endpointUri = endpointUri;
+    epInfo->endpointConfig = &endpointConfig;
+    epInfo->appConfig = &appConfig;
+
+    int exitCode = 1;
+    pthread_t updater;
+    bool updaterStarted = false;
+    UpdaterContext context = { options->nodes, options->rate };
+    if (STATUS_OK != createServer(epInfo).code || !waitFlag(&serverStarted))
+    {
+        fprintf(stderr, "loadgen: the server did not start on port %u\n", options->port);
+        goto EXIT;
+    }
+    if (!createLoadNodes(options->nodes))
+    {
+        fprintf(stderr, "loadgen: creating the nodes failed\n");
+        goto EXIT;
+    }
+    if (0 != pthread_create(&updater, NULL, updaterLoop, &context))
+    {
+        fprintf(stderr, "loadgen: starting the updater failed\n");
+        goto EXIT;
+    }
+    updaterStarted = true;
+
+    printf("loadgen server: %s nodes=%zu rate=%u/s\n", endpointUri, options->nodes,
+            options->rate);
+    printf("%8s %12s %10s %8s %10s\n", "time_s", "updates/s", "late_ticks", "cpu_%", "rss_MB");
+    fflush(stdout);
+
+    uint64_t start = benchNowUs();
+    uint64_t last = start;
+    uint64_t lastUpdates = 0, lastLate = 0;
+    ProcessUsage lastUsage = { 0, 0 };
+    readProcessUsage(0, &lastUsage);
+    while (!stopRequested && (0 == options->durationS
+            || benchNowUs() - start < (uint64_t) options->durationS * 1000000))
+    {
+        benchSleepMs(options->intervalS * 1000);
+        uint64_t now = benchNowUs();
+        double seconds = (now - last) / 1e6;
+        uint64_t updates = __atomic_load_n(&serverUpdates, __ATOMIC_RELAXED);
+        uint64_t late = __atomic_load_n(&serverLateTicks, __ATOMIC_RELAXED);
+        ProcessUsage usage = lastUsage;
+        readProcessUsage(0, &usage);
+        printf("%8.0f %12.0f %10" PRIu64 " %8.1f %10.1f\n", (now - start) / 1e6,
+                (updates - lastUpdates) / seconds, late - lastLate,
+                cpuPercent(usage.cpuTicks - lastUsage.cpuTicks, seconds),
+                usage.rssBytes / 1048576.0);
+        fflush(stdout);
+        last = now;
+        lastUpdates = updates;
+        lastLate = late;
+        lastUsage = usage;
+    }
+    exitCode = 0;
+
+EXIT:
+    stopRequested = 1;
+    if (updaterStarted)
+    {
+        pthread_join(updater, NULL);
+        printf("loadgen server: %" PRIu64 " updates, %" PRIu64 " late ticks\n",
+                serverUpdates, serverLateTicks);
+    }
+    if (serverStarted)
+    {
+        closeServer(epInfo);
+    }
+    EdgeFree(epInfo);
+    freeConfigure(config);
+    return exitCode;
+}
+
+/* Client */
+
+static bool subscribeItems(const LoadOptions *options, size_t session)
+{
+    size_t perSession = options->items / options->sessions;
+    size_t first = session * perSession;
+    size_t count = (session + 1 == options->sessions) ? options->items - first : perSession;
+    if (0 == count)
+    {
+        return true;
+    }
+
+    /* The load namespace is the first one created, index 2 */
+    char name[BENCH_NODE_NAME_SIZE];
+    snprintf(name, sizeof(name), "{2;S;v=%d}" LOAD_NODE_PREFIX "%zu", EDGE_NODEID_DOUBLE,
+            first % options->nodes);
+    EdgeMessage *msg = createEdgeSubMessage(options->endpointUri, name, count, Edge_Create_Sub);
+    if (NULL == msg)
+    {
+        return false;
+    }
+    for (size_t i = 0; i < count; i++)
+    {
+        snprintf(name, sizeof(name), "{2;S;v=%d}" LOAD_NODE_PREFIX "%zu", EDGE_NODEID_DOUBLE,
+                (first + i) % options->nodes);
+        if (STATUS_OK != insertSubParameter(&msg, name, Edge_Create_Sub, options->samplingMs,
+                options->samplingMs, 10, 10000, 0, true, 0, options->queueSize).code)
+        {
+            destroyEdgeMessage(msg);
+            return false;
+        }
+    }
+    EdgeResult result = sendRequest(msg);
+    destroyEdgeMessage(msg);
+    return STATUS_OK == result.code;
+}
+
+/* Runs one session and writes a LoadRecord to fd every interval */
+static int runSession(const LoadOptions *options, size_t session, int fd)
+{
+    signal(SIGINT, SIG_IGN);
+    signal(SIGTERM, stopHandler);
+
+    EdgeConfigure *config = configureCallbacks();
+    if (NULL == config)
+    {
+        return 1;
+    }
+    EdgeMessage *msg = createEdgeMessage(options->endpointUri, 1, CMD_GET_ENDPOINTS);
+    bool ok = (NULL != msg && STATUS_OK == getEndpointInfo(msg).code);
+    destroyEdgeMessage(msg);
+    if (!ok || !waitFlag(&clientStarted))
+    {
+        fprintf(stderr, "loadgen: session %zu did not connect to %s\n", session,
+                options->endpointUri);
+    }
+    else if (!subscribeItems(options, session))
+    {
+        fprintf(stderr, "loadgen: session %zu could not subscribe\n", session);
+    }
+
+    /* Records are sent even without a session, the parent reads one per interval */
+    while (!stopRequested)
+    {
+        benchSleepMs(options->intervalS * 1000);
+        LoadRecord record;
+        pthread_mutex_lock(&loadMutex);
+        record = current;
+        record.connected = clientStarted ? 1 : 0;
+        memset(&current, 0, sizeof(current));
+        pthread_mutex_unlock(&loadMutex);
+        if (sizeof(record) != write(fd, &record, sizeof(record)))
+        {
+            break;
+        }
+    }
+
+    if (clientRequested)
+    {
+        msg = createEdgeMessage(options->endpointUri, 1, CMD_STOP_CLIENT);
+        if (msg)
+        {
+            disconnectClient(msg->endpointInfo);
+            destroyEdgeMessage(msg);
+        }
+    }
+    freeConfigure(config);
+    return 0;
+}
+
+static void printRecord(const char *time, size_t sessions, const LoadRecord *record,
+        double seconds, double cpu, double rssMB)
+{
+    printf("%8s %4u/%-4zu %12.0f %12.0f %8.2f %8.2f %8.2f %9.2f %8.1f %10.1f\n", time,
+            record->connected, sessions, record->reports / seconds, record->values / seconds,
+            latencyPercentileMs(record, 50), latencyPercentileMs(record, 90),
+            latencyPercentileMs(record, 99), record->maxLatencyUs / 1000.0, cpu, rssMB);
+}
+
+static int runClient(const LoadOptions *options)
+{
+    if (NULL == options->endpointUri)
+    {
+        fprintf(stderr, "loadgen: the client needs -e endpointUri\n");
+        return 1;
+    }
+    if (options->items / options->sessions + options->items % options->sessions > options->nodes)
+    {
+        fprintf(stderr, "loadgen: a session would subscribe a node twice, use fewer items "
+                "per session than nodes\n");
+        return 1;
+    }
+
+    pid_t pids[LOAD_MAX_SESSIONS];
+    int fds[LOAD_MAX_SESSIONS];
+    size_t started = 0;
+    for (; started < options->sessions; started++)
+    {
+        int pipeFds[2];
+        if (0 != pipe(pipeFds))
+        {
+            break;
+        }
+        fflush(stdout);
+        pid_t pid = fork();
+        if (0 == pid)
+        {
+            for (size_t i = 0; i < started; i++)
+            {
+                close(fds[i]);
+            }
+            close(pipeFds[0]);
+            _exit(runSession(options, started, pipeFds[1]));
+        }
+        close(pipeFds[1]);
+        if (pid < 0)
+        {
+            close(pipeFds[0]);
+            break;
+        }
+        pids[started] = pid;
+        fds[started] = pipeFds[0];
+    }
+
+    printf("loadgen client: %s items=%zu sessions=%zu sampling=%ums queue=%u\n",
+            options->endpointUri, options->items, started, options->samplingMs,
+            options->queueSize);
+    printf("%8s %9s %12s %12s %8s %8s %8s %9s %8s %10s\n", "time_s", "sessions", "reports/s",
+            "values/s", "p50_ms", "p90_ms", "p99_ms", "max_ms", "cpu_%", "rss_MB");
+    fflush(stdout);
+
+    LoadRecord total;
+    memset(&total, 0, sizeof(total));
+    ProcessUsage lastUsage[LOAD_MAX_SESSIONS];
+    memset(lastUsage, 0, sizeof(lastUsage));
+    for (size_t i = 0; i < started; i++)
+    {
+        readProcessUsage(pids[i], &lastUsage[i]);
+    }
+    uint64_t start = benchNowUs();
+    uint64_t last = start;
+    size_t alive = started;
+    while (alive > 0 && !stopRequested && (0 == options->durationS
+            || benchNowUs() - start < (uint64_t) options->durationS * 1000000))
+    {
+        LoadRecord interval;
+        memset(&interval, 0, sizeof(interval));
+        double cpu = 0, rssMB = 0;
+        for (size_t i = 0; i < started; i++)
+        {
+            if (fds[i] < 0)
+            {
+                continue;
+            }
+            LoadRecord record;
+            ssize_t length;
+            do
+            {
+                length = read(fds[i], &record, sizeof(record));
+            } while (length < 0 && EINTR == errno && !stopRequested);
+            if (sizeof(record) != length)
+            {
+                close(fds[i]);
+                fds[i] = -1;
+                alive--;
+                continue;
+            }
+            mergeRecord(&interval, &record);
+
+            ProcessUsage usage = lastUsage[i];
+            readProcessUsage(pids[i], &usage);
+            cpu += cpuPercent(usage.cpuTicks - lastUsage[i].cpuTicks,
+                    (benchNowUs() - last) / 1e6);
+            rssMB += usage.rssBytes / 1048576.0;
+            lastUsage[i] = usage;
+        }
+        uint64_t now = benchNowUs();
+        char time[16];
+        snprintf(time, sizeof(time), "%.0f", (now - start) / 1e6);
+        printRecord(time, started, &interval, (now - last) / 1e6, cpu, rssMB);
+        fflush(stdout);
+        mergeRecord(&total, &interval);
+        total.connected = interval.connected;
+        last = now;
+    }
+
+    for (size_t i = 0; i < started; i++)
+    {
+        kill(pids[i], SIGTERM);
+    }
+    for (size_t i = 0; i < started; i++)
+    {
+        if (fds[i] >= 0)
+        {
+            close(fds[i]);
+        }
+        waitpid(pids[i], NULL, 0);
+    }
+
+    double seconds = (last - start) / 1e6;
+    printf("loadgen client summary over %.0f s:\n", seconds);
+    printRecord("total", started, &total, (seconds > 0) ? seconds : 1, 0, 0);
+    if (total.skewed > 0)
+    {
+        printf("loadgen client: %u values were newer than the clock of the client\n",
+                total.skewed);
+    }
+    return (started == options->sessions) ? 0 : 1;
+}
+
+static void usage(const char *program)
+{
+    printf("Usage: %s server [-p port] [-n nodes] [-r rate] [-i interval] [-d duration]\n",
+            program);
+    printf("       %s client -e endpointUri [-n nodes] [-m items] [-k sessions] [-s sampling]\n"
+            "              [-q queueSize] [-i interval] [-d duration]\n", program);
+    printf("  -p  port of the server (default %d)\n", DEFAULT_PORT);
+    printf("  -n  variable nodes of the server (default %d)\n", DEFAULT_NODES);
+    printf("  -r  updates of every node per second (default %d)\n", DEFAULT_RATE);
+    printf("  -m  monitored items over all sessions (default %d)\n", DEFAULT_ITEMS);
+    printf("  -k  sessions, one process each (default %d, at most %d)\n", DEFAULT_SESSIONS,
+            LOAD_MAX_SESSIONS);
+    printf("  -s  sampling and publishing interval in milliseconds (default %d)\n",
+            DEFAULT_SAMPLING_MS);
+    printf("  -q  queue size of the monitored items (default %d)\n", DEFAULT_QUEUE_SIZE);
+    printf("  -i  seconds between two lines (default %d)\n", DEFAULT_INTERVAL_S);
+    printf("  -d  seconds to run, 0 until SIGINT (default 0)\n");
+}
+
+int main(int argc, char **argv)
+{
+    LoadOptions options;
+    options.port = DEFAULT_PORT;
+    options.nodes = DEFAULT_NODES;
+    options.rate = DEFAULT_RATE;
+    options.endpointUri = NULL;
+    options.items = DEFAULT_ITEMS;
+    options.sessions = DEFAULT_SESSIONS;
+    options.samplingMs = DEFAULT_SAMPLING_MS;
+    options.queueSize = DEFAULT_QUEUE_SIZE;
+    options.intervalS = DEFAULT_INTERVAL_S;
+    options.durationS = 0;
+
+    if (argc < 2 || (0 != strcmp(argv[1], "server") && 0 != strcmp(argv[1], "client")))
+    {
+        usage(argv[0]);
+        return 1;
+    }
+    for (int i = 2; i < argc; i++)
+    {
+        const char *arg = argv[i];
+        if ('-' != arg[0] || '\0' == arg[1] || '\0' != arg[2] || i + 1 >= argc)
+        {
+            usage(argv[0]);
+            return 1;
+        }
+        const char *text = argv[++i];
+        if ('e' == arg[1])
+        {
+            options.endpointUri = text;
+            continue;
+        }
+        char *end = NULL;
+        unsigned long value = strtoul(text, &end, 10);
+        if (NULL == end || '\0' != *end || (0 == value && 'd' != arg[1]))
+        {
+            usage(argv[0]);
+            return 1;
+        }
+        switch (arg[1])
+        {
+            case 'p': options.port = (unsigned int) value; break;
+            case 'n': options.nodes = value; break;
+            case 'r': options.rate = (unsigned int) value; break;
+            case 'm': options.items = value; break;
+            case 'k': options.sessions = value; break;
+            case 's': options.samplingMs = (unsigned int) value; break;
+            case 'q': options.queueSize = (unsigned int) value; break;
+            case 'i': options.intervalS = (unsigned int) value; break;
+            case 'd': options.durationS = (unsigned int) value; break;
+            default: usage(argv[0]); return 1;
+        }
+    }
+    if (options.sessions > LOAD_MAX_SESSIONS)
+    {
+        usage(argv[0]);
+        return 1;
+    }
+
+    signal(SIGINT, stopHandler);
+    signal(SIGTERM, stopHandler);
+    signal(SIGPIPE, SIG_IGN);
+    /* Log records would add to the load */
+    setLogLevel(EDGE_LOG_LEVEL_NONE);
+
+    return (0 == strcmp(argv[1], "server")) ? runServer(&options) : runClient(&options);
+}
@@ -0,0 +1,396 @@
+/******************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ *
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************/
+
+/*
+ * Microbenchmarks of the containers and message copies of the library, in one thread.
+ *
+ *   uqueue_add_get        u_queue_add_element() then u_queue_get_element() of size messages
+ *   uarraylist_add        u_arraylist_add() of size elements to a new list
+ *   uarraylist_add_remove u_arraylist_add() of size elements, then u_arraylist_remove() of the
+ *                         first element until the list is empty
+ *   uarraylist_get_index  u_arraylist_get_index() of every element of a list of size elements
+ *   map_insert            insertMapElement() of size keys to a new map
+ *   map_get               getMapElement() of every key of a map of size keys
+ *   message_read          cloneEdgeMessage() and freeEdgeMessage() of a read of size nodes
+ *   message_write         cloneEdgeMessage() and freeEdgeMessage() of a write of size values
+ *
+ * A repetition runs the operation batch enough times for at least MIN_OPS_PER_REPETITION
+ * container operations or MESSAGE_COPIES_PER_REPETITION message copies, so that the clock
+ * resolution does not matter. Results are nanoseconds per operation over the repetitions.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "bench_util.h"
+#include "edge_malloc.h"
+#include "edge_map.h"
+#include "edge_open62541.h"
+#include "uarraylist.h"
+#include "uqueue.h"
+
+#define DEFAULT_REPETITIONS (100)
+#define DEFAULT_WARMUP (10)
+#define MIN_OPS_PER_REPETITION (4096)
+#define MESSAGE_COPIES_PER_REPETITION (256)
+#define MAX_ELEMENTS (4096)
+
+typedef struct MicroCase
+{
+    const char *name;
+    size_t size;
+    /* Runs the batch batches times, returns the operations */
+    size_t (*run)(size_t size, size_t batches);
+} MicroCase;
+
+/* Distinct element addresses */
+static int elements[MAX_ELEMENTS];
+static u_queue_message_t queueMessages[MAX_ELEMENTS];
+static u_queue_t *queue = NULL;
+static u_arraylist_t *filledList = NULL;
+static edgeMap *filledMap = NULL;
+static EdgeMessage *message = NULL;
+/* Keeps the compiler from dropping lookups */
+static volatile uintptr_t sink = 0;
+
+static size_t runQueueAddGet(size_t size, size_t batches)
+{
+    for (size_t b = 0; b < batches; b++)
+    {
+        for (size_t i = 0; i < size; i++)
+        {
+            u_queue_add_element(queue, &queueMessages[i]);
+        }
+        for (size_t i = 0; i < size; i++)
+        {
+            sink += (uintptr_t) u_queue_get_element(queue);
+        }
+    }
+    return batches * size * 2;
+}
+
+static size_t runListAdd(size_t size, size_t batches)
+{
+    for (size_t b = 0; b < batches; b++)
+    {
+        u_arraylist_t *list = u_arraylist_create();
+        for (size_t i = 0; i < size; i++)
+        {
+            u_arraylist_add(list, &elements[i]);
+        }
+        u_arraylist_free(&list);
+    }
+    return batches * size;
+}
+
+static size_t runListAddRemove(size_t size, size_t batches)
+{
+    for (size_t b = 0; b < batches; b++)
+    {
+        u_arraylist_t *list = u_arraylist_create();
+        for (size_t i = 0; i < size; i++)
+        {
+            u_arraylist_add(list, &elements[i]);
+        }
+        for (size_t i = 0; i < size; i++)
+        {
+            sink += (uintptr_t) u_arraylist_remove(list, 0);
+        }
+        u_arraylist_free(&list);
+    }
+    return batches * size * 2;
+}
+
+static size_t runListGetIndex(size_t size, size_t batches)
+{
+    for (size_t b = 0; b < batches; b++)
+    {
+        for (size_t i = 0; i < size; i++)
+        {
+            uint32_t index = 0;
+            u_arraylist_get_index(filledList, &elements[i], &index);
+            sink += index;
+        }
+    }
+    return batches * size;
+}
+
+static size_t runMapInsert(size_t size, size_t batches)
+{
+    for (size_t b = 0; b < batches; b++)
+    {
+        edgeMap *map = createMap();
+        for (size_t i = 0; i < size; i++)
+        {
+            insertMapElement(map, &elements[i], &elements[i]);
+        }
+        deleteMap(map);
+        EdgeFree(map);
+    }
+    return batches * size;
+}
+
+static size_t runMapGet(size_t size, size_t batches)
+{
+    for (size_t b = 0; b < batches; b++)
+    {
+        for (size_t i = 0; i < size; i++)
+        {
+            sink += (uintptr_t) getMapElement(filledMap, &elements[i]);
+        }
+    }
+    return batches * size;
+}
+
+static size_t runMessageCopy(size_t size, size_t batches)
+{
+    (void) size;
+    for (size_t b = 0; b < batches; b++)
+    {
+        EdgeMessage *copy = cloneEdgeMessage(message);
+        sink += (uintptr_t) copy;
+        freeEdgeMessage(copy);
+    }
+    return batches;
+}
+
+static EdgeMessage *createReadMessage(size_t size)
+{
+    EdgeMessage *msg = createEdgeAttributeMessage("opc.tcp://localhost:12686/edge-opc-server",
+            size, CMD_READ);
+    char name[BENCH_NODE_NAME_SIZE];
+    for (size_t i = 0; msg && i < size; i++)
+    {
+        benchRequestNodeName(i, name);
+        insertReadAccessNode(&msg, name);
+    }
+    return msg;
+}
+
+static EdgeMessage *createWriteMessage(size_t size)
+{
+    EdgeMessage *msg = createEdgeAttributeMessage("opc.tcp://localhost:12686/edge-opc-server",
+            size, CMD_WRITE);
+    char name[BENCH_NODE_NAME_SIZE];
+    for (size_t i = 0; msg && i < size; i++)
+    {
+        double *value = (double *) EdgeMalloc(sizeof(double));
+        if (NULL == value)
+        {
+            break;
+        }
+        *value = (double) i;
+        benchRequestNodeName(i, name);
+        insertWriteAccessNode(&msg, name, value, 1);
+    }
+    return msg;
+}
+
+/* Builds the input of a case outside of the measurement */
+static bool setUp(const MicroCase *micro)
+{
+    if (micro->run == runQueueAddGet)
+    {
+        queue = u_queue_create();
+        return NULL != queue;
+    }
+    if (micro->run == runListGetIndex)
+    {
+        filledList = u_arraylist_create();
+        for (size_t i = 0; filledList && i < micro->size; i++)
+        {
+            u_arraylist_add(filledList, &elements[i]);
+        }
+        return NULL != filledList;
+    }
+    if (micro->run == runMapGet)
+    {
+        filledMap = createMap();
+        for (size_t i = 0; filledMap && i < micro->size; i++)
+        {
+            insertMapElement(filledMap, &elements[i], &elements[i]);
+        }
+        return NULL != filledMap;
+    }
+    if (micro->run == runMessageCopy)
+    {
+        message = (0 == strcmp(micro->name, "message_write")) ?
+                createWriteMessage(micro->size) : createReadMessage(micro->size);
+        return NULL != message;
+    }
+    return true;
+}
+
+static void tearDown(void)
+{
+    if (queue)
+    {
+        u_queue_delete(queue);
+        queue = NULL;
+    }
+    if (filledList)
+    {
+        u_arraylist_free(&filledList);
+    }
+    if (filledMap)
+    {
+        deleteMap(filledMap);
+        EdgeFree(filledMap);
+        filledMap = NULL;
+    }
+    if (message)
+    {
+        destroyEdgeMessage(message);
+        message = NULL;
+    }
+}
+
+static const MicroCase cases[] =
+{
+    { "uqueue_add_get", 16, runQueueAddGet },
+    { "uqueue_add_get", 256, runQueueAddGet },
+    { "uqueue_add_get", 4096, runQueueAddGet },
+    { "uarraylist_add", 16, runListAdd },
+    { "uarraylist_add", 256, runListAdd },
+    { "uarraylist_add", 4096, runListAdd },
+    { "uarraylist_add_remove", 16, runListAddRemove },
+    { "uarraylist_add_remove", 256, runListAddRemove },
+    { "uarraylist_add_remove", 4096, runListAddRemove },
+    { "uarraylist_get_index", 16, runListGetIndex },
+    { "uarraylist_get_index", 256, runListGetIndex },
+    { "uarraylist_get_index", 4096, runListGetIndex },
+    { "map_insert", 8, runMapInsert },
+    { "map_insert", 64, runMapInsert },
+    { "map_insert", 512, runMapInsert },
+    { "map_get", 8, runMapGet },
+    { "map_get", 64, runMapGet },
+    { "map_get", 512, runMapGet },
+    { "message_read", 1, runMessageCopy },
+    { "message_read", 16, runMessageCopy },
+    { "message_read", 128, runMessageCopy },
+    { "message_write", 1, runMessageCopy },
+    { "message_write", 16, runMessageCopy },
+    { "message_write", 128, runMessageCopy }
+};
+
+#define CASE_COUNT (sizeof(cases) / sizeof(cases[0]))
+
+static bool runCase(const MicroCase *micro, size_t repetitions, size_t warmup)
+{
+    char name[64];
+    snprintf(name, sizeof(name), "%s/%zu", micro->name, micro->size);
+    uint64_t *samples = (uint64_t *) EdgeCalloc(repetitions, sizeof(uint64_t));
+    if (NULL == samples || !setUp(micro))
+    {
+        printf("microbench: %s: setting up failed\n", name);
+        EdgeFree(samples);
+        tearDown();
+        return false;
+    }
+
+    /* A batch of the message copies is a single message */
+    size_t batches = (micro->run == runMessageCopy) ? MESSAGE_COPIES_PER_REPETITION :
+            (MIN_OPS_PER_REPETITION + micro->size - 1) / micro->size;
+
+    size_t ops = 0;
+    for (size_t r = 0; r < warmup; r++)
+    {
+        micro->run(micro->size, batches);
+    }
+    for (size_t r = 0; r < repetitions; r++)
+    {
+        uint64_t start = benchNowNs();
+        ops = micro->run(micro->size, batches);
+        samples[r] = benchNowNs() - start;
+    }
+    tearDown();
+
+    BenchStats stats;
+    benchComputeStats(samples, repetitions, &stats);
+    EdgeFree(samples);
+    printf("%-32s %8zu %10.1f %10.1f %10.1f %12.2f\n", name, repetitions, stats.mean / ops,
+            stats.p50 / ops, stats.p99 / ops, (stats.mean > 0) ? ops * 1e3 / stats.mean : 0);
+    fflush(stdout);
+    return true;
+}
+
+static void usage(const char *program)
+{
+    printf("Usage: %s [-r repetitions] [-w warmup] [case...]\n", program);
+    printf("Cases: uqueue_add_get uarraylist_add uarraylist_add_remove uarraylist_get_index\n");
+    printf("       map_insert map_get message_read message_write (default: all)\n");
+}
+
+int main(int argc, char **argv)
+{
+    size_t repetitions = DEFAULT_REPETITIONS;
+    size_t warmup = DEFAULT_WARMUP;
+    bool anySelected = false;
+    bool selected[CASE_COUNT];
+    memset(selected, 0, sizeof(selected));
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (0 == strcmp(argv[i], "-r") || 0 == strcmp(argv[i], "-w"))
+        {
+            char *end = NULL;
+            unsigned long value = (i + 1 < argc) ? strtoul(argv[i + 1], &end, 10) : 0;
+            if (NULL == end || '\0' != *end || (0 == value && 'r' == argv[i][1]))
+            {
+                usage(argv[0]);
+                return 1;
+            }
+            *(('r' == argv[i][1]) ? &repetitions : &warmup) = value;
+            i++;
+            continue;
+        }
+        bool known = false;
+        for (size_t idx = 0; idx < CASE_COUNT; idx++)
+        {
+            if (0 == strcmp(argv[i], cases[idx].name))
+            {
+                selected[idx] = true;
+                known = true;
+            }
+        }
+        if (!known)
+        {
+            usage(argv[0]);
+            return 1;
+        }
+        anySelected = true;
+    }
+
+    /* Log records would be part of the measurement */
+    setLogLevel(EDGE_LOG_LEVEL_NONE);
+    printf("%-32s %8s %10s %10s %10s %12s\n", "benchmark/size", "reps", "mean_ns/op", "p50_ns/op",
+            "p99_ns/op", "Mops/s");
+
+    int failures = 0;
+    for (size_t idx = 0; idx < CASE_COUNT; idx++)
+    {
+        if ((!anySelected || selected[idx]) && !runCase(&cases[idx], repetitions, warmup))
+        {
+            failures++;
+        }
+    }
+    return (failures > 0) ? 1 : 0;
+}
@@ -356,7 +356,9 @@ static void monitored_msg_cb (EdgeMessage *data)
 {
     if (data->type == REPORT)
     {
-        struct tm *lt = data->serverTime.timeInfo;
+        struct tm localTime;
+        struct tm *lt = data->serverTime.timeInfo ? data->serverTime.timeInfo :
+                getEdgeLocalTime(&data->serverTime, &localTime);
         struct timeval val = data->serverTime.tv;
 
         printf("[Application response Callback] Monitored Item Response received\n");
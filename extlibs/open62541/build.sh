@@ -39,7 +39,8 @@ mkdir -p build
 # Get into the build directory
 cd build
 
-cmake .. -DCMAKE_BUILD_TYPE=Release -DUA_ENABLE_AMALGAMATION=ON -DUA_ENABLE_ENCRYPTION=OFF
+# Extra CMake options, like -DUA_ENABLE_MULTITHREADING=ON, are passed as arguments
+cmake .. -DCMAKE_BUILD_TYPE=Release -DUA_ENABLE_AMALGAMATION=ON -DUA_ENABLE_ENCRYPTION=OFF "$@"
 
 make
 
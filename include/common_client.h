@@ -41,6 +41,21 @@ extern "C"
 typedef struct EdgeNodeInfo EdgeNodeInfo;
 typedef struct EdgeResult EdgeResult;
 
+/**
+  * @brief Opaque handle of a read request prepared by prepareRead()
+  */
+typedef struct EdgePreparedRead EdgePreparedRead;
+
+/**
+  * @brief Opaque handle of a PubSub subscriber created with createPubSubSubscriber()
+  */
+typedef struct EdgeSubscriber EdgeSubscriber;
+
+/**
+  * @brief Opaque handle of a request sent by sendRequestAsync()
+  */
+typedef struct EdgeFuture EdgeFuture;
+
 /**
   * @brief Structure which represents the data
   *
@@ -55,6 +70,10 @@ typedef struct EdgeVersatility
 
     /**< Array Length */
     size_t arrayLength;
+
+    /**< Array buffer was decoded by the stack and handed over instead of copied,
+         see setZeroCopyArrayThreshold(). It is released with the response. */
+    bool adopted;
 } EdgeVersatility;
 
 /**
@@ -113,8 +132,64 @@ typedef struct EdgeResponse
 
     /**< Diagnostic information */
     EdgeDiagnosticInfo *m_diagnosticInfo;
+
+    /**< Read response: #EdgeAttributeId which was read */
+    uint32_t attributeId;
+
+    /**< Report: source timestamp of the value, in microseconds since the Unix epoch, 0 if unknown */
+    int64_t sourceTimestamp;
+
+    /**< Report: server timestamp of the value, in microseconds since the Unix epoch, 0 if unknown */
+    int64_t serverTimestamp;
+
+    /**< Report: time the client received the notification, in microseconds since the Unix epoch */
+    int64_t receiveTimestamp;
+
+    /**< History read response: set if later responses carry more values of the node.
+         The last response of a node carries no value if its last chunk was empty. */
+    bool hasMoreValues;
 } EdgeResponse;
 
+/**
+  * @brief Data changes of a monitored item which are notified
+  *
+  */
+typedef enum
+{
+    /**< Change of the status or the value, the default of the server */
+    EDGE_DATACHANGE_TRIGGER_STATUS_VALUE = 0,
+    /**< Change of the status only */
+    EDGE_DATACHANGE_TRIGGER_STATUS = 1,
+    /**< Change of the status, the value or the source timestamp */
+    EDGE_DATACHANGE_TRIGGER_STATUS_VALUE_TIMESTAMP = 2
+} EdgeDataChangeTrigger;
+
+/**
+  * @brief Deadband which filters the value changes of a monitored item
+  *
+  */
+typedef enum
+{
+    /**< No deadband */
+    EDGE_DEADBAND_NONE = 0,
+    /**< Absolute change of the value */
+    EDGE_DEADBAND_ABSOLUTE = 1,
+    /**< Change in percent of the EURange of the node */
+    EDGE_DEADBAND_PERCENT = 2
+} EdgeDeadbandType;
+
+/**
+  * @brief Sample which is discarded when the queue of a monitored item is full
+  *
+  */
+typedef enum
+{
+    /**< Oldest sample of the queue */
+    EDGE_DISCARD_OLDEST = 0,
+    /**< Newest sample of the queue */
+    EDGE_DISCARD_NEWEST = 1
+} EdgeDiscardPolicy;
+
 /**
   * @brief Structure which represents the Subscription Request data
   *
@@ -145,8 +220,20 @@ typedef struct EdgeSubRequest
     /**< Priority of the subscription */
     int priority;
 
-    /**< Size of MonitoredItem queue */
+    /**< Size of MonitoredItem queue, samples of a larger queue are reported together */
     uint32_t queueSize;
+
+    /**< Sample which is discarded when the MonitoredItem queue is full */
+    EdgeDiscardPolicy discardPolicy;
+
+    /**< Data changes which are notified */
+    EdgeDataChangeTrigger trigger;
+
+    /**< Deadband type of the value changes */
+    EdgeDeadbandType deadbandType;
+
+    /**< Deadband value, absolute or in percent */
+    double deadbandValue;
 } EdgeSubRequest;
 
 #ifdef __cplusplus
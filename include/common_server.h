@@ -36,6 +36,29 @@ extern "C"
 
 typedef struct EdgeNodeId EdgeNodeId;
 
+/**
+  * @brief Read callback of a data source variable node, called on every read of the node
+  *        and every sample of a monitored item of it, in the server loop.
+  * @param[in]  browseName Browse name of the node.
+  * @param[in]  context Data source context of the node item.
+  * @param[out]  value Receives the value in the form createVariableNodeItem() takes its data,
+  *              and arrayLength for array nodes. It is copied after the call.
+  * @return true on success, otherwise false if there is no value.
+  */
+typedef bool (*data_source_read_func) (const char *browseName, void *context,
+        EdgeVersatility *value);
+
+/**
+  * @brief Write callback of a data source variable node, called in the server loop.
+  * @param[in]  browseName Browse name of the node.
+  * @param[in]  context Data source context of the node item.
+  * @param[in]  value New value of the node type. String values are Edge_String views which are
+  *             not NUL-terminated and are valid only during the call.
+  * @return true if the value is taken, otherwise false.
+  */
+typedef bool (*data_source_write_func) (const char *browseName, void *context,
+        const EdgeVersatility *value);
+
 /**
   * @brief Structure which represents the Node information
   *
@@ -80,6 +103,16 @@ typedef struct EdgeNodeItem
 
     /* Minimum Sampling interval*/
     double minimumSamplingInterval;
+
+    /**< Read callback of a VARIABLE_NODE or ARRAY_NODE which keeps no value of its own,
+     * its value is read from the callback when it is needed. variableData is not used. */
+    data_source_read_func read_fn;
+
+    /**< Write callback of a data source node, the node is read-only if it is NULL */
+    data_source_write_func write_fn;
+
+    /**< Context passed to the data source callbacks, it must stay valid while the server runs */
+    void *dataSourceContext;
 } EdgeNodeItem;
 
 /**
@@ -168,6 +201,23 @@ typedef struct EdgeArgument
   */
 typedef void (*method_func) (int inpSize, void **input, int outSize, void **output);
 
+/**
+  * @brief Opaque handle of the output arguments of a method call,
+  *        filled with getMethodOutputBuffer() and setMethodOutputString().
+  */
+typedef struct EdgeMethodOutputs EdgeMethodOutputs;
+
+/**
+  * @brief Method callback function which works on the decoded arguments without copies.
+  *        String inputs are Edge_String views, one per element for arrays, which are not
+  *        NUL-terminated and are valid only during the call. Other inputs are as for method_func.
+  * @param[in]  inpSize Number of input arguments.
+  * @param[in]  input Input data.
+  * @param[in]  outSize Number of output arguments.
+  * @param[out]  outputs Output arguments, written in place.
+  */
+typedef void (*method_view_func) (int inpSize, void **input, int outSize, EdgeMethodOutputs *outputs);
+
 /**
   * @brief Structure which represents the method request data.
   *
@@ -196,6 +246,29 @@ typedef struct EdgeMethod
     method_func method_fn;
 } EdgeMethod;
 
+/**
+  * @brief Opaque handle of a server instance created with createServerInstance().
+  */
+typedef struct EdgeServer EdgeServer;
+
+/**
+  * @brief Opaque handle of a namespace created in the server.
+  * It stays valid until the server is closed.
+  */
+typedef struct EdgeNamespace EdgeNamespace;
+
+/**
+  * @brief Opaque handle of a Variable/Array node created with createNode().
+  * It stays valid until the server is closed.
+  */
+typedef struct EdgeVariableNode EdgeVariableNode;
+
+/**
+  * @brief Opaque handle of a PubSub publisher created with createPubSubPublisher().
+  * It stays valid until it is deleted or the server is closed.
+  */
+typedef struct EdgePublisher EdgePublisher;
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,126 @@
+/******************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ *
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************/
+
+/**
+ * @file edge_bulk_convert.h
+ *
+ * @brief This file contains the conversion of large numeric arrays, such as the values of
+ *        array reads and reports or the values of array writes.
+ *
+ * The loops use SSE2 on x86 and NEON on ARM when the compiler targets them, and plain C
+ * otherwise. Source and destination may be the same array when their element sizes are equal.
+ */
+
+#ifndef EDGE_BULK_CONVERT_H_
+#define EDGE_BULK_CONVERT_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#ifndef EXPORT
+#ifndef _WIN32
+#define EXPORT __attribute__((visibility("default")))
+#else
+#define EXPORT
+#endif
+#endif
+
+/**
+ * @brief Converts samples to float, dst[i] = src[i] * scale + offset.
+ * @param[in]  src Source samples.
+ * @param[out] dst Converted values.
+ * @param[in]  count Number of samples.
+ * @param[in]  scale Factor of each sample.
+ * @param[in]  offset Added to each scaled sample.
+ */
+EXPORT void edgeInt16ToFloat(const int16_t *src, float *dst, size_t count, float scale,
+        float offset);
+
+/**
+ * @brief Converts unsigned samples to float, see edgeInt16ToFloat().
+ */
+EXPORT void edgeUInt16ToFloat(const uint16_t *src, float *dst, size_t count, float scale,
+        float offset);
+
+/**
+ * @brief Converts values to samples for a write, dst[i] = src[i] * scale + offset rounded to
+ *        the nearest integer and saturated to the range of int16_t. NaN becomes INT16_MIN.
+ * @param[in]  src Values.
+ * @param[out] dst Samples.
+ * @param[in]  count Number of values.
+ * @param[in]  scale Factor of each value.
+ * @param[in]  offset Added to each scaled value.
+ */
+EXPORT void edgeFloatToInt16(const float *src, int16_t *dst, size_t count, float scale,
+        float offset);
+
+/**
+ * @brief Scales values, dst[i] = src[i] * scale + offset.
+ */
+EXPORT void edgeScaleFloat(const float *src, float *dst, size_t count, float scale, float offset);
+
+/**
+ * @brief Scales values, dst[i] = src[i] * scale + offset.
+ */
+EXPORT void edgeScaleDouble(const double *src, double *dst, size_t count, double scale,
+        double offset);
+
+/**
+ * @brief Reverses the byte order of each 16-bit element in place.
+ * @param[in,out]  data Elements.
+ * @param[in]  count Number of elements.
+ */
+EXPORT void edgeSwapBytes16(void *data, size_t count);
+
+/**
+ * @brief Reverses the byte order of each 32-bit element in place.
+ */
+EXPORT void edgeSwapBytes32(void *data, size_t count);
+
+/**
+ * @brief Reverses the byte order of each 64-bit element in place.
+ */
+EXPORT void edgeSwapBytes64(void *data, size_t count);
+
+/**
+ * @brief Converts the numeric array of a response to float, dst[i] = src[i] * scale + offset.
+ * @param[in]  src Array value of the response, EdgeVersatility.value.
+ * @param[in]  type Type of the response, EdgeResponse.type. EDGE_NODEID_SBYTE, BYTE, INT16,
+ *             UINT16, INT32, UINT32, FLOAT and DOUBLE are supported.
+ * @param[out] dst Converted values.
+ * @param[in]  count Number of elements, EdgeVersatility.arrayLength.
+ * @param[in]  scale Factor of each element.
+ * @param[in]  offset Added to each scaled element.
+ * @return @c true on success, @c false for an unsupported type or NULL arrays.
+ */
+EXPORT bool edgeConvertArrayToFloat(const void *src, int type, float *dst, size_t count,
+        float scale, float offset);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* EDGE_BULK_CONVERT_H_ */
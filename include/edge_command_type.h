@@ -67,6 +67,18 @@ typedef enum
     /** Command to read sampling interval on server.*/
     CMD_READ_SAMPLING_INTERVAL = 11,
 
+    /** Command to register nodes for repeated reads and writes on server.*/
+    CMD_REGISTER_NODES = 12,
+
+    /** Command to unregister nodes registered with CMD_REGISTER_NODES.*/
+    CMD_UNREGISTER_NODES = 13,
+
+    /** Command to resolve browse paths to NodeIds on server.*/
+    CMD_TRANSLATE_BROWSE_PATHS = 14,
+
+    /** Command to read the history of values on server.*/
+    CMD_HISTORY_READ = 15,
+
     /** Invalid command */
     CMD_INVALID = 100
 } EdgeCommand;
@@ -134,4 +146,28 @@ typedef enum
 /** Method - Command description.*/
 #define CMD_METHOD_DESC                    "call method nodes from server"
 
+/** Register nodes - String value.*/
+#define  CMD_REGISTER_NODES_VALUE                    "register_nodes"
+
+/** Register nodes - Command description.*/
+#define CMD_REGISTER_NODES_DESC                    "register nodes for repeated access"
+
+/** Unregister nodes - String value.*/
+#define  CMD_UNREGISTER_NODES_VALUE                    "unregister_nodes"
+
+/** Unregister nodes - Command description.*/
+#define CMD_UNREGISTER_NODES_DESC                    "unregister nodes"
+
+/** Translate browse paths - String value.*/
+#define  CMD_TRANSLATE_BROWSE_PATHS_VALUE                    "translate_browse_paths"
+
+/** Translate browse paths - Command description.*/
+#define CMD_TRANSLATE_BROWSE_PATHS_DESC                    "translate browse paths to node ids"
+
+/** History read - String value.*/
+#define  CMD_HISTORY_READ_VALUE                    "history_read"
+
+/** History read - Command description.*/
+#define CMD_HISTORY_READ_DESC                    "read the history of values"
+
 #endif /* EDGE_COMMAND_TYPE_H_ */
@@ -58,6 +58,35 @@ typedef enum
     MILTI_FOLDER_NODE_TYPE = 1009
 } EdgeIdentifier;
 
+/**
+ * Attribute identifiers defined by OPC UA Part 6, used for reading several attributes in one request.
+ */
+typedef enum
+{
+    EDGE_ATTRIBUTE_NODEID = 1,
+    EDGE_ATTRIBUTE_NODECLASS = 2,
+    EDGE_ATTRIBUTE_BROWSENAME = 3,
+    EDGE_ATTRIBUTE_DISPLAYNAME = 4,
+    EDGE_ATTRIBUTE_DESCRIPTION = 5,
+    EDGE_ATTRIBUTE_WRITEMASK = 6,
+    EDGE_ATTRIBUTE_USERWRITEMASK = 7,
+    EDGE_ATTRIBUTE_ISABSTRACT = 8,
+    EDGE_ATTRIBUTE_SYMMETRIC = 9,
+    EDGE_ATTRIBUTE_INVERSENAME = 10,
+    EDGE_ATTRIBUTE_CONTAINSNOLOOPS = 11,
+    EDGE_ATTRIBUTE_EVENTNOTIFIER = 12,
+    EDGE_ATTRIBUTE_VALUE = 13,
+    EDGE_ATTRIBUTE_DATATYPE = 14,
+    EDGE_ATTRIBUTE_VALUERANK = 15,
+    EDGE_ATTRIBUTE_ARRAYDIMENSIONS = 16,
+    EDGE_ATTRIBUTE_ACCESSLEVEL = 17,
+    EDGE_ATTRIBUTE_USERACCESSLEVEL = 18,
+    EDGE_ATTRIBUTE_MINIMUMSAMPLINGINTERVAL = 19,
+    EDGE_ATTRIBUTE_HISTORIZING = 20,
+    EDGE_ATTRIBUTE_EXECUTABLE = 21,
+    EDGE_ATTRIBUTE_USEREXECUTABLE = 22
+} EdgeAttributeId;
+
 #ifdef __cplusplus
 }
 #endif
@@ -28,6 +28,7 @@
 #define EDGE_MALLOC_H_
 
 #include <malloc.h>
+#include <stdbool.h>
 #include <edge_opcua_common.h>
 
 #ifdef __cplusplus
@@ -102,6 +103,83 @@ EXPORT void EdgeFree(void *ptr);
 
 EXPORT Edge_String EdgeStringAlloc(char const src[]);
 
+/**
+ * Maximum number of allocation tags tracked when built with ENABLE_MALLOC_STATS.
+ * Allocations from further tags are accounted to the last entry.
+ */
+#define EDGE_MALLOC_MAX_TAGS (64)
+
+/**
+ * Allocator used by EdgeMalloc, EdgeCalloc, EdgeRealloc and EdgeFree.
+ * callocFn may be NULL, in that case mallocFn followed by memset is used.
+ */
+typedef struct EdgeAllocator
+{
+    void *(*mallocFn)(size_t size);
+    void *(*callocFn)(size_t num, size_t size);
+    void *(*reallocFn)(void *ptr, size_t size);
+    void (*freeFn)(void *ptr);
+} EdgeAllocator;
+
+/**
+ * Live and total allocations of one tag.
+ */
+typedef struct EdgeAllocStats
+{
+    /** Call-site tag, the source file of the allocation */
+    const char *tag;
+    /** Bytes currently allocated, blocks released with free() instead of EdgeFree()
+     *  are counted until their address is allocated again */
+    size_t liveBytes;
+    /** Blocks currently allocated */
+    size_t liveCount;
+    /** Blocks allocated since start */
+    size_t totalCount;
+} EdgeAllocStats;
+
+/**
+ * Replaces the allocator behind the Edge allocation APIs, e.g. with jemalloc,
+ * mimalloc or a per-thread cache.
+ *
+ * NOTE: Must be called before any other API of the stack, memory is always
+ *       released through the allocator which provided it.
+ *
+ * NOTE: The hooks must be free()-compatible with libc, e.g. jemalloc or mimalloc
+ *       replacing malloc() process-wide. Blocks of EdgeMalloc() are handed to open62541
+ *       and released there with free(), and blocks of open62541 reach EdgeFree().
+ *
+ * @param allocator - Allocation hooks, mallocFn, reallocFn and freeFn are mandatory.
+ *                    NULL restores the libc allocator.
+ *
+ * @return
+ *     true if the allocator was installed
+ *     false if a mandatory hook is missing
+ */
+EXPORT bool EdgeSetAllocator(const EdgeAllocator *allocator);
+
+/**
+ * Copies the per tag allocation counters.
+ *
+ * NOTE: Counters are only maintained when built with ENABLE_MALLOC_STATS, which
+ *       serializes the allocations of all threads to track them.
+ *
+ * @param stats - Array receiving the counters
+ * @param maxStats - Number of entries in stats
+ *
+ * @return number of entries written, 0 if statistics are not enabled
+ */
+EXPORT size_t EdgeGetAllocStats(EdgeAllocStats *stats, size_t maxStats);
+
+#ifdef ENABLE_MALLOC_STATS
+EXPORT void *EdgeMallocTag(size_t size, const char *tag);
+EXPORT void *EdgeCallocTag(size_t num, size_t size, const char *tag);
+EXPORT void *EdgeReallocTag(void *ptr, size_t size, const char *tag);
+
+#define EdgeMalloc(size) EdgeMallocTag((size), __FILE__)
+#define EdgeCalloc(num, size) EdgeCallocTag((num), (size), __FILE__)
+#define EdgeRealloc(ptr, size) EdgeReallocTag((ptr), (size), __FILE__)
+#endif
+
 #ifdef __cplusplus
 }
 #endif
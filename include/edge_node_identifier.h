@@ -47,6 +47,7 @@ typedef enum
     #ifdef ENABLE_SUB_QUEUE
     Edge_Publish_Sub = 10036,
     #endif
+    Edge_Create_Bulk_Sub = 10037,
 
     Edge_Connection_Status = 10040,
     Edge_Endpoints = 10050
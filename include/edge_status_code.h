@@ -61,6 +61,9 @@ typedef enum
     /** Service(read,write,method,browse,subscription, etc) result is not good.*/
     STATUS_SERVICE_RESULT_BAD = 9,
 
+    /** Indicates that the client could not establish the connection with the OPC UA server.*/
+    STATUS_CLIENT_CONNECT_FAILED = 10,
+
     /** Failed to enqueue(add) a request into send queue.*/
     STATUS_ENQUEUE_ERROR = 20,
 
@@ -85,6 +88,9 @@ typedef enum
     /** Server is not started.*/
     STATUS_NOT_START_SERVER  = 35,
 
+    /** Request is not finished within the timeout.*/
+    STATUS_REQUEST_TIMEOUT = 36,
+
     /** Resonse contains 1 less record than all responses.*/
     STATUS_WRITE_LESS_RESPONSE = 50,
 
@@ -222,6 +228,9 @@ typedef enum
 /** STATUS_SERVICE_RESULT_BAD - Description.*/
 #define STATUS_SERVICE_RESULT_BAD_VALUE        "service result is not good"
 
+/** STATUS_CLIENT_CONNECT_FAILED - Description.*/
+#define STATUS_CLIENT_CONNECT_FAILED_VALUE     "connection to the server failed"
+
 /** STATUS_ENQUEUE_ERROR - Description.*/
 #define STATUS_ENQUEUE_ERROR_VALUE  ""
 
@@ -246,6 +255,9 @@ typedef enum
 /** STATUS_NOT_START_SERVER - Description.*/
 #define STATUS_NOT_START_SERVER_VALUE         "server is not started"
 
+/** STATUS_REQUEST_TIMEOUT - Description.*/
+#define STATUS_REQUEST_TIMEOUT_VALUE         "request is not finished within the timeout"
+
 /** STATUS_WRITE_LESS_RESPONSE - Description.*/
 #define STATUS_WRITE_LESS_RESPONSE_VALUE         "contains 1 less record than all responses"
 
@@ -58,6 +58,7 @@ extern "C"
 #define BIND_PORT            (12686)
 #define MAX_BROWSENAME_SIZE  (1000)
 #define MAX_DISPLAYNAME_SIZE (1000)
+#define EDGE_MAX_SESSION_POOL_SIZE (16)
 #define UNIQUE_NODE_PATH     "{%d;%c;v=%d}%1000[^\n]s"
 
 #define EDGE_NODEID_UNKNOWN (0)
@@ -217,8 +218,151 @@ typedef enum
     DIRECTION_BOTH
 } EdgeBrowseDirection;
 
+/**
+  * @brief Enum which represents the node classes of EdgeBrowseParameter.nodeClassMask
+  *        Values are the node class bits of OPC UA.
+  *
+  */
+typedef enum
+{
+    EDGE_NODECLASS_OBJECT = 1,
+    EDGE_NODECLASS_VARIABLE = 2,
+    EDGE_NODECLASS_METHOD = 4,
+    EDGE_NODECLASS_VIEW = 128
+} EdgeNodeClass;
+
+/**
+  * @brief Enum which represents the log levels, a level includes the levels before it
+  *
+  */
+typedef enum
+{
+    /**< Nothing is logged. */
+    EDGE_LOG_LEVEL_NONE = 0,
+    /**< Failures. */
+    EDGE_LOG_LEVEL_ERROR,
+    /**< Unexpected conditions the stack recovers from. */
+    EDGE_LOG_LEVEL_WARNING,
+    /**< Notable events. */
+    EDGE_LOG_LEVEL_INFO,
+    /**< Tracing of the operations. */
+    EDGE_LOG_LEVEL_DEBUG
+} EdgeLogLevel;
+
+/**
+  * @brief Structure which represents one log record
+  *
+  */
+typedef struct EdgeLogEntry
+{
+    /**< Level of the record. */
+    EdgeLogLevel level;
+
+    /**< Module which logged the record. */
+    const char *tag;
+
+    /**< Text of the record, without a trailing newline. */
+    const char *message;
+
+    /**< Time of the record in microseconds, the clock of EdgeTimeInfo.monotonicTime. */
+    uint64_t monotonicTime;
+} EdgeLogEntry;
+
+/**
+  * @brief Callback which receives the log records on the log thread
+  * @param[in]  entry Log record, only valid during the callback
+  * @param[in]  context Context given to setLogSink()
+  */
+typedef void (*EdgeLogSink)(const EdgeLogEntry *entry, void *context);
+
+/**
+  * @brief Enum which represents the stages of a request which are traced, in the order a
+  *        request passes them. EXECUTE contains SERVICE and RESPONSE unless the service is
+  *        asynchronous, then they end while a later message of the session executes.
+  *
+  */
+typedef enum
+{
+    /**< sendRequest() or sendRequestTake() checks and copies the request. */
+    EDGE_TRACE_STAGE_SEND_REQUEST = 0,
+    /**< The request waits in the send queue. */
+    EDGE_TRACE_STAGE_SEND_QUEUE,
+    /**< The request is executed on the send thread. */
+    EDGE_TRACE_STAGE_EXECUTE,
+    /**< The open62541 service call, from the service request to its response. */
+    EDGE_TRACE_STAGE_SERVICE,
+    /**< The response message is built from the service response. */
+    EDGE_TRACE_STAGE_RESPONSE,
+    /**< The response or report waits in the receiver queue. */
+    EDGE_TRACE_STAGE_RECV_QUEUE,
+    /**< The callback of the application handles the response or report. */
+    EDGE_TRACE_STAGE_CALLBACK
+} EdgeTraceStage;
+
+/**
+  * @brief Structure which represents the begin or end of a stage of a request
+  *
+  */
+typedef struct EdgeTraceEvent
+{
+    /**< message_id of the request, which its responses carry as well. */
+    uint32_t messageId;
+
+    /**< Command of the message. */
+    EdgeCommand command;
+
+    /**< Type of the message, a request, response or report. */
+    EdgeMessageType type;
+
+    /**< Endpoint of the message, NULL if it has none. */
+    const char *endpointUri;
+
+    /**< Stage which begins or ends. */
+    EdgeTraceStage stage;
+
+    /**< Time of the event in microseconds, the clock of EdgeTimeInfo.monotonicTime. */
+    uint64_t monotonicTime;
+} EdgeTraceEvent;
+
+/**
+  * @brief Callback which receives a trace event on the thread of the stage
+  * @param[in]  event Trace event, only valid during the callback
+  * @param[in]  context EdgeTraceHooks.context
+  */
+typedef void (*EdgeTraceCallback)(const EdgeTraceEvent *event, void *context);
+
+/**
+  * @brief Structure which represents the request tracing hooks of the application.
+  *        The hooks run on the threads of the stack and must return quickly.
+  *
+  */
+typedef struct EdgeTraceHooks
+{
+    /**< Called when a stage begins, can be NULL. */
+    EdgeTraceCallback begin;
+
+    /**< Called when a stage ends, can be NULL. */
+    EdgeTraceCallback end;
+
+    /**< Context passed to the hooks. */
+    void *context;
+} EdgeTraceHooks;
+
+struct EdgeMessage;
+
+/**
+  * @brief Callback which receives the browse results of a request one by one
+  *        on the browse thread, instead of the browse_msg_cb of the application.
+  *        The message is freed when the callback returns.
+  * @param[in]  result Browse response message with one result
+  * @param[in]  context EdgeBrowseParameter.resultContext
+  * @return @c false to stop the browse, @c true to continue
+  */
+typedef bool (*browse_result_cb_t) (struct EdgeMessage *result, void *context);
+
 /**
   * @brief Structure which represents the parameters for Browse request data
+  *        New members are disabled when they are zero.
   *
   */
 typedef struct EdgeBrowseParameter
@@ -227,8 +371,222 @@ typedef struct EdgeBrowseParameter
     EdgeBrowseDirection direction;
     /**< Max references per node to browse. */
     int maxReferencesPerNode;
+    /**< Levels below the start nodes to browse, 0 for no limit. */
+    uint32_t maxDepth;
+    /**< EdgeNodeClass bits of the nodes passed to the application, 0 for all.
+         Nodes of the other classes are still browsed further. */
+    uint32_t nodeClassMask;
+    /**< Numeric id of the reference type in namespace 0 to follow including its subtypes,
+         0 for all references. */
+    uint32_t referenceTypeId;
+    /**< Number of results after which the browse stops, 0 for no limit. */
+    size_t maxResults;
+    /**< Receives the results and can stop the browse, NULL to pass them to browse_msg_cb. */
+    browse_result_cb_t resultCallback;
+    /**< Context passed to resultCallback. */
+    void *resultContext;
 } EdgeBrowseParameter;
 
+/**
+  * @brief Kind of history read
+  *
+  */
+typedef enum
+{
+    /**< Raw values stored between the start and the end time */
+    EDGE_HISTORY_READ_RAW = 0,
+    /**< Values modified between the start and the end time */
+    EDGE_HISTORY_READ_MODIFIED = 1,
+    /**< Aggregates of the values computed by the server for each processing interval */
+    EDGE_HISTORY_READ_PROCESSED = 2
+} EdgeHistoryReadKind;
+
+/**
+  * @brief Callback which receives the values of a history read chunk by chunk
+  *        on the thread of the request, instead of the response callback of the application.
+  *        The message is freed when the callback returns.
+  * @param[in]  result Response message with the values of one node returned by one request
+  * @param[in]  context EdgeHistoryParameter.resultContext
+  * @return @c false to stop the history read, @c true to continue
+  */
+typedef bool (*history_result_cb_t) (struct EdgeMessage *result, void *context);
+
+/**
+  * @brief Structure which represents the parameters of a History read request
+  *        Times are in microseconds since the Unix epoch, 0 leaves them unspecified.
+  *
+  */
+typedef struct EdgeHistoryParameter
+{
+    /**< Kind of history read. */
+    EdgeHistoryReadKind kind;
+    /**< Start of the period to read. */
+    int64_t startTime;
+    /**< End of the period to read, before the start time to read backwards. */
+    int64_t endTime;
+    /**< Raw and modified reads: values per node returned by one request, 0 for the server's
+         choice. Further values are read with the continuation points of the server. */
+    uint32_t numValuesPerNode;
+    /**< Raw reads: set to return the bounding values of the period. */
+    bool returnBounds;
+    /**< Processed reads: numeric id of the aggregate function in namespace 0,
+         like UA_NS0ID_AGGREGATEFUNCTION_AVERAGE. */
+    uint32_t aggregateType;
+    /**< Processed reads: length of each interval in milliseconds. */
+    double processingInterval;
+    /**< Number of values per node after which the history read stops, 0 for no limit. */
+    size_t maxValues;
+    /**< Receives the values and can stop the history read, NULL to pass them to the
+         response callback of the application. */
+    history_result_cb_t resultCallback;
+    /**< Context passed to resultCallback. */
+    void *resultContext;
+} EdgeHistoryParameter;
+
+/**
+  * @brief Structure which represents the configuration of a PubSub publisher or subscriber,
+  *        which send and receive UADP NetworkMessages over UDP
+  *
+  */
+typedef struct EdgePubSubConfig
+{
+    /**< IPv4 multicast group of the messages, like "239.0.0.1". */
+    const char *address;
+    /**< UDP port of the messages, 4840 if 0. */
+    uint16_t port;
+    /**< IPv4 address of the network interface, NULL for the default interface. */
+    const char *interfaceAddress;
+    /**< PublisherId of the messages. Subscriber: 0 accepts any. */
+    uint16_t publisherId;
+    /**< WriterGroupId of the messages. Subscriber: 0 accepts any. */
+    uint16_t writerGroupId;
+    /**< DataSetWriterId of the DataSetMessage. Subscriber: 0 accepts any. */
+    uint16_t dataSetWriterId;
+    /**< Publisher: interval between two messages in milliseconds. */
+    uint32_t publishingInterval;
+    /**< Publisher: time to live of the multicast messages, 1 if 0. */
+    uint8_t ttl;
+    /**< Largest message in bytes, 1472 if 0. */
+    uint32_t maxMessageSize;
+} EdgePubSubConfig;
+
+/**
+  * @brief Handle of a shared memory ring which EdgeMessages are published to,
+  *        see createShmPublisher().
+  */
+typedef struct EdgeShmPublisher EdgeShmPublisher;
+
+/**
+  * @brief Handle of a process which reads the messages of a shared memory ring,
+  *        see openShmConsumer().
+  */
+typedef struct EdgeShmConsumer EdgeShmConsumer;
+
+/**
+  * @brief String of a message in a shared memory ring. The bytes are followed by a '\0'.
+  *
+  */
+typedef struct EdgeShmString
+{
+    /**< Offset of the bytes from the start of the EdgeShmMessage, 0 for a NULL string. */
+    uint32_t offset;
+    /**< Number of bytes without the terminating '\0'. */
+    uint32_t length;
+} EdgeShmString;
+
+/**
+  * @brief Layout of the value of an EdgeShmResponse
+  *
+  */
+typedef enum
+{
+    /**< The response has no value, or one of a type which is not published. */
+    EDGE_SHM_VALUE_NONE = 0,
+    /**< Values in the memory layout of the type, like int32_t or double. */
+    EDGE_SHM_VALUE_PLAIN = 1,
+    /**< EdgeShmString values, of the String, ByteString, XmlElement and Guid types. */
+    EDGE_SHM_VALUE_STRING = 2,
+    /**< EdgeShmQualifiedName values. */
+    EDGE_SHM_VALUE_QUALIFIEDNAME = 3,
+    /**< EdgeShmLocalizedText values. */
+    EDGE_SHM_VALUE_LOCALIZEDTEXT = 4
+} EdgeShmValueKind;
+
+/**
+  * @brief QualifiedName value of a message in a shared memory ring
+  *
+  */
+typedef struct EdgeShmQualifiedName
+{
+    uint32_t namespaceIndex;
+    EdgeShmString name;
+} EdgeShmQualifiedName;
+
+/**
+  * @brief LocalizedText value of a message in a shared memory ring
+  *
+  */
+typedef struct EdgeShmLocalizedText
+{
+    EdgeShmString locale;
+    EdgeShmString text;
+} EdgeShmLocalizedText;
+
+/**
+  * @brief Response of a message in a shared memory ring, the flat form of EdgeResponse
+  *
+  */
+typedef struct EdgeShmResponse
+{
+    /**< Value alias of the node. */
+    EdgeShmString valueAlias;
+    /**< Type of the value, as EdgeResponse.type. */
+    int32_t type;
+    /**< #EdgeShmValueKind of the value. */
+    uint32_t valueKind;
+    /**< Offset of the value from the start of the EdgeShmMessage, 0 if there is none. */
+    uint32_t valueOffset;
+    /**< Number of values of an array, 0 for a scalar. */
+    uint32_t arrayLength;
+    /**< Code of EdgeResponse.result, 0 if it has none. */
+    uint32_t statusCode;
+    /**< Read response: #EdgeAttributeId which was read. */
+    uint32_t attributeId;
+    /**< Timestamps of the value, as in EdgeResponse. */
+    int64_t sourceTimestamp;
+    int64_t serverTimestamp;
+    int64_t receiveTimestamp;
+} EdgeShmResponse;
+
+/**
+  * @brief Message in a shared memory ring, the flat form of an EdgeMessage.
+  *        Its strings, responses and values follow it in one block.
+  *
+  */
+typedef struct EdgeShmMessage
+{
+    /**< Size of the message in bytes, with everything which follows it. */
+    uint32_t size;
+    /**< #EdgeMessageType of the message. */
+    uint32_t type;
+    /**< #EdgeCommand of the message. */
+    uint32_t command;
+    /**< message_id of the message. */
+    uint32_t messageId;
+    /**< Code of EdgeMessage.result, 0 if it has none. */
+    uint32_t statusCode;
+    /**< Number of EdgeShmResponse of the message. */
+    uint32_t responseCount;
+    /**< Offset of the EdgeShmResponse array from the start of the message. */
+    uint32_t responsesOffset;
+    /**< URI of the endpoint of the message. */
+    EdgeShmString endpointUri;
+    /**< EdgeMessage.serverTime in microseconds since the Unix epoch. */
+    int64_t serverTime;
+    /**< Number of the message in the ring, counting from 1. */
+    uint64_t sequence;
+} EdgeShmMessage;
+
 /**
   * @brief Structure which represents the endpoint configuratino information
   *
@@ -246,6 +604,38 @@ typedef struct EdgeEndpointConfig
 
     /**< Port.*/
     uint32_t bindPort;
+
+    /**< Value updates of enqueueVariableNodeUpdate() a server queues, 0 for the default of 4096.
+     * It is rounded up to a power of two.*/
+    uint32_t updateQueueSize;
+
+    /**< Longest time in ms a server loop iteration waits for network events before it serves
+     * queued value updates and method results, 0 or values from 50 on for the library's 50 ms.*/
+    uint32_t iterateTimeout;
+
+    /**< Worker threads which process the services of a server while its loop runs the network
+     * layer, 0 for the library default. More than one needs open62541 built with
+     * SERVER_THREADS=1 (UA_ENABLE_MULTITHREADING), otherwise the server uses one thread.
+     * The workers run while application threads modify nodes, which are registered with
+     * the RCU of open62541 on their first modification until they exit.*/
+    uint16_t serverThreads;
+
+    /**< Size in bytes of the chunks the endpoint sends, 0 for the library default.*/
+    uint32_t sendBufferSize;
+
+    /**< Size in bytes of the chunks the endpoint accepts, 0 for the library default.*/
+    uint32_t recvBufferSize;
+
+    /**< Largest message in bytes the endpoint accepts, 0 for no limit.*/
+    uint32_t maxMessageSize;
+
+    /**< Largest number of chunks of a message the endpoint accepts, 0 for no limit.*/
+    uint32_t maxChunkCount;
+
+    /**< Skip the writes of modifyVariableNode() and modifyVariableNodes() whose value the node
+     * holds already, so that they neither replace the value nor its timestamps. Values of the
+     * plain built-in types and strings are compared, others are always written.*/
+    bool writeOnChange;
 } EdgeEndpointConfig;
 
 /**
@@ -360,6 +750,9 @@ typedef struct EdgeDevice
 
     /**< Number of endpoints */
     size_t num_endpoints;
+
+    /**< Set by the network discovery when the server is no longer announced.*/
+    bool removed;
 } EdgeDevice;
 
 /**
@@ -448,6 +841,9 @@ typedef struct EdgeRequest
 
     /**< Return Diagnostics.*/
     int returnDiagnostic;
+
+    /**< Read request: #EdgeAttributeId to read, 0 reads the attribute of the message command.*/
+    uint32_t attributeId;
 } EdgeRequest;
 
 /**
@@ -464,8 +860,18 @@ typedef struct EdgeResult
 
 typedef struct EdgeTimeInfo
 {
+    /**< Broken-down local time of tv, it points to localTime.
+         NULL when setLocalTimeConversion() is disabled, see getEdgeLocalTime(). **/
     struct tm *timeInfo;
+
+    /**< Wall clock time **/
     struct timeval tv;
+
+    /**< Monotonic time in microseconds, only meaningful as a difference of two times **/
+    uint64_t monotonicTime;
+
+    /**< Storage of timeInfo **/
+    struct tm localTime;
 } EdgeTimeInfo;
 
 /**
@@ -510,12 +916,22 @@ typedef struct EdgeMessage
     /**< Total number of browse result objects **/
     size_t browseResultLength;
 
+    /**< History parameter for History read request.*/
+    EdgeHistoryParameter *historyParam;
+
     /**< Message Id **/
     uint32_t message_id;
 
     /**< Server Time Stamp **/
     EdgeTimeInfo serverTime;
 
+    /**< Read request: maximum age in milliseconds of the values to return, 0 reads fresh values **/
+    double maxAge;
+
+    /**< Write request: set to report only the nodes which failed to be written.
+         No GENERAL_RESPONSE is received for the successful nodes. **/
+    bool writeErrorsOnly;
+
 } EdgeMessage;
 
 #ifdef __cplusplus
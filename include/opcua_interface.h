@@ -144,6 +144,367 @@ typedef struct DiscoveryCallback
     device_found_cb_t device_found_cb;
 } DiscoveryCallback;
 
+/**
+ * @brief Action taken when a message is added to a full send or receive queue
+ *
+ */
+typedef enum EdgeQueueOverflowPolicy
+{
+    /**< Producer waits until there is room in the queue */
+    EDGE_QUEUE_OVERFLOW_BLOCK = 0,
+
+    /**< Message is rejected, sendRequest() returns STATUS_ENQUEUE_ERROR */
+    EDGE_QUEUE_OVERFLOW_REJECT = 1,
+
+    /**< Oldest queued REPORT message is dropped, rejected if there is none */
+    EDGE_QUEUE_OVERFLOW_DROP_OLDEST_REPORT = 2,
+
+    /**< Queued REPORT of the same endpoint and valueAlias is replaced, rejected if there is none */
+    EDGE_QUEUE_OVERFLOW_CONFLATE = 3
+} EdgeQueueOverflowPolicy;
+
+/**
+ * @brief Queue configuration which bounds the send or receive queue
+ *
+ */
+typedef struct EdgeQueueConfig
+{
+    /**< Maximum number of queued messages, 0 for unbounded */
+    uint32_t capacity;
+
+    /**< Action taken when the queue is full */
+    EdgeQueueOverflowPolicy overflowPolicy;
+
+    /**< Replace a pending REPORT of the same endpoint and valueAlias by the newer one,
+         so only the latest value of each monitored item waits in the queue */
+    bool conflateReports;
+
+    /**< Receive queue only: file which REPORT messages overflow into while the queue holds
+         half of capacity reports, 1024 if capacity is 0. Spooled reports are queued again in
+         order once the queue has drained, those left at shutdown after the next start.
+         Values of the built-in types Boolean to ByteString are spooled, the endpoint of
+         reports left by an earlier run is known by its URI only. NULL disables the spool. */
+    const char *spoolPath;
+
+    /**< Size of the spool file in bytes, 0 for 64 MiB. While it is full, reports are queued
+         as without a spool. */
+    uint64_t spoolMaxBytes;
+} EdgeQueueConfig;
+
+/**
+ * @brief Reconnection of client sessions whose connection is lost
+ *
+ */
+typedef struct EdgeReconnectConfig
+{
+    /**< Delay in milliseconds before the first attempt, 0 disables reconnecting (default).
+         The delay doubles with every failed attempt, each one is randomized between half
+         and the full delay so that sessions lost at once do not reconnect at once. */
+    uint32_t initialDelayMs;
+
+    /**< Upper bound of the delay in milliseconds, 0 for 60 seconds */
+    uint32_t maxDelayMs;
+
+    /**< Failed attempts after which the session is given up and STATUS_CLIENT_CONNECT_FAILED
+         is reported, 0 to retry until the client is stopped */
+    uint32_t maxAttempts;
+
+    /**< Time in milliseconds a request to a lost session waits for the next attempt
+         before it fails, 0 to fail at once */
+    uint32_t requestBufferMs;
+} EdgeReconnectConfig;
+
+/**
+ * @brief Number of wait time buckets in EdgeQueueStats.
+ * Bucket i counts waits below 10^(i+1) microseconds, the last bucket counts all longer waits.
+ */
+#define EDGE_QUEUE_WAIT_BUCKETS (8)
+
+/**
+ * @brief Statistics of the send or receive queue
+ *
+ */
+typedef struct EdgeQueueStats
+{
+    /**< Number of messages accepted by the queue */
+    uint64_t enqueueCount;
+
+    /**< Number of messages taken from the queue for processing */
+    uint64_t dequeueCount;
+
+    /**< Number of messages rejected, dropped or replaced by a newer report */
+    uint64_t dropCount;
+
+    /**< Number of messages currently queued */
+    uint32_t depth;
+
+    /**< Highest number of messages queued at once */
+    uint32_t highWaterDepth;
+
+    /**< Longest time a message waited in the queue, in microseconds */
+    uint64_t maxWaitUs;
+
+    /**< Sum of the wait times of the dequeued messages, in microseconds */
+    uint64_t totalWaitUs;
+
+    /**< Histogram of the wait times */
+    uint64_t waitHistogram[EDGE_QUEUE_WAIT_BUCKETS];
+} EdgeQueueStats;
+
+/**
+ * @brief Number of latency buckets in EdgeLatencyHistogram.
+ * Bucket i counts latencies below 10^(i+1) microseconds, the last bucket counts all longer ones.
+ */
+#define EDGE_LATENCY_BUCKETS (8)
+
+/**
+ * @brief Stages of the delivery of a REPORT, from the sample of the server to the application
+ *
+ */
+typedef enum
+{
+    /**< Source timestamp to server timestamp, sampling in the server */
+    EDGE_LATENCY_SERVER = 0,
+    /**< Server timestamp to client receive time, publishing and network */
+    EDGE_LATENCY_NETWORK = 1,
+    /**< Client receive time to application callback, receive queue and dispatcher */
+    EDGE_LATENCY_DISPATCH = 2,
+    /**< Source timestamp to application callback */
+    EDGE_LATENCY_TOTAL = 3,
+    /**< Number of stages */
+    EDGE_LATENCY_STAGES = 4
+} EdgeLatencyStage;
+
+/**
+ * @brief Latency histogram of one delivery stage
+ *
+ */
+typedef struct EdgeLatencyHistogram
+{
+    /**< Number of recorded notifications */
+    uint64_t count;
+
+    /**< Longest latency, in microseconds */
+    uint64_t maxUs;
+
+    /**< Sum of the latencies, in microseconds */
+    uint64_t totalUs;
+
+    /**< Histogram of the latencies */
+    uint64_t histogram[EDGE_LATENCY_BUCKETS];
+} EdgeLatencyHistogram;
+
+/**
+ * @brief Notification latencies of a subscription, identified by the message_id of its
+ *        create request which is also the message_id of its REPORT messages.
+ * Stages crossing the clocks of server and client are only as exact as the clock synchronization,
+ * negative latencies are recorded as zero.
+ */
+typedef struct EdgeReportLatency
+{
+    /**< Latency of each EdgeLatencyStage */
+    EdgeLatencyHistogram stages[EDGE_LATENCY_STAGES];
+} EdgeReportLatency;
+
+/**
+ * @brief Services of a server whose calls reach the callbacks of the application
+ *
+ */
+typedef enum
+{
+    /**< Reads and samples of data source variable nodes */
+    EDGE_SERVER_SERVICE_READ = 0,
+    /**< Writes to data source variable nodes */
+    EDGE_SERVER_SERVICE_WRITE = 1,
+    /**< Method calls, asynchronous ones until they are handed to the method workers */
+    EDGE_SERVER_SERVICE_CALL = 2,
+    /**< Number of services */
+    EDGE_SERVER_SERVICES = 3
+} EdgeServerService;
+
+/**
+ * @brief Calls of one service of a server
+ *
+ */
+typedef struct EdgeServiceStats
+{
+    /**< Durations of the calls in the server loop */
+    EdgeLatencyHistogram latency;
+
+    /**< Number of calls which returned a bad status */
+    uint64_t errorCount;
+} EdgeServiceStats;
+
+/**
+ * @brief Runtime statistics of a server, counted since it was started
+ *
+ */
+typedef struct EdgeServerStats
+{
+    /**< Number of activated sessions which are not closed */
+    uint32_t sessionCount;
+
+    /**< Number of sessions activated since the start */
+    uint64_t sessionTotal;
+
+    /**< Number of nodes in the nodestore, including the namespace 0 nodes */
+    uint64_t nodeCount;
+
+    /**< Number of value updates of enqueueVariableNodeUpdate() written by the server loop */
+    uint64_t updateCount;
+
+    /**< Number of modifyVariableNode() writes skipped because the node held the value already,
+         see EdgeEndpointConfig.writeOnChange */
+    uint64_t unchangedWriteCount;
+
+    /**< Calls of each EdgeServerService */
+    EdgeServiceStats services[EDGE_SERVER_SERVICES];
+} EdgeServerStats;
+
+/**
+ * @brief Kinds of the requests of a client session
+ *
+ */
+typedef enum
+{
+    /**< Reads of values, sampling intervals and history */
+    EDGE_CLIENT_REQUEST_READ = 0,
+    /**< Writes */
+    EDGE_CLIENT_REQUEST_WRITE = 1,
+    /**< Method calls */
+    EDGE_CLIENT_REQUEST_METHOD = 2,
+    /**< Browse and browse view requests */
+    EDGE_CLIENT_REQUEST_BROWSE = 3,
+    /**< Creating, modifying and deleting subscriptions */
+    EDGE_CLIENT_REQUEST_SUBSCRIPTION = 4,
+    /**< RegisterNodes, UnregisterNodes and TranslateBrowsePathsToNodeIds */
+    EDGE_CLIENT_REQUEST_OTHER = 5,
+    /**< Number of request kinds */
+    EDGE_CLIENT_REQUESTS = 6
+} EdgeClientRequest;
+
+/**
+ * @brief Requests of one kind of a client session
+ *
+ */
+typedef struct EdgeClientRequestStats
+{
+    /**< Number of requests executed on the session */
+    uint64_t requestCount;
+
+    /**< Number of service calls which returned a bad status, timeouts included */
+    uint64_t errorCount;
+
+    /**< Number of service calls which timed out */
+    uint64_t timeoutCount;
+
+    /**< Durations of the service calls, from the service request to its response.
+         Reads answered by the value cache make no service call. */
+    EdgeLatencyHistogram serviceLatency;
+} EdgeClientRequestStats;
+
+/**
+ * @brief Runtime statistics of the sessions of a client endpoint, counted since it was connected.
+ *        The sessions of a session pool are counted together.
+ *
+ */
+typedef struct EdgeClientStats
+{
+    /**< Time of the snapshot in microseconds, the clock of EdgeTimeInfo.monotonicTime.
+         Rates like notifications per second are the difference of two snapshots. */
+    uint64_t monotonicTime;
+
+    /**< Number of sessions of the endpoint */
+    uint32_t sessionCount;
+
+    /**< Bytes sent to the server */
+    uint64_t bytesSent;
+
+    /**< Bytes received from the server */
+    uint64_t bytesReceived;
+
+    /**< Number of times the first session lost its connection */
+    uint64_t disconnectCount;
+
+    /**< Number of times the first session was connected again */
+    uint64_t reconnectCount;
+
+    /**< Number of subscriptions of the endpoint */
+    uint32_t subscriptionCount;
+
+    /**< Number of monitored items of the subscriptions */
+    uint32_t monitoredItemCount;
+
+    /**< Number of notifications received */
+    uint64_t notificationCount;
+
+    /**< Requests of each EdgeClientRequest */
+    EdgeClientRequestStats requests[EDGE_CLIENT_REQUESTS];
+} EdgeClientStats;
+
+/**
+ * @brief Classes of the threads of the library, see EdgeThreadConfig.
+ *
+ */
+typedef enum
+{
+    /**< Workers of the send and receive queues.*/
+    EDGE_THREAD_DISPATCHER = 0,
+
+    /**< Threads which run the server loop of the server and its instances.*/
+    EDGE_THREAD_SERVER = 1,
+
+    /**< Threads which send the publish requests of the client subscriptions.*/
+    EDGE_THREAD_SUBSCRIPTION = 2,
+
+    /**< Method workers, timers, connection, discovery, PubSub and logger threads.*/
+    EDGE_THREAD_HELPER = 3,
+
+    /**< Number of thread classes.*/
+    EDGE_THREAD_CLASSES = 4
+} EdgeThreadClass;
+
+/**
+ * @brief Scheduling policies of the threads, see EdgeThreadConfig.
+ *
+ */
+typedef enum
+{
+    /**< Keeps the policy the thread inherits.*/
+    EDGE_SCHED_DEFAULT = 0,
+
+    /**< Normal time-sharing policy.*/
+    EDGE_SCHED_OTHER = 1,
+
+    /**< Real-time first-in first-out policy, it usually needs privileges.*/
+    EDGE_SCHED_FIFO = 2,
+
+    /**< Real-time round-robin policy, it usually needs privileges.*/
+    EDGE_SCHED_RR = 3
+} EdgeSchedPolicy;
+
+/**
+ * @brief Attributes of a class of threads. Each thread applies them when it starts,
+ *        a setting which fails is logged and the thread runs without it.
+ *
+ */
+typedef struct EdgeThreadConfig
+{
+    /**< Name of the threads, a number is appended to it. Names are cut to 11 characters.
+         NULL names them by the class, e.g. "edge-server-1". Only used on Linux.*/
+    const char *name;
+
+    /**< CPUs the threads may run on, bit n for CPU n. 0 keeps the inherited affinity.
+         Only used on Linux.*/
+    uint64_t cpuMask;
+
+    /**< Scheduling policy of the threads.*/
+    EdgeSchedPolicy schedPolicy;
+
+    /**< Scheduling priority of the threads, used with a policy other than EDGE_SCHED_DEFAULT.*/
+    int schedPriority;
+} EdgeThreadConfig;
+
 /**
  * @brief EdgeConfigure structure which contains the initial configuration for client/server
  *
@@ -57,6 +57,7 @@ void onSendMessage(EdgeMessage* msg);
 void onResponseMessage(EdgeMessage *msg);
 void onStatusCallback(EdgeEndPointInfo *epInfo, EdgeStatusCode status);
 void onDiscoveryCallback(EdgeDevice *device);
+void onDeviceCallback(EdgeDevice *device);
 
 /**
  * @brief Function for creating the server
@@ -74,6 +75,24 @@ EXPORT EdgeResult createServer(EdgeEndPointInfo *epInfo);
  */
 EXPORT void closeServer(EdgeEndPointInfo *epInfo);
 
+/**
+ * @brief Create a server instance besides the server of createServer(). Each instance has its
+ * own port, configuration, namespaces and loop thread, so a process can host several servers.
+ * Nodes are added to an instance with the handle APIs on its namespaces.
+ * @param[in]  epInfo End point information for server.
+ * @return Server instance on success, otherwise NULL
+ * @remarks The asynchronous method workers are shared by the servers of the process,
+ * the first server which starts sets their number.
+ */
+EXPORT EdgeServer* createServerInstance(EdgeEndPointInfo *epInfo);
+
+/**
+ * @brief Close a server instance of createServerInstance(), its handles become invalid.
+ * @param[in]  server Server instance.
+ * @param[in]  epInfo End point information for server.
+ */
+EXPORT void closeServerInstance(EdgeServer *server, EdgeEndPointInfo *epInfo);
+
 /**
  * @brief Gets a list of all registered servers at the given server. Application has to free the memory \n
                    allocated for the resultant array of EdgeApplicationConfig objects and its members.
@@ -103,6 +122,109 @@ EXPORT EdgeResult findServers(const char *endpointUri, size_t serverUrisSize,
  */
 EXPORT EdgeResult getEndpointInfo(EdgeMessage *msg);
 
+/**
+ * @brief Gets the endpoints of many servers at once. Up to maxWorkers servers are probed in
+ *        parallel, each server which answers is reported to endpoint_found_cb as soon as its
+ *        endpoints arrive. The callbacks of one scan are not called concurrently.
+ *        The call returns when every endpoint Uri has been probed.
+ * @param[in]  endpointUris Endpoint Uris to probe.
+ * @param[in]  count Number of endpoint Uris.
+ * @param[in]  maxWorkers Number of servers probed at once, 0 for 8, at most 64.
+ * @param[in]  timeoutMs Timeout of each probe in milliseconds, 0 for the client default.
+ * @return @c EdgeResult code is 0 on success, otherwise an error value
+ * @retval #STATUS_OK Successful, also if a server did not answer
+ * @retval #STATUS_PARAM_INVALID Invalid parameter
+ */
+EXPORT EdgeResult scanEndpoints(const char *const *endpointUris, size_t count, size_t maxWorkers,
+        uint32_t timeoutMs);
+
+/**
+ * @brief Gets the endpoints of the servers on a range of IPv4 addresses, see scanEndpoints().
+ * @param[in]  firstAddress First IPv4 address of the range, e.g. "192.168.0.1".
+ * @param[in]  lastAddress Last IPv4 address of the range, at most 65536 addresses in all.
+ * @param[in]  port Port of the servers.
+ * @param[in]  maxWorkers Number of servers probed at once, 0 for 8, at most 64.
+ * @param[in]  timeoutMs Timeout of each probe in milliseconds, 0 for the client default.
+ * @return @c EdgeResult code is 0 on success, otherwise an error value
+ * @retval #STATUS_OK Successful
+ * @retval #STATUS_PARAM_INVALID Invalid parameter
+ * @retval #STATUS_INTERNAL_ERROR Memory allocation failed
+ */
+EXPORT EdgeResult scanEndpointRange(const char *firstAddress, const char *lastAddress,
+        uint16_t port, size_t maxWorkers, uint32_t timeoutMs);
+
+/**
+ * @brief Caches the endpoints reported by getEndpointInfo() and scanEndpoints(). Until the
+ *        time to live ends, the endpoints of an endpoint Uri are reported again without a
+ *        request to the server. A server whose connection fails or is lost is dropped from
+ *        the cache. The cache is disabled by default.
+ * @param[in]  ttlMs Time to live of the cached endpoints in milliseconds, 0 disables the
+ *             cache and empties it.
+ */
+EXPORT void setEndpointCache(uint32_t ttlMs);
+
+/**
+ * @brief Drops cached endpoints, so that they are discovered again by the next request
+ * @param[in]  endpointUri Endpoint Uri of a server, all endpoint Uris with its address and
+ *             port are dropped. NULL drops all cached endpoints.
+ */
+EXPORT void invalidateEndpointCache(const char *endpointUri);
+
+/**
+ * @brief Follows the servers announced on the network by mDNS, as learnt by a local discovery
+ *        server with the multicast extension (LDS-ME). Each server is reported to
+ *        device_found_cb once when it appears, with its address, port and server name, and
+ *        once with EdgeDevice.removed set when its announcement ends. Endpoints of a reported
+ *        server are asked for with getEndpointInfo(). Needs open62541 built with
+ *        MULTICAST_DISCOVERY=1.
+ * @param[in]  ldsEndpointUri Endpoint Uri of the LDS-ME, e.g. "opc.tcp://localhost:4840".
+ * @param[in]  intervalMs Time between two queries of the LDS-ME in milliseconds,
+ *             0 for 5 seconds.
+ * @return @c EdgeResult code is 0 on success, otherwise an error value
+ * @retval #STATUS_OK Successful
+ * @retval #STATUS_PARAM_INVALID Invalid parameter
+ * @retval #STATUS_ALREADY_INIT Network discovery is already running
+ * @retval #STATUS_ERROR Multicast discovery is not built in, or it could not be started
+ */
+EXPORT EdgeResult startNetworkDiscovery(const char *ldsEndpointUri, uint32_t intervalMs);
+
+/**
+ * @brief Stops following the servers announced on the network
+ */
+EXPORT void stopNetworkDiscovery(void);
+
+/**
+ * @brief Sets the level of the records which are logged. Records are buffered per thread and
+ *        written by a log thread, so logging does not wait for the output. Records are dropped
+ *        while the buffer of a thread is full. The default is EDGE_LOG_LEVEL_DEBUG in DEBUG
+ *        builds and EDGE_LOG_LEVEL_NONE otherwise.
+ * @param[in]  level Highest level which is logged.
+ */
+EXPORT void setLogLevel(EdgeLogLevel level);
+
+/**
+ * @brief Sets the destination of the log records, the standard output by default
+ * @param[in]  sink Callback receiving the records on the log thread, NULL for the standard
+ *             output.
+ * @param[in]  context Context passed to the callback.
+ */
+EXPORT void setLogSink(EdgeLogSink sink, void *context);
+
+/**
+ * @brief Writes the buffered log records to the sink before returning
+ */
+EXPORT void flushLog(void);
+
+/**
+ * @brief Sets the hooks which are called when a request enters and leaves each stage of
+ *        EdgeTraceStage. Tracing is disabled by default and then costs one check per stage.
+ * @param[in]  hooks Hooks to call, they are copied. NULL disables tracing.
+ * @remarks Set the hooks while no requests are in flight, a stage which is traced while
+ *          they change may call the old hooks. A begin is not followed by an end when a
+ *          queued message is dropped by the overflow policy or conflated.
+ */
+EXPORT void setTraceHooks(const EdgeTraceHooks *hooks);
+
 /**
  * @brief Disconnect the client connection
  * @param[in]  epInfo End point information for server.
@@ -115,6 +237,50 @@ EXPORT void disconnectClient(EdgeEndPointInfo *epInfo);
  */
 EXPORT void configure(EdgeConfigure *config);
 
+/**
+ * @brief Sets the capacity and overflow policy of the send and receive queue,
+ *        the configurations are copied. Both queues are unbounded by default.
+ * @param[in]  sendConfig Send queue configuration, NULL keeps the current one.
+ *             A zeroed configuration makes the queue unbounded.
+ * @param[in]  recvConfig Receive queue configuration, NULL keeps the current one.
+ * @remarks Queues which are running already take the new bounds at once. Report conflation
+ *          and the report spool apply when the queues are started, so set them before the
+ *          first request is sent.
+ */
+EXPORT void setQueueConfig(const EdgeQueueConfig *sendConfig, const EdgeQueueConfig *recvConfig);
+
+/**
+ * @brief Delivers REPORT messages to monitored_msg_cb directly on the client thread,
+ *        bypassing the receive queue.
+ * @param[in]  enable true to deliver reports inline, false to queue them (default).
+ * @remarks The message is only valid during the callback and must not be freed or kept
+ *          by the application.
+ */
+EXPORT void setInlineReports(bool enable);
+
+/**
+ * @brief Collects the DATACHANGE notifications of a subscription received in one publish
+ *        response into one REPORT message with a response per notification, instead of one
+ *        REPORT message per notification. Not used with setInlineReports().
+ * @param[in]  enable true to batch the notifications, false for a message each (default).
+ */
+EXPORT void setBatchedReports(bool enable);
+
+/**
+ * @brief Numeric array values of read, method and REPORT responses which take at least this
+ *        many bytes keep the buffer decoded by the stack instead of being copied.
+ * @param[in]  bytes Size from which arrays are handed over, 0 copies all values (default).
+ */
+EXPORT void setZeroCopyArrayThreshold(size_t bytes);
+
+/**
+ * @brief Sets the attributes of each class of threads, they are copied.
+ *        They apply to the threads started afterwards.
+ * @param[in]  configs Attributes indexed by EdgeThreadClass, EDGE_THREAD_CLASSES of them.
+ *             A zeroed entry keeps the defaults of its class, NULL restores all defaults.
+ */
+EXPORT void setThreadConfig(const EdgeThreadConfig *configs);
+
 /**
  * @brief Add a new namespace to the server.
  * @param[in]  name Namespace name/URI
@@ -141,6 +307,36 @@ EXPORT EdgeResult createNamespace(const char *name, const char *rootNodeId,
 EXPORT EdgeResult createNode(const char *namespaceUri,
         EdgeNodeItem *item);
 
+/**
+ * @brief Add the nodes and then the references in the server in one pass.
+ * The namespaces are resolved once per call and the whole batch is validated before
+ * the first node is added, so an invalid batch adds nothing.
+ * @param[in]  namespaceUri Namespace URI of the nodes
+ * @param[in]  items Node information of each node, in the order they are added
+ * @param[in]  itemCount Number of nodes
+ * @param[in]  references References to add after the nodes, NULL if referenceCount is 0
+ * @param[in]  referenceCount Number of references
+ * @return @c EdgeResult code is 0 on success, otherwise an error value
+ * @retval #STATUS_OK Successful
+ * @retval #STATUS_PARAM_INVALID Invalid parameter
+ * @retval #STATUS_ERROR Operation failed
+ */
+EXPORT EdgeResult createNodes(const char *namespaceUri, EdgeNodeItem **items, size_t itemCount,
+        EdgeReference **references, size_t referenceCount);
+
+/**
+ * @brief Add the nodes and references of a precompiled binary nodeset file in the server.
+ * The file is mapped and its records are added in place, without node items. The whole
+ * file is validated before the first node is added, so an invalid file adds nothing.
+ * @param[in]  namespaceUri Namespace URI of the nodes
+ * @param[in]  path Path of the binary nodeset, generated by tools/nodeset2bin.py
+ * @return @c EdgeResult code is 0 on success, otherwise an error value
+ * @retval #STATUS_OK Successful
+ * @retval #STATUS_PARAM_INVALID Invalid parameter or malformed nodeset
+ * @retval #STATUS_ERROR Operation failed
+ */
+EXPORT EdgeResult loadNodeset(const char *namespaceUri, const char *path);
+
 /**
  * @brief Create a node item
  * @param[in]  name Browse name
@@ -168,6 +364,24 @@ EXPORT EdgeNodeItem* createNodeItem(const char* name, EdgeIdentifier nodeType,
 EXPORT EdgeNodeItem* createVariableNodeItem(const char* name, int type,
         void* data, EdgeIdentifier nodeType, double minimumInterval);
 
+/**
+ * @brief Create a Variable/Array node whose value is not stored in the server but produced by
+ * a read callback whenever the node is read or sampled, and passed to a write callback when
+ * the node is written.
+ * @param[in]  name Browse name
+ * @param[in]  type Node identifier
+ * @param[in]  nodeType Type of node (VARIABLE/ARRAY)
+ * @param[in]  readFn Read callback
+ * @param[in]  writeFn Write callback, NULL for a read-only node
+ * @param[in]  context Context passed to the callbacks
+ * @param[in]  minimumInterval Minimum sampling interval
+ * @return EdgeNodeItem created on success, otherwise NULL
+ * @remarks The callbacks are called in the server loop, they must not block.
+ */
+EXPORT EdgeNodeItem* createDataSourceNodeItem(const char* name, int type,
+        EdgeIdentifier nodeType, data_source_read_func readFn, data_source_write_func writeFn,
+        void *context, double minimumInterval);
+
 /**
  * @brief Delete a node item
  * @param[in]  item Node information like browse name etc.
@@ -187,10 +401,30 @@ EXPORT EdgeResult deleteNodeItem(EdgeNodeItem* item);
  * @retval #STATUS_OK Successful
  * @retval #STATUS_PARAM_INVALID Invalid parameter
  * @retval #STATUS_ERROR Operation failed
+ * @remarks With EdgeEndpointConfig.writeOnChange, a node added with createNode() which holds
+ * the value already is not written. Such calls succeed and are counted in
+ * EdgeServerStats.unchangedWriteCount.
  */
 EXPORT EdgeResult modifyVariableNode(const char *namespaceUri,
 		    const char *nodeUri, EdgeVersatility *value);
 
+/**
+ * @brief Modify many Variable/Array nodes of a namespace in one call.
+ * The namespace is resolved once, and every node is written even if another one fails.
+ * @param[in]  namespaceUri Namespace uri
+ * @param[in]  nodeUris Node browse name of each node
+ * @param[in]  values New value of each node
+ * @param[in]  count Number of nodes
+ * @return @c EdgeResult code is 0 on success, otherwise an error value
+ * @retval #STATUS_OK Successful
+ * @retval #STATUS_PARAM_INVALID Invalid parameter
+ * @retval #STATUS_ERROR Operation failed for at least one node
+ * @remarks Nodes added with createNode() are written straight away, without reading their
+ * value type from the node first.
+ */
+EXPORT EdgeResult modifyVariableNodes(const char *namespaceUri, const char **nodeUris,
+        EdgeVersatility **values, size_t count);
+
 /**
  * @brief Create a Method node
  * @param[in]  namespaceUri Namespace uri
@@ -204,6 +438,335 @@ EXPORT EdgeResult modifyVariableNode(const char *namespaceUri,
 EXPORT EdgeResult createMethodNode(const char *namespaceUri,
         EdgeNodeItem *item, EdgeMethod *method);
 
+/**
+ * @brief Create a Method node whose callback works on the arguments without copies.
+ * The view callback is called instead of method_fn of the method, which may be NULL.
+ * @param[in]  namespaceUri Namespace uri
+ * @param[in]  item Node information like browse name etc.
+ * @param[in]  method Input and Output arguments
+ * @param[in]  viewFn Method callback function without argument copies
+ * @return @c EdgeResult code is 0 on success, otherwise an error value
+ * @retval #STATUS_OK Successful
+ * @retval #STATUS_PARAM_INVALID Invalid parameter
+ * @retval #STATUS_ERROR Operation failed
+ */
+EXPORT EdgeResult createMethodNodeWithView(const char *namespaceUri,
+        EdgeNodeItem *item, EdgeMethod *method, method_view_func viewFn);
+
+/**
+ * @brief Create a Method node which runs on the method workers of the server instead of
+ * the server loop. Calls complete with GoodCompletesAsynchronously and no outputs.
+ * The outputs of each completed call are written to the "Output<n>" properties of the
+ * method node, whose NodeIds are the one of the method with an "_Output<n>" suffix,
+ * so clients can read or monitor them.
+ * @param[in]  namespaceUri Namespace uri
+ * @param[in]  item Node information like browse name etc.
+ * @param[in]  method Input and Output arguments
+ * @return @c EdgeResult code is 0 on success, otherwise an error value
+ * @retval #STATUS_OK Successful
+ * @retval #STATUS_PARAM_INVALID Invalid parameter
+ * @retval #STATUS_ERROR Operation failed
+ */
+EXPORT EdgeResult createAsyncMethodNode(const char *namespaceUri,
+        EdgeNodeItem *item, EdgeMethod *method);
+
+/**
+ * @brief Set the number of worker threads which run the methods of createAsyncMethodNode().
+ * The servers of the process share the workers, which start with the first server.
+ * The count applies when they are started next, the default is 2.
+ * @param[in]  count Number of worker threads, 0 for the default
+ */
+EXPORT void setMethodWorkerCount(uint32_t count);
+
+/**
+ * @brief Get the handle of a namespace, so that node APIs can skip resolving its uri.
+ * @param[in]  namespaceUri Namespace uri passed to createNamespace()
+ * @return Namespace handle on success, otherwise NULL if the namespace does not exist
+ * @remarks The handle is valid until closeServer() is called.
+ */
+EXPORT EdgeNamespace* getNamespaceHandle(const char *namespaceUri);
+
+/**
+ * @brief Add a new namespace to a server instance.
+ * @param[in]  server Server instance from createServerInstance()
+ * @param[in]  name Namespace name/URI
+ * @param[in]  rootNodeId Root Node identifier
+ * @param[in]  rootBrowseName Root Node Browse Name
+ * @param[in]  rootDisplayName Root Node Display Name
+ * @return @c EdgeResult code is 0 on success, otherwise an error value
+ * @retval #STATUS_OK Successful
+ * @retval #STATUS_PARAM_INVALID Invalid parameter
+ * @retval #STATUS_ERROR Operation failed
+ */
+EXPORT EdgeResult createNamespaceInInstance(EdgeServer *server, const char *name,
+        const char *rootNodeId, const char *rootBrowseName, const char *rootDisplayName);
+
+/**
+ * @brief Get the handle of a namespace of a server instance, for the handle APIs.
+ * @param[in]  server Server instance from createServerInstance()
+ * @param[in]  namespaceUri Namespace uri passed to createNamespaceInInstance()
+ * @return Namespace handle on success, otherwise NULL if the namespace does not exist
+ * @remarks The handle is valid until closeServerInstance() is called.
+ */
+EXPORT EdgeNamespace* getNamespaceHandleInInstance(EdgeServer *server, const char *namespaceUri);
+
+/**
+ * @brief Add the node in the namespace of the handle.
+ * @param[in]  ns Namespace handle from getNamespaceHandle()
+ * @param[in]  item Node information like browse name, display name, access level etc.
+ * @return @c EdgeResult code is 0 on success, otherwise an error value
+ * @retval #STATUS_OK Successful
+ * @retval #STATUS_PARAM_INVALID Invalid parameter
+ * @retval #STATUS_ERROR Operation failed
+ */
+EXPORT EdgeResult createNodeByHandle(const EdgeNamespace *ns, EdgeNodeItem *item);
+
+/**
+ * @brief Add the nodes and references of a binary nodeset file in the namespace of the handle.
+ * @param[in]  ns Namespace handle from getNamespaceHandle()
+ * @param[in]  path Path of the binary nodeset, generated by tools/nodeset2bin.py
+ * @return @c EdgeResult code is 0 on success, otherwise an error value
+ * @retval #STATUS_OK Successful
+ * @retval #STATUS_PARAM_INVALID Invalid parameter or malformed nodeset
+ * @retval #STATUS_ERROR Operation failed
+ */
+EXPORT EdgeResult loadNodesetByHandle(const EdgeNamespace *ns, const char *path);
+
+/**
+ * @brief Modify a Variable/Array node in the namespace of the handle
+ * @param[in]  ns Namespace handle from getNamespaceHandle()
+ * @param[in]  nodeUri Node browse name
+ * @param[in]  value new value to write
+ * @return @c EdgeResult code is 0 on success, otherwise an error value
+ * @retval #STATUS_OK Successful
+ * @retval #STATUS_PARAM_INVALID Invalid parameter
+ * @retval #STATUS_ERROR Operation failed
+ */
+EXPORT EdgeResult modifyVariableNodeByHandle(const EdgeNamespace *ns,
+        const char *nodeUri, EdgeVersatility *value);
+
+/**
+ * @brief Modify many Variable/Array nodes in the namespace of the handle in one call
+ * @param[in]  ns Namespace handle from getNamespaceHandle()
+ * @param[in]  nodeUris Node browse name of each node
+ * @param[in]  values New value of each node
+ * @param[in]  count Number of nodes
+ * @return @c EdgeResult code is 0 on success, otherwise an error value
+ * @retval #STATUS_OK Successful
+ * @retval #STATUS_PARAM_INVALID Invalid parameter
+ * @retval #STATUS_ERROR Operation failed for at least one node
+ */
+EXPORT EdgeResult modifyVariableNodesByHandle(const EdgeNamespace *ns, const char **nodeUris,
+        EdgeVersatility **values, size_t count);
+
+/**
+ * @brief Get the handle of a Variable/Array node for enqueueVariableNodeUpdate()
+ * @param[in]  ns Namespace handle from getNamespaceHandle()
+ * @param[in]  nodeUri Node browse name
+ * @return Handle of the node, otherwise NULL
+ * @remarks Only nodes added with createNode() have a handle.
+ */
+EXPORT EdgeVariableNode* getVariableNodeHandle(const EdgeNamespace *ns, const char *nodeUri);
+
+/**
+ * @brief Queue a new value of a Variable/Array node without waiting for the server.
+ * The value is copied in the calling thread and handed to the server loop without locks,
+ * which writes the queued values in batches between its iterations.
+ * It may be called from many threads at once while the server is running.
+ * @param[in]  node Node handle from getVariableNodeHandle()
+ * @param[in]  value new value to write
+ * @return @c EdgeResult code is 0 on success, otherwise an error value
+ * @retval #STATUS_OK Successful
+ * @retval #STATUS_PARAM_INVALID Invalid parameter
+ * @retval #STATUS_ENQUEUE_ERROR The queue is full, see EdgeEndpointConfig.updateQueueSize
+ * @retval #STATUS_ERROR Operation failed
+ * @remarks Errors of the write itself are only logged by the server.
+ */
+EXPORT EdgeResult enqueueVariableNodeUpdate(EdgeVariableNode *node, const EdgeVersatility *value);
+
+/**
+ * @brief Publish the values of Variable/Array nodes over UDP as OPC UA PubSub UADP messages.
+ * Each message carries one key frame DataSet whose fields are the values of the nodes, read
+ * by the server loop every publishing interval and sent to the address of the configuration,
+ * usually a multicast group, without a session or an encoding per client.
+ * Fields are built-in scalars and arrays from Boolean to ByteString.
+ * @param[in]  nodes Node handles from getVariableNodeHandle(), all of one server
+ * @param[in]  nodeCount Number of nodes
+ * @param[in]  config Address, ids and publishing interval of the messages
+ * @return Handle of the publisher, otherwise NULL
+ * @remarks The publisher starts with the next iteration of the server loop.
+ *          Messages larger than EdgePubSubConfig.maxMessageSize are not sent.
+ */
+EXPORT EdgePublisher* createPubSubPublisher(EdgeVariableNode **nodes, size_t nodeCount,
+        const EdgePubSubConfig *config);
+
+/**
+ * @brief Stop a publisher of createPubSubPublisher(), the server loop deletes it
+ * @param[in]  publisher Publisher handle
+ * @return @c EdgeResult code is 0 on success, otherwise an error value
+ * @retval #STATUS_OK Successful
+ * @retval #STATUS_PARAM_INVALID Invalid parameter
+ * @remarks The publishers left are deleted when the server is closed.
+ */
+EXPORT EdgeResult deletePubSubPublisher(EdgePublisher *publisher);
+
+/**
+ * @brief Receive the DataSets of a PubSub publisher on a thread of the subscriber.
+ * Each DataSet is passed to monitored_msg_cb as a REPORT message with a response per field,
+ * whose value alias is the one of the field. Empty fields are left out.
+ * The endpoint Uri of the reports is "opc.udp://<address>:<port>".
+ * @param[in]  config Address and ids of the messages to receive
+ * @param[in]  valueAliases Value alias of each field of the DataSet
+ * @param[in]  fieldCount Number of fields, DataSets with more fields are dropped
+ * @return Handle of the subscriber, otherwise NULL
+ */
+EXPORT EdgeSubscriber* createPubSubSubscriber(const EdgePubSubConfig *config,
+        const char **valueAliases, size_t fieldCount);
+
+/**
+ * @brief Stop a subscriber of createPubSubSubscriber() and delete it
+ * @param[in]  subscriber Subscriber handle
+ */
+EXPORT void deletePubSubSubscriber(EdgeSubscriber *subscriber);
+
+/**
+ * @brief Create a shared memory ring through which other processes of the host read messages.
+ * Messages are stored in a flat form which consumers read in place, see openShmConsumer().
+ * A ring of the same name is replaced.
+ * @param[in]  name Name of the shared memory, like "/edge_reports"
+ * @param[in]  size Size of the ring in bytes, 0 for 16 MiB
+ * @return Handle of the publisher, otherwise NULL
+ * @remarks Not supported on Windows.
+ */
+EXPORT EdgeShmPublisher* createShmPublisher(const char *name, size_t size);
+
+/**
+ * @brief Store a message in a shared memory ring, usually from a receive callback.
+ * Values of the plain built-in types, strings, QualifiedNames and LocalizedTexts are stored,
+ * other values are left out. The oldest messages are overwritten when the ring is full.
+ * @param[in]  publisher Publisher handle
+ * @param[in]  msg Message, it is not taken over
+ * @return @c EdgeResult code is 0 on success, otherwise an error value
+ * @retval #STATUS_OK Successful
+ * @retval #STATUS_PARAM_INVALID Invalid parameter
+ * @retval #STATUS_ENQUEUE_ERROR Message is larger than half of the ring
+ */
+EXPORT EdgeResult publishShmMessage(EdgeShmPublisher *publisher, const EdgeMessage *msg);
+
+/**
+ * @brief Delete a publisher of createShmPublisher() and remove the name of its ring.
+ * Consumers keep reading the messages stored before.
+ * @param[in]  publisher Publisher handle
+ */
+EXPORT void deleteShmPublisher(EdgeShmPublisher *publisher);
+
+/**
+ * @brief Open a shared memory ring of createShmPublisher() in another process.
+ * Reading starts with the next message which is published.
+ * @param[in]  name Name of the shared memory
+ * @return Handle of the consumer, otherwise NULL
+ */
+EXPORT EdgeShmConsumer* openShmConsumer(const char *name);
+
+/**
+ * @brief Read the next message of a shared memory ring, it stays valid until the next call.
+ * Messages which were overwritten before they were read are counted by getShmLostCount().
+ * @param[in]  consumer Consumer handle
+ * @param[in]  timeoutMs Time to wait for a message in milliseconds, 0 returns at once
+ * @return Message in the ring, NULL if none was published in time
+ * @remarks Offsets of the message are relative to the message, use getShmString(),
+ *          getShmResponse() and getShmValue() to read its parts.
+ */
+EXPORT const EdgeShmMessage* readShmMessage(EdgeShmConsumer *consumer, uint32_t timeoutMs);
+
+/**
+ * @brief Finish reading the message of readShmMessage() and check that it is intact.
+ * @param[in]  consumer Consumer handle
+ * @return true if the publisher did not overwrite the message while it was read
+ */
+EXPORT bool releaseShmMessage(EdgeShmConsumer *consumer);
+
+/**
+ * @brief Get a string of the message read last, it is terminated by '\0'
+ * @param[in]  consumer Consumer handle
+ * @param[in]  str String of the message
+ * @return the string, NULL if it is not set
+ */
+EXPORT const char* getShmString(const EdgeShmConsumer *consumer, EdgeShmString str);
+
+/**
+ * @brief Get a response of the message read last
+ * @param[in]  consumer Consumer handle
+ * @param[in]  index Index of the response, less than EdgeShmMessage.responseCount
+ * @return the response, otherwise NULL
+ */
+EXPORT const EdgeShmResponse* getShmResponse(const EdgeShmConsumer *consumer, size_t index);
+
+/**
+ * @brief Get the value of a response of the message read last.
+ * It is one value or arrayLength values of the type of EdgeShmResponse.valueKind:
+ * the Edge representation of the type for EDGE_SHM_VALUE_PLAIN, otherwise EdgeShmString,
+ * EdgeShmQualifiedName or EdgeShmLocalizedText.
+ * @param[in]  consumer Consumer handle
+ * @param[in]  response Response of getShmResponse()
+ * @return the value, NULL if the response has none
+ */
+EXPORT const void* getShmValue(const EdgeShmConsumer *consumer, const EdgeShmResponse *response);
+
+/**
+ * @brief Get the number of messages a consumer lost because they were overwritten
+ * @param[in]  consumer Consumer handle
+ * @return the number of lost messages
+ */
+EXPORT uint64_t getShmLostCount(const EdgeShmConsumer *consumer);
+
+/**
+ * @brief Close a consumer of openShmConsumer()
+ * @param[in]  consumer Consumer handle
+ */
+EXPORT void closeShmConsumer(EdgeShmConsumer *consumer);
+
+/**
+ * @brief Create a Method node in the namespace of the handle
+ * @param[in]  ns Namespace handle from getNamespaceHandle()
+ * @param[in]  item Node information like browse name etc.
+ * @param[in]  method Input and Output arguments
+ * @return @c EdgeResult code is 0 on success, otherwise an error value
+ * @retval #STATUS_OK Successful
+ * @retval #STATUS_PARAM_INVALID Invalid parameter
+ * @retval #STATUS_ERROR Operation failed
+ */
+EXPORT EdgeResult createMethodNodeByHandle(const EdgeNamespace *ns,
+        EdgeNodeItem *item, EdgeMethod *method);
+
+/**
+ * @brief Get the storage of an output argument inside a method_view_func call
+ * of a node created with createMethodNodeWithView().
+ * It holds one value of the argument type for SCALAR arguments and arrayLength values
+ * for ARRAY_1D ones, which the method writes in place. The value is sent without copies.
+ * @param[in]  outputs Output arguments passed to the method
+ * @param[in]  index Index of the output argument
+ * @return Zeroed storage of the argument, the same on every call, otherwise NULL
+ * @remarks String arguments are Edge_String values, they are set with setMethodOutputString().
+ */
+EXPORT void *getMethodOutputBuffer(EdgeMethodOutputs *outputs, size_t index);
+
+/**
+ * @brief Set a string output argument, or one element of a string array output argument,
+ * inside a method_view_func call. The string is copied once into the response.
+ * @param[in]  outputs Output arguments passed to the method
+ * @param[in]  index Index of the output argument
+ * @param[in]  element Index of the array element, 0 for SCALAR arguments
+ * @param[in]  data String data, it need not be NUL-terminated
+ * @param[in]  length Length of the string data
+ * @return @c EdgeResult code is 0 on success, otherwise an error value
+ * @retval #STATUS_OK Successful
+ * @retval #STATUS_PARAM_INVALID Invalid parameter
+ * @retval #STATUS_ERROR Operation failed
+ */
+EXPORT EdgeResult setMethodOutputString(EdgeMethodOutputs *outputs, size_t index, size_t element,
+        const char *data, size_t length);
+
 /**
  * @brief Create node references
  * @param[in]  reference Source and Target node information to create reference
@@ -219,6 +782,49 @@ EXPORT EdgeResult addReference(EdgeReference *reference);
  */
 EXPORT void showNodeList(void);
 
+/**
+ * @brief Gets the runtime statistics of the server of createServer(): sessions, nodestore size
+ *        and the calls which reached data source and method callbacks, with their durations.
+ *        The counters are cheap to read and are kept while the server runs.
+ * @param[out] stats Receives the statistics
+ * @return @c EdgeResult code is 0 on success, otherwise an error value
+ * @retval #STATUS_OK Successful
+ * @retval #STATUS_PARAM_INVALID Invalid parameter
+ * @retval #STATUS_ERROR Server is not running
+ */
+EXPORT EdgeResult getServerStats(EdgeServerStats *stats);
+
+/**
+ * @brief Gets the runtime statistics of a server instance of createServerInstance()
+ * @param[in]  server Server instance
+ * @param[out] stats Receives the statistics
+ * @return @c EdgeResult code is 0 on success, otherwise an error value
+ * @retval #STATUS_OK Successful
+ * @retval #STATUS_PARAM_INVALID Invalid parameter
+ * @retval #STATUS_ERROR Server is not running
+ */
+EXPORT EdgeResult getServerInstanceStats(EdgeServer *server, EdgeServerStats *stats);
+
+/**
+ * @brief Gets the runtime statistics of the sessions of a client endpoint: requests of each
+ *        kind with their service durations, errors and timeouts, bytes on the connection,
+ *        reconnects, subscriptions and notifications.
+ * @param[in]  endpointUri Endpoint Uri of the client
+ * @param[out] stats Receives the statistics
+ * @return @c EdgeResult code is 0 on success, otherwise an error value
+ * @retval #STATUS_OK Successful
+ * @retval #STATUS_PARAM_INVALID Invalid parameter
+ * @retval #STATUS_ERROR Endpoint is not connected
+ */
+EXPORT EdgeResult getClientStats(const char *endpointUri, EdgeClientStats *stats);
+
+/**
+ * @brief Formats the statistics of all connected client endpoints in the Prometheus text
+ *        exposition format, one series per endpoint with an endpoint label
+ * @return Text on success, to be freed with EdgeFree(), otherwise NULL
+ */
+EXPORT char *getClientMetricsText(void);
+
 /**
  * @brief Send the EdgeMessage request to queue for processing
  * @param[in]  msg EdgeMessage request data
@@ -229,6 +835,266 @@ EXPORT void showNodeList(void);
  */
 EXPORT EdgeResult sendRequest(EdgeMessage* msg);
 
+/**
+ * @brief Send the EdgeMessage request to queue for processing without copying it
+ * @param[in]  msg EdgeMessage request data created by createEdgeMessage() or a
+ *             related API. Ownership moves to the library whatever the result,
+ *             so msg must not be used or destroyed by the caller after this call.
+ * @return @c EdgeResult code is 0 on success, otherwise an error value
+ * @retval #STATUS_OK Successful
+ * @retval #STATUS_PARAM_INVALID Invalid parameter
+ * @retval #STATUS_ENQUEUE_ERROR Send queue did not accept the request
+ * @remarks Values inserted by reference, like the buffer given to
+ *          insertWriteAccessNode(), must stay valid until the response is received.
+ */
+EXPORT EdgeResult sendRequestTake(EdgeMessage* msg);
+
+/**
+ * @brief Send the EdgeMessage request to queue for processing, like sendRequest(), and
+ *        get a future which collects its responses.
+ *        GENERAL_RESPONSE, BROWSE_RESPONSE and ERROR_RESPONSE messages of the request skip
+ *        the receive queue and its callbacks until the request is finished, i.e. until it
+ *        is executed and the responses of its service calls have arrived.
+ * @param[in]  msg EdgeMessage request data. A message has one future at a time, the
+ *             requests of the message which are sent meanwhile are collected by it too.
+ * @return EdgeFuture to be destroyed with destroyFuture(), NULL on error or if the message
+ *         already has a future
+ * @remarks Reports of a subscription are always delivered to the callbacks.
+ */
+EXPORT EdgeFuture* sendRequestAsync(EdgeMessage* msg);
+
+/**
+ * @brief Waits until the request of the future is finished
+ * @param[in]  future EdgeFuture returned by sendRequestAsync()
+ * @param[in]  timeoutMs Milliseconds to wait, 0 waits without a limit
+ * @return @c EdgeResult code is 0 on success, otherwise an error value
+ * @retval #STATUS_OK Request is finished, all its responses are in the future
+ * @retval #STATUS_PARAM_INVALID Invalid parameter
+ * @retval #STATUS_REQUEST_TIMEOUT Request is not finished yet
+ * @remarks A request whose session is lost before its service responses arrive does not
+ *          finish, so a limited timeout is recommended.
+ */
+EXPORT EdgeResult waitFuture(EdgeFuture *future, uint32_t timeoutMs);
+
+/**
+ * @brief Gets the number of response messages collected by the future
+ * @param[in]  future EdgeFuture returned by sendRequestAsync()
+ * @return Number of the messages, final once waitFuture() returned #STATUS_OK
+ */
+EXPORT size_t getFutureResponseCount(EdgeFuture *future);
+
+/**
+ * @brief Gets a response message collected by the future
+ * @param[in]  future EdgeFuture returned by sendRequestAsync()
+ * @param[in]  index Index of the message, in the order of arrival
+ * @return EdgeMessage owned by the future, valid until destroyFuture(). NULL if the index
+ *         is out of range.
+ */
+EXPORT EdgeMessage* getFutureResponse(EdgeFuture *future, size_t index);
+
+/**
+ * @brief Destroys the future with its response messages.
+ *        Responses of an unfinished request are delivered to the callbacks afterwards.
+ * @param[in]  future EdgeFuture returned by sendRequestAsync()
+ */
+EXPORT void destroyFuture(EdgeFuture *future);
+
+/**
+ * @brief Sends the EdgeMessage request and waits for its response on the calling thread.
+ *        The first GENERAL_RESPONSE or BROWSE_RESPONSE message of the request is returned,
+ *        or its first ERROR_RESPONSE if there is none. Its other messages are delivered to
+ *        the callbacks.
+ * @param[in]  msg EdgeMessage request data
+ * @param[in]  timeoutMs Milliseconds to wait, 0 waits without a limit
+ * @param[out] response Response message to be destroyed with destroyEdgeMessage().
+ *             NULL if the request finished without a response, like a write which reports
+ *             errors only.
+ * @return @c EdgeResult code is 0 on success, otherwise an error value
+ * @retval #STATUS_OK Request is finished
+ * @retval #STATUS_PARAM_INVALID Invalid parameter
+ * @retval #STATUS_ENQUEUE_ERROR Send queue did not accept the request
+ * @retval #STATUS_REQUEST_TIMEOUT Request is not finished, its responses are delivered
+ *         to the callbacks
+ */
+EXPORT EdgeResult sendRequestAndWait(EdgeMessage* msg, uint32_t timeoutMs, EdgeMessage **response);
+
+/**
+ * @brief Prepares a read request for cyclic polling. The request is copied and its
+ *        nodes to read are built once, so every cycle only exchanges the read with the server.
+ *        Responses of all cycles carry the message_id of msg.
+ * @param[in]  msg EdgeMessage request data with CMD_READ or CMD_READ_SAMPLING_INTERVAL command.
+ *             The caller keeps the ownership of msg.
+ * @return Prepared read on success, otherwise NULL. Destroy it with destroyPreparedRead().
+ */
+EXPORT EdgePreparedRead* prepareRead(EdgeMessage *msg);
+
+/**
+ * @brief Send one cycle of a prepared read to queue for processing
+ * @param[in]  read Prepared read created by prepareRead()
+ * @return @c EdgeResult code is 0 on success, otherwise an error value
+ * @retval #STATUS_OK Successful
+ * @retval #STATUS_PARAM_INVALID Invalid parameter
+ * @retval #STATUS_ENQUEUE_ERROR Send queue did not accept the request
+ */
+EXPORT EdgeResult sendPreparedRead(EdgePreparedRead *read);
+
+/**
+ * @brief Starts sending a cycle of a prepared read every intervalMs milliseconds.
+ *        A cycle is skipped while the previous one is still waiting in the send queue.
+ * @param[in]  read Prepared read created by prepareRead()
+ * @param[in]  intervalMs Cycle time in milliseconds
+ * @return @c EdgeResult code is 0 on success, otherwise an error value
+ * @retval #STATUS_OK Successful
+ * @retval #STATUS_PARAM_INVALID Invalid parameter
+ * @retval #STATUS_ALREADY_INIT Periodic read is already running
+ * @retval #STATUS_ERROR Operation failed
+ */
+EXPORT EdgeResult startPeriodicRead(EdgePreparedRead *read, uint32_t intervalMs);
+
+/**
+ * @brief Stops the periodic read started by startPeriodicRead()
+ * @param[in]  read Prepared read created by prepareRead()
+ */
+EXPORT void stopPeriodicRead(EdgePreparedRead *read);
+
+/**
+ * @brief Stops and deallocates a prepared read. Cycles still in the send queue are dropped.
+ * @param[in]  read Prepared read created by prepareRead()
+ */
+EXPORT void destroyPreparedRead(EdgePreparedRead *read);
+
+/**
+ * @brief Configures the coalescing of write requests. CMD_WRITE messages of one endpoint are
+ *        collected until maxNodes nodes are pending or windowMs milliseconds have passed since
+ *        the first of them, then they are sent in one write request.
+ *        Every message still receives its own response with its message_id.
+ * @param[in]  maxNodes Number of pending nodes which sends the write request at once,
+ *             0 disables coalescing (default).
+ * @param[in]  windowMs Time in milliseconds a write waits for others at most.
+ * @return @c EdgeResult code is 0 on success, otherwise an error value
+ * @retval #STATUS_OK Successful
+ * @retval #STATUS_PARAM_INVALID Invalid parameter
+ * @retval #STATUS_ERROR Operation failed
+ * @remarks A read sent after a coalesced write may be executed before the write.
+ */
+EXPORT EdgeResult configureWriteCoalescing(size_t maxNodes, uint32_t windowMs);
+
+/**
+ * @brief Enables sharing of identical reads. A CMD_READ or CMD_READ_SAMPLING_INTERVAL message
+ *        which reads the same nodes and attributes of an endpoint with the same maxAge as a
+ *        read in flight is not sent, it receives the response of that read.
+ *        Every message still receives its own response with its message_id.
+ * @param[in]  enable true to share the reads, false to send each of them (default).
+ * @remarks Reads served from the value cache are not sent, so they are not shared either.
+ */
+EXPORT void setReadSharing(bool enable);
+
+/**
+ * @brief Gets the statistics of the send and receive queue
+ * @param[out] sendStats Send queue statistics, can be NULL
+ * @param[out] recvStats Receive queue statistics, can be NULL
+ * @return @c EdgeResult code is 0 on success, otherwise an error value
+ * @retval #STATUS_OK Successful
+ * @retval #STATUS_PARAM_INVALID Invalid parameter
+ * @retval #STATUS_ERROR Queues are not initialized
+ */
+EXPORT EdgeResult getQueueStats(EdgeQueueStats *sendStats, EdgeQueueStats *recvStats);
+
+/**
+ * @brief Resets the counters, high-water depth and wait time histogram of the
+ *        send and receive queue. Current depth is kept.
+ */
+EXPORT void resetQueueStats(void);
+
+/**
+ * @brief Records the notification latency of each subscription, see getReportLatency().
+ * @param[in]  enable true to record the latencies, false to skip them (default).
+ */
+EXPORT void setReportLatency(bool enable);
+
+/**
+ * @brief Gets the notification latencies of a subscription.
+ *        They are recorded when setReportLatency() is enabled.
+ * @param[in]  messageId message_id of the create request of the subscription,
+ *             its REPORT messages carry the same message_id
+ * @param[out] latency Latency histograms of each delivery stage
+ * @return @c EdgeResult code is 0 on success, otherwise an error value
+ * @retval #STATUS_OK Successful
+ * @retval #STATUS_PARAM_INVALID Invalid parameter
+ * @retval #STATUS_ERROR No report of the subscription was recorded
+ */
+EXPORT EdgeResult getReportLatency(uint32_t messageId, EdgeReportLatency *latency);
+
+/**
+ * @brief Discards the notification latencies of all subscriptions.
+ */
+EXPORT void resetReportLatency(void);
+
+/**
+ * @brief Keeps the results of browse requests to an endpoint in a snapshot file.
+ *        A browse request to the endpoint is answered from the file when it was saved for the
+ *        same start nodes and browse parameters, and the namespace array and build information
+ *        of the server are unchanged. Otherwise the server is browsed and the file is replaced.
+ * @param[in]  endpointUri Endpoint of the server
+ * @param[in]  path Snapshot file, NULL to browse the endpoint without a snapshot
+ * @return @c EdgeResult code is 0 on success, otherwise an error value
+ * @retval #STATUS_OK Successful
+ * @retval #STATUS_PARAM_INVALID Invalid parameter
+ * @retval #STATUS_INTERNAL_ERROR Memory allocation failed
+ */
+EXPORT EdgeResult setBrowseSnapshot(const char *endpointUri, const char *path);
+
+/**
+ * @brief Sets the number of sessions opened to an endpoint. Reads, writes, method calls and
+ *        browse requests are executed on any free session of the endpoint, so that up to this
+ *        many of them are in flight at once. Subscriptions, registered nodes, prepared reads,
+ *        translated browse paths and coalesced writes keep to the first session.
+ * @param[in]  endpointUri Endpoint of the server
+ * @param[in]  sessions Number of sessions, at most EDGE_MAX_SESSION_POOL_SIZE.
+ *             0 or 1 opens one session (default).
+ * @return @c EdgeResult code is 0 on success, otherwise an error value
+ * @retval #STATUS_OK Successful
+ * @retval #STATUS_PARAM_INVALID Invalid parameter
+ * @retval #STATUS_INTERNAL_ERROR Memory allocation failed
+ * @remarks The sessions are opened with the next connection to the endpoint. Requests run in
+ *          parallel only with the send lanes of ENABLE_SEND_LANES, and a read sent after a
+ *          write may then be executed before the write.
+ */
+EXPORT EdgeResult setSessionPoolSize(const char *endpointUri, size_t sessions);
+
+/**
+ * @brief Configures the reconnection of client sessions whose connection is lost.
+ *        The same session is activated again on a new secure channel if the server still keeps
+ *        it, otherwise a new one is created. STATUS_DISCONNECTED and STATUS_CONNECTED are
+ *        reported to network_cb as before. Sessions with subscriptions are recovered by their
+ *        publish requests instead.
+ * @param[in]  config Backoff and request buffering, NULL disables reconnecting.
+ * @return @c EdgeResult code is 0 on success, otherwise an error value
+ * @retval #STATUS_OK Successful
+ * @retval #STATUS_PARAM_INVALID Invalid parameter
+ * @retval #STATUS_ERROR Operation failed
+ * @remarks Requests queued while a session is lost are kept in the send queue and executed
+ *          in order once it is connected again, each waiting at most requestBufferMs.
+ */
+EXPORT EdgeResult setClientReconnect(const EdgeReconnectConfig *config);
+
+/**
+ * @brief Sets whether the receive time of every notification is converted to local time.
+ *        When it is not, serverTime.timeInfo of REPORT messages is NULL and
+ *        getEdgeLocalTime() converts it when needed.
+ * @param[in]  enable true to convert the time of each notification (default), false to skip it.
+ */
+EXPORT void setLocalTimeConversion(bool enable);
+
+/**
+ * @brief Converts the wall clock time of an EdgeTimeInfo to local time,
+ *        e.g. for REPORT messages received with setLocalTimeConversion() disabled.
+ * @param[in]  timeInfo Time to convert
+ * @param[out] localTime Broken-down local time
+ * @return localTime on success, NULL in case of error
+ */
+EXPORT struct tm *getEdgeLocalTime(const EdgeTimeInfo *timeInfo, struct tm *localTime);
+
 /**
  * @brief Deallocates the dynamic memory for EdgeResult. \n
                   Behaviour is undefined if EdgeResult is not dynamically allocated.
@@ -363,6 +1229,19 @@ EXPORT EdgeResult insertSubParameter(EdgeMessage **msg, const char* nodeName,
         int lifetimeCount, int maxNotificationsPerPublish, bool publishingEnabled, int priority,
         uint32_t queueSize);
 
+/**
+ * @brief Set the data change filter of the Monitored Item which was inserted last
+ * @param[in]  msg EdgeMessage request of a Create or Modify subscription
+ * @param[in]  trigger Data changes which are notified
+ * @param[in]  deadbandType Deadband type
+ * @param[in]  deadbandValue Deadband value, absolute or in percent of the EURange
+ * @return @c EdgeResult code is 0 on success, otherwise an error value
+ * @retval #STATUS_OK Successful
+ * @retval #STATUS_PARAM_INVALID Invalid parameter
+ */
+EXPORT EdgeResult insertSubFilter(EdgeMessage *msg, EdgeDataChangeTrigger trigger,
+        EdgeDeadbandType deadbandType, double deadbandValue);
+
 /**
  * @brief Create EdgeMessage for Subscription Services
  * @param[in]  endpointUri Endpoint Uri
@@ -397,7 +1276,13 @@ EXPORT EdgeMessage* createEdgeAttributeMessage(const char *endpointUri,
 EXPORT EdgeMessage* createEdgeMessage(const char *endpointUri, size_t requestSize, EdgeCommand cmd);
 
 /**
- * @brief Insert Read Access to the EdgeMessage request data
+ * @brief Insert Read Access to the EdgeMessage request data.
+ * It also adds the nodes of CMD_REGISTER_NODES and CMD_UNREGISTER_NODES requests.
+ * Reads and writes of registered nodes use the NodeIds returned by the server.
+ * The nodes of a CMD_TRANSLATE_BROWSE_PATHS request are browse paths relative to the Objects
+ * folder, like "{2;S;v=0}Robot/0:Speed". Each response carries the resolved NodeId and the status
+ * of its path, and later reads, writes and subscriptions of the node name use the resolved NodeId.
+ * It also adds the nodes of CMD_HISTORY_READ requests, see insertHistoryReadParameter().
  * @param[in]  msg EdgeMessage request
  * @param[in]  nodeName Node name
  * @param[out]  msg EdgeMessage request
@@ -408,6 +1293,22 @@ EXPORT EdgeMessage* createEdgeMessage(const char *endpointUri, size_t requestSiz
  */
 EXPORT EdgeResult insertReadAccessNode(EdgeMessage **msg, const char* nodeName);
 
+/**
+ * @brief Insert Read Access of an attribute to the EdgeMessage request data.
+ * Nodes of one CMD_READ message may read different attributes, they are read in one request.
+ * The attribute of each response is given by EdgeResponse.attributeId.
+ * @param[in]  msg EdgeMessage request with CMD_READ command
+ * @param[in]  nodeName Node name
+ * @param[in]  attributeId Attribute to read
+ * @param[out]  msg EdgeMessage request
+ * @return @c EdgeResult code is 0 on success, otherwise an error value
+ * @retval #STATUS_OK Successful
+ * @retval #STATUS_PARAM_INVALID Invalid parameter
+ * @retval #STATUS_ERROR Operation failed
+ */
+EXPORT EdgeResult insertReadAttributeNode(EdgeMessage **msg, const char* nodeName,
+        EdgeAttributeId attributeId);
+
 /**
  * @brief Insert Write Access to the EdgeMessage request data
  * @param[in]  msg EdgeMessage request
@@ -438,7 +1339,10 @@ EXPORT EdgeResult insertWriteAccessNodeWithValueType(EdgeMessage **msg, const ch
         size_t valueCount, int valueType);
 
 /**
- * @brief Insert method parameters to the EdgeMessage request
+ * @brief Insert method parameters to the EdgeMessage request.
+ * In a message of multiple requests, the arguments are added to the last method request until
+ * it has inputParameterSize arguments, the next call starts a new method request. All method
+ * requests of the message are sent in one Call service request.
  * @param[in]  msg EdgeMessage Request
  * @param[in]  nodeName Node name
  * @param[in]  inputParameterSize Number of input arguments
@@ -461,7 +1365,8 @@ EXPORT EdgeResult insertEdgeMethodParameter(EdgeMessage **msg, const char* nodeN
  * @brief Insert browse parameter to the EdgeMessage request
  * @param[in]  msg EdgeMessage Request
  * @param[in]  nodeInfo Node information
- * @param[in]  parameter Browse parameters such as browse direction, max references per node to browse.
+ * @param[in]  parameter Browse parameters such as browse direction, max references per node to browse,
+ *             depth and result limits and a callback which can stop the browse.
  * @param[out]  msg EdgeMessage Request
  * @return @c EdgeResult code is 0 on success, otherwise an error value
  * @retval #STATUS_OK Successful
@@ -471,6 +1376,24 @@ EXPORT EdgeResult insertEdgeMethodParameter(EdgeMessage **msg, const char* nodeN
 EXPORT EdgeResult insertBrowseParameter(EdgeMessage **msg, EdgeNodeInfo* nodeInfo,
         EdgeBrowseParameter parameter);
 
+/**
+ * @brief Insert the history read parameter to the EdgeMessage request.
+ * The nodes of a CMD_HISTORY_READ request are added with insertReadAccessNode().
+ * Values are passed on in chunks as the server returns them, one GENERAL_RESPONSE per node and
+ * request, whose responses carry the values with their timestamps. Further chunks of a node are
+ * read with the continuation points of the server while hasMoreValues is set.
+ * @param[in]  msg EdgeMessage Request
+ * @param[in]  parameter Kind of read, period, aggregate and chunk size, and a callback which
+ *             receives the chunks and can stop the history read.
+ * @param[out]  msg EdgeMessage Request
+ * @return @c EdgeResult code is 0 on success, otherwise an error value
+ * @retval #STATUS_OK Successful
+ * @retval #STATUS_PARAM_INVALID Invalid parameter
+ * @retval #STATUS_ERROR Operation failed
+ */
+EXPORT EdgeResult insertHistoryReadParameter(EdgeMessage **msg,
+        const EdgeHistoryParameter *parameter);
+
 /* Get the value type of the variable node */
 /**
  * @brief Get the value type of the variable node
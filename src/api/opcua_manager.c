@@ -21,8 +21,24 @@
 #include "opcua_manager.h"
 #include "edge_opcua_server.h"
 #include "edge_opcua_client.h"
+#include "edge_node.h"
+#include "prepared_read.h"
+#include "write_coalesce.h"
+#include "read_share.h"
 #include "message_dispatcher.h"
+#include "report_latency.h"
+#include "request_future.h"
+#include "browse_snapshot.h"
+#include "edge_reconnect.h"
+#include "edge_discovery_scan.h"
+#include "edge_endpoint_cache.h"
+#include "edge_network_discovery.h"
+#include "edge_pubsub.h"
+#include "edge_shm_transport.h"
+#include "cmd_util.h"
 #include "edge_logger.h"
+#include "edge_trace.h"
+#include "edge_thread_config.h"
 #include "edge_utils.h"
 #include "edge_open62541.h"
 #include "edge_malloc.h"
@@ -41,6 +57,7 @@ static ReceivedMessageCallback *receivedMsgCb;
 static StatusCallback *statusCb;
 static DiscoveryCallback *discoveryCb;
 
+#ifndef DISABLE_SERVER
 static bool b_serverInitialized = false;
 
 void showNodeList(void)
@@ -48,6 +65,27 @@ void showNodeList(void)
     printNodeListInServer();
 }
 
+EdgeResult getServerStats(EdgeServerStats *stats)
+{
+    return getDefaultServerStats(stats);
+}
+
+EdgeResult getServerInstanceStats(EdgeServer *server, EdgeServerStats *stats)
+{
+    return getServerStatsInServer(server, stats);
+}
+#endif
+
+EdgeResult getClientStats(const char *endpointUri, EdgeClientStats *stats)
+{
+    return getClientStatsInClient(endpointUri, stats);
+}
+
+char *getClientMetricsText(void)
+{
+    return getClientMetricsTextInClient();
+}
+
 static void registerRecvCallback(ReceivedMessageCallback *callback)
 {
     receivedMsgCb = callback;
@@ -77,11 +115,40 @@ void configure(EdgeConfigure *config)
         In case if server application sets this parameter, it will not be used anywhere in the stack. */
     setSupportedApplicationTypes(config->supportedApplicationTypes);
 
-    registerClientCallback(onResponseMessage, onStatusCallback, onDiscoveryCallback);
+    registerClientCallback(onResponseMessage, onStatusCallback, onDiscoveryCallback,
+            onDeviceCallback);
+#ifndef DISABLE_SERVER
     registerServerCallback(onStatusCallback);
+#endif
     registerMQCallback(onResponseMessage, onSendMessage);
 }
 
+void setQueueConfig(const EdgeQueueConfig *sendConfig, const EdgeQueueConfig *recvConfig)
+{
+    set_queue_config(sendConfig, recvConfig);
+}
+
+void setInlineReports(bool enable)
+{
+    set_inline_reports(enable);
+}
+
+void setBatchedReports(bool enable)
+{
+    set_batched_reports(enable);
+}
+
+void setZeroCopyArrayThreshold(size_t bytes)
+{
+    setZeroCopyArrayBytes(bytes);
+}
+
+void setThreadConfig(const EdgeThreadConfig *configs)
+{
+    setEdgeThreadConfig(configs);
+}
+
+#ifndef DISABLE_SERVER
 EdgeResult createNamespace(const char *name, const char *rootNodeId, const char *rootBrowseName,
 		const char *rootDisplayName)
 {
@@ -94,12 +161,29 @@ EdgeResult createNode(const char *namespaceUri, EdgeNodeItem *item)
     return addNodesInServer(namespaceUri, item);
 }
 
+EdgeResult createNodes(const char *namespaceUri, EdgeNodeItem **items, size_t itemCount,
+        EdgeReference **references, size_t referenceCount)
+{
+    return addNodeItemsInServer(namespaceUri, items, itemCount, references, referenceCount);
+}
+
+EdgeResult loadNodeset(const char *namespaceUri, const char *path)
+{
+    return loadNodesetInServer(namespaceUri, path);
+}
+
 EdgeResult modifyVariableNode(const char *namespaceUri, const char *nodeUri, EdgeVersatility *value)
 {
     // modify variable nodes
     return modifyNodeInServer(namespaceUri, nodeUri, value);
 }
 
+EdgeResult modifyVariableNodes(const char *namespaceUri, const char **nodeUris,
+        EdgeVersatility **values, size_t count)
+{
+    return modifyNodesInServer(namespaceUri, nodeUris, values, count);
+}
+
 EdgeResult addReference(EdgeReference *reference)
 {
     return addReferenceInServer(reference);
@@ -107,7 +191,173 @@ EdgeResult addReference(EdgeReference *reference)
 
 EdgeResult createMethodNode(const char *namespaceUri, EdgeNodeItem *item, EdgeMethod *method)
 {
-    return addMethodNodeInServer(namespaceUri, item, method);
+    return addMethodNodeInServer(namespaceUri, item, method, NULL, false);
+}
+
+EdgeResult createMethodNodeWithView(const char *namespaceUri, EdgeNodeItem *item,
+        EdgeMethod *method, method_view_func viewFn)
+{
+    EdgeResult result = { STATUS_PARAM_INVALID };
+    VERIFY_NON_NULL_MSG(viewFn, "", result);
+    return addMethodNodeInServer(namespaceUri, item, method, viewFn, false);
+}
+
+EdgeResult createAsyncMethodNode(const char *namespaceUri, EdgeNodeItem *item,
+        EdgeMethod *method)
+{
+    return addMethodNodeInServer(namespaceUri, item, method, NULL, true);
+}
+
+void setMethodWorkerCount(uint32_t count)
+{
+    setMethodWorkersInServer(count);
+}
+
+EdgeNamespace* getNamespaceHandle(const char *namespaceUri)
+{
+    return getNamespaceInServer(namespaceUri);
+}
+
+EdgeResult createNamespaceInInstance(EdgeServer *server, const char *name,
+        const char *rootNodeId, const char *rootBrowseName, const char *rootDisplayName)
+{
+    EdgeResult result = { STATUS_PARAM_INVALID };
+    VERIFY_NON_NULL_MSG(server, "NULL param server in createNamespaceInInstance\n", result);
+    return createNamespaceInServerInstance(server, name, rootNodeId, rootBrowseName,
+            rootDisplayName);
+}
+
+EdgeNamespace* getNamespaceHandleInInstance(EdgeServer *server, const char *namespaceUri)
+{
+    return getNamespaceInServerInstance(server, namespaceUri);
+}
+
+EdgeResult createNodeByHandle(const EdgeNamespace *ns, EdgeNodeItem *item)
+{
+    return addNodesInNamespace(ns, item);
+}
+
+EdgeResult loadNodesetByHandle(const EdgeNamespace *ns, const char *path)
+{
+    return loadNodesetInNamespace(ns, path);
+}
+
+EdgeResult modifyVariableNodeByHandle(const EdgeNamespace *ns, const char *nodeUri,
+        EdgeVersatility *value)
+{
+    return modifyNodeInNamespace(ns, nodeUri, value);
+}
+
+EdgeResult modifyVariableNodesByHandle(const EdgeNamespace *ns, const char **nodeUris,
+        EdgeVersatility **values, size_t count)
+{
+    return modifyNodesInNamespace(ns, nodeUris, values, count);
+}
+
+EdgeVariableNode* getVariableNodeHandle(const EdgeNamespace *ns, const char *nodeUri)
+{
+    return getVariableNodeInNamespace(ns, nodeUri);
+}
+
+EdgeResult enqueueVariableNodeUpdate(EdgeVariableNode *node, const EdgeVersatility *value)
+{
+    return enqueueNodeUpdateInServer(node, value);
+}
+
+EdgePublisher* createPubSubPublisher(EdgeVariableNode **nodes, size_t nodeCount,
+        const EdgePubSubConfig *config)
+{
+    return createPublisherInServer(nodes, nodeCount, config);
+}
+
+EdgeResult deletePubSubPublisher(EdgePublisher *publisher)
+{
+    return deletePublisherInServer(publisher);
+}
+#endif
+
+EdgeSubscriber* createPubSubSubscriber(const EdgePubSubConfig *config, const char **valueAliases,
+        size_t fieldCount)
+{
+    return createUadpSubscriber(config, valueAliases, fieldCount);
+}
+
+void deletePubSubSubscriber(EdgeSubscriber *subscriber)
+{
+    deleteUadpSubscriber(subscriber);
+}
+
+EdgeShmPublisher* createShmPublisher(const char *name, size_t size)
+{
+    return createShmRingPublisher(name, size);
+}
+
+EdgeResult publishShmMessage(EdgeShmPublisher *publisher, const EdgeMessage *msg)
+{
+    return publishToShmRing(publisher, msg);
+}
+
+void deleteShmPublisher(EdgeShmPublisher *publisher)
+{
+    deleteShmRingPublisher(publisher);
+}
+
+EdgeShmConsumer* openShmConsumer(const char *name)
+{
+    return openShmRingConsumer(name);
+}
+
+const EdgeShmMessage* readShmMessage(EdgeShmConsumer *consumer, uint32_t timeoutMs)
+{
+    return readFromShmRing(consumer, timeoutMs);
+}
+
+bool releaseShmMessage(EdgeShmConsumer *consumer)
+{
+    return releaseShmRingMessage(consumer);
+}
+
+const char* getShmString(const EdgeShmConsumer *consumer, EdgeShmString str)
+{
+    return getShmRingString(consumer, str);
+}
+
+const EdgeShmResponse* getShmResponse(const EdgeShmConsumer *consumer, size_t index)
+{
+    return getShmRingResponse(consumer, index);
+}
+
+const void* getShmValue(const EdgeShmConsumer *consumer, const EdgeShmResponse *response)
+{
+    return getShmRingValue(consumer, response);
+}
+
+uint64_t getShmLostCount(const EdgeShmConsumer *consumer)
+{
+    return getShmRingLostCount(consumer);
+}
+
+void closeShmConsumer(EdgeShmConsumer *consumer)
+{
+    closeShmRingConsumer(consumer);
+}
+
+#ifndef DISABLE_SERVER
+EdgeResult createMethodNodeByHandle(const EdgeNamespace *ns, EdgeNodeItem *item,
+        EdgeMethod *method)
+{
+    return addMethodNodeInNamespace(ns, item, method, NULL, false);
+}
+
+void *getMethodOutputBuffer(EdgeMethodOutputs *outputs, size_t index)
+{
+    return getOutputArgumentBuffer(outputs, index);
+}
+
+EdgeResult setMethodOutputString(EdgeMethodOutputs *outputs, size_t index, size_t element,
+        const char *data, size_t length)
+{
+    return setOutputArgumentString(outputs, index, element, data, length);
 }
 
 EdgeResult createServer(EdgeEndPointInfo *epInfo)
@@ -135,6 +385,29 @@ void closeServer(EdgeEndPointInfo *epInfo)
     b_serverInitialized = false;
 }
 
+EdgeServer* createServerInstance(EdgeEndPointInfo *epInfo)
+{
+    EDGE_LOG(TAG, "[Received command] :: Server instance start.");
+    VERIFY_NON_NULL_MSG(epInfo, "", NULL);
+    VERIFY_NON_NULL_MSG(epInfo->endpointConfig, "", NULL);
+    COND_CHECK((epInfo->endpointConfig->bindPort < 1), NULL);
+    COND_CHECK((epInfo->endpointConfig->bindPort > 65535), NULL);
+
+    EdgeServer *server = NULL;
+    EdgeResult result = startServerInstance(epInfo, &server);
+    COND_CHECK((result.code != STATUS_OK), NULL);
+    return server;
+}
+
+void closeServerInstance(EdgeServer *server, EdgeEndPointInfo *epInfo)
+{
+    VERIFY_NON_NULL_NR_MSG(server, "NULL param server in closeServerInstance\n");
+    VERIFY_NON_NULL_NR_MSG(epInfo, "NULL param epInfo in closeServerInstance\n");
+    stopServerInstance(server, epInfo);
+}
+#endif
+
+#ifndef DISABLE_DISCOVERY
 EdgeResult getEndpointInfo(EdgeMessage *msg)
 {
     EdgeResult ret;
@@ -145,6 +418,60 @@ EdgeResult getEndpointInfo(EdgeMessage *msg)
     return client_getEndpoints(msg->endpointInfo->endpointUri);
 }
 
+EdgeResult scanEndpoints(const char *const *endpointUris, size_t count, size_t maxWorkers,
+        uint32_t timeoutMs)
+{
+    return scanEndpointsInternal(endpointUris, count, maxWorkers, timeoutMs);
+}
+
+EdgeResult scanEndpointRange(const char *firstAddress, const char *lastAddress,
+        uint16_t port, size_t maxWorkers, uint32_t timeoutMs)
+{
+    return scanEndpointRangeInternal(firstAddress, lastAddress, port, maxWorkers, timeoutMs);
+}
+
+void setEndpointCache(uint32_t ttlMs)
+{
+    setEndpointCacheTtlInternal(ttlMs);
+}
+
+void invalidateEndpointCache(const char *endpointUri)
+{
+    invalidateEndpointCacheInternal(endpointUri);
+}
+
+EdgeResult startNetworkDiscovery(const char *ldsEndpointUri, uint32_t intervalMs)
+{
+    return startNetworkDiscoveryInternal(ldsEndpointUri, intervalMs);
+}
+
+void stopNetworkDiscovery(void)
+{
+    stopNetworkDiscoveryInternal();
+}
+#endif
+
+void setLogLevel(EdgeLogLevel level)
+{
+    edgeLogSetLevel(level);
+}
+
+void setLogSink(EdgeLogSink sink, void *context)
+{
+    edgeLogSetSink(sink, context);
+}
+
+void flushLog(void)
+{
+    edgeLogFlush();
+}
+
+void setTraceHooks(const EdgeTraceHooks *hooks)
+{
+    edgeTraceSetHooks(hooks);
+}
+
+#ifndef DISABLE_DISCOVERY
 EdgeResult findServers(const char *endpointUri, size_t serverUrisSize, unsigned char **serverUris,
         size_t localeIdsSize, unsigned char **localeIds, size_t *registeredServersSize,
         EdgeApplicationConfig **registeredServers)
@@ -152,6 +479,7 @@ EdgeResult findServers(const char *endpointUri, size_t serverUrisSize, unsigned
     return client_findServers(endpointUri, serverUrisSize, serverUris, localeIdsSize, localeIds,
             registeredServersSize, registeredServers);
 }
+#endif
 
 void disconnectClient(EdgeEndPointInfo *epInfo)
 {
@@ -160,12 +488,21 @@ void disconnectClient(EdgeEndPointInfo *epInfo)
     disconnect_client(epInfo);
 }
 
+#ifndef DISABLE_SERVER
 EdgeNodeItem* createVariableNodeItem(const char* name, int type, void* data,
         EdgeIdentifier nodeType, double minimumInterval)
 {
     return createVariableNodeItemImpl(name, type, data, nodeType, minimumInterval);
 }
 
+EdgeNodeItem* createDataSourceNodeItem(const char* name, int type, EdgeIdentifier nodeType,
+        data_source_read_func readFn, data_source_write_func writeFn, void *context,
+        double minimumInterval)
+{
+    return createDataSourceNodeItemImpl(name, type, nodeType, readFn, writeFn, context,
+            minimumInterval);
+}
+
 EdgeNodeItem* createNodeItem(const char* name, EdgeIdentifier nodeType, EdgeNodeId *sourceNodeId)
 {
     return createNodeItemImpl(name, nodeType, sourceNodeId);
@@ -175,6 +512,7 @@ EdgeResult deleteNodeItem(EdgeNodeItem* item)
 {
     return deleteNodeItemImpl(item);
 }
+#endif
 
 void destroyEdgeResult(EdgeResult *res)
 {
@@ -260,6 +598,32 @@ bool checkEndpointURI(char *endpoint) {
 #endif	
 }
 
+/* Commands of the subsystems which the build profile leaves out are refused by sendRequest() */
+static bool isCommandBuilt(EdgeCommand command)
+{
+#ifdef DISABLE_SERVER
+    if (CMD_START_SERVER == command || CMD_STOP_SERVER == command)
+    {
+        return false;
+    }
+#endif
+#ifdef DISABLE_BROWSE
+    if (CMD_BROWSE == command || CMD_BROWSE_VIEW == command
+            || CMD_TRANSLATE_BROWSE_PATHS == command)
+    {
+        return false;
+    }
+#endif
+#ifdef DISABLE_METHOD
+    if (CMD_METHOD == command)
+    {
+        return false;
+    }
+#endif
+    (void) command;
+    return true;
+}
+
 static EdgeResult checkParameterValid(EdgeMessage *msg)
 {
     EdgeResult result;
@@ -268,6 +632,11 @@ static EdgeResult checkParameterValid(EdgeMessage *msg)
     VERIFY_NON_NULL_MSG(msg->endpointInfo, "EdgeMessage endpoint NULL in checkParameterValid\n", result);
     VERIFY_NON_NULL_MSG(msg->endpointInfo->endpointUri, "EndpointURI NULL in checkParameterValid\n", result);
 
+    result.code = STATUS_NOT_SUPPORT;
+    COND_CHECK_MSG((!isCommandBuilt(msg->command)),
+            "Command is left out of this build in checkParameterValid\n", result);
+    result.code = STATUS_PARAM_INVALID;
+
     if(!checkEndpointURI(msg->endpointInfo->endpointUri)) {
         char *m_endpoint = (char*) EdgeCalloc(strlen(msg->endpointInfo->endpointUri) + 1, sizeof(char));
         strncpy(m_endpoint, msg->endpointInfo->endpointUri, strlen(msg->endpointInfo->endpointUri));
@@ -314,6 +683,10 @@ static EdgeResult checkParameterValid(EdgeMessage *msg)
         COND_CHECK((msg->command == CMD_METHOD), result);
         COND_CHECK((msg->command == CMD_SUB), result);
         COND_CHECK((msg->command == CMD_READ_SAMPLING_INTERVAL), result);
+        COND_CHECK((msg->command == CMD_REGISTER_NODES), result);
+        COND_CHECK((msg->command == CMD_UNREGISTER_NODES), result);
+        COND_CHECK((msg->command == CMD_TRANSLATE_BROWSE_PATHS), result);
+        COND_CHECK((msg->command == CMD_HISTORY_READ), result);
     }
 
     if (msg->command == CMD_BROWSE)
@@ -321,6 +694,13 @@ static EdgeResult checkParameterValid(EdgeMessage *msg)
         VERIFY_NON_NULL_MSG(msg->browseParam, "BrowseParam is NULL in checkParameterValid\n", result);
     }
 
+    if (msg->command == CMD_HISTORY_READ)
+    {
+        VERIFY_NON_NULL_MSG(msg->historyParam, "HistoryParam is NULL in checkParameterValid\n", result);
+        COND_CHECK_MSG((msg->historyParam->kind > EDGE_HISTORY_READ_PROCESSED),
+                "Invalid history read kind in checkParameterValid\n", result);
+    }
+
     if (msg->command == CMD_SUB)
     {
         if (msg->request)
@@ -348,9 +728,11 @@ EdgeResult sendRequest(EdgeMessage* msg)
     // Initializes the queueing thread if it is not initialized yet.
     init_queue();
 
+    EDGE_TRACE_BEGIN(msg, EDGE_TRACE_STAGE_SEND_REQUEST);
     EdgeResult result = checkParameterValid(msg);
+    EdgeMessage *msgCopy = (result.code == STATUS_OK) ? cloneEdgeMessage(msg) : NULL;
+    EDGE_TRACE_END(msg, EDGE_TRACE_STAGE_SEND_REQUEST);
     COND_CHECK((result.code != STATUS_OK), result);
-    EdgeMessage *msgCopy = cloneEdgeMessage(msg);
     result.code = STATUS_ERROR;
     VERIFY_NON_NULL_MSG(msgCopy, "NULL messageCopy recevied in send request\n", result);
     bool ret = add_to_sendQ(msgCopy);
@@ -358,8 +740,265 @@ EdgeResult sendRequest(EdgeMessage* msg)
     return result;
 }
 
+EdgeResult sendRequestTake(EdgeMessage* msg)
+{
+    // Initializes the queueing thread if it is not initialized yet.
+    init_queue();
+
+    EDGE_TRACE_BEGIN(msg, EDGE_TRACE_STAGE_SEND_REQUEST);
+    EdgeResult result = checkParameterValid(msg);
+    EDGE_TRACE_END(msg, EDGE_TRACE_STAGE_SEND_REQUEST);
+    if (result.code != STATUS_OK)
+    {
+        // ownership is taken on every path, so an invalid message is released here.
+        if (IS_NOT_NULL(msg))
+        {
+            freeEdgeMessage(msg);
+        }
+        return result;
+    }
+    bool ret = add_to_sendQ(msg);
+    result.code = (ret ? STATUS_OK : STATUS_ENQUEUE_ERROR);
+    return result;
+}
+
+static EdgeFuture *sendRequestWithFuture(EdgeMessage *msg, EdgeResult *result)
+{
+    // Initializes the queueing thread if it is not initialized yet.
+    init_queue();
+
+    *result = checkParameterValid(msg);
+    COND_CHECK((result->code != STATUS_OK), NULL);
+    result->code = STATUS_PARAM_INVALID;
+    // Registered first, the responses may arrive before add_to_sendQ() returns
+    EdgeFuture *future = createRequestFuture(msg->message_id);
+    VERIFY_NON_NULL_MSG(future, "Failed to create the future of the request\n", NULL);
+
+    result->code = STATUS_ERROR;
+    EdgeMessage *msgCopy = cloneEdgeMessage(msg);
+    if (IS_NULL(msgCopy))
+    {
+        EDGE_LOG(TAG, "NULL messageCopy recevied in send request");
+        deleteRequestFuture(future);
+        return NULL;
+    }
+    if (!add_to_sendQ(msgCopy))
+    {
+        result->code = STATUS_ENQUEUE_ERROR;
+        deleteRequestFuture(future);
+        return NULL;
+    }
+    result->code = STATUS_OK;
+    return future;
+}
+
+EdgeFuture* sendRequestAsync(EdgeMessage* msg)
+{
+    EdgeResult result;
+    return sendRequestWithFuture(msg, &result);
+}
+
+EdgeResult waitFuture(EdgeFuture *future, uint32_t timeoutMs)
+{
+    EdgeResult result;
+    result.code = STATUS_PARAM_INVALID;
+    VERIFY_NON_NULL_MSG(future, "NULL future received in waitFuture\n", result);
+    result.code = waitRequestFuture(future, timeoutMs) ? STATUS_OK : STATUS_REQUEST_TIMEOUT;
+    return result;
+}
+
+size_t getFutureResponseCount(EdgeFuture *future)
+{
+    return getRequestFutureResponseCount(future);
+}
+
+EdgeMessage* getFutureResponse(EdgeFuture *future, size_t index)
+{
+    return getRequestFutureResponse(future, index, false);
+}
+
+void destroyFuture(EdgeFuture *future)
+{
+    deleteRequestFuture(future);
+}
+
+EdgeResult sendRequestAndWait(EdgeMessage* msg, uint32_t timeoutMs, EdgeMessage **response)
+{
+    EdgeResult result;
+    result.code = STATUS_PARAM_INVALID;
+    VERIFY_NON_NULL_MSG(response, "NULL response received in sendRequestAndWait\n", result);
+    *response = NULL;
+    EdgeFuture *future = sendRequestWithFuture(msg, &result);
+    COND_CHECK((IS_NULL(future)), result);
+
+    bool finished = waitRequestFuture(future, timeoutMs);
+    // Later responses of an unfinished request go to the callbacks as well
+    detachRequestFuture(future);
+
+    size_t count = getRequestFutureResponseCount(future);
+    size_t index = count;
+    for (size_t i = 0; finished && i < count; i++)
+    {
+        EdgeMessage *resp = getRequestFutureResponse(future, i, false);
+        if (GENERAL_RESPONSE == resp->type || BROWSE_RESPONSE == resp->type)
+        {
+            index = i;
+            break;
+        }
+        if (ERROR_RESPONSE == resp->type && index == count)
+        {
+            index = i;
+        }
+    }
+    for (size_t i = 0; i < count; i++)
+    {
+        EdgeMessage *resp = getRequestFutureResponse(future, i, true);
+        if (i == index)
+        {
+            *response = resp;
+        }
+        else
+        {
+            add_to_recvQ(resp);
+        }
+    }
+    deleteRequestFuture(future);
+
+    result.code = finished ? STATUS_OK : STATUS_REQUEST_TIMEOUT;
+    return result;
+}
+
+EdgePreparedRead* prepareRead(EdgeMessage *msg)
+{
+    EdgeResult result = checkParameterValid(msg);
+    COND_CHECK((result.code != STATUS_OK), NULL);
+    return createPreparedReadImpl(msg);
+}
+
+EdgeResult sendPreparedRead(EdgePreparedRead *read)
+{
+    // Initializes the queueing thread if it is not initialized yet.
+    init_queue();
+    return sendPreparedReadImpl(read);
+}
+
+EdgeResult startPeriodicRead(EdgePreparedRead *read, uint32_t intervalMs)
+{
+    // Initializes the queueing thread if it is not initialized yet.
+    init_queue();
+    return startPeriodicReadImpl(read, intervalMs);
+}
+
+void stopPeriodicRead(EdgePreparedRead *read)
+{
+    stopPeriodicReadImpl(read);
+}
+
+void destroyPreparedRead(EdgePreparedRead *read)
+{
+    destroyPreparedReadImpl(read);
+}
+
+EdgeResult configureWriteCoalescing(size_t maxNodes, uint32_t windowMs)
+{
+    // Initializes the queueing thread if it is not initialized yet.
+    init_queue();
+    return configureWriteCoalescingImpl(maxNodes, windowMs);
+}
+
+void setReadSharing(bool enable)
+{
+    setReadSharingImpl(enable);
+}
+
+EdgeResult getQueueStats(EdgeQueueStats *sendStats, EdgeQueueStats *recvStats)
+{
+    EdgeResult result;
+    result.code = STATUS_PARAM_INVALID;
+    COND_CHECK((IS_NULL(sendStats) && IS_NULL(recvStats)), result);
+    result.code = (get_queue_stats(sendStats, recvStats, false) ? STATUS_OK : STATUS_ERROR);
+    return result;
+}
+
+void resetQueueStats(void)
+{
+    get_queue_stats(NULL, NULL, true);
+}
+
+void setReportLatency(bool enable)
+{
+    set_report_latency(enable);
+}
+
+EdgeResult getReportLatency(uint32_t messageId, EdgeReportLatency *latency)
+{
+    EdgeResult result;
+    result.code = STATUS_PARAM_INVALID;
+    VERIFY_NON_NULL_MSG(latency, "NULL latency param in getReportLatency\n", result);
+    result.code = (get_report_latency(messageId, latency) ? STATUS_OK : STATUS_ERROR);
+    return result;
+}
+
+void resetReportLatency(void)
+{
+    reset_report_latency();
+}
+
+#ifndef DISABLE_BROWSE
+EdgeResult setBrowseSnapshot(const char *endpointUri, const char *path)
+{
+    EdgeResult result;
+    result.code = STATUS_PARAM_INVALID;
+    VERIFY_NON_NULL_MSG(endpointUri, "NULL endpointUri param in setBrowseSnapshot\n", result);
+    result.code = (setBrowseSnapshotPath(endpointUri, path) ? STATUS_OK : STATUS_INTERNAL_ERROR);
+    return result;
+}
+#endif
+
+EdgeResult setSessionPoolSize(const char *endpointUri, size_t sessions)
+{
+    return setSessionPoolSizeInClient(endpointUri, sessions);
+}
+
+EdgeResult setClientReconnect(const EdgeReconnectConfig *config)
+{
+    return setReconnectConfig(config);
+}
+
+void setLocalTimeConversion(bool enable)
+{
+    setEdgeLocalTimeEnabled(enable);
+}
+
+struct tm *getEdgeLocalTime(const EdgeTimeInfo *timeInfo, struct tm *localTime)
+{
+    VERIFY_NON_NULL_MSG(timeInfo, "NULL timeInfo param in getEdgeLocalTime\n", NULL);
+    VERIFY_NON_NULL_MSG(localTime, "NULL localTime param in getEdgeLocalTime\n", NULL);
+    time_t rawtime = (time_t) timeInfo->tv.tv_sec;
+#ifndef _WIN32
+    return localtime_r(&rawtime, localTime);
+#else
+    return (0 == localtime_s(localTime, &rawtime)) ? localTime : NULL;
+#endif
+}
+
 void onSendMessage(EdgeMessage* msg)
 {
+#ifdef ENABLE_ASYNC_SERVICES
+    if (EDGE_MESSAGE_BLOCK(msg)->asyncDrain)
+    {
+        EDGE_LOG(TAG, "\n[Received command] :: WAIT FOR ASYNC RESPONSES \n");
+        drainAsyncServicesInServer(msg);
+        return;
+    }
+#endif
+    if (EDGE_MESSAGE_BLOCK(msg)->reconnectProbe)
+    {
+        EDGE_LOG(TAG, "\n[Received command] :: RECONNECT \n");
+        reconnectClientInServer(msg);
+        return;
+    }
+#ifndef DISABLE_SERVER
     if (CMD_START_SERVER == msg->command)
     {
         EDGE_LOG(TAG, "\n[Received command] :: START SERVER \n");
@@ -368,18 +1007,23 @@ void onSendMessage(EdgeMessage* msg)
         COND_CHECK_NR_MSG((result.code != STATUS_OK), "Error in starting server\n");
         b_serverInitialized = true;
     }
-    else if (CMD_START_CLIENT == msg->command)
+    else
+#endif
+    if (CMD_START_CLIENT == msg->command)
     {
         EDGE_LOG(TAG, "\n[Received command] :: START CLIENT \n");
-        bool result = connect_client(msg->endpointInfo->endpointUri);
+        bool result = connect_client_async(msg->endpointInfo->endpointUri,
+                msg->endpointInfo->endpointConfig);
         VERIFY_NON_NULL_NR_MSG(!result, "");
     }
+#ifndef DISABLE_SERVER
     else if (CMD_STOP_SERVER == msg->command)
     {
         EDGE_LOG(TAG, "\nReceived command] :: STOP SERVER \n");
         stop_server(msg->endpointInfo);
         b_serverInitialized = false;
     }
+#endif
     else if (CMD_STOP_CLIENT == msg->command)
     {
         EDGE_LOG(TAG, "\n[Received command] :: STOP CLIENT \n");
@@ -400,21 +1044,42 @@ void onSendMessage(EdgeMessage* msg)
         EDGE_LOG(TAG, "\n[Received command] :: WRITE \n");
         writeNodesInServer(msg);
     }
+#ifndef DISABLE_METHOD
     else if (CMD_METHOD == msg->command)
     {
         EDGE_LOG(TAG, "\n[Received command] :: METHOD CALL \n");
         callMethodInServer(msg);
     }
+#endif
     else if (CMD_SUB == msg->command)
     {
         EDGE_LOG(TAG, "\n[Received command] :: SUB \n");
         executeSubscriptionInServer(msg);
     }
+#ifndef DISABLE_BROWSE
     else if (CMD_BROWSE == msg->command || CMD_BROWSE_VIEW == msg->command)
     {
         EDGE_LOG(TAG, "\n[Received command] :: BROWSE \n");
         browseNodesInServer(msg);
     }
+#endif
+    else if (CMD_REGISTER_NODES == msg->command || CMD_UNREGISTER_NODES == msg->command)
+    {
+        EDGE_LOG(TAG, "\n[Received command] :: REGISTER NODES \n");
+        registerNodesInServer(msg);
+    }
+#ifndef DISABLE_BROWSE
+    else if (CMD_TRANSLATE_BROWSE_PATHS == msg->command)
+    {
+        EDGE_LOG(TAG, "\n[Received command] :: TRANSLATE BROWSE PATHS \n");
+        translateBrowsePathsInServer(msg);
+    }
+#endif
+    else if (CMD_HISTORY_READ == msg->command)
+    {
+        EDGE_LOG(TAG, "\n[Received command] :: HISTORY READ \n");
+        historyReadInServer(msg);
+    }
 }
 
 void onResponseMessage(EdgeMessage *msg)
@@ -438,6 +1103,13 @@ void onDiscoveryCallback(EdgeDevice *device)
     discoveryCb->endpoint_found_cb(device);
 }
 
+void onDeviceCallback(EdgeDevice *device)
+{
+    VERIFY_NON_NULL_NR_MSG(discoveryCb, "NULL discoveryCb in onDeviceCallback\n");
+    VERIFY_NON_NULL_NR_MSG(discoveryCb->device_found_cb, "NULL device_found_cb in onDeviceCallback\n");
+    discoveryCb->device_found_cb(device);
+}
+
 void onStatusCallback(EdgeEndPointInfo *epInfo, EdgeStatusCode status)
 {
     VERIFY_NON_NULL_NR_MSG(statusCb, "NULL statusCb in onStatusCallback\n"); // status callback not registered by application.
@@ -449,7 +1121,8 @@ void onStatusCallback(EdgeEndPointInfo *epInfo, EdgeStatusCode status)
     {
         statusCb->stop_cb(epInfo, status);
     }
-    else if (STATUS_CONNECTED == status || STATUS_DISCONNECTED == status)
+    else if (STATUS_CONNECTED == status || STATUS_DISCONNECTED == status
+            || STATUS_CLIENT_CONNECT_FAILED == status)
     {
         statusCb->network_cb(epInfo, status);
     }
@@ -527,7 +1200,7 @@ EdgeResult insertSubParameter(EdgeMessage **msg, const char* nodeName, EdgeNodeT
 
     result.code = STATUS_OK;
     subReq->subType = subType;
-    if (Edge_Create_Sub == subType || Edge_Modify_Sub == subType)
+    if (Edge_Create_Sub == subType || Edge_Create_Bulk_Sub == subType || Edge_Modify_Sub == subType)
     {
         subReq->samplingInterval = samplingInterval;
         subReq->publishingInterval = publishingInterval;
@@ -539,7 +1212,7 @@ EdgeResult insertSubParameter(EdgeMessage **msg, const char* nodeName, EdgeNodeT
         subReq->queueSize = queueSize;
     }
 
-    if (Edge_Create_Sub == subType)
+    if (Edge_Create_Sub == subType || Edge_Create_Bulk_Sub == subType)
     {
         size_t index = (*msg)->requestLength;
 
@@ -568,27 +1241,66 @@ EdgeResult insertSubParameter(EdgeMessage **msg, const char* nodeName, EdgeNodeT
     return result;
 }
 
+EdgeResult insertSubFilter(EdgeMessage *msg, EdgeDataChangeTrigger trigger,
+        EdgeDeadbandType deadbandType, double deadbandValue)
+{
+    EdgeResult result;
+    result.code = STATUS_PARAM_INVALID;
+    VERIFY_NON_NULL_MSG(msg, "NULL msg param in insertSubFilter\n", result);
+    COND_CHECK_MSG((msg->command != CMD_SUB), "Error: parameter is not valid", result);
+    COND_CHECK_MSG((trigger < EDGE_DATACHANGE_TRIGGER_STATUS_VALUE
+            || trigger > EDGE_DATACHANGE_TRIGGER_STATUS_VALUE_TIMESTAMP),
+            "Error: data change trigger is not valid", result);
+    COND_CHECK_MSG((deadbandType < EDGE_DEADBAND_NONE || deadbandType > EDGE_DEADBAND_PERCENT),
+            "Error: deadband type is not valid", result);
+    COND_CHECK_MSG((deadbandValue < 0.0), "Error: deadband value is negative", result);
+    COND_CHECK_MSG((EDGE_DEADBAND_PERCENT == deadbandType && deadbandValue > 100.0),
+            "Error: percent deadband is larger than 100", result);
+
+    EdgeSubRequest *subReq = NULL;
+    if (SEND_REQUESTS == msg->type && msg->requestLength > 0 && IS_NOT_NULL(msg->requests)
+            && IS_NOT_NULL(msg->requests[msg->requestLength - 1]))
+    {
+        subReq = msg->requests[msg->requestLength - 1]->subMsg;
+    }
+    else if (SEND_REQUEST == msg->type && IS_NOT_NULL(msg->request))
+    {
+        subReq = msg->request->subMsg;
+    }
+    VERIFY_NON_NULL_MSG(subReq, "No monitored item is inserted in insertSubFilter\n", result);
+    COND_CHECK_MSG((Edge_Create_Sub != subReq->subType && Edge_Create_Bulk_Sub != subReq->subType
+            && Edge_Modify_Sub != subReq->subType), "Error: filter needs a create or modify request",
+            result);
+
+    subReq->trigger = trigger;
+    subReq->deadbandType = deadbandType;
+    subReq->deadbandValue = deadbandValue;
+
+    result.code = STATUS_OK;
+    return result;
+}
+
 EdgeMessage* createEdgeSubMessage(const char *endpointUri, const char* nodeName, size_t requestSize,
         EdgeNodeType subType)
 {
     VERIFY_NON_NULL_MSG(endpointUri, "NULL endpointUri param in createEdgeSubMessage\n", NULL);
 
-    EdgeMessage *msg = (EdgeMessage *) EdgeCalloc(1, sizeof(EdgeMessage));
+    EdgeMessage *msg = allocEdgeMessage();
     VERIFY_NON_NULL_MSG(msg, "EdgeCalloc FAILED for message in createEdgeSubMessage\n", NULL);
 
     msg->endpointInfo = (EdgeEndPointInfo *) EdgeCalloc(1, sizeof(EdgeEndPointInfo));
     if (IS_NULL(msg->endpointInfo))
     {
         EDGE_LOG(TAG, "Error : Malloc failed for epInfo");
-        EdgeFree(msg);
+        freeEdgeMessage(msg);
         return NULL;
     }
 
     msg->endpointInfo->endpointUri = copyString(endpointUri);
     msg->command = CMD_SUB;
-    msg->message_id = EdgeGetRandom();
+    msg->message_id = EdgeGetMessageId();
 
-    if (Edge_Create_Sub == subType)
+    if (Edge_Create_Sub == subType || Edge_Create_Bulk_Sub == subType)
     {
         msg->requests = (EdgeRequest **) EdgeCalloc(requestSize, sizeof(EdgeRequest *));
         if (IS_NULL(msg->requests))
@@ -625,14 +1337,14 @@ EdgeMessage* createEdgeAttributeMessage(const char *endpointUri, size_t requestS
 {
     VERIFY_NON_NULL_MSG(endpointUri, "NULL endpointUri param in createEdgeAttributeMessage\n", NULL);
 
-    EdgeMessage *msg = (EdgeMessage *) EdgeCalloc(1, sizeof(EdgeMessage));
+    EdgeMessage *msg = allocEdgeMessage();
     VERIFY_NON_NULL_MSG(msg, "EdgeCalloc FAILED for message in createEdgeAttributeMessage\n", NULL);
 
     msg->endpointInfo = (EdgeEndPointInfo *) EdgeCalloc(1, sizeof(EdgeEndPointInfo));
     if (IS_NULL(msg->endpointInfo))
     {
         EDGE_LOG(TAG, "Error : Malloc failed for epInfo");
-        EdgeFree(msg);
+        freeEdgeMessage(msg);
         return NULL;
     }
 
@@ -647,7 +1359,7 @@ EdgeMessage* createEdgeAttributeMessage(const char *endpointUri, size_t requestS
     }
     msg->type = SEND_REQUESTS;
     msg->command = cmd;
-    msg->message_id = EdgeGetRandom();
+    msg->message_id = EdgeGetMessageId();
 
     return msg;
 }
@@ -656,14 +1368,14 @@ EdgeMessage* createEdgeMessage(const char *endpointUri, size_t requestSize, Edge
 {
     VERIFY_NON_NULL_MSG(endpointUri, "NULL endpointUri param in createEdgeMessage\n", NULL);
 
-    EdgeMessage *msg = (EdgeMessage *) EdgeCalloc(1, sizeof(EdgeMessage));
+    EdgeMessage *msg = allocEdgeMessage();
     VERIFY_NON_NULL_MSG(msg, "EdgeCalloc failed for message in createEdgeMessage\n", NULL);
 
     msg->endpointInfo = (EdgeEndPointInfo *) EdgeCalloc(1, sizeof(EdgeEndPointInfo));
     if (IS_NULL(msg->endpointInfo))
     {
         EDGE_LOG(TAG, "Error : Malloc failed for epInfo");
-        EdgeFree(msg);
+        freeEdgeMessage(msg);
         return NULL;
     }
 
@@ -697,7 +1409,7 @@ EdgeMessage* createEdgeMessage(const char *endpointUri, size_t requestSize, Edge
     }
 
     msg->command = cmd;
-    msg->message_id = EdgeGetRandom();
+    msg->message_id = EdgeGetMessageId();
 
     return msg;
 }
@@ -708,7 +1420,11 @@ EdgeResult insertReadAccessNode(EdgeMessage **msg, const char* nodeName)
     VERIFY_NON_NULL_MSG((*msg), "Error : msg is null", result);
     VERIFY_NON_NULL_MSG(nodeName, "Error : nodename is null", result);
 
-    COND_CHECK_MSG(((*msg)->command != CMD_READ && (*msg)->command != CMD_READ_SAMPLING_INTERVAL),
+    COND_CHECK_MSG(((*msg)->command != CMD_READ && (*msg)->command != CMD_READ_SAMPLING_INTERVAL
+                    && (*msg)->command != CMD_REGISTER_NODES
+                    && (*msg)->command != CMD_UNREGISTER_NODES
+                    && (*msg)->command != CMD_TRANSLATE_BROWSE_PATHS
+                    && (*msg)->command != CMD_HISTORY_READ),
                    "Error: Invalid command", result);
 
     result.code = STATUS_ERROR;
@@ -724,6 +1440,22 @@ EdgeResult insertReadAccessNode(EdgeMessage **msg, const char* nodeName)
     return result;
 }
 
+EdgeResult insertReadAttributeNode(EdgeMessage **msg, const char* nodeName,
+        EdgeAttributeId attributeId)
+{
+    EdgeResult result = { STATUS_PARAM_INVALID };
+    VERIFY_NON_NULL_MSG(msg, "Error : msg is null", result);
+    VERIFY_NON_NULL_MSG((*msg), "Error : msg is null", result);
+    COND_CHECK_MSG(((*msg)->command != CMD_READ), "Error: Invalid command", result);
+    COND_CHECK_MSG((attributeId < EDGE_ATTRIBUTE_NODEID || attributeId > EDGE_ATTRIBUTE_USEREXECUTABLE),
+                   "Error: Invalid attribute id", result);
+
+    result = insertReadAccessNode(msg, nodeName);
+    COND_CHECK((result.code != STATUS_OK), result);
+    (*msg)->requests[(*msg)->requestLength - 1]->attributeId = attributeId;
+    return result;
+}
+
 EdgeResult insertWriteAccessNode(EdgeMessage **msg, const char* nodeName, void* value,
         size_t valueCount)
 {
@@ -764,11 +1496,12 @@ EdgeResult insertWriteAccessNodeWithValueType(EdgeMessage **msg, const char* nod
         (*msg)->requests[index]->type = valueType;
     }
 
-    EdgeVersatility* varient = (EdgeVersatility*) malloc(sizeof(EdgeVersatility));
+    EdgeVersatility* varient = (EdgeVersatility*) EdgeMalloc(sizeof(EdgeVersatility));
     VERIFY_NON_NULL_MSG(varient, "Error : Malloc failed for Versatility", result);
     varient->value = value;
     varient->arrayLength = 0;
     varient->isArray = false;
+    varient->adopted = false;
     if (valueCount > 1)
     {
         varient->isArray = true;
@@ -798,6 +1531,7 @@ EdgeResult insertEdgeMethodParameter(EdgeMessage **msg, const char* nodeName,
     }
 
     EdgeRequest *request = NULL;
+    result.code = STATUS_ERROR;
     if (SEND_REQUEST == (*msg)->type)
     {
         request = (*msg)->request;
@@ -805,11 +1539,26 @@ EdgeResult insertEdgeMethodParameter(EdgeMessage **msg, const char* nodeName,
     }
     else
     {
-        result.code = STATUS_NOT_SUPPORT;
-        return result;
+        /* Arguments go to the last method request until it has all of its input arguments */
+        size_t index = (*msg)->requestLength;
+        if (index > 0)
+        {
+            request = (*msg)->requests[index - 1];
+            if (IS_NOT_NULL(request->methodParams)
+                    && request->methodParams->num_inpArgs >= inputParameterSize)
+            {
+                request = NULL;
+            }
+        }
+        if (IS_NULL(request))
+        {
+            (*msg)->requests[index] = (EdgeRequest *) EdgeCalloc(1, sizeof(EdgeRequest));
+            VERIFY_NON_NULL_MSG((*msg)->requests[index], "Error : Malloc failed for requests", result);
+            request = (*msg)->requests[index];
+            (*msg)->requestLength = ++index;
+        }
     }
 
-    result.code = STATUS_ERROR;
     if (NULL == request->nodeInfo)
     {
         request->nodeInfo = createEdgeNodeInfo(nodeName);
@@ -899,8 +1648,31 @@ EdgeResult insertBrowseParameter(EdgeMessage **msg, EdgeNodeInfo* nodeInfo,
             return result;
         }
     }
-    (*msg)->browseParam->direction = parameter.direction;
-    (*msg)->browseParam->maxReferencesPerNode = parameter.maxReferencesPerNode;
+    *(*msg)->browseParam = parameter;
+
+    result.code = STATUS_OK;
+    return result;
+}
+
+EdgeResult insertHistoryReadParameter(EdgeMessage **msg, const EdgeHistoryParameter *parameter)
+{
+    EdgeResult result;
+    result.code = STATUS_PARAM_INVALID;
+    VERIFY_NON_NULL_MSG(msg, "Error : msg is null", result);
+    VERIFY_NON_NULL_MSG((*msg), "Error : msg is null", result);
+    VERIFY_NON_NULL_MSG(parameter, "Error : parameter is null", result);
+    COND_CHECK_MSG(((*msg)->command != CMD_HISTORY_READ), "Error: Invalid command", result);
+    COND_CHECK_MSG((parameter->kind > EDGE_HISTORY_READ_PROCESSED),
+            "Error: Invalid history read kind", result);
+
+    result.code = STATUS_ERROR;
+    if (IS_NULL((*msg)->historyParam))
+    {
+        (*msg)->historyParam = (EdgeHistoryParameter *) EdgeCalloc(1, sizeof(EdgeHistoryParameter));
+        VERIFY_NON_NULL_MSG((*msg)->historyParam, "Error : Malloc failed for msg->historyParam",
+                result);
+    }
+    *(*msg)->historyParam = *parameter;
 
     result.code = STATUS_OK;
     return result;
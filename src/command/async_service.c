@@ -0,0 +1,242 @@
+/******************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ *
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************/
+
+#include "async_service.h"
+
+#ifdef ENABLE_ASYNC_SERVICES
+
+#include "cmd_util.h"
+#include "edge_logger.h"
+#include "edge_trace.h"
+#include "edge_client_stats.h"
+#include "edge_malloc.h"
+#include "edge_open62541.h"
+#include "edge_hash_map.h"
+#include "message_dispatcher.h"
+#include "request_future.h"
+
+#include <string.h>
+
+#ifndef _WIN32
+#include <pthread.h>
+#else
+#include "pthread.h"
+#endif
+
+#define TAG "async_service"
+
+/* Requests of a session are sent and answered on the thread which executes its messages,
+ * the mutex only guards the map itself. */
+typedef struct EdgeAsyncSession
+{
+    /**< Requests sent and not answered yet. **/
+    size_t inFlight;
+
+    /**< A message which waits for the outstanding responses is in the send queue. **/
+    bool drainQueued;
+} EdgeAsyncSession;
+
+typedef struct EdgeAsyncRequest
+{
+    /**< Copy of the request message. **/
+    EdgeMessage *msg;
+
+    EdgeAsyncHandler handler;
+
+    /**< Time from getClientServiceTime() when the request was sent. **/
+    uint64_t startUs;
+
+    /**< Copy of the handler data. **/
+    char data[];
+} EdgeAsyncRequest;
+
+/* Client handle -> EdgeAsyncSession */
+static EdgeHashMap *asyncSessionMap = NULL;
+static pthread_mutex_t asyncSessionMutex = PTHREAD_MUTEX_INITIALIZER;
+
+static EdgeAsyncSession *getAsyncSession(UA_Client *client, bool create)
+{
+    pthread_mutex_lock(&asyncSessionMutex);
+    EdgeAsyncSession *session = (EdgeAsyncSession *) getEdgeHashMapElement(asyncSessionMap, client);
+    if (IS_NULL(session) && create)
+    {
+        if (IS_NULL(asyncSessionMap))
+        {
+            asyncSessionMap = createEdgeHashMap(EDGE_HASH_POINTER_KEY);
+        }
+        session = (EdgeAsyncSession *) EdgeCalloc(1, sizeof(EdgeAsyncSession));
+        if (IS_NOT_NULL(session) && (IS_NULL(asyncSessionMap)
+                || !insertEdgeHashMapElement(asyncSessionMap, client, session)))
+        {
+            EdgeFree(session);
+            session = NULL;
+        }
+    }
+    pthread_mutex_unlock(&asyncSessionMutex);
+    return session;
+}
+
+static void asyncServiceCallback(UA_Client *client, void *userdata, UA_UInt32 requestId,
+        void *response)
+{
+    EdgeAsyncRequest *request = (EdgeAsyncRequest *) userdata;
+    EDGE_LOG_V(TAG, "Response of asynchronous request %u\n", requestId);
+
+    EdgeAsyncSession *session = getAsyncSession(client, false);
+    if (IS_NOT_NULL(session) && session->inFlight > 0)
+    {
+        session->inFlight--;
+    }
+
+    EDGE_TRACE_END(request->msg, EDGE_TRACE_STAGE_SERVICE);
+    /* Every service response starts with its response header */
+    recordClientService(client, request->msg->command, request->startUs,
+            ((UA_ResponseHeader *) response)->serviceResult);
+    EDGE_TRACE_BEGIN(request->msg, EDGE_TRACE_STAGE_RESPONSE);
+    request->handler(client, request->msg, request->data, response);
+    EDGE_TRACE_END(request->msg, EDGE_TRACE_STAGE_RESPONSE);
+    finishRequestFuture(request->msg->message_id);
+    freeEdgeMessage(request->msg);
+    EdgeFree(request);
+}
+
+/**
+ * @brief queueDrain - Queues the message which waits for the outstanding responses of the
+ *        session. It runs after the messages queued so far, which keeps them pipelined.
+ *        The message blocks its send thread in drainAsyncServices(), messages of other
+ *        endpoints on that thread wait up to EDGE_ASYNC_DRAIN_TIMEOUT behind it.
+ * @param msg - Request message of the session
+ * @return true if the message was queued
+ */
+static bool queueDrain(const EdgeMessage *msg)
+{
+    EdgeMessage *drain = allocEdgeMessage();
+    VERIFY_NON_NULL_MSG(drain, "EdgeCalloc FAILED for drain message\n", false);
+    setMessageEndpointInfo(drain, shareMessageEndpointInfo(msg));
+    if (IS_NULL(drain->endpointInfo))
+    {
+        EDGE_LOG(TAG, "Memory allocation failed.");
+        freeEdgeMessage(drain);
+        return false;
+    }
+    drain->type = SEND_REQUEST;
+    drain->command = msg->command;
+    drain->message_id = msg->message_id;
+    EDGE_MESSAGE_BLOCK(drain)->asyncDrain = true;
+    return add_to_sendQ(drain);
+}
+
+bool sendAsyncService(UA_Client *client, const EdgeMessage *msg, const void *request,
+        const UA_DataType *requestType, const UA_DataType *responseType,
+        EdgeAsyncHandler handler, const void *data, size_t dataSize)
+{
+    VERIFY_NON_NULL_MSG(client, "Client param is NULL in sendAsyncService\n", false);
+    EdgeAsyncSession *session = getAsyncSession(client, true);
+    VERIFY_NON_NULL_MSG(session, "Failed to create the asynchronous session state\n", false);
+
+    EdgeAsyncRequest *asyncRequest = (EdgeAsyncRequest *) EdgeCalloc(1,
+            sizeof(EdgeAsyncRequest) + dataSize);
+    VERIFY_NON_NULL_MSG(asyncRequest, "EdgeCalloc FAILED for EdgeAsyncRequest\n", false);
+    /* cloneEdgeMessage() does not modify the message */
+    asyncRequest->msg = cloneEdgeMessage((EdgeMessage *) msg);
+    if (IS_NULL(asyncRequest->msg))
+    {
+        EDGE_LOG(TAG, "Memory allocation failed.");
+        EdgeFree(asyncRequest);
+        return false;
+    }
+    asyncRequest->handler = handler;
+    if (IS_NOT_NULL(data) && dataSize > 0)
+    {
+        memcpy(asyncRequest->data, data, dataSize);
+    }
+
+    UA_UInt32 requestId = 0;
+    /* The future of the request waits for the response, see asyncServiceCallback */
+    holdRequestFuture(msg->message_id);
+    asyncRequest->startUs = getClientServiceTime();
+    /* The stage ends in asyncServiceCallback, when the response arrives */
+    EDGE_TRACE_BEGIN(msg, EDGE_TRACE_STAGE_SERVICE);
+    UA_StatusCode ret = __UA_Client_AsyncService(client, request, requestType, asyncServiceCallback,
+            responseType, asyncRequest, &requestId);
+    if (UA_STATUSCODE_GOOD != ret)
+    {
+        EDGE_LOG_V(TAG, "Failed to send asynchronous request :: 0x%08x(%s)\n", ret, UA_StatusCode_name(ret));
+        EDGE_TRACE_END(msg, EDGE_TRACE_STAGE_SERVICE);
+        finishRequestFuture(msg->message_id);
+        freeEdgeMessage(asyncRequest->msg);
+        EdgeFree(asyncRequest);
+        return false;
+    }
+    session->inFlight++;
+
+    /* Keep the pipeline bounded, wait for the oldest responses when it is full */
+    while (session->inFlight >= EDGE_ASYNC_MAX_IN_FLIGHT)
+    {
+        if (UA_STATUSCODE_GOOD != UA_Client_runAsync(client, EDGE_ASYNC_WAIT_TIME))
+        {
+            break;
+        }
+    }
+
+    if (!session->drainQueued && session->inFlight > 0)
+    {
+        session->drainQueued = queueDrain(msg);
+    }
+    return true;
+}
+
+void drainAsyncServices(UA_Client *client)
+{
+    VERIFY_NON_NULL_NR_MSG(client, "Client param is NULL in drainAsyncServices\n");
+    EdgeAsyncSession *session = getAsyncSession(client, false);
+    VERIFY_NON_NULL_NR_MSG(session, "No asynchronous requests for the client\n");
+    session->drainQueued = false;
+
+    UA_DateTime deadline = UA_DateTime_nowMonotonic() + EDGE_ASYNC_DRAIN_TIMEOUT * UA_MSEC_TO_DATETIME;
+    while (session->inFlight > 0 && UA_DateTime_nowMonotonic() < deadline)
+    {
+        if (UA_STATUSCODE_GOOD != UA_Client_runAsync(client, EDGE_ASYNC_WAIT_TIME))
+        {
+            EDGE_LOG(TAG, "Failed to receive asynchronous responses.");
+            break;
+        }
+    }
+    if (session->inFlight > 0)
+    {
+        EDGE_LOG_V(TAG, "%d asynchronous requests are not answered yet\n", (int) session->inFlight);
+    }
+}
+
+void removeAsyncServices(UA_Client *client)
+{
+    pthread_mutex_lock(&asyncSessionMutex);
+    EdgeAsyncSession *session = (EdgeAsyncSession *) removeEdgeHashMapElement(asyncSessionMap,
+            client, NULL);
+    EdgeFree(session);
+    if (IS_NOT_NULL(asyncSessionMap) && 0 == getEdgeHashMapSize(asyncSessionMap))
+    {
+        deleteEdgeHashMap(asyncSessionMap);
+        asyncSessionMap = NULL;
+    }
+    pthread_mutex_unlock(&asyncSessionMutex);
+}
+
+#endif // ENABLE_ASYNC_SERVICES
@@ -0,0 +1,106 @@
+/******************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ *
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************/
+
+/**
+ * @file async_service.h
+ *
+ * @brief This file contains the definition, types and APIs for pipelined asynchronous service requests.
+ */
+
+#ifndef EDGE_ASYNC_SERVICE_H
+#define EDGE_ASYNC_SERVICE_H
+
+#include "opcua_common.h"
+#include "open62541.h"
+
+#include "edge_utils.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/**< Requests of one session which may be outstanding before sending waits for a response */
+#ifndef EDGE_ASYNC_MAX_IN_FLIGHT
+#define EDGE_ASYNC_MAX_IN_FLIGHT (16)
+#endif
+
+/**< Time in milliseconds one wait for asynchronous responses blocks at most */
+#ifndef EDGE_ASYNC_WAIT_TIME
+#define EDGE_ASYNC_WAIT_TIME (50)
+#endif
+
+/**< Time in milliseconds drainAsyncServices() waits for the outstanding requests at most.
+ *   The send thread is blocked meanwhile, see drainAsyncServices(). */
+#ifndef EDGE_ASYNC_DRAIN_TIMEOUT
+#define EDGE_ASYNC_DRAIN_TIMEOUT (5000)
+#endif
+
+/**
+ * @brief Handles the response of an asynchronous request
+ * @param[in]  client Client Handle.
+ * @param[in]  msg Copy of the request message.
+ * @param[in]  data Copy of the data given to sendAsyncService().
+ * @param[in]  response Decoded response, it is deallocated by the stack after the handler returns.
+ */
+typedef void (*EdgeAsyncHandler)(UA_Client *client, const EdgeMessage *msg, const void *data,
+        void *response);
+
+/**
+ * @brief Sends a service request without waiting for its response, which is passed to handler
+ *        while the session waits for responses. Up to #EDGE_ASYNC_MAX_IN_FLIGHT requests of
+ *        a session are outstanding, then sending waits until one of them has been answered.
+ *        The request is encoded before returning, so it may be deallocated by the caller.
+ * @param[in]  client Client Handle.
+ * @param[in]  msg Request message, it is copied for the handler.
+ * @param[in]  request Service request.
+ * @param[in]  requestType Data type of request.
+ * @param[in]  responseType Data type of the response.
+ * @param[in]  handler Response handler.
+ * @param[in]  data Data the handler needs besides msg, copied for the handler. Can be NULL.
+ * @param[in]  dataSize Size of data in bytes.
+ * @return true if the request was sent. Otherwise the caller executes it synchronously.
+ */
+bool sendAsyncService(UA_Client *client, const EdgeMessage *msg, const void *request,
+        const UA_DataType *requestType, const UA_DataType *responseType,
+        EdgeAsyncHandler handler, const void *data, size_t dataSize);
+
+/**
+ * @brief Waits until all asynchronous requests of a session have been answered or
+ *        #EDGE_ASYNC_DRAIN_TIMEOUT has passed.
+ * @param[in]  client Client Handle.
+ * @remarks It runs on the thread which executes the messages of the session. Without send
+ *          lanes that is the single send thread, so a slow server stalls the requests of
+ *          all other endpoints for up to #EDGE_ASYNC_DRAIN_TIMEOUT (5 seconds by default).
+ */
+void drainAsyncServices(UA_Client *client);
+
+/**
+ * @brief Forgets the asynchronous requests of a client, called when its session ends.
+ *        Responses which arrive later are still passed to their handlers.
+ * @param[in]  client Client Handle.
+ */
+void removeAsyncServices(UA_Client *client);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // EDGE_ASYNC_SERVICE_H
@@ -21,14 +21,26 @@
 #include "browse_common.h"
 #include "edge_node_type.h"
 #include "edge_logger.h"
+#include "edge_trace.h"
+#include "edge_client_stats.h"
 #include "edge_malloc.h"
 #include "edge_open62541.h"
 #include "message_dispatcher.h"
 #include "command_adapter.h"
 #include "uqueue.h"
+#include "async_service.h"
+#include "browse_snapshot.h"
+#include "server_capabilities.h"
+#include "edge_hash_map.h"
 
 #include <inttypes.h>
+#include <stdio.h>
 #include <string.h>
+#ifndef _WIN32
+#include <pthread.h>
+#else
+#include "pthread.h"
+#endif
 
 #define TAG "browse_common"
 #define BROWSE_PATH_SEPERATOR "/"
@@ -42,16 +54,39 @@ static const char WELL_KNOWN_LOCALHOST_URI_VALUE[] = "opc.tcp://localhost";
 
 static response_cb_t g_responseCallback = NULL;
 
+/* Browse request message -> BrowseSnapshot which records its responses */
+static EdgeHashMap *g_snapshotRecorders = NULL;
+static pthread_mutex_t g_snapshotRecorderMutex = PTHREAD_MUTEX_INITIALIZER;
+
+/*
+ * Browse path of a node as a chain of parent pointers, e.g. /a/b/c is c -> b -> a.
+ * Children share the path of their parent, the string is only built for the application.
+ */
+typedef struct BrowsePathNode
+{
+    struct BrowsePathNode *parent; // Path of the parent node, NULL for the root.
+    uint32_t refCount; // Browse items and child paths referring to this path.
+    size_t length; // Length of the complete path.
+    bool endsWithSeparator; // The complete path ends with BROWSE_PATH_SEPERATOR.
+    size_t segmentLength; // Length of segment.
+    char segment[]; // Characters added to the parent path, including the separator.
+} BrowsePathNode;
+
 typedef struct BrowseItem
 {
     uint32_t reqId; // If client app rquested browse for N nodes, then a sequential request id from 0 to N-1 will be assigned.
     UA_NodeId *nodeId; // Node ID.
-    unsigned char *browseName; // Browse name.
-    uint32_t browseNameLen; // Length of browse name.
-    unsigned char *browsePath; // Complete path starting from the root till this node. Ex: /a/b/c
-    uint32_t browsePathLen; // Length of browse path.
+    BrowsePathNode *browsePath; // Complete path starting from the root till this node. Ex: /a/b/c
+    uint32_t depth; // Levels below the start node.
 } BrowseItem;
 
+typedef struct BrowseContext
+{
+    EdgeHashMap *visited; // Nodes visited by the browse operation, see visitNode().
+    size_t resultCount; // Results passed to the application.
+    bool stopped; // The result limit is reached or the application stopped the browse.
+} BrowseContext;
+
 void setErrorResponseCallback(response_cb_t callback) {
     g_responseCallback = callback;
 }
@@ -77,8 +112,8 @@ UA_NodeId *getNodeId(EdgeRequest *req)
     VERIFY_NON_NULL_MSG(req->nodeInfo, "EdgeRequest NodeInfo is NULL\n", NULL);
     VERIFY_NON_NULL_MSG(req->nodeInfo->nodeId, "EdgeRequest NodeId is NULL\n", NULL);
 
-    UA_NodeId *node = (UA_NodeId *) EdgeCalloc(1, sizeof(UA_NodeId));
-    VERIFY_NON_NULL_MSG(node, "EdgeCalloc FAILED for UA Node Id\n", NULL);
+    UA_NodeId *node = UA_NodeId_new();
+    VERIFY_NON_NULL_MSG(node, "UA_NodeId_new FAILED for UA Node Id\n", NULL);
     if (req->nodeInfo->nodeId->type == EDGE_INTEGER)
     {
         *node = UA_NODEID_NUMERIC(req->nodeInfo->nodeId->nameSpace,
@@ -99,7 +134,7 @@ UA_NodeId *getNodeId(EdgeRequest *req)
 void invokeErrorCb(uint32_t srcMsgId, EdgeNodeId *srcNodeId,
         EdgeStatusCode edgeResult, const char *versatileValue)
 {
-    EdgeMessage *resultMsg = (EdgeMessage *) EdgeCalloc(1, sizeof(EdgeMessage));
+    EdgeMessage *resultMsg = allocEdgeMessage();
     VERIFY_NON_NULL_NR_MSG(resultMsg, "EdgeCalloc FAILED for EdgeMessage in invokeErrorCb\n");
 
     resultMsg->message_id = srcMsgId; // Error message corresponds to the request message with the given message id.
@@ -169,18 +204,55 @@ EXIT:
     freeEdgeMessage(resultMsg);
 }
 
-static void invokeResponseCb(EdgeMessage *msg, int msgId, EdgeNodeId *srcNodeId,
+/**
+ * @brief recordBrowseResponse - Adds a browse response to the snapshot which records the
+ *        browse of msg, if there is one. A snapshot which misses a response is discarded.
+ */
+static void recordBrowseResponse(EdgeMessage *msg, int msgId, EdgeNodeId *srcNodeId,
+        const char *browseName, const unsigned char *browsePath, const char *valueAlias)
+{
+    pthread_mutex_lock(&g_snapshotRecorderMutex);
+    BrowseSnapshot *snapshot = (BrowseSnapshot *) getEdgeHashMapElement(g_snapshotRecorders, msg);
+    if (IS_NOT_NULL(snapshot))
+    {
+        BrowseSnapshotReference reference;
+        memset(&reference, 0, sizeof(BrowseSnapshotReference));
+        reference.requestId = (uint32_t) msgId;
+        if (IS_NOT_NULL(srcNodeId))
+        {
+            reference.srcNodeId = *srcNodeId;
+        }
+        reference.browseName = browseName;
+        reference.browsePath = browsePath;
+        reference.valueAlias = valueAlias;
+        if (!addBrowseSnapshotReference(snapshot, &reference))
+        {
+            EDGE_LOG(TAG, "Failed to record a browse response, the snapshot is discarded.");
+            removeEdgeHashMapElement(g_snapshotRecorders, msg, NULL);
+            closeBrowseSnapshot(snapshot);
+        }
+    }
+    pthread_mutex_unlock(&g_snapshotRecorderMutex);
+}
+
+/**
+ * @brief invokeResponseCb - Passes a browse result to the application
+ * @return false if the result callback of the request stopped the browse
+ */
+static bool invokeResponseCb(EdgeMessage *msg, int msgId, EdgeNodeId *srcNodeId,
         EdgeBrowseResult *browseResult, size_t size, const unsigned char *browsePath, char *valueAlias)
 {
-    VERIFY_NON_NULL_NR_MSG(browseResult, "EdgeBrowseResult Param is NULL\n");
-    VERIFY_NON_NULL_NR_MSG(browseResult->browseName, "EdgeBrowseResult.BrowseName is NULL\n");
+    VERIFY_NON_NULL_MSG(browseResult, "EdgeBrowseResult Param is NULL\n", true);
+    VERIFY_NON_NULL_MSG(browseResult->browseName, "EdgeBrowseResult.BrowseName is NULL\n", true);
 
-    EdgeMessage *resultMsg = (EdgeMessage *) EdgeCalloc(1, sizeof(EdgeMessage));
-    VERIFY_NON_NULL_NR_MSG(resultMsg, "EdgeCalloc Failed for EdgeMessage in invokeResponseCb\n");
+    recordBrowseResponse(msg, msgId, srcNodeId, browseResult->browseName, browsePath, valueAlias);
+
+    EdgeMessage *resultMsg = allocEdgeMessage();
+    VERIFY_NON_NULL_MSG(resultMsg, "EdgeCalloc Failed for EdgeMessage in invokeResponseCb\n", true);
 
     resultMsg->type = BROWSE_RESPONSE;
     resultMsg->message_id = msg->message_id;
-    resultMsg->endpointInfo = cloneEdgeEndpointInfo(msg->endpointInfo);
+    setMessageEndpointInfo(resultMsg, shareMessageEndpointInfo(msg));
     if (IS_NULL(resultMsg->endpointInfo))
     {
         EDGE_LOG(TAG, "Failed to clone the EdgeEndpointInfo.");
@@ -242,12 +314,20 @@ static void invokeResponseCb(EdgeMessage *msg, int msgId, EdgeNodeId *srcNodeId,
 
     resultMsg->browseResultLength = size;
 
+    if (IS_NOT_NULL(msg->browseParam) && IS_NOT_NULL(msg->browseParam->resultCallback))
+    {
+        // The callback runs on the browse thread, so that it can stop the browse.
+        bool proceed = msg->browseParam->resultCallback(resultMsg, msg->browseParam->resultContext);
+        freeEdgeMessage(resultMsg);
+        return proceed;
+    }
     add_to_recvQ(resultMsg);
-    return;
+    return true;
 
 BROWSE_ERROR:
     // Deallocate memory.
     freeEdgeMessage(resultMsg);
+    return true;
 }
 
 static bool checkContinuationPoint(uint32_t msgId, UA_BrowseResult *browseResult,
@@ -454,80 +534,221 @@ unsigned char *convertNodeIdToString(UA_NodeId *nodeId)
     return browseName;
 }
 
-// Ex1: If path1 = '/Objects', path2 = 'Server', then this function returns '/Objects/Server'.
-// Ex2: If path1 = '/', path2 = 'Server', then this function returns '/Server'.
-// Ex3: If path1 = '', path2 = 'Server', then this function returns 'Server'.
-// Ex4: If path1 = '/', path2 = '', then this function returns '/'.
-static unsigned char *joinPaths(unsigned char *path1, unsigned char *path2)
+/**
+ * @brief createBrowsePath - Creates the path of a child node, joined like /a/b + c = /a/b/c
+ * @param parent - Path of the parent node, NULL to create the root path '/name'
+ * @param name - Browse name of the node, may be NULL
+ * @param nameLength - Length of name
+ * @return Path with a reference count of 1, NULL in case of error
+ */
+static BrowsePathNode *createBrowsePath(BrowsePathNode *parent, const char *name, size_t nameLength)
 {
-    size_t len1 = 0, len2 = 0, totLen;
-    if(IS_NOT_NULL(path1))
+    if(IS_NULL(name))
+    {
+        nameLength = 0;
+    }
+
+    // A separator is needed only between two non-empty parts which are not separated yet.
+    size_t separatorLength = IS_NULL(parent) || (nameLength > 0 && !parent->endsWithSeparator);
+    BrowsePathNode *path = (BrowsePathNode *) EdgeMalloc(sizeof(BrowsePathNode)
+            + separatorLength + nameLength);
+    VERIFY_NON_NULL_MSG(path, "Memory allocation failed.", NULL);
+
+    path->parent = parent;
+    path->refCount = 1;
+    path->segmentLength = separatorLength + nameLength;
+    path->length = (IS_NULL(parent) ? 0 : parent->length) + path->segmentLength;
+    if(separatorLength > 0)
     {
-        len1 = strlen((char *)path1);
+        path->segment[0] = BROWSE_PATH_SEPERATOR[0];
     }
-    if(IS_NOT_NULL(path2))
+    if(nameLength > 0)
+    {
+        memcpy(path->segment + separatorLength, name, nameLength);
+        path->endsWithSeparator = (name[nameLength - 1] == BROWSE_PATH_SEPERATOR[0]);
+    }
+    else
     {
-        len2 = strlen((char *)path2);
+        path->endsWithSeparator = IS_NULL(parent) || parent->endsWithSeparator;
     }
 
-    totLen = len1 + len2 + 1;
-    COND_CHECK((totLen == 1), NULL); // Both the paths are empty.
+    if(IS_NOT_NULL(parent))
+    {
+        parent->refCount++;
+    }
+    return path;
+}
+
+/**
+ * @brief releaseBrowsePath - Drops a reference to a path. The path and the parents which are
+ *        no longer referred to are freed.
+ * @param path - Path, may be NULL
+ */
+static void releaseBrowsePath(BrowsePathNode *path)
+{
+    while(IS_NOT_NULL(path) && 0 == --path->refCount)
+    {
+        BrowsePathNode *parent = path->parent;
+        EdgeFree(path);
+        path = parent;
+    }
+}
+
+/**
+ * @brief getBrowsePathString - Builds the complete path string of a node joined with a leaf name
+ * @param path - Path of the node
+ * @param leaf - Name to append, may be NULL
+ * @return NUL-terminated path which is to be freed by the caller, NULL in case of error
+ */
+static unsigned char *getBrowsePathString(const BrowsePathNode *path, const char *leaf)
+{
+    VERIFY_NON_NULL_MSG(path, "path param is NULL", NULL);
+
+    size_t leafLength = IS_NULL(leaf) ? 0 : strlen(leaf);
+    size_t separatorLength = (leafLength > 0 && !path->endsWithSeparator);
+    size_t length = path->length + separatorLength + leafLength;
 
-    unsigned char *result = (unsigned char *) EdgeCalloc(totLen+1, sizeof(unsigned char));
+    unsigned char *result = (unsigned char *) EdgeMalloc(length + 1);
     VERIFY_NON_NULL_MSG(result, "Memory allocation failed.", NULL);
 
-    if(len1 > 0)
+    // Segments are filled from the leaf up to the root.
+    if(leafLength > 0)
+    {
+        memcpy(result + length - leafLength, leaf, leafLength);
+    }
+    if(separatorLength > 0)
     {
-        strncpy((char *)result, (char *)path1, len1);
+        result[path->length] = BROWSE_PATH_SEPERATOR[0];
     }
-    size_t offset = len1;
-    if(len2 > 0)
+    for(; IS_NOT_NULL(path); path = path->parent)
     {
-        if(len1 > 0 && result[len1-1] != '/')
+        memcpy(result + path->length - path->segmentLength, path->segment, path->segmentLength);
+    }
+    result[length] = '\0';
+    return result;
+}
+
+/**
+ * @brief getNodeIdKey - Makes a key which identifies a node in the visited set,
+ *        e.g. "2;s=Temperature" or "0;i=85"
+ * @param nodeId - Node ID
+ * @return Key which is to be freed by the caller, NULL in case of error
+ */
+static char *getNodeIdKey(const UA_NodeId *nodeId)
+{
+    size_t dataLength = 0;
+    switch(nodeId->identifierType)
+    {
+        case UA_NODEIDTYPE_STRING:
+            dataLength = nodeId->identifier.string.length;
+            break;
+        case UA_NODEIDTYPE_BYTESTRING:
+            dataLength = 2 * nodeId->identifier.byteString.length;
+            break;
+        default:
+            // Numeric and GUID identifiers are formatted below.
+            break;
+    }
+
+    // Namespace index, type, numeric identifier or GUID and the data of string identifiers.
+    size_t size = 64 + dataLength;
+    char *key = (char *) EdgeMalloc(size);
+    VERIFY_NON_NULL_MSG(key, "Memory allocation failed.", NULL);
+
+    int offset = 0;
+    switch(nodeId->identifierType)
+    {
+        case UA_NODEIDTYPE_NUMERIC:
+            snprintf(key, size, "%u;i=%" PRIu32, nodeId->namespaceIndex, nodeId->identifier.numeric);
+            break;
+        case UA_NODEIDTYPE_STRING:
+            offset = snprintf(key, size, "%u;s=", nodeId->namespaceIndex);
+            if(dataLength > 0)
+            {
+                memcpy(key + offset, nodeId->identifier.string.data, dataLength);
+            }
+            key[offset + dataLength] = '\0';
+            break;
+        case UA_NODEIDTYPE_GUID:
         {
-            result[len1] = '/';
-            ++offset;
+            const UA_Guid *guid = &nodeId->identifier.guid;
+            snprintf(key, size, "%u;g=%08x-%04x-%04x-%02x%02x-%02x%02x%02x%02x%02x%02x",
+                    nodeId->namespaceIndex, guid->data1, guid->data2, guid->data3,
+                    guid->data4[0], guid->data4[1], guid->data4[2], guid->data4[3],
+                    guid->data4[4], guid->data4[5], guid->data4[6], guid->data4[7]);
+            break;
         }
-        strncpy((char *)(result+offset), (char *)path2, len2);
+        case UA_NODEIDTYPE_BYTESTRING:
+            offset = snprintf(key, size, "%u;b=", nodeId->namespaceIndex);
+            for(size_t idx = 0; idx < nodeId->identifier.byteString.length; ++idx)
+            {
+                snprintf(key + offset + 2 * idx, 3, "%02x", nodeId->identifier.byteString.data[idx]);
+            }
+            key[offset + dataLength] = '\0';
+            break;
+        default:
+            EDGE_LOG(TAG, "Unknown node id type.");
+            EdgeFree(key);
+            return NULL;
+    }
+    return key;
+}
+
+/**
+ * @brief visitNode - Adds a node to the visited set of the browse operation
+ * @param visited - Visited set, the key of each node is also its value
+ * @param nodeId - Node ID
+ * @param firstVisit - Set to false if the node has been visited before
+ * @return false in case of error
+ */
+static bool visitNode(EdgeHashMap *visited, const UA_NodeId *nodeId, bool *firstVisit)
+{
+    char *key = getNodeIdKey(nodeId);
+    VERIFY_NON_NULL_MSG(key, "Failed to make the key of a node.", false);
+
+    *firstVisit = IS_NULL(getEdgeHashMapElement(visited, key));
+    if(!*firstVisit)
+    {
+        EdgeFree(key);
+        return true;
     }
-    return result;
+    if(!insertEdgeHashMapElement(visited, key, key))
+    {
+        EDGE_LOG(TAG, "Failed to add a node to the visited set.");
+        EdgeFree(key);
+        return false;
+    }
+    return true;
 }
 
-static uint16_t getMaxNodesToBrowse(UA_Client *client)
+static void destroyVisitedNodes(EdgeHashMap **visited)
 {
-    /* Read Maximum browse continuation points supported by the server */
-    UA_UInt16 maxBrowseContinuationPoints = 1; // Server's mandatory property. Minimum value assumed.
-    UA_Variant *val = UA_Variant_new();
-    UA_StatusCode retval = UA_Client_readValueAttribute(client,
-            UA_NODEID_NUMERIC(0, UA_NS0ID_SERVER_SERVERCAPABILITIES_MAXBROWSECONTINUATIONPOINTS), val);
-    if(retval == UA_STATUSCODE_GOOD && UA_Variant_isScalar(val) &&
-       val->type == &UA_TYPES[UA_TYPES_UINT16])
+    VERIFY_NON_NULL_NR_MSG(*visited, "visited set is NULL");
+    size_t cursor = 0;
+    keyValue key = NULL;
+    while(getNextEdgeHashMapElement(*visited, &cursor, &key, NULL))
     {
-        maxBrowseContinuationPoints = *(UA_UInt16*)val->data;
-        EDGE_LOG_V(TAG, "Maximum browse continuation points supported by the server is: %u\n",
-                maxBrowseContinuationPoints);
+        EdgeFree(key);
     }
-    UA_Variant_delete(val);
+    deleteEdgeHashMap(*visited);
+    *visited = NULL;
+}
 
-    /* Read Maximum nodes per browse supported by the server */
-    UA_UInt32 maxNodesPerBrowse = 0; // Server's optional property.
-    val = UA_Variant_new();
-    retval = UA_Client_readValueAttribute(client,
-            UA_NODEID_NUMERIC(0, UA_NS0ID_SERVER_SERVERCAPABILITIES_OPERATIONLIMITS_MAXNODESPERBROWSE), val);
-    if(retval == UA_STATUSCODE_GOOD && UA_Variant_isScalar(val) &&
-       val->type == &UA_TYPES[UA_TYPES_UINT32])
+static uint16_t getMaxNodesToBrowse(UA_Client *client, uint16_t *maxContinuationPoints)
+{
+    /* Capabilities are read once per session */
+    EdgeServerCapabilities capabilities;
+    getServerCapabilities(client, &capabilities);
+    if (IS_NOT_NULL(maxContinuationPoints))
     {
-        maxNodesPerBrowse = *(UA_UInt32*)val->data;
-        EDGE_LOG_V(TAG, "Maximum nodes per browse request supported by the server is: %u\n",
-                maxNodesPerBrowse);
+        *maxContinuationPoints = capabilities.maxBrowseContinuationPoints;
     }
-    UA_Variant_delete(val);
 
     /* Choose the minimum of them */
-    uint16_t minimum = maxBrowseContinuationPoints;
-    if(maxNodesPerBrowse != 0 && maxNodesPerBrowse < minimum)
+    uint16_t minimum = capabilities.maxBrowseContinuationPoints;
+    if(capabilities.maxNodesPerBrowse != 0 && capabilities.maxNodesPerBrowse < minimum)
     {
-        minimum = maxNodesPerBrowse;
+        minimum = capabilities.maxNodesPerBrowse;
     }
 
     return minimum;
@@ -572,8 +793,7 @@ static BrowseItem *dequeueBrowseItem(u_queue_t *browseQueue)
 static void destroyBrowseItemMembers(BrowseItem *item)
 {
     VERIFY_NON_NULL_NR_MSG(item, "browseItem is NULL");
-    EdgeFree(item->browseName);
-    EdgeFree(item->browsePath);
+    releaseBrowsePath(item->browsePath);
     VERIFY_NON_NULL_NR_MSG(item->nodeId, "browseItem is NULL");
     UA_NodeId_delete(item->nodeId);
 }
@@ -649,13 +869,8 @@ static BrowseItem *parseBrowseNodeFromReference(UA_ReferenceDescription *referen
         return NULL;
     }
 
-    newItem->browseName = convertUAStringToUnsignedChar(&reference->browseName.name);
-    if(IS_NOT_NULL(newItem->browseName))
-    {
-        newItem->browseNameLen = strlen((char *)newItem->browseName);
-    }
-
-    newItem->browsePath = joinPaths(srcBrowseItem->browsePath, newItem->browseName);
+    newItem->browsePath = createBrowsePath(srcBrowseItem->browsePath,
+            (const char *) reference->browseName.name.data, reference->browseName.name.length);
     if(IS_NULL(newItem->browsePath))
     {
         destroyBrowseItem(newItem);
@@ -663,8 +878,8 @@ static BrowseItem *parseBrowseNodeFromReference(UA_ReferenceDescription *referen
         return NULL;
     }
 
-    newItem->browsePathLen = strlen((char *)newItem->browsePath);
     newItem->reqId = srcBrowseItem->reqId;
+    newItem->depth = srcBrowseItem->depth + 1;
     return newItem;
 }
 
@@ -682,36 +897,35 @@ static BrowseItem *parseBrowseNodeFromRequest(EdgeRequest *req, uint32_t reqId)
         return NULL;
     }
 
-    newItem->browseName = convertNodeIdToString(newItem->nodeId);
-    if(IS_NOT_NULL(newItem->browseName))
-    {
-        newItem->browseNameLen = strlen((char *)newItem->browseName);
-    }
-
-    unsigned char *rootPath = (unsigned char *)"/";
-    newItem->browsePath = joinPaths(rootPath, newItem->browseName);
+    char *browseName = (char *) convertNodeIdToString(newItem->nodeId);
+    newItem->browsePath = createBrowsePath(NULL, browseName,
+            IS_NULL(browseName) ? 0 : strlen(browseName));
+    EdgeFree(browseName);
     if(IS_NULL(newItem->browsePath))
     {
         destroyBrowseItem(newItem);
         EDGE_LOG(TAG, "Failed to join browse paths.");
         return NULL;
     }
-    newItem->browsePathLen = strlen((char *)newItem->browsePath);
     newItem->reqId = reqId;
     return newItem;
 }
 
-static bool parseBrowseNodesFromRequest(EdgeMessage *msg, u_queue_t *browseQueue)
+static bool parseBrowseNodesFromRequest(EdgeMessage *msg, u_queue_t *browseQueue,
+        EdgeHashMap *visited)
 {
     VERIFY_NON_NULL_MSG(msg, "msg param is NULL", false);
     VERIFY_NON_NULL_MSG(browseQueue, "browseQueue param is NULL", false);
+    VERIFY_NON_NULL_MSG(visited, "visited param is NULL", false);
+    bool firstVisit;
 
     if (msg->type == SEND_REQUEST)
     {
         EDGE_LOG(TAG, "Message Type: " SEND_REQUEST_DESC);
         BrowseItem *newItem = parseBrowseNodeFromRequest(msg->request, 0);
         VERIFY_NON_NULL_MSG(newItem, "Memory allocation failed.", false);
-        if(!enqueueBrowseItem(browseQueue, newItem))
+        if(!visitNode(visited, newItem->nodeId, &firstVisit) ||
+            !enqueueBrowseItem(browseQueue, newItem))
         {
             destroyBrowseItem(newItem);
             EDGE_LOG(TAG, "Failed to enqueue browse item.");
@@ -726,7 +940,9 @@ static bool parseBrowseNodesFromRequest(EdgeMessage *msg, u_queue_t *browseQueue
         {
             BrowseItem *newItem = parseBrowseNodeFromRequest(msg->requests[i], i);
             VERIFY_NON_NULL_MSG(newItem, "Memory allocation failed.", false);
-            if(!enqueueBrowseItem(browseQueue, newItem))
+            // Every requested node is browsed, even if it is requested twice.
+            if(!visitNode(visited, newItem->nodeId, &firstVisit) ||
+                !enqueueBrowseItem(browseQueue, newItem))
             {
                 destroyBrowseItem(newItem);
                 EDGE_LOG(TAG, "Failed to enqueue browse item.");
@@ -801,16 +1017,16 @@ static bool makeBrowseNextRequest(UA_Client *client, EdgeMessage *msg,
     return true;
 }
 
-static bool makeBrowseRequest(UA_Client *client, BrowseItem **currentBrowseItems,
-        uint32_t count, EdgeMessage *msg, UA_BrowseResponse *bRes)
+static UA_BrowseDescription *initBrowseRequest(BrowseItem **currentBrowseItems,
+        uint32_t count, EdgeMessage *msg, UA_BrowseRequest *bReq)
 {
-    VERIFY_NON_NULL_MSG(client, "client param is NULL", false);
-    VERIFY_NON_NULL_MSG(currentBrowseItems, "currentBrowseItems param is NULL", false);
-    VERIFY_NON_NULL_MSG(msg, "msg param is NULL", false);
-    VERIFY_NON_NULL_MSG(bRes, "bRes param is NULL", false);
+    VERIFY_NON_NULL_MSG(currentBrowseItems, "currentBrowseItems param is NULL", NULL);
+    VERIFY_NON_NULL_MSG(msg, "msg param is NULL", NULL);
+    VERIFY_NON_NULL_MSG(bReq, "bReq param is NULL", NULL);
 
     // Form browse request.
     int maxReferencesPerNode = 0;
+    UA_UInt32 referenceTypeId = UA_NS0ID_REFERENCES;
     UA_BrowseDirection directionParam = UA_BROWSEDIRECTION_FORWARD;
     if(IS_NOT_NULL(msg->browseParam))
     {
@@ -825,34 +1041,45 @@ static bool makeBrowseRequest(UA_Client *client, BrowseItem **currentBrowseItems
         }
 
         maxReferencesPerNode = msg->browseParam->maxReferencesPerNode;
+
+        // The server leaves out the other references, the views are still searched along all.
+        if(CMD_BROWSE == msg->command && msg->browseParam->referenceTypeId > 0)
+        {
+            referenceTypeId = msg->browseParam->referenceTypeId;
+        }
     }
 
     UA_BrowseDescription *nodesToBrowse = (UA_BrowseDescription *) UA_calloc(count,
             sizeof(UA_BrowseDescription));
-    VERIFY_NON_NULL_MSG(nodesToBrowse, "Failed to allocate memory for browse description.", false);
+    VERIFY_NON_NULL_MSG(nodesToBrowse, "Failed to allocate memory for browse description.", NULL);
 
     UA_UInt32 nodeClassMask = (msg->command != CMD_BROWSE_VIEW) ?
             BROWSE_NODECLASS_MASK : VIEW_NODECLASS_MASK;
 
-    UA_BrowseRequest bReq;
-    UA_BrowseRequest_init(&bReq);
-    bReq.requestedMaxReferencesPerNode = maxReferencesPerNode;
-    bReq.nodesToBrowseSize = count;
-    bReq.nodesToBrowse = nodesToBrowse;
+    UA_BrowseRequest_init(bReq);
+    bReq->requestedMaxReferencesPerNode = maxReferencesPerNode;
+    bReq->nodesToBrowseSize = count;
+    bReq->nodesToBrowse = nodesToBrowse;
     for(uint32_t idx = 0; idx < count; ++idx)
     {
         BrowseItem *item = currentBrowseItems[idx];
         nodesToBrowse[idx].nodeId = *(item->nodeId);
         nodesToBrowse[idx].browseDirection = directionParam;
         nodesToBrowse[idx].referenceTypeId = UA_NODEID_NUMERIC(SYSTEM_NAMESPACE_INDEX,
-                UA_NS0ID_REFERENCES);
+                referenceTypeId);
         nodesToBrowse[idx].includeSubtypes = true;
         nodesToBrowse[idx].nodeClassMask = nodeClassMask;
         nodesToBrowse[idx].resultMask = UA_BROWSERESULTMASK_ALL;
     }
+    return nodesToBrowse;
+}
 
-    // Call browse.
-    *bRes = UA_Client_Service_browse(client, bReq);
+static bool checkBrowseResponse(BrowseItem **currentBrowseItems, uint32_t count,
+        EdgeMessage *msg, UA_BrowseResponse *bRes)
+{
+    VERIFY_NON_NULL_MSG(currentBrowseItems, "currentBrowseItems param is NULL", false);
+    VERIFY_NON_NULL_MSG(msg, "msg param is NULL", false);
+    VERIFY_NON_NULL_MSG(bRes, "bRes param is NULL", false);
 
     // Check result. Invoke app's error callback if there is an error.
     if (bRes->responseHeader.serviceResult != UA_STATUSCODE_GOOD || bRes->resultsSize != count)
@@ -877,12 +1104,30 @@ static bool makeBrowseRequest(UA_Client *client, BrowseItem **currentBrowseItems
         invokeErrorCb(msg->message_id, nodeId, statusCode, versatileVal);
         freeEdgeNodeId(nodeId);
         UA_BrowseResponse_deleteMembers(bRes);
-        EdgeFree(nodesToBrowse);
         return false;
     }
+    return true;
+}
+
+static bool makeBrowseRequest(UA_Client *client, BrowseItem **currentBrowseItems,
+        uint32_t count, EdgeMessage *msg, UA_BrowseResponse *bRes)
+{
+    VERIFY_NON_NULL_MSG(client, "client param is NULL", false);
+    VERIFY_NON_NULL_MSG(bRes, "bRes param is NULL", false);
+
+    UA_BrowseRequest bReq;
+    UA_BrowseDescription *nodesToBrowse = initBrowseRequest(currentBrowseItems, count, msg, &bReq);
+    COND_CHECK(IS_NULL(nodesToBrowse), false);
 
+    // Call browse.
+    uint64_t startUs = getClientServiceTime();
+    EDGE_TRACE_BEGIN(msg, EDGE_TRACE_STAGE_SERVICE);
+    *bRes = UA_Client_Service_browse(client, bReq);
+    EDGE_TRACE_END(msg, EDGE_TRACE_STAGE_SERVICE);
+    recordClientService(client, msg->command, startUs, bRes->responseHeader.serviceResult);
     EdgeFree(nodesToBrowse);
-    return true;
+
+    return checkBrowseResponse(currentBrowseItems, count, msg, bRes);
 }
 
 static uint32_t dequeueItems(u_queue_t *browseQueue, uint32_t count,
@@ -901,24 +1146,6 @@ static uint32_t dequeueItems(u_queue_t *browseQueue, uint32_t count,
     return count;
 }
 
-bool hasCycle(unsigned char *srcBrowsePath, UA_String *browseName)
-{
-    VERIFY_NON_NULL_MSG(srcBrowsePath, "srcBrowsePath param is NULL", false);
-    VERIFY_NON_NULL_MSG(browseName, "browseName param is NULL", false);
-
-    size_t tokenLen;
-    unsigned char *token = (unsigned char *)strtok((char *)srcBrowsePath, BROWSE_PATH_SEPERATOR);
-    while(IS_NOT_NULL(token))
-    {
-        tokenLen = strlen((char *)token);
-        COND_CHECK((tokenLen == browseName->length &&
-                    !memcmp(token, browseName->data, browseName->length)), true);
-        token = (unsigned char *)strtok(NULL, BROWSE_PATH_SEPERATOR);
-    }
-
-    return false;
-}
-
 static bool validateReference(UA_ReferenceDescription *reference,
         EdgeMessage *msg, BrowseItem *srcBrowseItem, EdgeNodeId *srcNodeId)
 {
@@ -957,24 +1184,15 @@ static bool validateReference(UA_ReferenceDescription *reference,
     if (!checkTypeDefinition(msg->message_id, reference, srcNodeId))
         valid = false;
 
-    // Checking whether the browse name of the reference is there or not in the browse path.
-    unsigned char *pathCopy = cloneData(srcBrowseItem->browsePath,
-            strlen((char *)srcBrowseItem->browsePath)+1);
-    if(hasCycle(pathCopy, &reference->browseName.name))
-    {
-        EDGE_LOG(TAG, "Found this node in the current browse path. Ignoring this node to avoid cycle.");
-        valid = false;
-    }
-
     // Log the NodeId for debugging purpose.
     logNodeId(reference->nodeId.nodeId);
 
-    EdgeFree(pathCopy);
     return valid;
 }
 
 static bool passReferenceToApp(UA_ReferenceDescription *reference,
-        EdgeMessage *msg, BrowseItem *srcBrowseItem, EdgeNodeId *srcNodeId)
+        EdgeMessage *msg, BrowseItem *srcBrowseItem, EdgeNodeId *srcNodeId,
+        BrowseContext *context)
 {
     VERIFY_NON_NULL_MSG(reference, "reference param is NULL", false);
     VERIFY_NON_NULL_MSG(msg, "msg param is NULL", false);
@@ -1008,21 +1226,30 @@ static bool passReferenceToApp(UA_ReferenceDescription *reference,
     if((!SHOW_SPECIFIC_NODECLASS) || (reference->nodeClass & SHOW_SPECIFIC_NODECLASS_MASK)){
         valueAlias = getValueAlias(browseResult->browseName,
                 &(reference->nodeId.nodeId), reference->displayName);
-        completePath = joinPaths(srcBrowseItem->browsePath, (unsigned char *)valueAlias);
+        completePath = getBrowsePathString(srcBrowseItem->browsePath, valueAlias);
     }
 
-    invokeResponseCb(msg, srcBrowseItem->reqId, srcNodeId, browseResult, size, completePath, valueAlias);
+    bool proceed = invokeResponseCb(msg, srcBrowseItem->reqId, srcNodeId, browseResult, size,
+            completePath, valueAlias);
     EdgeFree(completePath);
     EdgeFree(valueAlias);
     EdgeFree(browseResult->browseName);
     EdgeFree(browseResult);
+
+    context->resultCount++;
+    size_t maxResults = IS_NOT_NULL(msg->browseParam) ? msg->browseParam->maxResults : 0;
+    if(!proceed || (maxResults > 0 && context->resultCount >= maxResults))
+    {
+        EDGE_LOG(TAG, "Browse is stopped.");
+        context->stopped = true;
+    }
     return true;
 }
 
 static bool handleBrowseResult(UA_Client *client, EdgeMessage *msg,
         u_queue_t *browseQueue, BrowseItem *srcBrowseItem,
         EdgeNodeId *srcNodeId, UA_BrowseResult *browseResult,
-        List **viewList)
+        BrowseContext *context, List **viewList)
 {
     VERIFY_NON_NULL_MSG(client, "client param is NULL", false);
     VERIFY_NON_NULL_MSG(msg, "msg param is NULL", false);
@@ -1030,6 +1257,7 @@ static bool handleBrowseResult(UA_Client *client, EdgeMessage *msg,
     VERIFY_NON_NULL_MSG(srcBrowseItem, "srcBrowseItem param is NULL", false);
     VERIFY_NON_NULL_MSG(srcNodeId, "srcNodeId param is NULL", false);
     VERIFY_NON_NULL_MSG(browseResult, "browseResult param is NULL", false);
+    VERIFY_NON_NULL_MSG(context, "context param is NULL", false);
 
     // If it's a BrowseView request, then view list should be a valid pointer to a list.
     if(CMD_BROWSE_VIEW == msg->command)
@@ -1040,12 +1268,21 @@ static bool handleBrowseResult(UA_Client *client, EdgeMessage *msg,
     // Returning true to avoid processing of other browse results.
     COND_CHECK ((!checkContinuationPoint(msg->message_id, browseResult, srcNodeId)), true);
 
+    // Depth and node class limits apply to the nodes which are passed to the application.
+    uint32_t maxDepth = 0, nodeClassMask = 0;
+    if(CMD_BROWSE == msg->command && IS_NOT_NULL(msg->browseParam))
+    {
+        maxDepth = msg->browseParam->maxDepth;
+        nodeClassMask = msg->browseParam->nodeClassMask;
+    }
+    bool expandable = (0 == maxDepth || srcBrowseItem->depth + 1 < maxDepth);
+
     // Handle references.
     size_t referencesSize = browseResult->referencesSize;
-    for (size_t idx = 0; idx < referencesSize; ++idx)
+    for (size_t idx = 0; idx < referencesSize && !context->stopped; ++idx)
     {
         UA_ReferenceDescription *reference = &browseResult->references[idx];
-        // Verify this reference, check for loop, trigger error callback if it's invalid.
+        // Verify this reference, trigger error callback if it's invalid.
         // Returns true if it's valid.
         if(!validateReference(reference, msg, srcBrowseItem, srcNodeId))
         {
@@ -1053,17 +1290,35 @@ static bool handleBrowseResult(UA_Client *client, EdgeMessage *msg,
             continue;
         }
 
+        // Nodes which are browsed further are expanded only once, which also breaks cycles.
+        // Every valid reference is still passed to the application, e.g. a method node which is
+        // shared by several objects is reported under each of them.
+        bool firstVisit = true;
+        if(UA_NODECLASS_VARIABLE != reference->nodeClass)
+        {
+            if(!visitNode(context->visited, &reference->nodeId.nodeId, &firstVisit))
+            {
+                return false;
+            }
+            if(!firstVisit)
+            {
+                EDGE_LOG(TAG, "This node has been visited already. It is not browsed again.");
+            }
+        }
+
         // Pass the complete browse path of this reference to application.
         // Only for browse requests.
         if(msg->command != CMD_BROWSE_VIEW &&
-            !passReferenceToApp(reference, msg, srcBrowseItem, srcNodeId))
+            (0 == nodeClassMask || (reference->nodeClass & nodeClassMask)) &&
+            !passReferenceToApp(reference, msg, srcBrowseItem, srcNodeId, context))
         {
             EDGE_LOG_V(TAG, "Failed to pass reference(%zu) to application.\n", idx);
             return false;
         }
 
         // If the reference is not a variable type, then create a BrowseItem for it and enqueue.
-        if(UA_NODECLASS_VARIABLE != reference->nodeClass)
+        if(UA_NODECLASS_VARIABLE != reference->nodeClass && firstVisit && expandable
+                && !context->stopped)
         {
             // Create a BrowseItem.
             BrowseItem *newItem = parseBrowseNodeFromReference(reference, srcBrowseItem);
@@ -1096,10 +1351,52 @@ static bool handleBrowseResult(UA_Client *client, EdgeMessage *msg,
     return true;
 }
 
+/**
+ * @brief releaseContinuationPoints - Releases the continuation points of browse results which
+ *        are not followed because the browse is stopped, so that the session can reuse them.
+ * @param client - Client handle
+ * @param results - Browse results
+ * @param size - Number of results
+ */
+static void releaseContinuationPoints(UA_Client *client, UA_BrowseResult *results, size_t size)
+{
+    size_t count = 0;
+    for(size_t idx = 0; idx < size; ++idx)
+    {
+        count += (results[idx].continuationPoint.length > 0);
+    }
+    COND_CHECK_NR_MSG(0 == count, "");
+
+    UA_ByteString *continuationPoints = (UA_ByteString *) EdgeMalloc(count * sizeof(UA_ByteString));
+    VERIFY_NON_NULL_NR_MSG(continuationPoints, "Memory allocation failed.");
+    count = 0;
+    for(size_t idx = 0; idx < size; ++idx)
+    {
+        if(results[idx].continuationPoint.length > 0)
+        {
+            continuationPoints[count++] = results[idx].continuationPoint;
+        }
+    }
+
+    UA_BrowseNextRequest bReq;
+    UA_BrowseNextRequest_init(&bReq);
+    bReq.releaseContinuationPoints = true;
+    bReq.continuationPointsSize = count;
+    bReq.continuationPoints = continuationPoints;
+    UA_BrowseNextResponse bRes = UA_Client_Service_browseNext(client, bReq);
+    if(UA_STATUSCODE_GOOD != bRes.responseHeader.serviceResult)
+    {
+        EDGE_LOG_V(TAG, "Failed to release continuation points :: 0x%08x\n",
+                bRes.responseHeader.serviceResult);
+    }
+    UA_BrowseNextResponse_deleteMembers(&bRes);
+    EdgeFree(continuationPoints);
+}
+
 static bool browseNextNodes(UA_Client *client, EdgeMessage *msg,
         u_queue_t *browseQueue, BrowseItem *srcBrowseItem,
         EdgeNodeId *srcNodeId, UA_ByteString *continuationPoint,
-        List **viewList)
+        BrowseContext *context, List **viewList)
 {
     VERIFY_NON_NULL_MSG(client, "client param is NULL", false);
     VERIFY_NON_NULL_MSG(msg, "msg param is NULL", false);
@@ -1129,7 +1426,8 @@ static bool browseNextNodes(UA_Client *client, EdgeMessage *msg,
             return false;
         }
 
-        if(!handleBrowseResult(client, msg, browseQueue, srcBrowseItem, srcNodeId, &bRes.results[0], viewList))
+        if(!handleBrowseResult(client, msg, browseQueue, srcBrowseItem, srcNodeId, &bRes.results[0],
+                context, viewList))
         {
             EDGE_LOG(TAG, "Failed to handle the BrowseNext result.");
             UA_BrowseNextResponse_deleteMembers(&bRes);
@@ -1143,7 +1441,12 @@ static bool browseNextNodes(UA_Client *client, EdgeMessage *msg,
             EdgeFree(cp.data);
 
         // If there is a continuation point in this browse result, call BrowseNext again.
-        if(bRes.results[0].continuationPoint.length > 0)
+        if(context->stopped)
+        {
+            releaseContinuationPoints(client, bRes.results, 1);
+            done = true;
+        }
+        else if(bRes.results[0].continuationPoint.length > 0)
         {
             // Copy the continuation point.
             cp.length = bRes.results[0].continuationPoint.length;
@@ -1167,8 +1470,317 @@ static bool browseNextNodes(UA_Client *client, EdgeMessage *msg,
     return true;
 }
 
+static bool handleBrowseResponse(UA_Client *client, EdgeMessage *msg, u_queue_t *browseQueue,
+        BrowseItem **currentBrowseItems, uint32_t count, UA_BrowseResponse *bRes,
+        BrowseContext *context, List **viewList)
+{
+    uint32_t nodeIdUnknownCount = 0;
+    EdgeNodeId *srcNodeId = NULL;
+    // Iterate over all the results in the response. Number of results will be same as 'count'.
+    for(uint32_t res_idx = 0; res_idx < count; ++res_idx)
+    {
+        // Results which are not processed any more may still hold continuation points.
+        if(context->stopped)
+        {
+            releaseContinuationPoints(client, &bRes->results[res_idx], count - res_idx);
+            break;
+        }
+
+        // Get the EdgeNodeId of the corresponding request. This is required to be sent in application callbacks.
+        srcNodeId = getEdgeNodeId(currentBrowseItems[res_idx]->nodeId);
+        if(IS_NULL(srcNodeId))
+        {
+            EDGE_LOG(TAG, "Failed to get the edge node id.");
+            invokeErrorCb(msg->message_id, NULL, STATUS_ERROR, "Failed to get the edge node id.");
+            return false;
+        }
+
+        // Check the status code of result and keep track of unknown NodeId cases.
+        UA_StatusCode status = bRes->results[res_idx].statusCode;
+        if (UA_STATUSCODE_GOOD != status)
+        {
+            if (UA_STATUSCODE_BADNODEIDUNKNOWN == status)
+                nodeIdUnknownCount++;
+
+            if (nodeIdUnknownCount == bRes->resultsSize)
+            {
+                EDGE_LOG(TAG, "Error: " STATUS_VIEW_NODEID_UNKNOWN_ALL_RESULTS_VALUE);
+                invokeErrorCb(msg->message_id, srcNodeId, STATUS_VIEW_NODEID_UNKNOWN_ALL_RESULTS,
+                        STATUS_VIEW_NODEID_UNKNOWN_ALL_RESULTS_VALUE);
+            }
+            else
+            {
+                const char *statusStr = UA_StatusCode_name(status);
+                invokeErrorCb(msg->message_id, srcNodeId, STATUS_VIEW_RESULT_STATUS_CODE_BAD, statusStr);
+            }
+            freeEdgeNodeId(srcNodeId);
+            continue;
+        }
+
+        // Process all the references in this browse result. Validate them. Detect & avoid cycle in browse path.
+        // Create BrowseItem for each reference, Pass it to application and Enqueue.
+        if(!handleBrowseResult(client, msg, browseQueue, currentBrowseItems[res_idx], srcNodeId,
+                &bRes->results[res_idx], context, viewList))
+        {
+            EDGE_LOG(TAG, "Failed to handle the browse result.");
+            invokeErrorCb(msg->message_id, srcNodeId, STATUS_ERROR, "Failed to handle the browse result.");
+            freeEdgeNodeId(srcNodeId);
+            return false;
+        }
+
+        if(context->stopped)
+        {
+            releaseContinuationPoints(client, &bRes->results[res_idx], count - res_idx);
+            freeEdgeNodeId(srcNodeId);
+            break;
+        }
+
+        // Handle continution point.
+        // If there is a continuation point in this browse result, call BrowseNext.
+        if(bRes->results[res_idx].continuationPoint.length > 0)
+        {
+            // Perform BrowseNext to get next set of pending references.
+            // Only one continuation point will be passed per BrowseNext call. So there will be only one result per call.
+            // Handle the BrowseNext result - Iterate over all the references, validate them,
+            // pass them to app, enqueue them. If the result still has continuation point, call BrowseNext and perform
+            // the same operations. Continue till there is no continuation point.
+            if(!browseNextNodes(client, msg, browseQueue, currentBrowseItems[res_idx],
+                    srcNodeId, &(bRes->results[res_idx].continuationPoint), context, viewList))
+            {
+                EDGE_LOG(TAG, "Failed to perform BrowseNext.\n");
+                freeEdgeNodeId(srcNodeId);
+                return false;
+            }
+        }
+
+        // Destroy items which are created in this loop.
+        freeEdgeNodeId(srcNodeId);
+    }
+    return true;
+}
+
+#ifdef ENABLE_ASYNC_SERVICES
+/* One Browse request of the pipeline, see browseNodesPipelined(). */
+typedef struct BrowseBatch
+{
+    BrowseItem **items;
+    uint32_t count;
+
+    /**< Response moved out of the stack by browseResponseHandler(). **/
+    UA_BrowseResponse response;
+
+    /**< The response has arrived. **/
+    bool done;
+
+    /**< The browse operation gave up waiting, the handler destroys the batch. **/
+    bool abandoned;
+} BrowseBatch;
+
+static void destroyBrowseBatch(BrowseBatch *batch)
+{
+    destroyBrowseItems(batch->items, batch->count);
+    EdgeFree(batch->items);
+    UA_BrowseResponse_deleteMembers(&batch->response);
+    EdgeFree(batch);
+}
+
+/**
+ * @brief browseResponseHandler - Keeps the response of a pipelined Browse request for
+ *        browseNodesPipelined(). It runs inside the stack, so it leaves the browse queue alone.
+ * @param client - Client handle
+ * @param msg - Copy of the browse request message
+ * @param data - Pointer to the BrowseBatch
+ * @param response - UA_BrowseResponse, moved into the batch
+ */
+static void browseResponseHandler(UA_Client *client, const EdgeMessage *msg, const void *data,
+        void *response)
+{
+    BrowseBatch *batch = *(BrowseBatch * const *) data;
+    if (batch->abandoned)
+    {
+        destroyBrowseBatch(batch);
+        return;
+    }
+    batch->response = *(UA_BrowseResponse *) response;
+    UA_BrowseResponse_init((UA_BrowseResponse *) response);
+    batch->done = true;
+}
+
+/**
+ * @brief sendBrowseBatch - Dequeues up to maxNodesToBrowse items and sends their Browse request
+ *        without waiting for the response. The request is executed synchronously if it
+ *        cannot be pipelined.
+ * @return The batch, NULL in case of error. The error callback has been invoked then.
+ */
+static BrowseBatch *sendBrowseBatch(UA_Client *client, EdgeMessage *msg, u_queue_t *browseQueue,
+        uint16_t maxNodesToBrowse)
+{
+    uint32_t count = u_queue_get_size(browseQueue);
+    if(count > maxNodesToBrowse)
+    {
+        count = maxNodesToBrowse;
+    }
+
+    BrowseBatch *batch = (BrowseBatch *) EdgeCalloc(1, sizeof(BrowseBatch));
+    VERIFY_NON_NULL_MSG(batch, "Failed to allocate memory for browse batch.", NULL);
+    UA_BrowseResponse_init(&batch->response);
+    batch->items = (BrowseItem **) EdgeCalloc(count, sizeof(BrowseItem *));
+    if(IS_NULL(batch->items))
+    {
+        EDGE_LOG(TAG, "Failed to allocate memory for browse request.");
+        EdgeFree(batch);
+        invokeErrorCb(msg->message_id, NULL, STATUS_ERROR, "Failed to allocate memory for browse request.");
+        return NULL;
+    }
+
+    batch->count = dequeueItems(browseQueue, count, batch->items);
+    if(batch->count != count)
+    {
+        EDGE_LOG(TAG, "Failed to dequeue required number of browse items.");
+        destroyBrowseBatch(batch);
+        invokeErrorCb(msg->message_id, NULL, STATUS_ERROR, "Failed to dequeue required number of browse items.");
+        return NULL;
+    }
+
+    UA_BrowseRequest bReq;
+    UA_BrowseDescription *nodesToBrowse = initBrowseRequest(batch->items, count, msg, &bReq);
+    if(IS_NULL(nodesToBrowse))
+    {
+        destroyBrowseBatch(batch);
+        invokeErrorCb(msg->message_id, NULL, STATUS_ERROR, "Failed to allocate memory for browse request.");
+        return NULL;
+    }
+
+    if(!sendAsyncService(client, msg, &bReq, &UA_TYPES[UA_TYPES_BROWSEREQUEST],
+            &UA_TYPES[UA_TYPES_BROWSERESPONSE], browseResponseHandler, &batch, sizeof(batch)))
+    {
+        uint64_t startUs = getClientServiceTime();
+        EDGE_TRACE_BEGIN(msg, EDGE_TRACE_STAGE_SERVICE);
+        batch->response = UA_Client_Service_browse(client, bReq);
+        EDGE_TRACE_END(msg, EDGE_TRACE_STAGE_SERVICE);
+        recordClientService(client, msg->command, startUs,
+                batch->response.responseHeader.serviceResult);
+        batch->done = true;
+    }
+    EdgeFree(nodesToBrowse);
+    return batch;
+}
+
+/**
+ * @brief waitBrowseBatch - Waits for the response of a batch at most #EDGE_ASYNC_DRAIN_TIMEOUT.
+ *        Responses of the other batches in flight are received meanwhile.
+ * @return true if the response has arrived
+ */
+static bool waitBrowseBatch(UA_Client *client, BrowseBatch *batch)
+{
+    UA_DateTime deadline = UA_DateTime_nowMonotonic() + EDGE_ASYNC_DRAIN_TIMEOUT * UA_MSEC_TO_DATETIME;
+    while (!batch->done && UA_DateTime_nowMonotonic() < deadline)
+    {
+        if (UA_STATUSCODE_GOOD != UA_Client_runAsync(client, EDGE_ASYNC_WAIT_TIME))
+        {
+            EDGE_LOG(TAG, "Failed to receive browse responses.");
+            break;
+        }
+    }
+    return batch->done;
+}
+
+/**
+ * @brief releaseBrowseBatches - Destroys the batches whose response has arrived and leaves
+ *        the others to browseResponseHandler().
+ */
+static void releaseBrowseBatches(BrowseBatch **batches, uint32_t first, uint32_t size)
+{
+    for (uint32_t idx = 0; idx < size; ++idx)
+    {
+        BrowseBatch *batch = batches[(first + idx) % EDGE_BROWSE_MAX_IN_FLIGHT];
+        if (batch->done)
+        {
+            destroyBrowseBatch(batch);
+        }
+        else
+        {
+            batch->abandoned = true;
+        }
+    }
+}
+
+/**
+ * @brief browseNodesPipelined - Walks the browse queue like the synchronous loop of
+ *        browseNodesHelper() while up to maxInFlight Browse requests are outstanding.
+ *        Responses are processed in the order of their requests, so the callbacks see the
+ *        same result stream, only the round trips overlap.
+ */
+static bool browseNodesPipelined(UA_Client *client, EdgeMessage *msg, u_queue_t *browseQueue,
+        uint16_t maxNodesToBrowse, uint32_t maxInFlight, BrowseContext *context, List **viewList)
+{
+    BrowseBatch *batches[EDGE_BROWSE_MAX_IN_FLIGHT];
+    uint32_t first = 0, size = 0;
+    bool result = true;
+
+    while(result && !context->stopped && (size > 0 || !isQueueEmpty(browseQueue)))
+    {
+        // Keep the pipeline full.
+        while(size < maxInFlight && !isQueueEmpty(browseQueue))
+        {
+            BrowseBatch *batch = sendBrowseBatch(client, msg, browseQueue, maxNodesToBrowse);
+            if(IS_NULL(batch))
+            {
+                result = false;
+                break;
+            }
+            batches[(first + size) % EDGE_BROWSE_MAX_IN_FLIGHT] = batch;
+            size++;
+        }
+        if(!result || 0 == size)
+        {
+            break;
+        }
+
+        // Process the oldest response, it may enqueue more items.
+        BrowseBatch *batch = batches[first];
+        if(!waitBrowseBatch(client, batch))
+        {
+            EdgeNodeId *nodeId = (batch->count == 1) ? getEdgeNodeId(batch->items[0]->nodeId) : NULL;
+            invokeErrorCb(msg->message_id, nodeId, STATUS_SERVICE_RESULT_BAD,
+                    STATUS_SERVICE_RESULT_BAD_VALUE);
+            freeEdgeNodeId(nodeId);
+            result = false;
+            break;
+        }
+        first = (first + 1) % EDGE_BROWSE_MAX_IN_FLIGHT;
+        size--;
+
+        if(!checkBrowseResponse(batch->items, batch->count, msg, &batch->response))
+        {
+            EDGE_LOG(TAG, "Failed to make a browse request.");
+            result = false;
+        }
+        else if(!handleBrowseResponse(client, msg, browseQueue, batch->items, batch->count,
+                &batch->response, context, viewList))
+        {
+            result = false;
+        }
+        destroyBrowseBatch(batch);
+    }
+
+    // A stopped browse releases the continuation points of the responses in flight too.
+    while(result && context->stopped && size > 0 && waitBrowseBatch(client, batches[first]))
+    {
+        BrowseBatch *batch = batches[first];
+        releaseContinuationPoints(client, batch->response.results, batch->response.resultsSize);
+        destroyBrowseBatch(batch);
+        first = (first + 1) % EDGE_BROWSE_MAX_IN_FLIGHT;
+        size--;
+    }
+    releaseBrowseBatches(batches, first, size);
+    return result;
+}
+#endif
+
 static bool browseNodesHelper(UA_Client *client, EdgeMessage *msg, u_queue_t *browseQueue,
-        uint16_t maxNodesToBrowse, BrowseItem **currentBrowseItems, List **viewList)
+        uint16_t maxNodesToBrowse, uint32_t maxInFlight, BrowseItem **currentBrowseItems,
+        BrowseContext *context, List **viewList)
 {
     VERIFY_NON_NULL_MSG(client, "client param is NULL", false);
     VERIFY_NON_NULL_MSG(msg, "msg param is NULL", false);
@@ -1181,7 +1793,15 @@ static bool browseNodesHelper(UA_Client *client, EdgeMessage *msg, u_queue_t *br
         VERIFY_NON_NULL_MSG(viewList, "viewList param is NULL", false);
     }
 
-    while(!isQueueEmpty(browseQueue))
+#ifdef ENABLE_ASYNC_SERVICES
+    if(maxInFlight > 1)
+    {
+        return browseNodesPipelined(client, msg, browseQueue, maxNodesToBrowse, maxInFlight,
+                context, viewList);
+    }
+#endif
+
+    while(!isQueueEmpty(browseQueue) && !context->stopped)
     {
          // Adjust the maximum nodes to browse based on the queue size.
         uint32_t count = u_queue_get_size(browseQueue);
@@ -1210,89 +1830,264 @@ static bool browseNodesHelper(UA_Client *client, EdgeMessage *msg, u_queue_t *br
             return false;
         }
 
-        uint32_t nodeIdUnknownCount = 0;
-        EdgeNodeId *srcNodeId = NULL;
-        // Iterate over all the results in the response. Number of results will be same as 'count'.
-        for(uint32_t res_idx = 0; res_idx < count; ++res_idx)
+        bool handled = handleBrowseResponse(client, msg, browseQueue, currentBrowseItems, count,
+                &bRes, context, viewList);
+
+        // Destroy items which are created in this loop.
+        destroyBrowseItems(currentBrowseItems, count);
+        UA_BrowseResponse_deleteMembers(&bRes);
+        COND_CHECK(!handled, false);
+    }
+    return true;
+}
+
+/**
+ * @brief getMaxBrowseInFlight - Finds how many Browse requests may be outstanding. Every node
+ *        of them may hold one of the session's continuation points until it is processed.
+ * @param maxNodesToBrowse - Nodes per Browse request
+ * @param maxContinuationPoints - Continuation points of the session
+ * @return Number of Browse requests, 1 if they are not pipelined
+ */
+static uint32_t getMaxBrowseInFlight(uint16_t maxNodesToBrowse, uint16_t maxContinuationPoints)
+{
+#ifdef ENABLE_ASYNC_SERVICES
+    uint32_t maxInFlight = (maxNodesToBrowse > 0) ? maxContinuationPoints / maxNodesToBrowse : 1;
+    if (maxInFlight > EDGE_BROWSE_MAX_IN_FLIGHT)
+    {
+        maxInFlight = EDGE_BROWSE_MAX_IN_FLIGHT;
+    }
+    return (maxInFlight > 0) ? maxInFlight : 1;
+#else
+    (void) maxNodesToBrowse;
+    (void) maxContinuationPoints;
+    return 1;
+#endif
+}
+
+static bool appendSnapshotKey(char **key, size_t *length, const char *data, size_t size)
+{
+    char *newKey = (char *) EdgeRealloc(*key, *length + size + 2);
+    VERIFY_NON_NULL_MSG(newKey, "EdgeRealloc FAILED for snapshot key\n", false);
+    memcpy(newKey + *length, data, size);
+    newKey[*length + size] = '\n';
+    newKey[*length + size + 1] = '\0';
+    *key = newKey;
+    *length += size + 1;
+    return true;
+}
+
+static bool appendSnapshotKeyValue(UA_Client *client, UA_UInt32 node, char **key, size_t *length)
+{
+    UA_Variant *val = UA_Variant_new();
+    VERIFY_NON_NULL_MSG(val, "UA_Variant_new FAILED in appendSnapshotKeyValue\n", false);
+    bool result = false;
+    UA_StatusCode retval = UA_Client_readValueAttribute(client, UA_NODEID_NUMERIC(0, node), val);
+    if (UA_STATUSCODE_GOOD != retval)
+    {
+        EDGE_LOG_V(TAG, "Failed to read node %u for the browse snapshot :: 0x%08x(%s)\n", node,
+                retval, UA_StatusCode_name(retval));
+    }
+    else if (val->type == &UA_TYPES[UA_TYPES_STRING])
+    {
+        result = true;
+        size_t size = UA_Variant_isScalar(val) ? 1 : val->arrayLength;
+        for (size_t idx = 0; idx < size && result; ++idx)
         {
-            // Get the EdgeNodeId of the corresponding request. This is required to be sent in application callbacks.
-            srcNodeId = getEdgeNodeId(currentBrowseItems[res_idx]->nodeId);
-            if(IS_NULL(srcNodeId))
-            {
-                EDGE_LOG(TAG, "Failed to get the edge node id.");
-                UA_BrowseResponse_deleteMembers(&bRes);
-                destroyBrowseItems(currentBrowseItems, count);
-                invokeErrorCb(msg->message_id, NULL, STATUS_ERROR, "Failed to get the edge node id.");
-                return false;
-            }
+            UA_String *str = &((UA_String *) val->data)[idx];
+            result = appendSnapshotKey(key, length, (const char *) str->data, str->length);
+        }
+    }
+    else if (val->type == &UA_TYPES[UA_TYPES_DATETIME] && UA_Variant_isScalar(val))
+    {
+        char buf[32];
+        int size = snprintf(buf, sizeof(buf), "%" PRId64, *(UA_DateTime *) val->data);
+        result = appendSnapshotKey(key, length, buf, (size_t) size);
+    }
+    UA_Variant_delete(val);
+    return result;
+}
 
-            // Check the status code of result and keep track of unknown NodeId cases.
-            UA_StatusCode status = bRes.results[res_idx].statusCode;
-            if (UA_STATUSCODE_GOOD != status)
-            {
-                if (UA_STATUSCODE_BADNODEIDUNKNOWN == status)
-                    nodeIdUnknownCount++;
+/**
+ * @brief getServerModelKey - Reads what identifies the address space of the server,
+ *        its namespace array and its build information as the model version.
+ * @param client - Client handle
+ * @return Key to be freed by the caller, NULL in case of error
+ */
+static char *getServerModelKey(UA_Client *client)
+{
+    const UA_UInt32 nodes[] = {
+        UA_NS0ID_SERVER_NAMESPACEARRAY,
+        UA_NS0ID_SERVER_SERVERSTATUS_BUILDINFO_SOFTWAREVERSION,
+        UA_NS0ID_SERVER_SERVERSTATUS_BUILDINFO_BUILDNUMBER,
+        UA_NS0ID_SERVER_SERVERSTATUS_BUILDINFO_BUILDDATE
+    };
+    char *key = NULL;
+    size_t length = 0;
+    for (size_t idx = 0; idx < sizeof(nodes) / sizeof(nodes[0]); ++idx)
+    {
+        if (!appendSnapshotKeyValue(client, nodes[idx], &key, &length))
+        {
+            EdgeFree(key);
+            return NULL;
+        }
+    }
+    return key;
+}
 
-                if (nodeIdUnknownCount == bRes.resultsSize)
-                {
-                    EDGE_LOG(TAG, "Error: " STATUS_VIEW_NODEID_UNKNOWN_ALL_RESULTS_VALUE);
-                    invokeErrorCb(msg->message_id, srcNodeId, STATUS_VIEW_NODEID_UNKNOWN_ALL_RESULTS,
-                            STATUS_VIEW_NODEID_UNKNOWN_ALL_RESULTS_VALUE);
-                }
-                else
-                {
-                    const char *statusStr = UA_StatusCode_name(status);
-                    invokeErrorCb(msg->message_id, srcNodeId, STATUS_VIEW_RESULT_STATUS_CODE_BAD, statusStr);
-                }
-                freeEdgeNodeId(srcNodeId);
-                continue;
-            }
+static bool appendRequestKey(EdgeRequest *req, char **key, size_t *length)
+{
+    VERIFY_NON_NULL_MSG(req, "EdgeRequest is NULL\n", false);
+    VERIFY_NON_NULL_MSG(req->nodeInfo, "EdgeRequest NodeInfo is NULL\n", false);
+    VERIFY_NON_NULL_MSG(req->nodeInfo->nodeId, "EdgeRequest NodeId is NULL\n", false);
+    EdgeNodeId *nodeId = req->nodeInfo->nodeId;
+    char buf[64];
+    int size = snprintf(buf, sizeof(buf), "%u;%d;%d;", nodeId->nameSpace, (int) nodeId->type,
+            nodeId->integerNodeId);
+    const char *id = IS_NOT_NULL(nodeId->nodeId) ? nodeId->nodeId : "";
+    char *line = (char *) EdgeMalloc(size + strlen(id) + 1);
+    VERIFY_NON_NULL_MSG(line, "EdgeMalloc FAILED for snapshot key\n", false);
+    memcpy(line, buf, size);
+    strcpy(line + size, id);
+    bool result = appendSnapshotKey(key, length, line, strlen(line));
+    EdgeFree(line);
+    return result;
+}
 
-            // Process all the references in this browse result. Validate them. Detect & avoid cycle in browse path.
-            // Create BrowseItem for each reference, Pass it to application and Enqueue.
-            if(!handleBrowseResult(client, msg, browseQueue, currentBrowseItems[res_idx], srcNodeId,
-                    &bRes.results[res_idx], viewList))
-            {
-                EDGE_LOG(TAG, "Failed to handle the browse result.");
-                freeEdgeNodeId(srcNodeId);
-                UA_BrowseResponse_deleteMembers(&bRes);
-                destroyBrowseItems(currentBrowseItems, count);
-                invokeErrorCb(msg->message_id, srcNodeId, STATUS_ERROR, "Failed to handle the browse result.");
-                return false;
-            }
+/**
+ * @brief getBrowseRequestKey - Describes the start nodes and parameters of a browse request,
+ *        a snapshot only answers a request with the same key.
+ * @param msg - Browse request message
+ * @return Key to be freed by the caller, NULL in case of error
+ */
+static char *getBrowseRequestKey(EdgeMessage *msg)
+{
+    char buf[96];
+    EdgeBrowseParameter param;
+    memset(&param, 0, sizeof(EdgeBrowseParameter));
+    param.direction = (EdgeBrowseDirection) -1;
+    if (IS_NOT_NULL(msg->browseParam))
+    {
+        param = *msg->browseParam;
+    }
+    int size = snprintf(buf, sizeof(buf), "%d;%d;%d;%" PRIu32 ";%" PRIu32 ";%" PRIu32,
+            (int) msg->command, (int) param.direction, param.maxReferencesPerNode, param.maxDepth,
+            param.nodeClassMask, param.referenceTypeId);
+    char *key = NULL;
+    size_t length = 0;
+    bool result = appendSnapshotKey(&key, &length, buf, (size_t) size);
+    if (SEND_REQUEST == msg->type)
+    {
+        result = result && appendRequestKey(msg->request, &key, &length);
+    }
+    else
+    {
+        for (size_t idx = 0; idx < msg->requestLength && result; ++idx)
+        {
+            result = appendRequestKey(msg->requests[idx], &key, &length);
+        }
+    }
+    if (!result)
+    {
+        EdgeFree(key);
+        key = NULL;
+    }
+    return key;
+}
+
+/**
+ * @brief startBrowseSnapshot - Replays the snapshot of the endpoint if it was saved for the same
+ *        server model and request. Otherwise a snapshot starts recording the browse of msg.
+ * @param client - Client handle
+ * @param msg - Browse request message
+ * @return true if the snapshot answered the request
+ */
+static bool startBrowseSnapshot(UA_Client *client, EdgeMessage *msg)
+{
+    COND_CHECK(IS_NULL(msg->endpointInfo) || IS_NULL(msg->endpointInfo->endpointUri), false);
+    COND_CHECK(!hasBrowseSnapshotPath(msg->endpointInfo->endpointUri), false);
 
-            // Handle continution point.
-            // If there is a continuation point in this browse result, call BrowseNext.
-            if(bRes.results[res_idx].continuationPoint.length > 0)
+    char *serverKey = getServerModelKey(client);
+    char *requestKey = getBrowseRequestKey(msg);
+    BrowseSnapshot *snapshot = NULL;
+    if (IS_NOT_NULL(serverKey) && IS_NOT_NULL(requestKey))
+    {
+        snapshot = openBrowseSnapshot(msg->endpointInfo->endpointUri, serverKey, requestKey);
+    }
+    EdgeFree(serverKey);
+    EdgeFree(requestKey);
+    COND_CHECK(IS_NULL(snapshot), false);
+
+    if (isBrowseSnapshotLoaded(snapshot))
+    {
+        uint32_t size = getBrowseSnapshotSize(snapshot);
+        size_t maxResults = IS_NOT_NULL(msg->browseParam) ? msg->browseParam->maxResults : 0;
+        if (maxResults > 0 && maxResults < size)
+        {
+            size = (uint32_t) maxResults;
+        }
+        for (uint32_t idx = 0; idx < size; ++idx)
+        {
+            BrowseSnapshotReference reference;
+            COND_CHECK_MSG(!getBrowseSnapshotReference(snapshot, idx, &reference),
+                    "Failed to read a browse snapshot entry.", true);
+            EdgeBrowseResult browseResult;
+            browseResult.browseName = (char *) reference.browseName;
+            if (!invokeResponseCb(msg, reference.requestId, &reference.srcNodeId, &browseResult, 1,
+                    reference.browsePath, (char *) reference.valueAlias))
             {
-                // Perform BrowseNext to get next set of pending references.
-                // Only one continuation point will be passed per BrowseNext call. So there will be only one result per call.
-                // Handle the BrowseNext result - Iterate over all the references, validate them,
-                // pass them to app, enqueue them. If the result still has continuation point, call BrowseNext and perform
-                // the same operations. Continue till there is no continuation point.
-                if(!browseNextNodes(client, msg, browseQueue, currentBrowseItems[res_idx],
-                        srcNodeId, &(bRes.results[res_idx].continuationPoint), viewList))
-                {
-                    EDGE_LOG(TAG, "Failed to perform BrowseNext.\n");
-                    freeEdgeNodeId(srcNodeId);
-                    UA_BrowseResponse_deleteMembers(&bRes);
-                    destroyBrowseItems(currentBrowseItems, count);
-                    return false;
-                }
+                break;
             }
-
-            // Destroy items which are created in this loop.
-            freeEdgeNodeId(srcNodeId);
         }
+        closeBrowseSnapshot(snapshot);
+        return true;
+    }
 
-        // Destroy items which are created in this loop.
-        destroyBrowseItems(currentBrowseItems, count);
-        UA_BrowseResponse_deleteMembers(&bRes);
+    pthread_mutex_lock(&g_snapshotRecorderMutex);
+    if (IS_NULL(g_snapshotRecorders))
+    {
+        g_snapshotRecorders = createEdgeHashMap(EDGE_HASH_POINTER_KEY);
     }
-    return true;
+    if (IS_NULL(g_snapshotRecorders) || !insertEdgeHashMapElement(g_snapshotRecorders, msg, snapshot))
+    {
+        EDGE_LOG(TAG, "Failed to record the browse snapshot.");
+        closeBrowseSnapshot(snapshot);
+    }
+    pthread_mutex_unlock(&g_snapshotRecorderMutex);
+    return false;
 }
 
-void browseNodes(UA_Client *client, EdgeMessage *msg)
+/**
+ * @brief finishBrowseSnapshot - Saves the snapshot which recorded the browse of msg
+ *        if the browse succeeded, otherwise the file is left as it is.
+ */
+static void finishBrowseSnapshot(EdgeMessage *msg, bool success)
+{
+    pthread_mutex_lock(&g_snapshotRecorderMutex);
+    BrowseSnapshot *snapshot = (BrowseSnapshot *) removeEdgeHashMapElement(g_snapshotRecorders,
+            msg, NULL);
+    if (IS_NOT_NULL(g_snapshotRecorders) && 0 == getEdgeHashMapSize(g_snapshotRecorders))
+    {
+        deleteEdgeHashMap(g_snapshotRecorders);
+        g_snapshotRecorders = NULL;
+    }
+    pthread_mutex_unlock(&g_snapshotRecorderMutex);
+    COND_CHECK_NR_MSG(IS_NULL(snapshot), "");
+
+    if (success && saveBrowseSnapshot(snapshot))
+    {
+        EDGE_LOG_V(TAG, "Saved %u browse responses to the snapshot\n", getBrowseSnapshotSize(snapshot));
+    }
+    closeBrowseSnapshot(snapshot);
+}
+
+/**
+ * @brief browseAllNodes - Browses the start nodes of msg and the nodes below them
+ * @param client - Client handle
+ * @param msg - Browse request message
+ * @param stopped - Set to true if the browse stopped before all nodes were browsed
+ * @return false in case of error
+ */
+static bool browseAllNodes(UA_Client *client, EdgeMessage *msg, bool *stopped)
 {
     // Initialize a queue.
     u_queue_t *browseQueue = u_queue_create();
@@ -1300,21 +2095,35 @@ void browseNodes(UA_Client *client, EdgeMessage *msg)
     {
         EDGE_LOG(TAG, "Failed to initialize queue.");
         invokeErrorCb(msg->message_id, NULL, STATUS_ERROR, "Failed to initialize queue.");
-        return;
+        return false;
+    }
+
+    BrowseContext context;
+    memset(&context, 0, sizeof(BrowseContext));
+    context.visited = createEdgeHashMap(EDGE_HASH_STRING_KEY);
+    if (IS_NULL(context.visited))
+    {
+        EDGE_LOG(TAG, "Failed to create the visited set.");
+        destroyBrowseQueue(&browseQueue);
+        invokeErrorCb(msg->message_id, NULL, STATUS_ERROR, "Failed to create the visited set.");
+        return false;
     }
 
     // Iterate over the given requests, create a BrowseItem for each one of them and enqueue.
-    if(!parseBrowseNodesFromRequest(msg, browseQueue))
+    if(!parseBrowseNodesFromRequest(msg, browseQueue, context.visited))
     {
         EDGE_LOG(TAG, "Failed to parse the browse request.");
+        destroyVisitedNodes(&context.visited);
         destroyBrowseQueue(&browseQueue);
         invokeErrorCb(msg->message_id, NULL, STATUS_ERROR, "Failed to parse the browse request.");
-        return;
+        return false;
     }
 
     // Read server's capability and find out the maximum nodes
     // which can be browsed through a single browse request.
-    uint16_t maxNodesToBrowse = getMaxNodesToBrowse(client);
+    uint16_t maxContinuationPoints = 1;
+    uint16_t maxNodesToBrowse = getMaxNodesToBrowse(client, &maxContinuationPoints);
+    uint32_t maxInFlight = getMaxBrowseInFlight(maxNodesToBrowse, maxContinuationPoints);
 
     // List to hold all view nodes (BrowseItem). Only for CMD_BROWSE_VIEW requests.
     List *viewList = NULL;
@@ -1325,34 +2134,45 @@ void browseNodes(UA_Client *client, EdgeMessage *msg)
     if(IS_NULL(currentBrowseItems))
     {
         EDGE_LOG(TAG, "Failed to allocate memory for browse request.");
+        destroyVisitedNodes(&context.visited);
         destroyBrowseQueue(&browseQueue);
         invokeErrorCb(msg->message_id, NULL, STATUS_ERROR, "Failed to allocate memory for browse request.");
-        return;
+        return false;
     }
 
-    if(!browseNodesHelper(client, msg, browseQueue, maxNodesToBrowse, currentBrowseItems, &viewList))
+    if(!browseNodesHelper(client, msg, browseQueue, maxNodesToBrowse, maxInFlight,
+            currentBrowseItems, &context, &viewList))
     {
         destroyViewList(&viewList);
+        destroyVisitedNodes(&context.visited);
         EdgeFree(currentBrowseItems);
         destroyBrowseQueue(&browseQueue);
-        return;
+        return false;
     }
 
     if (CMD_BROWSE_VIEW == msg->command)
     {
+        // The nodes of the views are browsed afresh.
+        destroyVisitedNodes(&context.visited);
+        context.visited = createEdgeHashMap(EDGE_HASH_STRING_KEY);
+
         // Iterate over the viewList and enqueue all BrowseItems.
         List *viewPtr = viewList;
         while(viewPtr)
         {
             BrowseItem *item = viewPtr->data;
-            if(!enqueueBrowseItem(browseQueue, item))
+            bool firstVisit;
+            item->depth = 0;
+            if(IS_NULL(context.visited) || !visitNode(context.visited, item->nodeId, &firstVisit) ||
+                !enqueueBrowseItem(browseQueue, item))
             {
                 EDGE_LOG(TAG, "Failed to enqueue a BrowseItem.");
                 destroyViewList(&viewList);
+                destroyVisitedNodes(&context.visited);
                 EdgeFree(currentBrowseItems);
                 destroyBrowseQueue(&browseQueue);
                 invokeErrorCb(msg->message_id, NULL, STATUS_ERROR, "Failed to enqueue a BrowseItem.");
-                return;
+                return false;
             }
             viewPtr->data = NULL;
             viewPtr = viewPtr->link;
@@ -1362,17 +2182,34 @@ void browseNodes(UA_Client *client, EdgeMessage *msg)
         msg->command = CMD_BROWSE;
 
         // Start processing the view nodes. Perform general browse for all the nodes.
-        if(!browseNodesHelper(client, msg, browseQueue, maxNodesToBrowse, currentBrowseItems, &viewList))
+        if(!browseNodesHelper(client, msg, browseQueue, maxNodesToBrowse, maxInFlight,
+                currentBrowseItems, &context, &viewList))
         {
             destroyViewList(&viewList);
+            destroyVisitedNodes(&context.visited);
             EdgeFree(currentBrowseItems);
             destroyBrowseQueue(&browseQueue);
-            return;
+            return false;
         }
     }
 
     // Destroy items which are created in this function.
+    *stopped = context.stopped;
     destroyViewList(&viewList);
+    destroyVisitedNodes(&context.visited);
     EdgeFree(currentBrowseItems);
     destroyBrowseQueue(&browseQueue);
+    return true;
+}
+
+void browseNodes(UA_Client *client, EdgeMessage *msg)
+{
+    if (startBrowseSnapshot(client, msg))
+    {
+        return;
+    }
+    // A stopped browse misses results, so it is not saved.
+    bool stopped = false;
+    bool success = browseAllNodes(client, msg, &stopped);
+    finishBrowseSnapshot(msg, success && !stopped);
 }
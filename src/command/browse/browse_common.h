@@ -39,6 +39,11 @@ extern "C"
 {
 #endif
 
+/**< Browse requests of one browse operation which may be outstanding with ENABLE_ASYNC_SERVICES */
+#ifndef EDGE_BROWSE_MAX_IN_FLIGHT
+#define EDGE_BROWSE_MAX_IN_FLIGHT (4)
+#endif
+
 typedef struct ViewNodeInfo
 {
     UA_NodeId *nodeId;
@@ -51,14 +56,6 @@ typedef struct ViewNodeInfo
  */
 void setErrorResponseCallback(response_cb_t callback);
 
-/**
- * @brief Based on server's capabilities, finds the maximum nodes a client can browse per request.
- * @remarks Performs synchronous read to get the server's capabilities.
- * @param[in]  client Client Handle.
- * @return Value indicating the maximum nodes a client can browse per request on success.
- */
-//uint16_t getMaxNodesToBrowse(UA_Client *client);
-
 /**
  * @brief Performs Browse, BrowseNext & BrowseView operations and
  * passes the results to the application through callback.
@@ -0,0 +1,472 @@
+/******************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ *
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************/
+
+#include "browse_snapshot.h"
+#include "edge_hash_map.h"
+#include "edge_utils.h"
+#include "edge_logger.h"
+#include "edge_malloc.h"
+
+#include <stdio.h>
+#include <string.h>
+#ifndef _WIN32
+#include <pthread.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#else
+#include "pthread.h"
+#endif
+
+#define TAG "browse_snapshot"
+
+#define SNAPSHOT_MAGIC "EDGESNAP"
+#define SNAPSHOT_MAGIC_SIZE (8)
+#define SNAPSHOT_NO_STRING UINT32_MAX
+#define SNAPSHOT_INITIAL_CAPACITY (256)
+
+/* File layout: header, referenceCount entries, then stringsSize bytes of NUL-terminated strings.
+ * Strings are referenced by their offset, so a mapped file is used in place. */
+typedef struct SnapshotHeader
+{
+    char magic[SNAPSHOT_MAGIC_SIZE];
+    uint32_t version;
+    uint32_t referenceCount;
+    uint32_t stringsSize;
+    uint32_t serverKey;
+    uint32_t requestKey;
+    uint32_t reserved;
+} SnapshotHeader;
+
+typedef struct SnapshotEntry
+{
+    uint32_t requestId;
+    int32_t integerNodeId;
+    uint16_t nameSpace;
+    uint16_t type;
+    uint32_t nodeId;
+    uint32_t browseName;
+    uint32_t browsePath;
+    uint32_t valueAlias;
+} SnapshotEntry;
+
+struct BrowseSnapshot
+{
+    char *path;
+    bool loaded;
+
+    /**< Entries and strings, in the file when loaded, otherwise recorded **/
+    SnapshotEntry *entries;
+    uint32_t count;
+    uint32_t capacity;
+    char *strings;
+    uint32_t stringsSize;
+    uint32_t stringsCapacity;
+
+    uint32_t serverKey;
+    uint32_t requestKey;
+
+    /**< Offset of the last source node id, consecutive references share it **/
+    uint32_t lastNodeId;
+
+    /**< File contents of a loaded snapshot **/
+    void *data;
+    size_t dataSize;
+};
+
+/* Endpoint URI -> snapshot path, both owned by the map */
+static EdgeHashMap *g_snapshotPaths = NULL;
+static pthread_mutex_t g_snapshotMutex = PTHREAD_MUTEX_INITIALIZER;
+
+bool setBrowseSnapshotPath(const char *endpointUri, const char *path)
+{
+    VERIFY_NON_NULL_MSG(endpointUri, "NULL endpointUri in setBrowseSnapshotPath\n", false);
+    bool result = true;
+    pthread_mutex_lock(&g_snapshotMutex);
+    keyValue storedKey = NULL;
+    char *oldPath = (char *) removeEdgeHashMapElement(g_snapshotPaths, (keyValue) endpointUri,
+            &storedKey);
+    EdgeFree(oldPath);
+    EdgeFree(storedKey);
+
+    if (IS_NOT_NULL(path))
+    {
+        if (IS_NULL(g_snapshotPaths))
+        {
+            g_snapshotPaths = createEdgeHashMap(EDGE_HASH_STRING_KEY);
+        }
+        char *key = cloneString(endpointUri);
+        char *value = cloneString(path);
+        if (IS_NULL(g_snapshotPaths) || IS_NULL(key) || IS_NULL(value)
+                || !insertEdgeHashMapElement(g_snapshotPaths, key, value))
+        {
+            EDGE_LOG(TAG, "Memory allocation failed.");
+            EdgeFree(key);
+            EdgeFree(value);
+            result = false;
+        }
+    }
+
+    if (IS_NOT_NULL(g_snapshotPaths) && 0 == getEdgeHashMapSize(g_snapshotPaths))
+    {
+        deleteEdgeHashMap(g_snapshotPaths);
+        g_snapshotPaths = NULL;
+    }
+    pthread_mutex_unlock(&g_snapshotMutex);
+    return result;
+}
+
+bool hasBrowseSnapshotPath(const char *endpointUri)
+{
+    VERIFY_NON_NULL_MSG(endpointUri, "NULL endpointUri in hasBrowseSnapshotPath\n", false);
+    pthread_mutex_lock(&g_snapshotMutex);
+    bool result = IS_NOT_NULL(getEdgeHashMapElement(g_snapshotPaths, (keyValue) endpointUri));
+    pthread_mutex_unlock(&g_snapshotMutex);
+    return result;
+}
+
+static char *getBrowseSnapshotPath(const char *endpointUri)
+{
+    pthread_mutex_lock(&g_snapshotMutex);
+    const char *path = (const char *) getEdgeHashMapElement(g_snapshotPaths, (keyValue) endpointUri);
+    char *copy = IS_NOT_NULL(path) ? cloneString(path) : NULL;
+    pthread_mutex_unlock(&g_snapshotMutex);
+    return copy;
+}
+
+/**
+ * @brief readSnapshotFile - Maps the snapshot file, or reads it where it cannot be mapped
+ * @param snapshot - Snapshot whose data and dataSize are set
+ * @return true if the file has been read
+ */
+static bool readSnapshotFile(BrowseSnapshot *snapshot)
+{
+#ifndef _WIN32
+    int fd = open(snapshot->path, O_RDONLY);
+    COND_CHECK(fd < 0, false);
+    struct stat st;
+    if (0 != fstat(fd, &st) || st.st_size < (off_t) sizeof(SnapshotHeader))
+    {
+        close(fd);
+        return false;
+    }
+    void *data = mmap(NULL, (size_t) st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    COND_CHECK(MAP_FAILED == data, false);
+    snapshot->data = data;
+    snapshot->dataSize = (size_t) st.st_size;
+    return true;
+#else
+    FILE *file = fopen(snapshot->path, "rb");
+    COND_CHECK(IS_NULL(file), false);
+    bool result = false;
+    long size = 0;
+    if (0 == fseek(file, 0, SEEK_END) && (size = ftell(file)) >= (long) sizeof(SnapshotHeader)
+            && 0 == fseek(file, 0, SEEK_SET))
+    {
+        snapshot->data = EdgeMalloc((size_t) size);
+        if (IS_NOT_NULL(snapshot->data) && 1 == fread(snapshot->data, (size_t) size, 1, file))
+        {
+            snapshot->dataSize = (size_t) size;
+            result = true;
+        }
+        else
+        {
+            EdgeFree(snapshot->data);
+            snapshot->data = NULL;
+        }
+    }
+    fclose(file);
+    return result;
+#endif
+}
+
+static void releaseSnapshotFile(BrowseSnapshot *snapshot)
+{
+    COND_CHECK_NR_MSG(IS_NULL(snapshot->data), "");
+#ifndef _WIN32
+    munmap(snapshot->data, snapshot->dataSize);
+#else
+    EdgeFree(snapshot->data);
+#endif
+    snapshot->data = NULL;
+    snapshot->dataSize = 0;
+}
+
+static const char *getSnapshotString(const BrowseSnapshot *snapshot, uint32_t offset)
+{
+    COND_CHECK(offset >= snapshot->stringsSize, NULL);
+    return snapshot->strings + offset;
+}
+
+/**
+ * @brief loadSnapshotFile - Uses the snapshot file if it is intact and was saved with the same keys
+ * @return true if the snapshot was loaded
+ */
+static bool loadSnapshotFile(BrowseSnapshot *snapshot, const char *serverKey, const char *requestKey)
+{
+    COND_CHECK(!readSnapshotFile(snapshot), false);
+
+    const SnapshotHeader *header = (const SnapshotHeader *) snapshot->data;
+    uint64_t expectedSize = sizeof(SnapshotHeader)
+            + (uint64_t) header->referenceCount * sizeof(SnapshotEntry) + header->stringsSize;
+    if (0 != memcmp(header->magic, SNAPSHOT_MAGIC, SNAPSHOT_MAGIC_SIZE)
+            || EDGE_BROWSE_SNAPSHOT_VERSION != header->version
+            || expectedSize != snapshot->dataSize || 0 == header->stringsSize)
+    {
+        EDGE_LOG_V(TAG, "%s is not a valid browse snapshot\n", snapshot->path);
+        releaseSnapshotFile(snapshot);
+        return false;
+    }
+
+    snapshot->entries = (SnapshotEntry *) ((char *) snapshot->data + sizeof(SnapshotHeader));
+    snapshot->count = header->referenceCount;
+    snapshot->strings = (char *) (snapshot->entries + header->referenceCount);
+    snapshot->stringsSize = header->stringsSize;
+
+    /* A NUL at the end keeps every string offset inside the table */
+    const char *server = getSnapshotString(snapshot, header->serverKey);
+    const char *request = getSnapshotString(snapshot, header->requestKey);
+    if ('\0' != snapshot->strings[snapshot->stringsSize - 1] || IS_NULL(server) || IS_NULL(request)
+            || 0 != strcmp(server, serverKey) || 0 != strcmp(request, requestKey))
+    {
+        EDGE_LOG_V(TAG, "%s was saved for another server model or request\n", snapshot->path);
+        snapshot->entries = NULL;
+        snapshot->count = 0;
+        snapshot->strings = NULL;
+        snapshot->stringsSize = 0;
+        releaseSnapshotFile(snapshot);
+        return false;
+    }
+    return true;
+}
+
+static uint32_t addSnapshotString(BrowseSnapshot *snapshot, const char *str)
+{
+    COND_CHECK(IS_NULL(str), SNAPSHOT_NO_STRING);
+    size_t length = strlen(str) + 1;
+    COND_CHECK(length >= SNAPSHOT_NO_STRING - snapshot->stringsSize, SNAPSHOT_NO_STRING);
+    if (snapshot->stringsSize + length > snapshot->stringsCapacity)
+    {
+        uint32_t capacity = snapshot->stringsCapacity ? snapshot->stringsCapacity : SNAPSHOT_INITIAL_CAPACITY;
+        while (capacity < snapshot->stringsSize + length && capacity < SNAPSHOT_NO_STRING / 2)
+        {
+            capacity *= 2;
+        }
+        COND_CHECK(capacity < snapshot->stringsSize + length, SNAPSHOT_NO_STRING);
+        char *strings = (char *) EdgeRealloc(snapshot->strings, capacity);
+        VERIFY_NON_NULL_MSG(strings, "EdgeRealloc FAILED for snapshot strings\n", SNAPSHOT_NO_STRING);
+        snapshot->strings = strings;
+        snapshot->stringsCapacity = capacity;
+    }
+    uint32_t offset = snapshot->stringsSize;
+    memcpy(snapshot->strings + offset, str, length);
+    snapshot->stringsSize += (uint32_t) length;
+    return offset;
+}
+
+BrowseSnapshot *openBrowseSnapshot(const char *endpointUri, const char *serverKey,
+        const char *requestKey)
+{
+    VERIFY_NON_NULL_MSG(endpointUri, "NULL endpointUri in openBrowseSnapshot\n", NULL);
+    VERIFY_NON_NULL_MSG(serverKey, "NULL serverKey in openBrowseSnapshot\n", NULL);
+    VERIFY_NON_NULL_MSG(requestKey, "NULL requestKey in openBrowseSnapshot\n", NULL);
+    char *path = getBrowseSnapshotPath(endpointUri);
+    COND_CHECK(IS_NULL(path), NULL);
+
+    BrowseSnapshot *snapshot = (BrowseSnapshot *) EdgeCalloc(1, sizeof(BrowseSnapshot));
+    if (IS_NULL(snapshot))
+    {
+        EDGE_LOG(TAG, "Memory allocation failed.");
+        EdgeFree(path);
+        return NULL;
+    }
+    snapshot->path = path;
+    snapshot->lastNodeId = SNAPSHOT_NO_STRING;
+
+    if (loadSnapshotFile(snapshot, serverKey, requestKey))
+    {
+        snapshot->loaded = true;
+        EDGE_LOG_V(TAG, "Loaded %u browse responses from %s\n", snapshot->count, path);
+        return snapshot;
+    }
+
+    snapshot->serverKey = addSnapshotString(snapshot, serverKey);
+    snapshot->requestKey = addSnapshotString(snapshot, requestKey);
+    if (SNAPSHOT_NO_STRING == snapshot->serverKey || SNAPSHOT_NO_STRING == snapshot->requestKey)
+    {
+        EDGE_LOG(TAG, "Memory allocation failed.");
+        closeBrowseSnapshot(snapshot);
+        return NULL;
+    }
+    return snapshot;
+}
+
+bool isBrowseSnapshotLoaded(const BrowseSnapshot *snapshot)
+{
+    VERIFY_NON_NULL_MSG(snapshot, "NULL snapshot in isBrowseSnapshotLoaded\n", false);
+    return snapshot->loaded;
+}
+
+uint32_t getBrowseSnapshotSize(const BrowseSnapshot *snapshot)
+{
+    VERIFY_NON_NULL_MSG(snapshot, "NULL snapshot in getBrowseSnapshotSize\n", 0);
+    return snapshot->count;
+}
+
+bool getBrowseSnapshotReference(const BrowseSnapshot *snapshot, uint32_t index,
+        BrowseSnapshotReference *reference)
+{
+    VERIFY_NON_NULL_MSG(snapshot, "NULL snapshot in getBrowseSnapshotReference\n", false);
+    VERIFY_NON_NULL_MSG(reference, "NULL reference in getBrowseSnapshotReference\n", false);
+    COND_CHECK(index >= snapshot->count, false);
+
+    const SnapshotEntry *entry = &snapshot->entries[index];
+    memset(reference, 0, sizeof(BrowseSnapshotReference));
+    reference->requestId = entry->requestId;
+    reference->srcNodeId.nameSpace = entry->nameSpace;
+    reference->srcNodeId.type = (EdgeNodeIdType) entry->type;
+    reference->srcNodeId.integerNodeId = entry->integerNodeId;
+    reference->srcNodeId.nodeId = (char *) getSnapshotString(snapshot, entry->nodeId);
+    reference->browseName = getSnapshotString(snapshot, entry->browseName);
+    reference->browsePath = (const unsigned char *) getSnapshotString(snapshot, entry->browsePath);
+    reference->valueAlias = getSnapshotString(snapshot, entry->valueAlias);
+
+    /* Only optional strings may be missing */
+    COND_CHECK_MSG(IS_NULL(reference->browseName), "Browse snapshot entry is corrupt\n", false);
+    return true;
+}
+
+bool addBrowseSnapshotReference(BrowseSnapshot *snapshot, const BrowseSnapshotReference *reference)
+{
+    VERIFY_NON_NULL_MSG(snapshot, "NULL snapshot in addBrowseSnapshotReference\n", false);
+    VERIFY_NON_NULL_MSG(reference, "NULL reference in addBrowseSnapshotReference\n", false);
+    VERIFY_NON_NULL_MSG(reference->browseName, "NULL browseName in addBrowseSnapshotReference\n", false);
+    COND_CHECK(snapshot->loaded, false);
+
+    if (snapshot->count == snapshot->capacity)
+    {
+        uint32_t capacity = snapshot->capacity ? snapshot->capacity * 2 : SNAPSHOT_INITIAL_CAPACITY;
+        SnapshotEntry *entries = (SnapshotEntry *) EdgeRealloc(snapshot->entries,
+                capacity * sizeof(SnapshotEntry));
+        VERIFY_NON_NULL_MSG(entries, "EdgeRealloc FAILED for snapshot entries\n", false);
+        snapshot->entries = entries;
+        snapshot->capacity = capacity;
+    }
+
+    SnapshotEntry entry;
+    memset(&entry, 0, sizeof(SnapshotEntry));
+    entry.requestId = reference->requestId;
+    entry.integerNodeId = reference->srcNodeId.integerNodeId;
+    entry.nameSpace = reference->srcNodeId.nameSpace;
+    entry.type = (uint16_t) reference->srcNodeId.type;
+
+    /* References of one node are browsed one after another */
+    const char *lastNodeId = getSnapshotString(snapshot, snapshot->lastNodeId);
+    if (IS_NOT_NULL(lastNodeId) && IS_NOT_NULL(reference->srcNodeId.nodeId)
+            && 0 == strcmp(lastNodeId, reference->srcNodeId.nodeId))
+    {
+        entry.nodeId = snapshot->lastNodeId;
+    }
+    else
+    {
+        entry.nodeId = addSnapshotString(snapshot, reference->srcNodeId.nodeId);
+        snapshot->lastNodeId = entry.nodeId;
+    }
+    entry.browseName = addSnapshotString(snapshot, reference->browseName);
+    entry.browsePath = addSnapshotString(snapshot, (const char *) reference->browsePath);
+    entry.valueAlias = addSnapshotString(snapshot, reference->valueAlias);
+    if (SNAPSHOT_NO_STRING == entry.browseName
+            || (IS_NOT_NULL(reference->srcNodeId.nodeId) && SNAPSHOT_NO_STRING == entry.nodeId)
+            || (IS_NOT_NULL(reference->browsePath) && SNAPSHOT_NO_STRING == entry.browsePath)
+            || (IS_NOT_NULL(reference->valueAlias) && SNAPSHOT_NO_STRING == entry.valueAlias))
+    {
+        EDGE_LOG(TAG, "Memory allocation failed.");
+        return false;
+    }
+
+    snapshot->entries[snapshot->count++] = entry;
+    return true;
+}
+
+bool saveBrowseSnapshot(BrowseSnapshot *snapshot)
+{
+    VERIFY_NON_NULL_MSG(snapshot, "NULL snapshot in saveBrowseSnapshot\n", false);
+    COND_CHECK(snapshot->loaded, true);
+
+    size_t pathLength = strlen(snapshot->path);
+    char *tmpPath = (char *) EdgeMalloc(pathLength + sizeof(".tmp"));
+    VERIFY_NON_NULL_MSG(tmpPath, "EdgeMalloc FAILED for snapshot path\n", false);
+    memcpy(tmpPath, snapshot->path, pathLength);
+    memcpy(tmpPath + pathLength, ".tmp", sizeof(".tmp"));
+
+    SnapshotHeader header;
+    memset(&header, 0, sizeof(SnapshotHeader));
+    memcpy(header.magic, SNAPSHOT_MAGIC, SNAPSHOT_MAGIC_SIZE);
+    header.version = EDGE_BROWSE_SNAPSHOT_VERSION;
+    header.referenceCount = snapshot->count;
+    header.stringsSize = snapshot->stringsSize;
+    header.serverKey = snapshot->serverKey;
+    header.requestKey = snapshot->requestKey;
+
+    bool result = false;
+    FILE *file = fopen(tmpPath, "wb");
+    if (IS_NOT_NULL(file))
+    {
+        result = (1 == fwrite(&header, sizeof(SnapshotHeader), 1, file))
+                && (0 == snapshot->count
+                        || snapshot->count == fwrite(snapshot->entries, sizeof(SnapshotEntry), snapshot->count, file))
+                && (1 == fwrite(snapshot->strings, snapshot->stringsSize, 1, file));
+        result = (0 == fclose(file)) && result;
+    }
+
+#ifdef _WIN32
+    /* rename() does not replace an existing file */
+    remove(snapshot->path);
+#endif
+    if (result && 0 != rename(tmpPath, snapshot->path))
+    {
+        result = false;
+    }
+    if (!result)
+    {
+        EDGE_LOG_V(TAG, "Failed to save the browse snapshot %s\n", snapshot->path);
+        remove(tmpPath);
+    }
+    EdgeFree(tmpPath);
+    return result;
+}
+
+void closeBrowseSnapshot(BrowseSnapshot *snapshot)
+{
+    COND_CHECK_NR_MSG(IS_NULL(snapshot), "");
+    if (snapshot->loaded)
+    {
+        releaseSnapshotFile(snapshot);
+    }
+    else
+    {
+        EdgeFree(snapshot->entries);
+        EdgeFree(snapshot->strings);
+    }
+    EdgeFree(snapshot->path);
+    EdgeFree(snapshot);
+}
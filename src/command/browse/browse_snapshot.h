@@ -0,0 +1,144 @@
+/******************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ *
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************/
+
+/**
+ * @file browse_snapshot.h
+ *
+ * @brief This file contains the APIs of the address space snapshots, which keep the results of
+ *        a browse in a file so that the next browse of an unchanged server replays them.
+ */
+
+#ifndef EDGE_BROWSE_SNAPSHOT_H
+#define EDGE_BROWSE_SNAPSHOT_H
+
+#include "opcua_common.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/**< Version of the snapshot file format, files of other versions are browsed again */
+#define EDGE_BROWSE_SNAPSHOT_VERSION (1)
+
+/**
+ * @brief One browse response of a snapshot. The strings of a loaded snapshot point into
+ *        its file and are valid until closeBrowseSnapshot().
+ */
+typedef struct BrowseSnapshotReference
+{
+    /**< requestId of the browse response */
+    uint32_t requestId;
+
+    /**< Node whose reference was browsed, only nameSpace, type, nodeId and integerNodeId are used */
+    EdgeNodeId srcNodeId;
+
+    /**< Browse name of the reference */
+    const char *browseName;
+
+    /**< Complete browse path of the reference, can be NULL */
+    const unsigned char *browsePath;
+
+    /**< Value alias of the reference, can be NULL */
+    const char *valueAlias;
+} BrowseSnapshotReference;
+
+typedef struct BrowseSnapshot BrowseSnapshot;
+
+/**
+ * @brief Sets the snapshot file of the browse requests of an endpoint.
+ * @param[in]  endpointUri Endpoint of the server.
+ * @param[in]  path Snapshot file, NULL to browse the endpoint without a snapshot again.
+ * @return @c true on success, @c false if memory is insufficient
+ */
+bool setBrowseSnapshotPath(const char *endpointUri, const char *path);
+
+/**
+ * @brief Checks whether the browse requests of an endpoint use a snapshot file.
+ * @param[in]  endpointUri Endpoint of the server.
+ * @return @c true if setBrowseSnapshotPath() set a file for the endpoint
+ */
+bool hasBrowseSnapshotPath(const char *endpointUri);
+
+/**
+ * @brief Opens the snapshot of an endpoint. If its file was saved with the same keys it is
+ *        loaded, otherwise an empty snapshot records the browse for saveBrowseSnapshot().
+ * @param[in]  endpointUri Endpoint of the server.
+ * @param[in]  serverKey Namespace array and model version of the server.
+ * @param[in]  requestKey Start nodes and parameters of the browse request.
+ * @return Snapshot, NULL if the endpoint has no snapshot file or memory is insufficient.
+ */
+BrowseSnapshot *openBrowseSnapshot(const char *endpointUri, const char *serverKey,
+        const char *requestKey);
+
+/**
+ * @brief Checks whether a snapshot was loaded from its file.
+ * @param[in]  snapshot Snapshot from openBrowseSnapshot().
+ * @return @c true if it was loaded, @c false if it records a browse
+ */
+bool isBrowseSnapshotLoaded(const BrowseSnapshot *snapshot);
+
+/**
+ * @brief Gets the number of browse responses of a snapshot.
+ * @param[in]  snapshot Snapshot from openBrowseSnapshot().
+ * @return Number of references
+ */
+uint32_t getBrowseSnapshotSize(const BrowseSnapshot *snapshot);
+
+/**
+ * @brief Gets a browse response of a loaded snapshot.
+ * @param[in]  snapshot Snapshot from openBrowseSnapshot().
+ * @param[in]  index Index of the response, less than getBrowseSnapshotSize().
+ * @param[out] reference Browse response.
+ * @return @c true on success, @c false if the index is invalid or the file is corrupt
+ */
+bool getBrowseSnapshotReference(const BrowseSnapshot *snapshot, uint32_t index,
+        BrowseSnapshotReference *reference);
+
+/**
+ * @brief Records a browse response in a snapshot which was not loaded.
+ * @param[in]  snapshot Snapshot from openBrowseSnapshot().
+ * @param[in]  reference Browse response, it is copied.
+ * @return @c true on success, @c false if memory is insufficient
+ */
+bool addBrowseSnapshotReference(BrowseSnapshot *snapshot, const BrowseSnapshotReference *reference);
+
+/**
+ * @brief Writes the recorded browse responses to the snapshot file.
+ *        The file is replaced only when it has been written completely.
+ * @param[in]  snapshot Snapshot from openBrowseSnapshot().
+ * @return @c true on success
+ */
+bool saveBrowseSnapshot(BrowseSnapshot *snapshot);
+
+/**
+ * @brief Closes a snapshot and deallocates it.
+ * @param[in]  snapshot Snapshot from openBrowseSnapshot(), can be NULL.
+ */
+void closeBrowseSnapshot(BrowseSnapshot *snapshot);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // EDGE_BROWSE_SNAPSHOT_H
@@ -24,29 +24,29 @@
 #include "edge_open62541.h"
 #include "message_dispatcher.h"
 
+#include <stdio.h>
+
 #define TAG "cmd_util"
-#define ERROR_DESC_LENGTH (100)
+
+/* Set by configure() before any client is connected */
+static size_t zeroCopyArrayBytes = 0;
 
 int get_response_type(const UA_DataType *datatype)
 {
-    int max = 20; // UA_TYPES_LOCALIZEDTEXT
-    for (int i = 0; i <= max; i++)
-    {
-        COND_CHECK((datatype == &UA_TYPES[i]), i+1);
-    }
-    return -1;
+    int index = getEdgeTypeIndex(datatype);
+    return (index < 0) ? -1 : index + 1;
 }
 
 void sendErrorResponse(const EdgeMessage *msg, char *err_desc)
 {
-    EdgeMessage *resultMsg = (EdgeMessage *) EdgeCalloc(1, sizeof(EdgeMessage));
+    EdgeMessage *resultMsg = allocEdgeMessage();
     VERIFY_NON_NULL_NR_MSG(resultMsg, "EdgeCalloc FAILED for EdgeMessage in sendErrorResponse\n");
-    resultMsg->endpointInfo = cloneEdgeEndpointInfo(msg->endpointInfo);
+    setMessageEndpointInfo(resultMsg, shareMessageEndpointInfo(msg));
     resultMsg->type = ERROR_RESPONSE;
     resultMsg->responseLength = 1;
     resultMsg->message_id = msg->message_id;
 
-    resultMsg->responses = (EdgeResponse **) malloc(sizeof(EdgeResponse *) * resultMsg->responseLength);
+    resultMsg->responses = (EdgeResponse **) EdgeMalloc(sizeof(EdgeResponse *) * resultMsg->responseLength);
     for (int i = 0; i < resultMsg->responseLength; i++)
     {
         resultMsg->responses[i] = (EdgeResponse*) EdgeCalloc(1, sizeof(EdgeResponse));
@@ -137,171 +137,42 @@ EdgeDiagnosticInfo *checkDiagnosticInfo(int nodesToProcess,
     return diagnostics;
 }
 
-/**
- * @brief convertToEdgeLocalizedText - Util function to handle LocalizedText read response
- * @param lt - Localized text to be handled
- * @return Edge_LocalizedText*
- */
-static Edge_LocalizedText *convertToEdgeLocalizedText(UA_LocalizedText *lt)
-{
-    VERIFY_NON_NULL_MSG(lt, "Input parameter(lt) is NULL", NULL);
-    Edge_LocalizedText *value = (Edge_LocalizedText *) EdgeCalloc(1, sizeof(Edge_LocalizedText));
-    VERIFY_NON_NULL_MSG(value, "Memory allocation failed.", NULL);
-
-    Edge_String *edgeStr = convertToEdgeString(&lt->locale);
-    if(IS_NULL(edgeStr))
-    {
-        EDGE_LOG(TAG, "Failed to convert locale.");
-        EdgeFree(value);
-        return NULL;
-    }
-    value->locale = *edgeStr;
-    EdgeFree(edgeStr);
-
-    edgeStr = convertToEdgeString(&lt->text);
-    if(IS_NULL(edgeStr))
-    {
-        EDGE_LOG(TAG, "Failed to convert text.");
-        EdgeFree(value->locale.data);
-        EdgeFree(value);
-        return NULL;
-    }
-    value->text = *edgeStr;
-    EdgeFree(edgeStr);
-    return value;
-}
-
-/**
- * @brief convertToEdgeQualifiedName - Utility function to handle QualifiedName response
- * @param qn - Qualified name to be handled
- * @return Edge_QualifiedName*
- */
-static Edge_QualifiedName *convertToEdgeQualifiedName(UA_QualifiedName *qn)
-{
-    VERIFY_NON_NULL_MSG(qn, "Input parameter(qn) is NULL", NULL);
-    Edge_QualifiedName *value = (Edge_QualifiedName *) EdgeCalloc(1, sizeof(Edge_QualifiedName));
-    VERIFY_NON_NULL_MSG(value, "Memory allocation failed.", NULL);
-
-    value->namespaceIndex = qn->namespaceIndex;
-    Edge_String *edgeStr = convertToEdgeString(&qn->name);
-    if(IS_NULL(edgeStr))
-    {
-        EDGE_LOG(TAG, "Failed to convert name.");
-        EdgeFree(value);
-        return NULL;
-    }
-    value->name = *edgeStr;
-    EdgeFree(edgeStr);
-    return value;
-}
-
 EdgeVersatility* parseResponse(EdgeResponse *response, UA_Variant val)
 {
-    char errorDesc[ERROR_DESC_LENGTH] = {'\0'};
-    EdgeVersatility *versatility = NULL;
-    bool isScalar = false;
-
-    isScalar = UA_Variant_isScalar(&val);
+    bool isScalar = UA_Variant_isScalar(&val);
     if (!isScalar && val.arrayLength == 0)
-        return versatility;
+        return NULL;
 
     response->type = get_response_type(val.type);
     if (response->type < 0)
-        return versatility;
+        return NULL;
+    const EdgeTypeConversion *conversion = getEdgeTypeConversion(response->type - 1);
+    size_t memSize = val.type->memSize;
 
-    versatility = (EdgeVersatility*) EdgeCalloc(1, sizeof(EdgeVersatility));
+    EdgeVersatility *versatility = (EdgeVersatility*) EdgeCalloc(1, sizeof(EdgeVersatility));
+    VERIFY_NON_NULL_MSG(versatility, "EdgeCalloc FAILED for versatility in parseResponse\n", NULL);
 
     if (isScalar)
     {
         /* Scalar response handling */
         versatility->arrayLength = 0;
         versatility->isArray = false;
-        size_t size = get_size(response->type, false);
-        if ((response->type == UA_NS0ID_STRING) || (response->type == UA_NS0ID_BYTESTRING)
-                || (response->type == UA_NS0ID_XMLELEMENT))
-        {
-            /* STRING or BYTESTRING or XMLELEMENT scalar response handling */
-            UA_String str = *((UA_String *) val.data);
-            size_t len = str.length;
-            versatility->value = (void *) EdgeCalloc(1, len+1);
-            if(IS_NULL(versatility->value))
-            {
-                EDGE_LOG(TAG, "Memory allocation failed.");
-                strncpy(errorDesc, "Memory allocation failed.", ERROR_DESC_LENGTH);
-                freeEdgeResponse(response);
-                goto EXIT;
-            }
-            strncpy(versatility->value, (char*) str.data, len);
-           ((char*) versatility->value)[(int) len] = '\0';
-        }
-        else if (response->type == UA_NS0ID_GUID)
-        {
-            /* GUID scalar response handling */
-            UA_Guid str = *((UA_Guid *) val.data);
-            char *value = (char *) EdgeMalloc(GUID_LENGTH + 1);
-            if(IS_NULL(value))
-            {
-                EDGE_LOG(TAG, "Error : Malloc failed for Guid SCALAR value in Read Group\n");
-                strncpy(errorDesc, "Memory allocation failed.", ERROR_DESC_LENGTH);
-                freeEdgeResponse(response);
-                goto EXIT;
-            }
-
-            convertGuidToString(str, &value);
-            versatility->value = (void *) value;
-
-            EDGE_LOG_V(TAG, "%s\n", value);
-        }
-        else if(response->type == UA_NS0ID_LOCALIZEDTEXT)
+        if (IS_NOT_NULL(conversion->toEdge))
         {
-            /* LOCALIZEDTEXT scalar response handling */
-            Edge_LocalizedText *value = convertToEdgeLocalizedText((UA_LocalizedText *) val.data);
-            if(IS_NULL(value))
-            {
-                EDGE_LOG(TAG, "Failed to parse localized text.");
-                strncpy(errorDesc, "Failed to parse localized text.", ERROR_DESC_LENGTH);
-                freeEdgeResponse(response);
-                goto EXIT;
-            }
-            versatility->value = value;
-        }
-        else if(response->type == UA_NS0ID_QUALIFIEDNAME)
-        {
-            /* QUALIFIEDNAME scalar response handling */
-            Edge_QualifiedName *value = convertToEdgeQualifiedName((UA_QualifiedName *) val.data);
-            if(IS_NULL(value))
-            {
-                EDGE_LOG(TAG, "Failed to convert qualified name.");
-                strncpy(errorDesc, "Failed to convert qualified name.", ERROR_DESC_LENGTH);
-                freeEdgeResponse(response);
-                goto EXIT;
-            }
-            versatility->value = value;
+            versatility->value = conversion->toEdge(val.data);
         }
-        else if(response->type == UA_NS0ID_NODEID)
+        else
         {
-            /* NODEID scalar response handling */
-            versatility->value = convertToEdgeNodeIdType((UA_NodeId *) val.data);
-            if(IS_NULL(versatility->value))
+            versatility->value = EdgeMalloc(memSize);
+            if (IS_NOT_NULL(versatility->value))
             {
-                EDGE_LOG(TAG, "Failed to convert NodeId.");
-                strncpy(errorDesc, "Failed to convert NodeId.", ERROR_DESC_LENGTH);
-                freeEdgeResponse(response);
-                goto EXIT;
+                memcpy(versatility->value, val.data, memSize);
             }
         }
-        else
+        if (IS_NULL(versatility->value))
         {
-            /* Response handling for other array data types */
-            versatility->value = (void *) EdgeCalloc(1, size);
-            if(IS_NULL(versatility->value))
-            {
-                EDGE_LOG(TAG, "Memory allocation failed.");
-                strncpy(errorDesc, "Memory allocation failed.", ERROR_DESC_LENGTH);
-                freeEdgeResponse(response);
-                goto EXIT;
-            }
-            memcpy(versatility->value, val.data, size);
+            EDGE_LOG_V(TAG, "Failed to convert the scalar value of type %d.\n", response->type);
+            goto EXIT;
         }
     }
     else
@@ -309,168 +180,83 @@ EdgeVersatility* parseResponse(EdgeResponse *response, UA_Variant val)
         /* Array response handling */
         versatility->arrayLength = val.arrayLength;
         versatility->isArray = true;
-        if (response->type == UA_NS0ID_STRING || response->type == UA_NS0ID_BYTESTRING
-                || response->type == UA_NS0ID_XMLELEMENT)
-        {
-            /* STRING or BYTESTRING or XMLELEMENT array response handling */
-            UA_String *str = ((UA_String *) val.data);
-            versatility->value = EdgeCalloc (val.arrayLength, sizeof(char *));
-            if(IS_NULL(versatility->value))
-            {
-                EDGE_LOG(TAG, "Error : Malloc failed for String Array values in Read Group\n");
-                strncpy(errorDesc, "Memory allocation failed.", ERROR_DESC_LENGTH);
-                freeEdgeResponse(response);
-                goto EXIT;
-            }
-
-            char **values = (char **) versatility->value;
-            for (int j = 0; j < val.arrayLength; j++)
-            {
-                values[j] = (char *) EdgeMalloc(str[j].length + 1);
-                if(IS_NULL(values[j]))
-                {
-                    EDGE_LOG_V(TAG, "Error : Malloc failed for ByteString Array value %d in Read Group\n", j);
-                    strncpy(errorDesc, "Memory allocation failed.", ERROR_DESC_LENGTH);
-                    freeEdgeResponse(response);
-                    goto EXIT;
-                }
-                strncpy(values[j], (char *) str[j].data, str[j].length);
-                values[j][str[j].length] = '\0';
-            }
-        }
-        else if (response->type == UA_NS0ID_GUID)
-        {
-            /* GUID Array response handling */
-            UA_Guid *str = ((UA_Guid *) val.data);
-            versatility->value = EdgeCalloc(val.arrayLength, sizeof(char *));
-            if(IS_NULL(versatility->value))
-            {
-                EDGE_LOG(TAG, "Error : Malloc failed for Guid Array values in Read Group\n");
-                strncpy(errorDesc, "Memory allocation failed.", ERROR_DESC_LENGTH);
-                freeEdgeResponse(response);
-                goto EXIT;
-            }
-
-            char **values = (char **) versatility->value;
-            for (int j = 0; j < val.arrayLength; j++)
-            {
-                values[j] = (char *) EdgeMalloc(GUID_LENGTH + 1);
-                if(IS_NULL(values[j]))
-                {
-                    EDGE_LOG_V(TAG, "Error : Malloc failed for Guid Array value %d in Read Group\n", j);
-                    strncpy(errorDesc, "Memory allocation failed.", ERROR_DESC_LENGTH);
-                    freeEdgeResponse(response);
-                    goto EXIT;
-                }
-                convertGuidToString(str[j], &(values[j]));
-                EDGE_LOG_V(TAG, "%s\n", values[j]);
-            }
-        }
-        else if(response->type == UA_NS0ID_QUALIFIEDNAME)
-        {
-            /* QUALIFIEDNAME array response handling */
-            UA_QualifiedName *qnArr = ((UA_QualifiedName *) val.data);
-            versatility->value = EdgeCalloc(val.arrayLength, sizeof(UA_QualifiedName *));
-            if(IS_NULL(versatility->value))
-            {
-                EDGE_LOG(TAG, "Error : Malloc failed for QualifiedName Array values in Read Group\n");
-                strncpy(errorDesc, "Memory allocation failed.", ERROR_DESC_LENGTH);
-                freeEdgeResponse(response);
-                goto EXIT;
-            }
-
-            Edge_QualifiedName **values = (Edge_QualifiedName **) versatility->value;
-            for (int j = 0; j < val.arrayLength; j++)
-            {
-                values[j] = convertToEdgeQualifiedName(&qnArr[j]);
-                if(IS_NULL(values[j]))
-                {
-                    EDGE_LOG(TAG, "Failed to convert the qualified name.");
-                    strncpy(errorDesc, "Failed to convert the qualified name.", ERROR_DESC_LENGTH);
-                    freeEdgeResponse(response);
-                    goto EXIT;
-                }
-            }
-        }
-        else if(response->type == UA_NS0ID_LOCALIZEDTEXT)
-        {
-            /* LOCALIZEDTEXT array response handling */
-            UA_LocalizedText *ltArr = ((UA_LocalizedText *) val.data);
-            versatility->value = EdgeCalloc(val.arrayLength, sizeof(UA_LocalizedText *));
-            if(IS_NULL(versatility->value))
-            {
-                EDGE_LOG(TAG, "Error : Malloc failed for LocalizedText Array values in Read Group\n");
-                strncpy(errorDesc, "Memory allocation failed.", ERROR_DESC_LENGTH);
-                freeEdgeResponse(response);
-                goto EXIT;
-            }
-
-            Edge_LocalizedText **values = (Edge_LocalizedText **) versatility->value;
-            for (int j = 0; j < val.arrayLength; j++)
-            {
-                values[j] = convertToEdgeLocalizedText(&ltArr[j]);
-                if(IS_NULL(values[j]))
-                {
-                    EDGE_LOG(TAG, "Failed to convert the localized text.");
-                    strncpy(errorDesc, "Failed to convert the localized text.", ERROR_DESC_LENGTH);
-                    freeEdgeResponse(response);
-                    goto EXIT;
-                }
-            }
-        }
-        else if(response->type == UA_NS0ID_NODEID)
+        if (IS_NOT_NULL(conversion->toEdge))
         {
-            /* NODEID array response handling */
-            UA_NodeId *nodeIdArr = ((UA_NodeId *) val.data);
-            versatility->value = EdgeCalloc(val.arrayLength, sizeof(Edge_NodeId *));
-            if(IS_NULL(versatility->value))
+            void **values = (void **) EdgeCalloc(val.arrayLength, sizeof(void *));
+            versatility->value = values;
+            if (IS_NULL(values))
             {
-                EDGE_LOG(TAG, "Error : Malloc failed for NodeId Array values in Read Group\n");
-                strncpy(errorDesc, "Memory allocation failed.", ERROR_DESC_LENGTH);
-                freeEdgeResponse(response);
+                EDGE_LOG(TAG, "Error : Malloc failed for Array values in parseResponse\n");
                 goto EXIT;
             }
-
-            Edge_NodeId **values = (Edge_NodeId **) versatility->value;
-            for (int j = 0; j < val.arrayLength; j++)
+            for (size_t j = 0; j < val.arrayLength; j++)
             {
-                values[j] = convertToEdgeNodeIdType(&nodeIdArr[j]);
-                if(IS_NULL(values[j]))
+                values[j] = conversion->toEdge((const UA_Byte *) val.data + j * memSize);
+                if (IS_NULL(values[j]))
                 {
-                    EDGE_LOG(TAG, "Failed to convert the NodeId.");
-                    strncpy(errorDesc, "Failed to convert the NodeId.", ERROR_DESC_LENGTH);
-                    freeEdgeResponse(response);
+                    EDGE_LOG_V(TAG, "Failed to convert the array value %zu of type %d.\n", j,
+                            response->type);
                     goto EXIT;
                 }
             }
         }
         else
         {
-            /* Response handling for other array data types */
-            if(IS_NULL(val.type))
-            {
-                EDGE_LOG(TAG, "Vaue type is NULL ERROR.");
-                strncpy(errorDesc, "Vaue type is NULL ERROR..", ERROR_DESC_LENGTH);
-                freeEdgeResponse(response);
-                goto EXIT;
-            }
-
-            versatility->value = (void *) EdgeCalloc(versatility->arrayLength, val.type->memSize);
-            if(IS_NULL(versatility->value))
+            versatility->value = EdgeMalloc(memSize * val.arrayLength);
+            if (IS_NULL(versatility->value))
             {
                 EDGE_LOG(TAG, "Memory allocation failed.");
-                strncpy(errorDesc, "Memory allocation failed.", ERROR_DESC_LENGTH);
-                freeEdgeResponse(response);
                 goto EXIT;
             }
-
-            memcpy(versatility->value, val.data, val.type->memSize * versatility->arrayLength);
+            memcpy(versatility->value, val.data, memSize * val.arrayLength);
         }
     }
 
     return versatility;
 
     EXIT:
-    freeEdgeVersatility(versatility);
+    freeEdgeVersatilityByType(versatility, response->type);
     return NULL;
 }
+
+EdgeVersatility* takeResponse(EdgeResponse *response, UA_Variant *val)
+{
+    VERIFY_NON_NULL_MSG(val, "NULL val in takeResponse\n", NULL);
+    /* Only a plain array buffer owned by the variant can be taken, others are converted */
+    if (0 == zeroCopyArrayBytes || UA_Variant_isScalar(val) || val->arrayLength == 0
+            || val->storageType != UA_VARIANT_DATA || !val->type->pointerFree
+            || val->arrayLength * val->type->memSize < zeroCopyArrayBytes)
+    {
+        return parseResponse(response, *val);
+    }
+    int type = get_response_type(val->type);
+    const EdgeTypeConversion *conversion = getEdgeTypeConversion(type - 1);
+    if (IS_NULL(conversion) || IS_NOT_NULL(conversion->toEdge))
+    {
+        return parseResponse(response, *val);
+    }
+
+    EdgeVersatility *versatility = (EdgeVersatility*) EdgeCalloc(1, sizeof(EdgeVersatility));
+    VERIFY_NON_NULL_MSG(versatility, "EdgeCalloc FAILED for versatility in takeResponse\n", NULL);
+    response->type = type;
+    versatility->value = val->data;
+    versatility->isArray = true;
+    versatility->arrayLength = val->arrayLength;
+    versatility->adopted = true;
+
+    /* Deleting the variant frees nothing of the array anymore */
+    val->data = NULL;
+    val->arrayLength = 0;
+    return versatility;
+}
+
+void setZeroCopyArrayBytes(size_t bytes)
+{
+    zeroCopyArrayBytes = bytes;
+}
+
+bool formatNodeKey(uint16_t nsIndex, const char *valueAlias, char *key)
+{
+    int written = snprintf(key, EDGE_NODE_KEY_SIZE, "%u;%s", nsIndex, valueAlias);
+    return (written > 0 && written < EDGE_NODE_KEY_SIZE);
+}
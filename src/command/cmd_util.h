@@ -30,6 +30,11 @@
 #include "opcua_common.h"
 #include "open62541.h"
 
+/**
+ * @brief Size of the buffer for a node key built by formatNodeKey().
+ */
+#define EDGE_NODE_KEY_SIZE (512)
+
 /**
  * @brief Get the numeric identifier of the data type.
  * @param[in]  type UA_DataType.
@@ -58,5 +63,29 @@ EdgeDiagnosticInfo *checkDiagnosticInfo(int nodesToProcess,
 
 EdgeVersatility* parseResponse(EdgeResponse *response, UA_Variant val);
 
+/**
+ * @brief Converts the value like parseResponse(), numeric arrays of at least the bytes set by
+ *        setZeroCopyArrayBytes() are handed over instead of copied. The variant is left empty then.
+ * @param[in]  response Response receiving the type
+ * @param[in,out]  val Value owned by the caller
+ * @return Value of the response, NULL on failure
+ */
+EdgeVersatility* takeResponse(EdgeResponse *response, UA_Variant *val);
+
+/**
+ * @brief Sets the size from which takeResponse() hands over numeric arrays
+ * @param[in]  bytes Minimum array size in bytes, 0 to copy all arrays
+ */
+void setZeroCopyArrayBytes(size_t bytes);
+
+/**
+ * @brief Builds the key of a node for per-session node maps
+ * @param[in]  nsIndex Namespace index of the node
+ * @param[in]  valueAlias Value alias of the node
+ * @param[out] key Buffer of EDGE_NODE_KEY_SIZE bytes
+ * @return @c true on success, @c false if the key does not fit
+ */
+bool formatNodeKey(uint16_t nsIndex, const char *valueAlias, char *key);
+
 
 #endif // EDGE_CMD_UTIL_H
@@ -0,0 +1,462 @@
+/******************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ *
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************/
+
+
+#include "history_read.h"
+#include "read.h"
+#include "cmd_util.h"
+#include "edge_logger.h"
+#include "edge_malloc.h"
+#include "edge_open62541.h"
+#include "edge_trace.h"
+#include "edge_client_stats.h"
+#include "message_dispatcher.h"
+#include "server_capabilities.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#define TAG "history_read"
+
+/* Severity bits of a Bad status, GoodNoData and GoodMoreData results carry values */
+#define STATUS_SEVERITY_BAD (0x80000000)
+
+/* Read state of a node of the request */
+typedef struct HistoryNode
+{
+    /* Continuation point of the next chunk, empty if the server has no more values */
+    UA_ByteString continuationPoint;
+    /* Values passed on so far */
+    size_t valueCount;
+    /* Set when no more chunks are read, a continuation point left is released */
+    bool done;
+    /* Set when a chunk announced more values of the node */
+    bool announced;
+} HistoryNode;
+
+#ifdef UA_TYPES_HISTORYREADREQUEST
+
+/**
+ * @brief toDateTime - Converts a time of the history parameter to a UA_DateTime
+ * @param time - Microseconds since the Unix epoch, 0 if unspecified
+ * @return UA_DateTime, 0 if unspecified
+ */
+static UA_DateTime toDateTime(int64_t time)
+{
+    return (0 == time) ? 0 : time * UA_USEC_TO_DATETIME + UA_DATETIME_UNIX_EPOCH;
+}
+
+/**
+ * @brief sendHistoryRead - Sends one HistoryRead request for some nodes of the message
+ * @param client - Client handle
+ * @param msg - Request edge message
+ * @param rv - Nodes of the message from createReadValueIds()
+ * @param nodes - Read state of the nodes of the message
+ * @param indices - Indices of the nodes to read
+ * @param count - Number of nodes to read
+ * @param release - true to release the continuation points of the nodes instead
+ * @return Response with one result per node to read
+ */
+static UA_HistoryReadResponse sendHistoryRead(UA_Client *client, const EdgeMessage *msg,
+        const UA_ReadValueId *rv, const HistoryNode *nodes, const size_t *indices, size_t count,
+        bool release)
+{
+    const EdgeHistoryParameter *param = msg->historyParam;
+    UA_HistoryReadResponse response;
+    UA_HistoryReadResponse_init(&response);
+
+    UA_HistoryReadValueId *items = (UA_HistoryReadValueId *) EdgeCalloc(count,
+            sizeof(UA_HistoryReadValueId));
+    UA_NodeId *aggregates = (UA_NodeId *) EdgeCalloc(count, sizeof(UA_NodeId));
+    if (IS_NULL(items) || IS_NULL(aggregates))
+    {
+        EDGE_LOG(TAG, "EdgeCalloc FAILED for the nodes of a history read\n");
+        EdgeFree(items);
+        EdgeFree(aggregates);
+        response.responseHeader.serviceResult = UA_STATUSCODE_BADOUTOFMEMORY;
+        return response;
+    }
+    /* Members are shared with the nodes of the message, nothing of the request is deleted */
+    for (size_t k = 0; k < count; k++)
+    {
+        items[k].nodeId = rv[indices[k]].nodeId;
+        items[k].continuationPoint = nodes[indices[k]].continuationPoint;
+        aggregates[k] = UA_NODEID_NUMERIC(0, param->aggregateType);
+    }
+
+    UA_ReadRawModifiedDetails rawDetails;
+    UA_ReadRawModifiedDetails_init(&rawDetails);
+    UA_ReadProcessedDetails processedDetails;
+    UA_ReadProcessedDetails_init(&processedDetails);
+
+    UA_HistoryReadRequest request;
+    UA_HistoryReadRequest_init(&request);
+    request.historyReadDetails.encoding = UA_EXTENSIONOBJECT_DECODED_NODELETE;
+    if (EDGE_HISTORY_READ_PROCESSED == param->kind)
+    {
+        processedDetails.startTime = toDateTime(param->startTime);
+        processedDetails.endTime = toDateTime(param->endTime);
+        processedDetails.processingInterval = param->processingInterval;
+        processedDetails.aggregateType = aggregates;
+        processedDetails.aggregateTypeSize = count;
+        processedDetails.aggregateConfiguration.useServerCapabilitiesDefaults = true;
+        request.historyReadDetails.content.decoded.type = &UA_TYPES[UA_TYPES_READPROCESSEDDETAILS];
+        request.historyReadDetails.content.decoded.data = &processedDetails;
+    }
+    else
+    {
+        rawDetails.isReadModified = (EDGE_HISTORY_READ_MODIFIED == param->kind);
+        rawDetails.startTime = toDateTime(param->startTime);
+        rawDetails.endTime = toDateTime(param->endTime);
+        rawDetails.numValuesPerNode = param->numValuesPerNode;
+        rawDetails.returnBounds = param->returnBounds;
+        request.historyReadDetails.content.decoded.type = &UA_TYPES[UA_TYPES_READRAWMODIFIEDDETAILS];
+        request.historyReadDetails.content.decoded.data = &rawDetails;
+    }
+    request.timestampsToReturn = UA_TIMESTAMPSTORETURN_BOTH;
+    request.releaseContinuationPoints = release;
+    request.nodesToRead = items;
+    request.nodesToReadSize = count;
+
+    uint64_t startUs = getClientServiceTime();
+    EDGE_TRACE_BEGIN(msg, EDGE_TRACE_STAGE_SERVICE);
+    __UA_Client_Service(client, &request, &UA_TYPES[UA_TYPES_HISTORYREADREQUEST],
+            &response, &UA_TYPES[UA_TYPES_HISTORYREADRESPONSE]);
+    EDGE_TRACE_END(msg, EDGE_TRACE_STAGE_SERVICE);
+    recordClientService(client, msg->command, startUs, response.responseHeader.serviceResult);
+
+    EdgeFree(items);
+    EdgeFree(aggregates);
+    return response;
+}
+
+/**
+ * @brief getHistoryValues - Gets the values of a history read result
+ * @param result - Result of a node
+ * @param size - Receives the number of values
+ * @return Values, NULL if the result has none
+ */
+static UA_DataValue *getHistoryValues(UA_HistoryReadResult *result, size_t *size)
+{
+    *size = 0;
+    const UA_ExtensionObject *data = &result->historyData;
+    if (data->encoding < UA_EXTENSIONOBJECT_DECODED || IS_NULL(data->content.decoded.data))
+    {
+        return NULL;
+    }
+    if (data->content.decoded.type == &UA_TYPES[UA_TYPES_HISTORYDATA])
+    {
+        UA_HistoryData *history = (UA_HistoryData *) data->content.decoded.data;
+        *size = history->dataValuesSize;
+        return history->dataValues;
+    }
+#ifdef UA_TYPES_HISTORYMODIFIEDDATA
+    if (data->content.decoded.type == &UA_TYPES[UA_TYPES_HISTORYMODIFIEDDATA])
+    {
+        /* Modification infos are not passed on, only the values */
+        UA_HistoryModifiedData *history = (UA_HistoryModifiedData *) data->content.decoded.data;
+        *size = history->dataValuesSize;
+        return history->dataValues;
+    }
+#endif
+    return NULL;
+}
+
+/**
+ * @brief appendHistoryValue - Adds a response with a value of a node to a chunk
+ * @param resultMsg - Chunk, its responses have room for the value
+ * @param msg - Request edge message
+ * @param index - Index of the node in the message
+ * @param value - Value, it is taken over where possible. NULL for a response without value.
+ * @param more - true if later chunks carry more values of the node
+ * @return false if memory is insufficient
+ */
+static bool appendHistoryValue(EdgeMessage *resultMsg, const EdgeMessage *msg, size_t index,
+        UA_DataValue *value, bool more)
+{
+    EdgeResponse *response = (EdgeResponse *) EdgeCalloc(1, sizeof(EdgeResponse));
+    VERIFY_NON_NULL_MSG(response, "EdgeCalloc FAILED for a history read response\n", false);
+    response->nodeInfo = cloneEdgeNodeInfo(msg->requests[index]->nodeInfo);
+    response->requestId = msg->requests[index]->requestId;
+    response->attributeId = UA_ATTRIBUTEID_VALUE;
+    response->hasMoreValues = more;
+    if (IS_NOT_NULL(value))
+    {
+        response->sourceTimestamp = value->hasSourceTimestamp ?
+                (value->sourceTimestamp - UA_DATETIME_UNIX_EPOCH) / UA_USEC_TO_DATETIME : 0;
+        response->serverTimestamp = value->hasServerTimestamp ?
+                (value->serverTimestamp - UA_DATETIME_UNIX_EPOCH) / UA_USEC_TO_DATETIME : 0;
+        response->message = takeResponse(response, &value->value);
+    }
+    if (IS_NULL(response->nodeInfo) || (IS_NOT_NULL(value) && IS_NULL(response->message)))
+    {
+        EDGE_LOG(TAG, "Memory allocation failed.");
+        freeEdgeResponse(response);
+        return false;
+    }
+    resultMsg->responses[resultMsg->responseLength++] = response;
+    return true;
+}
+
+/**
+ * @brief deliverHistoryChunk - Passes the values of one result of a node to the application
+ * @param msg - Request edge message
+ * @param index - Index of the node in the message
+ * @param values - Values of the result, they are taken over where possible
+ * @param count - Number of values to pass on
+ * @param node - Read state of the node
+ * @return false if the result callback stopped the read
+ */
+static bool deliverHistoryChunk(const EdgeMessage *msg, size_t index, UA_DataValue *values,
+        size_t count, HistoryNode *node)
+{
+    bool more = !node->done;
+    EdgeMessage *resultMsg = allocEdgeMessage();
+    VERIFY_NON_NULL_MSG(resultMsg, "EdgeCalloc FAILED for resultMsg in deliverHistoryChunk\n", true);
+    resultMsg->type = GENERAL_RESPONSE;
+    resultMsg->command = CMD_HISTORY_READ;
+    resultMsg->message_id = msg->message_id;
+    setMessageEndpointInfo(resultMsg, shareMessageEndpointInfo(msg));
+    resultMsg->responses = (EdgeResponse **) EdgeCalloc((count > 0) ? count : 1,
+            sizeof(EdgeResponse *));
+    if (IS_NULL(resultMsg->endpointInfo) || IS_NULL(resultMsg->responses))
+    {
+        EDGE_LOG(TAG, "Memory allocation failed.");
+        freeEdgeMessage(resultMsg);
+        return true;
+    }
+
+    for (size_t i = 0; i < count; i++)
+    {
+        /* Values without data, like empty intervals of processed reads, are left out */
+        if (values[i].hasValue && !appendHistoryValue(resultMsg, msg, index, &values[i], more))
+        {
+            break;
+        }
+    }
+    /* The end of a node which announced more values is passed on even without values */
+    if (0 == resultMsg->responseLength && !more && node->announced)
+    {
+        appendHistoryValue(resultMsg, msg, index, NULL, more);
+    }
+    if (0 == resultMsg->responseLength)
+    {
+        freeEdgeMessage(resultMsg);
+        return true;
+    }
+
+    node->announced = more;
+    if (IS_NOT_NULL(msg->historyParam->resultCallback))
+    {
+        // The callback runs on the thread of the request, so that it can stop the read.
+        bool proceed = msg->historyParam->resultCallback(resultMsg,
+                msg->historyParam->resultContext);
+        freeEdgeMessage(resultMsg);
+        return proceed;
+    }
+    add_to_recvQ(resultMsg);
+    return true;
+}
+
+/**
+ * @brief readHistoryChunks - Reads the next chunk of some nodes and passes the values on
+ * @param client - Client handle
+ * @param msg - Request edge message
+ * @param rv - Nodes of the message from createReadValueIds()
+ * @param nodes - Read state of the nodes of the message
+ * @param indices - Indices of the nodes to read
+ * @param count - Number of nodes to read
+ * @return false if the read stops, as the result callback asked so or the request failed
+ */
+static bool readHistoryChunks(UA_Client *client, const EdgeMessage *msg, const UA_ReadValueId *rv,
+        HistoryNode *nodes, const size_t *indices, size_t count)
+{
+    char errorDesc[ERROR_DESC_LENGTH] = {'\0'};
+    UA_HistoryReadResponse response = sendHistoryRead(client, msg, rv, nodes, indices, count,
+            false);
+    if (UA_STATUSCODE_GOOD != response.responseHeader.serviceResult
+            || count != response.resultsSize)
+    {
+        EDGE_LOG_V(TAG, "Error in history read :: 0x%08x(%s)\n",
+                response.responseHeader.serviceResult,
+                UA_StatusCode_name(response.responseHeader.serviceResult));
+        /* The state of the continuation points on the server is unknown, they are dropped */
+        for (size_t k = 0; k < count; k++)
+        {
+            UA_ByteString_deleteMembers(&nodes[indices[k]].continuationPoint);
+            nodes[indices[k]].done = true;
+        }
+        UA_HistoryReadResponse_deleteMembers(&response);
+        sendErrorResponse(msg, "Error in history read.");
+        return false;
+    }
+
+    bool proceed = true;
+    size_t maxValues = msg->historyParam->maxValues;
+    for (size_t k = 0; k < count; k++)
+    {
+        size_t index = indices[k];
+        HistoryNode *node = &nodes[index];
+        UA_HistoryReadResult *result = &response.results[k];
+        UA_ByteString_deleteMembers(&node->continuationPoint);
+        if (result->statusCode & STATUS_SEVERITY_BAD)
+        {
+            EDGE_LOG_V(TAG, "Error in history read response for particular node :: 0x%08x(%s)\n",
+                    result->statusCode, UA_StatusCode_name(result->statusCode));
+            snprintf(errorDesc, ERROR_DESC_LENGTH,
+                    "Bad history read result for the node at position(%d)", (int) index);
+            sendErrorResponse(msg, errorDesc);
+            node->done = true;
+            continue;
+        }
+
+        /* The continuation point is taken over for the next chunk */
+        node->continuationPoint = result->continuationPoint;
+        UA_ByteString_init(&result->continuationPoint);
+
+        size_t size = 0;
+        UA_DataValue *values = getHistoryValues(result, &size);
+        if (maxValues > 0 && node->valueCount + size >= maxValues)
+        {
+            size = maxValues - node->valueCount;
+            node->done = true;
+        }
+        node->valueCount += size;
+        node->done = node->done || !proceed || 0 == node->continuationPoint.length;
+        if (proceed)
+        {
+            proceed = deliverHistoryChunk(msg, index, values, size, node);
+        }
+    }
+    UA_HistoryReadResponse_deleteMembers(&response);
+    return proceed;
+}
+
+/**
+ * @brief releaseHistoryNodes - Releases the continuation points left on the server
+ * @param client - Client handle
+ * @param msg - Request edge message
+ * @param rv - Nodes of the message from createReadValueIds()
+ * @param nodes - Read state of the nodes of the message
+ * @param indices - Buffer for the indices of the nodes, one per node of the message
+ * @param maxNodes - Maximum number of nodes per request
+ */
+static void releaseHistoryNodes(UA_Client *client, const EdgeMessage *msg,
+        const UA_ReadValueId *rv, HistoryNode *nodes, size_t *indices, size_t maxNodes)
+{
+    size_t count = 0;
+    for (size_t i = 0; i < msg->requestLength; i++)
+    {
+        if (nodes[i].continuationPoint.length > 0)
+        {
+            indices[count++] = i;
+        }
+    }
+    for (size_t start = 0; start < count; start += maxNodes)
+    {
+        size_t batch = (count - start < maxNodes) ? count - start : maxNodes;
+        UA_HistoryReadResponse response = sendHistoryRead(client, msg, rv, nodes,
+                indices + start, batch, true);
+        UA_HistoryReadResponse_deleteMembers(&response);
+    }
+}
+
+EdgeResult executeHistoryRead(UA_Client *client, const EdgeMessage *msg)
+{
+    EdgeResult result;
+    result.code = STATUS_PARAM_INVALID;
+    VERIFY_NON_NULL_MSG(client, "Client param is NULL in executeHistoryRead\n", result);
+    VERIFY_NON_NULL_MSG(msg, "EdgeMessage param is NULL in executeHistoryRead\n", result);
+    VERIFY_NON_NULL_MSG(msg->historyParam, "NULL history parameter in executeHistoryRead\n",
+            result);
+    COND_CHECK_MSG((0 == msg->requestLength || IS_NULL(msg->requests)),
+            "No nodes in executeHistoryRead\n", result);
+
+    result.code = STATUS_ERROR;
+    size_t reqLen = msg->requestLength;
+    UA_ReadValueId *rv = createReadValueIds(client, msg, UA_ATTRIBUTEID_VALUE);
+    HistoryNode *nodes = (HistoryNode *) EdgeCalloc(reqLen, sizeof(HistoryNode));
+    size_t *pending = (size_t *) EdgeMalloc(reqLen * sizeof(size_t));
+    if (IS_NULL(rv) || IS_NULL(nodes) || IS_NULL(pending))
+    {
+        EDGE_LOG(TAG, "Memory allocation failed.");
+        sendErrorResponse(msg, "Memory allocation failed.");
+        deleteReadValueIds(rv, reqLen);
+        EdgeFree(nodes);
+        EdgeFree(pending);
+        return result;
+    }
+
+    /* Servers reject requests above their MaxNodesPerHistoryReadData */
+    EdgeServerCapabilities capabilities;
+    getServerCapabilities(client, &capabilities);
+    size_t maxNodes = (capabilities.maxNodesPerHistoryReadData > 0) ?
+            capabilities.maxNodesPerHistoryReadData : reqLen;
+
+    /* Each pass reads the next chunk of the nodes which have more values */
+    size_t pendingCount = reqLen;
+    for (size_t i = 0; i < reqLen; i++)
+    {
+        pending[i] = i;
+    }
+    bool proceed = true;
+    while (proceed && pendingCount > 0)
+    {
+        for (size_t start = 0; proceed && start < pendingCount; start += maxNodes)
+        {
+            size_t batch = (pendingCount - start < maxNodes) ? pendingCount - start : maxNodes;
+            proceed = readHistoryChunks(client, msg, rv, nodes, pending + start, batch);
+        }
+        size_t next = 0;
+        for (size_t k = 0; k < pendingCount; k++)
+        {
+            if (!nodes[pending[k]].done)
+            {
+                pending[next++] = pending[k];
+            }
+        }
+        pendingCount = next;
+    }
+
+    releaseHistoryNodes(client, msg, rv, nodes, pending, maxNodes);
+    for (size_t i = 0; i < reqLen; i++)
+    {
+        UA_ByteString_deleteMembers(&nodes[i].continuationPoint);
+    }
+    deleteReadValueIds(rv, reqLen);
+    EdgeFree(nodes);
+    EdgeFree(pending);
+    result.code = STATUS_OK;
+    return result;
+}
+
+#else
+
+EdgeResult executeHistoryRead(UA_Client *client, const EdgeMessage *msg)
+{
+    (void) client;
+    EdgeResult result;
+    result.code = STATUS_ERROR;
+    EDGE_LOG(TAG, "The open62541 library is built without the HistoryRead service\n");
+    sendErrorResponse(msg, "History read is not supported.");
+    return result;
+}
+
+#endif
@@ -0,0 +1,61 @@
+/******************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ *
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************/
+
+
+/**
+ * @file history_read.h
+ *
+ * @brief This file contains the definition, types and APIs for HistoryRead requests.
+ */
+
+#ifndef EDGE_HISTORY_READ_H
+#define EDGE_HISTORY_READ_H
+
+#include "opcua_common.h"
+#include "open62541.h"
+
+#include "edge_utils.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/**
+ * @brief Reads the history of the nodes of the message as given by its history parameter.
+ *        Every result of the server is passed on at once as a chunk of values of one node,
+ *        further chunks are read with the continuation points of the server until all nodes
+ *        are complete, the value limit is reached or the result callback stops the read.
+ *        Requests are split by the MaxNodesPerHistoryReadData of the server.
+ * @param[in]  client Client Handle.
+ * @param[in]  msg EdgeMessage request data
+ * @return @c EdgeResult code is 0 on success, otherwise an error value
+ * @retval #STATUS_OK Successful
+ * @retval #STATUS_PARAM_INVALID Invalid parameter
+ * @retval #STATUS_ERROR Operation failed
+ * @remarks Continuation points left on the server when the read stops early are released.
+ */
+EdgeResult executeHistoryRead(UA_Client *client, const EdgeMessage *msg);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // EDGE_HISTORY_READ_H
@@ -21,138 +21,334 @@
 #include "method.h"
 #include "cmd_util.h"
 #include "edge_logger.h"
+#include "edge_trace.h"
+#include "edge_client_stats.h"
 #include "edge_malloc.h"
 #include "message_dispatcher.h"
 #include "edge_open62541.h"
+#include "async_service.h"
+#include "server_capabilities.h"
+
+#include <string.h>
 
 #define TAG "method"
 
 #define GUID_LENGTH (36)
 
-EdgeResult executeMethod(UA_Client *client, const EdgeMessage *msg)
+/* Good-class status codes like GoodCompletesAsynchronously are successful calls */
+#define IS_GOOD_STATUS(code) (0 == ((code) & 0xC0000000))
+
+/**
+ * @brief getMethodRequest - Gets a method request of the message
+ * @param msg - Request Edge Message
+ * @param index - Index of the request
+ * @return Request of the index, the only request of a SEND_REQUEST message
+ */
+static EdgeRequest *getMethodRequest(const EdgeMessage *msg, size_t index)
+{
+    return (SEND_REQUESTS == msg->type) ? msg->requests[index] : msg->request;
+}
+
+/**
+ * @brief getMethodRequestCount - Gets the number of method requests of the message
+ * @param msg - Request Edge Message
+ * @return Number of requests
+ */
+static size_t getMethodRequestCount(const EdgeMessage *msg)
+{
+    return (SEND_REQUESTS == msg->type) ? msg->requestLength : 1;
+}
+
+/**
+ * @brief processCallResponse - Queues one response message with the outputs of all successful
+ * calls, each failed call gets an error response
+ * @param msg - Request Edge Message
+ * @param callResponse - Call response with one result per request, it is not deallocated but
+ * large array outputs may be handed over to the responses, see takeResponse()
+ * @return @c EdgeResult code is 0 on success, otherwise an error value
+ */
+static EdgeResult processCallResponse(const EdgeMessage *msg, UA_CallResponse *callResponse)
 {
     EdgeResult result;
     result.code = STATUS_ERROR;
-    VERIFY_NON_NULL_MSG(client, "NULL param CLIENT in executeMethod\n", result);
-    EdgeRequest *request = msg->request;
-    EdgeMethodRequestParams *params = request->methodParams;
-    int idx = 0;
-    UA_Variant *input = NULL;
-    int num_inpArgs = 0;
-    if (params)
+    size_t reqLen = getMethodRequestCount(msg);
+    UA_StatusCode serviceResult = callResponse->responseHeader.serviceResult;
+    if (IS_GOOD_STATUS(serviceResult) && reqLen != callResponse->resultsSize)
     {
-        num_inpArgs = params->num_inpArgs;
+        serviceResult = UA_STATUSCODE_BADUNEXPECTEDERROR;
     }
-    if (num_inpArgs > 0)
+    if (!IS_GOOD_STATUS(serviceResult))
     {
-        input = (UA_Variant *) EdgeCalloc(params->num_inpArgs, sizeof(UA_Variant));
-        VERIFY_NON_NULL_MSG(input, "EdgeCalloc FAILED for UA_Variant in executeMethod\n", result);
+        EDGE_LOG_V(TAG, "method call failed 0x%08x\n", serviceResult);
+        sendErrorResponse(msg, "Error in executing METHOD OPERATION.");
+        return result;
     }
 
-    for (idx = 0; idx < num_inpArgs; idx++)
+    size_t outputSize = 0;
+    size_t succeeded = 0;
+    for (size_t i = 0; i < reqLen; i++)
     {
-        UA_Variant_init(&input[idx]);
-        int type = (int) params->inpArg[idx]->argType - 1;
-        if (params->inpArg[idx]->valType == SCALAR)
+        const UA_CallMethodResult *callResult = &callResponse->results[i];
+        if (!IS_GOOD_STATUS(callResult->statusCode))
         {
-            /* Input argument is scalar value */
-            createScalarVariant(type, params->inpArg[idx]->scalarValue, &input[idx]);
-        }
-        else if (params->inpArg[idx]->valType == ARRAY_1D)
-        {
-            /* Input argument is array of scalar values */
-            createArrayVariant(type, params->inpArg[idx]->arrayData,
-                               params->inpArg[idx]->arrayLength, &input[idx]);
+            /* Method call failed */
+            EDGE_LOG_V(TAG, "method call failed 0x%08x\n", callResult->statusCode);
+            sendErrorResponse(msg, "Error in executing METHOD OPERATION.");
+            continue;
         }
+        outputSize += callResult->outputArgumentsSize;
+        succeeded++;
     }
+    COND_CHECK((0 == succeeded), result);
+    EDGE_LOG(TAG, "method call was success");
 
-    size_t outputSize = 0;
-    UA_Variant *output = NULL;
-    EdgeMessage *resultMsg = NULL;
-    /* Execute Method Call */
-    UA_StatusCode retVal = UA_Client_call(client, UA_NODEID_NUMERIC(0, UA_NS0ID_OBJECTSFOLDER),
-            UA_NODEID_STRING(request->nodeInfo->nodeId->nameSpace, request->nodeInfo->valueAlias),
-            num_inpArgs, input, &outputSize, &output);
-    if (retVal != UA_STATUSCODE_GOOD)
+    EdgeMessage *resultMsg = allocEdgeMessage();
+    if(IS_NULL(resultMsg))
     {
-        /* Method call failed */
-        EDGE_LOG_V(TAG, "method call failed 0x%08x\n", retVal);
-        sendErrorResponse(msg, "Error in executing METHOD OPERATION.");
+        EDGE_LOG(TAG, "Memory allocation failed.");
+        goto EXIT;
     }
-    else
+
+    setMessageEndpointInfo(resultMsg, shareMessageEndpointInfo(msg));
+    if(IS_NULL(resultMsg->endpointInfo))
     {
-        EDGE_LOG(TAG, "method call was success");
+        EDGE_LOG(TAG, "Memory allocation failed.");
+        goto EXIT;
+    }
 
-        resultMsg = (EdgeMessage *) EdgeCalloc(1, sizeof(EdgeMessage));
-        if(IS_NULL(resultMsg))
-        {
-            EDGE_LOG(TAG, "Memory allocation failed.");
-            goto EXIT;
-        }
+    resultMsg->type = GENERAL_RESPONSE;
+    resultMsg->command = CMD_METHOD;
+    resultMsg->message_id = msg->message_id;
 
-        resultMsg->endpointInfo = cloneEdgeEndpointInfo(msg->endpointInfo);
-        if(IS_NULL(resultMsg->endpointInfo))
+    if(outputSize > 0)
+    {
+        resultMsg->responses = (EdgeResponse **) EdgeCalloc(outputSize, sizeof(EdgeResponse *));
+        if(IS_NULL(resultMsg->responses))
         {
-            EDGE_LOG(TAG, "Memory allocation failed.");
+            EDGE_LOG(TAG, "ERROR : EdgeResponse EdgeMalloc failed in executeMethod");
             goto EXIT;
         }
+    }
 
-        resultMsg->type = GENERAL_RESPONSE;
-        resultMsg->responseLength = outputSize;
-        resultMsg->command = CMD_METHOD;
-        resultMsg->message_id = msg->message_id;
-
-        if(outputSize > 0)
+    /* The outputs of the calls follow each other in the order of the requests */
+    for (size_t i = 0; i < reqLen; i++)
+    {
+        UA_CallMethodResult *callResult = &callResponse->results[i];
+        if (!IS_GOOD_STATUS(callResult->statusCode))
         {
-            resultMsg->responses = (EdgeResponse **) EdgeCalloc(outputSize, sizeof(EdgeResponse *));
-            if(IS_NULL(resultMsg->responses))
-            {
-                EDGE_LOG(TAG, "ERROR : EdgeResponse EdgeMalloc failed in executeMethod");
-                goto EXIT;
-            }
+            continue;
         }
-
-        for (int i = 0; i < outputSize; i++)
+        EdgeRequest *request = getMethodRequest(msg, i);
+        for (size_t j = 0; j < callResult->outputArgumentsSize; j++)
         {
-            resultMsg->responses[i] = (EdgeResponse *) EdgeCalloc(1, sizeof(EdgeResponse));
-            if(IS_NULL(resultMsg->responses[i]))
+            EdgeResponse *response = (EdgeResponse *) EdgeCalloc(1, sizeof(EdgeResponse));
+            if(IS_NULL(response))
             {
-                EDGE_LOG_V(TAG, "ERROR : EdgeResponse %d Malloc failed in executeMethod\n", i);
+                EDGE_LOG_V(TAG, "ERROR : EdgeResponse %d Malloc failed in executeMethod\n",
+                        (int) resultMsg->responseLength);
                 goto EXIT;
             }
+            resultMsg->responses[resultMsg->responseLength++] = response;
 
-            resultMsg->responses[i]->nodeInfo = cloneEdgeNodeInfo(msg->request->nodeInfo);
-            resultMsg->responses[i]->requestId = msg->request->requestId;
-            resultMsg->responses[i]->type = get_response_type(output[i].type);
-            resultMsg->responses[i]->message = parseResponse(resultMsg->responses[i], output[i]);
-            if(IS_NULL(resultMsg->responses[i]->message))
+            response->nodeInfo = cloneEdgeNodeInfo(request->nodeInfo);
+            response->requestId = request->requestId;
+            response->type = get_response_type(callResult->outputArguments[j].type);
+            response->message = takeResponse(response, &callResult->outputArguments[j]);
+            if(IS_NULL(response->message))
             {
                 EDGE_LOG(TAG, "ERROR : versatility EdgeMalloc failed in executeMethod");
                 goto EXIT;
             }
-            resultMsg->responses[i]->m_diagnosticInfo = NULL;
+            response->m_diagnosticInfo = NULL;
         }
-
-        /* Adding the method response to receiverQ */
-        add_to_recvQ(resultMsg);
-        result.code = STATUS_OK;
-        resultMsg = NULL;
     }
 
+    /* Adding the method response to receiverQ */
+    add_to_recvQ(resultMsg);
+    result.code = STATUS_OK;
+    resultMsg = NULL;
+
 EXIT:
     /* Free the memory */
     if(IS_NOT_NULL(resultMsg))
     {
         freeEdgeMessage(resultMsg);
     }
+    return result;
+}
+
+#ifdef ENABLE_ASYNC_SERVICES
+static void asyncMethodHandler(UA_Client *client, const EdgeMessage *msg, const void *data,
+        void *response)
+{
+    processCallResponse(msg, (UA_CallResponse *) response);
+}
+#endif
+
+/**
+ * @brief initCallMethodRequest - Initializes the call of one method request
+ * @param request - Method request of the Edge Message
+ * @param item - Call to initialize, its method NodeId borrows the value alias of the request
+ * @return GOOD status on success, otherwise an error status. The input arguments of the
+ * item are freed with UA_Array_delete in both cases.
+ */
+static UA_StatusCode initCallMethodRequest(const EdgeRequest *request, UA_CallMethodRequest *item)
+{
+    UA_CallMethodRequest_init(item);
+    item->objectId = UA_NODEID_NUMERIC(0, UA_NS0ID_OBJECTSFOLDER);
+    item->methodId = UA_NODEID_STRING(request->nodeInfo->nodeId->nameSpace,
+            request->nodeInfo->valueAlias);
+
+    EdgeMethodRequestParams *params = request->methodParams;
+    size_t num_inpArgs = IS_NOT_NULL(params) ? params->num_inpArgs : 0;
+    COND_CHECK((0 == num_inpArgs), UA_STATUSCODE_GOOD);
+
+    item->inputArguments = (UA_Variant *) UA_Array_new(num_inpArgs, &UA_TYPES[UA_TYPES_VARIANT]);
+    VERIFY_NON_NULL_MSG(item->inputArguments,
+            "UA_Array_new FAILED for UA_Variant in executeMethod\n", UA_STATUSCODE_BADOUTOFMEMORY);
+    item->inputArgumentsSize = num_inpArgs;
+
+    for (size_t idx = 0; idx < num_inpArgs; idx++)
+    {
+        int type = (int) params->inpArg[idx]->argType - 1;
+        if (params->inpArg[idx]->valType == SCALAR)
+        {
+            /* Input argument is scalar value */
+            createScalarVariant(type, params->inpArg[idx]->scalarValue, &item->inputArguments[idx]);
+        }
+        else if (params->inpArg[idx]->valType == ARRAY_1D)
+        {
+            /* Input argument is array of scalar values */
+            createArrayVariant(type, params->inpArg[idx]->arrayData,
+                               params->inpArg[idx]->arrayLength, &item->inputArguments[idx]);
+        }
+    }
+    return UA_STATUSCODE_GOOD;
+}
+
+/**
+ * @brief callInChunks - Splits a call request into requests of at most maxMethods calls
+ * and merges their results into one response
+ * @param client - Client handle
+ * @param request - Call request with all the calls
+ * @param maxMethods - Maximum number of calls per request, 0 if there is no limit
+ * @return Call response with one result per call of the request
+ */
+static UA_CallResponse callInChunks(UA_Client *client, const UA_CallRequest *request,
+        size_t maxMethods)
+{
+    size_t total = request->methodsToCallSize;
+    if (0 == maxMethods || total <= maxMethods)
+    {
+        return UA_Client_Service_call(client, *request);
+    }
 
-    for (idx = 0; idx < num_inpArgs; idx++)
+    UA_CallResponse response;
+    UA_CallResponse_init(&response);
+    response.results = (UA_CallMethodResult *) UA_Array_new(total,
+            &UA_TYPES[UA_TYPES_CALLMETHODRESULT]);
+    if (IS_NULL(response.results))
     {
-        UA_Variant_deleteMembers(&input[idx]);
+        response.responseHeader.serviceResult = UA_STATUSCODE_BADOUTOFMEMORY;
+        return response;
     }
+    response.resultsSize = total;
 
-    UA_Array_delete(output, outputSize, &UA_TYPES[UA_TYPES_VARIANT]);
+    UA_CallRequest chunkRequest = *request;
+    for (size_t offset = 0; offset < total; offset += maxMethods)
+    {
+        size_t count = (total - offset < maxMethods) ? (total - offset) : maxMethods;
+        chunkRequest.methodsToCall = request->methodsToCall + offset;
+        chunkRequest.methodsToCallSize = count;
+        EDGE_LOG_V(TAG, "Calling methods %d to %d\n", (int) offset, (int) (offset + count - 1));
+
+        UA_CallResponse chunkResponse = UA_Client_Service_call(client, chunkRequest);
+        UA_StatusCode serviceResult = chunkResponse.responseHeader.serviceResult;
+        if (serviceResult == UA_STATUSCODE_GOOD && chunkResponse.resultsSize != count)
+        {
+            serviceResult = UA_STATUSCODE_BADUNEXPECTEDERROR;
+        }
+        if (serviceResult != UA_STATUSCODE_GOOD)
+        {
+            UA_CallResponse_deleteMembers(&chunkResponse);
+            UA_CallResponse_deleteMembers(&response);
+            response.responseHeader.serviceResult = serviceResult;
+            return response;
+        }
+
+        /* Take over the results of the chunk */
+        memcpy(response.results + offset, chunkResponse.results,
+                count * sizeof(UA_CallMethodResult));
+        UA_free(chunkResponse.results);
+        chunkResponse.results = NULL;
+        chunkResponse.resultsSize = 0;
+        UA_CallResponse_deleteMembers(&chunkResponse);
+    }
+    return response;
+}
 
-    EdgeFree(input);
+EdgeResult executeMethod(UA_Client *client, const EdgeMessage *msg)
+{
+    EdgeResult result;
+    result.code = STATUS_ERROR;
+    VERIFY_NON_NULL_MSG(client, "NULL param CLIENT in executeMethod\n", result);
+    size_t reqLen = getMethodRequestCount(msg);
+    result.code = STATUS_PARAM_INVALID;
+    COND_CHECK_MSG((0 == reqLen), "No method requests in executeMethod\n", result);
+
+    /* All method requests of the message go into one Call service request */
+    result.code = STATUS_ERROR;
+    UA_CallMethodRequest *items = (UA_CallMethodRequest *) EdgeCalloc(reqLen,
+            sizeof(UA_CallMethodRequest));
+    VERIFY_NON_NULL_MSG(items, "EdgeCalloc FAILED for UA_CallMethodRequest in executeMethod\n",
+            result);
+    for (size_t i = 0; i < reqLen; i++)
+    {
+        if (initCallMethodRequest(getMethodRequest(msg, i), &items[i]) != UA_STATUSCODE_GOOD)
+        {
+            sendErrorResponse(msg, "Memory allocation failed.");
+            goto EXIT;
+        }
+    }
+
+    UA_CallRequest callRequest;
+    UA_CallRequest_init(&callRequest);
+    callRequest.methodsToCall = items;
+    callRequest.methodsToCallSize = reqLen;
+
+    EdgeServerCapabilities capabilities;
+    getServerCapabilities(client, &capabilities);
+    size_t maxNodesPerMethodCall = capabilities.maxNodesPerMethodCall;
+
+#ifdef ENABLE_ASYNC_SERVICES
+    /* The response is processed by asyncMethodHandler */
+    if ((0 == maxNodesPerMethodCall || reqLen <= maxNodesPerMethodCall)
+            && sendAsyncService(client, msg, &callRequest, &UA_TYPES[UA_TYPES_CALLREQUEST],
+            &UA_TYPES[UA_TYPES_CALLRESPONSE], asyncMethodHandler, NULL, 0))
+    {
+        result.code = STATUS_OK;
+        goto EXIT;
+    }
+#endif
+
+    /* Execute Method Call */
+    uint64_t startUs = getClientServiceTime();
+    EDGE_TRACE_BEGIN(msg, EDGE_TRACE_STAGE_SERVICE);
+    UA_CallResponse callResponse = callInChunks(client, &callRequest, maxNodesPerMethodCall);
+    EDGE_TRACE_END(msg, EDGE_TRACE_STAGE_SERVICE);
+    recordClientService(client, msg->command, startUs, callResponse.responseHeader.serviceResult);
+    EDGE_TRACE_BEGIN(msg, EDGE_TRACE_STAGE_RESPONSE);
+    result = processCallResponse(msg, &callResponse);
+    EDGE_TRACE_END(msg, EDGE_TRACE_STAGE_RESPONSE);
+    UA_CallResponse_deleteMembers(&callResponse);
+
+EXIT:
+    /* Free the memory */
+    for (size_t i = 0; i < reqLen; i++)
+    {
+        UA_Array_delete(items[i].inputArguments, items[i].inputArgumentsSize,
+                &UA_TYPES[UA_TYPES_VARIANT]);
+    }
+    EdgeFree(items);
     return result;
 }
@@ -0,0 +1,373 @@
+/******************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ *
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************/
+
+#include "prepared_read.h"
+#include "read.h"
+#include "cmd_util.h"
+#include "edge_logger.h"
+#include "edge_malloc.h"
+#include "edge_open62541.h"
+#include "edge_hash_map.h"
+#include "message_dispatcher.h"
+#include "octhread.h"
+#include "edge_thread_config.h"
+
+#include <stdint.h>
+
+#ifndef _WIN32
+#include <pthread.h>
+#else
+#include "pthread.h"
+#endif
+
+#define TAG "prepared_read"
+
+#define PREPARED_READ_KEY(id) ((keyValue) (uintptr_t) (id))
+
+struct EdgePreparedRead
+{
+    /**< Key in preparedReadMap, carried by the queued cycle messages. **/
+    uint32_t id;
+
+    /**< Copy of the read request, made once. **/
+    EdgeMessage *msg;
+
+    /**< Attribute read by the request. **/
+    UA_UInt32 attributeId;
+
+    /**< Nodes to read, built on the first cycle for client. **/
+    UA_ReadValueId *rv;
+    UA_Client *client;
+
+    /**< Held while a cycle executes, so that destroy waits for it. **/
+    pthread_mutex_t lock;
+
+    /**< Periodic read state, guarded by timerMutex. **/
+    oc_mutex timerMutex;
+    oc_cond timerCond;
+    oc_thread timer;
+    bool running;
+    uint64_t intervalUs;
+
+    /**< Number of cycles in the send queue. The periodic read skips a cycle while one is queued. **/
+    size_t queued;
+};
+
+/* Prepared read id -> EdgePreparedRead. Cycle messages hold the id, so a cycle left in the
+ * queue after its prepared read was destroyed is dropped instead of touching freed memory. */
+static EdgeHashMap *preparedReadMap = NULL;
+static uint32_t lastPreparedId = 0;
+static pthread_mutex_t preparedReadMutex = PTHREAD_MUTEX_INITIALIZER;
+
+static void freePreparedRead(EdgePreparedRead *read)
+{
+    deleteReadValueIds(read->rv, read->msg->requestLength);
+    freeEdgeMessage(read->msg);
+    oc_cond_free(read->timerCond);
+    oc_mutex_free(read->timerMutex);
+    pthread_mutex_destroy(&read->lock);
+    EdgeFree(read);
+}
+
+EdgePreparedRead *createPreparedReadImpl(EdgeMessage *msg)
+{
+    VERIFY_NON_NULL_MSG(msg, "NULL message received in createPreparedRead\n", NULL);
+    VERIFY_NON_NULL_MSG(msg->endpointInfo, "NULL endpointInfo received in createPreparedRead\n", NULL);
+    COND_CHECK_MSG((msg->command != CMD_READ && msg->command != CMD_READ_SAMPLING_INTERVAL),
+            "Error: Invalid command for prepared read\n", NULL);
+    COND_CHECK_MSG((IS_NULL(msg->requests) || msg->requestLength < 1),
+            "Error: Prepared read has no nodes to read\n", NULL);
+
+    EdgePreparedRead *read = (EdgePreparedRead *) EdgeCalloc(1, sizeof(EdgePreparedRead));
+    VERIFY_NON_NULL_MSG(read, "EdgeCalloc FAILED for EdgePreparedRead\n", NULL);
+    read->attributeId = (CMD_READ == msg->command) ? UA_ATTRIBUTEID_VALUE :
+            UA_ATTRIBUTEID_MINIMUMSAMPLINGINTERVAL;
+    read->timerMutex = oc_mutex_new();
+    read->timerCond = oc_cond_new();
+    read->msg = cloneEdgeMessage(msg);
+    if (IS_NULL(read->timerMutex) || IS_NULL(read->timerCond) || IS_NULL(read->msg))
+    {
+        EDGE_LOG(TAG, "Memory allocation failed.");
+        oc_cond_free(read->timerCond);
+        oc_mutex_free(read->timerMutex);
+        freeEdgeMessage(read->msg);
+        EdgeFree(read);
+        return NULL;
+    }
+    pthread_mutex_init(&read->lock, NULL);
+
+    pthread_mutex_lock(&preparedReadMutex);
+    if (IS_NULL(preparedReadMap))
+    {
+        preparedReadMap = createEdgeHashMap(EDGE_HASH_POINTER_KEY);
+    }
+    do
+    {
+        read->id = ++lastPreparedId;
+    } while (0 == read->id || IS_NOT_NULL(getEdgeHashMapElement(preparedReadMap,
+            PREPARED_READ_KEY(read->id))));
+    bool inserted = IS_NOT_NULL(preparedReadMap) &&
+            insertEdgeHashMapElement(preparedReadMap, PREPARED_READ_KEY(read->id), read);
+    pthread_mutex_unlock(&preparedReadMutex);
+
+    if (!inserted)
+    {
+        EDGE_LOG(TAG, "Failed to store the prepared read.");
+        freePreparedRead(read);
+        return NULL;
+    }
+    return read;
+}
+
+/**
+ * @brief queueCycle - Queues a cycle message, which shares the endpoint of the prepared request
+ * @param read - Prepared read
+ * @return true if the send queue accepted the cycle
+ */
+static bool queueCycle(EdgePreparedRead *read)
+{
+    EdgeMessage *cycle = allocEdgeMessage();
+    VERIFY_NON_NULL_MSG(cycle, "EdgeCalloc FAILED for prepared read cycle\n", false);
+    setMessageEndpointInfo(cycle, shareMessageEndpointInfo(read->msg));
+    if (IS_NULL(cycle->endpointInfo))
+    {
+        EDGE_LOG(TAG, "Memory allocation failed.");
+        freeEdgeMessage(cycle);
+        return false;
+    }
+    cycle->type = SEND_REQUESTS;
+    cycle->command = read->msg->command;
+    cycle->message_id = read->msg->message_id;
+    EDGE_MESSAGE_BLOCK(cycle)->preparedId = read->id;
+
+    oc_mutex_lock(read->timerMutex);
+    read->queued++;
+    oc_mutex_unlock(read->timerMutex);
+    if (!add_to_sendQ(cycle))
+    {
+        oc_mutex_lock(read->timerMutex);
+        read->queued--;
+        oc_mutex_unlock(read->timerMutex);
+        return false;
+    }
+    return true;
+}
+
+EdgeResult sendPreparedReadImpl(EdgePreparedRead *read)
+{
+    EdgeResult result;
+    result.code = STATUS_PARAM_INVALID;
+    VERIFY_NON_NULL_MSG(read, "NULL prepared read received in sendPreparedRead\n", result);
+    result.code = queueCycle(read) ? STATUS_OK : STATUS_ENQUEUE_ERROR;
+    return result;
+}
+
+static void *periodicReadHandler(void *arg)
+{
+    applyEdgeThreadConfig(EDGE_THREAD_HELPER);
+    EdgePreparedRead *read = (EdgePreparedRead *) arg;
+    uint64_t next = oc_get_time_us();
+
+    oc_mutex_lock(read->timerMutex);
+    while (read->running)
+    {
+        if (0 == read->queued)
+        {
+            oc_mutex_unlock(read->timerMutex);
+            queueCycle(read);
+            oc_mutex_lock(read->timerMutex);
+        }
+        else
+        {
+            /* The server or the queue is slower than the cycle, do not let cycles pile up */
+            EDGE_LOG(TAG, "Previous cycle is still queued, skipping this cycle.");
+        }
+
+        /* Fixed rate, a late cycle does not shift the following ones */
+        next += read->intervalUs;
+        uint64_t now = oc_get_time_us();
+        if (next < now)
+        {
+            next = now;
+        }
+        while (read->running && now < next)
+        {
+            oc_cond_wait_for(read->timerCond, read->timerMutex, next - now);
+            now = oc_get_time_us();
+        }
+    }
+    oc_mutex_unlock(read->timerMutex);
+    return NULL;
+}
+
+EdgeResult startPeriodicReadImpl(EdgePreparedRead *read, uint32_t intervalMs)
+{
+    EdgeResult result;
+    result.code = STATUS_PARAM_INVALID;
+    VERIFY_NON_NULL_MSG(read, "NULL prepared read received in startPeriodicRead\n", result);
+    COND_CHECK_MSG((0 == intervalMs), "Error: Interval of periodic read is 0\n", result);
+
+    oc_mutex_lock(read->timerMutex);
+    if (read->running)
+    {
+        oc_mutex_unlock(read->timerMutex);
+        result.code = STATUS_ALREADY_INIT;
+        return result;
+    }
+    read->intervalUs = (uint64_t) intervalMs * 1000;
+    read->running = true;
+    oc_mutex_unlock(read->timerMutex);
+
+    if (OC_THREAD_SUCCESS != oc_thread_new(&read->timer, periodicReadHandler, read))
+    {
+        EDGE_LOG(TAG, "Failed to start the periodic read thread.");
+        oc_mutex_lock(read->timerMutex);
+        read->running = false;
+        oc_mutex_unlock(read->timerMutex);
+        read->timer = NULL;
+        result.code = STATUS_ERROR;
+        return result;
+    }
+    result.code = STATUS_OK;
+    return result;
+}
+
+void stopPeriodicReadImpl(EdgePreparedRead *read)
+{
+    VERIFY_NON_NULL_NR_MSG(read, "NULL prepared read received in stopPeriodicRead\n");
+
+    oc_mutex_lock(read->timerMutex);
+    read->running = false;
+    oc_cond_signal(read->timerCond);
+    oc_mutex_unlock(read->timerMutex);
+
+    if (IS_NOT_NULL(read->timer))
+    {
+        oc_thread_wait(read->timer);
+        oc_thread_free(read->timer);
+        read->timer = NULL;
+    }
+}
+
+void destroyPreparedReadImpl(EdgePreparedRead *read)
+{
+    VERIFY_NON_NULL_NR_MSG(read, "NULL prepared read received in destroyPreparedRead\n");
+    stopPeriodicReadImpl(read);
+
+    pthread_mutex_lock(&preparedReadMutex);
+    removeEdgeHashMapElement(preparedReadMap, PREPARED_READ_KEY(read->id), NULL);
+    if (IS_NOT_NULL(preparedReadMap) && 0 == getEdgeHashMapSize(preparedReadMap))
+    {
+        deleteEdgeHashMap(preparedReadMap);
+        preparedReadMap = NULL;
+    }
+    pthread_mutex_unlock(&preparedReadMutex);
+
+    /* Not reachable by new cycles anymore, wait for the one being executed */
+    pthread_mutex_lock(&read->lock);
+    pthread_mutex_unlock(&read->lock);
+    freePreparedRead(read);
+}
+
+EdgeResult executePreparedRead(UA_Client *client, const EdgeMessage *msg)
+{
+    EdgeResult result;
+    result.code = STATUS_PARAM_INVALID;
+    VERIFY_NON_NULL_MSG(msg, "NULL message received in executePreparedRead\n", result);
+
+    pthread_mutex_lock(&preparedReadMutex);
+    EdgePreparedRead *read = (EdgePreparedRead *) getEdgeHashMapElement(preparedReadMap,
+            PREPARED_READ_KEY(EDGE_MESSAGE_BLOCK(msg)->preparedId));
+    if (IS_NOT_NULL(read))
+    {
+        pthread_mutex_lock(&read->lock);
+    }
+    pthread_mutex_unlock(&preparedReadMutex);
+
+    if (IS_NULL(read))
+    {
+        /* Destroyed while the cycle was queued */
+        EDGE_LOG_V(TAG, "Prepared read %u does not exist anymore.\n", EDGE_MESSAGE_BLOCK(msg)->preparedId);
+        result.code = STATUS_OK;
+        return result;
+    }
+
+    oc_mutex_lock(read->timerMutex);
+    if (read->queued > 0)
+    {
+        read->queued--;
+    }
+    oc_mutex_unlock(read->timerMutex);
+
+    if (IS_NULL(client))
+    {
+        /* Not connected, the next cycle tries again */
+        EDGE_LOG(TAG, "Client param is NULL in executePreparedRead");
+        pthread_mutex_unlock(&read->lock);
+        result.code = STATUS_ERROR;
+        return result;
+    }
+
+    if (read->client != client)
+    {
+        /* First cycle of this session, registered nodes resolve to the NodeIds of the session */
+        deleteReadValueIds(read->rv, read->msg->requestLength);
+        read->rv = createReadValueIds(client, read->msg, read->attributeId);
+        read->client = IS_NOT_NULL(read->rv) ? client : NULL;
+    }
+
+    if (IS_NULL(read->rv))
+    {
+        EDGE_LOG(TAG, "Memory allocation failed.");
+        sendErrorResponse(read->msg, "Memory allocation failed.");
+        result.code = STATUS_ERROR;
+    }
+    else
+    {
+        readValueIds(client, read->msg, read->attributeId, read->rv);
+        result.code = STATUS_OK;
+    }
+    pthread_mutex_unlock(&read->lock);
+    return result;
+}
+
+void resetPreparedReads(UA_Client *client)
+{
+    pthread_mutex_lock(&preparedReadMutex);
+    size_t cursor = 0;
+    keyValue key = NULL, value = NULL;
+    while (getNextEdgeHashMapElement(preparedReadMap, &cursor, &key, &value))
+    {
+        EdgePreparedRead *read = (EdgePreparedRead *) value;
+        /* Queued cycles may be dropped with the queue when the session ends */
+        oc_mutex_lock(read->timerMutex);
+        read->queued = 0;
+        oc_mutex_unlock(read->timerMutex);
+        pthread_mutex_lock(&read->lock);
+        if (read->client == client)
+        {
+            deleteReadValueIds(read->rv, read->msg->requestLength);
+            read->rv = NULL;
+            read->client = NULL;
+        }
+        pthread_mutex_unlock(&read->lock);
+    }
+    pthread_mutex_unlock(&preparedReadMutex);
+}
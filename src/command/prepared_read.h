@@ -0,0 +1,102 @@
+/******************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ *
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************/
+
+/**
+ * @file prepared_read.h
+ *
+ * @brief This file contains the definition, types and APIs for prepared read requests.
+ */
+
+#ifndef EDGE_PREPARED_READ_H
+#define EDGE_PREPARED_READ_H
+
+#include "opcua_common.h"
+#include "open62541.h"
+
+#include "edge_utils.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/**
+ * @brief Prepares a read request so that it can be executed repeatedly
+ * @param[in]  msg EdgeMessage read request data. It is copied once, so the caller keeps ownership.
+ * @return Prepared read on success, otherwise NULL.
+ */
+EdgePreparedRead *createPreparedReadImpl(EdgeMessage *msg);
+
+/**
+ * @brief Queues one cycle of a prepared read
+ * @param[in]  read Prepared read
+ * @return @c EdgeResult code is 0 on success, otherwise an error value
+ * @retval #STATUS_OK Successful
+ * @retval #STATUS_PARAM_INVALID Invalid parameter
+ * @retval #STATUS_ENQUEUE_ERROR Send queue did not accept the request
+ */
+EdgeResult sendPreparedReadImpl(EdgePreparedRead *read);
+
+/**
+ * @brief Starts queueing a cycle of a prepared read every intervalMs milliseconds
+ * @param[in]  read Prepared read
+ * @param[in]  intervalMs Cycle time in milliseconds
+ * @return @c EdgeResult code is 0 on success, otherwise an error value
+ * @retval #STATUS_OK Successful
+ * @retval #STATUS_PARAM_INVALID Invalid parameter
+ * @retval #STATUS_ALREADY_INIT Periodic read is already running
+ * @retval #STATUS_ERROR Operation failed
+ */
+EdgeResult startPeriodicReadImpl(EdgePreparedRead *read, uint32_t intervalMs);
+
+/**
+ * @brief Stops the periodic read started by startPeriodicReadImpl()
+ * @param[in]  read Prepared read
+ */
+void stopPeriodicReadImpl(EdgePreparedRead *read);
+
+/**
+ * @brief Stops and deallocates a prepared read. Cycles which are still queued are dropped.
+ * @param[in]  read Prepared read
+ */
+void destroyPreparedReadImpl(EdgePreparedRead *read);
+
+/**
+ * @brief Executes a cycle of a prepared read queued by sendPreparedReadImpl() or the periodic read
+ * @param[in]  client Client Handle.
+ * @param[in]  msg Cycle message, its preparedId identifies the prepared read
+ * @return @c EdgeResult code is 0 on success, otherwise an error value
+ * @retval #STATUS_OK Successful
+ * @retval #STATUS_PARAM_INVALID Invalid parameter
+ * @retval #STATUS_ERROR Operation failed
+ */
+EdgeResult executePreparedRead(UA_Client *client, const EdgeMessage *msg);
+
+/**
+ * @brief Drops the nodes to read that prepared reads built for a client, called when its session ends
+ * @param[in]  client Client Handle.
+ */
+void resetPreparedReads(UA_Client *client);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // EDGE_PREPARED_READ_H
@@ -23,8 +23,16 @@
 #include "common_client.h"
 #include "message_dispatcher.h"
 #include "edge_logger.h"
+#include "edge_trace.h"
+#include "edge_client_stats.h"
 #include "edge_malloc.h"
 #include "edge_open62541.h"
+#include "value_cache.h"
+#include "register_nodes.h"
+#include "prepared_read.h"
+#include "async_service.h"
+#include "server_capabilities.h"
+#include "read_share.h"
 
 #include <inttypes.h>
 
@@ -158,73 +166,216 @@ static void *checkValidation(UA_DataValue *value, const EdgeMessage *msg, UA_Tim
 #endif // CTT_ENABLED
 
 /**
- * @brief readGroup - Executes read operation of single/group nodes
+ * @brief readInChunks - Splits a read request into requests of at most maxNodes nodes
+ * and merges their results into one response
+ * @param client - Client handle
+ * @param request - Read request with all the nodes to read
+ * @param maxNodes - Maximum number of nodes per request
+ * @return Read response with one result per node of the request
+ */
+static UA_ReadResponse readInChunks(UA_Client *client, const UA_ReadRequest *request, size_t maxNodes)
+{
+    UA_ReadResponse response;
+    UA_ReadResponse_init(&response);
+    size_t total = request->nodesToReadSize;
+    response.results = (UA_DataValue *) UA_Array_new(total, &UA_TYPES[UA_TYPES_DATAVALUE]);
+    if (IS_NULL(response.results))
+    {
+        response.responseHeader.serviceResult = UA_STATUSCODE_BADOUTOFMEMORY;
+        return response;
+    }
+    response.resultsSize = total;
+
+    UA_ReadRequest chunkRequest = *request;
+    for (size_t offset = 0; offset < total; offset += maxNodes)
+    {
+        size_t count = (total - offset < maxNodes) ? (total - offset) : maxNodes;
+        chunkRequest.nodesToRead = request->nodesToRead + offset;
+        chunkRequest.nodesToReadSize = count;
+        EDGE_LOG_V(TAG, "[READGROUP] Reading nodes %d to %d\n", (int) offset, (int) (offset + count - 1));
+
+        UA_ReadResponse chunkResponse = UA_Client_Service_read(client, chunkRequest);
+        UA_StatusCode serviceResult = chunkResponse.responseHeader.serviceResult;
+        if (serviceResult == UA_STATUSCODE_GOOD && chunkResponse.resultsSize != count)
+        {
+            serviceResult = UA_STATUSCODE_BADUNEXPECTEDERROR;
+        }
+        if (serviceResult != UA_STATUSCODE_GOOD)
+        {
+            UA_ReadResponse_deleteMembers(&chunkResponse);
+            UA_ReadResponse_deleteMembers(&response);
+            response.responseHeader.serviceResult = serviceResult;
+            return response;
+        }
+
+        /* Take over the results of the chunk */
+        memcpy(response.results + offset, chunkResponse.results, count * sizeof(UA_DataValue));
+        UA_free(chunkResponse.results);
+        chunkResponse.results = NULL;
+        chunkResponse.resultsSize = 0;
+        UA_ReadResponse_deleteMembers(&chunkResponse);
+    }
+    return response;
+}
+
+/**
+ * @brief getReadAttributeId - Gets the attribute to read for a request
+ * @param request - Request of the read message
+ * @param attributeId - Attribute Id of the read message
+ * @return Attribute Id of the request if it has one, otherwise attributeId
+ */
+static UA_UInt32 getReadAttributeId(const EdgeRequest *request, UA_UInt32 attributeId)
+{
+    return (request->attributeId > 0) ? (UA_UInt32) request->attributeId : attributeId;
+}
+
+#ifdef ENABLE_VALUE_CACHE
+/**
+ * @brief readFromValueCache - Serves a read of values from the session's value cache
  * @param client - Client handle
  * @param msg - Request edge message
- * @param attributeId - Attribute Id to read
+ * @param response - Receives one result per request on success
+ * @return true if every node had a value younger than msg->maxAge, false otherwise
  */
-static void readGroup(UA_Client *client, const EdgeMessage *msg, UA_UInt32 attributeId)
+static bool readFromValueCache(UA_Client *client, const EdgeMessage *msg, UA_ReadResponse *response)
 {
-    char errorDesc[ERROR_DESC_LENGTH] = {'\0'};
-    EdgeMessage *resultMsg = NULL;
     size_t reqLen = msg->requestLength;
-    UA_ReadValueId *rv = (UA_ReadValueId *) EdgeMalloc(sizeof(UA_ReadValueId) * reqLen);
-    if(IS_NULL(rv))
+    for (size_t i = 0; i < reqLen; i++)
     {
-        EDGE_LOG(TAG, "Memory allocation failed.");
-        sendErrorResponse(msg, "Memory allocation failed.");
-        return;
+        /* Only values are cached */
+        COND_CHECK((UA_ATTRIBUTEID_VALUE != getReadAttributeId(msg->requests[i], UA_ATTRIBUTEID_VALUE)),
+                false);
     }
 
+    UA_ReadResponse_init(response);
+    response->results = (UA_DataValue *) UA_Array_new(reqLen, &UA_TYPES[UA_TYPES_DATAVALUE]);
+    COND_CHECK(IS_NULL(response->results), false);
+    response->resultsSize = reqLen;
+
     for (size_t i = 0; i < reqLen; i++)
     {
-        EDGE_LOG_V(TAG, "[READGROUP] Node to read :: %s [ns : %d]\n", msg->requests[i]->nodeInfo->valueAlias,
-                msg->requests[i]->nodeInfo->nodeId->nameSpace);
-        UA_ReadValueId_init(&rv[i]);
-        rv[i].attributeId = attributeId;
-        rv[i].nodeId = UA_NODEID_STRING_ALLOC(msg->requests[i]->nodeInfo->nodeId->nameSpace,
-                msg->requests[i]->nodeInfo->valueAlias);
+        if (!getCachedValue(client, msg->requests[i]->nodeInfo->nodeId->nameSpace,
+                msg->requests[i]->nodeInfo->valueAlias, msg->maxAge, &response->results[i]))
+        {
+            UA_ReadResponse_deleteMembers(response);
+            UA_ReadResponse_init(response);
+            return false;
+        }
     }
+    EDGE_LOG_V(TAG, "[READGROUP] %d nodes served from the value cache\n", (int) reqLen);
+    return true;
+}
 
-    UA_ReadRequest readRequest;
-    UA_ReadRequest_init(&readRequest);
-    /* Nodes information to read */
-    readRequest.nodesToRead = rv;
-    /* Number of nodes to read */
-    readRequest.nodesToReadSize = reqLen;
+/**
+ * @brief storeInValueCache - Stores the values of a successful read in the session's value cache
+ * @param client - Client handle
+ * @param msg - Request edge message
+ * @param response - Read response with one result per request
+ */
+static void storeInValueCache(UA_Client *client, const EdgeMessage *msg,
+        const UA_ReadResponse *response)
+{
+    for (size_t i = 0; i < msg->requestLength && i < response->resultsSize; i++)
+    {
+        if (response->results[i].status == UA_STATUSCODE_GOOD
+                && UA_ATTRIBUTEID_VALUE == getReadAttributeId(msg->requests[i], UA_ATTRIBUTEID_VALUE))
+        {
+            putCachedValue(client, msg->requests[i]->nodeInfo->nodeId->nameSpace,
+                    msg->requests[i]->nodeInfo->valueAlias, &response->results[i]);
+        }
+    }
+}
+#endif
 
-    /* Max age */
-    #ifdef CTT_ENABLED
-        readRequest.maxAge = 2000;
-    #else
-        readRequest.maxAge = 0;
-    #endif
+UA_ReadValueId *createReadValueIds(UA_Client *client, const EdgeMessage *msg, UA_UInt32 attributeId)
+{
+    size_t reqLen = msg->requestLength;
+    UA_ReadValueId *rv = (UA_ReadValueId *) EdgeMalloc(sizeof(UA_ReadValueId) * reqLen);
+    VERIFY_NON_NULL_MSG(rv, "EdgeMalloc FAILED for UA_ReadValueId in createReadValueIds\n", NULL);
 
-    /* Timestamp information requested from server */
-    readRequest.timestampsToReturn = UA_TIMESTAMPSTORETURN_BOTH;
+    for (size_t i = 0; i < reqLen; i++)
+    {
+        EDGE_LOG_V(TAG, "[READGROUP] Node to read :: %s [ns : %d]\n", msg->requests[i]->nodeInfo->valueAlias,
+                msg->requests[i]->nodeInfo->nodeId->nameSpace);
+        UA_ReadValueId_init(&rv[i]);
+        rv[i].attributeId = getReadAttributeId(msg->requests[i], attributeId);
+        const UA_NodeId *registered = getRegisteredNodeId(client,
+                msg->requests[i]->nodeInfo->nodeId->nameSpace, msg->requests[i]->nodeInfo->valueAlias);
+        if (IS_NOT_NULL(registered))
+        {
+            UA_NodeId_copy(registered, &rv[i].nodeId);
+        }
+        else
+        {
+            rv[i].nodeId = UA_NODEID_STRING_ALLOC(msg->requests[i]->nodeInfo->nodeId->nameSpace,
+                    msg->requests[i]->nodeInfo->valueAlias);
+        }
+    }
+    return rv;
+}
 
-    //UA_RequestHeader_init(&(readRequest.requestHeader));
-    //readRequest.requestHeader.returnDiagnostics = 1;
+void deleteReadValueIds(UA_ReadValueId *rv, size_t length)
+{
+    if (IS_NULL(rv))
+    {
+        return;
+    }
+    for (size_t i = 0; i < length; i++)
+    {
+        UA_ReadValueId_deleteMembers(&rv[i]);
+    }
+    EdgeFree(rv);
+}
 
-    UA_ReadResponse readResponse = UA_Client_Service_read(client, readRequest);
+/**
+ * @brief processReadResponse - Queues the response message of a read request
+ * @param client - Client handle
+ * @param msg - Request edge message
+ * @param attributeId - Attribute Id read
+ * @param readRequest - Read request, only its scalar members are used
+ * @param readResponse - Read response, it is not deallocated but large array values may be
+ * handed over to the responses, see takeResponse()
+ * @param cached - Whether the values come from the value cache or are stored in it already
+ */
+static void processReadResponse(UA_Client *client, const EdgeMessage *msg, UA_UInt32 attributeId,
+        const UA_ReadRequest *readRequest, UA_ReadResponse *readResponse, bool cached)
+{
+    char errorDesc[ERROR_DESC_LENGTH] = {'\0'};
+    EdgeMessage *resultMsg = NULL;
+    size_t reqLen = msg->requestLength;
 
-    if (readResponse.responseHeader.serviceResult != UA_STATUSCODE_GOOD)
+    if (readResponse->responseHeader.serviceResult != UA_STATUSCODE_GOOD)
     {
         /* Error response in processing read request */
-        EDGE_LOG_V(TAG, "Error in group read :: 0x%08x(%s)\n", readResponse.responseHeader.serviceResult,
-                UA_StatusCode_name(readResponse.responseHeader.serviceResult));
+        EDGE_LOG_V(TAG, "Error in group read :: 0x%08x(%s)\n", readResponse->responseHeader.serviceResult,
+                UA_StatusCode_name(readResponse->responseHeader.serviceResult));
+        strncpy(errorDesc, "Error in read.", ERROR_DESC_LENGTH);
+        goto EXIT;
+    }
+
+    if (reqLen != readResponse->resultsSize)
+    {
+        EDGE_LOG_V(TAG, "Requested(%d) but received(%d) results\n", (int) reqLen,
+                (int) readResponse->resultsSize);
         strncpy(errorDesc, "Error in read.", ERROR_DESC_LENGTH);
         goto EXIT;
     }
 
+#ifdef ENABLE_VALUE_CACHE
+    if (UA_ATTRIBUTEID_VALUE == attributeId && !cached)
+    {
+        storeInValueCache(client, msg, readResponse);
+    }
+#endif
+
 #ifdef CTT_ENABLED
-    if (readResponse.results[0].status == UA_STATUSCODE_GOOD)
+    if (readResponse->results[0].status == UA_STATUSCODE_GOOD)
     {
         if(UA_ATTRIBUTEID_VALUE == attributeId) {
-            if (readRequest.timestampsToReturn == UA_TIMESTAMPSTORETURN_NEITHER)
+            if (readRequest->timestampsToReturn == UA_TIMESTAMPSTORETURN_NEITHER)
             {
-                if (readResponse.results[0].hasSourceTimestamp
-                        || readResponse.results[0].hasServerTimestamp)
+                if (readResponse->results[0].hasSourceTimestamp
+                        || readResponse->results[0].hasServerTimestamp)
                 {
                     /* Invalid timestamp error */
                     EDGE_LOG(TAG, "BadInvalidTimestamp\n\n");
@@ -232,10 +383,10 @@ static void readGroup(UA_Client *client, const EdgeMessage *msg, UA_UInt32 attri
                     goto EXIT;
                 }
             }
-            else if (readRequest.timestampsToReturn == UA_TIMESTAMPSTORETURN_BOTH)
+            else if (readRequest->timestampsToReturn == UA_TIMESTAMPSTORETURN_BOTH)
             {
-                if (!readResponse.results[0].hasSourceTimestamp
-                        || !readResponse.results[0].hasServerTimestamp)
+                if (!readResponse->results[0].hasSourceTimestamp
+                        || !readResponse->results[0].hasServerTimestamp)
                 {
                     /* Missing timestamp information in response */
                     EDGE_LOG(TAG, "Timestamp missing\n\n");
@@ -243,10 +394,10 @@ static void readGroup(UA_Client *client, const EdgeMessage *msg, UA_UInt32 attri
                     goto EXIT;
                 }
             }
-            else if (readRequest.timestampsToReturn == UA_TIMESTAMPSTORETURN_SOURCE)
+            else if (readRequest->timestampsToReturn == UA_TIMESTAMPSTORETURN_SOURCE)
             {
-                if (!readResponse.results[0].hasSourceTimestamp
-                        || readResponse.results[0].hasServerTimestamp)
+                if (!readResponse->results[0].hasSourceTimestamp
+                        || readResponse->results[0].hasServerTimestamp)
                 {
                     /* Source timestamp requested. But source timestamp missing in response */
                     EDGE_LOG(TAG, "source Timestamp missing\n\n");
@@ -254,10 +405,10 @@ static void readGroup(UA_Client *client, const EdgeMessage *msg, UA_UInt32 attri
                     goto EXIT;
                 }
             }
-            else if (readRequest.timestampsToReturn == UA_TIMESTAMPSTORETURN_SERVER)
+            else if (readRequest->timestampsToReturn == UA_TIMESTAMPSTORETURN_SERVER)
             {
-                if (readResponse.results[0].hasSourceTimestamp
-                        || !readResponse.results[0].hasServerTimestamp)
+                if (readResponse->results[0].hasSourceTimestamp
+                        || !readResponse->results[0].hasServerTimestamp)
                 {
                     /* Server timestamp requested. But server timestamp missing in response */
                     EDGE_LOG(TAG, "server Timestamp missing\n\n");
@@ -266,9 +417,9 @@ static void readGroup(UA_Client *client, const EdgeMessage *msg, UA_UInt32 attri
                 }
             }
 
-            if (readRequest.timestampsToReturn != UA_TIMESTAMPSTORETURN_NEITHER
-                    && !checkMaxAge(readResponse.results[0].serverTimestamp, UA_DateTime_now(),
-                            readRequest.maxAge * 2))
+            if (readRequest->timestampsToReturn != UA_TIMESTAMPSTORETURN_NEITHER
+                    && !checkMaxAge(readResponse->results[0].serverTimestamp, UA_DateTime_now(),
+                            readRequest->maxAge * 2))
             {
                 /* MaxAge error */
                 EDGE_LOG(TAG, "Max age failed\n\n");
@@ -276,9 +427,9 @@ static void readGroup(UA_Client *client, const EdgeMessage *msg, UA_UInt32 attri
                 goto EXIT;
             }
 
-            if (readRequest.timestampsToReturn != UA_TIMESTAMPSTORETURN_NEITHER
-                    && !checkValidation(&(readResponse.results[0]), msg, readRequest.timestampsToReturn,
-                            readRequest.maxAge))
+            if (readRequest->timestampsToReturn != UA_TIMESTAMPSTORETURN_NEITHER
+                    && !checkValidation(&(readResponse->results[0]), msg, readRequest->timestampsToReturn,
+                            readRequest->maxAge))
             {
                 strncpy(errorDesc, "", ERROR_DESC_LENGTH);
                 goto EXIT;
@@ -287,7 +438,7 @@ static void readGroup(UA_Client *client, const EdgeMessage *msg, UA_UInt32 attri
     }
 #endif // CTT_ENABLED
 
-    resultMsg = (EdgeMessage *) EdgeCalloc(1, sizeof(EdgeMessage));
+    resultMsg = allocEdgeMessage();
     if(IS_NULL(resultMsg))
     {
         EDGE_LOG(TAG, "Error : Malloc failed for resultMsg in Read Group\n");
@@ -311,7 +462,7 @@ static void readGroup(UA_Client *client, const EdgeMessage *msg, UA_UInt32 attri
     }
     resultMsg->type = GENERAL_RESPONSE;
     resultMsg->message_id = msg->message_id;
-    resultMsg->endpointInfo = cloneEdgeEndpointInfo(msg->endpointInfo);
+    setMessageEndpointInfo(resultMsg, shareMessageEndpointInfo(msg));
     if(IS_NULL(resultMsg->endpointInfo))
     {
         EDGE_LOG(TAG, "Error : EdgeCalloc failed for resultMsg.endpointInfo in Read Group\n");
@@ -322,10 +473,8 @@ static void readGroup(UA_Client *client, const EdgeMessage *msg, UA_UInt32 attri
     int respIndex = 0;
     for (int i = 0; i < reqLen; i++)
     {
-        if (readResponse.results[i].status == UA_STATUSCODE_GOOD)
+        if (readResponse->results[i].status == UA_STATUSCODE_GOOD)
         {
-            UA_Variant val = readResponse.results[i].value;
-
             EdgeResponse *response = (EdgeResponse *) EdgeCalloc(1, sizeof(EdgeResponse));
             if (IS_NULL(response))
             {
@@ -344,7 +493,8 @@ static void readGroup(UA_Client *client, const EdgeMessage *msg, UA_UInt32 attri
             }
 
             response->requestId = msg->requests[i]->requestId;
-            response->message = parseResponse(response, val);
+            response->attributeId = getReadAttributeId(msg->requests[i], attributeId);
+            response->message = takeResponse(response, &readResponse->results[i].value);
             if (IS_NULL(response->message))
             {
                 freeEdgeResponse(response);
@@ -353,8 +503,8 @@ static void readGroup(UA_Client *client, const EdgeMessage *msg, UA_UInt32 attri
 
             /* Check for diagnostic information in read response */
             response->m_diagnosticInfo = checkDiagnosticInfo(msg->requestLength,
-                    readResponse.diagnosticInfos, readResponse.diagnosticInfosSize,
-                    readRequest.requestHeader.returnDiagnostics);
+                    readResponse->diagnosticInfos, readResponse->diagnosticInfosSize,
+                    readRequest->requestHeader.returnDiagnostics);
 
             resultMsg->responseLength++;
             resultMsg->responses[respIndex++] = response;
@@ -363,7 +513,7 @@ static void readGroup(UA_Client *client, const EdgeMessage *msg, UA_UInt32 attri
         {
             /* Error in read response for a particular node */
             EDGE_LOG_V(TAG, "Error in group read response for particular node :: 0x%08x(%s)\n",
-                    readResponse.results[i].status, UA_StatusCode_name(readResponse.results[i].status));
+                    readResponse->results[i].status, UA_StatusCode_name(readResponse->results[i].status));
             if(1 == reqLen)
             {
                 // Error response for the node(only one) in the given read request.
@@ -383,32 +533,176 @@ static void readGroup(UA_Client *client, const EdgeMessage *msg, UA_UInt32 attri
     }
     /* Adding the read response to receiver Q */
     add_to_recvQ(resultMsg);
-    for (size_t i = 0; i < reqLen; i++)
-    {
-        UA_NodeId_deleteMembers(&rv[i].nodeId);
-    }
-    UA_ReadValueId_deleteMembers(rv);
-    EdgeFree(rv);
-    UA_ReadResponse_deleteMembers(&readResponse);
     return;
 
     EXIT:
     /* Free the memory */
     sendErrorResponse(msg, errorDesc);
     freeEdgeMessage(resultMsg);
-    for (size_t i = 0; i < reqLen; i++)
+}
+
+/**
+ * @brief answerSharedReads - Queues the responses of the reads which joined a read in flight
+ * @param client - Client handle the read was sent with
+ * @param shareKey - Key of the read from shareRead(), it is freed. NULL if it is not shared.
+ * @param attributeId - Attribute Id read
+ * @param readRequest - Read request, only its scalar members are used
+ * @param readResponse - Read response, it is not modified
+ */
+static void answerSharedReads(UA_Client *client, char *shareKey, UA_UInt32 attributeId,
+        const UA_ReadRequest *readRequest, const UA_ReadResponse *readResponse)
+{
+    EdgeMessage **readers = NULL;
+    size_t count = completeSharedRead(client, shareKey, &readers);
+    for (size_t i = 0; i < count; i++)
     {
-        UA_NodeId_deleteMembers(&rv[i].nodeId);
+        /* Each reader may take the values of its own copy */
+        UA_ReadResponse copy;
+        if (UA_STATUSCODE_GOOD != UA_ReadResponse_copy(readResponse, &copy))
+        {
+            sendErrorResponse(readers[i], "Memory allocation failed.");
+            continue;
+        }
+        processReadResponse(client, readers[i], attributeId, readRequest, &copy, true);
+        UA_ReadResponse_deleteMembers(&copy);
     }
-    UA_ReadValueId_deleteMembers(rv);
-    EdgeFree(rv);
+    releaseSharedReaders(readers, count);
+}
+
+#ifdef ENABLE_ASYNC_SERVICES
+/* Handler data of an asynchronous read */
+typedef struct EdgeAsyncRead
+{
+    UA_UInt32 attributeId;
+    UA_ReadRequest request;
+    /* Key of the read if it is shared, see shareRead() */
+    char *shareKey;
+} EdgeAsyncRead;
+
+static void asyncReadHandler(UA_Client *client, const EdgeMessage *msg, const void *data,
+        void *response)
+{
+    const EdgeAsyncRead *asyncRead = (const EdgeAsyncRead *) data;
+    answerSharedReads(client, asyncRead->shareKey, asyncRead->attributeId, &asyncRead->request,
+            (UA_ReadResponse *) response);
+    processReadResponse(client, msg, asyncRead->attributeId, &asyncRead->request,
+            (UA_ReadResponse *) response, false);
+}
+#endif
+
+void readValueIds(UA_Client *client, const EdgeMessage *msg, UA_UInt32 attributeId, UA_ReadValueId *rv)
+{
+    size_t reqLen = msg->requestLength;
+
+    UA_ReadRequest readRequest;
+    UA_ReadRequest_init(&readRequest);
+    /* Nodes information to read */
+    readRequest.nodesToRead = rv;
+    /* Number of nodes to read */
+    readRequest.nodesToReadSize = reqLen;
+
+    /* Max age */
+    #ifdef CTT_ENABLED
+        readRequest.maxAge = 2000;
+    #else
+        readRequest.maxAge = msg->maxAge;
+    #endif
+
+    /* Timestamp information requested from server */
+    readRequest.timestampsToReturn = UA_TIMESTAMPSTORETURN_BOTH;
+
+    //UA_RequestHeader_init(&(readRequest.requestHeader));
+    //readRequest.requestHeader.returnDiagnostics = 1;
+
+    UA_ReadResponse readResponse;
+    UA_ReadResponse_init(&readResponse);
+    bool cached = false;
+#ifdef ENABLE_VALUE_CACHE
+    /* Values younger than maxAge in the value cache save the round trip */
+    cached = (UA_ATTRIBUTEID_VALUE == attributeId && msg->maxAge > 0 &&
+            readFromValueCache(client, msg, &readResponse));
+#endif
+    char *shareKey = NULL;
+    if (!cached && shareRead(client, msg, attributeId, &shareKey))
+    {
+        /* Answered with the response of the identical read in flight */
+        return;
+    }
+    if (!cached)
+    {
+        /* Servers reject requests above their MaxNodesPerRead, larger groups are read in chunks */
+        EdgeServerCapabilities capabilities;
+        getServerCapabilities(client, &capabilities);
+        size_t maxNodesPerRead = capabilities.maxNodesPerRead;
+        if (maxNodesPerRead > 0 && reqLen > maxNodesPerRead)
+        {
+            uint64_t startUs = getClientServiceTime();
+            EDGE_TRACE_BEGIN(msg, EDGE_TRACE_STAGE_SERVICE);
+            readResponse = readInChunks(client, &readRequest, maxNodesPerRead);
+            EDGE_TRACE_END(msg, EDGE_TRACE_STAGE_SERVICE);
+            recordClientService(client, msg->command, startUs,
+                    readResponse.responseHeader.serviceResult);
+        }
+        else
+        {
+#ifdef ENABLE_ASYNC_SERVICES
+            /* The response is processed by asyncReadHandler, only scalar members are kept for it */
+            EdgeAsyncRead asyncRead;
+            asyncRead.attributeId = attributeId;
+            asyncRead.request = readRequest;
+            asyncRead.request.nodesToRead = NULL;
+            asyncRead.request.nodesToReadSize = 0;
+            asyncRead.shareKey = shareKey;
+            if (sendAsyncService(client, msg, &readRequest, &UA_TYPES[UA_TYPES_READREQUEST],
+                    &UA_TYPES[UA_TYPES_READRESPONSE], asyncReadHandler, &asyncRead, sizeof(asyncRead)))
+            {
+                return;
+            }
+#endif
+            uint64_t startUs = getClientServiceTime();
+            EDGE_TRACE_BEGIN(msg, EDGE_TRACE_STAGE_SERVICE);
+            readResponse = UA_Client_Service_read(client, readRequest);
+            EDGE_TRACE_END(msg, EDGE_TRACE_STAGE_SERVICE);
+            recordClientService(client, msg->command, startUs,
+                    readResponse.responseHeader.serviceResult);
+        }
+    }
+
+    EDGE_TRACE_BEGIN(msg, EDGE_TRACE_STAGE_RESPONSE);
+    answerSharedReads(client, shareKey, attributeId, &readRequest, &readResponse);
+    processReadResponse(client, msg, attributeId, &readRequest, &readResponse, cached);
+    EDGE_TRACE_END(msg, EDGE_TRACE_STAGE_RESPONSE);
     UA_ReadResponse_deleteMembers(&readResponse);
 }
 
+/**
+ * @brief readGroup - Executes read operation of single/group nodes
+ * @param client - Client handle
+ * @param msg - Request edge message
+ * @param attributeId - Attribute Id to read
+ */
+static void readGroup(UA_Client *client, const EdgeMessage *msg, UA_UInt32 attributeId)
+{
+    UA_ReadValueId *rv = createReadValueIds(client, msg, attributeId);
+    if(IS_NULL(rv))
+    {
+        EDGE_LOG(TAG, "Memory allocation failed.");
+        sendErrorResponse(msg, "Memory allocation failed.");
+        return;
+    }
+    readValueIds(client, msg, attributeId, rv);
+    deleteReadValueIds(rv, msg->requestLength);
+}
+
 EdgeResult executeRead(UA_Client *client, const EdgeMessage *msg)
 {
     EdgeResult result;
     result.code = STATUS_ERROR;
+    if (EDGE_MESSAGE_BLOCK(msg)->preparedId)
+    {
+        /* Cycle of a prepared read, the request was built by prepareRead() */
+        return executePreparedRead(client, msg);
+    }
     VERIFY_NON_NULL_MSG(client, "Client param is NULL in execute READ\n", result);
 
     if (CMD_READ == msg->command)
@@ -48,6 +48,33 @@ extern "C"
  */
 EdgeResult executeRead(UA_Client *client, const EdgeMessage *msg);
 
+/**
+ * @brief Builds the nodes to read of a read request message
+ * @param[in]  client Client Handle, registered nodes of its session are read by their registered NodeId.
+ * @param[in]  msg EdgeMessage read request data
+ * @param[in]  attributeId Attribute Id to read
+ * @return Array of msg->requestLength ReadValueIds on success, otherwise NULL.
+ *         Free it with deleteReadValueIds().
+ */
+UA_ReadValueId *createReadValueIds(UA_Client *client, const EdgeMessage *msg, UA_UInt32 attributeId);
+
+/**
+ * @brief Deallocates the nodes to read built by createReadValueIds()
+ * @param[in]  rv Nodes to read
+ * @param[in]  length Number of nodes to read
+ */
+void deleteReadValueIds(UA_ReadValueId *rv, size_t length);
+
+/**
+ * @brief Reads the nodes built by createReadValueIds() and queues the response of msg.
+ *        rv is not modified, so it can be read again in the next cycle.
+ * @param[in]  client Client Handle.
+ * @param[in]  msg EdgeMessage read request data the nodes were built from
+ * @param[in]  attributeId Attribute Id to read
+ * @param[in]  rv Nodes to read
+ */
+void readValueIds(UA_Client *client, const EdgeMessage *msg, UA_UInt32 attributeId, UA_ReadValueId *rv);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,250 @@
+/******************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ *
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************/
+
+
+#include "read_share.h"
+#include "cmd_util.h"
+#include "request_future.h"
+#include "edge_logger.h"
+#include "edge_malloc.h"
+#include "edge_open62541.h"
+#include "edge_hash_map.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#ifndef _WIN32
+#include <pthread.h>
+#else
+#include "pthread.h"
+#endif
+
+#define TAG "read_share"
+
+typedef struct sharedRead
+{
+    /* Key of the read, owned by the entry */
+    char *key;
+    /* Client which sent the read */
+    UA_Client *client;
+    /* Copies of the reads which wait for its response */
+    EdgeMessage **readers;
+    size_t count;
+    size_t capacity;
+} sharedRead;
+
+/* "endpoint|maxAge|ns:attribute:valueAlias|..." -> sharedRead */
+static EdgeHashMap *sharedReadMap = NULL;
+static bool readSharingEnabled = false;
+static pthread_mutex_t readShareMutex = PTHREAD_MUTEX_INITIALIZER;
+
+void setReadSharingImpl(bool enable)
+{
+    pthread_mutex_lock(&readShareMutex);
+    readSharingEnabled = enable;
+    pthread_mutex_unlock(&readShareMutex);
+}
+
+/**
+ * @brief createReadKey - Builds the key of a read from its endpoint, max age and nodes
+ * @param msg - Read request message
+ * @param attributeId - Attribute Id of the requests without their own attribute
+ * @return Key to be freed with EdgeFree(), NULL on error
+ */
+static char *createReadKey(const EdgeMessage *msg, UA_UInt32 attributeId)
+{
+    const char *endpoint = msg->endpointInfo->endpointUri;
+    size_t size = strlen(endpoint) + 32;
+    for (size_t i = 0; i < msg->requestLength; i++)
+    {
+        size += strlen(msg->requests[i]->nodeInfo->valueAlias) + 24;
+    }
+
+    char *key = (char *) EdgeMalloc(size);
+    VERIFY_NON_NULL_MSG(key, "EdgeMalloc FAILED for the read key\n", NULL);
+    int length = snprintf(key, size, "%s|%g", endpoint, msg->maxAge);
+    for (size_t i = 0; i < msg->requestLength && length > 0 && (size_t) length < size; i++)
+    {
+        const EdgeRequest *request = msg->requests[i];
+        UA_UInt32 attribute = (request->attributeId > 0) ? (UA_UInt32) request->attributeId : attributeId;
+        length += snprintf(key + length, size - length, "|%u:%u:%s",
+                (unsigned) request->nodeInfo->nodeId->nameSpace, (unsigned) attribute,
+                request->nodeInfo->valueAlias);
+    }
+    if (length < 0 || (size_t) length >= size)
+    {
+        EdgeFree(key);
+        return NULL;
+    }
+    return key;
+}
+
+static bool addReader(sharedRead *entry, const EdgeMessage *msg)
+{
+    if (entry->count == entry->capacity)
+    {
+        size_t capacity = (0 == entry->capacity) ? 4 : entry->capacity * 2;
+        EdgeMessage **readers = (EdgeMessage **) EdgeRealloc(entry->readers,
+                capacity * sizeof(EdgeMessage *));
+        VERIFY_NON_NULL_MSG(readers, "EdgeRealloc FAILED for the shared readers\n", false);
+        entry->readers = readers;
+        entry->capacity = capacity;
+    }
+    /* cloneEdgeMessage() does not modify the message */
+    EdgeMessage *copy = cloneEdgeMessage((EdgeMessage *) msg);
+    VERIFY_NON_NULL_MSG(copy, "Failed to copy the shared reader\n", false);
+    entry->readers[entry->count++] = copy;
+    /* The future of the reader waits for the response of the shared read */
+    holdRequestFuture(msg->message_id);
+    return true;
+}
+
+bool shareRead(UA_Client *client, const EdgeMessage *msg, UA_UInt32 attributeId, char **key)
+{
+    *key = NULL;
+    COND_CHECK((IS_NULL(client) || IS_NULL(msg) || 0 == msg->requestLength), false);
+
+    pthread_mutex_lock(&readShareMutex);
+    if (!readSharingEnabled)
+    {
+        pthread_mutex_unlock(&readShareMutex);
+        return false;
+    }
+    pthread_mutex_unlock(&readShareMutex);
+
+    char *readKey = createReadKey(msg, attributeId);
+    VERIFY_NON_NULL_MSG(readKey, "Failed to create the read key, it is not shared\n", false);
+
+    pthread_mutex_lock(&readShareMutex);
+    sharedRead *entry = (sharedRead *) getEdgeHashMapElement(sharedReadMap, readKey);
+    if (IS_NOT_NULL(entry))
+    {
+        bool joined = addReader(entry, msg);
+        pthread_mutex_unlock(&readShareMutex);
+        EdgeFree(readKey);
+        if (joined)
+        {
+            EDGE_LOG_V(TAG, "Read of message %u joined the read in flight\n", msg->message_id);
+        }
+        return joined;
+    }
+
+    if (IS_NULL(sharedReadMap))
+    {
+        sharedReadMap = createEdgeHashMap(EDGE_HASH_STRING_KEY);
+    }
+    /* The caller keeps its own copy, the entry may end before the response */
+    *key = cloneString(readKey);
+    entry = (sharedRead *) EdgeCalloc(1, sizeof(sharedRead));
+    if (IS_NOT_NULL(entry))
+    {
+        entry->key = readKey;
+        entry->client = client;
+    }
+    if (IS_NULL(*key) || IS_NULL(entry) || IS_NULL(sharedReadMap)
+            || !insertEdgeHashMapElement(sharedReadMap, entry->key, entry))
+    {
+        pthread_mutex_unlock(&readShareMutex);
+        EDGE_LOG(TAG, "Failed to register the read in flight, it is not shared.");
+        EdgeFree(*key);
+        *key = NULL;
+        EdgeFree(entry);
+        EdgeFree(readKey);
+        return false;
+    }
+    pthread_mutex_unlock(&readShareMutex);
+    return false;
+}
+
+/* Called with readShareMutex held */
+static void removeSharedRead(sharedRead *entry)
+{
+    removeEdgeHashMapElement(sharedReadMap, entry->key, NULL);
+    if (0 == getEdgeHashMapSize(sharedReadMap))
+    {
+        deleteEdgeHashMap(sharedReadMap);
+        sharedReadMap = NULL;
+    }
+    EdgeFree(entry->key);
+    EdgeFree(entry);
+}
+
+size_t completeSharedRead(UA_Client *client, char *key, EdgeMessage ***readers)
+{
+    *readers = NULL;
+    COND_CHECK((IS_NULL(key)), 0);
+
+    size_t count = 0;
+    pthread_mutex_lock(&readShareMutex);
+    sharedRead *entry = (sharedRead *) getEdgeHashMapElement(sharedReadMap, key);
+    /* A read of another client may have the key if the session of this one has ended */
+    if (IS_NOT_NULL(entry) && entry->client == client)
+    {
+        *readers = entry->readers;
+        count = entry->count;
+        removeSharedRead(entry);
+    }
+    pthread_mutex_unlock(&readShareMutex);
+    if (count > 0)
+    {
+        EDGE_LOG_V(TAG, "Response of the read is shared with %d reads\n", (int) count);
+    }
+    EdgeFree(key);
+    return count;
+}
+
+void releaseSharedReaders(EdgeMessage **readers, size_t count)
+{
+    for (size_t i = 0; i < count; i++)
+    {
+        finishRequestFuture(readers[i]->message_id);
+        freeEdgeMessage(readers[i]);
+    }
+    EdgeFree(readers);
+}
+
+void removeSharedReads(UA_Client *client)
+{
+    pthread_mutex_lock(&readShareMutex);
+    bool found = true;
+    while (found)
+    {
+        /* The map is not modified during an iteration, it starts again after a removal */
+        found = false;
+        size_t cursor = 0;
+        keyValue value = NULL;
+        while (getNextEdgeHashMapElement(sharedReadMap, &cursor, NULL, &value))
+        {
+            sharedRead *entry = (sharedRead *) value;
+            if (entry->client == client)
+            {
+                for (size_t i = 0; i < entry->count; i++)
+                {
+                    sendErrorResponse(entry->readers[i], "Session of the shared read ended.");
+                }
+                releaseSharedReaders(entry->readers, entry->count);
+                removeSharedRead(entry);
+                found = true;
+                break;
+            }
+        }
+    }
+    pthread_mutex_unlock(&readShareMutex);
+}
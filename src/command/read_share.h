@@ -0,0 +1,87 @@
+/******************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ *
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************/
+
+
+/**
+ * @file read_share.h
+ *
+ * @brief This file contains the sharing of identical read requests which are in flight.
+ */
+
+#ifndef EDGE_READ_SHARE_H
+#define EDGE_READ_SHARE_H
+
+#include "opcua_common.h"
+#include "open62541.h"
+
+#include "edge_utils.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/**
+ * @brief Enables sharing of identical reads. A read of the same nodes and attributes of an
+ *        endpoint as a read in flight is not sent, it receives the response of that read.
+ * @param[in]  enable true to share the reads, false to send each of them (default).
+ */
+void setReadSharingImpl(bool enable);
+
+/**
+ * @brief Shares a read which is about to be sent with an identical read in flight.
+ * @param[in]  client Client Handle.
+ * @param[in]  msg EdgeMessage read request data, it is copied if it joins a read.
+ * @param[in]  attributeId Attribute Id read for requests without their own attribute.
+ * @param[out] key Receives the key of the read if it is sent and shared by later reads,
+ *             otherwise NULL. Pass it to completeSharedRead() with the response.
+ * @return true if the read joined a read in flight and must not be sent.
+ */
+bool shareRead(UA_Client *client, const EdgeMessage *msg, UA_UInt32 attributeId, char **key);
+
+/**
+ * @brief Ends a shared read and takes the reads which joined it
+ * @param[in]  client Client Handle the read was sent with.
+ * @param[in]  key Key of the read returned by shareRead(), it is freed.
+ * @param[out] readers Receives the joined read messages, to be released with
+ *             releaseSharedReaders().
+ * @return Number of the joined read messages.
+ */
+size_t completeSharedRead(UA_Client *client, char *key, EdgeMessage ***readers);
+
+/**
+ * @brief Releases the read messages taken by completeSharedRead() after they are answered
+ * @param[in]  readers Joined read messages.
+ * @param[in]  count Number of the messages.
+ */
+void releaseSharedReaders(EdgeMessage **readers, size_t count);
+
+/**
+ * @brief Ends the shared reads of a client which is gone, the joined reads receive an error.
+ *        Called when its session ends.
+ * @param[in]  client Client Handle.
+ */
+void removeSharedReads(UA_Client *client);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // EDGE_READ_SHARE_H
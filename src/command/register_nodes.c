@@ -0,0 +1,357 @@
+/******************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ *
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************/
+
+#include "register_nodes.h"
+#include "cmd_util.h"
+#include "edge_logger.h"
+#include "edge_malloc.h"
+#include "edge_open62541.h"
+#include "edge_hash_map.h"
+#include "message_dispatcher.h"
+
+#ifndef _WIN32
+#include <pthread.h>
+#else
+#include "pthread.h"
+#endif
+
+#define TAG "register_nodes"
+
+/* Client handle -> map of "nsIndex;valueAlias" -> registered UA_NodeId */
+static EdgeHashMap *sessionNodeMap = NULL;
+static pthread_mutex_t registeredNodesMutex = PTHREAD_MUTEX_INITIALIZER;
+
+static void freeRegisteredNodes(EdgeHashMap *nodes)
+{
+    size_t cursor = 0;
+    keyValue key = NULL, value = NULL;
+    while (getNextEdgeHashMapElement(nodes, &cursor, &key, &value))
+    {
+        UA_NodeId_delete((UA_NodeId *) value);
+        EdgeFree(key);
+    }
+    deleteEdgeHashMap(nodes);
+}
+
+static bool storeRegisteredNodeId(UA_Client *client, const char *key, const UA_NodeId *nodeId)
+{
+    UA_NodeId *copy = UA_NodeId_new();
+    VERIFY_NON_NULL_MSG(copy, "UA_NodeId_new FAILED in storeRegisteredNodeId\n", false);
+    if (UA_NodeId_copy(nodeId, copy) != UA_STATUSCODE_GOOD)
+    {
+        UA_NodeId_delete(copy);
+        return false;
+    }
+
+    bool stored = false;
+    pthread_mutex_lock(&registeredNodesMutex);
+    if (IS_NULL(sessionNodeMap))
+    {
+        sessionNodeMap = createEdgeHashMap(EDGE_HASH_POINTER_KEY);
+    }
+    EdgeHashMap *nodes = (EdgeHashMap *) getEdgeHashMapElement(sessionNodeMap, (keyValue) client);
+    if (IS_NULL(nodes))
+    {
+        nodes = createEdgeHashMap(EDGE_HASH_STRING_KEY);
+        if (IS_NOT_NULL(nodes) && !insertEdgeHashMapElement(sessionNodeMap, (keyValue) client,
+                (keyValue) nodes))
+        {
+            deleteEdgeHashMap(nodes);
+            nodes = NULL;
+        }
+    }
+    if (IS_NOT_NULL(nodes))
+    {
+        /* Registering a node again replaces the previous NodeId */
+        keyValue storedKey = NULL;
+        UA_NodeId *previous = (UA_NodeId *) removeEdgeHashMapElement(nodes, (keyValue) key, &storedKey);
+        if (IS_NOT_NULL(previous))
+        {
+            UA_NodeId_delete(previous);
+        }
+        if (IS_NULL(storedKey))
+        {
+            storedKey = cloneString(key);
+        }
+        stored = (IS_NOT_NULL(storedKey) && insertEdgeHashMapElement(nodes, storedKey, (keyValue) copy));
+        if (!stored)
+        {
+            EdgeFree(storedKey);
+        }
+    }
+    pthread_mutex_unlock(&registeredNodesMutex);
+
+    if (!stored)
+    {
+        UA_NodeId_delete(copy);
+    }
+    return stored;
+}
+
+/* Removes the node from the registry and hands its NodeId to the caller, NULL if not registered */
+static UA_NodeId *takeRegisteredNodeId(UA_Client *client, const char *key)
+{
+    keyValue storedKey = NULL;
+    pthread_mutex_lock(&registeredNodesMutex);
+    EdgeHashMap *nodes = (EdgeHashMap *) getEdgeHashMapElement(sessionNodeMap, (keyValue) client);
+    UA_NodeId *nodeId = (UA_NodeId *) removeEdgeHashMapElement(nodes, (keyValue) key, &storedKey);
+    pthread_mutex_unlock(&registeredNodesMutex);
+    EdgeFree(storedKey);
+    return nodeId;
+}
+
+const UA_NodeId *getRegisteredNodeId(UA_Client *client, uint16_t nsIndex, const char *valueAlias)
+{
+    COND_CHECK((IS_NULL(client) || IS_NULL(valueAlias) || IS_NULL(sessionNodeMap)), NULL);
+    char key[EDGE_NODE_KEY_SIZE];
+    COND_CHECK(!formatNodeKey(nsIndex, valueAlias, key), NULL);
+
+    pthread_mutex_lock(&registeredNodesMutex);
+    EdgeHashMap *nodes = (EdgeHashMap *) getEdgeHashMapElement(sessionNodeMap, (keyValue) client);
+    const UA_NodeId *nodeId = (const UA_NodeId *) getEdgeHashMapElement(nodes, (keyValue) key);
+    pthread_mutex_unlock(&registeredNodesMutex);
+    return nodeId;
+}
+
+bool storeResolvedNodeId(UA_Client *client, uint16_t nsIndex, const char *valueAlias,
+        const UA_NodeId *nodeId)
+{
+    COND_CHECK((IS_NULL(client) || IS_NULL(valueAlias) || IS_NULL(nodeId)), false);
+    char key[EDGE_NODE_KEY_SIZE];
+    COND_CHECK(!formatNodeKey(nsIndex, valueAlias, key), false);
+    return storeRegisteredNodeId(client, key, nodeId);
+}
+
+void removeRegisteredNodes(UA_Client *client)
+{
+    pthread_mutex_lock(&registeredNodesMutex);
+    EdgeHashMap *nodes = (EdgeHashMap *) removeEdgeHashMapElement(sessionNodeMap,
+            (keyValue) client, NULL);
+    if (IS_NOT_NULL(sessionNodeMap) && 0 == getEdgeHashMapSize(sessionNodeMap))
+    {
+        deleteEdgeHashMap(sessionNodeMap);
+        sessionNodeMap = NULL;
+    }
+    pthread_mutex_unlock(&registeredNodesMutex);
+
+    if (IS_NOT_NULL(nodes))
+    {
+        freeRegisteredNodes(nodes);
+    }
+}
+
+/**
+ * @brief sendRegisterResponse - Sends one response per node with the status of the operation
+ * @param msg - Request edge message
+ * @param status - Status of each node of the request
+ */
+static void sendRegisterResponse(const EdgeMessage *msg, const UA_StatusCode *status)
+{
+    size_t reqLen = msg->requestLength;
+    EdgeMessage *resultMsg = allocEdgeMessage();
+    VERIFY_NON_NULL_NR_MSG(resultMsg, "EdgeCalloc FAILED for resultMsg in sendRegisterResponse\n");
+
+    setMessageEndpointInfo(resultMsg, shareMessageEndpointInfo(msg));
+    resultMsg->responses = (EdgeResponse **) EdgeCalloc(reqLen, sizeof(EdgeResponse *));
+    if (IS_NULL(resultMsg->endpointInfo) || IS_NULL(resultMsg->responses))
+    {
+        EDGE_LOG(TAG, "Error : Malloc failed for resultMsg in sendRegisterResponse\n");
+        goto RESPONSE_ERROR;
+    }
+    resultMsg->command = msg->command;
+    resultMsg->type = GENERAL_RESPONSE;
+    resultMsg->message_id = msg->message_id;
+
+    for (size_t i = 0; i < reqLen; i++)
+    {
+        EdgeResponse *response = (EdgeResponse *) EdgeCalloc(1, sizeof(EdgeResponse));
+        if (IS_NULL(response))
+        {
+            goto RESPONSE_ERROR;
+        }
+        resultMsg->responses[i] = response;
+        resultMsg->responseLength++;
+
+        response->nodeInfo = cloneEdgeNodeInfo(msg->requests[i]->nodeInfo);
+        response->requestId = msg->requests[i]->requestId;
+        response->message = (EdgeVersatility *) EdgeCalloc(1, sizeof(EdgeVersatility));
+        if (IS_NULL(response->nodeInfo) || IS_NULL(response->message))
+        {
+            EDGE_LOG(TAG, "Error : Malloc failed for EdgeResponse in sendRegisterResponse\n");
+            goto RESPONSE_ERROR;
+        }
+        response->message->value = cloneString(UA_StatusCode_name(status[i]));
+        if (IS_NULL(response->message->value))
+        {
+            goto RESPONSE_ERROR;
+        }
+    }
+
+    /* Adding the response to receiver Q */
+    add_to_recvQ(resultMsg);
+    return;
+
+    RESPONSE_ERROR:
+    freeEdgeMessage(resultMsg);
+}
+
+static void registerNodes(UA_Client *client, const EdgeMessage *msg)
+{
+    size_t reqLen = msg->requestLength;
+    UA_NodeId *nodeIds = (UA_NodeId *) EdgeMalloc(sizeof(UA_NodeId) * reqLen);
+    UA_StatusCode *status = (UA_StatusCode *) EdgeCalloc(reqLen, sizeof(UA_StatusCode));
+    if (IS_NULL(nodeIds) || IS_NULL(status))
+    {
+        EDGE_LOG(TAG, "Error : Malloc failed in registerNodes\n");
+        sendErrorResponse(msg, "Memory allocation failed.");
+        goto EXIT;
+    }
+
+    for (size_t i = 0; i < reqLen; i++)
+    {
+        /* Borrows the value alias of the request, the NodeIds are not freed */
+        nodeIds[i] = UA_NODEID_STRING(msg->requests[i]->nodeInfo->nodeId->nameSpace,
+                msg->requests[i]->nodeInfo->valueAlias);
+    }
+
+    UA_RegisterNodesRequest request;
+    UA_RegisterNodesRequest_init(&request);
+    request.nodesToRegister = nodeIds;
+    request.nodesToRegisterSize = reqLen;
+    UA_RegisterNodesResponse response = UA_Client_Service_registerNodes(client, request);
+    if (response.responseHeader.serviceResult != UA_STATUSCODE_GOOD
+            || response.registeredNodeIdsSize != reqLen)
+    {
+        EDGE_LOG_V(TAG, "Error in register nodes :: 0x%08x(%s)\n", response.responseHeader.serviceResult,
+                UA_StatusCode_name(response.responseHeader.serviceResult));
+        sendErrorResponse(msg, "Error in register nodes.");
+        UA_RegisterNodesResponse_deleteMembers(&response);
+        goto EXIT;
+    }
+
+    for (size_t i = 0; i < reqLen; i++)
+    {
+        char key[EDGE_NODE_KEY_SIZE];
+        status[i] = UA_STATUSCODE_BADOUTOFMEMORY;
+        if (formatNodeKey(msg->requests[i]->nodeInfo->nodeId->nameSpace,
+                msg->requests[i]->nodeInfo->valueAlias, key)
+                && storeRegisteredNodeId(client, key, &response.registeredNodeIds[i]))
+        {
+            status[i] = UA_STATUSCODE_GOOD;
+        }
+    }
+    UA_RegisterNodesResponse_deleteMembers(&response);
+    sendRegisterResponse(msg, status);
+
+    EXIT:
+    EdgeFree(nodeIds);
+    EdgeFree(status);
+}
+
+static void unregisterNodes(UA_Client *client, const EdgeMessage *msg)
+{
+    size_t reqLen = msg->requestLength;
+    UA_NodeId **registered = (UA_NodeId **) EdgeCalloc(reqLen, sizeof(UA_NodeId *));
+    UA_NodeId *nodeIds = (UA_NodeId *) EdgeMalloc(sizeof(UA_NodeId) * reqLen);
+    UA_StatusCode *status = (UA_StatusCode *) EdgeCalloc(reqLen, sizeof(UA_StatusCode));
+    if (IS_NULL(registered) || IS_NULL(nodeIds) || IS_NULL(status))
+    {
+        EDGE_LOG(TAG, "Error : Malloc failed in unregisterNodes\n");
+        sendErrorResponse(msg, "Memory allocation failed.");
+        goto EXIT;
+    }
+
+    /* Nodes are forgotten locally whatever the server answers */
+    size_t count = 0;
+    for (size_t i = 0; i < reqLen; i++)
+    {
+        char key[EDGE_NODE_KEY_SIZE];
+        if (formatNodeKey(msg->requests[i]->nodeInfo->nodeId->nameSpace,
+                msg->requests[i]->nodeInfo->valueAlias, key))
+        {
+            registered[i] = takeRegisteredNodeId(client, key);
+        }
+        if (IS_NULL(registered[i]))
+        {
+            status[i] = UA_STATUSCODE_BADNODEIDUNKNOWN;
+            continue;
+        }
+        nodeIds[count++] = *registered[i];
+    }
+
+    if (count > 0)
+    {
+        UA_UnregisterNodesRequest request;
+        UA_UnregisterNodesRequest_init(&request);
+        request.nodesToUnregister = nodeIds;
+        request.nodesToUnregisterSize = count;
+        UA_UnregisterNodesResponse response = UA_Client_Service_unregisterNodes(client, request);
+        UA_StatusCode serviceResult = response.responseHeader.serviceResult;
+        UA_UnregisterNodesResponse_deleteMembers(&response);
+        if (serviceResult != UA_STATUSCODE_GOOD)
+        {
+            EDGE_LOG_V(TAG, "Error in unregister nodes :: 0x%08x(%s)\n", serviceResult,
+                    UA_StatusCode_name(serviceResult));
+            for (size_t i = 0; i < reqLen; i++)
+            {
+                if (IS_NOT_NULL(registered[i]))
+                {
+                    status[i] = serviceResult;
+                }
+            }
+        }
+    }
+    sendRegisterResponse(msg, status);
+
+    EXIT:
+    if (IS_NOT_NULL(registered))
+    {
+        for (size_t i = 0; i < reqLen; i++)
+        {
+            if (IS_NOT_NULL(registered[i]))
+            {
+                UA_NodeId_delete(registered[i]);
+            }
+        }
+    }
+    EdgeFree(registered);
+    EdgeFree(nodeIds);
+    EdgeFree(status);
+}
+
+EdgeResult executeRegisterNodes(UA_Client *client, const EdgeMessage *msg)
+{
+    EdgeResult result;
+    result.code = STATUS_ERROR;
+    VERIFY_NON_NULL_MSG(client, "Client param is NULL in executeRegisterNodes\n", result);
+    result.code = STATUS_PARAM_INVALID;
+    COND_CHECK_MSG((0 == msg->requestLength), "No nodes in executeRegisterNodes\n", result);
+
+    if (CMD_REGISTER_NODES == msg->command)
+    {
+        registerNodes(client, msg);
+    }
+    else if (CMD_UNREGISTER_NODES == msg->command)
+    {
+        unregisterNodes(client, msg);
+    }
+    result.code = STATUS_OK;
+    return result;
+}
@@ -0,0 +1,85 @@
+/******************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ *
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************/
+
+/**
+ * @file register_nodes.h
+ *
+ * @brief This file contains the definition, types and APIs for RegisterNodes command requests.
+ */
+
+#ifndef EDGE_REGISTER_NODES_H
+#define EDGE_REGISTER_NODES_H
+
+#include "opcua_common.h"
+#include "open62541.h"
+
+#include "edge_utils.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/**
+ * @brief Executes RegisterNodes or UnregisterNodes operation, depending on the command of the message
+ * @param[in]  client Client Handle.
+ * @param[in]  msg EdgeMessage request data
+ * @return @c EdgeResult code is 0 on success, otherwise an error value
+ * @retval #STATUS_OK Successful
+ * @retval #STATUS_PARAM_INVALID Invalid parameter
+ * @retval #STATUS_ERROR Operation failed
+ */
+EdgeResult executeRegisterNodes(UA_Client *client, const EdgeMessage *msg);
+
+/**
+ * @brief Gets the NodeId that the server returned when the node was registered
+ * @param[in]  client Client Handle.
+ * @param[in]  nsIndex Namespace index of the node.
+ * @param[in]  valueAlias Value alias of the node.
+ * @return Registered NodeId, otherwise NULL if the node is not registered.
+ * @remarks The NodeId stays valid until the node is unregistered or the session ends.
+ * Requests of one session are executed in order, so it can be used while executing one of them.
+ */
+const UA_NodeId *getRegisteredNodeId(UA_Client *client, uint16_t nsIndex, const char *valueAlias);
+
+/**
+ * @brief Stores a NodeId resolved by the client under the node of a request, so that later
+ *        requests for the node use it as if the node was registered
+ * @param[in]  client Client Handle.
+ * @param[in]  nsIndex Namespace index of the node.
+ * @param[in]  valueAlias Value alias of the node.
+ * @param[in]  nodeId NodeId to use for the node, it is copied.
+ * @return @c true if it was stored, @c false if memory is insufficient or a parameter is invalid
+ * @remarks CMD_UNREGISTER_NODES forgets the node like a registered one.
+ */
+bool storeResolvedNodeId(UA_Client *client, uint16_t nsIndex, const char *valueAlias,
+        const UA_NodeId *nodeId);
+
+/**
+ * @brief Forgets the registered nodes of a client, called when its session ends
+ * @param[in]  client Client Handle.
+ */
+void removeRegisteredNodes(UA_Client *client);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // EDGE_REGISTER_NODES_H
@@ -0,0 +1,203 @@
+/******************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ *
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************/
+
+#include "server_capabilities.h"
+#include "edge_logger.h"
+#include "edge_malloc.h"
+#include "edge_open62541.h"
+#include "edge_hash_map.h"
+
+#include <stdint.h>
+#include <string.h>
+#ifndef _WIN32
+#include <pthread.h>
+#else
+#include "pthread.h"
+#endif
+
+#define TAG "server_capabilities"
+
+/* Client handle -> EdgeServerCapabilities */
+static EdgeHashMap *capabilitiesMap = NULL;
+static pthread_mutex_t capabilitiesMutex = PTHREAD_MUTEX_INITIALIZER;
+
+/* Nodes of the capabilities, in the order of the read request */
+static const UA_UInt32 CAPABILITY_NODES[] = {
+    UA_NS0ID_SERVER_SERVERCAPABILITIES_MAXBROWSECONTINUATIONPOINTS,
+    UA_NS0ID_SERVER_SERVERCAPABILITIES_OPERATIONLIMITS_MAXNODESPERBROWSE,
+    UA_NS0ID_SERVER_SERVERCAPABILITIES_OPERATIONLIMITS_MAXNODESPERREAD,
+    UA_NS0ID_SERVER_SERVERCAPABILITIES_OPERATIONLIMITS_MAXNODESPERWRITE,
+    UA_NS0ID_SERVER_SERVERCAPABILITIES_OPERATIONLIMITS_MAXMONITOREDITEMSPERCALL,
+    UA_NS0ID_SERVER_SERVERCAPABILITIES_OPERATIONLIMITS_MAXNODESPERTRANSLATEBROWSEPATHSTONODEIDS,
+    UA_NS0ID_SERVER_SERVERCAPABILITIES_OPERATIONLIMITS_MAXNODESPERMETHODCALL,
+    UA_NS0ID_SERVER_SERVERCAPABILITIES_OPERATIONLIMITS_MAXNODESPERHISTORYREADDATA
+};
+#define CAPABILITY_COUNT (sizeof(CAPABILITY_NODES) / sizeof(CAPABILITY_NODES[0]))
+
+/**
+ * @brief getCapabilityValue - Gets an optional UInt32 or UInt16 capability of a read result
+ * @param value - Read result
+ * @param limit - Receives the value, left as it is if the server has none
+ */
+static void getCapabilityValue(const UA_DataValue *value, uint32_t *limit)
+{
+    if (!value->hasValue || UA_STATUSCODE_GOOD != value->status || !UA_Variant_isScalar(&value->value))
+    {
+        return;
+    }
+    if (value->value.type == &UA_TYPES[UA_TYPES_UINT32])
+    {
+        *limit = *(UA_UInt32 *) value->value.data;
+    }
+    else if (value->value.type == &UA_TYPES[UA_TYPES_UINT16])
+    {
+        *limit = *(UA_UInt16 *) value->value.data;
+    }
+}
+
+static void initServerCapabilities(EdgeServerCapabilities *capabilities)
+{
+    memset(capabilities, 0, sizeof(EdgeServerCapabilities));
+    // Server's mandatory property. Minimum value assumed.
+    capabilities->maxBrowseContinuationPoints = 1;
+}
+
+/**
+ * @brief fetchServerCapabilities - Reads all capabilities of the server in one request
+ * @param client - Client handle
+ * @param capabilities - Receives the capabilities
+ */
+static void fetchServerCapabilities(UA_Client *client, EdgeServerCapabilities *capabilities)
+{
+    initServerCapabilities(capabilities);
+
+    UA_ReadValueId items[CAPABILITY_COUNT];
+    for (size_t i = 0; i < CAPABILITY_COUNT; i++)
+    {
+        UA_ReadValueId_init(&items[i]);
+        items[i].nodeId = UA_NODEID_NUMERIC(0, CAPABILITY_NODES[i]);
+        items[i].attributeId = UA_ATTRIBUTEID_VALUE;
+    }
+    UA_ReadRequest request;
+    UA_ReadRequest_init(&request);
+    request.nodesToRead = items;
+    request.nodesToReadSize = CAPABILITY_COUNT;
+
+    UA_ReadResponse response = UA_Client_Service_read(client, request);
+    if (UA_STATUSCODE_GOOD != response.responseHeader.serviceResult
+            || CAPABILITY_COUNT != response.resultsSize)
+    {
+        EDGE_LOG_V(TAG, "Failed to read the server capabilities :: 0x%08x(%s)\n",
+                response.responseHeader.serviceResult,
+                UA_StatusCode_name(response.responseHeader.serviceResult));
+        UA_ReadResponse_deleteMembers(&response);
+        return;
+    }
+
+    uint32_t continuationPoints = capabilities->maxBrowseContinuationPoints;
+    getCapabilityValue(&response.results[0], &continuationPoints);
+    if (continuationPoints > 0 && continuationPoints <= UINT16_MAX)
+    {
+        capabilities->maxBrowseContinuationPoints = (uint16_t) continuationPoints;
+    }
+    getCapabilityValue(&response.results[1], &capabilities->maxNodesPerBrowse);
+    getCapabilityValue(&response.results[2], &capabilities->maxNodesPerRead);
+    getCapabilityValue(&response.results[3], &capabilities->maxNodesPerWrite);
+    getCapabilityValue(&response.results[4], &capabilities->maxMonitoredItemsPerCall);
+    getCapabilityValue(&response.results[5], &capabilities->maxNodesPerTranslateBrowsePaths);
+    getCapabilityValue(&response.results[6], &capabilities->maxNodesPerMethodCall);
+    getCapabilityValue(&response.results[7], &capabilities->maxNodesPerHistoryReadData);
+    UA_ReadResponse_deleteMembers(&response);
+
+    EDGE_LOG_V(TAG, "Server capabilities: continuation points %u, nodes per browse %u, "
+            "per read %u, per write %u, monitored items per call %u, "
+            "paths per translate %u, methods per call %u, history reads %u\n",
+            capabilities->maxBrowseContinuationPoints, capabilities->maxNodesPerBrowse,
+            capabilities->maxNodesPerRead, capabilities->maxNodesPerWrite,
+            capabilities->maxMonitoredItemsPerCall, capabilities->maxNodesPerTranslateBrowsePaths,
+            capabilities->maxNodesPerMethodCall, capabilities->maxNodesPerHistoryReadData);
+}
+
+bool storeServerCapabilities(UA_Client *client, const EdgeServerCapabilities *capabilities)
+{
+    VERIFY_NON_NULL_MSG(client, "NULL client in storeServerCapabilities\n", false);
+    VERIFY_NON_NULL_MSG(capabilities, "NULL capabilities in storeServerCapabilities\n", false);
+    EdgeServerCapabilities *stored = (EdgeServerCapabilities *) EdgeMalloc(sizeof(EdgeServerCapabilities));
+    VERIFY_NON_NULL_MSG(stored, "EdgeMalloc FAILED for EdgeServerCapabilities\n", false);
+    *stored = *capabilities;
+
+    pthread_mutex_lock(&capabilitiesMutex);
+    if (IS_NULL(capabilitiesMap))
+    {
+        capabilitiesMap = createEdgeHashMap(EDGE_HASH_POINTER_KEY);
+    }
+    EdgeFree(removeEdgeHashMapElement(capabilitiesMap, (keyValue) client, NULL));
+    bool inserted = IS_NOT_NULL(capabilitiesMap)
+            && insertEdgeHashMapElement(capabilitiesMap, (keyValue) client, stored);
+    pthread_mutex_unlock(&capabilitiesMutex);
+    if (!inserted)
+    {
+        EdgeFree(stored);
+    }
+    return inserted;
+}
+
+bool readServerCapabilities(UA_Client *client)
+{
+    VERIFY_NON_NULL_MSG(client, "NULL client in readServerCapabilities\n", false);
+    EdgeServerCapabilities capabilities;
+    fetchServerCapabilities(client, &capabilities);
+    return storeServerCapabilities(client, &capabilities);
+}
+
+void getServerCapabilities(UA_Client *client, EdgeServerCapabilities *capabilities)
+{
+    VERIFY_NON_NULL_NR_MSG(capabilities, "NULL capabilities in getServerCapabilities\n");
+    initServerCapabilities(capabilities);
+    VERIFY_NON_NULL_NR_MSG(client, "NULL client in getServerCapabilities\n");
+
+    pthread_mutex_lock(&capabilitiesMutex);
+    EdgeServerCapabilities *cached = (EdgeServerCapabilities *) getEdgeHashMapElement(capabilitiesMap,
+            (keyValue) client);
+    if (IS_NOT_NULL(cached))
+    {
+        *capabilities = *cached;
+    }
+    pthread_mutex_unlock(&capabilitiesMutex);
+    if (IS_NOT_NULL(cached))
+    {
+        return;
+    }
+
+    fetchServerCapabilities(client, capabilities);
+    storeServerCapabilities(client, capabilities);
+}
+
+void removeServerCapabilities(UA_Client *client)
+{
+    pthread_mutex_lock(&capabilitiesMutex);
+    EdgeFree(removeEdgeHashMapElement(capabilitiesMap, (keyValue) client, NULL));
+    if (IS_NOT_NULL(capabilitiesMap) && 0 == getEdgeHashMapSize(capabilitiesMap))
+    {
+        deleteEdgeHashMap(capabilitiesMap);
+        capabilitiesMap = NULL;
+    }
+    pthread_mutex_unlock(&capabilitiesMutex);
+}
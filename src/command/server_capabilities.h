@@ -0,0 +1,104 @@
+/******************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ *
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************/
+
+/**
+ * @file server_capabilities.h
+ *
+ * @brief This file contains the ServerCapabilities and OperationLimits of each session.
+ */
+
+#ifndef EDGE_SERVER_CAPABILITIES_H
+#define EDGE_SERVER_CAPABILITIES_H
+
+#include "opcua_common.h"
+#include "open62541.h"
+
+#include "edge_utils.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/**
+ * @brief Limits of a server which requests are split by. 0 means the server has no limit.
+ */
+typedef struct EdgeServerCapabilities
+{
+    /**< ServerCapabilities/MaxBrowseContinuationPoints, at least 1 */
+    uint16_t maxBrowseContinuationPoints;
+
+    /**< OperationLimits/MaxNodesPerBrowse */
+    uint32_t maxNodesPerBrowse;
+
+    /**< OperationLimits/MaxNodesPerRead */
+    uint32_t maxNodesPerRead;
+
+    /**< OperationLimits/MaxNodesPerWrite */
+    uint32_t maxNodesPerWrite;
+
+    /**< OperationLimits/MaxMonitoredItemsPerCall */
+    uint32_t maxMonitoredItemsPerCall;
+
+    /**< OperationLimits/MaxNodesPerTranslateBrowsePathsToNodeIds */
+    uint32_t maxNodesPerTranslateBrowsePaths;
+
+    /**< OperationLimits/MaxNodesPerMethodCall */
+    uint32_t maxNodesPerMethodCall;
+
+    /**< OperationLimits/MaxNodesPerHistoryReadData */
+    uint32_t maxNodesPerHistoryReadData;
+} EdgeServerCapabilities;
+
+/**
+ * @brief Reads the capabilities of the server with one read request and caches them
+ *        for the session, called when the client has connected.
+ * @param[in]  client Client Handle.
+ * @return @c true if they were cached, @c false if memory is insufficient
+ */
+bool readServerCapabilities(UA_Client *client);
+
+/**
+ * @brief Caches capabilities for the session in place of the ones read from the server.
+ * @param[in]  client Client Handle.
+ * @param[in]  capabilities Capabilities to cache, copied.
+ * @return @c true if they were cached, @c false if memory is insufficient
+ */
+bool storeServerCapabilities(UA_Client *client, const EdgeServerCapabilities *capabilities);
+
+/**
+ * @brief Gets the cached capabilities of the session, they are read if they are not cached yet.
+ * @param[in]  client Client Handle.
+ * @param[out] capabilities Capabilities of the server. Limits which cannot be read are
+ *             left at their defaults, there is no limit then.
+ */
+void getServerCapabilities(UA_Client *client, EdgeServerCapabilities *capabilities);
+
+/**
+ * @brief Forgets the capabilities of a client, called when its session ends
+ * @param[in]  client Client Handle.
+ */
+void removeServerCapabilities(UA_Client *client);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // EDGE_SERVER_CAPABILITIES_H
@@ -23,11 +23,19 @@
 #include "edge_random.h"
 #include "edge_utils.h"
 #include "edge_open62541.h"
-#include "edge_map.h"
+#include "edge_hash_map.h"
 #include "edge_logger.h"
 #include "edge_malloc.h"
 #include "message_dispatcher.h"
+#include "report_latency.h"
 #include "edge_opcua_client.h"
+#include "edge_report_pool.h"
+#include "edge_intern.h"
+#include "value_cache.h"
+#include "server_capabilities.h"
+#include "register_nodes.h"
+#include "octhread.h"
+#include "edge_thread_config.h"
 
 #ifndef _WIN32
 #include <pthread.h>
@@ -41,12 +49,24 @@
 
 #define EDGE_UA_SUBSCRIPTION_ITEM_SIZE (100)
 
+/* Publishing intervals are not scheduled shorter than this (ms) */
+#define EDGE_UA_MINIMUM_PUBLISHING_TIME (10)
+/* Longest wait (ms) before a failed publish request is sent again */
+#define EDGE_UA_MAXIMUM_PUBLISH_RETRY_TIME (5000)
+
+/* Number of threads which send the publish requests of all sessions. Without ENABLE_SUB_QUEUE
+ * a thread is blocked while the server holds its publish request, so a few are shared. */
+#ifndef EDGE_UA_PUBLISH_REACTOR_THREADS
 #ifndef ENABLE_SUB_QUEUE
-#define EDGE_UA_MINIMUM_PUBLISHING_TIME (25)
+#define EDGE_UA_PUBLISH_REACTOR_THREADS (4)
 #else
-#define EDGE_UA_MINIMUM_PUBLISHING_TIME (1000)
+#define EDGE_UA_PUBLISH_REACTOR_THREADS (1)
+#endif
 #endif
 
+/* Initial number of responses of a batched REPORT message */
+#define EDGE_UA_REPORT_BATCH_SIZE (16)
+
 #define DEFAULT_RETRANSMIT_SEQUENCENUM (2)
 #define GUID_LENGTH (36)
 
@@ -59,6 +79,14 @@ typedef struct subscriptionInfo
     UA_UInt32 subId;
     /* MonitoredItem Id */
     UA_UInt32 monId;
+    /* Publishing interval of the subscription in milliseconds */
+    UA_Double publishingInterval;
+    /* Keep alive count of the subscription */
+    UA_UInt32 maxKeepAliveCount;
+    /* Queue size of the monitored item, guarded by serializeMutex */
+    UA_UInt32 queueSize;
+    /* Parameters of the item, used to create it again when the server lost its subscription */
+    EdgeSubRequest request;
     /* Context */
     void *hfContext;
 } subscriptionInfo;
@@ -67,25 +95,89 @@ typedef struct clientSubscription
 {
     /* Number of subscriptions */
     int subscriptionCount;
-    /* Subscription thread */
-    pthread_t subscription_thread;
-    /* Mutex for serialization */
+    /* Client handle */
+    UA_Client *client;
+#ifdef ENABLE_SUB_QUEUE
+    /* Endpoint of the publish messages */
+    char *endpointUri;
+#endif
+    /* Serializes changes of the subscription list with the publish requests of the reactor */
     pthread_mutex_t serializeMutex;
-    /* flag to determine to execution of subscription thread */
-    bool subscription_thread_running;
-    /* Subscription list */
-    edgeMap *subscriptionList;
+    /* Members below are guarded by reactorMutex */
+    /* Set while the session is in the sessions of the publish reactor */
+    bool reactorActive;
+    /* Next session of the publish reactor */
+    struct clientSubscription *nextSession;
+    /* Time in microseconds at which the next publish request is due */
+    uint64_t nextPublishTime;
+    /* Set while a reactor thread sends a publish request of the session */
+    bool publishing;
+    /* Set while a publish request is waiting in the send queue */
+    bool publishQueued;
+    /* Subscription list keyed by the interned value alias */
+    EdgeHashMap *subscriptionList;
+    /* Data change notifications received, updated by NOTIFICATION_COUNT_INCREMENT */
+    uint64_t notificationCount;
+    /* Recycled REPORT messages of the session, NULL if it could not be created */
+    EdgeReportPool *reportPool;
+    /* REPORT messages collected during the current publish request, one per subscription */
+    struct reportBatch *reportBatches;
+    size_t reportBatchCount;
+    size_t reportBatchCapacity;
+    /* Members below are guarded by serializeMutex */
+    /* Set when a publish request found the connection lost, the session is connected again */
+    bool sessionLost;
+    /* Subscriptions which are not yet transferred to or created in the new session */
+    UA_UInt32 *lostSubIds;
+    size_t lostSubIdCount;
 } clientSubscription;
 
+/* REPORT message which collects the notifications of a subscription of one publish response */
+typedef struct reportBatch
+{
+    /* Subscription Id */
+    UA_UInt32 subId;
+    /* REPORT message, it has a response for each notification */
+    EdgeMessage *report;
+    /* Number of allocated responses of the report */
+    size_t capacity;
+} reportBatch;
+
 typedef struct client_valueAlias
 {
     /* Client handle */
     UA_Client *client;
-    /* value alias */
-    char *valueAlias;
+    /* Interned value alias, also the key of the subscription list */
+    const char *valueAlias;
+    /* Namespace index of the monitored node */
+    UA_UInt16 nsIndex;
+    /* Subscription of the client, set once the item is in its subscription list */
+    clientSubscription *clientSub;
+    /* Entry of the item in the subscription list, NULL until it is inserted */
+    subscriptionInfo *subInfo;
 } client_valueAlias;
 
-static edgeMap *clientSubMap  = NULL;
+#define NOTIFICATION_COUNT_INCREMENT(ptr) __atomic_add_fetch((ptr), 1, __ATOMIC_RELAXED)
+#define NOTIFICATION_COUNT_LOAD(ptr) __atomic_load_n((ptr), __ATOMIC_RELAXED)
+
+static EdgeHashMap *clientSubMap  = NULL;
+/* Guards clientSubMap, subscriptions of different endpoints may be handled in parallel */
+static pthread_mutex_t clientSubMapMutex = PTHREAD_MUTEX_INITIALIZER;
+
+/* Publish reactor, its threads send the publish requests of all sessions with subscriptions */
+/* Serializes the start and stop of the reactor with the users of reactorMutex */
+static pthread_mutex_t reactorLifecycleMutex = PTHREAD_MUTEX_INITIALIZER;
+static oc_mutex reactorMutex = NULL;
+static oc_cond reactorCond = NULL;
+static oc_thread reactorThreads[EDGE_UA_PUBLISH_REACTOR_THREADS];
+static size_t reactorThreadCount = 0;
+static bool reactorRunning = false;
+/* Sessions of the reactor, linked by nextSession */
+static clientSubscription *reactorSessions = NULL;
+static size_t reactorSessionCount = 0;
+
+static UA_StatusCode recoverSession(clientSubscription *clientSub);
+static void markSessionLost(clientSubscription *clientSub, UA_StatusCode ret);
 
 /**
  * @brief validateMonitoringId - Function that checks whether monitoredItem id
@@ -95,260 +187,1355 @@ static edgeMap *clientSubMap  = NULL;
  * @param monId - monitored Id to check under the given subscription Id
  * @return
  */
-static bool validateMonitoringId(edgeMap *list, UA_UInt32 subId, UA_UInt32 monId)
+static bool validateMonitoringId(EdgeHashMap *list, UA_UInt32 subId, UA_UInt32 monId)
 {
     VERIFY_NON_NULL_MSG(list, "", true);
-    edgeMapNode *temp = list->head;
-    while (temp != NULL)
+    size_t cursor = 0;
+    keyValue value = NULL;
+    while (getNextEdgeHashMapElement(list, &cursor, NULL, &value))
+    {
+        subscriptionInfo *subInfo = (subscriptionInfo *) value;
+        if (subInfo->subId == subId && subInfo->monId == monId)
+            return false;
+    }
+    return true;
+}
+
+/**
+ * @brief hasSubscriptionId - Function that checks whether subscription id is valid
+ * @param list - subscription list
+ * @param subId - subscription Id to check whether its valid
+ * @return
+ */
+static bool hasSubscriptionId(EdgeHashMap *list, UA_UInt32 subId)
+{
+    VERIFY_NON_NULL_MSG(list, "", false);
+    size_t cursor = 0;
+    keyValue value = NULL;
+    while (getNextEdgeHashMapElement(list, &cursor, NULL, &value))
+    {
+        subscriptionInfo *subInfo = (subscriptionInfo *) value;
+        COND_CHECK((subInfo->subId == subId), true);
+    }
+    return false;
+}
+
+/**
+ * @brief get_subscription_list - Gets the subscription list associated with particular client handle
+ * @param client - Client handle
+ * @return void pointer representing the client handle info.
+ */
+static void* get_subscription_list(UA_Client *client)
+{
+    pthread_mutex_lock(&clientSubMapMutex);
+    void *value = getEdgeHashMapElement(clientSubMap, (keyValue) client);
+    pthread_mutex_unlock(&clientSubMapMutex);
+    return value;
+}
+
+/**
+ * @brief getSubInfoByKey - Gets subscription information from the list with interned valueAlias filter
+ * @param list - subscription list
+ * @param key - interned value alias, compared by pointer
+ * @return keyValue
+ */
+static keyValue getSubInfoByKey(EdgeHashMap* list, const char *key)
+{
+    VERIFY_NON_NULL_MSG(list, "", NULL);
+    return getEdgeHashMapElement(list, (keyValue) key);
+}
+
+/**
+ * @brief getSubInfo - Gets subscription information from the list with valueAlias filter
+ * @param list - subscription list
+ * @param valueAlias - value alias
+ * @return keyValue
+ */
+static keyValue getSubInfo(EdgeHashMap* list, const char *valueAlias)
+{
+    /* A subscribed alias is always interned, as it is the key of the list */
+    const char *key = lookupEdgeString(valueAlias);
+    COND_CHECK((IS_NULL(key)), NULL);
+    keyValue value = getSubInfoByKey(list, key);
+    releaseEdgeString(key);
+    return value;
+}
+
+/**
+ * @brief removeSubFromMap - Remove the subscription information from the subscription list
+ * @param list - subscription list
+ * @param valueAlias - value alias
+ * @return the removed subscription info
+ */
+static subscriptionInfo *removeSubFromMap(EdgeHashMap *list, const char *valueAlias)
+{
+    VERIFY_NON_NULL_MSG(list, "", NULL);
+    const char *key = lookupEdgeString(valueAlias);
+    COND_CHECK((IS_NULL(key)), NULL);
+
+    keyValue storedKey = NULL;
+    subscriptionInfo *subInfo = (subscriptionInfo *) removeEdgeHashMapElement(list,
+            (keyValue) key, &storedKey);
+    if (storedKey)
+    {
+        releaseEdgeString(storedKey);
+    }
+    releaseEdgeString(key);
+    return subInfo;
+}
+
+#ifndef ENABLE_SUB_QUEUE
+static UA_StatusCode sendPublishRequest(UA_Client *client)
+{
+    return UA_Client_Subscriptions_manuallySendPublishRequest(client);
+}
+#endif
+
+/**
+ * @brief setPublishingParameters - Stores the publishing parameters of a subscription in all
+ * of its entries of the subscription list
+ * @param clientSub - Subscriptions of the client
+ * @param subId - Subscription Id
+ * @param publishingInterval - Publishing interval in milliseconds
+ * @param maxKeepAliveCount - Keep alive count
+ */
+static void setPublishingParameters(clientSubscription *clientSub, UA_UInt32 subId,
+        UA_Double publishingInterval, UA_UInt32 maxKeepAliveCount)
+{
+    pthread_mutex_lock(&clientSub->serializeMutex);
+    size_t cursor = 0;
+    keyValue value = NULL;
+    while (getNextEdgeHashMapElement(clientSub->subscriptionList, &cursor, NULL, &value))
+    {
+        subscriptionInfo *subInfo = (subscriptionInfo *) value;
+        if (subInfo->subId == subId)
+        {
+            subInfo->publishingInterval = publishingInterval;
+            subInfo->maxKeepAliveCount = maxKeepAliveCount;
+        }
+    }
+    pthread_mutex_unlock(&clientSub->serializeMutex);
+}
+
+/**
+ * @brief schedulePublish - Sets the time of the next publish request from the shortest publishing
+ * interval of the subscriptions. A failed request is retried after the keep alive time.
+ * Must be called with reactorMutex held.
+ * @param clientSub - Subscriptions of the client
+ * @param sentAt - Time in microseconds at which the last publish request was sent
+ * @param ret - Result of the last publish request
+ */
+static void schedulePublish(clientSubscription *clientSub, uint64_t sentAt, UA_StatusCode ret)
+{
+    UA_Double interval = 0;
+    UA_UInt32 keepAlive = 1;
+    pthread_mutex_lock(&clientSub->serializeMutex);
+    size_t cursor = 0;
+    keyValue value = NULL;
+    while (getNextEdgeHashMapElement(clientSub->subscriptionList, &cursor, NULL, &value))
+    {
+        subscriptionInfo *subInfo = (subscriptionInfo *) value;
+        if (interval <= 0 || subInfo->publishingInterval < interval)
+        {
+            interval = subInfo->publishingInterval;
+            keepAlive = subInfo->maxKeepAliveCount;
+        }
+    }
+    pthread_mutex_unlock(&clientSub->serializeMutex);
+
+    if (interval < EDGE_UA_MINIMUM_PUBLISHING_TIME)
+    {
+        interval = EDGE_UA_MINIMUM_PUBLISHING_TIME;
+    }
+    if (ret != UA_STATUSCODE_GOOD)
+    {
+        /* The server did not answer, no notification is expected before the keep alive */
+        EDGE_LOG_V(TAG, "Publish request failed :: %s\n", UA_StatusCode_name(ret));
+        interval *= (keepAlive > 0) ? keepAlive : 1;
+        if (interval > EDGE_UA_MAXIMUM_PUBLISH_RETRY_TIME)
+        {
+            interval = EDGE_UA_MAXIMUM_PUBLISH_RETRY_TIME;
+        }
+    }
+    clientSub->nextPublishTime = sentAt + (uint64_t) (interval * 1000);
+}
+
+/**
+ * @brief wakePublishReactor - Makes the publish reactor send a publish request of the session now,
+ * after its subscriptions changed
+ * @param clientSub - Subscriptions of the client
+ */
+static void wakePublishReactor(clientSubscription *clientSub)
+{
+    pthread_mutex_lock(&reactorLifecycleMutex);
+    if (clientSub->reactorActive)
+    {
+        oc_mutex_lock(reactorMutex);
+        clientSub->nextPublishTime = 0;
+        oc_cond_broadcast(reactorCond);
+        oc_mutex_unlock(reactorMutex);
+    }
+    pthread_mutex_unlock(&reactorLifecycleMutex);
+}
+
+#ifdef ENABLE_SUB_QUEUE
+/**
+ * @brief completePublish - Schedules the next publish request of the session once the dispatcher
+ * has sent the queued one
+ * @param clientSub - Subscriptions of the client
+ * @param sentAt - Time in microseconds at which the publish request was sent
+ * @param ret - Result of the publish request
+ */
+static void completePublish(clientSubscription *clientSub, uint64_t sentAt, UA_StatusCode ret)
+{
+    pthread_mutex_lock(&reactorLifecycleMutex);
+    if (clientSub->reactorActive)
+    {
+        oc_mutex_lock(reactorMutex);
+        clientSub->publishQueued = false;
+        schedulePublish(clientSub, sentAt, ret);
+        oc_cond_broadcast(reactorCond);
+        oc_mutex_unlock(reactorMutex);
+    }
+    else
+    {
+        clientSub->publishQueued = false;
+    }
+    pthread_mutex_unlock(&reactorLifecycleMutex);
+}
+#endif
+
+/**
+ * @brief isInlineScalarType - Checks whether a scalar of the type is a plain value of at most 8 bytes
+ * @param type - Response type from get_response_type()
+ * @return
+ */
+static bool isInlineScalarType(int type)
+{
+    return (type >= UA_NS0ID_BOOLEAN && type <= UA_NS0ID_DOUBLE) || type == UA_NS0ID_DATETIME;
+}
+
+/**
+ * @brief setReportTimestamps - Sets the timestamps of the value and the receive time in the response
+ * @param response - Response of the notification
+ * @param value - Changed value
+ */
+static void setReportTimestamps(EdgeResponse *response, const UA_DataValue *value)
+{
+    response->sourceTimestamp = value->hasSourceTimestamp ?
+            (value->sourceTimestamp - UA_DATETIME_UNIX_EPOCH) / UA_USEC_TO_DATETIME : 0;
+    response->serverTimestamp = value->hasServerTimestamp ?
+            (value->serverTimestamp - UA_DATETIME_UNIX_EPOCH) / UA_USEC_TO_DATETIME : 0;
+    response->receiveTimestamp = get_report_time_us();
+}
+
+/**
+ * @brief deliverInlineReport - Hands a DATACHANGE notification to the application without queueing
+ * @param subInfo - Subscription information of the monitored item
+ * @param valueAlias - Value alias of the monitored item
+ * @param value - Changed value
+ */
+static void deliverInlineReport(subscriptionInfo *subInfo, const char *valueAlias, UA_DataValue *value)
+{
+    /* Everything but the parsed value is borrowed for the duration of the callback */
+    EdgeNodeInfo nodeInfo;
+    memset(&nodeInfo, 0, sizeof(EdgeNodeInfo));
+    nodeInfo.valueAlias = (char *) valueAlias;
+
+    EdgeResponse response;
+    memset(&response, 0, sizeof(EdgeResponse));
+    response.nodeInfo = &nodeInfo;
+    EdgeResponse *responses[1] = { &response };
+
+    EdgeMessage reportMsg;
+    memset(&reportMsg, 0, sizeof(EdgeMessage));
+    reportMsg.endpointInfo = subInfo->msg->endpointInfo;
+    reportMsg.message_id = subInfo->msg->message_id;
+    reportMsg.type = REPORT;
+    reportMsg.responseLength = 1;
+    reportMsg.responses = responses;
+
+    setEdgeTimeInfo(&reportMsg.serverTime);
+
+    setReportTimestamps(&response, value);
+    response.message = takeResponse(&response, &value->value);
+    VERIFY_NON_NULL_NR_MSG(response.message, "takeResponse FAILED in deliverInlineReport\n");
+
+    deliver_inline(&reportMsg);
+
+    freeEdgeVersatilityByType(response.message, response.type);
+}
+
+/**
+ * @brief sendPooledReport - Queues the notification in a report recycled from the session pool
+ * @param pool - Report pool of the client session
+ * @param subInfo - Subscription information of the monitored item
+ * @param valueAlias - Interned value alias of the monitored item
+ * @param value - Changed value
+ */
+static void sendPooledReport(EdgeReportPool *pool, subscriptionInfo *subInfo, const char *valueAlias,
+        UA_DataValue *value)
+{
+    EdgeMessage *report = acquireEdgeReport(pool, valueAlias);
+    VERIFY_NON_NULL_NR_MSG(report, "acquireEdgeReport FAILED in monitoredItemHandler\n");
+    report->message_id = subInfo->msg->message_id;
+
+    EdgeResponse *response = report->responses[0];
+    setReportTimestamps(response, value);
+    int type = get_response_type(value->value.type);
+    bool stored = false;
+    if (UA_Variant_isScalar(&value->value) && isInlineScalarType(type))
+    {
+        stored = setEdgeReportScalar(report, type, value->value.data, get_size(type, false));
+    }
+    if (!stored)
+    {
+        response->message = takeResponse(response, &value->value);
+        if (IS_NULL(response->message))
+        {
+            EDGE_LOG(TAG, "Error : takeResponse failed in monitor item handler\n");
+            freeEdgeMessage(report);
+            return;
+        }
+    }
+
+    /* Adding the subscription response to receiver Q */
+    add_to_recvQ(report);
+}
+
+/**
+ * @brief createReportMessage - Creates an empty REPORT message of the subscription
+ * @param subInfo - Subscription information of the monitored item
+ * @return REPORT message without responses, NULL on failure
+ */
+static EdgeMessage *createReportMessage(subscriptionInfo *subInfo)
+{
+    EdgeMessage *resultMsg = allocEdgeMessage();
+    VERIFY_NON_NULL_MSG(resultMsg, "EdgeCalloc FAILED for edgeMessage in createReportMessage\n", NULL);
+
+    setMessageEndpointInfo(resultMsg, shareMessageEndpointInfo(subInfo->msg));
+    if(IS_NULL(resultMsg->endpointInfo))
+    {
+        EDGE_LOG(TAG, "Error : EdgeCalloc failed for resultMsg.endpointInfo in monitor item handler\n");
+        freeEdgeMessage(resultMsg);
+        return NULL;
+    }
+
+    setEdgeTimeInfo(&resultMsg->serverTime);
+
+    resultMsg->message_id = subInfo->msg->message_id;
+    resultMsg->type = REPORT;
+    resultMsg->responseLength = 0;
+    return resultMsg;
+}
+
+/**
+ * @brief createReportResponse - Creates the response of a DATACHANGE notification
+ * @param valueAlias - Value alias of the monitored item
+ * @param value - Changed value
+ * @return Response on success, NULL on failure
+ */
+static EdgeResponse *createReportResponse(const char *valueAlias, UA_DataValue *value)
+{
+    EdgeResponse *response = (EdgeResponse *) EdgeCalloc(1, sizeof(EdgeResponse));
+    VERIFY_NON_NULL_MSG(response, "EdgeCalloc FAILED for response in createReportResponse\n", NULL);
+
+    response->nodeInfo = (EdgeNodeInfo *) EdgeCalloc(1, sizeof(EdgeNodeInfo));
+    if(IS_NULL(response->nodeInfo))
+    {
+        EDGE_LOG(TAG, "Error : Malloc failed for response->nodeInfo in monitor item handler\n");
+        goto RESPONSE_ERROR;
+    }
+    response->nodeInfo->valueAlias = (char *) EdgeMalloc(strlen(valueAlias) + 1);
+    if(IS_NULL(response->nodeInfo->valueAlias))
+    {
+        EDGE_LOG(TAG, "Error : Malloc failed for response->nodeInfo->valueAlias in monitor item handler\n");
+        goto RESPONSE_ERROR;
+    }
+    strncpy(response->nodeInfo->valueAlias, valueAlias, strlen(valueAlias)+1);
+
+    response->message = takeResponse(response, &value->value);
+    if(IS_NULL(response->message))
+    {
+        EDGE_LOG(TAG, "Error : Malloc failed for versatility in monitor item handler\n");
+        goto RESPONSE_ERROR;
+    }
+    setReportTimestamps(response, value);
+    return response;
+
+    RESPONSE_ERROR:
+    /* Free memory */
+    freeEdgeResponse(response);
+    return NULL;
+}
+
+/**
+ * @brief getReportBatch - Gets the batched REPORT message of the subscription, it is created
+ * on the first notification of the publish response
+ * @param clientSub - Subscriptions of the client
+ * @param subInfo - Subscription information of the monitored item
+ * @return Batch on success, NULL on failure
+ */
+static reportBatch *getReportBatch(clientSubscription *clientSub, subscriptionInfo *subInfo)
+{
+    for (size_t i = 0; i < clientSub->reportBatchCount; i++)
+    {
+        if (clientSub->reportBatches[i].subId == subInfo->subId)
+        {
+            return &clientSub->reportBatches[i];
+        }
+    }
+
+    if (clientSub->reportBatchCount == clientSub->reportBatchCapacity)
+    {
+        size_t capacity = (0 == clientSub->reportBatchCapacity) ? 1 : clientSub->reportBatchCapacity * 2;
+        reportBatch *batches = (reportBatch *) EdgeRealloc(clientSub->reportBatches,
+                capacity * sizeof(reportBatch));
+        VERIFY_NON_NULL_MSG(batches, "EdgeRealloc FAILED for reportBatches in getReportBatch\n", NULL);
+        clientSub->reportBatches = batches;
+        clientSub->reportBatchCapacity = capacity;
+    }
+
+    EdgeMessage *report = createReportMessage(subInfo);
+    VERIFY_NON_NULL_MSG(report, "createReportMessage FAILED in getReportBatch\n", NULL);
+
+    reportBatch *batch = &clientSub->reportBatches[clientSub->reportBatchCount++];
+    batch->subId = subInfo->subId;
+    batch->report = report;
+    batch->capacity = 0;
+    return batch;
+}
+
+/**
+ * @brief addBatchedReport - Adds the notification to the batched REPORT message of its subscription,
+ * the message is queued by sendBatchedReports() once the publish response is processed
+ * @param clientSub - Subscriptions of the client
+ * @param subInfo - Subscription information of the monitored item
+ * @param valueAlias - Value alias of the monitored item
+ * @param value - Changed value
+ */
+static void addBatchedReport(clientSubscription *clientSub, subscriptionInfo *subInfo,
+        const char *valueAlias, UA_DataValue *value)
+{
+    reportBatch *batch = getReportBatch(clientSub, subInfo);
+    VERIFY_NON_NULL_NR_MSG(batch, "getReportBatch FAILED in addBatchedReport\n");
+
+    EdgeMessage *report = batch->report;
+    if (report->responseLength == batch->capacity)
+    {
+        size_t capacity = (0 == batch->capacity) ? EDGE_UA_REPORT_BATCH_SIZE : batch->capacity * 2;
+        EdgeResponse **responses = (EdgeResponse **) EdgeRealloc(report->responses,
+                capacity * sizeof(EdgeResponse *));
+        VERIFY_NON_NULL_NR_MSG(responses, "EdgeRealloc FAILED for responses in addBatchedReport\n");
+        report->responses = responses;
+        batch->capacity = capacity;
+    }
+
+    EdgeResponse *response = createReportResponse(valueAlias, value);
+    VERIFY_NON_NULL_NR_MSG(response, "createReportResponse FAILED in addBatchedReport\n");
+    report->responses[report->responseLength++] = response;
+}
+
+/**
+ * @brief sendBatchedReports - Queues the batched REPORT messages of the processed publish response
+ * @param clientSub - Subscriptions of the client
+ */
+static void sendBatchedReports(clientSubscription *clientSub)
+{
+    for (size_t i = 0; i < clientSub->reportBatchCount; i++)
+    {
+        EdgeMessage *report = clientSub->reportBatches[i].report;
+        if (report->responseLength > 0)
+        {
+            /* Adding the subscription responses to receiver Q */
+            add_to_recvQ(report);
+        }
+        else
+        {
+            freeEdgeMessage(report);
+        }
+    }
+    clientSub->reportBatchCount = 0;
+}
+
+/**
+ * @brief monitoredItemHandler - Callback function for getting DATACHANGE notifications for subscribed nodes
+ * @param client - Client handle
+ * @param monId - MonitoredItem Id
+ * @param value - Changed value
+ * @param context - Context
+ */
+static void monitoredItemHandler(UA_Client *client, UA_UInt32 monId, UA_DataValue *value, void *context)
+{
+    (void) client;
+
+    if (value->status != UA_STATUSCODE_GOOD)
+    {
+        EDGE_LOG_V(TAG, "ERROR :: Received Value Status Code %s\n", UA_StatusCode_name(value->status));
+        return;
+    }
+
+    COND_CHECK_NR_MSG((!value->hasValue), "");
+
+    EDGE_LOG_V(TAG, "Notification received. Value is present, monId :: %d\n", monId);
+    logCurrentTimeStamp();
+
+    client_valueAlias *client_alias = (client_valueAlias*) context;
+    const char *valueAlias = client_alias->valueAlias;
+
+    /* The context links straight to the entry, no lookup in the subscription maps */
+    clientSubscription *clientSub = client_alias->clientSub;
+    VERIFY_NON_NULL_NR_MSG(clientSub, "clientSubscription recevied is NULL in monitoredItemHandler\n");
+    NOTIFICATION_COUNT_INCREMENT(&clientSub->notificationCount);
+
+    subscriptionInfo *subInfo = client_alias->subInfo;
+    VERIFY_NON_NULL_NR_MSG(subInfo, "subscription info received in NULL in monitoredItemHandler\n");
+
+#ifdef ENABLE_VALUE_CACHE
+    putCachedValue(client_alias->client, client_alias->nsIndex, valueAlias, value);
+#endif
+
+    if (is_inline_reports_enabled())
+    {
+        deliverInlineReport(subInfo, valueAlias, value);
+        return;
+    }
+
+    /* Queued samples of the item arrive in the same publish response, they are reported together */
+    if (is_batched_reports_enabled() || subInfo->queueSize > 1)
+    {
+        addBatchedReport(clientSub, subInfo, valueAlias, value);
+        return;
+    }
+
+    if (IS_NOT_NULL(clientSub->reportPool))
+    {
+        sendPooledReport(clientSub->reportPool, subInfo, valueAlias, value);
+        return;
+    }
+
+    EdgeMessage *resultMsg = createReportMessage(subInfo);
+    VERIFY_NON_NULL_NR_MSG(resultMsg, "createReportMessage FAILED in monitoredItemHandler\n");
+
+    resultMsg->responses = (EdgeResponse **) EdgeCalloc(1, sizeof(EdgeResponse*));
+    if(IS_NULL(resultMsg->responses))
+    {
+        EDGE_LOG(TAG, "Error : Malloc failed for resultMsg.responses in monitor item handler\n");
+        goto SUBSCRIPTION_ERROR;
+    }
+
+    resultMsg->responses[0] = createReportResponse(valueAlias, value);
+    if(IS_NULL(resultMsg->responses[0]))
+    {
+        goto SUBSCRIPTION_ERROR;
+    }
+    resultMsg->responseLength = 1;
+
+    /* Adding the subscription response to receiver Q */
+    add_to_recvQ(resultMsg);
+
+    return;
+
+    SUBSCRIPTION_ERROR:
+    /* Free memory */
+    freeEdgeMessage(resultMsg);
+}
+
+/**
+ * @brief sendSessionPublish - Sends a publish request of the session and schedules the next one.
+ * Called by a reactor thread with reactorMutex held, it is released while the request is sent.
+ * @param clientSub - Subscriptions of the client, marked as busy by the caller
+ * @param now - Current time in microseconds
+ */
+static void sendSessionPublish(clientSubscription *clientSub, uint64_t now)
+{
+    oc_mutex_unlock(reactorMutex);
+#ifndef ENABLE_SUB_QUEUE
+    pthread_mutex_lock(&clientSub->serializeMutex);
+    UA_StatusCode ret = recoverSession(clientSub);
+    if (UA_STATUSCODE_GOOD == ret)
+    {
+        ret = sendPublishRequest(clientSub->client);
+        markSessionLost(clientSub, ret);
+    }
+    sendBatchedReports(clientSub);
+    pthread_mutex_unlock(&clientSub->serializeMutex);
+    oc_mutex_lock(reactorMutex);
+    clientSub->publishing = false;
+    schedulePublish(clientSub, now, ret);
+#else
+    bool queued = false;
+    EdgeMessage *publishMsg = allocEdgeMessage();
+    if (IS_NOT_NULL(publishMsg))
+    {
+        publishMsg->type = SEND_REQUEST;
+        publishMsg->command = CMD_SUB;
+        publishMsg->message_id = EdgeGetMessageId();
+        publishMsg->endpointInfo = (EdgeEndPointInfo *) EdgeCalloc(1, sizeof(EdgeEndPointInfo));
+        publishMsg->request = (EdgeRequest *) EdgeCalloc(1, sizeof(EdgeRequest));
+        if (IS_NOT_NULL(publishMsg->endpointInfo) && IS_NOT_NULL(publishMsg->request))
+        {
+            publishMsg->endpointInfo->endpointUri = cloneString(clientSub->endpointUri);
+            publishMsg->request->subMsg = (EdgeSubRequest *) EdgeCalloc(1, sizeof(EdgeSubRequest));
+        }
+        if (IS_NULL(publishMsg->endpointInfo) || IS_NULL(publishMsg->request)
+                || IS_NULL(publishMsg->endpointInfo->endpointUri) || IS_NULL(publishMsg->request->subMsg))
+        {
+            EDGE_LOG(TAG, "Error : Malloc failed for the publish message\n");
+            freeEdgeMessage(publishMsg);
+        }
+        else
+        {
+            publishMsg->request->subMsg->subType = Edge_Publish_Sub;
+            /* The request is scheduled again by completePublish() once the dispatcher has sent it */
+            queued = add_to_sendQ(publishMsg);
+        }
+    }
+    oc_mutex_lock(reactorMutex);
+    if (!queued)
+    {
+        clientSub->publishQueued = false;
+        schedulePublish(clientSub, now, UA_STATUSCODE_BADRESOURCEUNAVAILABLE);
+    }
+#endif
+    oc_cond_broadcast(reactorCond);
+}
+
+/**
+ * @brief publishReactorHandler - Thread of the publish reactor. Sends publish requests of the session
+ * which has been due for the longest time and waits for the earliest due time otherwise.
+ * Publish requests are sent one at a time per session, when the shortest publishing interval of its
+ * subscriptions has passed since the last one. The server holds a request until it has
+ * notifications or the keep alive count expires, so notifications are reported as they arrive.
+ * @param ptr - Unused
+ */
+static void *publishReactorHandler(void *ptr)
+{
+    (void) ptr;
+    applyEdgeThreadConfig(EDGE_THREAD_SUBSCRIPTION);
+    EDGE_LOG(TAG, ">>>>>>>>>>>>>>>>>> publish reactor thread created <<<<<<<<<<<<<<<<<<<<");
+
+    oc_mutex_lock(reactorMutex);
+    while (reactorRunning)
+    {
+        uint64_t now = oc_get_time_us();
+        clientSubscription *due = NULL;
+        uint64_t wakeAt = 0;
+        for (clientSubscription *session = reactorSessions; session; session = session->nextSession)
+        {
+            if (session->publishing || session->publishQueued)
+            {
+                continue;
+            }
+            if (session->nextPublishTime <= now)
+            {
+                if (IS_NULL(due) || session->nextPublishTime < due->nextPublishTime)
+                {
+                    due = session;
+                }
+            }
+            else if (0 == wakeAt || session->nextPublishTime < wakeAt)
+            {
+                wakeAt = session->nextPublishTime;
+            }
+        }
+
+        if (IS_NULL(due))
+        {
+            /* Woken up by a change of the sessions, a sent publish request or the stop */
+            if (0 == wakeAt)
+            {
+                oc_cond_wait(reactorCond, reactorMutex);
+            }
+            else
+            {
+                oc_cond_wait_for(reactorCond, reactorMutex, wakeAt - now);
+            }
+            continue;
+        }
+
+#ifndef ENABLE_SUB_QUEUE
+        due->publishing = true;
+#else
+        due->publishQueued = true;
+#endif
+        sendSessionPublish(due, now);
+    }
+    oc_mutex_unlock(reactorMutex);
+
+    EDGE_LOG(TAG, ">>>>>>>>>>>>>>>>>> publish reactor thread destroyed <<<<<<<<<<<<<<<<<<<<");
+    return NULL;
+}
+
+/**
+ * @brief stopPublishReactor - Stops the threads of the publish reactor.
+ * Must be called with reactorLifecycleMutex held.
+ */
+static void stopPublishReactor()
+{
+    if (IS_NULL(reactorMutex))
+    {
+        return;
+    }
+    oc_mutex_lock(reactorMutex);
+    reactorRunning = false;
+    oc_cond_broadcast(reactorCond);
+    oc_mutex_unlock(reactorMutex);
+
+    for (size_t i = 0; i < reactorThreadCount; i++)
+    {
+        oc_thread_wait(reactorThreads[i]);
+        oc_thread_free(reactorThreads[i]);
+    }
+    reactorThreadCount = 0;
+    oc_cond_free(reactorCond);
+    oc_mutex_free(reactorMutex);
+    reactorCond = NULL;
+    reactorMutex = NULL;
+}
+
+/**
+ * @brief addPublishSession - Adds a session to the publish reactor, which is started if needed.
+ * A thread is added for each session until there are EDGE_UA_PUBLISH_REACTOR_THREADS of them.
+ * @param clientSub - Subscriptions of the client
+ * @return true on success
+ */
+static bool addPublishSession(clientSubscription *clientSub)
+{
+    bool added = false;
+    pthread_mutex_lock(&reactorLifecycleMutex);
+    if (IS_NULL(reactorMutex))
+    {
+        reactorMutex = oc_mutex_new();
+        reactorCond = oc_cond_new();
+        reactorRunning = true;
+        if (IS_NULL(reactorMutex) || IS_NULL(reactorCond))
+        {
+            EDGE_LOG(TAG, "Error : Failed to create the publish reactor\n");
+            if (IS_NOT_NULL(reactorCond))
+            {
+                oc_cond_free(reactorCond);
+            }
+            if (IS_NOT_NULL(reactorMutex))
+            {
+                oc_mutex_free(reactorMutex);
+            }
+            reactorCond = NULL;
+            reactorMutex = NULL;
+            goto EXIT;
+        }
+    }
+
+    if (reactorThreadCount < EDGE_UA_PUBLISH_REACTOR_THREADS && reactorThreadCount <= reactorSessionCount)
+    {
+        if (OC_THREAD_SUCCESS == oc_thread_new(&reactorThreads[reactorThreadCount],
+                publishReactorHandler, NULL))
+        {
+            reactorThreadCount++;
+        }
+        else
+        {
+            EDGE_LOG(TAG, "Error : Failed to create a publish reactor thread\n");
+        }
+    }
+    if (0 == reactorThreadCount)
+    {
+        stopPublishReactor();
+        goto EXIT;
+    }
+
+    oc_mutex_lock(reactorMutex);
+    clientSub->reactorActive = true;
+    clientSub->nextPublishTime = 0;
+    clientSub->publishing = false;
+    clientSub->publishQueued = false;
+    clientSub->nextSession = reactorSessions;
+    reactorSessions = clientSub;
+    reactorSessionCount++;
+    oc_cond_broadcast(reactorCond);
+    oc_mutex_unlock(reactorMutex);
+    added = true;
+
+EXIT:
+    pthread_mutex_unlock(&reactorLifecycleMutex);
+    return added;
+}
+
+/**
+ * @brief removePublishSession - Removes a session from the publish reactor once its publish request
+ * in progress is done. The reactor is stopped with its last session.
+ * @param clientSub - Subscriptions of the client
+ */
+static void removePublishSession(clientSubscription *clientSub)
+{
+    pthread_mutex_lock(&reactorLifecycleMutex);
+    if (!clientSub->reactorActive)
+    {
+        pthread_mutex_unlock(&reactorLifecycleMutex);
+        return;
+    }
+
+    oc_mutex_lock(reactorMutex);
+    clientSubscription **link = &reactorSessions;
+    while (*link && *link != clientSub)
+    {
+        link = &(*link)->nextSession;
+    }
+    if (*link)
+    {
+        *link = clientSub->nextSession;
+    }
+    clientSub->nextSession = NULL;
+    clientSub->reactorActive = false;
+    reactorSessionCount--;
+    /* A queued publish request is sent by this thread, it is not waited for */
+    while (clientSub->publishing)
+    {
+        oc_cond_wait(reactorCond, reactorMutex);
+    }
+    oc_mutex_unlock(reactorMutex);
+
+    if (0 == reactorSessionCount)
     {
-        subscriptionInfo *subInfo = (subscriptionInfo *) temp->value;
-        if (subInfo->subId == subId && subInfo->monId == monId)
-            return false;
-        temp = temp->next;
+        stopPublishReactor();
     }
-    return true;
+    pthread_mutex_unlock(&reactorLifecycleMutex);
 }
 
 /**
- * @brief hasSubscriptionId - Function that checks whether subscription id is valid
- * @param list - subscription list
- * @param subId - subscription Id to check whether its valid
- * @return
+ * @brief checkDuplicateRequests - Checks that no node is requested twice in the message
+ * @param msg - Create subscription message
+ * @return GOOD status if every value alias is requested once
  */
-static bool hasSubscriptionId(edgeMap *list, UA_UInt32 subId)
+static UA_StatusCode checkDuplicateRequests(const EdgeMessage *msg)
 {
-    VERIFY_NON_NULL_MSG(list, "", false);
-    edgeMapNode *temp = list->head;
-    while (temp != NULL)
+    EdgeHashMap *aliases = createEdgeHashMap(EDGE_HASH_STRING_KEY);
+    VERIFY_NON_NULL_MSG(aliases, "createEdgeHashMap FAILED in checkDuplicateRequests\n",
+            UA_STATUSCODE_BADOUTOFMEMORY);
+
+    UA_StatusCode ret = UA_STATUSCODE_GOOD;
+    for (size_t i = 0; i < msg->requestLength; i++)
     {
-        subscriptionInfo *subInfo = (subscriptionInfo *)temp->value;
-        COND_CHECK((subInfo->subId == subId), true);
-        temp = temp->next;
+        char *valueAlias = msg->requests[i]->nodeInfo->valueAlias;
+        /* Item numbers are stored, they start at 1 */
+        keyValue first = getEdgeHashMapElement(aliases, (keyValue) valueAlias);
+        if (IS_NOT_NULL(first))
+        {
+            EDGE_LOG_V(TAG, "Error :Message contains dublicate requests\n"
+                "Item No : %d & %d\nItem Name : %s\nThis Subscription request was not processed to server.\n",
+                (int) (uintptr_t) first, (int) i + 1, valueAlias);
+            ret = UA_STATUSCODE_BADREQUESTCANCELLEDBYCLIENT;
+            break;
+        }
+        if (!insertEdgeHashMapElement(aliases, (keyValue) valueAlias, (keyValue) (uintptr_t) (i + 1)))
+        {
+            ret = UA_STATUSCODE_BADOUTOFMEMORY;
+            break;
+        }
     }
-    return false;
+    deleteEdgeHashMap(aliases);
+    return ret;
 }
 
 /**
- * @brief get_subscription_list - Gets the subscription list associated with particular client handle
+ * @brief addMonitoredItems - Creates the monitored items in as many CreateMonitoredItems requests
+ * as the OperationLimits of the server require
  * @param client - Client handle
- * @return void pointer representing the client handle info.
+ * @param subId - Subscription Id
+ * @param items - Items to create
+ * @param itemSize - Number of items
+ * @param hfs - Handling functions of the items
+ * @param contexts - Contexts of the handling functions
+ * @param itemResults - Result of each item
+ * @param monId - Monitored item Id of each item, 0 if it was not created
+ * @return GOOD status if every request was sent, otherwise the error of the first failed request.
+ *         The items of a failed request get its error as result.
  */
-static void* get_subscription_list(UA_Client *client)
+static UA_StatusCode addMonitoredItems(UA_Client *client, UA_UInt32 subId,
+        UA_MonitoredItemCreateRequest *items, size_t itemSize, UA_MonitoredItemHandlingFunction *hfs,
+        void **contexts, UA_StatusCode *itemResults, UA_UInt32 *monId)
 {
-    VERIFY_NON_NULL_MSG(clientSubMap, "", NULL);
-    edgeMapNode *temp = clientSubMap->head;
-    while (NULL != temp)
+    EdgeServerCapabilities capabilities;
+    getServerCapabilities(client, &capabilities);
+    size_t chunkSize = capabilities.maxMonitoredItemsPerCall;
+    if (0 == chunkSize || chunkSize > itemSize)
     {
-        // Check whether its valid client handle and return the subscription details for the client
-        COND_CHECK((temp->key == client), temp->value);
-        temp = temp->next;
+        chunkSize = itemSize;
     }
-    return NULL;
+
+    UA_StatusCode ret = UA_STATUSCODE_GOOD;
+    for (size_t offset = 0; offset < itemSize; offset += chunkSize)
+    {
+        size_t count = (itemSize - offset < chunkSize) ? itemSize - offset : chunkSize;
+        UA_StatusCode retChunk = UA_Client_Subscriptions_addMonitoredItems(client, subId,
+                items + offset, count, hfs + offset, contexts + offset, itemResults + offset,
+                monId + offset);
+        if (retChunk != UA_STATUSCODE_GOOD)
+        {
+            EDGE_LOG_V(TAG, "Error in creating monitored items %d to %d :: %s\n", (int) offset + 1,
+                    (int) (offset + count), UA_StatusCode_name(retChunk));
+            for (size_t i = offset; i < offset + count; i++)
+            {
+                if (0 == monId[i] && itemResults[i] == UA_STATUSCODE_GOOD)
+                {
+                    itemResults[i] = retChunk;
+                }
+            }
+            if (ret == UA_STATUSCODE_GOOD)
+            {
+                ret = retChunk;
+            }
+        }
+    }
+    return ret;
 }
 
 /**
- * @brief getSubInfo - Gets subscription information from the list with valueAlias filter
- * @param list - subscription list
- * @param valueAlias - value alias
- * @return keyValue
+ * @brief sendItemResults - Queues one response with the result of each item of a bulk creation
+ * @param msg - Create subscription message
+ * @param itemResults - Result of each item
  */
-static keyValue getSubInfo(edgeMap* list, const char *valueAlias)
+static void sendItemResults(const EdgeMessage *msg, const UA_StatusCode *itemResults)
 {
-    VERIFY_NON_NULL_MSG(list, "", NULL);
-    edgeMapNode *temp = list->head;
-    while (temp != NULL)
+    size_t reqLen = msg->requestLength;
+    EdgeMessage *resultMsg = allocEdgeMessage();
+    VERIFY_NON_NULL_NR_MSG(resultMsg, "EdgeCalloc FAILED for resultMsg in sendItemResults\n");
+
+    setMessageEndpointInfo(resultMsg, shareMessageEndpointInfo(msg));
+    if (IS_NULL(resultMsg->endpointInfo))
+    {
+        EDGE_LOG(TAG, "Error : Malloc Failed for resultMsg->endpointInfo in sendItemResults");
+        goto ERROR;
+    }
+    resultMsg->command = CMD_SUB;
+    resultMsg->type = GENERAL_RESPONSE;
+    resultMsg->message_id = msg->message_id;
+
+    resultMsg->responses = (EdgeResponse **) EdgeCalloc(reqLen, sizeof(EdgeResponse *));
+    if (IS_NULL(resultMsg->responses))
     {
-        if (!strcmp(temp->key, valueAlias))
+        EDGE_LOG(TAG, "Error : Malloc Failed for responses in sendItemResults");
+        goto ERROR;
+    }
+
+    for (size_t i = 0; i < reqLen; i++)
+    {
+        EdgeResponse *response = (EdgeResponse *) EdgeCalloc(1, sizeof(EdgeResponse));
+        if (IS_NULL(response))
+        {
+            goto ERROR;
+        }
+        resultMsg->responses[resultMsg->responseLength++] = response;
+        response->requestId = msg->requests[i]->requestId;
+        response->nodeInfo = cloneEdgeNodeInfo(msg->requests[i]->nodeInfo);
+        response->message = (EdgeVersatility *) EdgeCalloc(1, sizeof(EdgeVersatility));
+        if (IS_NULL(response->nodeInfo) || IS_NULL(response->message))
+        {
+            EDGE_LOG(TAG, "Error : Malloc Failed for EdgeResponse in sendItemResults");
+            goto ERROR;
+        }
+        response->message->value = cloneString(UA_StatusCode_name(itemResults[i]));
+        if (IS_NULL(response->message->value))
         {
-            return temp->value;
+            EDGE_LOG(TAG, "Error : Malloc Failed for status code in sendItemResults");
+            goto ERROR;
         }
-        temp = temp->next;
     }
-    return NULL;
+
+    /* Adding the item results to receiver Q */
+    add_to_recvQ(resultMsg);
+    return;
+
+    ERROR:
+    /* Free memory */
+    freeEdgeMessage(resultMsg);
 }
 
 /**
- * @brief removeSubFromMap - Remove the subscription information from the subscription list
- * @param list - subscription list
- * @param valueAlias - value alias
- * @return the removed subscription info
+ * @brief createSubscriptionMessage - Creates the message kept by an item of the subscription.
+ * Reports only need its endpoint and message id, so the requests are not copied.
+ * @param msg - Create subscription message
+ * @return Message on success, NULL on failure
  */
-static edgeMapNode *removeSubFromMap(edgeMap *list, const char *valueAlias)
+static EdgeMessage *createSubscriptionMessage(const EdgeMessage *msg)
 {
-    edgeMapNode *temp = list->head;
-    edgeMapNode *prev = NULL;
-    while (temp != NULL)
+    EdgeMessage *subMsg = allocEdgeMessage();
+    VERIFY_NON_NULL_MSG(subMsg, "EdgeCalloc FAILED in createSubscriptionMessage\n", NULL);
+    subMsg->type = msg->type;
+    subMsg->command = msg->command;
+    subMsg->message_id = msg->message_id;
+    setMessageEndpointInfo(subMsg, shareMessageEndpointInfo(msg));
+    if (IS_NULL(subMsg->endpointInfo))
     {
-        if (!strcmp(temp->key, valueAlias))
-        {
-            if (prev == NULL)
-            {
-                list->head = temp->next;
-            }
-            else
-            {
-                prev->next = temp->next;
-            }
-
-            return temp;
-        }
-        prev = temp;
-        temp = temp->next;
+        freeEdgeMessage(subMsg);
+        return NULL;
     }
-    return NULL;
+    return subMsg;
 }
 
-#ifndef ENABLE_SUB_QUEUE
-void sendPublishRequest(UA_Client *client)
+/**
+ * @brief getQueueSize - Gets the requested queue size of a monitored item
+ * @param subReq - Subscription request
+ * @return Queue size, at least 1
+ */
+static UA_UInt32 getQueueSize(const EdgeSubRequest *subReq)
 {
-    UA_Client_Subscriptions_manuallySendPublishRequest(client);
+    return (subReq->queueSize > 1) ? subReq->queueSize : 1;
 }
-#endif
 
 /**
- * @brief monitoredItemHandler - Callback function for getting DATACHANGE notifications for subscribed nodes
- * @param client - Client handle
- * @param monId - MonitoredItem Id
- * @param value - Changed value
- * @param context - Context
+ * @brief setDataChangeFilter - Sets the data change filter of the request in the monitoring parameters
+ * @param subReq - Subscription request
+ * @param filter - Storage of the filter, it must live until the request is sent
+ * @param params - Monitoring parameters, they do not own the filter
  */
-static void monitoredItemHandler(UA_Client *client, UA_UInt32 monId, UA_DataValue *value, void *context)
+static void setDataChangeFilter(const EdgeSubRequest *subReq, UA_DataChangeFilter *filter,
+        UA_MonitoringParameters *params)
 {
-    (void) client;
-
-    if (value->status != UA_STATUSCODE_GOOD)
+    if (EDGE_DEADBAND_NONE == subReq->deadbandType
+            && EDGE_DATACHANGE_TRIGGER_STATUS_VALUE == subReq->trigger)
     {
-        EDGE_LOG_V(TAG, "ERROR :: Received Value Status Code %s\n", UA_StatusCode_name(value->status));
+        /* The server applies its default filter */
         return;
     }
 
-    COND_CHECK_NR_MSG((!value->hasValue), "");
-
-    EDGE_LOG_V(TAG, "Notification received. Value is present, monId :: %d\n", monId);
-    logCurrentTimeStamp();
-
-    client_valueAlias *client_alias = (client_valueAlias*) context;
-    char *valueAlias = client_alias->valueAlias;
-
-    clientSubscription *clientSub = (clientSubscription*) get_subscription_list(client_alias->client);
-    VERIFY_NON_NULL_NR_MSG(clientSub, "clientSubscription recevied is NULL in monitoredItemHandler\n");
+    UA_DataChangeFilter_init(filter);
+    switch (subReq->trigger)
+    {
+        case EDGE_DATACHANGE_TRIGGER_STATUS:
+            filter->trigger = UA_DATACHANGETRIGGER_STATUS;
+            break;
+        case EDGE_DATACHANGE_TRIGGER_STATUS_VALUE_TIMESTAMP:
+            filter->trigger = UA_DATACHANGETRIGGER_STATUSVALUETIMESTAMP;
+            break;
+        default:
+            filter->trigger = UA_DATACHANGETRIGGER_STATUSVALUE;
+            break;
+    }
+    switch (subReq->deadbandType)
+    {
+        case EDGE_DEADBAND_ABSOLUTE:
+            filter->deadbandType = UA_DEADBANDTYPE_ABSOLUTE;
+            break;
+        case EDGE_DEADBAND_PERCENT:
+            filter->deadbandType = UA_DEADBANDTYPE_PERCENT;
+            break;
+        default:
+            filter->deadbandType = UA_DEADBANDTYPE_NONE;
+            break;
+    }
+    filter->deadbandValue = (UA_DEADBANDTYPE_NONE == filter->deadbandType) ? 0.0 : subReq->deadbandValue;
 
-    subscriptionInfo *subInfo = (subscriptionInfo *) getSubInfo(clientSub->subscriptionList, client_alias->valueAlias);
-    VERIFY_NON_NULL_NR_MSG(subInfo, "subscription info received in NULL in monitoredItemHandler\n");
+    params->filter.encoding = UA_EXTENSIONOBJECT_DECODED_NODELETE;
+    params->filter.content.decoded.type = &UA_TYPES[UA_TYPES_DATACHANGEFILTER];
+    params->filter.content.decoded.data = filter;
+}
 
-    EdgeMessage *resultMsg = (EdgeMessage *) EdgeCalloc(1, sizeof(EdgeMessage));
-    VERIFY_NON_NULL_NR_MSG(resultMsg, "EdgeCalloc FAILED for edgeMessage in monitoredItemHandler\n");
+/**
+ * @brief initMonitoredItem - Initializes the create request of a monitored item
+ * @param client - Client handle, registered nodes use the NodeId returned by the server
+ * @param item - Create request
+ * @param nsIndex - Namespace index of the node
+ * @param valueAlias - Value alias of the node, borrowed by the request
+ * @param subReq - Subscription request of the item
+ * @param filter - Storage of the data change filter, it must live until the request is sent
+ */
+static void initMonitoredItem(UA_Client *client, UA_MonitoredItemCreateRequest *item,
+        UA_UInt16 nsIndex, const char *valueAlias, const EdgeSubRequest *subReq,
+        UA_DataChangeFilter *filter)
+{
+    UA_MonitoredItemCreateRequest_init(item);
+    /* Neither NodeId is freed, the registered one lives until the session ends */
+    const UA_NodeId *registered = getRegisteredNodeId(client, nsIndex, valueAlias);
+    item->itemToMonitor.nodeId = IS_NOT_NULL(registered) ? *registered :
+            UA_NODEID_STRING(nsIndex, (char *) valueAlias);
+    item->itemToMonitor.attributeId = UA_ATTRIBUTEID_VALUE;
+    item->monitoringMode = UA_MONITORINGMODE_REPORTING;
+    item->requestedParameters.samplingInterval = subReq->samplingInterval;
+    item->requestedParameters.discardOldest = (EDGE_DISCARD_NEWEST != subReq->discardPolicy);
+    item->requestedParameters.queueSize = getQueueSize(subReq);
+    setDataChangeFilter(subReq, filter, &item->requestedParameters);
+}
 
-    resultMsg->endpointInfo = cloneEdgeEndpointInfo(subInfo->msg->endpointInfo);
-    if(IS_NULL(resultMsg->endpointInfo))
+/**
+ * @brief isConnectionLost - Checks whether a service failed because the connection or the session
+ * of the client is gone
+ * @param ret - Result of the service
+ * @return true if the session has to be connected again
+ */
+static bool isConnectionLost(UA_StatusCode ret)
+{
+    switch (ret)
     {
-        EDGE_LOG(TAG, "Error : EdgeCalloc failed for resultMsg.endpointInfo in monitor item handler\n");
-        goto SUBSCRIPTION_ERROR;
+        case UA_STATUSCODE_BADCONNECTIONCLOSED:
+        case UA_STATUSCODE_BADSECURECHANNELCLOSED:
+        case UA_STATUSCODE_BADSECURECHANNELIDINVALID:
+        case UA_STATUSCODE_BADSESSIONCLOSED:
+        case UA_STATUSCODE_BADSESSIONIDINVALID:
+        case UA_STATUSCODE_BADCOMMUNICATIONERROR:
+        case UA_STATUSCODE_BADSERVERNOTCONNECTED:
+        case UA_STATUSCODE_BADNOTCONNECTED:
+            return true;
+        default:
+            return false;
     }
+}
 
-    time_t rawtime;
-    time(&rawtime);
-    resultMsg->serverTime.timeInfo = localtime(&rawtime);
-
-#ifndef _WIN32
-    gettimeofday(&(resultMsg->serverTime.tv), NULL);
-#else
-    getTimeofDay(&(resultMsg->serverTime.tv), NULL);
-#endif
-
-    resultMsg->message_id = subInfo->msg->message_id;
-    resultMsg->type = REPORT;
-    resultMsg->responseLength = 1;
-    resultMsg->responses = (EdgeResponse **) EdgeCalloc(1, sizeof(EdgeResponse*));
-    if(IS_NULL(resultMsg->responses))
+/**
+ * @brief markSessionLost - Marks the session for recovery when a publish request found the
+ * connection lost. All subscriptions of the session are transferred to the new session.
+ * Must be called with serializeMutex held.
+ * @param clientSub - Subscriptions of the client
+ * @param ret - Result of the publish request
+ */
+static void markSessionLost(clientSubscription *clientSub, UA_StatusCode ret)
+{
+    if (!isConnectionLost(ret) || clientSub->sessionLost)
     {
-        EDGE_LOG(TAG, "Error : Malloc failed for resultMsg.responses in monitor item handler\n");
-        goto SUBSCRIPTION_ERROR;
+        return;
     }
+    EDGE_LOG_V(TAG, "Connection of the session lost :: %s\n", UA_StatusCode_name(ret));
 
-    resultMsg->responses[0] = (EdgeResponse *) EdgeCalloc(1, sizeof(EdgeResponse));
-    if(IS_NULL(resultMsg->responses[0]))
+    size_t cursor = 0;
+    keyValue value = NULL;
+    while (getNextEdgeHashMapElement(clientSub->subscriptionList, &cursor, NULL, &value))
     {
-        goto SUBSCRIPTION_ERROR;
+        UA_UInt32 subId = ((subscriptionInfo *) value)->subId;
+        bool listed = false;
+        for (size_t i = 0; i < clientSub->lostSubIdCount && !listed; i++)
+        {
+            listed = (clientSub->lostSubIds[i] == subId);
+        }
+        if (listed)
+        {
+            continue;
+        }
+        UA_UInt32 *ids = (UA_UInt32 *) EdgeRealloc(clientSub->lostSubIds,
+                (clientSub->lostSubIdCount + 1) * sizeof(UA_UInt32));
+        if (IS_NULL(ids))
+        {
+            EDGE_LOG(TAG, "Error : Malloc failed for the lost subscriptions\n");
+            break;
+        }
+        ids[clientSub->lostSubIdCount++] = subId;
+        clientSub->lostSubIds = ids;
     }
+    clientSub->sessionLost = true;
+}
 
-    EdgeResponse *response = resultMsg->responses[0];
-    response->nodeInfo = (EdgeNodeInfo *) EdgeCalloc(1, sizeof(EdgeNodeInfo));
-    if(IS_NULL(response->nodeInfo))
+/**
+ * @brief recreateSubscription - Creates a subscription and its monitored items again in the
+ * current session, after the server lost it. The entries of the items keep their value aliases.
+ * Must be called with serializeMutex held.
+ * @param clientSub - Subscriptions of the client
+ * @param oldSubId - Id of the lost subscription
+ * @return GOOD status if the subscription was created, or if it has no items left
+ */
+static UA_StatusCode recreateSubscription(clientSubscription *clientSub, UA_UInt32 oldSubId)
+{
+    UA_Client *client = clientSub->client;
+    size_t itemSize = 0;
+    size_t cursor = 0;
+    keyValue value = NULL;
+    while (getNextEdgeHashMapElement(clientSub->subscriptionList, &cursor, NULL, &value))
     {
-        EDGE_LOG(TAG, "Error : Malloc failed for response->nodeInfo in monitor item handler\n");
-        goto SUBSCRIPTION_ERROR;
+        itemSize += (((subscriptionInfo *) value)->subId == oldSubId) ? 1 : 0;
     }
-    response->nodeInfo->valueAlias = (char *) EdgeMalloc(strlen(valueAlias) + 1);
-    if(IS_NULL(response->nodeInfo->valueAlias))
+    /* The local state of the lost subscription is not needed any more */
+    UA_Client_Subscriptions_remove(client, oldSubId);
+    COND_CHECK((0 == itemSize), UA_STATUSCODE_GOOD);
+
+    UA_StatusCode ret = UA_STATUSCODE_BADOUTOFMEMORY;
+    subscriptionInfo **infos = (subscriptionInfo **) EdgeCalloc(itemSize, sizeof(subscriptionInfo *));
+    UA_MonitoredItemCreateRequest *items = (UA_MonitoredItemCreateRequest *) EdgeCalloc(itemSize,
+            sizeof(UA_MonitoredItemCreateRequest));
+    UA_DataChangeFilter *filters = (UA_DataChangeFilter *) EdgeCalloc(itemSize,
+            sizeof(UA_DataChangeFilter));
+    UA_MonitoredItemHandlingFunction *hfs = (UA_MonitoredItemHandlingFunction *) EdgeCalloc(itemSize,
+            sizeof(UA_MonitoredItemHandlingFunction));
+    void **contexts = (void **) EdgeCalloc(itemSize, sizeof(void *));
+    UA_StatusCode *itemResults = (UA_StatusCode *) EdgeCalloc(itemSize, sizeof(UA_StatusCode));
+    UA_UInt32 *monId = (UA_UInt32 *) EdgeCalloc(itemSize, sizeof(UA_UInt32));
+    if (IS_NULL(infos) || IS_NULL(items) || IS_NULL(filters) || IS_NULL(hfs) || IS_NULL(contexts)
+            || IS_NULL(itemResults) || IS_NULL(monId))
     {
-        EDGE_LOG(TAG, "Error : Malloc failed for response->nodeInfo->valueAlias in monitor item handler\n");
-        goto SUBSCRIPTION_ERROR;
+        EDGE_LOG(TAG, "Error : Malloc failed in recreateSubscription\n");
+        goto EXIT;
     }
-    strncpy(response->nodeInfo->valueAlias, valueAlias, strlen(valueAlias)+1);
 
-    response->message = parseResponse(response, value->value);
-    if(IS_NULL(response->message))
+    size_t index = 0;
+    cursor = 0;
+    while (getNextEdgeHashMapElement(clientSub->subscriptionList, &cursor, NULL, &value))
     {
-        EDGE_LOG(TAG, "Error : Malloc failed for versatility in monitor item handler\n");
-        goto SUBSCRIPTION_ERROR;
+        subscriptionInfo *subInfo = (subscriptionInfo *) value;
+        if (subInfo->subId != oldSubId)
+        {
+            continue;
+        }
+        client_valueAlias *alias = (client_valueAlias *) subInfo->hfContext;
+        infos[index] = subInfo;
+        initMonitoredItem(client, &items[index], alias->nsIndex, alias->valueAlias,
+                &subInfo->request, &filters[index]);
+        hfs[index] = &monitoredItemHandler;
+        contexts[index] = alias;
+        index++;
     }
 
-    /* Adding the subscription response to receiver Q */
-    add_to_recvQ(resultMsg);
+    const EdgeSubRequest *subReq = &infos[0]->request;
+    UA_SubscriptionSettings settings =
+    { subReq->publishingInterval, /* .requestedPublishingInterval */
+    subReq->lifetimeCount, /* .requestedLifetimeCount */
+    subReq->maxKeepAliveCount, /* .requestedMaxKeepAliveCount */
+    subReq->maxNotificationsPerPublish, /* .maxNotificationsPerPublish */
+    subReq->publishingEnabled, /* .publishingEnabled */
+    subReq->priority /* .priority */
+    };
+    UA_UInt32 subId = 0;
+    ret = UA_Client_Subscriptions_new(client, settings, &subId);
+    if (!subId)
+    {
+        EDGE_LOG_V(TAG, "Error in creating the lost subscription %u again :: %s\n", oldSubId,
+                UA_StatusCode_name(ret));
+        ret = (UA_STATUSCODE_GOOD == ret) ? UA_STATUSCODE_BADSUBSCRIPTIONIDINVALID : ret;
+        goto EXIT;
+    }
 
-    return;
+    addMonitoredItems(client, subId, items, itemSize, hfs, contexts, itemResults, monId);
+    for (size_t i = 0; i < itemSize; i++)
+    {
+        /* An item the server rejects now stays without monitored item until it is deleted */
+        if (0 == monId[i] || UA_STATUSCODE_GOOD != itemResults[i])
+        {
+            EDGE_LOG_V(TAG, "Error :: %s is not monitored in the new session :: %s\n",
+                    ((client_valueAlias *) contexts[i])->valueAlias, UA_StatusCode_name(itemResults[i]));
+        }
+        infos[i]->subId = subId;
+        infos[i]->monId = monId[i];
+    }
+    EDGE_LOG_V(TAG, "Lost subscription %u created again as %u\n", oldSubId, subId);
+    ret = UA_STATUSCODE_GOOD;
 
-    SUBSCRIPTION_ERROR:
-    /* Free memory */
-    freeEdgeMessage(resultMsg);
+EXIT:
+    EdgeFree(infos);
+    EdgeFree(items);
+    EdgeFree(filters);
+    EdgeFree(hfs);
+    EdgeFree(contexts);
+    EdgeFree(itemResults);
+    EdgeFree(monId);
+    return ret;
 }
 
-static void *subscription_thread_handler(void *ptr)
+/**
+ * @brief recoverSession - Connects a lost session again and moves its subscriptions into the new
+ * session with TransferSubscriptions. Subscriptions the server does not keep any more are created
+ * again. Subscriptions which could not be recovered are retried with the next publish request.
+ * Must be called with serializeMutex held.
+ * @param clientSub - Subscriptions of the client
+ * @return GOOD status if the session is connected
+ */
+static UA_StatusCode recoverSession(clientSubscription *clientSub)
 {
-    EDGE_LOG(TAG, ">>>>>>>>>>>>>>>>>> subscription thread created <<<<<<<<<<<<<<<<<<<<");
-    #ifndef ENABLE_SUB_QUEUE
-    UA_Client *client = (UA_Client *) ptr;
-    #else
-    char *uri = (char *) ptr;
-    UA_Client *client = (UA_Client *) getSessionClient(uri);
-    #endif
+    COND_CHECK((!clientSub->sessionLost && 0 == clientSub->lostSubIdCount), UA_STATUSCODE_GOOD);
 
-    clientSubscription *clientSub = NULL;
-    clientSub = (clientSubscription*) get_subscription_list(client);
-    VERIFY_NON_NULL_MSG(clientSub, "NULL client subscription in subscription_thread_handler\n", NULL);
+    UA_Client *client = clientSub->client;
+    if (clientSub->sessionLost)
+    {
+        char *endpointUrl = (char *) EdgeCalloc(client->endpointUrl.length + 1, sizeof(char));
+        VERIFY_NON_NULL_MSG(endpointUrl, "EdgeCalloc FAILED in recoverSession\n",
+                UA_STATUSCODE_BADOUTOFMEMORY);
+        memcpy(endpointUrl, client->endpointUrl.data, client->endpointUrl.length);
+        /* The client keeps its subscriptions, they are only moved to the new session */
+        UA_StatusCode retConnect = UA_Client_connect(client, endpointUrl);
+        EdgeFree(endpointUrl);
+        if (UA_STATUSCODE_GOOD != retConnect)
+        {
+            EDGE_LOG_V(TAG, "Reconnecting the session failed :: %s\n", UA_StatusCode_name(retConnect));
+            return retConnect;
+        }
+        EDGE_LOG(TAG, "Session connected again, recovering its subscriptions\n");
+        clientSub->sessionLost = false;
+    }
 
-    clientSub->subscription_thread_running = true;
-    while (clientSub->subscription_thread_running)
+    UA_TransferSubscriptionsRequest transferRequest;
+    UA_TransferSubscriptionsRequest_init(&transferRequest);
+    transferRequest.subscriptionIds = clientSub->lostSubIds;
+    transferRequest.subscriptionIdsSize = clientSub->lostSubIdCount;
+    /* The current values replace the notifications lost with the connection */
+    transferRequest.sendInitialValues = true;
+
+    UA_TransferSubscriptionsResponse transferResponse;
+    __UA_Client_Service(client, &transferRequest, &UA_TYPES[UA_TYPES_TRANSFERSUBSCRIPTIONSREQUEST],
+            &transferResponse, &UA_TYPES[UA_TYPES_TRANSFERSUBSCRIPTIONSRESPONSE]);
+    /* The ids are owned by the session */
+    transferRequest.subscriptionIds = NULL;
+    transferRequest.subscriptionIdsSize = 0;
+
+    UA_StatusCode retTransfer = transferResponse.responseHeader.serviceResult;
+    if (isConnectionLost(retTransfer))
     {
-        /* Manually send publish request to server every
-         * (EDGE_UA_MINIMUM_PUBLISHING_TIME * 1000) ms */
+        EDGE_LOG_V(TAG, "Transfer of the subscriptions failed :: %s\n", UA_StatusCode_name(retTransfer));
+        clientSub->sessionLost = true;
+        UA_TransferSubscriptionsResponse_deleteMembers(&transferResponse);
+        return retTransfer;
+    }
 
-        #ifndef ENABLE_SUB_QUEUE
-        sendPublishRequest(client);
-        #else
-        EdgeMessage *publishMsg = (EdgeMessage *)EdgeCalloc(1, sizeof(EdgeMessage));
-        publishMsg->type = SEND_REQUEST;
-        publishMsg->command = CMD_SUB;
-        publishMsg->endpointInfo = (EdgeEndPointInfo *) EdgeCalloc(1, sizeof(EdgeEndPointInfo));
-        publishMsg->endpointInfo->endpointUri = cloneString(uri);
-        publishMsg->message_id = EdgeGetRandom();
-        publishMsg->request = (EdgeRequest *) EdgeCalloc(1, sizeof(EdgeRequest));
-        publishMsg->request->subMsg = (EdgeSubRequest *) EdgeCalloc(1, sizeof(EdgeSubRequest));
-        publishMsg->request->subMsg->subType = Edge_Publish_Sub;
+    size_t remaining = 0;
+    for (size_t i = 0; i < clientSub->lostSubIdCount; i++)
+    {
+        UA_UInt32 subId = clientSub->lostSubIds[i];
+        bool transferred = (UA_STATUSCODE_GOOD == retTransfer && i < transferResponse.resultsSize
+                && UA_STATUSCODE_GOOD == transferResponse.results[i].statusCode);
+        if (transferred)
+        {
+            EDGE_LOG_V(TAG, "Subscription %u transferred to the new session\n", subId);
+            continue;
+        }
+        if (UA_STATUSCODE_GOOD != recreateSubscription(clientSub, subId))
+        {
+            clientSub->lostSubIds[remaining++] = subId;
+        }
+    }
+    clientSub->lostSubIdCount = remaining;
+    if (0 == remaining)
+    {
+        EdgeFree(clientSub->lostSubIds);
+        clientSub->lostSubIds = NULL;
+    }
+
+    UA_TransferSubscriptionsResponse_deleteMembers(&transferResponse);
+    return UA_STATUSCODE_GOOD;
+}
 
-        add_to_sendQ(publishMsg);
-        #endif
+bool hasClientSubscriptions(UA_Client *client)
+{
+    clientSubscription *clientSub = (clientSubscription *) get_subscription_list(client);
+    return IS_NOT_NULL(clientSub) && clientSub->subscriptionCount > 0;
+}
 
-		#ifndef _WIN32
-        usleep(EDGE_UA_MINIMUM_PUBLISHING_TIME * 1000);
-		#else
-		Sleep(EDGE_UA_MINIMUM_PUBLISHING_TIME);
-		#endif
+void getClientSubscriptionStats(UA_Client *client, uint32_t *subscriptions, uint32_t *items,
+        uint64_t *notifications)
+{
+    *subscriptions = 0;
+    *items = 0;
+    *notifications = 0;
+
+    /* Entries of clientSubMap live as long as the process, the lock keeps the map stable */
+    pthread_mutex_lock(&clientSubMapMutex);
+    clientSubscription *clientSub = (clientSubscription *) getEdgeHashMapElement(clientSubMap,
+            (keyValue) client);
+    pthread_mutex_unlock(&clientSubMapMutex);
+    if (IS_NULL(clientSub))
+    {
+        return;
     }
 
-    EDGE_LOG(TAG, ">>>>>>>>>>>>>>>>>> subscription thread destroyed <<<<<<<<<<<<<<<<<<<<");
-    return NULL;
+    pthread_mutex_lock(&clientSub->serializeMutex);
+    *subscriptions = (clientSub->subscriptionCount > 0) ? clientSub->subscriptionCount : 0;
+    *items = IS_NOT_NULL(clientSub->subscriptionList) ?
+            (uint32_t) getEdgeHashMapSize(clientSub->subscriptionList) : 0;
+    pthread_mutex_unlock(&clientSub->serializeMutex);
+    *notifications = NOTIFICATION_COUNT_LOAD(&clientSub->notificationCount);
 }
 
 static UA_StatusCode createSub(UA_Client *client, const EdgeMessage *msg)
@@ -368,22 +1555,10 @@ static UA_StatusCode createSub(UA_Client *client, const EdgeMessage *msg)
         subReq = req->subMsg;
     }
 
-    for (int i = 0; i < msg->requestLength; i++)
-    {
-        for(int j = 0; j < msg->requestLength-1; j++)
-        {
-            if(i != j)
-            {
-                if (!strcmp(msg->requests[i]->nodeInfo->valueAlias, msg->requests[j]->nodeInfo->valueAlias))
-                {
-                    EDGE_LOG_V(TAG, "Error :Message contains dublicate requests\n"
-                        "Item No : %d & %d\nItem Name : %s\nThis Subscription request was not processed to server.\n",
-                        i+1, j+1, msg->requests[i]->nodeInfo->valueAlias);
-                    return UA_STATUSCODE_BADREQUESTCANCELLEDBYCLIENT;
-                }
-            }
-        }
-    }
+    bool bulk = (subReq->subType == Edge_Create_Bulk_Sub);
+
+    UA_StatusCode retDup = checkDuplicateRequests(msg);
+    COND_CHECK((retDup != UA_STATUSCODE_GOOD), retDup);
 
     if(IS_NOT_NULL(clientSub))
     {
@@ -430,6 +1605,7 @@ static UA_StatusCode createSub(UA_Client *client, const EdgeMessage *msg)
     }
 
     size_t itemSize = msg->requestLength;
+    UA_DataChangeFilter *filters = NULL;
     UA_MonitoredItemCreateRequest *items = (UA_MonitoredItemCreateRequest *) EdgeMalloc(
             sizeof(UA_MonitoredItemCreateRequest) * itemSize);
     if(IS_NULL(items))
@@ -462,6 +1638,12 @@ static UA_StatusCode createSub(UA_Client *client, const EdgeMessage *msg)
         EDGE_LOG(TAG, "Error : Malloc failed for client_alias in create subscription");
         goto EXIT;
     }
+    filters = (UA_DataChangeFilter *) EdgeCalloc(itemSize, sizeof(UA_DataChangeFilter));
+    if(IS_NULL(filters))
+    {
+        EDGE_LOG(TAG, "Error : Malloc failed for filters in create subscription");
+        goto EXIT;
+    }
 
     for (int i = 0; i < itemSize; i++)
     {
@@ -482,35 +1664,40 @@ static UA_StatusCode createSub(UA_Client *client, const EdgeMessage *msg)
          }
 
         client_alias[i]->client = client;
-        client_alias[i]->valueAlias = (char *)EdgeMalloc(EDGE_UA_SUBSCRIPTION_ITEM_SIZE);
+        client_alias[i]->nsIndex = msg->requests[i]->nodeInfo->nodeId->nameSpace;
+        client_alias[i]->clientSub = NULL;
+        client_alias[i]->subInfo = NULL;
+        client_alias[i]->valueAlias = internEdgeString(msg->requests[i]->nodeInfo->valueAlias);
         if(IS_NULL(client_alias[i]->valueAlias))
         {
             EDGE_LOG_V(TAG, "Error : Malloc failed for client_alias.valuealias id %d in create subscription\n", i);
             goto EXIT;
         }
-        strncpy(client_alias[i]->valueAlias, msg->requests[i]->nodeInfo->valueAlias,
-                alias_size);
-        client_alias[i]->valueAlias[alias_size] = '\0';
 
         EDGE_LOG_V(TAG, "%s, %s, %d", msg->requests[i]->nodeInfo->valueAlias,
                 msg->requests[i]->nodeInfo->nodeId->nodeUri, msg->requests[i]->nodeInfo->nodeId->nameSpace);
-        UA_MonitoredItemCreateRequest_init(&items[i]);
-        items[i].itemToMonitor.nodeId = UA_NODEID_STRING(msg->requests[i]->nodeInfo->nodeId->nameSpace,
-                msg->requests[i]->nodeInfo->valueAlias);
-        items[i].itemToMonitor.attributeId = UA_ATTRIBUTEID_VALUE;
-        items[i].monitoringMode = UA_MONITORINGMODE_REPORTING;
-        items[i].requestedParameters.samplingInterval =
-                msg->requests[i]->subMsg->samplingInterval;
-        items[i].requestedParameters.discardOldest = true;
-        items[i].requestedParameters.queueSize = 1;
+        initMonitoredItem(client, &items[i], msg->requests[i]->nodeInfo->nodeId->nameSpace,
+                msg->requests[i]->nodeInfo->valueAlias, msg->requests[i]->subMsg, &filters[i]);
     }
 
-    UA_StatusCode retMon = UA_Client_Subscriptions_addMonitoredItems(client, subId, items, itemSize,
-            hfs, (void **) client_alias, itemResults, monId);
-    (void) retMon;
+    UA_StatusCode retMon = addMonitoredItems(client, subId, items, itemSize, hfs,
+            (void **) client_alias, itemResults, monId);
     for (int i = 0; i < itemSize; i++)
     {
         EDGE_LOG_V(TAG, "Monitoring Details for item : %d\n", i);
+        if (bulk && (0 == monId[i] || itemResults[i] != UA_STATUSCODE_GOOD))
+        {
+            /* The item is reported in the item results, the others are still created */
+            if (itemResults[i] == UA_STATUSCODE_GOOD)
+            {
+                itemResults[i] = UA_STATUSCODE_BADMONITOREDITEMIDINVALID;
+            }
+            EDGE_LOG_V(TAG, "ERROR Result Recevied for this item : %s\n", UA_StatusCode_name(itemResults[i]));
+            releaseEdgeString(client_alias[i]->valueAlias);
+            EdgeFree(client_alias[i]);
+            client_alias[i] = NULL;
+            continue;
+        }
         if (monId[i])
         {
             if (clientSub != NULL && !validateMonitoringId(clientSub->subscriptionList, subId, monId[i]))
@@ -552,12 +1739,36 @@ static UA_StatusCode createSub(UA_Client *client, const EdgeMessage *msg)
             }
             clientSub->subscriptionCount = 0;
             clientSub->subscriptionList = NULL;
+            clientSub->notificationCount = 0;
+            clientSub->client = client;
+#ifdef ENABLE_SUB_QUEUE
+            clientSub->endpointUri = cloneString(msg->endpointInfo->endpointUri);
+            if (IS_NULL(clientSub->endpointUri))
+            {
+                EDGE_LOG(TAG, "Error : Malloc failed for clientSub.endpointUri in create subscription\n");
+                EdgeFree(clientSub);
+                clientSub = NULL;
+                goto EXIT;
+            }
+#endif
             clientSub->serializeMutex = (pthread_mutex_t) PTHREAD_MUTEX_INITIALIZER;
+            clientSub->reactorActive = false;
+            clientSub->nextSession = NULL;
+            clientSub->nextPublishTime = 0;
+            clientSub->publishing = false;
+            clientSub->publishQueued = false;
+            clientSub->reportBatches = NULL;
+            clientSub->reportBatchCount = 0;
+            clientSub->reportBatchCapacity = 0;
+            clientSub->sessionLost = false;
+            clientSub->lostSubIds = NULL;
+            clientSub->lostSubIdCount = 0;
+            clientSub->reportPool = createEdgeReportPool(msg->endpointInfo);
         }
 
         if (IS_NULL(clientSub->subscriptionList))
         {
-            clientSub->subscriptionList = createMap();
+            clientSub->subscriptionList = createEdgeHashMap(EDGE_HASH_POINTER_KEY);
         }
         if (clientSub->subscriptionList)
         {
@@ -567,7 +1778,7 @@ static UA_StatusCode createSub(UA_Client *client, const EdgeMessage *msg)
                 EDGE_LOG(TAG, "Error : Malloc failed for subInfo in create subscription");
                 goto EXIT;
             }
-            EdgeMessage *msgCopy = cloneEdgeMessage((EdgeMessage*) msg);      //    (EdgeMessage *) EdgeMalloc(sizeof(EdgeMessage));
+            EdgeMessage *msgCopy = createSubscriptionMessage(msg);
             if(IS_NULL(msgCopy))
             {
                 EdgeFree(subInfo);
@@ -578,41 +1789,71 @@ static UA_StatusCode createSub(UA_Client *client, const EdgeMessage *msg)
             subInfo->msg = msgCopy;
             subInfo->subId = subId;
             subInfo->monId = monId[i];
+            /* Revised values of the server are only known once the subscription is modified */
+            subInfo->publishingInterval = subReq->publishingInterval;
+            subInfo->maxKeepAliveCount = subReq->maxKeepAliveCount;
+            /* The revised queue size is not returned by the client */
+            subInfo->queueSize = getQueueSize(msg->requests[i]->subMsg);
+            subInfo->request = *msg->requests[i]->subMsg;
             subInfo->hfContext = client_alias[i];
             EDGE_LOG_V(TAG, "Inserting MAP ELEMENT valueAlias :: %s \n",
-                   msgCopy->requests[i]->nodeInfo->valueAlias);
-            char *valueAlias = (char *)EdgeMalloc(sizeof(char) * (strlen(msgCopy->requests[i]->nodeInfo->valueAlias) + 1));
-            if(IS_NULL(valueAlias))
+                   client_alias[i]->valueAlias);
+            const char *valueAlias = retainEdgeString(client_alias[i]->valueAlias);
+            pthread_mutex_lock(&clientSub->serializeMutex);
+            bool inserted = insertEdgeHashMapElement(clientSub->subscriptionList,
+                    (keyValue) valueAlias, (keyValue) subInfo);
+            if (inserted)
+            {
+                client_alias[i]->clientSub = clientSub;
+                client_alias[i]->subInfo = subInfo;
+            }
+            pthread_mutex_unlock(&clientSub->serializeMutex);
+            if (!inserted)
             {
+                EDGE_LOG(TAG, "Error : Failed to insert valueAlias in subscription list");
+                releaseEdgeString(valueAlias);
+                freeEdgeMessage(msgCopy);
                 EdgeFree(subInfo);
-                EDGE_LOG(TAG, "Error : Malloc failed for valueAlias in create subscription");
                 goto EXIT;
             }
+        }
+    }
 
-            strncpy(valueAlias, msgCopy->requests[i]->nodeInfo->valueAlias,
-                strlen(msgCopy->requests[i]->nodeInfo->valueAlias)+1);
-            insertMapElement(clientSub->subscriptionList, (keyValue) valueAlias,
-                             (keyValue) subInfo);
+    if (bulk)
+    {
+        sendItemResults(msg, itemResults);
+        if (IS_NULL(clientSub) || !hasSubscriptionId(clientSub->subscriptionList, subId))
+        {
+            /* None of the items was created */
+            EDGE_LOG_V(TAG, "Removing the subscription without items SID %d \n", subId);
+            UA_Client_Subscriptions_remove(client, subId);
+            goto EXIT;
         }
     }
 
+    pthread_mutex_lock(&clientSubMapMutex);
     if (NULL == clientSubMap)
     {
-        clientSubMap = createMap();
+        clientSubMap = createEdgeHashMap(EDGE_HASH_POINTER_KEY);
+    }
+    if (IS_NULL(getEdgeHashMapElement(clientSubMap, (keyValue) client)))
+    {
+        insertEdgeHashMapElement(clientSubMap, (keyValue) client, (keyValue) clientSub);
     }
-    insertMapElement(clientSubMap, (keyValue) client, (keyValue) clientSub);
+    pthread_mutex_unlock(&clientSubMapMutex);
 
     if (0 == clientSub->subscriptionCount)
     {
-        /* initiate thread for manually sending publish request. */
-        #ifndef ENABLE_SUB_QUEUE
-        pthread_create(&(clientSub->subscription_thread), NULL, &subscription_thread_handler,
-            (void *) client);
-        #else
-        char *uri = cloneString(msg->endpointInfo->endpointUri);
-        pthread_create(&(clientSub->subscription_thread), NULL, &subscription_thread_handler,
-            (void *) uri);
-        #endif
+        /* The publish reactor sends the publish requests of the session from now on */
+        if (!addPublishSession(clientSub))
+        {
+            EDGE_LOG(TAG, "Error : Failed to add the session to the publish reactor\n");
+        }
+    }
+    else
+    {
+        /* The first notifications of the new items are published without waiting */
+        wakePublishReactor(clientSub);
     }
     clientSub->subscriptionCount++;
 
@@ -622,6 +1863,7 @@ static UA_StatusCode createSub(UA_Client *client, const EdgeMessage *msg)
     EdgeFree(hfs);
     EdgeFree(itemResults);
     EdgeFree(items);
+    EdgeFree(filters);
 
     return UA_STATUSCODE_GOOD;
 }
@@ -640,6 +1882,8 @@ static UA_StatusCode deleteSub(UA_Client *client, const EdgeMessage *msg)
     EDGE_LOG_V(TAG, "Node name :: %s\n", (char *)msg->request->nodeInfo->valueAlias);
     EDGE_LOG_V(TAG, "SUB ID :: %d\n", subInfo->subId);
     EDGE_LOG_V(TAG, "MON ID :: %d\n", subInfo->monId);
+    /* subInfo is freed once it is removed from the list */
+    UA_UInt32 subId = subInfo->subId;
 
     UA_StatusCode ret = UA_Client_Subscriptions_removeMonitoredItem(client, subInfo->subId,
             subInfo->monId);
@@ -652,41 +1896,35 @@ static UA_StatusCode deleteSub(UA_Client *client, const EdgeMessage *msg)
     else
     {
         EDGE_LOG(TAG, "Monitoring deleted successfully\n\n");
-        edgeMapNode *removed = removeSubFromMap(clientSub->subscriptionList,
+        pthread_mutex_lock(&clientSub->serializeMutex);
+        subscriptionInfo *info = removeSubFromMap(clientSub->subscriptionList,
             msg->request->nodeInfo->valueAlias);
-        if (removed != NULL)
+        pthread_mutex_unlock(&clientSub->serializeMutex);
+        if (IS_NOT_NULL(info))
         {
-            subscriptionInfo *info = (subscriptionInfo *) removed->value;
-            if (IS_NOT_NULL(info))
-            {
-                client_valueAlias *alias = (client_valueAlias*) info->hfContext;
-                EdgeFree(alias->valueAlias);
-                EdgeFree(alias);
-                EdgeFree(info->msg);
-                EdgeFree(info);
-            }
-            EdgeFree(removed->key);
-            EdgeFree(removed);
+            client_valueAlias *alias = (client_valueAlias*) info->hfContext;
+            releaseEdgeString(alias->valueAlias);
+            EdgeFree(alias);
+            freeEdgeMessage(info->msg);
+            EdgeFree(info);
         }
     }
 
-    if (!hasSubscriptionId(clientSub->subscriptionList, subInfo->subId))
+    if (!hasSubscriptionId(clientSub->subscriptionList, subId))
     {
-        EDGE_LOG_V(TAG, "Removing the subscription  SID %d \n", subInfo->subId);
-        UA_StatusCode retVal = UA_Client_Subscriptions_remove(client, subInfo->subId);
+        EDGE_LOG_V(TAG, "Removing the subscription  SID %d \n", subId);
+        UA_StatusCode retVal = UA_Client_Subscriptions_remove(client, subId);
         if (UA_STATUSCODE_GOOD != retVal)
         {
-            EDGE_LOG_V(TAG, "Error in removing subscription  SID %d \n", subInfo->subId);
+            EDGE_LOG_V(TAG, "Error in removing subscription  SID %d \n", subId);
             return retVal;
         }
         clientSub->subscriptionCount--;
         if (0 == clientSub->subscriptionCount)
         {
-            /* destroy the subscription thread */
-            /* delete the subscription thread as there are no existing subscriptions request */
-            EDGE_LOG(TAG, "subscription thread destroy\n");
-            clientSub->subscription_thread_running = false;
-            pthread_join(clientSub->subscription_thread, NULL);
+            /* No publish requests are needed as there are no existing subscriptions request */
+            EDGE_LOG(TAG, "removing the session from the publish reactor\n");
+            removePublishSession(clientSub);
         }
     }
 
@@ -737,6 +1975,9 @@ static UA_StatusCode modifySub(UA_Client *client, const EdgeMessage *msg)
         EDGE_LOG_V(TAG, "Requested Interval:: %f Response Interval:: %f \n", subReq->publishingInterval,
                 response.revisedPublishingInterval);
     }
+    setPublishingParameters(clientSub, subInfo->subId, response.revisedPublishingInterval,
+            response.revisedMaxKeepAliveCount);
+    wakePublishReactor(clientSub);
 
     UA_ModifySubscriptionRequest_deleteMembers(&modifySubscriptionRequest);
 
@@ -745,8 +1986,9 @@ static UA_StatusCode modifySub(UA_Client *client, const EdgeMessage *msg)
     UA_ModifyMonitoredItemsRequest_init(&modifyMonitoredItemsRequest);
     modifyMonitoredItemsRequest.subscriptionId = subInfo->subId;
     modifyMonitoredItemsRequest.itemsToModifySize = 1;
-    modifyMonitoredItemsRequest.itemsToModify = EdgeCalloc(1, sizeof(UA_MonitoredItemModifyRequest));
-    VERIFY_NON_NULL_MSG(modifyMonitoredItemsRequest.itemsToModify, "EdgeCalloc FAILED in modifySub\n",
+    modifyMonitoredItemsRequest.itemsToModify = (UA_MonitoredItemModifyRequest *) UA_Array_new(1,
+            &UA_TYPES[UA_TYPES_MONITOREDITEMMODIFYREQUEST]);
+    VERIFY_NON_NULL_MSG(modifyMonitoredItemsRequest.itemsToModify, "UA_Array_new FAILED in modifySub\n",
         UA_STATUSCODE_BADUNEXPECTEDERROR);
 
     UA_UInt32 monId = subInfo->monId;
@@ -754,11 +1996,15 @@ static UA_StatusCode modifySub(UA_Client *client, const EdgeMessage *msg)
     modifyMonitoredItemsRequest.itemsToModify[0].monitoredItemId = monId;
     UA_MonitoringParameters_init(&modifyMonitoredItemsRequest.itemsToModify[0].requestedParameters);
     (modifyMonitoredItemsRequest.itemsToModify[0].requestedParameters).clientHandle = (UA_UInt32) 1;
-    (modifyMonitoredItemsRequest.itemsToModify[0].requestedParameters).discardOldest = true;
+    (modifyMonitoredItemsRequest.itemsToModify[0].requestedParameters).discardOldest =
+            (EDGE_DISCARD_NEWEST != subReq->discardPolicy);
     (modifyMonitoredItemsRequest.itemsToModify[0].requestedParameters).samplingInterval =
             subReq->samplingInterval;
     (modifyMonitoredItemsRequest.itemsToModify[0].requestedParameters).queueSize =
-            subReq->queueSize;
+            getQueueSize(subReq);
+    UA_DataChangeFilter filter;
+    setDataChangeFilter(subReq, &filter,
+            &modifyMonitoredItemsRequest.itemsToModify[0].requestedParameters);
     UA_ModifyMonitoredItemsResponse modifyMonitoredItemsResponse;
     __UA_Client_Service(client, &modifyMonitoredItemsRequest,
             &UA_TYPES[UA_TYPES_MODIFYMONITOREDITEMSREQUEST], &modifyMonitoredItemsResponse,
@@ -779,6 +2025,14 @@ static UA_StatusCode modifySub(UA_Client *client, const EdgeMessage *msg)
 
         EDGE_LOG(TAG, "modify monitored item success\n\n");
 
+        if (UA_STATUSCODE_GOOD == result.statusCode)
+        {
+            pthread_mutex_lock(&clientSub->serializeMutex);
+            subInfo->queueSize = result.revisedQueueSize;
+            subInfo->request = *subReq;
+            pthread_mutex_unlock(&clientSub->serializeMutex);
+        }
+
         if (result.revisedQueueSize != subReq->queueSize)
         {
             EDGE_LOG(TAG, "WARNING : Revised Queue Size in Response MISMATCH\n\n");
@@ -957,7 +2211,7 @@ EdgeResult executeSub(UA_Client *client, const EdgeMessage *msg)
         subReq = req->subMsg;
     }
 
-    if (subReq->subType == Edge_Create_Sub)
+    if (subReq->subType == Edge_Create_Sub || subReq->subType == Edge_Create_Bulk_Sub)
     {
         /* Create Subscription */
         retVal = createSub(client, msg);
@@ -980,7 +2234,25 @@ EdgeResult executeSub(UA_Client *client, const EdgeMessage *msg)
     #ifdef ENABLE_SUB_QUEUE
     else if (subReq->subType == Edge_Publish_Sub)
     {
-        UA_Client_Subscriptions_manuallySendPublishRequest(client);
+        uint64_t sentAt = oc_get_time_us();
+        clientSubscription *clientSub = (clientSubscription*) get_subscription_list(client);
+        if (IS_NOT_NULL(clientSub))
+        {
+            pthread_mutex_lock(&clientSub->serializeMutex);
+            UA_StatusCode ret = recoverSession(clientSub);
+            if (UA_STATUSCODE_GOOD == ret)
+            {
+                ret = UA_Client_Subscriptions_manuallySendPublishRequest(client);
+                markSessionLost(clientSub, ret);
+            }
+            sendBatchedReports(clientSub);
+            pthread_mutex_unlock(&clientSub->serializeMutex);
+            completePublish(clientSub, sentAt, ret);
+        }
+        else
+        {
+            UA_Client_Subscriptions_manuallySendPublishRequest(client);
+        }
     }
     #endif
 
@@ -48,6 +48,24 @@ extern "C"
  */
 EdgeResult executeSub(UA_Client *client, const EdgeMessage *msg);
 
+/**
+ * @brief Checks whether a session has subscriptions. Such a session is connected again
+ *        and keeps its subscriptions when its connection is lost.
+ * @param[in]  client Client Handle.
+ * @return @c true if the session has at least one subscription
+ */
+bool hasClientSubscriptions(UA_Client *client);
+
+/**
+ * @brief Gets the subscription statistics of a session
+ * @param[in]  client Client Handle.
+ * @param[out] subscriptions Receives the number of subscriptions
+ * @param[out] items Receives the number of monitored items
+ * @param[out] notifications Receives the number of data change notifications received
+ */
+void getClientSubscriptionStats(UA_Client *client, uint32_t *subscriptions, uint32_t *items,
+        uint64_t *notifications);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,364 @@
+/******************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ *
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************/
+
+#include "translate_paths.h"
+#include "cmd_util.h"
+#include "edge_logger.h"
+#include "edge_malloc.h"
+#include "edge_open62541.h"
+#include "message_dispatcher.h"
+#include "register_nodes.h"
+#include "server_capabilities.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#define TAG "translate_paths"
+
+#define PATH_SEPARATOR '/'
+#define NAMESPACE_SEPARATOR ':'
+
+/**
+ * @brief parsePathElement - Parses one element of a browse path, "ns:name" or "name"
+ * @param element - First character of the element
+ * @param length - Length of the element
+ * @param defaultNs - Namespace index of an element without one
+ * @param relElement - Receives the element, its target name is allocated
+ * @return GOOD status on success, otherwise an error status
+ */
+static UA_StatusCode parsePathElement(const char *element, size_t length, uint16_t defaultNs,
+        UA_RelativePathElement *relElement)
+{
+    UA_RelativePathElement_init(relElement);
+    relElement->referenceTypeId = UA_NODEID_NUMERIC(0, UA_NS0ID_HIERARCHICALREFERENCES);
+    relElement->isInverse = false;
+    relElement->includeSubtypes = true;
+    relElement->targetName.namespaceIndex = defaultNs;
+
+    /* A leading number followed by the namespace separator is the namespace index */
+    size_t digits = 0;
+    while (digits < length && element[digits] >= '0' && element[digits] <= '9')
+    {
+        digits++;
+    }
+    if (digits > 0 && digits < length && NAMESPACE_SEPARATOR == element[digits])
+    {
+        unsigned long nsIndex = strtoul(element, NULL, 10);
+        COND_CHECK((digits > 5 || nsIndex > UINT16_MAX), UA_STATUSCODE_BADBROWSENAMEINVALID);
+        relElement->targetName.namespaceIndex = (UA_UInt16) nsIndex;
+        element += digits + 1;
+        length -= digits + 1;
+    }
+    COND_CHECK((0 == length), UA_STATUSCODE_BADBROWSENAMEINVALID);
+
+    UA_String name;
+    name.length = length;
+    name.data = (UA_Byte *) element;
+    return UA_String_copy(&name, &relElement->targetName.name);
+}
+
+/**
+ * @brief parseBrowsePath - Parses a browse path relative to the Objects folder. Elements are
+ * separated by '/', a leading '/' is optional.
+ * @param path - Browse path of the request
+ * @param defaultNs - Namespace index of the elements without one
+ * @param browsePath - Receives the browse path, it is freed with UA_BrowsePath_deleteMembers
+ * @return GOOD status on success, otherwise an error status
+ */
+static UA_StatusCode parseBrowsePath(const char *path, uint16_t defaultNs, UA_BrowsePath *browsePath)
+{
+    UA_BrowsePath_init(browsePath);
+    browsePath->startingNode = UA_NODEID_NUMERIC(0, UA_NS0ID_OBJECTSFOLDER);
+    COND_CHECK((IS_NULL(path)), UA_STATUSCODE_BADBROWSENAMEINVALID);
+    if (PATH_SEPARATOR == *path)
+    {
+        path++;
+    }
+    COND_CHECK(('\0' == *path), UA_STATUSCODE_BADNOTHINGTODO);
+
+    size_t elementSize = 1;
+    for (const char *c = path; *c != '\0'; c++)
+    {
+        elementSize += (PATH_SEPARATOR == *c) ? 1 : 0;
+    }
+    browsePath->relativePath.elements = (UA_RelativePathElement *) UA_Array_new(elementSize,
+            &UA_TYPES[UA_TYPES_RELATIVEPATHELEMENT]);
+    COND_CHECK((IS_NULL(browsePath->relativePath.elements)), UA_STATUSCODE_BADOUTOFMEMORY);
+    browsePath->relativePath.elementsSize = elementSize;
+
+    for (size_t i = 0; i < elementSize; i++)
+    {
+        const char *end = strchr(path, PATH_SEPARATOR);
+        size_t length = IS_NOT_NULL(end) ? (size_t) (end - path) : strlen(path);
+        UA_StatusCode ret = parsePathElement(path, length, defaultNs,
+                &browsePath->relativePath.elements[i]);
+        if (UA_STATUSCODE_GOOD != ret)
+        {
+            UA_BrowsePath_deleteMembers(browsePath);
+            return ret;
+        }
+        path += length + 1;
+    }
+    return UA_STATUSCODE_GOOD;
+}
+
+/**
+ * @brief translateInChunks - Splits a translate request into requests of at most maxPaths
+ * browse paths and merges their results into one response
+ * @param client - Client handle
+ * @param request - Request with all the browse paths
+ * @param maxPaths - Maximum number of browse paths per request, 0 if there is no limit
+ * @return Response with one result per browse path of the request
+ */
+static UA_TranslateBrowsePathsToNodeIdsResponse translateInChunks(UA_Client *client,
+        const UA_TranslateBrowsePathsToNodeIdsRequest *request, size_t maxPaths)
+{
+    size_t total = request->browsePathsSize;
+    if (0 == maxPaths || total <= maxPaths)
+    {
+        return UA_Client_Service_translateBrowsePathsToNodeIds(client, *request);
+    }
+
+    UA_TranslateBrowsePathsToNodeIdsResponse response;
+    UA_TranslateBrowsePathsToNodeIdsResponse_init(&response);
+    response.results = (UA_BrowsePathResult *) UA_Array_new(total, &UA_TYPES[UA_TYPES_BROWSEPATHRESULT]);
+    if (IS_NULL(response.results))
+    {
+        response.responseHeader.serviceResult = UA_STATUSCODE_BADOUTOFMEMORY;
+        return response;
+    }
+    response.resultsSize = total;
+
+    UA_TranslateBrowsePathsToNodeIdsRequest chunkRequest = *request;
+    for (size_t offset = 0; offset < total; offset += maxPaths)
+    {
+        size_t count = (total - offset < maxPaths) ? (total - offset) : maxPaths;
+        chunkRequest.browsePaths = request->browsePaths + offset;
+        chunkRequest.browsePathsSize = count;
+        EDGE_LOG_V(TAG, "Translating browse paths %d to %d\n", (int) offset, (int) (offset + count - 1));
+
+        UA_TranslateBrowsePathsToNodeIdsResponse chunkResponse =
+                UA_Client_Service_translateBrowsePathsToNodeIds(client, chunkRequest);
+        UA_StatusCode serviceResult = chunkResponse.responseHeader.serviceResult;
+        if (serviceResult == UA_STATUSCODE_GOOD && chunkResponse.resultsSize != count)
+        {
+            serviceResult = UA_STATUSCODE_BADUNEXPECTEDERROR;
+        }
+        if (serviceResult != UA_STATUSCODE_GOOD)
+        {
+            UA_TranslateBrowsePathsToNodeIdsResponse_deleteMembers(&chunkResponse);
+            UA_TranslateBrowsePathsToNodeIdsResponse_deleteMembers(&response);
+            response.responseHeader.serviceResult = serviceResult;
+            return response;
+        }
+
+        /* Take over the results of the chunk */
+        memcpy(response.results + offset, chunkResponse.results, count * sizeof(UA_BrowsePathResult));
+        UA_free(chunkResponse.results);
+        chunkResponse.results = NULL;
+        chunkResponse.resultsSize = 0;
+        UA_TranslateBrowsePathsToNodeIdsResponse_deleteMembers(&chunkResponse);
+    }
+    return response;
+}
+
+/**
+ * @brief getResolvedNodeId - Gets the node which a browse path is resolved to
+ * @param result - Result of the browse path
+ * @param status - Receives the status of the browse path
+ * @return NodeId of the first target which is fully resolved on this server, otherwise NULL
+ */
+static UA_NodeId *getResolvedNodeId(UA_BrowsePathResult *result, UA_StatusCode *status)
+{
+    *status = result->statusCode;
+    COND_CHECK((UA_STATUSCODE_GOOD != *status), NULL);
+
+    for (size_t i = 0; i < result->targetsSize; i++)
+    {
+        UA_BrowsePathTarget *target = &result->targets[i];
+        if (UA_UINT32_MAX == target->remainingPathIndex && 0 == target->targetId.serverIndex)
+        {
+            if (result->targetsSize > 1)
+            {
+                EDGE_LOG_V(TAG, "Browse path has %d targets, the first one is used\n",
+                        (int) result->targetsSize);
+            }
+            return &target->targetId.nodeId;
+        }
+    }
+    *status = UA_STATUSCODE_BADNOMATCH;
+    return NULL;
+}
+
+/**
+ * @brief sendTranslateResponse - Sends one response per browse path with its status, nodes
+ * which are resolved carry their NodeId
+ * @param msg - Request edge message
+ * @param status - Status of each browse path of the request
+ * @param nodeIds - Resolved node of each browse path, NULL if it is not resolved
+ */
+static void sendTranslateResponse(const EdgeMessage *msg, const UA_StatusCode *status,
+        UA_NodeId **nodeIds)
+{
+    size_t reqLen = msg->requestLength;
+    EdgeMessage *resultMsg = allocEdgeMessage();
+    VERIFY_NON_NULL_NR_MSG(resultMsg, "EdgeCalloc FAILED for resultMsg in sendTranslateResponse\n");
+
+    setMessageEndpointInfo(resultMsg, shareMessageEndpointInfo(msg));
+    resultMsg->responses = (EdgeResponse **) EdgeCalloc(reqLen, sizeof(EdgeResponse *));
+    if (IS_NULL(resultMsg->endpointInfo) || IS_NULL(resultMsg->responses))
+    {
+        EDGE_LOG(TAG, "Error : Malloc failed for resultMsg in sendTranslateResponse\n");
+        goto RESPONSE_ERROR;
+    }
+    resultMsg->command = msg->command;
+    resultMsg->type = GENERAL_RESPONSE;
+    resultMsg->message_id = msg->message_id;
+
+    for (size_t i = 0; i < reqLen; i++)
+    {
+        EdgeResponse *response = (EdgeResponse *) EdgeCalloc(1, sizeof(EdgeResponse));
+        if (IS_NULL(response))
+        {
+            goto RESPONSE_ERROR;
+        }
+        resultMsg->responses[i] = response;
+        resultMsg->responseLength++;
+
+        response->nodeInfo = cloneEdgeNodeInfo(msg->requests[i]->nodeInfo);
+        response->requestId = msg->requests[i]->requestId;
+        response->message = (EdgeVersatility *) EdgeCalloc(1, sizeof(EdgeVersatility));
+        if (IS_NULL(response->nodeInfo) || IS_NULL(response->message))
+        {
+            EDGE_LOG(TAG, "Error : Malloc failed for EdgeResponse in sendTranslateResponse\n");
+            goto RESPONSE_ERROR;
+        }
+        response->message->value = cloneString(UA_StatusCode_name(status[i]));
+        if (IS_NULL(response->message->value))
+        {
+            goto RESPONSE_ERROR;
+        }
+        if (IS_NOT_NULL(nodeIds[i]))
+        {
+            /* The node info keeps the browse path, its NodeId becomes the resolved one */
+            EdgeNodeId *resolved = getEdgeNodeId(nodeIds[i]);
+            if (IS_NULL(resolved))
+            {
+                goto RESPONSE_ERROR;
+            }
+            freeEdgeNodeId(response->nodeInfo->nodeId);
+            response->nodeInfo->nodeId = resolved;
+        }
+    }
+
+    /* Adding the response to receiver Q */
+    add_to_recvQ(resultMsg);
+    return;
+
+    RESPONSE_ERROR:
+    freeEdgeMessage(resultMsg);
+}
+
+EdgeResult executeTranslateBrowsePaths(UA_Client *client, const EdgeMessage *msg)
+{
+    EdgeResult result;
+    result.code = STATUS_ERROR;
+    VERIFY_NON_NULL_MSG(client, "Client param is NULL in executeTranslateBrowsePaths\n", result);
+    result.code = STATUS_PARAM_INVALID;
+    size_t reqLen = msg->requestLength;
+    COND_CHECK_MSG((0 == reqLen), "No browse paths in executeTranslateBrowsePaths\n", result);
+
+    result.code = STATUS_ERROR;
+    UA_BrowsePath *paths = (UA_BrowsePath *) EdgeCalloc(reqLen, sizeof(UA_BrowsePath));
+    UA_StatusCode *status = (UA_StatusCode *) EdgeCalloc(reqLen, sizeof(UA_StatusCode));
+    UA_NodeId **nodeIds = (UA_NodeId **) EdgeCalloc(reqLen, sizeof(UA_NodeId *));
+    size_t *pathIndex = (size_t *) EdgeCalloc(reqLen, sizeof(size_t));
+    UA_TranslateBrowsePathsToNodeIdsResponse response;
+    UA_TranslateBrowsePathsToNodeIdsResponse_init(&response);
+    if (IS_NULL(paths) || IS_NULL(status) || IS_NULL(nodeIds) || IS_NULL(pathIndex))
+    {
+        EDGE_LOG(TAG, "Error : Malloc failed in executeTranslateBrowsePaths\n");
+        sendErrorResponse(msg, "Memory allocation failed.");
+        goto EXIT;
+    }
+
+    /* Only valid browse paths are sent, the others keep their parse error */
+    size_t pathSize = 0;
+    for (size_t i = 0; i < reqLen; i++)
+    {
+        EdgeNodeInfo *nodeInfo = msg->requests[i]->nodeInfo;
+        status[i] = parseBrowsePath(nodeInfo->valueAlias, nodeInfo->nodeId->nameSpace, &paths[pathSize]);
+        if (UA_STATUSCODE_GOOD == status[i])
+        {
+            pathIndex[pathSize++] = i;
+        }
+    }
+
+    if (pathSize > 0)
+    {
+        EdgeServerCapabilities capabilities;
+        getServerCapabilities(client, &capabilities);
+
+        UA_TranslateBrowsePathsToNodeIdsRequest request;
+        UA_TranslateBrowsePathsToNodeIdsRequest_init(&request);
+        request.browsePaths = paths;
+        request.browsePathsSize = pathSize;
+        response = translateInChunks(client, &request, capabilities.maxNodesPerTranslateBrowsePaths);
+        if (response.responseHeader.serviceResult != UA_STATUSCODE_GOOD
+                || response.resultsSize != pathSize)
+        {
+            EDGE_LOG_V(TAG, "Error in translate browse paths :: 0x%08x(%s)\n",
+                    response.responseHeader.serviceResult,
+                    UA_StatusCode_name(response.responseHeader.serviceResult));
+            sendErrorResponse(msg, "Error in translate browse paths.");
+            goto EXIT;
+        }
+    }
+
+    for (size_t i = 0; i < pathSize; i++)
+    {
+        size_t index = pathIndex[i];
+        EdgeNodeInfo *nodeInfo = msg->requests[index]->nodeInfo;
+        nodeIds[index] = getResolvedNodeId(&response.results[i], &status[index]);
+        /* Later requests for the browse path use the resolved node */
+        if (IS_NOT_NULL(nodeIds[index]) && !storeResolvedNodeId(client, nodeInfo->nodeId->nameSpace,
+                nodeInfo->valueAlias, nodeIds[index]))
+        {
+            EDGE_LOG_V(TAG, "Failed to store the node of browse path %s\n", nodeInfo->valueAlias);
+        }
+    }
+    sendTranslateResponse(msg, status, nodeIds);
+    result.code = STATUS_OK;
+
+    EXIT:
+    UA_TranslateBrowsePathsToNodeIdsResponse_deleteMembers(&response);
+    if (IS_NOT_NULL(paths))
+    {
+        for (size_t i = 0; i < reqLen; i++)
+        {
+            UA_BrowsePath_deleteMembers(&paths[i]);
+        }
+    }
+    EdgeFree(paths);
+    EdgeFree(status);
+    EdgeFree(nodeIds);
+    EdgeFree(pathIndex);
+    return result;
+}
@@ -0,0 +1,61 @@
+/******************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ *
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************/
+
+/**
+ * @file translate_paths.h
+ *
+ * @brief This file contains the definition, types and APIs for TranslateBrowsePathsToNodeIds requests.
+ */
+
+#ifndef EDGE_TRANSLATE_PATHS_H
+#define EDGE_TRANSLATE_PATHS_H
+
+#include "opcua_common.h"
+#include "open62541.h"
+
+#include "edge_utils.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/**
+ * @brief Resolves the browse paths of the message to NodeIds with TranslateBrowsePathsToNodeIds.
+ *        The value alias of each request is a browse path relative to the Objects folder,
+ *        like "2:Robot/Speed", whose elements without a namespace index are in the namespace
+ *        of the request. Requests are split by the MaxNodesPerTranslateBrowsePathsToNodeIds
+ *        of the server.
+ * @param[in]  client Client Handle.
+ * @param[in]  msg EdgeMessage request data
+ * @return @c EdgeResult code is 0 on success, otherwise an error value
+ * @retval #STATUS_OK Successful
+ * @retval #STATUS_PARAM_INVALID Invalid parameter
+ * @retval #STATUS_ERROR Operation failed
+ * @remarks Resolved nodes are used by later read, write and subscribe requests of the session
+ *          for the same namespace index and browse path.
+ */
+EdgeResult executeTranslateBrowsePaths(UA_Client *client, const EdgeMessage *msg);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // EDGE_TRANSLATE_PATHS_H
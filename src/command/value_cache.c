@@ -0,0 +1,171 @@
+/******************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ *
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************/
+
+#include "value_cache.h"
+#include "cmd_util.h"
+#include "edge_logger.h"
+#include "edge_malloc.h"
+#include "edge_utils.h"
+#include "edge_hash_map.h"
+
+#ifndef _WIN32
+#include <pthread.h>
+#else
+#include "pthread.h"
+#endif
+
+#define TAG "value_cache"
+
+typedef struct cachedValue
+{
+    /* Value as received from the server */
+    UA_DataValue value;
+    /* Monotonic time at which the value was received */
+    UA_DateTime receivedAt;
+} cachedValue;
+
+/* Client handle -> map of "nsIndex;valueAlias" -> cachedValue */
+static EdgeHashMap *sessionCacheMap = NULL;
+static pthread_mutex_t valueCacheMutex = PTHREAD_MUTEX_INITIALIZER;
+
+static void freeCachedValues(EdgeHashMap *values)
+{
+    size_t cursor = 0;
+    keyValue key = NULL, value = NULL;
+    while (getNextEdgeHashMapElement(values, &cursor, &key, &value))
+    {
+        cachedValue *entry = (cachedValue *) value;
+        UA_DataValue_deleteMembers(&entry->value);
+        EdgeFree(entry);
+        EdgeFree(key);
+    }
+    deleteEdgeHashMap(values);
+}
+
+bool putCachedValue(UA_Client *client, uint16_t nsIndex, const char *valueAlias,
+        const UA_DataValue *value)
+{
+    VERIFY_NON_NULL_MSG(client, "NULL client in putCachedValue\n", false);
+    VERIFY_NON_NULL_MSG(valueAlias, "NULL valueAlias in putCachedValue\n", false);
+    VERIFY_NON_NULL_MSG(value, "NULL value in putCachedValue\n", false);
+    COND_CHECK(!value->hasValue, false);
+
+    char key[EDGE_NODE_KEY_SIZE];
+    COND_CHECK_MSG(!formatNodeKey(nsIndex, valueAlias, key), "Value alias too long to cache\n", false);
+
+    /* Copy outside of the lock, values can be large arrays */
+    UA_DataValue copy;
+    COND_CHECK(UA_DataValue_copy(value, &copy) != UA_STATUSCODE_GOOD, false);
+    UA_DateTime now = UA_DateTime_nowMonotonic();
+
+    bool stored = false;
+    pthread_mutex_lock(&valueCacheMutex);
+    if (IS_NULL(sessionCacheMap))
+    {
+        sessionCacheMap = createEdgeHashMap(EDGE_HASH_POINTER_KEY);
+    }
+    EdgeHashMap *values = (EdgeHashMap *) getEdgeHashMapElement(sessionCacheMap, (keyValue) client);
+    if (IS_NULL(values))
+    {
+        values = createEdgeHashMap(EDGE_HASH_STRING_KEY);
+        if (IS_NOT_NULL(values) && !insertEdgeHashMapElement(sessionCacheMap, (keyValue) client,
+                (keyValue) values))
+        {
+            deleteEdgeHashMap(values);
+            values = NULL;
+        }
+    }
+    if (IS_NOT_NULL(values))
+    {
+        cachedValue *entry = (cachedValue *) getEdgeHashMapElement(values, (keyValue) key);
+        if (IS_NOT_NULL(entry))
+        {
+            UA_DataValue_deleteMembers(&entry->value);
+            entry->value = copy;
+            entry->receivedAt = now;
+            stored = true;
+        }
+        else
+        {
+            entry = (cachedValue *) EdgeMalloc(sizeof(cachedValue));
+            char *storedKey = cloneString(key);
+            if (IS_NOT_NULL(entry) && IS_NOT_NULL(storedKey))
+            {
+                entry->value = copy;
+                entry->receivedAt = now;
+                stored = insertEdgeHashMapElement(values, (keyValue) storedKey, (keyValue) entry);
+            }
+            if (!stored)
+            {
+                EdgeFree(entry);
+                EdgeFree(storedKey);
+            }
+        }
+    }
+    pthread_mutex_unlock(&valueCacheMutex);
+
+    if (!stored)
+    {
+        UA_DataValue_deleteMembers(&copy);
+    }
+    return stored;
+}
+
+bool getCachedValue(UA_Client *client, uint16_t nsIndex, const char *valueAlias, double maxAge,
+        UA_DataValue *value)
+{
+    VERIFY_NON_NULL_MSG(client, "NULL client in getCachedValue\n", false);
+    VERIFY_NON_NULL_MSG(valueAlias, "NULL valueAlias in getCachedValue\n", false);
+    VERIFY_NON_NULL_MSG(value, "NULL value in getCachedValue\n", false);
+    COND_CHECK((maxAge <= 0), false);
+
+    char key[EDGE_NODE_KEY_SIZE];
+    COND_CHECK(!formatNodeKey(nsIndex, valueAlias, key), false);
+
+    bool hit = false;
+    UA_DateTime now = UA_DateTime_nowMonotonic();
+    pthread_mutex_lock(&valueCacheMutex);
+    EdgeHashMap *values = (EdgeHashMap *) getEdgeHashMapElement(sessionCacheMap, (keyValue) client);
+    cachedValue *entry = (cachedValue *) getEdgeHashMapElement(values, (keyValue) key);
+    if (IS_NOT_NULL(entry) && (double) (now - entry->receivedAt) <= maxAge * UA_DATETIME_MSEC)
+    {
+        hit = (UA_DataValue_copy(&entry->value, value) == UA_STATUSCODE_GOOD);
+    }
+    pthread_mutex_unlock(&valueCacheMutex);
+    return hit;
+}
+
+void removeValueCache(UA_Client *client)
+{
+    pthread_mutex_lock(&valueCacheMutex);
+    EdgeHashMap *values = (EdgeHashMap *) removeEdgeHashMapElement(sessionCacheMap,
+            (keyValue) client, NULL);
+    if (IS_NOT_NULL(sessionCacheMap) && 0 == getEdgeHashMapSize(sessionCacheMap))
+    {
+        deleteEdgeHashMap(sessionCacheMap);
+        sessionCacheMap = NULL;
+    }
+    pthread_mutex_unlock(&valueCacheMutex);
+
+    if (IS_NOT_NULL(values))
+    {
+        freeCachedValues(values);
+    }
+}
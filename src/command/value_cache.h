@@ -0,0 +1,71 @@
+/******************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ *
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************/
+
+/**
+ * @file value_cache.h
+ *
+ * @brief This file contains the per-session cache of node values fed by reads and notifications.
+ */
+
+#ifndef EDGE_VALUE_CACHE_H
+#define EDGE_VALUE_CACHE_H
+
+#include "opcua_common.h"
+#include "open62541.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/**
+ * @brief Stores the latest value of a node of the client's session.
+ * @param[in]  client Client Handle.
+ * @param[in]  nsIndex Namespace index of the node.
+ * @param[in]  valueAlias Value alias of the node.
+ * @param[in]  value Value received from the server, it is copied.
+ * @return @c true if the value was stored, @c false otherwise.
+ */
+bool putCachedValue(UA_Client *client, uint16_t nsIndex, const char *valueAlias,
+        const UA_DataValue *value);
+
+/**
+ * @brief Copies the cached value of a node if it is not older than maxAge.
+ * @param[in]  client Client Handle.
+ * @param[in]  nsIndex Namespace index of the node.
+ * @param[in]  valueAlias Value alias of the node.
+ * @param[in]  maxAge Maximum age of the value in milliseconds.
+ * @param[out] value Receives a copy of the cached value, to be freed with UA_DataValue_deleteMembers().
+ * @return @c true on a cache hit, @c false if there is no value or it is too old.
+ */
+bool getCachedValue(UA_Client *client, uint16_t nsIndex, const char *valueAlias, double maxAge,
+        UA_DataValue *value);
+
+/**
+ * @brief Drops the cached values of a client, called when its session ends.
+ * @param[in]  client Client Handle.
+ */
+void removeValueCache(UA_Client *client);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // EDGE_VALUE_CACHE_H
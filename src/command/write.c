@@ -21,112 +21,73 @@
 #include "write.h"
 #include "common_client.h"
 #include "edge_logger.h"
+#include "edge_trace.h"
+#include "edge_client_stats.h"
 #include "edge_malloc.h"
 #include "edge_open62541.h"
 #include "message_dispatcher.h"
 #include "cmd_util.h"
+#include "register_nodes.h"
+#include "async_service.h"
+#include "write_coalesce.h"
+#include "server_capabilities.h"
 
 #include <inttypes.h>
+#include <string.h>
 
 #define TAG "write"
 
 /**
- * @brief writeGroup - Executes write operation
- * @param client - Client handle
+ * @brief processWriteResponse - Queues the response message of a write request
  * @param msg - Request Edge Message
+ * @param writeRequest - Write request, only its scalar members are used
+ * @param writeResponse - Write response, it is not deallocated
  */
-static void writeGroup(UA_Client *client, const EdgeMessage *msg)
+static void processWriteResponse(const EdgeMessage *msg, const UA_WriteRequest *writeRequest,
+        const UA_WriteResponse *writeResponse)
 {
     size_t reqLen = msg->requestLength;
-    UA_WriteValue *wv = (UA_WriteValue *) EdgeMalloc(sizeof(UA_WriteValue) * reqLen);
-    VERIFY_NON_NULL_NR_MSG(wv, "EdgeMalloc FAILED for UA_WriteValue in wroteGroup\n");
-    UA_Variant *myVariant = (UA_Variant *) EdgeMalloc(sizeof(UA_Variant) * reqLen);
-    if (IS_NULL(myVariant))
-    {
-        EDGE_LOG(TAG, "Error : Malloc failed for myVariant in write group.");
-        EdgeFree(wv);
-        return;
-    }
-
-    for (size_t i = 0; i < reqLen; i++)
-    {
-        EDGE_LOG_V(TAG, "[WRITEGROUP] Node to write :: %s\n", msg->requests[i]->nodeInfo->valueAlias);
-        uint32_t Nodeid = (uint32_t)(msg->requests[i]->type);
-        uint32_t type = Nodeid - 1;
-        UA_WriteValue_init(&wv[i]);
-        UA_Variant_init(&myVariant[i]);
-        /* Attribute Id to write to */
-        wv[i].attributeId = UA_ATTRIBUTEID_VALUE;
-        /* Node id */
-        wv[i].nodeId = UA_NODEID_STRING(msg->requests[i]->nodeInfo->nodeId->nameSpace,
-                msg->requests[i]->nodeInfo->valueAlias);
-        wv[i].value.hasValue = true;
-        /* Data type */
-        wv[i].value.value.type = &UA_TYPES[type];
-        wv[i].value.value.storageType = UA_VARIANT_DATA_NODELETE; /* do not free the integer on deletion */
-
-        EdgeVersatility *message = (EdgeVersatility * ) msg->requests[i]->value;
-        if (message->isArray == 0)
-        {
-            /* scalar value to write */
-            createScalarVariant(type, message->value, &myVariant[i]);
-        }
-        else
-        {
-            /* array value to write */
-            createArrayVariant(type, message->value, message->arrayLength, &myVariant[i]);
-        }
-        wv[i].value.value = myVariant[i];
-    }
-
-    UA_WriteRequest writeRequest;
-    UA_WriteRequest_init(&writeRequest);
-    /* Node information */
-    writeRequest.nodesToWrite = wv;
-    /* Number of nodes to write */
-    writeRequest.nodesToWriteSize = reqLen;
-    //writeRequest.requestHeader.returnDiagnostics = 1;
 
-    /* Execute write operation */
-    UA_WriteResponse writeResponse = UA_Client_Service_write(client, writeRequest);
-    if (writeResponse.responseHeader.serviceResult != UA_STATUSCODE_GOOD)
+    if (writeResponse->responseHeader.serviceResult != UA_STATUSCODE_GOOD)
     {
         /* Error in write request */
-        EDGE_LOG_V(TAG, "Error in write :: 0x%08x(%s)\n", writeResponse.responseHeader.serviceResult,
-                UA_StatusCode_name(writeResponse.responseHeader.serviceResult));
-
-        EdgeFree(wv);
-        for (size_t i = 0; i < reqLen; i++)
-            UA_Variant_deleteMembers(&myVariant[i]);
-        EdgeFree(myVariant);
-
-        UA_WriteResponse_deleteMembers(&writeResponse);
+        EDGE_LOG_V(TAG, "Error in write :: 0x%08x(%s)\n", writeResponse->responseHeader.serviceResult,
+                UA_StatusCode_name(writeResponse->responseHeader.serviceResult));
         return;
     }
 
-    EdgeFree(wv);
-    for (size_t i = 0; i < reqLen; i++)
-        UA_Variant_deleteMembers(&myVariant[i]);
-    EdgeFree(myVariant);
-
-    if (reqLen != writeResponse.resultsSize)
+    if (reqLen != writeResponse->resultsSize)
     {
-        EDGE_LOG_V(TAG, "Requested(%d) but received(%d) => %s\n", (int) reqLen, (int)writeResponse.resultsSize,
-                (reqLen < writeResponse.resultsSize) ? "Received more results" : "Received less results");
+        EDGE_LOG_V(TAG, "Requested(%d) but received(%d) => %s\n", (int) reqLen, (int)writeResponse->resultsSize,
+                (reqLen < writeResponse->resultsSize) ? "Received more results" : "Received less results");
         sendErrorResponse(msg, "Error in write operation");
+        return;
+    }
 
-        UA_WriteResponse_deleteMembers(&writeResponse);
+    if (msg->writeErrorsOnly)
+    {
+        /* Successful nodes are not reported, no response message is built for them */
+        for (size_t i = 0; i < reqLen; i++)
+        {
+            UA_StatusCode code = writeResponse->results[i];
+            if (code != UA_STATUSCODE_GOOD)
+            {
+                EDGE_LOG_V(TAG, "Error in write response for a particular node :: 0x%08x(%s)\n", code,
+                        UA_StatusCode_name(code));
+                sendErrorResponse(msg, "Error in write Response");
+            }
+        }
         return;
     }
 
-    EdgeMessage *resultMsg = (EdgeMessage *) EdgeCalloc(1, sizeof(EdgeMessage));
+    EdgeMessage *resultMsg = allocEdgeMessage();
     if (IS_NULL(resultMsg))
     {
         EDGE_LOG(TAG, "Error : Malloc Failed for resultMsg in Write Group");
         goto WRITE_ERROR;
     }
 
-    resultMsg->endpointInfo = cloneEdgeEndpointInfo(msg->endpointInfo);
+    setMessageEndpointInfo(resultMsg, shareMessageEndpointInfo(msg));
     if (IS_NULL(resultMsg->endpointInfo))
     {
         EDGE_LOG(TAG, "Error : Malloc Failed for resultMsg->endpointInfo in Write Group");
@@ -147,7 +108,7 @@ static void writeGroup(UA_Client *client, const EdgeMessage *msg)
     size_t respIndex = 0;
     for (size_t i = 0; i < reqLen; i++)
     {
-        UA_StatusCode code = writeResponse.results[i];
+        UA_StatusCode code = writeResponse->results[i];
 
         if (code != UA_STATUSCODE_GOOD)
         {
@@ -157,7 +118,7 @@ static void writeGroup(UA_Client *client, const EdgeMessage *msg)
 
             sendErrorResponse(msg, "Error in write Response");
 
-            if (writeResponse.responseHeader.serviceResult != UA_STATUSCODE_GOOD)
+            if (writeResponse->responseHeader.serviceResult != UA_STATUSCODE_GOOD)
                 continue;
         }
         else
@@ -176,8 +137,8 @@ static void writeGroup(UA_Client *client, const EdgeMessage *msg)
             }
             response->requestId = msg->requests[i]->requestId;
             response->m_diagnosticInfo = checkDiagnosticInfo(msg->requestLength,
-                    writeResponse.diagnosticInfos, writeResponse.diagnosticInfosSize,
-                    writeRequest.requestHeader.returnDiagnostics);
+                    writeResponse->diagnosticInfos, writeResponse->diagnosticInfosSize,
+                    writeRequest->requestHeader.returnDiagnostics);
             if (IS_NULL(response->m_diagnosticInfo))
             {
                 EDGE_LOG(TAG, "Error : Malloc Failed for EdgeResponse.DagnosticInfo in Write Group");
@@ -194,7 +155,13 @@ static void writeGroup(UA_Client *client, const EdgeMessage *msg)
             }
             const char *retCode = UA_StatusCode_name(code);
             size_t len = strlen(retCode);
-            char *code = (char*) malloc(len+1);
+            char *code = (char*) EdgeMalloc(len+1);
+            if (IS_NULL(code))
+            {
+                EDGE_LOG(TAG, "Error : Malloc Failed for status code in Write Group");
+                freeEdgeResponse(response);
+                goto WRITE_ERROR;
+            }
             strncpy(code, retCode, len+1);
 
             response->message->value = (void *) code;
@@ -212,13 +179,213 @@ static void writeGroup(UA_Client *client, const EdgeMessage *msg)
     }
     /* Adding the write response to receiver Q */
     add_to_recvQ(resultMsg);
-
-    UA_WriteResponse_deleteMembers(&writeResponse);
     return;
 
     WRITE_ERROR:
     /* Free memory */
     freeEdgeMessage(resultMsg);
+}
+
+#ifdef ENABLE_ASYNC_SERVICES
+static void asyncWriteHandler(UA_Client *client, const EdgeMessage *msg, const void *data,
+        void *response)
+{
+    processWriteResponse(msg, (const UA_WriteRequest *) data, (const UA_WriteResponse *) response);
+}
+#endif
+
+/**
+ * @brief fillWriteValue - Fills the write value of a request
+ * @param client - Client handle
+ * @param request - Write request of the Edge Message
+ * @param wv - Write value to fill
+ * @param variant - Variant which holds the value to write
+ */
+static void fillWriteValue(UA_Client *client, const EdgeRequest *request, UA_WriteValue *wv,
+        UA_Variant *variant)
+{
+    EDGE_LOG_V(TAG, "[WRITEGROUP] Node to write :: %s\n", request->nodeInfo->valueAlias);
+    uint32_t Nodeid = (uint32_t)(request->type);
+    uint32_t type = Nodeid - 1;
+    UA_WriteValue_init(wv);
+    UA_Variant_init(variant);
+    /* Attribute Id to write to */
+    wv->attributeId = UA_ATTRIBUTEID_VALUE;
+    /* Node id, registered nodes use the NodeId returned by the server. Neither is freed. */
+    const UA_NodeId *registered = getRegisteredNodeId(client,
+            request->nodeInfo->nodeId->nameSpace, request->nodeInfo->valueAlias);
+    wv->nodeId = IS_NOT_NULL(registered) ? *registered :
+            UA_NODEID_STRING(request->nodeInfo->nodeId->nameSpace,
+            request->nodeInfo->valueAlias);
+    wv->value.hasValue = true;
+
+    EdgeVersatility *message = (EdgeVersatility * ) request->value;
+    /* Fixed size values are encoded straight from the buffer of the application */
+    if (UA_STATUSCODE_GOOD != createBorrowedVariant(type, message->value, message->isArray,
+            message->arrayLength, variant))
+    {
+        if (message->isArray == 0)
+        {
+            /* scalar value to write */
+            createScalarVariant(type, message->value, variant);
+        }
+        else
+        {
+            /* array value to write */
+            createArrayVariant(type, message->value, message->arrayLength, variant);
+        }
+    }
+    wv->value.value = *variant;
+}
+
+/**
+ * @brief writeInChunks - Splits a write request into requests of at most maxNodes nodes
+ * and merges their results into one response
+ * @param client - Client handle
+ * @param request - Write request with all the nodes to write
+ * @param maxNodes - Maximum number of nodes per request
+ * @return Write response with one result per node of the request
+ */
+static UA_WriteResponse writeInChunks(UA_Client *client, const UA_WriteRequest *request, size_t maxNodes)
+{
+    UA_WriteResponse response;
+    UA_WriteResponse_init(&response);
+    size_t total = request->nodesToWriteSize;
+    response.results = (UA_StatusCode *) UA_Array_new(total, &UA_TYPES[UA_TYPES_STATUSCODE]);
+    if (IS_NULL(response.results))
+    {
+        response.responseHeader.serviceResult = UA_STATUSCODE_BADOUTOFMEMORY;
+        return response;
+    }
+    response.resultsSize = total;
+
+    UA_WriteRequest chunkRequest = *request;
+    for (size_t offset = 0; offset < total; offset += maxNodes)
+    {
+        size_t count = (total - offset < maxNodes) ? (total - offset) : maxNodes;
+        chunkRequest.nodesToWrite = request->nodesToWrite + offset;
+        chunkRequest.nodesToWriteSize = count;
+        EDGE_LOG_V(TAG, "[WRITEGROUP] Writing nodes %d to %d\n", (int) offset, (int) (offset + count - 1));
+
+        UA_WriteResponse chunkResponse = UA_Client_Service_write(client, chunkRequest);
+        UA_StatusCode serviceResult = chunkResponse.responseHeader.serviceResult;
+        if (serviceResult == UA_STATUSCODE_GOOD && chunkResponse.resultsSize != count)
+        {
+            serviceResult = UA_STATUSCODE_BADUNEXPECTEDERROR;
+        }
+        if (serviceResult != UA_STATUSCODE_GOOD)
+        {
+            UA_WriteResponse_deleteMembers(&chunkResponse);
+            UA_WriteResponse_deleteMembers(&response);
+            response.responseHeader.serviceResult = serviceResult;
+            return response;
+        }
+
+        memcpy(response.results + offset, chunkResponse.results, count * sizeof(UA_StatusCode));
+        UA_WriteResponse_deleteMembers(&chunkResponse);
+    }
+    return response;
+}
+
+/**
+ * @brief writeGroups - Executes write operation of the nodes of several messages in one request
+ * @param client - Client handle
+ * @param msgs - Request Edge Messages of the same endpoint
+ * @param count - Number of messages
+ */
+static void writeGroups(UA_Client *client, const EdgeMessage *const *msgs, size_t count)
+{
+    size_t reqLen = 0;
+    for (size_t k = 0; k < count; k++)
+    {
+        reqLen += msgs[k]->requestLength;
+    }
+    UA_WriteValue *wv = (UA_WriteValue *) EdgeMalloc(sizeof(UA_WriteValue) * reqLen);
+    VERIFY_NON_NULL_NR_MSG(wv, "EdgeMalloc FAILED for UA_WriteValue in wroteGroup\n");
+    UA_Variant *myVariant = (UA_Variant *) EdgeMalloc(sizeof(UA_Variant) * reqLen);
+    if (IS_NULL(myVariant))
+    {
+        EDGE_LOG(TAG, "Error : Malloc failed for myVariant in write group.");
+        EdgeFree(wv);
+        return;
+    }
+
+    size_t index = 0;
+    for (size_t k = 0; k < count; k++)
+    {
+        for (size_t i = 0; i < msgs[k]->requestLength; i++, index++)
+        {
+            fillWriteValue(client, msgs[k]->requests[i], &wv[index], &myVariant[index]);
+        }
+    }
+
+    UA_WriteRequest writeRequest;
+    UA_WriteRequest_init(&writeRequest);
+    /* Node information */
+    writeRequest.nodesToWrite = wv;
+    /* Number of nodes to write */
+    writeRequest.nodesToWriteSize = reqLen;
+    //writeRequest.requestHeader.returnDiagnostics = 1;
+
+    EdgeServerCapabilities capabilities;
+    getServerCapabilities(client, &capabilities);
+    size_t maxNodesPerWrite = capabilities.maxNodesPerWrite;
+    bool chunked = (maxNodesPerWrite > 0 && reqLen > maxNodesPerWrite);
+
+#ifdef ENABLE_ASYNC_SERVICES
+    /* The response is processed by asyncWriteHandler, only scalar members are kept for it */
+    UA_WriteRequest asyncWrite = writeRequest;
+    asyncWrite.nodesToWrite = NULL;
+    asyncWrite.nodesToWriteSize = 0;
+    if (1 == count && !chunked && sendAsyncService(client, msgs[0], &writeRequest, &UA_TYPES[UA_TYPES_WRITEREQUEST],
+            &UA_TYPES[UA_TYPES_WRITERESPONSE], asyncWriteHandler, &asyncWrite, sizeof(asyncWrite)))
+    {
+        EdgeFree(wv);
+        for (size_t i = 0; i < reqLen; i++)
+            UA_Variant_deleteMembers(&myVariant[i]);
+        EdgeFree(myVariant);
+        return;
+    }
+#endif
+
+    /* Execute write operation, in as many requests as the server allows */
+    for (size_t k = 0; k < count; k++)
+    {
+        EDGE_TRACE_BEGIN(msgs[k], EDGE_TRACE_STAGE_SERVICE);
+    }
+    uint64_t startUs = getClientServiceTime();
+    UA_WriteResponse writeResponse = chunked ? writeInChunks(client, &writeRequest, maxNodesPerWrite) :
+            UA_Client_Service_write(client, writeRequest);
+    for (size_t k = 0; k < count; k++)
+    {
+        EDGE_TRACE_END(msgs[k], EDGE_TRACE_STAGE_SERVICE);
+        recordClientService(client, msgs[k]->command, startUs,
+                writeResponse.responseHeader.serviceResult);
+    }
+
+    EdgeFree(wv);
+    for (size_t i = 0; i < reqLen; i++)
+        UA_Variant_deleteMembers(&myVariant[i]);
+    EdgeFree(myVariant);
+
+    /* Each message gets the results of its own nodes */
+    size_t offset = 0;
+    for (size_t k = 0; k < count; k++)
+    {
+        UA_WriteResponse view = writeResponse;
+        if (count > 1 && reqLen == writeResponse.resultsSize)
+        {
+            view.results = writeResponse.results + offset;
+            view.resultsSize = msgs[k]->requestLength;
+            bool hasDiagnostics = (reqLen == writeResponse.diagnosticInfosSize);
+            view.diagnosticInfos = hasDiagnostics ? writeResponse.diagnosticInfos + offset : NULL;
+            view.diagnosticInfosSize = hasDiagnostics ? msgs[k]->requestLength : 0;
+        }
+        EDGE_TRACE_BEGIN(msgs[k], EDGE_TRACE_STAGE_RESPONSE);
+        processWriteResponse(msgs[k], &writeRequest, &view);
+        EDGE_TRACE_END(msgs[k], EDGE_TRACE_STAGE_RESPONSE);
+        offset += msgs[k]->requestLength;
+    }
     UA_WriteResponse_deleteMembers(&writeResponse);
 }
 
@@ -227,7 +394,30 @@ EdgeResult executeWrite(UA_Client *client, const EdgeMessage *msg)
     EdgeResult result;
     result.code = STATUS_ERROR;
     VERIFY_NON_NULL_MSG(client, "Client param is NULL in execute WRITE\n", result);
-    writeGroup(client, msg);
+    if (EDGE_MESSAGE_BLOCK(msg)->coalesceFlush)
+    {
+        /* Window of the pending writes of the session has passed */
+        return flushCoalescedWrites(client, msg);
+    }
+    if (coalesceWrite(client, msg))
+    {
+        /* Sent later with the other pending writes of the session */
+        result.code = STATUS_OK;
+        return result;
+    }
+    writeGroups(client, &msg, 1);
+    result.code = STATUS_OK;
+    return result;
+}
+
+EdgeResult executeWrites(UA_Client *client, EdgeMessage **msgs, size_t count)
+{
+    EdgeResult result;
+    result.code = STATUS_PARAM_INVALID;
+    VERIFY_NON_NULL_MSG(client, "Client param is NULL in execute WRITE\n", result);
+    VERIFY_NON_NULL_MSG(msgs, "NULL messages received in execute WRITE\n", result);
+    COND_CHECK((0 == count), result);
+    writeGroups(client, (const EdgeMessage *const *) msgs, count);
     result.code = STATUS_OK;
     return result;
 }
@@ -48,6 +48,19 @@ extern "C"
  */
 EdgeResult executeWrite(UA_Client *client, const EdgeMessage *msg);
 
+/**
+ * @brief Executes Write operation of several messages of one session in one write request.
+ *        Every message receives its own response with the results of its nodes.
+ * @param[in]  client Client Handle.
+ * @param[in]  msgs EdgeMessage requests data
+ * @param[in]  count Number of messages
+ * @return @c EdgeResult code is 0 on success, otherwise an error value
+ * @retval #STATUS_OK Successful
+ * @retval #STATUS_PARAM_INVALID Invalid parameter
+ * @retval #STATUS_ERROR Operation failed
+ */
+EdgeResult executeWrites(UA_Client *client, EdgeMessage **msgs, size_t count);
+
 #ifdef __cplusplus
 }
 #endif
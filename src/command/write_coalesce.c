@@ -0,0 +1,390 @@
+/******************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ *
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************/
+
+#include "write_coalesce.h"
+#include "write.h"
+#include "cmd_util.h"
+#include "edge_logger.h"
+#include "edge_malloc.h"
+#include "edge_open62541.h"
+#include "edge_hash_map.h"
+#include "message_dispatcher.h"
+#include "request_future.h"
+#include "octhread.h"
+#include "edge_thread_config.h"
+
+#ifndef _WIN32
+#include <pthread.h>
+#else
+#include "pthread.h"
+#endif
+
+#define TAG "write_coalesce"
+
+#define WRITE_BATCH_INITIAL_CAPACITY (8)
+
+/* Pending writes of a session. They are added and sent on the thread which executes the
+ * messages of the session, writeBatchMutex guards the map and the settings. */
+typedef struct EdgeWriteBatch
+{
+    /**< Copies of the pending write messages. **/
+    EdgeMessage **msgs;
+    size_t count;
+    size_t capacity;
+
+    /**< Number of nodes of the pending write messages. **/
+    size_t nodes;
+
+    /**< A flush message is waiting in the flush timer. **/
+    bool flushScheduled;
+} EdgeWriteBatch;
+
+/* Flush message which is queued when its deadline has passed */
+typedef struct EdgeScheduledFlush
+{
+    EdgeMessage *msg;
+    uint64_t deadline;
+    struct EdgeScheduledFlush *next;
+} EdgeScheduledFlush;
+
+/* Client handle -> EdgeWriteBatch */
+static EdgeHashMap *writeBatchMap = NULL;
+static size_t coalesceMaxNodes = 0;
+static uint32_t coalesceWindowMs = 0;
+static pthread_mutex_t writeBatchMutex = PTHREAD_MUTEX_INITIALIZER;
+
+/* Flush timer, runs while coalescing is enabled */
+static oc_mutex flushMutex = NULL;
+static oc_cond flushCond = NULL;
+static oc_thread flushThread = NULL;
+static bool flushRunning = false;
+static EdgeScheduledFlush *flushHead = NULL;
+static EdgeScheduledFlush *flushTail = NULL;
+
+static void *flushTimerHandler(void *arg)
+{
+    (void) arg;
+    applyEdgeThreadConfig(EDGE_THREAD_HELPER);
+    oc_mutex_lock(flushMutex);
+    while (flushRunning || IS_NOT_NULL(flushHead))
+    {
+        uint64_t now = oc_get_time_us();
+        if (IS_NOT_NULL(flushHead) && (!flushRunning || flushHead->deadline <= now))
+        {
+            /* Deadlines are in arrival order, the window is the same for all of them */
+            EdgeScheduledFlush *flush = flushHead;
+            flushHead = flush->next;
+            if (IS_NULL(flushHead))
+            {
+                flushTail = NULL;
+            }
+            oc_mutex_unlock(flushMutex);
+            add_to_sendQ(flush->msg);
+            EdgeFree(flush);
+            oc_mutex_lock(flushMutex);
+        }
+        else if (IS_NOT_NULL(flushHead))
+        {
+            oc_cond_wait_for(flushCond, flushMutex, flushHead->deadline - now);
+        }
+        else
+        {
+            oc_cond_wait(flushCond, flushMutex);
+        }
+    }
+    oc_mutex_unlock(flushMutex);
+    return NULL;
+}
+
+static bool startFlushTimer(void)
+{
+    flushMutex = oc_mutex_new();
+    flushCond = oc_cond_new();
+    if (IS_NULL(flushMutex) || IS_NULL(flushCond))
+    {
+        EDGE_LOG(TAG, "Failed to create the flush timer lock.");
+        oc_cond_free(flushCond);
+        oc_mutex_free(flushMutex);
+        flushCond = NULL;
+        flushMutex = NULL;
+        return false;
+    }
+    flushRunning = true;
+    if (OC_THREAD_SUCCESS != oc_thread_new(&flushThread, flushTimerHandler, NULL))
+    {
+        EDGE_LOG(TAG, "Failed to start the flush timer thread.");
+        flushRunning = false;
+        flushThread = NULL;
+        oc_cond_free(flushCond);
+        oc_mutex_free(flushMutex);
+        flushCond = NULL;
+        flushMutex = NULL;
+        return false;
+    }
+    return true;
+}
+
+static void stopFlushTimer(void)
+{
+    /* Scheduled flushes are queued at once, so no write stays pending */
+    oc_mutex_lock(flushMutex);
+    flushRunning = false;
+    oc_cond_signal(flushCond);
+    oc_mutex_unlock(flushMutex);
+
+    oc_thread_wait(flushThread);
+    oc_thread_free(flushThread);
+    oc_cond_free(flushCond);
+    oc_mutex_free(flushMutex);
+    flushThread = NULL;
+    flushCond = NULL;
+    flushMutex = NULL;
+}
+
+/**
+ * @brief scheduleFlush - Queues a flush message of the session of msg after the window
+ * @param msg - First pending write of the session
+ * @param windowMs - Time to wait in milliseconds
+ * @return true if the flush was scheduled
+ */
+static bool scheduleFlush(const EdgeMessage *msg, uint32_t windowMs)
+{
+    EdgeScheduledFlush *flush = (EdgeScheduledFlush *) EdgeCalloc(1, sizeof(EdgeScheduledFlush));
+    VERIFY_NON_NULL_MSG(flush, "EdgeCalloc FAILED for EdgeScheduledFlush\n", false);
+    flush->msg = allocEdgeMessage();
+    if (IS_NULL(flush->msg))
+    {
+        EDGE_LOG(TAG, "Memory allocation failed.");
+        EdgeFree(flush);
+        return false;
+    }
+    setMessageEndpointInfo(flush->msg, shareMessageEndpointInfo(msg));
+    if (IS_NULL(flush->msg->endpointInfo))
+    {
+        EDGE_LOG(TAG, "Memory allocation failed.");
+        freeEdgeMessage(flush->msg);
+        EdgeFree(flush);
+        return false;
+    }
+    flush->msg->type = SEND_REQUESTS;
+    flush->msg->command = CMD_WRITE;
+    flush->msg->message_id = msg->message_id;
+    EDGE_MESSAGE_BLOCK(flush->msg)->coalesceFlush = true;
+    flush->deadline = oc_get_time_us() + (uint64_t) windowMs * 1000;
+
+    oc_mutex_lock(flushMutex);
+    if (IS_NULL(flushTail))
+    {
+        flushHead = flush;
+    }
+    else
+    {
+        flushTail->next = flush;
+    }
+    flushTail = flush;
+    oc_cond_signal(flushCond);
+    oc_mutex_unlock(flushMutex);
+    return true;
+}
+
+static void freeWriteBatch(EdgeWriteBatch *batch)
+{
+    for (size_t i = 0; i < batch->count; i++)
+    {
+        finishRequestFuture(batch->msgs[i]->message_id);
+        freeEdgeMessage(batch->msgs[i]);
+    }
+    EdgeFree(batch->msgs);
+    EdgeFree(batch);
+}
+
+static EdgeWriteBatch *getWriteBatch(UA_Client *client)
+{
+    EdgeWriteBatch *batch = (EdgeWriteBatch *) getEdgeHashMapElement(writeBatchMap, client);
+    COND_CHECK((IS_NOT_NULL(batch)), batch);
+
+    if (IS_NULL(writeBatchMap))
+    {
+        writeBatchMap = createEdgeHashMap(EDGE_HASH_POINTER_KEY);
+        VERIFY_NON_NULL_MSG(writeBatchMap, "Failed to create the write batch map\n", NULL);
+    }
+    batch = (EdgeWriteBatch *) EdgeCalloc(1, sizeof(EdgeWriteBatch));
+    VERIFY_NON_NULL_MSG(batch, "EdgeCalloc FAILED for EdgeWriteBatch\n", NULL);
+    if (!insertEdgeHashMapElement(writeBatchMap, client, batch))
+    {
+        EdgeFree(batch);
+        return NULL;
+    }
+    return batch;
+}
+
+static bool appendToWriteBatch(EdgeWriteBatch *batch, EdgeMessage *msg)
+{
+    if (batch->count == batch->capacity)
+    {
+        size_t capacity = (0 == batch->capacity) ? WRITE_BATCH_INITIAL_CAPACITY : batch->capacity * 2;
+        EdgeMessage **msgs = (EdgeMessage **) EdgeRealloc(batch->msgs, capacity * sizeof(EdgeMessage *));
+        VERIFY_NON_NULL_MSG(msgs, "EdgeRealloc FAILED for write batch\n", false);
+        batch->msgs = msgs;
+        batch->capacity = capacity;
+    }
+    batch->msgs[batch->count++] = msg;
+    batch->nodes += msg->requestLength;
+    return true;
+}
+
+EdgeResult configureWriteCoalescingImpl(size_t maxNodes, uint32_t windowMs)
+{
+    EdgeResult result;
+    result.code = STATUS_PARAM_INVALID;
+    COND_CHECK_MSG((maxNodes > 0 && 0 == windowMs), "Error: Coalescing window is 0\n", result);
+
+    pthread_mutex_lock(&writeBatchMutex);
+    bool enabled = (coalesceMaxNodes > 0);
+    result.code = STATUS_OK;
+    if (maxNodes > 0 && !enabled && !startFlushTimer())
+    {
+        result.code = STATUS_ERROR;
+    }
+    else
+    {
+        coalesceMaxNodes = maxNodes;
+        coalesceWindowMs = windowMs;
+    }
+
+    if (0 == maxNodes && enabled)
+    {
+        /* New writes are executed at once, the pending ones are flushed by the timer */
+        stopFlushTimer();
+    }
+    pthread_mutex_unlock(&writeBatchMutex);
+    return result;
+}
+
+bool isWriteCoalescingEnabled(void)
+{
+    pthread_mutex_lock(&writeBatchMutex);
+    bool enabled = (coalesceMaxNodes > 0);
+    pthread_mutex_unlock(&writeBatchMutex);
+    return enabled;
+}
+
+bool coalesceWrite(UA_Client *client, const EdgeMessage *msg)
+{
+    COND_CHECK((IS_NULL(client) || IS_NULL(msg)), false);
+
+    pthread_mutex_lock(&writeBatchMutex);
+    if (0 == coalesceMaxNodes)
+    {
+        pthread_mutex_unlock(&writeBatchMutex);
+        return false;
+    }
+
+    EdgeWriteBatch *batch = getWriteBatch(client);
+    /* cloneEdgeMessage() does not modify the message */
+    EdgeMessage *copy = IS_NOT_NULL(batch) ? cloneEdgeMessage((EdgeMessage *) msg) : NULL;
+    if (IS_NULL(copy) || !appendToWriteBatch(batch, copy))
+    {
+        pthread_mutex_unlock(&writeBatchMutex);
+        if (IS_NOT_NULL(copy))
+        {
+            freeEdgeMessage(copy);
+        }
+        EDGE_LOG(TAG, "Failed to add the write to the pending writes, it is executed at once.");
+        return false;
+    }
+    /* The future of the request waits until the pending write is sent */
+    holdRequestFuture(msg->message_id);
+
+    bool full = (batch->nodes >= coalesceMaxNodes);
+    if (!full && !batch->flushScheduled)
+    {
+        batch->flushScheduled = scheduleFlush(msg, coalesceWindowMs);
+        full = !batch->flushScheduled;
+    }
+    pthread_mutex_unlock(&writeBatchMutex);
+
+    if (full)
+    {
+        flushCoalescedWrites(client, NULL);
+    }
+    return true;
+}
+
+EdgeResult flushCoalescedWrites(UA_Client *client, const EdgeMessage *msg)
+{
+    EdgeResult result;
+    result.code = STATUS_PARAM_INVALID;
+    VERIFY_NON_NULL_MSG(client, "Client param is NULL in flushCoalescedWrites\n", result);
+
+    pthread_mutex_lock(&writeBatchMutex);
+    EdgeWriteBatch *batch = (EdgeWriteBatch *) getEdgeHashMapElement(writeBatchMap, client);
+    EdgeMessage **msgs = NULL;
+    size_t count = 0;
+    if (IS_NOT_NULL(batch))
+    {
+        msgs = batch->msgs;
+        count = batch->count;
+        batch->msgs = NULL;
+        batch->count = 0;
+        batch->capacity = 0;
+        batch->nodes = 0;
+        if (IS_NOT_NULL(msg))
+        {
+            /* The flush message of the timer, the next write schedules a new one */
+            batch->flushScheduled = false;
+        }
+    }
+    pthread_mutex_unlock(&writeBatchMutex);
+
+    result.code = STATUS_OK;
+    if (count > 0)
+    {
+        EDGE_LOG_V(TAG, "Writing %d coalesced write messages\n", (int) count);
+        result = executeWrites(client, msgs, count);
+    }
+    for (size_t i = 0; i < count; i++)
+    {
+        finishRequestFuture(msgs[i]->message_id);
+        freeEdgeMessage(msgs[i]);
+    }
+    EdgeFree(msgs);
+    return result;
+}
+
+void removeCoalescedWrites(UA_Client *client)
+{
+    pthread_mutex_lock(&writeBatchMutex);
+    EdgeWriteBatch *batch = (EdgeWriteBatch *) removeEdgeHashMapElement(writeBatchMap, client, NULL);
+    if (IS_NOT_NULL(batch))
+    {
+        if (batch->count > 0)
+        {
+            EDGE_LOG_V(TAG, "Session ended, %d pending write messages are dropped\n", (int) batch->count);
+        }
+        freeWriteBatch(batch);
+    }
+    if (IS_NOT_NULL(writeBatchMap) && 0 == getEdgeHashMapSize(writeBatchMap))
+    {
+        deleteEdgeHashMap(writeBatchMap);
+        writeBatchMap = NULL;
+    }
+    pthread_mutex_unlock(&writeBatchMutex);
+}
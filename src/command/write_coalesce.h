@@ -0,0 +1,88 @@
+/******************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ *
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************/
+
+/**
+ * @file write_coalesce.h
+ *
+ * @brief This file contains the definition, types and APIs for coalescing write requests.
+ */
+
+#ifndef EDGE_WRITE_COALESCE_H
+#define EDGE_WRITE_COALESCE_H
+
+#include "opcua_common.h"
+#include "open62541.h"
+
+#include "edge_utils.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/**
+ * @brief Configures the coalescing of write requests. Writes of a session are merged into one
+ *        write request until maxNodes nodes are collected or windowMs milliseconds have passed
+ *        since the first of them.
+ * @param[in]  maxNodes Number of nodes which sends the merged request at once, 0 disables coalescing.
+ * @param[in]  windowMs Time in milliseconds a write waits for others at most.
+ * @return @c EdgeResult code is 0 on success, otherwise an error value
+ * @retval #STATUS_OK Successful
+ * @retval #STATUS_PARAM_INVALID Invalid parameter
+ * @retval #STATUS_ERROR Operation failed
+ */
+EdgeResult configureWriteCoalescingImpl(size_t maxNodes, uint32_t windowMs);
+
+/**
+ * @brief Checks whether write requests are coalesced
+ * @return true if coalescing is enabled.
+ */
+bool isWriteCoalescingEnabled(void);
+
+/**
+ * @brief Adds a write request to the pending writes of its session if coalescing is enabled
+ * @param[in]  client Client Handle.
+ * @param[in]  msg EdgeMessage write request data, it is copied.
+ * @return true if the write is sent later with the pending writes, false if it has to be executed now.
+ */
+bool coalesceWrite(UA_Client *client, const EdgeMessage *msg);
+
+/**
+ * @brief Sends the pending writes of a session in one write request
+ * @param[in]  client Client Handle.
+ * @param[in]  msg Flush message queued when the first of the pending writes arrived.
+ * @return @c EdgeResult code is 0 on success, otherwise an error value
+ * @retval #STATUS_OK Successful
+ * @retval #STATUS_PARAM_INVALID Invalid parameter
+ * @retval #STATUS_ERROR Operation failed
+ */
+EdgeResult flushCoalescedWrites(UA_Client *client, const EdgeMessage *msg);
+
+/**
+ * @brief Drops the pending writes of a client, called when its session ends
+ * @param[in]  client Client Handle.
+ */
+void removeCoalescedWrites(UA_Client *client);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // EDGE_WRITE_COALESCE_H
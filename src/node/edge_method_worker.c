@@ -0,0 +1,312 @@
+/******************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ *
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************/
+
+#include "edge_method_worker.h"
+#include "edge_node.h"
+#include "edge_utils.h"
+#include "edge_logger.h"
+#include "edge_malloc.h"
+#include "cathreadpool.h"
+#include "edge_thread_config.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#ifndef _WIN32
+#include <pthread.h>
+#else
+#include "pthread.h"
+#endif
+
+#define TAG "edge_method_worker"
+
+#define DEFAULT_METHOD_WORKERS (2)
+#define MAX_METHOD_WORKERS (32)
+
+#define METHOD_OUTPUT_SUFFIX "_Output%u"
+#define METHOD_OUTPUT_SUFFIX_SIZE (32)
+
+/* Call of an asynchronous method, queued for the workers and then for the server loop */
+typedef struct MethodCall
+{
+    UA_Server *server;
+    const EdgeMethodNode *node;
+    UA_NodeId methodId;
+    size_t inputSize;
+    UA_Variant *input;
+    size_t outputSize;
+    UA_Variant *output;
+    UA_StatusCode status;
+    struct MethodCall *next;
+} MethodCall;
+
+/* Workers shared by the servers of the process, guarded by workersMutex */
+static ca_thread_pool_t methodWorkers = NULL;
+static size_t methodWorkerUsers = 0;
+static uint32_t methodWorkerCount = 0;
+static pthread_mutex_t workersMutex = PTHREAD_MUTEX_INITIALIZER;
+
+/* Completed calls in completion order, delivered by the server loop */
+static MethodCall *completedHead = NULL;
+static MethodCall *completedTail = NULL;
+static pthread_mutex_t completedMutex = PTHREAD_MUTEX_INITIALIZER;
+
+static void freeMethodCall(MethodCall *call)
+{
+    UA_Array_delete(call->input, call->inputSize, &UA_TYPES[UA_TYPES_VARIANT]);
+    UA_Array_delete(call->output, call->outputSize, &UA_TYPES[UA_TYPES_VARIANT]);
+    UA_NodeId_deleteMembers(&call->methodId);
+    EdgeFree(call);
+}
+
+/**
+ * @brief executeMethodCall - Worker task which calls the method and queues its outputs
+ * @param data - Method call
+ */
+static void executeMethodCall(void *data)
+{
+    MethodCall *call = (MethodCall *) data;
+    call->output = (UA_Variant *) UA_Array_new(call->outputSize, &UA_TYPES[UA_TYPES_VARIANT]);
+    if (IS_NULL(call->output))
+    {
+        call->outputSize = 0;
+        call->status = UA_STATUSCODE_BADOUTOFMEMORY;
+    }
+    else
+    {
+        call->status = invokeMethod(call->node, call->inputSize, call->input, call->outputSize,
+                call->output);
+    }
+
+    pthread_mutex_lock(&completedMutex);
+    if (IS_NULL(completedTail))
+    {
+        completedHead = call;
+    }
+    else
+    {
+        completedTail->next = call;
+    }
+    completedTail = call;
+    pthread_mutex_unlock(&completedMutex);
+}
+
+/**
+ * @brief takeCompletedCalls - Takes the completed calls of a server
+ * @param server - server of the calls, NULL for the calls of every server
+ * @return First completed call, NULL if there is none
+ */
+static MethodCall *takeCompletedCalls(const UA_Server *server)
+{
+    MethodCall *calls = NULL;
+    MethodCall **callsTail = &calls;
+    pthread_mutex_lock(&completedMutex);
+    MethodCall **link = &completedHead;
+    completedTail = NULL;
+    while (IS_NOT_NULL(*link))
+    {
+        MethodCall *call = *link;
+        if (IS_NULL(server) || call->server == server)
+        {
+            *link = call->next;
+            call->next = NULL;
+            *callsTail = call;
+            callsTail = &call->next;
+        }
+        else
+        {
+            completedTail = call;
+            link = &call->next;
+        }
+    }
+    pthread_mutex_unlock(&completedMutex);
+    return calls;
+}
+
+/**
+ * @brief freeMethodCalls - Frees a list of calls
+ * @param call - First call of the list
+ */
+static void freeMethodCalls(MethodCall *call)
+{
+    while (IS_NOT_NULL(call))
+    {
+        MethodCall *next = call->next;
+        freeMethodCall(call);
+        call = next;
+    }
+}
+
+bool getMethodOutputNodeId(const UA_NodeId *methodId, size_t index, UA_NodeId *outputNodeId)
+{
+    UA_NodeId_init(outputNodeId);
+    COND_CHECK((methodId->identifierType != UA_NODEIDTYPE_STRING), false);
+    char suffix[METHOD_OUTPUT_SUFFIX_SIZE];
+    int suffixLength = snprintf(suffix, sizeof(suffix), METHOD_OUTPUT_SUFFIX, (unsigned) index);
+    COND_CHECK((suffixLength < 0 || (size_t) suffixLength >= sizeof(suffix)), false);
+
+    size_t length = methodId->identifier.string.length;
+    UA_Byte *data = (UA_Byte *) UA_malloc(length + (size_t) suffixLength);
+    VERIFY_NON_NULL_MSG(data, "UA_malloc FAILED in getMethodOutputNodeId\n", false);
+    memcpy(data, methodId->identifier.string.data, length);
+    memcpy(data + length, suffix, (size_t) suffixLength);
+    outputNodeId->namespaceIndex = methodId->namespaceIndex;
+    outputNodeId->identifierType = UA_NODEIDTYPE_STRING;
+    outputNodeId->identifier.string.length = length + (size_t) suffixLength;
+    outputNodeId->identifier.string.data = data;
+    return true;
+}
+
+void setMethodWorkerThreads(uint32_t workerCount)
+{
+    pthread_mutex_lock(&workersMutex);
+    methodWorkerCount = workerCount;
+    pthread_mutex_unlock(&workersMutex);
+}
+
+bool startMethodWorkers()
+{
+    pthread_mutex_lock(&workersMutex);
+    if (IS_NOT_NULL(methodWorkers))
+    {
+        /* The first server sets the number of workers */
+        methodWorkerUsers++;
+        pthread_mutex_unlock(&workersMutex);
+        return true;
+    }
+
+    uint32_t workerCount = methodWorkerCount;
+    if (0 == workerCount)
+    {
+        workerCount = DEFAULT_METHOD_WORKERS;
+    }
+    else if (workerCount > MAX_METHOD_WORKERS)
+    {
+        workerCount = MAX_METHOD_WORKERS;
+    }
+
+    CAResult_t res = ca_thread_pool_init((int32_t) workerCount, &methodWorkers);
+    if (CA_STATUS_OK != res)
+    {
+        EDGE_LOG_V(TAG, "Failed to create %u method workers\n", workerCount);
+        methodWorkers = NULL;
+        pthread_mutex_unlock(&workersMutex);
+        return false;
+    }
+    ca_thread_pool_set_start_routine(methodWorkers, startEdgeThreadWorker,
+            (void *) (intptr_t) EDGE_THREAD_HELPER);
+    methodWorkerUsers = 1;
+    pthread_mutex_unlock(&workersMutex);
+    return true;
+}
+
+void stopMethodWorkers(UA_Server *server)
+{
+    pthread_mutex_lock(&workersMutex);
+    if (IS_NULL(methodWorkers))
+    {
+        pthread_mutex_unlock(&workersMutex);
+        return;
+    }
+    ca_thread_pool_t workers = NULL;
+    if (0 == --methodWorkerUsers)
+    {
+        workers = methodWorkers;
+        methodWorkers = NULL;
+    }
+    pthread_mutex_unlock(&workersMutex);
+
+    if (IS_NULL(workers))
+    {
+        /* Other servers keep the workers, calls of this one which complete later are dropped
+         * when the last server stops */
+        freeMethodCalls(takeCompletedCalls(server));
+        return;
+    }
+
+    /* Queued calls are completed before the workers exit */
+    ca_thread_pool_free(workers);
+    freeMethodCalls(takeCompletedCalls(NULL));
+}
+
+UA_StatusCode submitMethodCall(UA_Server *server, const EdgeMethodNode *node,
+        const UA_NodeId *methodId, size_t inputSize, const UA_Variant *input, size_t outputSize)
+{
+    VERIFY_NON_NULL_MSG(methodWorkers, "Method workers are not running\n",
+            UA_STATUSCODE_BADRESOURCEUNAVAILABLE);
+    MethodCall *call = (MethodCall *) EdgeCalloc(1, sizeof(MethodCall));
+    VERIFY_NON_NULL_MSG(call, "EdgeCalloc FAILED for MethodCall\n", UA_STATUSCODE_BADOUTOFMEMORY);
+    call->server = server;
+    call->node = node;
+    call->outputSize = outputSize;
+
+    /* The decoded request is freed when the callback returns, the worker gets a copy */
+    if (UA_NodeId_copy(methodId, &call->methodId) != UA_STATUSCODE_GOOD
+            || UA_Array_copy(input, inputSize, (void **) &call->input,
+                    &UA_TYPES[UA_TYPES_VARIANT]) != UA_STATUSCODE_GOOD)
+    {
+        freeMethodCall(call);
+        return UA_STATUSCODE_BADOUTOFMEMORY;
+    }
+    call->inputSize = inputSize;
+
+    if (CA_STATUS_OK != ca_thread_pool_add_task(methodWorkers, executeMethodCall, call, NULL))
+    {
+        EDGE_LOG(TAG, "Failed to queue the method call\n");
+        freeMethodCall(call);
+        return UA_STATUSCODE_BADRESOURCEUNAVAILABLE;
+    }
+    return UA_STATUSCODE_GOODCOMPLETESASYNCHRONOUSLY;
+}
+
+void deliverMethodResults(UA_Server *server)
+{
+    MethodCall *call = takeCompletedCalls(server);
+    while (IS_NOT_NULL(call))
+    {
+        MethodCall *next = call->next;
+
+        /* Each output carries the status of the call, the write copies the output */
+        for (size_t i = 0; i < call->outputSize; i++)
+        {
+            UA_WriteValue wv;
+            UA_WriteValue_init(&wv);
+            if (!getMethodOutputNodeId(&call->methodId, i, &wv.nodeId))
+            {
+                break;
+            }
+            wv.attributeId = UA_ATTRIBUTEID_VALUE;
+            wv.value.value = call->output[i];
+            wv.value.hasValue = (UA_STATUSCODE_GOOD == call->status);
+            wv.value.status = call->status;
+            wv.value.hasStatus = (UA_STATUSCODE_GOOD != call->status);
+            UA_StatusCode ret = UA_Server_write(server, &wv);
+            UA_NodeId_deleteMembers(&wv.nodeId);
+            if (UA_STATUSCODE_GOOD != ret)
+            {
+                EDGE_LOG_V(TAG, "Failed to write method output %d :: 0x%08x(%s)\n", (int) i, ret,
+                        UA_StatusCode_name(ret));
+            }
+        }
+
+        freeMethodCall(call);
+        call = next;
+    }
+}
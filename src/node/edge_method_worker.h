@@ -0,0 +1,95 @@
+/******************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ *
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************/
+
+/**
+ * @file edge_method_worker.h
+ *
+ * @brief This file contains the worker pool which executes the asynchronous methods of the server.
+ */
+
+#ifndef EDGE_METHOD_WORKER_H
+#define EDGE_METHOD_WORKER_H
+
+#include "opcua_common.h"
+#include "edge_node.h"
+
+#include <open62541.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/**
+ * @brief Sets the number of worker threads of asynchronous methods,
+ *        it takes effect when the workers are started next.
+ * @param[in]  workerCount Number of worker threads, 0 for the default
+ */
+void setMethodWorkerThreads(uint32_t workerCount);
+
+/**
+ * @brief Starts the worker threads of asynchronous methods, called when a server starts.
+ *        The servers of the process share the workers of the first one.
+ * @return @c true on success, @c false if the threads cannot be created
+ */
+bool startMethodWorkers();
+
+/**
+ * @brief Called when a server stops, results of its calls which are not delivered yet are dropped.
+ *        When the last server stops, it waits for the queued method calls and stops the workers.
+ * @param[in]  server Server Handle
+ */
+void stopMethodWorkers(UA_Server *server);
+
+/**
+ * @brief Gets the NodeId of the property which receives an output argument of an asynchronous
+ *        method, the string NodeId of the method with the suffix "_Output<index>"
+ * @param[in]  methodId NodeId of the method node
+ * @param[in]  index Index of the output argument
+ * @param[out] outputNodeId NodeId of the property, it is freed with UA_NodeId_deleteMembers
+ * @return @c true on success, @c false if the method has no string NodeId or memory is insufficient
+ */
+bool getMethodOutputNodeId(const UA_NodeId *methodId, size_t index, UA_NodeId *outputNodeId);
+
+/**
+ * @brief Queues a call of an asynchronous method for the workers
+ * @param[in]  server Server Handle, whose loop delivers the results
+ * @param[in]  node Method node
+ * @param[in]  methodId NodeId of the method node, it is copied
+ * @param[in]  inputSize Number of input arguments
+ * @param[in]  input Input arguments, they are copied
+ * @param[in]  outputSize Number of output arguments
+ * @return GoodCompletesAsynchronously if the call is queued, otherwise an error status
+ */
+UA_StatusCode submitMethodCall(UA_Server *server, const EdgeMethodNode *node,
+        const UA_NodeId *methodId, size_t inputSize, const UA_Variant *input, size_t outputSize);
+
+/**
+ * @brief Writes the output arguments of the completed calls of a server to their output nodes,
+ *        called by the server loop, which owns the server.
+ * @param[in]  server Server Handle
+ */
+void deliverMethodResults(UA_Server *server);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // EDGE_METHOD_WORKER_H
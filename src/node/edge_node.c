@@ -20,18 +20,72 @@
 
 #include "edge_node.h"
 #include "edge_utils.h"
-#include "edge_map.h"
+#include "edge_hash_map.h"
 #include "edge_logger.h"
 #include "edge_malloc.h"
 #include "edge_open62541.h"
+#include "edge_method_worker.h"
+#include "edge_server_stats.h"
 
 #include <stdio.h>
+#ifndef _WIN32
+#include <pthread.h>
+#else
+#include "pthread.h"
+#endif
 
 #define TAG "edge_node"
 #define MAX_ARGS  (10)
 
-static edgeMap *methodNodeMap = NULL;
+/* Browse name of an output property of an asynchronous method */
+#define METHOD_OUTPUT_NAME "Output%u"
+#define METHOD_OUTPUT_NAME_SIZE (32)
+
+static EdgeHashMap *methodNodeMap = NULL;
 static size_t methodNodeCount = 0;
+
+/* Nodes of one server, so that several servers can run in a process */
+typedef struct ServerNodes ServerNodes;
+
+/* Type of a variable node, so that modifyNode() need not read the value before writing it.
+ * Entries are the handles of getVariableNode(), they are freed with the nodes of their server. */
+struct EdgeVariableNode
+{
+    ServerNodes *owner;
+    uint16_t nsIndex;
+    UA_UInt16 typeIndex;
+    bool isArray;
+    char browseName[];
+};
+
+/* Node context of a data source variable node */
+typedef struct DataSourceNode
+{
+    struct DataSourceNode *next;
+    UA_UInt16 typeIndex;
+    bool isArray;
+    data_source_read_func read_fn;
+    data_source_write_func write_fn;
+    void *context;
+    char browseName[];
+} DataSourceNode;
+
+struct ServerNodes
+{
+    struct ServerNodes *next;
+    UA_Server *server;
+    void *context;
+    /* Browse name -> EdgeVariableNode */
+    EdgeHashMap *variableNodes;
+    /* Contexts of the data source nodes, freed when the server is deleted */
+    DataSourceNode *dataSourceNodes;
+    /* Nodestore which modifyNode() compares values in, NULL to write every value */
+    const UA_Nodestore *compareNodestore;
+};
+
+/* Nodes of each registered server, guarded by serverNodesMutex */
+static ServerNodes *serverNodes = NULL;
+static pthread_mutex_t serverNodesMutex = PTHREAD_MUTEX_INITIALIZER;
 //static int numeric_id = 1000;
 
 /****************************** Static functions ***********************************/
@@ -43,6 +97,102 @@ static void getDisplayInfo(const EdgeNodeItem *item, char* displayInfo) {
     }
 }
 
+/**
+ * @brief getServerNodes - Gets the nodes of a server, serverNodesMutex is held by the caller
+ * @param server - server handle
+ * @return nodes of the server, NULL if the server is not registered
+ */
+static ServerNodes *getServerNodes(const UA_Server *server)
+{
+    ServerNodes *nodes = serverNodes;
+    while (IS_NOT_NULL(nodes) && nodes->server != server)
+    {
+        nodes = nodes->next;
+    }
+    return nodes;
+}
+
+/**
+ * @brief storeVariableNodeType - Caches the type of a variable node
+ * @param server - server handle
+ * @param nsIndex - namespace index of the node
+ * @param browseName - browse name of the node, which is its string NodeId
+ * @param typeIndex - index of the value type in UA_TYPES
+ * @param isArray - true if the value is an array
+ */
+static void storeVariableNodeType(UA_Server *server, uint16_t nsIndex, const char *browseName,
+        UA_UInt16 typeIndex, bool isArray)
+{
+    pthread_mutex_lock(&serverNodesMutex);
+    ServerNodes *nodes = getServerNodes(server);
+    if (IS_NOT_NULL(nodes) && IS_NULL(nodes->variableNodes))
+    {
+        nodes->variableNodes = createEdgeHashMap(EDGE_HASH_STRING_KEY);
+    }
+    EdgeVariableNode *entry = NULL;
+    if (IS_NOT_NULL(nodes) && IS_NOT_NULL(nodes->variableNodes))
+    {
+        entry = (EdgeVariableNode *) getEdgeHashMapElement(nodes->variableNodes,
+                (keyValue) browseName);
+        if (IS_NULL(entry))
+        {
+            size_t length = strlen(browseName);
+            entry = (EdgeVariableNode *) EdgeMalloc(sizeof(EdgeVariableNode) + length + 1);
+            if (IS_NOT_NULL(entry))
+            {
+                entry->owner = nodes;
+                memcpy(entry->browseName, browseName, length + 1);
+                if (!insertEdgeHashMapElement(nodes->variableNodes, (keyValue) entry->browseName,
+                        entry))
+                {
+                    EdgeFree(entry);
+                    entry = NULL;
+                }
+            }
+        }
+    }
+    if (IS_NOT_NULL(entry))
+    {
+        /* A node of the same name in another namespace replaces it */
+        entry->nsIndex = nsIndex;
+        entry->typeIndex = typeIndex;
+        entry->isArray = isArray;
+    }
+    pthread_mutex_unlock(&serverNodesMutex);
+}
+
+/**
+ * @brief getVariableNodeType - Gets the cached type of a variable node
+ * @param server - server handle
+ * @param nsIndex - namespace index of the node
+ * @param browseName - browse name of the node
+ * @param typeIndex - receives the index of the value type in UA_TYPES
+ * @param isArray - receives true if the value is an array
+ * @param compareNodestore - receives the nodestore of setServerNodesWriteOnChange(), or NULL
+ * @return true if the type of the node is cached, otherwise false
+ */
+static bool getVariableNodeType(UA_Server *server, uint16_t nsIndex, const char *browseName,
+        UA_UInt16 *typeIndex, bool *isArray, const UA_Nodestore **compareNodestore)
+{
+    bool found = false;
+    pthread_mutex_lock(&serverNodesMutex);
+    ServerNodes *nodes = getServerNodes(server);
+    *compareNodestore = IS_NOT_NULL(nodes) ? nodes->compareNodestore : NULL;
+    if (IS_NOT_NULL(nodes) && IS_NOT_NULL(nodes->variableNodes))
+    {
+        EdgeVariableNode *entry = (EdgeVariableNode *) getEdgeHashMapElement(nodes->variableNodes,
+                (keyValue) browseName);
+        if (IS_NOT_NULL(entry) && entry->nsIndex == nsIndex)
+        {
+            *typeIndex = entry->typeIndex;
+            *isArray = entry->isArray;
+            found = true;
+        }
+    }
+    pthread_mutex_unlock(&serverNodesMutex);
+    return found;
+}
+
 static UA_Byte getAccessLevel(int level)
 {
     UA_Byte access_lvl = UA_ACCESSLEVELMASK_READ | UA_ACCESSLEVELMASK_WRITE;
@@ -57,6 +207,163 @@ static UA_Byte getAccessLevel(int level)
     return access_lvl;
 }
 
+/**
+ * @brief readDataSourceValue - Reads the value of a data source node from its read callback
+ * @return GOOD status on success, otherwise an error status
+ */
+static UA_StatusCode readDataSourceValue(void *nodeContext, UA_Boolean includeSourceTimeStamp,
+        const UA_NumericRange *range, UA_DataValue *value)
+{
+    DataSourceNode *node = (DataSourceNode *) nodeContext;
+    VERIFY_NON_NULL_MSG(node, "NULL data source node\n", UA_STATUSCODE_BADINTERNALERROR);
+
+    EdgeVersatility data;
+    memset(&data, 0, sizeof(EdgeVersatility));
+    if (!node->read_fn(node->browseName, node->context, &data) || IS_NULL(data.value))
+    {
+        EDGE_LOG_V(TAG, "No value from the data source of [%s]\n", node->browseName);
+        return UA_STATUSCODE_BADNODATA;
+    }
+
+    UA_Variant full;
+    UA_Variant_init(&full);
+    UA_StatusCode ret;
+    if (node->isArray)
+    {
+        ret = createArrayVariant(node->typeIndex, data.value, data.arrayLength, &full);
+    }
+    else
+    {
+        ret = createScalarVariant(node->typeIndex, data.value, &full);
+    }
+    COND_CHECK((ret != UA_STATUSCODE_GOOD), ret);
+
+    if (IS_NOT_NULL(range))
+    {
+        ret = UA_Variant_copyRange(&full, &value->value, *range);
+        UA_Variant_deleteMembers(&full);
+        COND_CHECK((ret != UA_STATUSCODE_GOOD), ret);
+    }
+    else
+    {
+        value->value = full;
+    }
+    value->hasValue = true;
+    if (includeSourceTimeStamp)
+    {
+        value->hasSourceTimestamp = true;
+        value->sourceTimestamp = UA_DateTime_now();
+    }
+    return UA_STATUSCODE_GOOD;
+}
+
+static UA_StatusCode readDataSource(UA_Server *server, const UA_NodeId *sessionId,
+        void *sessionContext, const UA_NodeId *nodeId, void *nodeContext,
+        UA_Boolean includeSourceTimeStamp, const UA_NumericRange *range, UA_DataValue *value)
+{
+    uint64_t start = getServerServiceTime();
+    UA_StatusCode ret = readDataSourceValue(nodeContext, includeSourceTimeStamp, range, value);
+    recordServerService(server, EDGE_SERVER_SERVICE_READ, start, ret);
+    return ret;
+}
+
+/**
+ * @brief writeDataSourceValue - Passes a value written to a data source node to its write callback
+ * @return GOOD status on success, otherwise an error status
+ */
+static UA_StatusCode writeDataSourceValue(void *nodeContext, const UA_NumericRange *range,
+        const UA_DataValue *value)
+{
+    DataSourceNode *node = (DataSourceNode *) nodeContext;
+    VERIFY_NON_NULL_MSG(node, "NULL data source node\n", UA_STATUSCODE_BADINTERNALERROR);
+    COND_CHECK((IS_NULL(node->write_fn)), UA_STATUSCODE_BADNOTWRITABLE);
+    COND_CHECK((IS_NOT_NULL(range)), UA_STATUSCODE_BADWRITENOTSUPPORTED);
+    COND_CHECK((!value->hasValue || value->value.type != &UA_TYPES[node->typeIndex]
+            || UA_Variant_isScalar(&value->value) == node->isArray), UA_STATUSCODE_BADTYPEMISMATCH);
+
+    /* Strings are passed as the UA_String of the request, which has the layout of Edge_String */
+    EdgeVersatility data;
+    data.value = value->value.data;
+    data.isArray = node->isArray;
+    data.arrayLength = node->isArray ? value->value.arrayLength : 0;
+    if (!node->write_fn(node->browseName, node->context, &data))
+    {
+        EDGE_LOG_V(TAG, "Data source of [%s] did not take the value\n", node->browseName);
+        return UA_STATUSCODE_BADINTERNALERROR;
+    }
+    return UA_STATUSCODE_GOOD;
+}
+
+static UA_StatusCode writeDataSource(UA_Server *server, const UA_NodeId *sessionId,
+        void *sessionContext, const UA_NodeId *nodeId, void *nodeContext,
+        const UA_NumericRange *range, const UA_DataValue *value)
+{
+    uint64_t start = getServerServiceTime();
+    UA_StatusCode ret = writeDataSourceValue(nodeContext, range, value);
+    recordServerService(server, EDGE_SERVER_SERVICE_WRITE, start, ret);
+    return ret;
+}
+
+/**
+ * @brief addDataSourceNode - Add a variable node whose value comes from the callbacks of the item
+ * @param server - server handle
+ * @param nsIndex - namespace index under which node has to be added
+ * @param item - node to add
+ * @param typeIndex - index of the value type in UA_TYPES
+ * @param isArray - true if the value is an array
+ * @param attr - attributes of the node without a value
+ * @return GOOD status on success, otherwise an error status
+ */
+static UA_StatusCode addDataSourceNode(UA_Server *server, uint16_t nsIndex,
+        const EdgeNodeItem *item, UA_UInt16 typeIndex, bool isArray, UA_VariableAttributes *attr)
+{
+    /* The context of the node is freed with the nodes of the server */
+    pthread_mutex_lock(&serverNodesMutex);
+    bool registered = IS_NOT_NULL(getServerNodes(server));
+    pthread_mutex_unlock(&serverNodesMutex);
+    COND_CHECK_MSG((!registered), "Data source node of an unregistered server\n",
+            UA_STATUSCODE_BADINTERNALERROR);
+
+    size_t length = strlen(item->browseName);
+    DataSourceNode *node = (DataSourceNode *) EdgeCalloc(1, sizeof(DataSourceNode) + length + 1);
+    VERIFY_NON_NULL_MSG(node, "EdgeCalloc FAILED for the data source node\n",
+            UA_STATUSCODE_BADOUTOFMEMORY);
+    memcpy(node->browseName, item->browseName, length + 1);
+    node->typeIndex = typeIndex;
+    node->isArray = isArray;
+    node->read_fn = item->read_fn;
+    node->write_fn = item->write_fn;
+    node->context = item->dataSourceContext;
+
+    if (IS_NULL(item->write_fn))
+    {
+        attr->accessLevel &= (UA_Byte) ~UA_ACCESSLEVELMASK_WRITE;
+        attr->userAccessLevel &= (UA_Byte) ~UA_ACCESSLEVELMASK_WRITE;
+    }
+
+    UA_DataSource dataSource;
+    dataSource.read = readDataSource;
+    dataSource.write = writeDataSource;
+    UA_StatusCode status = UA_Server_addDataSourceVariableNode(server,
+            UA_NODEID_STRING(nsIndex, item->browseName),
+            UA_NODEID_NUMERIC(0, UA_NS0ID_OBJECTSFOLDER), UA_NODEID_NUMERIC(0, UA_NS0ID_ORGANIZES),
+            UA_QUALIFIEDNAME(nsIndex, item->browseName), UA_NODEID_NUMERIC(0, 63), *attr,
+            dataSource, node, NULL);
+    if (status != UA_STATUSCODE_GOOD)
+    {
+        EdgeFree(node);
+        return status;
+    }
+
+    /* Servers are only unregistered after they are deleted */
+    pthread_mutex_lock(&serverNodesMutex);
+    ServerNodes *nodes = getServerNodes(server);
+    node->next = nodes->dataSourceNodes;
+    nodes->dataSourceNodes = node;
+    pthread_mutex_unlock(&serverNodesMutex);
+    return status;
+}
+
 /**
  * @brief addVariableNode - Add variable node to server
  * @param server - server handle
@@ -85,16 +392,26 @@ static void addVariableNode(UA_Server *server, uint16_t nsIndex, const EdgeNodeI
     attr.valueRank = -1;
 
     int type = (int) id - 1;
-    createScalarVariant(type, item->variableData, &attr.value);
+    UA_StatusCode status;
+    if (IS_NOT_NULL(item->read_fn))
+    {
+        status = addDataSourceNode(server, nsIndex, item, (UA_UInt16) type, false, &attr);
+    }
+    else
+    {
+        createScalarVariant(type, item->variableData, &attr.value);
 
-    UA_StatusCode status = UA_Server_addVariableNode(server, UA_NODEID_STRING(nsIndex, item->browseName),
-            UA_NODEID_NUMERIC(0, UA_NS0ID_OBJECTSFOLDER), UA_NODEID_NUMERIC(0, UA_NS0ID_ORGANIZES),
-            UA_QUALIFIEDNAME(nsIndex, name), UA_NODEID_NUMERIC(0, 63), attr, NULL, NULL);
+        status = UA_Server_addVariableNode(server, UA_NODEID_STRING(nsIndex, item->browseName),
+                UA_NODEID_NUMERIC(0, UA_NS0ID_OBJECTSFOLDER),
+                UA_NODEID_NUMERIC(0, UA_NS0ID_ORGANIZES), UA_QUALIFIEDNAME(nsIndex, name),
+                UA_NODEID_NUMERIC(0, 63), attr, NULL, NULL);
 
-    UA_Variant_deleteMembers(&attr.value);
+        UA_Variant_deleteMembers(&attr.value);
+    }
 
     COND_CHECK_NR_MSG((status != UA_STATUSCODE_GOOD), "+++ addVariableNode failed +++\n");
     EDGE_LOG(TAG, "+++ addVariableNode success +++\n");
+    storeVariableNodeType(server, nsIndex, item->browseName, (UA_UInt16) type, false);
 }
 
 /**
@@ -125,16 +442,26 @@ static void addArrayNode(UA_Server *server, uint16_t nsIndex, const EdgeNodeItem
     EDGE_LOG_V(TAG, "[%s] sampling interval : %lf\n", item->browseName, item->minimumSamplingInterval);
 
     int type = (int) id - 1;
-    createArrayVariant(type, item->variableData, item->arrayLength, &attr.value);
+    UA_StatusCode status;
+    if (IS_NOT_NULL(item->read_fn))
+    {
+        status = addDataSourceNode(server, nsIndex, item, (UA_UInt16) type, true, &attr);
+    }
+    else
+    {
+        createArrayVariant(type, item->variableData, item->arrayLength, &attr.value);
 
-    UA_StatusCode status = UA_Server_addVariableNode(server, UA_NODEID_STRING(nsIndex, item->browseName),
-            UA_NODEID_NUMERIC(0, UA_NS0ID_OBJECTSFOLDER), UA_NODEID_NUMERIC(0, UA_NS0ID_ORGANIZES),
-            UA_QUALIFIEDNAME(nsIndex, name), UA_NODEID_NUMERIC(0, 63), attr, NULL, NULL);
+        status = UA_Server_addVariableNode(server, UA_NODEID_STRING(nsIndex, item->browseName),
+                UA_NODEID_NUMERIC(0, UA_NS0ID_OBJECTSFOLDER),
+                UA_NODEID_NUMERIC(0, UA_NS0ID_ORGANIZES), UA_QUALIFIEDNAME(nsIndex, name),
+                UA_NODEID_NUMERIC(0, 63), attr, NULL, NULL);
 
-    UA_Variant_deleteMembers(&attr.value);
+        UA_Variant_deleteMembers(&attr.value);
+    }
 
     COND_CHECK_NR_MSG((status != UA_STATUSCODE_GOOD), "+++ addArrayNode failed +++\n");
     EDGE_LOG(TAG, "+++ addArrayNode success +++\n");
+    storeVariableNodeType(server, nsIndex, item->browseName, (UA_UInt16) type, true);
 }
 
 /**
@@ -383,15 +710,122 @@ static void addReferenceTypeNode(UA_Server *server, uint16_t nsIndex, const Edge
     COND_CHECK_NR_MSG((status != UA_STATUSCODE_GOOD), "+++ UA_Server_addReference failed +++\n");
 }
 
-static keyValue getMethodMapElement(const edgeMap *map, keyValue key)
+/**
+ * @brief writeNodeValue - Writes a value of the given type to a variable node
+ * @param server - server handle
+ * @param node - NodeId of the variable node
+ * @param typeIndex - index of the value type in UA_TYPES
+ * @param isArray - true if the value is an array of value->arrayLength elements
+ * @param value - value to write
+ * @return GOOD status on success, otherwise an error status
+ */
+static UA_StatusCode writeNodeValue(UA_Server *server, const UA_NodeId *node, UA_UInt16 typeIndex,
+        bool isArray, const EdgeVersatility *value)
+{
+    UA_Variant variant;
+    UA_Variant_init(&variant);
+    const UA_DataType *type = &UA_TYPES[typeIndex];
+    if (type->pointerFree)
+    {
+        /* The server copies the value into the node, plain values are passed as they are */
+        if (isArray)
+        {
+            UA_Variant_setArray(&variant, value->value, value->arrayLength, type);
+        }
+        else
+        {
+            UA_Variant_setScalar(&variant, value->value, type);
+        }
+        return UA_Server_writeValue(server, *node, variant);
+    }
+
+    UA_StatusCode ret;
+    if (isArray)
+    {
+        ret = createArrayVariant(typeIndex, value->value, value->arrayLength, &variant);
+    }
+    else
+    {
+        ret = createScalarVariant(typeIndex, value->value, &variant);
+    }
+    if (ret == UA_STATUSCODE_GOOD)
+    {
+        ret = UA_Server_writeValue(server, *node, variant);
+    }
+    UA_Variant_deleteMembers(&variant);
+    return ret;
+}
+
+/**
+ * @brief isEdgeValueEqual - Compares a value with a variant of the given type
+ * @param current - variant of the node
+ * @param typeIndex - index of the value type in UA_TYPES
+ * @param isArray - true if the value is an array of value->arrayLength elements
+ * @param value - value to compare
+ * @return true if the values are equal, false if they differ or the type is not compared
+ */
+static bool isEdgeValueEqual(const UA_Variant *current, UA_UInt16 typeIndex, bool isArray,
+        const EdgeVersatility *value)
+{
+    size_t count = isArray ? value->arrayLength : 1;
+    COND_CHECK((isArray && current->arrayLength != count), false);
+    COND_CHECK((0 == count), true);
+    const UA_DataType *type = &UA_TYPES[typeIndex];
+    if (type->pointerFree)
+    {
+        /* Plain values have the same layout in the Edge and the stack representation */
+        return 0 == memcmp(current->data, value->value, count * type->memSize);
+    }
+    if (typeIndex != UA_TYPES_STRING && typeIndex != UA_TYPES_BYTESTRING
+            && typeIndex != UA_TYPES_XMLELEMENT)
+    {
+        return false;
+    }
+
+    const UA_String *strings = (const UA_String *) current->data;
+    for (size_t i = 0; i < count; i++)
+    {
+        const char *str = isArray ? ((char **) value->value)[i] : (const char *) value->value;
+        if (IS_NULL(str) || strings[i].length != strlen(str)
+                || 0 != memcmp(strings[i].data, str, strings[i].length))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief isNodeValueUnchanged - Compares a value with the value of a variable node in the
+ *        nodestore, without copying the value of the node
+ * @param nodestore - nodestore of the server
+ * @param node - NodeId of the variable node
+ * @param typeIndex - index of the value type in UA_TYPES
+ * @param isArray - true if the value is an array of value->arrayLength elements
+ * @param value - value to compare
+ * @return true if the node holds the value, otherwise false
+ */
+static bool isNodeValueUnchanged(const UA_Nodestore *nodestore, const UA_NodeId *node,
+        UA_UInt16 typeIndex, bool isArray, const EdgeVersatility *value)
 {
-    edgeMapNode *temp = map->head;
-    while (temp != NULL)
+    COND_CHECK((IS_NULL(value->value)), false);
+    const UA_Node *stored = nodestore->getNode(nodestore->context, node);
+    COND_CHECK((IS_NULL(stored)), false);
+    bool unchanged = false;
+    if (stored->nodeClass == UA_NODECLASS_VARIABLE)
     {
-        COND_CHECK_MSG((!strcmp(temp->key, key)), "", temp->value);
-        temp = temp->next;
+        /* Values of data source nodes are not stored, they are always written */
+        const UA_VariableNode *variable = (const UA_VariableNode *) stored;
+        const UA_Variant *current = &variable->value.data.value.value;
+        if (variable->valueSource == UA_VALUESOURCE_DATA
+                && current->type == &UA_TYPES[typeIndex]
+                && UA_Variant_isScalar(current) == !isArray)
+        {
+            unchanged = isEdgeValueEqual(current, typeIndex, isArray, value);
+        }
     }
-    return NULL;
+    nodestore->releaseNode(nodestore->context, stored);
+    return unchanged;
 }
 
 static void destroyInputArgs(void **inp, size_t inputSize, const UA_Variant *input)
@@ -421,16 +855,138 @@ static void destroyInputArgs(void **inp, size_t inputSize, const UA_Variant *inp
     EdgeFree(inp);
 }
 
-static UA_StatusCode methodCallback(UA_Server *server, const UA_NodeId *sessionId,
-        void *sessionContext, const UA_NodeId *methodId, void *methodContext,
-        const UA_NodeId *objectId, void *objectContext, size_t inputSize, const UA_Variant *input,
-        size_t outputSize, UA_Variant *output)
+/**
+ * @brief addMethodOutputNodes - Adds one property per output argument of an asynchronous method
+ * node, which receives the output of each completed call
+ * @param server - Server handle
+ * @param methodId - NodeId of the method node
+ * @param method - Method of the node
+ */
+static void addMethodOutputNodes(UA_Server *server, const UA_NodeId *methodId,
+        const EdgeMethod *method)
 {
-    char *key = (char *) methodId->identifier.string.data;
-    keyValue value = getMethodMapElement(methodNodeMap, (keyValue) key);
-    VERIFY_NON_NULL_MSG(value, "", UA_STATUSCODE_BADMETHODINVALID);
+    for (size_t idx = 0; idx < method->num_outArgs; idx++)
+    {
+        char name[METHOD_OUTPUT_NAME_SIZE];
+        UA_NodeId outputNodeId;
+        if (!getMethodOutputNodeId(methodId, idx, &outputNodeId))
+        {
+            EDGE_LOG(TAG, "+++ addMethodOutputNodes failed +++\n");
+            return;
+        }
+        snprintf(name, sizeof(name), METHOD_OUTPUT_NAME, (unsigned) idx);
+
+        UA_VariableAttributes attr = UA_VariableAttributes_default;
+        attr.displayName = UA_LOCALIZEDTEXT("en-US", name);
+        attr.description = UA_LOCALIZEDTEXT("en-US", method->description);
+        attr.dataType = UA_TYPES[(size_t) method->outArg[idx]->argType - 1].typeId;
+        attr.valueRank = (method->outArg[idx]->valType == ARRAY_1D) ? 1 : -1;
+        attr.accessLevel = UA_ACCESSLEVELMASK_READ;
+        UA_StatusCode status = UA_Server_addVariableNode(server, outputNodeId, *methodId,
+                UA_NODEID_NUMERIC(0, UA_NS0ID_HASPROPERTY),
+                UA_QUALIFIEDNAME(methodId->namespaceIndex, name),
+                UA_NODEID_NUMERIC(0, UA_NS0ID_PROPERTYTYPE), attr, NULL, NULL);
+        UA_NodeId_deleteMembers(&outputNodeId);
+        if (status != UA_STATUSCODE_GOOD)
+        {
+            EDGE_LOG(TAG, "+++ addMethodOutputNodes failed +++\n");
+        }
+    }
+}
+
+/* Output arguments of a method_view_func call */
+struct EdgeMethodOutputs
+{
+    const EdgeMethod *method;
+    size_t size;
+    UA_Variant *variants;
+};
+
+void *getOutputArgumentBuffer(EdgeMethodOutputs *outputs, size_t index)
+{
+    COND_CHECK((IS_NULL(outputs) || index >= outputs->size), NULL);
+    UA_Variant *variant = &outputs->variants[index];
+    if (IS_NOT_NULL(variant->type))
+    {
+        return variant->data;
+    }
+
+    const EdgeArgument *arg = outputs->method->outArg[index];
+    const UA_DataType *type = &UA_TYPES[(int) arg->argType - 1];
+    if (arg->valType == ARRAY_1D)
+    {
+        void *values = UA_Array_new(arg->arrayLength, type);
+        VERIFY_NON_NULL_MSG(values, "UA_Array_new FAILED in getOutputArgumentBuffer\n", NULL);
+        UA_Variant_setArray(variant, values, arg->arrayLength, type);
+    }
+    else
+    {
+        void *value = UA_new(type);
+        VERIFY_NON_NULL_MSG(value, "UA_new FAILED in getOutputArgumentBuffer\n", NULL);
+        UA_Variant_setScalar(variant, value, type);
+    }
+    return variant->data;
+}
+
+EdgeResult setOutputArgumentString(EdgeMethodOutputs *outputs, size_t index, size_t element,
+        const char *data, size_t length)
+{
+    EdgeResult result = { STATUS_PARAM_INVALID };
+    COND_CHECK((IS_NULL(outputs) || index >= outputs->size || (IS_NULL(data) && length > 0)), result);
+    const EdgeArgument *arg = outputs->method->outArg[index];
+    COND_CHECK((arg->argType != EDGE_NODEID_STRING), result);
+    COND_CHECK((element >= ((arg->valType == ARRAY_1D) ? arg->arrayLength : 1)), result);
+
+    result.code = STATUS_ERROR;
+    UA_String *values = (UA_String *) getOutputArgumentBuffer(outputs, index);
+    VERIFY_NON_NULL_MSG(values, "NULL output buffer in setOutputArgumentString\n", result);
+
+    UA_String view;
+    view.length = length;
+    view.data = (UA_Byte *) data;
+    UA_String_deleteMembers(&values[element]);
+    COND_CHECK((UA_String_copy(&view, &values[element]) != UA_STATUSCODE_GOOD), result);
+    result.code = STATUS_OK;
+    return result;
+}
+
+/**
+ * @brief callMethodView - Calls a method_view_func with views of the decoded input arguments
+ * @param node - Method node
+ * @param inputSize - Number of input arguments
+ * @param input - Input arguments
+ * @param outputSize - Number of output arguments
+ * @param output - Output arguments, written in place by the method
+ * @return GOOD status on success, otherwise an error status
+ */
+static UA_StatusCode callMethodView(const EdgeMethodNode *node, size_t inputSize,
+        const UA_Variant *input, size_t outputSize, UA_Variant *output)
+{
+    void *inp[MAX_ARGS];
+    COND_CHECK((inputSize > MAX_ARGS || outputSize > node->method->num_outArgs),
+            UA_STATUSCODE_BADINVALIDARGUMENT);
+    /* UA_String and Edge_String share their layout, so strings are passed as they are decoded */
+    for (size_t i = 0; i < inputSize; i++)
+    {
+        inp[i] = input[i].data;
+    }
+
+    EdgeMethodOutputs outputs;
+    outputs.method = node->method;
+    outputs.size = outputSize;
+    outputs.variants = output;
+    node->viewFn((int) inputSize, inp, (int) outputSize, &outputs);
+    return UA_STATUSCODE_GOOD;
+}
 
-    EdgeMethod *method = (EdgeMethod *) value;
+UA_StatusCode invokeMethod(const EdgeMethodNode *node, size_t inputSize, const UA_Variant *input,
+        size_t outputSize, UA_Variant *output)
+{
+    if (IS_NOT_NULL(node->viewFn))
+    {
+        return callMethodView(node, inputSize, input, outputSize, output);
+    }
+    const EdgeMethod *method = node->method;
     method_func method_to_call = (method_func) (method->method_fn);
 
     void **inp = NULL;
@@ -530,6 +1086,40 @@ static UA_StatusCode methodCallback(UA_Server *server, const UA_NodeId *sessionI
     return UA_STATUSCODE_GOOD;
 }
 
+static UA_StatusCode callMethod(UA_Server *server, const UA_NodeId *methodId,
+        void *methodContext, size_t inputSize, const UA_Variant *input, size_t outputSize,
+        UA_Variant *output)
+{
+    /* Method nodes carry their EdgeMethodNode as node context, the map covers nodes without one */
+    keyValue value = methodContext;
+    if (IS_NULL(value))
+    {
+        value = getEdgeHashMapElementByString(methodNodeMap,
+                (const char *) methodId->identifier.string.data, methodId->identifier.string.length);
+    }
+    VERIFY_NON_NULL_MSG(value, "", UA_STATUSCODE_BADMETHODINVALID);
+
+    EdgeMethodNode *node = (EdgeMethodNode *) value;
+    if (node->runAsync)
+    {
+        /* The server loop goes on, the outputs are written to the output nodes when complete */
+        return submitMethodCall(server, node, methodId, inputSize, input, outputSize);
+    }
+    return invokeMethod(node, inputSize, input, outputSize, output);
+}
+
+static UA_StatusCode methodCallback(UA_Server *server, const UA_NodeId *sessionId,
+        void *sessionContext, const UA_NodeId *methodId, void *methodContext,
+        const UA_NodeId *objectId, void *objectContext, size_t inputSize, const UA_Variant *input,
+        size_t outputSize, UA_Variant *output)
+{
+    uint64_t start = getServerServiceTime();
+    UA_StatusCode ret = callMethod(server, methodId, methodContext, inputSize, input, outputSize,
+            output);
+    recordServerService(server, EDGE_SERVER_SERVICE_CALL, start, ret);
+    return ret;
+}
+
 /****************************** Member functions ***********************************/
 
 EdgeResult addNodes(UA_Server *server, uint16_t nsIndex, const EdgeNodeItem *item)
@@ -574,13 +1164,20 @@ EdgeResult addNodes(UA_Server *server, uint16_t nsIndex, const EdgeNodeItem *ite
     return result;
 }
 
-EdgeResult addMethodNode(UA_Server *server, uint16_t nsIndex, const EdgeNodeItem *item, EdgeMethod *method)
+EdgeResult addMethodNode(UA_Server *server, uint16_t nsIndex, const EdgeNodeItem *item,
+        EdgeMethod *method, method_view_func viewFn, bool runAsync)
 {
     EdgeResult result;
     result.code = STATUS_ERROR;
 
     VERIFY_NON_NULL_MSG(server, "NULL server parameter in addMethodNode\n", result);
 
+    EdgeMethodNode *node = (EdgeMethodNode *) EdgeCalloc(1, sizeof(EdgeMethodNode));
+    VERIFY_NON_NULL_MSG(node, "EdgeCalloc FAILED for node in addMethodNode\n", result);
+    node->method = method;
+    node->viewFn = viewFn;
+    node->runAsync = runAsync;
+
     int num_inpArgs = method->num_inpArgs;
     int num_outArgs = method->num_outArgs;
     size_t idx = 0;
@@ -602,7 +1199,12 @@ EdgeResult addMethodNode(UA_Server *server, uint16_t nsIndex, const EdgeNodeItem
         {
             inputArguments[idx].valueRank = 1; /* Array with one dimensions */
             UA_UInt32 *inputDimensions = (UA_UInt32 *) EdgeMalloc(sizeof(UA_UInt32));
-            VERIFY_NON_NULL_MSG(inputDimensions, "EdgeMalloc FAILEd for inputDimensions in addMethodNode\n", result);
+            if (IS_NULL(inputDimensions))
+            {
+                EDGE_LOG(TAG, "EdgeMalloc FAILEd for inputDimensions in addMethodNode\n");
+                EdgeFree(node);
+                return result;
+            }
             inputDimensions[0] = method->inpArg[idx]->arrayLength;
             inputArguments[idx].arrayDimensionsSize = 1;
             inputArguments[idx].arrayDimensions = inputDimensions;
@@ -636,6 +1238,7 @@ EdgeResult addMethodNode(UA_Server *server, uint16_t nsIndex, const EdgeNodeItem
                         EdgeFree(inputArguments[idx].arrayDimensions);
                     }
                 }
+                EdgeFree(node);
                 result.code = STATUS_ERROR;
                 return result;
             }
@@ -670,23 +1273,36 @@ EdgeResult addMethodNode(UA_Server *server, uint16_t nsIndex, const EdgeNodeItem
     UA_StatusCode status = UA_Server_addMethodNode(server, UA_NODEID_STRING(nsIndex, item->browseName),
             sourceNodeId, UA_NODEID_NUMERIC(0, UA_NS0ID_HASCOMPONENT),
             UA_QUALIFIEDNAME(nsIndex, item->browseName), methodAttr, &methodCallback, num_inpArgs,
-            inputArguments, num_outArgs, outputArguments, NULL, NULL);
+            inputArguments, num_outArgs, outputArguments, node, NULL);
     if (status == UA_STATUSCODE_GOOD)
     {
         EDGE_LOG(TAG, "+++ addMethodNode success +++\n");
+        if (runAsync)
+        {
+            UA_NodeId methodId = UA_NODEID_STRING(nsIndex, item->browseName);
+            addMethodOutputNodes(server, &methodId, method);
+        }
         if (NULL == methodNodeMap)
-            methodNodeMap = createMap();
+            methodNodeMap = createEdgeHashMap(EDGE_HASH_STRING_KEY);
 
         char *browseName = (char *) EdgeMalloc(strlen(item->browseName) + 1);
         VERIFY_NON_NULL_MSG(browseName, "EdgeMalloc FAILED for browseName in addMethodNode\n", result);
         strncpy(browseName, item->browseName, strlen(item->browseName));
         browseName[strlen(item->browseName)] = '\0';
-        insertMapElement(methodNodeMap, (void *) browseName, method);
-        methodNodeCount += 1;
+        if (insertEdgeHashMapElement(methodNodeMap, (void *) browseName, node))
+        {
+            methodNodeCount += 1;
+        }
+        else
+        {
+            EDGE_LOG(TAG, "Error : Method node could not be registered\n");
+            EdgeFree(browseName);
+        }
     }
     else
     {
         EDGE_LOG(TAG, "+++ addMethodNode failed +++\n");
+        EdgeFree(node);
     }
 
     status = UA_Server_addReference(server, UA_NODEID_NUMERIC(0, UA_NS0ID_OBJECTSFOLDER),
@@ -742,55 +1358,190 @@ EdgeResult modifyNode(UA_Server *server, uint16_t nsIndex, const char *nodeUri,
 
     VERIFY_NON_NULL_MSG(server, "NULL server parameter in modifyNode\n", result);
 
-    // read the value;
     UA_NodeId node = UA_NODEID_STRING(nsIndex, (char*)nodeUri);
-    UA_Variant *readval = UA_Variant_new();
-    VERIFY_NON_NULL_MSG(readval, "NULL UA_Variant received in modifyNode\n", result);
+    UA_UInt16 typeIndex = 0;
+    bool isArray = false;
+    const UA_Nodestore *compareNodestore = NULL;
+    UA_StatusCode ret = UA_STATUSCODE_BADTYPEMISMATCH;
+    if (getVariableNodeType(server, nsIndex, nodeUri, &typeIndex, &isArray, &compareNodestore))
+    {
+        if (IS_NOT_NULL(compareNodestore)
+                && isNodeValueUnchanged(compareNodestore, &node, typeIndex, isArray, value))
+        {
+            recordServerUnchangedWrites(server, 1);
+            result.code = STATUS_OK;
+            return result;
+        }
+        ret = writeNodeValue(server, &node, typeIndex, isArray, value);
+    }
+
+    /* Nodes of unknown type, or replaced since they were cached, are read for their type */
+    if (ret == UA_STATUSCODE_BADTYPEMISMATCH)
+    {
+        UA_Variant readval;
+        UA_Variant_init(&readval);
+        ret = UA_Server_readValue(server, node, &readval);
+        if (ret != UA_STATUSCODE_GOOD || IS_NULL(readval.type))
+        {
+            EDGE_LOG(TAG, "error in read value during modify node \n");
+            UA_Variant_deleteMembers(&readval);
+            return result;
+        }
+        typeIndex = readval.type->typeIndex;
+        isArray = !UA_Variant_isScalar(&readval);
+        UA_Variant_deleteMembers(&readval);
+
+        storeVariableNodeType(server, nsIndex, nodeUri, typeIndex, isArray);
+        ret = writeNodeValue(server, &node, typeIndex, isArray, value);
+    }
 
-    UA_StatusCode ret = UA_Server_readValue(server, node, readval);
     if (ret != UA_STATUSCODE_GOOD)
     {
-        EDGE_LOG(TAG, "error in read value during modify node \n");
-        UA_Variant_delete(readval);
-        result.code = STATUS_ERROR;
+        EDGE_LOG_V(TAG, "Error in modifying node value:: 0x%08x\n", ret);
         return result;
     }
 
-    const UA_DataType *type = readval->type;
-    UA_Variant *myVariant = UA_Variant_new();
-    if (UA_Variant_isScalar(readval))
+    EDGE_LOG(TAG, "+++ write successful +++\n\n");
+    result.code = STATUS_OK;
+    return result;
+}
+
+EdgeVariableNode *getVariableNode(UA_Server *server, uint16_t nsIndex, const char *nodeUri)
+{
+    EdgeVariableNode *node = NULL;
+    pthread_mutex_lock(&serverNodesMutex);
+    ServerNodes *nodes = getServerNodes(server);
+    if (IS_NOT_NULL(nodes) && IS_NOT_NULL(nodes->variableNodes))
     {
-        ret = createScalarVariant(type->typeIndex, value->value, myVariant);
+        node = (EdgeVariableNode *) getEdgeHashMapElement(nodes->variableNodes, (keyValue) nodeUri);
+        if (IS_NOT_NULL(node) && node->nsIndex != nsIndex)
+        {
+            node = NULL;
+        }
     }
-    else
+    pthread_mutex_unlock(&serverNodesMutex);
+    return node;
+}
+
+void *getVariableNodeContext(const EdgeVariableNode *node)
+{
+    /* The owner is set once and lives as long as the node */
+    return node->owner->context;
+}
+
+UA_StatusCode copyVariableNodeValue(const EdgeVariableNode *node, const EdgeVersatility *value,
+        UA_Variant *out)
+{
+    pthread_mutex_lock(&serverNodesMutex);
+    UA_UInt16 typeIndex = node->typeIndex;
+    bool isArray = node->isArray;
+    pthread_mutex_unlock(&serverNodesMutex);
+
+    UA_Variant_init(out);
+    if (isArray)
     {
-        ret = createArrayVariant(type->typeIndex, value->value, value->arrayLength, myVariant);
+        return createArrayVariant(typeIndex, value->value, value->arrayLength, out);
     }
+    return createScalarVariant(typeIndex, value->value, out);
+}
 
+UA_StatusCode writeVariableNodeValue(UA_Server *server, const EdgeVariableNode *node,
+        const UA_Variant *value)
+{
+    UA_NodeId nodeId = UA_NODEID_STRING(node->nsIndex, (char *) node->browseName);
+    UA_StatusCode ret = UA_Server_writeValue(server, nodeId, *value);
     if (ret != UA_STATUSCODE_GOOD)
     {
-        EDGE_LOG(TAG, "error in set scalar copy during modify node \n");
-        result.code = STATUS_ERROR;
-        UA_Variant_delete(readval);
-        UA_Variant_delete(myVariant);
-        return result;
+        EDGE_LOG_V(TAG, "Error in applying update of [%s]:: 0x%08x\n", node->browseName, ret);
     }
+    return ret;
+}
+
+UA_StatusCode readVariableNodeValue(UA_Server *server, const EdgeVariableNode *node,
+        UA_Variant *out)
+{
+    UA_NodeId nodeId = UA_NODEID_STRING(node->nsIndex, (char *) node->browseName);
+    return UA_Server_readValue(server, nodeId, out);
+}
+
+EdgeResult registerServerNodes(UA_Server *server, void *context)
+{
+    EdgeResult result = { STATUS_PARAM_INVALID };
+    VERIFY_NON_NULL_MSG(server, "NULL server parameter in registerServerNodes\n", result);
+    result.code = STATUS_ERROR;
+    ServerNodes *nodes = (ServerNodes *) EdgeCalloc(1, sizeof(ServerNodes));
+    VERIFY_NON_NULL_MSG(nodes, "EdgeCalloc FAILED for the nodes of the server\n", result);
+    nodes->server = server;
+    nodes->context = context;
+
+    pthread_mutex_lock(&serverNodesMutex);
+    nodes->next = serverNodes;
+    serverNodes = nodes;
+    pthread_mutex_unlock(&serverNodesMutex);
+    result.code = STATUS_OK;
+    return result;
+}
 
-    UA_StatusCode retVal = UA_Server_writeValue(server, node, *myVariant);
-    if (retVal != UA_STATUSCODE_GOOD)
+void setServerNodesWriteOnChange(UA_Server *server, const UA_Nodestore *nodestore)
+{
+    pthread_mutex_lock(&serverNodesMutex);
+    ServerNodes *nodes = getServerNodes(server);
+    if (IS_NOT_NULL(nodes))
     {
-        EDGE_LOG_V(TAG, "Error in modifying node value:: 0x%08x\n", retVal);
-        result.code = STATUS_ERROR;
-        UA_Variant_delete(readval);
-        UA_Variant_delete(myVariant);
-        return result;
+        nodes->compareNodestore = nodestore;
     }
+    pthread_mutex_unlock(&serverNodesMutex);
+}
 
-    EDGE_LOG(TAG, "+++ write successful +++\n\n");
-    UA_Variant_delete(myVariant);
-    UA_Variant_delete(readval);
+void deleteServerNodes(UA_Server *server)
+{
+    pthread_mutex_lock(&serverNodesMutex);
+    ServerNodes **link = &serverNodes;
+    while (IS_NOT_NULL(*link) && (*link)->server != server)
+    {
+        link = &(*link)->next;
+    }
+    ServerNodes *nodes = *link;
+    if (IS_NOT_NULL(nodes))
+    {
+        *link = nodes->next;
+    }
+    pthread_mutex_unlock(&serverNodesMutex);
+    VERIFY_NON_NULL_NR_MSG(nodes, "");
 
+    if (IS_NOT_NULL(nodes->variableNodes))
+    {
+        size_t cursor = 0;
+        keyValue value = NULL;
+        while (getNextEdgeHashMapElement(nodes->variableNodes, &cursor, NULL, &value))
+        {
+            EdgeFree(value);
+        }
+        deleteEdgeHashMap(nodes->variableNodes);
+    }
+    while (IS_NOT_NULL(nodes->dataSourceNodes))
+    {
+        DataSourceNode *next = nodes->dataSourceNodes->next;
+        EdgeFree(nodes->dataSourceNodes);
+        nodes->dataSourceNodes = next;
+    }
+    EdgeFree(nodes);
+}
+
+EdgeResult modifyNodes(UA_Server *server, uint16_t nsIndex, const char **nodeUris,
+        EdgeVersatility **values, size_t count)
+{
+    EdgeResult result;
     result.code = STATUS_OK;
+    for (size_t i = 0; i < count; i++)
+    {
+        /* Every node is written, a failed one does not stop the others */
+        if (STATUS_OK != modifyNode(server, nsIndex, nodeUris[i], values[i]).code)
+        {
+            EDGE_LOG_V(TAG, "Failed to modify [%s]\n", nodeUris[i]);
+            result.code = STATUS_ERROR;
+        }
+    }
     return result;
 }
 /***********************************************************************************/
@@ -48,18 +48,73 @@ extern "C"
  */
 EdgeResult addNodes(UA_Server *server, uint16_t nsIndex, const EdgeNodeItem *item);
 
+/**
+ * @brief Method node registered in the server, it is the node context of the method node.
+ *        Options of the node are kept here, so that EdgeMethod keeps its layout.
+ */
+typedef struct EdgeMethodNode
+{
+    /**< Method of the application */
+    EdgeMethod *method;
+
+    /**< Method callback function without argument copies, used instead of method_fn unless NULL */
+    method_view_func viewFn;
+
+    /**< Runs the method on the method workers of the server instead of the server loop */
+    bool runAsync;
+} EdgeMethodNode;
+
 /**
  * @brief Create/add method node in server
  * @param[in]  server Server Handle
  * @param[in]  nsIndex Namespace Index
  * @param[in]  item Node item information
  * @param[in]  method Method and argument data information
+ * @param[in]  viewFn Method callback without argument copies, NULL to call method_fn
+ * @param[in]  runAsync Whether the method runs on the method workers
+ * @return @c EdgeResult code is 0 on success, otherwise an error value
+ * @retval #STATUS_OK Successful
+ * @retval #STATUS_PARAM_INVALID Invalid parameter
+ * @retval #STATUS_ERROR Operation failed
+ */
+EdgeResult addMethodNode(UA_Server *server, uint16_t nsIndex, const EdgeNodeItem *item,
+        EdgeMethod *method, method_view_func viewFn, bool runAsync);
+
+/**
+ * @brief Calls the method function of a method node with the decoded arguments
+ * @param[in]  node Method node
+ * @param[in]  inputSize Number of input arguments
+ * @param[in]  input Input arguments
+ * @param[in]  outputSize Number of output arguments
+ * @param[out] output Output arguments, initialized by the caller
+ * @return GOOD status on success, otherwise an error status
+ */
+UA_StatusCode invokeMethod(const EdgeMethodNode *node, size_t inputSize, const UA_Variant *input,
+        size_t outputSize, UA_Variant *output);
+
+/**
+ * @brief Gets the storage of an output argument of a method_view_func call,
+ *        it is allocated in the output variant on the first call
+ * @param[in]  outputs Output arguments of the call
+ * @param[in]  index Index of the output argument
+ * @return Storage of the argument, otherwise NULL
+ */
+void *getOutputArgumentBuffer(EdgeMethodOutputs *outputs, size_t index);
+
+/**
+ * @brief Copies a string into a string output argument of a method_view_func call
+ * @param[in]  outputs Output arguments of the call
+ * @param[in]  index Index of the output argument
+ * @param[in]  element Index of the array element, 0 for scalar arguments
+ * @param[in]  data String data
+ * @param[in]  length Length of the string data
  * @return @c EdgeResult code is 0 on success, otherwise an error value
  * @retval #STATUS_OK Successful
  * @retval #STATUS_PARAM_INVALID Invalid parameter
  * @retval #STATUS_ERROR Operation failed
  */
-EdgeResult addMethodNode(UA_Server *server, uint16_t nsIndex, const EdgeNodeItem *item, EdgeMethod *method);
+EdgeResult setOutputArgumentString(EdgeMethodOutputs *outputs, size_t index, size_t element,
+        const char *data, size_t length);
 
 /**
  * @brief Modify node in server
@@ -74,6 +129,95 @@ EdgeResult addMethodNode(UA_Server *server, uint16_t nsIndex, const EdgeNodeItem
  */
 EdgeResult modifyNode(UA_Server *server, uint16_t nsIndex, const char *nodeUri, EdgeVersatility *value);
 
+/**
+ * @brief Modify many nodes of a namespace in server. A node which fails does not stop the others.
+ * @param[in]  server Server Handle
+ * @param[in]  nsIndex Namespace Index
+ * @param[in]  nodeUris Node Uri of each node
+ * @param[in]  values New data of each node
+ * @param[in]  count Number of nodes
+ * @return @c EdgeResult code is 0 on success, otherwise an error value
+ * @retval #STATUS_OK Successful
+ * @retval #STATUS_ERROR Operation failed for at least one node
+ */
+EdgeResult modifyNodes(UA_Server *server, uint16_t nsIndex, const char **nodeUris,
+        EdgeVersatility **values, size_t count);
+
+/**
+ * @brief Registers a server before nodes are added to it, its nodes are kept apart
+ *        from those of the other servers of the process
+ * @param[in]  server Server Handle
+ * @param[in]  context Context of the server, see getVariableNodeContext()
+ * @return @c EdgeResult code is 0 on success, otherwise an error value
+ * @retval #STATUS_OK Successful
+ * @retval #STATUS_PARAM_INVALID Invalid parameter
+ * @retval #STATUS_ERROR Operation failed
+ */
+EdgeResult registerServerNodes(UA_Server *server, void *context);
+
+/**
+ * @brief Makes modifyNode() skip the write of a value which the node holds already.
+ *        Values of the plain built-in types and strings are compared in the nodestore,
+ *        without copying the value of the node; the others are always written.
+ * @param[in]  server Server Handle
+ * @param[in]  nodestore Nodestore of the server, NULL to write every value
+ */
+void setServerNodesWriteOnChange(UA_Server *server, const UA_Nodestore *nodestore);
+
+/**
+ * @brief Frees the variable node handles and the contexts of the data source nodes of a server,
+ *        after the server is deleted
+ * @param[in]  server Server Handle
+ */
+void deleteServerNodes(UA_Server *server);
+
+/**
+ * @brief Gets the handle of a variable node added with addNodes()
+ * @param[in]  server Server Handle
+ * @param[in]  nsIndex Namespace Index
+ * @param[in]  nodeUri Node Uri
+ * @return Handle of the node, valid until deleteServerNodes() is called, otherwise NULL
+ */
+EdgeVariableNode *getVariableNode(UA_Server *server, uint16_t nsIndex, const char *nodeUri);
+
+/**
+ * @brief Gets the context of the server of a variable node, passed to registerServerNodes()
+ * @param[in]  node Handle of the node
+ * @return Context of the server
+ */
+void *getVariableNodeContext(const EdgeVariableNode *node);
+
+/**
+ * @brief Copies a value into a variant of the type of a variable node, without the server.
+ *        It may be called from any thread.
+ * @param[in]  node Handle of the node
+ * @param[in]  value New data
+ * @param[out] out Variant which owns the copy, freed with UA_Variant_deleteMembers()
+ * @return GOOD status on success, otherwise an error status
+ */
+UA_StatusCode copyVariableNodeValue(const EdgeVariableNode *node, const EdgeVersatility *value,
+        UA_Variant *out);
+
+/**
+ * @brief Writes a value made by copyVariableNodeValue() to a variable node
+ * @param[in]  server Server Handle
+ * @param[in]  node Handle of the node
+ * @param[in]  value Value of the node
+ * @return GOOD status on success, otherwise an error status
+ */
+UA_StatusCode writeVariableNodeValue(UA_Server *server, const EdgeVariableNode *node,
+        const UA_Variant *value);
+
+/**
+ * @brief Reads the value of a variable node, in the server loop
+ * @param[in]  server Server Handle
+ * @param[in]  node Handle of the node
+ * @param[out] out Variant which owns a copy of the value, freed with UA_Variant_deleteMembers()
+ * @return GOOD status on success, otherwise an error status
+ */
+UA_StatusCode readVariableNodeValue(UA_Server *server, const EdgeVariableNode *node,
+        UA_Variant *out);
+
 /**
  * @brief Add node reference in server
  * @param[in]  server Server Handle
@@ -0,0 +1,422 @@
+/******************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ *
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************/
+
+#include "edge_nodeset.h"
+#include "edge_node.h"
+#include "edge_utils.h"
+#include "edge_logger.h"
+#include "edge_malloc.h"
+
+#include <stdio.h>
+#include <string.h>
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#define TAG "edge_nodeset"
+
+#define HEADER_SIZE (24)
+#define NODE_RECORD_SIZE (40)
+#define REFERENCE_RECORD_SIZE (12)
+
+/* Decoded header, the section pointers point into the nodeset */
+typedef struct NodesetLayout
+{
+    uint32_t nodeCount;
+    uint32_t referenceCount;
+    const uint8_t *nodes;
+    const uint8_t *references;
+    const uint8_t *values;
+    uint32_t valueSize;
+    const char *strings;
+    uint32_t stringSize;
+} NodesetLayout;
+
+/* Decoded node record */
+typedef struct NodeRecord
+{
+    double minimumSamplingInterval;
+    uint32_t browseName;
+    uint32_t displayName;
+    uint32_t parent;
+    uint32_t value;
+    uint32_t arrayLength;
+    uint16_t nodeType;
+    uint16_t valueType;
+    uint8_t accessLevel;
+    uint8_t userAccessLevel;
+} NodeRecord;
+
+static uint16_t readUInt16(const uint8_t *p)
+{
+    return (uint16_t) (p[0] | (p[1] << 8));
+}
+
+static uint32_t readUInt32(const uint8_t *p)
+{
+    return (uint32_t) p[0] | ((uint32_t) p[1] << 8) | ((uint32_t) p[2] << 16)
+            | ((uint32_t) p[3] << 24);
+}
+
+static double readDouble(const uint8_t *p)
+{
+    uint64_t bits = (uint64_t) readUInt32(p) | ((uint64_t) readUInt32(p + 4) << 32);
+    double value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+/**
+ * @brief isLittleEndian - Checks the byte order of the host
+ * @return true if values of the value section can be used in place, otherwise false
+ */
+static bool isLittleEndian()
+{
+    uint16_t probe = 1;
+    return *((uint8_t *) &probe) == 1;
+}
+
+static void readNodeRecord(const NodesetLayout *layout, uint32_t index, NodeRecord *record)
+{
+    const uint8_t *p = layout->nodes + (size_t) index * NODE_RECORD_SIZE;
+    record->minimumSamplingInterval = readDouble(p);
+    record->browseName = readUInt32(p + 8);
+    record->displayName = readUInt32(p + 12);
+    record->parent = readUInt32(p + 16);
+    record->value = readUInt32(p + 20);
+    record->arrayLength = readUInt32(p + 24);
+    record->nodeType = readUInt16(p + 28);
+    record->valueType = readUInt16(p + 30);
+    record->accessLevel = p[32];
+    record->userAccessLevel = p[33];
+}
+
+/**
+ * @brief getString - Gets a string of the string section
+ * @param layout - nodeset layout
+ * @param offset - string offset
+ * @return the string, NULL if the offset is EDGE_NODESET_NO_STRING or out of the section
+ */
+static char *getString(const NodesetLayout *layout, uint32_t offset)
+{
+    /* The section ends with NUL, so every offset inside it starts a terminated string */
+    COND_CHECK((offset >= layout->stringSize), NULL);
+    return (char *) (layout->strings + offset);
+}
+
+static bool isStringType(uint16_t valueType)
+{
+    int type = (int) valueType - 1;
+    return type == UA_TYPES_STRING || type == UA_TYPES_BYTESTRING;
+}
+
+static bool hasValue(uint16_t nodeType)
+{
+    return nodeType == VARIABLE_NODE || nodeType == ARRAY_NODE || nodeType == VARIABLE_TYPE_NODE;
+}
+
+/**
+ * @brief parseLayout - Decodes the header and checks the section sizes against the data
+ * @param data - binary nodeset
+ * @param size - size of the binary nodeset
+ * @param layout - receives the sections
+ * @return true if the header is valid, otherwise false
+ */
+static bool parseLayout(const uint8_t *data, size_t size, NodesetLayout *layout)
+{
+    COND_CHECK_MSG((size < HEADER_SIZE), "Nodeset is smaller than its header\n", false);
+    COND_CHECK_MSG((memcmp(data, EDGE_NODESET_MAGIC, 4) != 0), "Not a binary nodeset\n", false);
+    COND_CHECK_MSG((readUInt16(data + 4) != EDGE_NODESET_VERSION),
+            "Unsupported nodeset version\n", false);
+
+    layout->nodeCount = readUInt32(data + 8);
+    layout->referenceCount = readUInt32(data + 12);
+    layout->valueSize = readUInt32(data + 16);
+    layout->stringSize = readUInt32(data + 20);
+
+    /* 64 bit sums, so that the counts of a corrupt header cannot wrap around */
+    uint64_t nodesEnd = HEADER_SIZE + (uint64_t) layout->nodeCount * NODE_RECORD_SIZE;
+    uint64_t referencesEnd = nodesEnd
+            + (uint64_t) layout->referenceCount * REFERENCE_RECORD_SIZE;
+    uint64_t valuesEnd = referencesEnd + layout->valueSize;
+    COND_CHECK_MSG((valuesEnd + layout->stringSize != (uint64_t) size),
+            "Nodeset size does not match its header\n", false);
+    COND_CHECK_MSG((layout->stringSize > 0 && data[size - 1] != '\0'),
+            "String section is not terminated\n", false);
+
+    layout->nodes = data + HEADER_SIZE;
+    layout->references = data + nodesEnd;
+    layout->values = data + referencesEnd;
+    layout->strings = (const char *) (data + valuesEnd);
+    return true;
+}
+
+/**
+ * @brief checkValue - Checks that the value of a variable node lies inside the nodeset
+ * @param layout - nodeset layout
+ * @param record - node record
+ * @return true if the value is valid, otherwise false
+ */
+static bool checkValue(const NodesetLayout *layout, const NodeRecord *record)
+{
+    COND_CHECK_MSG((record->valueType < 1 || record->valueType > UA_TYPES_COUNT),
+            "Unknown value type in the nodeset\n", false);
+    const UA_DataType *type = &UA_TYPES[record->valueType - 1];
+    bool isString = isStringType(record->valueType);
+    COND_CHECK_MSG((!isString && !type->pointerFree), "Unsupported value type in the nodeset\n",
+            false);
+
+    uint64_t count = (record->nodeType == VARIABLE_NODE) ? 1 : record->arrayLength;
+    COND_CHECK_MSG((count == 0), "Empty array in the nodeset\n", false);
+
+    if (isString && record->nodeType == VARIABLE_NODE)
+    {
+        VERIFY_NON_NULL_MSG(getString(layout, record->value), "Invalid string value\n", false);
+        return true;
+    }
+
+    uint64_t elementSize = isString ? sizeof(uint32_t) : type->memSize;
+    COND_CHECK_MSG(((uint64_t) record->value + count * elementSize > layout->valueSize),
+            "Value out of the value section\n", false);
+    if (isString)
+    {
+        const uint8_t *offsets = layout->values + record->value;
+        for (uint64_t i = 0; i < count; i++)
+        {
+            VERIFY_NON_NULL_MSG(getString(layout, readUInt32(offsets + i * sizeof(uint32_t))),
+                    "Invalid string array value\n", false);
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief checkNodeset - Checks every record, so that an invalid nodeset adds nothing
+ * @param layout - nodeset layout
+ * @return true if the nodeset is valid, otherwise false
+ */
+static bool checkNodeset(const NodesetLayout *layout)
+{
+    for (uint32_t i = 0; i < layout->nodeCount; i++)
+    {
+        NodeRecord record;
+        readNodeRecord(layout, i, &record);
+        COND_CHECK_MSG((record.nodeType < VARIABLE_NODE || record.nodeType > VIEW_NODE),
+                "Unsupported node type in the nodeset\n", false);
+        VERIFY_NON_NULL_MSG(getString(layout, record.browseName), "Invalid browse name\n", false);
+        COND_CHECK_MSG((record.displayName != EDGE_NODESET_NO_STRING
+                && IS_NULL(getString(layout, record.displayName))), "Invalid display name\n", false);
+        COND_CHECK_MSG((record.parent != EDGE_NODESET_NO_STRING
+                && IS_NULL(getString(layout, record.parent))), "Invalid parent node\n", false);
+        if (hasValue(record.nodeType) && !checkValue(layout, &record))
+        {
+            return false;
+        }
+    }
+
+    for (uint32_t i = 0; i < layout->referenceCount; i++)
+    {
+        const uint8_t *p = layout->references + (size_t) i * REFERENCE_RECORD_SIZE;
+        VERIFY_NON_NULL_MSG(getString(layout, readUInt32(p)), "Invalid reference source\n", false);
+        VERIFY_NON_NULL_MSG(getString(layout, readUInt32(p + 4)), "Invalid reference target\n",
+                false);
+    }
+    return true;
+}
+
+/**
+ * @brief addNodesetNode - Adds the node of a record, its strings and values are used in place
+ * @param server - server handle
+ * @param nsIndex - namespace index of the node
+ * @param layout - nodeset layout
+ * @param record - checked node record
+ * @return true if the node was handed to addNodes(), otherwise false
+ */
+static bool addNodesetNode(UA_Server *server, uint16_t nsIndex, const NodesetLayout *layout,
+        const NodeRecord *record)
+{
+    EdgeNodeId parent;
+    memset(&parent, 0, sizeof(parent));
+    parent.nameSpace = nsIndex;
+    parent.nodeId = (record->parent == EDGE_NODESET_NO_STRING) ? NULL :
+            getString(layout, record->parent);
+
+    EdgeNodeItem item;
+    memset(&item, 0, sizeof(item));
+    item.browseName = getString(layout, record->browseName);
+    item.displayName = (record->displayName == EDGE_NODESET_NO_STRING) ? NULL :
+            getString(layout, record->displayName);
+    item.nodeType = (EdgeIdentifier) record->nodeType;
+    item.accessLevel = record->accessLevel;
+    item.userAccessLevel = record->userAccessLevel;
+    item.variableIdentifier = record->valueType;
+    item.arrayLength = record->arrayLength;
+    item.minimumSamplingInterval = record->minimumSamplingInterval;
+    item.sourceNodeId = &parent;
+
+    char **strings = NULL;
+    if (hasValue(record->nodeType))
+    {
+        if (!isStringType(record->valueType))
+        {
+            item.variableData = (void *) (layout->values + record->value);
+        }
+        else if (record->nodeType == VARIABLE_NODE)
+        {
+            item.variableData = getString(layout, record->value);
+        }
+        else
+        {
+            /* createArrayVariant() takes an array of C strings */
+            const uint8_t *offsets = layout->values + record->value;
+            strings = (char **) EdgeMalloc(sizeof(char *) * record->arrayLength);
+            VERIFY_NON_NULL_MSG(strings, "EdgeMalloc failed for a string array\n", false);
+            for (uint32_t i = 0; i < record->arrayLength; i++)
+            {
+                strings[i] = getString(layout, readUInt32(offsets + i * sizeof(uint32_t)));
+            }
+            item.variableData = strings;
+        }
+    }
+
+    EdgeResult result = addNodes(server, nsIndex, &item);
+    EdgeFree(strings);
+    return result.code == STATUS_OK;
+}
+
+EdgeResult loadNodesetBuffer(UA_Server *server, uint16_t nsIndex, const void *data, size_t size)
+{
+    EdgeResult result = { STATUS_PARAM_INVALID };
+    VERIFY_NON_NULL_MSG(server, "NULL server parameter in loadNodesetBuffer\n", result);
+    VERIFY_NON_NULL_MSG(data, "NULL data parameter in loadNodesetBuffer\n", result);
+
+    NodesetLayout layout;
+    COND_CHECK((!parseLayout((const uint8_t *) data, size, &layout)), result);
+    COND_CHECK((!checkNodeset(&layout)), result);
+
+    result.code = STATUS_ERROR;
+    COND_CHECK_MSG((layout.valueSize > 0 && !isLittleEndian()),
+            "Nodeset values need a little-endian host\n", result);
+
+    result.code = STATUS_OK;
+    for (uint32_t i = 0; i < layout.nodeCount; i++)
+    {
+        NodeRecord record;
+        readNodeRecord(&layout, i, &record);
+        if (!addNodesetNode(server, nsIndex, &layout, &record))
+        {
+            result.code = STATUS_ERROR;
+        }
+    }
+
+    /* References go last, so that they can link any two nodes of the nodeset */
+    for (uint32_t i = 0; i < layout.referenceCount; i++)
+    {
+        const uint8_t *p = layout.references + (size_t) i * REFERENCE_RECORD_SIZE;
+        EdgeReference reference;
+        memset(&reference, 0, sizeof(reference));
+        reference.sourcePath = getString(&layout, readUInt32(p));
+        reference.targetPath = getString(&layout, readUInt32(p + 4));
+        reference.referenceId = readUInt16(p + 8);
+        reference.forward = p[10] != 0;
+        EdgeResult refResult = addReferences(server, &reference, nsIndex, nsIndex);
+        if (STATUS_OK != refResult.code)
+        {
+            result = refResult;
+        }
+    }
+    EDGE_LOG_V(TAG, "Nodeset of %u nodes and %u references loaded\n", layout.nodeCount,
+            layout.referenceCount);
+    return result;
+}
+
+#ifndef _WIN32
+EdgeResult loadNodesetFile(UA_Server *server, uint16_t nsIndex, const char *path)
+{
+    EdgeResult result = { STATUS_PARAM_INVALID };
+    VERIFY_NON_NULL_MSG(server, "NULL server parameter in loadNodesetFile\n", result);
+    VERIFY_NON_NULL_MSG(path, "NULL path parameter in loadNodesetFile\n", result);
+
+    result.code = STATUS_ERROR;
+    int fd = open(path, O_RDONLY);
+    COND_CHECK_MSG((fd < 0), "Nodeset file cannot be opened\n", result);
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size < HEADER_SIZE)
+    {
+        EDGE_LOG(TAG, "Nodeset file is too small\n");
+        close(fd);
+        result.code = STATUS_PARAM_INVALID;
+        return result;
+    }
+
+    /* The records are used in place, only the pages the loader touches are read */
+    size_t size = (size_t) st.st_size;
+    void *data = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    COND_CHECK_MSG((data == MAP_FAILED), "Nodeset file cannot be mapped\n", result);
+
+    result = loadNodesetBuffer(server, nsIndex, data, size);
+    munmap(data, size);
+    return result;
+}
+#else
+EdgeResult loadNodesetFile(UA_Server *server, uint16_t nsIndex, const char *path)
+{
+    EdgeResult result = { STATUS_PARAM_INVALID };
+    VERIFY_NON_NULL_MSG(server, "NULL server parameter in loadNodesetFile\n", result);
+    VERIFY_NON_NULL_MSG(path, "NULL path parameter in loadNodesetFile\n", result);
+
+    result.code = STATUS_ERROR;
+    FILE *fp = fopen(path, "rb");
+    COND_CHECK_MSG((IS_NULL(fp)), "Nodeset file cannot be opened\n", result);
+
+    /* One read into one buffer, the records are used in place from there */
+    long size = -1;
+    if (fseek(fp, 0, SEEK_END) == 0)
+    {
+        size = ftell(fp);
+    }
+    if (size < HEADER_SIZE || fseek(fp, 0, SEEK_SET) != 0)
+    {
+        EDGE_LOG(TAG, "Nodeset file is too small\n");
+        fclose(fp);
+        result.code = STATUS_PARAM_INVALID;
+        return result;
+    }
+
+    void *data = EdgeMalloc((size_t) size);
+    if (IS_NULL(data) || fread(data, 1, (size_t) size, fp) != (size_t) size)
+    {
+        EDGE_LOG(TAG, "Nodeset file cannot be read\n");
+        EdgeFree(data);
+        fclose(fp);
+        return result;
+    }
+    fclose(fp);
+
+    result = loadNodesetBuffer(server, nsIndex, data, (size_t) size);
+    EdgeFree(data);
+    return result;
+}
+#endif
@@ -0,0 +1,103 @@
+/******************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ *
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************/
+
+/**
+ * @file edge_nodeset.h
+ *
+ * @brief This file contains the loader of precompiled binary nodesets.
+ *
+ * A binary nodeset holds the nodes and references of one namespace in a form which is used
+ * in place, so that the nodes are added without parsing or allocating node items.
+ * tools/nodeset2bin.py generates it from a NodeSet2 XML file. All integers are little-endian.
+ *
+ * | Section    | Size                 | Contents                                         |
+ * |------------|----------------------|--------------------------------------------------|
+ * | header     | 24                   | "EDNS", uint16 version, uint16 0, uint32 node    |
+ * |            |                      | count, reference count, value and string size    |
+ * | nodes      | 40 * node count      | node records                                     |
+ * | references | 12 * reference count | reference records                                |
+ * | values     | value size           | values of the variable nodes, in memory layout   |
+ * | strings    | string size          | NUL-terminated strings, the last byte is NUL     |
+ *
+ * Node record: double minimum sampling interval, uint32 browse name, display name and
+ * parent strings, uint32 value, uint32 array length, uint16 EdgeIdentifier node type,
+ * uint16 EdgeNodeIdentifier value type, uint8 access level, uint8 user access level and
+ * 6 reserved bytes. Strings are offsets in the string section, EDGE_NODESET_NO_STRING if
+ * there is none. The value is an offset in the value section, except for String and
+ * ByteString values: it is the string offset of a scalar, or the value offset of the
+ * uint32 string offsets of an array.
+ *
+ * Reference record: uint32 source and target strings, uint16 numeric reference type of
+ * namespace 0 (0 for Organizes), uint8 forward and 1 reserved byte.
+ */
+
+#ifndef EDGE_NODESET_H
+#define EDGE_NODESET_H
+
+#include "opcua_common.h"
+
+#include <open62541.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/** Magic bytes at the start of a binary nodeset */
+#define EDGE_NODESET_MAGIC "EDNS"
+
+/** Version of the binary nodeset format */
+#define EDGE_NODESET_VERSION (1)
+
+/** String offset of an absent string */
+#define EDGE_NODESET_NO_STRING (0xFFFFFFFFu)
+
+/**
+ * @brief Add the nodes and then the references of a binary nodeset in memory.
+ * The whole nodeset is validated before the first node is added, so an invalid nodeset
+ * adds nothing.
+ * @param[in]  server Server Handle
+ * @param[in]  nsIndex Namespace Index of the nodes
+ * @param[in]  data Binary nodeset, it need not stay valid after the call
+ * @param[in]  size Size of the binary nodeset
+ * @return @c EdgeResult code is 0 on success, otherwise an error value
+ * @retval #STATUS_OK Successful
+ * @retval #STATUS_PARAM_INVALID Invalid parameter or malformed nodeset
+ * @retval #STATUS_ERROR Operation failed
+ */
+EdgeResult loadNodesetBuffer(UA_Server *server, uint16_t nsIndex, const void *data, size_t size);
+
+/**
+ * @brief Map a binary nodeset file and add its nodes and references, see loadNodesetBuffer()
+ * @param[in]  server Server Handle
+ * @param[in]  nsIndex Namespace Index of the nodes
+ * @param[in]  path Path of the binary nodeset file
+ * @return @c EdgeResult code is 0 on success, otherwise an error value
+ * @retval #STATUS_OK Successful
+ * @retval #STATUS_PARAM_INVALID Invalid parameter or malformed nodeset
+ * @retval #STATUS_ERROR Operation failed
+ */
+EdgeResult loadNodesetFile(UA_Server *server, uint16_t nsIndex, const char *path);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* EDGE_NODESET_H */
@@ -0,0 +1,586 @@
+/******************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ *
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "edge_malloc.h"
+#include "edge_logger.h"
+
+#include "caqueueinglanes.h"
+
+#define TAG "OIC_CA_QLANES"
+
+#define DEFAULT_LANE_KEY ""
+
+#if defined(_MSC_VER)
+#define LANES_THREAD_LOCAL __declspec(thread)
+#else
+#define LANES_THREAD_LOCAL __thread
+#endif
+
+/* Lanes served by the calling worker thread, NULL on other threads. */
+static LANES_THREAD_LOCAL CAQueueingLanes_t *g_workerLanes = NULL;
+/* Set when the calling worker stopped its own lanes from inside a task. */
+static LANES_THREAD_LOCAL bool g_workerDetached = false;
+/* Lane whose data the calling worker is processing, NULL between tasks. */
+static LANES_THREAD_LOCAL CAQueueingLane_t *g_workerLane = NULL;
+
+static void CAQueueingLanesDestroyMessage(CAQueueingLanes_t *lanes, u_queue_message_t *message)
+{
+    if (NULL != lanes->destroy)
+    {
+        lanes->destroy(message->msg, message->size);
+    }
+    else
+    {
+        EdgeFree(message->msg);
+    }
+
+    EdgeFree(message);
+}
+
+typedef struct
+{
+    CADataMatchFunction match;
+    u_queue_message_t *data;
+} CAQueueingLanesMatchContext_t;
+
+static bool CAQueueingLanesMatch(const u_queue_message_t *queued, void *ctx)
+{
+    CAQueueingLanesMatchContext_t *context = (CAQueueingLanesMatchContext_t *) ctx;
+    return context->match(queued->msg, queued->size, context->data->msg, context->data->size);
+}
+
+/* Called with lanesMutex held. Returns CA_STATUS_OK when message can be queued,
+ * message is set to NULL when it has been merged into a queued one. */
+static CAResult_t CAQueueingLanesMakeRoom(CAQueueingLanes_t *lanes, CAQueueingLane_t *lane,
+                                          u_queue_message_t **message)
+{
+    CAQueueingLanesMatchContext_t context = { lanes->overflowMatch, *message };
+    u_queue_match_cb match = lanes->overflowMatch ? CAQueueingLanesMatch : NULL;
+
+    while (0 != lanes->capacity && lanes->pendingCount >= lanes->capacity)
+    {
+        switch (lanes->overflowPolicy)
+        {
+            case CA_QUEUEING_OVERFLOW_BLOCK:
+                if (g_workerLanes == lanes)
+                {
+                    // a worker can not wait for the workers
+                    EDGE_LOG(TAG, "lanes are full, added from a worker..");
+                    return CA_STATUS_OK;
+                }
+                if (lanes->isStop)
+                {
+                    EDGE_LOG(TAG, "lanes are full and stopped..");
+                    return CA_STATUS_FAILED;
+                }
+                oc_cond_wait(lanes->spaceCond, lanes->lanesMutex);
+                break;
+            case CA_QUEUEING_OVERFLOW_DROP_OLDEST:
+            {
+                u_queue_message_t *old = u_priority_queue_remove_match(lane->dataQueue,
+                                                                       match, &context);
+                if (NULL == old)
+                {
+                    EDGE_LOG(TAG, "lanes are full, nothing can be dropped..");
+                    return CA_STATUS_FAILED;
+                }
+                EDGE_LOG(TAG, "lanes are full, oldest data dropped..");
+                lanes->pendingCount--;
+                lanes->stats.dropCount++;
+                CAQueueingLanesDestroyMessage(lanes, old);
+                break;
+            }
+            case CA_QUEUEING_OVERFLOW_CONFLATE:
+            {
+                u_queue_message_t *old = u_priority_queue_find_element(lane->dataQueue,
+                                                                       match, &context);
+                if (NULL == old)
+                {
+                    EDGE_LOG(TAG, "lanes are full, nothing can be conflated..");
+                    return CA_STATUS_FAILED;
+                }
+                // swap the data in place so the queued position is kept
+                void *oldData = old->msg;
+                uint32_t oldSize = old->size;
+                old->msg = (*message)->msg;
+                old->size = (*message)->size;
+                (*message)->msg = oldData;
+                (*message)->size = oldSize;
+                CAQueueingLanesDestroyMessage(lanes, *message);
+                *message = NULL;
+                CAQueueingStatsEnqueued(&lanes->stats, lanes->pendingCount);
+                lanes->stats.dropCount++;
+                return CA_STATUS_OK;
+            }
+            default:
+                EDGE_LOG(TAG, "lanes are full, data rejected..");
+                return CA_STATUS_FAILED;
+        }
+    }
+    return CA_STATUS_OK;
+}
+
+static void CAQueueingLanesPushReady(CAQueueingLanes_t *lanes, CAQueueingLane_t *lane)
+{
+    lane->nextReady = NULL;
+    if (NULL == lanes->readyTail)
+    {
+        lanes->readyHead = lane;
+    }
+    else
+    {
+        lanes->readyTail->nextReady = lane;
+    }
+    lanes->readyTail = lane;
+}
+
+static CAQueueingLane_t *CAQueueingLanesPopReady(CAQueueingLanes_t *lanes)
+{
+    CAQueueingLane_t *lane = lanes->readyHead;
+    if (NULL != lane)
+    {
+        lanes->readyHead = lane->nextReady;
+        if (NULL == lanes->readyHead)
+        {
+            lanes->readyTail = NULL;
+        }
+        lane->nextReady = NULL;
+    }
+    return lane;
+}
+
+static CAQueueingLane_t *CAQueueingLanesGetLane(CAQueueingLanes_t *lanes, const char *key)
+{
+    uint32_t len = u_arraylist_length(lanes->lanes);
+    for (uint32_t i = 0; i < len; i++)
+    {
+        CAQueueingLane_t *lane = (CAQueueingLane_t *) u_arraylist_get(lanes->lanes, i);
+        if (lane && 0 == strcmp(lane->key, key))
+        {
+            return lane;
+        }
+    }
+
+    CAQueueingLane_t *lane = (CAQueueingLane_t *) EdgeCalloc(1, sizeof(CAQueueingLane_t));
+    if (NULL == lane)
+    {
+        return NULL;
+    }
+
+    size_t keyLen = strlen(key);
+    lane->key = (char *) EdgeMalloc(keyLen + 1);
+    lane->dataQueue = u_priority_queue_create();
+    if (NULL == lane->key || NULL == lane->dataQueue
+        || !u_arraylist_add(lanes->lanes, (void *) lane))
+    {
+        EdgeFree(lane->key);
+        if (lane->dataQueue)
+        {
+            u_priority_queue_delete(lane->dataQueue);
+        }
+        EdgeFree(lane);
+        return NULL;
+    }
+    memcpy(lane->key, key, keyLen + 1);
+
+    EDGE_LOG_V(TAG, "lane created for key [%s]", lane->key);
+    return lane;
+}
+
+static void CAQueueingLanesWorker(void *threadValue)
+{
+    CAQueueingLanes_t *lanes = (CAQueueingLanes_t *) threadValue;
+    g_workerLanes = lanes;
+    g_workerDetached = false;
+
+    EDGE_LOG(TAG, "lane worker start..");
+
+    oc_mutex_lock(lanes->lanesMutex);
+    while (!lanes->isStop)
+    {
+        CAQueueingLane_t *lane = CAQueueingLanesPopReady(lanes);
+        if (NULL == lane)
+        {
+            oc_cond_wait(lanes->lanesCond, lanes->lanesMutex);
+            continue;
+        }
+
+        // lane stays scheduled while its data is processed, so order is kept
+        u_queue_message_t *message = u_priority_queue_get_element(lane->dataQueue);
+        if (NULL != message)
+        {
+            lanes->pendingCount--;
+            CAQueueingStatsDequeued(&lanes->stats, message, oc_get_time_us());
+            if (0 != lanes->capacity)
+            {
+                oc_cond_broadcast(lanes->spaceCond);
+            }
+        }
+        g_workerLane = lane;
+        oc_mutex_unlock(lanes->lanesMutex);
+
+        if (NULL != message)
+        {
+            lanes->threadTask(message->msg);
+            if (g_workerDetached)
+            {
+                // lanes were stopped and may be destroyed by the task itself,
+                // the lane was already handed back by CAQueueingLanesStop()
+                CAQueueingLanesDestroyMessage(lanes, message);
+                g_workerLane = NULL;
+                g_workerLanes = NULL;
+                EDGE_LOG(TAG, "lane worker end..");
+                return;
+            }
+            CAQueueingLanesDestroyMessage(lanes, message);
+        }
+
+        oc_mutex_lock(lanes->lanesMutex);
+        g_workerLane = NULL;
+        if (u_priority_queue_get_size(lane->dataQueue) > 0)
+        {
+            CAQueueingLanesPushReady(lanes, lane);
+        }
+        else
+        {
+            lane->isScheduled = false;
+        }
+    }
+
+    lanes->activeWorkers--;
+    oc_cond_broadcast(lanes->lanesCond);
+    oc_mutex_unlock(lanes->lanesMutex);
+
+    g_workerLanes = NULL;
+    EDGE_LOG(TAG, "lane worker end..");
+}
+
+CAResult_t CAQueueingLanesInitialize(CAQueueingLanes_t *lanes, ca_thread_pool_t handle,
+                                     uint32_t workerCount, CAThreadTask task,
+                                     CADataDestroyFunction destroy)
+{
+    if (NULL == lanes || NULL == handle || NULL == task || 0 == workerCount)
+    {
+        EDGE_LOG(TAG, "invalid parameter..");
+        return CA_STATUS_INVALID_PARAM;
+    }
+
+    lanes->threadPool = handle;
+    lanes->threadTask = task;
+    lanes->destroy = destroy;
+    lanes->isStop = true;
+    lanes->workerCount = workerCount;
+    lanes->activeWorkers = 0;
+    lanes->readyHead = NULL;
+    lanes->readyTail = NULL;
+    lanes->pendingCount = 0;
+    lanes->capacity = 0;
+    lanes->overflowPolicy = CA_QUEUEING_OVERFLOW_BLOCK;
+    lanes->overflowMatch = NULL;
+    memset(&lanes->stats, 0, sizeof(CAQueueingStats_t));
+    lanes->lanesMutex = oc_mutex_new();
+    lanes->lanesCond = oc_cond_new();
+    lanes->spaceCond = oc_cond_new();
+    lanes->lanes = u_arraylist_create();
+    if (NULL == lanes->lanesMutex || NULL == lanes->lanesCond || NULL == lanes->spaceCond
+        || NULL == lanes->lanes)
+    {
+        if (lanes->lanesMutex)
+        {
+            oc_mutex_free(lanes->lanesMutex);
+            lanes->lanesMutex = NULL;
+        }
+        if (lanes->lanesCond)
+        {
+            oc_cond_free(lanes->lanesCond);
+            lanes->lanesCond = NULL;
+        }
+        if (lanes->spaceCond)
+        {
+            oc_cond_free(lanes->spaceCond);
+            lanes->spaceCond = NULL;
+        }
+        u_arraylist_free(&lanes->lanes);
+        return CA_MEMORY_ALLOC_FAILED;
+    }
+
+    return CA_STATUS_OK;
+}
+
+CAResult_t CAQueueingLanesSetBounds(CAQueueingLanes_t *lanes, uint32_t capacity,
+                                    CAQueueingOverflowPolicy_t policy,
+                                    CADataMatchFunction match)
+{
+    if (NULL == lanes || NULL == lanes->lanesMutex)
+    {
+        EDGE_LOG(TAG, "lanes instance is empty..");
+        return CA_STATUS_INVALID_PARAM;
+    }
+
+    if (CA_QUEUEING_OVERFLOW_CONFLATE == policy && NULL == match)
+    {
+        EDGE_LOG(TAG, "conflate policy needs a match function..");
+        return CA_STATUS_INVALID_PARAM;
+    }
+
+    oc_mutex_lock(lanes->lanesMutex);
+    lanes->capacity = capacity;
+    lanes->overflowPolicy = policy;
+    lanes->overflowMatch = match;
+    // let blocked producers re-check the new bounds
+    oc_cond_broadcast(lanes->spaceCond);
+    oc_mutex_unlock(lanes->lanesMutex);
+
+    return CA_STATUS_OK;
+}
+
+CAResult_t CAQueueingLanesStart(CAQueueingLanes_t *lanes)
+{
+    if (NULL == lanes || NULL == lanes->lanesMutex)
+    {
+        EDGE_LOG(TAG, "lanes instance is empty..");
+        return CA_STATUS_INVALID_PARAM;
+    }
+
+    oc_mutex_lock(lanes->lanesMutex);
+    if (!lanes->isStop)
+    {
+        oc_mutex_unlock(lanes->lanesMutex);
+        EDGE_LOG(TAG, "lanes already running..");
+        return CA_STATUS_OK;
+    }
+    lanes->isStop = false;
+
+    CAResult_t res = CA_STATUS_OK;
+    for (uint32_t i = 0; i < lanes->workerCount; i++)
+    {
+        lanes->activeWorkers++;
+        res = ca_thread_pool_add_task(lanes->threadPool, CAQueueingLanesWorker, lanes, NULL);
+        if (CA_STATUS_OK != res)
+        {
+            lanes->activeWorkers--;
+            EDGE_LOG(TAG, "thread pool add task error(lane worker).");
+            break;
+        }
+    }
+    oc_mutex_unlock(lanes->lanesMutex);
+
+    if (CA_STATUS_OK != res)
+    {
+        CAQueueingLanesStop(lanes);
+    }
+    return res;
+}
+
+CAResult_t CAQueueingLanesAddData(CAQueueingLanes_t *lanes, const char *key, void *data,
+                                  uint32_t size)
+{
+    return CAQueueingLanesAddDataWithPriority(lanes, key, data, size, U_PRIORITY_QUEUE_LOWEST);
+}
+
+CAResult_t CAQueueingLanesAddDataWithPriority(CAQueueingLanes_t *lanes, const char *key,
+                                              void *data, uint32_t size, uint32_t priority)
+{
+    if (NULL == lanes || NULL == lanes->lanesMutex)
+    {
+        EDGE_LOG(TAG, "lanes instance is empty..");
+        return CA_STATUS_INVALID_PARAM;
+    }
+
+    if (NULL == data || 0 == size)
+    {
+        EDGE_LOG(TAG, "data is empty..");
+        return CA_STATUS_INVALID_PARAM;
+    }
+
+    u_queue_message_t *message = (u_queue_message_t *) EdgeMalloc(sizeof(u_queue_message_t));
+    if (NULL == message)
+    {
+        EDGE_LOG(TAG, "memory error!!");
+        return CA_MEMORY_ALLOC_FAILED;
+    }
+    message->msg = data;
+    message->size = size;
+    message->enqueueTime = oc_get_time_us();
+
+    oc_mutex_lock(lanes->lanesMutex);
+    CAQueueingLane_t *lane = CAQueueingLanesGetLane(lanes, key ? key : DEFAULT_LANE_KEY);
+    if (NULL == lane || CA_STATUS_OK != CAQueueingLanesMakeRoom(lanes, lane, &message))
+    {
+        lanes->stats.dropCount++;
+        oc_mutex_unlock(lanes->lanesMutex);
+        EDGE_LOG(TAG, "failed to add data to lane");
+        EdgeFree(message);
+        return CA_STATUS_FAILED;
+    }
+
+    if (NULL == message)
+    {
+        // merged into a queued data, lane is already scheduled
+        oc_mutex_unlock(lanes->lanesMutex);
+        return CA_STATUS_OK;
+    }
+
+    if (CA_STATUS_OK != u_priority_queue_add_element(lane->dataQueue, message, priority))
+    {
+        lanes->stats.dropCount++;
+        oc_mutex_unlock(lanes->lanesMutex);
+        EDGE_LOG(TAG, "failed to add data to lane");
+        EdgeFree(message);
+        return CA_STATUS_FAILED;
+    }
+    lanes->pendingCount++;
+    CAQueueingStatsEnqueued(&lanes->stats, lanes->pendingCount);
+
+    if (!lane->isScheduled)
+    {
+        lane->isScheduled = true;
+        CAQueueingLanesPushReady(lanes, lane);
+        oc_cond_signal(lanes->lanesCond);
+    }
+    oc_mutex_unlock(lanes->lanesMutex);
+
+    return CA_STATUS_OK;
+}
+
+CAResult_t CAQueueingLanesGetStats(CAQueueingLanes_t *lanes, CAQueueingStats_t *stats, bool reset)
+{
+    if (NULL == lanes || NULL == lanes->lanesMutex || NULL == stats)
+    {
+        EDGE_LOG(TAG, "lanes instance is empty..");
+        return CA_STATUS_INVALID_PARAM;
+    }
+
+    oc_mutex_lock(lanes->lanesMutex);
+    *stats = lanes->stats;
+    stats->depth = lanes->pendingCount;
+    if (reset)
+    {
+        memset(&lanes->stats, 0, sizeof(CAQueueingStats_t));
+        lanes->stats.depth = lanes->pendingCount;
+        lanes->stats.highWaterDepth = lanes->pendingCount;
+    }
+    oc_mutex_unlock(lanes->lanesMutex);
+
+    return CA_STATUS_OK;
+}
+
+CAResult_t CAQueueingLanesStop(CAQueueingLanes_t *lanes)
+{
+    if (NULL == lanes || NULL == lanes->lanesMutex)
+    {
+        EDGE_LOG(TAG, "lanes instance is empty..");
+        return CA_STATUS_INVALID_PARAM;
+    }
+
+    EDGE_LOG(TAG, "lanes stop request!!");
+
+    oc_mutex_lock(lanes->lanesMutex);
+    lanes->isStop = true;
+    oc_cond_broadcast(lanes->lanesCond);
+    oc_cond_broadcast(lanes->spaceCond);
+
+    if (g_workerLanes == lanes && !g_workerDetached)
+    {
+        // called from a task, this worker leaves without touching the lanes again,
+        // so its lane is rescheduled here for the workers of a later start
+        g_workerDetached = true;
+        lanes->activeWorkers--;
+        if (NULL != g_workerLane)
+        {
+            if (u_priority_queue_get_size(g_workerLane->dataQueue) > 0)
+            {
+                CAQueueingLanesPushReady(lanes, g_workerLane);
+            }
+            else
+            {
+                g_workerLane->isScheduled = false;
+            }
+        }
+    }
+
+    while (lanes->activeWorkers > 0)
+    {
+        oc_cond_wait(lanes->lanesCond, lanes->lanesMutex);
+    }
+    oc_mutex_unlock(lanes->lanesMutex);
+
+    return CA_STATUS_OK;
+}
+
+CAResult_t CAQueueingLanesDestroy(CAQueueingLanes_t *lanes)
+{
+    if (NULL == lanes)
+    {
+        EDGE_LOG(TAG, "lanes instance is empty..");
+        return CA_STATUS_INVALID_PARAM;
+    }
+
+    EDGE_LOG(TAG, "lanes destroy..");
+
+    if (NULL != lanes->lanes)
+    {
+        uint32_t len = u_arraylist_length(lanes->lanes);
+        for (uint32_t i = 0; i < len; i++)
+        {
+            CAQueueingLane_t *lane = (CAQueueingLane_t *) u_arraylist_get(lanes->lanes, i);
+            if (NULL == lane)
+            {
+                continue;
+            }
+
+            u_queue_message_t *message = NULL;
+            while (NULL != (message = u_priority_queue_get_element(lane->dataQueue)))
+            {
+                CAQueueingLanesDestroyMessage(lanes, message);
+            }
+            u_priority_queue_delete(lane->dataQueue);
+            EdgeFree(lane->key);
+            EdgeFree(lane);
+        }
+        u_arraylist_free(&lanes->lanes);
+    }
+
+    lanes->readyHead = NULL;
+    lanes->readyTail = NULL;
+
+    if (lanes->lanesMutex)
+    {
+        oc_mutex_free(lanes->lanesMutex);
+        lanes->lanesMutex = NULL;
+    }
+    if (lanes->lanesCond)
+    {
+        oc_cond_free(lanes->lanesCond);
+        lanes->lanesCond = NULL;
+    }
+    if (lanes->spaceCond)
+    {
+        oc_cond_free(lanes->spaceCond);
+        lanes->spaceCond = NULL;
+    }
+    lanes->pendingCount = 0;
+
+    return CA_STATUS_OK;
+}
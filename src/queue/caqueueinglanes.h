@@ -0,0 +1,190 @@
+/******************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ *
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************/
+
+/**
+ * @file
+ *
+ * This file contains the APIs for keyed queueing lanes.
+ * Data added with the same key are processed in order, one at a time,
+ * while data of different keys are processed in parallel by a shared
+ * set of worker threads.
+ */
+
+#ifndef CA_QUEUEING_LANES_H_
+#define CA_QUEUEING_LANES_H_
+
+#include <stdint.h>
+
+#include "cathreadpool.h"
+#include "caqueueingthread.h"
+#include "caqueueingstats.h"
+#include "octhread.h"
+#include "uarraylist.h"
+#include "uqueue.h"
+#include "upriorityqueue.h"
+#include "cacommon.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+typedef struct CAQueueingLane_t CAQueueingLane_t;
+
+/** Lane holding the ordered data of one key. **/
+struct CAQueueingLane_t
+{
+    /** Key of the lane. **/
+    char *key;
+    /** Que of data waiting in this lane, one FIFO per priority level. **/
+    u_priority_queue_t *dataQueue;
+    /** Lane is in the ready list or being processed by a worker. **/
+    bool isScheduled;
+    /** Next lane in the ready list. **/
+    CAQueueingLane_t *nextReady;
+};
+
+typedef struct
+{
+    /** Thread pool of the worker threads. **/
+    ca_thread_pool_t threadPool;
+    /** mutex for synchronization. **/
+    oc_mutex lanesMutex;
+    /** conditional mutex for synchronization. **/
+    oc_cond lanesCond;
+    /** Thread function to be invoked. **/
+    CAThreadTask threadTask;
+    /** Data destroy function. **/
+    CADataDestroyFunction destroy;
+    /** Variable to inform the workers to stop. **/
+    bool isStop;
+    /** Number of worker threads to start. **/
+    uint32_t workerCount;
+    /** Number of worker threads currently running. **/
+    uint32_t activeWorkers;
+    /** List of lanes created so far. **/
+    u_arraylist_t *lanes;
+    /** First lane with pending data. **/
+    CAQueueingLane_t *readyHead;
+    /** Last lane with pending data. **/
+    CAQueueingLane_t *readyTail;
+    /** Number of data queued in all lanes. **/
+    uint32_t pendingCount;
+    /** Maximum number of data queued in all lanes, 0 for unbounded. **/
+    uint32_t capacity;
+    /** Action taken when the lanes are full. **/
+    CAQueueingOverflowPolicy_t overflowPolicy;
+    /** Match function of the drop oldest and conflate policies. **/
+    CADataMatchFunction overflowMatch;
+    /** conditional for producers waiting on full lanes. **/
+    oc_cond spaceCond;
+    /** Statistics of all lanes, protected by lanesMutex. **/
+    CAQueueingStats_t stats;
+} CAQueueingLanes_t;
+
+/**
+ * Initializes the queuing lanes.
+ * @param[in]   lanes        lanes data.
+ * @param[in]   handle       thread pool handle created.
+ * @param[in]   workerCount  number of worker threads shared by all lanes.
+ * @param[in]   task         function to be called for each data.
+ * @param[in]   destroy      function to data destroy.
+ * @return  CA_STATUS_OK or ERROR CODES (CAResult_t error codes in cacommon.h).
+ */
+CAResult_t CAQueueingLanesInitialize(CAQueueingLanes_t *lanes, ca_thread_pool_t handle,
+                                     uint32_t workerCount, CAThreadTask task,
+                                     CADataDestroyFunction destroy);
+
+/**
+ * Bounds the number of data queued in all lanes.
+ * Same policies as CAQueueingThreadSetBounds(), data to drop or conflate
+ * is only searched in the lane of the new data.
+ * @param[in]   lanes        lanes data.
+ * @param[in]   capacity     maximum number of queued data, 0 for unbounded.
+ * @param[in]   policy       action taken when the lanes are full.
+ * @param[in]   match        match function, required for conflate,
+ *                           NULL drops any data for drop oldest.
+ * @return  CA_STATUS_OK or ERROR CODES (CAResult_t error codes in cacommon.h).
+ */
+CAResult_t CAQueueingLanesSetBounds(CAQueueingLanes_t *lanes, uint32_t capacity,
+                                    CAQueueingOverflowPolicy_t policy,
+                                    CADataMatchFunction match);
+
+/**
+ * Start the worker threads of the queuing lanes.
+ * @param[in]   lanes        lanes data.
+ * @return  CA_STATUS_OK or ERROR CODES (CAResult_t error codes in cacommon.h).
+ */
+CAResult_t CAQueueingLanesStart(CAQueueingLanes_t *lanes);
+
+/**
+ * Add data to the lane of the given key. The lane is created on first use.
+ * @param[in]   lanes        lanes data.
+ * @param[in]   key          lane key, NULL uses a common lane.
+ * @param[in]   data         data that needs to be given for each thread.
+ * @param[in]   size         length of the data.
+ * @return  CA_STATUS_OK or ERROR CODES (CAResult_t error codes in cacommon.h).
+ */
+CAResult_t CAQueueingLanesAddData(CAQueueingLanes_t *lanes, const char *key, void *data,
+                                  uint32_t size);
+
+/**
+ * Add data to the lane of the given key with a priority level.
+ * Within a lane, higher levels (0 is the highest) are handled first without
+ * starving lower ones, see u_priority_queue_get_element().
+ * @param[in]   lanes        lanes data.
+ * @param[in]   key          lane key, NULL uses a common lane.
+ * @param[in]   data         data that needs to be given for each thread.
+ * @param[in]   size         length of the data.
+ * @param[in]   priority     priority level, up to U_PRIORITY_QUEUE_LOWEST.
+ * @return  CA_STATUS_OK or ERROR CODES (CAResult_t error codes in cacommon.h).
+ *          On error, including full lanes, data stays owned by the caller.
+ */
+CAResult_t CAQueueingLanesAddDataWithPriority(CAQueueingLanes_t *lanes, const char *key,
+                                              void *data, uint32_t size, uint32_t priority);
+
+/**
+ * Gets the statistics of all lanes.
+ * @param[in]   lanes        lanes data.
+ * @param[out]  stats        copy of the statistics.
+ * @param[in]   reset        true to reset the counters after the copy.
+ * @return  CA_STATUS_OK or ERROR CODES (CAResult_t error codes in cacommon.h).
+ */
+CAResult_t CAQueueingLanesGetStats(CAQueueingLanes_t *lanes, CAQueueingStats_t *stats, bool reset);
+
+/**
+ * Stop the worker threads. Can be called from a task running on a worker.
+ * @param[in]   lanes        lanes data.
+ * @return  CA_STATUS_OK or ERROR CODES (CAResult_t error codes in cacommon.h).
+ */
+CAResult_t CAQueueingLanesStop(CAQueueingLanes_t *lanes);
+
+/**
+ * Terminate the queuing lanes and destroy the remaining data.
+ * @param[in]   lanes        lanes data.
+ * @return  CA_STATUS_OK or ERROR CODES (CAResult_t error codes in cacommon.h).
+ */
+CAResult_t CAQueueingLanesDestroy(CAQueueingLanes_t *lanes);
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif  /* CA_QUEUEING_LANES_H_ */
@@ -0,0 +1,57 @@
+/******************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ *
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************/
+
+#include "caqueueingstats.h"
+
+void CAQueueingStatsEnqueued(CAQueueingStats_t *stats, uint32_t depth)
+{
+    stats->enqueueCount++;
+    stats->depth = depth;
+    if (depth > stats->highWaterDepth)
+    {
+        stats->highWaterDepth = depth;
+    }
+}
+
+void CAQueueingStatsDequeued(CAQueueingStats_t *stats, const u_queue_message_t *message,
+                             uint64_t now)
+{
+    uint64_t wait = (now > message->enqueueTime) ? now - message->enqueueTime : 0;
+
+    stats->dequeueCount++;
+    if (stats->depth > 0)
+    {
+        stats->depth--;
+    }
+    stats->totalWaitUs += wait;
+    if (wait > stats->maxWaitUs)
+    {
+        stats->maxWaitUs = wait;
+    }
+
+    uint32_t bucket = 0;
+    uint64_t limit = 10;
+    while (bucket < CA_QUEUEING_WAIT_BUCKETS - 1 && wait >= limit)
+    {
+        bucket++;
+        limit *= 10;
+    }
+    stats->waitHistogram[bucket]++;
+}
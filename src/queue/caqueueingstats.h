@@ -0,0 +1,87 @@
+/******************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ *
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************/
+
+/**
+ * @file
+ *
+ * This file contains the statistics kept by the queueing thread and lanes.
+ */
+
+#ifndef CA_QUEUEING_STATS_H_
+#define CA_QUEUEING_STATS_H_
+
+#include <stdint.h>
+
+#include "uqueue.h"
+#include "cacommon.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/**
+ * Number of wait time buckets. Bucket i counts waits below 10^(i+1) microseconds,
+ * the last bucket counts all longer waits.
+ **/
+#define CA_QUEUEING_WAIT_BUCKETS (8)
+
+/** Queue statistics. **/
+typedef struct
+{
+    /** Number of data accepted by the queue. **/
+    uint64_t enqueueCount;
+    /** Number of data handed to the task. **/
+    uint64_t dequeueCount;
+    /** Number of data rejected, dropped or replaced by newer data. **/
+    uint64_t dropCount;
+    /** Number of data currently queued. **/
+    uint32_t depth;
+    /** Highest number of data queued at once. **/
+    uint32_t highWaterDepth;
+    /** Longest time data waited in the queue, in microseconds. **/
+    uint64_t maxWaitUs;
+    /** Sum of the wait times, in microseconds. **/
+    uint64_t totalWaitUs;
+    /** Histogram of the wait times. **/
+    uint64_t waitHistogram[CA_QUEUEING_WAIT_BUCKETS];
+} CAQueueingStats_t;
+
+/**
+ * Records data accepted by the queue.
+ * @param[in]   stats        statistics to update.
+ * @param[in]   depth        number of data queued after the enqueue.
+ */
+void CAQueueingStatsEnqueued(CAQueueingStats_t *stats, uint32_t depth);
+
+/**
+ * Records data taken from the queue.
+ * @param[in]   stats        statistics to update.
+ * @param[in]   message      dequeued message, enqueueTime is used for the wait time.
+ * @param[in]   now          current time from oc_get_time_us().
+ */
+void CAQueueingStatsDequeued(CAQueueingStats_t *stats, const u_queue_message_t *message,
+                             uint64_t now);
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif  /* CA_QUEUEING_STATS_H_ */
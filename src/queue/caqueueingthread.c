@@ -33,25 +33,326 @@
 
 #define TAG "OIC_CA_QING"
 
-static void CAQueueingThreadBaseRoutine(void *threadValue)
+#if defined(_WIN32) && !defined(__GNUC__)
+#include <windows.h>
+#define PARKED_STORE(ptr, val) InterlockedExchange((LONG volatile *) (ptr), (val))
+#define PARKED_LOAD(ptr) InterlockedCompareExchange((LONG volatile *) (ptr), 0, 0)
+#define STATS_INCREMENT(ptr) InterlockedIncrement64((LONGLONG volatile *) (ptr))
+#define STATS_LOAD(ptr) InterlockedCompareExchange64((LONGLONG volatile *) (ptr), 0, 0)
+#define STATS_DECREMENT(ptr) InterlockedDecrement64((LONGLONG volatile *) (ptr))
+#else
+#define PARKED_STORE(ptr, val) __atomic_store_n((ptr), (val), __ATOMIC_SEQ_CST)
+#define PARKED_LOAD(ptr) __atomic_load_n((ptr), __ATOMIC_SEQ_CST)
+#define STATS_INCREMENT(ptr) __atomic_add_fetch((ptr), 1, __ATOMIC_RELAXED)
+#define STATS_LOAD(ptr) __atomic_load_n((ptr), __ATOMIC_RELAXED)
+#define STATS_DECREMENT(ptr) __atomic_sub_fetch((ptr), 1, __ATOMIC_RELAXED)
+#endif
+
+#if defined(_MSC_VER)
+#define QING_THREAD_LOCAL __declspec(thread)
+#else
+#define QING_THREAD_LOCAL __thread
+#endif
+
+/* Queueing thread served by the calling thread, NULL on other threads. */
+static QING_THREAD_LOCAL CAQueueingThread_t *g_currentThread = NULL;
+
+typedef struct
 {
-    EDGE_LOG( TAG, "message handler main thread start..");
+    CADataMatchFunction match;
+    u_queue_message_t *data;
+} CAQueueingMatchContext_t;
 
-    CAQueueingThread_t *thread = (CAQueueingThread_t *) threadValue;
+struct CAQueueingConflationEntry_t
+{
+    uint32_t hash;
+    u_queue_message_t *message;
+    CAQueueingConflationEntry_t *next;
+};
 
-    if (NULL == thread)
+static void CAQueueingThreadDestroyMessage(CAQueueingThread_t *thread, u_queue_message_t *message)
+{
+    if (NULL != thread->destroy)
+    {
+        thread->destroy(message->msg, message->size);
+    }
+    else
+    {
+        EdgeFree(message->msg);
+    }
+
+    EdgeFree(message);
+}
+
+static void CAQueueingThreadProcess(CAQueueingThread_t *thread, u_queue_message_t **batch,
+                                    void **batchData, uint32_t count)
+{
+    // process data
+    if (NULL != thread->batchTask)
+    {
+        for (uint32_t i = 0; i < count; i++)
+        {
+            batchData[i] = batch[i]->msg;
+        }
+        thread->batchTask(batchData, count);
+    }
+    else
+    {
+        for (uint32_t i = 0; i < count; i++)
+        {
+            thread->threadTask(batch[i]->msg);
+        }
+    }
+
+    // free
+    for (uint32_t i = 0; i < count; i++)
+    {
+        CAQueueingThreadDestroyMessage(thread, batch[i]);
+    }
+}
+
+/* Conflation index helpers, called with threadMutex held. */
+static u_queue_message_t *CAQueueingThreadFindConflated(CAQueueingThread_t *thread,
+                                                        u_queue_message_t *message)
+{
+    uint32_t hash = thread->conflateHash(message->msg, message->size);
+    if (0 == hash)
+    {
+        return NULL;
+    }
+
+    CAQueueingConflationEntry_t *entry = thread->conflateIndex[hash % CA_QUEUEING_CONFLATION_BUCKETS];
+    for (; NULL != entry; entry = entry->next)
+    {
+        if (entry->hash == hash && thread->conflateMatch(entry->message->msg, entry->message->size,
+                                                         message->msg, message->size))
+        {
+            return entry->message;
+        }
+    }
+    return NULL;
+}
+
+static void CAQueueingThreadIndex(CAQueueingThread_t *thread, u_queue_message_t *message)
+{
+    if (NULL == thread->conflateIndex)
+    {
+        return;
+    }
+
+    uint32_t hash = thread->conflateHash(message->msg, message->size);
+    if (0 == hash)
+    {
+        return;
+    }
+
+    CAQueueingConflationEntry_t *entry =
+        (CAQueueingConflationEntry_t *) EdgeMalloc(sizeof(CAQueueingConflationEntry_t));
+    if (NULL == entry)
+    {
+        EDGE_LOG(TAG, "memory error, data is queued without conflation..");
+        return;
+    }
+
+    CAQueueingConflationEntry_t **bucket = &thread->conflateIndex[hash % CA_QUEUEING_CONFLATION_BUCKETS];
+    entry->hash = hash;
+    entry->message = message;
+    entry->next = *bucket;
+    *bucket = entry;
+}
+
+static void CAQueueingThreadUnindex(CAQueueingThread_t *thread, u_queue_message_t *message)
+{
+    if (NULL == thread->conflateIndex)
+    {
+        return;
+    }
+
+    uint32_t hash = thread->conflateHash(message->msg, message->size);
+    if (0 == hash)
     {
-        EDGE_LOG(TAG, "thread data passing error!!");
         return;
     }
 
+    CAQueueingConflationEntry_t **link = &thread->conflateIndex[hash % CA_QUEUEING_CONFLATION_BUCKETS];
+    for (; NULL != *link; link = &(*link)->next)
+    {
+        if ((*link)->message == message)
+        {
+            CAQueueingConflationEntry_t *entry = *link;
+            *link = entry->next;
+            EdgeFree(entry);
+            return;
+        }
+    }
+}
+
+static void CAQueueingThreadClearIndex(CAQueueingThread_t *thread)
+{
+    if (NULL == thread->conflateIndex)
+    {
+        return;
+    }
+
+    for (uint32_t i = 0; i < CA_QUEUEING_CONFLATION_BUCKETS; i++)
+    {
+        CAQueueingConflationEntry_t *entry = thread->conflateIndex[i];
+        while (NULL != entry)
+        {
+            CAQueueingConflationEntry_t *next = entry->next;
+            EdgeFree(entry);
+            entry = next;
+        }
+    }
+    EdgeFree(thread->conflateIndex);
+    thread->conflateIndex = NULL;
+}
+
+/* Swaps the data of a queued message with the new one and destroys the old data. */
+static void CAQueueingThreadReplace(CAQueueingThread_t *thread, u_queue_message_t *queued,
+                                    u_queue_message_t *message)
+{
+    CAQueueingThreadUnindex(thread, queued);
+    void *oldData = queued->msg;
+    uint32_t oldSize = queued->size;
+    queued->msg = message->msg;
+    queued->size = message->size;
+    message->msg = oldData;
+    message->size = oldSize;
+    CAQueueingThreadIndex(thread, queued);
+    CAQueueingThreadDestroyMessage(thread, message);
+
+    CAQueueingStatsEnqueued(&thread->stats, u_priority_queue_get_size(thread->dataQueue));
+    thread->stats.dropCount++;
+}
+
+static bool CAQueueingThreadMatch(const u_queue_message_t *queued, void *ctx)
+{
+    CAQueueingMatchContext_t *context = (CAQueueingMatchContext_t *) ctx;
+    return context->match(queued->msg, queued->size, context->data->msg, context->data->size);
+}
+
+/* Called with threadMutex held. Returns CA_STATUS_OK when message can be queued,
+ * message is set to NULL when it has been merged into a queued one. */
+static CAResult_t CAQueueingThreadMakeRoom(CAQueueingThread_t *thread, u_queue_message_t **message)
+{
+    CAQueueingMatchContext_t context = { thread->overflowMatch, *message };
+    u_queue_match_cb match = thread->overflowMatch ? CAQueueingThreadMatch : NULL;
+
+    while (0 != thread->capacity && u_priority_queue_get_size(thread->dataQueue) >= thread->capacity)
+    {
+        switch (thread->overflowPolicy)
+        {
+            case CA_QUEUEING_OVERFLOW_BLOCK:
+                if (g_currentThread == thread)
+                {
+                    // the consumer can not wait for itself
+                    EDGE_LOG(TAG, "queue is full, added from its own thread..");
+                    return CA_STATUS_OK;
+                }
+                if (thread->isStop)
+                {
+                    EDGE_LOG(TAG, "queue is full and thread is stopped..");
+                    return CA_STATUS_FAILED;
+                }
+                oc_cond_wait(thread->spaceCond, thread->threadMutex);
+                break;
+            case CA_QUEUEING_OVERFLOW_DROP_OLDEST:
+            {
+                u_queue_message_t *old = u_priority_queue_remove_match(thread->dataQueue,
+                                                                       match, &context);
+                if (NULL == old)
+                {
+                    EDGE_LOG(TAG, "queue is full, nothing can be dropped..");
+                    return CA_STATUS_FAILED;
+                }
+                EDGE_LOG(TAG, "queue is full, oldest data dropped..");
+                CAQueueingThreadUnindex(thread, old);
+                CAQueueingThreadDestroyMessage(thread, old);
+                thread->stats.dropCount++;
+                break;
+            }
+            case CA_QUEUEING_OVERFLOW_CONFLATE:
+            {
+                u_queue_message_t *old = u_priority_queue_find_element(thread->dataQueue,
+                                                                       match, &context);
+                if (NULL == old)
+                {
+                    EDGE_LOG(TAG, "queue is full, nothing can be conflated..");
+                    return CA_STATUS_FAILED;
+                }
+                // swap the data in place so the queued position is kept
+                CAQueueingThreadReplace(thread, old, *message);
+                *message = NULL;
+                return CA_STATUS_OK;
+            }
+            default:
+                EDGE_LOG(TAG, "queue is full, data rejected..");
+                return CA_STATUS_FAILED;
+        }
+    }
+    return CA_STATUS_OK;
+}
+
+static void CAQueueingThreadLockFreeRoutine(CAQueueingThread_t *thread, u_queue_message_t **batch,
+                                            void **batchData, uint32_t batchSize)
+{
+    while (!thread->isStop)
+    {
+        uint32_t count = 0;
+        u_queue_message_t *message = NULL;
+        while (count < batchSize && NULL != (message = u_mpsc_queue_pop(thread->lockFreeQueue)))
+        {
+            batch[count++] = message;
+        }
+
+        if (count > 0)
+        {
+            uint64_t now = oc_get_time_us();
+            oc_mutex_lock(thread->threadMutex);
+            uint64_t queued = STATS_LOAD(&thread->lockFreeEnqueued) - thread->lockFreeDequeued;
+            thread->lockFreeDequeued += count;
+            if (queued > thread->stats.highWaterDepth)
+            {
+                thread->stats.highWaterDepth = (uint32_t) queued;
+            }
+            thread->stats.depth = (uint32_t) queued;
+            for (uint32_t i = 0; i < count; i++)
+            {
+                CAQueueingStatsDequeued(&thread->stats, batch[i], now);
+            }
+            oc_mutex_unlock(thread->threadMutex);
+
+            CAQueueingThreadProcess(thread, batch, batchData, count);
+            continue;
+        }
+
+        // queue is empty, park until a producer sees isParked and signals
+        oc_mutex_lock(thread->threadMutex);
+        PARKED_STORE(&thread->isParked, 1);
+        if (!thread->isStop && u_mpsc_queue_is_empty(thread->lockFreeQueue))
+        {
+            EDGE_LOG(TAG, "wait..");
+
+            oc_cond_wait(thread->threadCond, thread->threadMutex);
+
+            EDGE_LOG(TAG, "wake up..");
+        }
+        PARKED_STORE(&thread->isParked, 0);
+        oc_mutex_unlock(thread->threadMutex);
+    }
+}
+
+static void CAQueueingThreadLockedRoutine(CAQueueingThread_t *thread, u_queue_message_t **batch,
+                                          void **batchData, uint32_t batchSize)
+{
     while (!thread->isStop)
     {
         // mutex lock
         oc_mutex_lock(thread->threadMutex);
 
         // if queue is empty, thread will wait
-        if (!thread->isStop && u_queue_get_size(thread->dataQueue) <= 0)
+        if (!thread->isStop && u_priority_queue_get_size(thread->dataQueue) <= 0)
         {
             EDGE_LOG(TAG, "wait..");
 
@@ -69,31 +370,85 @@ static void CAQueueingThreadBaseRoutine(void *threadValue)
             continue;
         }
 
-        // get data
-        u_queue_message_t *message = u_queue_get_element(thread->dataQueue);
+        // get up to batchSize data under one lock
+        uint32_t count = 0;
+        u_queue_message_t *message = NULL;
+        uint64_t now = oc_get_time_us();
+        while (count < batchSize && NULL != (message = u_priority_queue_get_element(thread->dataQueue)))
+        {
+            CAQueueingThreadUnindex(thread, message);
+            CAQueueingStatsDequeued(&thread->stats, message, now);
+            batch[count++] = message;
+        }
+        if (0 != thread->capacity && 0 != count)
+        {
+            oc_cond_broadcast(thread->spaceCond);
+        }
         // mutex unlock
         oc_mutex_unlock(thread->threadMutex);
-        if (NULL == message)
+        if (0 == count)
         {
             continue;
         }
 
-        // process data
-        thread->threadTask(message->msg);
+        CAQueueingThreadProcess(thread, batch, batchData, count);
+    }
+}
+
+static void CAQueueingThreadBaseRoutine(void *threadValue)
+{
+    EDGE_LOG( TAG, "message handler main thread start..");
+
+    CAQueueingThread_t *thread = (CAQueueingThread_t *) threadValue;
 
-        // free
-        if (NULL != thread->destroy)
+    if (NULL == thread)
+    {
+        EDGE_LOG(TAG, "thread data passing error!!");
+        return;
+    }
+
+    g_currentThread = thread;
+
+    u_queue_message_t *single = NULL;
+    void *singleData = NULL;
+    u_queue_message_t **batch = &single;
+    void **batchData = &singleData;
+    uint32_t batchSize = 1;
+    if (thread->batchSize > 1)
+    {
+        batch = (u_queue_message_t **) EdgeCalloc(thread->batchSize, sizeof(u_queue_message_t *));
+        batchData = (void **) EdgeCalloc(thread->batchSize, sizeof(void *));
+        if (NULL == batch || NULL == batchData)
         {
-            thread->destroy(message->msg, message->size);
+            EDGE_LOG(TAG, "batch allocation failed, draining one message at a time");
+            EdgeFree(batch);
+            EdgeFree(batchData);
+            batch = &single;
+            batchData = &singleData;
         }
         else
         {
-            EdgeFree(message->msg);
+            batchSize = thread->batchSize;
         }
+    }
 
-        EdgeFree(message);
+    if (CA_QUEUEING_MODE_LOCKFREE == thread->mode)
+    {
+        CAQueueingThreadLockFreeRoutine(thread, batch, batchData, batchSize);
+    }
+    else
+    {
+        CAQueueingThreadLockedRoutine(thread, batch, batchData, batchSize);
+    }
+
+    if (batch != &single)
+    {
+        EdgeFree(batch);
+        EdgeFree(batchData);
     }
 
+    g_currentThread = NULL;
+
     oc_mutex_lock(thread->threadMutex);
     oc_cond_signal(thread->threadCond);
     oc_mutex_unlock(thread->threadMutex);
@@ -103,6 +458,14 @@ static void CAQueueingThreadBaseRoutine(void *threadValue)
 
 CAResult_t CAQueueingThreadInitialize(CAQueueingThread_t *thread, ca_thread_pool_t handle,
                                       CAThreadTask task, CADataDestroyFunction destroy)
+{
+    return CAQueueingThreadInitializeWithMode(thread, handle, task, destroy,
+                                              CA_QUEUEING_MODE_LOCKED);
+}
+
+CAResult_t CAQueueingThreadInitializeWithMode(CAQueueingThread_t *thread, ca_thread_pool_t handle,
+                                              CAThreadTask task, CADataDestroyFunction destroy,
+                                              CAQueueingMode_t mode)
 {
     if (NULL == thread)
     {
@@ -120,23 +483,56 @@ CAResult_t CAQueueingThreadInitialize(CAQueueingThread_t *thread, ca_thread_pool
 
     // set send thread data
     thread->threadPool = handle;
-    thread->dataQueue = u_queue_create();
+    // the locked queue reuses pre-allocated elements until it grows past the default
+    thread->dataQueue = u_priority_queue_create_with_capacity(
+            (CA_QUEUEING_MODE_LOCKED == mode) ? CA_QUEUEING_DEFAULT_CAPACITY : 0);
     thread->threadMutex = oc_mutex_new();
     thread->threadCond = oc_cond_new();
+    thread->spaceCond = oc_cond_new();
     thread->isStop = true;
     thread->threadTask = task;
     thread->destroy = destroy;
-    if (NULL == thread->dataQueue || NULL == thread->threadMutex || NULL == thread->threadCond)
+    thread->mode = mode;
+    thread->lockFreeQueue = NULL;
+    thread->isParked = 0;
+    thread->batchTask = NULL;
+    thread->batchSize = 1;
+    thread->capacity = 0;
+    thread->overflowPolicy = CA_QUEUEING_OVERFLOW_BLOCK;
+    thread->overflowMatch = NULL;
+    thread->conflateHash = NULL;
+    thread->conflateMatch = NULL;
+    thread->conflateIndex = NULL;
+    memset(&thread->stats, 0, sizeof(CAQueueingStats_t));
+    thread->lockFreeEnqueued = 0;
+    thread->lockFreeDequeued = 0;
+    thread->lockFreeEnqueueBase = 0;
+    if (NULL == thread->dataQueue || NULL == thread->threadMutex || NULL == thread->threadCond
+        || NULL == thread->spaceCond)
     {
         goto ERROR_MEM_FAILURE;
     }
 
+    if (CA_QUEUEING_MODE_LOCKFREE == mode)
+    {
+        thread->lockFreeQueue = u_mpsc_queue_create();
+        if (NULL == thread->lockFreeQueue)
+        {
+            goto ERROR_MEM_FAILURE;
+        }
+    }
+
     return CA_STATUS_OK;
 
 ERROR_MEM_FAILURE:
+    if (thread->lockFreeQueue)
+    {
+        u_mpsc_queue_delete(thread->lockFreeQueue);
+        thread->lockFreeQueue = NULL;
+    }
     if (thread->dataQueue)
     {
-        u_queue_delete(thread->dataQueue);
+        u_priority_queue_delete(thread->dataQueue);
         thread->dataQueue = NULL;
     }
     if (thread->threadMutex)
@@ -149,9 +545,139 @@ ERROR_MEM_FAILURE:
         oc_cond_free(thread->threadCond);
         thread->threadCond = NULL;
     }
+    if (thread->spaceCond)
+    {
+        oc_cond_free(thread->spaceCond);
+        thread->spaceCond = NULL;
+    }
     return CA_MEMORY_ALLOC_FAILED;
 }
 
+CAResult_t CAQueueingThreadSetBatchMode(CAQueueingThread_t *thread, CAThreadBatchTask batchTask,
+                                        uint32_t batchSize)
+{
+    if (NULL == thread)
+    {
+        EDGE_LOG( TAG, "thread instance is empty..");
+        return CA_STATUS_INVALID_PARAM;
+    }
+
+    if (0 == batchSize || (NULL == batchTask && NULL == thread->threadTask))
+    {
+        EDGE_LOG( TAG, "invalid batch parameter..");
+        return CA_STATUS_INVALID_PARAM;
+    }
+
+    if (false == thread->isStop)
+    {
+        EDGE_LOG( TAG, "batch mode can not be changed while running..");
+        return CA_STATUS_FAILED;
+    }
+
+    thread->batchTask = batchTask;
+    thread->batchSize = batchSize;
+    return CA_STATUS_OK;
+}
+
+CAResult_t CAQueueingThreadSetBounds(CAQueueingThread_t *thread, uint32_t capacity,
+                                     CAQueueingOverflowPolicy_t policy,
+                                     CADataMatchFunction match)
+{
+    if (NULL == thread || NULL == thread->threadMutex)
+    {
+        EDGE_LOG( TAG, "thread instance is empty..");
+        return CA_STATUS_INVALID_PARAM;
+    }
+
+    if (CA_QUEUEING_OVERFLOW_CONFLATE == policy && NULL == match)
+    {
+        EDGE_LOG( TAG, "conflate policy needs a match function..");
+        return CA_STATUS_INVALID_PARAM;
+    }
+
+    if (CA_QUEUEING_MODE_LOCKFREE == thread->mode && 0 != capacity)
+    {
+        EDGE_LOG( TAG, "bounds are not supported by the lock-free queue..");
+        return CA_STATUS_FAILED;
+    }
+
+    oc_mutex_lock(thread->threadMutex);
+    // an empty queue is replaced by one whose elements are allocated up front,
+    // so that enqueue and dequeue up to the bound do not touch the allocator
+    if (0 != capacity && capacity != thread->capacity
+        && 0 == u_priority_queue_get_size(thread->dataQueue))
+    {
+        u_priority_queue_t *dataQueue = u_priority_queue_create_with_capacity(capacity);
+        if (NULL != dataQueue)
+        {
+            u_priority_queue_delete(thread->dataQueue);
+            thread->dataQueue = dataQueue;
+        }
+    }
+    thread->capacity = capacity;
+    thread->overflowPolicy = policy;
+    thread->overflowMatch = match;
+    // let blocked producers re-check the new bounds
+    oc_cond_broadcast(thread->spaceCond);
+    oc_mutex_unlock(thread->threadMutex);
+
+    return CA_STATUS_OK;
+}
+
+CAResult_t CAQueueingThreadSetConflation(CAQueueingThread_t *thread, CADataHashFunction hash,
+                                         CADataMatchFunction match)
+{
+    if (NULL == thread || NULL == thread->threadMutex)
+    {
+        EDGE_LOG( TAG, "thread instance is empty..");
+        return CA_STATUS_INVALID_PARAM;
+    }
+
+    if (NULL != hash && NULL == match)
+    {
+        EDGE_LOG( TAG, "conflation needs a match function..");
+        return CA_STATUS_INVALID_PARAM;
+    }
+
+    if (CA_QUEUEING_MODE_LOCKFREE == thread->mode && NULL != hash)
+    {
+        EDGE_LOG( TAG, "conflation is not supported by the lock-free queue..");
+        return CA_STATUS_FAILED;
+    }
+
+    if (false == thread->isStop)
+    {
+        EDGE_LOG( TAG, "conflation can not be changed while running..");
+        return CA_STATUS_FAILED;
+    }
+
+    oc_mutex_lock(thread->threadMutex);
+    if (0 != u_priority_queue_get_size(thread->dataQueue))
+    {
+        oc_mutex_unlock(thread->threadMutex);
+        EDGE_LOG( TAG, "conflation can not be changed with queued data..");
+        return CA_STATUS_FAILED;
+    }
+
+    CAQueueingThreadClearIndex(thread);
+    if (NULL != hash)
+    {
+        thread->conflateIndex = (CAQueueingConflationEntry_t **)
+            EdgeCalloc(CA_QUEUEING_CONFLATION_BUCKETS, sizeof(CAQueueingConflationEntry_t *));
+        if (NULL == thread->conflateIndex)
+        {
+            oc_mutex_unlock(thread->threadMutex);
+            EDGE_LOG( TAG, "memory error!!");
+            return CA_MEMORY_ALLOC_FAILED;
+        }
+    }
+    thread->conflateHash = hash;
+    thread->conflateMatch = match;
+    oc_mutex_unlock(thread->threadMutex);
+
+    return CA_STATUS_OK;
+}
+
 CAResult_t CAQueueingThreadStart(CAQueueingThread_t *thread)
 {
     if (NULL == thread)
@@ -194,6 +720,12 @@ CAResult_t CAQueueingThreadStart(CAQueueingThread_t *thread)
 }
 
 CAResult_t CAQueueingThreadAddData(CAQueueingThread_t *thread, void *data, uint32_t size)
+{
+    return CAQueueingThreadAddDataWithPriority(thread, data, size, U_PRIORITY_QUEUE_LOWEST);
+}
+
+CAResult_t CAQueueingThreadAddDataWithPriority(CAQueueingThread_t *thread, void *data,
+                                               uint32_t size, uint32_t priority)
 {
     if (NULL == thread)
     {
@@ -218,12 +750,72 @@ CAResult_t CAQueueingThreadAddData(CAQueueingThread_t *thread, void *data, uint3
 
     message->msg = data;
     message->size = size;
+    message->enqueueTime = oc_get_time_us();
+
+    if (CA_QUEUEING_MODE_LOCKFREE == thread->mode)
+    {
+        // counted before the push so the consumer never sees a negative depth
+        STATS_INCREMENT(&thread->lockFreeEnqueued);
+        CAResult_t res = u_mpsc_queue_push(thread->lockFreeQueue, message);
+        if (CA_STATUS_OK != res)
+        {
+            oc_mutex_lock(thread->threadMutex);
+            STATS_DECREMENT(&thread->lockFreeEnqueued);
+            thread->stats.dropCount++;
+            oc_mutex_unlock(thread->threadMutex);
+            EdgeFree(message);
+            return res;
+        }
+
+        // only take the lock when the consumer is actually waiting
+        if (PARKED_LOAD(&thread->isParked))
+        {
+            oc_mutex_lock(thread->threadMutex);
+            oc_cond_signal(thread->threadCond);
+            oc_mutex_unlock(thread->threadMutex);
+        }
+        return CA_STATUS_OK;
+    }
 
     // mutex lock
     oc_mutex_lock(thread->threadMutex);
 
+    // replace a queued data of the same key
+    if (NULL != thread->conflateIndex)
+    {
+        u_queue_message_t *queued = CAQueueingThreadFindConflated(thread, message);
+        if (NULL != queued)
+        {
+            CAQueueingThreadReplace(thread, queued, message);
+            oc_mutex_unlock(thread->threadMutex);
+            return CA_STATUS_OK;
+        }
+    }
+
+    // apply the overflow policy if the queue is full
+    CAResult_t res = CAQueueingThreadMakeRoom(thread, &message);
+    if (CA_STATUS_OK != res)
+    {
+        thread->stats.dropCount++;
+        oc_mutex_unlock(thread->threadMutex);
+        EdgeFree(message);
+        return res;
+    }
+
     // add thread data into list
-    u_queue_add_element(thread->dataQueue, message);
+    if (NULL != message)
+    {
+        res = u_priority_queue_add_element(thread->dataQueue, message, priority);
+        if (CA_STATUS_OK != res)
+        {
+            thread->stats.dropCount++;
+            oc_mutex_unlock(thread->threadMutex);
+            EdgeFree(message);
+            return res;
+        }
+        CAQueueingThreadIndex(thread, message);
+        CAQueueingStatsEnqueued(&thread->stats, u_priority_queue_get_size(thread->dataQueue));
+    }
 
     // notity the thread
     oc_cond_signal(thread->threadCond);
@@ -234,6 +826,44 @@ CAResult_t CAQueueingThreadAddData(CAQueueingThread_t *thread, void *data, uint3
     return CA_STATUS_OK;
 }
 
+CAResult_t CAQueueingThreadGetStats(CAQueueingThread_t *thread, CAQueueingStats_t *stats,
+                                    bool reset)
+{
+    if (NULL == thread || NULL == thread->threadMutex || NULL == stats)
+    {
+        EDGE_LOG( TAG, "thread instance is empty..");
+        return CA_STATUS_INVALID_PARAM;
+    }
+
+    oc_mutex_lock(thread->threadMutex);
+    *stats = thread->stats;
+    uint64_t lockFreeEnqueued = STATS_LOAD(&thread->lockFreeEnqueued);
+    if (CA_QUEUEING_MODE_LOCKFREE == thread->mode)
+    {
+        stats->enqueueCount = lockFreeEnqueued - thread->lockFreeEnqueueBase;
+        stats->depth = (uint32_t) (lockFreeEnqueued - thread->lockFreeDequeued);
+    }
+    else
+    {
+        stats->depth = u_priority_queue_get_size(thread->dataQueue);
+    }
+
+    if (reset)
+    {
+        thread->lockFreeEnqueueBase = lockFreeEnqueued;
+        thread->stats.enqueueCount = 0;
+        thread->stats.dequeueCount = 0;
+        thread->stats.dropCount = 0;
+        thread->stats.highWaterDepth = stats->depth;
+        thread->stats.maxWaitUs = 0;
+        thread->stats.totalWaitUs = 0;
+        memset(thread->stats.waitHistogram, 0, sizeof(thread->stats.waitHistogram));
+    }
+    oc_mutex_unlock(thread->threadMutex);
+
+    return CA_STATUS_OK;
+}
+
 CAResult_t CAQueueingThreadDestroy(CAQueueingThread_t *thread)
 {
     if (NULL == thread)
@@ -248,37 +878,49 @@ CAResult_t CAQueueingThreadDestroy(CAQueueingThread_t *thread)
     oc_mutex_lock(thread->threadMutex);
 
     // remove all remained list data.
-    while (u_queue_get_size(thread->dataQueue) > 0)
+    while (u_priority_queue_get_size(thread->dataQueue) > 0)
     {
         // get data
-        u_queue_message_t *message = u_queue_get_element(thread->dataQueue);
+        u_queue_message_t *message = u_priority_queue_get_element(thread->dataQueue);
 
         // free
         if (NULL != message)
         {
-            if (NULL != thread->destroy)
-            {
-                thread->destroy(message->msg, message->size);
-            }
-            else
-            {
-                EdgeFree(message->msg);
-            }
-
-            EdgeFree(message);
+            CAQueueingThreadDestroyMessage(thread, message);
         }
     }
 
+    CAQueueingThreadClearIndex(thread);
+    thread->conflateHash = NULL;
+    thread->conflateMatch = NULL;
+
+    // remove all remained lock-free list data.
+    u_queue_message_t *message = NULL;
+    while (NULL != thread->lockFreeQueue
+           && NULL != (message = u_mpsc_queue_pop(thread->lockFreeQueue)))
+    {
+        CAQueueingThreadDestroyMessage(thread, message);
+    }
+
     // mutex unlock
     oc_mutex_unlock(thread->threadMutex);
 
     oc_mutex_free(thread->threadMutex);
     thread->threadMutex = NULL;
     oc_cond_free(thread->threadCond);
+    thread->threadCond = NULL;
+    oc_cond_free(thread->spaceCond);
+    thread->spaceCond = NULL;
 
-    u_queue_delete(thread->dataQueue);
+    u_priority_queue_delete(thread->dataQueue);
     thread->dataQueue = NULL;
 
+    if (NULL != thread->lockFreeQueue)
+    {
+        u_mpsc_queue_delete(thread->lockFreeQueue);
+        thread->lockFreeQueue = NULL;
+    }
+
     return CA_STATUS_OK;
 }
 
@@ -300,8 +942,9 @@ CAResult_t CAQueueingThreadStop(CAQueueingThread_t *thread)
         // set stop flag
         thread->isStop = true;
 
-        // notify the thread
+        // notify the thread and the blocked producers
         oc_cond_signal(thread->threadCond);
+        oc_cond_broadcast(thread->spaceCond);
 
         oc_cond_wait(thread->threadCond, thread->threadMutex);
 
@@ -32,6 +32,9 @@
 #include "cathreadpool.h"
 #include "octhread.h"
 #include "uqueue.h"
+#include "upriorityqueue.h"
+#include "umpscqueue.h"
+#include "caqueueingstats.h"
 #include "cacommon.h"
 
 #ifdef __cplusplus
@@ -42,9 +45,59 @@ extern "C"
 /** Thread function to be invoked. **/
 typedef void (*CAThreadTask)(void *threadData);
 
+/** Thread function to be invoked with a batch of data drained in one go. **/
+typedef void (*CAThreadBatchTask)(void **threadData, uint32_t count);
+
 /** Data destroy function. **/
 typedef void (*CADataDestroyFunction)(void *data, uint32_t size);
 
+/**
+ * Data match function used by the overflow policies.
+ * Returns true if the queued data can be dropped or replaced for the new data.
+ **/
+typedef bool (*CADataMatchFunction)(void *queued, uint32_t queuedSize, void *data, uint32_t size);
+
+/**
+ * Data hash function used by conflation.
+ * Returns 0 if the data can not be conflated. Data accepted by the match
+ * function must have the same hash.
+ **/
+typedef uint32_t (*CADataHashFunction)(void *data, uint32_t size);
+
+/**
+ * Number of elements allocated up front for the locked queue of an unbounded
+ * queueing thread, see u_priority_queue_create_with_capacity().
+ **/
+#define CA_QUEUEING_DEFAULT_CAPACITY (64)
+
+/** Number of buckets of the conflation index. **/
+#define CA_QUEUEING_CONFLATION_BUCKETS (256)
+
+/** Entry of the conflation index. **/
+typedef struct CAQueueingConflationEntry_t CAQueueingConflationEntry_t;
+
+/** Action taken when data is added to a full queue. **/
+typedef enum
+{
+    /** Producer waits until the consumer makes room. **/
+    CA_QUEUEING_OVERFLOW_BLOCK = 0,
+    /** New data is rejected. **/
+    CA_QUEUEING_OVERFLOW_REJECT,
+    /** Oldest queued data accepted by the match function is dropped. **/
+    CA_QUEUEING_OVERFLOW_DROP_OLDEST,
+    /** Queued data accepted by the match function is replaced by the new data. **/
+    CA_QUEUEING_OVERFLOW_CONFLATE
+} CAQueueingOverflowPolicy_t;
+
+/** Queue backend used by the queueing thread. **/
+typedef enum
+{
+    /** Mutex protected queue, consumer is signalled for every message. **/
+    CA_QUEUEING_MODE_LOCKED = 0,
+    /** Lock-free MPSC queue, consumer is signalled only when it is parked. **/
+    CA_QUEUEING_MODE_LOCKFREE
+} CAQueueingMode_t;
+
 typedef struct
 {
     /** Thread pool of the thread started. **/
@@ -59,8 +112,40 @@ typedef struct
     CADataDestroyFunction destroy;
     /** Variable to inform the thread to stop. **/
     bool isStop;
-    /** Que on which the thread is operating. **/
-    u_queue_t *dataQueue;
+    /** Que on which the thread is operating, one FIFO per priority level. **/
+    u_priority_queue_t *dataQueue;
+    /** Queue backend in use. **/
+    CAQueueingMode_t mode;
+    /** Lock-free que used in CA_QUEUEING_MODE_LOCKFREE. **/
+    u_mpsc_queue_t *lockFreeQueue;
+    /** Set while the consumer waits on threadCond in CA_QUEUEING_MODE_LOCKFREE. **/
+    volatile int isParked;
+    /** Thread function invoked per batch, NULL to call threadTask per data. **/
+    CAThreadBatchTask batchTask;
+    /** Maximum number of data drained per lock acquisition. **/
+    uint32_t batchSize;
+    /** Maximum number of queued data, 0 for unbounded. **/
+    uint32_t capacity;
+    /** Action taken when the queue is full. **/
+    CAQueueingOverflowPolicy_t overflowPolicy;
+    /** Match function of the drop oldest and conflate policies. **/
+    CADataMatchFunction overflowMatch;
+    /** conditional for producers waiting on a full queue. **/
+    oc_cond spaceCond;
+    /** Hash function of conflated data, NULL when conflation is off. **/
+    CADataHashFunction conflateHash;
+    /** Match function of conflated data. **/
+    CADataMatchFunction conflateMatch;
+    /** Queued data indexed by hash, allocated when conflation is on. **/
+    CAQueueingConflationEntry_t **conflateIndex;
+    /** Queue statistics, protected by threadMutex. **/
+    CAQueueingStats_t stats;
+    /** Data pushed in CA_QUEUEING_MODE_LOCKFREE, updated without the lock. **/
+    volatile uint64_t lockFreeEnqueued;
+    /** Data popped in CA_QUEUEING_MODE_LOCKFREE. **/
+    uint64_t lockFreeDequeued;
+    /** Value of lockFreeEnqueued at the last statistics reset. **/
+    uint64_t lockFreeEnqueueBase;
 } CAQueueingThread_t;
 
 /**
@@ -74,6 +159,62 @@ typedef struct
 CAResult_t CAQueueingThreadInitialize(CAQueueingThread_t *thread, ca_thread_pool_t handle,
                                       CAThreadTask task, CADataDestroyFunction destroy);
 
+/**
+ * Initializes the queuing thread with the given queue backend.
+ * @param[in]   thread       thread data for each thread.
+ * @param[in]   handle       thread pool handle created.
+ * @param[in]   task         function to be called for each data.
+ * @param[in]   destroy      function to data destroy.
+ * @param[in]   mode         queue backend to use.
+ * @return  CA_STATUS_OK or ERROR CODES (CAResult_t error codes in cacommon.h).
+ */
+CAResult_t CAQueueingThreadInitializeWithMode(CAQueueingThread_t *thread, ca_thread_pool_t handle,
+                                              CAThreadTask task, CADataDestroyFunction destroy,
+                                              CAQueueingMode_t mode);
+
+/**
+ * Enables batch draining for the queuing thread.
+ * Up to batchSize data are taken from the queue per lock acquisition and
+ * handed to batchTask, or to the thread task one by one if batchTask is NULL.
+ * Data are destroyed after the task returns. Must be called before start.
+ * @param[in]   thread       thread data for each thread.
+ * @param[in]   batchTask    function to be called for each batch, can be NULL.
+ * @param[in]   batchSize    maximum number of data per batch.
+ * @return  CA_STATUS_OK or ERROR CODES (CAResult_t error codes in cacommon.h).
+ */
+CAResult_t CAQueueingThreadSetBatchMode(CAQueueingThread_t *thread, CAThreadBatchTask batchTask,
+                                        uint32_t batchSize);
+
+/**
+ * Bounds the queue of the queuing thread.
+ * When the queue holds capacity data, the policy decides what happens to new
+ * data. A blocked producer is woken up when room is made or the thread stops,
+ * data added from the task itself never blocks. Not supported by the
+ * lock-free backend.
+ * @param[in]   thread       thread data for each thread.
+ * @param[in]   capacity     maximum number of queued data, 0 for unbounded.
+ * @param[in]   policy       action taken when the queue is full.
+ * @param[in]   match        match function, required for conflate,
+ *                           NULL drops any data for drop oldest.
+ * @return  CA_STATUS_OK or ERROR CODES (CAResult_t error codes in cacommon.h).
+ */
+CAResult_t CAQueueingThreadSetBounds(CAQueueingThread_t *thread, uint32_t capacity,
+                                     CAQueueingOverflowPolicy_t policy,
+                                     CADataMatchFunction match);
+
+/**
+ * Enables conflation of queued data.
+ * New data matching a queued one replaces it in place, so only the latest
+ * data of each key waits in the queue. Lookup is done through a hash index.
+ * Must be called before start, not supported by the lock-free backend.
+ * @param[in]   thread       thread data for each thread.
+ * @param[in]   hash         hash function, NULL to turn conflation off.
+ * @param[in]   match        match function, required with hash.
+ * @return  CA_STATUS_OK or ERROR CODES (CAResult_t error codes in cacommon.h).
+ */
+CAResult_t CAQueueingThreadSetConflation(CAQueueingThread_t *thread, CADataHashFunction hash,
+                                         CADataMatchFunction match);
+
 /**
  * Start the queuing thread.
  * @param[in]   thread        thread data that needs to be started.
@@ -90,6 +231,33 @@ CAResult_t CAQueueingThreadStart(CAQueueingThread_t *thread);
  */
 CAResult_t CAQueueingThreadAddData(CAQueueingThread_t *thread, void *data, uint32_t size);
 
+/**
+ * Add queuing thread data with a priority level.
+ * Data of a higher level (0 is the highest) are handled first, a waiting lower
+ * level is still served after U_PRIORITY_QUEUE_STARVATION_LIMIT passes.
+ * The lock-free backend keeps a single FIFO and ignores the priority.
+ * @param[in]   thread       thread data for new thread control.
+ * @param[in]   data         data that needs to be given for each thread.
+ * @param[in]   size         length of the data.
+ * @param[in]   priority     priority level, up to U_PRIORITY_QUEUE_LOWEST.
+ * @return  CA_STATUS_OK or ERROR CODES (CAResult_t error codes in cacommon.h).
+ *          On error, including a full queue, data is not queued and stays
+ *          owned by the caller.
+ */
+CAResult_t CAQueueingThreadAddDataWithPriority(CAQueueingThread_t *thread, void *data,
+                                               uint32_t size, uint32_t priority);
+
+/**
+ * Gets the statistics of the queuing thread.
+ * In CA_QUEUEING_MODE_LOCKFREE the high-water depth is sampled by the consumer.
+ * @param[in]   thread       thread data for each thread.
+ * @param[out]  stats        copy of the statistics.
+ * @param[in]   reset        true to reset the counters after the copy.
+ * @return  CA_STATUS_OK or ERROR CODES (CAResult_t error codes in cacommon.h).
+ */
+CAResult_t CAQueueingThreadGetStats(CAQueueingThread_t *thread, CAQueueingStats_t *stats,
+                                    bool reset);
+
 /**
  * Stop the queuing thread.
  * @param[in]   thread       thread data that needs to be started.
@@ -61,6 +61,20 @@ typedef struct ca_thread_pool
  */
 CAResult_t ca_thread_pool_init(int32_t num_of_threads, ca_thread_pool_t *thread_pool_handle);
 
+/**
+ * This function sets a routine which each worker thread runs when it starts, before its
+ * first task. Workers started before the call do not run it.
+ *
+ * @param thread_pool The thread pool structure.
+ * @param method The routine to be executed, NULL for none.
+ * @param data The data to be passed to the routine.
+ *
+ * @return CA_STATUS_OK on success.
+ * @return Error on failure.
+ */
+CAResult_t ca_thread_pool_set_start_routine(ca_thread_pool_t thread_pool, ca_thread_func method,
+                                            void *data);
+
 /**
  * This function adds a routine to be executed by the thread pool at some future time.
  *
@@ -32,52 +32,169 @@
 #include "uarraylist.h"
 #include "octhread.h"
 
-#include "edge_random.h"
 #include "edge_malloc.h"
 #include "edge_logger.h"
 
 #define TAG "UTHREADPOOL"
 
 /**
- * empty struct to represent the details.  This implementation has no data
- * that it needs to keep track of, so it only uses NULL for the internal value.
+ * Task waiting in the pool queue.
  */
-typedef struct ca_thread_pool_details_t
+typedef struct ca_thread_pool_task_t
 {
-    u_arraylist_t* threads_list;
-    oc_mutex list_lock;
-} ca_thread_pool_details_t;
+    ca_thread_func func;
+    void* data;
+    uint32_t taskId;
+    struct ca_thread_pool_task_t *next;
+} ca_thread_pool_task_t;
 
 /**
- * struct to wrap the pthreads callback properly.  The function pointer for
- * pthreads requires a void* return value, however u_thread_func is a void.
+ * Details of the pool. Workers are created on demand up to max_threads
+ * and stay alive, taking tasks from a FIFO queue, until the pool is freed.
  */
-typedef struct ca_thread_pool_callback_info_t
+typedef struct ca_thread_pool_details_t
 {
-    ca_thread_func func;
-    void* data;
-} ca_thread_pool_callback_info_t;
+    u_arraylist_t* threads_list;
+    oc_mutex list_lock;
+    oc_cond task_cond;
+    oc_cond done_cond;
+    ca_thread_pool_task_t *task_head;
+    ca_thread_pool_task_t *task_tail;
+    uint32_t max_threads;
+    uint32_t idle_threads;
+    uint32_t next_task_id;
+    bool stop;
+    ca_thread_func start_func;
+    void *start_data;
+} ca_thread_pool_details_t;
 
 typedef struct ca_thread_pool_thread_info_t
 {
     oc_thread thread;
+    ca_thread_pool_details_t *details;
     uint32_t taskId;
+    bool busy;
 } ca_thread_pool_thread_info_t;
 
-// passthrough function to convert the pthreads call to a u_thread_func call
-void* ca_thread_pool_pthreads_delegate(void* data)
+#if defined(_MSC_VER)
+#define POOL_THREAD_LOCAL __declspec(thread)
+#else
+#define POOL_THREAD_LOCAL __thread
+#endif
+
+/* Worker info of the calling thread, NULL if it is not a pool worker. */
+static POOL_THREAD_LOCAL ca_thread_pool_thread_info_t *g_currentWorker = NULL;
+/* Set when the pool was freed from a task running on the calling worker. */
+static POOL_THREAD_LOCAL bool g_workerDetached = false;
+
+static ca_thread_pool_task_t *ca_thread_pool_pop_task(ca_thread_pool_details_t *details)
 {
-    ca_thread_pool_callback_info_t* info = (ca_thread_pool_callback_info_t*)data;
-    info->func(info->data);
-    EdgeFree(info);
+    ca_thread_pool_task_t *task = details->task_head;
+    if (task)
+    {
+        details->task_head = task->next;
+        if (!details->task_head)
+        {
+            details->task_tail = NULL;
+        }
+        task->next = NULL;
+    }
+    return task;
+}
+
+// worker loop, runs queued tasks until the pool is stopped and the queue is drained
+static void* ca_thread_pool_worker(void* data)
+{
+    ca_thread_pool_thread_info_t *threadInfo = (ca_thread_pool_thread_info_t *) data;
+    ca_thread_pool_details_t *details = threadInfo->details;
+    g_currentWorker = threadInfo;
+    g_workerDetached = false;
+
+    oc_mutex_lock(details->list_lock);
+    ca_thread_func start_func = details->start_func;
+    void *start_data = details->start_data;
+    oc_mutex_unlock(details->list_lock);
+    if (start_func)
+    {
+        start_func(start_data);
+    }
+
+    oc_mutex_lock(details->list_lock);
+    while (true)
+    {
+        while (!details->task_head && !details->stop)
+        {
+            details->idle_threads++;
+            oc_cond_wait(details->task_cond, details->list_lock);
+            details->idle_threads--;
+        }
+
+        ca_thread_pool_task_t *task = ca_thread_pool_pop_task(details);
+        if (!task)
+        {
+            break;
+        }
+
+        threadInfo->taskId = task->taskId;
+        threadInfo->busy = true;
+        oc_mutex_unlock(details->list_lock);
+
+        task->func(task->data);
+        EdgeFree(task);
+
+        if (g_workerDetached)
+        {
+            // the pool was freed by the task itself, nothing of it is valid anymore
+            g_currentWorker = NULL;
+            return NULL;
+        }
+
+        oc_mutex_lock(details->list_lock);
+        threadInfo->busy = false;
+        oc_cond_broadcast(details->done_cond);
+    }
+    oc_mutex_unlock(details->list_lock);
+
+    g_currentWorker = NULL;
     return NULL;
 }
 
-// this implementation doesn't do a thread pool, so this function is essentially
-// a no-op besides creating a valid ca_thread_pool_t object.  It was determined after
-// reading through the existing implementation that the thread-pooling was unnecessary
-// for the posix platforms.  Behavior shouldn't be changed since previously num_of_threads
-// was greater than the number of requested threads.
+// spawns one more persistent worker, list_lock must be held
+static CAResult_t ca_thread_pool_spawn_worker(ca_thread_pool_details_t *details)
+{
+    ca_thread_pool_thread_info_t *threadInfo =
+            (ca_thread_pool_thread_info_t *) EdgeCalloc(1, sizeof(ca_thread_pool_thread_info_t));
+    if (!threadInfo)
+    {
+        EDGE_LOG(TAG, "Memory allocation failed");
+        return CA_MEMORY_ALLOC_FAILED;
+    }
+    threadInfo->details = details;
+
+    if (!u_arraylist_add(details->threads_list, (void*) threadInfo))
+    {
+        EDGE_LOG(TAG, "Arraylist add failed");
+        EdgeFree(threadInfo);
+        return CA_STATUS_FAILED;
+    }
+
+    int thrRet = oc_thread_new(&threadInfo->thread, ca_thread_pool_worker, threadInfo);
+    if (thrRet != 0)
+    {
+        uint32_t index = 0;
+        if (u_arraylist_get_index(details->threads_list, threadInfo, &index))
+        {
+            u_arraylist_remove(details->threads_list, index);
+        }
+        EDGE_LOG_V(TAG, "Thread start failed with error %d", thrRet);
+        EdgeFree(threadInfo);
+        return CA_STATUS_FAILED;
+    }
+
+    EDGE_LOG_V(TAG, "created worker %u", u_arraylist_length(details->threads_list));
+    return CA_STATUS_OK;
+}
+
 CAResult_t ca_thread_pool_init(int32_t num_of_threads, ca_thread_pool_t *thread_pool)
 {
     EDGE_LOG(TAG, "IN");
@@ -102,7 +219,7 @@ CAResult_t ca_thread_pool_init(int32_t num_of_threads, ca_thread_pool_t *thread_
         return CA_MEMORY_ALLOC_FAILED;
     }
 
-    (*thread_pool)->details = EdgeMalloc(sizeof(struct ca_thread_pool_details_t));
+    (*thread_pool)->details = EdgeCalloc(1, sizeof(struct ca_thread_pool_details_t));
     if(!(*thread_pool)->details)
     {
         EDGE_LOG(TAG, "Failed to allocate for thread-pool details");
@@ -111,23 +228,17 @@ CAResult_t ca_thread_pool_init(int32_t num_of_threads, ca_thread_pool_t *thread_
         return CA_MEMORY_ALLOC_FAILED;
     }
 
-    (*thread_pool)->details->list_lock = oc_mutex_new();
-
-    if(!(*thread_pool)->details->list_lock)
-    {
-        EDGE_LOG(TAG, "Failed to create thread-pool mutex");
-        goto exit;
-    }
-
-    (*thread_pool)->details->threads_list = u_arraylist_create();
+    ca_thread_pool_details_t *details = (*thread_pool)->details;
+    details->max_threads = (uint32_t) num_of_threads;
+    details->next_task_id = 1;
+    details->list_lock = oc_mutex_new();
+    details->task_cond = oc_cond_new();
+    details->done_cond = oc_cond_new();
+    details->threads_list = u_arraylist_create();
 
-    if(!(*thread_pool)->details->threads_list)
+    if(!details->list_lock || !details->task_cond || !details->done_cond || !details->threads_list)
     {
-        EDGE_LOG(TAG, "Failed to create thread-pool list");
-        if(!oc_mutex_free((*thread_pool)->details->list_lock))
-        {
-            EDGE_LOG(TAG, "Failed to free thread-pool mutex");
-        }
+        EDGE_LOG(TAG, "Failed to create thread-pool resources");
         goto exit;
     }
 
@@ -135,12 +246,42 @@ CAResult_t ca_thread_pool_init(int32_t num_of_threads, ca_thread_pool_t *thread_
     return CA_STATUS_OK;
 
 exit:
+    if (details->list_lock)
+    {
+        oc_mutex_free(details->list_lock);
+    }
+    if (details->task_cond)
+    {
+        oc_cond_free(details->task_cond);
+    }
+    if (details->done_cond)
+    {
+        oc_cond_free(details->done_cond);
+    }
+    u_arraylist_free(&details->threads_list);
     EdgeFree((*thread_pool)->details);
     EdgeFree(*thread_pool);
     *thread_pool = NULL;
     return CA_STATUS_FAILED;
 }
 
+CAResult_t ca_thread_pool_set_start_routine(ca_thread_pool_t thread_pool, ca_thread_func method,
+                                            void *data)
+{
+    if(NULL == thread_pool)
+    {
+        EDGE_LOG(TAG, "thread_pool was NULL");
+        return CA_STATUS_INVALID_PARAM;
+    }
+
+    ca_thread_pool_details_t *details = thread_pool->details;
+    oc_mutex_lock(details->list_lock);
+    details->start_func = method;
+    details->start_data = data;
+    oc_mutex_unlock(details->list_lock);
+    return CA_STATUS_OK;
+}
+
 CAResult_t ca_thread_pool_add_task(ca_thread_pool_t thread_pool, ca_thread_func method, void *data,
                                    uint32_t *taskId)
 {
@@ -152,62 +293,86 @@ CAResult_t ca_thread_pool_add_task(ca_thread_pool_t thread_pool, ca_thread_func
         return CA_STATUS_INVALID_PARAM;
     }
 
-    ca_thread_pool_callback_info_t* info = EdgeMalloc(sizeof(ca_thread_pool_callback_info_t));
-    if(!info)
+    ca_thread_pool_task_t* task = EdgeCalloc(1, sizeof(ca_thread_pool_task_t));
+    if(!task)
     {
-        EDGE_LOG(TAG, "Failed to allocate for memory wrapper");
+        EDGE_LOG(TAG, "Failed to allocate for task");
         return CA_MEMORY_ALLOC_FAILED;
     }
 
-    info->func = method;
-    info->data = data;
+    task->func = method;
+    task->data = data;
 
-    ca_thread_pool_thread_info_t *threadInfo =
-            (ca_thread_pool_thread_info_t *) EdgeCalloc(1, sizeof(ca_thread_pool_thread_info_t));
-    if (!threadInfo)
+    ca_thread_pool_details_t *details = thread_pool->details;
+    oc_mutex_lock(details->list_lock);
+    if (details->stop)
     {
-        EDGE_LOG(TAG, "Memory allocation failed");
-        EdgeFree(info);
+        oc_mutex_unlock(details->list_lock);
+        EDGE_LOG(TAG, "thread pool is stopping");
+        EdgeFree(task);
         return CA_STATUS_FAILED;
     }
-    threadInfo->taskId = EdgeGetRandom();
-    if (taskId)
+
+    // give a worker to the task if all of the existing ones are busy
+    uint32_t queued = 0;
+    for (ca_thread_pool_task_t *it = details->task_head; it; it = it->next)
     {
-        *taskId = threadInfo->taskId;
+        queued++;
+    }
+    if (details->idle_threads <= queued
+        && u_arraylist_length(details->threads_list) < details->max_threads)
+    {
+        CAResult_t res = ca_thread_pool_spawn_worker(details);
+        if (CA_STATUS_OK != res && 0 == u_arraylist_length(details->threads_list))
+        {
+            oc_mutex_unlock(details->list_lock);
+            EdgeFree(task);
+            return res;
+        }
     }
 
-    oc_mutex_lock(thread_pool->details->list_lock);
-    bool addResult = u_arraylist_add(thread_pool->details->threads_list, (void*) threadInfo);
-    if (!addResult)
+    task->taskId = details->next_task_id++;
+    if (0 == details->next_task_id)
     {
-        // Note that this is considered non-fatal.
-        oc_mutex_unlock(thread_pool->details->list_lock);
-        EDGE_LOG(TAG, "Arraylist add failed");
-        EdgeFree(info);
-        EdgeFree(threadInfo);
-        return CA_STATUS_FAILED;
+        details->next_task_id = 1;
+    }
+    if (taskId)
+    {
+        *taskId = task->taskId;
     }
 
-    int thrRet = oc_thread_new(&threadInfo->thread, ca_thread_pool_pthreads_delegate, info);
-    if (thrRet != 0)
+    if (details->task_tail)
     {
-        uint32_t index = 0;
-        if (u_arraylist_get_index(thread_pool->details->threads_list, threadInfo, &index))
-        {
-            u_arraylist_remove(thread_pool->details->threads_list, index);
-        }
-        oc_mutex_unlock(thread_pool->details->list_lock);
-        EDGE_LOG_V(TAG, "Thread start failed with error %d", thrRet);
-        EdgeFree(info);
-        return CA_STATUS_FAILED;
+        details->task_tail->next = task;
+    }
+    else
+    {
+        details->task_head = task;
     }
-    EDGE_LOG_V(TAG, "created taskId: %u", threadInfo->taskId);
-    oc_mutex_unlock(thread_pool->details->list_lock);
+    details->task_tail = task;
+    oc_cond_signal(details->task_cond);
+
+    EDGE_LOG_V(TAG, "queued taskId: %u", task->taskId);
+    oc_mutex_unlock(details->list_lock);
 
     EDGE_LOG_V(TAG, "Out %s", __func__);
     return CA_STATUS_OK;
 }
 
+static bool ca_thread_pool_is_running(ca_thread_pool_details_t *details, uint32_t taskId)
+{
+    for (uint32_t i = 0; i < u_arraylist_length(details->threads_list); ++i)
+    {
+        ca_thread_pool_thread_info_t *threadInfo = (ca_thread_pool_thread_info_t *)
+                u_arraylist_get(details->threads_list, i);
+        if (threadInfo && threadInfo->busy && threadInfo->taskId == taskId)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
 CAResult_t ca_thread_pool_remove_task(ca_thread_pool_t thread_pool, uint32_t taskId)
 {
     EDGE_LOG_V(TAG, "In %s", __func__);
@@ -218,27 +383,44 @@ CAResult_t ca_thread_pool_remove_task(ca_thread_pool_t thread_pool, uint32_t tas
         return CA_STATUS_FAILED;
     }
 
-    oc_mutex_lock(thread_pool->details->list_lock);
-    for (uint32_t i = 0; i < u_arraylist_length(thread_pool->details->threads_list); ++i)
+    ca_thread_pool_details_t *details = thread_pool->details;
+    oc_mutex_lock(details->list_lock);
+
+    // task not started yet, just drop it
+    ca_thread_pool_task_t *prev = NULL;
+    for (ca_thread_pool_task_t *task = details->task_head; task; prev = task, task = task->next)
     {
-        ca_thread_pool_thread_info_t *threadInfo = (ca_thread_pool_thread_info_t *)
-                u_arraylist_get(thread_pool->details->threads_list, i);
-        if (threadInfo)
+        if (task->taskId == taskId)
         {
-            if (threadInfo->taskId == taskId)
+            if (prev)
             {
-                EDGE_LOG_V(TAG, "waiting.. taskId: %u", threadInfo->taskId);
-                oc_thread_wait(threadInfo->thread);
-
-                EDGE_LOG_V(TAG, "removed taskId: %u", threadInfo->taskId);
-                u_arraylist_remove(thread_pool->details->threads_list, i);
-                oc_thread_free(threadInfo->thread);
-                EdgeFree(threadInfo);
-                break;
+                prev->next = task->next;
             }
+            else
+            {
+                details->task_head = task->next;
+            }
+            if (details->task_tail == task)
+            {
+                details->task_tail = prev;
+            }
+            EdgeFree(task);
+            EDGE_LOG_V(TAG, "removed queued taskId: %u", taskId);
+            oc_mutex_unlock(details->list_lock);
+            return CA_STATUS_OK;
         }
     }
-    oc_mutex_unlock(thread_pool->details->list_lock);
+
+    // task running, wait for it unless it is the caller itself
+    if (!(g_currentWorker && g_currentWorker->details == details && g_currentWorker->taskId == taskId))
+    {
+        while (ca_thread_pool_is_running(details, taskId))
+        {
+            EDGE_LOG_V(TAG, "waiting.. taskId: %u", taskId);
+            oc_cond_wait(details->done_cond, details->list_lock);
+        }
+    }
+    oc_mutex_unlock(details->list_lock);
 
     EDGE_LOG_V(TAG, "Out %s", __func__);
     return CA_STATUS_OK;
@@ -254,28 +436,51 @@ void ca_thread_pool_free(ca_thread_pool_t thread_pool)
         return;
     }
 
-    oc_mutex_lock(thread_pool->details->list_lock);
+    ca_thread_pool_details_t *details = thread_pool->details;
 
-    for (uint32_t i = 0; i < u_arraylist_length(thread_pool->details->threads_list); ++i)
+    oc_mutex_lock(details->list_lock);
+    details->stop = true;
+    oc_cond_broadcast(details->task_cond);
+    oc_mutex_unlock(details->list_lock);
+
+    // workers drain the queue before exiting, so all scheduled tasks complete
+    for (uint32_t i = 0; i < u_arraylist_length(details->threads_list); ++i)
     {
         ca_thread_pool_thread_info_t *threadInfo = (ca_thread_pool_thread_info_t *)
-                u_arraylist_get(thread_pool->details->threads_list, i);
+                u_arraylist_get(details->threads_list, i);
         if (threadInfo)
         {
             if (threadInfo->thread)
             {
-                EDGE_LOG_V(TAG, "waiting.. thread: %p", threadInfo->thread);
-                oc_thread_wait(threadInfo->thread);
+                if (threadInfo == g_currentWorker)
+                {
+                    // freed from one of its own tasks, let this worker go on its own
+                    EDGE_LOG_V(TAG, "detaching.. thread: %p", threadInfo->thread);
+                    g_workerDetached = true;
+                    oc_thread_detach(threadInfo->thread);
+                }
+                else
+                {
+                    EDGE_LOG_V(TAG, "waiting.. thread: %p", threadInfo->thread);
+                    oc_thread_wait(threadInfo->thread);
+                }
                 oc_thread_free(threadInfo->thread);
             }
             EdgeFree(threadInfo);
         }
     }
 
-    u_arraylist_free(&(thread_pool->details->threads_list));
+    u_arraylist_free(&(details->threads_list));
+
+    ca_thread_pool_task_t *task = NULL;
+    while (NULL != (task = ca_thread_pool_pop_task(details)))
+    {
+        EdgeFree(task);
+    }
 
-    oc_mutex_unlock(thread_pool->details->list_lock);
-    oc_mutex_free(thread_pool->details->list_lock);
+    oc_cond_free(details->task_cond);
+    oc_cond_free(details->done_cond);
+    oc_mutex_free(details->list_lock);
 
     EdgeFree(thread_pool->details);
     EdgeFree(thread_pool);
@@ -20,6 +20,7 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #ifndef _WIN32
 #include <pthread.h>
 #include <unistd.h>
@@ -31,21 +32,74 @@
 #include "cacommon.h"
 #include "cathreadpool.h" /* for thread pool */
 #include "caqueueingthread.h"
+#include "caqueueinglanes.h"
 #include "message_dispatcher.h"
+#include "report_latency.h"
+#include "request_future.h"
+#include "report_spool.h"
+#include "octhread.h"
+#include "edge_hash_map.h"
 #include "edge_utils.h"
 #include "edge_malloc.h"
 #include "edge_logger.h"
+#include "edge_trace.h"
+#include "edge_thread_config.h"
 
 #define SINGLE_HANDLE
 #define MAX_THREAD_POOL_SIZE    20
+#define QUEUEING_BATCH_SIZE     32
+#define SEND_LANE_WORKER_COUNT  4
+#define MAX_LANE_KEY_SIZE       (600)
+
+// reports queued before the spool is used if the receive queue has no capacity
+#define SPOOL_DEFAULT_THRESHOLD (1024)
+// interval in which the spool is checked if the receive queue did not drain
+#define SPOOL_REPLAY_INTERVAL_US (50 * 1000)
 
 #define TAG "message_handler"
 
+#ifdef ENABLE_LOCKFREE_QUEUE
+#define QUEUEING_MODE CA_QUEUEING_MODE_LOCKFREE
+#else
+#define QUEUEING_MODE CA_QUEUEING_MODE_LOCKED
+#endif
+
+/**
+ * Priority classes of the queued messages, mapped onto the queue levels.
+ * Higher classes are handled first, lower ones are not starved.
+ */
+typedef enum
+{
+    /** Start/stop, subscription management and error responses. */
+    MESSAGE_PRIORITY_CONTROL = 0,
+    /** Write and method requests and their responses. */
+    MESSAGE_PRIORITY_WRITE = 1,
+    /** Read and browse requests and their responses. */
+    MESSAGE_PRIORITY_READ = 2,
+    /** Subscription reports and publish requests. */
+    MESSAGE_PRIORITY_REPORT = U_PRIORITY_QUEUE_LOWEST
+} MessagePriority;
+
 // thread pool handle
 static ca_thread_pool_t g_threadPoolHandle = NULL;
 
 // message handler main thread
+#ifndef ENABLE_SEND_LANES
 static CAQueueingThread_t g_sendThread;
+#else
+// one ordered send lane per endpoint, served by shared workers
+static CAQueueingLanes_t g_sendLanes;
+#endif
+
+// endpoint -> RequestLanes of the endpoints whose requests spread over several lanes
+static EdgeHashMap *g_requestLanes = NULL;
+static pthread_mutex_t g_requestLanesMutex = PTHREAD_MUTEX_INITIALIZER;
+
+typedef struct RequestLanes
+{
+    size_t count;
+    size_t next;
+} RequestLanes;
 static CAQueueingThread_t g_receiveThread;
 
 static response_cb_t g_responseCallback = NULL;
@@ -54,8 +108,290 @@ static send_cb_t g_sendCallback = NULL;
 static pthread_mutex_t g_queueingThreadMutex = PTHREAD_MUTEX_INITIALIZER;
 static bool g_queueingThreadInitialized = false;
 
+// reports are handed to the application on the producer thread
+static bool g_inlineReports = false;
+
+// notifications of a publish response are collected into one report
+static bool g_batchedReports = false;
+
+// queue bounds, unbounded by default
+static EdgeQueueConfig g_sendQueueConfig;
+static EdgeQueueConfig g_recvQueueConfig;
+
+// copy of g_recvQueueConfig.spoolPath
+static char *g_spoolPath = NULL;
+
+// REPORT messages overflow into the spool while the receive queue holds g_spoolThreshold
+// of them, g_spoolMutex keeps the order of spooled and queued reports
+static EdgeReportSpool *g_reportSpool = NULL;
+static uint64_t g_spoolThreshold = 0;
+static oc_mutex g_spoolMutex = NULL;
+static oc_cond g_spoolCond = NULL;
+static oc_thread g_spoolThread = NULL;
+static bool g_spoolRunning = false;
+
+// REPORT messages in the receive queue, counted while the spool is open
+static volatile uint64_t g_queuedReports = 0;
+
 static void handleMessage(EdgeMessage *data);
 static void destroyData(void *data, uint32_t size);
+static MessagePriority getMessagePriority(EdgeMessage *msg);
+
+static bool isQueuedReport(void *queued, uint32_t queuedSize, void *data, uint32_t size)
+{
+    (void) queuedSize;
+    (void) data;
+    (void) size;
+    return REPORT == ((EdgeMessage *) queued)->type;
+}
+
+static const char *getReportValueAlias(EdgeMessage *msg)
+{
+    if (REPORT != msg->type || 1 != msg->responseLength || NULL == msg->responses
+            || NULL == msg->responses[0] || NULL == msg->responses[0]->nodeInfo)
+    {
+        return NULL;
+    }
+    return msg->responses[0]->nodeInfo->valueAlias;
+}
+
+static bool isSameReport(void *queued, uint32_t queuedSize, void *data, uint32_t size)
+{
+    (void) queuedSize;
+    (void) size;
+    EdgeMessage *queuedMsg = (EdgeMessage *) queued;
+    EdgeMessage *msg = (EdgeMessage *) data;
+
+    const char *queuedAlias = getReportValueAlias(queuedMsg);
+    const char *alias = getReportValueAlias(msg);
+    if (NULL == queuedAlias || NULL == alias || 0 != strcmp(queuedAlias, alias))
+    {
+        return false;
+    }
+
+    if (NULL == queuedMsg->endpointInfo || NULL == msg->endpointInfo)
+    {
+        return queuedMsg->endpointInfo == msg->endpointInfo;
+    }
+    const char *queuedUri = queuedMsg->endpointInfo->endpointUri;
+    const char *uri = msg->endpointInfo->endpointUri;
+    return (queuedUri && uri) ? (0 == strcmp(queuedUri, uri)) : (queuedUri == uri);
+}
+
+static uint32_t hashString(uint32_t hash, const char *str)
+{
+    // FNV-1a
+    for (; str && *str; str++)
+    {
+        hash ^= (uint8_t) *str;
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+static uint32_t getReportHash(void *data, uint32_t size)
+{
+    (void) size;
+    EdgeMessage *msg = (EdgeMessage *) data;
+    const char *alias = getReportValueAlias(msg);
+    if (NULL == alias)
+    {
+        return 0;
+    }
+
+    uint32_t hash = hashString(2166136261u, alias);
+    if (msg->endpointInfo)
+    {
+        hash = hashString(hash, msg->endpointInfo->endpointUri);
+    }
+    return (0 == hash) ? 1 : hash;
+}
+
+static CAQueueingOverflowPolicy_t getOverflowPolicy(const EdgeQueueConfig *config,
+        CADataMatchFunction *match)
+{
+    switch (config->overflowPolicy)
+    {
+        case EDGE_QUEUE_OVERFLOW_REJECT:
+            *match = NULL;
+            return CA_QUEUEING_OVERFLOW_REJECT;
+        case EDGE_QUEUE_OVERFLOW_DROP_OLDEST_REPORT:
+            *match = isQueuedReport;
+            return CA_QUEUEING_OVERFLOW_DROP_OLDEST;
+        case EDGE_QUEUE_OVERFLOW_CONFLATE:
+            *match = isSameReport;
+            return CA_QUEUEING_OVERFLOW_CONFLATE;
+        default:
+            *match = NULL;
+            return CA_QUEUEING_OVERFLOW_BLOCK;
+    }
+}
+
+// conflation can only be changed before the queues start
+static CAResult_t applyConflation(CAQueueingThread_t *thread, const EdgeQueueConfig *config)
+{
+    return CAQueueingThreadSetConflation(thread, config->conflateReports ? getReportHash : NULL,
+            config->conflateReports ? isSameReport : NULL);
+}
+
+static CAResult_t applySendQueueConfig()
+{
+    CADataMatchFunction match = NULL;
+    CAQueueingOverflowPolicy_t policy = getOverflowPolicy(&g_sendQueueConfig, &match);
+#ifndef ENABLE_SEND_LANES
+    return CAQueueingThreadSetBounds(&g_sendThread, g_sendQueueConfig.capacity, policy, match);
+#else
+    return CAQueueingLanesSetBounds(&g_sendLanes, g_sendQueueConfig.capacity, policy, match);
+#endif
+}
+
+static CAResult_t applyRecvQueueConfig()
+{
+    CADataMatchFunction match = NULL;
+    CAQueueingOverflowPolicy_t policy = getOverflowPolicy(&g_recvQueueConfig, &match);
+    return CAQueueingThreadSetBounds(&g_receiveThread, g_recvQueueConfig.capacity, policy, match);
+}
+
+static bool enqueueReceived(EdgeMessage *msg)
+{
+    bool counted = (REPORT == msg->type && NULL != g_reportSpool);
+    if (counted)
+    {
+        __atomic_add_fetch(&g_queuedReports, 1, __ATOMIC_RELAXED);
+    }
+    EDGE_TRACE_BEGIN(msg, EDGE_TRACE_STAGE_RECV_QUEUE);
+    CAResult_t res = CAQueueingThreadAddDataWithPriority(&g_receiveThread, msg, sizeof(EdgeMessage),
+            getMessagePriority(msg));
+    if (CA_STATUS_OK != res)
+    {
+        EDGE_LOG_V(TAG, "Failed to add message to receive queue (%d)\n", res);
+        if (counted)
+        {
+            __atomic_sub_fetch(&g_queuedReports, 1, __ATOMIC_RELAXED);
+        }
+        EDGE_TRACE_END(msg, EDGE_TRACE_STAGE_RECV_QUEUE);
+        freeEdgeMessage(msg);
+        return false;
+    }
+    return true;
+}
+
+/* Spools a report while the receive queue is behind or earlier reports are spooled,
+ * so that the reports of a subscription are delivered in order.
+ * Returns true if the report was spooled and freed. */
+static bool spoolReport(EdgeMessage *msg)
+{
+    bool spooled = false;
+    oc_mutex_lock(g_spoolMutex);
+    if (NULL != g_reportSpool && (0 < getReportSpoolCount(g_reportSpool)
+            || __atomic_load_n(&g_queuedReports, __ATOMIC_RELAXED) >= g_spoolThreshold))
+    {
+        spooled = appendReportSpool(g_reportSpool, msg);
+    }
+    oc_mutex_unlock(g_spoolMutex);
+    if (spooled)
+    {
+        freeEdgeMessage(msg);
+    }
+    return spooled;
+}
+
+static void *spoolReplayHandler(void *arg)
+{
+    (void) arg;
+    applyEdgeThreadConfig(EDGE_THREAD_HELPER);
+    oc_mutex_lock(g_spoolMutex);
+    while (g_spoolRunning)
+    {
+        // replaying starts once the queue has drained to half of the threshold
+        if (0 < getReportSpoolCount(g_reportSpool)
+                && __atomic_load_n(&g_queuedReports, __ATOMIC_RELAXED) <= g_spoolThreshold / 2)
+        {
+            EdgeMessage *msg = NULL;
+            while (__atomic_load_n(&g_queuedReports, __ATOMIC_RELAXED) < g_spoolThreshold
+                    && NULL != (msg = takeReportSpool(g_reportSpool)))
+            {
+                enqueueReceived(msg);
+            }
+        }
+        oc_cond_wait_for(g_spoolCond, g_spoolMutex, SPOOL_REPLAY_INTERVAL_US);
+    }
+    oc_mutex_unlock(g_spoolMutex);
+    return NULL;
+}
+
+// called before the receive queue starts
+static bool startReportSpool()
+{
+    g_spoolMutex = oc_mutex_new();
+    g_spoolCond = oc_cond_new();
+    if (NULL == g_spoolMutex || NULL == g_spoolCond)
+    {
+        EDGE_LOG(TAG, "Failed to create the report spool lock.");
+        goto ERROR;
+    }
+    g_reportSpool = openReportSpool(g_recvQueueConfig.spoolPath, g_recvQueueConfig.spoolMaxBytes);
+    if (NULL == g_reportSpool)
+    {
+        goto ERROR;
+    }
+    g_spoolThreshold = g_recvQueueConfig.capacity ?
+            (g_recvQueueConfig.capacity + 1) / 2 : SPOOL_DEFAULT_THRESHOLD;
+    g_queuedReports = 0;
+    g_spoolRunning = true;
+    if (OC_THREAD_SUCCESS != oc_thread_new(&g_spoolThread, spoolReplayHandler, NULL))
+    {
+        EDGE_LOG(TAG, "Failed to start the report spool thread.");
+        g_spoolRunning = false;
+        g_spoolThread = NULL;
+        goto ERROR;
+    }
+    return true;
+
+ERROR:
+    closeReportSpool(g_reportSpool);
+    g_reportSpool = NULL;
+    oc_cond_free(g_spoolCond);
+    oc_mutex_free(g_spoolMutex);
+    g_spoolCond = NULL;
+    g_spoolMutex = NULL;
+    return false;
+}
+
+// spooled reports stay in the file for the next start
+static void stopReportSpoolReplay()
+{
+    if (NULL == g_spoolThread)
+    {
+        return;
+    }
+    oc_mutex_lock(g_spoolMutex);
+    g_spoolRunning = false;
+    oc_cond_signal(g_spoolCond);
+    oc_mutex_unlock(g_spoolMutex);
+
+    oc_thread_wait(g_spoolThread);
+    oc_thread_free(g_spoolThread);
+    g_spoolThread = NULL;
+}
+
+// called after the receive queue is stopped
+static void closeSpool()
+{
+    if (NULL == g_spoolMutex)
+    {
+        return;
+    }
+    oc_mutex_lock(g_spoolMutex);
+    closeReportSpool(g_reportSpool);
+    g_reportSpool = NULL;
+    oc_mutex_unlock(g_spoolMutex);
+
+    oc_cond_free(g_spoolCond);
+    oc_mutex_free(g_spoolMutex);
+    g_spoolCond = NULL;
+    g_spoolMutex = NULL;
+}
 
 void delete_queue()
 {
@@ -69,10 +405,19 @@ void delete_queue()
 
     // stop thread
     // delete thread data
+#ifndef ENABLE_SEND_LANES
     if (NULL != g_sendThread.threadMutex)
     {
         CAQueueingThreadStop(&g_sendThread);
     }
+#else
+    if (NULL != g_sendLanes.lanesMutex)
+    {
+        CAQueueingLanesStop(&g_sendLanes);
+    }
+#endif
+
+    stopReportSpoolReplay();
 
     // stop thread
     // delete thread data
@@ -88,8 +433,14 @@ void delete_queue()
         g_threadPoolHandle = NULL;
     }
 
+#ifndef ENABLE_SEND_LANES
     CAQueueingThreadDestroy(&g_sendThread);
+#else
+    CAQueueingLanesDestroy(&g_sendLanes);
+#endif
     CAQueueingThreadDestroy(&g_receiveThread);
+    closeSpool();
+    reset_report_latency();
 
     g_queueingThreadInitialized = false;
 
@@ -114,30 +465,210 @@ static void recvQ_run(void *ptr)
     handleMessage(data);
 }
 
+static MessagePriority getSubPriority(EdgeMessage *msg)
+{
+    EdgeRequest *req = (SEND_REQUESTS == msg->type && msg->requests) ? msg->requests[0] : msg->request;
+    if (NULL == req || NULL == req->subMsg)
+    {
+        return MESSAGE_PRIORITY_REPORT;
+    }
+
+    switch (req->subMsg->subType)
+    {
+        case Edge_Create_Sub:
+        case Edge_Create_Bulk_Sub:
+        case Edge_Modify_Sub:
+        case Edge_Delete_Sub:
+        case Edge_Republish_Sub:
+            return MESSAGE_PRIORITY_CONTROL;
+        default:
+            return MESSAGE_PRIORITY_REPORT;
+    }
+}
+
+static MessagePriority getMessagePriority(EdgeMessage *msg)
+{
+    if (NULL == msg)
+    {
+        return MESSAGE_PRIORITY_REPORT;
+    }
+
+    if (REPORT == msg->type)
+    {
+        return MESSAGE_PRIORITY_REPORT;
+    }
+    if (ERROR_RESPONSE == msg->type)
+    {
+        return MESSAGE_PRIORITY_CONTROL;
+    }
+
+    switch (msg->command)
+    {
+        case CMD_START_SERVER:
+        case CMD_START_CLIENT:
+        case CMD_STOP_SERVER:
+        case CMD_STOP_CLIENT:
+            return MESSAGE_PRIORITY_CONTROL;
+        case CMD_WRITE:
+        case CMD_METHOD:
+            return MESSAGE_PRIORITY_WRITE;
+        case CMD_SUB:
+            return getSubPriority(msg);
+        default:
+            return MESSAGE_PRIORITY_READ;
+    }
+}
+
+void set_request_lanes(const char *endpoint, size_t count)
+{
+    if (NULL == endpoint)
+    {
+        return;
+    }
+
+    pthread_mutex_lock(&g_requestLanesMutex);
+    keyValue storedKey = NULL;
+    RequestLanes *lanes = (RequestLanes *) removeEdgeHashMapElement(g_requestLanes,
+            (keyValue) endpoint, &storedKey);
+    EdgeFree(storedKey);
+    EdgeFree(lanes);
+    if (count > 1)
+    {
+        if (NULL == g_requestLanes)
+        {
+            g_requestLanes = createEdgeHashMap(EDGE_HASH_STRING_KEY);
+        }
+        char *key = cloneString(endpoint);
+        lanes = (RequestLanes *) EdgeCalloc(1, sizeof(RequestLanes));
+        if (NULL == g_requestLanes || NULL == key || NULL == lanes
+                || !insertEdgeHashMapElement(g_requestLanes, (keyValue) key, (keyValue) lanes))
+        {
+            EDGE_LOG(TAG, "Memory allocation failed for the request lanes\n");
+            EdgeFree(key);
+            EdgeFree(lanes);
+        }
+        else
+        {
+            lanes->count = count;
+        }
+    }
+    if (NULL != g_requestLanes && 0 == getEdgeHashMapSize(g_requestLanes))
+    {
+        deleteEdgeHashMap(g_requestLanes);
+        g_requestLanes = NULL;
+    }
+    pthread_mutex_unlock(&g_requestLanesMutex);
+}
+
+#ifdef ENABLE_SEND_LANES
+/* Requests which any session of an endpoint can serve, the others keep to their order */
+static bool isPooledRequest(EdgeMessage *msg)
+{
+    EdgeMessageBlock *block = EDGE_MESSAGE_BLOCK(msg);
+    if ((SEND_REQUEST != msg->type && SEND_REQUESTS != msg->type) || block->asyncDrain)
+    {
+        return false;
+    }
+    switch (msg->command)
+    {
+        case CMD_READ:
+            return 0 == block->preparedId;
+        case CMD_WRITE:
+            return !block->coalesceFlush;
+        case CMD_METHOD:
+        case CMD_BROWSE:
+        case CMD_BROWSE_VIEW:
+            return true;
+        default:
+            return false;
+    }
+}
+
+/* Gets the send lane of a message, the endpoint or "endpoint#n" for pooled requests */
+static const char *getSendLane(EdgeMessage *msg, char *laneKey, size_t size)
+{
+    const char *endpoint = (msg && msg->endpointInfo) ? msg->endpointInfo->endpointUri : NULL;
+    if (NULL == endpoint || !isPooledRequest(msg))
+    {
+        return endpoint;
+    }
+
+    size_t lane = 0;
+    pthread_mutex_lock(&g_requestLanesMutex);
+    RequestLanes *lanes = (RequestLanes *) getEdgeHashMapElement(g_requestLanes,
+            (keyValue) endpoint);
+    if (NULL != lanes)
+    {
+        lane = lanes->next;
+        lanes->next = (lanes->next + 1) % lanes->count;
+    }
+    pthread_mutex_unlock(&g_requestLanesMutex);
+
+    if (0 == lane || snprintf(laneKey, size, "%s#%zu", endpoint, lane) >= (int) size)
+    {
+        return endpoint;
+    }
+    return laneKey;
+}
+#endif
+
 bool add_to_sendQ(EdgeMessage *msg)
 {
-    CAQueueingThreadAddData(&g_sendThread, msg, sizeof(EdgeMessage));
+    MessagePriority priority = getMessagePriority(msg);
+    // traced before the message is queued, a worker may free it right after
+    EDGE_TRACE_BEGIN(msg, EDGE_TRACE_STAGE_SEND_QUEUE);
+#ifndef ENABLE_SEND_LANES
+    CAResult_t res = CAQueueingThreadAddDataWithPriority(&g_sendThread, msg, sizeof(EdgeMessage),
+            priority);
+#else
+    char laneKey[MAX_LANE_KEY_SIZE];
+    const char *lane = getSendLane(msg, laneKey, sizeof(laneKey));
+    CAResult_t res = CAQueueingLanesAddDataWithPriority(&g_sendLanes, lane, msg,
+            sizeof(EdgeMessage), priority);
+#endif
+    if (CA_STATUS_OK != res)
+    {
+        EDGE_LOG_V(TAG, "Failed to add message to send queue (%d)\n", res);
+        EDGE_TRACE_END(msg, EDGE_TRACE_STAGE_SEND_QUEUE);
+        freeEdgeMessage(msg);
+        return false;
+    }
     return true;
 }
 
 bool add_to_recvQ(EdgeMessage *msg)
 {
-    CAQueueingThreadAddData(&g_receiveThread, msg, sizeof(EdgeMessage));
-    return true;
+    if (deliverToRequestFuture(msg))
+    {
+        // Taken by the thread which waits for the request
+        return true;
+    }
+    if (REPORT == msg->type && NULL != g_reportSpool && spoolReport(msg))
+    {
+        return true;
+    }
+    return enqueueReceived(msg);
 }
 
 static void handleMessage(EdgeMessage *data)
 {
     if (SEND_REQUEST == data->type || SEND_REQUESTS == data->type)
     {
+        EDGE_TRACE_END(data, EDGE_TRACE_STAGE_SEND_QUEUE);
         // Invoke callback to send request.
+        EDGE_TRACE_BEGIN(data, EDGE_TRACE_STAGE_EXECUTE);
         g_sendCallback(data);
+        EDGE_TRACE_END(data, EDGE_TRACE_STAGE_EXECUTE);
     }
     else if (GENERAL_RESPONSE == data->type || BROWSE_RESPONSE == data->type || REPORT == data->type
             || ERROR_RESPONSE == data->type)
     {
+        EDGE_TRACE_END(data, EDGE_TRACE_STAGE_RECV_QUEUE);
         // Invoke callback to handle response.
+        record_report_latency(data);
+        EDGE_TRACE_BEGIN(data, EDGE_TRACE_STAGE_CALLBACK);
         g_responseCallback(data);
+        EDGE_TRACE_END(data, EDGE_TRACE_STAGE_CALLBACK);
     }
 }
 
@@ -163,30 +694,114 @@ void init_queue()
         EDGE_LOG(TAG, "thread pool initialize error.");
         goto EXIT;
     }
+    ca_thread_pool_set_start_routine(g_threadPoolHandle, startEdgeThreadWorker,
+            (void *) (intptr_t) EDGE_THREAD_DISPATCHER);
 
+#ifndef ENABLE_SEND_LANES
     // send thread initialize
-    res = CAQueueingThreadInitialize(&g_sendThread, g_threadPoolHandle, sendQ_run, destroyData);
+    res = CAQueueingThreadInitializeWithMode(&g_sendThread, g_threadPoolHandle, sendQ_run, destroyData,
+            (g_sendQueueConfig.capacity || g_sendQueueConfig.conflateReports)
+                ? CA_QUEUEING_MODE_LOCKED : QUEUEING_MODE);
     if (CA_STATUS_OK != res)
     {
         EDGE_LOG(TAG, "Failed to Initialize send queue thread");
         goto EXIT;
     }
 
+    res = CAQueueingThreadSetBatchMode(&g_sendThread, NULL, QUEUEING_BATCH_SIZE);
+    if (CA_STATUS_OK != res)
+    {
+        EDGE_LOG(TAG, "Failed to set batch mode of send queue thread");
+        goto EXIT;
+    }
+
+    res = applySendQueueConfig();
+    if (CA_STATUS_OK != res)
+    {
+        EDGE_LOG(TAG, "Failed to set bounds of send queue thread");
+        goto EXIT;
+    }
+
+    res = applyConflation(&g_sendThread, &g_sendQueueConfig);
+    if (CA_STATUS_OK != res)
+    {
+        EDGE_LOG(TAG, "Failed to set conflation of send queue thread");
+        goto EXIT;
+    }
+
     res = CAQueueingThreadStart(&g_sendThread);
     if (CA_STATUS_OK != res)
     {
         EDGE_LOG(TAG, "thread start error(send thread).");
         goto EXIT;
     }
+#else
+    // send lanes initialize
+    res = CAQueueingLanesInitialize(&g_sendLanes, g_threadPoolHandle, SEND_LANE_WORKER_COUNT,
+            sendQ_run, destroyData);
+    if (CA_STATUS_OK != res)
+    {
+        EDGE_LOG(TAG, "Failed to Initialize send queue lanes");
+        goto EXIT;
+    }
+
+    res = applySendQueueConfig();
+    if (CA_STATUS_OK != res)
+    {
+        EDGE_LOG(TAG, "Failed to set bounds of send queue lanes");
+        goto EXIT;
+    }
+
+    if (g_sendQueueConfig.conflateReports)
+    {
+        // send lanes carry requests only, there is no REPORT to conflate
+        EDGE_LOG(TAG, "Report conflation is ignored by the send queue lanes");
+    }
+
+    res = CAQueueingLanesStart(&g_sendLanes);
+    if (CA_STATUS_OK != res)
+    {
+        EDGE_LOG(TAG, "thread start error(send lanes).");
+        goto EXIT;
+    }
+#endif
 
     // receive thread initialize
-    res = CAQueueingThreadInitialize(&g_receiveThread, g_threadPoolHandle, recvQ_run, destroyData);
+    res = CAQueueingThreadInitializeWithMode(&g_receiveThread, g_threadPoolHandle, recvQ_run, destroyData,
+            (g_recvQueueConfig.capacity || g_recvQueueConfig.conflateReports)
+                ? CA_QUEUEING_MODE_LOCKED : QUEUEING_MODE);
     if (CA_STATUS_OK != res)
     {
         EDGE_LOG(TAG, "Failed to Initialize receive queue thread");
         goto EXIT;
     }
 
+    res = CAQueueingThreadSetBatchMode(&g_receiveThread, NULL, QUEUEING_BATCH_SIZE);
+    if (CA_STATUS_OK != res)
+    {
+        EDGE_LOG(TAG, "Failed to set batch mode of receive queue thread");
+        goto EXIT;
+    }
+
+    res = applyRecvQueueConfig();
+    if (CA_STATUS_OK != res)
+    {
+        EDGE_LOG(TAG, "Failed to set bounds of receive queue thread");
+        goto EXIT;
+    }
+
+    res = applyConflation(&g_receiveThread, &g_recvQueueConfig);
+    if (CA_STATUS_OK != res)
+    {
+        EDGE_LOG(TAG, "Failed to set conflation of receive queue thread");
+        goto EXIT;
+    }
+
+    if (NULL != g_recvQueueConfig.spoolPath && !startReportSpool())
+    {
+        EDGE_LOG(TAG, "Failed to open the report spool, reports are queued without it");
+    }
+
     res = CAQueueingThreadStart(&g_receiveThread);
     if (CA_STATUS_OK != res)
     {
@@ -206,6 +821,159 @@ EXIT:
     }
 }
 
+void set_queue_config(const EdgeQueueConfig *sendConfig, const EdgeQueueConfig *recvConfig)
+{
+    int ret = pthread_mutex_lock(&g_queueingThreadMutex);
+    if(ret != 0)
+    {
+        EDGE_LOG_V(TAG, "Failed to lock the queueing thread mutex. "
+            "pthread_mutex_lock() returned (%d)\n.", ret);
+        exit(ret);
+    }
+
+    if (sendConfig)
+    {
+        g_sendQueueConfig = *sendConfig;
+    }
+    if (recvConfig)
+    {
+        // the path is kept until the spool is opened
+        EdgeFree(g_spoolPath);
+        g_spoolPath = recvConfig->spoolPath ? cloneString(recvConfig->spoolPath) : NULL;
+        g_recvQueueConfig = *recvConfig;
+        g_recvQueueConfig.spoolPath = g_spoolPath;
+    }
+
+    // running queues take the new bounds right away
+    if (g_queueingThreadInitialized)
+    {
+        if (CA_STATUS_OK != applySendQueueConfig())
+        {
+            EDGE_LOG(TAG, "Failed to set bounds of send queue");
+        }
+        if (CA_STATUS_OK != applyRecvQueueConfig())
+        {
+            EDGE_LOG(TAG, "Failed to set bounds of receive queue");
+        }
+        EDGE_LOG(TAG, "Report conflation and the report spool take effect when the queues are "
+                "initialized again");
+    }
+
+    ret = pthread_mutex_unlock(&g_queueingThreadMutex);
+    if(ret != 0)
+    {
+        EDGE_LOG_V(TAG, "Failed to unlock the queueing thread mutex. "
+            "pthread_mutex_unlock() returned (%d)\n.", ret);
+        exit(ret);
+    }
+}
+
+static void copyQueueStats(EdgeQueueStats *dst, const CAQueueingStats_t *src)
+{
+    dst->enqueueCount = src->enqueueCount;
+    dst->dequeueCount = src->dequeueCount;
+    dst->dropCount = src->dropCount;
+    dst->depth = src->depth;
+    dst->highWaterDepth = src->highWaterDepth;
+    dst->maxWaitUs = src->maxWaitUs;
+    dst->totalWaitUs = src->totalWaitUs;
+    for (int i = 0; i < EDGE_QUEUE_WAIT_BUCKETS && i < CA_QUEUEING_WAIT_BUCKETS; i++)
+    {
+        dst->waitHistogram[i] = src->waitHistogram[i];
+    }
+}
+
+bool get_queue_stats(EdgeQueueStats *sendStats, EdgeQueueStats *recvStats, bool reset)
+{
+    int ret = pthread_mutex_lock(&g_queueingThreadMutex);
+    if(ret != 0)
+    {
+        EDGE_LOG_V(TAG, "Failed to lock the queueing thread mutex. "
+            "pthread_mutex_lock() returned (%d)\n.", ret);
+        exit(ret);
+    }
+
+    bool result = false;
+    CAQueueingStats_t stats;
+    if (!g_queueingThreadInitialized)
+    {
+        EDGE_LOG(TAG, "Queues are not initialized");
+        goto EXIT;
+    }
+
+    // reset is done for both queues even if only one copy is requested
+#ifndef ENABLE_SEND_LANES
+    if (CA_STATUS_OK != CAQueueingThreadGetStats(&g_sendThread, &stats, reset))
+#else
+    if (CA_STATUS_OK != CAQueueingLanesGetStats(&g_sendLanes, &stats, reset))
+#endif
+    {
+        EDGE_LOG(TAG, "Failed to get statistics of send queue");
+        goto EXIT;
+    }
+    if (sendStats)
+    {
+        copyQueueStats(sendStats, &stats);
+    }
+
+    if (CA_STATUS_OK != CAQueueingThreadGetStats(&g_receiveThread, &stats, reset))
+    {
+        EDGE_LOG(TAG, "Failed to get statistics of receive queue");
+        goto EXIT;
+    }
+    if (recvStats)
+    {
+        copyQueueStats(recvStats, &stats);
+    }
+    result = true;
+
+EXIT:
+    ret = pthread_mutex_unlock(&g_queueingThreadMutex);
+    if(ret != 0)
+    {
+        EDGE_LOG_V(TAG, "Failed to unlock the queueing thread mutex. "
+            "pthread_mutex_unlock() returned (%d)\n.", ret);
+        exit(ret);
+    }
+    return result;
+}
+
+void set_inline_reports(bool enable)
+{
+    g_inlineReports = enable;
+}
+
+bool is_inline_reports_enabled()
+{
+    return g_inlineReports;
+}
+
+void set_batched_reports(bool enable)
+{
+    g_batchedReports = enable;
+}
+
+bool is_batched_reports_enabled()
+{
+    return g_batchedReports;
+}
+
+bool deliver_inline(EdgeMessage *msg)
+{
+    VERIFY_NON_NULL_MSG(msg, "msg is NULL.", false);
+    if (NULL == g_responseCallback)
+    {
+        EDGE_LOG(TAG, "No response callback registered for inline delivery");
+        return false;
+    }
+
+    record_report_latency(msg);
+    EDGE_TRACE_BEGIN(msg, EDGE_TRACE_STAGE_CALLBACK);
+    g_responseCallback(msg);
+    EDGE_TRACE_END(msg, EDGE_TRACE_STAGE_CALLBACK);
+    return true;
+}
+
 void registerMQCallback(response_cb_t resCallback, send_cb_t sendCallback)
 {
     g_responseCallback = resCallback;
@@ -222,6 +990,19 @@ static void destroyData(void *data, uint32_t size)
 
     EdgeMessage *msg = (EdgeMessage *) data;
     VERIFY_NON_NULL_NR_MSG(msg, "msg is NULL.");
+    if (REPORT == msg->type && NULL != g_reportSpool
+            && g_spoolThreshold / 2 == __atomic_sub_fetch(&g_queuedReports, 1, __ATOMIC_RELAXED))
+    {
+        // the queue has drained far enough to replay the spool
+        oc_cond_signal(g_spoolCond);
+    }
+    EdgeMessageBlock *block = EDGE_MESSAGE_BLOCK(msg);
+    if ((SEND_REQUEST == msg->type || SEND_REQUESTS == msg->type) && !block->asyncDrain
+            && !block->reconnectProbe && !block->coalesceFlush)
+    {
+        // The request is executed or dropped, its future is completed unless it is still held
+        finishRequestFuture(msg->message_id);
+    }
     freeEdgeMessage(msg);
     EDGE_LOG(TAG, "destroyData OUT");
 }
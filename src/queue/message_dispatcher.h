@@ -29,24 +29,25 @@
 
 #include "opcua_common.h"
 #include "command_adapter.h"
+#include "opcua_interface.h"
 
 #include <stdbool.h>
 
 /**
  * @brief Add the EdgeMessage data to receiver Queue to send it to application
- * @param[in]  msg EdgeMessage data
+ * @param[in]  msg EdgeMessage data, owned by the queue from now on
  * @return @c true on success, false on failure
- * @retval #true Successful (Queue is empty)
- * @retval #false Failure (Queue is not empty)
+ * @retval #true Successful (Message is queued)
+ * @retval #false Failure (Queue is full or not initialized, msg is freed)
  */
 bool add_to_recvQ(EdgeMessage *msg);
 
 /**
  * @brief Add the EdgeMessage data to send Queue to send it to server for processing
- * @param[in]  msg EdgeMessage data
+ * @param[in]  msg EdgeMessage data, owned by the queue from now on
  * @return @c true on success, false on failure
- * @retval #true Successful (Queue is empty)
- * @retval #false Failure (Queue is not empty)
+ * @retval #true Successful (Message is queued)
+ * @retval #false Failure (Queue is full or not initialized, msg is freed)
  */
 bool add_to_sendQ(EdgeMessage *msg);
 
@@ -61,6 +62,65 @@ void delete_queue();
  */
 void init_queue();
 
+/**
+ * @brief Sets the capacity and overflow policy of the send and receiver queue
+ * @param[in]  sendConfig Send queue configuration, NULL keeps the current one
+ * @param[in]  recvConfig Receiver queue configuration, NULL keeps the current one
+ * @remarks Queues which are running already take the new bounds at once, report
+ *          conflation and the report spool are applied the next time the queues are
+ *          initialized.
+ *          A bounded or conflating queue always uses the locked queue backend.
+ */
+void set_queue_config(const EdgeQueueConfig *sendConfig, const EdgeQueueConfig *recvConfig);
+
+/**
+ * @brief Gets the statistics of the send and receiver queue
+ * @param[out] sendStats Send queue statistics, can be NULL
+ * @param[out] recvStats Receiver queue statistics, can be NULL
+ * @param[in]  reset true to reset the counters after the copy
+ * @return @c true on success, false if the queues are not initialized
+ */
+bool get_queue_stats(EdgeQueueStats *sendStats, EdgeQueueStats *recvStats, bool reset);
+
+/**
+ * @brief Enables inline delivery of REPORT messages
+ * @param[in]  enable true to deliver reports on the producer thread
+ */
+void set_inline_reports(bool enable);
+
+/**
+ * @brief Checks whether REPORT messages are delivered inline
+ * @return @c true if reports bypass the receiver queue
+ */
+bool is_inline_reports_enabled();
+
+/**
+ * @brief Enables batching of the REPORT messages of one publish response
+ * @param[in]  enable true to receive the notifications of a subscription in one REPORT message
+ */
+void set_batched_reports(bool enable);
+
+/**
+ * @brief Checks whether REPORT messages are batched
+ * @return @c true if the notifications of a publish response share a REPORT message
+ */
+bool is_batched_reports_enabled();
+
+/**
+ * @brief Spreads the requests of an endpoint which any of its sessions can execute over
+ *        several send lanes, see ENABLE_SEND_LANES
+ * @param[in]  endpoint Endpoint Uri of the requests
+ * @param[in]  count Number of lanes, 1 keeps all requests of the endpoint in one lane
+ */
+void set_request_lanes(const char *endpoint, size_t count);
+
+/**
+ * @brief Delivers the EdgeMessage to the response callback on the calling thread
+ * @param[in]  msg EdgeMessage data, still owned by the caller after return
+ * @return @c true on success, false if no response callback is registered
+ */
+bool deliver_inline(EdgeMessage *msg);
+
 /**
  * @brief Registers the callback for response and message handling
  * @param[in]  resCallback Callback for handling response message
@@ -138,6 +138,25 @@ OCThreadResult_t oc_thread_wait(oc_thread t)
     return res;
 }
 
+OCThreadResult_t oc_thread_detach(oc_thread t)
+{
+    oc_thread_internal *threadInfo = (oc_thread_internal*) t;
+    if (NULL == threadInfo)
+    {
+        EDGE_LOG_V(TAG, "%s Invalid thread !", __func__);
+        return OC_THREAD_INVALID_PARAMETER;
+    }
+
+    int detachres = pthread_detach(threadInfo->thread);
+    if (0 != detachres)
+    {
+        EDGE_LOG_V(TAG, "Failed to detach thread with error %d", detachres);
+        return OC_THREAD_WAIT_FAILURE;
+    }
+
+    return OC_THREAD_SUCCESS;
+}
+
 oc_mutex oc_mutex_new(void)
 {
     oc_mutex retVal = NULL;
@@ -431,3 +450,8 @@ OCWaitResult_t oc_cond_wait_for(oc_cond cond, oc_mutex mutex, uint64_t microseco
     return retVal;
 }
 
+uint64_t oc_get_time_us(void)
+{
+    struct timespec ts = oc_get_current_time();
+    return (uint64_t) ts.tv_sec * USECS_PER_SEC + (uint64_t) ts.tv_nsec / NANOSECS_PER_USECS;
+}
@@ -97,6 +97,17 @@ OCThreadResult_t oc_thread_free(oc_thread t);
  */
 OCThreadResult_t oc_thread_wait(oc_thread t);
 
+/**
+ * Detach a thread so its resources are released when it exits, without being waited on
+ * @param[in] t The thread to be detached
+ * @return OCThreadResult_t An enumeration of possible outcomes
+ * @retval OC_THREAD_SUCCESS If the thread was successfully detached
+ * @retval OC_THREAD_INVALID_PARAMETER If param t is NULL
+ * @retval OC_THREAD_WAIT_FAILURE If the thread could not be detached
+ *
+ */
+OCThreadResult_t oc_thread_detach(oc_thread t);
+
 /**
  * Creates new mutex.
  *
@@ -190,6 +201,14 @@ OCWaitResult_t oc_cond_wait_for(oc_cond cond, oc_mutex mutex, uint64_t microseco
  */
 void oc_cond_free(oc_cond cond);
 
+/**
+ * Monotonic time, used to measure intervals.
+ *
+ * @return current monotonic time in microseconds.
+ *
+ */
+uint64_t oc_get_time_us(void);
+
 #ifdef __cplusplus
 } /* extern "C" */
 #endif /* __cplusplus */
@@ -0,0 +1,177 @@
+/******************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ *
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************/
+
+#include "report_latency.h"
+#include "edge_hash_map.h"
+#include "edge_utils.h"
+#include "edge_malloc.h"
+#include "edge_logger.h"
+
+#include <string.h>
+#ifndef _WIN32
+#include <pthread.h>
+#include <sys/time.h>
+#else
+#include "pthread.h"
+#endif
+
+#define TAG "report_latency"
+
+static pthread_mutex_t g_latencyMutex = PTHREAD_MUTEX_INITIALIZER;
+
+// message_id + 1 of the subscription to its EdgeReportLatency
+static EdgeHashMap *g_latencyMap = NULL;
+
+static bool g_latencyEnabled = false;
+
+int64_t get_report_time_us()
+{
+    struct timeval tv;
+#ifndef _WIN32
+    gettimeofday(&tv, NULL);
+#else
+    getTimeofDay(&tv, NULL);
+#endif
+    return (int64_t) tv.tv_sec * 1000000 + tv.tv_usec;
+}
+
+void set_report_latency(bool enable)
+{
+    g_latencyEnabled = enable;
+}
+
+bool is_report_latency_enabled()
+{
+    return g_latencyEnabled;
+}
+
+static void recordStage(EdgeLatencyHistogram *stage, int64_t from, int64_t to)
+{
+    if (0 == from || 0 == to)
+    {
+        // One of the timestamps is unknown
+        return;
+    }
+
+    uint64_t latency = (to > from) ? (uint64_t) (to - from) : 0;
+    stage->count++;
+    stage->totalUs += latency;
+    if (latency > stage->maxUs)
+    {
+        stage->maxUs = latency;
+    }
+
+    uint32_t bucket = 0;
+    uint64_t limit = 10;
+    while (bucket < EDGE_LATENCY_BUCKETS - 1 && latency >= limit)
+    {
+        bucket++;
+        limit *= 10;
+    }
+    stage->histogram[bucket]++;
+}
+
+static EdgeReportLatency *getLatency(uint32_t messageId)
+{
+    keyValue key = (keyValue) ((uintptr_t) messageId + 1);
+    EdgeReportLatency *latency = (EdgeReportLatency *) getEdgeHashMapElement(g_latencyMap, key);
+    if (IS_NOT_NULL(latency))
+    {
+        return latency;
+    }
+
+    if (IS_NULL(g_latencyMap))
+    {
+        g_latencyMap = createEdgeHashMap(EDGE_HASH_POINTER_KEY);
+        VERIFY_NON_NULL_MSG(g_latencyMap, "createEdgeHashMap FAILED in getLatency\n", NULL);
+    }
+    COND_CHECK((getEdgeHashMapSize(g_latencyMap) >= EDGE_LATENCY_MAX_SUBSCRIPTIONS), NULL);
+
+    latency = (EdgeReportLatency *) EdgeCalloc(1, sizeof(EdgeReportLatency));
+    VERIFY_NON_NULL_MSG(latency, "EdgeCalloc FAILED in getLatency\n", NULL);
+    if (!insertEdgeHashMapElement(g_latencyMap, key, (keyValue) latency))
+    {
+        EdgeFree(latency);
+        return NULL;
+    }
+    return latency;
+}
+
+void record_report_latency(const EdgeMessage *msg)
+{
+    if (!g_latencyEnabled || IS_NULL(msg) || REPORT != msg->type || IS_NULL(msg->responses))
+    {
+        return;
+    }
+
+    int64_t now = get_report_time_us();
+    pthread_mutex_lock(&g_latencyMutex);
+    EdgeReportLatency *latency = getLatency(msg->message_id);
+    if (IS_NOT_NULL(latency))
+    {
+        for (size_t i = 0; i < msg->responseLength; i++)
+        {
+            const EdgeResponse *response = msg->responses[i];
+            if (IS_NULL(response))
+            {
+                continue;
+            }
+            recordStage(&latency->stages[EDGE_LATENCY_SERVER], response->sourceTimestamp,
+                    response->serverTimestamp);
+            recordStage(&latency->stages[EDGE_LATENCY_NETWORK], response->serverTimestamp,
+                    response->receiveTimestamp);
+            recordStage(&latency->stages[EDGE_LATENCY_DISPATCH], response->receiveTimestamp, now);
+            recordStage(&latency->stages[EDGE_LATENCY_TOTAL], response->sourceTimestamp, now);
+        }
+    }
+    pthread_mutex_unlock(&g_latencyMutex);
+}
+
+bool get_report_latency(uint32_t messageId, EdgeReportLatency *latency)
+{
+    VERIFY_NON_NULL_MSG(latency, "NULL latency param in get_report_latency\n", false);
+
+    pthread_mutex_lock(&g_latencyMutex);
+    EdgeReportLatency *recorded = (EdgeReportLatency *) getEdgeHashMapElement(g_latencyMap,
+            (keyValue) ((uintptr_t) messageId + 1));
+    if (IS_NOT_NULL(recorded))
+    {
+        memcpy(latency, recorded, sizeof(EdgeReportLatency));
+    }
+    pthread_mutex_unlock(&g_latencyMutex);
+    return IS_NOT_NULL(recorded);
+}
+
+void reset_report_latency()
+{
+    pthread_mutex_lock(&g_latencyMutex);
+    if (IS_NOT_NULL(g_latencyMap))
+    {
+        size_t cursor = 0;
+        keyValue value = NULL;
+        while (getNextEdgeHashMapElement(g_latencyMap, &cursor, NULL, &value))
+        {
+            EdgeFree(value);
+        }
+        deleteEdgeHashMap(g_latencyMap);
+        g_latencyMap = NULL;
+    }
+    pthread_mutex_unlock(&g_latencyMutex);
+}
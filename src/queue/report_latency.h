@@ -0,0 +1,89 @@
+/******************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ *
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************/
+
+/**
+ * @file report_latency.h
+ *
+ * @brief This file contains the notification latency statistics of the subscriptions
+ */
+
+#ifndef EDGE_REPORT_LATENCY_H
+#define EDGE_REPORT_LATENCY_H
+
+#include "opcua_common.h"
+#include "opcua_interface.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/**
+ * @brief Maximum number of subscriptions whose latency is recorded at once.
+ * Reports of further subscriptions are not recorded until reset_report_latency() is called.
+ */
+#define EDGE_LATENCY_MAX_SUBSCRIPTIONS (256)
+
+/**
+ * @brief Gets the wall clock time which the latencies of the reports are measured with
+ * @return Microseconds since the Unix epoch
+ */
+int64_t get_report_time_us();
+
+/**
+ * @brief Enables recording of the report latencies
+ * @param[in]  enable true to record the latency of each notification handed to the application
+ */
+void set_report_latency(bool enable);
+
+/**
+ * @brief Checks whether report latencies are recorded
+ * @return @c true if they are recorded
+ */
+bool is_report_latency_enabled();
+
+/**
+ * @brief Records the latencies of the responses of a REPORT message which is handed to
+ *        the application now. Other messages are ignored.
+ * @param[in]  msg EdgeMessage which is delivered
+ */
+void record_report_latency(const EdgeMessage *msg);
+
+/**
+ * @brief Copies the latencies of a subscription
+ * @param[in]  messageId message_id of the REPORT messages of the subscription
+ * @param[out] latency Latencies of the subscription
+ * @return @c true on success, @c false if no report of the subscription was recorded
+ */
+bool get_report_latency(uint32_t messageId, EdgeReportLatency *latency);
+
+/**
+ * @brief Discards the latencies of all subscriptions
+ */
+void reset_report_latency();
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* EDGE_REPORT_LATENCY_H */
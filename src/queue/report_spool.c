@@ -0,0 +1,613 @@
+/******************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ *
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************/
+
+
+#include "report_spool.h"
+#include "cmd_util.h"
+#include "edge_open62541.h"
+#include "edge_uadp.h"
+#include "edge_hash_map.h"
+#include "edge_utils.h"
+#include "edge_malloc.h"
+#include "edge_logger.h"
+
+#include <string.h>
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+#define TAG "report_spool"
+
+#define SPOOL_MAGIC (0x4C505345u) /* "ESPL" */
+#define SPOOL_VERSION (1)
+#define SPOOL_HEADER_SIZE (64)
+#define SPOOL_MIN_BYTES (4096)
+
+/* Written at the end of the ring when the next record does not fit before the end */
+#define SPOOL_WRAP_MARKER (0xFFFFFFFFu)
+
+/* Length of a NULL string */
+#define SPOOL_NULL_STRING (0xFFFFFFFFu)
+
+/* Records start on 8 byte boundaries, so a wrap marker always fits */
+#define SPOOL_RECORD_SIZE(length) ((((uint64_t) (length)) + 4 + 7) & ~((uint64_t) 7))
+
+#define SPOOL_SCRATCH_SIZE (1024)
+
+/* Header at the start of the file, offsets are relative to the ring which follows it.
+ * The ring holds [head, tail) when tail > head, else [head, end) and [0, tail). */
+typedef struct SpoolHeader
+{
+    uint32_t magic;
+    uint32_t version;
+    uint64_t dataSize;
+    uint64_t head;
+    uint64_t tail;
+    uint64_t count;
+} SpoolHeader;
+
+struct EdgeReportSpool
+{
+    int fd;
+    uint8_t *base;
+    uint64_t mapSize;
+    SpoolHeader *header;
+    uint8_t *data;
+
+    /* Record which is being encoded */
+    uint8_t *scratch;
+    size_t scratchSize;
+    size_t scratchLength;
+
+    /* Endpoint URI -> shared EdgeEndPointInfo of the spooled reports */
+    EdgeHashMap *endpoints;
+};
+
+/* Cursor over a record which is being decoded */
+typedef struct SpoolReader
+{
+    const uint8_t *pos;
+    const uint8_t *end;
+} SpoolReader;
+
+static bool reserveScratch(EdgeReportSpool *spool, size_t size)
+{
+    if (spool->scratchLength + size <= spool->scratchSize)
+    {
+        return true;
+    }
+    size_t newSize = spool->scratchSize * 2;
+    while (newSize < spool->scratchLength + size)
+    {
+        newSize *= 2;
+    }
+    COND_CHECK((newSize > spool->header->dataSize), false);
+    uint8_t *scratch = (uint8_t *) EdgeRealloc(spool->scratch, newSize);
+    VERIFY_NON_NULL_MSG(scratch, "EdgeRealloc FAILED for the spool record\n", false);
+    spool->scratch = scratch;
+    spool->scratchSize = newSize;
+    return true;
+}
+
+static bool putBytes(EdgeReportSpool *spool, const void *value, size_t size)
+{
+    COND_CHECK((!reserveScratch(spool, size)), false);
+    memcpy(spool->scratch + spool->scratchLength, value, size);
+    spool->scratchLength += size;
+    return true;
+}
+
+static bool putUInt32(EdgeReportSpool *spool, uint32_t value)
+{
+    return putBytes(spool, &value, sizeof(value));
+}
+
+static bool putInt64(EdgeReportSpool *spool, int64_t value)
+{
+    return putBytes(spool, &value, sizeof(value));
+}
+
+static bool putString(EdgeReportSpool *spool, const char *str)
+{
+    if (IS_NULL(str))
+    {
+        return putUInt32(spool, SPOOL_NULL_STRING);
+    }
+    size_t length = strlen(str);
+    return putUInt32(spool, (uint32_t) length) && putBytes(spool, str, length);
+}
+
+/* The variant is written after its length, the scratch grows until the encoding fits */
+static bool putVariant(EdgeReportSpool *spool, const UA_Variant *value)
+{
+    size_t lengthPos = spool->scratchLength;
+    COND_CHECK((!putUInt32(spool, 0)), false);
+    for (;;)
+    {
+        size_t length = encodeUadpVariant(value, spool->scratch + spool->scratchLength,
+                spool->scratchSize - spool->scratchLength);
+        if (length > 0)
+        {
+            uint32_t encoded = (uint32_t) length;
+            memcpy(spool->scratch + lengthPos, &encoded, sizeof(encoded));
+            spool->scratchLength += length;
+            return true;
+        }
+        COND_CHECK((!reserveScratch(spool, spool->scratchSize - spool->scratchLength + 1)), false);
+    }
+}
+
+static bool getBytes(SpoolReader *reader, void *value, size_t size)
+{
+    COND_CHECK(((size_t) (reader->end - reader->pos) < size), false);
+    memcpy(value, reader->pos, size);
+    reader->pos += size;
+    return true;
+}
+
+static bool getUInt32(SpoolReader *reader, uint32_t *value)
+{
+    return getBytes(reader, value, sizeof(*value));
+}
+
+static bool getInt64(SpoolReader *reader, int64_t *value)
+{
+    return getBytes(reader, value, sizeof(*value));
+}
+
+static bool getString(SpoolReader *reader, char **str)
+{
+    uint32_t length = 0;
+    COND_CHECK((!getUInt32(reader, &length)), false);
+    *str = NULL;
+    COND_CHECK((SPOOL_NULL_STRING == length), true);
+    COND_CHECK(((size_t) (reader->end - reader->pos) < length), false);
+    *str = (char *) EdgeMalloc(length + 1);
+    VERIFY_NON_NULL_MSG(*str, "EdgeMalloc FAILED for a spooled string\n", false);
+    memcpy(*str, reader->pos, length);
+    (*str)[length] = '\0';
+    reader->pos += length;
+    return true;
+}
+
+static bool getVariant(SpoolReader *reader, UA_Variant *value)
+{
+    uint32_t length = 0;
+    COND_CHECK((!getUInt32(reader, &length)), false);
+    COND_CHECK(((size_t) (reader->end - reader->pos) < length), false);
+    COND_CHECK((UA_STATUSCODE_GOOD != decodeUadpVariant(reader->pos, length, value)), false);
+    reader->pos += length;
+    return true;
+}
+
+/**
+ * @brief getResponseVariant - Gets the value of a response as variant
+ * @param response - Response of the report
+ * @param value - Receives the value, empty if the response has none
+ * @param copied - Set if the variant owns a copy of the value
+ * @return true on success, false if the value can not be spooled
+ */
+static bool getResponseVariant(const EdgeResponse *response, UA_Variant *value, bool *copied)
+{
+    UA_Variant_init(value);
+    *copied = false;
+    const EdgeVersatility *versatility = response->message;
+    COND_CHECK((IS_NULL(versatility) || IS_NULL(versatility->value)), true);
+
+    /* The response type is the UA_TYPES index plus one */
+    int typeIndex = response->type - 1;
+    COND_CHECK((typeIndex < 0 || typeIndex >= UA_TYPES_COUNT
+            || !isUadpVariantType(&UA_TYPES[typeIndex])), false);
+    int length = (int) versatility->arrayLength;
+    if (UA_STATUSCODE_GOOD == createBorrowedVariant(typeIndex, versatility->value,
+            versatility->isArray, length, value))
+    {
+        return true;
+    }
+    *copied = true;
+    UA_StatusCode ret = versatility->isArray ?
+            createArrayVariant(typeIndex, versatility->value, length, value) :
+            createScalarVariant(typeIndex, versatility->value, value);
+    return UA_STATUSCODE_GOOD == ret;
+}
+
+static bool encodeResponse(EdgeReportSpool *spool, const EdgeResponse *response)
+{
+    UA_Variant value;
+    bool copied = false;
+    if (!getResponseVariant(response, &value, &copied))
+    {
+        EDGE_LOG_V(TAG, "Value of type %d can not be spooled\n", response->type);
+        return false;
+    }
+    bool encoded = putString(spool, IS_NOT_NULL(response->nodeInfo) ?
+                    response->nodeInfo->valueAlias : NULL)
+            && putInt64(spool, response->sourceTimestamp)
+            && putInt64(spool, response->serverTimestamp)
+            && putInt64(spool, response->receiveTimestamp)
+            && putVariant(spool, &value);
+    if (copied)
+    {
+        UA_Variant_deleteMembers(&value);
+    }
+    return encoded;
+}
+
+static bool encodeReport(EdgeReportSpool *spool, const EdgeMessage *msg)
+{
+    spool->scratchLength = 0;
+    bool encoded = putUInt32(spool, msg->message_id)
+            && putUInt32(spool, (uint32_t) msg->command)
+            && putInt64(spool, (int64_t) msg->serverTime.tv.tv_sec)
+            && putInt64(spool, (int64_t) msg->serverTime.tv.tv_usec)
+            && putString(spool, IS_NOT_NULL(msg->endpointInfo) ?
+                    msg->endpointInfo->endpointUri : NULL)
+            && putUInt32(spool, (uint32_t) msg->responseLength);
+    for (size_t i = 0; encoded && i < msg->responseLength; i++)
+    {
+        COND_CHECK((IS_NULL(msg->responses) || IS_NULL(msg->responses[i])), false);
+        encoded = encodeResponse(spool, msg->responses[i]);
+    }
+    return encoded;
+}
+
+static EdgeResponse *decodeResponse(SpoolReader *reader)
+{
+    EdgeResponse *response = (EdgeResponse *) EdgeCalloc(1, sizeof(EdgeResponse));
+    VERIFY_NON_NULL_MSG(response, "EdgeCalloc FAILED for a spooled response\n", NULL);
+    response->nodeInfo = (EdgeNodeInfo *) EdgeCalloc(1, sizeof(EdgeNodeInfo));
+    UA_Variant value;
+    UA_Variant_init(&value);
+    if (IS_NULL(response->nodeInfo) || !getString(reader, &response->nodeInfo->valueAlias)
+            || !getInt64(reader, &response->sourceTimestamp)
+            || !getInt64(reader, &response->serverTimestamp)
+            || !getInt64(reader, &response->receiveTimestamp)
+            || !getVariant(reader, &value))
+    {
+        freeEdgeResponse(response);
+        return NULL;
+    }
+    if (IS_NOT_NULL(value.type))
+    {
+        response->message = takeResponse(response, &value);
+    }
+    UA_Variant_deleteMembers(&value);
+    return response;
+}
+
+/**
+ * @brief getSpooledEndpoint - Gets the shared endpoint of a spooled report, the one of the
+ * spooled reports if it is known, otherwise an endpoint with the URI only
+ * @param spool - Spool
+ * @param endpointUri - URI of the endpoint, taken by the function
+ * @return Shared endpoint on success, NULL on failure
+ */
+static EdgeEndPointInfo *getSpooledEndpoint(EdgeReportSpool *spool, char *endpointUri)
+{
+    EdgeEndPointInfo *known = (EdgeEndPointInfo *) getEdgeHashMapElement(spool->endpoints,
+            (keyValue) endpointUri);
+    if (IS_NOT_NULL(known))
+    {
+        EdgeFree(endpointUri);
+        return retainEdgeEndpointInfo(known);
+    }
+    EdgeEndPointInfo endpointInfo;
+    memset(&endpointInfo, 0, sizeof(EdgeEndPointInfo));
+    endpointInfo.endpointUri = endpointUri;
+    EdgeEndPointInfo *shared = shareEdgeEndpointInfo(&endpointInfo);
+    EdgeFree(endpointUri);
+    return shared;
+}
+
+static EdgeMessage *decodeReport(EdgeReportSpool *spool, SpoolReader *reader)
+{
+    EdgeMessage *msg = allocEdgeMessage();
+    VERIFY_NON_NULL_MSG(msg, "EdgeCalloc FAILED for a spooled report\n", NULL);
+    msg->type = REPORT;
+
+    uint32_t command = 0, responseLength = 0;
+    int64_t sec = 0, usec = 0;
+    char *endpointUri = NULL;
+    if (!getUInt32(reader, &msg->message_id) || !getUInt32(reader, &command)
+            || !getInt64(reader, &sec) || !getInt64(reader, &usec)
+            || !getString(reader, &endpointUri) || !getUInt32(reader, &responseLength)
+            || responseLength > (size_t) (reader->end - reader->pos))
+    {
+        EdgeFree(endpointUri);
+        freeEdgeMessage(msg);
+        return NULL;
+    }
+    msg->command = (EdgeCommand) command;
+    if (IS_NOT_NULL(endpointUri))
+    {
+        setMessageEndpointInfo(msg, getSpooledEndpoint(spool, endpointUri));
+        if (IS_NULL(msg->endpointInfo))
+        {
+            freeEdgeMessage(msg);
+            return NULL;
+        }
+    }
+
+    /* The server time is the one of the report, the monotonic time the one it is taken */
+    setEdgeTimeInfo(&msg->serverTime);
+    msg->serverTime.tv.tv_sec = (time_t) sec;
+    msg->serverTime.tv.tv_usec = (suseconds_t) usec;
+    if (IS_NOT_NULL(msg->serverTime.timeInfo))
+    {
+        time_t rawtime = (time_t) sec;
+#ifndef _WIN32
+        localtime_r(&rawtime, &msg->serverTime.localTime);
+#else
+        localtime_s(&msg->serverTime.localTime, &rawtime);
+#endif
+    }
+
+    if (responseLength > 0)
+    {
+        msg->responses = (EdgeResponse **) EdgeCalloc(responseLength, sizeof(EdgeResponse *));
+        if (IS_NULL(msg->responses))
+        {
+            EDGE_LOG(TAG, "EdgeCalloc FAILED for spooled responses\n");
+            freeEdgeMessage(msg);
+            return NULL;
+        }
+    }
+    for (; msg->responseLength < responseLength; msg->responseLength++)
+    {
+        msg->responses[msg->responseLength] = decodeResponse(reader);
+        if (IS_NULL(msg->responses[msg->responseLength]))
+        {
+            freeEdgeMessage(msg);
+            return NULL;
+        }
+    }
+    return msg;
+}
+
+/* Remembers the endpoint of a spooled report, so the report is taken with the same endpoint */
+static void rememberEndpoint(EdgeReportSpool *spool, EdgeEndPointInfo *endpointInfo)
+{
+    if (IS_NULL(endpointInfo) || IS_NULL(endpointInfo->endpointUri)
+            || IS_NOT_NULL(getEdgeHashMapElement(spool->endpoints,
+                    (keyValue) endpointInfo->endpointUri)))
+    {
+        return;
+    }
+    EdgeEndPointInfo *shared = shareEdgeEndpointInfo(endpointInfo);
+    char *key = IS_NOT_NULL(shared) ? cloneString(shared->endpointUri) : NULL;
+    if (IS_NULL(key) || !insertEdgeHashMapElement(spool->endpoints, (keyValue) key,
+            (keyValue) shared))
+    {
+        EdgeFree(key);
+        if (IS_NOT_NULL(shared))
+        {
+            releaseEdgeEndpointInfo(shared);
+        }
+    }
+}
+
+static void resetSpool(EdgeReportSpool *spool)
+{
+    spool->header->head = 0;
+    spool->header->tail = 0;
+    spool->header->count = 0;
+}
+
+static uint32_t readRecordLength(const EdgeReportSpool *spool, uint64_t offset)
+{
+    uint32_t length = 0;
+    memcpy(&length, spool->data + offset, sizeof(length));
+    return length;
+}
+
+/* Gets the offset of the next record at or after offset, where the ring may wrap */
+static uint64_t getRecordOffset(const EdgeReportSpool *spool, uint64_t offset)
+{
+    if (offset == spool->header->dataSize || SPOOL_WRAP_MARKER == readRecordLength(spool, offset))
+    {
+        return 0;
+    }
+    return offset;
+}
+
+static bool writeRecord(EdgeReportSpool *spool, const uint8_t *payload, uint32_t length)
+{
+    SpoolHeader *header = spool->header;
+    uint64_t size = SPOOL_RECORD_SIZE(length);
+    COND_CHECK((0 < header->count && header->tail == header->head), false);
+
+    uint64_t offset = header->tail;
+    if (header->tail >= header->head && size > header->dataSize - header->tail)
+    {
+        /* Wraps to the start, which must not reach the head */
+        COND_CHECK((size > header->head), false);
+        if (header->tail < header->dataSize)
+        {
+            uint32_t marker = SPOOL_WRAP_MARKER;
+            memcpy(spool->data + header->tail, &marker, sizeof(marker));
+        }
+        offset = 0;
+    }
+    else if (header->tail < header->head && size > header->head - header->tail)
+    {
+        return false;
+    }
+
+    memcpy(spool->data + offset, &length, sizeof(length));
+    memcpy(spool->data + offset + sizeof(length), payload, length);
+    /* The header is updated after the record, a record is complete once it is counted */
+    header->tail = offset + size;
+    header->count++;
+    return true;
+}
+
+EdgeReportSpool *openReportSpool(const char *path, uint64_t maxBytes)
+{
+    VERIFY_NON_NULL_MSG(path, "NULL path param in openReportSpool\n", NULL);
+#ifdef _WIN32
+    EDGE_LOG(TAG, "The report spool is not supported on this platform\n");
+    return NULL;
+#else
+    uint64_t mapSize = (0 == maxBytes) ? EDGE_REPORT_SPOOL_DEFAULT_BYTES : maxBytes;
+    mapSize = (mapSize < SPOOL_MIN_BYTES) ? SPOOL_MIN_BYTES : (mapSize & ~((uint64_t) 7));
+
+    EdgeReportSpool *spool = (EdgeReportSpool *) EdgeCalloc(1, sizeof(EdgeReportSpool));
+    VERIFY_NON_NULL_MSG(spool, "EdgeCalloc FAILED for EdgeReportSpool\n", NULL);
+    spool->fd = -1;
+    spool->scratchSize = SPOOL_SCRATCH_SIZE;
+    spool->scratch = (uint8_t *) EdgeMalloc(spool->scratchSize);
+    spool->endpoints = createEdgeHashMap(EDGE_HASH_STRING_KEY);
+    if (IS_NULL(spool->scratch) || IS_NULL(spool->endpoints))
+    {
+        EDGE_LOG(TAG, "Memory allocation failed for the report spool\n");
+        goto ERROR;
+    }
+
+    spool->fd = open(path, O_RDWR | O_CREAT | O_CLOEXEC, 0600);
+    struct stat st;
+    if (spool->fd < 0 || 0 != fstat(spool->fd, &st))
+    {
+        EDGE_LOG_V(TAG, "Failed to open the report spool %s\n", path);
+        goto ERROR;
+    }
+    bool sameSize = ((uint64_t) st.st_size == mapSize);
+    if (!sameSize && 0 != ftruncate(spool->fd, (off_t) mapSize))
+    {
+        EDGE_LOG_V(TAG, "Failed to size the report spool %s\n", path);
+        goto ERROR;
+    }
+    void *base = mmap(NULL, (size_t) mapSize, PROT_READ | PROT_WRITE, MAP_SHARED, spool->fd, 0);
+    if (MAP_FAILED == base)
+    {
+        EDGE_LOG_V(TAG, "Failed to map the report spool %s\n", path);
+        goto ERROR;
+    }
+    spool->base = (uint8_t *) base;
+    spool->mapSize = mapSize;
+    spool->header = (SpoolHeader *) spool->base;
+    spool->data = spool->base + SPOOL_HEADER_SIZE;
+
+    /* Reports left by the last run are kept if the header is consistent */
+    SpoolHeader *header = spool->header;
+    uint64_t dataSize = mapSize - SPOOL_HEADER_SIZE;
+    if (!sameSize || SPOOL_MAGIC != header->magic || SPOOL_VERSION != header->version
+            || dataSize != header->dataSize || header->head > dataSize || header->tail > dataSize
+            || 0 != (header->head & 7) || 0 != (header->tail & 7))
+    {
+        header->magic = SPOOL_MAGIC;
+        header->version = SPOOL_VERSION;
+        header->dataSize = dataSize;
+        resetSpool(spool);
+    }
+    else if (header->count > 0)
+    {
+        EDGE_LOG_V(TAG, "%llu reports are left in the report spool\n",
+                (unsigned long long) header->count);
+    }
+    return spool;
+
+ERROR:
+    closeReportSpool(spool);
+    return NULL;
+#endif
+}
+
+void closeReportSpool(EdgeReportSpool *spool)
+{
+    VERIFY_NON_NULL_NR_MSG(spool, "NULL spool param in closeReportSpool\n");
+#ifndef _WIN32
+    if (IS_NOT_NULL(spool->base))
+    {
+        msync(spool->base, (size_t) spool->mapSize, MS_SYNC);
+        munmap(spool->base, (size_t) spool->mapSize);
+    }
+    if (spool->fd >= 0)
+    {
+        close(spool->fd);
+    }
+#endif
+    if (IS_NOT_NULL(spool->endpoints))
+    {
+        size_t cursor = 0;
+        keyValue key = NULL, value = NULL;
+        while (getNextEdgeHashMapElement(spool->endpoints, &cursor, &key, &value))
+        {
+            EdgeFree(key);
+            releaseEdgeEndpointInfo((EdgeEndPointInfo *) value);
+        }
+        deleteEdgeHashMap(spool->endpoints);
+    }
+    EdgeFree(spool->scratch);
+    EdgeFree(spool);
+}
+
+bool appendReportSpool(EdgeReportSpool *spool, const EdgeMessage *msg)
+{
+    VERIFY_NON_NULL_MSG(spool, "NULL spool param in appendReportSpool\n", false);
+    VERIFY_NON_NULL_MSG(msg, "NULL msg param in appendReportSpool\n", false);
+    COND_CHECK((REPORT != msg->type), false);
+    COND_CHECK((!encodeReport(spool, msg)), false);
+    COND_CHECK_MSG((!writeRecord(spool, spool->scratch, (uint32_t) spool->scratchLength)),
+            "The report spool is full\n", false);
+    rememberEndpoint(spool, msg->endpointInfo);
+    return true;
+}
+
+EdgeMessage *takeReportSpool(EdgeReportSpool *spool)
+{
+    VERIFY_NON_NULL_MSG(spool, "NULL spool param in takeReportSpool\n", NULL);
+    SpoolHeader *header = spool->header;
+    while (header->count > 0)
+    {
+        uint64_t offset = getRecordOffset(spool, header->head);
+        uint32_t length = readRecordLength(spool, offset);
+        uint64_t size = SPOOL_RECORD_SIZE(length);
+        if (size > header->dataSize - offset)
+        {
+            EDGE_LOG(TAG, "The report spool is corrupted, its reports are dropped\n");
+            resetSpool(spool);
+            return NULL;
+        }
+
+        SpoolReader reader = { spool->data + offset + sizeof(length),
+                spool->data + offset + sizeof(length) + length };
+        EdgeMessage *msg = decodeReport(spool, &reader);
+        header->head = offset + size;
+        if (0 == --header->count)
+        {
+            resetSpool(spool);
+        }
+        if (IS_NOT_NULL(msg))
+        {
+            return msg;
+        }
+        EDGE_LOG(TAG, "A spooled report could not be decoded and is dropped\n");
+    }
+    return NULL;
+}
+
+uint64_t getReportSpoolCount(const EdgeReportSpool *spool)
+{
+    COND_CHECK((IS_NULL(spool)), 0);
+    return spool->header->count;
+}
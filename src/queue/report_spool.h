@@ -0,0 +1,94 @@
+/******************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ *
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************/
+
+
+/**
+ * @file report_spool.h
+ *
+ * @brief This file contains the spool file which REPORT messages overflow into while the
+ *        receive queue is behind. The file is mapped into memory and used as a ring of records,
+ *        reports are taken from it in the order they were added.
+ */
+
+#ifndef EDGE_REPORT_SPOOL_H
+#define EDGE_REPORT_SPOOL_H
+
+#include "opcua_common.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/**
+ * @brief Size of the spool file if none is configured
+ */
+#define EDGE_REPORT_SPOOL_DEFAULT_BYTES (64 * 1024 * 1024)
+
+typedef struct EdgeReportSpool EdgeReportSpool;
+
+/**
+ * @brief Opens the spool file, it is created if it does not exist. Reports which were left in
+ *        a file of the same size are kept and taken first.
+ *        A spool is not thread safe, the caller serializes its use.
+ * @param[in]  path Path of the file
+ * @param[in]  maxBytes Size of the file, 0 for EDGE_REPORT_SPOOL_DEFAULT_BYTES
+ * @return EdgeReportSpool on success, NULL on failure
+ */
+EdgeReportSpool *openReportSpool(const char *path, uint64_t maxBytes);
+
+/**
+ * @brief Writes the spooled reports to the file and closes it
+ * @param[in]  spool Spool to close, can be NULL
+ */
+void closeReportSpool(EdgeReportSpool *spool);
+
+/**
+ * @brief Adds a copy of a REPORT message to the end of the spool.
+ *        Values of the built-in types Boolean to ByteString are kept, the endpoint is kept by
+ *        its URI.
+ * @param[in]  spool Spool
+ * @param[in]  msg REPORT message, which stays with the caller
+ * @return @c true on success, @c false if the spool is full or a value can not be spooled
+ */
+bool appendReportSpool(EdgeReportSpool *spool, const EdgeMessage *msg);
+
+/**
+ * @brief Takes the oldest report of the spool. Records which can not be decoded are dropped.
+ * @param[in]  spool Spool
+ * @return New REPORT message, NULL if the spool is empty
+ */
+EdgeMessage *takeReportSpool(EdgeReportSpool *spool);
+
+/**
+ * @brief Gets the number of reports in the spool
+ * @param[in]  spool Spool
+ * @return Number of reports
+ */
+uint64_t getReportSpoolCount(const EdgeReportSpool *spool);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* EDGE_REPORT_SPOOL_H */
@@ -0,0 +1,281 @@
+/******************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ *
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************/
+
+
+#include "request_future.h"
+#include "octhread.h"
+#include "edge_hash_map.h"
+#include "edge_utils.h"
+#include "edge_malloc.h"
+#include "edge_logger.h"
+
+#include <string.h>
+#ifndef _WIN32
+#include <pthread.h>
+#else
+#include "pthread.h"
+#endif
+
+#define TAG "request_future"
+
+struct EdgeFuture
+{
+    uint32_t messageId;
+    /* Executions of the request which are not finished */
+    uint32_t pending;
+    /* Whether the future is in g_futureMap */
+    bool registered;
+    EdgeMessage **responses;
+    size_t responseCount;
+    size_t responseCapacity;
+    oc_mutex mutex;
+    oc_cond cond;
+};
+
+static pthread_mutex_t g_futureMutex = PTHREAD_MUTEX_INITIALIZER;
+
+// message_id + 1 of the request to its EdgeFuture
+static EdgeHashMap *g_futureMap = NULL;
+
+// Number of registered futures, responses skip the lookup while it is 0
+static volatile uint32_t g_futureCount = 0;
+
+static keyValue getFutureKey(uint32_t messageId)
+{
+    return (keyValue) ((uintptr_t) messageId + 1);
+}
+
+/* Called with g_futureMutex held */
+static void unregisterFuture(EdgeFuture *future)
+{
+    if (future->registered)
+    {
+        removeEdgeHashMapElement(g_futureMap, getFutureKey(future->messageId), NULL);
+        future->registered = false;
+        __atomic_sub_fetch(&g_futureCount, 1, __ATOMIC_RELEASE);
+        if (0 == getEdgeHashMapSize(g_futureMap))
+        {
+            deleteEdgeHashMap(g_futureMap);
+            g_futureMap = NULL;
+        }
+    }
+}
+
+EdgeFuture *createRequestFuture(uint32_t messageId)
+{
+    EdgeFuture *future = (EdgeFuture *) EdgeCalloc(1, sizeof(EdgeFuture));
+    VERIFY_NON_NULL_MSG(future, "EdgeCalloc FAILED for EdgeFuture\n", NULL);
+    future->messageId = messageId;
+    future->pending = 1;
+    future->mutex = oc_mutex_new();
+    future->cond = oc_cond_new();
+    if (IS_NULL(future->mutex) || IS_NULL(future->cond))
+    {
+        EDGE_LOG(TAG, "Failed to create the condition of the future.");
+        goto ERROR;
+    }
+
+    pthread_mutex_lock(&g_futureMutex);
+    if (IS_NULL(g_futureMap))
+    {
+        g_futureMap = createEdgeHashMap(EDGE_HASH_POINTER_KEY);
+    }
+    if (IS_NULL(g_futureMap)
+            || IS_NOT_NULL(getEdgeHashMapElement(g_futureMap, getFutureKey(messageId)))
+            || !insertEdgeHashMapElement(g_futureMap, getFutureKey(messageId), (keyValue) future))
+    {
+        pthread_mutex_unlock(&g_futureMutex);
+        EDGE_LOG_V(TAG, "Failed to register the future of message %u\n", messageId);
+        goto ERROR;
+    }
+    future->registered = true;
+    __atomic_add_fetch(&g_futureCount, 1, __ATOMIC_RELEASE);
+    pthread_mutex_unlock(&g_futureMutex);
+    return future;
+
+ERROR:
+    if (IS_NOT_NULL(future->cond))
+    {
+        oc_cond_free(future->cond);
+    }
+    if (IS_NOT_NULL(future->mutex))
+    {
+        oc_mutex_free(future->mutex);
+    }
+    EdgeFree(future);
+    return NULL;
+}
+
+bool deliverToRequestFuture(EdgeMessage *msg)
+{
+    if (0 == __atomic_load_n(&g_futureCount, __ATOMIC_ACQUIRE) || IS_NULL(msg)
+            || (GENERAL_RESPONSE != msg->type && BROWSE_RESPONSE != msg->type
+                && ERROR_RESPONSE != msg->type))
+    {
+        return false;
+    }
+
+    bool taken = false;
+    pthread_mutex_lock(&g_futureMutex);
+    EdgeFuture *future = (EdgeFuture *) getEdgeHashMapElement(g_futureMap,
+            getFutureKey(msg->message_id));
+    if (IS_NOT_NULL(future))
+    {
+        oc_mutex_lock(future->mutex);
+        if (future->responseCount == future->responseCapacity)
+        {
+            size_t capacity = (0 == future->responseCapacity) ? 4 : future->responseCapacity * 2;
+            EdgeMessage **responses = (EdgeMessage **) EdgeRealloc(future->responses,
+                    capacity * sizeof(EdgeMessage *));
+            if (IS_NOT_NULL(responses))
+            {
+                future->responses = responses;
+                future->responseCapacity = capacity;
+            }
+        }
+        if (future->responseCount < future->responseCapacity)
+        {
+            future->responses[future->responseCount++] = msg;
+            taken = true;
+        }
+        oc_mutex_unlock(future->mutex);
+    }
+    pthread_mutex_unlock(&g_futureMutex);
+    return taken;
+}
+
+void holdRequestFuture(uint32_t messageId)
+{
+    if (0 == __atomic_load_n(&g_futureCount, __ATOMIC_ACQUIRE))
+    {
+        return;
+    }
+
+    pthread_mutex_lock(&g_futureMutex);
+    EdgeFuture *future = (EdgeFuture *) getEdgeHashMapElement(g_futureMap, getFutureKey(messageId));
+    if (IS_NOT_NULL(future))
+    {
+        oc_mutex_lock(future->mutex);
+        future->pending++;
+        oc_mutex_unlock(future->mutex);
+    }
+    pthread_mutex_unlock(&g_futureMutex);
+}
+
+void finishRequestFuture(uint32_t messageId)
+{
+    if (0 == __atomic_load_n(&g_futureCount, __ATOMIC_ACQUIRE))
+    {
+        return;
+    }
+
+    pthread_mutex_lock(&g_futureMutex);
+    EdgeFuture *future = (EdgeFuture *) getEdgeHashMapElement(g_futureMap, getFutureKey(messageId));
+    if (IS_NOT_NULL(future))
+    {
+        oc_mutex_lock(future->mutex);
+        if (future->pending > 0 && 0 == --future->pending)
+        {
+            unregisterFuture(future);
+            oc_cond_broadcast(future->cond);
+        }
+        oc_mutex_unlock(future->mutex);
+    }
+    pthread_mutex_unlock(&g_futureMutex);
+}
+
+bool waitRequestFuture(EdgeFuture *future, uint32_t timeoutMs)
+{
+    VERIFY_NON_NULL_MSG(future, "future is NULL in waitRequestFuture\n", false);
+    uint64_t deadline = oc_get_time_us() + (uint64_t) timeoutMs * 1000;
+
+    oc_mutex_lock(future->mutex);
+    while (future->pending > 0)
+    {
+        if (0 == timeoutMs)
+        {
+            oc_cond_wait(future->cond, future->mutex);
+            continue;
+        }
+        uint64_t now = oc_get_time_us();
+        if (now >= deadline)
+        {
+            break;
+        }
+        oc_cond_wait_for(future->cond, future->mutex, deadline - now);
+    }
+    bool finished = (0 == future->pending);
+    oc_mutex_unlock(future->mutex);
+    return finished;
+}
+
+size_t getRequestFutureResponseCount(EdgeFuture *future)
+{
+    VERIFY_NON_NULL_MSG(future, "future is NULL in getRequestFutureResponseCount\n", 0);
+    oc_mutex_lock(future->mutex);
+    size_t count = future->responseCount;
+    oc_mutex_unlock(future->mutex);
+    return count;
+}
+
+EdgeMessage *getRequestFutureResponse(EdgeFuture *future, size_t index, bool take)
+{
+    VERIFY_NON_NULL_MSG(future, "future is NULL in getRequestFutureResponse\n", NULL);
+    EdgeMessage *msg = NULL;
+    oc_mutex_lock(future->mutex);
+    if (index < future->responseCount)
+    {
+        msg = future->responses[index];
+        if (take)
+        {
+            future->responses[index] = NULL;
+        }
+    }
+    oc_mutex_unlock(future->mutex);
+    return msg;
+}
+
+void detachRequestFuture(EdgeFuture *future)
+{
+    VERIFY_NON_NULL_NR_MSG(future, "future is NULL in detachRequestFuture\n");
+    pthread_mutex_lock(&g_futureMutex);
+    unregisterFuture(future);
+    pthread_mutex_unlock(&g_futureMutex);
+}
+
+void deleteRequestFuture(EdgeFuture *future)
+{
+    VERIFY_NON_NULL_NR_MSG(future, "future is NULL in deleteRequestFuture\n");
+
+    /* Nothing reaches the future once it is not in the map */
+    detachRequestFuture(future);
+
+    for (size_t i = 0; i < future->responseCount; i++)
+    {
+        if (IS_NOT_NULL(future->responses[i]))
+        {
+            freeEdgeMessage(future->responses[i]);
+        }
+    }
+    EdgeFree(future->responses);
+    oc_cond_free(future->cond);
+    oc_mutex_free(future->mutex);
+    EdgeFree(future);
+}
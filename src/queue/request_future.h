@@ -0,0 +1,116 @@
+/******************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ *
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************/
+
+
+/**
+ * @file request_future.h
+ *
+ * @brief This file contains the futures which wait for the responses of a request
+ */
+
+#ifndef EDGE_REQUEST_FUTURE_H
+#define EDGE_REQUEST_FUTURE_H
+
+#include "opcua_common.h"
+#include "opcua_interface.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/**
+ * @brief Creates the future of a request before the request is queued.
+ *        GENERAL_RESPONSE, BROWSE_RESPONSE and ERROR_RESPONSE messages with the message_id of
+ *        the request are collected by the future instead of the receive queue, until the
+ *        request is finished.
+ * @param[in]  messageId message_id of the request
+ * @return EdgeFuture on success, NULL if the message_id already has a future
+ */
+EdgeFuture *createRequestFuture(uint32_t messageId);
+
+/**
+ * @brief Hands a response message to the future of its request
+ * @param[in]  msg Response message, taken by the future on success
+ * @return @c true if the future took the message, @c false if it goes to the receive queue
+ */
+bool deliverToRequestFuture(EdgeMessage *msg);
+
+/**
+ * @brief Keeps the future of a request pending for one more execution.
+ *        A request is executed once by the send queue and once by each asynchronous service
+ *        call which is sent for it. Each execution ends with finishRequestFuture().
+ * @param[in]  messageId message_id of the request
+ */
+void holdRequestFuture(uint32_t messageId);
+
+/**
+ * @brief Ends one execution of a request. The future is completed after the last one,
+ *        responses which arrive later go to the receive queue.
+ * @param[in]  messageId message_id of the request
+ */
+void finishRequestFuture(uint32_t messageId);
+
+/**
+ * @brief Waits until the request of the future is finished
+ * @param[in]  future EdgeFuture of the request
+ * @param[in]  timeoutMs Milliseconds to wait, 0 waits without a limit
+ * @return @c true if the request is finished, @c false on timeout
+ */
+bool waitRequestFuture(EdgeFuture *future, uint32_t timeoutMs);
+
+/**
+ * @brief Gets the number of response messages collected by the future
+ * @param[in]  future EdgeFuture of the request
+ * @return Number of the collected messages
+ */
+size_t getRequestFutureResponseCount(EdgeFuture *future);
+
+/**
+ * @brief Gets a response message collected by the future
+ * @param[in]  future EdgeFuture of the request
+ * @param[in]  index Index of the message, in the order of arrival
+ * @param[in]  take @c true to take the message from the future, the caller frees it then
+ * @return EdgeMessage, NULL if the index is out of range or the message was taken
+ */
+EdgeMessage *getRequestFutureResponse(EdgeFuture *future, size_t index, bool take);
+
+/**
+ * @brief Removes the future from its request, responses which arrive later go to the
+ *        receive queue. The collected messages stay with the future.
+ * @param[in]  future EdgeFuture of the request
+ */
+void detachRequestFuture(EdgeFuture *future);
+
+/**
+ * @brief Removes the future and frees it with the messages which are not taken.
+ *        Responses of an unfinished request go to the receive queue afterwards.
+ * @param[in]  future EdgeFuture of the request
+ */
+void deleteRequestFuture(EdgeFuture *future);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* EDGE_REQUEST_FUTURE_H */
@@ -0,0 +1,152 @@
+/******************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ *
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************/
+
+#include "umpscqueue.h"
+
+#include <stddef.h>
+#include "edge_logger.h"
+#include "edge_malloc.h"
+
+#if defined(_WIN32) && !defined(__GNUC__)
+#include <windows.h>
+#define MPSC_XCHG_PTR(ptr, val) InterlockedExchangePointer((PVOID volatile *) (ptr), (val))
+#define MPSC_LOAD_PTR(ptr) InterlockedCompareExchangePointer((PVOID volatile *) (ptr), NULL, NULL)
+#define MPSC_STORE_PTR(ptr, val) InterlockedExchangePointer((PVOID volatile *) (ptr), (val))
+#else
+#define MPSC_XCHG_PTR(ptr, val) __atomic_exchange_n((ptr), (val), __ATOMIC_SEQ_CST)
+#define MPSC_LOAD_PTR(ptr) __atomic_load_n((ptr), __ATOMIC_SEQ_CST)
+#define MPSC_STORE_PTR(ptr, val) __atomic_store_n((ptr), (val), __ATOMIC_SEQ_CST)
+#endif
+
+/**
+ * @def TAG
+ * @brief Logging tag for module name
+ */
+#define TAG "UMPSCQUEUE"
+
+u_mpsc_queue_t *u_mpsc_queue_create()
+{
+    u_mpsc_queue_t *queuePtr = (u_mpsc_queue_t *) EdgeMalloc(sizeof(u_mpsc_queue_t));
+    if (NULL == queuePtr)
+    {
+        EDGE_LOG(TAG, "QueueCreate FAIL");
+        return NULL;
+    }
+
+    u_mpsc_queue_node *stub = (u_mpsc_queue_node *) EdgeMalloc(sizeof(u_mpsc_queue_node));
+    if (NULL == stub)
+    {
+        EDGE_LOG(TAG, "QueueCreate FAIL, memory allocation failed");
+        EdgeFree(queuePtr);
+        return NULL;
+    }
+
+    stub->message = NULL;
+    stub->next = NULL;
+    queuePtr->head = stub;
+    queuePtr->tail = stub;
+
+    return queuePtr;
+}
+
+CAResult_t u_mpsc_queue_push(u_mpsc_queue_t *queue, u_queue_message_t *message)
+{
+    if (NULL == queue)
+    {
+        EDGE_LOG(TAG, "QueuePush FAIL, Invalid Queue");
+        return CA_STATUS_FAILED;
+    }
+
+    if (NULL == message)
+    {
+        EDGE_LOG(TAG, "QueuePush : FAIL, NULL Message");
+        return CA_STATUS_FAILED;
+    }
+
+    u_mpsc_queue_node *node = (u_mpsc_queue_node *) EdgeMalloc(sizeof(u_mpsc_queue_node));
+    if (NULL == node)
+    {
+        EDGE_LOG(TAG, "QueuePush FAIL, memory allocation failed");
+        return CA_MEMORY_ALLOC_FAILED;
+    }
+
+    node->message = message;
+    node->next = NULL;
+
+    // publish the node as new tail, then link it behind the previous one
+    u_mpsc_queue_node *prev = (u_mpsc_queue_node *) MPSC_XCHG_PTR(&queue->tail, node);
+    MPSC_STORE_PTR(&prev->next, node);
+
+    return CA_STATUS_OK;
+}
+
+u_queue_message_t *u_mpsc_queue_pop(u_mpsc_queue_t *queue)
+{
+    if (NULL == queue)
+    {
+        EDGE_LOG(TAG, "QueuePop FAIL, Invalid Queue");
+        return NULL;
+    }
+
+    u_mpsc_queue_node *head = queue->head;
+    u_mpsc_queue_node *next = (u_mpsc_queue_node *) MPSC_LOAD_PTR(&head->next);
+    if (NULL == next)
+    {
+        return NULL;
+    }
+
+    // next becomes the new stub, its message is handed to the caller
+    u_queue_message_t *message = next->message;
+    next->message = NULL;
+    queue->head = next;
+    EdgeFree(head);
+
+    return message;
+}
+
+bool u_mpsc_queue_is_empty(u_mpsc_queue_t *queue)
+{
+    if (NULL == queue)
+    {
+        EDGE_LOG(TAG, "QueueIsEmpty FAIL, Invalid Queue");
+        return true;
+    }
+
+    return NULL == MPSC_LOAD_PTR(&queue->head->next);
+}
+
+CAResult_t u_mpsc_queue_delete(u_mpsc_queue_t *queue)
+{
+    if (NULL == queue)
+    {
+        EDGE_LOG(TAG, "QueueDelete FAIL, Invalid Queue");
+        return CA_STATUS_FAILED;
+    }
+
+    u_queue_message_t *message = NULL;
+    while (NULL != (message = u_mpsc_queue_pop(queue)))
+    {
+        EdgeFree(message);
+    }
+
+    EdgeFree(queue->head);
+    EdgeFree(queue);
+    return CA_STATUS_OK;
+}
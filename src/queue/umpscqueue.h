@@ -0,0 +1,106 @@
+/******************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ *
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************/
+
+/**
+ * @file
+ *
+ * This file contains the APIs for lock-free multi-producer/single-consumer queue.
+ * Any number of threads may push concurrently, but only one thread may pop.
+ */
+
+#ifndef U_MPSC_QUEUE_H_
+#define U_MPSC_QUEUE_H_
+
+#include "cacommon.h"
+#include "uqueue.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif /* __cplusplus */
+
+typedef struct u_mpsc_queue_node_t u_mpsc_queue_node;
+
+/**
+ * MPSC queue node format.
+ */
+struct u_mpsc_queue_node_t
+{
+    /** pointer to queue message. */
+    u_queue_message_t *message;
+    /** Pointer to next queue node. */
+    u_mpsc_queue_node *volatile next;
+};
+
+/**
+ * MPSC queue structure.
+ * head is only touched by the consumer, tail is shared by the producers.
+ */
+typedef struct u_mpsc_queue_t
+{
+    /** Consumer side, always points to a stub node. */
+    u_mpsc_queue_node *head;
+    /** Producer side, last pushed node. */
+    u_mpsc_queue_node *volatile tail;
+} u_mpsc_queue_t;
+
+/**
+ * API to creates lock-free queue.
+ * @return  u_mpsc_queue_t pointer if Success, NULL otherwise.
+ */
+u_mpsc_queue_t *u_mpsc_queue_create();
+
+/**
+ * Deletes the queue. Remaining messages are freed, not their data.
+ * Must not be called while producers or the consumer are still using the queue.
+ * @param queue pointer to queue.
+ * @return ::CA_STATUS_OK if Success, ::CA_STATUS_FAILED otherwise.
+ */
+CAResult_t u_mpsc_queue_delete(u_mpsc_queue_t *queue);
+
+/**
+ * Adds message at the end of the queue. Safe to call from multiple threads.
+ * @param queue pointer to queue.
+ * @param message Pointer to message.
+ * @return ::CA_STATUS_OK if Success, error code otherwise.
+ */
+CAResult_t u_mpsc_queue_push(u_mpsc_queue_t *queue, u_queue_message_t *message);
+
+/**
+ * Returns the first message in the queue and removes it.
+ * Must only be called from the single consumer thread.
+ * @param queue pointer to queue.
+ * @return pointer to Message if Success, NULL if the queue is empty.
+ */
+u_queue_message_t *u_mpsc_queue_pop(u_mpsc_queue_t *queue);
+
+/**
+ * Checks whether a message is available for the consumer.
+ * A push that is still in flight may not be visible yet.
+ * @param queue pointer to queue.
+ * @return true if queue is empty, false otherwise.
+ */
+bool u_mpsc_queue_is_empty(u_mpsc_queue_t *queue);
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif /* __cplusplus */
+
+#endif /* U_MPSC_QUEUE_H_ */
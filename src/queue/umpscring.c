@@ -0,0 +1,200 @@
+/******************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ *
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************/
+
+#include "umpscring.h"
+
+#include <string.h>
+#include "edge_logger.h"
+#include "edge_malloc.h"
+
+#if defined(_WIN32) && !defined(__GNUC__)
+#include <windows.h>
+#define RING_LOAD(ptr) ((uint32_t) InterlockedCompareExchange((LONG volatile *) (ptr), 0, 0))
+#define RING_STORE(ptr, val) InterlockedExchange((LONG volatile *) (ptr), (LONG) (val))
+#define RING_CAS(ptr, expected, desired) \
+    ((LONG) (expected) == InterlockedCompareExchange((LONG volatile *) (ptr), (LONG) (desired), \
+            (LONG) (expected)))
+#else
+#define RING_LOAD(ptr) __atomic_load_n((ptr), __ATOMIC_ACQUIRE)
+#define RING_STORE(ptr, val) __atomic_store_n((ptr), (val), __ATOMIC_RELEASE)
+#define RING_CAS(ptr, expected, desired) \
+    __sync_bool_compare_and_swap((ptr), (expected), (desired))
+#endif
+
+/**
+ * @def TAG
+ * @brief Logging tag for module name
+ */
+#define TAG "UMPSCRING"
+
+/** Largest capacity, positions are compared as signed 32-bit differences. */
+#define MAX_RING_CAPACITY (1u << 30)
+
+/**
+ * Slot of the ring. Its sequence is the position which may write it next,
+ * and that position + 1 once the element is written.
+ */
+typedef struct u_mpsc_ring_slot_t
+{
+    volatile uint32_t sequence;
+} u_mpsc_ring_slot_t;
+
+struct u_mpsc_ring_t
+{
+    /** Number of slots minus one. */
+    uint32_t mask;
+    /** Size of an element. */
+    size_t elementSize;
+    /** Offset of the element within a slot. */
+    size_t elementOffset;
+    /** Size of a slot with its element. */
+    size_t slotSize;
+    /** Next position to push, shared by the producers. */
+    volatile uint32_t tail;
+    /** Next position to pop, only touched by the consumer. */
+    uint32_t head;
+    /** Slots, each a sequence followed by an element. */
+    unsigned char *slots;
+};
+
+static u_mpsc_ring_slot_t *getSlot(const u_mpsc_ring_t *ring, uint32_t position)
+{
+    return (u_mpsc_ring_slot_t *) (ring->slots + (size_t) (position & ring->mask) * ring->slotSize);
+}
+
+u_mpsc_ring_t *u_mpsc_ring_create(uint32_t capacity, size_t elementSize)
+{
+    if (0 == capacity || capacity > MAX_RING_CAPACITY || 0 == elementSize)
+    {
+        EDGE_LOG(TAG, "RingCreate FAIL, invalid capacity or element size");
+        return NULL;
+    }
+
+    uint32_t slotCount = 1;
+    while (slotCount < capacity)
+    {
+        slotCount <<= 1;
+    }
+
+    u_mpsc_ring_t *ring = (u_mpsc_ring_t *) EdgeCalloc(1, sizeof(u_mpsc_ring_t));
+    if (NULL == ring)
+    {
+        EDGE_LOG(TAG, "RingCreate FAIL");
+        return NULL;
+    }
+
+    // elements start at an aligned offset behind the sequence
+    size_t align = sizeof(void *) > sizeof(double) ? sizeof(void *) : sizeof(double);
+    size_t elementOffset = (sizeof(u_mpsc_ring_slot_t) + align - 1) / align * align;
+    ring->elementOffset = elementOffset;
+    ring->slotSize = (elementOffset + elementSize + align - 1) / align * align;
+    ring->elementSize = elementSize;
+    ring->mask = slotCount - 1;
+    ring->slots = (unsigned char *) EdgeCalloc(slotCount, ring->slotSize);
+    if (NULL == ring->slots)
+    {
+        EDGE_LOG(TAG, "RingCreate FAIL, memory allocation failed");
+        EdgeFree(ring);
+        return NULL;
+    }
+
+    for (uint32_t i = 0; i < slotCount; i++)
+    {
+        getSlot(ring, i)->sequence = i;
+    }
+    return ring;
+}
+
+static void *getElement(const u_mpsc_ring_t *ring, u_mpsc_ring_slot_t *slot)
+{
+    return (unsigned char *) slot + ring->elementOffset;
+}
+
+CAResult_t u_mpsc_ring_push(u_mpsc_ring_t *ring, const void *element)
+{
+    if (NULL == ring || NULL == element)
+    {
+        EDGE_LOG(TAG, "RingPush FAIL, Invalid Ring or Element");
+        return CA_STATUS_INVALID_PARAM;
+    }
+
+    uint32_t position = RING_LOAD(&ring->tail);
+    for (;;)
+    {
+        u_mpsc_ring_slot_t *slot = getSlot(ring, position);
+        int32_t diff = (int32_t) (RING_LOAD(&slot->sequence) - position);
+        if (0 == diff)
+        {
+            // the slot is free for this position, claim the position
+            if (RING_CAS(&ring->tail, position, position + 1))
+            {
+                memcpy(getElement(ring, slot), element, ring->elementSize);
+                RING_STORE(&slot->sequence, position + 1);
+                return CA_STATUS_OK;
+            }
+        }
+        else if (diff < 0)
+        {
+            // the consumer has not popped the slot of the previous round yet
+            return CA_STATUS_FAILED;
+        }
+        position = RING_LOAD(&ring->tail);
+    }
+}
+
+bool u_mpsc_ring_pop(u_mpsc_ring_t *ring, void *element)
+{
+    if (NULL == ring || NULL == element)
+    {
+        EDGE_LOG(TAG, "RingPop FAIL, Invalid Ring or Element");
+        return false;
+    }
+
+    uint32_t position = ring->head;
+    u_mpsc_ring_slot_t *slot = getSlot(ring, position);
+    if ((int32_t) (RING_LOAD(&slot->sequence) - (position + 1)) < 0)
+    {
+        return false;
+    }
+
+    memcpy(element, getElement(ring, slot), ring->elementSize);
+    // hand the slot to the position of the next round
+    RING_STORE(&slot->sequence, position + ring->mask + 1);
+    ring->head = position + 1;
+    return true;
+}
+
+uint32_t u_mpsc_ring_capacity(const u_mpsc_ring_t *ring)
+{
+    return (NULL == ring) ? 0 : ring->mask + 1;
+}
+
+CAResult_t u_mpsc_ring_delete(u_mpsc_ring_t *ring)
+{
+    if (NULL == ring)
+    {
+        EDGE_LOG(TAG, "RingDelete FAIL, Invalid Ring");
+        return CA_STATUS_FAILED;
+    }
+
+    EdgeFree(ring->slots);
+    EdgeFree(ring);
+    return CA_STATUS_OK;
+}
@@ -0,0 +1,91 @@
+/******************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ *
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************/
+
+/**
+ * @file
+ *
+ * This file contains the APIs for a bounded lock-free multi-producer/single-consumer ring.
+ * Elements of a fixed size are copied into preallocated slots, so pushing allocates nothing.
+ * Any number of threads may push concurrently, but only one thread may pop.
+ */
+
+#ifndef U_MPSC_RING_H_
+#define U_MPSC_RING_H_
+
+#include "cacommon.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif /* __cplusplus */
+
+/**
+ * MPSC ring structure.
+ */
+typedef struct u_mpsc_ring_t u_mpsc_ring_t;
+
+/**
+ * Creates a ring.
+ * @param capacity Number of slots, rounded up to a power of two.
+ * @param elementSize Size of an element in bytes.
+ * @return  u_mpsc_ring_t pointer if Success, NULL otherwise.
+ */
+u_mpsc_ring_t *u_mpsc_ring_create(uint32_t capacity, size_t elementSize);
+
+/**
+ * Deletes the ring. Remaining elements are dropped.
+ * Must not be called while producers or the consumer are still using the ring.
+ * @param ring pointer to ring.
+ * @return ::CA_STATUS_OK if Success, ::CA_STATUS_FAILED otherwise.
+ */
+CAResult_t u_mpsc_ring_delete(u_mpsc_ring_t *ring);
+
+/**
+ * Copies an element at the end of the ring. Safe to call from multiple threads.
+ * @param ring pointer to ring.
+ * @param element Pointer to the element, elementSize bytes are copied.
+ * @return ::CA_STATUS_OK if Success, ::CA_STATUS_FAILED if the ring is full.
+ */
+CAResult_t u_mpsc_ring_push(u_mpsc_ring_t *ring, const void *element);
+
+/**
+ * Copies the first element of the ring out and removes it.
+ * Must only be called from the single consumer thread.
+ * @param ring pointer to ring.
+ * @param element Receives the element.
+ * @return true if an element was popped, false if the ring is empty.
+ */
+bool u_mpsc_ring_pop(u_mpsc_ring_t *ring, void *element);
+
+/**
+ * Gets the number of slots of the ring.
+ * @param ring pointer to ring.
+ * @return capacity of the ring, 0 for an invalid ring.
+ */
+uint32_t u_mpsc_ring_capacity(const u_mpsc_ring_t *ring);
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif /* __cplusplus */
+
+#endif /* U_MPSC_RING_H_ */
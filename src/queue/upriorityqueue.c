@@ -0,0 +1,204 @@
+/******************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ *
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************/
+
+#include "upriorityqueue.h"
+
+#include <stddef.h>
+#include "edge_logger.h"
+#include "edge_malloc.h"
+
+/**
+ * @def TAG
+ * @brief Logging tag for module name
+ */
+#define TAG "UPRIORITYQUEUE"
+
+u_priority_queue_t *u_priority_queue_create()
+{
+    return u_priority_queue_create_with_capacity(0);
+}
+
+u_priority_queue_t *u_priority_queue_create_with_capacity(uint32_t capacity)
+{
+    u_priority_queue_t *queuePtr = (u_priority_queue_t *) EdgeCalloc(1, sizeof(u_priority_queue_t));
+    if (NULL == queuePtr)
+    {
+        EDGE_LOG(TAG, "QueueCreate FAIL");
+        return NULL;
+    }
+
+    for (uint32_t i = 0; i < U_PRIORITY_QUEUE_LEVELS; i++)
+    {
+        queuePtr->levels[i] = (U_PRIORITY_QUEUE_LOWEST == i) ?
+                u_queue_create_with_capacity(capacity) : u_queue_create();
+        if (NULL == queuePtr->levels[i])
+        {
+            EDGE_LOG(TAG, "QueueCreate FAIL, memory allocation failed");
+            u_priority_queue_delete(queuePtr);
+            return NULL;
+        }
+    }
+
+    return queuePtr;
+}
+
+CAResult_t u_priority_queue_delete(u_priority_queue_t *queue)
+{
+    if (NULL == queue)
+    {
+        EDGE_LOG(TAG, "QueueDelete FAIL, Invalid Queue");
+        return CA_STATUS_FAILED;
+    }
+
+    for (uint32_t i = 0; i < U_PRIORITY_QUEUE_LEVELS; i++)
+    {
+        if (NULL != queue->levels[i])
+        {
+            u_queue_delete(queue->levels[i]);
+        }
+    }
+
+    EdgeFree(queue);
+    return CA_STATUS_OK;
+}
+
+CAResult_t u_priority_queue_add_element(u_priority_queue_t *queue, u_queue_message_t *message,
+                                        uint32_t priority)
+{
+    if (NULL == queue)
+    {
+        EDGE_LOG(TAG, "QueueAddElement FAIL, Invalid Queue");
+        return CA_STATUS_FAILED;
+    }
+
+    if (priority > U_PRIORITY_QUEUE_LOWEST)
+    {
+        priority = U_PRIORITY_QUEUE_LOWEST;
+    }
+
+    CAResult_t res = u_queue_add_element(queue->levels[priority], message);
+    if (CA_STATUS_OK == res)
+    {
+        queue->count++;
+    }
+    return res;
+}
+
+u_queue_message_t *u_priority_queue_get_element(u_priority_queue_t *queue)
+{
+    if (NULL == queue)
+    {
+        EDGE_LOG(TAG, "QueueGetElement FAIL, Invalid Queue");
+        return NULL;
+    }
+
+    // a starved level goes first, otherwise the highest non-empty one
+    int chosen = -1;
+    int highest = -1;
+    for (uint32_t i = 0; i < U_PRIORITY_QUEUE_LEVELS; i++)
+    {
+        if (0 == u_queue_get_size(queue->levels[i]))
+        {
+            continue;
+        }
+        if (highest < 0)
+        {
+            highest = (int) i;
+        }
+        if (queue->skipped[i] >= U_PRIORITY_QUEUE_STARVATION_LIMIT)
+        {
+            chosen = (int) i;
+            break;
+        }
+    }
+
+    if (highest < 0)
+    {
+        return NULL;
+    }
+    if (chosen < 0)
+    {
+        chosen = highest;
+    }
+
+    for (uint32_t i = (uint32_t) highest; i < U_PRIORITY_QUEUE_LEVELS; i++)
+    {
+        if ((int) i != chosen && 0 != u_queue_get_size(queue->levels[i]))
+        {
+            queue->skipped[i]++;
+        }
+    }
+    queue->skipped[chosen] = 0;
+
+    queue->count--;
+    return u_queue_get_element(queue->levels[chosen]);
+}
+
+u_queue_message_t *u_priority_queue_find_element(u_priority_queue_t *queue,
+                                                 u_queue_match_cb match, void *ctx)
+{
+    if (NULL == queue || NULL == match)
+    {
+        EDGE_LOG(TAG, "QueueFindElement FAIL, Invalid Param");
+        return NULL;
+    }
+
+    for (int i = U_PRIORITY_QUEUE_LOWEST; i >= 0; i--)
+    {
+        u_queue_message_t *message = u_queue_find_element(queue->levels[i], match, ctx);
+        if (NULL != message)
+        {
+            return message;
+        }
+    }
+    return NULL;
+}
+
+u_queue_message_t *u_priority_queue_remove_match(u_priority_queue_t *queue,
+                                                 u_queue_match_cb match, void *ctx)
+{
+    if (NULL == queue)
+    {
+        EDGE_LOG(TAG, "QueueRemoveMatch FAIL, Invalid Queue");
+        return NULL;
+    }
+
+    for (int i = U_PRIORITY_QUEUE_LOWEST; i >= 0; i--)
+    {
+        u_queue_message_t *message = u_queue_remove_match(queue->levels[i], match, ctx);
+        if (NULL != message)
+        {
+            queue->count--;
+            return message;
+        }
+    }
+    return NULL;
+}
+
+uint32_t u_priority_queue_get_size(u_priority_queue_t *queue)
+{
+    if (NULL == queue)
+    {
+        EDGE_LOG(TAG, "QueueGetSize FAIL, Invalid Queue");
+        return 0;
+    }
+
+    return queue->count;
+}
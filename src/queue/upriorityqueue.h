@@ -0,0 +1,133 @@
+/******************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ *
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************/
+
+/**
+ * @file
+ *
+ * This file contains the APIs for priority queue.
+ * Messages are kept FIFO per priority level. Higher levels are served first,
+ * but a waiting lower level is served after it has been passed over
+ * U_PRIORITY_QUEUE_STARVATION_LIMIT times, so it is never starved.
+ */
+
+#ifndef U_PRIORITY_QUEUE_H_
+#define U_PRIORITY_QUEUE_H_
+
+#include "cacommon.h"
+#include "uqueue.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif /* __cplusplus */
+
+/** Number of priority levels, 0 is the highest. */
+#define U_PRIORITY_QUEUE_LEVELS (4)
+
+/** Lowest priority level, used when no priority is given. */
+#define U_PRIORITY_QUEUE_LOWEST (U_PRIORITY_QUEUE_LEVELS - 1)
+
+/** Number of times a waiting level can be passed over before it is served. */
+#define U_PRIORITY_QUEUE_STARVATION_LIMIT (8)
+
+/**
+ * Priority queue structure.
+ */
+typedef struct u_priority_queue_t
+{
+    /** FIFO queue of each level. */
+    u_queue_t *levels[U_PRIORITY_QUEUE_LEVELS];
+    /** Number of times each level was passed over while not empty. */
+    uint32_t skipped[U_PRIORITY_QUEUE_LEVELS];
+    /** Number of messages in all levels. */
+    uint32_t count;
+} u_priority_queue_t;
+
+/**
+ * API to creates priority queue.
+ * @return  u_priority_queue_t pointer if Success, NULL otherwise.
+ */
+u_priority_queue_t *u_priority_queue_create();
+
+/**
+ * API to creates priority queue with pre-allocated elements for the lowest
+ * level, which takes the messages without priority.
+ * @param capacity number of elements to pre-allocate, see u_queue_create_with_capacity().
+ * @return  u_priority_queue_t pointer if Success, NULL otherwise.
+ */
+u_priority_queue_t *u_priority_queue_create_with_capacity(uint32_t capacity);
+
+/**
+ * Resets and deletes the queue.
+ * @param queue pointer to queue.
+ * @return ::CA_STATUS_OK if Success, ::CA_STATUS_FAILED otherwise.
+ */
+CAResult_t u_priority_queue_delete(u_priority_queue_t *queue);
+
+/**
+ * Adds message at the end of its priority level.
+ * @param queue pointer to queue.
+ * @param message Pointer to message.
+ * @param priority priority level, values past the lowest level are clamped.
+ * @return ::CA_STATUS_OK if Success, error code otherwise.
+ */
+CAResult_t u_priority_queue_add_element(u_priority_queue_t *queue, u_queue_message_t *message,
+                                        uint32_t priority);
+
+/**
+ * Returns the next message to serve and removes it from the queue.
+ * @param queue pointer to queue.
+ * @return pointer to Message if Success, NULL otherwise.
+ */
+u_queue_message_t *u_priority_queue_get_element(u_priority_queue_t *queue);
+
+/**
+ * Returns the first message matching the callback, but not remove the element.
+ * Levels are searched from the lowest to the highest.
+ * @param queue pointer to queue.
+ * @param match callback to match messages.
+ * @param ctx context given to the callback.
+ * @return pointer to Message if found, NULL otherwise.
+ */
+u_queue_message_t *u_priority_queue_find_element(u_priority_queue_t *queue,
+                                                 u_queue_match_cb match, void *ctx);
+
+/**
+ * Returns the oldest message matching the callback and removes it from the queue.
+ * Levels are searched from the lowest to the highest.
+ * @param queue pointer to queue.
+ * @param match callback to match messages, NULL matches any message.
+ * @param ctx context given to the callback.
+ * @return pointer to Message if found, NULL otherwise.
+ */
+u_queue_message_t *u_priority_queue_remove_match(u_priority_queue_t *queue,
+                                                 u_queue_match_cb match, void *ctx);
+
+/**
+ * @param queue pointer to queue.
+ * @return number of elements in all levels.
+ */
+uint32_t u_priority_queue_get_size(u_priority_queue_t *queue);
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif /* __cplusplus */
+
+#endif /* U_PRIORITY_QUEUE_H_ */
@@ -37,7 +37,57 @@
  */
 #define TAG "UQUEUE"
 
+static u_queue_element *u_queue_alloc_element(u_queue_t *queue)
+{
+    u_queue_element *element = queue->freeList;
+    if (NULL != element)
+    {
+        queue->freeList = element->next;
+        queue->freeCount--;
+        return element;
+    }
+
+    return (u_queue_element *) EdgeMalloc(sizeof(u_queue_element));
+}
+
+static void u_queue_release_element(u_queue_t *queue, u_queue_element *element)
+{
+    if (queue->freeCount < queue->capacity)
+    {
+        element->message = NULL;
+        element->next = queue->freeList;
+        queue->freeList = element;
+        queue->freeCount++;
+        return;
+    }
+
+    EdgeFree(element);
+}
+
+static u_queue_element *u_queue_unlink_head(u_queue_t *queue)
+{
+    u_queue_element *element = queue->element;
+    if (NULL == element)
+    {
+        return NULL;
+    }
+
+    queue->element = element->next;
+    if (NULL == queue->element)
+    {
+        queue->tail = NULL;
+    }
+    queue->count--;
+
+    return element;
+}
+
 u_queue_t *u_queue_create()
+{
+    return u_queue_create_with_capacity(NO_MESSAGES);
+}
+
+u_queue_t *u_queue_create_with_capacity(uint32_t capacity)
 {
     u_queue_t *queuePtr = (u_queue_t *) EdgeMalloc(sizeof(u_queue_t));
     if (NULL == queuePtr)
@@ -48,6 +98,24 @@ u_queue_t *u_queue_create()
 
     queuePtr->count = NO_MESSAGES;
     queuePtr->element = NULL;
+    queuePtr->tail = NULL;
+    queuePtr->freeList = NULL;
+    queuePtr->freeCount = 0;
+    queuePtr->capacity = capacity;
+
+    for (uint32_t i = 0; i < capacity; i++)
+    {
+        u_queue_element *element = (u_queue_element *) EdgeMalloc(sizeof(u_queue_element));
+        if (NULL == element)
+        {
+            EDGE_LOG(TAG, "QueueCreate : pre-allocation stopped, memory allocation failed");
+            break;
+        }
+        element->message = NULL;
+        element->next = queuePtr->freeList;
+        queuePtr->freeList = element;
+        queuePtr->freeCount++;
+    }
 
     return queuePtr;
 }
@@ -55,7 +123,6 @@ u_queue_t *u_queue_create()
 CAResult_t u_queue_add_element(u_queue_t *queue, u_queue_message_t *message)
 {
     u_queue_element *element = NULL;
-    u_queue_element *ptr = NULL;
 
     if (NULL == queue)
     {
@@ -69,7 +136,13 @@ CAResult_t u_queue_add_element(u_queue_t *queue, u_queue_message_t *message)
         return CA_STATUS_FAILED;
     }
 
-    element = (u_queue_element *) EdgeMalloc(sizeof(u_queue_element));
+    if (NULL == queue->tail && NO_MESSAGES != queue->count)
+    {
+        EDGE_LOG(TAG, "QueueAddElement : FAIL, count is not zero");
+        return CA_STATUS_FAILED;
+    }
+
+    element = u_queue_alloc_element(queue);
     if (NULL == element)
     {
         EDGE_LOG(TAG, "QueueAddElement FAIL, memory allocation failed");
@@ -79,36 +152,18 @@ CAResult_t u_queue_add_element(u_queue_t *queue, u_queue_message_t *message)
     element->message = message;
     element->next = NULL;
 
-    ptr = queue->element;
-
-    if (NULL != ptr)
+    if (NULL != queue->tail)
     {
-        while (NULL != ptr->next)
-        {
-            ptr = ptr->next;
-        }
-
-        ptr->next = element;
-        queue->count++;
-
-        EDGE_LOG_V(TAG, "Queue Count : %d", queue->count);
+        queue->tail->next = element;
     }
     else
     {
-        if (NO_MESSAGES != queue->count)
-        {
-            EDGE_LOG(TAG, "QueueAddElement : FAIL, count is not zero");
-
-            /* error in queue, free the allocated memory*/
-            EdgeFree(element);
-            return CA_STATUS_FAILED;
-        }
-
         queue->element = element;
-        queue->count++;
-        EDGE_LOG_V(TAG, "Queue Count : %d", queue->count);
     }
+    queue->tail = element;
+    queue->count++;
 
+    EDGE_LOG_V(TAG, "Queue Count : %d", queue->count);
     return CA_STATUS_OK;
 }
 
@@ -123,24 +178,19 @@ u_queue_message_t *u_queue_get_element(u_queue_t *queue)
         return NULL;
     }
 
-    element = queue->element;
-
+    element = u_queue_unlink_head(queue);
     if (NULL == element)
     {
         return NULL;
     }
 
-    queue->element = element->next;
-    queue->count--;
-
     message = element->message;
-    EdgeFree(element);
+    u_queue_release_element(queue, element);
     return message;
 }
 
 CAResult_t u_queue_remove_element(u_queue_t *queue)
 {
-    u_queue_element *next = NULL;
     u_queue_element *remove = NULL;
 
     if (NULL == queue)
@@ -149,25 +199,78 @@ CAResult_t u_queue_remove_element(u_queue_t *queue)
         return CA_STATUS_FAILED;
     }
 
-    remove = queue->element;
-
+    remove = u_queue_unlink_head(queue);
     if (NULL == remove)
     {
         EDGE_LOG(TAG, "QueueRemoveElement : no messages");
         return CA_STATUS_OK;
     }
 
-    next = remove->next;
-
     EdgeFree(remove->message);
-    EdgeFree(remove);
-
-    queue->element = next;
-    queue->count--;
+    u_queue_release_element(queue, remove);
 
     return CA_STATUS_OK;
 }
 
+u_queue_message_t *u_queue_find_element(u_queue_t *queue, u_queue_match_cb match, void *ctx)
+{
+    if (NULL == queue || NULL == match)
+    {
+        EDGE_LOG(TAG, "QueueFindElement FAIL, Invalid Param");
+        return NULL;
+    }
+
+    for (u_queue_element *element = queue->element; NULL != element; element = element->next)
+    {
+        if (match(element->message, ctx))
+        {
+            return element->message;
+        }
+    }
+    return NULL;
+}
+
+u_queue_message_t *u_queue_remove_match(u_queue_t *queue, u_queue_match_cb match, void *ctx)
+{
+    if (NULL == queue)
+    {
+        EDGE_LOG(TAG, "QueueRemoveMatch FAIL, Invalid Queue");
+        return NULL;
+    }
+
+    if (NULL == match)
+    {
+        return u_queue_get_element(queue);
+    }
+
+    u_queue_element *prev = NULL;
+    for (u_queue_element *element = queue->element; NULL != element; element = element->next)
+    {
+        if (!match(element->message, ctx))
+        {
+            prev = element;
+            continue;
+        }
+
+        if (NULL == prev)
+        {
+            return u_queue_get_element(queue);
+        }
+
+        prev->next = element->next;
+        if (queue->tail == element)
+        {
+            queue->tail = prev;
+        }
+        queue->count--;
+
+        u_queue_message_t *message = element->message;
+        u_queue_release_element(queue, element);
+        return message;
+    }
+    return NULL;
+}
+
 uint32_t u_queue_get_size(u_queue_t *queue)
 {
     if (NULL == queue)
@@ -225,6 +328,13 @@ CAResult_t u_queue_delete(u_queue_t *queue)
         return error;
     }
 
+    while (NULL != queue->freeList)
+    {
+        u_queue_element *next = queue->freeList->next;
+        EdgeFree(queue->freeList);
+        queue->freeList = next;
+    }
+
     EdgeFree(queue);
     return (CA_STATUS_OK);
 }
@@ -43,8 +43,18 @@ typedef struct u_queue_message_t
     void *msg;
     /** message size. */
     uint32_t size;
+    /** Time the message was queued in microseconds, set by the queueing thread. */
+    uint64_t enqueueTime;
 } u_queue_message_t;
 
+/**
+ * Callback to match a queued message.
+ * @param message queued message.
+ * @param ctx context given by the caller.
+ * @return true if the message matches.
+ */
+typedef bool (*u_queue_match_cb)(const u_queue_message_t *message, void *ctx);
+
 typedef struct u_queue_element_t u_queue_element;
 
 /**
@@ -65,8 +75,16 @@ typedef struct u_queue_t
 {
     /** Head of the queue. */
     u_queue_element *element;
+    /** Tail of the queue, used for constant time insertion. */
+    u_queue_element *tail;
     /** Number of messages in Queue. */
     uint32_t count;
+    /** List of spare elements reused before allocating new ones. */
+    u_queue_element *freeList;
+    /** Number of elements in the spare list. */
+    uint32_t freeCount;
+    /** Maximum number of spare elements kept after dequeue. */
+    uint32_t capacity;
 } u_queue_t;
 
 /**
@@ -75,6 +93,15 @@ typedef struct u_queue_t
  */
 u_queue_t *u_queue_create();
 
+/**
+ * API to creates queue with pre-allocated elements.
+ * Up to capacity elements are allocated up front and recycled on dequeue,
+ * so steady-state enqueue and dequeue do not touch the allocator.
+ * @param capacity number of elements to pre-allocate.
+ * @return  u_queue_t pointer if Success, NULL otherwise.
+ */
+u_queue_t *u_queue_create_with_capacity(uint32_t capacity);
+
 /**
  * Resets and deletes the queue.
  * @param queue- queue pointer.
@@ -105,6 +132,24 @@ u_queue_message_t *u_queue_get_element(u_queue_t *queue);
  */
 CAResult_t u_queue_remove_element(u_queue_t *queue);
 
+/**
+ * Returns the first message matching the callback, but not remove the element.
+ * @param queue pointer to queue.
+ * @param match callback to match messages.
+ * @param ctx context given to the callback.
+ * @return pointer to Message if found, NULL otherwise.
+ */
+u_queue_message_t *u_queue_find_element(u_queue_t *queue, u_queue_match_cb match, void *ctx);
+
+/**
+ * Returns the first message matching the callback and removes queue element.
+ * @param queue pointer to queue.
+ * @param match callback to match messages, NULL matches the head.
+ * @param ctx context given to the callback.
+ * @return pointer to Message if found, NULL otherwise.
+ */
+u_queue_message_t *u_queue_remove_match(u_queue_t *queue, u_queue_match_cb match, void *ctx);
+
 /**
  * @param queue pointer to queue.
  * @return number of elements in queue.
@@ -28,46 +28,41 @@
 
 static uint8_t supportedApplicationTypes;
 
+static void logEndpointString(const char *name, const UA_String *value)
+{
+    char *str = convertUAStringToString(value);
+    EDGE_LOG_V(TAG, "Endpoint %s: %s.\n", name, IS_NOT_NULL(str) ? str : "");
+    EdgeFree(str);
+}
+
 void logEndpointDescription(UA_EndpointDescription *ep)
 {
-#if DEBUG
-    if(!ep)
+    if(!ep || !EDGE_LOG_ENABLED(EDGE_LOG_LEVEL_DEBUG))
     {
         return;
     }
 
-    char *str = NULL;
     EDGE_LOG_V(TAG, "%s", "\n\n");
     EDGE_LOG(TAG, "----------Endpoint Description--------------");
-    EDGE_LOG_V(TAG, "Endpoint URL: %s.\n", (str = convertUAStringToString(&ep->endpointUrl)));
-    free(str);
+    logEndpointString("URL", &ep->endpointUrl);
     EDGE_LOG_V(TAG, "Endpoint security mode: %d.\n", ep->securityMode);
-    EDGE_LOG_V(TAG, "Endpoint security policy URI: %s.\n", (str = convertUAStringToString(&ep->securityPolicyUri)));
-    free(str);
+    logEndpointString("security policy URI", &ep->securityPolicyUri);
     EDGE_LOG_V(TAG, "Endpoint user identity token count: %d\n", (int) ep->userIdentityTokensSize);
-    EDGE_LOG_V(TAG, "Endpoint transport profile URI: %s.\n", (str = convertUAStringToString(&ep->transportProfileUri)));
-    free(str);
+    logEndpointString("transport profile URI", &ep->transportProfileUri);
     EDGE_LOG_V(TAG, "Endpoint security level: %u.\n", ep->securityLevel);
-    EDGE_LOG_V(TAG, "Endpoint application URI: %s.\n", (str = convertUAStringToString(&ep->server.applicationUri)));
-    free(str);
-    EDGE_LOG_V(TAG, "Endpoint product URI: %s.\n", (str = convertUAStringToString(&ep->server.productUri)));
-    free(str);
-    EDGE_LOG_V(TAG, "Endpoint application name: %s.\n", (str = convertUAStringToString(&ep->server.applicationName.text)));
-    free(str);
+    logEndpointString("application URI", &ep->server.applicationUri);
+    logEndpointString("product URI", &ep->server.productUri);
+    logEndpointString("application name", &ep->server.applicationName.text);
     EDGE_LOG_V(TAG, "Endpoint application type: %u.\n", ep->server.applicationType);
-    EDGE_LOG_V(TAG, "Endpoint gateway server URI: %s.\n", (str = convertUAStringToString(&ep->server.gatewayServerUri)));
-    free(str);
-    EDGE_LOG_V(TAG, "Endpoint discovery profile URI: %s.\n", (str = convertUAStringToString(&ep->server.discoveryProfileUri)));
-    free(str);
+    logEndpointString("gateway server URI", &ep->server.gatewayServerUri);
+    logEndpointString("discovery profile URI", &ep->server.discoveryProfileUri);
     EDGE_LOG_V(TAG, "Endpoint discovery URL count: %d\n", (int) ep->server.discoveryUrlsSize);
     for(size_t i = 0; i < ep->server.discoveryUrlsSize; ++i)
     {
-        EDGE_LOG_V(TAG, "Endpoint discovery URL(%d): %s.\n", (int) i+1, (str = convertUAStringToString(&ep->server.discoveryUrls[i])));
-        free(str);
+        char *str = convertUAStringToString(&ep->server.discoveryUrls[i]);
+        EDGE_LOG_V(TAG, "Endpoint discovery URL(%d): %s.\n", (int) i+1, IS_NOT_NULL(str) ? str : "");
+        EdgeFree(str);
     }
-#else
-    (void) ep;
-#endif
 }
 
 EdgeApplicationConfig *convertToEdgeApplicationConfig(UA_ApplicationDescription *appDesc)
@@ -135,8 +130,8 @@ EdgeApplicationConfig *convertToEdgeApplicationConfig(UA_ApplicationDescription
 
     appConfig->applicationType = convertToEdgeApplicationType(appDesc->applicationType);
     appConfig->discoveryUrlsSize = appDesc->discoveryUrlsSize;
-    appConfig->discoveryUrls = (char **) calloc(appDesc->discoveryUrlsSize, sizeof(char *));
-    if (!appConfig->discoveryUrls)
+    appConfig->discoveryUrls = (char **) EdgeCalloc(appDesc->discoveryUrlsSize, sizeof(char *));
+    if (!appConfig->discoveryUrls && appDesc->discoveryUrlsSize > 0)
     {
         EDGE_LOG(TAG, "Memory allocation failed for appConfig discoveryUrls.");
         freeEdgeApplicationConfig(appConfig);
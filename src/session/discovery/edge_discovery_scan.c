@@ -0,0 +1,169 @@
+/******************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ *
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************/
+
+#include "edge_discovery_scan.h"
+#include "edge_get_endpoints.h"
+#include "edge_logger.h"
+#include "edge_utils.h"
+#include "edge_malloc.h"
+#include "octhread.h"
+#include "edge_thread_config.h"
+
+#include <stdio.h>
+#ifndef _WIN32
+#include <arpa/inet.h>
+#include <pthread.h>
+#else
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#include "pthread.h"
+#endif
+
+#define TAG "edge_discovery_scan"
+
+#define DEFAULT_SCAN_WORKERS (8)
+#define MAX_SCAN_WORKERS (64)
+/* Addresses of one scanEndpointRangeInternal() call at most, a /16 network */
+#define MAX_SCAN_RANGE (65536)
+#define MAX_SCAN_URI_SIZE (64)
+
+/* Endpoint Uris of one scan, handed out to its workers */
+typedef struct EdgeDiscoveryScan
+{
+    const char *const *endpointUris;
+    size_t count;
+    size_t next;
+    uint32_t timeoutMs;
+    pthread_mutex_t mutex;
+} EdgeDiscoveryScan;
+
+static void *scanWorkerHandler(void *arg)
+{
+    applyEdgeThreadConfig(EDGE_THREAD_HELPER);
+    EdgeDiscoveryScan *scan = (EdgeDiscoveryScan *) arg;
+    while (true)
+    {
+        pthread_mutex_lock(&scan->mutex);
+        size_t index = scan->next++;
+        pthread_mutex_unlock(&scan->mutex);
+        if (index >= scan->count)
+        {
+            break;
+        }
+
+        EdgeResult result = getEndpointsWithTimeout((char *) scan->endpointUris[index],
+                scan->timeoutMs);
+        if (STATUS_OK != result.code)
+        {
+            EDGE_LOG_V(TAG, "No endpoints of %s (%d)\n", scan->endpointUris[index], result.code);
+        }
+    }
+    return NULL;
+}
+
+EdgeResult scanEndpointsInternal(const char *const *endpointUris, size_t count,
+        size_t maxWorkers, uint32_t timeoutMs)
+{
+    EdgeResult result;
+    result.code = STATUS_PARAM_INVALID;
+    VERIFY_NON_NULL_MSG(endpointUris, "NULL endpointUris in scanEndpointsInternal\n", result);
+    COND_CHECK_MSG((0 == count), "No endpoint Uri to scan\n", result);
+    for (size_t i = 0; i < count; i++)
+    {
+        VERIFY_NON_NULL_MSG(endpointUris[i], "NULL endpoint Uri in scanEndpointsInternal\n",
+                result);
+    }
+
+    EdgeDiscoveryScan scan;
+    scan.endpointUris = endpointUris;
+    scan.count = count;
+    scan.next = 0;
+    scan.timeoutMs = timeoutMs;
+    pthread_mutex_init(&scan.mutex, NULL);
+
+    size_t workers = (0 == maxWorkers) ? DEFAULT_SCAN_WORKERS : maxWorkers;
+    workers = (workers > MAX_SCAN_WORKERS) ? MAX_SCAN_WORKERS : workers;
+    workers = (workers > count) ? count : workers;
+
+    /* The calling thread is one of the workers, so the scan completes without any thread */
+    oc_thread threads[MAX_SCAN_WORKERS];
+    size_t started = 0;
+    while (started + 1 < workers
+            && OC_THREAD_SUCCESS == oc_thread_new(&threads[started], scanWorkerHandler, &scan))
+    {
+        started++;
+    }
+    if (started + 1 < workers)
+    {
+        EDGE_LOG_V(TAG, "Scanning with %zu of %zu workers\n", started + 1, workers);
+    }
+
+    scanWorkerHandler(&scan);
+    for (size_t i = 0; i < started; i++)
+    {
+        oc_thread_wait(threads[i]);
+        oc_thread_free(threads[i]);
+    }
+    pthread_mutex_destroy(&scan.mutex);
+
+    result.code = STATUS_OK;
+    return result;
+}
+
+EdgeResult scanEndpointRangeInternal(const char *firstAddress, const char *lastAddress,
+        uint16_t port, size_t maxWorkers, uint32_t timeoutMs)
+{
+    EdgeResult result;
+    result.code = STATUS_PARAM_INVALID;
+    VERIFY_NON_NULL_MSG(firstAddress, "NULL firstAddress in scanEndpointRangeInternal\n", result);
+    VERIFY_NON_NULL_MSG(lastAddress, "NULL lastAddress in scanEndpointRangeInternal\n", result);
+
+    struct in_addr first, last;
+    COND_CHECK_MSG((1 != inet_pton(AF_INET, firstAddress, &first)
+            || 1 != inet_pton(AF_INET, lastAddress, &last)), "Invalid IPv4 address\n", result);
+    uint32_t from = ntohl(first.s_addr);
+    uint32_t to = ntohl(last.s_addr);
+    COND_CHECK_MSG((from > to || to - from >= MAX_SCAN_RANGE), "Invalid address range\n", result);
+
+    size_t count = (size_t) (to - from) + 1;
+    char **uris = (char **) EdgeCalloc(count, sizeof(char *));
+    char *buffer = (char *) EdgeCalloc(count, MAX_SCAN_URI_SIZE);
+    if (IS_NULL(uris) || IS_NULL(buffer))
+    {
+        EDGE_LOG(TAG, "Memory allocation failed.");
+        EdgeFree(uris);
+        EdgeFree(buffer);
+        result.code = STATUS_INTERNAL_ERROR;
+        return result;
+    }
+
+    for (size_t i = 0; i < count; i++)
+    {
+        uint32_t address = from + (uint32_t) i;
+        uris[i] = buffer + i * MAX_SCAN_URI_SIZE;
+        snprintf(uris[i], MAX_SCAN_URI_SIZE, "opc.tcp://%u.%u.%u.%u:%u", (address >> 24) & 0xFF,
+                (address >> 16) & 0xFF, (address >> 8) & 0xFF, address & 0xFF, port);
+    }
+
+    result = scanEndpointsInternal((const char *const *) uris, count, maxWorkers, timeoutMs);
+    EdgeFree(buffer);
+    EdgeFree(uris);
+    return result;
+}
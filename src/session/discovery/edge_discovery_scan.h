@@ -0,0 +1,71 @@
+/******************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ *
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************/
+
+/**
+ * @file edge_discovery_scan.h
+ *
+ * @brief This file contains APIs to get the endpoints of many servers in parallel.
+ */
+
+#ifndef EDGE_DISCOVERY_SCAN_H
+#define EDGE_DISCOVERY_SCAN_H
+
+#include "opcua_common.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/**
+ * @brief Gets the endpoints of the given endpoint Uris on several workers. Each server which
+ *        answers is reported by the discovery callback as soon as its endpoints arrive.
+ * @param[in]  endpointUris Endpoint Uris to probe.
+ * @param[in]  count Number of endpoint Uris.
+ * @param[in]  maxWorkers Number of servers probed at once, 0 for the default.
+ * @param[in]  timeoutMs Timeout of each probe in milliseconds, 0 for the client default.
+ * @return @c EdgeResult code is 0 on success, otherwise an error value
+ * @retval #STATUS_OK Successful, also if a server did not answer
+ * @retval #STATUS_PARAM_INVALID Invalid parameter
+ */
+EdgeResult scanEndpointsInternal(const char *const *endpointUris, size_t count,
+        size_t maxWorkers, uint32_t timeoutMs);
+
+/**
+ * @brief Gets the endpoints of the servers on a range of IPv4 addresses, see
+ *        scanEndpointsInternal().
+ * @param[in]  firstAddress First IPv4 address of the range.
+ * @param[in]  lastAddress Last IPv4 address of the range.
+ * @param[in]  port Port of the servers.
+ * @param[in]  maxWorkers Number of servers probed at once, 0 for the default.
+ * @param[in]  timeoutMs Timeout of each probe in milliseconds, 0 for the client default.
+ * @return @c EdgeResult code is 0 on success, otherwise an error value
+ * @retval #STATUS_OK Successful
+ * @retval #STATUS_PARAM_INVALID Invalid parameter
+ * @retval #STATUS_INTERNAL_ERROR Operation failed
+ */
+EdgeResult scanEndpointRangeInternal(const char *firstAddress, const char *lastAddress,
+        uint16_t port, size_t maxWorkers, uint32_t timeoutMs);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // EDGE_DISCOVERY_SCAN_H
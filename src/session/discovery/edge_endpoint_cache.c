@@ -0,0 +1,258 @@
+/******************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ *
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************/
+
+#include "edge_endpoint_cache.h"
+#include "edge_logger.h"
+#include "edge_utils.h"
+#include "edge_hash_map.h"
+#include "edge_malloc.h"
+#include "octhread.h"
+
+#include "open62541.h"
+
+#include <stdio.h>
+#ifndef _WIN32
+#include <pthread.h>
+#else
+#include "pthread.h"
+#endif
+
+#define TAG "edge_endpoint_cache"
+
+#define MAX_SERVER_SIZE (512)
+
+/* Endpoints discovered for one endpoint Uri. Members are guarded by cacheMutex. */
+struct EdgeEndpointCacheEntry
+{
+    /* Key of the entry in cacheMap */
+    char *endpointUri;
+    /* Address and port of the server, see formatServer() */
+    char *server;
+    EdgeDevice *device;
+    /* oc_get_time_us() after which the entry is not handed out anymore */
+    uint64_t expiresUs;
+    /* Holders of acquireCachedEndpoints() and the map itself while the entry is in it */
+    size_t refCount;
+};
+
+static EdgeHashMap *cacheMap = NULL;
+static uint32_t cacheTtlMs = 0;
+static pthread_mutex_t cacheMutex = PTHREAD_MUTEX_INITIALIZER;
+
+static bool formatServer(const char *address, size_t length, uint16_t port, char *out)
+{
+    int written = snprintf(out, MAX_SERVER_SIZE, "%.*s:%u", (int) length, address, port);
+    return (written > 0 && written < MAX_SERVER_SIZE);
+}
+
+/* Called with cacheMutex held */
+static void unrefEntry(EdgeEndpointCacheEntry *entry)
+{
+    if (0 != --entry->refCount)
+    {
+        return;
+    }
+    freeEdgeDevice(entry->device);
+    EdgeFree(entry->server);
+    EdgeFree(entry->endpointUri);
+    EdgeFree(entry);
+}
+
+/* Called with cacheMutex held */
+static void removeEntry(EdgeEndpointCacheEntry *entry)
+{
+    removeEdgeHashMapElement(cacheMap, (keyValue) entry->endpointUri, NULL);
+    unrefEntry(entry);
+}
+
+/* Called with cacheMutex held */
+static void clearCache(void)
+{
+    if (IS_NULL(cacheMap))
+    {
+        return;
+    }
+    size_t cursor = 0;
+    keyValue value = NULL;
+    while (getNextEdgeHashMapElement(cacheMap, &cursor, NULL, &value))
+    {
+        unrefEntry((EdgeEndpointCacheEntry *) value);
+    }
+    deleteEdgeHashMap(cacheMap);
+    cacheMap = NULL;
+}
+
+void setEndpointCacheTtlInternal(uint32_t ttlMs)
+{
+    pthread_mutex_lock(&cacheMutex);
+    cacheTtlMs = ttlMs;
+    if (0 == ttlMs)
+    {
+        clearCache();
+    }
+    pthread_mutex_unlock(&cacheMutex);
+}
+
+EdgeEndpointCacheEntry *acquireCachedEndpoints(const char *endpointUri)
+{
+    VERIFY_NON_NULL_MSG(endpointUri, "NULL endpointUri in acquireCachedEndpoints\n", NULL);
+    EdgeEndpointCacheEntry *entry = NULL;
+    pthread_mutex_lock(&cacheMutex);
+    if (IS_NOT_NULL(cacheMap))
+    {
+        entry = (EdgeEndpointCacheEntry *) getEdgeHashMapElement(cacheMap, (keyValue) endpointUri);
+    }
+    if (IS_NOT_NULL(entry) && oc_get_time_us() >= entry->expiresUs)
+    {
+        removeEntry(entry);
+        entry = NULL;
+    }
+    if (IS_NOT_NULL(entry))
+    {
+        entry->refCount++;
+    }
+    pthread_mutex_unlock(&cacheMutex);
+    return entry;
+}
+
+EdgeDevice *getCachedDevice(const EdgeEndpointCacheEntry *entry)
+{
+    return entry->device;
+}
+
+void releaseCachedEndpoints(EdgeEndpointCacheEntry *entry)
+{
+    VERIFY_NON_NULL_NR_MSG(entry, "NULL entry in releaseCachedEndpoints\n");
+    pthread_mutex_lock(&cacheMutex);
+    unrefEntry(entry);
+    pthread_mutex_unlock(&cacheMutex);
+}
+
+bool cacheEndpoints(const char *endpointUri, EdgeDevice *device)
+{
+    VERIFY_NON_NULL_MSG(endpointUri, "NULL endpointUri in cacheEndpoints\n", false);
+    VERIFY_NON_NULL_MSG(device, "NULL device in cacheEndpoints\n", false);
+    VERIFY_NON_NULL_MSG(device->address, "NULL device address in cacheEndpoints\n", false);
+
+    char server[MAX_SERVER_SIZE];
+    COND_CHECK_MSG(!formatServer(device->address, strlen(device->address), device->port, server),
+            "Server address is too long for the endpoint cache\n", false);
+
+    EdgeEndpointCacheEntry *entry = (EdgeEndpointCacheEntry *) EdgeCalloc(1,
+            sizeof(EdgeEndpointCacheEntry));
+    VERIFY_NON_NULL_MSG(entry, "EdgeCalloc FAILED for EdgeEndpointCacheEntry\n", false);
+    entry->endpointUri = cloneString(endpointUri);
+    entry->server = cloneString(server);
+    if (IS_NULL(entry->endpointUri) || IS_NULL(entry->server))
+    {
+        EDGE_LOG(TAG, "Memory allocation failed.");
+        EdgeFree(entry->server);
+        EdgeFree(entry->endpointUri);
+        EdgeFree(entry);
+        return false;
+    }
+    entry->device = device;
+    entry->refCount = 1;
+
+    bool cached = false;
+    pthread_mutex_lock(&cacheMutex);
+    if (0 != cacheTtlMs)
+    {
+        if (IS_NULL(cacheMap))
+        {
+            cacheMap = createEdgeHashMap(EDGE_HASH_STRING_KEY);
+        }
+        EdgeEndpointCacheEntry *old = IS_NOT_NULL(cacheMap) ? (EdgeEndpointCacheEntry *)
+                getEdgeHashMapElement(cacheMap, (keyValue) endpointUri) : NULL;
+        if (IS_NOT_NULL(old))
+        {
+            removeEntry(old);
+        }
+        entry->expiresUs = oc_get_time_us() + (uint64_t) cacheTtlMs * 1000;
+        cached = IS_NOT_NULL(cacheMap)
+                && insertEdgeHashMapElement(cacheMap, (keyValue) entry->endpointUri,
+                        (keyValue) entry);
+    }
+    pthread_mutex_unlock(&cacheMutex);
+
+    if (!cached)
+    {
+        /* The device stays with the caller */
+        entry->device = NULL;
+        EdgeFree(entry->server);
+        EdgeFree(entry->endpointUri);
+        EdgeFree(entry);
+    }
+    return cached;
+}
+
+void invalidateEndpointCacheInternal(const char *endpointUri)
+{
+    char server[MAX_SERVER_SIZE];
+    if (IS_NOT_NULL(endpointUri))
+    {
+        UA_String hostName = UA_STRING_NULL, path = UA_STRING_NULL;
+        UA_UInt16 port = 0;
+        UA_String endpointUrlString = UA_STRING((char *) (uintptr_t) endpointUri);
+        if (UA_STATUSCODE_GOOD != UA_parseEndpointUrl(&endpointUrlString, &hostName, &port, &path)
+                || !formatServer((const char *) hostName.data, hostName.length, port, server))
+        {
+            EDGE_LOG_V(TAG, "Invalid endpoint Uri %s in invalidateEndpointCache\n", endpointUri);
+            return;
+        }
+    }
+
+    pthread_mutex_lock(&cacheMutex);
+    if (IS_NULL(endpointUri))
+    {
+        clearCache();
+    }
+    else if (IS_NOT_NULL(cacheMap))
+    {
+        /* The map must not change while it is iterated, the entries are removed afterwards */
+        size_t size = getEdgeHashMapSize(cacheMap);
+        EdgeEndpointCacheEntry **stale = (EdgeEndpointCacheEntry **) EdgeCalloc(size + 1,
+                sizeof(EdgeEndpointCacheEntry *));
+        if (IS_NULL(stale))
+        {
+            EDGE_LOG(TAG, "Memory allocation failed, dropping the whole endpoint cache.");
+            clearCache();
+        }
+        else
+        {
+            size_t count = 0, cursor = 0;
+            keyValue value = NULL;
+            while (getNextEdgeHashMapElement(cacheMap, &cursor, NULL, &value))
+            {
+                EdgeEndpointCacheEntry *entry = (EdgeEndpointCacheEntry *) value;
+                if (0 == strcmp(entry->server, server))
+                {
+                    stale[count++] = entry;
+                }
+            }
+            for (size_t i = 0; i < count; i++)
+            {
+                removeEntry(stale[i]);
+            }
+            EdgeFree(stale);
+        }
+    }
+    pthread_mutex_unlock(&cacheMutex);
+}
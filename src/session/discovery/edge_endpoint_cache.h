@@ -0,0 +1,89 @@
+/******************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ *
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************/
+
+/**
+ * @file edge_endpoint_cache.h
+ *
+ * @brief This file contains the cache of the endpoints discovered by GetEndpoints.
+ *
+ * A discovered EdgeDevice is kept per endpoint Uri until its time to live ends or its server
+ * is invalidated, and is reported again without a request to the server. The connect logic
+ * invalidates a server whose connection fails or is lost, so that it is discovered again.
+ */
+
+#ifndef EDGE_ENDPOINT_CACHE_H
+#define EDGE_ENDPOINT_CACHE_H
+
+#include "opcua_common.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+typedef struct EdgeEndpointCacheEntry EdgeEndpointCacheEntry;
+
+/**
+ * @brief Sets the time to live of the cached endpoints
+ * @param[in]  ttlMs Time to live in milliseconds, 0 disables the cache and empties it.
+ */
+void setEndpointCacheTtlInternal(uint32_t ttlMs);
+
+/**
+ * @brief Gets the cached endpoints of an endpoint Uri. The entry stays valid until
+ *        releaseCachedEndpoints(), also if it is invalidated meanwhile.
+ * @param[in]  endpointUri Endpoint Uri.
+ * @return the entry, NULL if there is none or it has expired.
+ */
+EdgeEndpointCacheEntry *acquireCachedEndpoints(const char *endpointUri);
+
+/**
+ * @brief Gets the device of a cached entry
+ * @param[in]  entry Entry of acquireCachedEndpoints().
+ * @return the device, which must not be modified or freed.
+ */
+EdgeDevice *getCachedDevice(const EdgeEndpointCacheEntry *entry);
+
+/**
+ * @brief Releases an entry of acquireCachedEndpoints()
+ * @param[in]  entry Entry of acquireCachedEndpoints().
+ */
+void releaseCachedEndpoints(EdgeEndpointCacheEntry *entry);
+
+/**
+ * @brief Caches the discovered endpoints of an endpoint Uri, replacing older ones
+ * @param[in]  endpointUri Endpoint Uri.
+ * @param[in]  device Discovered device, owned by the cache if the call succeeds.
+ * @return true if the device was cached, false if the cache is disabled or allocation failed.
+ */
+bool cacheEndpoints(const char *endpointUri, EdgeDevice *device);
+
+/**
+ * @brief Drops the cached endpoints of a server
+ * @param[in]  endpointUri Endpoint Uri of the server, every endpoint Uri with the same
+ *             address and port is dropped. NULL drops all.
+ */
+void invalidateEndpointCacheInternal(const char *endpointUri);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // EDGE_ENDPOINT_CACHE_H
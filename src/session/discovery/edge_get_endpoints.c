@@ -20,6 +20,7 @@
 
 #include "edge_get_endpoints.h"
 #include "edge_discovery_common.h"
+#include "edge_endpoint_cache.h"
 #include "edge_logger.h"
 #include "edge_utils.h"
 #include "edge_list.h"
@@ -27,9 +28,24 @@
 
 #include "open62541.h"
 
+#ifndef _WIN32
+#include <pthread.h>
+#else
+#include "pthread.h"
+#endif
+
 #define TAG "edge_get_endpoints"
 
 static discovery_cb_t g_discoveryCallback = NULL;
+/* Devices of a discovery scan are reported one at a time */
+static pthread_mutex_t g_discoveryCallbackMutex = PTHREAD_MUTEX_INITIALIZER;
+
+static void reportDevice(EdgeDevice *device)
+{
+    pthread_mutex_lock(&g_discoveryCallbackMutex);
+    g_discoveryCallback(device);
+    pthread_mutex_unlock(&g_discoveryCallbackMutex);
+}
 
 static bool parseEndpoints(size_t endpointArraySize, UA_EndpointDescription *endpointArray,
         size_t *count, List **endpointList)
@@ -191,6 +207,11 @@ static bool parseEndpoints(size_t endpointArraySize, UA_EndpointDescription *end
 }
 
 EdgeResult getEndpointsInternal(char *endpointUri)
+{
+    return getEndpointsWithTimeout(endpointUri, 0);
+}
+
+EdgeResult getEndpointsWithTimeout(char *endpointUri, uint32_t timeoutMs)
 {
     EdgeResult result;
     UA_StatusCode retVal;
@@ -210,6 +231,16 @@ EdgeResult getEndpointsInternal(char *endpointUri)
         return result;
     }
 
+    EdgeEndpointCacheEntry *cached = acquireCachedEndpoints(endpointUri);
+    if (cached)
+    {
+        EDGE_LOG_V(TAG, "Cached endpoints of %s.\n", endpointUri);
+        reportDevice(getCachedDevice(cached));
+        releaseCachedEndpoints(cached);
+        result.code = STATUS_OK;
+        return result;
+    }
+
     device = (EdgeDevice *) EdgeCalloc(1, sizeof(EdgeDevice));
     if (!device)
     {
@@ -240,7 +271,12 @@ EdgeResult getEndpointsInternal(char *endpointUri)
         memcpy(device->serverName, path.data, path.length);
     }
 
-    client = UA_Client_new(UA_ClientConfig_default);
+    UA_ClientConfig config = UA_ClientConfig_default;
+    if (timeoutMs > 0)
+    {
+        config.timeout = timeoutMs;
+    }
+    client = UA_Client_new(config);
     if (!client)
     {
         EDGE_LOG(TAG, "UA_Client_new() failed.");
@@ -259,7 +295,11 @@ EdgeResult getEndpointsInternal(char *endpointUri)
     if (0 == endpointArraySize)
     {
         EDGE_LOG(TAG, "No endpoints found.");
-        g_discoveryCallback(device);
+        reportDevice(device);
+        if (cacheEndpoints(endpointUri, device))
+        {
+            device = NULL;
+        }
         result.code = STATUS_OK;
         goto EXIT;
     }
@@ -279,7 +319,7 @@ EdgeResult getEndpointsInternal(char *endpointUri)
     }
 
     device->num_endpoints = count;
-    device->endpointsInfo = (EdgeEndPointInfo **) calloc(count, sizeof(EdgeEndPointInfo *));
+    device->endpointsInfo = (EdgeEndPointInfo **) EdgeCalloc(count, sizeof(EdgeEndPointInfo *));
     if (!device->endpointsInfo)
     {
         EDGE_LOG(TAG, "Memory allocation failed.");
@@ -294,7 +334,11 @@ EdgeResult getEndpointsInternal(char *endpointUri)
         ptr = ptr->link;
     }
 
-    g_discoveryCallback(device);
+    reportDevice(device);
+    if (cacheEndpoints(endpointUri, device))
+    {
+        device = NULL;
+    }
     result.code = STATUS_OK;
 
     EXIT:
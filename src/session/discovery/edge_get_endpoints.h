@@ -45,6 +45,18 @@ extern "C"
  */
 EdgeResult getEndpointsInternal(char *endpointUri);
 
+/**
+ * @brief Gets the detailed end point information with a connection timeout
+ * @param[in]  endpointUri Endpoint Uri.
+ * @param[in]  timeoutMs Timeout in milliseconds of the connection and the request,
+ *             0 for the client default.
+ * @return @c EdgeResult code is 0 on success, otherwise an error value
+ * @retval #STATUS_OK Successful
+ * @retval #STATUS_PARAM_INVALID Invalid parameter
+ * @retval #STATUS_ERROR Operation failed
+ */
+EdgeResult getEndpointsWithTimeout(char *endpointUri, uint32_t timeoutMs);
+
 /**
  * @brief Register the client callback to receive the endpoint information.
  * @param[in]  discoveryCallback Client callback.
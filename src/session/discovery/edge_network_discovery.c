@@ -0,0 +1,319 @@
+/******************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ *
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************/
+
+#include "edge_network_discovery.h"
+#include "edge_endpoint_cache.h"
+#include "edge_logger.h"
+#include "edge_utils.h"
+#include "edge_open62541.h"
+#include "edge_hash_map.h"
+#include "edge_malloc.h"
+#include "octhread.h"
+#include "edge_thread_config.h"
+
+#include "open62541.h"
+
+#define TAG "edge_network_discovery"
+
+#define DEFAULT_DISCOVERY_INTERVAL_MS (5000)
+
+static discovery_cb_t g_deviceCallback = NULL;
+
+#ifdef UA_ENABLE_DISCOVERY_MULTICAST
+
+/* Server announced on the network, touched by the listener thread only */
+typedef struct KnownServer
+{
+    /* Key of the server in knownServers */
+    char *discoveryUrl;
+    char *serverName;
+    /* Last query of the LDS-ME which listed the server */
+    uint64_t round;
+} KnownServer;
+
+static char *ldsEndpoint = NULL;
+static uint32_t discoveryIntervalMs = 0;
+static EdgeHashMap *knownServers = NULL;
+static uint64_t discoveryRound = 0;
+
+static oc_mutex listenerMutex = NULL;
+static oc_cond listenerCond = NULL;
+static oc_thread listenerThread = NULL;
+static bool listenerRunning = false;
+
+static void freeKnownServer(KnownServer *server)
+{
+    EdgeFree(server->serverName);
+    EdgeFree(server->discoveryUrl);
+    EdgeFree(server);
+}
+
+static void reportServer(const KnownServer *server, bool removed)
+{
+    EDGE_LOG_V(TAG, "Server %s %s the network.\n", server->discoveryUrl,
+            removed ? "left" : "joined");
+    if (IS_NULL(g_deviceCallback))
+    {
+        return;
+    }
+
+    UA_String hostName = UA_STRING_NULL, path = UA_STRING_NULL;
+    UA_UInt16 port = 0;
+    UA_String discoveryUrl = UA_STRING(server->discoveryUrl);
+    if (UA_STATUSCODE_GOOD != UA_parseEndpointUrl(&discoveryUrl, &hostName, &port, &path))
+    {
+        EDGE_LOG_V(TAG, "Discovery URL %s is invalid.\n", server->discoveryUrl);
+        return;
+    }
+
+    EdgeDevice *device = (EdgeDevice *) EdgeCalloc(1, sizeof(EdgeDevice));
+    VERIFY_NON_NULL_NR_MSG(device, "EdgeCalloc FAILED for EdgeDevice\n");
+    device->address = convertUAStringToString(&hostName);
+    device->port = port;
+    device->serverName = IS_NOT_NULL(server->serverName) ? cloneString(server->serverName) : NULL;
+    device->removed = removed;
+    if (IS_NULL(device->address)
+            || (IS_NOT_NULL(server->serverName) && IS_NULL(device->serverName)))
+    {
+        EDGE_LOG(TAG, "Memory allocation failed.");
+        freeEdgeDevice(device);
+        return;
+    }
+    g_deviceCallback(device);
+    freeEdgeDevice(device);
+}
+
+/* Reports the servers which joined or left since the previous query */
+static void pollServersOnNetwork(UA_Client *client)
+{
+    size_t serverCount = 0;
+    UA_ServerOnNetwork *servers = NULL;
+    UA_StatusCode retVal = UA_Client_findServersOnNetwork(client, ldsEndpoint, 0, 0, 0, NULL,
+            &serverCount, &servers);
+    if (UA_STATUSCODE_GOOD != retVal)
+    {
+        /* An unreachable LDS-ME tells nothing about the servers, they are kept */
+        EDGE_LOG_V(TAG, "FindServersOnNetwork failed. Error Code: %s.\n",
+                UA_StatusCode_name(retVal));
+        return;
+    }
+
+    if (IS_NULL(knownServers))
+    {
+        knownServers = createEdgeHashMap(EDGE_HASH_STRING_KEY);
+    }
+    if (IS_NULL(knownServers))
+    {
+        EDGE_LOG(TAG, "Memory allocation failed.");
+        UA_Array_delete(servers, serverCount, &UA_TYPES[UA_TYPES_SERVERONNETWORK]);
+        return;
+    }
+
+    discoveryRound++;
+    for (size_t i = 0; i < serverCount; i++)
+    {
+        if (servers[i].discoveryUrl.length == 0)
+        {
+            continue;
+        }
+        KnownServer *known = (KnownServer *) getEdgeHashMapElementByString(knownServers,
+                (const char *) servers[i].discoveryUrl.data, servers[i].discoveryUrl.length);
+        if (IS_NOT_NULL(known))
+        {
+            known->round = discoveryRound;
+            continue;
+        }
+
+        known = (KnownServer *) EdgeCalloc(1, sizeof(KnownServer));
+        VERIFY_NON_NULL_NR_MSG(known, "EdgeCalloc FAILED for KnownServer\n");
+        known->discoveryUrl = convertUAStringToString(&servers[i].discoveryUrl);
+        known->serverName = convertUAStringToString(&servers[i].serverName);
+        known->round = discoveryRound;
+        if (IS_NULL(known->discoveryUrl)
+                || !insertEdgeHashMapElement(knownServers, (keyValue) known->discoveryUrl,
+                        (keyValue) known))
+        {
+            EDGE_LOG(TAG, "Failed to add a server announced on the network.");
+            freeKnownServer(known);
+            continue;
+        }
+        reportServer(known, false);
+    }
+    UA_Array_delete(servers, serverCount, &UA_TYPES[UA_TYPES_SERVERONNETWORK]);
+
+    /* The map must not change while it is iterated, the servers are removed afterwards */
+    size_t knownCount = getEdgeHashMapSize(knownServers);
+    KnownServer **stale = (KnownServer **) EdgeCalloc(knownCount + 1, sizeof(KnownServer *));
+    VERIFY_NON_NULL_NR_MSG(stale, "EdgeCalloc FAILED for the left servers\n");
+    size_t staleCount = 0, cursor = 0;
+    keyValue value = NULL;
+    while (getNextEdgeHashMapElement(knownServers, &cursor, NULL, &value))
+    {
+        if (((KnownServer *) value)->round != discoveryRound)
+        {
+            stale[staleCount++] = (KnownServer *) value;
+        }
+    }
+    for (size_t i = 0; i < staleCount; i++)
+    {
+        removeEdgeHashMapElement(knownServers, (keyValue) stale[i]->discoveryUrl, NULL);
+        /* Its endpoints are discovered again if it comes back */
+        invalidateEndpointCacheInternal(stale[i]->discoveryUrl);
+        reportServer(stale[i], true);
+        freeKnownServer(stale[i]);
+    }
+    EdgeFree(stale);
+}
+
+static void forgetServers(void)
+{
+    if (IS_NULL(knownServers))
+    {
+        return;
+    }
+    size_t cursor = 0;
+    keyValue value = NULL;
+    while (getNextEdgeHashMapElement(knownServers, &cursor, NULL, &value))
+    {
+        freeKnownServer((KnownServer *) value);
+    }
+    deleteEdgeHashMap(knownServers);
+    knownServers = NULL;
+}
+
+static void *listenerHandler(void *arg)
+{
+    (void) arg;
+    applyEdgeThreadConfig(EDGE_THREAD_HELPER);
+    UA_Client *client = UA_Client_new(UA_ClientConfig_default);
+    oc_mutex_lock(listenerMutex);
+    while (listenerRunning)
+    {
+        oc_mutex_unlock(listenerMutex);
+        if (IS_NOT_NULL(client))
+        {
+            pollServersOnNetwork(client);
+        }
+        oc_mutex_lock(listenerMutex);
+
+        uint64_t deadline = oc_get_time_us() + (uint64_t) discoveryIntervalMs * 1000;
+        uint64_t now = oc_get_time_us();
+        while (listenerRunning && now < deadline)
+        {
+            oc_cond_wait_for(listenerCond, listenerMutex, deadline - now);
+            now = oc_get_time_us();
+        }
+    }
+    oc_mutex_unlock(listenerMutex);
+
+    if (IS_NOT_NULL(client))
+    {
+        UA_Client_delete(client);
+    }
+    forgetServers();
+    return NULL;
+}
+
+EdgeResult startNetworkDiscoveryInternal(const char *ldsEndpointUri, uint32_t intervalMs)
+{
+    EdgeResult result;
+    result.code = STATUS_PARAM_INVALID;
+    VERIFY_NON_NULL_MSG(ldsEndpointUri, "NULL ldsEndpointUri in startNetworkDiscovery\n", result);
+    result.code = STATUS_ALREADY_INIT;
+    COND_CHECK_MSG(IS_NOT_NULL(listenerThread), "Network discovery is already running\n", result);
+
+    result.code = STATUS_ERROR;
+    ldsEndpoint = cloneString(ldsEndpointUri);
+    VERIFY_NON_NULL_MSG(ldsEndpoint, "Memory allocation failed for the LDS endpoint\n", result);
+    discoveryIntervalMs = (0 == intervalMs) ? DEFAULT_DISCOVERY_INTERVAL_MS : intervalMs;
+
+    listenerMutex = oc_mutex_new();
+    listenerCond = oc_cond_new();
+    if (IS_NULL(listenerMutex) || IS_NULL(listenerCond))
+    {
+        EDGE_LOG(TAG, "Failed to create the discovery listener lock.");
+        goto ERROR;
+    }
+    listenerRunning = true;
+    if (OC_THREAD_SUCCESS != oc_thread_new(&listenerThread, listenerHandler, NULL))
+    {
+        EDGE_LOG(TAG, "Failed to start the discovery listener thread.");
+        listenerRunning = false;
+        listenerThread = NULL;
+        goto ERROR;
+    }
+    result.code = STATUS_OK;
+    return result;
+
+    ERROR:
+    oc_cond_free(listenerCond);
+    oc_mutex_free(listenerMutex);
+    listenerCond = NULL;
+    listenerMutex = NULL;
+    EdgeFree(ldsEndpoint);
+    ldsEndpoint = NULL;
+    return result;
+}
+
+void stopNetworkDiscoveryInternal(void)
+{
+    if (IS_NULL(listenerThread))
+    {
+        return;
+    }
+    oc_mutex_lock(listenerMutex);
+    listenerRunning = false;
+    oc_cond_signal(listenerCond);
+    oc_mutex_unlock(listenerMutex);
+
+    oc_thread_wait(listenerThread);
+    oc_thread_free(listenerThread);
+    oc_cond_free(listenerCond);
+    oc_mutex_free(listenerMutex);
+    listenerThread = NULL;
+    listenerCond = NULL;
+    listenerMutex = NULL;
+    EdgeFree(ldsEndpoint);
+    ldsEndpoint = NULL;
+}
+
+#else
+
+EdgeResult startNetworkDiscoveryInternal(const char *ldsEndpointUri, uint32_t intervalMs)
+{
+    (void) intervalMs;
+    EdgeResult result;
+    result.code = STATUS_PARAM_INVALID;
+    VERIFY_NON_NULL_MSG(ldsEndpointUri, "NULL ldsEndpointUri in startNetworkDiscovery\n", result);
+    EDGE_LOG(TAG, "open62541 is built without multicast discovery, see MULTICAST_DISCOVERY.");
+    result.code = STATUS_ERROR;
+    return result;
+}
+
+void stopNetworkDiscoveryInternal(void)
+{
+}
+
+#endif
+
+void registerNetworkDiscoveryCb(discovery_cb_t deviceCallback)
+{
+    g_deviceCallback = deviceCallback;
+}
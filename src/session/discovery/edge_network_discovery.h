@@ -0,0 +1,72 @@
+/******************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ *
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************/
+
+/**
+ * @file edge_network_discovery.h
+ *
+ * @brief This file contains the multicast discovery of servers on the network.
+ *
+ * A local discovery server with the multicast extension (LDS-ME) learns the servers of the
+ * network from their mDNS announcements. Its FindServersOnNetwork table is followed by a
+ * listener thread, which reports each server once when it appears and once when its
+ * announcement ends. Needs open62541 built with MULTICAST_DISCOVERY=1
+ * (UA_ENABLE_DISCOVERY_MULTICAST).
+ */
+
+#ifndef EDGE_NETWORK_DISCOVERY_H
+#define EDGE_NETWORK_DISCOVERY_H
+
+#include "opcua_common.h"
+#include "command_adapter.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/**
+ * @brief Starts following the servers announced on the network
+ * @param[in]  ldsEndpointUri Endpoint Uri of the LDS-ME.
+ * @param[in]  intervalMs Time between two queries of the LDS-ME in milliseconds, 0 for 5 seconds.
+ * @return @c EdgeResult code is 0 on success, otherwise an error value
+ * @retval #STATUS_OK Successful
+ * @retval #STATUS_PARAM_INVALID Invalid parameter
+ * @retval #STATUS_ALREADY_INIT Discovery is already running
+ * @retval #STATUS_ERROR Multicast discovery is not built in, or the listener did not start
+ */
+EdgeResult startNetworkDiscoveryInternal(const char *ldsEndpointUri, uint32_t intervalMs);
+
+/**
+ * @brief Stops following the servers announced on the network. Servers are not reported
+ *        as removed.
+ */
+void stopNetworkDiscoveryInternal(void);
+
+/**
+ * @brief Register the callback which receives the servers appearing and disappearing.
+ * @param[in]  deviceCallback Client callback.
+ */
+void registerNetworkDiscoveryCb(discovery_cb_t deviceCallback);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // EDGE_NETWORK_DISCOVERY_H
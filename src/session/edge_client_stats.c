@@ -0,0 +1,596 @@
+/******************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ *
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************/
+
+
+#include "edge_client_stats.h"
+#include "edge_opcua_client.h"
+#include "subscription.h"
+#include "edge_hash_map.h"
+#include "edge_utils.h"
+#include "edge_logger.h"
+#include "edge_malloc.h"
+#include "octhread.h"
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+#include <inttypes.h>
+
+#ifndef _WIN32
+#include <pthread.h>
+#else
+#include "pthread.h"
+#endif
+
+#define TAG "client_stats"
+
+/* Severity bits of a Bad status, Good and Uncertain ones are no errors */
+#define STATUS_SEVERITY_BAD (0x80000000)
+
+#define METRICS_TEXT_INITIAL_SIZE (4096)
+
+typedef struct EdgeClientCounters
+{
+    struct EdgeClientCounters *next;
+    UA_Client *client;
+    char *endpoint;
+    /* Set when the first session lost its connection, until it is connected again */
+    bool disconnected;
+    EdgeClientStats stats;
+} EdgeClientCounters;
+
+/* Counters of each endpoint and the sessions counted with them (UA_Client * -> counters),
+ * both guarded by g_countersMutex together with the counters */
+static EdgeClientCounters *g_counters = NULL;
+static EdgeHashMap *g_sessionCounters = NULL;
+static pthread_mutex_t g_countersMutex = PTHREAD_MUTEX_INITIALIZER;
+
+/* Transport functions which the counting ones forward to, the same for every connection */
+static UA_StatusCode (*g_send)(UA_Connection *connection, UA_ByteString *buf) = NULL;
+static UA_StatusCode (*g_recv)(UA_Connection *connection, UA_ByteString *response,
+        UA_UInt32 timeout) = NULL;
+
+static const char *REQUEST_NAMES[EDGE_CLIENT_REQUESTS] =
+{ "read", "write", "method", "browse", "subscription", "other" };
+
+/* Histogram bucket i holds the durations below 10^(i+1) us, given in seconds */
+static const char *BUCKET_LIMITS[EDGE_LATENCY_BUCKETS - 1] =
+{ "1e-05", "0.0001", "0.001", "0.01", "0.1", "1", "10" };
+
+/* Call with g_countersMutex held */
+static EdgeClientCounters *findCounters(const UA_Client *client)
+{
+    if (IS_NULL(g_sessionCounters) || IS_NULL(client))
+    {
+        return NULL;
+    }
+    return (EdgeClientCounters *) getEdgeHashMapElement(g_sessionCounters, (keyValue) client);
+}
+
+static EdgeClientRequest getRequestOfCommand(EdgeCommand command)
+{
+    switch (command)
+    {
+        case CMD_READ:
+        case CMD_READ_SAMPLING_INTERVAL:
+        case CMD_HISTORY_READ:
+            return EDGE_CLIENT_REQUEST_READ;
+        case CMD_WRITE:
+            return EDGE_CLIENT_REQUEST_WRITE;
+        case CMD_METHOD:
+            return EDGE_CLIENT_REQUEST_METHOD;
+        case CMD_BROWSE:
+        case CMD_BROWSE_VIEW:
+            return EDGE_CLIENT_REQUEST_BROWSE;
+        case CMD_SUB:
+            return EDGE_CLIENT_REQUEST_SUBSCRIPTION;
+        default:
+            return EDGE_CLIENT_REQUEST_OTHER;
+    }
+}
+
+static void recordDuration(EdgeLatencyHistogram *histogram, uint64_t duration)
+{
+    histogram->count++;
+    histogram->totalUs += duration;
+    if (duration > histogram->maxUs)
+    {
+        histogram->maxUs = duration;
+    }
+
+    uint32_t bucket = 0;
+    uint64_t limit = 10;
+    while (bucket < EDGE_LATENCY_BUCKETS - 1 && duration >= limit)
+    {
+        bucket++;
+        limit *= 10;
+    }
+    histogram->histogram[bucket]++;
+}
+
+static UA_Client *getConnectionClient(UA_Connection *connection)
+{
+    return (UA_Client *) ((char *) connection - offsetof(UA_Client, connection));
+}
+
+static void addConnectionBytes(UA_Connection *connection, size_t sent, size_t received)
+{
+    pthread_mutex_lock(&g_countersMutex);
+    EdgeClientCounters *counters = findCounters(getConnectionClient(connection));
+    if (IS_NOT_NULL(counters))
+    {
+        counters->stats.bytesSent += sent;
+        counters->stats.bytesReceived += received;
+    }
+    pthread_mutex_unlock(&g_countersMutex);
+}
+
+static UA_StatusCode countingSend(UA_Connection *connection, UA_ByteString *buf)
+{
+    /* The buffer is released by the send */
+    size_t length = buf->length;
+    UA_StatusCode ret = g_send(connection, buf);
+    if (ret == UA_STATUSCODE_GOOD)
+    {
+        addConnectionBytes(connection, length, 0);
+    }
+    return ret;
+}
+
+static UA_StatusCode countingRecv(UA_Connection *connection, UA_ByteString *response,
+        UA_UInt32 timeout)
+{
+    UA_StatusCode ret = g_recv(connection, response, timeout);
+    if (ret == UA_STATUSCODE_GOOD)
+    {
+        addConnectionBytes(connection, 0, response->length);
+    }
+    return ret;
+}
+
+void countClientConnection(UA_Client *client)
+{
+    VERIFY_NON_NULL_NR_MSG(client, "NULL client in countClientConnection\n");
+    pthread_mutex_lock(&g_countersMutex);
+    if (client->connection.send != countingSend && IS_NOT_NULL(client->connection.send))
+    {
+        g_send = client->connection.send;
+        client->connection.send = countingSend;
+    }
+    if (client->connection.recv != countingRecv && IS_NOT_NULL(client->connection.recv))
+    {
+        g_recv = client->connection.recv;
+        client->connection.recv = countingRecv;
+    }
+    pthread_mutex_unlock(&g_countersMutex);
+}
+
+bool createClientCounters(UA_Client *client, const char *endpoint)
+{
+    VERIFY_NON_NULL_MSG(client, "NULL client in createClientCounters\n", false);
+    VERIFY_NON_NULL_MSG(endpoint, "NULL endpoint in createClientCounters\n", false);
+    EdgeClientCounters *counters = (EdgeClientCounters *) EdgeCalloc(1,
+            sizeof(EdgeClientCounters));
+    VERIFY_NON_NULL_MSG(counters, "EdgeCalloc FAILED for the client counters\n", false);
+    counters->endpoint = cloneString(endpoint);
+    if (IS_NULL(counters->endpoint))
+    {
+        EDGE_LOG(TAG, "Memory allocation failed for the endpoint of the client counters\n");
+        EdgeFree(counters);
+        return false;
+    }
+    counters->client = client;
+    counters->stats.sessionCount = 1;
+
+    pthread_mutex_lock(&g_countersMutex);
+    if (IS_NULL(g_sessionCounters))
+    {
+        g_sessionCounters = createEdgeHashMap(EDGE_HASH_POINTER_KEY);
+    }
+    if (IS_NULL(g_sessionCounters)
+            || !insertEdgeHashMapElement(g_sessionCounters, (keyValue) client, counters))
+    {
+        pthread_mutex_unlock(&g_countersMutex);
+        EDGE_LOG(TAG, "Failed to count the client session\n");
+        EdgeFree(counters->endpoint);
+        EdgeFree(counters);
+        return false;
+    }
+    counters->next = g_counters;
+    g_counters = counters;
+    pthread_mutex_unlock(&g_countersMutex);
+    return true;
+}
+
+void addClientCountersSession(UA_Client *first, UA_Client *session)
+{
+    VERIFY_NON_NULL_NR_MSG(session, "NULL session in addClientCountersSession\n");
+    pthread_mutex_lock(&g_countersMutex);
+    EdgeClientCounters *counters = findCounters(first);
+    if (IS_NOT_NULL(counters)
+            && insertEdgeHashMapElement(g_sessionCounters, (keyValue) session, counters))
+    {
+        counters->stats.sessionCount++;
+    }
+    pthread_mutex_unlock(&g_countersMutex);
+}
+
+void removeClientCounters(UA_Client *client)
+{
+    pthread_mutex_lock(&g_countersMutex);
+    EdgeClientCounters *counters = findCounters(client);
+    if (IS_NULL(counters))
+    {
+        pthread_mutex_unlock(&g_countersMutex);
+        return;
+    }
+    removeEdgeHashMapElement(g_sessionCounters, (keyValue) client, NULL);
+    counters->stats.sessionCount--;
+    if (counters->client != client)
+    {
+        pthread_mutex_unlock(&g_countersMutex);
+        return;
+    }
+
+    /* The pool sessions are freed before the first one, drop any left over anyway */
+    size_t cursor = 0;
+    keyValue key = NULL, value = NULL;
+    while (getNextEdgeHashMapElement(g_sessionCounters, &cursor, &key, &value))
+    {
+        if (value == counters)
+        {
+            removeEdgeHashMapElement(g_sessionCounters, key, NULL);
+            cursor = 0;
+        }
+    }
+    EdgeClientCounters **link = &g_counters;
+    while (IS_NOT_NULL(*link) && *link != counters)
+    {
+        link = &(*link)->next;
+    }
+    if (IS_NOT_NULL(*link))
+    {
+        *link = counters->next;
+    }
+    if (IS_NULL(g_counters))
+    {
+        deleteEdgeHashMap(g_sessionCounters);
+        g_sessionCounters = NULL;
+    }
+    pthread_mutex_unlock(&g_countersMutex);
+    EdgeFree(counters->endpoint);
+    EdgeFree(counters);
+}
+
+uint64_t getClientServiceTime()
+{
+    return oc_get_time_us();
+}
+
+void recordClientRequest(UA_Client *client, EdgeCommand command)
+{
+    if (IS_NULL(client))
+    {
+        return;
+    }
+    pthread_mutex_lock(&g_countersMutex);
+    EdgeClientCounters *counters = findCounters(client);
+    if (IS_NOT_NULL(counters))
+    {
+        counters->stats.requests[getRequestOfCommand(command)].requestCount++;
+    }
+    pthread_mutex_unlock(&g_countersMutex);
+}
+
+void recordClientService(UA_Client *client, EdgeCommand command, uint64_t startUs,
+        UA_StatusCode status)
+{
+    uint64_t now = oc_get_time_us();
+    pthread_mutex_lock(&g_countersMutex);
+    EdgeClientCounters *counters = findCounters(client);
+    if (IS_NOT_NULL(counters))
+    {
+        EdgeClientRequestStats *stats = &counters->stats.requests[getRequestOfCommand(command)];
+        recordDuration(&stats->serviceLatency, (now > startUs) ? now - startUs : 0);
+        if (status & STATUS_SEVERITY_BAD)
+        {
+            stats->errorCount++;
+        }
+        if (status == UA_STATUSCODE_BADTIMEOUT)
+        {
+            stats->timeoutCount++;
+        }
+    }
+    pthread_mutex_unlock(&g_countersMutex);
+}
+
+void recordClientConnection(UA_Client *client, bool connected)
+{
+    pthread_mutex_lock(&g_countersMutex);
+    EdgeClientCounters *counters = findCounters(client);
+    if (IS_NOT_NULL(counters) && counters->client == client)
+    {
+        if (!connected && !counters->disconnected)
+        {
+            counters->disconnected = true;
+            counters->stats.disconnectCount++;
+        }
+        else if (connected && counters->disconnected)
+        {
+            counters->disconnected = false;
+            counters->stats.reconnectCount++;
+        }
+    }
+    pthread_mutex_unlock(&g_countersMutex);
+}
+
+static void getSubscriptionCounters(UA_Client *client, EdgeClientStats *stats)
+{
+    uint32_t subscriptions = 0, items = 0;
+    uint64_t notifications = 0;
+    getClientSubscriptionStats(client, &subscriptions, &items, &notifications);
+    stats->subscriptionCount = subscriptions;
+    stats->monitoredItemCount = items;
+    stats->notificationCount = notifications;
+}
+
+bool getClientCounters(UA_Client *client, EdgeClientStats *stats)
+{
+    VERIFY_NON_NULL_MSG(client, "NULL client in getClientCounters\n", false);
+    VERIFY_NON_NULL_MSG(stats, "NULL stats in getClientCounters\n", false);
+    pthread_mutex_lock(&g_countersMutex);
+    EdgeClientCounters *counters = findCounters(client);
+    if (IS_NULL(counters))
+    {
+        pthread_mutex_unlock(&g_countersMutex);
+        return false;
+    }
+    *stats = counters->stats;
+    pthread_mutex_unlock(&g_countersMutex);
+
+    /* Subscriptions are kept by subscription.c under its own locks */
+    getSubscriptionCounters(client, stats);
+    stats->monotonicTime = oc_get_time_us();
+    return true;
+}
+
+typedef struct MetricsText
+{
+    char *text;
+    size_t length;
+    size_t size;
+    bool failed;
+} MetricsText;
+
+static void appendText(MetricsText *out, const char *format, ...)
+{
+    if (out->failed)
+    {
+        return;
+    }
+    while (true)
+    {
+        va_list args;
+        va_start(args, format);
+        int written = vsnprintf(out->text + out->length, out->size - out->length, format, args);
+        va_end(args);
+        if (written < 0)
+        {
+            out->failed = true;
+            return;
+        }
+        if ((size_t) written < out->size - out->length)
+        {
+            out->length += written;
+            return;
+        }
+        size_t size = out->size * 2 + written;
+        char *text = (char *) EdgeRealloc(out->text, size);
+        if (IS_NULL(text))
+        {
+            out->failed = true;
+            return;
+        }
+        out->text = text;
+        out->size = size;
+    }
+}
+
+/* Escapes an endpoint as a label value, which may not hold \, " or a new line as they are */
+static char *escapeLabel(const char *value)
+{
+    size_t length = strlen(value);
+    char *label = (char *) EdgeMalloc(length * 2 + 1);
+    VERIFY_NON_NULL_MSG(label, "EdgeMalloc FAILED for a metrics label\n", NULL);
+    char *out = label;
+    for (const char *in = value; *in; in++)
+    {
+        if ('\\' == *in || '"' == *in)
+        {
+            *out++ = '\\';
+            *out++ = *in;
+        }
+        else if ('\n' == *in)
+        {
+            *out++ = '\\';
+            *out++ = 'n';
+        }
+        else
+        {
+            *out++ = *in;
+        }
+    }
+    *out = '\0';
+    return label;
+}
+
+typedef struct EndpointStats
+{
+    char *label;
+    EdgeClientStats stats;
+} EndpointStats;
+
+static void appendRequestCounter(MetricsText *out, const EndpointStats *endpoints,
+        size_t count, const char *name, const char *help, size_t offset)
+{
+    appendText(out, "# HELP %s %s\n# TYPE %s counter\n", name, help, name);
+    for (size_t i = 0; i < count; i++)
+    {
+        for (int r = 0; r < EDGE_CLIENT_REQUESTS; r++)
+        {
+            const char *field = (const char *) &endpoints[i].stats.requests[r] + offset;
+            appendText(out, "%s{endpoint=\"%s\",request=\"%s\"} %" PRIu64 "\n", name,
+                    endpoints[i].label, REQUEST_NAMES[r], *(const uint64_t *) field);
+        }
+    }
+}
+
+static void appendEndpointMetric(MetricsText *out, const EndpointStats *endpoints,
+        size_t count, const char *name, const char *type, const char *help, size_t offset,
+        bool wide)
+{
+    appendText(out, "# HELP %s %s\n# TYPE %s %s\n", name, help, name, type);
+    for (size_t i = 0; i < count; i++)
+    {
+        const char *field = (const char *) &endpoints[i].stats + offset;
+        uint64_t value = wide ? *(const uint64_t *) field : *(const uint32_t *) field;
+        appendText(out, "%s{endpoint=\"%s\"} %" PRIu64 "\n", name, endpoints[i].label, value);
+    }
+}
+
+static void appendLatencyHistogram(MetricsText *out, const EndpointStats *endpoints,
+        size_t count)
+{
+    const char *name = "edge_client_service_latency_seconds";
+    appendText(out, "# HELP %s Duration of the service calls of the client sessions.\n"
+            "# TYPE %s histogram\n", name, name);
+    for (size_t i = 0; i < count; i++)
+    {
+        for (int r = 0; r < EDGE_CLIENT_REQUESTS; r++)
+        {
+            const EdgeLatencyHistogram *latency = &endpoints[i].stats.requests[r].serviceLatency;
+            uint64_t cumulative = 0;
+            for (int b = 0; b < EDGE_LATENCY_BUCKETS - 1; b++)
+            {
+                cumulative += latency->histogram[b];
+                appendText(out, "%s_bucket{endpoint=\"%s\",request=\"%s\",le=\"%s\"} %" PRIu64
+                        "\n", name, endpoints[i].label, REQUEST_NAMES[r], BUCKET_LIMITS[b],
+                        cumulative);
+            }
+            appendText(out, "%s_bucket{endpoint=\"%s\",request=\"%s\",le=\"+Inf\"} %" PRIu64 "\n",
+                    name, endpoints[i].label, REQUEST_NAMES[r], latency->count);
+            appendText(out, "%s_sum{endpoint=\"%s\",request=\"%s\"} %.6f\n", name,
+                    endpoints[i].label, REQUEST_NAMES[r], latency->totalUs / 1e6);
+            appendText(out, "%s_count{endpoint=\"%s\",request=\"%s\"} %" PRIu64 "\n", name,
+                    endpoints[i].label, REQUEST_NAMES[r], latency->count);
+        }
+    }
+}
+
+char *getClientCountersText(void)
+{
+    /* Copy the counters first, the subscriptions are read under the locks of subscription.c */
+    pthread_mutex_lock(&g_countersMutex);
+    size_t count = 0;
+    for (EdgeClientCounters *counters = g_counters; counters; counters = counters->next)
+    {
+        count++;
+    }
+    EndpointStats *endpoints = NULL;
+    UA_Client **clients = NULL;
+    if (count > 0)
+    {
+        endpoints = (EndpointStats *) EdgeCalloc(count, sizeof(EndpointStats));
+        clients = (UA_Client **) EdgeCalloc(count, sizeof(UA_Client *));
+        if (IS_NULL(endpoints) || IS_NULL(clients))
+        {
+            pthread_mutex_unlock(&g_countersMutex);
+            EDGE_LOG(TAG, "EdgeCalloc FAILED for the client metrics\n");
+            EdgeFree(endpoints);
+            EdgeFree(clients);
+            return NULL;
+        }
+    }
+    size_t index = 0;
+    for (EdgeClientCounters *counters = g_counters; counters; counters = counters->next, index++)
+    {
+        endpoints[index].label = escapeLabel(counters->endpoint);
+        endpoints[index].stats = counters->stats;
+        clients[index] = counters->client;
+    }
+    pthread_mutex_unlock(&g_countersMutex);
+
+    MetricsText out = { NULL, 0, METRICS_TEXT_INITIAL_SIZE, false };
+    out.text = (char *) EdgeMalloc(out.size);
+    out.failed = IS_NULL(out.text);
+    for (size_t i = 0; i < count; i++)
+    {
+        out.failed = out.failed || IS_NULL(endpoints[i].label);
+        getSubscriptionCounters(clients[i], &endpoints[i].stats);
+    }
+    if (!out.failed)
+    {
+        out.text[0] = '\0';
+    }
+
+    appendRequestCounter(&out, endpoints, count, "edge_client_requests_total",
+            "Requests executed on the client sessions.",
+            offsetof(EdgeClientRequestStats, requestCount));
+    appendRequestCounter(&out, endpoints, count, "edge_client_errors_total",
+            "Service calls which returned a Bad status.",
+            offsetof(EdgeClientRequestStats, errorCount));
+    appendRequestCounter(&out, endpoints, count, "edge_client_timeouts_total",
+            "Service calls which timed out.", offsetof(EdgeClientRequestStats, timeoutCount));
+    appendLatencyHistogram(&out, endpoints, count);
+    appendEndpointMetric(&out, endpoints, count, "edge_client_bytes_sent_total", "counter",
+            "Bytes sent on the connections.", offsetof(EdgeClientStats, bytesSent), true);
+    appendEndpointMetric(&out, endpoints, count, "edge_client_bytes_received_total", "counter",
+            "Bytes received on the connections.", offsetof(EdgeClientStats, bytesReceived), true);
+    appendEndpointMetric(&out, endpoints, count, "edge_client_disconnects_total", "counter",
+            "Connections lost.", offsetof(EdgeClientStats, disconnectCount), true);
+    appendEndpointMetric(&out, endpoints, count, "edge_client_reconnects_total", "counter",
+            "Connections established again after a loss.",
+            offsetof(EdgeClientStats, reconnectCount), true);
+    appendEndpointMetric(&out, endpoints, count, "edge_client_notifications_total", "counter",
+            "Data change notifications received.", offsetof(EdgeClientStats, notificationCount),
+            true);
+    appendEndpointMetric(&out, endpoints, count, "edge_client_sessions", "gauge",
+            "Open sessions, pool sessions included.", offsetof(EdgeClientStats, sessionCount),
+            false);
+    appendEndpointMetric(&out, endpoints, count, "edge_client_subscriptions", "gauge",
+            "Active subscriptions.", offsetof(EdgeClientStats, subscriptionCount), false);
+    appendEndpointMetric(&out, endpoints, count, "edge_client_monitored_items", "gauge",
+            "Active monitored items.", offsetof(EdgeClientStats, monitoredItemCount), false);
+
+    for (size_t i = 0; i < count; i++)
+    {
+        EdgeFree(endpoints[i].label);
+    }
+    EdgeFree(endpoints);
+    EdgeFree(clients);
+    if (out.failed)
+    {
+        EDGE_LOG(TAG, "Failed to format the client metrics\n");
+        EdgeFree(out.text);
+        return NULL;
+    }
+    return out.text;
+}
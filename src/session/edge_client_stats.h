@@ -0,0 +1,121 @@
+/******************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ *
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************/
+
+
+/**
+ * @file edge_client_stats.h
+ *
+ * @brief This file contains the runtime statistics of the client sessions.
+ *
+ * The counters of an endpoint are shared by all sessions of its session pool. Requests are
+ * counted where the sessions execute them, service calls where the command modules make them
+ * and the bytes of a connection by the send and receive functions of its transport.
+ */
+
+#ifndef EDGE_CLIENT_STATS_H
+#define EDGE_CLIENT_STATS_H
+
+#include "opcua_common.h"
+#include "opcua_interface.h"
+
+#include <open62541.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/**
+ * @brief Counts the bytes of the connection of a session. A connection opened again on a
+ *        reconnect is counted once this is called again.
+ * @param[in]  client Connected session
+ */
+void countClientConnection(UA_Client *client);
+
+/**
+ * @brief Creates the counters of the first session of an endpoint
+ * @param[in]  client First session of the endpoint
+ * @param[in]  endpoint Endpoint Uri, the label of the metrics
+ * @return @c true on success
+ */
+bool createClientCounters(UA_Client *client, const char *endpoint);
+
+/**
+ * @brief Counts a further session of the session pool of an endpoint with its first session
+ * @param[in]  first First session of the endpoint
+ * @param[in]  session Session of the pool
+ */
+void addClientCountersSession(UA_Client *first, UA_Client *session);
+
+/**
+ * @brief Stops counting a session. The counters are deleted with the first session.
+ * @param[in]  client Session
+ */
+void removeClientCounters(UA_Client *client);
+
+/**
+ * @brief Gets the time which the service durations are measured with
+ * @return Monotonic time in microseconds
+ */
+uint64_t getClientServiceTime();
+
+/**
+ * @brief Records a request executed on a session
+ * @param[in]  client Session, NULL if the endpoint is not connected
+ * @param[in]  command Command of the request
+ */
+void recordClientRequest(UA_Client *client, EdgeCommand command);
+
+/**
+ * @brief Records a service call of a request
+ * @param[in]  client Session which made the call
+ * @param[in]  command Command of the request
+ * @param[in]  startUs Time from getClientServiceTime() when the service request was sent
+ * @param[in]  status Service result, Bad statuses count as errors
+ */
+void recordClientService(UA_Client *client, EdgeCommand command, uint64_t startUs,
+        UA_StatusCode status);
+
+/**
+ * @brief Records a change of the connection state of a session
+ * @param[in]  client Session
+ * @param[in]  connected true if the session is connected again, false if it is lost
+ */
+void recordClientConnection(UA_Client *client, bool connected);
+
+/**
+ * @brief Copies the counters of an endpoint
+ * @param[in]  client First session of the endpoint
+ * @param[out] stats Receives the statistics
+ * @return @c true on success, @c false if the session is not counted
+ */
+bool getClientCounters(UA_Client *client, EdgeClientStats *stats);
+
+/**
+ * @brief Formats the counters of all endpoints in the Prometheus text exposition format
+ * @return Text, to be freed with EdgeFree(), NULL on failure
+ */
+char *getClientCountersText(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* EDGE_CLIENT_STATS_H */
@@ -20,54 +20,166 @@
 
 #include "edge_opcua_client.h"
 #include "edge_get_endpoints.h"
+#include "edge_endpoint_cache.h"
+#include "edge_network_discovery.h"
 #include "edge_find_servers.h"
 #include "edge_discovery_common.h"
 #include "read.h"
+#include "value_cache.h"
 #include "write.h"
 #include "browse.h"
 #include "method.h"
+#include "register_nodes.h"
+#include "translate_paths.h"
+#include "history_read.h"
+#include "prepared_read.h"
+#include "async_service.h"
+#include "write_coalesce.h"
+#include "read_share.h"
+#include "server_capabilities.h"
 #include "message_dispatcher.h"
 #include "subscription.h"
+#include "edge_reconnect.h"
+#include "edge_client_stats.h"
 #include "edge_logger.h"
 #include "edge_utils.h"
 #include "edge_open62541.h"
 #include "edge_list.h"
-#include "edge_map.h"
+#include "edge_hash_map.h"
 #include "edge_malloc.h"
+#include "octhread.h"
+#include "edge_thread_config.h"
 
 #include <stdio.h>
 #include <inttypes.h>
+#ifndef _WIN32
+#include <pthread.h>
+#else
+#include "pthread.h"
+#endif
 
 #define TAG "session_client"
 
 #define MAX_ADDRESS_SIZE (512)
 
-static edgeMap *sessionClientMap = NULL;
+/* Connections which are established at once by connect_client_async() */
+#define MAX_CONNECT_WORKERS (16)
+
+/* Sessions asked of acquireSession(), the next free one of the pool or the first one */
+#define ANY_SESSION ((size_t) -1)
+#define FIRST_SESSION (0)
+
+/* Sessions of an endpoint, see setSessionPoolSizeInClient().
+ * Members are guarded by sessionClientMutex. */
+typedef struct SessionPool
+{
+    /* The first session is the one of the session maps, it keeps the subscriptions */
+    UA_Client *clients[EDGE_MAX_SESSION_POOL_SIZE];
+    /* Set while a request uses the session */
+    bool busy[EDGE_MAX_SESSION_POOL_SIZE];
+    size_t count;
+    size_t busyCount;
+    /* Threads waiting in acquireSession() for a session */
+    size_t waiters;
+    /* Session which the next request tries first, so that requests spread over all of them */
+    size_t next;
+    /* Set when the endpoint is disconnected, no session is handed out anymore */
+    bool closing;
+    /* Set when the last request which leaves the closing pool frees it */
+    bool freeOnRelease;
+    /* Endpoint the sessions are connected to again with */
+    char *endpoint;
+} SessionPool;
+
+/* Connection of connect_client_async() which waits for or runs in a connect worker */
+typedef struct ConnectRequest
+{
+    char *endpoint;
+    /* Buffer and message sizes of the endpoint */
+    UA_ConnectionConfig connectionConfig;
+    /* Set when the endpoint is disconnected before its connection is established */
+    bool cancelled;
+    struct ConnectRequest *next;
+} ConnectRequest;
+
+static EdgeHashMap *sessionClientMap = NULL;
+/* Endpoint URIs as given by requests, mapped to their resolved client */
+static EdgeHashMap *sessionUriMap = NULL;
 static size_t clientCount = 0;
+/* First session of an endpoint with several sessions -> its SessionPool */
+static EdgeHashMap *sessionPoolMap = NULL;
+/* "address:port" -> number of sessions of the endpoint, see setSessionPoolSizeInClient() */
+static EdgeHashMap *sessionPoolSizes = NULL;
+/* Guards the session maps and clientCount, requests of different endpoints may run in parallel */
+static pthread_mutex_t sessionClientMutex = PTHREAD_MUTEX_INITIALIZER;
+/* Signals sessions released to their pool and pools which close, used with sessionClientMutex */
+static pthread_cond_t sessionPoolCond = PTHREAD_COND_INITIALIZER;
+/* "address:port" -> ConnectRequest of the endpoints being connected, guarded by sessionClientMutex */
+static EdgeHashMap *connectingMap = NULL;
+/* Connections waiting for a connect worker and the number of workers, guarded by sessionClientMutex */
+static ConnectRequest *connectHead = NULL;
+static ConnectRequest *connectTail = NULL;
+static size_t connectWorkers = 0;
 
 static status_cb_t g_statusCallback = NULL;
 
-static void getAddressPort(char *endpoint, char **out)
+static bool formatAddressPort(const char *endpoint, char *addr_port)
 {
     UA_String hostName = UA_STRING_NULL, path = UA_STRING_NULL;
     UA_UInt16 port = 0;
     UA_String endpointUrlString = UA_STRING((char *) (uintptr_t) endpoint);
 
     UA_StatusCode parse_retval = UA_parseEndpointUrl(&endpointUrlString, &hostName, &port, &path);
-    COND_CHECK_NR_MSG((parse_retval != UA_STATUSCODE_GOOD), "Server URL is invalid. Unable to get endpoints\n");
+    COND_CHECK_MSG((parse_retval != UA_STATUSCODE_GOOD),
+            "Server URL is invalid. Unable to get endpoints\n", false);
+    COND_CHECK_MSG((hostName.length >= MAX_ADDRESS_SIZE), "Server address is too long\n", false);
 
     char address[MAX_ADDRESS_SIZE];
     strncpy(address, (char*) hostName.data, hostName.length);
     address[hostName.length] = '\0';
 
-    char addr_port[MAX_ADDRESS_SIZE];
     memset(addr_port, '\0', MAX_ADDRESS_SIZE);
     int written = snprintf(addr_port, MAX_ADDRESS_SIZE, "%s:%d", address, port);
-    if (written > 0)
+    return (written > 0 && written < MAX_ADDRESS_SIZE);
+}
+
+static void getAddressPort(char *endpoint, char **out)
+{
+    char addr_port[MAX_ADDRESS_SIZE];
+    if (formatAddressPort(endpoint, addr_port))
     {
-        *out = (char*) EdgeMalloc(sizeof(char) * (written + 1));
-        strncpy(*out, addr_port, written);
-        (*out)[written] = '\0';
+        *out = cloneString(addr_port);
+    }
+}
+
+/* Caches the resolution of endpoint to client. Called with sessionClientMutex held. */
+static void addSessionUri(const char *endpoint, UA_Client *client)
+{
+    if (IS_NULL(sessionUriMap))
+    {
+        sessionUriMap = createEdgeHashMap(EDGE_HASH_STRING_KEY);
+    }
+    char *uri = cloneString(endpoint);
+    if (IS_NOT_NULL(uri) && !insertEdgeHashMapElement(sessionUriMap, (keyValue) uri, (keyValue) client))
+    {
+        EdgeFree(uri);
+    }
+}
+
+/* Drops all the cached endpoints of client. Called with sessionClientMutex held. */
+static void removeSessionUris(UA_Client *client)
+{
+    size_t cursor = 0;
+    keyValue key = NULL, value = NULL;
+    while (getNextEdgeHashMapElement(sessionUriMap, &cursor, &key, &value))
+    {
+        if (value == (keyValue) client)
+        {
+            removeEdgeHashMapElement(sessionUriMap, key, NULL);
+            EdgeFree(key);
+            /* removal moves the following elements, start over */
+            cursor = 0;
+        }
     }
 }
 
@@ -77,95 +189,543 @@ static keyValue getSessionClient(char *endpoint)
 keyValue getSessionClient(char *endpoint)
 #endif
 {
-    VERIFY_NON_NULL_MSG(sessionClientMap, "sessionClientMap is NULL\n", NULL);
+    VERIFY_NON_NULL_MSG(endpoint, "NULL endpoint received in getSessionClient \n", NULL);
+
+    /* Requests usually repeat the URI they connected with, resolve it without parsing */
+    pthread_mutex_lock(&sessionClientMutex);
+    keyValue value = getEdgeHashMapElement(sessionUriMap, (keyValue) endpoint);
+    pthread_mutex_unlock(&sessionClientMutex);
+    if (IS_NOT_NULL(value))
+    {
+        return value;
+    }
 
     EDGE_LOG_V(TAG, "Endpoint : %s\n", endpoint);
-    char *ep = NULL;
-    getAddressPort(endpoint, &ep);
-    VERIFY_NON_NULL_MSG(ep, "NULL EP received in getSessionClient \n", NULL);
+    char ep[MAX_ADDRESS_SIZE];
+    COND_CHECK_MSG(!formatAddressPort(endpoint, ep), "Invalid EP received in getSessionClient \n",
+            NULL);
+
+    pthread_mutex_lock(&sessionClientMutex);
+    value = getEdgeHashMapElement(sessionClientMap, (keyValue) ep);
+    if (IS_NOT_NULL(value))
+    {
+        addSessionUri(endpoint, (UA_Client *) value);
+    }
+    pthread_mutex_unlock(&sessionClientMutex);
+    return value;
+}
+
+/**
+ * @brief waitForConnection - Waits until a connection of connect_client_async() to the endpoint
+ *        is established or has failed, so that the requests sent after it find the session
+ * @param endpoint - endpoint Uri
+ * @return true if the endpoint was being connected
+ */
+static bool waitForConnection(const char *endpoint)
+{
+    char ep[MAX_ADDRESS_SIZE];
+    COND_CHECK(!formatAddressPort(endpoint, ep), false);
+
+    bool waited = false;
+    pthread_mutex_lock(&sessionClientMutex);
+    while (IS_NOT_NULL(getEdgeHashMapElement(connectingMap, (keyValue) ep)))
+    {
+        waited = true;
+        pthread_cond_wait(&sessionPoolCond, &sessionClientMutex);
+    }
+    pthread_mutex_unlock(&sessionClientMutex);
+    return waited;
+}
+
+static void reportClientStatus(const char *endpoint, EdgeStatusCode status)
+{
+#ifndef DISABLE_DISCOVERY
+    if (STATUS_CLIENT_CONNECT_FAILED == status)
+    {
+        /* The endpoints of the server may have changed, it is discovered again */
+        invalidateEndpointCacheInternal(endpoint);
+    }
+#endif
+    EdgeEndPointInfo ep;
+    memset(&ep, 0, sizeof(EdgeEndPointInfo));
+    ep.endpointUri = (char *) endpoint;
+    g_statusCallback(&ep, status);
+}
+
+/* Connects the first session of an endpoint again if its connection is lost, see
+ * setReconnectConfig(). Called by the thread which holds the session. */
+static void reconnectSession(UA_Client *client, const char *endpoint)
+{
+    if (awaitReconnect(client))
+    {
+        reportClientStatus(endpoint, STATUS_CLIENT_CONNECT_FAILED);
+    }
+}
+
+/* Drops the state the command modules keep for a session */
+static void removeClientState(UA_Client *client)
+{
+    removeServerCapabilities(client);
+    removeValueCache(client);
+    removeRegisteredNodes(client);
+    resetPreparedReads(client);
+    removeCoalescedWrites(client);
+    removeSharedReads(client);
+    removeReconnect(client);
+    removeClientCounters(client);
+#ifdef ENABLE_ASYNC_SERVICES
+    removeAsyncServices(client);
+#endif
+}
+
+/* Deletes the sessions of a pool other than the first one, and the pool */
+static void freeSessionPool(SessionPool *pool)
+{
+    for (size_t i = 1; i < pool->count; i++)
+    {
+        removeClientState(pool->clients[i]);
+        UA_Client_delete(pool->clients[i]);
+    }
+    EdgeFree(pool->endpoint);
+    EdgeFree(pool);
+}
+
+/* Wakes the threads waiting for the pool after a request left it. Called with
+ * sessionClientMutex held, returns the pool if the caller has to free it. */
+static SessionPool *leaveSessionPool(SessionPool *pool)
+{
+    pthread_cond_broadcast(&sessionPoolCond);
+    bool idle = (0 == pool->busyCount && 0 == pool->waiters);
+    return (pool->closing && pool->freeOnRelease && idle) ? pool : NULL;
+}
+
+/* Gets the index of a free session of the pool, count if there is none.
+ * Called with sessionClientMutex held. */
+static size_t findFreeSession(SessionPool *pool, size_t wanted)
+{
+    if (ANY_SESSION != wanted)
+    {
+        return pool->busy[wanted] ? pool->count : wanted;
+    }
+    for (size_t i = 0; i < pool->count; i++)
+    {
+        size_t index = (pool->next + i) % pool->count;
+        if (!pool->busy[index])
+        {
+            pool->next = (index + 1) % pool->count;
+            return index;
+        }
+    }
+    return pool->count;
+}
+
+/**
+ * @brief acquireSession - Gets a session of an endpoint for one request. A session of a pool
+ *        serves one request at a time, the call waits until the wanted one is free.
+ * @param endpoint - endpoint of the request
+ * @param wanted - index of the session, ANY_SESSION for the next free one of the pool
+ * @param pool - receives the pool of the session for releaseSession(),
+ *               NULL if the endpoint has one session
+ * @return session, NULL if the endpoint is not connected or has no such session
+ */
+static UA_Client *acquireSession(char *endpoint, size_t wanted, SessionPool **pool)
+{
+    *pool = NULL;
+    UA_Client *client = (UA_Client *) getSessionClient(endpoint);
+    if (IS_NULL(client) && waitForConnection(endpoint))
+    {
+        client = (UA_Client *) getSessionClient(endpoint);
+    }
+    COND_CHECK((IS_NULL(client)), NULL);
+
+    pthread_mutex_lock(&sessionClientMutex);
+    SessionPool *found = (SessionPool *) getEdgeHashMapElement(sessionPoolMap, (keyValue) client);
+    if (IS_NULL(found) || (ANY_SESSION != wanted && wanted >= found->count))
+    {
+        pthread_mutex_unlock(&sessionClientMutex);
+        COND_CHECK((IS_NOT_NULL(found) || (ANY_SESSION != wanted && FIRST_SESSION != wanted)),
+                NULL);
+        reconnectSession(client, endpoint);
+        return client;
+    }
+
+    found->waiters++;
+    size_t index = found->count;
+    while (!found->closing && (index = findFreeSession(found, wanted)) == found->count)
+    {
+        pthread_cond_wait(&sessionPoolCond, &sessionClientMutex);
+    }
+    found->waiters--;
 
-    keyValue value = NULL;
-    for(edgeMapNode *temp = sessionClientMap->head; temp != NULL; temp = temp->next)
+    SessionPool *toFree = NULL;
+    if (found->closing)
     {
-        if (!strcmp(temp->key, ep))
+        client = NULL;
+        toFree = leaveSessionPool(found);
+    }
+    else
+    {
+        found->busy[index] = true;
+        found->busyCount++;
+        client = found->clients[index];
+        *pool = found;
+    }
+    pthread_mutex_unlock(&sessionClientMutex);
+
+    if (IS_NOT_NULL(toFree))
+    {
+        freeSessionPool(toFree);
+    }
+    else if (IS_NOT_NULL(client) && 0 == index)
+    {
+        reconnectSession(client, endpoint);
+    }
+    else if (IS_NOT_NULL(client) && index > 0 && UA_Client_getState(client) == UA_CLIENTSTATE_DISCONNECTED)
+    {
+        /* Other sessions of the pool report no status, a lost one is connected again on its next use */
+        UA_StatusCode retVal = UA_Client_connect(client, found->endpoint);
+        if (retVal == UA_STATUSCODE_GOOD)
         {
-            value = temp->value;
+            countClientConnection(client);
+        }
+        EDGE_LOG_V(TAG, "Session %zu of the pool connected again 0x%08x\n", index, retVal);
+    }
+    return client;
+}
+
+/* Gives a session of acquireSession() back to its pool */
+static void releaseSession(SessionPool *pool, UA_Client *client)
+{
+    if (IS_NULL(pool) || IS_NULL(client))
+    {
+        /* Session of an endpoint without pool */
+        return;
+    }
+    pthread_mutex_lock(&sessionClientMutex);
+    for (size_t i = 0; i < pool->count; i++)
+    {
+        if (pool->clients[i] == client && pool->busy[i])
+        {
+            pool->busy[i] = false;
+            pool->busyCount--;
             break;
         }
     }
-    EdgeFree(ep);
-    return value;
+    SessionPool *toFree = leaveSessionPool(pool);
+    pthread_mutex_unlock(&sessionClientMutex);
+    if (IS_NOT_NULL(toFree))
+    {
+        freeSessionPool(toFree);
+    }
 }
 
-static edgeMapNode *removeClientFromSessionMap(char *endpoint)
+/**
+ * @brief openSessionPool - Opens the further sessions of an endpoint whose pool size is set.
+ *        Sessions which cannot be connected are left out of the pool.
+ * @param client - first session of the endpoint
+ * @param endpoint - endpoint Uri
+ * @param addrPort - "address:port" of the endpoint
+ * @param connectionConfig - buffer and message sizes of the sessions
+ */
+static void openSessionPool(UA_Client *client, const char *endpoint, const char *addrPort,
+        const UA_ConnectionConfig *connectionConfig)
 {
-    VERIFY_NON_NULL_MSG(sessionClientMap, "sessionClientMap is NULL\n", NULL);
-    char *ep = NULL;
-    getAddressPort(endpoint, &ep);
-    VERIFY_NON_NULL_MSG(ep, "NULL EP received in removeClientFromSessionMap\n", NULL);
+    pthread_mutex_lock(&sessionClientMutex);
+    size_t size = (size_t) (uintptr_t) getEdgeHashMapElement(sessionPoolSizes, (keyValue) addrPort);
+    pthread_mutex_unlock(&sessionClientMutex);
+    if (size < 2)
+    {
+        return;
+    }
+
+    SessionPool *pool = (SessionPool *) EdgeCalloc(1, sizeof(SessionPool));
+    VERIFY_NON_NULL_NR_MSG(pool, "EdgeCalloc FAILED for SessionPool\n");
+    pool->endpoint = cloneString(endpoint);
+    if (IS_NULL(pool->endpoint))
+    {
+        EdgeFree(pool);
+        return;
+    }
+    pool->clients[0] = client;
+    pool->count = 1;
 
-    edgeMapNode *prev = NULL;
-    edgeMapNode *temp = sessionClientMap->head;
-    while (temp != NULL)
+    /* Only the first session reports its state to the application */
+    UA_ClientConfig config = UA_ClientConfig_default;
+    config.localConnectionConfig = *connectionConfig;
+    while (pool->count < size)
     {
-        if (!strcmp(temp->key, ep))
+        UA_Client *session = UA_Client_new(config);
+        if (IS_NULL(session) || UA_Client_connect(session, pool->endpoint) != UA_STATUSCODE_GOOD)
         {
-            if (prev == NULL)
-            {
-                sessionClientMap->head = temp->next;
-            }
-            else
+            EDGE_LOG_V(TAG, "Session pool of %s has %zu of %zu sessions\n", endpoint, pool->count,
+                    size);
+            if (IS_NOT_NULL(session))
             {
-                prev->next = temp->next;
+                UA_Client_delete(session);
             }
             break;
         }
-        prev = temp;
-        temp = temp->next;
+        readServerCapabilities(session);
+        addClientCountersSession(client, session);
+        countClientConnection(session);
+        pool->clients[pool->count++] = session;
+    }
+
+    pthread_mutex_lock(&sessionClientMutex);
+    if (IS_NULL(sessionPoolMap))
+    {
+        sessionPoolMap = createEdgeHashMap(EDGE_HASH_POINTER_KEY);
+    }
+    bool inserted = pool->count > 1
+            && insertEdgeHashMapElement(sessionPoolMap, (keyValue) client, (keyValue) pool);
+    pthread_mutex_unlock(&sessionClientMutex);
+    if (!inserted)
+    {
+        freeSessionPool(pool);
+    }
+}
+
+/**
+ * @brief removeClientFromSessionMap - Removes the sessions of an endpoint from the session maps
+ * @param endpoint - endpoint Uri
+ * @param waitForPool - true to wait until the requests on the sessions of the pool have ended.
+ *        Otherwise the pool is freed by the last of them, as the caller may be one.
+ * @return first session of the endpoint, NULL if it is not connected
+ */
+static UA_Client *removeClientFromSessionMap(char *endpoint, bool waitForPool)
+{
+    char *ep = NULL;
+    getAddressPort(endpoint, &ep);
+    VERIFY_NON_NULL_MSG(ep, "NULL EP received in removeClientFromSessionMap\n", NULL);
+
+    keyValue storedKey = NULL;
+    SessionPool *pool = NULL;
+    pthread_mutex_lock(&sessionClientMutex);
+    UA_Client *client = (UA_Client *) removeEdgeHashMapElement(sessionClientMap, (keyValue) ep,
+            &storedKey);
+    if (IS_NOT_NULL(client))
+    {
+        removeSessionUris(client);
+        pool = (SessionPool *) removeEdgeHashMapElement(sessionPoolMap, (keyValue) client, NULL);
+    }
+    if (IS_NOT_NULL(pool))
+    {
+        pool->closing = true;
+        pthread_cond_broadcast(&sessionPoolCond);
+        while (waitForPool && (pool->busyCount > 0 || pool->waiters > 0))
+        {
+            pthread_cond_wait(&sessionPoolCond, &sessionClientMutex);
+        }
+        if (pool->busyCount > 0 || pool->waiters > 0)
+        {
+            pool->freeOnRelease = true;
+            pool = NULL;
+        }
     }
+    pthread_mutex_unlock(&sessionClientMutex);
+    if (IS_NOT_NULL(pool))
+    {
+        freeSessionPool(pool);
+    }
+    if (IS_NOT_NULL(client))
+    {
+        removeClientState(client);
+    }
+    EdgeFree(storedKey);
     EdgeFree(ep);
-    return temp;
+    return client;
+}
+
+EdgeResult setSessionPoolSizeInClient(const char *endpointUri, size_t sessions)
+{
+    EdgeResult result;
+    result.code = STATUS_PARAM_INVALID;
+    VERIFY_NON_NULL_MSG(endpointUri, "NULL endpointUri in setSessionPoolSizeInClient\n", result);
+    COND_CHECK_MSG((sessions > EDGE_MAX_SESSION_POOL_SIZE), "Session pool is too large\n", result);
+    char addrPort[MAX_ADDRESS_SIZE];
+    COND_CHECK_MSG(!formatAddressPort(endpointUri, addrPort), "Invalid endpointUri\n", result);
+
+    result.code = STATUS_OK;
+    pthread_mutex_lock(&sessionClientMutex);
+    keyValue storedKey = NULL;
+    removeEdgeHashMapElement(sessionPoolSizes, (keyValue) addrPort, &storedKey);
+    EdgeFree(storedKey);
+    if (sessions > 1)
+    {
+        if (IS_NULL(sessionPoolSizes))
+        {
+            sessionPoolSizes = createEdgeHashMap(EDGE_HASH_STRING_KEY);
+        }
+        char *key = cloneString(addrPort);
+        if (IS_NULL(sessionPoolSizes) || IS_NULL(key) || !insertEdgeHashMapElement(
+                sessionPoolSizes, (keyValue) key, (keyValue) (uintptr_t) sessions))
+        {
+            EDGE_LOG(TAG, "Memory allocation failed.");
+            EdgeFree(key);
+            result.code = STATUS_INTERNAL_ERROR;
+        }
+    }
+    if (IS_NOT_NULL(sessionPoolSizes) && 0 == getEdgeHashMapSize(sessionPoolSizes))
+    {
+        deleteEdgeHashMap(sessionPoolSizes);
+        sessionPoolSizes = NULL;
+    }
+    pthread_mutex_unlock(&sessionClientMutex);
+
+    if (STATUS_OK == result.code)
+    {
+        /* Requests of the endpoint are queued in as many send lanes, so that they run in parallel */
+        set_request_lanes(endpointUri, (sessions > 1) ? sessions : 1);
+    }
+    return result;
 }
 
 void setSupportedApplicationTypes(uint8_t supportedTypes)
 {
+#ifndef DISABLE_DISCOVERY
     setSupportedApplicationTypesInternal(supportedTypes);
+#else
+    /* The types only filter the servers found by discovery */
+    (void) supportedTypes;
+#endif
 }
 
 EdgeResult readNodesFromServer(EdgeMessage *msg)
 {
-    UA_Client *clientHandle = (UA_Client*) getSessionClient(msg->endpointInfo->endpointUri);
+    /* A prepared read keeps the node ids it built for the first session */
+    SessionPool *pool = NULL;
+    UA_Client *clientHandle = acquireSession(msg->endpointInfo->endpointUri,
+            (0 != EDGE_MESSAGE_BLOCK(msg)->preparedId) ? FIRST_SESSION : ANY_SESSION, &pool);
+    recordClientRequest(clientHandle, msg->command);
     EdgeResult ret = executeRead(clientHandle, msg);
+    releaseSession(pool, clientHandle);
     return ret;
 }
 
 EdgeResult writeNodesInServer(EdgeMessage *msg)
 {
-    UA_Client *clientHandle = (UA_Client*) getSessionClient(msg->endpointInfo->endpointUri);
+    /* Coalesced writes are collected and flushed on the first session */
+    SessionPool *pool = NULL;
+    bool pinned = EDGE_MESSAGE_BLOCK(msg)->coalesceFlush || isWriteCoalescingEnabled();
+    UA_Client *clientHandle = acquireSession(msg->endpointInfo->endpointUri,
+            pinned ? FIRST_SESSION : ANY_SESSION, &pool);
+    recordClientRequest(clientHandle, msg->command);
     EdgeResult ret = executeWrite(clientHandle, msg);
+    releaseSession(pool, clientHandle);
     return ret;
 }
 
+#ifndef DISABLE_BROWSE
 void browseNodesInServer(EdgeMessage *msg)
 {
-    UA_Client *clientHandle = (UA_Client*) getSessionClient(msg->endpointInfo->endpointUri);
+    SessionPool *pool = NULL;
+    UA_Client *clientHandle = acquireSession(msg->endpointInfo->endpointUri, ANY_SESSION, &pool);
+    recordClientRequest(clientHandle, msg->command);
     executeBrowse(clientHandle, msg);
+    releaseSession(pool, clientHandle);
 }
+#endif
 
+#ifndef DISABLE_METHOD
 EdgeResult callMethodInServer(EdgeMessage *msg)
 {
-    UA_Client *clientHandle = (UA_Client*) getSessionClient(msg->endpointInfo->endpointUri);
+    SessionPool *pool = NULL;
+    UA_Client *clientHandle = acquireSession(msg->endpointInfo->endpointUri, ANY_SESSION, &pool);
+    recordClientRequest(clientHandle, msg->command);
     EdgeResult ret = executeMethod(clientHandle, msg);
+    releaseSession(pool, clientHandle);
     return ret;
 }
+#endif
+
+EdgeResult registerNodesInServer(EdgeMessage *msg)
+{
+    /* Registered node ids belong to the session which registered them */
+    SessionPool *pool = NULL;
+    UA_Client *clientHandle = acquireSession(msg->endpointInfo->endpointUri, FIRST_SESSION, &pool);
+    recordClientRequest(clientHandle, msg->command);
+    EdgeResult ret = executeRegisterNodes(clientHandle, msg);
+    releaseSession(pool, clientHandle);
+    return ret;
+}
+
+#ifndef DISABLE_BROWSE
+EdgeResult translateBrowsePathsInServer(EdgeMessage *msg)
+{
+    SessionPool *pool = NULL;
+    UA_Client *clientHandle = acquireSession(msg->endpointInfo->endpointUri, FIRST_SESSION, &pool);
+    recordClientRequest(clientHandle, msg->command);
+    EdgeResult ret = executeTranslateBrowsePaths(clientHandle, msg);
+    releaseSession(pool, clientHandle);
+    return ret;
+}
+#endif
+
+EdgeResult historyReadInServer(EdgeMessage *msg)
+{
+    SessionPool *pool = NULL;
+    UA_Client *clientHandle = acquireSession(msg->endpointInfo->endpointUri, ANY_SESSION, &pool);
+    recordClientRequest(clientHandle, msg->command);
+    EdgeResult ret = executeHistoryRead(clientHandle, msg);
+    releaseSession(pool, clientHandle);
+    return ret;
+}
+
+void reconnectClientInServer(EdgeMessage *msg)
+{
+    SessionPool *pool = NULL;
+    UA_Client *clientHandle = acquireSession(msg->endpointInfo->endpointUri, FIRST_SESSION, &pool);
+    releaseSession(pool, clientHandle);
+}
+
+#ifdef ENABLE_ASYNC_SERVICES
+void drainAsyncServicesInServer(EdgeMessage *msg)
+{
+    /* Asynchronous requests may be pending on every session of the pool */
+    for (size_t index = 0; ; index++)
+    {
+        SessionPool *pool = NULL;
+        UA_Client *clientHandle = acquireSession(msg->endpointInfo->endpointUri, index, &pool);
+        if (IS_NULL(clientHandle))
+        {
+            break;
+        }
+        drainAsyncServices(clientHandle);
+        releaseSession(pool, clientHandle);
+    }
+}
+#endif
 
 EdgeResult executeSubscriptionInServer(EdgeMessage *msg)
 {
-    UA_Client *clientHandle = (UA_Client*) getSessionClient(msg->endpointInfo->endpointUri);
+    SessionPool *pool = NULL;
+    UA_Client *clientHandle = acquireSession(msg->endpointInfo->endpointUri, FIRST_SESSION, &pool);
+    recordClientRequest(clientHandle, msg->command);
     EdgeResult ret = executeSub(clientHandle, msg);
+    releaseSession(pool, clientHandle);
     return ret;
 }
 
+EdgeResult getClientStatsInClient(const char *endpointUri, EdgeClientStats *stats)
+{
+    EdgeResult result = { STATUS_PARAM_INVALID };
+    VERIFY_NON_NULL_MSG(endpointUri, "NULL endpointUri in getClientStatsInClient\n", result);
+    VERIFY_NON_NULL_MSG(stats, "NULL stats in getClientStatsInClient\n", result);
+    result.code = STATUS_ERROR;
+    UA_Client *client = (UA_Client *) getSessionClient((char *) endpointUri);
+    VERIFY_NON_NULL_MSG(client, "Endpoint is not connected\n", result);
+    if (getClientCounters(client, stats))
+    {
+        result.code = STATUS_OK;
+    }
+    return result;
+}
+
+char *getClientMetricsTextInClient(void)
+{
+    return getClientCountersText();
+}
+
 void edgeStatusCallback(UA_Client *client, UA_ClientState clientState)
 {
     if(IS_NOT_NULL(client->endpointUrl.data))
@@ -178,21 +738,42 @@ void edgeStatusCallback(UA_Client *client, UA_ClientState clientState)
 
         if(clientState == UA_CLIENTSTATE_DISCONNECTED)
         {
-            removeClientFromSessionMap(ep->endpointUri);
+            recordClientConnection(client, false);
+#ifndef DISABLE_DISCOVERY
+            invalidateEndpointCacheInternal(ep->endpointUri);
+#endif
+            /* A session with subscriptions is connected again by the publish reactor,
+             * others by the next request or probe after their backoff if it is enabled */
+            if (!hasClientSubscriptions(client) && !scheduleReconnect(client, ep->endpointUri))
+            {
+                removeClientFromSessionMap(ep->endpointUri, false);
+            }
             g_statusCallback(ep, STATUS_DISCONNECTED);
         }
         else if(clientState == UA_CLIENTSTATE_CONNECTED)
         {
+            /* A connection opened again has the transport functions of a new one */
+            countClientConnection(client);
+            recordClientConnection(client, true);
             g_statusCallback(ep, STATUS_CONNECTED);
         }
     }
 }
 
-bool connect_client(char *endpoint)
+/**
+ * @brief connectClient - Establishes the connection to an endpoint and adds its session
+ * @param endpoint - endpoint Uri
+ * @param connectionConfig - buffer and message sizes of the session
+ * @param request - connection of connect_client_async(), NULL for connect_client()
+ * @return true if the session was added
+ */
+static bool connectClient(char *endpoint, const UA_ConnectionConfig *connectionConfig,
+        const ConnectRequest *request)
 {
     UA_StatusCode retVal;
     UA_ClientConfig config = UA_ClientConfig_default;
     config.stateCallback = edgeStatusCallback;
+    config.localConnectionConfig = *connectionConfig;
 
     UA_Client *m_client = NULL;
     char *m_port = NULL;
@@ -216,63 +797,242 @@ bool connect_client(char *endpoint)
     {
         EDGE_LOG_V(TAG, "\n [CLIENT] Unable to connect 0x%08x!\n", retVal);
         UA_Client_delete(m_client);
+        reportClientStatus(m_endpoint, STATUS_CLIENT_CONNECT_FAILED);
         EdgeFree(m_endpoint);
         return false;
     }
 
     EDGE_LOG(TAG, "\n [CLIENT] Client connection successful \n");
+
+    // Read the limits of the server once, every request of the session is split by them
+    readServerCapabilities(m_client);
     getAddressPort(m_endpoint, &m_port);
 
     // Add the client to session map
+    pthread_mutex_lock(&sessionClientMutex);
     if (NULL == sessionClientMap)
     {
-        sessionClientMap = createMap();
+        sessionClientMap = createEdgeHashMap(EDGE_HASH_STRING_KEY);
+    }
+    bool cancelled = IS_NOT_NULL(request) && request->cancelled;
+    bool inserted = !cancelled
+            && insertEdgeHashMapElement(sessionClientMap, (keyValue) m_port, (keyValue) m_client);
+    if (inserted)
+    {
+        addSessionUri(m_endpoint, m_client);
+        clientCount++;
+    }
+    pthread_mutex_unlock(&sessionClientMutex);
+    if (cancelled)
+    {
+        EDGE_LOG(TAG, "client disconnected while the connection was established.\n");
+        removeServerCapabilities(m_client);
+        UA_Client_delete(m_client);
+        EdgeFree(m_port);
+        EdgeFree(m_endpoint);
+        return false;
+    }
+    if (!inserted)
+    {
+        EDGE_LOG(TAG, "Error : client could not be added to the session map.\n");
+        removeServerCapabilities(m_client);
+        UA_Client_delete(m_client);
+        EdgeFree(m_port);
+        EdgeFree(m_endpoint);
+        return false;
     }
-    insertMapElement(sessionClientMap, (keyValue) m_port, (keyValue) m_client);
-    clientCount++;
+    createClientCounters(m_client, m_endpoint);
+    countClientConnection(m_client);
+    openSessionPool(m_client, m_endpoint, m_port, connectionConfig);
 
-    EdgeEndPointInfo *ep = (EdgeEndPointInfo *) EdgeCalloc(1, sizeof(EdgeEndPointInfo));
-    VERIFY_NON_NULL_MSG(ep, "EdgeCalloc FAILED for EdgeEndPointInfo\n", false);
-    ep->endpointUri = m_endpoint;
-    g_statusCallback(ep, STATUS_CLIENT_STARTED);
+    reportClientStatus(m_endpoint, STATUS_CLIENT_STARTED);
     EdgeFree(m_endpoint);
-    EdgeFree(ep);
 
     return true;
 }
 
-void disconnect_client(EdgeEndPointInfo *epInfo)
+bool connect_client(char *endpoint, const EdgeEndpointConfig *epConfig)
+{
+    UA_ConnectionConfig connectionConfig = UA_ClientConfig_default.localConnectionConfig;
+    applyTransportConfig(&connectionConfig, epConfig);
+    return connectClient(endpoint, &connectionConfig, NULL);
+}
+
+/* Connects the queued endpoints until none is left */
+static void *connectWorkerHandler(void *arg)
 {
-    edgeMapNode *session = NULL;
-    session = removeClientFromSessionMap(epInfo->endpointUri);
-    if (session)
+    (void) arg;
+    applyEdgeThreadConfig(EDGE_THREAD_HELPER);
+    pthread_mutex_lock(&sessionClientMutex);
+    while (IS_NOT_NULL(connectHead))
     {
-        if (session->key)
+        ConnectRequest *request = connectHead;
+        connectHead = request->next;
+        if (IS_NULL(connectHead))
         {
-            free(session->key);
-            session->key = NULL;
+            connectTail = NULL;
         }
-        if (session->value)
+        bool cancelled = request->cancelled;
+        pthread_mutex_unlock(&sessionClientMutex);
+
+        if (!cancelled)
         {
-            UA_Client *m_client = (UA_Client*) session->value;
-            UA_Client_delete(m_client);
-            m_client = NULL;
+            connectClient(request->endpoint, &request->connectionConfig, request);
         }
-        free(session);
-        session = NULL;
-        clientCount--;
+
+        char ep[MAX_ADDRESS_SIZE];
+        keyValue storedKey = NULL;
+        pthread_mutex_lock(&sessionClientMutex);
+        if (formatAddressPort(request->endpoint, ep))
+        {
+            removeEdgeHashMapElement(connectingMap, (keyValue) ep, &storedKey);
+        }
+        if (IS_NOT_NULL(connectingMap) && 0 == getEdgeHashMapSize(connectingMap))
+        {
+            deleteEdgeHashMap(connectingMap);
+            connectingMap = NULL;
+        }
+        /* Wakes the requests waiting for the session */
+        pthread_cond_broadcast(&sessionPoolCond);
+        pthread_mutex_unlock(&sessionClientMutex);
+
+        EdgeFree(storedKey);
+        EdgeFree(request->endpoint);
+        EdgeFree(request);
+        pthread_mutex_lock(&sessionClientMutex);
+    }
+    connectWorkers--;
+    pthread_mutex_unlock(&sessionClientMutex);
+    return NULL;
+}
+
+bool connect_client_async(char *endpoint, const EdgeEndpointConfig *epConfig)
+{
+    VERIFY_NON_NULL_MSG(endpoint, "NULL endpoint in connect_client_async\n", false);
+    char ep[MAX_ADDRESS_SIZE];
+    COND_CHECK_MSG(!formatAddressPort(endpoint, ep), "Invalid endpoint in connect_client_async\n",
+            false);
+
+    ConnectRequest *request = (ConnectRequest *) EdgeCalloc(1, sizeof(ConnectRequest));
+    VERIFY_NON_NULL_MSG(request, "EdgeCalloc FAILED for ConnectRequest\n", false);
+    request->endpoint = cloneString(endpoint);
+    request->connectionConfig = UA_ClientConfig_default.localConnectionConfig;
+    applyTransportConfig(&request->connectionConfig, epConfig);
+    char *key = cloneString(ep);
+    if (IS_NULL(request->endpoint) || IS_NULL(key))
+    {
+        EDGE_LOG(TAG, "Memory allocation failed.");
+        EdgeFree(key);
+        EdgeFree(request->endpoint);
+        EdgeFree(request);
+        return false;
+    }
+
+    pthread_mutex_lock(&sessionClientMutex);
+    if (IS_NULL(connectingMap))
+    {
+        connectingMap = createEdgeHashMap(EDGE_HASH_STRING_KEY);
+    }
+    bool connecting = IS_NOT_NULL(getEdgeHashMapElement(connectingMap, (keyValue) ep));
+    bool queued = !connecting
+            && insertEdgeHashMapElement(connectingMap, (keyValue) key, (keyValue) request);
+    bool startWorker = false;
+    if (queued)
+    {
+        if (IS_NULL(connectTail))
+        {
+            connectHead = request;
+        }
+        else
+        {
+            connectTail->next = request;
+        }
+        connectTail = request;
+        startWorker = (connectWorkers < MAX_CONNECT_WORKERS);
+        if (startWorker)
+        {
+            connectWorkers++;
+        }
+    }
+    pthread_mutex_unlock(&sessionClientMutex);
+
+    if (!queued)
+    {
+        EDGE_LOG(TAG, connecting ? "client is already being connected.\n" :
+                "Error : connection could not be queued.\n");
+        EdgeFree(key);
+        EdgeFree(request->endpoint);
+        EdgeFree(request);
+        return false;
+    }
+
+    oc_thread worker = NULL;
+    if (startWorker)
+    {
+        if (OC_THREAD_SUCCESS == oc_thread_new(&worker, connectWorkerHandler, NULL))
+        {
+            oc_thread_detach(worker);
+            oc_thread_free(worker);
+        }
+        else
+        {
+            /* The queued connections are established on this thread instead */
+            EDGE_LOG(TAG, "Failed to start a connect worker.\n");
+            connectWorkerHandler(NULL);
+        }
+    }
+    return true;
+}
+
+void disconnect_client(EdgeEndPointInfo *epInfo)
+{
+    /* A connection which is still being established is dropped when it completes */
+    char ep[MAX_ADDRESS_SIZE];
+    if (formatAddressPort(epInfo->endpointUri, ep))
+    {
+        pthread_mutex_lock(&sessionClientMutex);
+        ConnectRequest *request = (ConnectRequest *) getEdgeHashMapElement(connectingMap,
+                (keyValue) ep);
+        if (IS_NOT_NULL(request))
+        {
+            request->cancelled = true;
+        }
+        pthread_mutex_unlock(&sessionClientMutex);
+    }
+
+    UA_Client *m_client = removeClientFromSessionMap(epInfo->endpointUri, true);
+    if (m_client)
+    {
+        UA_Client_delete(m_client);
+        m_client = NULL;
         g_statusCallback(epInfo, STATUS_STOP_CLIENT);
 
-        if (0 == clientCount)
+        pthread_mutex_lock(&sessionClientMutex);
+        clientCount--;
+        bool lastClient = (0 == clientCount);
+        if (lastClient)
         {
-            free(sessionClientMap);
+            deleteEdgeHashMap(sessionClientMap);
             sessionClientMap = NULL;
+            deleteEdgeHashMap(sessionUriMap);
+            sessionUriMap = NULL;
+            if (IS_NOT_NULL(sessionPoolMap))
+            {
+                deleteEdgeHashMap(sessionPoolMap);
+                sessionPoolMap = NULL;
+            }
+        }
+        pthread_mutex_unlock(&sessionClientMutex);
+
+        if (lastClient)
+        {
             /* Delete all the messages in send and receiver queue */
             delete_queue();
         }
     }
 }
 
+#ifndef DISABLE_DISCOVERY
 EdgeResult client_findServers(const char *endpointUri, size_t serverUrisSize,
     unsigned char **serverUris, size_t localeIdsSize, unsigned char **localeIds,
     size_t *registeredServersSize, EdgeApplicationConfig **registeredServers)
@@ -285,10 +1045,17 @@ EdgeResult client_getEndpoints(char *endpointUri)
 {
     return getEndpointsInternal(endpointUri);
 }
+#endif
 
-void registerClientCallback(response_cb_t resCallback, status_cb_t statusCallback, discovery_cb_t discoveryCallback)
+void registerClientCallback(response_cb_t resCallback, status_cb_t statusCallback,
+        discovery_cb_t discoveryCallback, discovery_cb_t deviceCallback)
 {
+#ifndef DISABLE_BROWSE
     registerBrowseResponseCallback(resCallback);
+#endif
     g_statusCallback = statusCallback;
+#ifndef DISABLE_DISCOVERY
     registerGetEndpointsCb(discoveryCallback);
+    registerNetworkDiscoveryCb(deviceCallback);
+#endif
 }
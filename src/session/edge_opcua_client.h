@@ -129,11 +129,25 @@ void setSupportedApplicationTypes(uint8_t supportedTypes);
 /**
  * @brief Establishes client connection
  * @param[in]  endpoint Endpoint Uri
+ * @param[in]  epConfig Endpoint configuration with the buffer and message sizes, can be NULL
  * @return @c true on success, false in case of error
  * @retval #true Successful
  * @retval #false Error
  */
-bool connect_client(char *endpoint);
+bool connect_client(char *endpoint, const EdgeEndpointConfig *epConfig);
+
+/**
+ * @brief Establishes client connection on a connect worker and returns at once. Connections to
+ *        several endpoints are established in parallel, each of them is reported by the status
+ *        callback with STATUS_CLIENT_STARTED or STATUS_CLIENT_CONNECT_FAILED.
+ *        Requests to the endpoint wait until its connection is established or has failed.
+ * @param[in]  endpoint Endpoint Uri
+ * @param[in]  epConfig Endpoint configuration with the buffer and message sizes, can be NULL
+ * @return @c true if the connection is queued, false in case of error
+ * @retval #true Successful
+ * @retval #false Error, or the endpoint is being connected already
+ */
+bool connect_client_async(char *endpoint, const EdgeEndpointConfig *epConfig);
 
 /**
  * @brief Close the client connection
@@ -206,6 +220,50 @@ void browseNodesInServer(EdgeMessage *msg);
  */
 EdgeResult callMethodInServer(EdgeMessage *msg);
 
+/**
+ * @brief Send the RegisterNodes or UnregisterNodes request data to server
+ * @param[in]  msg EdgeMessage request data.
+ * @return @c EdgeResult code is 0 on success, otherwise an error value
+ * @retval #STATUS_OK Successful
+ * @retval #STATUS_PARAM_INVALID Invalid parameter
+ * @retval #STATUS_ERROR Operation failed
+ */
+EdgeResult registerNodesInServer(EdgeMessage *msg);
+
+/**
+ * @brief Send the TranslateBrowsePathsToNodeIds request data to server
+ * @param[in]  msg EdgeMessage request data.
+ * @return @c EdgeResult code is 0 on success, otherwise an error value
+ * @retval #STATUS_OK Successful
+ * @retval #STATUS_PARAM_INVALID Invalid parameter
+ * @retval #STATUS_ERROR Operation failed
+ */
+EdgeResult translateBrowsePathsInServer(EdgeMessage *msg);
+
+/**
+ * @brief Send the HistoryRead requests of the request data to server
+ * @param[in]  msg EdgeMessage request data.
+ * @return @c EdgeResult code is 0 on success, otherwise an error value
+ * @retval #STATUS_OK Successful
+ * @retval #STATUS_PARAM_INVALID Invalid parameter
+ * @retval #STATUS_ERROR Operation failed
+ */
+EdgeResult historyReadInServer(EdgeMessage *msg);
+
+/**
+ * @brief Connects the lost session of an endpoint again when its backoff has ended
+ * @param[in]  msg Probe message queued by the reconnect timer.
+ */
+void reconnectClientInServer(EdgeMessage *msg);
+
+#ifdef ENABLE_ASYNC_SERVICES
+/**
+ * @brief Waits for the responses of the asynchronous requests sent to the server
+ * @param[in]  msg EdgeMessage queued by the asynchronous requests.
+ */
+void drainAsyncServicesInServer(EdgeMessage *msg);
+#endif
+
 /**
  * @brief Send the Subscription request data to server
  * @param[in]  msg EdgeMessage request data.
@@ -216,13 +274,43 @@ EdgeResult callMethodInServer(EdgeMessage *msg);
  */
 EdgeResult executeSubscriptionInServer(EdgeMessage *msg);
 
+/**
+ * @brief Sets the number of sessions opened to an endpoint at its next connection
+ * @param[in]  endpointUri Endpoint of the server.
+ * @param[in]  sessions Number of sessions, 0 or 1 for one session.
+ * @return @c EdgeResult code is 0 on success, otherwise an error value
+ * @retval #STATUS_OK Successful
+ * @retval #STATUS_PARAM_INVALID Invalid parameter
+ * @retval #STATUS_INTERNAL_ERROR Memory allocation failed
+ */
+EdgeResult setSessionPoolSizeInClient(const char *endpointUri, size_t sessions);
+
+/**
+ * @brief Gets the statistics of the sessions of an endpoint
+ * @param[in]  endpointUri Endpoint of the server.
+ * @param[out] stats Receives the statistics
+ * @return @c EdgeResult code is 0 on success, otherwise an error value
+ * @retval #STATUS_OK Successful
+ * @retval #STATUS_PARAM_INVALID Invalid parameter
+ * @retval #STATUS_ERROR Endpoint is not connected
+ */
+EdgeResult getClientStatsInClient(const char *endpointUri, EdgeClientStats *stats);
+
+/**
+ * @brief Formats the statistics of the sessions of all endpoints as Prometheus text
+ * @return Text, to be freed with EdgeFree(), NULL on failure
+ */
+char *getClientMetricsTextInClient(void);
+
 /**
  * @brief Register the client callback function
  * @param[in]  resCallback response callback
  * @param[in]  statusCallback status callback
  * @param[in]  discoveryCallback Discovery callback
+ * @param[in]  deviceCallback Callback of the servers appearing and disappearing on the network
  */
-void registerClientCallback(response_cb_t resCallback, status_cb_t statusCallback, discovery_cb_t discoveryCallback);
+void registerClientCallback(response_cb_t resCallback, status_cb_t statusCallback,
+        discovery_cb_t discoveryCallback, discovery_cb_t deviceCallback);
 
 #ifdef ENABLE_SUB_QUEUE
 keyValue getSessionClient(char *endpoint);
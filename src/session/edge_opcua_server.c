@@ -20,11 +20,17 @@
 
 #include "edge_opcua_server.h"
 #include "edge_node.h"
+#include "edge_nodeset.h"
+#include "edge_method_worker.h"
+#include "edge_server_stats.h"
+#include "edge_pubsub.h"
 #include "edge_utils.h"
 #include "edge_open62541.h"
-#include "edge_map.h"
+#include "edge_hash_map.h"
 #include "edge_logger.h"
 #include "edge_malloc.h"
+#include "umpscring.h"
+#include "edge_thread_config.h"
 
 #include <stdio.h>
 #ifndef _WIN32
@@ -33,30 +39,63 @@
 #include "pthread.h"
 #endif
 #include <open62541.h>
+#ifdef UA_ENABLE_MULTITHREADING
+#include <urcu.h>
+#endif
 
 #define TAG "session_server"
 
-typedef struct
+/* Default number of queued value updates, see EdgeEndpointConfig.updateQueueSize */
+#define DEFAULT_UPDATE_QUEUE_SIZE (4096)
+
+/* Longest wait of UA_Server_run_iterate() for network events, fixed by the library in ms */
+#define LIBRARY_ITERATE_TIMEOUT (50)
+
+/* Server instance, the process may run several of them */
+struct EdgeServer
 {
+    UA_ServerConfig *serverConfig;
+    UA_Server *server;
+    volatile UA_Boolean running;
+    pthread_t serverThread;
+
+    /* Namespace Map */
+    EdgeHashMap *namespaceMap;
+
+    /* Value updates of enqueueNodeUpdateInServer() */
+    u_mpsc_ring_t *updateRing;
+
+    /* Runtime statistics */
+    EdgeServerCounters *counters;
+
+    /* PubSub publishers of the nodes, scheduled by the server loop */
+    EdgePublisher *publishers;
+    pthread_mutex_t publishersMutex;
+};
+
+struct EdgeNamespace
+{
+    EdgeServer *server;
     uint16_t ns_index;
     char *rootNodeIdentifier;
     char *rootNodeBrowseName;
     char *rootNodeDisplayName;
-} EdgeNamespace;
-
-static UA_ServerConfig *m_serverConfig;
-static UA_Server *m_server;
-static UA_Boolean b_running = UA_FALSE;
+};
 
-static pthread_t m_serverThread;
-
-/* Namespace Map */
-static edgeMap *namespaceMap = NULL;
+/* Server of start_server(), which the functions without a server or namespace handle use */
+static EdgeServer *m_defaultServer = NULL;
 
 static int namespaceType = DEFAULT_TYPE;
 
 static status_cb_t g_statusCallback = NULL;
 
+/* Value update queued by a producer thread, applied by the server loop */
+typedef struct NodeUpdate
+{
+    EdgeVariableNode *node;
+    UA_Variant value;
+} NodeUpdate;
+
 void printNode(void *visitorContext, const UA_Node *node)
 {
     VERIFY_NON_NULL_NR_MSG(node, "UA_Node is null\n");
@@ -89,26 +128,28 @@ void printNode(void *visitorContext, const UA_Node *node)
 
 void printNodeListInServer()
 {
-    m_serverConfig->nodestore.iterate(m_serverConfig->nodestore.context, NULL, printNode);
+    VERIFY_NON_NULL_NR_MSG(m_defaultServer, "Server is not running\n");
+    UA_ServerConfig *config = m_defaultServer->serverConfig;
+    config->nodestore.iterate(config->nodestore.context, NULL, printNode);
 }
 
-static void* getNamespaceIndex(const char *namespaceUri)
+static void* getNamespaceIndex(const EdgeServer *server, const char *namespaceUri)
 {
-    VERIFY_NON_NULL_MSG(namespaceMap, "", NULL);
-    edgeMapNode *temp = namespaceMap->head;
-    while (temp != NULL)
-    {
-        char *uri = (char*) temp->key;
-        if (!strcmp(uri, namespaceUri))
-            return temp->value;
-
-        temp = temp->next;
-    }
-    return NULL;
+    VERIFY_NON_NULL_MSG(server, "", NULL);
+    VERIFY_NON_NULL_MSG(server->namespaceMap, "", NULL);
+    return getEdgeHashMapElement(server->namespaceMap, (keyValue) namespaceUri);
 }
 
 EdgeResult createNamespaceInServer(const char *namespaceUri, const char *rootNodeIdentifier,
 		const char *rootNodeBrowseName,	const char *rootNodeDisplayName)
+{
+    return createNamespaceInServerInstance(m_defaultServer, namespaceUri, rootNodeIdentifier,
+            rootNodeBrowseName, rootNodeDisplayName);
+}
+
+EdgeResult createNamespaceInServerInstance(EdgeServer *server, const char *namespaceUri,
+        const char *rootNodeIdentifier, const char *rootNodeBrowseName,
+        const char *rootNodeDisplayName)
 {
     EdgeResult result = { STATUS_PARAM_INVALID };
     VERIFY_NON_NULL_MSG(namespaceUri, "", result);
@@ -117,13 +158,23 @@ EdgeResult createNamespaceInServer(const char *namespaceUri, const char *rootNod
     VERIFY_NON_NULL_MSG(rootNodeDisplayName, "", result);
 
     COND_CHECK((namespaceType != URI_TYPE && namespaceType != DEFAULT_TYPE), result);
-    COND_CHECK_MSG((getNamespaceIndex(namespaceUri)), "Namespace already added\n", result);
+    result.code = STATUS_ERROR;
+    VERIFY_NON_NULL_MSG(server, "Server is not running\n", result);
+    result.code = STATUS_PARAM_INVALID;
+    COND_CHECK_MSG((getNamespaceIndex(server, namespaceUri)), "Namespace already added\n", result);
 
     result.code = STATUS_OK;
-    uint16_t idx = UA_Server_addNamespace(m_server, namespaceUri);
+    uint16_t idx = UA_Server_addNamespace(server->server, namespaceUri);
     EDGE_LOG_V(TAG, "[SERVER] Namespace with Index Created:: [%d]\n", idx);
 
     EdgeNamespace *ns = (EdgeNamespace*) EdgeCalloc(1, sizeof(EdgeNamespace));
+    if(IS_NULL(ns))
+    {
+        EDGE_LOG(TAG, "Memory allocation failed.");
+        result.code = STATUS_ERROR;
+        return result;
+    }
+    ns->server = server;
     ns->ns_index = idx;
     ns->rootNodeIdentifier = (char*) EdgeMalloc(sizeof(char) * (strlen(rootNodeIdentifier)+1));
     if(IS_NULL(ns->rootNodeIdentifier))
@@ -149,9 +200,13 @@ EdgeResult createNamespaceInServer(const char *namespaceUri, const char *rootNod
     }
     strncpy(ns->rootNodeDisplayName, rootNodeDisplayName, strlen(rootNodeDisplayName)+1);
 
-    if (namespaceMap == NULL)
-        namespaceMap = createMap();
-    insertMapElement(namespaceMap, (keyValue) namespaceUri, (keyValue) ns);
+    if (server->namespaceMap == NULL)
+        server->namespaceMap = createEdgeHashMap(EDGE_HASH_STRING_KEY);
+    if (!insertEdgeHashMapElement(server->namespaceMap, (keyValue) namespaceUri, (keyValue) ns))
+    {
+        EDGE_LOG(TAG, "Failed to add the namespace to the namespace map.");
+        goto NAMESPACE_ERROR;
+    }
     return result;
 
 NAMESPACE_ERROR:
@@ -164,15 +219,181 @@ NAMESPACE_ERROR:
     return result;
 }
 
+EdgeNamespace *getNamespaceInServer(const char *namespaceUri)
+{
+    return getNamespaceInServerInstance(m_defaultServer, namespaceUri);
+}
+
+EdgeNamespace *getNamespaceInServerInstance(const EdgeServer *server, const char *namespaceUri)
+{
+    VERIFY_NON_NULL_MSG(namespaceUri, "", NULL);
+    return (EdgeNamespace*) getNamespaceIndex(server, namespaceUri);
+}
+
+EdgeResult addNodesInNamespace(const EdgeNamespace *ns, EdgeNodeItem *item)
+{
+    EdgeResult result = { STATUS_PARAM_INVALID};
+    VERIFY_NON_NULL_MSG(ns, "", result);
+    VERIFY_NON_NULL_MSG(item, "", result);
+    result = addNodes(ns->server->server, ns->ns_index, item);
+    return result;
+}
+
 EdgeResult addNodesInServer(const char *namespaceUri, EdgeNodeItem *item)
 {
     EdgeResult result = { STATUS_PARAM_INVALID};
     VERIFY_NON_NULL_MSG(namespaceUri, "", result);
     VERIFY_NON_NULL_MSG(item, "", result);
     result.code = STATUS_ERROR;
-    EdgeNamespace *ns = (EdgeNamespace*) getNamespaceIndex(namespaceUri);
+    EdgeNamespace *ns = (EdgeNamespace*) getNamespaceIndex(m_defaultServer, namespaceUri);
     VERIFY_NON_NULL_MSG(ns, "", result);
-    result = addNodes(m_server, ns->ns_index, item);
+    return addNodesInNamespace(ns, item);
+}
+
+EdgeResult loadNodesetInNamespace(const EdgeNamespace *ns, const char *path)
+{
+    EdgeResult result = { STATUS_PARAM_INVALID};
+    VERIFY_NON_NULL_MSG(ns, "", result);
+    VERIFY_NON_NULL_MSG(path, "", result);
+    result = loadNodesetFile(ns->server->server, ns->ns_index, path);
+    return result;
+}
+
+EdgeResult loadNodesetInServer(const char *namespaceUri, const char *path)
+{
+    EdgeResult result = { STATUS_PARAM_INVALID};
+    VERIFY_NON_NULL_MSG(namespaceUri, "", result);
+    VERIFY_NON_NULL_MSG(path, "", result);
+    result.code = STATUS_ERROR;
+    EdgeNamespace *ns = (EdgeNamespace*) getNamespaceIndex(m_defaultServer, namespaceUri);
+    VERIFY_NON_NULL_MSG(ns, "", result);
+    return loadNodesetInNamespace(ns, path);
+}
+
+/**
+ * @brief getReferenceNamespaces - Resolves the namespaces of a reference
+ * @param reference - Node reference information
+ * @param indexes - Receives the source and the target namespace indexes
+ * @return true if both namespaces exist, otherwise false
+ */
+static bool getReferenceNamespaces(const EdgeReference *reference, uint16_t *indexes)
+{
+    VERIFY_NON_NULL_MSG(reference, "NULL reference in the batch\n", false);
+    VERIFY_NON_NULL_MSG(reference->sourcePath, "NULL source path in the batch\n", false);
+    VERIFY_NON_NULL_MSG(reference->targetPath, "NULL target path in the batch\n", false);
+    VERIFY_NON_NULL_MSG(reference->sourceNamespace, "NULL source namespace in the batch\n", false);
+    VERIFY_NON_NULL_MSG(reference->targetNamespace, "NULL target namespace in the batch\n", false);
+    EdgeNamespace *src_ns = (EdgeNamespace*) getNamespaceIndex(m_defaultServer, reference->sourceNamespace);
+    VERIFY_NON_NULL_MSG(src_ns, "Unknown source namespace in the batch\n", false);
+    EdgeNamespace *target_ns = (EdgeNamespace*) getNamespaceIndex(m_defaultServer, reference->targetNamespace);
+    VERIFY_NON_NULL_MSG(target_ns, "Unknown target namespace in the batch\n", false);
+    indexes[0] = src_ns->ns_index;
+    indexes[1] = target_ns->ns_index;
+    return true;
+}
+
+EdgeResult addNodeItemsInServer(const char *namespaceUri, EdgeNodeItem **items, size_t itemCount,
+        EdgeReference **references, size_t referenceCount)
+{
+    EdgeResult result = { STATUS_PARAM_INVALID};
+    VERIFY_NON_NULL_MSG(namespaceUri, "", result);
+    COND_CHECK_MSG((itemCount > 0 && IS_NULL(items)), "NULL node items\n", result);
+    COND_CHECK_MSG((referenceCount > 0 && IS_NULL(references)), "NULL references\n", result);
+    EdgeNamespace *ns = (EdgeNamespace*) getNamespaceIndex(m_defaultServer, namespaceUri);
+    VERIFY_NON_NULL_MSG(ns, "Unknown namespace of the nodes\n", result);
+
+    /* Everything is validated before the first node is added, so a bad batch adds nothing */
+    for (size_t i = 0; i < itemCount; i++)
+    {
+        VERIFY_NON_NULL_MSG(items[i], "NULL node item in the batch\n", result);
+        VERIFY_NON_NULL_MSG(items[i]->browseName, "NULL browse name in the batch\n", result);
+    }
+
+    uint16_t *refIndexes = NULL;
+    if (referenceCount > 0)
+    {
+        result.code = STATUS_ERROR;
+        refIndexes = (uint16_t *) EdgeCalloc(referenceCount * 2, sizeof(uint16_t));
+        VERIFY_NON_NULL_MSG(refIndexes, "EdgeCalloc failed for the reference namespaces\n", result);
+        for (size_t i = 0; i < referenceCount; i++)
+        {
+            if (!getReferenceNamespaces(references[i], &refIndexes[i * 2]))
+            {
+                EdgeFree(refIndexes);
+                result.code = STATUS_PARAM_INVALID;
+                return result;
+            }
+        }
+    }
+
+    result.code = STATUS_OK;
+    for (size_t i = 0; i < itemCount; i++)
+    {
+        addNodes(ns->server->server, ns->ns_index, items[i]);
+    }
+
+    /* References go last, so that they can link any two nodes of the batch */
+    for (size_t i = 0; i < referenceCount; i++)
+    {
+        EdgeResult refResult = addReferences(ns->server->server, references[i], refIndexes[i * 2],
+                refIndexes[i * 2 + 1]);
+        if (STATUS_OK != refResult.code)
+        {
+            result = refResult;
+        }
+    }
+    EdgeFree(refIndexes);
+    EDGE_LOG_V(TAG, "[SERVER] Batch of %zu nodes and %zu references added\n", itemCount,
+            referenceCount);
+    return result;
+}
+
+#ifdef UA_ENABLE_MULTITHREADING
+/* Set once the thread is registered with the RCU of open62541 */
+static EDGE_THREAD_LOCAL bool rcuRegistered = false;
+static pthread_key_t rcuKey;
+static pthread_once_t rcuOnce = PTHREAD_ONCE_INIT;
+
+static void unregisterRcuThread(void *data)
+{
+    rcu_unregister_thread();
+}
+
+static void createRcuKey(void)
+{
+    pthread_key_create(&rcuKey, unregisterRcuThread);
+}
+
+/**
+ * @brief registerRcuThread - Registers the calling thread with RCU until it exits.
+ *        With several server threads the workers of open62541 edit the nodestore while
+ *        application threads modify nodes, under RCU read locks which are only valid in
+ *        registered threads
+ */
+static void registerRcuThread(void)
+{
+    if (rcuRegistered)
+    {
+        return;
+    }
+    pthread_once(&rcuOnce, createRcuKey);
+    rcu_register_thread();
+    /* Any non-NULL value makes the key run its destructor when the thread exits */
+    pthread_setspecific(rcuKey, &rcuRegistered);
+    rcuRegistered = true;
+}
+#endif
+
+EdgeResult modifyNodeInNamespace(const EdgeNamespace *ns, const char *nodeUri, EdgeVersatility *value)
+{
+    EdgeResult result = { STATUS_PARAM_INVALID};
+    VERIFY_NON_NULL_MSG(ns, "", result);
+    VERIFY_NON_NULL_MSG(nodeUri, "", result);
+    VERIFY_NON_NULL_MSG(value, "", result);
+#ifdef UA_ENABLE_MULTITHREADING
+    registerRcuThread();
+#endif
+    result = modifyNode(ns->server->server, ns->ns_index, nodeUri, value);
     return result;
 }
 
@@ -183,12 +404,42 @@ EdgeResult modifyNodeInServer(const char *namespaceUri, const char *nodeUri, Edg
     VERIFY_NON_NULL_MSG(nodeUri, "", result);
     VERIFY_NON_NULL_MSG(value, "", result);
     result.code = STATUS_ERROR;
-    EdgeNamespace *ns = (EdgeNamespace*) getNamespaceIndex(namespaceUri);
+    EdgeNamespace *ns = (EdgeNamespace*) getNamespaceIndex(m_defaultServer, namespaceUri);
+    VERIFY_NON_NULL_MSG(ns, "", result);
+    return modifyNodeInNamespace(ns, nodeUri, value);
+}
+
+EdgeResult modifyNodesInNamespace(const EdgeNamespace *ns, const char **nodeUris,
+        EdgeVersatility **values, size_t count)
+{
+    EdgeResult result = { STATUS_PARAM_INVALID};
     VERIFY_NON_NULL_MSG(ns, "", result);
-    result = modifyNode(m_server, ns->ns_index, nodeUri, value);
+    COND_CHECK((0 == count), result);
+    VERIFY_NON_NULL_MSG(nodeUris, "", result);
+    VERIFY_NON_NULL_MSG(values, "", result);
+    for (size_t i = 0; i < count; i++)
+    {
+        VERIFY_NON_NULL_MSG(nodeUris[i], "NULL node uri in the batch\n", result);
+        VERIFY_NON_NULL_MSG(values[i], "NULL value in the batch\n", result);
+    }
+#ifdef UA_ENABLE_MULTITHREADING
+    registerRcuThread();
+#endif
+    result = modifyNodes(ns->server->server, ns->ns_index, nodeUris, values, count);
     return result;
 }
 
+EdgeResult modifyNodesInServer(const char *namespaceUri, const char **nodeUris,
+        EdgeVersatility **values, size_t count)
+{
+    EdgeResult result = { STATUS_PARAM_INVALID};
+    VERIFY_NON_NULL_MSG(namespaceUri, "", result);
+    result.code = STATUS_ERROR;
+    EdgeNamespace *ns = (EdgeNamespace*) getNamespaceIndex(m_defaultServer, namespaceUri);
+    VERIFY_NON_NULL_MSG(ns, "", result);
+    return modifyNodesInNamespace(ns, nodeUris, values, count);
+}
+
 EdgeResult addReferenceInServer(EdgeReference *reference)
 {
     EdgeResult result = { STATUS_PARAM_INVALID};
@@ -196,25 +447,43 @@ EdgeResult addReferenceInServer(EdgeReference *reference)
     VERIFY_NON_NULL_MSG(reference->sourceNamespace, "", result);
     VERIFY_NON_NULL_MSG(reference->targetNamespace, "", result);
     result.code = STATUS_ERROR;
-    EdgeNamespace *src_ns = (EdgeNamespace*) getNamespaceIndex(reference->sourceNamespace);
+    EdgeNamespace *src_ns = (EdgeNamespace*) getNamespaceIndex(m_defaultServer, reference->sourceNamespace);
     VERIFY_NON_NULL_MSG(src_ns, "", result);
-    EdgeNamespace *target_ns = (EdgeNamespace*) getNamespaceIndex(reference->targetNamespace);
+    EdgeNamespace *target_ns = (EdgeNamespace*) getNamespaceIndex(m_defaultServer, reference->targetNamespace);
     VERIFY_NON_NULL_MSG(target_ns, "", result);
-    result = addReferences(m_server, reference, src_ns->ns_index, target_ns->ns_index);
+    result = addReferences(src_ns->server->server, reference, src_ns->ns_index,
+            target_ns->ns_index);
+    return result;
+}
+
+EdgeResult addMethodNodeInNamespace(const EdgeNamespace *ns, EdgeNodeItem *item, EdgeMethod *method,
+        method_view_func viewFn, bool runAsync)
+{
+    EdgeResult result = { STATUS_PARAM_INVALID};
+    VERIFY_NON_NULL_MSG(ns, "", result);
+    VERIFY_NON_NULL_MSG(item, "", result);
+    VERIFY_NON_NULL_MSG(method, "", result);
+    result = addMethodNode(ns->server->server, ns->ns_index, item, method, viewFn,
+            runAsync);
     return result;
 }
 
-EdgeResult addMethodNodeInServer(const char *namespaceUri, EdgeNodeItem *item, EdgeMethod *method)
+EdgeResult addMethodNodeInServer(const char *namespaceUri, EdgeNodeItem *item, EdgeMethod *method,
+        method_view_func viewFn, bool runAsync)
 {
     EdgeResult result = { STATUS_PARAM_INVALID};
     VERIFY_NON_NULL_MSG(namespaceUri, "", result);
     VERIFY_NON_NULL_MSG(item, "", result);
     VERIFY_NON_NULL_MSG(method, "", result);
     result.code = STATUS_ERROR;
-    EdgeNamespace *ns = (EdgeNamespace*) getNamespaceIndex(namespaceUri);
+    EdgeNamespace *ns = (EdgeNamespace*) getNamespaceIndex(m_defaultServer, namespaceUri);
     VERIFY_NON_NULL_MSG(ns, "", result);
-    result = addMethodNode(m_server, ns->ns_index, item, method);
-    return result;
+    return addMethodNodeInNamespace(ns, item, method, viewFn, runAsync);
+}
+
+void setMethodWorkersInServer(uint32_t count)
+{
+    setMethodWorkerThreads(count);
 }
 
 EdgeNodeItem* createVariableNodeItemImpl(const char* name, int type, void* data,
@@ -237,6 +506,21 @@ EdgeNodeItem* createVariableNodeItemImpl(const char* name, int type, void* data,
     return item;
 }
 
+EdgeNodeItem* createDataSourceNodeItemImpl(const char* name, int type, EdgeIdentifier nodeType,
+        data_source_read_func readFn, data_source_write_func writeFn, void *context,
+        double minimumInterval)
+{
+    VERIFY_NON_NULL_MSG(readFn, "NULL read callback of the data source node\n", NULL);
+    COND_CHECK_MSG((nodeType != VARIABLE_NODE && nodeType != ARRAY_NODE),
+            "Data source node must be a variable or array node\n", NULL);
+    EdgeNodeItem* item = createVariableNodeItemImpl(name, type, NULL, nodeType, minimumInterval);
+    VERIFY_NON_NULL_MSG(item, "", NULL);
+    item->read_fn = readFn;
+    item->write_fn = writeFn;
+    item->dataSourceContext = context;
+    return item;
+}
+
 EdgeNodeItem* createNodeItemImpl(const char* name, EdgeIdentifier nodeType, EdgeNodeId *sourceNodeId)
 {
     VERIFY_NON_NULL_MSG(name, "", NULL);
@@ -257,125 +541,384 @@ EdgeNodeItem* createNodeItemImpl(const char* name, EdgeIdentifier nodeType, Edge
 EdgeResult deleteNodeItemImpl(EdgeNodeItem* item)
 {
     EdgeResult result;
-    free(item);
+    EdgeFree(item);
+    result.code = STATUS_OK;
+    return result;
+}
+
+EdgeVariableNode *getVariableNodeInNamespace(const EdgeNamespace *ns, const char *nodeUri)
+{
+    VERIFY_NON_NULL_MSG(ns, "NULL namespace in getVariableNodeInNamespace\n", NULL);
+    VERIFY_NON_NULL_MSG(nodeUri, "NULL node uri in getVariableNodeInNamespace\n", NULL);
+    return getVariableNode(ns->server->server, ns->ns_index, nodeUri);
+}
+
+EdgeResult enqueueNodeUpdateInServer(EdgeVariableNode *node, const EdgeVersatility *value)
+{
+    EdgeResult result = { STATUS_PARAM_INVALID };
+    VERIFY_NON_NULL_MSG(node, "", result);
+    VERIFY_NON_NULL_MSG(value, "", result);
+    VERIFY_NON_NULL_MSG(value->value, "", result);
+    result.code = STATUS_ERROR;
+    EdgeServer *server = (EdgeServer *) getVariableNodeContext(node);
+    VERIFY_NON_NULL_MSG(server->updateRing, "Queued value updates are not available\n", result);
+
+    NodeUpdate update;
+    update.node = node;
+    if (copyVariableNodeValue(node, value, &update.value) != UA_STATUSCODE_GOOD)
+    {
+        EDGE_LOG(TAG, "Failed to copy the value of the update\n");
+        return result;
+    }
+    if (CA_STATUS_OK != u_mpsc_ring_push(server->updateRing, &update))
+    {
+        EDGE_LOG(TAG, "Update queue is full\n");
+        UA_Variant_deleteMembers(&update.value);
+        result.code = STATUS_ENQUEUE_ERROR;
+        return result;
+    }
     result.code = STATUS_OK;
     return result;
 }
 
+/**
+ * @brief applyNodeUpdates - Writes the queued value updates to their nodes
+ * @param server - server of the updates
+ * @param limit - maximum number of updates to apply, so that producers cannot starve the loop
+ */
+static void applyNodeUpdates(EdgeServer *server, uint32_t limit)
+{
+    NodeUpdate update;
+    uint32_t count = 0;
+    while (count < limit && u_mpsc_ring_pop(server->updateRing, &update))
+    {
+        writeVariableNodeValue(server->server, update.node, &update.value);
+        UA_Variant_deleteMembers(&update.value);
+        count++;
+    }
+    recordServerUpdates(server->counters, count);
+}
+
+/**
+ * @brief wakeServerLoop - Repeated callback which only bounds the wait of UA_Server_run_iterate(),
+ *        so that the server loop applies queued updates and method results at least that often
+ * @param server - server handle
+ * @param data - unused
+ */
+static void wakeServerLoop(UA_Server *server, void *data)
+{
+}
+
+/**
+ * @brief schedulePublishers - Starts new publishers and deletes retired ones in the server loop,
+ *        which owns the repeated callbacks of the server
+ * @param server - server of the publishers
+ */
+static void schedulePublishers(EdgeServer *server)
+{
+    pthread_mutex_lock(&server->publishersMutex);
+    scheduleUadpPublishers(server->server, &server->publishers);
+    pthread_mutex_unlock(&server->publishersMutex);
+}
+
 static void *server_loop(void *ptr)
 {
-    while (b_running)
+    applyEdgeThreadConfig(EDGE_THREAD_SERVER);
+    EdgeServer *server = (EdgeServer *) ptr;
+    uint32_t capacity = u_mpsc_ring_capacity(server->updateRing);
+    bindServerCounters(server->counters);
+#ifdef UA_ENABLE_MULTITHREADING
+    registerRcuThread();
+#endif
+    while (server->running)
     {
-        UA_Server_run_iterate(m_server, true);
+        UA_Server_run_iterate(server->server, true);
+        deliverMethodResults(server->server);
+        applyNodeUpdates(server, capacity);
+        schedulePublishers(server);
     }
 
+    bindServerCounters(NULL);
     EDGE_LOG(TAG, " [SERVER] server loop exit\n");
     return NULL;
 }
 
 EdgeResult start_server(EdgeEndPointInfo *epInfo)
+{
+    EdgeResult result = { STATUS_ALREADY_INIT };
+    VERIFY_NON_NULL_MSG(!m_defaultServer, "Server already started\n", result);
+    return startServerInstance(epInfo, &m_defaultServer);
+}
+
+EdgeResult startServerInstance(EdgeEndPointInfo *epInfo, EdgeServer **instance)
 {
     EdgeResult result = { STATUS_PARAM_INVALID };
     VERIFY_NON_NULL_MSG(epInfo, "", result);
     VERIFY_NON_NULL_MSG(epInfo->endpointConfig, "", result);
     VERIFY_NON_NULL_MSG(epInfo->appConfig, "", result);
+    VERIFY_NON_NULL_MSG(instance, "", result);
 
-    result.code = STATUS_OK;
+    result.code = STATUS_ERROR;
     EdgeEndpointConfig *epConfig = epInfo->endpointConfig;
     EdgeApplicationConfig *appConfig = epInfo->appConfig;
 
     //UA_ByteString certificate = loadCertificate();
-    //m_serverConfig = UA_ServerConfig_new_default();    //UA_ServerConfig_new_minimal(4840, &certificate);
-    m_serverConfig = UA_ServerConfig_new_minimal(epConfig->bindPort, NULL);
-
-    UA_String_deleteMembers(&m_serverConfig->applicationDescription.applicationUri);
-    UA_LocalizedText_deleteMembers(&m_serverConfig->applicationDescription.applicationName);
-    UA_String_deleteMembers(&m_serverConfig->applicationDescription.productUri);
-    UA_String_deleteMembers(&m_serverConfig->buildInfo.productUri);
-    UA_String_deleteMembers(&m_serverConfig->buildInfo.manufacturerName);
-    UA_String_deleteMembers(&m_serverConfig->buildInfo.productName);
-    UA_String_deleteMembers(&m_serverConfig->buildInfo.softwareVersion);
-    UA_String_deleteMembers(&m_serverConfig->buildInfo.buildNumber);
-
-    UA_String_deleteMembers(&m_serverConfig->endpoints->endpointDescription.server.applicationUri);
+    //config = UA_ServerConfig_new_default();    //UA_ServerConfig_new_minimal(4840, &certificate);
+    UA_ServerConfig *config = UA_ServerConfig_new_minimal(epConfig->bindPort, NULL);
+    VERIFY_NON_NULL_MSG(config, "UA_ServerConfig_new_minimal failed\n", result);
+
+    UA_String_deleteMembers(&config->applicationDescription.applicationUri);
+    UA_LocalizedText_deleteMembers(&config->applicationDescription.applicationName);
+    UA_String_deleteMembers(&config->applicationDescription.productUri);
+    UA_String_deleteMembers(&config->buildInfo.productUri);
+    UA_String_deleteMembers(&config->buildInfo.manufacturerName);
+    UA_String_deleteMembers(&config->buildInfo.productName);
+    UA_String_deleteMembers(&config->buildInfo.softwareVersion);
+    UA_String_deleteMembers(&config->buildInfo.buildNumber);
+
+    UA_String_deleteMembers(&config->endpoints->endpointDescription.server.applicationUri);
     UA_LocalizedText_deleteMembers(
-            &m_serverConfig->endpoints->endpointDescription.server.applicationName);
+            &config->endpoints->endpointDescription.server.applicationName);
 
-    m_serverConfig->applicationDescription.applicationUri = UA_STRING_ALLOC(
+    config->applicationDescription.applicationUri = UA_STRING_ALLOC(
             appConfig->applicationUri);
-    m_serverConfig->applicationDescription.applicationName = UA_LOCALIZEDTEXT_ALLOC("en-US",
+    config->applicationDescription.applicationName = UA_LOCALIZEDTEXT_ALLOC("en-US",
             appConfig->applicationName);
-    m_serverConfig->applicationDescription.productUri = UA_STRING_ALLOC(appConfig->productUri);
-    m_serverConfig->applicationDescription.applicationType = convertEdgeApplicationType(
+    config->applicationDescription.productUri = UA_STRING_ALLOC(appConfig->productUri);
+    config->applicationDescription.applicationType = convertEdgeApplicationType(
             appConfig->applicationType);
 
-    m_serverConfig->buildInfo.productUri = UA_STRING_ALLOC("/edge");
-    m_serverConfig->buildInfo.manufacturerName = UA_STRING_ALLOC("samsung");
-    m_serverConfig->buildInfo.productName = UA_STRING_ALLOC("edgeSolution");
-    m_serverConfig->buildInfo.softwareVersion = UA_STRING_ALLOC("0.9");
-    m_serverConfig->buildInfo.buildNumber = UA_STRING_ALLOC("0.1");
+    config->buildInfo.productUri = UA_STRING_ALLOC("/edge");
+    config->buildInfo.manufacturerName = UA_STRING_ALLOC("samsung");
+    config->buildInfo.productName = UA_STRING_ALLOC("edgeSolution");
+    config->buildInfo.softwareVersion = UA_STRING_ALLOC("0.9");
+    config->buildInfo.buildNumber = UA_STRING_ALLOC("0.1");
 
-    m_serverConfig->endpoints->endpointDescription.server.applicationUri = UA_STRING_ALLOC(
+    config->endpoints->endpointDescription.server.applicationUri = UA_STRING_ALLOC(
             appConfig->applicationUri);
-    m_serverConfig->endpoints->endpointDescription.server.applicationName = UA_LOCALIZEDTEXT_ALLOC(
+    config->endpoints->endpointDescription.server.applicationName = UA_LOCALIZEDTEXT_ALLOC(
             "en-US", appConfig->applicationName);
 
     UA_DurationRange duration;
 
     duration.min = 1.0;
     duration.max = 24.0 * 3600.0 * 1000.0;
-    m_serverConfig->samplingIntervalLimits = duration;
+    config->samplingIntervalLimits = duration;
 
     duration.min = 5.0;
     duration.max = 3600.0 * 1000.0;
-    m_serverConfig->publishingIntervalLimits = duration;
+    config->publishingIntervalLimits = duration;
 
     UA_UInt32Range range;
 
     range.min = 0;
     range.max = 100;
-    m_serverConfig->keepAliveCountLimits = range;
+    config->keepAliveCountLimits = range;
+
+    UA_ConnectionConfig connectionConfig = UA_ConnectionConfig_default;
+    if (applyTransportConfig(&connectionConfig, epConfig))
+    {
+        /* The network layer keeps a copy of the connection config it was created with */
+        config->networkLayers[0].deleteMembers(&config->networkLayers[0]);
+        config->networkLayers[0] = UA_ServerNetworkLayerTCP(connectionConfig,
+                (UA_UInt16) epConfig->bindPort);
+    }
+
+#ifdef UA_ENABLE_MULTITHREADING
+    if (epConfig->serverThreads > 0)
+    {
+        config->nThreads = epConfig->serverThreads;
+    }
+#else
+    if (epConfig->serverThreads > 1)
+    {
+        EDGE_LOG(TAG, "\n [SERVER] open62541 is built without multithreading, using one thread \n");
+    }
+#endif
+
+    EdgeServer *server = (EdgeServer *) EdgeCalloc(1, sizeof(EdgeServer));
+    if (IS_NULL(server))
+    {
+        EDGE_LOG(TAG, "\n [SERVER] Memory allocation failed \n");
+        UA_ServerConfig_delete(config);
+        return result;
+    }
+    server->serverConfig = config;
+    pthread_mutex_init(&server->publishersMutex, NULL);
+
+    /* The hooks of the counters go into the config before the server copies it */
+    server->counters = createServerCounters(config);
+    if (IS_NULL(server->counters))
+    {
+        EDGE_LOG(TAG, "\n [SERVER] Error in creating server statistics \n");
+        goto START_ERROR;
+    }
 
     //    UA_ByteString_deleteMembers(&certificate);
-    m_server = UA_Server_new(m_serverConfig);
+    server->server = UA_Server_new(config);
+    if (IS_NULL(server->server)
+            || STATUS_OK != registerServerNodes(server->server, server).code)
+    {
+        EDGE_LOG(TAG, "\n [SERVER] Error in creating server \n");
+        goto START_ERROR;
+    }
+    setServerCountersServer(server->counters, server->server);
+    if (epConfig->writeOnChange)
+    {
+        /* The server shares the nodestore of the configuration, which lives as long as it */
+        setServerNodesWriteOnChange(server->server, &config->nodestore);
+    }
 
-    EDGE_LOG(TAG, "\n [SERVER] starting server \n");
-    UA_StatusCode retval = UA_Server_run_startup(m_server);
+    if (epConfig->iterateTimeout > 0 && epConfig->iterateTimeout < LIBRARY_ITERATE_TIMEOUT)
+    {
+        UA_UInt64 callbackId = 0;
+        if (UA_Server_addRepeatedCallback(server->server, wakeServerLoop, NULL,
+                epConfig->iterateTimeout, &callbackId) != UA_STATUSCODE_GOOD)
+        {
+            EDGE_LOG(TAG, "\n [SERVER] Failed to set the iterate timeout \n");
+        }
+    }
 
+    EDGE_LOG(TAG, "\n [SERVER] starting server \n");
+    UA_StatusCode retval = UA_Server_run_startup(server->server);
     if (retval != UA_STATUSCODE_GOOD)
     {
         EDGE_LOG(TAG, "\n [SERVER] Error in starting server \n");
-        b_running = UA_FALSE;
+        goto START_ERROR;
+    }
 
-        result.code = STATUS_ERROR;
-        return result;
+    EDGE_LOG(TAG, "\n ========= [SERVER] Server Start successful ============= \n");
+    uint32_t updateQueueSize = epConfig->updateQueueSize ? epConfig->updateQueueSize
+            : DEFAULT_UPDATE_QUEUE_SIZE;
+    server->updateRing = u_mpsc_ring_create(updateQueueSize, sizeof(NodeUpdate));
+    if (IS_NULL(server->updateRing))
+    {
+        EDGE_LOG(TAG, "\n [SERVER] Queued value updates are not available \n");
     }
-    else
+    server->running = UA_TRUE;
+    if (!startMethodWorkers())
     {
-        EDGE_LOG(TAG, "\n ========= [SERVER] Server Start successful ============= \n");
-        b_running = UA_TRUE;
-        pthread_create(&m_serverThread, NULL, &server_loop, NULL);
-        g_statusCallback(epInfo, STATUS_SERVER_STARTED);
-        //return (new EdgeResult::Builder(STATUS_OK))->build();
+        EDGE_LOG(TAG, "\n [SERVER] Asynchronous methods are not available \n");
+    }
+    pthread_create(&server->serverThread, NULL, &server_loop, server);
+    *instance = server;
+    g_statusCallback(epInfo, STATUS_SERVER_STARTED);
+    //return (new EdgeResult::Builder(STATUS_OK))->build();
 
-        result.code = STATUS_OK;
-        return result;
+    result.code = STATUS_OK;
+    return result;
+
+START_ERROR:
+    if (IS_NOT_NULL(server->server))
+    {
+        UA_Server_delete(server->server);
+        deleteServerNodes(server->server);
     }
+    UA_ServerConfig_delete(config);
+    deleteServerCounters(server->counters);
+    pthread_mutex_destroy(&server->publishersMutex);
+    EdgeFree(server);
+    return result;
 }
 
 void stop_server(EdgeEndPointInfo *epInfo)
 {
-    b_running = false;
-    pthread_join(m_serverThread, NULL);
-    UA_Server_run_shutdown(m_server);
-    UA_Server_delete(m_server);
-    UA_ServerConfig_delete(m_serverConfig);
+    VERIFY_NON_NULL_NR_MSG(m_defaultServer, "Server is not running\n");
+    EdgeServer *server = m_defaultServer;
+    m_defaultServer = NULL;
+    stopServerInstance(server, epInfo);
+}
+
+void stopServerInstance(EdgeServer *server, EdgeEndPointInfo *epInfo)
+{
+    VERIFY_NON_NULL_NR_MSG(server, "NULL server in stopServerInstance\n");
+    server->running = false;
+    pthread_join(server->serverThread, NULL);
+    if (IS_NOT_NULL(server->updateRing))
+    {
+        applyNodeUpdates(server, u_mpsc_ring_capacity(server->updateRing));
+        u_mpsc_ring_delete(server->updateRing);
+        server->updateRing = NULL;
+    }
+    stopMethodWorkers(server->server);
+    deleteUadpPublishers(server->server, server->publishers);
+    server->publishers = NULL;
+    pthread_mutex_destroy(&server->publishersMutex);
+    UA_Server_run_shutdown(server->server);
+    UA_Server_delete(server->server);
+    UA_ServerConfig_delete(server->serverConfig);
+    deleteServerNodes(server->server);
+    deleteServerCounters(server->counters);
     EDGE_LOG(TAG, "\n ========= [SERVER] Server Stopped ============= \n");
 
-    namespaceMap = NULL;
+    if (server->namespaceMap)
+    {
+        size_t cursor = 0;
+        keyValue value = NULL;
+        while (getNextEdgeHashMapElement(server->namespaceMap, &cursor, NULL, &value))
+        {
+            EdgeNamespace *ns = (EdgeNamespace *) value;
+            EdgeFree(ns->rootNodeIdentifier);
+            EdgeFree(ns->rootNodeBrowseName);
+            EdgeFree(ns->rootNodeDisplayName);
+            EdgeFree(ns);
+        }
+        deleteEdgeHashMap(server->namespaceMap);
+    }
+    EdgeFree(server);
     g_statusCallback(epInfo, STATUS_STOP_SERVER);
 }
 
+EdgeResult getServerStatsInServer(EdgeServer *server, EdgeServerStats *stats)
+{
+    EdgeResult result = { STATUS_PARAM_INVALID };
+    VERIFY_NON_NULL_MSG(stats, "", result);
+    result.code = STATUS_ERROR;
+    VERIFY_NON_NULL_MSG(server, "Server is not running\n", result);
+    getServerCounters(server->counters, stats);
+    result.code = STATUS_OK;
+    return result;
+}
+
+EdgeResult getDefaultServerStats(EdgeServerStats *stats)
+{
+    return getServerStatsInServer(m_defaultServer, stats);
+}
+
+EdgePublisher *createPublisherInServer(EdgeVariableNode **nodes, size_t nodeCount,
+        const EdgePubSubConfig *config)
+{
+    VERIFY_NON_NULL_MSG(nodes, "NULL nodes in createPublisherInServer\n", NULL);
+    COND_CHECK_MSG((0 == nodeCount), "No nodes in createPublisherInServer\n", NULL);
+    VERIFY_NON_NULL_MSG(nodes[0], "NULL node in createPublisherInServer\n", NULL);
+    EdgeServer *server = (EdgeServer *) getVariableNodeContext(nodes[0]);
+    for (size_t i = 1; i < nodeCount; i++)
+    {
+        VERIFY_NON_NULL_MSG(nodes[i], "NULL node in createPublisherInServer\n", NULL);
+        COND_CHECK_MSG((server != getVariableNodeContext(nodes[i])),
+                "Nodes of several servers in createPublisherInServer\n", NULL);
+    }
+
+    EdgePublisher *publisher = createUadpPublisher(server, nodes, nodeCount, config);
+    VERIFY_NON_NULL_MSG(publisher, "createUadpPublisher FAILED in createPublisherInServer\n", NULL);
+    pthread_mutex_lock(&server->publishersMutex);
+    linkUadpPublisher(&server->publishers, publisher);
+    pthread_mutex_unlock(&server->publishersMutex);
+    return publisher;
+}
+
+EdgeResult deletePublisherInServer(EdgePublisher *publisher)
+{
+    EdgeResult result = { STATUS_PARAM_INVALID };
+    VERIFY_NON_NULL_MSG(publisher, "NULL publisher in deletePublisherInServer\n", result);
+    EdgeServer *server = (EdgeServer *) getUadpPublisherOwner(publisher);
+    pthread_mutex_lock(&server->publishersMutex);
+    retireUadpPublisher(publisher);
+    pthread_mutex_unlock(&server->publishersMutex);
+    result.code = STATUS_OK;
+    return result;
+}
+
 void registerServerCallback(status_cb_t statusCallback)
 {
     g_statusCallback = statusCallback;
@@ -28,6 +28,7 @@
 #define EDGE_OPCUA_SERVER_H
 
 #include "opcua_common.h"
+#include "opcua_interface.h"
 #include "command_adapter.h"
 
 #ifdef __cplusplus
@@ -49,6 +50,22 @@ extern "C"
 EdgeResult createNamespaceInServer(const char *namespaceUri, const char *rootNodeIdentifier,
 		    const char *rootNodeBrowseName, const char *rootNodeDisplayName);
 
+/**
+ * @brief Send the request to a server instance for creating namespace
+ * @param[in]  server Server instance of startServerInstance()
+ * @param[in]  namespaceUri Namespace Uri.
+ * @param[in]  rootNodeIdentifier Root Node identifier
+ * @param[in]  rootNodeBrowseName Root Node browse name.
+ * @param[in]  rootNodeDisplayName Root Node display name.
+ * @return @c EdgeResult code is 0 on success, otherwise an error value
+ * @retval #STATUS_OK Successful
+ * @retval #STATUS_PARAM_INVALID Invalid parameter
+ * @retval #STATUS_ERROR Operation failed
+ */
+EdgeResult createNamespaceInServerInstance(EdgeServer *server, const char *namespaceUri,
+        const char *rootNodeIdentifier, const char *rootNodeBrowseName,
+        const char *rootNodeDisplayName);
+
 /**
  * @brief Send the request to create/add node
  * @param[in]  namespaceUri Namespace Uri to add new node
@@ -60,6 +77,21 @@ EdgeResult createNamespaceInServer(const char *namespaceUri, const char *rootNod
  */
 EdgeResult addNodesInServer(const char *namespaceUri, EdgeNodeItem *item);
 
+/**
+ * @brief Send the request to create/add nodes and then references in one pass
+ * @param[in]  namespaceUri Namespace Uri to add new nodes
+ * @param[in]  items Node items information
+ * @param[in]  itemCount Number of node items
+ * @param[in]  references Node references information, NULL if referenceCount is 0
+ * @param[in]  referenceCount Number of node references
+ * @return @c EdgeResult code is 0 on success, otherwise an error value
+ * @retval #STATUS_OK Successful
+ * @retval #STATUS_PARAM_INVALID Invalid parameter
+ * @retval #STATUS_ERROR Operation failed
+ */
+EdgeResult addNodeItemsInServer(const char *namespaceUri, EdgeNodeItem **items, size_t itemCount,
+        EdgeReference **references, size_t referenceCount);
+
 /**
  * @brief Send the request for modify node
  * @param[in]  namespaceUri Namespace Uri to add new node
@@ -72,6 +104,130 @@ EdgeResult addNodesInServer(const char *namespaceUri, EdgeNodeItem *item);
  */
 EdgeResult modifyNodeInServer(const char *namespaceUri, const char *nodeUri, EdgeVersatility *value);
 
+/**
+ * @brief Gets the handle of a namespace created with createNamespaceInServer()
+ * @param[in]  namespaceUri Namespace Uri.
+ * @return Namespace handle on success, otherwise NULL if the namespace does not exist
+ */
+EdgeNamespace *getNamespaceInServer(const char *namespaceUri);
+
+/**
+ * @brief Gets the handle of a namespace created with createNamespaceInServerInstance()
+ * @param[in]  server Server instance of startServerInstance()
+ * @param[in]  namespaceUri Namespace Uri.
+ * @return Namespace handle on success, otherwise NULL if the namespace does not exist
+ */
+EdgeNamespace *getNamespaceInServerInstance(const EdgeServer *server, const char *namespaceUri);
+
+/**
+ * @brief Send the request to create/add node in the namespace of the handle
+ * @param[in]  ns Namespace handle
+ * @param[in]  item Node item information
+ * @return @c EdgeResult code is 0 on success, otherwise an error value
+ * @retval #STATUS_OK Successful
+ * @retval #STATUS_PARAM_INVALID Invalid parameter
+ * @retval #STATUS_ERROR Operation failed
+ */
+EdgeResult addNodesInNamespace(const EdgeNamespace *ns, EdgeNodeItem *item);
+
+/**
+ * @brief Load a binary nodeset file into the namespace of the handle
+ * @param[in]  ns Namespace handle
+ * @param[in]  path Path of the binary nodeset file
+ * @return @c EdgeResult code is 0 on success, otherwise an error value
+ * @retval #STATUS_OK Successful
+ * @retval #STATUS_PARAM_INVALID Invalid parameter or malformed nodeset
+ * @retval #STATUS_ERROR Operation failed
+ */
+EdgeResult loadNodesetInNamespace(const EdgeNamespace *ns, const char *path);
+
+/**
+ * @brief Load a binary nodeset file into a namespace
+ * @param[in]  namespaceUri Namespace Uri of the nodes
+ * @param[in]  path Path of the binary nodeset file
+ * @return @c EdgeResult code is 0 on success, otherwise an error value
+ * @retval #STATUS_OK Successful
+ * @retval #STATUS_PARAM_INVALID Invalid parameter or malformed nodeset
+ * @retval #STATUS_ERROR Operation failed
+ */
+EdgeResult loadNodesetInServer(const char *namespaceUri, const char *path);
+
+/**
+ * @brief Send the request for modify node in the namespace of the handle
+ * @param[in]  ns Namespace handle
+ * @param[in]  nodeUri Node Uri
+ * @param[in]  value New data
+ * @return @c EdgeResult code is 0 on success, otherwise an error value
+ * @retval #STATUS_OK Successful
+ * @retval #STATUS_PARAM_INVALID Invalid parameter
+ * @retval #STATUS_ERROR Operation failed
+ */
+EdgeResult modifyNodeInNamespace(const EdgeNamespace *ns, const char *nodeUri, EdgeVersatility *value);
+
+/**
+ * @brief Send the request for modify nodes in the namespace of the handle
+ * @param[in]  ns Namespace handle
+ * @param[in]  nodeUris Node Uri of each node
+ * @param[in]  values New data of each node
+ * @param[in]  count Number of nodes
+ * @return @c EdgeResult code is 0 on success, otherwise an error value
+ * @retval #STATUS_OK Successful
+ * @retval #STATUS_PARAM_INVALID Invalid parameter
+ * @retval #STATUS_ERROR Operation failed
+ */
+EdgeResult modifyNodesInNamespace(const EdgeNamespace *ns, const char **nodeUris,
+        EdgeVersatility **values, size_t count);
+
+/**
+ * @brief Send the request for modify nodes
+ * @param[in]  namespaceUri Namespace Uri of the nodes
+ * @param[in]  nodeUris Node Uri of each node
+ * @param[in]  values New data of each node
+ * @param[in]  count Number of nodes
+ * @return @c EdgeResult code is 0 on success, otherwise an error value
+ * @retval #STATUS_OK Successful
+ * @retval #STATUS_PARAM_INVALID Invalid parameter
+ * @retval #STATUS_ERROR Operation failed
+ */
+EdgeResult modifyNodesInServer(const char *namespaceUri, const char **nodeUris,
+        EdgeVersatility **values, size_t count);
+
+/**
+ * @brief Get the handle of a variable node in the namespace of the handle
+ * @param[in]  ns Namespace handle
+ * @param[in]  nodeUri Node Uri
+ * @return Handle of the node, otherwise NULL
+ */
+EdgeVariableNode *getVariableNodeInNamespace(const EdgeNamespace *ns, const char *nodeUri);
+
+/**
+ * @brief Queue a new value of a variable node, which the server loop writes between iterations.
+ *        The value is copied, it may be called from any thread while the server runs.
+ * @param[in]  node Node handle
+ * @param[in]  value New data
+ * @return @c EdgeResult code is 0 on success, otherwise an error value
+ * @retval #STATUS_OK Successful
+ * @retval #STATUS_PARAM_INVALID Invalid parameter
+ * @retval #STATUS_ENQUEUE_ERROR Update queue is full
+ * @retval #STATUS_ERROR Operation failed
+ */
+EdgeResult enqueueNodeUpdateInServer(EdgeVariableNode *node, const EdgeVersatility *value);
+
+/**
+ * @brief Send the request to create/add method node in the namespace of the handle
+ * @param[in]  ns Namespace handle
+ * @param[in]  item Node item information
+ * @param[in]  method Method and argument information
+ * @param[in]  viewFn Method callback without argument copies, NULL to call method_fn
+ * @param[in]  runAsync Whether the method runs on the method workers
+ * @return @c EdgeResult code is 0 on success, otherwise an error value
+ * @retval #STATUS_OK Successful
+ * @retval #STATUS_PARAM_INVALID Invalid parameter
+ * @retval #STATUS_ERROR Operation failed
+ */
+EdgeResult addMethodNodeInNamespace(const EdgeNamespace *ns, EdgeNodeItem *item, EdgeMethod *method,
+        method_view_func viewFn, bool runAsync);
+
 /**
  * @brief Send the request for adding reference
  * @param[in]  reference Node reference information
@@ -87,12 +243,21 @@ EdgeResult addReferenceInServer(EdgeReference *reference);
  * @param[in]  namespaceUri Namespace Uri to add new node
  * @param[in]  item Node item information
  * @param[in]  method Method and argument information
+ * @param[in]  viewFn Method callback without argument copies, NULL to call method_fn
+ * @param[in]  runAsync Whether the method runs on the method workers
  * @return @c EdgeResult code is 0 on success, otherwise an error value
  * @retval #STATUS_OK Successful
  * @retval #STATUS_PARAM_INVALID Invalid parameter
  * @retval #STATUS_ERROR Operation failed
  */
-EdgeResult addMethodNodeInServer(const char *namespaceUri, EdgeNodeItem *item, EdgeMethod *method);
+EdgeResult addMethodNodeInServer(const char *namespaceUri, EdgeNodeItem *item, EdgeMethod *method,
+        method_view_func viewFn, bool runAsync);
+
+/**
+ * @brief Set the number of worker threads of asynchronous methods
+ * @param[in]  count Number of worker threads, 0 for the default
+ */
+void setMethodWorkersInServer(uint32_t count);
 
 /**
  * @brief Send the request to create and start the server
@@ -110,6 +275,24 @@ EdgeResult start_server(EdgeEndPointInfo *epInfo);
  */
 void stop_server(EdgeEndPointInfo *epInfo);
 
+/**
+ * @brief Starts a server instance with its own loop thread, beside the one of start_server()
+ * @param[in]  epInfo Endpoint information
+ * @param[out] instance Receives the server instance
+ * @return @c EdgeResult code is 0 on success, otherwise an error value
+ * @retval #STATUS_OK Successful
+ * @retval #STATUS_PARAM_INVALID Invalid parameter
+ * @retval #STATUS_ERROR Operation failed
+ */
+EdgeResult startServerInstance(EdgeEndPointInfo *epInfo, EdgeServer **instance);
+
+/**
+ * @brief Stops and frees a server instance of startServerInstance()
+ * @param[in]  server Server instance
+ * @param[in]  epInfo Endpoint information
+ */
+void stopServerInstance(EdgeServer *server, EdgeEndPointInfo *epInfo);
+
 /**
  * @brief Creates and Initialises the node with default values
  * @param[in]  name Node browse name
@@ -130,6 +313,21 @@ EdgeNodeItem* createNodeItemImpl(const char* name, EdgeIdentifier nodeType, Edge
 EdgeNodeItem* createVariableNodeItemImpl(const char* name, int type, void* data,
         EdgeIdentifier nodeType, double minimumInterval);
 
+/**
+ * @brief Creates and Initialises the data source variable node with default values
+ * @param[in]  name Node browse name
+ * @param[in]  type data type of node
+ * @param[in]  nodeType Type of node (Variable/Array)
+ * @param[in]  readFn Read callback of the node value
+ * @param[in]  writeFn Write callback of the node value, NULL for a read-only node
+ * @param[in]  context Context passed to the callbacks
+ * @param[in]  minimumInterval Minimum sampling interval
+ * @return EdgeNodeItem created on success, otherwise return NULL in case of error
+ */
+EdgeNodeItem* createDataSourceNodeItemImpl(const char* name, int type, EdgeIdentifier nodeType,
+        data_source_read_func readFn, data_source_write_func writeFn, void *context,
+        double minimumInterval);
+
 /**
  * @brief Deinitialised and deallocates the node item
  * @param[in]  item Node item to be deleted
@@ -140,6 +338,46 @@ EdgeNodeItem* createVariableNodeItemImpl(const char* name, int type, void* data,
  */
 EdgeResult deleteNodeItemImpl(EdgeNodeItem* item);
 
+/**
+ * @brief Gets the runtime statistics of a server instance
+ * @param[in]  server Server instance
+ * @param[out] stats Receives the statistics
+ * @return @c EdgeResult code is 0 on success, otherwise an error value
+ * @retval #STATUS_OK Successful
+ * @retval #STATUS_PARAM_INVALID Invalid parameter
+ * @retval #STATUS_ERROR Server is not running
+ */
+EdgeResult getServerStatsInServer(EdgeServer *server, EdgeServerStats *stats);
+
+/**
+ * @brief Gets the runtime statistics of the server of start_server()
+ * @param[out] stats Receives the statistics
+ * @return @c EdgeResult code is 0 on success, otherwise an error value
+ * @retval #STATUS_OK Successful
+ * @retval #STATUS_PARAM_INVALID Invalid parameter
+ * @retval #STATUS_ERROR Server is not running
+ */
+EdgeResult getDefaultServerStats(EdgeServerStats *stats);
+
+/**
+ * @brief Creates a PubSub publisher of variable nodes of a server
+ * @param[in]  nodes Handles of the nodes, which all belong to one server
+ * @param[in]  nodeCount Number of nodes
+ * @param[in]  config Configuration of the publisher
+ * @return Publisher on success, otherwise NULL
+ */
+EdgePublisher *createPublisherInServer(EdgeVariableNode **nodes, size_t nodeCount,
+        const EdgePubSubConfig *config);
+
+/**
+ * @brief Stops a PubSub publisher, which the server loop deletes
+ * @param[in]  publisher Publisher handle
+ * @return @c EdgeResult code is 0 on success, otherwise an error value
+ * @retval #STATUS_OK Successful
+ * @retval #STATUS_PARAM_INVALID Invalid parameter
+ */
+EdgeResult deletePublisherInServer(EdgePublisher *publisher);
+
 /**
  * @brief Print node list
  * @param[in]  reference Source and Target node information to create reference
@@ -0,0 +1,637 @@
+/******************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ *
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************/
+
+
+#include "edge_pubsub.h"
+#include "edge_node.h"
+#include "edge_uadp.h"
+#include "cmd_util.h"
+#include "message_dispatcher.h"
+#include "report_latency.h"
+#include "edge_utils.h"
+#include "edge_open62541.h"
+#include "edge_logger.h"
+#include "edge_malloc.h"
+#include "octhread.h"
+#include "edge_thread_config.h"
+
+#include <stdio.h>
+#include <string.h>
+#ifndef _WIN32
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <unistd.h>
+#else
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#endif
+
+#define TAG "edge_pubsub"
+
+#ifndef _WIN32
+typedef int PubSubSocket;
+#define INVALID_PUBSUB_SOCKET (-1)
+#define closePubSubSocket close
+#else
+typedef SOCKET PubSubSocket;
+#define INVALID_PUBSUB_SOCKET INVALID_SOCKET
+#define closePubSubSocket closesocket
+#endif
+
+/* Longest wait of a subscriber thread for a message, before it checks whether it is stopped */
+#define SUBSCRIBER_POLL_INTERVAL_MS (100)
+
+/* Uri of the endpoint of the REPORT messages of a subscriber, opc.udp://<address>:<port> */
+#define SUBSCRIBER_URI_SIZE (64)
+
+struct EdgePublisher
+{
+    struct EdgePublisher *next;
+    void *owner;
+    EdgeVariableNode **nodes;
+    size_t nodeCount;
+    /* Values of the nodes, read in each cycle */
+    UA_Variant *fields;
+    EdgeUadpHeader header;
+    uint32_t publishingInterval;
+    PubSubSocket socket;
+    struct sockaddr_in group;
+    uint8_t *buffer;
+    size_t bufferSize;
+    UA_UInt64 callbackId;
+    bool scheduled;
+    /* Set by retireUadpPublisher() under the lock of the list */
+    bool retired;
+    /* Set by the server loop once the callback is removed, the publisher is freed in the next pass */
+    bool removed;
+    /* Set while messages fail, so that a failure is logged once */
+    bool failing;
+};
+
+struct EdgeSubscriber
+{
+    uint16_t publisherId;
+    uint16_t writerGroupId;
+    uint16_t dataSetWriterId;
+    char **valueAliases;
+    size_t fieldCount;
+    UA_Variant *fields;
+    EdgeEndPointInfo *endpointInfo;
+    PubSubSocket socket;
+    uint8_t *buffer;
+    size_t bufferSize;
+    oc_thread thread;
+    volatile bool running;
+};
+
+/**
+ * @brief getGroupAddress - Gets the socket address of the messages of a configuration
+ * @param config - PubSub configuration
+ * @param group - Receives the address
+ * @return @c true on success, @c false if the address is invalid
+ */
+static bool getGroupAddress(const EdgePubSubConfig *config, struct sockaddr_in *group)
+{
+    memset(group, 0, sizeof(struct sockaddr_in));
+    group->sin_family = AF_INET;
+    group->sin_port = htons(config->port ? config->port : EDGE_UADP_DEFAULT_PORT);
+    return 1 == inet_pton(AF_INET, config->address, &group->sin_addr);
+}
+
+/**
+ * @brief getInterfaceAddress - Gets the address of the network interface of a configuration
+ * @param config - PubSub configuration
+ * @param address - Receives the address, INADDR_ANY for the default interface
+ * @return @c true on success, @c false if the address is invalid
+ */
+static bool getInterfaceAddress(const EdgePubSubConfig *config, struct in_addr *address)
+{
+    if (IS_NULL(config->interfaceAddress))
+    {
+        address->s_addr = htonl(INADDR_ANY);
+        return true;
+    }
+    return 1 == inet_pton(AF_INET, config->interfaceAddress, address);
+}
+
+static size_t getMessageSize(const EdgePubSubConfig *config)
+{
+    if (0 == config->maxMessageSize)
+    {
+        return EDGE_UADP_DEFAULT_MESSAGE_SIZE;
+    }
+    return (config->maxMessageSize < EDGE_UADP_MAX_MESSAGE_SIZE) ? config->maxMessageSize
+            : EDGE_UADP_MAX_MESSAGE_SIZE;
+}
+
+#ifndef DISABLE_SERVER
+/**
+ * @brief openPublisherSocket - Opens the socket which sends the messages of a publisher
+ * @param config - PubSub configuration
+ * @return Socket on success, INVALID_PUBSUB_SOCKET on failure
+ */
+static PubSubSocket openPublisherSocket(const EdgePubSubConfig *config)
+{
+    struct in_addr interfaceAddress;
+    if (!getInterfaceAddress(config, &interfaceAddress))
+    {
+        EDGE_LOG_V(TAG, "Invalid interface address %s\n", config->interfaceAddress);
+        return INVALID_PUBSUB_SOCKET;
+    }
+    PubSubSocket sock = socket(AF_INET, SOCK_DGRAM, 0);
+    if (INVALID_PUBSUB_SOCKET == sock)
+    {
+        EDGE_LOG(TAG, "Failed to open the socket of the publisher\n");
+        return INVALID_PUBSUB_SOCKET;
+    }
+    unsigned char ttl = config->ttl ? config->ttl : 1;
+    if (0 != setsockopt(sock, IPPROTO_IP, IP_MULTICAST_TTL, (const char *) &ttl, sizeof(ttl))
+            || (IS_NOT_NULL(config->interfaceAddress)
+                    && 0 != setsockopt(sock, IPPROTO_IP, IP_MULTICAST_IF,
+                            (const char *) &interfaceAddress, sizeof(interfaceAddress))))
+    {
+        EDGE_LOG(TAG, "Failed to set the multicast options of the publisher\n");
+        closePubSubSocket(sock);
+        return INVALID_PUBSUB_SOCKET;
+    }
+    return sock;
+}
+
+#endif
+
+/**
+ * @brief openSubscriberSocket - Opens the socket which receives the messages of a subscriber
+ *        and joins the multicast group of the configuration
+ * @param config - PubSub configuration
+ * @param group - Address of the messages
+ * @return Socket on success, INVALID_PUBSUB_SOCKET on failure
+ */
+static PubSubSocket openSubscriberSocket(const EdgePubSubConfig *config,
+        const struct sockaddr_in *group)
+{
+    struct ip_mreq membership;
+    membership.imr_multiaddr = group->sin_addr;
+    if (!getInterfaceAddress(config, &membership.imr_interface))
+    {
+        EDGE_LOG_V(TAG, "Invalid interface address %s\n", config->interfaceAddress);
+        return INVALID_PUBSUB_SOCKET;
+    }
+    PubSubSocket sock = socket(AF_INET, SOCK_DGRAM, 0);
+    if (INVALID_PUBSUB_SOCKET == sock)
+    {
+        EDGE_LOG(TAG, "Failed to open the socket of the subscriber\n");
+        return INVALID_PUBSUB_SOCKET;
+    }
+
+    /* Several subscribers of a host receive the messages of one group */
+    int reuse = 1;
+    struct sockaddr_in local;
+    memset(&local, 0, sizeof(struct sockaddr_in));
+    local.sin_family = AF_INET;
+    local.sin_port = group->sin_port;
+    local.sin_addr.s_addr = htonl(INADDR_ANY);
+#ifndef _WIN32
+    struct timeval timeout = { 0, SUBSCRIBER_POLL_INTERVAL_MS * 1000 };
+#else
+    DWORD timeout = SUBSCRIBER_POLL_INTERVAL_MS;
+#endif
+    bool multicast = IN_MULTICAST(ntohl(group->sin_addr.s_addr));
+    if (0 != setsockopt(sock, SOL_SOCKET, SO_REUSEADDR, (const char *) &reuse, sizeof(reuse))
+            || 0 != setsockopt(sock, SOL_SOCKET, SO_RCVTIMEO, (const char *) &timeout,
+                    sizeof(timeout))
+            || 0 != bind(sock, (const struct sockaddr *) &local, sizeof(local))
+            || (multicast && 0 != setsockopt(sock, IPPROTO_IP, IP_ADD_MEMBERSHIP,
+                    (const char *) &membership, sizeof(membership))))
+    {
+        EDGE_LOG_V(TAG, "Failed to join the group %s of the subscriber\n", config->address);
+        closePubSubSocket(sock);
+        return INVALID_PUBSUB_SOCKET;
+    }
+    return sock;
+}
+
+#ifndef DISABLE_SERVER
+/**
+ * @brief publishDataSet - Repeated callback of a publisher, which sends the values of its nodes.
+ *        It runs in the server loop, which owns the nodes.
+ * @param server - Server handle
+ * @param data - Publisher
+ */
+static void publishDataSet(UA_Server *server, void *data)
+{
+    EdgePublisher *publisher = (EdgePublisher *) data;
+    if (publisher->removed)
+    {
+        return;
+    }
+    for (size_t i = 0; i < publisher->nodeCount; i++)
+    {
+        /* A node which cannot be read is sent as an empty field */
+        UA_Variant_init(&publisher->fields[i]);
+        readVariableNodeValue(server, publisher->nodes[i], &publisher->fields[i]);
+    }
+    publisher->header.timestamp = UA_DateTime_now();
+    size_t length = encodeUadpMessage(&publisher->header, publisher->fields, publisher->nodeCount,
+            publisher->buffer, publisher->bufferSize);
+    for (size_t i = 0; i < publisher->nodeCount; i++)
+    {
+        UA_Variant_deleteMembers(&publisher->fields[i]);
+    }
+    publisher->header.sequenceNumber++;
+
+    bool sent = (length > 0) && (int) length == (int) sendto(publisher->socket,
+            (const char *) publisher->buffer, length, 0,
+            (const struct sockaddr *) &publisher->group, sizeof(publisher->group));
+    if (!sent && !publisher->failing)
+    {
+        EDGE_LOG_V(TAG, "Failed to publish the DataSet of writer %u, %s\n",
+                publisher->header.dataSetWriterId,
+                (0 == length) ? "it exceeds maxMessageSize" : "the send failed");
+    }
+    publisher->failing = !sent;
+}
+
+static void freeUadpPublisher(EdgePublisher *publisher)
+{
+    if (INVALID_PUBSUB_SOCKET != publisher->socket)
+    {
+        closePubSubSocket(publisher->socket);
+    }
+    EdgeFree(publisher->nodes);
+    EdgeFree(publisher->fields);
+    EdgeFree(publisher->buffer);
+    EdgeFree(publisher);
+}
+
+EdgePublisher *createUadpPublisher(void *owner, EdgeVariableNode **nodes, size_t nodeCount,
+        const EdgePubSubConfig *config)
+{
+    VERIFY_NON_NULL_MSG(nodes, "NULL nodes in createUadpPublisher\n", NULL);
+    VERIFY_NON_NULL_MSG(config, "NULL config in createUadpPublisher\n", NULL);
+    VERIFY_NON_NULL_MSG(config->address, "NULL address in createUadpPublisher\n", NULL);
+    COND_CHECK_MSG((0 == nodeCount || nodeCount > UINT16_MAX),
+            "Invalid number of nodes in createUadpPublisher\n", NULL);
+    COND_CHECK_MSG((0 == config->publishingInterval),
+            "Invalid publishing interval in createUadpPublisher\n", NULL);
+
+    EdgePublisher *publisher = (EdgePublisher *) EdgeCalloc(1, sizeof(EdgePublisher));
+    VERIFY_NON_NULL_MSG(publisher, "EdgeCalloc FAILED for publisher\n", NULL);
+    publisher->socket = INVALID_PUBSUB_SOCKET;
+    if (!getGroupAddress(config, &publisher->group))
+    {
+        EDGE_LOG_V(TAG, "Invalid address %s of the publisher\n", config->address);
+        goto ERROR;
+    }
+    publisher->owner = owner;
+    publisher->nodeCount = nodeCount;
+    publisher->publishingInterval = config->publishingInterval;
+    publisher->header.publisherId = config->publisherId;
+    publisher->header.writerGroupId = config->writerGroupId;
+    publisher->header.dataSetWriterId = config->dataSetWriterId;
+    publisher->bufferSize = getMessageSize(config);
+    publisher->nodes = (EdgeVariableNode **) EdgeMalloc(nodeCount * sizeof(EdgeVariableNode *));
+    publisher->fields = (UA_Variant *) EdgeCalloc(nodeCount, sizeof(UA_Variant));
+    publisher->buffer = (uint8_t *) EdgeMalloc(publisher->bufferSize);
+    if (IS_NULL(publisher->nodes) || IS_NULL(publisher->fields) || IS_NULL(publisher->buffer))
+    {
+        EDGE_LOG(TAG, "Memory allocation failed for the publisher\n");
+        goto ERROR;
+    }
+    memcpy(publisher->nodes, nodes, nodeCount * sizeof(EdgeVariableNode *));
+    publisher->socket = openPublisherSocket(config);
+    if (INVALID_PUBSUB_SOCKET == publisher->socket)
+    {
+        goto ERROR;
+    }
+    return publisher;
+
+    ERROR:
+    freeUadpPublisher(publisher);
+    return NULL;
+}
+
+void *getUadpPublisherOwner(const EdgePublisher *publisher)
+{
+    return publisher->owner;
+}
+
+void linkUadpPublisher(EdgePublisher **publishers, EdgePublisher *publisher)
+{
+    publisher->next = *publishers;
+    *publishers = publisher;
+}
+
+void retireUadpPublisher(EdgePublisher *publisher)
+{
+    publisher->retired = true;
+}
+
+void scheduleUadpPublishers(UA_Server *server, EdgePublisher **publishers)
+{
+    EdgePublisher **link = publishers;
+    while (IS_NOT_NULL(*link))
+    {
+        EdgePublisher *publisher = *link;
+        if (publisher->removed)
+        {
+            /* The iteration since the removal has dropped the callback from the timer */
+            *link = publisher->next;
+            freeUadpPublisher(publisher);
+            continue;
+        }
+        if (publisher->retired)
+        {
+            if (publisher->scheduled)
+            {
+                UA_Server_removeRepeatedCallback(server, publisher->callbackId);
+            }
+            publisher->removed = true;
+        }
+        else if (!publisher->scheduled)
+        {
+            if (UA_Server_addRepeatedCallback(server, publishDataSet, publisher,
+                    publisher->publishingInterval, &publisher->callbackId) == UA_STATUSCODE_GOOD)
+            {
+                publisher->scheduled = true;
+            }
+            else
+            {
+                EDGE_LOG(TAG, "Failed to schedule the publisher, it is not published\n");
+                publisher->removed = true;
+            }
+        }
+        link = &publisher->next;
+    }
+}
+
+void deleteUadpPublishers(UA_Server *server, EdgePublisher *publishers)
+{
+    while (IS_NOT_NULL(publishers))
+    {
+        EdgePublisher *next = publishers->next;
+        if (publishers->scheduled && !publishers->removed)
+        {
+            UA_Server_removeRepeatedCallback(server, publishers->callbackId);
+        }
+        freeUadpPublisher(publishers);
+        publishers = next;
+    }
+}
+#endif
+
+/**
+ * @brief createFieldResponse - Creates the response of a field of a DataSet
+ * @param valueAlias - Value alias of the field
+ * @param field - Value of the field, which may be taken by the response
+ * @return Response on success, NULL on failure
+ */
+static EdgeResponse *createFieldResponse(const char *valueAlias, UA_Variant *field)
+{
+    EdgeResponse *response = (EdgeResponse *) EdgeCalloc(1, sizeof(EdgeResponse));
+    VERIFY_NON_NULL_MSG(response, "EdgeCalloc FAILED for response in createFieldResponse\n", NULL);
+    response->nodeInfo = (EdgeNodeInfo *) EdgeCalloc(1, sizeof(EdgeNodeInfo));
+    if (IS_NULL(response->nodeInfo))
+    {
+        EDGE_LOG(TAG, "EdgeCalloc FAILED for nodeInfo in createFieldResponse\n");
+        goto RESPONSE_ERROR;
+    }
+    response->nodeInfo->valueAlias = cloneString(valueAlias);
+    if (IS_NULL(response->nodeInfo->valueAlias))
+    {
+        EDGE_LOG(TAG, "cloneString FAILED for valueAlias in createFieldResponse\n");
+        goto RESPONSE_ERROR;
+    }
+    response->message = takeResponse(response, field);
+    if (IS_NULL(response->message))
+    {
+        EDGE_LOG(TAG, "takeResponse FAILED in createFieldResponse\n");
+        goto RESPONSE_ERROR;
+    }
+    return response;
+
+    RESPONSE_ERROR:
+    freeEdgeResponse(response);
+    return NULL;
+}
+
+/**
+ * @brief deliverDataSet - Hands the fields of a DataSet to the application in a REPORT message,
+ *        empty fields are left out
+ * @param subscriber - Subscriber of the DataSet
+ * @param header - Headers of the message
+ * @param fieldCount - Number of decoded fields
+ */
+static void deliverDataSet(EdgeSubscriber *subscriber, const EdgeUadpHeader *header,
+        size_t fieldCount)
+{
+    EdgeMessage *report = allocEdgeMessage();
+    VERIFY_NON_NULL_NR_MSG(report, "EdgeCalloc FAILED for the report of a DataSet\n");
+    report->type = REPORT;
+    setEdgeTimeInfo(&report->serverTime);
+    setMessageEndpointInfo(report, retainEdgeEndpointInfo(subscriber->endpointInfo));
+    report->responses = (EdgeResponse **) EdgeCalloc(fieldCount, sizeof(EdgeResponse *));
+    if (IS_NULL(report->endpointInfo) || IS_NULL(report->responses))
+    {
+        EDGE_LOG(TAG, "Memory allocation failed for the report of a DataSet\n");
+        freeEdgeMessage(report);
+        return;
+    }
+
+    int64_t sourceTimestamp = header->timestamp ?
+            (header->timestamp - UA_DATETIME_UNIX_EPOCH) / UA_USEC_TO_DATETIME : 0;
+    int64_t receiveTimestamp = get_report_time_us();
+    for (size_t i = 0; i < fieldCount; i++)
+    {
+        if (IS_NULL(subscriber->fields[i].type))
+        {
+            continue;
+        }
+        EdgeResponse *response = createFieldResponse(subscriber->valueAliases[i],
+                &subscriber->fields[i]);
+        if (IS_NULL(response))
+        {
+            freeEdgeMessage(report);
+            return;
+        }
+        response->sourceTimestamp = sourceTimestamp;
+        response->receiveTimestamp = receiveTimestamp;
+        report->responses[report->responseLength++] = response;
+    }
+    if (0 == report->responseLength)
+    {
+        freeEdgeMessage(report);
+        return;
+    }
+    add_to_recvQ(report);
+}
+
+static bool isSubscribedDataSet(const EdgeSubscriber *subscriber, const EdgeUadpHeader *header)
+{
+    return (0 == subscriber->publisherId || subscriber->publisherId == header->publisherId)
+            && (0 == subscriber->writerGroupId || subscriber->writerGroupId == header->writerGroupId)
+            && (0 == subscriber->dataSetWriterId
+                    || subscriber->dataSetWriterId == header->dataSetWriterId);
+}
+
+static void *receiveDataSets(void *data)
+{
+    applyEdgeThreadConfig(EDGE_THREAD_HELPER);
+    EdgeSubscriber *subscriber = (EdgeSubscriber *) data;
+    while (subscriber->running)
+    {
+        /* Fails on the receive timeout as well */
+        int length = (int) recv(subscriber->socket, (char *) subscriber->buffer,
+                subscriber->bufferSize, 0);
+        if (length <= 0)
+        {
+            continue;
+        }
+        EdgeUadpHeader header;
+        size_t fieldCount = 0;
+        UA_StatusCode ret = decodeUadpMessage(subscriber->buffer, (size_t) length, &header,
+                subscriber->fields, subscriber->fieldCount, &fieldCount);
+        if (ret != UA_STATUSCODE_GOOD)
+        {
+            EDGE_LOG_V(TAG, "Dropped a message which could not be decoded:: 0x%08x\n", ret);
+            continue;
+        }
+        if (fieldCount > 0 && isSubscribedDataSet(subscriber, &header))
+        {
+            deliverDataSet(subscriber, &header, fieldCount);
+        }
+        for (size_t i = 0; i < fieldCount; i++)
+        {
+            UA_Variant_deleteMembers(&subscriber->fields[i]);
+        }
+    }
+    return NULL;
+}
+
+static void freeUadpSubscriber(EdgeSubscriber *subscriber)
+{
+    if (INVALID_PUBSUB_SOCKET != subscriber->socket)
+    {
+        closePubSubSocket(subscriber->socket);
+    }
+    if (IS_NOT_NULL(subscriber->valueAliases))
+    {
+        for (size_t i = 0; i < subscriber->fieldCount; i++)
+        {
+            EdgeFree(subscriber->valueAliases[i]);
+        }
+        EdgeFree(subscriber->valueAliases);
+    }
+    if (IS_NOT_NULL(subscriber->endpointInfo))
+    {
+        releaseEdgeEndpointInfo(subscriber->endpointInfo);
+    }
+    EdgeFree(subscriber->fields);
+    EdgeFree(subscriber->buffer);
+    EdgeFree(subscriber);
+}
+
+EdgeSubscriber *createUadpSubscriber(const EdgePubSubConfig *config, const char **valueAliases,
+        size_t fieldCount)
+{
+    VERIFY_NON_NULL_MSG(config, "NULL config in createUadpSubscriber\n", NULL);
+    VERIFY_NON_NULL_MSG(config->address, "NULL address in createUadpSubscriber\n", NULL);
+    VERIFY_NON_NULL_MSG(valueAliases, "NULL valueAliases in createUadpSubscriber\n", NULL);
+    COND_CHECK_MSG((0 == fieldCount || fieldCount > UINT16_MAX),
+            "Invalid number of fields in createUadpSubscriber\n", NULL);
+    for (size_t i = 0; i < fieldCount; i++)
+    {
+        VERIFY_NON_NULL_MSG(valueAliases[i], "NULL value alias in createUadpSubscriber\n", NULL);
+    }
+    struct sockaddr_in group;
+    if (!getGroupAddress(config, &group))
+    {
+        EDGE_LOG_V(TAG, "Invalid address %s of the subscriber\n", config->address);
+        return NULL;
+    }
+
+    EdgeSubscriber *subscriber = (EdgeSubscriber *) EdgeCalloc(1, sizeof(EdgeSubscriber));
+    VERIFY_NON_NULL_MSG(subscriber, "EdgeCalloc FAILED for subscriber\n", NULL);
+    subscriber->socket = INVALID_PUBSUB_SOCKET;
+    subscriber->publisherId = config->publisherId;
+    subscriber->writerGroupId = config->writerGroupId;
+    subscriber->dataSetWriterId = config->dataSetWriterId;
+    subscriber->bufferSize = getMessageSize(config);
+    subscriber->buffer = (uint8_t *) EdgeMalloc(subscriber->bufferSize);
+    subscriber->fields = (UA_Variant *) EdgeCalloc(fieldCount, sizeof(UA_Variant));
+    subscriber->valueAliases = (char **) EdgeCalloc(fieldCount, sizeof(char *));
+    if (IS_NULL(subscriber->buffer) || IS_NULL(subscriber->fields)
+            || IS_NULL(subscriber->valueAliases))
+    {
+        EDGE_LOG(TAG, "Memory allocation failed for the subscriber\n");
+        goto ERROR;
+    }
+    subscriber->fieldCount = fieldCount;
+    for (size_t i = 0; i < fieldCount; i++)
+    {
+        subscriber->valueAliases[i] = cloneString(valueAliases[i]);
+        if (IS_NULL(subscriber->valueAliases[i]))
+        {
+            EDGE_LOG(TAG, "Memory allocation failed for the value aliases of the subscriber\n");
+            goto ERROR;
+        }
+    }
+
+    /* Reports of the subscriber share one endpoint which names the group */
+    char endpointUri[SUBSCRIBER_URI_SIZE];
+    snprintf(endpointUri, SUBSCRIBER_URI_SIZE, "opc.udp://%s:%u", config->address,
+            ntohs(group.sin_port));
+    EdgeEndPointInfo endpointInfo;
+    memset(&endpointInfo, 0, sizeof(EdgeEndPointInfo));
+    endpointInfo.endpointUri = endpointUri;
+    subscriber->endpointInfo = shareEdgeEndpointInfo(&endpointInfo);
+    if (IS_NULL(subscriber->endpointInfo))
+    {
+        EDGE_LOG(TAG, "Memory allocation failed for the endpoint of the subscriber\n");
+        goto ERROR;
+    }
+
+    subscriber->socket = openSubscriberSocket(config, &group);
+    if (INVALID_PUBSUB_SOCKET == subscriber->socket)
+    {
+        goto ERROR;
+    }
+    subscriber->running = true;
+    if (OC_THREAD_SUCCESS != oc_thread_new(&subscriber->thread, receiveDataSets, subscriber))
+    {
+        EDGE_LOG(TAG, "Failed to start the thread of the subscriber\n");
+        goto ERROR;
+    }
+    return subscriber;
+
+    ERROR:
+    freeUadpSubscriber(subscriber);
+    return NULL;
+}
+
+void deleteUadpSubscriber(EdgeSubscriber *subscriber)
+{
+    VERIFY_NON_NULL_NR_MSG(subscriber, "NULL subscriber in deleteUadpSubscriber\n");
+    subscriber->running = false;
+    oc_thread_wait(subscriber->thread);
+    oc_thread_free(subscriber->thread);
+    freeUadpSubscriber(subscriber);
+}
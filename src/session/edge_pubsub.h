@@ -0,0 +1,110 @@
+/******************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ *
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************/
+
+
+/**
+ * @file edge_pubsub.h
+ * @brief This file contains the PubSub publishers of the server nodes and the subscribers
+ *        of their UADP messages over UDP.
+ */
+
+#ifndef EDGE_PUBSUB_H
+#define EDGE_PUBSUB_H
+
+#include "opcua_common.h"
+#include "common_server.h"
+#include "common_client.h"
+
+#include <open62541.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/**
+ * @brief Creates a publisher of the values of variable nodes. It publishes once it is
+ *        scheduled by the server loop with scheduleUadpPublishers().
+ * @param[in]  owner Server of the nodes
+ * @param[in]  nodes Handles of the nodes, which are the fields of the DataSet in this order
+ * @param[in]  nodeCount Number of nodes
+ * @param[in]  config Configuration of the publisher
+ * @return Publisher on success, otherwise NULL
+ */
+EdgePublisher *createUadpPublisher(void *owner, EdgeVariableNode **nodes, size_t nodeCount,
+        const EdgePubSubConfig *config);
+
+/**
+ * @brief Gets the server of a publisher, passed to createUadpPublisher()
+ * @param[in]  publisher Publisher handle
+ * @return Server of the publisher
+ */
+void *getUadpPublisherOwner(const EdgePublisher *publisher);
+
+/**
+ * @brief Adds a publisher to the publishers of a server, under the lock of the list
+ * @param[in,out]  publishers Head of the list
+ * @param[in]  publisher Publisher of createUadpPublisher()
+ */
+void linkUadpPublisher(EdgePublisher **publishers, EdgePublisher *publisher);
+
+/**
+ * @brief Marks a publisher for deletion by the server loop, under the lock of the list
+ * @param[in]  publisher Publisher handle
+ */
+void retireUadpPublisher(EdgePublisher *publisher);
+
+/**
+ * @brief Starts the repeated callbacks of new publishers and deletes retired ones.
+ *        It is called by the server loop under the lock of the list, between its iterations.
+ * @param[in]  server Server handle
+ * @param[in,out]  publishers Head of the list
+ */
+void scheduleUadpPublishers(UA_Server *server, EdgePublisher **publishers);
+
+/**
+ * @brief Deletes all publishers of a server, once its server loop has stopped
+ * @param[in]  server Server handle
+ * @param[in]  publishers Head of the list
+ */
+void deleteUadpPublishers(UA_Server *server, EdgePublisher *publishers);
+
+/**
+ * @brief Creates a subscriber which receives DataSets on a thread of its own and hands each
+ *        one to the application as a REPORT message with a response per field.
+ * @param[in]  config Configuration of the subscriber
+ * @param[in]  valueAliases Value alias of each field of the DataSet
+ * @param[in]  fieldCount Number of fields
+ * @return Subscriber on success, otherwise NULL
+ */
+EdgeSubscriber *createUadpSubscriber(const EdgePubSubConfig *config, const char **valueAliases,
+        size_t fieldCount);
+
+/**
+ * @brief Stops the thread of a subscriber and deletes it
+ * @param[in]  subscriber Subscriber handle
+ */
+void deleteUadpSubscriber(EdgeSubscriber *subscriber);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* EDGE_PUBSUB_H */
@@ -0,0 +1,451 @@
+/******************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ *
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************/
+
+#include "edge_reconnect.h"
+#include "message_dispatcher.h"
+#include "edge_logger.h"
+#include "edge_utils.h"
+#include "edge_open62541.h"
+#include "edge_hash_map.h"
+#include "edge_malloc.h"
+#include "edge_random.h"
+#include "octhread.h"
+#include "edge_thread_config.h"
+
+#include <time.h>
+#ifndef _WIN32
+#include <pthread.h>
+#else
+#include "pthread.h"
+#endif
+
+#define TAG "edge_reconnect"
+
+/* Upper bound of the backoff when the configuration has none */
+#define DEFAULT_MAX_DELAY_MS (60000)
+
+/* Backoff of a lost session */
+typedef struct EdgeReconnect
+{
+    char *endpoint;
+    /* Failed attempts so far */
+    uint32_t attempts;
+    /* Backoff before the next attempt, without jitter */
+    uint32_t delayMs;
+    /* Time of oc_get_time_us() from which the next attempt is made */
+    uint64_t deadline;
+    /* Set while a thread connects the session, the mutex is not held meanwhile */
+    bool attempting;
+    /* Set when the backoff is dropped during an attempt, which frees it at its end */
+    bool removed;
+} EdgeReconnect;
+
+/* Probe message which is queued at the end of a backoff */
+typedef struct EdgeReconnectProbe
+{
+    char *endpoint;
+    uint64_t deadline;
+    struct EdgeReconnectProbe *next;
+} EdgeReconnectProbe;
+
+/* Client handle -> EdgeReconnect, guarded by reconnectMutex with the configuration */
+static EdgeHashMap *reconnectMap = NULL;
+static EdgeReconnectConfig reconnectConfig;
+static pthread_mutex_t reconnectMutex = PTHREAD_MUTEX_INITIALIZER;
+/* Signals the end of an attempt */
+static pthread_cond_t reconnectCond = PTHREAD_COND_INITIALIZER;
+
+/* Probe timer, runs while reconnecting is enabled. Probes are sorted by deadline. */
+static oc_mutex probeMutex = NULL;
+static oc_cond probeCond = NULL;
+static oc_thread probeThread = NULL;
+static bool probeRunning = false;
+static EdgeReconnectProbe *probeHead = NULL;
+
+static void queueProbe(const char *endpoint)
+{
+    EdgeEndPointInfo epInfo;
+    memset(&epInfo, 0, sizeof(EdgeEndPointInfo));
+    epInfo.endpointUri = (char *) endpoint;
+
+    EdgeMessage *msg = allocEdgeMessage();
+    VERIFY_NON_NULL_NR_MSG(msg, "EdgeCalloc FAILED for probe message\n");
+    setMessageEndpointInfo(msg, shareEdgeEndpointInfo(&epInfo));
+    if (IS_NULL(msg->endpointInfo))
+    {
+        EDGE_LOG(TAG, "Memory allocation failed.");
+        freeEdgeMessage(msg);
+        return;
+    }
+    msg->type = SEND_REQUEST;
+    msg->command = CMD_START_CLIENT;
+    EDGE_MESSAGE_BLOCK(msg)->reconnectProbe = true;
+    add_to_sendQ(msg);
+}
+
+static void *probeTimerHandler(void *arg)
+{
+    (void) arg;
+    applyEdgeThreadConfig(EDGE_THREAD_HELPER);
+    oc_mutex_lock(probeMutex);
+    while (probeRunning)
+    {
+        uint64_t now = oc_get_time_us();
+        if (IS_NOT_NULL(probeHead) && probeHead->deadline <= now)
+        {
+            EdgeReconnectProbe *probe = probeHead;
+            probeHead = probe->next;
+            oc_mutex_unlock(probeMutex);
+            queueProbe(probe->endpoint);
+            EdgeFree(probe->endpoint);
+            EdgeFree(probe);
+            oc_mutex_lock(probeMutex);
+        }
+        else if (IS_NOT_NULL(probeHead))
+        {
+            oc_cond_wait_for(probeCond, probeMutex, probeHead->deadline - now);
+        }
+        else
+        {
+            oc_cond_wait(probeCond, probeMutex);
+        }
+    }
+    /* Sessions still lost are connected again by their next request */
+    while (IS_NOT_NULL(probeHead))
+    {
+        EdgeReconnectProbe *probe = probeHead;
+        probeHead = probe->next;
+        EdgeFree(probe->endpoint);
+        EdgeFree(probe);
+    }
+    oc_mutex_unlock(probeMutex);
+    return NULL;
+}
+
+static bool startProbeTimer(void)
+{
+    probeMutex = oc_mutex_new();
+    probeCond = oc_cond_new();
+    if (IS_NULL(probeMutex) || IS_NULL(probeCond))
+    {
+        EDGE_LOG(TAG, "Failed to create the probe timer lock.");
+        oc_cond_free(probeCond);
+        oc_mutex_free(probeMutex);
+        probeCond = NULL;
+        probeMutex = NULL;
+        return false;
+    }
+    probeRunning = true;
+    if (OC_THREAD_SUCCESS != oc_thread_new(&probeThread, probeTimerHandler, NULL))
+    {
+        EDGE_LOG(TAG, "Failed to start the probe timer thread.");
+        probeRunning = false;
+        probeThread = NULL;
+        oc_cond_free(probeCond);
+        oc_mutex_free(probeMutex);
+        probeCond = NULL;
+        probeMutex = NULL;
+        return false;
+    }
+    return true;
+}
+
+static void stopProbeTimer(void)
+{
+    oc_mutex_lock(probeMutex);
+    probeRunning = false;
+    oc_cond_signal(probeCond);
+    oc_mutex_unlock(probeMutex);
+
+    oc_thread_wait(probeThread);
+    oc_thread_free(probeThread);
+    oc_cond_free(probeCond);
+    oc_mutex_free(probeMutex);
+    probeThread = NULL;
+    probeCond = NULL;
+    probeMutex = NULL;
+}
+
+/* Called with reconnectMutex held, so the timer runs */
+static void scheduleProbe(const char *endpoint, uint64_t deadline)
+{
+    EdgeReconnectProbe *probe = (EdgeReconnectProbe *) EdgeCalloc(1, sizeof(EdgeReconnectProbe));
+    VERIFY_NON_NULL_NR_MSG(probe, "EdgeCalloc FAILED for EdgeReconnectProbe\n");
+    probe->endpoint = cloneString(endpoint);
+    if (IS_NULL(probe->endpoint))
+    {
+        EDGE_LOG(TAG, "Memory allocation failed.");
+        EdgeFree(probe);
+        return;
+    }
+    probe->deadline = deadline;
+
+    oc_mutex_lock(probeMutex);
+    EdgeReconnectProbe **next = &probeHead;
+    while (IS_NOT_NULL(*next) && (*next)->deadline <= deadline)
+    {
+        next = &(*next)->next;
+    }
+    probe->next = *next;
+    *next = probe;
+    oc_cond_signal(probeCond);
+    oc_mutex_unlock(probeMutex);
+}
+
+/* Backoff with equal jitter, so that sessions lost at once do not reconnect at once */
+static uint64_t getBackoffDeadline(uint32_t delayMs)
+{
+    uint64_t half = (uint64_t) delayMs * 500;
+    return oc_get_time_us() + half + (uint64_t) EdgeGetFastRandom() % (half + 1);
+}
+
+static void freeReconnect(EdgeReconnect *state)
+{
+    EdgeFree(state->endpoint);
+    EdgeFree(state);
+}
+
+/* Waits on reconnectCond until the oc_get_time_us() deadline or a signal */
+static void waitReconnectUntil(uint64_t deadline)
+{
+    uint64_t now = oc_get_time_us();
+    if (deadline <= now)
+    {
+        return;
+    }
+    uint64_t wait = deadline - now;
+
+    struct timespec abstime;
+#ifndef _WIN32
+    clock_gettime(CLOCK_REALTIME, &abstime);
+#else
+    timespec_get(&abstime, TIME_UTC);
+#endif
+    abstime.tv_sec += (time_t) (wait / 1000000);
+    abstime.tv_nsec += (long) ((wait % 1000000) * 1000);
+    if (abstime.tv_nsec >= 1000000000L)
+    {
+        abstime.tv_sec++;
+        abstime.tv_nsec -= 1000000000L;
+    }
+    pthread_cond_timedwait(&reconnectCond, &reconnectMutex, &abstime);
+}
+
+EdgeResult setReconnectConfig(const EdgeReconnectConfig *config)
+{
+    EdgeResult result;
+    result.code = STATUS_PARAM_INVALID;
+    bool enable = IS_NOT_NULL(config) && config->initialDelayMs > 0;
+    COND_CHECK_MSG((enable && config->maxDelayMs > 0 && config->maxDelayMs < config->initialDelayMs),
+            "Error: maxDelayMs is below initialDelayMs\n", result);
+
+    pthread_mutex_lock(&reconnectMutex);
+    bool enabled = reconnectConfig.initialDelayMs > 0;
+    result.code = STATUS_OK;
+    if (enable && !enabled && !startProbeTimer())
+    {
+        result.code = STATUS_ERROR;
+    }
+    else if (enable)
+    {
+        reconnectConfig = *config;
+        if (0 == reconnectConfig.maxDelayMs)
+        {
+            reconnectConfig.maxDelayMs = (config->initialDelayMs > DEFAULT_MAX_DELAY_MS) ?
+                    config->initialDelayMs : DEFAULT_MAX_DELAY_MS;
+        }
+    }
+    else
+    {
+        memset(&reconnectConfig, 0, sizeof(EdgeReconnectConfig));
+    }
+
+    if (!enable && enabled)
+    {
+        /* Lost sessions stay disconnected */
+        stopProbeTimer();
+        size_t cursor = 0;
+        keyValue key = NULL, value = NULL;
+        while (getNextEdgeHashMapElement(reconnectMap, &cursor, &key, &value))
+        {
+            EdgeReconnect *state = (EdgeReconnect *) value;
+            state->removed = state->attempting;
+            if (!state->attempting)
+            {
+                freeReconnect(state);
+            }
+        }
+        if (IS_NOT_NULL(reconnectMap))
+        {
+            deleteEdgeHashMap(reconnectMap);
+            reconnectMap = NULL;
+        }
+        pthread_cond_broadcast(&reconnectCond);
+    }
+    pthread_mutex_unlock(&reconnectMutex);
+    return result;
+}
+
+bool scheduleReconnect(UA_Client *client, const char *endpoint)
+{
+    COND_CHECK((IS_NULL(client) || IS_NULL(endpoint)), false);
+
+    pthread_mutex_lock(&reconnectMutex);
+    bool enabled = reconnectConfig.initialDelayMs > 0;
+    if (!enabled || IS_NOT_NULL(getEdgeHashMapElement(reconnectMap, (keyValue) client)))
+    {
+        /* A failed attempt reports the lost connection again, its backoff is running already */
+        pthread_mutex_unlock(&reconnectMutex);
+        return enabled;
+    }
+
+    EdgeReconnect *state = (EdgeReconnect *) EdgeCalloc(1, sizeof(EdgeReconnect));
+    bool inserted = false;
+    if (IS_NOT_NULL(state))
+    {
+        state->endpoint = cloneString(endpoint);
+        state->delayMs = reconnectConfig.initialDelayMs;
+        state->deadline = getBackoffDeadline(state->delayMs);
+        if (IS_NULL(reconnectMap))
+        {
+            reconnectMap = createEdgeHashMap(EDGE_HASH_POINTER_KEY);
+        }
+        inserted = IS_NOT_NULL(state->endpoint)
+                && insertEdgeHashMapElement(reconnectMap, (keyValue) client, (keyValue) state);
+    }
+    if (inserted)
+    {
+        scheduleProbe(state->endpoint, state->deadline);
+    }
+    else
+    {
+        EDGE_LOG(TAG, "Memory allocation failed.");
+        if (IS_NOT_NULL(state))
+        {
+            freeReconnect(state);
+        }
+    }
+    pthread_mutex_unlock(&reconnectMutex);
+    return inserted;
+}
+
+/**
+ * @brief attemptReconnect - Connects the lost session once. Called with reconnectMutex held,
+ *        which is released during the attempt.
+ * @param client - Client Handle
+ * @param state - Backoff of the client
+ * @return true if the session is given up
+ */
+static bool attemptReconnect(UA_Client *client, EdgeReconnect *state)
+{
+    char *endpoint = cloneString(state->endpoint);
+    COND_CHECK((IS_NULL(endpoint)), false);
+    state->attempting = true;
+    pthread_mutex_unlock(&reconnectMutex);
+
+    /* The client keeps its session, the server activates it on the new secure channel */
+    UA_StatusCode retVal = UA_Client_connect(client, endpoint);
+
+    pthread_mutex_lock(&reconnectMutex);
+    bool givenUp = false;
+    if (state->removed)
+    {
+        freeReconnect(state);
+    }
+    else if (UA_STATUSCODE_GOOD == retVal)
+    {
+        removeEdgeHashMapElement(reconnectMap, (keyValue) client, NULL);
+        freeReconnect(state);
+        EDGE_LOG_V(TAG, "Session of %s connected again\n", endpoint);
+    }
+    else if (reconnectConfig.maxAttempts > 0 && ++state->attempts >= reconnectConfig.maxAttempts)
+    {
+        removeEdgeHashMapElement(reconnectMap, (keyValue) client, NULL);
+        freeReconnect(state);
+        givenUp = true;
+        EDGE_LOG_V(TAG, "Session of %s is given up 0x%08x\n", endpoint, retVal);
+    }
+    else
+    {
+        uint32_t maxDelayMs = reconnectConfig.maxDelayMs;
+        state->delayMs = (state->delayMs >= maxDelayMs / 2) ? maxDelayMs : state->delayMs * 2;
+        state->deadline = getBackoffDeadline(state->delayMs);
+        state->attempting = false;
+        scheduleProbe(state->endpoint, state->deadline);
+    }
+    pthread_cond_broadcast(&reconnectCond);
+    EdgeFree(endpoint);
+    return givenUp;
+}
+
+bool awaitReconnect(UA_Client *client)
+{
+    COND_CHECK((IS_NULL(client)), false);
+
+    bool givenUp = false;
+    pthread_mutex_lock(&reconnectMutex);
+    uint64_t bufferEnd = oc_get_time_us() + (uint64_t) reconnectConfig.requestBufferMs * 1000;
+    while (!givenUp)
+    {
+        EdgeReconnect *state = (EdgeReconnect *) getEdgeHashMapElement(reconnectMap,
+                (keyValue) client);
+        if (IS_NULL(state))
+        {
+            break;
+        }
+        uint64_t now = oc_get_time_us();
+        if (!state->attempting && state->deadline <= now)
+        {
+            givenUp = attemptReconnect(client, state);
+        }
+        else if (now < bufferEnd && (state->attempting || state->deadline <= bufferEnd))
+        {
+            waitReconnectUntil(state->attempting ? bufferEnd : state->deadline);
+        }
+        else
+        {
+            /* The request fails on the lost session instead of waiting longer */
+            break;
+        }
+    }
+    pthread_mutex_unlock(&reconnectMutex);
+    return givenUp;
+}
+
+void removeReconnect(UA_Client *client)
+{
+    pthread_mutex_lock(&reconnectMutex);
+    EdgeReconnect *state = (EdgeReconnect *) removeEdgeHashMapElement(reconnectMap,
+            (keyValue) client, NULL);
+    if (IS_NOT_NULL(state))
+    {
+        state->removed = state->attempting;
+        if (!state->attempting)
+        {
+            freeReconnect(state);
+        }
+    }
+    if (IS_NOT_NULL(reconnectMap) && 0 == getEdgeHashMapSize(reconnectMap))
+    {
+        deleteEdgeHashMap(reconnectMap);
+        reconnectMap = NULL;
+    }
+    pthread_mutex_unlock(&reconnectMutex);
+}
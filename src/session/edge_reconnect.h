@@ -0,0 +1,83 @@
+/******************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ *
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************/
+
+/**
+ * @file edge_reconnect.h
+ *
+ * @brief This file contains the automatic reconnection of lost client sessions.
+ *
+ * A lost session is connected again by the request which uses it next, or by a probe message
+ * queued at the end of the backoff when no request comes. Both run on the send lane of the
+ * endpoint, so the attempt never races with a request on the same session. The same client is
+ * connected again, which activates its old session on the new secure channel if the server
+ * still keeps it.
+ */
+
+#ifndef EDGE_RECONNECT_H
+#define EDGE_RECONNECT_H
+
+#include "opcua_common.h"
+#include "opcua_interface.h"
+
+#include <open62541.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/**
+ * @brief Configures the reconnection of lost sessions
+ * @param[in]  config Backoff and request buffering, NULL or initialDelayMs 0 disables it.
+ * @return @c EdgeResult code is 0 on success, otherwise an error value
+ * @retval #STATUS_OK Successful
+ * @retval #STATUS_PARAM_INVALID Invalid parameter
+ * @retval #STATUS_ERROR Probe timer could not be started
+ */
+EdgeResult setReconnectConfig(const EdgeReconnectConfig *config);
+
+/**
+ * @brief Starts the backoff of a session whose connection is lost
+ * @param[in]  client Client Handle.
+ * @param[in]  endpoint Endpoint Uri the session is connected to again.
+ * @return true if the session is connected again later, false if reconnecting is disabled.
+ */
+bool scheduleReconnect(UA_Client *client, const char *endpoint);
+
+/**
+ * @brief Connects a lost session again before a request uses it. The request waits up to
+ *        requestBufferMs for the end of the backoff, the call returns at once otherwise.
+ *        Must be called by the thread which holds the session.
+ * @param[in]  client Client Handle.
+ * @return true if the session is given up after maxAttempts failed attempts.
+ */
+bool awaitReconnect(UA_Client *client);
+
+/**
+ * @brief Drops the backoff of a client, called when its session ends
+ * @param[in]  client Client Handle.
+ */
+void removeReconnect(UA_Client *client);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // EDGE_RECONNECT_H
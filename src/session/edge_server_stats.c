@@ -0,0 +1,300 @@
+/******************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ *
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************/
+
+#include "edge_server_stats.h"
+#include "edge_utils.h"
+#include "edge_logger.h"
+#include "edge_malloc.h"
+#include "octhread.h"
+
+#ifndef _WIN32
+#include <pthread.h>
+#else
+#include "pthread.h"
+#endif
+
+#define TAG "server_stats"
+
+/* Severity bits of a Bad status, Good and Uncertain ones like GoodCompletesAsynchronously
+ * are no errors */
+#define STATUS_SEVERITY_BAD (0x80000000)
+
+#if defined(_MSC_VER)
+#define STATS_THREAD_LOCAL __declspec(thread)
+#else
+#define STATS_THREAD_LOCAL __thread
+#endif
+
+struct EdgeServerCounters
+{
+    struct EdgeServerCounters *next;
+    UA_Server *server;
+    void *nodestoreContext;
+
+    /* Nodestore functions which the hooks forward to */
+    UA_StatusCode (*insertNode)(void *nsCtx, UA_Node *node, UA_NodeId *addedNodeId);
+    UA_StatusCode (*removeNode)(void *nsCtx, const UA_NodeId *nodeId);
+
+    /* Guards stats, which the server loop updates while any thread may read them */
+    pthread_mutex_t mutex;
+    EdgeServerStats stats;
+};
+
+/* Counters of each server, guarded by g_countersMutex */
+static EdgeServerCounters *g_counters = NULL;
+static pthread_mutex_t g_countersMutex = PTHREAD_MUTEX_INITIALIZER;
+
+/* Counters of the server whose loop runs on the calling thread */
+static STATS_THREAD_LOCAL EdgeServerCounters *t_loopCounters = NULL;
+
+/* Access control functions which the hooks forward to, the same for every server */
+static UA_StatusCode (*g_activateSession)(const UA_NodeId *sessionId,
+        const UA_ExtensionObject *userIdentityToken, void **sessionContext) = NULL;
+static void (*g_closeSession)(const UA_NodeId *sessionId, void *sessionContext) = NULL;
+
+/**
+ * @brief findCounters - Gets the counters of a server or of its nodestore
+ * @param server - server handle, NULL to find by the nodestore
+ * @param nodestoreContext - nodestore context, NULL to find by the server
+ * @return counters, NULL if the server is not known
+ */
+static EdgeServerCounters *findCounters(const UA_Server *server, const void *nodestoreContext)
+{
+    EdgeServerCounters *loop = t_loopCounters;
+    if (IS_NOT_NULL(loop) && ((server && loop->server == server)
+            || (nodestoreContext && loop->nodestoreContext == nodestoreContext)))
+    {
+        return loop;
+    }
+
+    pthread_mutex_lock(&g_countersMutex);
+    EdgeServerCounters *counters = g_counters;
+    while (IS_NOT_NULL(counters) && !((server && counters->server == server)
+            || (nodestoreContext && counters->nodestoreContext == nodestoreContext)))
+    {
+        counters = counters->next;
+    }
+    pthread_mutex_unlock(&g_countersMutex);
+    return counters;
+}
+
+static void recordDuration(EdgeLatencyHistogram *histogram, uint64_t duration)
+{
+    histogram->count++;
+    histogram->totalUs += duration;
+    if (duration > histogram->maxUs)
+    {
+        histogram->maxUs = duration;
+    }
+
+    uint32_t bucket = 0;
+    uint64_t limit = 10;
+    while (bucket < EDGE_LATENCY_BUCKETS - 1 && duration >= limit)
+    {
+        bucket++;
+        limit *= 10;
+    }
+    histogram->histogram[bucket]++;
+}
+
+static UA_StatusCode insertNodeHook(void *nsCtx, UA_Node *node, UA_NodeId *addedNodeId)
+{
+    EdgeServerCounters *counters = findCounters(NULL, nsCtx);
+    VERIFY_NON_NULL_MSG(counters, "Nodestore of an unknown server\n",
+            UA_STATUSCODE_BADINTERNALERROR);
+    UA_StatusCode ret = counters->insertNode(nsCtx, node, addedNodeId);
+    if (ret == UA_STATUSCODE_GOOD)
+    {
+        pthread_mutex_lock(&counters->mutex);
+        counters->stats.nodeCount++;
+        pthread_mutex_unlock(&counters->mutex);
+    }
+    return ret;
+}
+
+static UA_StatusCode removeNodeHook(void *nsCtx, const UA_NodeId *nodeId)
+{
+    EdgeServerCounters *counters = findCounters(NULL, nsCtx);
+    VERIFY_NON_NULL_MSG(counters, "Nodestore of an unknown server\n",
+            UA_STATUSCODE_BADINTERNALERROR);
+    UA_StatusCode ret = counters->removeNode(nsCtx, nodeId);
+    if (ret == UA_STATUSCODE_GOOD)
+    {
+        pthread_mutex_lock(&counters->mutex);
+        counters->stats.nodeCount--;
+        pthread_mutex_unlock(&counters->mutex);
+    }
+    return ret;
+}
+
+/**
+ * @brief activateSessionHook - Counts an activated session. Sessions are activated in the server
+ *        loop, whose counters become the session context, so that closeSessionHook() finds them.
+ *        The default access control keeps no session context of its own.
+ */
+static UA_StatusCode activateSessionHook(const UA_NodeId *sessionId,
+        const UA_ExtensionObject *userIdentityToken, void **sessionContext)
+{
+    EdgeServerCounters *counted = (EdgeServerCounters *) *sessionContext;
+    UA_StatusCode ret = g_activateSession(sessionId, userIdentityToken, sessionContext);
+    if (ret != UA_STATUSCODE_GOOD)
+    {
+        *sessionContext = counted;
+        return ret;
+    }
+
+    /* A session activated again, on another channel or with another user, is counted once */
+    EdgeServerCounters *counters = IS_NOT_NULL(counted) ? counted : t_loopCounters;
+    *sessionContext = counters;
+    if (IS_NULL(counted) && IS_NOT_NULL(counters))
+    {
+        pthread_mutex_lock(&counters->mutex);
+        counters->stats.sessionCount++;
+        counters->stats.sessionTotal++;
+        pthread_mutex_unlock(&counters->mutex);
+    }
+    return ret;
+}
+
+static void closeSessionHook(const UA_NodeId *sessionId, void *sessionContext)
+{
+    EdgeServerCounters *counters = (EdgeServerCounters *) sessionContext;
+    if (IS_NOT_NULL(counters))
+    {
+        pthread_mutex_lock(&counters->mutex);
+        counters->stats.sessionCount--;
+        pthread_mutex_unlock(&counters->mutex);
+    }
+    g_closeSession(sessionId, NULL);
+}
+
+EdgeServerCounters *createServerCounters(UA_ServerConfig *config)
+{
+    VERIFY_NON_NULL_MSG(config, "NULL config in createServerCounters\n", NULL);
+    EdgeServerCounters *counters = (EdgeServerCounters *) EdgeCalloc(1,
+            sizeof(EdgeServerCounters));
+    VERIFY_NON_NULL_MSG(counters, "EdgeCalloc FAILED for the server counters\n", NULL);
+    pthread_mutex_init(&counters->mutex, NULL);
+    counters->nodestoreContext = config->nodestore.context;
+    counters->insertNode = config->nodestore.insertNode;
+    counters->removeNode = config->nodestore.removeNode;
+    config->nodestore.insertNode = insertNodeHook;
+    config->nodestore.removeNode = removeNodeHook;
+
+    pthread_mutex_lock(&g_countersMutex);
+    if (config->accessControl.activateSession != activateSessionHook)
+    {
+        g_activateSession = config->accessControl.activateSession;
+        g_closeSession = config->accessControl.closeSession;
+        config->accessControl.activateSession = activateSessionHook;
+        config->accessControl.closeSession = closeSessionHook;
+    }
+    counters->next = g_counters;
+    g_counters = counters;
+    pthread_mutex_unlock(&g_countersMutex);
+    return counters;
+}
+
+void setServerCountersServer(EdgeServerCounters *counters, UA_Server *server)
+{
+    VERIFY_NON_NULL_NR_MSG(counters, "NULL counters in setServerCountersServer\n");
+    pthread_mutex_lock(&g_countersMutex);
+    counters->server = server;
+    pthread_mutex_unlock(&g_countersMutex);
+}
+
+void deleteServerCounters(EdgeServerCounters *counters)
+{
+    VERIFY_NON_NULL_NR_MSG(counters, "NULL counters in deleteServerCounters\n");
+    pthread_mutex_lock(&g_countersMutex);
+    EdgeServerCounters **link = &g_counters;
+    while (IS_NOT_NULL(*link) && *link != counters)
+    {
+        link = &(*link)->next;
+    }
+    if (IS_NOT_NULL(*link))
+    {
+        *link = counters->next;
+    }
+    pthread_mutex_unlock(&g_countersMutex);
+    pthread_mutex_destroy(&counters->mutex);
+    EdgeFree(counters);
+}
+
+void bindServerCounters(EdgeServerCounters *counters)
+{
+    t_loopCounters = counters;
+}
+
+uint64_t getServerServiceTime()
+{
+    return oc_get_time_us();
+}
+
+void recordServerService(const UA_Server *server, EdgeServerService service, uint64_t startUs,
+        UA_StatusCode status)
+{
+    COND_CHECK_NR_MSG(((unsigned) service >= EDGE_SERVER_SERVICES), "Unknown server service\n");
+    uint64_t now = oc_get_time_us();
+    EdgeServerCounters *counters = findCounters(server, NULL);
+    VERIFY_NON_NULL_NR_MSG(counters, "Service call of an unknown server\n");
+
+    pthread_mutex_lock(&counters->mutex);
+    EdgeServiceStats *stats = &counters->stats.services[service];
+    recordDuration(&stats->latency, (now > startUs) ? now - startUs : 0);
+    if (status & STATUS_SEVERITY_BAD)
+    {
+        stats->errorCount++;
+    }
+    pthread_mutex_unlock(&counters->mutex);
+}
+
+void recordServerUpdates(EdgeServerCounters *counters, uint32_t count)
+{
+    if (IS_NULL(counters) || 0 == count)
+    {
+        return;
+    }
+    pthread_mutex_lock(&counters->mutex);
+    counters->stats.updateCount += count;
+    pthread_mutex_unlock(&counters->mutex);
+}
+
+void recordServerUnchangedWrites(const UA_Server *server, uint32_t count)
+{
+    if (0 == count)
+    {
+        return;
+    }
+    EdgeServerCounters *counters = findCounters(server, NULL);
+    VERIFY_NON_NULL_NR_MSG(counters, "Write of an unknown server\n");
+    pthread_mutex_lock(&counters->mutex);
+    counters->stats.unchangedWriteCount += count;
+    pthread_mutex_unlock(&counters->mutex);
+}
+
+void getServerCounters(EdgeServerCounters *counters, EdgeServerStats *stats)
+{
+    VERIFY_NON_NULL_NR_MSG(counters, "NULL counters in getServerCounters\n");
+    VERIFY_NON_NULL_NR_MSG(stats, "NULL stats in getServerCounters\n");
+    pthread_mutex_lock(&counters->mutex);
+    *stats = counters->stats;
+    pthread_mutex_unlock(&counters->mutex);
+}
@@ -0,0 +1,119 @@
+/******************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ *
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************/
+
+/**
+ * @file edge_server_stats.h
+ *
+ * @brief This file contains the runtime statistics of the server instances.
+ *
+ * The counters are kept by hooks the server calls anyway: the access control for sessions,
+ * the nodestore for its size and the callbacks of data source and method nodes for the services.
+ * Requests which the library answers without the application, like Browse or Publish,
+ * are not visible to them.
+ */
+
+#ifndef EDGE_SERVER_STATS_H
+#define EDGE_SERVER_STATS_H
+
+#include "opcua_common.h"
+#include "opcua_interface.h"
+
+#include <open62541.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/**
+ * @brief Counters of one server
+ */
+typedef struct EdgeServerCounters EdgeServerCounters;
+
+/**
+ * @brief Creates the counters of a server and hooks them into its configuration.
+ *        It is called before UA_Server_new(), which copies the configuration.
+ * @param[in]  config Configuration of the server
+ * @return Counters on success, otherwise NULL
+ */
+EdgeServerCounters *createServerCounters(UA_ServerConfig *config);
+
+/**
+ * @brief Sets the server of the counters once UA_Server_new() returned it
+ * @param[in]  counters Counters of the server
+ * @param[in]  server Server handle
+ */
+void setServerCountersServer(EdgeServerCounters *counters, UA_Server *server);
+
+/**
+ * @brief Frees the counters after the server is deleted
+ * @param[in]  counters Counters of the server
+ */
+void deleteServerCounters(EdgeServerCounters *counters);
+
+/**
+ * @brief Binds the counters to the calling thread, which runs the loop of their server,
+ *        so that the callbacks of the loop find them without a lookup
+ * @param[in]  counters Counters of the server, NULL to unbind
+ */
+void bindServerCounters(EdgeServerCounters *counters);
+
+/**
+ * @brief Gets the time which the service durations are measured with
+ * @return Monotonic time in microseconds
+ */
+uint64_t getServerServiceTime();
+
+/**
+ * @brief Records a call of a service which the application served
+ * @param[in]  server Server handle of the callback
+ * @param[in]  service Service of the call
+ * @param[in]  startUs Time from getServerServiceTime() when the call started
+ * @param[in]  status Status of the call, Bad statuses count as errors
+ */
+void recordServerService(const UA_Server *server, EdgeServerService service, uint64_t startUs,
+        UA_StatusCode status);
+
+/**
+ * @brief Records value updates written by the server loop
+ * @param[in]  counters Counters of the server
+ * @param[in]  count Number of updates
+ */
+void recordServerUpdates(EdgeServerCounters *counters, uint32_t count);
+
+/**
+ * @brief Records writes which were skipped because the node held the value already
+ * @param[in]  server Server handle
+ * @param[in]  count Number of writes
+ */
+void recordServerUnchangedWrites(const UA_Server *server, uint32_t count);
+
+/**
+ * @brief Copies the counters of a server
+ * @param[in]  counters Counters of the server
+ * @param[out] stats Receives the statistics
+ */
+void getServerCounters(EdgeServerCounters *counters, EdgeServerStats *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* EDGE_SERVER_STATS_H */
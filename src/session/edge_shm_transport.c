@@ -0,0 +1,725 @@
+/******************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ *
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************/
+
+
+#include "edge_shm_transport.h"
+#include "edge_open62541.h"
+#include "edge_utils.h"
+#include "edge_logger.h"
+#include "edge_malloc.h"
+
+#include <string.h>
+#ifndef _WIN32
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+#define TAG "edge_shm_transport"
+
+#define SHM_MAGIC (0x4D485345u) /* "ESHM" */
+#define SHM_VERSION (1)
+#define SHM_MIN_SIZE (64 * 1024)
+
+/* Records and the fixed parts of a message start on 8 byte boundaries */
+#define SHM_ALIGN(size) (((size) + 7) & ~((uint64_t) 7))
+
+/* Record which fills the end of the ring, the next record starts at the beginning */
+#define SHM_RECORD_PAD (1u)
+
+#ifndef _WIN32
+
+/* Header of the ring in shared memory. Positions count the bytes written since the ring was
+ * created, a position is at offset position % dataSize of the data. */
+typedef struct ShmRingHeader
+{
+    uint32_t magic;
+    uint32_t version;
+    uint64_t dataSize;
+    /* End of the last published record */
+    uint64_t writePos;
+    /* Start of the oldest record, the records before it may be overwritten */
+    uint64_t reclaimPos;
+    /* Sequence of the last published message */
+    uint64_t sequence;
+    /* Consumers which wait for the next message */
+    uint32_t waiters;
+    pthread_mutex_t mutex;
+    pthread_cond_t cond;
+} ShmRingHeader;
+
+/* Data starts on a cache line after the header */
+#define SHM_DATA_OFFSET ((sizeof(ShmRingHeader) + 63) & ~((size_t) 63))
+
+typedef struct ShmRecordHeader
+{
+    /* Length of the message of the record */
+    uint32_t length;
+    uint32_t flags;
+} ShmRecordHeader;
+
+struct EdgeShmPublisher
+{
+    char *name;
+    int fd;
+    uint8_t *base;
+    size_t mapSize;
+    ShmRingHeader *header;
+    uint8_t *data;
+    /* Serializes the threads of the publishing process */
+    pthread_mutex_t lock;
+};
+
+struct EdgeShmConsumer
+{
+    int fd;
+    uint8_t *base;
+    size_t mapSize;
+    ShmRingHeader *header;
+    uint8_t *data;
+    uint64_t readPos;
+    /* Sequence of the next message, 0 until the first message is read */
+    uint64_t nextSequence;
+    uint64_t lostCount;
+    /* Message read last, its position and length */
+    const EdgeShmMessage *current;
+    uint64_t currentPos;
+    uint32_t currentLength;
+};
+
+#endif
+
+/* Lays out a flat message. While base is NULL the sizes of the fixed parts and of the strings
+ * are counted, the strings follow the fixed parts when the message is written. */
+typedef struct ShmWriter
+{
+    uint8_t *base;
+    uint64_t fixedPos;
+    uint64_t stringPos;
+} ShmWriter;
+
+static uint32_t reserveFixed(ShmWriter *writer, uint64_t size)
+{
+    uint64_t offset = SHM_ALIGN(writer->fixedPos);
+    writer->fixedPos = offset + size;
+    return (uint32_t) offset;
+}
+
+static void writeFixed(ShmWriter *writer, uint32_t offset, const void *value, size_t size)
+{
+    if (IS_NOT_NULL(writer->base))
+    {
+        memcpy(writer->base + offset, value, size);
+    }
+}
+
+static EdgeShmString putString(ShmWriter *writer, const void *data, size_t length)
+{
+    EdgeShmString str = { 0, 0 };
+    COND_CHECK((IS_NULL(data)), str);
+    str.offset = (uint32_t) writer->stringPos;
+    str.length = (uint32_t) length;
+    if (IS_NOT_NULL(writer->base))
+    {
+        memcpy(writer->base + writer->stringPos, data, length);
+        writer->base[writer->stringPos + length] = '\0';
+    }
+    writer->stringPos += length + 1;
+    return str;
+}
+
+static EdgeShmString putCString(ShmWriter *writer, const char *str)
+{
+    return putString(writer, str, IS_NOT_NULL(str) ? strlen(str) : 0);
+}
+
+/* Size of the message laid out by a counting writer */
+static uint64_t getCountedSize(const ShmWriter *writer)
+{
+    return SHM_ALIGN(writer->fixedPos) + writer->stringPos;
+}
+
+static EdgeShmValueKind getShmValueKind(int typeIndex)
+{
+    const EdgeTypeConversion *conversion = getEdgeTypeConversion(typeIndex);
+    COND_CHECK((IS_NULL(conversion)), EDGE_SHM_VALUE_NONE);
+    switch (typeIndex)
+    {
+        case UA_TYPES_STRING:
+        case UA_TYPES_BYTESTRING:
+        case UA_TYPES_XMLELEMENT:
+        case UA_TYPES_GUID:
+            return EDGE_SHM_VALUE_STRING;
+        case UA_TYPES_QUALIFIEDNAME:
+            return EDGE_SHM_VALUE_QUALIFIEDNAME;
+        case UA_TYPES_LOCALIZEDTEXT:
+            return EDGE_SHM_VALUE_LOCALIZEDTEXT;
+        default:
+            /* Values with pointers, like NodeIds, can not be read by another process */
+            return (IS_NULL(conversion->toEdge) && UA_TYPES[typeIndex].pointerFree) ?
+                    EDGE_SHM_VALUE_PLAIN : EDGE_SHM_VALUE_NONE;
+    }
+}
+
+static size_t getShmElementSize(EdgeShmValueKind kind, int typeIndex)
+{
+    switch (kind)
+    {
+        case EDGE_SHM_VALUE_PLAIN:
+            return getEdgeTypeConversion(typeIndex)->edgeSize;
+        case EDGE_SHM_VALUE_STRING:
+            return sizeof(EdgeShmString);
+        case EDGE_SHM_VALUE_QUALIFIEDNAME:
+            return sizeof(EdgeShmQualifiedName);
+        case EDGE_SHM_VALUE_LOCALIZEDTEXT:
+            return sizeof(EdgeShmLocalizedText);
+        default:
+            return 0;
+    }
+}
+
+/* Scalars of the converted types are one Edge value, arrays are pointers to Edge values */
+static const void *getEdgeElement(const EdgeVersatility *versatility, size_t index)
+{
+    return versatility->isArray ? ((void * const *) versatility->value)[index] : versatility->value;
+}
+
+static void putValue(ShmWriter *writer, const EdgeResponse *response, EdgeShmResponse *flat)
+{
+    const EdgeVersatility *versatility = response->message;
+    if (IS_NULL(versatility) || IS_NULL(versatility->value))
+    {
+        return;
+    }
+    /* The response type is the UA_TYPES index plus one */
+    int typeIndex = response->type - 1;
+    EdgeShmValueKind kind = getShmValueKind(typeIndex);
+    if (EDGE_SHM_VALUE_NONE == kind)
+    {
+        return;
+    }
+    size_t count = versatility->isArray ? versatility->arrayLength : 1;
+    size_t elementSize = getShmElementSize(kind, typeIndex);
+    flat->valueKind = kind;
+    flat->arrayLength = versatility->isArray ? (uint32_t) versatility->arrayLength : 0;
+    flat->valueOffset = reserveFixed(writer, count * elementSize);
+    if (EDGE_SHM_VALUE_PLAIN == kind)
+    {
+        /* Arrays of plain values are one block in the Edge representation as well */
+        writeFixed(writer, flat->valueOffset, versatility->value, count * elementSize);
+        return;
+    }
+
+    for (size_t i = 0; i < count; i++)
+    {
+        const void *element = getEdgeElement(versatility, i);
+        uint32_t offset = (uint32_t) (flat->valueOffset + i * elementSize);
+        if (EDGE_SHM_VALUE_STRING == kind)
+        {
+            EdgeShmString str = putCString(writer, (const char *) element);
+            writeFixed(writer, offset, &str, sizeof(str));
+        }
+        else if (EDGE_SHM_VALUE_QUALIFIEDNAME == kind)
+        {
+            const Edge_QualifiedName *name = (const Edge_QualifiedName *) element;
+            EdgeShmQualifiedName value;
+            memset(&value, 0, sizeof(value));
+            if (IS_NOT_NULL(name))
+            {
+                value.namespaceIndex = name->namespaceIndex;
+                value.name = putString(writer, name->name.data, name->name.length);
+            }
+            writeFixed(writer, offset, &value, sizeof(value));
+        }
+        else
+        {
+            const Edge_LocalizedText *text = (const Edge_LocalizedText *) element;
+            EdgeShmLocalizedText value;
+            memset(&value, 0, sizeof(value));
+            if (IS_NOT_NULL(text))
+            {
+                value.locale = putString(writer, text->locale.data, text->locale.length);
+                value.text = putString(writer, text->text.data, text->text.length);
+            }
+            writeFixed(writer, offset, &value, sizeof(value));
+        }
+    }
+}
+
+/**
+ * @brief putMessage - Lays out the flat form of a message
+ * @param writer - Writer of the message
+ * @param msg - Message
+ * @param sequence - Sequence of the message in the ring
+ */
+static void putMessage(ShmWriter *writer, const EdgeMessage *msg, uint64_t sequence)
+{
+    EdgeShmMessage flat;
+    memset(&flat, 0, sizeof(flat));
+    uint32_t offset = reserveFixed(writer, sizeof(EdgeShmMessage));
+    flat.type = (uint32_t) msg->type;
+    flat.command = (uint32_t) msg->command;
+    flat.messageId = msg->message_id;
+    flat.statusCode = IS_NOT_NULL(msg->result) ? (uint32_t) msg->result->code : 0;
+    flat.endpointUri = putCString(writer, IS_NOT_NULL(msg->endpointInfo) ?
+            msg->endpointInfo->endpointUri : NULL);
+    flat.serverTime = (int64_t) msg->serverTime.tv.tv_sec * 1000000 + msg->serverTime.tv.tv_usec;
+    flat.sequence = sequence;
+
+    flat.responseCount = IS_NOT_NULL(msg->responses) ? (uint32_t) msg->responseLength : 0;
+    if (flat.responseCount > 0)
+    {
+        flat.responsesOffset = reserveFixed(writer, flat.responseCount * sizeof(EdgeShmResponse));
+    }
+    for (uint32_t i = 0; i < flat.responseCount; i++)
+    {
+        const EdgeResponse *response = msg->responses[i];
+        EdgeShmResponse flatResponse;
+        memset(&flatResponse, 0, sizeof(flatResponse));
+        if (IS_NOT_NULL(response))
+        {
+            flatResponse.valueAlias = putCString(writer, IS_NOT_NULL(response->nodeInfo) ?
+                    response->nodeInfo->valueAlias : NULL);
+            flatResponse.type = response->type;
+            flatResponse.statusCode = IS_NOT_NULL(response->result) ?
+                    (uint32_t) response->result->code : 0;
+            flatResponse.attributeId = response->attributeId;
+            flatResponse.sourceTimestamp = response->sourceTimestamp;
+            flatResponse.serverTimestamp = response->serverTimestamp;
+            flatResponse.receiveTimestamp = response->receiveTimestamp;
+            putValue(writer, response, &flatResponse);
+        }
+        writeFixed(writer, flat.responsesOffset + i * sizeof(EdgeShmResponse), &flatResponse,
+                sizeof(flatResponse));
+    }
+
+    flat.size = (uint32_t) (IS_NOT_NULL(writer->base) ? writer->stringPos : getCountedSize(writer));
+    writeFixed(writer, offset, &flat, sizeof(flat));
+}
+
+#ifndef _WIN32
+
+static void lockRing(ShmRingHeader *header)
+{
+    /* A process which died holding the lock left nothing inconsistent behind */
+    if (EOWNERDEAD == pthread_mutex_lock(&header->mutex))
+    {
+        pthread_mutex_consistent(&header->mutex);
+    }
+}
+
+static bool initRingLock(ShmRingHeader *header)
+{
+    pthread_mutexattr_t mutexAttr;
+    pthread_condattr_t condAttr;
+    bool initialized = false;
+    pthread_mutexattr_init(&mutexAttr);
+    pthread_condattr_init(&condAttr);
+    if (0 == pthread_mutexattr_setpshared(&mutexAttr, PTHREAD_PROCESS_SHARED)
+            && 0 == pthread_mutexattr_setrobust(&mutexAttr, PTHREAD_MUTEX_ROBUST)
+            && 0 == pthread_condattr_setpshared(&condAttr, PTHREAD_PROCESS_SHARED)
+            && 0 == pthread_condattr_setclock(&condAttr, CLOCK_MONOTONIC)
+            && 0 == pthread_mutex_init(&header->mutex, &mutexAttr))
+    {
+        initialized = (0 == pthread_cond_init(&header->cond, &condAttr));
+        if (!initialized)
+        {
+            pthread_mutex_destroy(&header->mutex);
+        }
+    }
+    pthread_condattr_destroy(&condAttr);
+    pthread_mutexattr_destroy(&mutexAttr);
+    return initialized;
+}
+
+#endif
+
+EdgeShmPublisher *createShmRingPublisher(const char *name, size_t size)
+{
+    VERIFY_NON_NULL_MSG(name, "NULL name param in createShmRingPublisher\n", NULL);
+#ifdef _WIN32
+    EDGE_LOG(TAG, "Shared memory rings are not supported on this platform\n");
+    return NULL;
+#else
+    uint64_t dataSize = (0 == size) ? EDGE_SHM_DEFAULT_SIZE : size;
+    dataSize = (dataSize < SHM_MIN_SIZE) ? SHM_MIN_SIZE : (dataSize & ~((uint64_t) 7));
+
+    EdgeShmPublisher *publisher = (EdgeShmPublisher *) EdgeCalloc(1, sizeof(EdgeShmPublisher));
+    VERIFY_NON_NULL_MSG(publisher, "EdgeCalloc FAILED for EdgeShmPublisher\n", NULL);
+    publisher->fd = -1;
+    publisher->name = cloneString(name);
+    if (IS_NULL(publisher->name) || 0 != pthread_mutex_init(&publisher->lock, NULL))
+    {
+        EDGE_LOG(TAG, "Memory allocation failed for EdgeShmPublisher\n");
+        EdgeFree(publisher->name);
+        EdgeFree(publisher);
+        return NULL;
+    }
+
+    /* A ring left by an earlier run is replaced, its consumers keep their mapping */
+    shm_unlink(name);
+    publisher->fd = shm_open(name, O_RDWR | O_CREAT | O_EXCL, 0600);
+    publisher->mapSize = (size_t) (SHM_DATA_OFFSET + dataSize);
+    if (publisher->fd < 0 || 0 != ftruncate(publisher->fd, (off_t) publisher->mapSize))
+    {
+        EDGE_LOG_V(TAG, "Failed to create the shared memory %s\n", name);
+        goto ERROR;
+    }
+    void *base = mmap(NULL, publisher->mapSize, PROT_READ | PROT_WRITE, MAP_SHARED,
+            publisher->fd, 0);
+    if (MAP_FAILED == base)
+    {
+        EDGE_LOG_V(TAG, "Failed to map the shared memory %s\n", name);
+        goto ERROR;
+    }
+    publisher->base = (uint8_t *) base;
+    publisher->header = (ShmRingHeader *) base;
+    publisher->data = publisher->base + SHM_DATA_OFFSET;
+
+    ShmRingHeader *header = publisher->header;
+    header->version = SHM_VERSION;
+    header->dataSize = dataSize;
+    if (!initRingLock(header))
+    {
+        EDGE_LOG(TAG, "Failed to create the lock of the shared memory ring\n");
+        goto ERROR;
+    }
+    /* Consumers open the ring once the magic is set */
+    __atomic_store_n(&header->magic, SHM_MAGIC, __ATOMIC_RELEASE);
+    return publisher;
+
+ERROR:
+    deleteShmRingPublisher(publisher);
+    return NULL;
+#endif
+}
+
+EdgeResult publishToShmRing(EdgeShmPublisher *publisher, const EdgeMessage *msg)
+{
+    EdgeResult result = { STATUS_PARAM_INVALID };
+    VERIFY_NON_NULL_MSG(publisher, "NULL publisher param in publishToShmRing\n", result);
+    VERIFY_NON_NULL_MSG(msg, "NULL msg param in publishToShmRing\n", result);
+#ifdef _WIN32
+    result.code = STATUS_ERROR;
+    return result;
+#else
+    ShmRingHeader *header = publisher->header;
+    uint64_t dataSize = header->dataSize;
+    ShmWriter counter = { NULL, 0, 0 };
+    putMessage(&counter, msg, 0);
+    uint64_t length = getCountedSize(&counter);
+    uint64_t recordSize = sizeof(ShmRecordHeader) + SHM_ALIGN(length);
+    if (recordSize > dataSize / 2)
+    {
+        EDGE_LOG_V(TAG, "Message of %llu bytes is too large for the shared memory ring\n",
+                (unsigned long long) length);
+        result.code = STATUS_ENQUEUE_ERROR;
+        return result;
+    }
+
+    pthread_mutex_lock(&publisher->lock);
+    uint64_t pos = header->writePos;
+    uint64_t index = pos % dataSize;
+    uint64_t pad = (index + recordSize > dataSize) ? dataSize - index : 0;
+
+    /* The oldest records are given up before they are overwritten, consumers which read them
+     * see it before the records change */
+    uint64_t reclaimPos = header->reclaimPos;
+    while (reclaimPos + dataSize < pos + pad + recordSize)
+    {
+        uint64_t oldIndex = reclaimPos % dataSize;
+        ShmRecordHeader oldRecord;
+        memcpy(&oldRecord, publisher->data + oldIndex, sizeof(oldRecord));
+        reclaimPos += (oldRecord.flags & SHM_RECORD_PAD) ? dataSize - oldIndex :
+                sizeof(ShmRecordHeader) + SHM_ALIGN(oldRecord.length);
+    }
+    if (reclaimPos != header->reclaimPos)
+    {
+        __atomic_store_n(&header->reclaimPos, reclaimPos, __ATOMIC_RELAXED);
+        __atomic_thread_fence(__ATOMIC_RELEASE);
+    }
+    if (pad > 0)
+    {
+        ShmRecordHeader padRecord = { 0, SHM_RECORD_PAD };
+        memcpy(publisher->data + index, &padRecord, sizeof(padRecord));
+        pos += pad;
+        index = 0;
+    }
+
+    uint64_t sequence = header->sequence + 1;
+    ShmWriter writer = { publisher->data + index + sizeof(ShmRecordHeader), 0,
+            SHM_ALIGN(counter.fixedPos) };
+    putMessage(&writer, msg, sequence);
+    ShmRecordHeader record = { (uint32_t) length, 0 };
+    memcpy(publisher->data + index, &record, sizeof(record));
+    __atomic_store_n(&header->sequence, sequence, __ATOMIC_RELAXED);
+    __atomic_store_n(&header->writePos, pos + recordSize, __ATOMIC_SEQ_CST);
+
+    if (__atomic_load_n(&header->waiters, __ATOMIC_SEQ_CST) > 0)
+    {
+        lockRing(header);
+        pthread_cond_broadcast(&header->cond);
+        pthread_mutex_unlock(&header->mutex);
+    }
+    pthread_mutex_unlock(&publisher->lock);
+    result.code = STATUS_OK;
+    return result;
+#endif
+}
+
+void deleteShmRingPublisher(EdgeShmPublisher *publisher)
+{
+    VERIFY_NON_NULL_NR_MSG(publisher, "NULL publisher param in deleteShmRingPublisher\n");
+#ifndef _WIN32
+    if (IS_NOT_NULL(publisher->base))
+    {
+        munmap(publisher->base, publisher->mapSize);
+    }
+    if (publisher->fd >= 0)
+    {
+        close(publisher->fd);
+        shm_unlink(publisher->name);
+    }
+    pthread_mutex_destroy(&publisher->lock);
+#endif
+    EdgeFree(publisher->name);
+    EdgeFree(publisher);
+}
+
+EdgeShmConsumer *openShmRingConsumer(const char *name)
+{
+    VERIFY_NON_NULL_MSG(name, "NULL name param in openShmRingConsumer\n", NULL);
+#ifdef _WIN32
+    EDGE_LOG(TAG, "Shared memory rings are not supported on this platform\n");
+    return NULL;
+#else
+    EdgeShmConsumer *consumer = (EdgeShmConsumer *) EdgeCalloc(1, sizeof(EdgeShmConsumer));
+    VERIFY_NON_NULL_MSG(consumer, "EdgeCalloc FAILED for EdgeShmConsumer\n", NULL);
+    struct stat st;
+    consumer->fd = shm_open(name, O_RDWR, 0);
+    if (consumer->fd < 0 || 0 != fstat(consumer->fd, &st) || (size_t) st.st_size <= SHM_DATA_OFFSET)
+    {
+        EDGE_LOG_V(TAG, "Failed to open the shared memory %s\n", name);
+        goto ERROR;
+    }
+    consumer->mapSize = (size_t) st.st_size;
+    void *base = mmap(NULL, consumer->mapSize, PROT_READ | PROT_WRITE, MAP_SHARED, consumer->fd, 0);
+    if (MAP_FAILED == base)
+    {
+        EDGE_LOG_V(TAG, "Failed to map the shared memory %s\n", name);
+        goto ERROR;
+    }
+    consumer->base = (uint8_t *) base;
+    consumer->header = (ShmRingHeader *) base;
+    consumer->data = consumer->base + SHM_DATA_OFFSET;
+
+    ShmRingHeader *header = consumer->header;
+    if (SHM_MAGIC != __atomic_load_n(&header->magic, __ATOMIC_ACQUIRE)
+            || SHM_VERSION != header->version
+            || SHM_DATA_OFFSET + header->dataSize != consumer->mapSize)
+    {
+        EDGE_LOG_V(TAG, "The shared memory %s is no ring of this version\n", name);
+        goto ERROR;
+    }
+    consumer->readPos = __atomic_load_n(&header->writePos, __ATOMIC_ACQUIRE);
+    return consumer;
+
+ERROR:
+    closeShmRingConsumer(consumer);
+    return NULL;
+#endif
+}
+
+#ifndef _WIN32
+
+/* Waits until a message is published after the read position or the deadline passes */
+static bool waitForShmMessage(EdgeShmConsumer *consumer, const struct timespec *deadline)
+{
+    ShmRingHeader *header = consumer->header;
+    lockRing(header);
+    __atomic_add_fetch(&header->waiters, 1, __ATOMIC_SEQ_CST);
+    int ret = 0;
+    while (consumer->readPos == __atomic_load_n(&header->writePos, __ATOMIC_SEQ_CST)
+            && ETIMEDOUT != ret)
+    {
+        ret = pthread_cond_timedwait(&header->cond, &header->mutex, deadline);
+        if (EOWNERDEAD == ret)
+        {
+            pthread_mutex_consistent(&header->mutex);
+        }
+    }
+    __atomic_sub_fetch(&header->waiters, 1, __ATOMIC_SEQ_CST);
+    pthread_mutex_unlock(&header->mutex);
+    return consumer->readPos != __atomic_load_n(&header->writePos, __ATOMIC_ACQUIRE);
+}
+
+#endif
+
+const EdgeShmMessage *readFromShmRing(EdgeShmConsumer *consumer, uint32_t timeoutMs)
+{
+    VERIFY_NON_NULL_MSG(consumer, "NULL consumer param in readFromShmRing\n", NULL);
+#ifdef _WIN32
+    return NULL;
+#else
+    releaseShmRingMessage(consumer);
+    ShmRingHeader *header = consumer->header;
+    uint64_t dataSize = header->dataSize;
+    struct timespec deadline;
+    clock_gettime(CLOCK_MONOTONIC, &deadline);
+    deadline.tv_sec += timeoutMs / 1000;
+    deadline.tv_nsec += (long) (timeoutMs % 1000) * 1000000;
+    if (deadline.tv_nsec >= 1000000000)
+    {
+        deadline.tv_sec++;
+        deadline.tv_nsec -= 1000000000;
+    }
+
+    for (;;)
+    {
+        uint64_t writePos = __atomic_load_n(&header->writePos, __ATOMIC_ACQUIRE);
+        if (consumer->readPos == writePos)
+        {
+            if (0 == timeoutMs || !waitForShmMessage(consumer, &deadline))
+            {
+                return NULL;
+            }
+            continue;
+        }
+
+        uint64_t index = consumer->readPos % dataSize;
+        ShmRecordHeader record;
+        memcpy(&record, consumer->data + index, sizeof(record));
+        /* The record is only valid if it was not overwritten while it was read */
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+        uint64_t reclaimPos = __atomic_load_n(&header->reclaimPos, __ATOMIC_RELAXED);
+        if (consumer->readPos < reclaimPos)
+        {
+            /* Overtaken by the publisher, the lost messages are counted by their sequence */
+            consumer->readPos = reclaimPos;
+            continue;
+        }
+        if (!(record.flags & SHM_RECORD_PAD)
+                && record.length > dataSize - index - sizeof(ShmRecordHeader))
+        {
+            EDGE_LOG(TAG, "Invalid record in the shared memory ring, skipped to the newest\n");
+            consumer->readPos = writePos;
+            continue;
+        }
+        if (record.flags & SHM_RECORD_PAD)
+        {
+            consumer->readPos += dataSize - index;
+            continue;
+        }
+
+        consumer->current = (const EdgeShmMessage *) (consumer->data + index
+                + sizeof(ShmRecordHeader));
+        consumer->currentPos = consumer->readPos;
+        consumer->currentLength = record.length;
+        consumer->readPos += sizeof(ShmRecordHeader) + SHM_ALIGN(record.length);
+
+        uint64_t sequence = consumer->current->sequence;
+        if (0 != consumer->nextSequence && sequence > consumer->nextSequence)
+        {
+            consumer->lostCount += sequence - consumer->nextSequence;
+        }
+        consumer->nextSequence = sequence + 1;
+        return consumer->current;
+    }
+#endif
+}
+
+bool releaseShmRingMessage(EdgeShmConsumer *consumer)
+{
+    COND_CHECK((IS_NULL(consumer) || IS_NULL(consumer->current)), false);
+#ifdef _WIN32
+    return false;
+#else
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+    bool intact = consumer->currentPos >= __atomic_load_n(&consumer->header->reclaimPos,
+            __ATOMIC_RELAXED);
+    consumer->current = NULL;
+    if (!intact)
+    {
+        consumer->lostCount++;
+    }
+    return intact;
+#endif
+}
+
+/* Checks that a part of the message read last is inside the message */
+static bool isInCurrentMessage(const EdgeShmConsumer *consumer, uint64_t offset, uint64_t size)
+{
+    return IS_NOT_NULL(consumer) && IS_NOT_NULL(consumer->current) && 0 != offset
+            && offset + size <= consumer->currentLength;
+}
+
+const char *getShmRingString(const EdgeShmConsumer *consumer, EdgeShmString str)
+{
+    COND_CHECK((!isInCurrentMessage(consumer, str.offset, (uint64_t) str.length + 1)), NULL);
+    return (const char *) consumer->current + str.offset;
+}
+
+const EdgeShmResponse *getShmRingResponse(const EdgeShmConsumer *consumer, size_t index)
+{
+    COND_CHECK((IS_NULL(consumer) || IS_NULL(consumer->current)), NULL);
+    COND_CHECK((index >= consumer->current->responseCount), NULL);
+    uint64_t offset = (uint64_t) consumer->current->responsesOffset
+            + index * sizeof(EdgeShmResponse);
+    COND_CHECK((!isInCurrentMessage(consumer, offset, sizeof(EdgeShmResponse))), NULL);
+    return (const EdgeShmResponse *) ((const uint8_t *) consumer->current + offset);
+}
+
+const void *getShmRingValue(const EdgeShmConsumer *consumer, const EdgeShmResponse *response)
+{
+    VERIFY_NON_NULL_MSG(response, "NULL response param in getShmRingValue\n", NULL);
+    EdgeShmValueKind kind = (EdgeShmValueKind) response->valueKind;
+    int typeIndex = response->type - 1;
+    COND_CHECK((kind != getShmValueKind(typeIndex)), NULL);
+    uint64_t count = (0 == response->arrayLength) ? 1 : response->arrayLength;
+    uint64_t size = count * getShmElementSize(kind, typeIndex);
+    COND_CHECK((!isInCurrentMessage(consumer, response->valueOffset, size)), NULL);
+    return (const uint8_t *) consumer->current + response->valueOffset;
+}
+
+uint64_t getShmRingLostCount(const EdgeShmConsumer *consumer)
+{
+    COND_CHECK((IS_NULL(consumer)), 0);
+    return consumer->lostCount;
+}
+
+void closeShmRingConsumer(EdgeShmConsumer *consumer)
+{
+    VERIFY_NON_NULL_NR_MSG(consumer, "NULL consumer param in closeShmRingConsumer\n");
+#ifndef _WIN32
+    if (IS_NOT_NULL(consumer->base))
+    {
+        munmap(consumer->base, consumer->mapSize);
+    }
+    if (consumer->fd >= 0)
+    {
+        close(consumer->fd);
+    }
+#endif
+    EdgeFree(consumer);
+}
@@ -0,0 +1,136 @@
+/******************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ *
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************/
+
+
+/**
+ * @file edge_shm_transport.h
+ * @brief This file contains the shared memory rings which hand EdgeMessages to other
+ *        processes of the host. A publisher writes each message in a flat form into the ring,
+ *        consumers read it where it is, without copying or decoding it.
+ */
+
+#ifndef EDGE_SHM_TRANSPORT_H
+#define EDGE_SHM_TRANSPORT_H
+
+#include "opcua_common.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/* Size of the ring if none is given */
+#define EDGE_SHM_DEFAULT_SIZE (16 * 1024 * 1024)
+
+/**
+ * @brief Creates a ring in shared memory, a ring of the same name is replaced.
+ * @param[in]  name POSIX shared memory name, like "/edge-reports"
+ * @param[in]  size Size of the ring in bytes, 0 for EDGE_SHM_DEFAULT_SIZE
+ * @return Publisher on success, otherwise NULL
+ */
+EdgeShmPublisher *createShmRingPublisher(const char *name, size_t size);
+
+/**
+ * @brief Writes a message in its flat form to the ring. It may be called from several
+ *        threads. The oldest messages are overwritten, the publisher never waits for consumers.
+ * @param[in]  publisher Publisher
+ * @param[in]  msg Message, which stays with the caller
+ * @return STATUS_OK on success, STATUS_ENQUEUE_ERROR if the message takes more than half
+ *         of the ring
+ */
+EdgeResult publishToShmRing(EdgeShmPublisher *publisher, const EdgeMessage *msg);
+
+/**
+ * @brief Removes the name of the ring and deletes the publisher. Consumers keep their
+ *        mapping of the ring, which receives no more messages.
+ * @param[in]  publisher Publisher, can be NULL
+ */
+void deleteShmRingPublisher(EdgeShmPublisher *publisher);
+
+/**
+ * @brief Opens the ring of a publisher, messages published from now on are read.
+ *        A consumer is used by one thread at a time.
+ * @param[in]  name Name of the ring
+ * @return Consumer on success, otherwise NULL
+ */
+EdgeShmConsumer *openShmRingConsumer(const char *name);
+
+/**
+ * @brief Reads the next message in the ring, the message read before is released.
+ * @param[in]  consumer Consumer
+ * @param[in]  timeoutMs Milliseconds to wait for a message, 0 returns at once
+ * @return Message in the ring, NULL if there is none
+ */
+const EdgeShmMessage *readFromShmRing(EdgeShmConsumer *consumer, uint32_t timeoutMs);
+
+/**
+ * @brief Releases the message read last. The publisher may have overwritten it while it was
+ *        read, then everything taken from it must be discarded.
+ * @param[in]  consumer Consumer
+ * @return @c true if the message was not overwritten, @c false otherwise
+ */
+bool releaseShmRingMessage(EdgeShmConsumer *consumer);
+
+/**
+ * @brief Gets a string of the message read last
+ * @param[in]  consumer Consumer
+ * @param[in]  str String of the message
+ * @return '\0' terminated string in the ring, NULL for a NULL or invalid string
+ */
+const char *getShmRingString(const EdgeShmConsumer *consumer, EdgeShmString str);
+
+/**
+ * @brief Gets a response of the message read last
+ * @param[in]  consumer Consumer
+ * @param[in]  index Index of the response
+ * @return Response in the ring, NULL for an invalid index
+ */
+const EdgeShmResponse *getShmRingResponse(const EdgeShmConsumer *consumer, size_t index);
+
+/**
+ * @brief Gets the value of a response of the message read last
+ * @param[in]  consumer Consumer
+ * @param[in]  response Response of the message
+ * @return First element of the value in the layout of its #EdgeShmValueKind,
+ *         NULL if there is none
+ */
+const void *getShmRingValue(const EdgeShmConsumer *consumer, const EdgeShmResponse *response);
+
+/**
+ * @brief Gets the number of messages which were overwritten before they were read
+ * @param[in]  consumer Consumer
+ * @return Number of lost messages
+ */
+uint64_t getShmRingLostCount(const EdgeShmConsumer *consumer);
+
+/**
+ * @brief Closes the ring of a consumer and deletes it
+ * @param[in]  consumer Consumer, can be NULL
+ */
+void closeShmRingConsumer(EdgeShmConsumer *consumer);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* EDGE_SHM_TRANSPORT_H */
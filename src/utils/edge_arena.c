@@ -0,0 +1,85 @@
+/******************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ *
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************/
+
+#include "edge_arena.h"
+#include "edge_malloc.h"
+#include "edge_utils.h"
+
+#include <string.h>
+
+#define TAG "edge_arena"
+
+size_t getEdgeArenaSize(size_t size)
+{
+    return (size + EDGE_ARENA_ALIGNMENT - 1) & ~((size_t) EDGE_ARENA_ALIGNMENT - 1);
+}
+
+size_t getEdgeArenaStringSize(const char *str)
+{
+    COND_CHECK((IS_NULL(str)), 0);
+    return getEdgeArenaSize(strlen(str) + 1);
+}
+
+bool initEdgeArena(EdgeArena *arena, size_t size)
+{
+    VERIFY_NON_NULL_MSG(arena, "NULL arena param in initEdgeArena\n", false);
+    arena->used = 0;
+    arena->exhausted = false;
+    arena->size = getEdgeArenaSize(size);
+    arena->base = (uint8_t *) EdgeCalloc(1, arena->size);
+    VERIFY_NON_NULL_MSG(arena->base, "EdgeCalloc FAILED for arena block\n", false);
+    return true;
+}
+
+void *allocEdgeArena(EdgeArena *arena, size_t size)
+{
+    VERIFY_NON_NULL_MSG(arena, "NULL arena param in allocEdgeArena\n", NULL);
+    COND_CHECK((0 == size), NULL);
+    size_t rounded = getEdgeArenaSize(size);
+    if (IS_NULL(arena->base) || rounded > arena->size - arena->used)
+    {
+        EDGE_LOG(TAG, "Arena is exhausted.");
+        arena->exhausted = true;
+        return NULL;
+    }
+
+    void *ptr = arena->base + arena->used;
+    arena->used += rounded;
+    return ptr;
+}
+
+char *cloneStringInArena(EdgeArena *arena, const char *str)
+{
+    COND_CHECK((IS_NULL(str)), NULL);
+    size_t len = strlen(str);
+    char *clone = (char *) allocEdgeArena(arena, len + 1);
+    COND_CHECK((IS_NULL(clone)), NULL);
+    memcpy(clone, str, len + 1);
+    return clone;
+}
+
+void *cloneDataInArena(EdgeArena *arena, const void *src, size_t size)
+{
+    COND_CHECK((IS_NULL(src)), NULL);
+    void *clone = allocEdgeArena(arena, size);
+    COND_CHECK((IS_NULL(clone)), NULL);
+    memcpy(clone, src, size);
+    return clone;
+}
@@ -0,0 +1,113 @@
+/******************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ *
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************/
+
+/**
+ * @file edge_arena.h
+ * @brief This file contains a bump allocator which places many small objects in one block.
+ */
+
+#ifndef EDGE_ARENA_H
+#define EDGE_ARENA_H
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Alignment of every allocation in the arena.
+ */
+#define EDGE_ARENA_ALIGNMENT (8)
+
+/**
+ * @brief Structure which represents a single memory block handed out front to back.
+ */
+typedef struct EdgeArena
+{
+    /** Start of the block.*/
+    uint8_t *base;
+
+    /** Size of the block in bytes.*/
+    size_t size;
+
+    /** Number of bytes handed out so far.*/
+    size_t used;
+
+    /** Set when an allocation did not fit.*/
+    bool exhausted;
+} EdgeArena;
+
+/**
+ * @brief Get the number of arena bytes taken by an allocation.
+ * @param[in]  size Requested size in bytes.
+ * @return size rounded up to EDGE_ARENA_ALIGNMENT
+ */
+size_t getEdgeArenaSize(size_t size);
+
+/**
+ * @brief Get the number of arena bytes taken by a copy of the string.
+ * @param[in]  str String to be copied, can be NULL.
+ * @return rounded size including the terminator, 0 for NULL
+ */
+size_t getEdgeArenaStringSize(const char *str);
+
+/**
+ * @brief Allocates the zero filled block of the arena.
+ * @param[out] arena Arena to be initialized.
+ * @param[in]  size Total size in bytes, sum of getEdgeArenaSize() of all allocations.
+ * @return @c true on success, otherwise @c false
+ * @remarks The block is released with EdgeFree(arena->base).
+ */
+bool initEdgeArena(EdgeArena *arena, size_t size);
+
+/**
+ * @brief Takes zero filled memory from the arena.
+ * @param[in]  arena Arena handle.
+ * @param[in]  size Size in bytes.
+ * @return memory on success, NULL if the arena is exhausted or size is 0
+ * @remarks Exhaustion also sets arena->exhausted, so a sequence of copies can be checked once.
+ */
+void *allocEdgeArena(EdgeArena *arena, size_t size);
+
+/**
+ * @brief Copies the string into the arena.
+ * @param[in]  arena Arena handle.
+ * @param[in]  str String to be copied.
+ * @return copy on success, NULL if str is NULL or the arena is exhausted
+ */
+char *cloneStringInArena(EdgeArena *arena, const char *str);
+
+/**
+ * @brief Copies the data into the arena.
+ * @param[in]  arena Arena handle.
+ * @param[in]  src Data to be copied.
+ * @param[in]  size Size of the data in bytes.
+ * @return copy on success, NULL if src is NULL or the arena is exhausted
+ */
+void *cloneDataInArena(EdgeArena *arena, const void *src, size_t size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif      // EDGE_ARENA_H
@@ -0,0 +1,329 @@
+/******************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ *
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************/
+
+#include "edge_bulk_convert.h"
+#include "opcua_common.h"
+#include "edge_utils.h"
+#include "edge_logger.h"
+
+#include <math.h>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#define EDGE_BULK_SSE2
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define EDGE_BULK_NEON
+#endif
+
+#define TAG "edge_bulk_convert"
+
+/* Scalar conversion of one value, also used for the elements after the last full vector */
+static inline int16_t floatToInt16(float value)
+{
+    if (isnan(value) || value <= (float) INT16_MIN)
+    {
+        return INT16_MIN;
+    }
+    if (value >= (float) INT16_MAX)
+    {
+        return INT16_MAX;
+    }
+    return (int16_t) lrintf(value);
+}
+
+void edgeInt16ToFloat(const int16_t *src, float *dst, size_t count, float scale, float offset)
+{
+    VERIFY_NON_NULL_NR_MSG(src, "NULL src in edgeInt16ToFloat\n");
+    VERIFY_NON_NULL_NR_MSG(dst, "NULL dst in edgeInt16ToFloat\n");
+    size_t i = 0;
+#if defined(EDGE_BULK_SSE2)
+    const __m128 vScale = _mm_set1_ps(scale), vOffset = _mm_set1_ps(offset);
+    for (; i + 8 <= count; i += 8)
+    {
+        __m128i v = _mm_loadu_si128((const __m128i *) (src + i));
+        /* Each sample lands in the upper half of a 32-bit lane, the shift extends its sign */
+        __m128i lo = _mm_srai_epi32(_mm_unpacklo_epi16(v, v), 16);
+        __m128i hi = _mm_srai_epi32(_mm_unpackhi_epi16(v, v), 16);
+        _mm_storeu_ps(dst + i, _mm_add_ps(_mm_mul_ps(_mm_cvtepi32_ps(lo), vScale), vOffset));
+        _mm_storeu_ps(dst + i + 4, _mm_add_ps(_mm_mul_ps(_mm_cvtepi32_ps(hi), vScale), vOffset));
+    }
+#elif defined(EDGE_BULK_NEON)
+    const float32x4_t vScale = vdupq_n_f32(scale), vOffset = vdupq_n_f32(offset);
+    for (; i + 8 <= count; i += 8)
+    {
+        int16x8_t v = vld1q_s16(src + i);
+        float32x4_t lo = vcvtq_f32_s32(vmovl_s16(vget_low_s16(v)));
+        float32x4_t hi = vcvtq_f32_s32(vmovl_s16(vget_high_s16(v)));
+        vst1q_f32(dst + i, vaddq_f32(vmulq_f32(lo, vScale), vOffset));
+        vst1q_f32(dst + i + 4, vaddq_f32(vmulq_f32(hi, vScale), vOffset));
+    }
+#endif
+    for (; i < count; i++)
+    {
+        dst[i] = (float) src[i] * scale + offset;
+    }
+}
+
+void edgeUInt16ToFloat(const uint16_t *src, float *dst, size_t count, float scale, float offset)
+{
+    VERIFY_NON_NULL_NR_MSG(src, "NULL src in edgeUInt16ToFloat\n");
+    VERIFY_NON_NULL_NR_MSG(dst, "NULL dst in edgeUInt16ToFloat\n");
+    size_t i = 0;
+#if defined(EDGE_BULK_SSE2)
+    const __m128 vScale = _mm_set1_ps(scale), vOffset = _mm_set1_ps(offset);
+    const __m128i zero = _mm_setzero_si128();
+    for (; i + 8 <= count; i += 8)
+    {
+        __m128i v = _mm_loadu_si128((const __m128i *) (src + i));
+        __m128i lo = _mm_unpacklo_epi16(v, zero);
+        __m128i hi = _mm_unpackhi_epi16(v, zero);
+        _mm_storeu_ps(dst + i, _mm_add_ps(_mm_mul_ps(_mm_cvtepi32_ps(lo), vScale), vOffset));
+        _mm_storeu_ps(dst + i + 4, _mm_add_ps(_mm_mul_ps(_mm_cvtepi32_ps(hi), vScale), vOffset));
+    }
+#elif defined(EDGE_BULK_NEON)
+    const float32x4_t vScale = vdupq_n_f32(scale), vOffset = vdupq_n_f32(offset);
+    for (; i + 8 <= count; i += 8)
+    {
+        uint16x8_t v = vld1q_u16(src + i);
+        float32x4_t lo = vcvtq_f32_u32(vmovl_u16(vget_low_u16(v)));
+        float32x4_t hi = vcvtq_f32_u32(vmovl_u16(vget_high_u16(v)));
+        vst1q_f32(dst + i, vaddq_f32(vmulq_f32(lo, vScale), vOffset));
+        vst1q_f32(dst + i + 4, vaddq_f32(vmulq_f32(hi, vScale), vOffset));
+    }
+#endif
+    for (; i < count; i++)
+    {
+        dst[i] = (float) src[i] * scale + offset;
+    }
+}
+
+void edgeFloatToInt16(const float *src, int16_t *dst, size_t count, float scale, float offset)
+{
+    VERIFY_NON_NULL_NR_MSG(src, "NULL src in edgeFloatToInt16\n");
+    VERIFY_NON_NULL_NR_MSG(dst, "NULL dst in edgeFloatToInt16\n");
+    size_t i = 0;
+#if defined(EDGE_BULK_SSE2)
+    const __m128 vScale = _mm_set1_ps(scale), vOffset = _mm_set1_ps(offset);
+    const __m128 vMin = _mm_set1_ps((float) INT16_MIN), vMax = _mm_set1_ps((float) INT16_MAX);
+    for (; i + 8 <= count; i += 8)
+    {
+        __m128 lo = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(src + i), vScale), vOffset);
+        __m128 hi = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(src + i + 4), vScale), vOffset);
+        /* maxps returns its second operand for NaN, so NaN is clamped to INT16_MIN as well */
+        lo = _mm_min_ps(_mm_max_ps(lo, vMin), vMax);
+        hi = _mm_min_ps(_mm_max_ps(hi, vMin), vMax);
+        /* cvtps rounds to nearest like lrintf() in the default rounding mode */
+        __m128i packed = _mm_packs_epi32(_mm_cvtps_epi32(lo), _mm_cvtps_epi32(hi));
+        _mm_storeu_si128((__m128i *) (dst + i), packed);
+    }
+#endif
+    /* NEON before ARMv8 only converts by truncation, so the scalar loop serves ARM */
+    for (; i < count; i++)
+    {
+        dst[i] = floatToInt16(src[i] * scale + offset);
+    }
+}
+
+void edgeScaleFloat(const float *src, float *dst, size_t count, float scale, float offset)
+{
+    VERIFY_NON_NULL_NR_MSG(src, "NULL src in edgeScaleFloat\n");
+    VERIFY_NON_NULL_NR_MSG(dst, "NULL dst in edgeScaleFloat\n");
+    size_t i = 0;
+#if defined(EDGE_BULK_SSE2)
+    const __m128 vScale = _mm_set1_ps(scale), vOffset = _mm_set1_ps(offset);
+    for (; i + 4 <= count; i += 4)
+    {
+        _mm_storeu_ps(dst + i, _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(src + i), vScale), vOffset));
+    }
+#elif defined(EDGE_BULK_NEON)
+    const float32x4_t vScale = vdupq_n_f32(scale), vOffset = vdupq_n_f32(offset);
+    for (; i + 4 <= count; i += 4)
+    {
+        vst1q_f32(dst + i, vaddq_f32(vmulq_f32(vld1q_f32(src + i), vScale), vOffset));
+    }
+#endif
+    for (; i < count; i++)
+    {
+        dst[i] = src[i] * scale + offset;
+    }
+}
+
+void edgeScaleDouble(const double *src, double *dst, size_t count, double scale, double offset)
+{
+    VERIFY_NON_NULL_NR_MSG(src, "NULL src in edgeScaleDouble\n");
+    VERIFY_NON_NULL_NR_MSG(dst, "NULL dst in edgeScaleDouble\n");
+    size_t i = 0;
+#if defined(EDGE_BULK_SSE2)
+    const __m128d vScale = _mm_set1_pd(scale), vOffset = _mm_set1_pd(offset);
+    for (; i + 2 <= count; i += 2)
+    {
+        _mm_storeu_pd(dst + i, _mm_add_pd(_mm_mul_pd(_mm_loadu_pd(src + i), vScale), vOffset));
+    }
+#endif
+    for (; i < count; i++)
+    {
+        dst[i] = src[i] * scale + offset;
+    }
+}
+
+#if defined(EDGE_BULK_SSE2)
+/* Swaps the two bytes of each 16-bit lane */
+static inline __m128i swapBytesInWords(__m128i v)
+{
+    return _mm_or_si128(_mm_slli_epi16(v, 8), _mm_srli_epi16(v, 8));
+}
+#endif
+
+void edgeSwapBytes16(void *data, size_t count)
+{
+    VERIFY_NON_NULL_NR_MSG(data, "NULL data in edgeSwapBytes16\n");
+    uint16_t *values = (uint16_t *) data;
+    size_t i = 0;
+#if defined(EDGE_BULK_SSE2)
+    for (; i + 8 <= count; i += 8)
+    {
+        __m128i v = _mm_loadu_si128((const __m128i *) (values + i));
+        _mm_storeu_si128((__m128i *) (values + i), swapBytesInWords(v));
+    }
+#elif defined(EDGE_BULK_NEON)
+    for (; i + 8 <= count; i += 8)
+    {
+        uint8x16_t v = vld1q_u8((const uint8_t *) (values + i));
+        vst1q_u8((uint8_t *) (values + i), vrev16q_u8(v));
+    }
+#endif
+    for (; i < count; i++)
+    {
+        values[i] = (uint16_t) ((values[i] << 8) | (values[i] >> 8));
+    }
+}
+
+void edgeSwapBytes32(void *data, size_t count)
+{
+    VERIFY_NON_NULL_NR_MSG(data, "NULL data in edgeSwapBytes32\n");
+    uint32_t *values = (uint32_t *) data;
+    size_t i = 0;
+#if defined(EDGE_BULK_SSE2)
+    for (; i + 4 <= count; i += 4)
+    {
+        __m128i v = _mm_loadu_si128((const __m128i *) (values + i));
+        /* Swap the 16-bit halves of each element, then the bytes of each half */
+        v = _mm_shufflehi_epi16(_mm_shufflelo_epi16(v, 0xB1), 0xB1);
+        _mm_storeu_si128((__m128i *) (values + i), swapBytesInWords(v));
+    }
+#elif defined(EDGE_BULK_NEON)
+    for (; i + 4 <= count; i += 4)
+    {
+        uint8x16_t v = vld1q_u8((const uint8_t *) (values + i));
+        vst1q_u8((uint8_t *) (values + i), vrev32q_u8(v));
+    }
+#endif
+    for (; i < count; i++)
+    {
+        uint32_t v = values[i];
+        values[i] = (v << 24) | ((v << 8) & 0x00FF0000u) | ((v >> 8) & 0x0000FF00u) | (v >> 24);
+    }
+}
+
+void edgeSwapBytes64(void *data, size_t count)
+{
+    VERIFY_NON_NULL_NR_MSG(data, "NULL data in edgeSwapBytes64\n");
+    uint64_t *values = (uint64_t *) data;
+    size_t i = 0;
+#if defined(EDGE_BULK_SSE2)
+    for (; i + 2 <= count; i += 2)
+    {
+        __m128i v = _mm_loadu_si128((const __m128i *) (values + i));
+        /* Reverse the four 16-bit quarters of each element, then the bytes of each quarter */
+        v = _mm_shufflehi_epi16(_mm_shufflelo_epi16(v, 0x1B), 0x1B);
+        _mm_storeu_si128((__m128i *) (values + i), swapBytesInWords(v));
+    }
+#elif defined(EDGE_BULK_NEON)
+    for (; i + 2 <= count; i += 2)
+    {
+        uint8x16_t v = vld1q_u8((const uint8_t *) (values + i));
+        vst1q_u8((uint8_t *) (values + i), vrev64q_u8(v));
+    }
+#endif
+    for (; i < count; i++)
+    {
+        uint64_t v = values[i];
+        uint32_t high = (uint32_t) (v >> 32), low = (uint32_t) v;
+        edgeSwapBytes32(&high, 1);
+        edgeSwapBytes32(&low, 1);
+        values[i] = ((uint64_t) low << 32) | high;
+    }
+}
+
+bool edgeConvertArrayToFloat(const void *src, int type, float *dst, size_t count, float scale,
+        float offset)
+{
+    VERIFY_NON_NULL_MSG(src, "NULL src in edgeConvertArrayToFloat\n", false);
+    VERIFY_NON_NULL_MSG(dst, "NULL dst in edgeConvertArrayToFloat\n", false);
+    size_t i = 0;
+    switch (type)
+    {
+        case EDGE_NODEID_INT16:
+            edgeInt16ToFloat((const int16_t *) src, dst, count, scale, offset);
+            break;
+        case EDGE_NODEID_UINT16:
+            edgeUInt16ToFloat((const uint16_t *) src, dst, count, scale, offset);
+            break;
+        case EDGE_NODEID_FLOAT:
+            edgeScaleFloat((const float *) src, dst, count, scale, offset);
+            break;
+        /* The plain loops below are left to the auto-vectorizer of the compiler */
+        case EDGE_NODEID_SBYTE:
+            for (; i < count; i++)
+            {
+                dst[i] = (float) ((const int8_t *) src)[i] * scale + offset;
+            }
+            break;
+        case EDGE_NODEID_BYTE:
+            for (; i < count; i++)
+            {
+                dst[i] = (float) ((const uint8_t *) src)[i] * scale + offset;
+            }
+            break;
+        case EDGE_NODEID_INT32:
+            for (; i < count; i++)
+            {
+                dst[i] = (float) ((const int32_t *) src)[i] * scale + offset;
+            }
+            break;
+        case EDGE_NODEID_UINT32:
+            for (; i < count; i++)
+            {
+                dst[i] = (float) ((const uint32_t *) src)[i] * scale + offset;
+            }
+            break;
+        case EDGE_NODEID_DOUBLE:
+            for (; i < count; i++)
+            {
+                dst[i] = (float) (((const double *) src)[i] * scale + offset);
+            }
+            break;
+        default:
+            EDGE_LOG_V(TAG, "Type %d can not be converted to float.\n", type);
+            return false;
+    }
+    return true;
+}
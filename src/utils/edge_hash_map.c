@@ -0,0 +1,252 @@
+/******************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ *
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************/
+
+#include "edge_hash_map.h"
+#include "edge_malloc.h"
+#include "edge_utils.h"
+
+#include <stdint.h>
+#include <string.h>
+
+#define TAG "edge_hash_map"
+
+/* Slot of the table, an empty slot has a NULL key */
+typedef struct EdgeHashMapSlot
+{
+    keyValue key;
+    keyValue value;
+    uint32_t hash;
+} EdgeHashMapSlot;
+
+struct EdgeHashMap
+{
+    EdgeHashKeyMode mode;
+    /* Power of two */
+    size_t capacity;
+    size_t size;
+    EdgeHashMapSlot *slots;
+};
+
+static uint32_t hashPointer(const void *ptr)
+{
+    uint64_t x = (uint64_t) (uintptr_t) ptr;
+    x ^= x >> 33;
+    x *= 0xff51afd7ed558ccdULL;
+    x ^= x >> 33;
+    return (uint32_t) x;
+}
+
+/* FNV-1a, stops at length or at the terminating NUL */
+static uint32_t hashString(const char *str, size_t length)
+{
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < length && str[i]; i++)
+    {
+        hash ^= (unsigned char) str[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+static uint32_t hashKey(const EdgeHashMap *map, keyValue key)
+{
+    if (EDGE_HASH_STRING_KEY == map->mode)
+    {
+        return hashString((const char *) key, SIZE_MAX);
+    }
+    return hashPointer(key);
+}
+
+/* Returns the slot holding the key, or the empty slot ending its probe sequence */
+static EdgeHashMapSlot *findSlot(const EdgeHashMap *map, const char *key, size_t length,
+        uint32_t hash)
+{
+    size_t mask = map->capacity - 1;
+    for (size_t i = hash & mask; ; i = (i + 1) & mask)
+    {
+        EdgeHashMapSlot *slot = &map->slots[i];
+        if (NULL == slot->key)
+        {
+            return slot;
+        }
+        if (EDGE_HASH_POINTER_KEY == map->mode)
+        {
+            if (slot->key == key)
+            {
+                return slot;
+            }
+        }
+        else if (slot->hash == hash && 0 == strncmp((const char *) slot->key, key, length)
+                && (SIZE_MAX == length || '\0' == ((const char *) slot->key)[length]))
+        {
+            return slot;
+        }
+    }
+}
+
+static bool growMap(EdgeHashMap *map)
+{
+    size_t capacity = map->capacity * 2;
+    EdgeHashMapSlot *slots = (EdgeHashMapSlot *) EdgeCalloc(capacity, sizeof(EdgeHashMapSlot));
+    VERIFY_NON_NULL_MSG(slots, "EdgeCalloc FAILED for hash map slots\n", false);
+
+    for (size_t i = 0; i < map->capacity; i++)
+    {
+        EdgeHashMapSlot *slot = &map->slots[i];
+        if (slot->key)
+        {
+            size_t j = slot->hash & (capacity - 1);
+            while (slots[j].key)
+            {
+                j = (j + 1) & (capacity - 1);
+            }
+            slots[j] = *slot;
+        }
+    }
+    EdgeFree(map->slots);
+    map->slots = slots;
+    map->capacity = capacity;
+    return true;
+}
+
+EdgeHashMap *createEdgeHashMap(EdgeHashKeyMode mode)
+{
+    EdgeHashMap *map = (EdgeHashMap *) EdgeCalloc(1, sizeof(EdgeHashMap));
+    VERIFY_NON_NULL_MSG(map, "EdgeCalloc FAILED for create hash map\n", NULL);
+    map->slots = (EdgeHashMapSlot *) EdgeCalloc(EDGE_HASH_MAP_INITIAL_CAPACITY,
+            sizeof(EdgeHashMapSlot));
+    if (IS_NULL(map->slots))
+    {
+        EDGE_LOG(TAG, "EdgeCalloc FAILED for hash map slots\n");
+        EdgeFree(map);
+        return NULL;
+    }
+    map->mode = mode;
+    map->capacity = EDGE_HASH_MAP_INITIAL_CAPACITY;
+    return map;
+}
+
+bool insertEdgeHashMapElement(EdgeHashMap *map, keyValue key, keyValue value)
+{
+    VERIFY_NON_NULL_MSG(map, "NULL map param in insertEdgeHashMapElement\n", false);
+    VERIFY_NON_NULL_MSG(key, "NULL key param in insertEdgeHashMapElement\n", false);
+
+    // Keep the load factor at most 3/4 so that probe sequences stay short.
+    if ((map->size + 1) * 4 > map->capacity * 3)
+    {
+        COND_CHECK((!growMap(map)), false);
+    }
+
+    uint32_t hash = hashKey(map, key);
+    EdgeHashMapSlot *slot = findSlot(map, (const char *) key, SIZE_MAX, hash);
+    COND_CHECK_MSG((NULL != slot->key), "key is already present in the hash map\n", false);
+    slot->key = key;
+    slot->value = value;
+    slot->hash = hash;
+    map->size++;
+    return true;
+}
+
+keyValue getEdgeHashMapElement(const EdgeHashMap *map, keyValue key)
+{
+    COND_CHECK((IS_NULL(map) || IS_NULL(key)), NULL);
+    EdgeHashMapSlot *slot = findSlot(map, (const char *) key, SIZE_MAX, hashKey(map, key));
+    return slot->key ? slot->value : NULL;
+}
+
+keyValue getEdgeHashMapElementByString(const EdgeHashMap *map, const char *data, size_t length)
+{
+    COND_CHECK((IS_NULL(map) || IS_NULL(data)), NULL);
+    COND_CHECK((EDGE_HASH_STRING_KEY != map->mode), NULL);
+    COND_CHECK((memchr(data, '\0', length) != NULL), NULL);
+    EdgeHashMapSlot *slot = findSlot(map, data, length, hashString(data, length));
+    return slot->key ? slot->value : NULL;
+}
+
+keyValue removeEdgeHashMapElement(EdgeHashMap *map, keyValue key, keyValue *storedKey)
+{
+    if (storedKey)
+    {
+        *storedKey = NULL;
+    }
+    COND_CHECK((IS_NULL(map) || IS_NULL(key)), NULL);
+    EdgeHashMapSlot *slot = findSlot(map, (const char *) key, SIZE_MAX, hashKey(map, key));
+    COND_CHECK((NULL == slot->key), NULL);
+
+    keyValue value = slot->value;
+    if (storedKey)
+    {
+        *storedKey = slot->key;
+    }
+
+    // Shift the following entries back instead of leaving a tombstone.
+    size_t mask = map->capacity - 1;
+    size_t hole = (size_t) (slot - map->slots);
+    for (size_t i = (hole + 1) & mask; map->slots[i].key; i = (i + 1) & mask)
+    {
+        size_t home = map->slots[i].hash & mask;
+        // Move the entry if its home slot is not cyclically within (hole, i].
+        if (((i - home) & mask) >= ((i - hole) & mask))
+        {
+            map->slots[hole] = map->slots[i];
+            hole = i;
+        }
+    }
+    map->slots[hole].key = NULL;
+    map->slots[hole].value = NULL;
+    map->size--;
+    return value;
+}
+
+size_t getEdgeHashMapSize(const EdgeHashMap *map)
+{
+    COND_CHECK((IS_NULL(map)), 0);
+    return map->size;
+}
+
+bool getNextEdgeHashMapElement(const EdgeHashMap *map, size_t *cursor, keyValue *key,
+        keyValue *value)
+{
+    COND_CHECK((IS_NULL(map) || IS_NULL(cursor)), false);
+    while (*cursor < map->capacity)
+    {
+        EdgeHashMapSlot *slot = &map->slots[(*cursor)++];
+        if (slot->key)
+        {
+            if (key)
+            {
+                *key = slot->key;
+            }
+            if (value)
+            {
+                *value = slot->value;
+            }
+            return true;
+        }
+    }
+    return false;
+}
+
+void deleteEdgeHashMap(EdgeHashMap *map)
+{
+    VERIFY_NON_NULL_NR_MSG(map, "NULL map param in deleteEdgeHashMap\n");
+    EdgeFree(map->slots);
+    EdgeFree(map);
+}
@@ -0,0 +1,131 @@
+/******************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ *
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************/
+
+/**
+ * @file edge_hash_map.h
+ * @brief This file contains APIs for an open-addressing hash map of generic key-value pairs.
+ */
+
+#ifndef EDGE_HASH_MAP_H_
+#define EDGE_HASH_MAP_H_
+
+#include "edge_map.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/**
+ * @brief Initial number of slots of a hash map, it doubles when it is 3/4 full.
+ */
+#define EDGE_HASH_MAP_INITIAL_CAPACITY (16)
+
+/**
+ * @brief How keys of a hash map are compared.
+ */
+typedef enum
+{
+    /** Keys are compared by address.*/
+    EDGE_HASH_POINTER_KEY = 0,
+    /** Keys are NUL-terminated strings compared by content.*/
+    EDGE_HASH_STRING_KEY = 1
+} EdgeHashKeyMode;
+
+/**
+ * @brief Hash map of generic key-value pairs, keys and values are not owned by the map.
+ */
+typedef struct EdgeHashMap EdgeHashMap;
+
+/**
+ * @brief Creates an empty hash map.
+ * @param[in]  mode Key comparison mode.
+ * @return a pointer to the created map, otherwise a null pointer if the memory is insufficient.
+ */
+EdgeHashMap *createEdgeHashMap(EdgeHashKeyMode mode);
+
+/**
+ * @brief Inserts a key-value pair into the map.
+ * @param[in]  map Pointer to an EdgeHashMap created using createEdgeHashMap().
+ * @param[in]  key Generic key, must not be NULL. It must stay valid while it is in the map.
+ * @param[in]  value Generic value.
+ * @return @c true on success, @c false if the key is already present or memory is insufficient.
+ */
+bool insertEdgeHashMapElement(EdgeHashMap *map, keyValue key, keyValue value);
+
+/**
+ * @brief Gets the value of the given key from the map.
+ * @param[in]  map Pointer to an EdgeHashMap created using createEdgeHashMap().
+ * @param[in]  key Generic key.
+ * @return Value of given key on success, otherwise null.
+ */
+keyValue getEdgeHashMapElement(const EdgeHashMap *map, keyValue key);
+
+/**
+ * @brief Gets the value of a string key which is not NUL-terminated, e.g. a UA_String.
+ * @param[in]  map Pointer to an EdgeHashMap created with EDGE_HASH_STRING_KEY.
+ * @param[in]  data Characters of the key.
+ * @param[in]  length Number of characters.
+ * @return Value of given key on success, otherwise null.
+ */
+keyValue getEdgeHashMapElementByString(const EdgeHashMap *map, const char *data, size_t length);
+
+/**
+ * @brief Removes the given key from the map.
+ * @param[in]  map Pointer to an EdgeHashMap created using createEdgeHashMap().
+ * @param[in]  key Generic key.
+ * @param[out] storedKey Receives the key stored in the map so that it can be freed. May be NULL.
+ * @return Value of the removed key, otherwise null if the key is not present.
+ */
+keyValue removeEdgeHashMapElement(EdgeHashMap *map, keyValue key, keyValue *storedKey);
+
+/**
+ * @brief Gets the number of key-value pairs in the map.
+ * @param[in]  map Pointer to an EdgeHashMap created using createEdgeHashMap().
+ * @return number of elements.
+ */
+size_t getEdgeHashMapSize(const EdgeHashMap *map);
+
+/**
+ * @brief Iterates over the key-value pairs of the map in no particular order.
+ * @param[in]  map Pointer to an EdgeHashMap created using createEdgeHashMap().
+ * @param[in,out]  cursor Iteration position, 0 to start.
+ * @param[out] key Key of the element. May be NULL.
+ * @param[out] value Value of the element. May be NULL.
+ * @return @c true if an element was returned, @c false at the end of the map.
+ * @remarks The map must not be modified during the iteration.
+ */
+bool getNextEdgeHashMapElement(const EdgeHashMap *map, size_t *cursor, keyValue *key,
+        keyValue *value);
+
+/**
+ * @brief Frees the map. Keys and values are not freed.
+ * @param[in]  map Pointer to an EdgeHashMap created using createEdgeHashMap().
+ */
+void deleteEdgeHashMap(EdgeHashMap *map);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* EDGE_HASH_MAP_H_ */
@@ -0,0 +1,199 @@
+/******************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ *
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************/
+
+#include "edge_intern.h"
+#include "edge_logger.h"
+#include "edge_malloc.h"
+#include "edge_utils.h"
+
+#include <stdint.h>
+#include <string.h>
+
+#ifndef _WIN32
+#include <pthread.h>
+#else
+#include "pthread.h"
+#endif
+
+#if defined(_WIN32) && !defined(__GNUC__)
+#include <windows.h>
+#define REF_INCREMENT(ptr) InterlockedIncrement((LONG volatile *) (ptr))
+#define REF_DECREMENT(ptr) InterlockedDecrement((LONG volatile *) (ptr))
+#define COUNT_ADD(ptr, val) InterlockedExchangeAdd((LONG volatile *) (ptr), (val))
+#define COUNT_LOAD(ptr) InterlockedCompareExchange((LONG volatile *) (ptr), 0, 0)
+#else
+#define REF_INCREMENT(ptr) __atomic_add_fetch((ptr), 1, __ATOMIC_RELAXED)
+#define REF_DECREMENT(ptr) __atomic_sub_fetch((ptr), 1, __ATOMIC_ACQ_REL)
+#define COUNT_ADD(ptr, val) __atomic_add_fetch((ptr), (val), __ATOMIC_RELAXED)
+#define COUNT_LOAD(ptr) __atomic_load_n((ptr), __ATOMIC_RELAXED)
+#endif
+
+#define TAG "edge_intern"
+
+/* Interned string, the handle given out points at str */
+typedef struct EdgeInternEntry
+{
+    struct EdgeInternEntry *next;
+    uint32_t hash;
+    int refCount;
+    char str[1];
+} EdgeInternEntry;
+
+static EdgeInternEntry *g_buckets[EDGE_INTERN_BUCKETS];
+static pthread_mutex_t g_locks[EDGE_INTERN_LOCKS];
+static pthread_once_t g_locksOnce = PTHREAD_ONCE_INIT;
+static int g_stringCount = 0;
+
+static void initLocks(void)
+{
+    for (int i = 0; i < EDGE_INTERN_LOCKS; i++)
+    {
+        pthread_mutex_init(&g_locks[i], NULL);
+    }
+}
+
+/* FNV-1a */
+static uint32_t hashString(const char *str)
+{
+    uint32_t hash = 2166136261u;
+    for (const unsigned char *c = (const unsigned char *) str; *c; c++)
+    {
+        hash ^= *c;
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+static pthread_mutex_t *getLock(uint32_t hash)
+{
+    pthread_once(&g_locksOnce, initLocks);
+    return &g_locks[(hash % EDGE_INTERN_BUCKETS) % EDGE_INTERN_LOCKS];
+}
+
+static EdgeInternEntry *getEntry(const char *interned)
+{
+    return (EdgeInternEntry *) (interned - offsetof(EdgeInternEntry, str));
+}
+
+/* Called with the lock of the bucket held */
+static EdgeInternEntry *findEntry(const char *str, uint32_t hash)
+{
+    EdgeInternEntry *entry = g_buckets[hash % EDGE_INTERN_BUCKETS];
+    while (entry)
+    {
+        if (entry->hash == hash && 0 == strcmp(entry->str, str))
+        {
+            return entry;
+        }
+        entry = entry->next;
+    }
+    return NULL;
+}
+
+const char *internEdgeString(const char *str)
+{
+    VERIFY_NON_NULL_MSG(str, "NULL str param in internEdgeString\n", NULL);
+    uint32_t hash = hashString(str);
+    pthread_mutex_t *lock = getLock(hash);
+
+    pthread_mutex_lock(lock);
+    EdgeInternEntry *entry = findEntry(str, hash);
+    if (entry)
+    {
+        REF_INCREMENT(&entry->refCount);
+    }
+    else
+    {
+        size_t len = strlen(str);
+        entry = (EdgeInternEntry *) EdgeMalloc(sizeof(EdgeInternEntry) + len);
+        if (entry)
+        {
+            memcpy(entry->str, str, len + 1);
+            entry->hash = hash;
+            entry->refCount = 1;
+            entry->next = g_buckets[hash % EDGE_INTERN_BUCKETS];
+            g_buckets[hash % EDGE_INTERN_BUCKETS] = entry;
+            COUNT_ADD(&g_stringCount, 1);
+        }
+    }
+    pthread_mutex_unlock(lock);
+
+    VERIFY_NON_NULL_MSG(entry, "EdgeMalloc FAILED for interned string\n", NULL);
+    return entry->str;
+}
+
+const char *lookupEdgeString(const char *str)
+{
+    VERIFY_NON_NULL_MSG(str, "NULL str param in lookupEdgeString\n", NULL);
+    uint32_t hash = hashString(str);
+    pthread_mutex_t *lock = getLock(hash);
+
+    pthread_mutex_lock(lock);
+    EdgeInternEntry *entry = findEntry(str, hash);
+    if (entry)
+    {
+        REF_INCREMENT(&entry->refCount);
+    }
+    pthread_mutex_unlock(lock);
+    return entry ? entry->str : NULL;
+}
+
+const char *retainEdgeString(const char *interned)
+{
+    VERIFY_NON_NULL_MSG(interned, "NULL interned param in retainEdgeString\n", NULL);
+    // The caller holds a reference, so the count cannot drop to zero meanwhile.
+    REF_INCREMENT(&getEntry(interned)->refCount);
+    return interned;
+}
+
+void releaseEdgeString(const char *interned)
+{
+    VERIFY_NON_NULL_NR_MSG(interned, "NULL interned param in releaseEdgeString\n");
+    EdgeInternEntry *entry = getEntry(interned);
+    pthread_mutex_t *lock = getLock(entry->hash);
+
+    // Decrement under the lock so that internEdgeString() never revives a freed entry.
+    pthread_mutex_lock(lock);
+    if (0 != REF_DECREMENT(&entry->refCount))
+    {
+        entry = NULL;
+    }
+    else
+    {
+        EdgeInternEntry **link = &g_buckets[entry->hash % EDGE_INTERN_BUCKETS];
+        while (*link != entry)
+        {
+            link = &(*link)->next;
+        }
+        *link = entry->next;
+        COUNT_ADD(&g_stringCount, -1);
+    }
+    pthread_mutex_unlock(lock);
+
+    if (entry)
+    {
+        EdgeFree(entry);
+    }
+}
+
+size_t getEdgeStringCount(void)
+{
+    return (size_t) COUNT_LOAD(&g_stringCount);
+}
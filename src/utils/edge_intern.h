@@ -0,0 +1,85 @@
+/******************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ *
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************/
+
+/**
+ * @file edge_intern.h
+ * @brief This file contains the process-wide table of interned strings such as value aliases.
+ */
+
+#ifndef EDGE_INTERN_H
+#define EDGE_INTERN_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Number of hash buckets of the intern table.
+ */
+#define EDGE_INTERN_BUCKETS (8192)
+
+/**
+ * @brief Number of locks guarding the buckets, each lock covers a stripe of buckets.
+ */
+#define EDGE_INTERN_LOCKS (64)
+
+/**
+ * @brief Gets the interned copy of a string and takes a reference to it.
+ * @param[in]  str String to be interned.
+ * @return interned string on success, otherwise NULL
+ * @remarks Equal strings share one interned copy, so interned strings can be compared
+ *          by pointer. The copy is immutable and released by releaseEdgeString().
+ */
+const char *internEdgeString(const char *str);
+
+/**
+ * @brief Finds the interned copy of a string without adding it.
+ * @param[in]  str String to be looked up.
+ * @return interned string with one more reference, NULL if the string is not interned
+ */
+const char *lookupEdgeString(const char *str);
+
+/**
+ * @brief Takes one more reference to an interned string.
+ * @param[in]  interned String returned by internEdgeString() or lookupEdgeString().
+ * @return interned
+ */
+const char *retainEdgeString(const char *interned);
+
+/**
+ * @brief Drops one reference of an interned string, the last one frees it.
+ * @param[in]  interned String returned by internEdgeString() or lookupEdgeString().
+ */
+void releaseEdgeString(const char *interned);
+
+/**
+ * @brief Gets the number of distinct interned strings.
+ * @return number of strings in the table
+ */
+size_t getEdgeStringCount(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif      // EDGE_INTERN_H
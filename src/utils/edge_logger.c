@@ -0,0 +1,307 @@
+/******************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ *
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************/
+
+#include "edge_logger.h"
+#include "edge_utils.h"
+#include "octhread.h"
+#include "edge_thread_config.h"
+
+#include <stdarg.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifndef _WIN32
+#include <pthread.h>
+#else
+#include "pthread.h"
+#endif
+
+#define TAG "edge_logger"
+
+/* Size of the text of a record, longer records are truncated */
+#define EDGE_LOG_RECORD_SIZE (256)
+/* Records buffered per thread, a power of 2 */
+#define EDGE_LOG_RING_RECORDS (256)
+/* Time between two flushes when the buffers fill slowly */
+#define EDGE_LOG_FLUSH_INTERVAL_US (100 * 1000)
+
+#define LOAD_ACQUIRE(ptr) __atomic_load_n((ptr), __ATOMIC_ACQUIRE)
+#define STORE_RELEASE(ptr, val) __atomic_store_n((ptr), (val), __ATOMIC_RELEASE)
+#define COUNTER_ADD(ptr, val) __atomic_add_fetch((ptr), (val), __ATOMIC_RELAXED)
+#define COUNTER_EXCHANGE(ptr, val) __atomic_exchange_n((ptr), (val), __ATOMIC_RELAXED)
+
+typedef struct EdgeLogRecord
+{
+    uint64_t monotonicTime;
+    EdgeLogLevel level;
+    const char *tag;
+    char text[EDGE_LOG_RECORD_SIZE];
+} EdgeLogRecord;
+
+/* Single producer single consumer ring of one thread. The thread advances head, the
+ * flushing thread advances tail. */
+typedef struct EdgeLogRing
+{
+    EdgeLogRecord records[EDGE_LOG_RING_RECORDS];
+    size_t head;
+    size_t tail;
+    /* Set when the thread exits, the ring is freed once it is drained */
+    bool closed;
+    struct EdgeLogRing *next;
+} EdgeLogRing;
+
+#if DEBUG
+int g_edgeLogLevel = EDGE_LOG_LEVEL_DEBUG;
+#else
+int g_edgeLogLevel = EDGE_LOG_LEVEL_NONE;
+#endif
+
+static EDGE_THREAD_LOCAL EdgeLogRing *threadRing = NULL;
+/* Set while the thread runs logger code, octhread logs its failures through the logger */
+static EDGE_THREAD_LOCAL bool insideLogger = false;
+static pthread_key_t ringKey;
+static pthread_once_t loggerOnce = PTHREAD_ONCE_INIT;
+static bool loggerStarted = false;
+
+/* Guards the list of rings */
+static pthread_mutex_t ringMutex = PTHREAD_MUTEX_INITIALIZER;
+static EdgeLogRing *rings = NULL;
+
+/* Held while records are handed to the sink, so there is one consumer per ring */
+static pthread_mutex_t flushMutex = PTHREAD_MUTEX_INITIALIZER;
+static EdgeLogSink logSink = NULL;
+static void *logSinkContext = NULL;
+
+/* Records lost to full rings since the last flush */
+static size_t droppedRecords = 0;
+
+static oc_mutex wakeMutex = NULL;
+static oc_cond wakeCond = NULL;
+
+static void closeRing(void *data)
+{
+    /* Destructors running after this one must not log into the ring anymore */
+    threadRing = NULL;
+    insideLogger = true;
+    STORE_RELEASE(&((EdgeLogRing *) data)->closed, true);
+}
+
+static void writeToStdout(const EdgeLogEntry *entry, void *context)
+{
+    (void) context;
+    printf("[%s] %s\n", entry->tag, entry->message);
+}
+
+static void deliverRecord(EdgeLogSink sink, EdgeLogRecord *record)
+{
+    /* Most messages of the stack end with a newline, the sink adds its own separator */
+    size_t length = strlen(record->text);
+    while (length > 0 && '\n' == record->text[length - 1])
+    {
+        record->text[--length] = '\0';
+    }
+
+    EdgeLogEntry entry;
+    entry.level = record->level;
+    entry.tag = record->tag;
+    entry.message = record->text;
+    entry.monotonicTime = record->monotonicTime;
+    sink(&entry, logSinkContext);
+}
+
+void edgeLogFlush(void)
+{
+    pthread_mutex_lock(&flushMutex);
+    EdgeLogSink sink = IS_NOT_NULL(logSink) ? logSink : writeToStdout;
+
+    pthread_mutex_lock(&ringMutex);
+    EdgeLogRing **link = &rings;
+    while (IS_NOT_NULL(*link))
+    {
+        EdgeLogRing *ring = *link;
+        bool closed = LOAD_ACQUIRE(&ring->closed);
+        size_t head = LOAD_ACQUIRE(&ring->head);
+        for (size_t tail = ring->tail; tail != head; tail++)
+        {
+            deliverRecord(sink, &ring->records[tail % EDGE_LOG_RING_RECORDS]);
+            STORE_RELEASE(&ring->tail, tail + 1);
+        }
+
+        /* The thread of a closed ring logs nothing anymore */
+        if (closed)
+        {
+            *link = ring->next;
+            free(ring);
+        }
+        else
+        {
+            link = &ring->next;
+        }
+    }
+    pthread_mutex_unlock(&ringMutex);
+
+    size_t dropped = COUNTER_EXCHANGE(&droppedRecords, 0);
+    if (dropped > 0)
+    {
+        char text[64];
+        snprintf(text, sizeof(text), "%zu log records dropped", dropped);
+        EdgeLogEntry entry = { EDGE_LOG_LEVEL_WARNING, TAG, text, oc_get_time_us() };
+        sink(&entry, logSinkContext);
+    }
+    if (sink == writeToStdout)
+    {
+        fflush(stdout);
+    }
+    pthread_mutex_unlock(&flushMutex);
+}
+
+static void *flushHandler(void *arg)
+{
+    (void) arg;
+    /* Records of the sink on this thread would only feed the log */
+    insideLogger = true;
+    applyEdgeThreadConfig(EDGE_THREAD_HELPER);
+    for (;;)
+    {
+        oc_mutex_lock(wakeMutex);
+        oc_cond_wait_for(wakeCond, wakeMutex, EDGE_LOG_FLUSH_INTERVAL_US);
+        oc_mutex_unlock(wakeMutex);
+        edgeLogFlush();
+    }
+    return NULL;
+}
+
+static void startLogger(void)
+{
+    wakeMutex = oc_mutex_new();
+    wakeCond = oc_cond_new();
+    if (IS_NULL(wakeMutex) || IS_NULL(wakeCond) || 0 != pthread_key_create(&ringKey, closeRing))
+    {
+        return;
+    }
+
+    /* The log thread lives as long as the process, the remaining records are flushed at exit */
+    oc_thread flushThread = NULL;
+    if (OC_THREAD_SUCCESS != oc_thread_new(&flushThread, flushHandler, NULL))
+    {
+        return;
+    }
+    oc_thread_detach(flushThread);
+    atexit(edgeLogFlush);
+    loggerStarted = true;
+}
+
+static EdgeLogRing *getThreadRing(void)
+{
+    if (IS_NOT_NULL(threadRing))
+    {
+        return threadRing;
+    }
+    insideLogger = true;
+    pthread_once(&loggerOnce, startLogger);
+    insideLogger = false;
+    if (!loggerStarted)
+    {
+        return NULL;
+    }
+
+    EdgeLogRing *ring = (EdgeLogRing *) calloc(1, sizeof(EdgeLogRing));
+    if (IS_NULL(ring))
+    {
+        return NULL;
+    }
+    /* The destructor closes the ring when the thread exits */
+    if (0 != pthread_setspecific(ringKey, ring))
+    {
+        free(ring);
+        return NULL;
+    }
+    pthread_mutex_lock(&ringMutex);
+    ring->next = rings;
+    rings = ring;
+    pthread_mutex_unlock(&ringMutex);
+    threadRing = ring;
+    return ring;
+}
+
+static void wakeFlusher(void)
+{
+    insideLogger = true;
+    oc_mutex_lock(wakeMutex);
+    oc_cond_signal(wakeCond);
+    oc_mutex_unlock(wakeMutex);
+    insideLogger = false;
+}
+
+void edgeLogWrite(EdgeLogLevel level, const char *tag, const char *format, ...)
+{
+    if (insideLogger)
+    {
+        return;
+    }
+    EdgeLogRing *ring = getThreadRing();
+    if (IS_NULL(ring))
+    {
+        COUNTER_ADD(&droppedRecords, 1);
+        return;
+    }
+
+    size_t head = ring->head;
+    size_t pending = head - LOAD_ACQUIRE(&ring->tail);
+    if (pending >= EDGE_LOG_RING_RECORDS)
+    {
+        COUNTER_ADD(&droppedRecords, 1);
+        return;
+    }
+
+    EdgeLogRecord *record = &ring->records[head % EDGE_LOG_RING_RECORDS];
+    record->monotonicTime = oc_get_time_us();
+    record->level = level;
+    record->tag = IS_NOT_NULL(tag) ? tag : "";
+    va_list args;
+    va_start(args, format);
+    if (vsnprintf(record->text, EDGE_LOG_RECORD_SIZE, format, args) < 0)
+    {
+        record->text[0] = '\0';
+    }
+    va_end(args);
+    STORE_RELEASE(&ring->head, head + 1);
+
+    /* The log thread is woken early once, when the ring gets half full */
+    if (pending + 1 == EDGE_LOG_RING_RECORDS / 2)
+    {
+        wakeFlusher();
+    }
+}
+
+void edgeLogSetLevel(EdgeLogLevel level)
+{
+    STORE_RELEASE(&g_edgeLogLevel, (int) level);
+}
+
+void edgeLogSetSink(EdgeLogSink sink, void *context)
+{
+    /* Records buffered so far go to the previous sink */
+    edgeLogFlush();
+    pthread_mutex_lock(&flushMutex);
+    logSink = sink;
+    logSinkContext = context;
+    pthread_mutex_unlock(&flushMutex);
+}
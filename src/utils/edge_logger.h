@@ -21,33 +21,72 @@
 /**
  * @file edge_logger.h
  * @brief This file contains logger related macro definitions.
+ *
+ * Records are formatted into a lock-free ring buffer of the logging thread and handed to the
+ * sink by a log thread, so a record costs a level check when its level is not logged and a
+ * vsnprintf otherwise.
  */
 
 #ifndef EDGE_LOGGER_H_
 #define EDGE_LOGGER_H_
 
 #include <stdio.h>
+#include "opcua_common.h"
 
 #ifdef __cplusplus
 extern "C"
 {
 #endif
 
-#if DEBUG
+#if defined(__GNUC__)
+#define EDGE_LOG_FORMAT(fmt, args) __attribute__((format(printf, fmt, args)))
+#else
+#define EDGE_LOG_FORMAT(fmt, args)
+#endif
 
-/** Log the given tag and a string parameter.*/
-#define EDGE_LOG(tag, param) printf("[%s] %s\n", tag, param)
+/** Highest level which is logged, see edgeLogSetLevel(). */
+extern int g_edgeLogLevel;
 
-/** Log the given tag and a variable number of arguments.*/
-#define EDGE_LOG_V(tag, param, ...) fprintf(stdout, param, __VA_ARGS__)
-#else
+/**
+ * @brief Buffers a record in the log buffer of the calling thread. Use the macros below,
+ *        they skip the formatting of records above the level.
+ * @param[in]  level Level of the record
+ * @param[in]  tag Module of the record, a string literal
+ * @param[in]  format printf format of the record
+ */
+void edgeLogWrite(EdgeLogLevel level, const char *tag, const char *format, ...)
+        EDGE_LOG_FORMAT(3, 4);
 
-/** Log nothing.*/
-#define EDGE_LOG(tag, param)
+/**
+ * @brief Sets the highest level which is logged
+ * @param[in]  level Log level
+ */
+void edgeLogSetLevel(EdgeLogLevel level);
 
-/** Log nothing.*/
-#define EDGE_LOG_V(tag, param, ...)
-#endif
+/**
+ * @brief Sets the destination of the records
+ * @param[in]  sink Callback called on the log thread, NULL for the standard output
+ * @param[in]  context Context of the callback
+ */
+void edgeLogSetSink(EdgeLogSink sink, void *context);
+
+/**
+ * @brief Hands the buffered records of all threads to the sink
+ */
+void edgeLogFlush(void);
+
+/** Whether records of the level are logged.*/
+#define EDGE_LOG_ENABLED(level) ((int) (level) <= g_edgeLogLevel)
+
+/** Log the given tag and a printf format with its arguments at the level.*/
+#define EDGE_LOG_L(level, tag, ...) do { if (EDGE_LOG_ENABLED(level)) { \
+            edgeLogWrite((level), (tag), __VA_ARGS__); } } while (0)
+
+/** Log the given tag and a string parameter.*/
+#define EDGE_LOG(tag, param) EDGE_LOG_L(EDGE_LOG_LEVEL_DEBUG, tag, "%s", param)
+
+/** Log the given tag and a variable number of arguments.*/
+#define EDGE_LOG_V(tag, param, ...) EDGE_LOG_L(EDGE_LOG_LEVEL_DEBUG, tag, param, __VA_ARGS__)
 
 #ifdef __cplusplus
 }
@@ -23,20 +23,359 @@
 
 #include <stdio.h>
 #include <string.h>
+#include <stdint.h>
+
+#ifdef ENABLE_MALLOC_STATS
+#include <pthread.h>
+
+#undef EdgeMalloc
+#undef EdgeCalloc
+#undef EdgeRealloc
+
+#if defined(_WIN32) && !defined(__GNUC__)
+#include <windows.h>
+#ifdef _WIN64
+#define COUNTER_ADD(ptr, val) InterlockedExchangeAdd64((LONGLONG volatile *) (ptr), (LONGLONG) (val))
+#else
+#define COUNTER_ADD(ptr, val) InterlockedExchangeAdd((LONG volatile *) (ptr), (LONG) (val))
+#endif
+#define COUNTER_LOAD(ptr) ((size_t) COUNTER_ADD((ptr), 0))
+#define TAG_COUNT_STORE(ptr, val) InterlockedExchange((LONG volatile *) (ptr), (LONG) (val))
+#define TAG_COUNT_LOAD(ptr) ((size_t) InterlockedCompareExchange((LONG volatile *) (ptr), 0, 0))
+#else
+#define COUNTER_ADD(ptr, val) __atomic_add_fetch((ptr), (val), __ATOMIC_RELAXED)
+#define COUNTER_LOAD(ptr) __atomic_load_n((ptr), __ATOMIC_RELAXED)
+#define TAG_COUNT_STORE(ptr, val) __atomic_store_n((ptr), (val), __ATOMIC_RELEASE)
+#define TAG_COUNT_LOAD(ptr) __atomic_load_n((ptr), __ATOMIC_ACQUIRE)
+#endif
+#endif
 
 #define TAG "edge_malloc"
 
+static EdgeAllocator g_allocator = { malloc, calloc, realloc, free };
+
+#ifdef ENABLE_MALLOC_STATS
+/* Counters of one call-site tag */
+typedef struct EdgeAllocTag
+{
+    const char *tag;
+    size_t liveBytes;
+    size_t liveCount;
+    size_t totalCount;
+} EdgeAllocTag;
+
+/* Size and tag of a live block. They are kept in a table beside the blocks, so that the blocks
+ * stay plain allocator blocks which open62541 and the application may release with free() */
+typedef struct EdgeAllocEntry
+{
+    void *ptr;
+    size_t size;
+    EdgeAllocTag *tag;
+} EdgeAllocEntry;
+
+static EdgeAllocTag g_tags[EDGE_MALLOC_MAX_TAGS];
+static size_t g_tagCount = 0;
+static pthread_mutex_t g_tagMutex = PTHREAD_MUTEX_INITIALIZER;
+
+static EdgeAllocTag *findTag(const char *tag, size_t count)
+{
+    for (size_t i = 0; i < count; i++)
+    {
+        if (g_tags[i].tag == tag)
+        {
+            return &g_tags[i];
+        }
+    }
+    for (size_t i = 0; i < count; i++)
+    {
+        if (0 == strcmp(g_tags[i].tag, tag))
+        {
+            return &g_tags[i];
+        }
+    }
+    return NULL;
+}
+
+static EdgeAllocTag *getTag(const char *tag)
+{
+    if (NULL == tag)
+    {
+        tag = TAG;
+    }
+
+    // Entries are never removed, so published ones can be searched without the lock.
+    EdgeAllocTag *entry = findTag(tag, TAG_COUNT_LOAD(&g_tagCount));
+    if (entry)
+    {
+        return entry;
+    }
+
+    pthread_mutex_lock(&g_tagMutex);
+    size_t count = TAG_COUNT_LOAD(&g_tagCount);
+    entry = findTag(tag, count);
+    if (NULL == entry)
+    {
+        if (count < EDGE_MALLOC_MAX_TAGS)
+        {
+            entry = &g_tags[count];
+            entry->tag = tag;
+            TAG_COUNT_STORE(&g_tagCount, count + 1);
+        }
+        else
+        {
+            entry = &g_tags[EDGE_MALLOC_MAX_TAGS - 1];
+        }
+    }
+    pthread_mutex_unlock(&g_tagMutex);
+    return entry;
+}
+
+/* Open addressing table of the live blocks, its capacity is a power of two */
+static EdgeAllocEntry *g_entries = NULL;
+static size_t g_entryCapacity = 0;
+static size_t g_entryCount = 0;
+/* Guards the table and the calls into the allocator which add or remove blocks */
+static pthread_mutex_t g_entryMutex = PTHREAD_MUTEX_INITIALIZER;
+
+static size_t entrySlot(const void *ptr, size_t capacity)
+{
+    size_t key = (size_t) ((uintptr_t) ptr >> 4);
+    return (key * (size_t) 2654435761u) & (capacity - 1);
+}
+
+static EdgeAllocEntry *findEntry(const void *ptr)
+{
+    if (0 == g_entryCapacity)
+    {
+        return NULL;
+    }
+    for (size_t i = entrySlot(ptr, g_entryCapacity); NULL != g_entries[i].ptr;
+            i = (i + 1) & (g_entryCapacity - 1))
+    {
+        if (g_entries[i].ptr == ptr)
+        {
+            return &g_entries[i];
+        }
+    }
+    return NULL;
+}
+
+static void insertEntry(EdgeAllocEntry *entries, size_t capacity, const EdgeAllocEntry *entry)
+{
+    size_t i = entrySlot(entry->ptr, capacity);
+    while (NULL != entries[i].ptr)
+    {
+        i = (i + 1) & (capacity - 1);
+    }
+    entries[i] = *entry;
+}
+
+static bool growEntries(void)
+{
+    // The table is internal, it always comes from libc whatever allocator is installed.
+    size_t capacity = g_entryCapacity ? g_entryCapacity * 2 : 1024;
+    EdgeAllocEntry *entries = (EdgeAllocEntry *) calloc(capacity, sizeof(EdgeAllocEntry));
+    COND_CHECK((NULL == entries), false);
+    for (size_t i = 0; i < g_entryCapacity; i++)
+    {
+        if (NULL != g_entries[i].ptr)
+        {
+            insertEntry(entries, capacity, &g_entries[i]);
+        }
+    }
+    free(g_entries);
+    g_entries = entries;
+    g_entryCapacity = capacity;
+    return true;
+}
+
+static void removeEntry(EdgeAllocEntry *entry)
+{
+    COUNTER_ADD(&entry->tag->liveBytes, (size_t) 0 - entry->size);
+    COUNTER_ADD(&entry->tag->liveCount, (size_t) -1);
+
+    // Entries after the removed one move back, so that lookups never stop at a hole.
+    size_t hole = (size_t) (entry - g_entries);
+    size_t i = hole;
+    g_entries[hole].ptr = NULL;
+    while (true)
+    {
+        i = (i + 1) & (g_entryCapacity - 1);
+        if (NULL == g_entries[i].ptr)
+        {
+            break;
+        }
+        size_t slot = entrySlot(g_entries[i].ptr, g_entryCapacity);
+        if (((i - slot) & (g_entryCapacity - 1)) >= ((i - hole) & (g_entryCapacity - 1)))
+        {
+            g_entries[hole] = g_entries[i];
+            g_entries[i].ptr = NULL;
+            hole = i;
+        }
+    }
+    g_entryCount--;
+}
+
+/* Called with g_entryMutex held */
+static void trackBlock(void *ptr, size_t size, EdgeAllocTag *tag)
+{
+    // An entry of the same address belongs to a block which was released with free()
+    EdgeAllocEntry *stale = findEntry(ptr);
+    if (stale)
+    {
+        removeEntry(stale);
+    }
+    // No logging here, the logger allocates through the locked allocator too.
+    if ((g_entryCount + 1) * 4 > g_entryCapacity * 3 && !growEntries())
+    {
+        return;
+    }
+    EdgeAllocEntry entry = { ptr, size, tag };
+    insertEntry(g_entries, g_entryCapacity, &entry);
+    g_entryCount++;
+    COUNTER_ADD(&tag->liveBytes, size);
+    COUNTER_ADD(&tag->liveCount, 1);
+    COUNTER_ADD(&tag->totalCount, 1);
+}
+
+void *EdgeMallocTag(size_t size, const char *tag)
+{
+    COND_CHECK((0 == size), NULL);
+    EdgeAllocTag *entry = getTag(tag);
+    pthread_mutex_lock(&g_entryMutex);
+    void *ptr = g_allocator.mallocFn(size);
+    if (ptr)
+    {
+        trackBlock(ptr, size, entry);
+    }
+    pthread_mutex_unlock(&g_entryMutex);
+    return ptr;
+}
+
+void *EdgeCallocTag(size_t num, size_t size, const char *tag)
+{
+    COND_CHECK((0 == size), NULL);
+    COND_CHECK((0 == num), NULL);
+    COND_CHECK((num > SIZE_MAX / size), NULL);
+    size_t total = num * size;
+    EdgeAllocTag *entry = getTag(tag);
+    pthread_mutex_lock(&g_entryMutex);
+    void *ptr = NULL;
+    if (g_allocator.callocFn)
+    {
+        ptr = g_allocator.callocFn(num, size);
+    }
+    else
+    {
+        ptr = g_allocator.mallocFn(total);
+        if (ptr)
+        {
+            memset(ptr, 0, total);
+        }
+    }
+    if (ptr)
+    {
+        trackBlock(ptr, total, entry);
+    }
+    pthread_mutex_unlock(&g_entryMutex);
+    return ptr;
+}
+
+void *EdgeReallocTag(void *ptr, size_t size, const char *tag)
+{
+    // Same NULL pointer behavior as EdgeRealloc()
+    if (NULL == ptr)
+    {
+        return EdgeMallocTag(size, tag);
+    }
+
+    // The block stays accounted to the tag which allocated it. The lock is held across
+    // realloc(), otherwise another thread could be given the old address in between.
+    pthread_mutex_lock(&g_entryMutex);
+    void *resized = g_allocator.reallocFn(ptr, size);
+    if (resized)
+    {
+        EdgeAllocEntry *old = findEntry(ptr);
+        EdgeAllocTag *entry = old ? old->tag : getTag(tag);
+        if (old)
+        {
+            removeEntry(old);
+        }
+        trackBlock(resized, size, entry);
+    }
+    pthread_mutex_unlock(&g_entryMutex);
+    return resized;
+}
+
+void *EdgeMalloc(size_t size)
+{
+    return EdgeMallocTag(size, NULL);
+}
+
+void *EdgeCalloc(size_t num, size_t size)
+{
+    return EdgeCallocTag(num, size, NULL);
+}
+
+void *EdgeRealloc(void* ptr, size_t size)
+{
+    return EdgeReallocTag(ptr, size, NULL);
+}
+
+void EdgeFree(void *ptr)
+{
+    VERIFY_NON_NULL_NR_MSG(ptr, "ptr is NULL\n");
+    pthread_mutex_lock(&g_entryMutex);
+    // Blocks of open62541 are released through here as well, they have no entry.
+    EdgeAllocEntry *entry = findEntry(ptr);
+    if (entry)
+    {
+        removeEntry(entry);
+    }
+    g_allocator.freeFn(ptr);
+    pthread_mutex_unlock(&g_entryMutex);
+}
+
+size_t EdgeGetAllocStats(EdgeAllocStats *stats, size_t maxStats)
+{
+    VERIFY_NON_NULL_MSG(stats, "NULL stats param in EdgeGetAllocStats\n", 0);
+    size_t count = TAG_COUNT_LOAD(&g_tagCount);
+    if (count > maxStats)
+    {
+        count = maxStats;
+    }
+    for (size_t i = 0; i < count; i++)
+    {
+        stats[i].tag = g_tags[i].tag;
+        stats[i].liveBytes = COUNTER_LOAD(&g_tags[i].liveBytes);
+        stats[i].liveCount = COUNTER_LOAD(&g_tags[i].liveCount);
+        stats[i].totalCount = COUNTER_LOAD(&g_tags[i].totalCount);
+    }
+    return count;
+}
+#else
 void *EdgeMalloc(size_t size)
 {
     COND_CHECK((0 == size), NULL);
-    return malloc(size);
+    return g_allocator.mallocFn(size);
 }
 
 void *EdgeCalloc(size_t num, size_t size)
 {
     COND_CHECK((0 == size), NULL);
     COND_CHECK((0 == num), NULL);
-    return calloc(num, size);
+    if (g_allocator.callocFn)
+    {
+        return g_allocator.callocFn(num, size);
+    }
+
+    COND_CHECK((num > SIZE_MAX / size), NULL);
+    void *ptr = g_allocator.mallocFn(num * size);
+    if (ptr)
+    {
+        memset(ptr, 0, num * size);
+    }
+    return ptr;
 }
 
 void *EdgeRealloc(void* ptr, size_t size)
@@ -50,13 +389,37 @@ void *EdgeRealloc(void* ptr, size_t size)
     }
 
     // Otherwise leave the behavior up to realloc() itself:
-    return realloc(ptr, size);
+    return g_allocator.reallocFn(ptr, size);
 }
 
 void EdgeFree(void *ptr)
 {
     VERIFY_NON_NULL_NR_MSG(ptr, "ptr is NULL\n");
-    free(ptr);
+    g_allocator.freeFn(ptr);
+}
+
+size_t EdgeGetAllocStats(EdgeAllocStats *stats, size_t maxStats)
+{
+    (void) stats;
+    (void) maxStats;
+    return 0;
+}
+#endif
+
+bool EdgeSetAllocator(const EdgeAllocator *allocator)
+{
+    if (NULL == allocator)
+    {
+        g_allocator.mallocFn = malloc;
+        g_allocator.callocFn = calloc;
+        g_allocator.reallocFn = realloc;
+        g_allocator.freeFn = free;
+        return true;
+    }
+    COND_CHECK((NULL == allocator->mallocFn || NULL == allocator->reallocFn
+            || NULL == allocator->freeFn), false);
+    g_allocator = *allocator;
+    return true;
 }
 
 Edge_String EdgeStringAlloc(char const src[])
@@ -67,6 +430,7 @@ Edge_String EdgeStringAlloc(char const src[])
     Edge_String str;
     str.length = strlen(src);
     if(str.length > 0) {
+        // Allocated by libc malloc as the string is handed over to open62541.
         str.data = (Edge_Byte*)malloc(str.length);
         // Returns an empty Edge_String if memory allocated fails.
         VERIFY_NON_NULL_MSG(str.data, "EdgeMalloc FAILED IN EdgeStringAlloc\n", EDGE_STRING_NULL);
@@ -75,4 +439,4 @@ Edge_String EdgeStringAlloc(char const src[])
         str.data = (Edge_Byte*)EDGE_EMPTY_ARRAY_SENTINEL;
     }
     return str;
-}
\ No newline at end of file
+}
@@ -21,105 +21,252 @@
 #include "edge_open62541.h"
 #include "edge_logger.h"
 #include "edge_malloc.h"
+#include "edge_arena.h"
 
 #define TAG "edge_open62541"
 
 
-UA_StatusCode createScalarVariant(int type, void *data, UA_Variant *out)
+/* Stack scalar which refers to the memory of an Edge scalar, see EdgeTypeConversion */
+typedef union BorrowedScalar
 {
-    UA_StatusCode ret = UA_STATUSCODE_GOOD;
-    if (type == UA_TYPES_STRING)
-    {
-        UA_String val = UA_STRING_ALLOC((char * ) data);
-        ret = UA_Variant_setScalarCopy(out, &val, &UA_TYPES[type]);
-        UA_String_deleteMembers(&val);
+    UA_String string;
+    UA_QualifiedName qualifiedName;
+    UA_LocalizedText localizedText;
+} BorrowedScalar;
 
-        EdgeFree(val.data);
-    }
-    else if (type == UA_TYPES_BYTESTRING)
+static void *toEdgeString(const void *uaValue)
+{
+    const UA_String *str = (const UA_String *) uaValue;
+    char *value = (char *) EdgeMalloc(str->length + 1);
+    VERIFY_NON_NULL_MSG(value, "EdgeMalloc FAILED for string value\n", NULL);
+    if (str->length > 0)
     {
-        UA_ByteString val = UA_BYTESTRING_ALLOC((char * ) data);
-        ret = UA_Variant_setScalarCopy(out, &val, &UA_TYPES[type]);
-        UA_ByteString_deleteMembers(&val);
-
-        EdgeFree(val.data);
+        memcpy(value, str->data, str->length);
     }
-    else if (type == UA_TYPES_LOCALIZEDTEXT)
+    value[str->length] = '\0';
+    return value;
+}
+
+static void *toEdgeGuid(const void *uaValue)
+{
+    char *value = (char *) EdgeMalloc(GUID_LENGTH + 1);
+    VERIFY_NON_NULL_MSG(value, "EdgeMalloc FAILED for Guid value\n", NULL);
+    convertGuidToString(*((const UA_Guid *) uaValue), &value);
+    return value;
+}
+
+static void *toEdgeQualifiedName(const void *uaValue)
+{
+    UA_QualifiedName *qn = (UA_QualifiedName *) (uintptr_t) uaValue;
+    Edge_QualifiedName *value = (Edge_QualifiedName *) EdgeCalloc(1, sizeof(Edge_QualifiedName));
+    VERIFY_NON_NULL_MSG(value, "Memory allocation failed.", NULL);
+
+    value->namespaceIndex = qn->namespaceIndex;
+    Edge_String *edgeStr = convertToEdgeString(&qn->name);
+    if(IS_NULL(edgeStr))
     {
-        Edge_LocalizedText *lt = (Edge_LocalizedText *) data;
-        UA_LocalizedText val;
-        val.locale.length = lt->locale.length;
-        val.locale.data = (uint8_t*)EdgeCalloc(val.locale.length, sizeof(uint8_t));
-        memcpy(val.locale.data, lt->locale.data, lt->locale.length);
-        val.text.length = lt->text.length;
-        val.text.data = (uint8_t*)EdgeCalloc(val.text.length, sizeof(uint8_t));
-        memcpy(val.text.data, lt->text.data, lt->text.length);
-        ret = UA_Variant_setScalarCopy(out, &val, &UA_TYPES[type]);
-        EdgeFree(val.locale.data);
-        EdgeFree(val.text.data);
+        EDGE_LOG(TAG, "Failed to convert name.");
+        EdgeFree(value);
+        return NULL;
     }
-    else if (type == UA_TYPES_QUALIFIEDNAME)
+    value->name = *edgeStr;
+    EdgeFree(edgeStr);
+    return value;
+}
+
+static void *toEdgeLocalizedText(const void *uaValue)
+{
+    UA_LocalizedText *lt = (UA_LocalizedText *) (uintptr_t) uaValue;
+    Edge_LocalizedText *value = (Edge_LocalizedText *) EdgeCalloc(1, sizeof(Edge_LocalizedText));
+    VERIFY_NON_NULL_MSG(value, "Memory allocation failed.", NULL);
+
+    Edge_String *edgeStr = convertToEdgeString(&lt->locale);
+    if(IS_NULL(edgeStr))
     {
-        Edge_QualifiedName *eqn = (Edge_QualifiedName *) data;
-        UA_QualifiedName qn;
-        qn.namespaceIndex=eqn->namespaceIndex;
-        qn.name=*((UA_String *)&eqn->name);
-        ret = UA_Variant_setScalarCopy(out, &qn, &UA_TYPES[type]);
+        EDGE_LOG(TAG, "Failed to convert locale.");
+        EdgeFree(value);
+        return NULL;
     }
-    else if (type == UA_TYPES_NODEID)
+    value->locale = *edgeStr;
+    EdgeFree(edgeStr);
+
+    edgeStr = convertToEdgeString(&lt->text);
+    if(IS_NULL(edgeStr))
     {
-        Edge_NodeId *n1 = (Edge_NodeId *) data;
-        ret = UA_Variant_setScalarCopy(out, n1, &UA_TYPES[type]);
+        EDGE_LOG(TAG, "Failed to convert text.");
+        EdgeFree(value->locale.data);
+        EdgeFree(value);
+        return NULL;
     }
-    else
+    value->text = *edgeStr;
+    EdgeFree(edgeStr);
+    return value;
+}
+
+static void *toEdgeNodeId(const void *uaValue)
+{
+    return convertToEdgeNodeIdType((UA_NodeId *) (uintptr_t) uaValue);
+}
+
+static void freeEdgeValue(void *edgeValue)
+{
+    EdgeFree(edgeValue);
+}
+
+static void freeEdgeQualifiedNameValue(void *edgeValue)
+{
+    freeEdgeQualifiedName((Edge_QualifiedName *) edgeValue);
+}
+
+static void freeEdgeLocalizedTextValue(void *edgeValue)
+{
+    freeEdgeLocalizedText((Edge_LocalizedText *) edgeValue);
+}
+
+static void freeEdgeNodeIdValue(void *edgeValue)
+{
+    freeEdgeNodeIdType((Edge_NodeId *) edgeValue);
+}
+
+/* The Edge value of the string types is a NULL terminated C string */
+static void borrowString(const void *edgeValue, void *uaValue)
+{
+    char *str = (char *) (uintptr_t) edgeValue;
+    UA_String *val = (UA_String *) uaValue;
+    val->length = IS_NOT_NULL(str) ? strlen(str) : 0;
+    val->data = (UA_Byte *) str;
+}
+
+static void borrowStringElement(const void *edgeElement, void *uaValue)
+{
+    borrowString(*((char * const *) edgeElement), uaValue);
+}
+
+static void borrowQualifiedName(const void *edgeValue, void *uaValue)
+{
+    const Edge_QualifiedName *eqn = (const Edge_QualifiedName *) edgeValue;
+    UA_QualifiedName *qn = (UA_QualifiedName *) uaValue;
+    qn->namespaceIndex = eqn->namespaceIndex;
+    qn->name = *((const UA_String *) &eqn->name);
+}
+
+static void borrowLocalizedText(const void *edgeValue, void *uaValue)
+{
+    const Edge_LocalizedText *lt = (const Edge_LocalizedText *) edgeValue;
+    UA_LocalizedText *val = (UA_LocalizedText *) uaValue;
+    val->locale = *((const UA_String *) &lt->locale);
+    val->text = *((const UA_String *) &lt->text);
+}
+
+#define EDGE_CONVERTED_TYPES (UA_TYPES_LOCALIZEDTEXT + 1)
+
+/* Built-in types up to LocalizedText, indexed by UA_TYPES index. Types without functions are
+ * plain values which have the same memory layout in the stack and the Edge representation. */
+static const EdgeTypeConversion typeConversions[EDGE_CONVERTED_TYPES] =
+{
+    [UA_TYPES_BOOLEAN] = { sizeof(bool), NULL, NULL, NULL, NULL },
+    [UA_TYPES_SBYTE] = { sizeof(int8_t), NULL, NULL, NULL, NULL },
+    [UA_TYPES_BYTE] = { sizeof(uint8_t), NULL, NULL, NULL, NULL },
+    [UA_TYPES_INT16] = { sizeof(int16_t), NULL, NULL, NULL, NULL },
+    [UA_TYPES_UINT16] = { sizeof(uint16_t), NULL, NULL, NULL, NULL },
+    [UA_TYPES_INT32] = { sizeof(int32_t), NULL, NULL, NULL, NULL },
+    [UA_TYPES_UINT32] = { sizeof(uint32_t), NULL, NULL, NULL, NULL },
+    [UA_TYPES_INT64] = { sizeof(int64_t), NULL, NULL, NULL, NULL },
+    [UA_TYPES_UINT64] = { sizeof(uint64_t), NULL, NULL, NULL, NULL },
+    [UA_TYPES_FLOAT] = { sizeof(float), NULL, NULL, NULL, NULL },
+    [UA_TYPES_DOUBLE] = { sizeof(double), NULL, NULL, NULL, NULL },
+    [UA_TYPES_STRING] = { sizeof(char), toEdgeString, freeEdgeValue, borrowString,
+            borrowStringElement },
+    [UA_TYPES_DATETIME] = { sizeof(UA_DateTime), NULL, NULL, NULL, NULL },
+    /* Guids are written as UA_Guid and read as strings */
+    [UA_TYPES_GUID] = { sizeof(UA_Guid), toEdgeGuid, freeEdgeValue, NULL, NULL },
+    [UA_TYPES_BYTESTRING] = { sizeof(char), toEdgeString, freeEdgeValue, borrowString,
+            borrowStringElement },
+    [UA_TYPES_XMLELEMENT] = { sizeof(char), toEdgeString, freeEdgeValue, borrowString,
+            borrowStringElement },
+    /* Edge_NodeId has the memory layout of UA_NodeId */
+    [UA_TYPES_NODEID] = { sizeof(Edge_NodeId), toEdgeNodeId, freeEdgeNodeIdValue, NULL, NULL },
+    [UA_TYPES_EXPANDEDNODEID] = { sizeof(UA_ExpandedNodeId), NULL, NULL, NULL, NULL },
+    [UA_TYPES_STATUSCODE] = { sizeof(UA_StatusCode), NULL, NULL, NULL, NULL },
+    /* Arrays of these are written in the memory layout of the stack type */
+    [UA_TYPES_QUALIFIEDNAME] = { sizeof(Edge_QualifiedName), toEdgeQualifiedName,
+            freeEdgeQualifiedNameValue, borrowQualifiedName, NULL },
+    [UA_TYPES_LOCALIZEDTEXT] = { sizeof(Edge_LocalizedText), toEdgeLocalizedText,
+            freeEdgeLocalizedTextValue, borrowLocalizedText, NULL }
+};
+
+const EdgeTypeConversion *getEdgeTypeConversion(int typeIndex)
+{
+    COND_CHECK((typeIndex < 0 || typeIndex >= EDGE_CONVERTED_TYPES), NULL);
+    return &typeConversions[typeIndex];
+}
+
+int getEdgeTypeIndex(const UA_DataType *type)
+{
+    /* Types of the table are elements of UA_TYPES, their index is their offset in it */
+    COND_CHECK((IS_NULL(type)), -1);
+    COND_CHECK(((uintptr_t) type < (uintptr_t) &UA_TYPES[0]
+            || (uintptr_t) type > (uintptr_t) &UA_TYPES[EDGE_CONVERTED_TYPES - 1]), -1);
+    return (int) (type - UA_TYPES);
+}
+
+UA_StatusCode createScalarVariant(int type, void *data, UA_Variant *out)
+{
+    const EdgeTypeConversion *conversion = getEdgeTypeConversion(type);
+    if (IS_NULL(conversion) || IS_NULL(conversion->borrowScalar))
     {
-        ret = UA_Variant_setScalarCopy(out, data, &UA_TYPES[type]);
+        return UA_Variant_setScalarCopy(out, data, &UA_TYPES[type]);
     }
-    return ret;
+
+    /* The variant copies the borrowed value, the Edge value stays with the caller */
+    BorrowedScalar val;
+    conversion->borrowScalar(data, &val);
+    return UA_Variant_setScalarCopy(out, &val, &UA_TYPES[type]);
 }
 
 UA_StatusCode createArrayVariant(int type, void *data, int len, UA_Variant *out)
 {
-    UA_StatusCode ret = UA_STATUSCODE_GOOD;
-    // array
-    if (type == UA_TYPES_STRING)
+    const EdgeTypeConversion *conversion = getEdgeTypeConversion(type);
+    if (IS_NULL(conversion) || IS_NULL(conversion->borrowElement) || len <= 0)
     {
-        size_t idx = 0;
-        char **data1 = (char **) data;
-        UA_String *array = (UA_String *) UA_Array_new(len, &UA_TYPES[type]);
-        for (idx = 0; idx < len; idx++)
-        {
-            array[idx] = UA_STRING_ALLOC(data1[idx]);
-        }
-        ret = UA_Variant_setArrayCopy(out, array, len, &UA_TYPES[type]);
-        for (idx = 0; idx < len; idx++)
-        {
-            UA_String_deleteMembers(&array[idx]);
-        }
-        UA_Array_delete(array, len, &UA_TYPES[type]);
+        return UA_Variant_setArrayCopy(out, data, len, &UA_TYPES[type]);
     }
-    else if (type == UA_TYPES_BYTESTRING)
+
+    size_t memSize = UA_TYPES[type].memSize;
+    UA_Byte *array = (UA_Byte *) EdgeCalloc(len, memSize);
+    VERIFY_NON_NULL_MSG(array, "EdgeCalloc FAILED for array in createArrayVariant\n",
+            UA_STATUSCODE_BADOUTOFMEMORY);
+    size_t elementSize = sizeof(void *);
+    for (size_t idx = 0; idx < (size_t) len; idx++)
     {
-        size_t idx = 0;
-        char **data1 = (char **) data;
-        UA_ByteString *array = (UA_ByteString *) UA_Array_new(len, &UA_TYPES[type]);
-        for (idx = 0; idx < len; idx++)
-        {
-            array[idx] = UA_BYTESTRING_ALLOC(data1[idx]);
-        }
-        ret = UA_Variant_setArrayCopy(out, array, len, &UA_TYPES[type]);
-        for (idx = 0; idx < len; idx++)
-        {
-            UA_ByteString_deleteMembers(&array[idx]);
-        }
-        UA_Array_delete(array, len, &UA_TYPES[type]);
+        conversion->borrowElement((UA_Byte *) data + idx * elementSize, array + idx * memSize);
+    }
+    UA_StatusCode ret = UA_Variant_setArrayCopy(out, array, len, &UA_TYPES[type]);
+    /* The elements are borrowed, only the array itself is freed */
+    EdgeFree(array);
+    return ret;
+}
+
+UA_StatusCode createBorrowedVariant(int type, void *data, bool isArray, int len, UA_Variant *out)
+{
+    /* Strings and the Edge structures differ from the stack types, they are converted by copying */
+    const EdgeTypeConversion *conversion = getEdgeTypeConversion(type);
+    COND_CHECK((IS_NOT_NULL(conversion)
+            && IS_NOT_NULL(isArray ? conversion->borrowElement : conversion->borrowScalar)),
+            UA_STATUSCODE_BADNOTSUPPORTED);
+    COND_CHECK((IS_NULL(data) || (isArray && len <= 0)), UA_STATUSCODE_BADNOTSUPPORTED);
+
+    if (isArray)
+    {
+        UA_Variant_setArray(out, data, (size_t) len, &UA_TYPES[type]);
     }
     else
     {
-        ret = UA_Variant_setArrayCopy(out, data, len,
-                &UA_TYPES[type]);
+        UA_Variant_setScalar(out, data, &UA_TYPES[type]);
     }
-    return ret;
+    /* The buffer belongs to the caller */
+    out->storageType = UA_VARIANT_DATA_NODELETE;
+    return UA_STATUSCODE_GOOD;
 }
 
 char *convertUAStringToString(UA_String *uaStr)
@@ -404,108 +551,443 @@ void freeEdgeVersatilityByType(EdgeVersatility *versatileValue, int type)
 {
     VERIFY_NON_NULL_NR_MSG(versatileValue, "NULL param versatileValue in freeEdgeVersatilityByType\n");
 
-    if (versatileValue->isArray)
+    /* type is a response type, the UA_TYPES index plus one */
+    const EdgeTypeConversion *conversion = getEdgeTypeConversion(type - 1);
+    if (versatileValue->adopted)
     {
-        if (type == UA_NS0ID_STRING || type == UA_NS0ID_BYTESTRING
-            || type == UA_NS0ID_GUID || type == UA_NS0ID_XMLELEMENT)
-        {
-            // Free String array
-            char **values = versatileValue->value;
-            if (values)
-            {
-                for (int j = 0; j < versatileValue->arrayLength; j++)
-                {
-                    EdgeFree(values[j]);
-                }
-                EdgeFree(values);
-            }
-        }
-        else if (type == UA_NS0ID_QUALIFIEDNAME)
+        /* The buffer comes from the stack allocator, see takeResponse() */
+        UA_Array_delete(versatileValue->value, versatileValue->arrayLength, &UA_TYPES[type - 1]);
+    }
+    else if (IS_NULL(conversion) || IS_NULL(conversion->freeEdge) || IS_NULL(versatileValue->value))
+    {
+        EdgeFree(versatileValue->value);
+    }
+    else if (versatileValue->isArray)
+    {
+        void **values = (void **) versatileValue->value;
+        for (int j = 0; j < versatileValue->arrayLength; j++)
         {
-            Edge_QualifiedName **values = (Edge_QualifiedName **) versatileValue->value;
-            for (int j = 0; j < versatileValue->arrayLength; j++)
+            if (IS_NOT_NULL(values[j]))
             {
-                freeEdgeQualifiedName(values[j]);
+                conversion->freeEdge(values[j]);
             }
-            EdgeFree(values);
         }
-        else if (type == UA_NS0ID_LOCALIZEDTEXT)
+        EdgeFree(values);
+    }
+    else
+    {
+        conversion->freeEdge(versatileValue->value);
+    }
+
+    EdgeFree(versatileValue);
+}
+
+bool isNodeClassValid(UA_NodeClass nodeClass)
+{
+    static const int NODECLASS_MASK = UA_NODECLASS_UNSPECIFIED | UA_NODECLASS_OBJECT
+            | UA_NODECLASS_VARIABLE | UA_NODECLASS_METHOD | UA_NODECLASS_OBJECTTYPE
+            | UA_NODECLASS_VARIABLETYPE | UA_NODECLASS_REFERENCETYPE | UA_NODECLASS_DATATYPE
+            | UA_NODECLASS_VIEW;
+    if (nodeClass & NODECLASS_MASK)
+        return true;
+    return false;
+}
+
+size_t get_size(int type, bool isArray)
+{
+    COND_CHECK((isArray), sizeof(void*));
+    const EdgeTypeConversion *conversion = getEdgeTypeConversion(type - 1);
+    COND_CHECK((IS_NULL(conversion)), 0);
+    return conversion->edgeSize;
+}
+
+static size_t getEndpointInfoArenaSize(const EdgeEndPointInfo *endpointInfo)
+{
+    COND_CHECK((IS_NULL(endpointInfo)), 0);
+    size_t size = getEdgeArenaSize(sizeof(EdgeSharedEndpoint))
+            + getEdgeArenaStringSize(endpointInfo->endpointUri)
+            + getEdgeArenaStringSize(endpointInfo->securityPolicyUri)
+            + getEdgeArenaStringSize(endpointInfo->transportProfileUri);
+
+    EdgeEndpointConfig *config = endpointInfo->endpointConfig;
+    if (config)
+    {
+        size += getEdgeArenaSize(sizeof(EdgeEndpointConfig))
+                + getEdgeArenaStringSize(config->serverName)
+                + getEdgeArenaStringSize(config->bindAddress);
+    }
+
+    EdgeApplicationConfig *appConfig = endpointInfo->appConfig;
+    if (appConfig)
+    {
+        size += getEdgeArenaSize(sizeof(EdgeApplicationConfig))
+                + getEdgeArenaStringSize(appConfig->applicationUri)
+                + getEdgeArenaStringSize(appConfig->productUri)
+                + getEdgeArenaStringSize(appConfig->applicationName)
+                + getEdgeArenaStringSize(appConfig->gatewayServerUri)
+                + getEdgeArenaStringSize(appConfig->discoveryProfileUri)
+                + getEdgeArenaSize(appConfig->discoveryUrlsSize * sizeof(char *));
+        for (size_t i = 0; i < appConfig->discoveryUrlsSize; i++)
         {
-            Edge_LocalizedText **values = (Edge_LocalizedText **) versatileValue->value;
-            for (int j = 0; j < versatileValue->arrayLength; j++)
-            {
-                freeEdgeLocalizedText(values[j]);
-            }
-            EdgeFree(values);
+            size += getEdgeArenaStringSize(appConfig->discoveryUrls[i]);
         }
-        else if (type == UA_NS0ID_NODEID)
+    }
+    return size;
+}
+
+static EdgeEndPointInfo *cloneEndpointInfoInArena(EdgeArena *arena, const EdgeEndPointInfo *endpointInfo)
+{
+    EdgeSharedEndpoint *shared = (EdgeSharedEndpoint *) allocEdgeArena(arena,
+            sizeof(EdgeSharedEndpoint));
+    COND_CHECK((IS_NULL(shared)), NULL);
+    EdgeEndPointInfo *clone = &shared->info;
+    *clone = *endpointInfo;
+    clone->endpointUri = cloneStringInArena(arena, endpointInfo->endpointUri);
+    clone->securityPolicyUri = cloneStringInArena(arena, endpointInfo->securityPolicyUri);
+    clone->transportProfileUri = cloneStringInArena(arena, endpointInfo->transportProfileUri);
+
+    if (endpointInfo->endpointConfig)
+    {
+        clone->endpointConfig = (EdgeEndpointConfig *) cloneDataInArena(arena,
+                endpointInfo->endpointConfig, sizeof(EdgeEndpointConfig));
+        COND_CHECK((IS_NULL(clone->endpointConfig)), NULL);
+        clone->endpointConfig->serverName = cloneStringInArena(arena,
+                endpointInfo->endpointConfig->serverName);
+        clone->endpointConfig->bindAddress = cloneStringInArena(arena,
+                endpointInfo->endpointConfig->bindAddress);
+    }
+
+    if (endpointInfo->appConfig)
+    {
+        EdgeApplicationConfig *src = endpointInfo->appConfig;
+        EdgeApplicationConfig *dst = (EdgeApplicationConfig *) cloneDataInArena(arena, src,
+                sizeof(EdgeApplicationConfig));
+        COND_CHECK((IS_NULL(dst)), NULL);
+        clone->appConfig = dst;
+        dst->applicationUri = cloneStringInArena(arena, src->applicationUri);
+        dst->productUri = cloneStringInArena(arena, src->productUri);
+        dst->applicationName = cloneStringInArena(arena, src->applicationName);
+        dst->gatewayServerUri = cloneStringInArena(arena, src->gatewayServerUri);
+        dst->discoveryProfileUri = cloneStringInArena(arena, src->discoveryProfileUri);
+        dst->discoveryUrls = (char **) allocEdgeArena(arena, src->discoveryUrlsSize * sizeof(char *));
+        if (IS_NULL(dst->discoveryUrls))
         {
-            Edge_NodeId **values = (Edge_NodeId **) versatileValue->value;
-            for (int j = 0; j < versatileValue->arrayLength; j++)
-            {
-                freeEdgeNodeIdType(values[j]);
-            }
-            EdgeFree(values);
+            dst->discoveryUrlsSize = 0;
         }
-        else
+        for (size_t i = 0; i < dst->discoveryUrlsSize; i++)
         {
-            EdgeFree(versatileValue->value);
+            dst->discoveryUrls[i] = cloneStringInArena(arena, src->discoveryUrls[i]);
         }
     }
-    else
+    return clone;
+}
+
+bool applyTransportConfig(UA_ConnectionConfig *conf, const EdgeEndpointConfig *epConfig)
+{
+    COND_CHECK((IS_NULL(conf) || IS_NULL(epConfig)), false);
+    bool applied = false;
+    if (epConfig->sendBufferSize > 0)
+    {
+        conf->sendBufferSize = epConfig->sendBufferSize;
+        applied = true;
+    }
+    if (epConfig->recvBufferSize > 0)
+    {
+        conf->recvBufferSize = epConfig->recvBufferSize;
+        applied = true;
+    }
+    if (epConfig->maxMessageSize > 0)
+    {
+        conf->maxMessageSize = epConfig->maxMessageSize;
+        applied = true;
+    }
+    if (epConfig->maxChunkCount > 0)
     {
-        if(type == UA_NS0ID_QUALIFIEDNAME)
+        conf->maxChunkCount = epConfig->maxChunkCount;
+        applied = true;
+    }
+    return applied;
+}
+
+EdgeEndPointInfo *shareEdgeEndpointInfo(EdgeEndPointInfo *endpointInfo)
+{
+    VERIFY_NON_NULL_MSG(endpointInfo, "NULL param endpointInfo in shareEdgeEndpointInfo\n", NULL);
+    EdgeArena arena;
+    COND_CHECK_MSG((!initEdgeArena(&arena, getEndpointInfoArenaSize(endpointInfo))),
+            "EdgeCalloc failed in shareEdgeEndpointInfo\n", NULL);
+    EdgeEndPointInfo *shared = cloneEndpointInfoInArena(&arena, endpointInfo);
+    if (IS_NULL(shared) || arena.exhausted)
+    {
+        EDGE_LOG(TAG, "Failed to share the endpoint info.");
+        EdgeFree(arena.base);
+        return NULL;
+    }
+    ((EdgeSharedEndpoint *) shared)->refCount = 1;
+    return shared;
+}
+
+static size_t getNodeInfoArenaSize(const EdgeNodeInfo *nodeInfo)
+{
+    COND_CHECK((IS_NULL(nodeInfo)), 0);
+    size_t size = getEdgeArenaSize(sizeof(EdgeNodeInfo))
+            + getEdgeArenaStringSize(nodeInfo->methodName)
+            + getEdgeArenaStringSize(nodeInfo->valueAlias);
+    if (nodeInfo->nodeId)
+    {
+        size += getEdgeArenaSize(sizeof(EdgeNodeId))
+                + getEdgeArenaStringSize(nodeInfo->nodeId->nodeUri)
+                + getEdgeArenaStringSize(nodeInfo->nodeId->nodeId);
+    }
+    return size;
+}
+
+static EdgeNodeInfo *cloneNodeInfoInArena(EdgeArena *arena, const EdgeNodeInfo *nodeInfo)
+{
+    EdgeNodeInfo *clone = (EdgeNodeInfo *) allocEdgeArena(arena, sizeof(EdgeNodeInfo));
+    COND_CHECK((IS_NULL(clone)), NULL);
+    clone->methodName = cloneStringInArena(arena, nodeInfo->methodName);
+    clone->valueAlias = cloneStringInArena(arena, nodeInfo->valueAlias);
+    if (nodeInfo->nodeId)
+    {
+        clone->nodeId = (EdgeNodeId *) cloneDataInArena(arena, nodeInfo->nodeId, sizeof(EdgeNodeId));
+        COND_CHECK((IS_NULL(clone->nodeId)), NULL);
+        clone->nodeId->nodeUri = cloneStringInArena(arena, nodeInfo->nodeId->nodeUri);
+        clone->nodeId->nodeId = cloneStringInArena(arena, nodeInfo->nodeId->nodeId);
+    }
+    return clone;
+}
+
+static size_t getValueArenaSize(bool isString, int type, bool isArray, size_t arrayLength,
+        const void *value)
+{
+    COND_CHECK((IS_NULL(value)), 0);
+    if (!isArray)
+    {
+        return isString ? getEdgeArenaStringSize((const char *) value) :
+                getEdgeArenaSize(get_size(type, false));
+    }
+    if (!isString)
+    {
+        return getEdgeArenaSize(arrayLength * get_size(type, false));
+    }
+
+    size_t size = getEdgeArenaSize(arrayLength * sizeof(char *));
+    char **values = (char **) value;
+    for (size_t i = 0; i < arrayLength; i++)
+    {
+        size += getEdgeArenaStringSize(values[i]);
+    }
+    return size;
+}
+
+static void *cloneValueInArena(EdgeArena *arena, bool isString, int type, bool isArray,
+        size_t arrayLength, const void *value)
+{
+    COND_CHECK((IS_NULL(value)), NULL);
+    if (!isArray)
+    {
+        return isString ? cloneStringInArena(arena, (const char *) value) :
+                cloneDataInArena(arena, value, get_size(type, false));
+    }
+    if (!isString)
+    {
+        return cloneDataInArena(arena, value, arrayLength * get_size(type, false));
+    }
+
+    char **values = (char **) allocEdgeArena(arena, arrayLength * sizeof(char *));
+    COND_CHECK((IS_NULL(values)), NULL);
+    for (size_t i = 0; i < arrayLength; i++)
+    {
+        values[i] = cloneStringInArena(arena, ((char **) value)[i]);
+    }
+    return values;
+}
+
+static size_t getMethodParamsArenaSize(const EdgeMethodRequestParams *methodParams)
+{
+    COND_CHECK((IS_NULL(methodParams)), 0);
+    size_t size = getEdgeArenaSize(sizeof(EdgeMethodRequestParams));
+    COND_CHECK((methodParams->num_inpArgs < 1), size);
+
+    size += getEdgeArenaSize(methodParams->num_inpArgs * sizeof(EdgeArgument *));
+    for (size_t i = 0; i < methodParams->num_inpArgs; i++)
+    {
+        EdgeArgument *arg = methodParams->inpArg[i];
+        bool isString = (arg->argType == UA_NS0ID_STRING);
+        size += getEdgeArenaSize(sizeof(EdgeArgument));
+        if (SCALAR == arg->valType)
         {
-            freeEdgeQualifiedName((Edge_QualifiedName *)versatileValue->value);
+            size += getValueArenaSize(isString, arg->argType, false, 0, arg->scalarValue);
         }
-        else if(type == UA_NS0ID_LOCALIZEDTEXT)
+        else if (ARRAY_1D == arg->valType)
         {
-            freeEdgeLocalizedText((Edge_LocalizedText *)versatileValue->value);
+            size += getValueArenaSize(isString, arg->argType, true, arg->arrayLength, arg->arrayData);
         }
-        else if (type == UA_NS0ID_NODEID)
+    }
+    return size;
+}
+
+static EdgeMethodRequestParams *cloneMethodParamsInArena(EdgeArena *arena,
+        const EdgeMethodRequestParams *methodParams)
+{
+    EdgeMethodRequestParams *clone = (EdgeMethodRequestParams *) allocEdgeArena(arena,
+            sizeof(EdgeMethodRequestParams));
+    COND_CHECK((IS_NULL(clone)), NULL);
+    clone->num_outArgs = methodParams->num_outArgs;
+    COND_CHECK((methodParams->num_inpArgs < 1), clone);
+
+    clone->inpArg = (EdgeArgument **) allocEdgeArena(arena,
+            methodParams->num_inpArgs * sizeof(EdgeArgument *));
+    COND_CHECK((IS_NULL(clone->inpArg)), NULL);
+    clone->num_inpArgs = methodParams->num_inpArgs;
+    for (size_t i = 0; i < clone->num_inpArgs; i++)
+    {
+        EdgeArgument *arg = methodParams->inpArg[i];
+        bool isString = (arg->argType == UA_NS0ID_STRING);
+        clone->inpArg[i] = (EdgeArgument *) allocEdgeArena(arena, sizeof(EdgeArgument));
+        COND_CHECK((IS_NULL(clone->inpArg[i])), NULL);
+        clone->inpArg[i]->argType = arg->argType;
+        clone->inpArg[i]->valType = arg->valType;
+        if (SCALAR == arg->valType)
         {
-            freeEdgeNodeIdType((Edge_NodeId *)versatileValue->value);
+            clone->inpArg[i]->scalarValue = cloneValueInArena(arena, isString, arg->argType, false, 0,
+                    arg->scalarValue);
         }
-        else
+        else if (ARRAY_1D == arg->valType)
         {
-            EdgeFree(versatileValue->value);
+            clone->inpArg[i]->arrayLength = arg->arrayLength;
+            clone->inpArg[i]->arrayData = cloneValueInArena(arena, isString, arg->argType, true,
+                    arg->arrayLength, arg->arrayData);
         }
     }
+    return clone;
+}
 
-    EdgeFree(versatileValue);
+static bool isStringWriteType(int type)
+{
+    return (type == UA_NS0ID_STRING || type == UA_NS0ID_BYTESTRING);
 }
 
-bool isNodeClassValid(UA_NodeClass nodeClass)
+static size_t getRequestArenaSize(const EdgeMessage *msg, const EdgeRequest *request, bool isGroup)
 {
-    static const int NODECLASS_MASK = UA_NODECLASS_UNSPECIFIED | UA_NODECLASS_OBJECT
-            | UA_NODECLASS_VARIABLE | UA_NODECLASS_METHOD | UA_NODECLASS_OBJECTTYPE
-            | UA_NODECLASS_VARIABLETYPE | UA_NODECLASS_REFERENCETYPE | UA_NODECLASS_DATATYPE
-            | UA_NODECLASS_VIEW;
-    if (nodeClass & NODECLASS_MASK)
-        return true;
-    return false;
+    COND_CHECK((IS_NULL(request)), 0);
+    size_t size = getEdgeArenaSize(sizeof(EdgeRequest)) + getNodeInfoArenaSize(request->nodeInfo);
+    if (request->subMsg && (!isGroup || msg->command == CMD_SUB))
+    {
+        size += getEdgeArenaSize(sizeof(EdgeSubRequest));
+    }
+    if (!isGroup)
+    {
+        return size + getMethodParamsArenaSize(request->methodParams);
+    }
+
+    if (msg->command == CMD_WRITE && request->value)
+    {
+        EdgeVersatility *value = (EdgeVersatility *) request->value;
+        size += getEdgeArenaSize(sizeof(EdgeVersatility))
+                + getValueArenaSize(isStringWriteType(request->type), request->type,
+                        value->isArray, value->arrayLength, value->value);
+    }
+    return size;
 }
 
-size_t get_size(int type, bool isArray)
+static EdgeRequest *cloneRequestInArena(EdgeArena *arena, const EdgeMessage *msg,
+        const EdgeRequest *request, bool isGroup)
 {
-    COND_CHECK((isArray), sizeof(void*));
-    size_t size[13] = {sizeof(bool), sizeof(int8_t), sizeof(uint8_t), sizeof(int16_t), sizeof(uint16_t),
-                      sizeof(int32_t), sizeof(uint32_t), sizeof(int64_t), sizeof(uint64_t),
-                      sizeof(float), sizeof(double), sizeof(char), sizeof(UA_DateTime)};
-    return size[type-1];
+    EdgeRequest *clone = (EdgeRequest *) allocEdgeArena(arena, sizeof(EdgeRequest));
+    COND_CHECK((IS_NULL(clone)), NULL);
+    clone->attributeId = request->attributeId;
+    if (request->nodeInfo)
+    {
+        clone->nodeInfo = cloneNodeInfoInArena(arena, request->nodeInfo);
+        COND_CHECK((IS_NULL(clone->nodeInfo)), NULL);
+    }
+    if (request->subMsg && (!isGroup || msg->command == CMD_SUB))
+    {
+        clone->subMsg = (EdgeSubRequest *) cloneDataInArena(arena, request->subMsg,
+                sizeof(EdgeSubRequest));
+    }
+    if (!isGroup)
+    {
+        if (request->methodParams)
+        {
+            clone->methodParams = cloneMethodParamsInArena(arena, request->methodParams);
+        }
+        return clone;
+    }
+
+    if (msg->command == CMD_WRITE)
+    {
+        clone->type = request->type;
+        if (request->value)
+        {
+            EdgeVersatility *src = (EdgeVersatility *) request->value;
+            EdgeVersatility *dst = (EdgeVersatility *) allocEdgeArena(arena, sizeof(EdgeVersatility));
+            COND_CHECK((IS_NULL(dst)), NULL);
+            dst->isArray = src->isArray;
+            dst->arrayLength = src->arrayLength;
+            dst->adopted = false;
+            dst->value = cloneValueInArena(arena, isStringWriteType(request->type), request->type,
+                    src->isArray, src->arrayLength, src->value);
+            clone->value = dst;
+        }
+    }
+    return clone;
+}
+
+static size_t getMessageArenaSize(const EdgeMessage *msg)
+{
+    size_t size = getEdgeArenaSize(sizeof(EdgeMessageBlock));
+    if (msg->browseParam)
+    {
+        size += getEdgeArenaSize(sizeof(EdgeBrowseParameter));
+    }
+    if (msg->historyParam)
+    {
+        size += getEdgeArenaSize(sizeof(EdgeHistoryParameter));
+    }
+    if (msg->type == SEND_REQUEST)
+    {
+        size += getRequestArenaSize(msg, msg->request, false);
+    }
+    if (msg->type == SEND_REQUESTS)
+    {
+        size += getEdgeArenaSize(msg->requestLength * sizeof(EdgeRequest *));
+        for (size_t i = 0; i < msg->requestLength; i++)
+        {
+            size += getRequestArenaSize(msg, msg->requests[i], true);
+        }
+    }
+    return size;
 }
 
 EdgeMessage* cloneEdgeMessage(EdgeMessage *msg)
 {
     VERIFY_NON_NULL_MSG(msg, "NULL param EdgeMessage in cloneEdgeMessage\n", NULL);
-    EdgeMessage *clone = (EdgeMessage *)EdgeCalloc(1, sizeof(EdgeMessage));
-    VERIFY_NON_NULL_MSG(clone, "EdgeCalloc failed for clone in cloneEdgeMessage\n", NULL);
 
+    // Size everything first so that the clone and all of its members share one block.
+    EdgeArena arena;
+    COND_CHECK_MSG((!initEdgeArena(&arena, getMessageArenaSize(msg))),
+            "EdgeCalloc failed for clone in cloneEdgeMessage\n", NULL);
+    EdgeMessageBlock *block = (EdgeMessageBlock *) allocEdgeArena(&arena, sizeof(EdgeMessageBlock));
+    EdgeMessage *clone = IS_NOT_NULL(block) ? &block->msg : NULL;
+    if(IS_NULL(clone))
+    {
+        goto CLONE_ERROR;
+    }
+
+    block->isArenaBlock = true;
+    if (!registerEdgeMessageBlock(block))
+    {
+        clone = NULL;
+        goto CLONE_ERROR;
+    }
     clone->type = msg->type;
     clone->command = msg->command;
     if(IS_NOT_NULL(msg->endpointInfo))
     {
-        clone->endpointInfo = cloneEdgeEndpointInfo(msg->endpointInfo);
+        // msg may be allocated by the application, so its endpoint is copied
+        setMessageEndpointInfo(clone, shareEdgeEndpointInfo(msg->endpointInfo));
         if(IS_NULL(clone->endpointInfo))
         {
             goto CLONE_ERROR;
@@ -514,185 +996,73 @@ EdgeMessage* cloneEdgeMessage(EdgeMessage *msg)
 
     clone->requestLength = msg->requestLength;
     clone->message_id = msg->message_id;
+    clone->maxAge = msg->maxAge;
+    clone->writeErrorsOnly = msg->writeErrorsOnly;
 
     if (msg->browseParam)
     {
-        clone->browseParam = (EdgeBrowseParameter *) EdgeCalloc(1, sizeof(EdgeBrowseParameter));
+        clone->browseParam = (EdgeBrowseParameter *) cloneDataInArena(&arena, msg->browseParam,
+                sizeof(EdgeBrowseParameter));
         if(IS_NULL(clone->browseParam))
         {
             goto CLONE_ERROR;
         }
-        clone->browseParam->direction = msg->browseParam->direction;
-        clone->browseParam->maxReferencesPerNode = msg->browseParam->maxReferencesPerNode;
     }
 
-    if (msg->type == SEND_REQUEST)
+    if (msg->historyParam)
     {
-        if (msg->request)
+        clone->historyParam = (EdgeHistoryParameter *) cloneDataInArena(&arena, msg->historyParam,
+                sizeof(EdgeHistoryParameter));
+        if(IS_NULL(clone->historyParam))
         {
-            clone->request = (EdgeRequest*) EdgeCalloc(1, sizeof(EdgeRequest));
-            if(IS_NULL(clone->request))
-            {
-                goto CLONE_ERROR;
-            }
-
-            if (msg->request->nodeInfo)
-            {
-                clone->request->nodeInfo = cloneEdgeNodeInfo(msg->request->nodeInfo);
-                if(IS_NULL(clone->request->nodeInfo))
-                {
-                    goto CLONE_ERROR;
-                }
-            }
-
-            if (msg->request->subMsg)
-            {
-                clone->request->subMsg = cloneSubRequest(msg->request->subMsg);
-                if(IS_NULL(clone->request->subMsg))
-                {
-                    goto CLONE_ERROR;
-                }
-            }
+            goto CLONE_ERROR;
+        }
+    }
 
-            if (msg->request->methodParams)
-            {
-                clone->request->methodParams = cloneEdgeMethodRequestParams(msg->request->methodParams);
-                if(IS_NULL(clone->request->methodParams))
-                {
-                    goto CLONE_ERROR;
-                }
-            }
+    if (msg->type == SEND_REQUEST && msg->request)
+    {
+        clone->request = cloneRequestInArena(&arena, msg, msg->request, false);
+        if(IS_NULL(clone->request))
+        {
+            goto CLONE_ERROR;
         }
     }
 
     if (msg->type == SEND_REQUESTS)
     {
-        clone->requests = (EdgeRequest**) EdgeCalloc(msg->requestLength, sizeof(EdgeRequest*));
-        if(IS_NULL(clone->requests))
+        clone->requests = (EdgeRequest**) allocEdgeArena(&arena, msg->requestLength * sizeof(EdgeRequest*));
+        if(IS_NULL(clone->requests) && msg->requestLength > 0)
         {
             goto CLONE_ERROR;
         }
 
         for (size_t i = 0; i < msg->requestLength; i++)
         {
-            clone->requests[i] = (EdgeRequest*) EdgeCalloc(1, sizeof(EdgeRequest));
+            clone->requests[i] = cloneRequestInArena(&arena, msg, msg->requests[i], true);
             if(IS_NULL(clone->requests[i]))
             {
                 goto CLONE_ERROR;
             }
-
-            if (msg->requests[i]->nodeInfo)
-            {
-                clone->requests[i]->nodeInfo = cloneEdgeNodeInfo(msg->requests[i]->nodeInfo);
-                if(IS_NULL(clone->requests[i]->nodeInfo))
-                {
-                    goto CLONE_ERROR;
-                }
-            }
-
-            if (msg->command == CMD_WRITE)
-            {
-                clone->requests[i]->type = msg->requests[i]->type;
-                // EdgeVersatility
-                if (msg->requests[i]->value)
-                {
-                    EdgeVersatility *srcVersatility = (EdgeVersatility *) msg->requests[i]->value;
-                    clone->requests[i]->value = (EdgeVersatility*) EdgeCalloc(1, sizeof(EdgeVersatility));
-                    if(IS_NULL(clone->requests[i]->value))
-                    {
-                        goto CLONE_ERROR;
-                    }
-
-                    EdgeVersatility* cloneVersatility = (EdgeVersatility*) clone->requests[i]->value;
-                    if (srcVersatility->isArray == false)
-                    {
-                        // Scalar
-                        void *val = srcVersatility->value;
-
-                        cloneVersatility->arrayLength = srcVersatility->arrayLength;
-                        cloneVersatility->isArray = srcVersatility->isArray;
-                        size_t size = get_size(msg->requests[i]->type, srcVersatility->isArray);
-                        if (msg->requests[i]->type == UA_NS0ID_STRING || msg->requests[i]->type == UA_NS0ID_BYTESTRING)
-                        {
-                            size_t len = strlen((char *) srcVersatility->value);
-                            cloneVersatility->value = (void *) EdgeCalloc(1, len+1);
-                            if(IS_NULL(cloneVersatility->value))
-                            {
-                                goto CLONE_ERROR;
-                            }
-
-                            strncpy(cloneVersatility->value, (char*) srcVersatility->value, len+1);
-                        }
-                        else
-                        {
-                            cloneVersatility->value = (void *) EdgeCalloc(1, size);
-                            if(IS_NULL(cloneVersatility->value))
-                            {
-                                goto CLONE_ERROR;
-                            }
-                            memcpy(cloneVersatility->value, val, size);
-                        }
-                    }
-                    else
-                    {
-                        // Array
-                        void *val = srcVersatility->value;
-
-                        cloneVersatility->arrayLength = srcVersatility->arrayLength;
-                        cloneVersatility->isArray = srcVersatility->isArray;
-                        size_t size = get_size(msg->requests[i]->type, srcVersatility->isArray);
-                        if (msg->requests[i]->type == UA_NS0ID_STRING || msg->requests[i]->type == UA_NS0ID_BYTESTRING)
-                        {
-                            char **srcVal = (char**) srcVersatility->value;
-                            cloneVersatility->value = EdgeCalloc(srcVersatility->arrayLength, sizeof(char*));
-                            if(IS_NULL(cloneVersatility->value))
-                            {
-                                goto CLONE_ERROR;
-                            }
-
-                            char **dstVal = (char **) cloneVersatility->value;
-                            size_t len;
-                            for (int j = 0; j < srcVersatility->arrayLength; j++)
-                            {
-                                len = strlen(srcVal[j]);
-                                dstVal[j] = (char*) EdgeCalloc(1, sizeof(char) * (len+1));
-                                if(IS_NULL(dstVal[j]))
-                                {
-                                    goto CLONE_ERROR;
-                                }
-                                strncpy(dstVal[j], srcVal[j], len+1);
-                            }
-                        }
-                        else
-                        {
-                            cloneVersatility->value = EdgeCalloc(srcVersatility->arrayLength, size);
-                            if(IS_NULL(cloneVersatility->value))
-                            {
-                                goto CLONE_ERROR;
-                            }
-                            memcpy(cloneVersatility->value, val, get_size(msg->requests[i]->type, true) * srcVersatility->arrayLength);
-                        }
-                    }
-                }
-            }
-            else if (msg->command == CMD_SUB)
-            {
-                if(IS_NOT_NULL(msg->requests[i]->subMsg))
-                {
-                    clone->requests[i]->subMsg = cloneSubRequest(msg->requests[i]->subMsg);
-                    if(IS_NULL(clone->requests[i]->subMsg))
-                    {
-                        goto CLONE_ERROR;
-                    }
-                }
-            }
         }
     }
 
+    if (arena.exhausted)
+    {
+        goto CLONE_ERROR;
+    }
     return clone;
 
 CLONE_ERROR:
-    freeEdgeMessage(clone);
+    EDGE_LOG(TAG, "Failed to clone the message.");
+    if (IS_NOT_NULL(clone) && IS_NOT_NULL(clone->endpointInfo))
+    {
+        releaseEdgeEndpointInfo(clone->endpointInfo);
+    }
+    if (IS_NOT_NULL(clone))
+    {
+        unregisterEdgeMessageBlock(block);
+    }
+    EdgeFree(arena.base);
     return NULL;
 }
 
@@ -719,49 +1089,22 @@ UA_NodeId *cloneNodeId(UA_NodeId *nodeId)
     VERIFY_NON_NULL_MSG(nodeId, "nodeId param is NULL", NULL);
     UA_NodeId *clone = UA_NodeId_new();
     VERIFY_NON_NULL_MSG(clone, "Memory allocation failed.", NULL);
-    switch(nodeId->identifierType)
+    /* The identifier is released by UA_NodeId_delete(), so open62541 allocates it too */
+    if (UA_NodeId_copy(nodeId, clone) != UA_STATUSCODE_GOOD)
     {
-        case UA_NODEIDTYPE_NUMERIC:
-            *clone = UA_NODEID_NUMERIC(nodeId->namespaceIndex, nodeId->identifier.numeric);
-            break;
-        case UA_NODEIDTYPE_STRING:
-            clone->namespaceIndex = nodeId->namespaceIndex;
-            clone->identifierType = UA_NODEIDTYPE_STRING;
-            clone->identifier.string.length = nodeId->identifier.string.length;
-            clone->identifier.string.data = (UA_Byte *) EdgeMalloc(clone->identifier.string.length);
-            if(IS_NULL(clone->identifier.string.data))
-            {
-                EDGE_LOG(TAG, "Memory allocation failed.");
-                goto CLONE_ERROR;
-            }
-            memcpy(clone->identifier.string.data, nodeId->identifier.string.data, nodeId->identifier.string.length);
-            break;
-        case UA_NODEIDTYPE_GUID:
-            *clone = UA_NODEID_GUID(nodeId->namespaceIndex, nodeId->identifier.guid);
-            break;
-        case UA_NODEIDTYPE_BYTESTRING:
-            clone->namespaceIndex = nodeId->namespaceIndex;
-            clone->identifierType = UA_NODEIDTYPE_BYTESTRING;
-            clone->identifier.byteString.length = nodeId->identifier.byteString.length;
-            clone->identifier.byteString.data = (UA_Byte *) EdgeMalloc(clone->identifier.byteString.length);
-            if(IS_NULL(clone->identifier.byteString.data))
-            {
-                EDGE_LOG(TAG, "Memory allocation failed.");
-                goto CLONE_ERROR;
-            }
-            memcpy(clone->identifier.byteString.data, nodeId->identifier.byteString.data, nodeId->identifier.byteString.length);
-            break;
+        EDGE_LOG(TAG, "Memory allocation failed.");
+        UA_NodeId_delete(clone);
+        return NULL;
     }
     return clone;
-
-CLONE_ERROR:
-    UA_NodeId_delete(clone);
-    return NULL;
 }
 
 void logNodeId(UA_NodeId id)
 {
-#if DEBUG
+    if (!EDGE_LOG_ENABLED(EDGE_LOG_LEVEL_DEBUG))
+    {
+        return;
+    }
     char *str = NULL;
     switch (id.identifierType)
     {
@@ -781,7 +1124,4 @@ void logNodeId(UA_NodeId id)
             break;
     }
     EdgeFree(str);
-#else
-    (void) id;
-#endif
 }
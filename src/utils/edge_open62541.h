@@ -35,6 +35,43 @@ extern "C"
 {
 #endif
 
+/**
+ * @brief Conversion of the values of one built-in type between the stack representation and
+ *        the Edge representation used by requests and responses.
+ */
+typedef struct EdgeTypeConversion
+{
+    /**< Size of a scalar in the Edge representation, of one character for the string types */
+    size_t edgeSize;
+
+    /**< Converts one stack value to a new Edge value, NULL if the value is copied as it is */
+    void *(*toEdge)(const void *uaValue);
+
+    /**< Frees one Edge value made by toEdge, NULL if it is freed by EdgeFree() alone */
+    void (*freeEdge)(void *edgeValue);
+
+    /**< Sets up a stack scalar which refers to the memory of an Edge scalar,
+         NULL if the Edge scalar has the memory layout of the stack type */
+    void (*borrowScalar)(const void *edgeValue, void *uaValue);
+
+    /**< Same as borrowScalar for one pointer-sized element of an Edge array */
+    void (*borrowElement)(const void *edgeElement, void *uaValue);
+} EdgeTypeConversion;
+
+/**
+ * @brief Gets the conversion of a type, shared by the read, write, method and subscription paths.
+ * @param[in]  typeIndex UA_TYPES index of the type.
+ * @return the conversion, NULL for types after UA_TYPES_LOCALIZEDTEXT.
+ */
+const EdgeTypeConversion *getEdgeTypeConversion(int typeIndex);
+
+/**
+ * @brief Gets the UA_TYPES index of a type without searching UA_TYPES.
+ * @param[in]  type Data type.
+ * @return the index, -1 if it is not a type of getEdgeTypeConversion().
+ */
+int getEdgeTypeIndex(const UA_DataType *type);
+
 /**
  * @brief Create scalar variant .
  * @param[in]  type data type.
@@ -54,6 +91,19 @@ UA_StatusCode createScalarVariant(int type, void *data, UA_Variant *out);
  */
 UA_StatusCode createArrayVariant(int type, void *data, int len, UA_Variant *out);
 
+/**
+ * @brief Create a variant which borrows the data instead of copying it.
+ *        The variant does not free the data, which must stay valid while the variant is used.
+ * @param[in]  type data type.
+ * @param[in]  data Scalar or Array Data in the memory layout of the data type.
+ * @param[in]  isArray Whether data is an array.
+ * @param[in]  len  Array Length
+ * @param[out]  out Output variant.
+ * @return GOOD status on success. BADNOTSUPPORTED status if the data has to be converted by
+ *         createScalarVariant() or createArrayVariant().
+ */
+UA_StatusCode createBorrowedVariant(int type, void *data, bool isArray, int len, UA_Variant *out);
+
 /**
  * @brief Converts string of type UA_String to char string.
  * @remarks Allocated memory should be freed by the caller.
@@ -132,9 +182,28 @@ void freeEdgeVersatilityByType(EdgeVersatility *versatileValue, int type);
  */
 bool isNodeClassValid(UA_NodeClass nodeClass);
 
+/**
+ * @brief Applies the buffer and message sizes of an endpoint configuration to the connection
+ *        configuration of a client or server. Sizes which are 0 keep the values of conf.
+ * @param[in,out]  conf Connection configuration.
+ * @param[in]  epConfig Endpoint configuration, can be NULL.
+ * @return @c true if a size was applied, othewise @c false.
+ */
+bool applyTransportConfig(UA_ConnectionConfig *conf, const EdgeEndpointConfig *epConfig);
+
+/**
+ * @brief Copies the endpoint info into a shared, immutable EdgeSharedEndpoint.
+ * @remarks The copy is a single block that starts with one reference. Take more references
+ *          with retainEdgeEndpointInfo() and release them with releaseEdgeEndpointInfo().
+ * @param[in]  endpointInfo Endpoint info to be shared.
+ * @return Shared EdgeEndPointInfo on success. Otherwise null.
+ */
+EdgeEndPointInfo *shareEdgeEndpointInfo(EdgeEndPointInfo *endpointInfo);
+
 /**
  * @brief Clones EdgeMessage object.
  * @remarks Allocated memory should be freed by the caller.
+ *          The clone holds a reference to a shared copy of the endpoint info.
  * @param[in]  msg EdgeMessage object to be cloned.
  * @return Cloned EdgeMessage object on success. Otherwise null.
  */
@@ -150,9 +219,9 @@ EdgeMethodRequestParams* cloneEdgeMethodRequestParams(EdgeMethodRequestParams *m
 
 /**
  * @brief To get the size of the node of a given type.
- * @param[in]  type Type of node.
+ * @param[in]  type Type of node, the UA_TYPES index plus one.
  * @param[in]  isArray Indicates whether size is required for an array or single element.
- * @return Size of the node of a given type.
+ * @return Size of the node of a given type, 0 for an unknown type.
  */
 size_t get_size(int type, bool isArray);
 
@@ -30,12 +30,28 @@
 
 #include <stdio.h>
 #include <stdint.h>
+#include <time.h>
 #include "edge_random.h"
 #include "edge_utils.h"
 #include "edge_logger.h"
 
+#ifndef _WIN32
+#include <pthread.h>
+#else
+#include "pthread.h"
+#endif
+
 #define TAG "edge_random"
 
+#define ID_INCREMENT(ptr) __atomic_add_fetch((ptr), 1, __ATOMIC_RELAXED)
+
+/* Last message id handed out, starts at a random value so that ids differ between runs */
+static uint32_t lastMessageId = 0;
+static pthread_once_t messageIdOnce = PTHREAD_ONCE_INIT;
+
+/* State of the xorshift generator of each thread, 0 until it is seeded */
+static EDGE_THREAD_LOCAL uint32_t fastRandomState = 0;
+
 uint32_t EdgeGetRandom()
 {
     uint32_t result = 0;
@@ -61,3 +77,36 @@ uint32_t EdgeGetRandom()
 #endif
     return result;
 }
+
+static void seedMessageId(void)
+{
+    lastMessageId = EdgeGetRandom();
+}
+
+uint32_t EdgeGetMessageId()
+{
+    pthread_once(&messageIdOnce, seedMessageId);
+    uint32_t id = ID_INCREMENT(&lastMessageId);
+    if (0 == id)
+    {
+        /* 0 is skipped when the counter wraps */
+        id = ID_INCREMENT(&lastMessageId);
+    }
+    return id;
+}
+
+uint32_t EdgeGetFastRandom()
+{
+    uint32_t x = fastRandomState;
+    if (0 == x)
+    {
+        /* Seeded once per thread, the address tells apart threads seeded at the same time */
+        x = EdgeGetRandom() ^ (uint32_t) time(NULL) ^ (uint32_t) (uintptr_t) &fastRandomState;
+        x = (0 == x) ? 0x9E3779B9u : x;
+    }
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    fastRandomState = x;
+    return x;
+}
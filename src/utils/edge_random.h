@@ -35,11 +35,26 @@ extern "C" {
 #endif
 
 /**
- * @brief Generate a uniformly distributed 32-bit random number.
+ * @brief Generate a uniformly distributed 32-bit random number from the system entropy source.
+ *        Opens /dev/urandom on every call, use it only where the value must be unpredictable.
  * @return On success, it returns the random value, otherwise 0.
  */
 uint32_t EdgeGetRandom();
 
+/**
+ * @brief Generate a message id. Ids come from one atomic counter which starts at a random
+ *        value, so no id repeats before 2^32 - 1 more ids are generated. Never 0.
+ * @return the message id.
+ */
+uint32_t EdgeGetMessageId();
+
+/**
+ * @brief Generate a 32-bit pseudo random number without a system call, from a xorshift
+ *        generator per thread seeded once by EdgeGetRandom(). Not for security purposes.
+ * @return the pseudo random value.
+ */
+uint32_t EdgeGetFastRandom();
+
 #ifdef __cplusplus
 }
 #endif
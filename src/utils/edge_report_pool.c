@@ -0,0 +1,172 @@
+/******************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ *
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************/
+
+#include "edge_report_pool.h"
+#include "edge_open62541.h"
+#include "edge_logger.h"
+#include "edge_malloc.h"
+#include "edge_utils.h"
+#include "edge_intern.h"
+
+#include <string.h>
+#include <time.h>
+
+#ifndef _WIN32
+#include <pthread.h>
+#include <sys/time.h>
+#else
+#include "pthread.h"
+#endif
+
+#define TAG "edge_report_pool"
+
+/* All structures of a report in one block, the message comes first */
+typedef struct EdgeReportBlock
+{
+    EdgeMessageBlock message;
+    EdgeResponse *responses[1];
+    EdgeResponse response;
+    EdgeNodeInfo nodeInfo;
+    EdgeVersatility value;
+    union
+    {
+        uint64_t integer;
+        double real;
+        uint8_t bytes[EDGE_REPORT_SCALAR_SIZE];
+    } scalar;
+    struct EdgeReportBlock *next;
+} EdgeReportBlock;
+
+struct EdgeReportPool
+{
+    /* Guards freeList, reports are released on the receive queue thread */
+    pthread_mutex_t mutex;
+    /* Shared endpoint, every report holds a reference */
+    EdgeEndPointInfo *endpointInfo;
+    /* Released reports */
+    EdgeReportBlock *freeList;
+    /* Number of released reports */
+    size_t freeCount;
+};
+
+EdgeReportPool *createEdgeReportPool(EdgeEndPointInfo *endpointInfo)
+{
+    VERIFY_NON_NULL_MSG(endpointInfo, "NULL endpointInfo param in createEdgeReportPool\n", NULL);
+    EdgeReportPool *pool = (EdgeReportPool *) EdgeCalloc(1, sizeof(EdgeReportPool));
+    VERIFY_NON_NULL_MSG(pool, "EdgeCalloc FAILED for report pool\n", NULL);
+
+    pool->endpointInfo = shareEdgeEndpointInfo(endpointInfo);
+    if (IS_NULL(pool->endpointInfo))
+    {
+        EDGE_LOG(TAG, "Failed to share the endpoint of the report pool.");
+        EdgeFree(pool);
+        return NULL;
+    }
+    pthread_mutex_init(&pool->mutex, NULL);
+    return pool;
+}
+
+EdgeMessage *acquireEdgeReport(EdgeReportPool *pool, const char *valueAlias)
+{
+    VERIFY_NON_NULL_MSG(pool, "NULL pool param in acquireEdgeReport\n", NULL);
+    VERIFY_NON_NULL_MSG(valueAlias, "NULL valueAlias param in acquireEdgeReport\n", NULL);
+
+    pthread_mutex_lock(&pool->mutex);
+    EdgeReportBlock *block = pool->freeList;
+    if (block)
+    {
+        pool->freeList = block->next;
+        pool->freeCount--;
+    }
+    pthread_mutex_unlock(&pool->mutex);
+
+    if (IS_NULL(block))
+    {
+        block = (EdgeReportBlock *) EdgeMalloc(sizeof(EdgeReportBlock));
+        VERIFY_NON_NULL_MSG(block, "EdgeMalloc FAILED for report block\n", NULL);
+        /* Recycled blocks stay registered until they leave the pool */
+        if (!registerEdgeMessageBlock(&block->message))
+        {
+            EDGE_LOG(TAG, "Failed to register the report block.");
+            EdgeFree(block);
+            return NULL;
+        }
+    }
+    memset(block, 0, sizeof(EdgeReportBlock));
+    block->nodeInfo.valueAlias = (char *) retainEdgeString(valueAlias);
+
+    EdgeMessage *report = &block->message.msg;
+    block->message.pool = pool;
+    report->type = REPORT;
+    setMessageEndpointInfo(report, retainEdgeEndpointInfo(pool->endpointInfo));
+    report->responseLength = 1;
+    report->responses = block->responses;
+    block->responses[0] = &block->response;
+    block->response.nodeInfo = &block->nodeInfo;
+
+    setEdgeTimeInfo(&report->serverTime);
+    return report;
+}
+
+bool setEdgeReportScalar(EdgeMessage *report, int type, const void *data, size_t size)
+{
+    VERIFY_NON_NULL_MSG(report, "NULL report param in setEdgeReportScalar\n", false);
+    VERIFY_NON_NULL_MSG(data, "NULL data param in setEdgeReportScalar\n", false);
+    COND_CHECK((size > EDGE_REPORT_SCALAR_SIZE), false);
+
+    EdgeReportBlock *block = (EdgeReportBlock *) report;
+    memcpy(block->scalar.bytes, data, size);
+    block->value.value = block->scalar.bytes;
+    block->value.isArray = false;
+    block->value.arrayLength = 0;
+    block->response.type = type;
+    block->response.message = &block->value;
+    return true;
+}
+
+void releaseEdgeReport(EdgeMessage *report)
+{
+    VERIFY_NON_NULL_NR_MSG(report, "NULL report param in releaseEdgeReport\n");
+    EdgeReportBlock *block = (EdgeReportBlock *) report;
+    EdgeReportPool *pool = (EdgeReportPool *) block->message.pool;
+
+    if (block->response.message && block->response.message != &block->value)
+    {
+        freeEdgeVersatilityByType(block->response.message, block->response.type);
+    }
+    releaseEdgeString(block->nodeInfo.valueAlias);
+    releaseEdgeEndpointInfo(block->message.sharedEndpoint);
+
+    pthread_mutex_lock(&pool->mutex);
+    if (pool->freeCount < EDGE_REPORT_POOL_SIZE)
+    {
+        block->next = pool->freeList;
+        pool->freeList = block;
+        pool->freeCount++;
+        block = NULL;
+    }
+    pthread_mutex_unlock(&pool->mutex);
+
+    if (IS_NOT_NULL(block))
+    {
+        unregisterEdgeMessageBlock(&block->message);
+        EdgeFree(block);
+    }
+}
@@ -0,0 +1,87 @@
+/******************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ *
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************/
+
+/**
+ * @file edge_report_pool.h
+ * @brief This file contains a pool which recycles the REPORT messages of a client session.
+ */
+
+#ifndef EDGE_REPORT_POOL_H
+#define EDGE_REPORT_POOL_H
+
+#include "opcua_common.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Maximum number of released reports kept for reuse, more are freed.
+ */
+#define EDGE_REPORT_POOL_SIZE (64)
+
+/**
+ * @brief Largest scalar value kept inside a report.
+ */
+#define EDGE_REPORT_SCALAR_SIZE (8)
+
+typedef struct EdgeReportPool EdgeReportPool;
+
+/**
+ * @brief Creates the report pool of a client session.
+ * @param[in]  endpointInfo Endpoint of the session, cloned once and shared by all reports.
+ * @return pool on success, otherwise NULL
+ * @remarks The pool lives as long as the session subscriptions, it is not destroyed.
+ */
+EdgeReportPool *createEdgeReportPool(EdgeEndPointInfo *endpointInfo);
+
+/**
+ * @brief Takes a REPORT message with one response from the pool.
+ * @param[in]  pool Report pool.
+ * @param[in]  valueAlias Interned value alias of the monitored item, see internEdgeString().
+ *                        The report holds a reference to it.
+ * @return message stamped with the current server time, NULL on allocation failure
+ * @remarks responses[0]->message is NULL, it is filled by setEdgeReportScalar() or
+ *          with a heap EdgeVersatility which is freed on release. The message goes
+ *          back to the pool when it is passed to freeEdgeMessage().
+ */
+EdgeMessage *acquireEdgeReport(EdgeReportPool *pool, const char *valueAlias);
+
+/**
+ * @brief Stores a scalar value inside the report.
+ * @param[in]  report Message from acquireEdgeReport().
+ * @param[in]  type Value type, stored in responses[0]->type.
+ * @param[in]  data Scalar data.
+ * @param[in]  size Size of the data in bytes.
+ * @return @c true on success, @c false if the value does not fit into EDGE_REPORT_SCALAR_SIZE
+ */
+bool setEdgeReportScalar(EdgeMessage *report, int type, const void *data, size_t size);
+
+/**
+ * @brief Returns the report to its pool. Called by freeEdgeMessage().
+ * @param[in]  report Message from acquireEdgeReport().
+ */
+void releaseEdgeReport(EdgeMessage *report);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif      // EDGE_REPORT_POOL_H
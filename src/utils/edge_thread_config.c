@@ -0,0 +1,154 @@
+/******************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ *
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************/
+
+
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+
+#include <stdio.h>
+#include <string.h>
+#include "edge_thread_config.h"
+#include "edge_utils.h"
+#include "edge_malloc.h"
+#include "edge_logger.h"
+
+#ifndef _WIN32
+#include <pthread.h>
+#include <sched.h>
+#else
+#include "pthread.h"
+#endif
+
+#define TAG "edge_thread_config"
+
+/* Characters of a configured name, the rest of the 15 is left for the number */
+#define THREAD_NAME_LENGTH (11)
+
+static const char *defaultNames[EDGE_THREAD_CLASSES] =
+{
+    "edge-disp", "edge-server", "edge-sub", "edge-helper"
+};
+
+static EdgeThreadConfig threadConfigs[EDGE_THREAD_CLASSES];
+static char threadNames[EDGE_THREAD_CLASSES][THREAD_NAME_LENGTH + 1];
+/* Threads of each class started so far, they are numbered by it */
+static uint32_t threadCounts[EDGE_THREAD_CLASSES];
+static pthread_mutex_t threadConfigMutex = PTHREAD_MUTEX_INITIALIZER;
+
+void setEdgeThreadConfig(const EdgeThreadConfig *configs)
+{
+    pthread_mutex_lock(&threadConfigMutex);
+    for (int i = 0; i < EDGE_THREAD_CLASSES; i++)
+    {
+        if (IS_NULL(configs))
+        {
+            memset(&threadConfigs[i], 0, sizeof(EdgeThreadConfig));
+            threadNames[i][0] = '\0';
+            continue;
+        }
+        threadConfigs[i] = configs[i];
+        /* The name of the configuration may not outlive it */
+        threadNames[i][0] = '\0';
+        if (IS_NOT_NULL(configs[i].name))
+        {
+            strncpy(threadNames[i], configs[i].name, THREAD_NAME_LENGTH);
+            threadNames[i][THREAD_NAME_LENGTH] = '\0';
+        }
+        threadConfigs[i].name = NULL;
+    }
+    pthread_mutex_unlock(&threadConfigMutex);
+}
+
+#ifndef _WIN32
+static int getSchedPolicy(EdgeSchedPolicy policy)
+{
+    switch (policy)
+    {
+        case EDGE_SCHED_FIFO:
+            return SCHED_FIFO;
+        case EDGE_SCHED_RR:
+            return SCHED_RR;
+        default:
+            return SCHED_OTHER;
+    }
+}
+#endif
+
+void applyEdgeThreadConfig(EdgeThreadClass threadClass)
+{
+    COND_CHECK_NR_MSG(((int) threadClass < 0 || threadClass >= EDGE_THREAD_CLASSES),
+            "Invalid thread class in applyEdgeThreadConfig\n");
+
+    pthread_mutex_lock(&threadConfigMutex);
+    EdgeThreadConfig config = threadConfigs[threadClass];
+    char name[16];
+    snprintf(name, sizeof(name), "%s-%u", ('\0' != threadNames[threadClass][0]) ?
+            threadNames[threadClass] : defaultNames[threadClass], ++threadCounts[threadClass] % 1000);
+    pthread_mutex_unlock(&threadConfigMutex);
+
+#if defined(__linux__)
+    /* Names are limited to 15 characters */
+    int ret = pthread_setname_np(pthread_self(), name);
+    if (0 != ret)
+    {
+        EDGE_LOG_V(TAG, "Failed to name the thread %s (%d)\n", name, ret);
+    }
+
+    if (0 != config.cpuMask)
+    {
+        cpu_set_t cpus;
+        CPU_ZERO(&cpus);
+        for (int cpu = 0; cpu < 64 && cpu < CPU_SETSIZE; cpu++)
+        {
+            if (config.cpuMask & ((uint64_t) 1 << cpu))
+            {
+                CPU_SET(cpu, &cpus);
+            }
+        }
+        ret = pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus);
+        if (0 != ret)
+        {
+            EDGE_LOG_V(TAG, "Failed to set the CPU affinity of thread %s (%d)\n", name, ret);
+        }
+    }
+#else
+    (void) name;
+#endif
+
+#ifndef _WIN32
+    if (EDGE_SCHED_DEFAULT != config.schedPolicy)
+    {
+        struct sched_param param;
+        memset(&param, 0, sizeof(param));
+        param.sched_priority = config.schedPriority;
+        int err = pthread_setschedparam(pthread_self(), getSchedPolicy(config.schedPolicy), &param);
+        if (0 != err)
+        {
+            EDGE_LOG_V(TAG, "Failed to set the scheduling of thread %s (%d)\n", name, err);
+        }
+    }
+#endif
+}
+
+void startEdgeThreadWorker(void *threadClass)
+{
+    applyEdgeThreadConfig((EdgeThreadClass) (intptr_t) threadClass);
+}
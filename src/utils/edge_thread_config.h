@@ -0,0 +1,65 @@
+/******************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ *
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************/
+
+
+/**
+ * @file edge_thread_config.h
+ * @brief This file contains the attributes of the threads of the library, like their
+ *        CPU affinity, scheduling and names.
+ */
+
+#ifndef EDGE_THREAD_CONFIG_H
+#define EDGE_THREAD_CONFIG_H
+
+#include "opcua_interface.h"
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Sets the attributes of the thread classes, they are copied.
+ *        Threads started later apply them.
+ * @param[in]  configs Attributes of each thread class, indexed by EdgeThreadClass.
+ *             NULL restores the defaults.
+ */
+void setEdgeThreadConfig(const EdgeThreadConfig *configs);
+
+/**
+ * @brief Applies the attributes of a thread class to the calling thread.
+ *        Called by every thread of the library when it starts.
+ * @param[in]  threadClass Class of the calling thread.
+ */
+void applyEdgeThreadConfig(EdgeThreadClass threadClass);
+
+/**
+ * @brief Start routine of the workers of a thread pool, see ca_thread_pool_set_start_routine().
+ * @param[in]  threadClass EdgeThreadClass of the workers, cast to a pointer.
+ */
+void startEdgeThreadWorker(void *threadClass);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif      // EDGE_THREAD_CONFIG_H
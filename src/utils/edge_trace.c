@@ -0,0 +1,83 @@
+/******************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ *
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************/
+
+
+#include "edge_trace.h"
+#include "octhread.h"
+
+#include <string.h>
+
+#ifndef _WIN32
+#include <pthread.h>
+#else
+#include "pthread.h"
+#endif
+
+#define STORE_RELEASE(ptr, val) __atomic_store_n((ptr), (val), __ATOMIC_RELEASE)
+
+int g_edgeTraceEnabled = 0;
+
+/* Guards the hooks against concurrent edgeTraceSetHooks() calls, the stages read them
+ * without the lock */
+static pthread_mutex_t hooksMutex = PTHREAD_MUTEX_INITIALIZER;
+static EdgeTraceHooks traceHooks;
+
+static void callHook(EdgeTraceCallback hook, const EdgeMessage *msg, EdgeTraceStage stage)
+{
+    if (NULL == hook || NULL == msg)
+    {
+        return;
+    }
+    EdgeTraceEvent event;
+    event.messageId = msg->message_id;
+    event.command = msg->command;
+    event.type = msg->type;
+    event.endpointUri = (NULL != msg->endpointInfo) ? msg->endpointInfo->endpointUri : NULL;
+    event.stage = stage;
+    event.monotonicTime = oc_get_time_us();
+    hook(&event, traceHooks.context);
+}
+
+void edgeTraceBegin(const EdgeMessage *msg, EdgeTraceStage stage)
+{
+    callHook(traceHooks.begin, msg, stage);
+}
+
+void edgeTraceEnd(const EdgeMessage *msg, EdgeTraceStage stage)
+{
+    callHook(traceHooks.end, msg, stage);
+}
+
+void edgeTraceSetHooks(const EdgeTraceHooks *hooks)
+{
+    pthread_mutex_lock(&hooksMutex);
+    /* Stages which check the flag from now on do not call the hooks which are replaced */
+    STORE_RELEASE(&g_edgeTraceEnabled, 0);
+    if (NULL != hooks && (NULL != hooks->begin || NULL != hooks->end))
+    {
+        traceHooks = *hooks;
+        STORE_RELEASE(&g_edgeTraceEnabled, 1);
+    }
+    else
+    {
+        memset(&traceHooks, 0, sizeof(traceHooks));
+    }
+    pthread_mutex_unlock(&hooksMutex);
+}
@@ -0,0 +1,83 @@
+/******************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ *
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************/
+
+
+/**
+ * @file edge_trace.h
+ * @brief This file contains the request tracing hooks.
+ *
+ * Each stage of a request calls the begin hook of the application when it starts and the end
+ * hook when it is done. Tracing is disabled until hooks are set, then a stage costs the check
+ * of one flag.
+ */
+
+#ifndef EDGE_TRACE_H_
+#define EDGE_TRACE_H_
+
+#include "opcua_common.h"
+
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/** Whether hooks are set, see edgeTraceSetHooks(). */
+extern int g_edgeTraceEnabled;
+
+/**
+ * @brief Calls the begin hook for a stage of a message. Use EDGE_TRACE_BEGIN(), it skips the
+ *        call when tracing is disabled.
+ * @param[in]  msg Message which enters the stage
+ * @param[in]  stage Stage
+ */
+void edgeTraceBegin(const EdgeMessage *msg, EdgeTraceStage stage);
+
+/**
+ * @brief Calls the end hook for a stage of a message. Use EDGE_TRACE_END(), it skips the
+ *        call when tracing is disabled.
+ * @param[in]  msg Message which leaves the stage
+ * @param[in]  stage Stage
+ */
+void edgeTraceEnd(const EdgeMessage *msg, EdgeTraceStage stage);
+
+/**
+ * @brief Sets the hooks of the application
+ * @param[in]  hooks Hooks, copied, NULL disables tracing
+ */
+void edgeTraceSetHooks(const EdgeTraceHooks *hooks);
+
+/** Whether the stages are traced.*/
+#define EDGE_TRACE_ENABLED() (0 != g_edgeTraceEnabled)
+
+/** Trace the begin of a stage of a message.*/
+#define EDGE_TRACE_BEGIN(msg, stage) do { if (EDGE_TRACE_ENABLED()) { \
+            edgeTraceBegin((msg), (stage)); } } while (0)
+
+/** Trace the end of a stage of a message.*/
+#define EDGE_TRACE_END(msg, stage) do { if (EDGE_TRACE_ENABLED()) { \
+            edgeTraceEnd((msg), (stage)); } } while (0)
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* EDGE_TRACE_H_ */
@@ -0,0 +1,649 @@
+/******************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ *
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************/
+
+
+#include "edge_uadp.h"
+
+#include <string.h>
+
+/* NetworkMessage header, UADPFlags */
+#define UADP_VERSION (0x01)
+#define UADP_VERSION_MASK (0x0F)
+#define UADP_PUBLISHER_ID_ENABLED (0x10)
+#define UADP_GROUP_HEADER_ENABLED (0x20)
+#define UADP_PAYLOAD_HEADER_ENABLED (0x40)
+#define UADP_EXTENDED_FLAGS1_ENABLED (0x80)
+
+/* ExtendedFlags1 */
+#define UADP_PUBLISHER_ID_TYPE_MASK (0x07)
+#define UADP_PUBLISHER_ID_UINT16 (0x01)
+#define UADP_PUBLISHER_ID_UINT64 (0x03)
+#define UADP_DATASET_CLASS_ID_ENABLED (0x08)
+#define UADP_SECURITY_ENABLED (0x10)
+#define UADP_TIMESTAMP_ENABLED (0x20)
+#define UADP_PICOSECONDS_ENABLED (0x40)
+#define UADP_EXTENDED_FLAGS2_ENABLED (0x80)
+
+/* GroupFlags */
+#define UADP_WRITER_GROUP_ID_ENABLED (0x01)
+#define UADP_GROUP_VERSION_ENABLED (0x02)
+#define UADP_NETWORK_MESSAGE_NUMBER_ENABLED (0x04)
+#define UADP_SEQUENCE_NUMBER_ENABLED (0x08)
+
+/* DataSetFlags1 */
+#define UADP_DATASET_VALID (0x01)
+#define UADP_FIELD_ENCODING_MASK (0x06)
+#define UADP_DATASET_SEQUENCE_NUMBER_ENABLED (0x08)
+#define UADP_DATASET_STATUS_ENABLED (0x10)
+#define UADP_CONFIG_VERSION_MAJOR_ENABLED (0x20)
+#define UADP_CONFIG_VERSION_MINOR_ENABLED (0x40)
+#define UADP_DATASET_FLAGS2_ENABLED (0x80)
+
+/* DataSetFlags2 */
+#define UADP_MESSAGE_TYPE_MASK (0x0F)
+#define UADP_MESSAGE_TYPE_KEY_FRAME (0x00)
+#define UADP_MESSAGE_TYPE_KEEP_ALIVE (0x03)
+#define UADP_DATASET_TIMESTAMP_ENABLED (0x10)
+#define UADP_DATASET_PICOSECONDS_ENABLED (0x20)
+
+/* Variant encoding mask */
+#define VARIANT_TYPE_MASK (0x3F)
+#define VARIANT_DIMENSIONS_ENCODED (0x40)
+#define VARIANT_ARRAY_ENCODED (0x80)
+
+/* Built-in type ids of the types a field may have */
+#define BUILTIN_BOOLEAN (1)
+#define BUILTIN_STRING (12)
+#define BUILTIN_BYTESTRING (15)
+
+typedef struct UadpCursor
+{
+    uint8_t *pos;
+    const uint8_t *end;
+} UadpCursor;
+
+typedef struct FieldType
+{
+    uint8_t builtinId;
+    UA_UInt16 typeIndex;
+} FieldType;
+
+static const FieldType fieldTypes[] =
+{
+    { 1, UA_TYPES_BOOLEAN },
+    { 2, UA_TYPES_SBYTE },
+    { 3, UA_TYPES_BYTE },
+    { 4, UA_TYPES_INT16 },
+    { 5, UA_TYPES_UINT16 },
+    { 6, UA_TYPES_INT32 },
+    { 7, UA_TYPES_UINT32 },
+    { 8, UA_TYPES_INT64 },
+    { 9, UA_TYPES_UINT64 },
+    { 10, UA_TYPES_FLOAT },
+    { 11, UA_TYPES_DOUBLE },
+    { 12, UA_TYPES_STRING },
+    { 13, UA_TYPES_DATETIME },
+    { 15, UA_TYPES_BYTESTRING }
+};
+
+#define FIELD_TYPE_COUNT (sizeof(fieldTypes) / sizeof(fieldTypes[0]))
+
+static const FieldType *getFieldTypeByType(const UA_DataType *type)
+{
+    for (size_t i = 0; i < FIELD_TYPE_COUNT; i++)
+    {
+        if (type == &UA_TYPES[fieldTypes[i].typeIndex])
+        {
+            return &fieldTypes[i];
+        }
+    }
+    return NULL;
+}
+
+static const FieldType *getFieldTypeById(uint8_t builtinId)
+{
+    for (size_t i = 0; i < FIELD_TYPE_COUNT; i++)
+    {
+        if (builtinId == fieldTypes[i].builtinId)
+        {
+            return &fieldTypes[i];
+        }
+    }
+    return NULL;
+}
+
+static bool isStringType(uint8_t builtinId)
+{
+    return BUILTIN_STRING == builtinId || BUILTIN_BYTESTRING == builtinId;
+}
+
+/* Writes an unsigned integer of size bytes in little endian order */
+static bool writeUInt(UadpCursor *cursor, uint64_t value, size_t size)
+{
+    if ((size_t) (cursor->end - cursor->pos) < size)
+    {
+        return false;
+    }
+    for (size_t i = 0; i < size; i++)
+    {
+        *cursor->pos++ = (uint8_t) (value >> (8 * i));
+    }
+    return true;
+}
+
+static bool readUInt(UadpCursor *cursor, size_t size, uint64_t *value)
+{
+    if ((size_t) (cursor->end - cursor->pos) < size)
+    {
+        return false;
+    }
+    *value = 0;
+    for (size_t i = 0; i < size; i++)
+    {
+        *value |= ((uint64_t) *cursor->pos++) << (8 * i);
+    }
+    return true;
+}
+
+static bool skipBytes(UadpCursor *cursor, size_t size)
+{
+    if ((size_t) (cursor->end - cursor->pos) < size)
+    {
+        return false;
+    }
+    cursor->pos += size;
+    return true;
+}
+
+/* Numbers of 1, 2, 4 and 8 bytes, floats are written with the bits of their integer size */
+static bool writeNumber(UadpCursor *cursor, const void *value, size_t size)
+{
+    uint8_t u8;
+    uint16_t u16;
+    uint32_t u32;
+    uint64_t u64;
+    switch (size)
+    {
+        case 1:
+            memcpy(&u8, value, size);
+            return writeUInt(cursor, u8, size);
+        case 2:
+            memcpy(&u16, value, size);
+            return writeUInt(cursor, u16, size);
+        case 4:
+            memcpy(&u32, value, size);
+            return writeUInt(cursor, u32, size);
+        case 8:
+            memcpy(&u64, value, size);
+            return writeUInt(cursor, u64, size);
+        default:
+            return false;
+    }
+}
+
+static bool readNumber(UadpCursor *cursor, void *value, size_t size)
+{
+    uint64_t raw = 0;
+    if (!readUInt(cursor, size, &raw))
+    {
+        return false;
+    }
+    uint8_t u8 = (uint8_t) raw;
+    uint16_t u16 = (uint16_t) raw;
+    uint32_t u32 = (uint32_t) raw;
+    switch (size)
+    {
+        case 1:
+            memcpy(value, &u8, size);
+            return true;
+        case 2:
+            memcpy(value, &u16, size);
+            return true;
+        case 4:
+            memcpy(value, &u32, size);
+            return true;
+        case 8:
+            memcpy(value, &raw, size);
+            return true;
+        default:
+            return false;
+    }
+}
+
+static bool writeValue(UadpCursor *cursor, uint8_t builtinId, const UA_DataType *type,
+        const void *value)
+{
+    if (!isStringType(builtinId))
+    {
+        return writeNumber(cursor, value, type->memSize);
+    }
+    /* A null String has the length -1 */
+    const UA_String *string = (const UA_String *) value;
+    int32_t length = (NULL == string->data) ? -1 : (int32_t) string->length;
+    if (!writeUInt(cursor, (uint32_t) length, 4))
+    {
+        return false;
+    }
+    if (length <= 0)
+    {
+        return true;
+    }
+    if ((size_t) (cursor->end - cursor->pos) < string->length)
+    {
+        return false;
+    }
+    memcpy(cursor->pos, string->data, string->length);
+    cursor->pos += string->length;
+    return true;
+}
+
+static bool readValue(UadpCursor *cursor, uint8_t builtinId, const UA_DataType *type, void *value)
+{
+    if (!isStringType(builtinId))
+    {
+        return readNumber(cursor, value, type->memSize);
+    }
+    uint64_t raw = 0;
+    if (!readUInt(cursor, 4, &raw))
+    {
+        return false;
+    }
+    int32_t length = (int32_t) (uint32_t) raw;
+    UA_String *string = (UA_String *) value;
+    if (length <= 0)
+    {
+        /* An empty String is not null */
+        string->data = (0 == length) ? (UA_Byte *) UA_EMPTY_ARRAY_SENTINEL : NULL;
+        return true;
+    }
+    if ((size_t) (cursor->end - cursor->pos) < (size_t) length)
+    {
+        return false;
+    }
+    string->data = (UA_Byte *) UA_malloc((size_t) length);
+    if (NULL == string->data)
+    {
+        return false;
+    }
+    memcpy(string->data, cursor->pos, (size_t) length);
+    string->length = (size_t) length;
+    cursor->pos += length;
+    return true;
+}
+
+static bool writeVariant(UadpCursor *cursor, const UA_Variant *field)
+{
+    const FieldType *fieldType = (NULL == field->type) ? NULL : getFieldTypeByType(field->type);
+    if (NULL == fieldType)
+    {
+        return writeUInt(cursor, 0, 1);
+    }
+    bool isArray = !UA_Variant_isScalar(field);
+    uint8_t mask = fieldType->builtinId | (isArray ? VARIANT_ARRAY_ENCODED : 0);
+    if (!writeUInt(cursor, mask, 1))
+    {
+        return false;
+    }
+    if (!isArray)
+    {
+        return writeValue(cursor, fieldType->builtinId, field->type, field->data);
+    }
+    if (!writeUInt(cursor, (uint32_t) field->arrayLength, 4))
+    {
+        return false;
+    }
+    const uint8_t *element = (const uint8_t *) field->data;
+    for (size_t i = 0; i < field->arrayLength; i++, element += field->type->memSize)
+    {
+        if (!writeValue(cursor, fieldType->builtinId, field->type, element))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool readVariant(UadpCursor *cursor, UA_Variant *field)
+{
+    uint64_t mask = 0;
+    if (!readUInt(cursor, 1, &mask))
+    {
+        return false;
+    }
+    if (0 == mask)
+    {
+        return true;
+    }
+    const FieldType *fieldType = getFieldTypeById((uint8_t) (mask & VARIANT_TYPE_MASK));
+    if (NULL == fieldType || (mask & VARIANT_DIMENSIONS_ENCODED))
+    {
+        return false;
+    }
+    const UA_DataType *type = &UA_TYPES[fieldType->typeIndex];
+    if (!(mask & VARIANT_ARRAY_ENCODED))
+    {
+        void *value = UA_new(type);
+        if (NULL == value)
+        {
+            return false;
+        }
+        UA_Variant_setScalar(field, value, type);
+        return readValue(cursor, fieldType->builtinId, type, value);
+    }
+
+    uint64_t raw = 0;
+    if (!readUInt(cursor, 4, &raw))
+    {
+        return false;
+    }
+    int32_t length = (int32_t) (uint32_t) raw;
+    size_t count = (length < 0) ? 0 : (size_t) length;
+    /* Each element takes at least one byte, which bounds the allocation by the message */
+    size_t minSize = isStringType(fieldType->builtinId) ? 4 : type->memSize;
+    if (count > (size_t) (cursor->end - cursor->pos) / minSize)
+    {
+        return false;
+    }
+    void *values = UA_Array_new(count, type);
+    if (NULL == values)
+    {
+        return false;
+    }
+    UA_Variant_setArray(field, values, count, type);
+    uint8_t *element = (uint8_t *) values;
+    for (size_t i = 0; i < count; i++, element += type->memSize)
+    {
+        if (!readValue(cursor, fieldType->builtinId, type, element))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+size_t encodeUadpMessage(const EdgeUadpHeader *header, const UA_Variant *fields, size_t fieldCount,
+        uint8_t *buffer, size_t size)
+{
+    if (NULL == header || (NULL == fields && fieldCount > 0) || NULL == buffer
+            || fieldCount > UINT16_MAX)
+    {
+        return 0;
+    }
+    UadpCursor cursor = { buffer, buffer + size };
+    bool encoded = writeUInt(&cursor, UADP_VERSION | UADP_PUBLISHER_ID_ENABLED
+                    | UADP_GROUP_HEADER_ENABLED | UADP_PAYLOAD_HEADER_ENABLED
+                    | UADP_EXTENDED_FLAGS1_ENABLED, 1)
+            && writeUInt(&cursor, UADP_PUBLISHER_ID_UINT16 | UADP_TIMESTAMP_ENABLED, 1)
+            && writeUInt(&cursor, (uint16_t) header->publisherId, 2)
+            /* Group header */
+            && writeUInt(&cursor, UADP_WRITER_GROUP_ID_ENABLED | UADP_SEQUENCE_NUMBER_ENABLED, 1)
+            && writeUInt(&cursor, header->writerGroupId, 2)
+            && writeUInt(&cursor, header->sequenceNumber, 2)
+            /* Payload header of one DataSetMessage */
+            && writeUInt(&cursor, 1, 1)
+            && writeUInt(&cursor, header->dataSetWriterId, 2)
+            && writeUInt(&cursor, (uint64_t) header->timestamp, 8)
+            /* DataSetMessage header of a key frame with Variant fields */
+            && writeUInt(&cursor, UADP_DATASET_VALID | UADP_DATASET_SEQUENCE_NUMBER_ENABLED
+                    | UADP_DATASET_FLAGS2_ENABLED, 1)
+            && writeUInt(&cursor, UADP_MESSAGE_TYPE_KEY_FRAME | UADP_DATASET_TIMESTAMP_ENABLED, 1)
+            && writeUInt(&cursor, header->sequenceNumber, 2)
+            && writeUInt(&cursor, (uint64_t) header->timestamp, 8)
+            && writeUInt(&cursor, fieldCount, 2);
+    for (size_t i = 0; encoded && i < fieldCount; i++)
+    {
+        encoded = writeVariant(&cursor, &fields[i]);
+    }
+    return encoded ? (size_t) (cursor.pos - buffer) : 0;
+}
+
+/**
+ * @brief decodeNetworkHeader - Decodes the headers of a NetworkMessage up to its payload
+ * @param cursor - Cursor at the start of the message
+ * @param header - Receives the headers
+ * @return GOOD status on success, otherwise an error status
+ */
+static UA_StatusCode decodeNetworkHeader(UadpCursor *cursor, EdgeUadpHeader *header)
+{
+    uint64_t flags = 0, extendedFlags1 = 0, extendedFlags2 = 0, value = 0;
+    if (!readUInt(cursor, 1, &flags))
+    {
+        return UA_STATUSCODE_BADDECODINGERROR;
+    }
+    if (UADP_VERSION != (flags & UADP_VERSION_MASK))
+    {
+        return UA_STATUSCODE_BADNOTSUPPORTED;
+    }
+    if ((flags & UADP_EXTENDED_FLAGS1_ENABLED) && !readUInt(cursor, 1, &extendedFlags1))
+    {
+        return UA_STATUSCODE_BADDECODINGERROR;
+    }
+    if ((extendedFlags1 & UADP_EXTENDED_FLAGS2_ENABLED) && !readUInt(cursor, 1, &extendedFlags2))
+    {
+        return UA_STATUSCODE_BADDECODINGERROR;
+    }
+    /* Chunks, promoted fields, discovery messages and security are not supported */
+    if (0 != extendedFlags2 || (extendedFlags1 & UADP_SECURITY_ENABLED))
+    {
+        return UA_STATUSCODE_BADNOTSUPPORTED;
+    }
+    if (flags & UADP_PUBLISHER_ID_ENABLED)
+    {
+        uint64_t idType = extendedFlags1 & UADP_PUBLISHER_ID_TYPE_MASK;
+        if (idType > UADP_PUBLISHER_ID_UINT64)
+        {
+            return UA_STATUSCODE_BADNOTSUPPORTED;
+        }
+        if (!readUInt(cursor, (size_t) 1 << idType, &header->publisherId))
+        {
+            return UA_STATUSCODE_BADDECODINGERROR;
+        }
+    }
+    if ((extendedFlags1 & UADP_DATASET_CLASS_ID_ENABLED) && !skipBytes(cursor, 16))
+    {
+        return UA_STATUSCODE_BADDECODINGERROR;
+    }
+    if (flags & UADP_GROUP_HEADER_ENABLED)
+    {
+        uint64_t groupFlags = 0;
+        bool decoded = readUInt(cursor, 1, &groupFlags);
+        if (decoded && (groupFlags & UADP_WRITER_GROUP_ID_ENABLED))
+        {
+            decoded = readUInt(cursor, 2, &value);
+            header->writerGroupId = (uint16_t) value;
+        }
+        if (decoded && (groupFlags & UADP_GROUP_VERSION_ENABLED))
+        {
+            decoded = skipBytes(cursor, 4);
+        }
+        if (decoded && (groupFlags & UADP_NETWORK_MESSAGE_NUMBER_ENABLED))
+        {
+            decoded = skipBytes(cursor, 2);
+        }
+        if (decoded && (groupFlags & UADP_SEQUENCE_NUMBER_ENABLED))
+        {
+            decoded = readUInt(cursor, 2, &value);
+            header->sequenceNumber = (uint16_t) value;
+        }
+        if (!decoded)
+        {
+            return UA_STATUSCODE_BADDECODINGERROR;
+        }
+    }
+    if (flags & UADP_PAYLOAD_HEADER_ENABLED)
+    {
+        if (!readUInt(cursor, 1, &value))
+        {
+            return UA_STATUSCODE_BADDECODINGERROR;
+        }
+        if (1 != value)
+        {
+            return UA_STATUSCODE_BADNOTSUPPORTED;
+        }
+        if (!readUInt(cursor, 2, &value))
+        {
+            return UA_STATUSCODE_BADDECODINGERROR;
+        }
+        header->dataSetWriterId = (uint16_t) value;
+    }
+    if (extendedFlags1 & UADP_TIMESTAMP_ENABLED)
+    {
+        if (!readUInt(cursor, 8, &value))
+        {
+            return UA_STATUSCODE_BADDECODINGERROR;
+        }
+        header->timestamp = (int64_t) value;
+    }
+    if ((extendedFlags1 & UADP_PICOSECONDS_ENABLED) && !skipBytes(cursor, 2))
+    {
+        return UA_STATUSCODE_BADDECODINGERROR;
+    }
+    return UA_STATUSCODE_GOOD;
+}
+
+UA_StatusCode decodeUadpMessage(const uint8_t *buffer, size_t length, EdgeUadpHeader *header,
+        UA_Variant *fields, size_t fieldCapacity, size_t *fieldCount)
+{
+    if (NULL == buffer || NULL == header || (NULL == fields && fieldCapacity > 0)
+            || NULL == fieldCount)
+    {
+        return UA_STATUSCODE_BADINVALIDARGUMENT;
+    }
+    memset(header, 0, sizeof(EdgeUadpHeader));
+    *fieldCount = 0;
+    UadpCursor cursor = { (uint8_t *) buffer, buffer + length };
+    UA_StatusCode ret = decodeNetworkHeader(&cursor, header);
+    if (UA_STATUSCODE_GOOD != ret)
+    {
+        return ret;
+    }
+
+    uint64_t flags1 = 0, flags2 = 0, value = 0;
+    if (!readUInt(&cursor, 1, &flags1))
+    {
+        return UA_STATUSCODE_BADDECODINGERROR;
+    }
+    if ((flags1 & UADP_DATASET_FLAGS2_ENABLED) && !readUInt(&cursor, 1, &flags2))
+    {
+        return UA_STATUSCODE_BADDECODINGERROR;
+    }
+    uint64_t messageType = flags2 & UADP_MESSAGE_TYPE_MASK;
+    if (!(flags1 & UADP_DATASET_VALID) || UADP_MESSAGE_TYPE_KEEP_ALIVE == messageType)
+    {
+        return UA_STATUSCODE_GOOD;
+    }
+    /* Delta frames, events and RawData or DataValue fields are not supported */
+    if (UADP_MESSAGE_TYPE_KEY_FRAME != messageType || 0 != (flags1 & UADP_FIELD_ENCODING_MASK))
+    {
+        return UA_STATUSCODE_BADNOTSUPPORTED;
+    }
+    if (flags1 & UADP_DATASET_SEQUENCE_NUMBER_ENABLED)
+    {
+        if (!readUInt(&cursor, 2, &value))
+        {
+            return UA_STATUSCODE_BADDECODINGERROR;
+        }
+        header->sequenceNumber = (uint16_t) value;
+    }
+    if (flags2 & UADP_DATASET_TIMESTAMP_ENABLED)
+    {
+        if (!readUInt(&cursor, 8, &value))
+        {
+            return UA_STATUSCODE_BADDECODINGERROR;
+        }
+        header->timestamp = (int64_t) value;
+    }
+    bool decoded = true;
+    if (flags2 & UADP_DATASET_PICOSECONDS_ENABLED)
+    {
+        decoded = skipBytes(&cursor, 2);
+    }
+    if (decoded && (flags1 & UADP_DATASET_STATUS_ENABLED))
+    {
+        decoded = skipBytes(&cursor, 2);
+    }
+    if (decoded && (flags1 & UADP_CONFIG_VERSION_MAJOR_ENABLED))
+    {
+        decoded = skipBytes(&cursor, 4);
+    }
+    if (decoded && (flags1 & UADP_CONFIG_VERSION_MINOR_ENABLED))
+    {
+        decoded = skipBytes(&cursor, 4);
+    }
+    if (!decoded || !readUInt(&cursor, 2, &value))
+    {
+        return UA_STATUSCODE_BADDECODINGERROR;
+    }
+    if (value > fieldCapacity)
+    {
+        return UA_STATUSCODE_BADENCODINGLIMITSEXCEEDED;
+    }
+
+    size_t count = (size_t) value;
+    for (size_t i = 0; i < count; i++)
+    {
+        UA_Variant_init(&fields[i]);
+    }
+    for (size_t i = 0; decoded && i < count; i++)
+    {
+        decoded = readVariant(&cursor, &fields[i]);
+    }
+    if (!decoded)
+    {
+        for (size_t i = 0; i < count; i++)
+        {
+            UA_Variant_deleteMembers(&fields[i]);
+        }
+        return UA_STATUSCODE_BADDECODINGERROR;
+    }
+    *fieldCount = count;
+    return UA_STATUSCODE_GOOD;
+}
+
+bool isUadpVariantType(const UA_DataType *type)
+{
+    return NULL != type && NULL != getFieldTypeByType(type);
+}
+
+size_t encodeUadpVariant(const UA_Variant *value, uint8_t *buffer, size_t size)
+{
+    if (NULL == value || NULL == buffer)
+    {
+        return 0;
+    }
+    UadpCursor cursor = { buffer, buffer + size };
+    return writeVariant(&cursor, value) ? (size_t) (cursor.pos - buffer) : 0;
+}
+
+UA_StatusCode decodeUadpVariant(const uint8_t *buffer, size_t length, UA_Variant *value)
+{
+    if (NULL == buffer || NULL == value)
+    {
+        return UA_STATUSCODE_BADINVALIDARGUMENT;
+    }
+    UA_Variant_init(value);
+    UadpCursor cursor = { (uint8_t *) buffer, buffer + length };
+    if (!readVariant(&cursor, value) || cursor.pos != cursor.end)
+    {
+        UA_Variant_deleteMembers(value);
+        return UA_STATUSCODE_BADDECODINGERROR;
+    }
+    return UA_STATUSCODE_GOOD;
+}
@@ -0,0 +1,122 @@
+/******************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ *
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************/
+
+
+/**
+ * @file edge_uadp.h
+ * @brief This file contains the encoding of UADP NetworkMessages of OPC UA PubSub (Part 14).
+ *        A message carries one key frame DataSetMessage whose fields are Variants of
+ *        the built-in types Boolean to ByteString, without security and chunking.
+ */
+
+#ifndef EDGE_UADP_H
+#define EDGE_UADP_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#include <open62541.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* UDP port of OPC UA PubSub, used if the configuration sets none */
+#define EDGE_UADP_DEFAULT_PORT (4840)
+
+/* Largest NetworkMessage which is not fragmented by IPv4 on an Ethernet link */
+#define EDGE_UADP_DEFAULT_MESSAGE_SIZE (1472)
+
+/* Largest payload of a UDP datagram */
+#define EDGE_UADP_MAX_MESSAGE_SIZE (65507)
+
+/**
+ * @brief Headers of a UADP NetworkMessage with one DataSetMessage
+ */
+typedef struct EdgeUadpHeader
+{
+    uint64_t publisherId;
+    uint16_t writerGroupId;
+    uint16_t dataSetWriterId;
+    /* Sequence number of the DataSetMessage, or of the group if the DataSetMessage has none */
+    uint16_t sequenceNumber;
+    /* UA_DateTime of the DataSetMessage, or of the NetworkMessage if the DataSetMessage has none */
+    int64_t timestamp;
+} EdgeUadpHeader;
+
+/**
+ * @brief Encodes a NetworkMessage with one key frame DataSetMessage.
+ *        Fields of other than the built-in types are encoded as empty Variants.
+ * @param[in]  header Headers of the message, publisherId is encoded as UInt16
+ * @param[in]  fields Fields of the DataSet
+ * @param[in]  fieldCount Number of fields
+ * @param[out] buffer Buffer of the message
+ * @param[in]  size Size of the buffer
+ * @return Length of the message, 0 if it does not fit into the buffer
+ */
+size_t encodeUadpMessage(const EdgeUadpHeader *header, const UA_Variant *fields, size_t fieldCount,
+        uint8_t *buffer, size_t size);
+
+/**
+ * @brief Decodes a NetworkMessage with one DataSetMessage.
+ *        A keep alive message or a message of an invalid DataSetMessage decodes without fields.
+ * @param[in]  buffer Received message
+ * @param[in]  length Length of the message
+ * @param[out] header Headers of the message, fields which are not in the message are 0
+ * @param[out] fields Receives the fields, which own their values and are freed with
+ *             UA_Variant_deleteMembers()
+ * @param[in]  fieldCapacity Number of fields the array takes
+ * @param[out] fieldCount Number of decoded fields
+ * @return GOOD status on success, otherwise an error status and no fields
+ */
+UA_StatusCode decodeUadpMessage(const uint8_t *buffer, size_t length, EdgeUadpHeader *header,
+        UA_Variant *fields, size_t fieldCapacity, size_t *fieldCount);
+
+/**
+ * @brief Checks whether a Variant of the type is encoded with its value.
+ * @param[in]  type Data type of the Variant
+ * @return true for the built-in types Boolean to ByteString, otherwise false
+ */
+bool isUadpVariantType(const UA_DataType *type);
+
+/**
+ * @brief Encodes one Variant in the encoding of the DataSet fields, see encodeUadpMessage().
+ * @param[in]  value Variant to encode
+ * @param[out] buffer Buffer of the encoding
+ * @param[in]  size Size of the buffer
+ * @return Length of the encoding, 0 if it does not fit into the buffer
+ */
+size_t encodeUadpVariant(const UA_Variant *value, uint8_t *buffer, size_t size);
+
+/**
+ * @brief Decodes one Variant encoded by encodeUadpVariant().
+ * @param[in]  buffer Encoding of the Variant
+ * @param[in]  length Length of the encoding, which must be taken completely
+ * @param[out] value Receives the Variant, freed with UA_Variant_deleteMembers()
+ * @return GOOD status on success, otherwise an error status and an empty Variant
+ */
+UA_StatusCode decodeUadpVariant(const uint8_t *buffer, size_t length, UA_Variant *value);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif      // EDGE_UADP_H
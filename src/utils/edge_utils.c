@@ -26,13 +26,36 @@
 #include <sys/time.h>
 #endif
 #include <time.h>
+#ifndef _WIN32
+#include <pthread.h>
+#else
+#include "pthread.h"
+#endif
 
 #include "edge_open62541.h"
+#include "edge_hash_map.h"
 #include "edge_logger.h"
 #include "edge_malloc.h"
+#include "edge_report_pool.h"
+#include "octhread.h"
 
 #define TAG "edge_utils"
 
+static bool g_localTimeEnabled = true;
+
+/* Blocks of the messages allocated by the library. The application may allocate EdgeMessage by
+ * itself, such a message has no block, and nothing past it may be read. */
+static EdgeHashMap *g_messageBlocks = NULL;
+static pthread_mutex_t g_messageBlocksMutex = PTHREAD_MUTEX_INITIALIZER;
+
+#if defined(_WIN32) && !defined(__GNUC__)
+#define REF_INCREMENT(ptr) InterlockedIncrement((LONG volatile *) (ptr))
+#define REF_DECREMENT(ptr) InterlockedDecrement((LONG volatile *) (ptr))
+#else
+#define REF_INCREMENT(ptr) __atomic_add_fetch((ptr), 1, __ATOMIC_RELAXED)
+#define REF_DECREMENT(ptr) __atomic_sub_fetch((ptr), 1, __ATOMIC_ACQ_REL)
+#endif
+
 #ifdef _WIN32
 int getTimeofDay(struct timeval *tp, struct timezone *tzp)
 {
@@ -55,7 +78,10 @@ int getTimeofDay(struct timeval *tp, struct timezone *tzp)
 
 void logCurrentTimeStamp()
 {
-#if DEBUG
+    if (!EDGE_LOG_ENABLED(EDGE_LOG_LEVEL_DEBUG))
+    {
+        return;
+    }
     struct timeval curTime;
     #ifndef _WIN32
         gettimeofday(&curTime, NULL);
@@ -66,7 +92,32 @@ void logCurrentTimeStamp()
     char buffer[15];
     strftime(buffer, sizeof(buffer), "%m/%d %H:%M:%S", localtime(&curTime.tv_sec));
     EDGE_LOG_V(TAG, "Current time: %s.%06d\n", buffer, (int)(curTime.tv_usec));
+}
+
+void setEdgeLocalTimeEnabled(bool enable)
+{
+    g_localTimeEnabled = enable;
+}
+
+void setEdgeTimeInfo(EdgeTimeInfo *timeInfo)
+{
+#ifndef _WIN32
+    gettimeofday(&(timeInfo->tv), NULL);
+#else
+    getTimeofDay(&(timeInfo->tv), NULL);
+#endif
+    timeInfo->monotonicTime = oc_get_time_us();
+    timeInfo->timeInfo = NULL;
+    if (g_localTimeEnabled)
+    {
+        time_t rawtime = (time_t) timeInfo->tv.tv_sec;
+#ifndef _WIN32
+        localtime_r(&rawtime, &(timeInfo->localTime));
+#else
+        localtime_s(&(timeInfo->localTime), &rawtime);
 #endif
+        timeInfo->timeInfo = &(timeInfo->localTime);
+    }
 }
 
 char *cloneString(const char *str)
@@ -164,6 +215,10 @@ EdgeSubRequest* cloneSubRequest(EdgeSubRequest* subReq)
     clone->publishingEnabled = subReq->publishingEnabled;
     clone->priority = subReq->priority;
     clone->queueSize = subReq->queueSize;
+    clone->discardPolicy = subReq->discardPolicy;
+    clone->trigger = subReq->trigger;
+    clone->deadbandType = subReq->deadbandType;
+    clone->deadbandValue = subReq->deadbandValue;
 
     return clone;
 }
@@ -175,6 +230,13 @@ EdgeEndpointConfig *cloneEdgeEndpointConfig(EdgeEndpointConfig *config)
     VERIFY_NON_NULL_MSG(clone, "EdgeCallc failed for clone in cloneEdgeEndpointConfig\n", NULL);
     clone->requestTimeout = config->requestTimeout;
     clone->bindPort = config->bindPort;
+    clone->updateQueueSize = config->updateQueueSize;
+    clone->iterateTimeout = config->iterateTimeout;
+    clone->serverThreads = config->serverThreads;
+    clone->sendBufferSize = config->sendBufferSize;
+    clone->recvBufferSize = config->recvBufferSize;
+    clone->maxMessageSize = config->maxMessageSize;
+    clone->maxChunkCount = config->maxChunkCount;
     if (config->serverName)
     {
         clone->serverName = cloneString(config->serverName);
@@ -277,6 +339,41 @@ EdgeApplicationConfig *cloneEdgeApplicationConfig(EdgeApplicationConfig *config)
     return NULL;
 }
 
+EdgeEndPointInfo *retainEdgeEndpointInfo(EdgeEndPointInfo *endpointInfo)
+{
+    VERIFY_NON_NULL_MSG(endpointInfo, "NULL param endpointinfo in retainEdgeEndpointInfo\n", NULL);
+    REF_INCREMENT(&((EdgeSharedEndpoint *) endpointInfo)->refCount);
+    return endpointInfo;
+}
+
+void releaseEdgeEndpointInfo(EdgeEndPointInfo *endpointInfo)
+{
+    VERIFY_NON_NULL_NR_MSG(endpointInfo, "NULL param endpointinfo in releaseEdgeEndpointInfo\n");
+    // shared endpoints are single blocks made by shareEdgeEndpointInfo()
+    if (0 == REF_DECREMENT(&((EdgeSharedEndpoint *) endpointInfo)->refCount))
+    {
+        EdgeFree(endpointInfo);
+    }
+}
+
+EdgeEndPointInfo *shareMessageEndpointInfo(const EdgeMessage *msg)
+{
+    VERIFY_NON_NULL_MSG(msg, "NULL param msg in shareMessageEndpointInfo\n", NULL);
+    COND_CHECK((IS_NULL(msg->endpointInfo)), NULL);
+    if (msg->endpointInfo == EDGE_MESSAGE_BLOCK(msg)->sharedEndpoint)
+    {
+        return retainEdgeEndpointInfo(msg->endpointInfo);
+    }
+    return shareEdgeEndpointInfo(msg->endpointInfo);
+}
+
+void setMessageEndpointInfo(EdgeMessage *msg, EdgeEndPointInfo *endpointInfo)
+{
+    VERIFY_NON_NULL_NR_MSG(msg, "NULL param msg in setMessageEndpointInfo\n");
+    msg->endpointInfo = endpointInfo;
+    EDGE_MESSAGE_BLOCK(msg)->sharedEndpoint = endpointInfo;
+}
+
 void freeEdgeEndpointInfo(EdgeEndPointInfo *endpointInfo)
 {
     VERIFY_NON_NULL_NR_MSG(endpointInfo, "NULL param endpointinfo in cloneEdgeEndpointInfo\n");
@@ -470,17 +567,100 @@ void freeEdgeResponses(EdgeResponse **responses, int responseLength)
     EdgeFree(responses);
 }
 
-void freeEdgeMessage(EdgeMessage *msg)
+bool registerEdgeMessageBlock(EdgeMessageBlock *block)
+{
+    VERIFY_NON_NULL_MSG(block, "NULL param block in registerEdgeMessageBlock\n", false);
+    pthread_mutex_lock(&g_messageBlocksMutex);
+    if (IS_NULL(g_messageBlocks))
+    {
+        g_messageBlocks = createEdgeHashMap(EDGE_HASH_POINTER_KEY);
+    }
+    bool registered = IS_NOT_NULL(g_messageBlocks)
+            && insertEdgeHashMapElement(g_messageBlocks, (keyValue) &block->msg, (keyValue) block);
+    pthread_mutex_unlock(&g_messageBlocksMutex);
+    return registered;
+}
+
+void unregisterEdgeMessageBlock(EdgeMessageBlock *block)
+{
+    VERIFY_NON_NULL_NR_MSG(block, "NULL param block in unregisterEdgeMessageBlock\n");
+    pthread_mutex_lock(&g_messageBlocksMutex);
+    if (IS_NOT_NULL(g_messageBlocks))
+    {
+        removeEdgeHashMapElement(g_messageBlocks, (keyValue) &block->msg, NULL);
+    }
+    pthread_mutex_unlock(&g_messageBlocksMutex);
+}
+
+bool isEdgeMessageBlock(const EdgeMessage *msg)
+{
+    VERIFY_NON_NULL_MSG(msg, "NULL param msg in isEdgeMessageBlock\n", false);
+    pthread_mutex_lock(&g_messageBlocksMutex);
+    bool found = IS_NOT_NULL(g_messageBlocks)
+            && IS_NOT_NULL(getEdgeHashMapElement(g_messageBlocks, (keyValue) msg));
+    pthread_mutex_unlock(&g_messageBlocksMutex);
+    return found;
+}
+
+EdgeMessage *allocEdgeMessage()
+{
+    EdgeMessageBlock *block = (EdgeMessageBlock *) EdgeCalloc(1, sizeof(EdgeMessageBlock));
+    VERIFY_NON_NULL_MSG(block, "EdgeCalloc failed for EdgeMessageBlock in allocEdgeMessage\n", NULL);
+    if (!registerEdgeMessageBlock(block))
+    {
+        EDGE_LOG(TAG, "Failed to register the EdgeMessageBlock in allocEdgeMessage\n");
+        EdgeFree(block);
+        return NULL;
+    }
+    return &block->msg;
+}
+
+static void freeEdgeMessageMembers(EdgeMessage *msg)
 {
-    VERIFY_NON_NULL_NR_MSG(msg, "NULL param EdgeMessage in freeEdgeMessage\n");
-    freeEdgeEndpointInfo(msg->endpointInfo);
     freeEdgeRequest(msg->request);
     freeEdgeRequests(msg->requests, msg->requestLength);
     freeEdgeResponses(msg->responses, msg->responseLength);
     EdgeFree(msg->result);
     EdgeFree(msg->browseParam);
+    EdgeFree(msg->historyParam);
     freeEdgeBrowseResult(msg->browseResult, msg->browseResultLength);
-    EdgeFree(msg);
+}
+
+void freeEdgeMessage(EdgeMessage *msg)
+{
+    VERIFY_NON_NULL_NR_MSG(msg, "NULL param EdgeMessage in freeEdgeMessage\n");
+    if (!isEdgeMessageBlock(msg))
+    {
+        // allocated by the application, so everything it holds is its own
+        freeEdgeEndpointInfo(msg->endpointInfo);
+        freeEdgeMessageMembers(msg);
+        EdgeFree(msg);
+        return;
+    }
+    EdgeMessageBlock *block = EDGE_MESSAGE_BLOCK(msg);
+    if (block->pool)
+    {
+        releaseEdgeReport(msg);
+        return;
+    }
+    if (IS_NOT_NULL(block->sharedEndpoint))
+    {
+        releaseEdgeEndpointInfo(block->sharedEndpoint);
+    }
+    if (msg->endpointInfo != block->sharedEndpoint)
+    {
+        // owned by the message, or set by the application in place of the shared one
+        freeEdgeEndpointInfo(msg->endpointInfo);
+    }
+    unregisterEdgeMessageBlock(block);
+    if (block->isArenaBlock)
+    {
+        // cloned by cloneEdgeMessage(), the arena starts with the block itself
+        EdgeFree(block);
+        return;
+    }
+    freeEdgeMessageMembers(msg);
+    EdgeFree(block);
 }
 
 EdgeResult *createEdgeResult(EdgeStatusCode code)
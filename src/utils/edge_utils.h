@@ -49,8 +49,63 @@ extern "C"
 #define COND_CHECK_NR_MSG(arg, msg) { if (arg) { EDGE_LOG(TAG, \
             msg); return; } }
 
+#ifdef _WIN32
+#define EDGE_THREAD_LOCAL __declspec(thread)
+#else
+#define EDGE_THREAD_LOCAL __thread
+#endif
+
 #define GUID_LENGTH (36)
 
+/**
+ * @brief Message allocated by the library, with the state which the application does not see.
+ *        The application may allocate EdgeMessage by itself, so the state is only read from
+ *        messages made by allocEdgeMessage(), cloneEdgeMessage() and acquireEdgeReport().
+ *        These register their blocks, see isEdgeMessageBlock().
+ */
+typedef struct EdgeMessageBlock
+{
+    /**< Message, first so that the block converts to and from it */
+    EdgeMessage msg;
+
+    /**< Shared endpoint held by the message, see setMessageEndpointInfo(). NULL otherwise. */
+    EdgeEndPointInfo *sharedEndpoint;
+
+    /**< Set when the message and all of its members share one memory block.
+         Such a message is released at once by freeEdgeMessage(). */
+    bool isArenaBlock;
+
+    /**< Report pool which recycles the message in freeEdgeMessage(), NULL otherwise. */
+    void *pool;
+
+    /**< Id of the prepared read executed by the message, 0 otherwise. */
+    uint32_t preparedId;
+
+    /**< Set on the message which waits for the asynchronous responses of its session. */
+    bool asyncDrain;
+
+    /**< Set on the message which sends the coalesced writes of its session. */
+    bool coalesceFlush;
+
+    /**< Set on the message which connects a lost session again after its backoff. */
+    bool reconnectProbe;
+} EdgeMessageBlock;
+
+#define EDGE_MESSAGE_BLOCK(msg) ((EdgeMessageBlock *) (msg))
+
+/**
+ * @brief Immutable endpoint shared by reference counting, made by shareEdgeEndpointInfo().
+ *        Only its holders know that it is shared, the application does not see the count.
+ */
+typedef struct EdgeSharedEndpoint
+{
+    /**< Endpoint, first so that the block converts to and from it */
+    EdgeEndPointInfo info;
+
+    /**< Number of holders of the endpoint */
+    int refCount;
+} EdgeSharedEndpoint;
+
 #define CHECKING_ENDPOINT_URI_PATTERN ("^(opc)[.]{1}(tcp:)[/]{2}[A-Za-z0-9.-]{1,30}:[0-9]{1,6}([A-Za-z0-9_/-]{0,100})$")
 
 #ifdef _WIN32
@@ -67,6 +122,18 @@ int getTimeofDay(struct timeval *tp, struct timezone *tzp);
  */
 void logCurrentTimeStamp();
 
+/**
+ * @brief Enables the broken-down local time set by setEdgeTimeInfo().
+ * @param[in]  enable false to leave EdgeTimeInfo.timeInfo NULL.
+ */
+void setEdgeLocalTimeEnabled(bool enable);
+
+/**
+ * @brief Sets the wall clock and monotonic time to now, and the local time if it is enabled.
+ * @param[out]  timeInfo Time to set, timeInfo->timeInfo points into it.
+ */
+void setEdgeTimeInfo(EdgeTimeInfo *timeInfo);
+
 /**
  * @brief Clones a given string.
  * @remarks Allocated memory should be freed by the caller.
@@ -129,6 +196,7 @@ void freeEdgeApplicationConfig(EdgeApplicationConfig *config);
 /**
  * @brief De-allocates the memory consumed by EdgeEndPointInfo and its members.
  * @remarks Both EdgeEndPointInfo and its members should have been allocated dynamically.
+ *          A shared endpoint is released by releaseEdgeEndpointInfo() instead.
  * @param[in]  endpointInfo Pointer to EdgeEndPointInfo which needs to be freed.
  */
 void freeEdgeEndpointInfo(EdgeEndPointInfo *endpointInfo);
@@ -208,7 +276,8 @@ void freeEdgeResponses(EdgeResponse **responses, int responseLength);
 
 /**
  * @brief De-allocates the memory consumed by EdgeMessage and its members.
- * @remarks Both EdgeMessage and its members should have been allocated dynamically.
+ * @remarks The message and its members should have been allocated dynamically, by the
+ *          application or by allocEdgeMessage().
  * @param[in]  msg Pointer to EdgeMessage which needs to be freed.
  */
 void freeEdgeMessage(EdgeMessage *msg);
@@ -252,6 +321,65 @@ EdgeApplicationConfig *cloneEdgeApplicationConfig(EdgeApplicationConfig *config)
  */
 EdgeEndPointInfo *cloneEdgeEndpointInfo(EdgeEndPointInfo *endpointInfo);
 
+/**
+ * @brief Takes one more reference to a shared EdgeEndPointInfo.
+ * @param[in]  endpointInfo Shared endpoint made by shareEdgeEndpointInfo().
+ * @return endpointInfo
+ * @remarks The reference is dropped by releaseEdgeEndpointInfo().
+ */
+EdgeEndPointInfo *retainEdgeEndpointInfo(EdgeEndPointInfo *endpointInfo);
+
+/**
+ * @brief Drops one reference to a shared EdgeEndPointInfo, which is freed with the last one.
+ * @param[in]  endpointInfo Shared endpoint made by shareEdgeEndpointInfo().
+ */
+void releaseEdgeEndpointInfo(EdgeEndPointInfo *endpointInfo);
+
+/**
+ * @brief Records that a message of the library is followed by its EdgeMessageBlock.
+ * @param[in]  block Block of the message.
+ * @return @c true on success, @c false if memory is insufficient.
+ * @remarks The block is forgotten by unregisterEdgeMessageBlock() before it is freed.
+ */
+bool registerEdgeMessageBlock(EdgeMessageBlock *block);
+
+/**
+ * @brief Forgets a block recorded by registerEdgeMessageBlock().
+ * @param[in]  block Block of the message.
+ */
+void unregisterEdgeMessageBlock(EdgeMessageBlock *block);
+
+/**
+ * @brief Checks whether a message was allocated by the library in an EdgeMessageBlock.
+ * @param[in]  msg Message which may also be allocated by the application.
+ * @return @c true if the message has a block, @c false for messages of the application.
+ */
+bool isEdgeMessageBlock(const EdgeMessage *msg);
+
+/**
+ * @brief Allocates a zeroed EdgeMessage in an EdgeMessageBlock.
+ * @remarks Allocated memory should be freed by freeEdgeMessage().
+ * @return EdgeMessage on success. Otherwise null.
+ */
+EdgeMessage *allocEdgeMessage();
+
+/**
+ * @brief Shares the endpoint of a message allocated by allocEdgeMessage().
+ * @param[in]  msg Message whose endpoint is shared.
+ * @return One more reference to the shared endpoint held by the message, or a new shared copy
+ *         of its endpoint. Null if the message has no endpoint or on failure.
+ * @remarks The reference is dropped by releaseEdgeEndpointInfo().
+ */
+EdgeEndPointInfo *shareMessageEndpointInfo(const EdgeMessage *msg);
+
+/**
+ * @brief Sets the endpoint of a message allocated by allocEdgeMessage() to a shared endpoint.
+ * @param[in]  msg Message without endpoint.
+ * @param[in]  endpointInfo Shared endpoint, the message takes over the reference. May be null.
+ * @remarks The reference is dropped by freeEdgeMessage().
+ */
+void setMessageEndpointInfo(EdgeMessage *msg, EdgeEndPointInfo *endpointInfo);
+
 /**
  * @brief Creates an EdgeResult object with the given status code.
  * @remarks Allocated memory should be freed by the caller.
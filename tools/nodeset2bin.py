@@ -0,0 +1,340 @@
+#!/usr/bin/env python3
+#******************************************************************
+#
+# Copyright 2017 Samsung Electronics All Rights Reserved.
+#
+#
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#      http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+#
+#******************************************************************
+
+"""Compile a NodeSet2 XML file into the binary nodeset of loadNodeset().
+
+The server identifies the nodes of a namespace by their browse names, so the browse names
+of the nodes in the file must be unique. Nodes are added before their children, and the
+references of the file are added after all nodes. The format is described in
+src/node/edge_nodeset.h.
+
+usage: nodeset2bin.py input.xml output.bin
+"""
+
+import base64
+import datetime
+import struct
+import sys
+import uuid
+import xml.etree.ElementTree as ET
+
+UA_NS = '{http://opcfoundation.org/UA/2011/03/UANodeSet.xsd}'
+UAX_NS = '{http://opcfoundation.org/UA/2008/02/Types.xsd}'
+
+MAGIC = b'EDNS'
+VERSION = 1
+NO_STRING = 0xFFFFFFFF
+
+# EdgeIdentifier of each node class
+VARIABLE_NODE = 1000
+ARRAY_NODE = 1001
+OBJECT_NODE = 1002
+VARIABLE_TYPE_NODE = 1003
+OBJECT_TYPE_NODE = 1004
+REFERENCE_TYPE_NODE = 1005
+DATA_TYPE_NODE = 1006
+VIEW_NODE = 1007
+
+NODE_TYPES = {
+    'UAVariable': VARIABLE_NODE,
+    'UAObject': OBJECT_NODE,
+    'UAVariableType': VARIABLE_TYPE_NODE,
+    'UAObjectType': OBJECT_TYPE_NODE,
+    'UAReferenceType': REFERENCE_TYPE_NODE,
+    'UADataType': DATA_TYPE_NODE,
+    'UAView': VIEW_NODE,
+}
+
+# Node classes whose parent reference is added with the node itself
+PARENTED_TYPES = (OBJECT_NODE, OBJECT_TYPE_NODE, DATA_TYPE_NODE, VIEW_NODE)
+
+# Built-in types of namespace 0 which the loader supports: id -> (name, struct format)
+STRING_TYPES = (12, 15)
+BUILTIN_TYPES = {
+    1: ('Boolean', '<?'), 2: ('SByte', '<b'), 3: ('Byte', '<B'), 4: ('Int16', '<h'),
+    5: ('UInt16', '<H'), 6: ('Int32', '<i'), 7: ('UInt32', '<I'), 8: ('Int64', '<q'),
+    9: ('UInt64', '<Q'), 10: ('Float', '<f'), 11: ('Double', '<d'), 12: ('String', None),
+    13: ('DateTime', '<q'), 14: ('Guid', '<IHH8s'), 15: ('ByteString', None),
+    19: ('StatusCode', '<I'),
+}
+
+# Reference types of namespace 0 by their standard alias names
+REFERENCE_TYPES = {
+    'Organizes': 35, 'HasEventSource': 36, 'HasModellingRule': 37, 'HasEncoding': 38,
+    'HasDescription': 39, 'HasTypeDefinition': 40, 'GeneratesEvent': 41, 'HasSubtype': 45,
+    'HasProperty': 46, 'HasComponent': 47, 'HasNotifier': 48, 'HasOrderedComponent': 49,
+}
+HAS_TYPE_DEFINITION = 40
+
+# NodeSet2 access levels to EdgeAccessLevel: READ_WRITE = 0, READ = 1, WRITE = 2
+ACCESS_LEVELS = {0: 1, 1: 1, 2: 2, 3: 0}
+
+# 1601-01-01 to 1970-01-01 in 100 ns ticks, the DateTime epoch of OPC UA
+DATETIME_UNIX_EPOCH = 116444736000000000
+
+
+class NodesetError(Exception):
+    pass
+
+
+def numericId(nodeId, aliases):
+    """Returns the numeric identifier of a namespace 0 node id or alias, otherwise None."""
+    nodeId = aliases.get(nodeId, nodeId)
+    if nodeId.startswith('i='):
+        return int(nodeId[2:])
+    return None
+
+
+def browseName(element):
+    name = element.get('BrowseName')
+    if not name:
+        raise NodesetError('%s has no BrowseName' % element.get('NodeId'))
+    # The "ns:" prefix is the namespace of the name, the loader uses its own namespace
+    if ':' in name and name.split(':', 1)[0].isdigit():
+        name = name.split(':', 1)[1]
+    return name
+
+
+def displayName(element):
+    text = element.find(UA_NS + 'DisplayName')
+    if text is None or not text.text:
+        return None
+    return text.text
+
+
+def valueText(element, field):
+    child = element.find(UAX_NS + field)
+    return '' if child is None or child.text is None else child.text.strip()
+
+
+def parseDateTime(text):
+    """Converts an xs:dateTime in UTC into OPC UA DateTime ticks."""
+    if not text:
+        return 0
+    seconds, _, fraction = text.rstrip('Z').partition('.')
+    value = datetime.datetime.strptime(seconds, '%Y-%m-%dT%H:%M:%S')
+    delta = value - datetime.datetime(1970, 1, 1)
+    ticks = (delta.days * 86400 + delta.seconds) * 10000000
+    return DATETIME_UNIX_EPOCH + ticks + int((fraction + '0000000')[:7])
+
+
+def parseScalar(typeId, element):
+    """Converts a value element into the memory layout of its type, or a byte string."""
+    text = '' if element is None or element.text is None else element.text.strip()
+    if typeId == 1:
+        return struct.pack('<?', text.lower() == 'true')
+    if typeId in (10, 11):
+        return struct.pack(BUILTIN_TYPES[typeId][1], float(text or 0))
+    if typeId == 12:
+        return text.encode('utf-8')
+    if typeId == 15:
+        return base64.b64decode(text)
+    if typeId == 13:
+        return struct.pack('<q', parseDateTime(text))
+    if typeId == 14:
+        text = valueText(element, 'String') if element is not None else ''
+        guid = uuid.UUID(text) if text else uuid.UUID(int=0)
+        return struct.pack('<IHH8s', guid.time_low, guid.time_mid, guid.time_hi_version,
+                guid.bytes[8:])
+    if typeId == 19:
+        code = valueText(element, 'Code') if element is not None else ''
+        return struct.pack('<I', int(code or 0, 0))
+    return struct.pack(BUILTIN_TYPES[typeId][1], int(text or 0, 0))
+
+
+class NodesetWriter(object):
+    def __init__(self):
+        self.nodes = []
+        self.references = []
+        self.values = bytearray()
+        self.strings = bytearray()
+        self.stringOffsets = {}
+
+    def string(self, text):
+        if text is None:
+            return NO_STRING
+        data = text.encode('utf-8') if not isinstance(text, bytes) else text
+        if b'\0' in data:
+            raise NodesetError('String values cannot contain NUL: %r' % text)
+        if data not in self.stringOffsets:
+            self.stringOffsets[data] = len(self.strings)
+            self.strings += data + b'\0'
+        return self.stringOffsets[data]
+
+    def value(self, typeId, values, isArray):
+        if typeId in STRING_TYPES:
+            offsets = [self.string(v) for v in values]
+            if not isArray:
+                return offsets[0]
+            data = b''.join(struct.pack('<I', o) for o in offsets)
+        else:
+            data = b''.join(values)
+        # Values are aligned to 8 bytes, the loader does not rely on it
+        self.values += b'\0' * (-len(self.values) % 8)
+        offset = len(self.values)
+        self.values += data
+        return offset
+
+    def addNode(self, nodeType, name, display, parent, valueType=0, value=0, arrayLength=0,
+            accessLevel=0, userAccessLevel=0, samplingInterval=0.0):
+        self.nodes.append(struct.pack('<dIIIIIHHBB6x', samplingInterval, self.string(name),
+                self.string(display), self.string(parent), value, arrayLength, nodeType,
+                valueType, accessLevel, userAccessLevel))
+
+    def addReference(self, source, target, referenceId, forward):
+        self.references.append(struct.pack('<IIHBx', self.string(source), self.string(target),
+                referenceId, 1 if forward else 0))
+
+    def data(self):
+        header = MAGIC + struct.pack('<HHIIII', VERSION, 0, len(self.nodes),
+                len(self.references), len(self.values), len(self.strings))
+        return header + b''.join(self.nodes) + b''.join(self.references) + bytes(self.values) \
+                + bytes(self.strings)
+
+
+def variableValue(writer, element, aliases):
+    """Returns the value fields of a node record for a variable or a variable type."""
+    typeId = numericId(element.get('DataType', 'i=24'), aliases)
+    if typeId not in BUILTIN_TYPES:
+        raise NodesetError('%s has an unsupported DataType %s'
+                % (element.get('NodeId'), element.get('DataType')))
+    name = BUILTIN_TYPES[typeId][0]
+    valueRank = int(element.get('ValueRank', '-1'))
+    isArray = valueRank >= 0 or element.get('ArrayDimensions') is not None
+
+    value = element.find(UA_NS + 'Value')
+    items = []
+    if value is not None and len(value) > 0:
+        child = value[0]
+        if child.tag == UAX_NS + 'ListOf' + name:
+            isArray = True
+            items = list(child)
+        elif child.tag == UAX_NS + name:
+            items = [child]
+    if not items:
+        items = [None]
+
+    values = [parseScalar(typeId, item) for item in items]
+    if not isArray and len(values) > 1:
+        raise NodesetError('%s has several values' % element.get('NodeId'))
+    offset = writer.value(typeId, values, isArray)
+    return typeId, offset, len(values) if isArray else 0, isArray
+
+
+def compileNodeset(xmlText):
+    root = ET.fromstring(xmlText)
+    aliases = {}
+    aliasElement = root.find(UA_NS + 'Aliases')
+    if aliasElement is not None:
+        for alias in aliasElement.findall(UA_NS + 'Alias'):
+            aliases[alias.get('Alias')] = alias.text.strip()
+
+    elements = {}
+    order = []
+    for element in root:
+        tag = element.tag[len(UA_NS):]
+        if tag == 'UAMethod':
+            sys.stderr.write('skipping method %s, methods need callbacks\n' % element.get('NodeId'))
+            continue
+        if tag not in NODE_TYPES:
+            continue
+        elements[element.get('NodeId')] = element
+        order.append(element.get('NodeId'))
+
+    names = {}
+    for nodeId in order:
+        name = browseName(elements[nodeId])
+        if name in names.values():
+            raise NodesetError('BrowseName %s is not unique' % name)
+        names[nodeId] = name
+
+    def depth(nodeId, seen=()):
+        parent = elements[nodeId].get('ParentNodeId')
+        if parent not in elements or parent in seen:
+            return 0
+        return 1 + depth(parent, seen + (nodeId,))
+
+    writer = NodesetWriter()
+    types = {}
+    for nodeId in sorted(order, key=depth):
+        element = elements[nodeId]
+        nodeType = NODE_TYPES[element.tag[len(UA_NS):]]
+        parent = names.get(element.get('ParentNodeId'))
+        fields = {}
+        if nodeType in (VARIABLE_NODE, VARIABLE_TYPE_NODE):
+            typeId, offset, length, isArray = variableValue(writer, element, aliases)
+            if nodeType == VARIABLE_NODE and isArray:
+                nodeType = ARRAY_NODE
+            if nodeType == VARIABLE_TYPE_NODE and not isArray:
+                length = 1
+            fields = dict(valueType=typeId, value=offset, arrayLength=length)
+            if nodeType != VARIABLE_TYPE_NODE:
+                fields['accessLevel'] = ACCESS_LEVELS.get(int(element.get('AccessLevel', '1')) & 3)
+                fields['userAccessLevel'] = ACCESS_LEVELS.get(
+                        int(element.get('UserAccessLevel', '1')) & 3)
+                fields['samplingInterval'] = float(element.get('MinimumSamplingInterval', '0'))
+        types[nodeId] = nodeType
+        writer.addNode(nodeType, names[nodeId], displayName(element), parent, **fields)
+
+    added = set()
+    for nodeId in order:
+        element = elements[nodeId]
+        references = element.find(UA_NS + 'References')
+        if references is None:
+            continue
+        for reference in references.findall(UA_NS + 'Reference'):
+            referenceId = numericId(reference.get('ReferenceType'), aliases)
+            if referenceId is None:
+                referenceId = REFERENCE_TYPES.get(reference.get('ReferenceType'))
+            target = reference.text.strip()
+            if referenceId is None or referenceId == HAS_TYPE_DEFINITION or target not in elements:
+                continue
+            source = nodeId
+            if reference.get('IsForward', 'true').lower() == 'false':
+                source, target = target, source
+            # The loader adds the parent reference of these nodes with the node
+            if types[target] in PARENTED_TYPES and elements[target].get('ParentNodeId') == source:
+                continue
+            if (source, target, referenceId) in added:
+                continue
+            added.add((source, target, referenceId))
+            writer.addReference(names[source], names[target], referenceId, True)
+    return writer.data()
+
+
+def main(argv):
+    if len(argv) != 3:
+        sys.stderr.write(__doc__)
+        return 2
+    with open(argv[1], 'rb') as f:
+        xmlText = f.read()
+    try:
+        data = compileNodeset(xmlText)
+    except NodesetError as e:
+        sys.stderr.write('%s: %s\n' % (argv[1], e))
+        return 1
+    with open(argv[2], 'wb') as f:
+        f.write(data)
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main(sys.argv))
@@ -0,0 +1,874 @@
+//******************************************************************
+//
+// Copyright 2017 Samsung Electronics All Rights Reserved.
+//
+//-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=
+
+#include <gtest/gtest.h>
+
+#include <pthread.h>
+#include <unistd.h>
+
+#include "caqueueingthread.h"
+#include "caqueueinglanes.h"
+#include "umpscqueue.h"
+#include "umpscring.h"
+
+#include "edge_malloc.h"
+
+#define PRODUCER_COUNT 4
+#define MESSAGES_PER_PRODUCER 1000
+#define WAIT_RETRY_COUNT 2000
+
+static volatile int g_processed = 0;
+static volatile int g_lastValue[PRODUCER_COUNT];
+static volatile bool g_inOrder = true;
+
+static void countTask(void *data)
+{
+    int value = *(int *) data;
+    int producer = value / MESSAGES_PER_PRODUCER;
+    if (value <= g_lastValue[producer])
+    {
+        g_inOrder = false;
+    }
+    g_lastValue[producer] = value;
+    __atomic_add_fetch(&g_processed, 1, __ATOMIC_SEQ_CST);
+}
+
+static void *produce(void *arg)
+{
+    CAQueueingThread_t *thread = (CAQueueingThread_t *) arg;
+    static int producerId = 0;
+    int id = __atomic_fetch_add(&producerId, 1, __ATOMIC_SEQ_CST) % PRODUCER_COUNT;
+
+    for (int i = 0; i < MESSAGES_PER_PRODUCER; i++)
+    {
+        int *value = (int *) EdgeMalloc(sizeof(int));
+        *value = id * MESSAGES_PER_PRODUCER + i;
+        EXPECT_EQ(CA_STATUS_OK, CAQueueingThreadAddData(thread, value, sizeof(int)));
+    }
+    return NULL;
+}
+
+static void runProducers(CAQueueingMode_t mode)
+{
+    g_processed = 0;
+    g_inOrder = true;
+    for (int i = 0; i < PRODUCER_COUNT; i++)
+    {
+        g_lastValue[i] = -1;
+    }
+
+    ca_thread_pool_t pool = NULL;
+    ASSERT_EQ(CA_STATUS_OK, ca_thread_pool_init(2, &pool));
+
+    CAQueueingThread_t thread;
+    ASSERT_EQ(CA_STATUS_OK, CAQueueingThreadInitializeWithMode(&thread, pool, countTask, NULL, mode));
+    ASSERT_EQ(CA_STATUS_OK, CAQueueingThreadStart(&thread));
+
+    pthread_t producers[PRODUCER_COUNT];
+    for (int i = 0; i < PRODUCER_COUNT; i++)
+    {
+        ASSERT_EQ(0, pthread_create(&producers[i], NULL, produce, &thread));
+    }
+    for (int i = 0; i < PRODUCER_COUNT; i++)
+    {
+        pthread_join(producers[i], NULL);
+    }
+
+    for (int i = 0; i < WAIT_RETRY_COUNT && g_processed < PRODUCER_COUNT * MESSAGES_PER_PRODUCER; i++)
+    {
+        usleep(1000);
+    }
+    EXPECT_EQ(PRODUCER_COUNT * MESSAGES_PER_PRODUCER, g_processed);
+    EXPECT_TRUE(g_inOrder);
+
+    EXPECT_EQ(CA_STATUS_OK, CAQueueingThreadStop(&thread));
+    ca_thread_pool_free(pool);
+    EXPECT_EQ(CA_STATUS_OK, CAQueueingThreadDestroy(&thread));
+}
+
+TEST(UMpscQueue, PushPop)
+{
+    u_mpsc_queue_t *queue = u_mpsc_queue_create();
+    ASSERT_TRUE(queue != NULL);
+    EXPECT_TRUE(u_mpsc_queue_is_empty(queue));
+    EXPECT_TRUE(u_mpsc_queue_pop(queue) == NULL);
+
+    int values[100];
+    for (int i = 0; i < 100; i++)
+    {
+        values[i] = i;
+        u_queue_message_t *message = (u_queue_message_t *) EdgeMalloc(sizeof(u_queue_message_t));
+        message->msg = &values[i];
+        message->size = sizeof(int);
+        EXPECT_EQ(CA_STATUS_OK, u_mpsc_queue_push(queue, message));
+    }
+    EXPECT_FALSE(u_mpsc_queue_is_empty(queue));
+
+    for (int i = 0; i < 100; i++)
+    {
+        u_queue_message_t *message = u_mpsc_queue_pop(queue);
+        ASSERT_TRUE(message != NULL);
+        EXPECT_EQ(i, *(int *) message->msg);
+        EdgeFree(message);
+    }
+    EXPECT_TRUE(u_mpsc_queue_is_empty(queue));
+
+    EXPECT_EQ(CA_STATUS_OK, u_mpsc_queue_delete(queue));
+}
+
+TEST(UMpscQueue, InvalidParam)
+{
+    EXPECT_EQ(CA_STATUS_FAILED, u_mpsc_queue_push(NULL, NULL));
+    EXPECT_TRUE(u_mpsc_queue_pop(NULL) == NULL);
+    EXPECT_EQ(CA_STATUS_FAILED, u_mpsc_queue_delete(NULL));
+}
+
+TEST(UMpscRing, PushPop)
+{
+    u_mpsc_ring_t *ring = u_mpsc_ring_create(6, sizeof(int));
+    ASSERT_TRUE(ring != NULL);
+    EXPECT_EQ(8u, u_mpsc_ring_capacity(ring));
+
+    int value = 0;
+    EXPECT_FALSE(u_mpsc_ring_pop(ring, &value));
+
+    // wrap around several times
+    for (int round = 0; round < 3; round++)
+    {
+        for (int i = 0; i < 8; i++)
+        {
+            value = round * 8 + i;
+            EXPECT_EQ(CA_STATUS_OK, u_mpsc_ring_push(ring, &value));
+        }
+        value = -1;
+        EXPECT_EQ(CA_STATUS_FAILED, u_mpsc_ring_push(ring, &value));
+
+        for (int i = 0; i < 8; i++)
+        {
+            ASSERT_TRUE(u_mpsc_ring_pop(ring, &value));
+            EXPECT_EQ(round * 8 + i, value);
+        }
+        EXPECT_FALSE(u_mpsc_ring_pop(ring, &value));
+    }
+
+    EXPECT_EQ(CA_STATUS_OK, u_mpsc_ring_delete(ring));
+}
+
+TEST(UMpscRing, InvalidParam)
+{
+    int value = 0;
+    EXPECT_TRUE(u_mpsc_ring_create(0, sizeof(int)) == NULL);
+    EXPECT_TRUE(u_mpsc_ring_create(8, 0) == NULL);
+    EXPECT_EQ(CA_STATUS_INVALID_PARAM, u_mpsc_ring_push(NULL, &value));
+    EXPECT_FALSE(u_mpsc_ring_pop(NULL, &value));
+    EXPECT_EQ(0u, u_mpsc_ring_capacity(NULL));
+    EXPECT_EQ(CA_STATUS_FAILED, u_mpsc_ring_delete(NULL));
+}
+
+static void *produceRing(void *arg)
+{
+    u_mpsc_ring_t *ring = (u_mpsc_ring_t *) arg;
+    static int producerId = 0;
+    int id = __atomic_fetch_add(&producerId, 1, __ATOMIC_SEQ_CST) % PRODUCER_COUNT;
+
+    for (int i = 0; i < MESSAGES_PER_PRODUCER; i++)
+    {
+        int value = id * MESSAGES_PER_PRODUCER + i;
+        while (CA_STATUS_OK != u_mpsc_ring_push(ring, &value))
+        {
+            usleep(10);
+        }
+    }
+    return NULL;
+}
+
+TEST(UMpscRing, MultiProducer)
+{
+    u_mpsc_ring_t *ring = u_mpsc_ring_create(64, sizeof(int));
+    ASSERT_TRUE(ring != NULL);
+
+    int lastValue[PRODUCER_COUNT];
+    for (int i = 0; i < PRODUCER_COUNT; i++)
+    {
+        lastValue[i] = -1;
+    }
+
+    pthread_t producers[PRODUCER_COUNT];
+    for (int i = 0; i < PRODUCER_COUNT; i++)
+    {
+        ASSERT_EQ(0, pthread_create(&producers[i], NULL, produceRing, ring));
+    }
+
+    int popped = 0;
+    bool inOrder = true;
+    for (int i = 0; i < WAIT_RETRY_COUNT * 100 && popped < PRODUCER_COUNT * MESSAGES_PER_PRODUCER;
+            i++)
+    {
+        int value;
+        while (u_mpsc_ring_pop(ring, &value))
+        {
+            int producer = value / MESSAGES_PER_PRODUCER;
+            if (value <= lastValue[producer])
+            {
+                inOrder = false;
+            }
+            lastValue[producer] = value;
+            popped++;
+        }
+        usleep(10);
+    }
+
+    for (int i = 0; i < PRODUCER_COUNT; i++)
+    {
+        pthread_join(producers[i], NULL);
+    }
+    EXPECT_EQ(PRODUCER_COUNT * MESSAGES_PER_PRODUCER, popped);
+    EXPECT_TRUE(inOrder);
+
+    EXPECT_EQ(CA_STATUS_OK, u_mpsc_ring_delete(ring));
+}
+
+TEST(QueueingThread, LockedMultiProducer)
+{
+    runProducers(CA_QUEUEING_MODE_LOCKED);
+}
+
+TEST(QueueingThread, LockFreeMultiProducer)
+{
+    runProducers(CA_QUEUEING_MODE_LOCKFREE);
+}
+
+static volatile int g_batchCalls = 0;
+static volatile int g_batchItems = 0;
+static volatile uint32_t g_maxBatch = 0;
+
+static void batchTask(void **data, uint32_t count)
+{
+    for (uint32_t i = 0; i < count; i++)
+    {
+        countTask(data[i]);
+    }
+    if (count > g_maxBatch)
+    {
+        g_maxBatch = count;
+    }
+    g_batchItems += count;
+    g_batchCalls++;
+}
+
+TEST(QueueingThread, BatchModeInvalid)
+{
+    EXPECT_EQ(CA_STATUS_INVALID_PARAM, CAQueueingThreadSetBatchMode(NULL, batchTask, 8));
+
+    ca_thread_pool_t pool = NULL;
+    ASSERT_EQ(CA_STATUS_OK, ca_thread_pool_init(1, &pool));
+    CAQueueingThread_t thread;
+    ASSERT_EQ(CA_STATUS_OK, CAQueueingThreadInitialize(&thread, pool, countTask, NULL));
+    EXPECT_EQ(CA_STATUS_INVALID_PARAM, CAQueueingThreadSetBatchMode(&thread, batchTask, 0));
+    EXPECT_EQ(CA_STATUS_OK, CAQueueingThreadSetBatchMode(&thread, batchTask, 8));
+    ca_thread_pool_free(pool);
+    EXPECT_EQ(CA_STATUS_OK, CAQueueingThreadDestroy(&thread));
+}
+
+static void runBatch(CAQueueingMode_t mode)
+{
+    g_processed = 0;
+    g_inOrder = true;
+    g_batchCalls = 0;
+    g_batchItems = 0;
+    g_maxBatch = 0;
+    for (int i = 0; i < PRODUCER_COUNT; i++)
+    {
+        g_lastValue[i] = -1;
+    }
+
+    ca_thread_pool_t pool = NULL;
+    ASSERT_EQ(CA_STATUS_OK, ca_thread_pool_init(1, &pool));
+
+    CAQueueingThread_t thread;
+    ASSERT_EQ(CA_STATUS_OK, CAQueueingThreadInitializeWithMode(&thread, pool, NULL, NULL, mode));
+    ASSERT_EQ(CA_STATUS_OK, CAQueueingThreadSetBatchMode(&thread, batchTask, 16));
+
+    // queue data before start so the first drain sees a full backlog
+    for (int i = 0; i < MESSAGES_PER_PRODUCER; i++)
+    {
+        int *value = (int *) EdgeMalloc(sizeof(int));
+        *value = i;
+        EXPECT_EQ(CA_STATUS_OK, CAQueueingThreadAddData(&thread, value, sizeof(int)));
+    }
+    ASSERT_EQ(CA_STATUS_OK, CAQueueingThreadStart(&thread));
+
+    for (int i = 0; i < WAIT_RETRY_COUNT && g_processed < MESSAGES_PER_PRODUCER; i++)
+    {
+        usleep(1000);
+    }
+    EXPECT_EQ(MESSAGES_PER_PRODUCER, g_processed);
+    EXPECT_EQ(MESSAGES_PER_PRODUCER, g_batchItems);
+    EXPECT_EQ(static_cast<uint32_t>(16), g_maxBatch);
+    EXPECT_LT(g_batchCalls, MESSAGES_PER_PRODUCER);
+    EXPECT_TRUE(g_inOrder);
+
+    EXPECT_EQ(CA_STATUS_OK, CAQueueingThreadStop(&thread));
+    ca_thread_pool_free(pool);
+    EXPECT_EQ(CA_STATUS_OK, CAQueueingThreadDestroy(&thread));
+}
+
+TEST(QueueingThread, LockedBatch)
+{
+    runBatch(CA_QUEUEING_MODE_LOCKED);
+}
+
+TEST(QueueingThread, LockFreeBatch)
+{
+    runBatch(CA_QUEUEING_MODE_LOCKFREE);
+}
+
+#define LANE_COUNT 3
+
+typedef struct
+{
+    int lane;
+    int seq;
+} LaneItem;
+
+static volatile int g_laneLast[LANE_COUNT];
+static volatile int g_laneProcessed = 0;
+static volatile bool g_laneInOrder = true;
+static volatile bool g_releaseSlowLane = false;
+
+static void laneTask(void *data)
+{
+    LaneItem *item = (LaneItem *) data;
+    if (0 == item->lane)
+    {
+        // lane 0 blocks until the others are done
+        for (int i = 0; i < WAIT_RETRY_COUNT && !g_releaseSlowLane; i++)
+        {
+            usleep(1000);
+        }
+    }
+    if (item->seq != g_laneLast[item->lane] + 1)
+    {
+        g_laneInOrder = false;
+    }
+    g_laneLast[item->lane] = item->seq;
+    __atomic_add_fetch(&g_laneProcessed, 1, __ATOMIC_SEQ_CST);
+}
+
+TEST(QueueingLanes, InvalidParam)
+{
+    CAQueueingLanes_t lanes;
+    EXPECT_EQ(CA_STATUS_INVALID_PARAM, CAQueueingLanesInitialize(NULL, NULL, 1, laneTask, NULL));
+    EXPECT_EQ(CA_STATUS_INVALID_PARAM, CAQueueingLanesInitialize(&lanes, NULL, 1, laneTask, NULL));
+    EXPECT_EQ(CA_STATUS_INVALID_PARAM, CAQueueingLanesAddData(NULL, "a", &lanes, 1));
+    EXPECT_EQ(CA_STATUS_INVALID_PARAM, CAQueueingLanesStop(NULL));
+}
+
+TEST(QueueingLanes, OrderedPerKeyParallelAcrossKeys)
+{
+    const char *keys[LANE_COUNT] = { "opc.tcp://slow:4840", "opc.tcp://a:4840", "opc.tcp://b:4840" };
+    g_laneProcessed = 0;
+    g_laneInOrder = true;
+    g_releaseSlowLane = false;
+    for (int i = 0; i < LANE_COUNT; i++)
+    {
+        g_laneLast[i] = -1;
+    }
+
+    ca_thread_pool_t pool = NULL;
+    ASSERT_EQ(CA_STATUS_OK, ca_thread_pool_init(4, &pool));
+
+    CAQueueingLanes_t lanes;
+    ASSERT_EQ(CA_STATUS_OK, CAQueueingLanesInitialize(&lanes, pool, 2, laneTask, NULL));
+    ASSERT_EQ(CA_STATUS_OK, CAQueueingLanesStart(&lanes));
+
+    for (int seq = 0; seq < 100; seq++)
+    {
+        for (int lane = 0; lane < LANE_COUNT; lane++)
+        {
+            LaneItem *item = (LaneItem *) EdgeMalloc(sizeof(LaneItem));
+            item->lane = lane;
+            item->seq = seq;
+            EXPECT_EQ(CA_STATUS_OK, CAQueueingLanesAddData(&lanes, keys[lane], item, sizeof(LaneItem)));
+        }
+    }
+
+    // lanes 1 and 2 must complete while lane 0 is blocked on its first item
+    for (int i = 0; i < WAIT_RETRY_COUNT && g_laneProcessed < 200; i++)
+    {
+        usleep(1000);
+    }
+    EXPECT_EQ(200, g_laneProcessed);
+    EXPECT_EQ(-1, g_laneLast[0]);
+
+    g_releaseSlowLane = true;
+    for (int i = 0; i < WAIT_RETRY_COUNT && g_laneProcessed < 300; i++)
+    {
+        usleep(1000);
+    }
+    EXPECT_EQ(300, g_laneProcessed);
+    EXPECT_TRUE(g_laneInOrder);
+
+    EXPECT_EQ(CA_STATUS_OK, CAQueueingLanesStop(&lanes));
+    ca_thread_pool_free(pool);
+    EXPECT_EQ(CA_STATUS_OK, CAQueueingLanesDestroy(&lanes));
+}
+
+static CAQueueingLanes_t g_selfStopLanes;
+static volatile bool g_selfStopped = false;
+
+static void selfStopTask(void *data)
+{
+    (void) data;
+    CAQueueingLanesStop(&g_selfStopLanes);
+    CAQueueingLanesDestroy(&g_selfStopLanes);
+    g_selfStopped = true;
+}
+
+TEST(QueueingLanes, StopFromTask)
+{
+    g_selfStopped = false;
+    ca_thread_pool_t pool = NULL;
+    ASSERT_EQ(CA_STATUS_OK, ca_thread_pool_init(2, &pool));
+    ASSERT_EQ(CA_STATUS_OK, CAQueueingLanesInitialize(&g_selfStopLanes, pool, 2, selfStopTask, NULL));
+    ASSERT_EQ(CA_STATUS_OK, CAQueueingLanesStart(&g_selfStopLanes));
+
+    int *value = (int *) EdgeMalloc(sizeof(int));
+    EXPECT_EQ(CA_STATUS_OK, CAQueueingLanesAddData(&g_selfStopLanes, NULL, value, sizeof(int)));
+    for (int i = 0; i < WAIT_RETRY_COUNT && !g_selfStopped; i++)
+    {
+        usleep(1000);
+    }
+    EXPECT_TRUE(g_selfStopped);
+    ca_thread_pool_free(pool);
+}
+
+static int *newValue(int v)
+{
+    int *value = (int *) EdgeMalloc(sizeof(int));
+    *value = v;
+    return value;
+}
+
+static CAQueueingLanes_t g_restartLanes;
+static volatile int g_restartProcessed = 0;
+
+static void restartTask(void *data)
+{
+    (void) data;
+    if (1 == __atomic_add_fetch(&g_restartProcessed, 1, __ATOMIC_SEQ_CST))
+    {
+        CAQueueingLanesStop(&g_restartLanes);
+    }
+}
+
+TEST(QueueingLanes, RestartAfterStopFromTask)
+{
+    g_restartProcessed = 0;
+    ca_thread_pool_t pool = NULL;
+    ASSERT_EQ(CA_STATUS_OK, ca_thread_pool_init(2, &pool));
+    ASSERT_EQ(CA_STATUS_OK, CAQueueingLanesInitialize(&g_restartLanes, pool, 1, restartTask, NULL));
+    ASSERT_EQ(CA_STATUS_OK, CAQueueingLanesStart(&g_restartLanes));
+
+    // the lane of the stopping task still has data queued behind it
+    EXPECT_EQ(CA_STATUS_OK, CAQueueingLanesAddData(&g_restartLanes, "a", newValue(1), sizeof(int)));
+    EXPECT_EQ(CA_STATUS_OK, CAQueueingLanesAddData(&g_restartLanes, "a", newValue(2), sizeof(int)));
+    for (int i = 0; i < WAIT_RETRY_COUNT && g_restartProcessed < 1; i++)
+    {
+        usleep(1000);
+    }
+    usleep(10000);
+    EXPECT_EQ(1, g_restartProcessed);
+
+    ASSERT_EQ(CA_STATUS_OK, CAQueueingLanesStart(&g_restartLanes));
+    for (int i = 0; i < WAIT_RETRY_COUNT && g_restartProcessed < 2; i++)
+    {
+        usleep(1000);
+    }
+    EXPECT_EQ(2, g_restartProcessed);
+
+    // and the drained lane is scheduled again for new data
+    EXPECT_EQ(CA_STATUS_OK, CAQueueingLanesAddData(&g_restartLanes, "a", newValue(3), sizeof(int)));
+    for (int i = 0; i < WAIT_RETRY_COUNT && g_restartProcessed < 3; i++)
+    {
+        usleep(1000);
+    }
+    EXPECT_EQ(3, g_restartProcessed);
+
+    EXPECT_EQ(CA_STATUS_OK, CAQueueingLanesStop(&g_restartLanes));
+    ca_thread_pool_free(pool);
+    EXPECT_EQ(CA_STATUS_OK, CAQueueingLanesDestroy(&g_restartLanes));
+}
+
+static bool isEven(void *queued, uint32_t queuedSize, void *data, uint32_t size)
+{
+    (void) queuedSize;
+    (void) data;
+    (void) size;
+    return 0 == *(int *) queued % 2;
+}
+
+static bool sameTens(void *queued, uint32_t queuedSize, void *data, uint32_t size)
+{
+    (void) queuedSize;
+    (void) size;
+    return *(int *) queued / 10 == *(int *) data / 10;
+}
+
+static int takeValue(CAQueueingThread_t *thread)
+{
+    u_queue_message_t *message = u_priority_queue_get_element(thread->dataQueue);
+    if (NULL == message)
+    {
+        return -1;
+    }
+    int value = *(int *) message->msg;
+    EdgeFree(message->msg);
+    EdgeFree(message);
+    return value;
+}
+
+class QueueingThreadBoundsF : public testing::Test
+{
+protected:
+    virtual void SetUp()
+    {
+        ASSERT_EQ(CA_STATUS_OK, ca_thread_pool_init(2, &pool));
+        ASSERT_EQ(CA_STATUS_OK, CAQueueingThreadInitialize(&thread, pool, countTask, NULL));
+    }
+
+    virtual void TearDown()
+    {
+        EXPECT_EQ(CA_STATUS_OK, CAQueueingThreadStop(&thread));
+        ca_thread_pool_free(pool);
+        EXPECT_EQ(CA_STATUS_OK, CAQueueingThreadDestroy(&thread));
+    }
+
+    void addValues(int count)
+    {
+        for (int i = 0; i < count; i++)
+        {
+            EXPECT_EQ(CA_STATUS_OK, CAQueueingThreadAddData(&thread, newValue(i), sizeof(int)));
+        }
+    }
+
+    ca_thread_pool_t pool = NULL;
+    CAQueueingThread_t thread;
+};
+
+TEST_F(QueueingThreadBoundsF, InvalidParam)
+{
+    EXPECT_EQ(CA_STATUS_INVALID_PARAM, CAQueueingThreadSetBounds(NULL, 1,
+            CA_QUEUEING_OVERFLOW_REJECT, NULL));
+    EXPECT_EQ(CA_STATUS_INVALID_PARAM, CAQueueingThreadSetBounds(&thread, 1,
+            CA_QUEUEING_OVERFLOW_CONFLATE, NULL));
+}
+
+TEST_F(QueueingThreadBoundsF, Reject)
+{
+    ASSERT_EQ(CA_STATUS_OK, CAQueueingThreadSetBounds(&thread, 3, CA_QUEUEING_OVERFLOW_REJECT, NULL));
+    addValues(3);
+
+    int *value = newValue(3);
+    EXPECT_EQ(CA_STATUS_FAILED, CAQueueingThreadAddData(&thread, value, sizeof(int)));
+    EdgeFree(value);
+    EXPECT_EQ(static_cast<uint32_t>(3), u_priority_queue_get_size(thread.dataQueue));
+
+    // unbounded again
+    ASSERT_EQ(CA_STATUS_OK, CAQueueingThreadSetBounds(&thread, 0, CA_QUEUEING_OVERFLOW_REJECT, NULL));
+    EXPECT_EQ(CA_STATUS_OK, CAQueueingThreadAddData(&thread, newValue(3), sizeof(int)));
+    EXPECT_EQ(static_cast<uint32_t>(4), u_priority_queue_get_size(thread.dataQueue));
+}
+
+TEST_F(QueueingThreadBoundsF, DefaultPresizedQueue)
+{
+    // an unbounded queue starts with the default number of spare elements
+    u_queue_t *lowest = thread.dataQueue->levels[U_PRIORITY_QUEUE_LOWEST];
+    EXPECT_EQ(static_cast<uint32_t>(CA_QUEUEING_DEFAULT_CAPACITY), lowest->freeCount);
+
+    addValues(3);
+    EXPECT_EQ(static_cast<uint32_t>(CA_QUEUEING_DEFAULT_CAPACITY - 3), lowest->freeCount);
+}
+
+TEST_F(QueueingThreadBoundsF, PresizedQueue)
+{
+    // bounding the empty queue allocates its elements up front
+    ASSERT_EQ(CA_STATUS_OK, CAQueueingThreadSetBounds(&thread, 3, CA_QUEUEING_OVERFLOW_REJECT, NULL));
+    u_queue_t *lowest = thread.dataQueue->levels[U_PRIORITY_QUEUE_LOWEST];
+    EXPECT_EQ(static_cast<uint32_t>(3), lowest->freeCount);
+
+    addValues(3);
+    EXPECT_EQ(static_cast<uint32_t>(0), lowest->freeCount);
+    EXPECT_EQ(static_cast<uint32_t>(3), u_priority_queue_get_size(thread.dataQueue));
+
+    // a queue holding data is kept
+    ASSERT_EQ(CA_STATUS_OK, CAQueueingThreadSetBounds(&thread, 5, CA_QUEUEING_OVERFLOW_REJECT, NULL));
+    EXPECT_EQ(lowest, thread.dataQueue->levels[U_PRIORITY_QUEUE_LOWEST]);
+    EXPECT_EQ(static_cast<uint32_t>(3), u_priority_queue_get_size(thread.dataQueue));
+}
+
+TEST_F(QueueingThreadBoundsF, BlockWithoutConsumerRejects)
+{
+    ASSERT_EQ(CA_STATUS_OK, CAQueueingThreadSetBounds(&thread, 2, CA_QUEUEING_OVERFLOW_BLOCK, NULL));
+    addValues(2);
+
+    int *value = newValue(2);
+    EXPECT_EQ(CA_STATUS_FAILED, CAQueueingThreadAddData(&thread, value, sizeof(int)));
+    EdgeFree(value);
+}
+
+TEST_F(QueueingThreadBoundsF, DropOldest)
+{
+    ASSERT_EQ(CA_STATUS_OK, CAQueueingThreadSetBounds(&thread, 4,
+            CA_QUEUEING_OVERFLOW_DROP_OLDEST, isEven));
+    addValues(4);
+
+    // 0 and 2 are dropped, odd values are kept
+    EXPECT_EQ(CA_STATUS_OK, CAQueueingThreadAddData(&thread, newValue(5), sizeof(int)));
+    EXPECT_EQ(CA_STATUS_OK, CAQueueingThreadAddData(&thread, newValue(7), sizeof(int)));
+    int *value = newValue(9);
+    EXPECT_EQ(CA_STATUS_FAILED, CAQueueingThreadAddData(&thread, value, sizeof(int)));
+    EdgeFree(value);
+
+    int expected[4] = { 1, 3, 5, 7 };
+    for (int i = 0; i < 4; i++)
+    {
+        EXPECT_EQ(expected[i], takeValue(&thread));
+    }
+}
+
+TEST_F(QueueingThreadBoundsF, Conflate)
+{
+    ASSERT_EQ(CA_STATUS_OK, CAQueueingThreadSetBounds(&thread, 2,
+            CA_QUEUEING_OVERFLOW_CONFLATE, sameTens));
+    EXPECT_EQ(CA_STATUS_OK, CAQueueingThreadAddData(&thread, newValue(10), sizeof(int)));
+    EXPECT_EQ(CA_STATUS_OK, CAQueueingThreadAddData(&thread, newValue(20), sizeof(int)));
+
+    // replaces 10 in place
+    EXPECT_EQ(CA_STATUS_OK, CAQueueingThreadAddData(&thread, newValue(11), sizeof(int)));
+    int *value = newValue(30);
+    EXPECT_EQ(CA_STATUS_FAILED, CAQueueingThreadAddData(&thread, value, sizeof(int)));
+    EdgeFree(value);
+
+    EXPECT_EQ(static_cast<uint32_t>(2), u_priority_queue_get_size(thread.dataQueue));
+    EXPECT_EQ(11, takeValue(&thread));
+    EXPECT_EQ(20, takeValue(&thread));
+}
+
+static volatile bool g_blockReleased = false;
+
+static void blockingTask(void *data)
+{
+    (void) data;
+    for (int i = 0; i < WAIT_RETRY_COUNT && !g_blockReleased; i++)
+    {
+        usleep(1000);
+    }
+    __atomic_add_fetch(&g_processed, 1, __ATOMIC_SEQ_CST);
+}
+
+static void *produceBlocked(void *arg)
+{
+    CAQueueingThread_t *thread = (CAQueueingThread_t *) arg;
+    for (int i = 0; i < 10; i++)
+    {
+        EXPECT_EQ(CA_STATUS_OK, CAQueueingThreadAddData(thread, newValue(i), sizeof(int)));
+    }
+    return NULL;
+}
+
+TEST(QueueingThread, BoundsBlockProducer)
+{
+    g_processed = 0;
+    g_blockReleased = false;
+
+    ca_thread_pool_t pool = NULL;
+    ASSERT_EQ(CA_STATUS_OK, ca_thread_pool_init(2, &pool));
+    CAQueueingThread_t thread;
+    ASSERT_EQ(CA_STATUS_OK, CAQueueingThreadInitialize(&thread, pool, blockingTask, NULL));
+    ASSERT_EQ(CA_STATUS_OK, CAQueueingThreadSetBounds(&thread, 2, CA_QUEUEING_OVERFLOW_BLOCK, NULL));
+    ASSERT_EQ(CA_STATUS_OK, CAQueueingThreadStart(&thread));
+
+    pthread_t producer;
+    ASSERT_EQ(0, pthread_create(&producer, NULL, produceBlocked, &thread));
+
+    // the consumer holds one message, the queue holds two, the producer waits
+    usleep(100 * 1000);
+    oc_mutex_lock(thread.threadMutex);
+    EXPECT_GE(static_cast<uint32_t>(2), u_priority_queue_get_size(thread.dataQueue));
+    oc_mutex_unlock(thread.threadMutex);
+    EXPECT_EQ(0, g_processed);
+
+    g_blockReleased = true;
+    pthread_join(producer, NULL);
+    for (int i = 0; i < WAIT_RETRY_COUNT && g_processed < 10; i++)
+    {
+        usleep(1000);
+    }
+    EXPECT_EQ(10, g_processed);
+
+    EXPECT_EQ(CA_STATUS_OK, CAQueueingThreadStop(&thread));
+    ca_thread_pool_free(pool);
+    EXPECT_EQ(CA_STATUS_OK, CAQueueingThreadDestroy(&thread));
+}
+
+static uint32_t tensHash(void *data, uint32_t size)
+{
+    (void) size;
+    return *(int *) data / 10 + 1;
+}
+
+static volatile int g_recorded[16];
+static volatile int g_recordCount = 0;
+
+static void recordTask(void *data)
+{
+    int index = __atomic_load_n(&g_recordCount, __ATOMIC_SEQ_CST);
+    if (index < 16)
+    {
+        g_recorded[index] = *(int *) data;
+    }
+    __atomic_add_fetch(&g_recordCount, 1, __ATOMIC_SEQ_CST);
+}
+
+TEST(QueueingThread, Conflation)
+{
+    g_recordCount = 0;
+    ca_thread_pool_t pool = NULL;
+    ASSERT_EQ(CA_STATUS_OK, ca_thread_pool_init(2, &pool));
+    CAQueueingThread_t thread;
+    ASSERT_EQ(CA_STATUS_OK, CAQueueingThreadInitialize(&thread, pool, recordTask, NULL));
+    EXPECT_EQ(CA_STATUS_INVALID_PARAM, CAQueueingThreadSetConflation(&thread, tensHash, NULL));
+    ASSERT_EQ(CA_STATUS_OK, CAQueueingThreadSetConflation(&thread, tensHash, sameTens));
+
+    int values[5] = { 10, 20, 11, 12, 21 };
+    for (int i = 0; i < 5; i++)
+    {
+        EXPECT_EQ(CA_STATUS_OK, CAQueueingThreadAddData(&thread, newValue(values[i]), sizeof(int)));
+    }
+    // latest value of each key, in the position of the first one
+    EXPECT_EQ(static_cast<uint32_t>(2), u_priority_queue_get_size(thread.dataQueue));
+
+    ASSERT_EQ(CA_STATUS_OK, CAQueueingThreadStart(&thread));
+    EXPECT_EQ(CA_STATUS_FAILED, CAQueueingThreadSetConflation(&thread, NULL, NULL));
+    for (int i = 0; i < WAIT_RETRY_COUNT && g_recordCount < 2; i++)
+    {
+        usleep(1000);
+    }
+    ASSERT_EQ(2, g_recordCount);
+    EXPECT_EQ(12, g_recorded[0]);
+    EXPECT_EQ(21, g_recorded[1]);
+
+    // delivered data is no longer conflated
+    EXPECT_EQ(CA_STATUS_OK, CAQueueingThreadAddData(&thread, newValue(13), sizeof(int)));
+    for (int i = 0; i < WAIT_RETRY_COUNT && g_recordCount < 3; i++)
+    {
+        usleep(1000);
+    }
+    ASSERT_EQ(3, g_recordCount);
+    EXPECT_EQ(13, g_recorded[2]);
+
+    EXPECT_EQ(CA_STATUS_OK, CAQueueingThreadStop(&thread));
+    ca_thread_pool_free(pool);
+    EXPECT_EQ(CA_STATUS_OK, CAQueueingThreadDestroy(&thread));
+}
+
+TEST_F(QueueingThreadBoundsF, StatsCountDrops)
+{
+    CAQueueingStats_t stats;
+    EXPECT_EQ(CA_STATUS_INVALID_PARAM, CAQueueingThreadGetStats(&thread, NULL, false));
+    ASSERT_EQ(CA_STATUS_OK, CAQueueingThreadSetBounds(&thread, 2, CA_QUEUEING_OVERFLOW_REJECT, NULL));
+    addValues(2);
+    int *value = newValue(2);
+    EXPECT_EQ(CA_STATUS_FAILED, CAQueueingThreadAddData(&thread, value, sizeof(int)));
+    EdgeFree(value);
+
+    ASSERT_EQ(CA_STATUS_OK, CAQueueingThreadGetStats(&thread, &stats, true));
+    EXPECT_EQ(static_cast<uint64_t>(2), stats.enqueueCount);
+    EXPECT_EQ(static_cast<uint64_t>(1), stats.dropCount);
+    EXPECT_EQ(static_cast<uint32_t>(2), stats.depth);
+    EXPECT_EQ(static_cast<uint32_t>(2), stats.highWaterDepth);
+
+    // reset keeps the current depth as high water
+    ASSERT_EQ(CA_STATUS_OK, CAQueueingThreadGetStats(&thread, &stats, false));
+    EXPECT_EQ(static_cast<uint64_t>(0), stats.enqueueCount);
+    EXPECT_EQ(static_cast<uint64_t>(0), stats.dropCount);
+    EXPECT_EQ(static_cast<uint32_t>(2), stats.depth);
+    EXPECT_EQ(static_cast<uint32_t>(2), stats.highWaterDepth);
+}
+
+static void runStats(CAQueueingMode_t mode)
+{
+    g_recordCount = 0;
+    ca_thread_pool_t pool = NULL;
+    ASSERT_EQ(CA_STATUS_OK, ca_thread_pool_init(2, &pool));
+    CAQueueingThread_t thread;
+    ASSERT_EQ(CA_STATUS_OK, CAQueueingThreadInitializeWithMode(&thread, pool, recordTask, NULL, mode));
+
+    for (int i = 0; i < 5; i++)
+    {
+        EXPECT_EQ(CA_STATUS_OK, CAQueueingThreadAddData(&thread, newValue(i), sizeof(int)));
+    }
+    CAQueueingStats_t stats;
+    ASSERT_EQ(CA_STATUS_OK, CAQueueingThreadGetStats(&thread, &stats, false));
+    EXPECT_EQ(static_cast<uint64_t>(5), stats.enqueueCount);
+    EXPECT_EQ(static_cast<uint64_t>(0), stats.dequeueCount);
+    EXPECT_EQ(static_cast<uint32_t>(5), stats.depth);
+
+    ASSERT_EQ(CA_STATUS_OK, CAQueueingThreadStart(&thread));
+    for (int i = 0; i < WAIT_RETRY_COUNT && g_recordCount < 5; i++)
+    {
+        usleep(1000);
+    }
+    ASSERT_EQ(5, g_recordCount);
+    EXPECT_EQ(CA_STATUS_OK, CAQueueingThreadStop(&thread));
+
+    ASSERT_EQ(CA_STATUS_OK, CAQueueingThreadGetStats(&thread, &stats, true));
+    EXPECT_EQ(static_cast<uint64_t>(5), stats.enqueueCount);
+    EXPECT_EQ(static_cast<uint64_t>(5), stats.dequeueCount);
+    EXPECT_EQ(static_cast<uint32_t>(0), stats.depth);
+    EXPECT_EQ(static_cast<uint32_t>(5), stats.highWaterDepth);
+    EXPECT_GE(stats.totalWaitUs, stats.maxWaitUs);
+    uint64_t waits = 0;
+    for (int i = 0; i < CA_QUEUEING_WAIT_BUCKETS; i++)
+    {
+        waits += stats.waitHistogram[i];
+    }
+    EXPECT_EQ(static_cast<uint64_t>(5), waits);
+
+    ASSERT_EQ(CA_STATUS_OK, CAQueueingThreadGetStats(&thread, &stats, false));
+    EXPECT_EQ(static_cast<uint64_t>(0), stats.enqueueCount);
+    EXPECT_EQ(static_cast<uint64_t>(0), stats.dequeueCount);
+    EXPECT_EQ(static_cast<uint32_t>(0), stats.highWaterDepth);
+    EXPECT_EQ(static_cast<uint64_t>(0), stats.maxWaitUs);
+
+    ca_thread_pool_free(pool);
+    EXPECT_EQ(CA_STATUS_OK, CAQueueingThreadDestroy(&thread));
+}
+
+TEST(QueueingThread, LockedStats)
+{
+    runStats(CA_QUEUEING_MODE_LOCKED);
+}
+
+TEST(QueueingThread, LockFreeStats)
+{
+    runStats(CA_QUEUEING_MODE_LOCKFREE);
+}
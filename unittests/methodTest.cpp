@@ -120,6 +120,75 @@ void testMethod_P3(char *endpointUri)
     sleep(1);
 }
 
+void testMethodView_P(char *endpointUri)
+{
+    EdgeMessage *msg = createEdgeMessage(endpointUri, 1, CMD_METHOD);
+    ASSERT_EQ(NULL != msg, true);
+
+    EdgeResult ret = insertEdgeMethodParameter(&msg, "{2;S;v=0}string_view(x)", 1,
+                   EDGE_NODEID_STRING, SCALAR, (void*) "{\"payload\": \"string view\"}", NULL, 0);
+    ASSERT_EQ(ret.code, STATUS_OK);
+    ret = sendRequest(msg);
+    ASSERT_EQ(ret.code, STATUS_OK);
+
+    sleep(1);
+}
+
+void testMethodAsync_P(char *endpointUri)
+{
+    EdgeMessage *msg = createEdgeMessage(endpointUri, 1, CMD_METHOD);
+    ASSERT_EQ(NULL != msg, true);
+
+    EdgeResult ret = insertEdgeMethodParameter(&msg, "{2;S;v=0}print_string_async(x)", 1,
+                   EDGE_NODEID_STRING, SCALAR, (void*) "async string method", NULL, 0);
+    ASSERT_EQ(ret.code, STATUS_OK);
+    ret = sendRequest(msg);
+    ASSERT_EQ(ret.code, STATUS_OK);
+
+    /* The call completes at once, its output is written to its output node by the server loop */
+    sleep(1);
+
+    msg = createEdgeMessage(endpointUri, 1, CMD_READ);
+    ASSERT_EQ(NULL != msg, true);
+    EXPECT_EQ(insertReadAccessNode(&msg, "{2;S;v=12}print_string_async(x)_Output0").code, STATUS_OK);
+    ret = sendRequest(msg);
+    destroyEdgeMessage(msg);
+    EXPECT_EQ(ret.code, STATUS_OK);
+    sleep(1);
+}
+
+void testMethodBatch_P(char *endpointUri)
+{
+    /* All three calls go in one Call service request and come back in one response message */
+    EdgeMessage *msg = createEdgeMessage(endpointUri, 3, CMD_METHOD);
+    ASSERT_EQ(NULL != msg, true);
+
+    double *input = (double*) EdgeCalloc(1, sizeof(double));
+    ASSERT_EQ(NULL != input, true);
+    *input = 16.0;
+    EdgeResult ret = insertEdgeMethodParameter(&msg, "{2;S;v=0}square(x)", 1, EDGE_NODEID_DOUBLE,
+            SCALAR, (void *) input, NULL, 0);
+    EXPECT_EQ(ret.code, STATUS_OK);
+
+    ret = insertEdgeMethodParameter(&msg, "{2;S;v=0}print_string(x)", 1, EDGE_NODEID_STRING,
+            SCALAR, (void *) copyString("batch string method"), NULL, 0);
+    EXPECT_EQ(ret.code, STATUS_OK);
+
+    input = (double*) EdgeCalloc(1, sizeof(double));
+    ASSERT_EQ(NULL != input, true);
+    *input = 4.0;
+    ret = insertEdgeMethodParameter(&msg, "{2;S;v=0}square(x)", 1, EDGE_NODEID_DOUBLE,
+            SCALAR, (void *) input, NULL, 0);
+    EXPECT_EQ(ret.code, STATUS_OK);
+    EXPECT_EQ(msg->requestLength, 3);
+
+    ret = sendRequest(msg);
+    EXPECT_EQ(ret.code, STATUS_OK);
+    destroyEdgeMessage(msg);
+
+    sleep(1);
+}
+
 void testMethod_P4(char *endpointUri)
 {
     EdgeMessage *msg = createEdgeMessage(endpointUri, 1, CMD_METHOD);
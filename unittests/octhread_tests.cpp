@@ -565,3 +565,70 @@ TEST(ConditionTests, TC_07_WAITDURATION)
 
     oc_cond_free(sharedCond);
 }
+
+typedef struct _pool_struct
+{
+    oc_mutex lock;
+    int count;
+} _pool_struct;
+
+static void countFunc(void *param)
+{
+    _pool_struct *pData = (_pool_struct *) param;
+    oc_mutex_lock(pData->lock);
+    pData->count++;
+    oc_mutex_unlock(pData->lock);
+}
+
+static void blockFunc(void *param)
+{
+    volatile bool *release = (volatile bool *) param;
+    while (!*release)
+    {
+        usleep(MINIMAL_LOOP_SLEEP * USECS_PER_MSEC);
+    }
+}
+
+TEST(ThreadPoolTests, TC_01_MORE_TASKS_THAN_THREADS)
+{
+    ca_thread_pool_t mythreadpool;
+    EXPECT_EQ(CA_STATUS_OK, ca_thread_pool_init(2, &mythreadpool));
+
+    _pool_struct pData = { oc_mutex_new(), 0 };
+    for (int i = 0; i < 500; i++)
+    {
+        EXPECT_EQ(CA_STATUS_OK, ca_thread_pool_add_task(mythreadpool, countFunc, &pData, NULL));
+    }
+
+    // free returns only after every scheduled task ran
+    ca_thread_pool_free(mythreadpool);
+    EXPECT_EQ(500, pData.count);
+
+    oc_mutex_free(pData.lock);
+}
+
+TEST(ThreadPoolTests, TC_02_REMOVE_QUEUED_TASK)
+{
+    ca_thread_pool_t mythreadpool;
+    EXPECT_EQ(CA_STATUS_OK, ca_thread_pool_init(1, &mythreadpool));
+
+    volatile bool release = false;
+    uint32_t blockId = 0;
+    uint32_t countId = 0;
+    _pool_struct pData = { oc_mutex_new(), 0 };
+
+    EXPECT_EQ(CA_STATUS_OK, ca_thread_pool_add_task(mythreadpool, blockFunc, (void *) &release, &blockId));
+    EXPECT_EQ(CA_STATUS_OK, ca_thread_pool_add_task(mythreadpool, countFunc, &pData, &countId));
+    EXPECT_NE(blockId, countId);
+
+    // the only worker is blocked, so the second task is still queued
+    EXPECT_EQ(CA_STATUS_OK, ca_thread_pool_remove_task(mythreadpool, countId));
+
+    release = true;
+    EXPECT_EQ(CA_STATUS_OK, ca_thread_pool_remove_task(mythreadpool, blockId));
+
+    ca_thread_pool_free(mythreadpool);
+    EXPECT_EQ(0, pData.count);
+
+    oc_mutex_free(pData.lock);
+}
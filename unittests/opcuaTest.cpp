@@ -34,6 +34,11 @@ extern "C"
 #include "open62541.h"
 #include "test_common.h"
 #include "browse.h"
+#ifdef ENABLE_ASYNC_SERVICES
+#include "async_service.h"
+#include "browse_common.h"
+#include "server_capabilities.h"
+#endif
 }
 
 #define TAG "TC"
@@ -83,6 +88,10 @@ static bool browseNodeFlag = false;
 static bool methodCallFlag = false;
 static bool errorCallFlag = false;
 
+/* REPORT messages and their responses received by monitored_msg_cb */
+int reportCount = 0;
+int reportResponseCount = 0;
+
 char node_arr[46][30] =
 {
     "{2;S;v=12}String1", "{2;S;v=12}String2", "{2;S;v=12}String3", "{2;S;v=11}Double", "{2;S;v=6}Int32",
@@ -106,15 +115,31 @@ extern void testRead_P2(char *endpointUri);
 extern void testRead_P3(char *endpointUri);
 extern void testRead_P4(char *endpointUri);
 extern void testRead_P5(char *endpointUri);
+extern void testReadRegistered_P(char *endpointUri);
+extern void testReadTranslated_P(char *endpointUri);
+extern void testHistoryRead_P(char *endpointUri);
+extern void testReadPrepared_P(char *endpointUri);
+extern void testReadAndWait_P(char *endpointUri);
+extern void testReadAttributes_P(char *endpointUri);
+extern void testServerCapabilities_P(char *endpointUri);
+extern void testReadChunked_P(char *endpointUri);
+#ifdef ENABLE_ASYNC_SERVICES
+extern void testReadPipelined_P(char *endpointUri);
+extern void testAsyncServiceInFlight_P(char *endpointUri);
+extern void testAsyncServiceFallback_N(char *endpointUri);
+#endif
 extern void testReadWithoutEndpoint();
 extern void testReadWithoutCommand();
 extern void testReadWithoutValueAlias(char *endpointUri);
 extern void testReadWithoutMessage();
 
 extern void testWrite_P1(char *endpointUri);
+extern void testWriteChunked_P(char *endpointUri);
 extern void testWrite_P2(char *endpointUri);
 extern void testWrite_P3(char *endpointUri);
 extern void testWrite_P4(char *endpointUri);
+extern void testWriteCoalesced_P(char *endpointUri);
+extern void testWriteErrorsOnly_P(char *endpointUri);
 extern void testWriteWithoutCommand();
 extern void testWriteWithoutEndpoint();
 extern void testWriteWithoutValueAlias(char *endpointUri);
@@ -124,6 +149,9 @@ extern void testMethod_P1(char *endpointUri);
 extern void testMethod_P2(char *endpointUri);
 extern void testMethod_P3(char *endpointUri);
 extern void testMethod_P4(char *endpointUri);
+extern void testMethodView_P(char *endpointUri);
+extern void testMethodAsync_P(char *endpointUri);
+extern void testMethodBatch_P(char *endpointUri);
 extern void testMethodWithoutCommand();
 extern void testMethodWithoutParam();
 extern void testMethodWithoutEndpoint();
@@ -133,6 +161,13 @@ extern void testMethodWithoutMessage();
 extern void testSubscription_P1(char *endpointUri);
 extern void testSubscription_P2(char *endpointUri);
 extern void testSubscription_P3(char *endpointUri);
+extern void testSubscriptionBulk_P(char *endpointUri);
+extern void testSubscriptionDeadband_P(char *endpointUri);
+extern void testSubscriptionQueue_P(char *endpointUri);
+extern void testSubscriptionBatchedReports_P(char *endpointUri);
+extern void testSubscriptionPublishInterval_P(char *endpointUri);
+extern void testSubscriptionSessions_P(char *endpointUri, char *secondEndpointUri);
+extern void testSubscriptionInvalidFilter(char *endpointUri);
 extern void testSubscriptionWithoutCommand(char *endpointUri);
 extern void testSubscriptionWithoutEndpoint();
 extern void testSubscriptionWithoutValueAlias(char *endpointUri);
@@ -456,6 +491,8 @@ extern "C"
     {
         if (data->type == REPORT)
         {
+            reportCount++;
+            reportResponseCount += data->responseLength;
             printf("[Application response Callback] Monitored Item Response received\n");
             int len = data->responseLength;
             int idx = 0;
@@ -737,6 +774,85 @@ void string_method(int inpSize, void **input, int outSize, void **output)
     output[0] = (void *) outputArray;
 }
 
+/* Echoes the string input without copying it and returns its length */
+void string_view_method(int inpSize, void **input, int outSize, EdgeMethodOutputs *outputs)
+{
+    Edge_String *inp = (Edge_String *) input[0];
+    uint32_t *length = (uint32_t *) getMethodOutputBuffer(outputs, 0);
+    if (NULL != length)
+    {
+        *length = (uint32_t) inp->length;
+    }
+    setMethodOutputString(outputs, 1, 0, (const char *) inp->data, inp->length);
+}
+
+/* Value of the data source node, produced and taken by its callbacks */
+static int32_t dataSourceValue = 5;
+
+static bool data_source_read(const char *browseName, void *context, EdgeVersatility *value)
+{
+    value->value = context;
+    return true;
+}
+
+static bool data_source_write(const char *browseName, void *context, const EdgeVersatility *value)
+{
+    *(int32_t *) context = *(const int32_t *) value->value;
+    return true;
+}
+
+/* Binary nodeset of an object and an Int32 variable which it organizes, little-endian */
+#define NODESET_PATH "/tmp/edge_nodeset_test.bin"
+#define NODESET_STRINGS "NodesetDevice\0NodesetInt32"
+
+static void put_le(uint8_t *p, uint32_t value, int size)
+{
+    for (int i = 0; i < size; i++)
+    {
+        p[i] = (uint8_t) (value >> (8 * i));
+    }
+}
+
+static bool write_nodeset(const char *path, size_t truncate)
+{
+    uint8_t data[24 + 2 * 40 + 12 + 4 + sizeof(NODESET_STRINGS)];
+    memset(data, 0, sizeof(data));
+    memcpy(data, "EDNS", 4);
+    put_le(data + 4, 1, 2);
+    put_le(data + 8, 2, 4);
+    put_le(data + 12, 1, 4);
+    put_le(data + 16, 4, 4);
+    put_le(data + 20, sizeof(NODESET_STRINGS), 4);
+
+    uint8_t *object = data + 24;
+    put_le(object + 8, 0, 4);
+    put_le(object + 12, 0xFFFFFFFF, 4);
+    put_le(object + 16, 0xFFFFFFFF, 4);
+    put_le(object + 28, OBJECT_NODE, 2);
+
+    uint8_t *variable = object + 40;
+    put_le(variable + 8, 14, 4);
+    put_le(variable + 12, 0xFFFFFFFF, 4);
+    put_le(variable + 16, 0, 4);
+    put_le(variable + 28, VARIABLE_NODE, 2);
+    put_le(variable + 30, EDGE_NODEID_INT32, 2);
+
+    uint8_t *reference = variable + 40;
+    put_le(reference, 0, 4);
+    put_le(reference + 4, 14, 4);
+    put_le(reference + 8, EDGE_NODEID_HASCOMPONENT, 2);
+    reference[10] = 1;
+
+    put_le(reference + 12, 1234, 4);
+    memcpy(reference + 16, NODESET_STRINGS, sizeof(NODESET_STRINGS));
+
+    FILE *fp = fopen(path, "wb");
+    VERIFY_NON_NULL(fp, false);
+    bool written = fwrite(data, 1, sizeof(data) - truncate, fp) == sizeof(data) - truncate;
+    fclose(fp);
+    return written;
+}
+
 static void configureCallbacks()
 {
     PRINT("-----INITIALIZING CALLBACKS-----");
@@ -777,25 +893,25 @@ static void cleanCallbacks()
 
     if (config->recvCallback != NULL)
     {
-        free(config->recvCallback);
+        EdgeFree(config->recvCallback);
         config->recvCallback = NULL;
     }
 
     if (config->statusCallback != NULL)
     {
-        free(config->statusCallback);
+        EdgeFree(config->statusCallback);
         config->statusCallback = NULL;
     }
 
     if (config->discoveryCallback != NULL)
     {
-        free(config->discoveryCallback);
+        EdgeFree(config->discoveryCallback);
         config->discoveryCallback = NULL;
     }
 
     if (config != NULL)
     {
-        free(config);
+        EdgeFree(config);
         config = NULL;
     }
 }
@@ -804,13 +920,13 @@ static void deleteMessage(EdgeMessage *msg, EdgeEndPointInfo *ep)
 {
     if (msg != NULL)
     {
-        free(msg);
+        EdgeFree(msg);
         msg = NULL;
     }
 
     if (ep != NULL)
     {
-        free(ep);
+        EdgeFree(ep);
         ep = NULL;
     }
 }
@@ -869,6 +985,18 @@ static void browseNodeWithoutMessage()
     ASSERT_EQ(result.code, STATUS_PARAM_INVALID);
 }
 
+static void browseNodeTakeWithoutBrowseParam()
+{
+    EdgeMessage *msg = createEdgeMessage(endpointUri, 1, CMD_BROWSE);
+    EXPECT_EQ(NULL != msg, true);
+    /* invalid message is released by sendRequestTake */
+    EdgeResult result = sendRequestTake(msg);
+    ASSERT_EQ(result.code, STATUS_PARAM_INVALID);
+
+    result = sendRequestTake(NULL);
+    ASSERT_EQ(result.code, STATUS_PARAM_INVALID);
+}
+
 static void browseNodeWithoutBrowseParam()
 {
     EdgeMessage *msg = createEdgeMessage(endpointUri, 1, CMD_BROWSE);
@@ -977,6 +1105,265 @@ static void browse_next()
     browseNodeFlag = false;
 }
 
+static bool countBrowseResult(EdgeMessage *data, void *context)
+{
+    size_t *count = (size_t *) context;
+    (*count)++;
+    return *count < 2;
+}
+
+static void browseNodeStream()
+{
+    EdgeMessage *msg = createEdgeMessage(endpointUri, 1, CMD_BROWSE);
+    EXPECT_EQ(NULL != msg, true);
+
+    EdgeNodeInfo* nodeInfo = createEdgeNodeInfoForNodeId(EDGE_INTEGER, EDGE_NODEID_ROOTFOLDER,
+            SYSTEM_NAMESPACE_INDEX);
+    size_t count = 0;
+    EdgeBrowseParameter param = {DIRECTION_FORWARD, 0};
+    param.maxDepth = 2;
+    param.resultCallback = countBrowseResult;
+    param.resultContext = &count;
+    insertBrowseParameter(&msg, nodeInfo, param);
+
+    EXPECT_EQ(browseNodeFlag, false);
+    sendRequest(msg);
+    destroyEdgeMessage(msg);
+    sleep(1);
+
+    /* The callback stops the browse at the second result, browse_msg_cb is not called */
+    EXPECT_EQ(count, (size_t) 2);
+    EXPECT_EQ(browseNodeFlag, false);
+}
+
+static void browseNodeMaxResults()
+{
+    EdgeMessage *msg = createEdgeMessage(endpointUri, 1, CMD_BROWSE);
+    EXPECT_EQ(NULL != msg, true);
+
+    EdgeNodeInfo* nodeInfo = createEdgeNodeInfoForNodeId(EDGE_INTEGER, EDGE_NODEID_ROOTFOLDER,
+            SYSTEM_NAMESPACE_INDEX);
+    size_t count = 0;
+    EdgeBrowseParameter param = {DIRECTION_FORWARD, 0};
+    param.nodeClassMask = EDGE_NODECLASS_OBJECT;
+    param.maxResults = 1;
+    param.resultCallback = countBrowseResult;
+    param.resultContext = &count;
+    insertBrowseParameter(&msg, nodeInfo, param);
+
+    sendRequest(msg);
+    destroyEdgeMessage(msg);
+    sleep(1);
+
+    EXPECT_EQ(count, (size_t) 1);
+}
+
+#define BROWSE_GRAPH_MAX_RESULTS 32
+
+typedef struct BrowseGraphResults
+{
+    size_t count;
+    char names[BROWSE_GRAPH_MAX_RESULTS][64];
+    char paths[BROWSE_GRAPH_MAX_RESULTS][256];
+} BrowseGraphResults;
+
+static bool collectBrowseResult(EdgeMessage *data, void *context)
+{
+    BrowseGraphResults *results = (BrowseGraphResults *) context;
+    if (results->count < BROWSE_GRAPH_MAX_RESULTS && data->browseResult)
+    {
+        snprintf(results->names[results->count], sizeof(results->names[0]), "%s",
+                data->browseResult->browseName);
+        if (data->responses[0]->message != NULL)
+        {
+            snprintf(results->paths[results->count], sizeof(results->paths[0]), "%s",
+                    (char *) data->responses[0]->message->value);
+        }
+        results->count++;
+    }
+    return true;
+}
+
+static size_t countBrowseGraphName(const BrowseGraphResults *results, const char *name)
+{
+    size_t count = 0;
+    for (size_t idx = 0; idx < results->count; idx++)
+    {
+        if (0 == strcmp(results->names[idx], name))
+        {
+            count++;
+        }
+    }
+    return count;
+}
+
+static void addBrowseGraphObject(const char *name, const char *parent)
+{
+    EdgeNodeId *sourceNodeId = (EdgeNodeId *) EdgeCalloc(1, sizeof(EdgeNodeId));
+    ASSERT_EQ(NULL != sourceNodeId, true);
+    /* Objects without a parent are organized by the Objects folder */
+    sourceNodeId->nodeId = (char *) parent;
+    EdgeNodeItem *item = createNodeItem(name, OBJECT_NODE, sourceNodeId);
+    ASSERT_EQ(NULL != item, true);
+    EXPECT_EQ(createNode(DEFAULT_NAMESPACE_VALUE, item).code, STATUS_OK);
+    EdgeFree(sourceNodeId);
+    deleteNodeItem(item);
+}
+
+static void addBrowseGraphReference(const char *source, const char *target)
+{
+    EdgeReference *reference = (EdgeReference *) EdgeCalloc(1, sizeof(EdgeReference));
+    ASSERT_EQ(NULL != reference, true);
+    reference->forward = true;
+    reference->sourceNamespace = (char *) DEFAULT_NAMESPACE_VALUE;
+    reference->sourcePath = (char *) source;
+    reference->targetNamespace = (char *) DEFAULT_NAMESPACE_VALUE;
+    reference->targetPath = (char *) target;
+    /* default reference ID : Organizes */
+    EXPECT_EQ(addReference(reference).code, STATUS_OK);
+    EdgeFree(reference);
+}
+
+/*
+ * GraphA organizes GraphB, GraphShared1 and GraphShared2. GraphB organizes GraphA again (cycle),
+ * GraphChild is organized by both GraphShared1 and GraphShared2 and organizes GraphLeaf.
+ */
+static void browseNodeGraph()
+{
+    addBrowseGraphObject("GraphA", NULL);
+    addBrowseGraphObject("GraphB", "GraphA");
+    addBrowseGraphObject("GraphShared1", "GraphA");
+    addBrowseGraphObject("GraphShared2", "GraphA");
+    addBrowseGraphObject("GraphChild", "GraphShared1");
+    addBrowseGraphObject("GraphLeaf", "GraphChild");
+    addBrowseGraphReference("GraphB", "GraphA");
+    addBrowseGraphReference("GraphShared2", "GraphChild");
+
+    EdgeMessage *msg = createEdgeMessage(endpointUri, 1, CMD_BROWSE);
+    ASSERT_EQ(NULL != msg, true);
+
+    EdgeNodeInfo* nodeInfo = createEdgeNodeInfo("{2;S;v=0}GraphA");
+    BrowseGraphResults results;
+    memset(&results, 0, sizeof(BrowseGraphResults));
+    EdgeBrowseParameter param = {DIRECTION_FORWARD, 0};
+    param.referenceTypeId = EDGE_NODEID_ORGANIZES;
+    param.resultCallback = collectBrowseResult;
+    param.resultContext = &results;
+    insertBrowseParameter(&msg, nodeInfo, param);
+
+    EXPECT_EQ(sendRequest(msg).code, STATUS_OK);
+    destroyEdgeMessage(msg);
+    sleep(1);
+
+    /* The cycle back to the start node is reported once and not browsed again */
+    EXPECT_EQ(countBrowseGraphName(&results, "GraphA"), (size_t) 1);
+    EXPECT_EQ(countBrowseGraphName(&results, "GraphB"), (size_t) 1);
+    EXPECT_EQ(countBrowseGraphName(&results, "GraphShared1"), (size_t) 1);
+    EXPECT_EQ(countBrowseGraphName(&results, "GraphShared2"), (size_t) 1);
+    /* A node with two parents is reported under each of them, but expanded once */
+    EXPECT_EQ(countBrowseGraphName(&results, "GraphChild"), (size_t) 2);
+    EXPECT_EQ(countBrowseGraphName(&results, "GraphLeaf"), (size_t) 1);
+    EXPECT_EQ(results.count, (size_t) 7);
+
+    bool underShared1 = false, underShared2 = false;
+    for (size_t idx = 0; idx < results.count; idx++)
+    {
+        const char *path = results.paths[idx];
+        const char *name = results.names[idx];
+        /* Paths start at the requested node and end with the value alias of the result */
+        EXPECT_EQ(0 == strncmp(path, "/GraphA/", strlen("/GraphA/")), true);
+        size_t pathLen = strlen(path), nameLen = strlen(name);
+        ASSERT_EQ(pathLen > nameLen, true);
+        EXPECT_EQ(0 == strcmp(path + pathLen - nameLen, name), true);
+        EXPECT_EQ('}', path[pathLen - nameLen - 1]);
+        EXPECT_EQ(NULL == strstr(path, "//"), true);
+        if (0 == strcmp(name, "GraphChild"))
+        {
+            underShared1 |= (NULL != strstr(path, "/GraphShared1/"));
+            underShared2 |= (NULL != strstr(path, "/GraphShared2/"));
+        }
+        if (0 == strcmp(name, "GraphLeaf"))
+        {
+            EXPECT_EQ(NULL != strstr(path, "/GraphChild/"), true);
+        }
+    }
+    EXPECT_EQ(underShared1, true);
+    EXPECT_EQ(underShared2, true);
+}
+
+#ifdef ENABLE_ASYNC_SERVICES
+/* Browse results in the order of the callbacks, errors are entries named "error" */
+static bool collectBrowseStream(EdgeMessage *data, void *context)
+{
+    BrowseGraphResults *results = (BrowseGraphResults *) context;
+    if (errorCallFlag && results->count < BROWSE_GRAPH_MAX_RESULTS)
+    {
+        snprintf(results->names[results->count++], sizeof(results->names[0]), "error");
+        errorCallFlag = false;
+    }
+    return collectBrowseResult(data, context);
+}
+
+/* Browses the graph with one node per Browse request and up to continuationPoints of them
+ * in flight, the browse runs on the calling thread */
+static void browseGraphStream(UA_Client *client, uint16_t continuationPoints,
+        BrowseGraphResults *results)
+{
+    EdgeServerCapabilities capabilities;
+    memset(&capabilities, 0, sizeof(EdgeServerCapabilities));
+    capabilities.maxBrowseContinuationPoints = continuationPoints;
+    capabilities.maxNodesPerBrowse = 1;
+    ASSERT_EQ(storeServerCapabilities(client, &capabilities), true);
+
+    EdgeMessage *msg = createEdgeMessage(endpointUri, 3, CMD_BROWSE);
+    ASSERT_EQ(NULL != msg, true);
+    EdgeBrowseParameter param = {DIRECTION_FORWARD, 0};
+    param.referenceTypeId = EDGE_NODEID_ORGANIZES;
+    param.resultCallback = collectBrowseStream;
+    param.resultContext = results;
+    insertBrowseParameter(&msg, createEdgeNodeInfo("{2;S;v=0}GraphA"), param);
+    insertBrowseParameter(&msg, createEdgeNodeInfo("{2;S;v=0}InvalidNodeXYZ"), param);
+    insertBrowseParameter(&msg, createEdgeNodeInfo("{2;S;v=0}GraphShared2"), param);
+
+    memset(results, 0, sizeof(BrowseGraphResults));
+    errorCallFlag = false;
+    browseNodes(client, msg);
+    if (errorCallFlag && results->count < BROWSE_GRAPH_MAX_RESULTS)
+    {
+        snprintf(results->names[results->count++], sizeof(results->names[0]), "error");
+        errorCallFlag = false;
+    }
+    destroyEdgeMessage(msg);
+}
+
+/* The pipelined walk passes the same results and errors in the same order as the
+ * synchronous walk */
+static void browseNodeGraphPipelined()
+{
+    UA_Client *client = UA_Client_new(UA_ClientConfig_default);
+    ASSERT_EQ(NULL != client, true);
+    ASSERT_EQ(UA_Client_connect(client, endpointUri), UA_STATUSCODE_GOOD);
+
+    BrowseGraphResults syncResults, pipelinedResults;
+    browseGraphStream(client, 1, &syncResults);
+    browseGraphStream(client, EDGE_BROWSE_MAX_IN_FLIGHT, &pipelinedResults);
+
+    EXPECT_GT(syncResults.count, (size_t) 1);
+    EXPECT_EQ(countBrowseGraphName(&syncResults, "error"), (size_t) 1);
+    ASSERT_EQ(pipelinedResults.count, syncResults.count);
+    for (size_t idx = 0; idx < syncResults.count; idx++)
+    {
+        EXPECT_STREQ(pipelinedResults.names[idx], syncResults.names[idx]);
+        EXPECT_STREQ(pipelinedResults.paths[idx], syncResults.paths[idx]);
+    }
+
+    removeServerCapabilities(client);
+    UA_Client_disconnect(client);
+    removeAsyncServices(client);
+    UA_Client_delete(client);
+}
+#endif
+
 static void startClient(char *addr, int port, char *securityPolicyUri)
 {
     PRINT("                       Client connect            ");
@@ -1036,11 +1423,11 @@ static void start_server(uint16_t port, char *appUri, EdgeApplicationType appTyp
 
     deleteMessage(msg, ep);
     cleanCallbacks();
-    free(endpointConfig);
-    free(appConfig);
+    EdgeFree(endpointConfig);
+    EdgeFree(appConfig);
     if (epInfo->endpointUri != NULL)
     {
-        free(epInfo->endpointUri);
+        EdgeFree(epInfo->endpointUri);
         epInfo->endpointUri = NULL;
     }
 }
@@ -1119,7 +1506,7 @@ protected:
     {
         if (epInfo != NULL)
         {
-            free(epInfo);
+            EdgeFree(epInfo);
             epInfo = NULL;
         }
     }
@@ -1178,7 +1565,7 @@ TEST_F(OPC_serverTests , InitializeServer_P)
 
     if (epInfo->endpointUri != NULL)
     {
-        free(epInfo->endpointUri);
+        EdgeFree(epInfo->endpointUri);
         epInfo->endpointUri = NULL;
     }
 }
@@ -1196,7 +1583,7 @@ TEST_F(OPC_serverTests , InitializeServer_N)
 
     if (epInfo->endpointUri != NULL)
     {
-        free(epInfo->endpointUri);
+        EdgeFree(epInfo->endpointUri);
         epInfo->endpointUri = NULL;
     }
 }
@@ -1215,7 +1602,7 @@ TEST_F(OPC_serverTests , ConfigureServer_P)
 
     if (epInfo->endpointUri != NULL)
     {
-        free(epInfo->endpointUri);
+        EdgeFree(epInfo->endpointUri);
         epInfo->endpointUri = NULL;
     }
 }
@@ -1287,12 +1674,12 @@ TEST_F(OPC_serverTests , StartServer_N)
 
     cleanCallbacks();
 
-    free(endpointConfig);
-    free(appConfig);
+    EdgeFree(endpointConfig);
+    EdgeFree(appConfig);
 
     if (epInfo->endpointUri != NULL)
     {
-        free(epInfo->endpointUri);
+        EdgeFree(epInfo->endpointUri);
         epInfo->endpointUri = NULL;
     }
 }
@@ -1520,10 +1907,10 @@ TEST_F(OPC_serverTests , StartServer_N1)
 
     cleanCallbacks();
 
-    free(appConfig);
+    EdgeFree(appConfig);
     if (epInfo->endpointUri != NULL)
     {
-        free(epInfo->endpointUri);
+        EdgeFree(epInfo->endpointUri);
         epInfo->endpointUri = NULL;
     }
 }
@@ -1557,10 +1944,10 @@ TEST_F(OPC_serverTests , StartServer_N2)
 
     cleanCallbacks();
 
-    free(endpointConfig);
+    EdgeFree(endpointConfig);
     if (epInfo->endpointUri != NULL)
     {
-        free(epInfo->endpointUri);
+        EdgeFree(epInfo->endpointUri);
         epInfo->endpointUri = NULL;
     }
 }
@@ -1612,12 +1999,12 @@ TEST_F(OPC_serverTests , StartServer_P)
 
     cleanCallbacks();
 
-    free(endpointConfig);
-    free(appConfig);
+    EdgeFree(endpointConfig);
+    EdgeFree(appConfig);
 
     if (epInfo->endpointUri != NULL)
     {
-        free(epInfo->endpointUri);
+        EdgeFree(epInfo->endpointUri);
         epInfo->endpointUri = NULL;
     }
 }
@@ -1685,6 +2072,18 @@ TEST_F(OPC_serverTests , ServerCreateNamespace_N4)
     ASSERT_EQ(result.code, STATUS_PARAM_INVALID);
 }
 
+TEST_F(OPC_serverTests , ServerGetNamespaceHandle_P)
+{
+    EXPECT_EQ(startServerFlag, true);
+
+    EXPECT_EQ(getNamespaceHandle(DEFAULT_NAMESPACE_VALUE) != NULL, true);
+    EXPECT_EQ(getNamespaceHandle("urn:unknown:namespace") == NULL, true);
+    EXPECT_EQ(getNamespaceHandle(NULL) == NULL, true);
+
+    EdgeResult result = createNodeByHandle(NULL, NULL);
+    EXPECT_EQ(result.code, STATUS_PARAM_INVALID);
+}
+
 TEST_F(OPC_serverTests , ServerCreateVariableNodeItem_P)
 {
     EdgeNodeItem* item = NULL;
@@ -1844,6 +2243,22 @@ TEST_F(OPC_serverTests , ServerCreateNode_N2)
     ASSERT_EQ(result.code, STATUS_PARAM_INVALID);
 }
 
+TEST_F(OPC_serverTests , ServerCreateNodes_N)
+{
+    EdgeResult result = createNodes(NULL, NULL, 0, NULL, 0);
+    ASSERT_EQ(result.code, STATUS_PARAM_INVALID);
+
+    result = createNodes(DEFAULT_NAMESPACE_VALUE, NULL, 1, NULL, 0);
+    ASSERT_EQ(result.code, STATUS_PARAM_INVALID);
+
+    EdgeNodeItem *items[1] = { NULL };
+    result = createNodes(DEFAULT_NAMESPACE_VALUE, items, 1, NULL, 0);
+    ASSERT_EQ(result.code, STATUS_PARAM_INVALID);
+
+    result = createNodes(DEFAULT_NAMESPACE_VALUE, NULL, 0, NULL, 1);
+    ASSERT_EQ(result.code, STATUS_PARAM_INVALID);
+}
+
 TEST_F(OPC_serverTests , ServerAddNodes_P)
 {
     start_server(12686, (char *) DEFAULT_SERVER_APP_URI_VALUE, EDGE_APPLICATIONTYPE_SERVER);
@@ -2856,9 +3271,61 @@ TEST_F(OPC_serverTests , ServerAddNodes_P)
     printf("\n|------------[Added] %s\n", methodNodeItem3->browseName);
     EdgeFree(methodNodeItem3);
 
+    EdgeNodeItem *methodNodeItem4 = (EdgeNodeItem *) EdgeMalloc(sizeof(EdgeNodeItem));
+    VERIFY_NON_NULL_NR(methodNodeItem4);
+    methodNodeItem4->browseName = "string_view(x)";
+    methodNodeItem4->sourceNodeId = NULL;
+
+    EdgeMethod *method4 = (EdgeMethod *) EdgeMalloc(sizeof(EdgeMethod));
+    method4->description = "string view";
+    method4->methodNodeName = "string_view";
+
+    method4->num_inpArgs = 1;
+    method4->inpArg = (EdgeArgument **) malloc(sizeof(EdgeArgument *) * method4->num_inpArgs);
+    method4->inpArg[0] = (EdgeArgument *) EdgeCalloc(1, sizeof(EdgeArgument));
+    method4->inpArg[0]->argType = EDGE_NODEID_STRING;
+    method4->inpArg[0]->valType = SCALAR;
+
+    method4->num_outArgs = 2;
+    method4->outArg = (EdgeArgument **) malloc(sizeof(EdgeArgument *) * method4->num_outArgs);
+    method4->outArg[0] = (EdgeArgument *) EdgeCalloc(1, sizeof(EdgeArgument));
+    method4->outArg[0]->argType = EDGE_NODEID_UINT32;
+    method4->outArg[0]->valType = SCALAR;
+    method4->outArg[1] = (EdgeArgument *) EdgeCalloc(1, sizeof(EdgeArgument));
+    method4->outArg[1]->argType = EDGE_NODEID_STRING;
+    method4->outArg[1]->valType = SCALAR;
+    createMethodNodeWithView(DEFAULT_NAMESPACE_VALUE, methodNodeItem4, method4, string_view_method);
+    printf("\n|------------[Added] %s\n", methodNodeItem4->browseName);
+    EdgeFree(methodNodeItem4);
+
+    EdgeNodeItem *methodNodeItem5 = (EdgeNodeItem *) EdgeMalloc(sizeof(EdgeNodeItem));
+    VERIFY_NON_NULL_NR(methodNodeItem5);
+    methodNodeItem5->browseName = "print_string_async(x)";
+    methodNodeItem5->sourceNodeId = NULL;
+
+    EdgeMethod *method5 = (EdgeMethod *) EdgeCalloc(1, sizeof(EdgeMethod));
+    method5->description = "print str on a method worker";
+    method5->methodNodeName = "print_async";
+    method5->method_fn = test_method_print_string;
+
+    method5->num_inpArgs = 1;
+    method5->inpArg = (EdgeArgument **) malloc(sizeof(EdgeArgument *) * method5->num_inpArgs);
+    method5->inpArg[0] = (EdgeArgument *) EdgeCalloc(1, sizeof(EdgeArgument));
+    method5->inpArg[0]->argType = EDGE_NODEID_STRING;
+    method5->inpArg[0]->valType = SCALAR;
+
+    method5->num_outArgs = 1;
+    method5->outArg = (EdgeArgument **) malloc(sizeof(EdgeArgument *) * method5->num_outArgs);
+    method5->outArg[0] = (EdgeArgument *) EdgeCalloc(1, sizeof(EdgeArgument));
+    method5->outArg[0]->argType = EDGE_NODEID_STRING;
+    method5->outArg[0]->valType = SCALAR;
+    createAsyncMethodNode(DEFAULT_NAMESPACE_VALUE, methodNodeItem5, method5);
+    printf("\n|------------[Added] %s\n", methodNodeItem5->browseName);
+    EdgeFree(methodNodeItem5);
+
     if (epInfo->endpointUri != NULL)
     {
-        free(epInfo->endpointUri);
+        EdgeFree(epInfo->endpointUri);
         epInfo->endpointUri = NULL;
     }
 
@@ -2894,6 +3361,59 @@ TEST_F(OPC_serverTests , ServerAddNodes_P)
     /* default reference ID : Organizes */
     addReference(reference);
     EdgeFree(reference);
+
+    /* Data source node, its value lives in dataSourceValue */
+    item = createDataSourceNodeItem("DataSourceInt32", EDGE_NODEID_INT32, VARIABLE_NODE,
+            data_source_read, data_source_write, &dataSourceValue, 100);
+    ASSERT_EQ(NULL != item, true);
+    result = createNode(DEFAULT_NAMESPACE_VALUE, item);
+    EXPECT_EQ(result.code, STATUS_OK);
+    deleteNodeItem(item);
+    EXPECT_EQ(NULL == createDataSourceNodeItem("DataSourceObject", EDGE_NODEID_INT32, OBJECT_NODE,
+            data_source_read, NULL, NULL, 100), true);
+    EXPECT_EQ(NULL == createDataSourceNodeItem("DataSourceNoRead", EDGE_NODEID_INT32,
+            VARIABLE_NODE, NULL, NULL, NULL, 100), true);
+
+    /* Batch of an object node and its variable nodes */
+    int32_t batchValues[2] = { 10, 20 };
+    EdgeNodeItem *batchItems[4] = { NULL, };
+    batchItems[0] = createNodeItem("BatchObject", OBJECT_NODE, NULL);
+    batchItems[1] = createVariableNodeItem("BatchInt", EDGE_NODEID_INT32, (void *) &batchValues[0],
+            VARIABLE_NODE, 100);
+    batchItems[2] = createVariableNodeItem("BatchInt2", EDGE_NODEID_INT32, (void *) &batchValues[1],
+            VARIABLE_NODE, 100);
+    batchItems[3] = createVariableNodeItem("BatchString", EDGE_NODEID_STRING, (void *) "batch",
+            VARIABLE_NODE, 100);
+
+    EdgeReference *batchReferences[3] = { NULL, };
+    for (int idx = 0; idx < 3; idx++)
+    {
+        batchReferences[idx] = (EdgeReference *) EdgeCalloc(1, sizeof(EdgeReference));
+        ASSERT_EQ(NULL != batchReferences[idx], true);
+        batchReferences[idx]->forward = true;
+        batchReferences[idx]->sourceNamespace = (char *) DEFAULT_NAMESPACE_VALUE;
+        batchReferences[idx]->sourcePath = (char *) "BatchObject";
+        batchReferences[idx]->targetNamespace = (char *) DEFAULT_NAMESPACE_VALUE;
+        batchReferences[idx]->targetPath = batchItems[idx + 1]->browseName;
+    }
+
+    /* Unknown namespace of a reference rejects the whole batch */
+    batchReferences[2]->targetNamespace = (char *) "urn:unknown:namespace";
+    result = createNodes(DEFAULT_NAMESPACE_VALUE, batchItems, 4, batchReferences, 3);
+    EXPECT_EQ(result.code, STATUS_PARAM_INVALID);
+
+    batchReferences[2]->targetNamespace = (char *) DEFAULT_NAMESPACE_VALUE;
+    result = createNodes(DEFAULT_NAMESPACE_VALUE, batchItems, 4, batchReferences, 3);
+    EXPECT_EQ(result.code, STATUS_OK);
+
+    for (int idx = 0; idx < 4; idx++)
+    {
+        deleteNodeItem(batchItems[idx]);
+    }
+    for (int idx = 0; idx < 3; idx++)
+    {
+        EdgeFree(batchReferences[idx]);
+    }
 }
 
 TEST_F(OPC_clientTests , ServerModifyVariableNode_P)
@@ -2919,6 +3439,15 @@ TEST_F(OPC_clientTests , ServerModifyVariableNode_P)
     EdgeFree(message);
     usleep(500 * 1000);
 
+    // Double through the namespace handle
+    message = (EdgeVersatility *) EdgeMalloc(sizeof(EdgeVersatility));
+    EXPECT_EQ(NULL != message, true);
+    d_val = 70.656;
+    message->value = &d_val;
+    result = modifyVariableNodeByHandle(getNamespaceHandle(DEFAULT_NAMESPACE_VALUE), "Double", message);
+    EXPECT_EQ(result.code, STATUS_OK);
+    EdgeFree(message);
+
     // String1
     message = (EdgeVersatility *) EdgeMalloc(sizeof(EdgeVersatility));
     EXPECT_EQ(NULL != message, true);
@@ -2987,94 +3516,488 @@ TEST_F(OPC_clientTests , ServerModifyVariableNode_P)
     EdgeFree(new_str);
 }
 
-TEST_F(OPC_clientTests , ServerModifyVariableNode_N1)
+TEST_F(OPC_clientTests , ServerModifyVariableNodes_P)
 {
-    EdgeVersatility *message = (EdgeVersatility *) EdgeMalloc(sizeof(EdgeVersatility));
-    ASSERT_EQ(NULL != message, true);
-    EdgeResult result = modifyVariableNode(NULL, "ByteStringArray", message);
-    ASSERT_EQ(result.code, STATUS_PARAM_INVALID);
-    EdgeFree(message);
+    int32_t val = 80;
+    double d_val = 80.656;
+    char str[] = "batch_str";
+    EdgeVersatility messages[3];
+    memset(messages, 0, sizeof(messages));
+    messages[0].value = &val;
+    messages[1].value = &d_val;
+    messages[2].value = str;
+    EdgeVersatility *values[3] = { &messages[0], &messages[1], &messages[2] };
+    const char *nodeUris[3] = { "Int32", "Double", "String1" };
+
+    EdgeResult result = modifyVariableNodes(DEFAULT_NAMESPACE_VALUE, nodeUris, values, 3);
+    EXPECT_EQ(result.code, STATUS_OK);
+
+    result = modifyVariableNodesByHandle(getNamespaceHandle(DEFAULT_NAMESPACE_VALUE), nodeUris,
+            values, 3);
+    EXPECT_EQ(result.code, STATUS_OK);
+
+    /* An unknown node fails the batch, the other nodes are still written */
+    const char *badNodeUris[3] = { "Int32", "UnknownNode", "String1" };
+    result = modifyVariableNodes(DEFAULT_NAMESPACE_VALUE, badNodeUris, values, 3);
+    EXPECT_EQ(result.code, STATUS_ERROR);
 }
 
-TEST_F(OPC_clientTests , ServerModifyVariableNode_N2)
+TEST_F(OPC_clientTests , ServerModifyVariableNodes_N)
 {
-    EdgeVersatility *message = (EdgeVersatility *) EdgeMalloc(sizeof(EdgeVersatility));
-    ASSERT_EQ(NULL != message, true);
-    EdgeResult result = modifyVariableNode(DEFAULT_NAMESPACE_VALUE, NULL, message);
-    ASSERT_EQ(result.code, STATUS_PARAM_INVALID);
-    EdgeFree(message);
+    int32_t val = 80;
+    EdgeVersatility message;
+    memset(&message, 0, sizeof(message));
+    message.value = &val;
+    EdgeVersatility *values[1] = { &message };
+    const char *nodeUris[1] = { "Int32" };
+    const char *nullNodeUris[1] = { NULL };
+
+    EdgeResult result = modifyVariableNodes(NULL, nodeUris, values, 1);
+    EXPECT_EQ(result.code, STATUS_PARAM_INVALID);
+    result = modifyVariableNodes(DEFAULT_NAMESPACE_VALUE, NULL, values, 1);
+    EXPECT_EQ(result.code, STATUS_PARAM_INVALID);
+    result = modifyVariableNodes(DEFAULT_NAMESPACE_VALUE, nullNodeUris, values, 1);
+    EXPECT_EQ(result.code, STATUS_PARAM_INVALID);
+    result = modifyVariableNodes(DEFAULT_NAMESPACE_VALUE, nodeUris, values, 0);
+    EXPECT_EQ(result.code, STATUS_PARAM_INVALID);
 }
 
-TEST_F(OPC_clientTests , ServerModifyVariableNode_N3)
+TEST_F(OPC_clientTests , ServerEnqueueVariableNodeUpdate_P)
 {
-    EdgeResult result = modifyVariableNode(DEFAULT_NAMESPACE_VALUE, "ByteStringArray", NULL);
-    ASSERT_EQ(result.code, STATUS_PARAM_INVALID);
+    EdgeNamespace *ns = getNamespaceHandle(DEFAULT_NAMESPACE_VALUE);
+    EdgeVariableNode *node = getVariableNodeHandle(ns, "Int32");
+    ASSERT_TRUE(node != NULL);
+    EXPECT_EQ(node, getVariableNodeHandle(ns, "Int32"));
+
+    int32_t val = 81;
+    EdgeVersatility message;
+    memset(&message, 0, sizeof(message));
+    message.value = &val;
+    for (int i = 0; i < 100; i++)
+    {
+        val = 81 + i;
+        EXPECT_EQ(enqueueVariableNodeUpdate(node, &message).code, STATUS_OK);
+    }
+
+    EdgeVariableNode *strNode = getVariableNodeHandle(ns, "String1");
+    ASSERT_TRUE(strNode != NULL);
+    char str[] = "queued_str";
+    message.value = str;
+    EXPECT_EQ(enqueueVariableNodeUpdate(strNode, &message).code, STATUS_OK);
 }
 
-TEST_F(OPC_clientTests , ConfigureClient_P)
+TEST_F(OPC_clientTests , ServerEnqueueVariableNodeUpdate_N)
 {
-    EXPECT_EQ(NULL == config, false);
+    EdgeNamespace *ns = getNamespaceHandle(DEFAULT_NAMESPACE_VALUE);
+    EXPECT_TRUE(getVariableNodeHandle(ns, "UnknownNode") == NULL);
+    EXPECT_TRUE(getVariableNodeHandle(NULL, "Int32") == NULL);
+    EXPECT_TRUE(getVariableNodeHandle(ns, NULL) == NULL);
 
-    EXPECT_EQ(NULL == config->recvCallback, false);
+    EdgeVariableNode *node = getVariableNodeHandle(ns, "Int32");
+    ASSERT_TRUE(node != NULL);
+    EdgeVersatility message;
+    memset(&message, 0, sizeof(message));
+    EXPECT_EQ(enqueueVariableNodeUpdate(node, NULL).code, STATUS_PARAM_INVALID);
+    EXPECT_EQ(enqueueVariableNodeUpdate(node, &message).code, STATUS_PARAM_INVALID);
+    EXPECT_EQ(enqueueVariableNodeUpdate(NULL, &message).code, STATUS_PARAM_INVALID);
+}
 
-    EXPECT_EQ(NULL == config->statusCallback, false);
+TEST_F(OPC_clientTests , ServerLoadNodeset_N)
+{
+    EdgeNamespace *ns = getNamespaceHandle(DEFAULT_NAMESPACE_VALUE);
+    EXPECT_EQ(loadNodeset(NULL, NODESET_PATH).code, STATUS_PARAM_INVALID);
+    EXPECT_EQ(loadNodeset(DEFAULT_NAMESPACE_VALUE, NULL).code, STATUS_PARAM_INVALID);
+    EXPECT_EQ(loadNodesetByHandle(NULL, NODESET_PATH).code, STATUS_PARAM_INVALID);
+    EXPECT_EQ(loadNodeset("UnknownNamespace", NODESET_PATH).code, STATUS_ERROR);
+    EXPECT_EQ(loadNodesetByHandle(ns, "/nonexistent/nodeset.bin").code, STATUS_ERROR);
 
-    EXPECT_EQ(NULL == config->discoveryCallback, false);
+    /* A truncated nodeset is rejected before any node is added */
+    ASSERT_TRUE(write_nodeset(NODESET_PATH, 1));
+    EXPECT_EQ(loadNodesetByHandle(ns, NODESET_PATH).code, STATUS_PARAM_INVALID);
+    EXPECT_TRUE(getVariableNodeHandle(ns, "NodesetInt32") == NULL);
+    remove(NODESET_PATH);
 }
 
-TEST_F(OPC_clientTests , InitializeClient_P)
+TEST_F(OPC_clientTests , ServerLoadNodeset_P)
 {
-    EXPECT_EQ(strcmp(ipAddress, IPADDRESS) == 0, true);
-
-    EXPECT_EQ(strcmp(endpointUri, ENDPOINT_URI) == 0, false);
+    ASSERT_TRUE(write_nodeset(NODESET_PATH, 0));
+    EdgeResult result = loadNodeset(DEFAULT_NAMESPACE_VALUE, NODESET_PATH);
+    EXPECT_EQ(result.code, STATUS_OK);
 
-    EXPECT_EQ(strcmp(endpointUri, ipAddress) == 0, true);
+    /* Loaded variable nodes are regular nodes of the namespace */
+    EdgeNamespace *ns = getNamespaceHandle(DEFAULT_NAMESPACE_VALUE);
+    EXPECT_TRUE(getVariableNodeHandle(ns, "NodesetInt32") != NULL);
+    int32_t value = 4321;
+    EdgeVersatility message;
+    memset(&message, 0, sizeof(message));
+    message.value = &value;
+    EXPECT_EQ(modifyVariableNode(DEFAULT_NAMESPACE_VALUE, "NodesetInt32", &message).code,
+            STATUS_OK);
+    remove(NODESET_PATH);
 }
 
-TEST_F(OPC_clientTests , FindServers_P1)
+TEST_F(OPC_clientTests , ServerStats_N)
 {
-    findServersHelper();
+    EdgeServerStats stats;
+    EXPECT_EQ(getServerStats(NULL).code, STATUS_PARAM_INVALID);
+    EXPECT_EQ(getServerInstanceStats(NULL, NULL).code, STATUS_PARAM_INVALID);
+    EXPECT_EQ(getServerInstanceStats(NULL, &stats).code, STATUS_ERROR);
 }
 
-TEST_F(OPC_clientTests , FindServers_P2)
+TEST_F(OPC_clientTests , ServerStats_P)
 {
-    size_t serverUrisSize = 2;
-    unsigned char *serverUris[2] = {NULL};
-    serverUris[0] = (unsigned char *)"urn:digitalpetri:opcua:client";
-    serverUris[1] = (unsigned char *)"urn:digitalpetri:opcua:invalid_client";
-    size_t localeIdsSize = 0;
-    unsigned char **localeIds = NULL;
-    EdgeApplicationConfig *registeredServers = NULL;
-    size_t registeredServersSize = 0;
-    EdgeResult res = findServers(endpointUri, serverUrisSize, serverUris, localeIdsSize, localeIds, &registeredServersSize, &registeredServers);
-    EXPECT_EQ(res.code,STATUS_OK);
+    EdgeServerStats before;
+    ASSERT_EQ(getServerStats(&before).code, STATUS_OK);
+    EXPECT_GT(before.nodeCount, 0u);
 
-    printf("\nTotal number of registered servers at the given server: %zu\n", registeredServersSize);
-    for(size_t idx = 0; idx < registeredServersSize ; ++idx)
-    {
-        printf("Server[%zu] -> Application URI: %s\n", idx+1, registeredServers[idx].applicationUri);
-        printf("Server[%zu] -> Product URI: %s\n", idx+1, registeredServers[idx].productUri);
-        printf("Server[%zu] -> Application Name: %s\n", idx+1, registeredServers[idx].applicationName);
-        printf("Server[%zu] -> Application Type: %u\n", idx+1, registeredServers[idx].applicationType);
-        printf("Server[%zu] -> Gateway Server URI: %s\n", idx+1, registeredServers[idx].gatewayServerUri);
-        printf("Server[%zu] -> Discovery Profile URI: %s\n", idx+1, registeredServers[idx].discoveryProfileUri);
-        for(size_t i = 0; i < registeredServers[idx].discoveryUrlsSize; ++i)
-        {
-            printf("Server[%zu] -> Discovery URL[%zu]: %s\n", idx+1, i+1, registeredServers[idx].discoveryUrls[i]);
-        }
-    }
+    /* Nodes added to the nodestore are counted */
+    int32_t value = 11;
+    EdgeNodeItem *item = createVariableNodeItem("StatsInt32", EDGE_NODEID_INT32, (void *) &value,
+            VARIABLE_NODE, 100);
+    ASSERT_TRUE(item != NULL);
+    EXPECT_EQ(createNode(DEFAULT_NAMESPACE_VALUE, item).code, STATUS_OK);
+    deleteNodeItem(item);
 
-    // Application has to deallocate the memory for EdgeApplicationConfig array and its members.
-    for(size_t idx = 0; idx < registeredServersSize ; ++idx)
+    EdgeServerStats after;
+    ASSERT_EQ(getServerStats(&after).code, STATUS_OK);
+    EXPECT_GT(after.nodeCount, before.nodeCount);
+    EXPECT_GE(after.sessionTotal, after.sessionCount);
+    for (int i = 0; i < EDGE_SERVER_SERVICES; i++)
     {
-        destroyEdgeApplicationConfigMembers(&registeredServers[idx]);
+        EXPECT_LE(after.services[i].errorCount, after.services[i].latency.count);
     }
-    EdgeFree(registeredServers);
 }
 
-TEST_F(OPC_clientTests , FindServers_P3)
+TEST_F(OPC_clientTests , ClientStats_N)
 {
-    size_t serverUrisSize = 0;
+    EdgeClientStats stats;
+    EXPECT_EQ(getClientStats(NULL, &stats).code, STATUS_PARAM_INVALID);
+    EXPECT_EQ(getClientStats(endpointUri, NULL).code, STATUS_PARAM_INVALID);
+    EXPECT_EQ(getClientStats("opc.tcp://localhost:12699/none", &stats).code, STATUS_ERROR);
+
+    /* Metrics are described even without connected endpoints */
+    char *text = getClientMetricsText();
+    ASSERT_TRUE(text != NULL);
+    EXPECT_TRUE(strstr(text, "# TYPE edge_client_requests_total counter") != NULL);
+    EXPECT_TRUE(strstr(text, "# TYPE edge_client_service_latency_seconds histogram") != NULL);
+    EdgeFree(text);
+}
+
+TEST_F(OPC_clientTests , ServerInstance_P)
+{
+    EdgeEndpointConfig endpointConfig;
+    memset(&endpointConfig, 0, sizeof(endpointConfig));
+    endpointConfig.bindAddress = ipAddress;
+    endpointConfig.bindPort = 12688;
+    endpointConfig.serverName = (char *) DEFAULT_SERVER_NAME_VALUE;
+
+    EdgeApplicationConfig appConfig;
+    memset(&appConfig, 0, sizeof(appConfig));
+    appConfig.applicationName = (char *) DEFAULT_SERVER_APP_NAME_VALUE;
+    appConfig.applicationUri = (char *) DEFAULT_SERVER_APP_URI_VALUE;
+    appConfig.productUri = (char *) DEFAULT_PRODUCT_URI_VALUE;
+
+    EdgeEndPointInfo ep;
+    memset(&ep, 0, sizeof(ep));
+    ep.endpointUri = (char *) "opc.tcp://localhost:12688/edge-opc-server";
+    ep.endpointConfig = &endpointConfig;
+    ep.appConfig = &appConfig;
+
+    /* The instance runs beside the server of createServer() */
+    EdgeServer *instance = createServerInstance(&ep);
+    ASSERT_TRUE(instance != NULL);
+
+    /* Namespaces and nodes of the instance are its own */
+    EXPECT_TRUE(getNamespaceHandleInInstance(instance, DEFAULT_NAMESPACE_VALUE) == NULL);
+    EdgeResult result = createNamespaceInInstance(instance, DEFAULT_NAMESPACE_VALUE,
+            DEFAULT_ROOT_NODE_INFO_VALUE, DEFAULT_ROOT_NODE_INFO_VALUE,
+            DEFAULT_ROOT_NODE_INFO_VALUE);
+    EXPECT_EQ(result.code, STATUS_OK);
+    EdgeNamespace *ns = getNamespaceHandleInInstance(instance, DEFAULT_NAMESPACE_VALUE);
+    ASSERT_TRUE(ns != NULL);
+    EXPECT_NE(ns, getNamespaceHandle(DEFAULT_NAMESPACE_VALUE));
+
+    int32_t value = 7;
+    EdgeNodeItem *item = createVariableNodeItem("Int32", EDGE_NODEID_INT32, (void *) &value,
+            VARIABLE_NODE, 100);
+    ASSERT_TRUE(item != NULL);
+    EXPECT_EQ(createNodeByHandle(ns, item).code, STATUS_OK);
+    deleteNodeItem(item);
+
+    EdgeVariableNode *node = getVariableNodeHandle(ns, "Int32");
+    ASSERT_TRUE(node != NULL);
+    EXPECT_NE(node, getVariableNodeHandle(getNamespaceHandle(DEFAULT_NAMESPACE_VALUE), "Int32"));
+
+    EdgeVersatility message;
+    memset(&message, 0, sizeof(message));
+    value = 8;
+    message.value = &value;
+    EXPECT_EQ(modifyVariableNodeByHandle(ns, "Int32", &message).code, STATUS_OK);
+    EXPECT_EQ(enqueueVariableNodeUpdate(node, &message).code, STATUS_OK);
+
+    /* A second instance cannot bind the same port */
+    EXPECT_TRUE(createServerInstance(&ep) == NULL);
+
+    closeServerInstance(instance, &ep);
+
+    /* The stop callback of the instance does not stop the server of createServer() */
+    startServerFlag = true;
+    EXPECT_TRUE(getNamespaceHandle(DEFAULT_NAMESPACE_VALUE) != NULL);
+}
+
+TEST_F(OPC_clientTests , ServerWriteOnChange_P)
+{
+    EdgeEndpointConfig endpointConfig;
+    memset(&endpointConfig, 0, sizeof(endpointConfig));
+    endpointConfig.bindAddress = ipAddress;
+    endpointConfig.bindPort = 12689;
+    endpointConfig.serverName = (char *) DEFAULT_SERVER_NAME_VALUE;
+    endpointConfig.writeOnChange = true;
+
+    EdgeApplicationConfig appConfig;
+    memset(&appConfig, 0, sizeof(appConfig));
+    appConfig.applicationName = (char *) DEFAULT_SERVER_APP_NAME_VALUE;
+    appConfig.applicationUri = (char *) DEFAULT_SERVER_APP_URI_VALUE;
+    appConfig.productUri = (char *) DEFAULT_PRODUCT_URI_VALUE;
+
+    EdgeEndPointInfo ep;
+    memset(&ep, 0, sizeof(ep));
+    ep.endpointUri = (char *) "opc.tcp://localhost:12689/edge-opc-server";
+    ep.endpointConfig = &endpointConfig;
+    ep.appConfig = &appConfig;
+
+    EdgeServer *instance = createServerInstance(&ep);
+    ASSERT_TRUE(instance != NULL);
+    EXPECT_EQ(createNamespaceInInstance(instance, DEFAULT_NAMESPACE_VALUE,
+            DEFAULT_ROOT_NODE_INFO_VALUE, DEFAULT_ROOT_NODE_INFO_VALUE,
+            DEFAULT_ROOT_NODE_INFO_VALUE).code, STATUS_OK);
+    EdgeNamespace *ns = getNamespaceHandleInInstance(instance, DEFAULT_NAMESPACE_VALUE);
+    ASSERT_TRUE(ns != NULL);
+
+    int32_t value = 7;
+    EdgeNodeItem *item = createVariableNodeItem("Int32", EDGE_NODEID_INT32, (void *) &value,
+            VARIABLE_NODE, 100);
+    ASSERT_TRUE(item != NULL);
+    EXPECT_EQ(createNodeByHandle(ns, item).code, STATUS_OK);
+    deleteNodeItem(item);
+    item = createVariableNodeItem("String1", EDGE_NODEID_STRING, (void *) "test1",
+            VARIABLE_NODE, 100);
+    ASSERT_TRUE(item != NULL);
+    EXPECT_EQ(createNodeByHandle(ns, item).code, STATUS_OK);
+    deleteNodeItem(item);
+
+    EdgeServerStats before;
+    ASSERT_EQ(getServerInstanceStats(instance, &before).code, STATUS_OK);
+    EXPECT_EQ(before.unchangedWriteCount, 0u);
+
+    /* Values which the nodes hold already are not written */
+    EdgeVersatility message;
+    memset(&message, 0, sizeof(message));
+    message.value = &value;
+    EXPECT_EQ(modifyVariableNodeByHandle(ns, "Int32", &message).code, STATUS_OK);
+    message.value = (void *) "test1";
+    EXPECT_EQ(modifyVariableNodeByHandle(ns, "String1", &message).code, STATUS_OK);
+
+    EdgeServerStats after;
+    ASSERT_EQ(getServerInstanceStats(instance, &after).code, STATUS_OK);
+    EXPECT_EQ(after.unchangedWriteCount, 2u);
+
+    /* Changed values are written, and then the new value is the one which is compared */
+    value = 8;
+    message.value = &value;
+    EXPECT_EQ(modifyVariableNodeByHandle(ns, "Int32", &message).code, STATUS_OK);
+    message.value = (void *) "test2";
+    EXPECT_EQ(modifyVariableNodeByHandle(ns, "String1", &message).code, STATUS_OK);
+    ASSERT_EQ(getServerInstanceStats(instance, &after).code, STATUS_OK);
+    EXPECT_EQ(after.unchangedWriteCount, 2u);
+
+    message.value = &value;
+    EXPECT_EQ(modifyVariableNodeByHandle(ns, "Int32", &message).code, STATUS_OK);
+    ASSERT_EQ(getServerInstanceStats(instance, &after).code, STATUS_OK);
+    EXPECT_EQ(after.unchangedWriteCount, 3u);
+
+    closeServerInstance(instance, &ep);
+    startServerFlag = true;
+}
+
+TEST_F(OPC_clientTests , ServerIterateTimeout_P)
+{
+    EdgeEndpointConfig endpointConfig;
+    memset(&endpointConfig, 0, sizeof(endpointConfig));
+    endpointConfig.bindAddress = ipAddress;
+    endpointConfig.bindPort = 12690;
+    endpointConfig.serverName = (char *) DEFAULT_SERVER_NAME_VALUE;
+    endpointConfig.iterateTimeout = 5;
+    endpointConfig.serverThreads = 2;
+
+    EdgeApplicationConfig appConfig;
+    memset(&appConfig, 0, sizeof(appConfig));
+    appConfig.applicationName = (char *) DEFAULT_SERVER_APP_NAME_VALUE;
+    appConfig.applicationUri = (char *) DEFAULT_SERVER_APP_URI_VALUE;
+    appConfig.productUri = (char *) DEFAULT_PRODUCT_URI_VALUE;
+
+    EdgeEndPointInfo ep;
+    memset(&ep, 0, sizeof(ep));
+    ep.endpointUri = (char *) "opc.tcp://localhost:12690/edge-opc-server";
+    ep.endpointConfig = &endpointConfig;
+    ep.appConfig = &appConfig;
+
+    EdgeServer *instance = createServerInstance(&ep);
+    ASSERT_TRUE(instance != NULL);
+    EXPECT_EQ(createNamespaceInInstance(instance, DEFAULT_NAMESPACE_VALUE,
+            DEFAULT_ROOT_NODE_INFO_VALUE, DEFAULT_ROOT_NODE_INFO_VALUE,
+            DEFAULT_ROOT_NODE_INFO_VALUE).code, STATUS_OK);
+    EdgeNamespace *ns = getNamespaceHandleInInstance(instance, DEFAULT_NAMESPACE_VALUE);
+    ASSERT_TRUE(ns != NULL);
+
+    int32_t value = 7;
+    EdgeNodeItem *item = createVariableNodeItem("Int32", EDGE_NODEID_INT32, (void *) &value,
+            VARIABLE_NODE, 100);
+    ASSERT_TRUE(item != NULL);
+    EXPECT_EQ(createNodeByHandle(ns, item).code, STATUS_OK);
+    deleteNodeItem(item);
+    EdgeVariableNode *node = getVariableNodeHandle(ns, "Int32");
+    ASSERT_TRUE(node != NULL);
+
+    /* Without network events the loop of the instance wakes up every 5 ms instead of the
+     * 50 ms of the library, so each queued update is written well before 50 ms */
+    EdgeVersatility message;
+    memset(&message, 0, sizeof(message));
+    message.value = &value;
+    int longestWait = 0;
+    for (int i = 0; i < 20; i++)
+    {
+        EdgeServerStats stats;
+        ASSERT_EQ(getServerInstanceStats(instance, &stats).code, STATUS_OK);
+        uint64_t updates = stats.updateCount;
+        value = 8 + i;
+        EXPECT_EQ(enqueueVariableNodeUpdate(node, &message).code, STATUS_OK);
+
+        int wait = 0;
+        while (wait < 200 && stats.updateCount == updates)
+        {
+            usleep(1000);
+            wait++;
+            ASSERT_EQ(getServerInstanceStats(instance, &stats).code, STATUS_OK);
+        }
+        EXPECT_GT(stats.updateCount, updates);
+        longestWait = wait > longestWait ? wait : longestWait;
+    }
+    EXPECT_LT(longestWait, 40);
+
+    closeServerInstance(instance, &ep);
+    startServerFlag = true;
+}
+
+TEST_F(OPC_clientTests , ServerInstance_N)
+{
+    EXPECT_TRUE(createServerInstance(NULL) == NULL);
+    EXPECT_EQ(createNamespaceInInstance(NULL, DEFAULT_NAMESPACE_VALUE,
+            DEFAULT_ROOT_NODE_INFO_VALUE, DEFAULT_ROOT_NODE_INFO_VALUE,
+            DEFAULT_ROOT_NODE_INFO_VALUE).code, STATUS_PARAM_INVALID);
+    EXPECT_TRUE(getNamespaceHandleInInstance(NULL, DEFAULT_NAMESPACE_VALUE) == NULL);
+}
+
+TEST_F(OPC_clientTests , ServerModifyDataSourceNode_P)
+{
+    /* The write goes to the write callback instead of the node */
+    int32_t val = 42;
+    EdgeVersatility message;
+    memset(&message, 0, sizeof(message));
+    message.value = &val;
+    EdgeResult result = modifyVariableNode(DEFAULT_NAMESPACE_VALUE, "DataSourceInt32", &message);
+    EXPECT_EQ(result.code, STATUS_OK);
+    EXPECT_EQ(dataSourceValue, 42);
+}
+
+TEST_F(OPC_clientTests , ServerModifyVariableNode_N1)
+{
+    EdgeVersatility *message = (EdgeVersatility *) EdgeMalloc(sizeof(EdgeVersatility));
+    ASSERT_EQ(NULL != message, true);
+    EdgeResult result = modifyVariableNode(NULL, "ByteStringArray", message);
+    ASSERT_EQ(result.code, STATUS_PARAM_INVALID);
+    EdgeFree(message);
+}
+
+TEST_F(OPC_clientTests , ServerModifyVariableNode_N2)
+{
+    EdgeVersatility *message = (EdgeVersatility *) EdgeMalloc(sizeof(EdgeVersatility));
+    ASSERT_EQ(NULL != message, true);
+    EdgeResult result = modifyVariableNode(DEFAULT_NAMESPACE_VALUE, NULL, message);
+    ASSERT_EQ(result.code, STATUS_PARAM_INVALID);
+    EdgeFree(message);
+}
+
+TEST_F(OPC_clientTests , ServerModifyVariableNode_N3)
+{
+    EdgeResult result = modifyVariableNode(DEFAULT_NAMESPACE_VALUE, "ByteStringArray", NULL);
+    ASSERT_EQ(result.code, STATUS_PARAM_INVALID);
+}
+
+TEST_F(OPC_clientTests , ConfigureClient_P)
+{
+    EXPECT_EQ(NULL == config, false);
+
+    EXPECT_EQ(NULL == config->recvCallback, false);
+
+    EXPECT_EQ(NULL == config->statusCallback, false);
+
+    EXPECT_EQ(NULL == config->discoveryCallback, false);
+}
+
+TEST_F(OPC_clientTests , InitializeClient_P)
+{
+    EXPECT_EQ(strcmp(ipAddress, IPADDRESS) == 0, true);
+
+    EXPECT_EQ(strcmp(endpointUri, ENDPOINT_URI) == 0, false);
+
+    EXPECT_EQ(strcmp(endpointUri, ipAddress) == 0, true);
+}
+
+TEST_F(OPC_clientTests , FindServers_P1)
+{
+    findServersHelper();
+}
+
+TEST_F(OPC_clientTests , FindServers_P2)
+{
+    size_t serverUrisSize = 2;
+    unsigned char *serverUris[2] = {NULL};
+    serverUris[0] = (unsigned char *)"urn:digitalpetri:opcua:client";
+    serverUris[1] = (unsigned char *)"urn:digitalpetri:opcua:invalid_client";
+    size_t localeIdsSize = 0;
+    unsigned char **localeIds = NULL;
+    EdgeApplicationConfig *registeredServers = NULL;
+    size_t registeredServersSize = 0;
+    EdgeResult res = findServers(endpointUri, serverUrisSize, serverUris, localeIdsSize, localeIds, &registeredServersSize, &registeredServers);
+    EXPECT_EQ(res.code,STATUS_OK);
+
+    printf("\nTotal number of registered servers at the given server: %zu\n", registeredServersSize);
+    for(size_t idx = 0; idx < registeredServersSize ; ++idx)
+    {
+        printf("Server[%zu] -> Application URI: %s\n", idx+1, registeredServers[idx].applicationUri);
+        printf("Server[%zu] -> Product URI: %s\n", idx+1, registeredServers[idx].productUri);
+        printf("Server[%zu] -> Application Name: %s\n", idx+1, registeredServers[idx].applicationName);
+        printf("Server[%zu] -> Application Type: %u\n", idx+1, registeredServers[idx].applicationType);
+        printf("Server[%zu] -> Gateway Server URI: %s\n", idx+1, registeredServers[idx].gatewayServerUri);
+        printf("Server[%zu] -> Discovery Profile URI: %s\n", idx+1, registeredServers[idx].discoveryProfileUri);
+        for(size_t i = 0; i < registeredServers[idx].discoveryUrlsSize; ++i)
+        {
+            printf("Server[%zu] -> Discovery URL[%zu]: %s\n", idx+1, i+1, registeredServers[idx].discoveryUrls[i]);
+        }
+    }
+
+    // Application has to deallocate the memory for EdgeApplicationConfig array and its members.
+    for(size_t idx = 0; idx < registeredServersSize ; ++idx)
+    {
+        destroyEdgeApplicationConfigMembers(&registeredServers[idx]);
+    }
+    EdgeFree(registeredServers);
+}
+
+TEST_F(OPC_clientTests , FindServers_P3)
+{
+    size_t serverUrisSize = 0;
    unsigned char **serverUris = NULL;
    size_t localeIdsSize = 1;
    unsigned char *localeIds[1] = {NULL};
@@ -3220,7 +4143,7 @@ TEST_F(OPC_clientTests , getEndpointInfo_N2)
 
     EdgeMessage *msg = createEdgeMessage(endpointUri, 1, CMD_GET_ENDPOINTS);
     EXPECT_EQ(NULL != msg, true);
-    free(msg->endpointInfo);
+    EdgeFree(msg->endpointInfo);
     msg->endpointInfo = NULL;
 
     EdgeResult res = getEndpointInfo(msg);
@@ -3228,6 +4151,74 @@ TEST_F(OPC_clientTests , getEndpointInfo_N2)
     destroyEdgeMessage(msg);
 }
 
+TEST_F(OPC_clientTests , ScanEndpoints_N)
+{
+    const char *uris[] = { endpointUri, NULL };
+
+    EXPECT_EQ(scanEndpoints(NULL, 1, 0, 0).code, STATUS_PARAM_INVALID);
+    EXPECT_EQ(scanEndpoints(uris, 0, 0, 0).code, STATUS_PARAM_INVALID);
+    EXPECT_EQ(scanEndpoints(uris, 2, 0, 0).code, STATUS_PARAM_INVALID);
+
+    EXPECT_EQ(scanEndpointRange(NULL, "127.0.0.1", 12686, 0, 0).code, STATUS_PARAM_INVALID);
+    EXPECT_EQ(scanEndpointRange("127.0.0.5", "127.0.0.1", 12686, 0, 0).code,
+            STATUS_PARAM_INVALID);
+    EXPECT_EQ(scanEndpointRange("127.0.0", "127.0.0.1", 12686, 0, 0).code, STATUS_PARAM_INVALID);
+    EXPECT_EQ(startClientFlag, false);
+}
+
+TEST_F(OPC_clientTests , ScanEndpoints_P)
+{
+    EXPECT_EQ(startClientFlag, false);
+
+    const char *uris[] = { endpointUri };
+    EXPECT_EQ(scanEndpoints(uris, 1, 4, 1000).code, STATUS_OK);
+    EXPECT_EQ(startClientFlag, true);
+
+    stop_client();
+    EXPECT_EQ(startClientFlag, false);
+}
+
+TEST_F(OPC_clientTests , EndpointCache_P)
+{
+    EXPECT_EQ(startClientFlag, false);
+    setEndpointCache(60000);
+
+    EdgeMessage *msg = createEdgeMessage(endpointUri, 1, CMD_GET_ENDPOINTS);
+    EXPECT_EQ(NULL != msg, true);
+
+    // Discovered from the server, then reported again from the cache
+    for (int i = 0; i < 2; i++)
+    {
+        EdgeResult res = getEndpointInfo(msg);
+        EXPECT_EQ(res.code, STATUS_OK);
+        EXPECT_EQ(startClientFlag, true);
+
+        stop_client();
+        EXPECT_EQ(startClientFlag, false);
+    }
+
+    invalidateEndpointCache(endpointUri);
+    invalidateEndpointCache("opc.tcp://");
+    EdgeResult res = getEndpointInfo(msg);
+    EXPECT_EQ(res.code, STATUS_OK);
+    EXPECT_EQ(startClientFlag, true);
+
+    destroyEdgeMessage(msg);
+    setEndpointCache(0);
+
+    stop_client();
+    EXPECT_EQ(startClientFlag, false);
+}
+
+TEST_F(OPC_clientTests , NetworkDiscovery_N)
+{
+    EXPECT_EQ(startNetworkDiscovery(NULL, 0).code, STATUS_PARAM_INVALID);
+
+    // Stopping a discovery which is not running does nothing
+    stopNetworkDiscovery();
+    EXPECT_EQ(startClientFlag, false);
+}
+
 TEST_F(OPC_clientTests , StartClient_P)
 {
     EXPECT_EQ(startClientFlag, false);
@@ -3334,7 +4325,7 @@ TEST_F(OPC_clientTests , ClientRead_P4)
     EXPECT_EQ(startClientFlag, false);
 }
 
-TEST_F(OPC_clientTests , ClientRead_P5)
+TEST_F(OPC_clientTests , ClientReadRegistered_P)
 {
     EXPECT_EQ(startClientFlag, false);
 
@@ -3349,36 +4340,488 @@ TEST_F(OPC_clientTests , ClientRead_P5)
     destroyEdgeMessage(msg);
 
     readNodeFlag = true;
-    testRead_P5(endpointUri);
+    testReadRegistered_P(endpointUri);
     readNodeFlag = false;
 
     stop_client();
     EXPECT_EQ(startClientFlag, false);
 }
 
-TEST_F(OPC_clientTests , ClientRead_N1)
+TEST_F(OPC_clientTests , ClientReadTranslated_P)
+{
+    EXPECT_EQ(startClientFlag, false);
+
+    EdgeMessage *msg = createEdgeMessage(endpointUri, 1, CMD_GET_ENDPOINTS);
+    EXPECT_EQ(NULL != msg, true);
+
+    EdgeResult res = getEndpointInfo(msg);
+    EXPECT_EQ(res.code, STATUS_OK);
+
+    EXPECT_EQ(startClientFlag, true);
+
+    destroyEdgeMessage(msg);
+
+    readNodeFlag = true;
+    testReadTranslated_P(endpointUri);
+    readNodeFlag = false;
+
+    stop_client();
+    EXPECT_EQ(startClientFlag, false);
+}
+
+TEST_F(OPC_clientTests , ClientHistoryRead_P)
+{
+    EXPECT_EQ(startClientFlag, false);
+
+    EdgeMessage *msg = createEdgeMessage(endpointUri, 1, CMD_GET_ENDPOINTS);
+    EXPECT_EQ(NULL != msg, true);
+
+    EdgeResult res = getEndpointInfo(msg);
+    EXPECT_EQ(res.code, STATUS_OK);
+
+    EXPECT_EQ(startClientFlag, true);
+
+    destroyEdgeMessage(msg);
+
+    testHistoryRead_P(endpointUri);
+
+    stop_client();
+    EXPECT_EQ(startClientFlag, false);
+}
+
+TEST_F(OPC_clientTests , ClientReadPrepared_P)
+{
+    EXPECT_EQ(startClientFlag, false);
+
+    EdgeMessage *msg = createEdgeMessage(endpointUri, 1, CMD_GET_ENDPOINTS);
+    EXPECT_EQ(NULL != msg, true);
+
+    EdgeResult res = getEndpointInfo(msg);
+    EXPECT_EQ(res.code, STATUS_OK);
+
+    EXPECT_EQ(startClientFlag, true);
+
+    destroyEdgeMessage(msg);
+
+    readNodeFlag = true;
+    testReadPrepared_P(endpointUri);
+    readNodeFlag = false;
+
+    stop_client();
+    EXPECT_EQ(startClientFlag, false);
+}
+
+TEST_F(OPC_clientTests , ClientReadAndWait_P)
+{
+    EXPECT_EQ(startClientFlag, false);
+
+    EdgeMessage *msg = createEdgeMessage(endpointUri, 1, CMD_GET_ENDPOINTS);
+    EXPECT_EQ(NULL != msg, true);
+
+    EdgeResult res = getEndpointInfo(msg);
+    EXPECT_EQ(res.code, STATUS_OK);
+
+    EXPECT_EQ(startClientFlag, true);
+
+    destroyEdgeMessage(msg);
+
+    testReadAndWait_P(endpointUri);
+
+    stop_client();
+    EXPECT_EQ(startClientFlag, false);
+}
+
+TEST_F(OPC_clientTests , ClientReadAndWait_N)
+{
+    EdgeMessage *msg = createEdgeAttributeMessage(endpointUri, 1, CMD_READ);
+    ASSERT_EQ(NULL != msg, true);
+    EXPECT_EQ(insertReadAccessNode(&msg, node_arr[3]).code, STATUS_OK);
+
+    /* Without a session the request still finishes, with an error response at most */
+    EdgeMessage *response = NULL;
+    EXPECT_EQ(sendRequestAndWait(msg, 5000, &response).code, STATUS_OK);
+    if (NULL != response)
+    {
+        EXPECT_EQ(response->type, ERROR_RESPONSE);
+        destroyEdgeMessage(response);
+    }
+    destroyEdgeMessage(msg);
+}
+
+#ifdef ENABLE_ASYNC_SERVICES
+TEST_F(OPC_clientTests , ClientReadPipelined_P)
+{
+    EXPECT_EQ(startClientFlag, false);
+
+    EdgeMessage *msg = createEdgeMessage(endpointUri, 1, CMD_GET_ENDPOINTS);
+    EXPECT_EQ(NULL != msg, true);
+
+    EdgeResult res = getEndpointInfo(msg);
+    EXPECT_EQ(res.code, STATUS_OK);
+
+    EXPECT_EQ(startClientFlag, true);
+
+    destroyEdgeMessage(msg);
+
+    testReadPipelined_P(endpointUri);
+
+    stop_client();
+    EXPECT_EQ(startClientFlag, false);
+}
+
+TEST_F(OPC_clientTests , ClientAsyncServiceInFlight_P)
+{
+    EXPECT_EQ(startClientFlag, false);
+
+    EdgeMessage *msg = createEdgeMessage(endpointUri, 1, CMD_GET_ENDPOINTS);
+    EXPECT_EQ(NULL != msg, true);
+
+    EdgeResult res = getEndpointInfo(msg);
+    EXPECT_EQ(res.code, STATUS_OK);
+
+    EXPECT_EQ(startClientFlag, true);
+
+    destroyEdgeMessage(msg);
+
+    testAsyncServiceInFlight_P(endpointUri);
+
+    stop_client();
+    EXPECT_EQ(startClientFlag, false);
+}
+
+TEST_F(OPC_clientTests , ClientAsyncServiceFallback_N)
+{
+    EXPECT_EQ(startClientFlag, false);
+
+    EdgeMessage *msg = createEdgeMessage(endpointUri, 1, CMD_GET_ENDPOINTS);
+    EXPECT_EQ(NULL != msg, true);
+
+    EdgeResult res = getEndpointInfo(msg);
+    EXPECT_EQ(res.code, STATUS_OK);
+
+    EXPECT_EQ(startClientFlag, true);
+
+    destroyEdgeMessage(msg);
+
+    testAsyncServiceFallback_N(endpointUri);
+
+    stop_client();
+    EXPECT_EQ(startClientFlag, false);
+}
+#endif
+
+TEST_F(OPC_clientTests , ClientReadAttributes_P)
+{
+    EXPECT_EQ(startClientFlag, false);
+
+    EdgeMessage *msg = createEdgeMessage(endpointUri, 1, CMD_GET_ENDPOINTS);
+    EXPECT_EQ(NULL != msg, true);
+
+    EdgeResult res = getEndpointInfo(msg);
+    EXPECT_EQ(res.code, STATUS_OK);
+
+    EXPECT_EQ(startClientFlag, true);
+
+    destroyEdgeMessage(msg);
+
+    readNodeFlag = true;
+    testReadAttributes_P(endpointUri);
+    readNodeFlag = false;
+
+    stop_client();
+    EXPECT_EQ(startClientFlag, false);
+}
+
+TEST_F(OPC_clientTests , ClientServerCapabilities_P)
+{
+    EXPECT_EQ(startClientFlag, false);
+
+    EdgeMessage *msg = createEdgeMessage(endpointUri, 1, CMD_GET_ENDPOINTS);
+    EXPECT_EQ(NULL != msg, true);
+
+    EdgeResult res = getEndpointInfo(msg);
+    EXPECT_EQ(res.code, STATUS_OK);
+
+    EXPECT_EQ(startClientFlag, true);
+
+    destroyEdgeMessage(msg);
+
+    testServerCapabilities_P(endpointUri);
+
+    stop_client();
+    EXPECT_EQ(startClientFlag, false);
+}
+
+TEST_F(OPC_clientTests , ClientReadChunked_P)
+{
+    EXPECT_EQ(startClientFlag, false);
+
+    EdgeMessage *msg = createEdgeMessage(endpointUri, 1, CMD_GET_ENDPOINTS);
+    EXPECT_EQ(NULL != msg, true);
+
+    EdgeResult res = getEndpointInfo(msg);
+    EXPECT_EQ(res.code, STATUS_OK);
+
+    EXPECT_EQ(startClientFlag, true);
+
+    destroyEdgeMessage(msg);
+
+    testReadChunked_P(endpointUri);
+
+    stop_client();
+    EXPECT_EQ(startClientFlag, false);
+}
+
+TEST_F(OPC_clientTests , ClientRead_P5)
+{
+    EXPECT_EQ(startClientFlag, false);
+
+    EdgeMessage *msg = createEdgeMessage(endpointUri, 1, CMD_GET_ENDPOINTS);
+    EXPECT_EQ(NULL != msg, true);
+
+    EdgeResult res = getEndpointInfo(msg);
+    EXPECT_EQ(res.code, STATUS_OK);
+
+    EXPECT_EQ(startClientFlag, true);
+
+    destroyEdgeMessage(msg);
+
+    readNodeFlag = true;
+    testRead_P5(endpointUri);
+    readNodeFlag = false;
+
+    stop_client();
+    EXPECT_EQ(startClientFlag, false);
+}
+
+TEST_F(OPC_clientTests , ClientRead_N1)
+{
+    EXPECT_EQ(startClientFlag, false);
+
+    EdgeMessage *msg = createEdgeMessage(endpointUri, 1, CMD_GET_ENDPOINTS);
+    EXPECT_EQ(NULL != msg, true);
+
+    EdgeResult res = getEndpointInfo(msg);
+    EXPECT_EQ(res.code, STATUS_OK);
+
+    EXPECT_EQ(startClientFlag, true);
+
+    destroyEdgeMessage(msg);
+
+    readNodeFlag = true;
+    testReadWithoutEndpoint();
+    readNodeFlag = false;
+
+    stop_client();
+    EXPECT_EQ(startClientFlag, false);
+}
+
+TEST_F(OPC_clientTests , ClientRead_N2)
+{
+    EXPECT_EQ(startClientFlag, false);
+
+    EdgeMessage *msg = createEdgeMessage(endpointUri, 1, CMD_GET_ENDPOINTS);
+    EXPECT_EQ(NULL != msg, true);
+
+    EdgeResult res = getEndpointInfo(msg);
+    EXPECT_EQ(res.code, STATUS_OK);
+
+    EXPECT_EQ(startClientFlag, true);
+
+    destroyEdgeMessage(msg);
+
+    readNodeFlag = true;
+    testReadWithoutValueAlias(endpointUri);
+    readNodeFlag = false;
+
+    stop_client();
+    EXPECT_EQ(startClientFlag, false);
+}
+
+TEST_F(OPC_clientTests , ClientRead_N3)
+{
+    EXPECT_EQ(startClientFlag, false);
+
+    EdgeMessage *msg = createEdgeMessage(endpointUri, 1, CMD_GET_ENDPOINTS);
+    EXPECT_EQ(NULL != msg, true);
+
+    EdgeResult res = getEndpointInfo(msg);
+    EXPECT_EQ(res.code, STATUS_OK);
+
+    EXPECT_EQ(startClientFlag, true);
+
+    destroyEdgeMessage(msg);
+
+    readNodeFlag = true;
+    testReadWithoutMessage();
+    readNodeFlag = false;
+
+    stop_client();
+    EXPECT_EQ(startClientFlag, false);
+}
+
+TEST_F(OPC_clientTests , ClientRead_N4)
+{
+    EXPECT_EQ(startClientFlag, false);
+
+    EdgeMessage *msg = createEdgeMessage(endpointUri, 1, CMD_GET_ENDPOINTS);
+    EXPECT_EQ(NULL != msg, true);
+
+    EdgeResult res = getEndpointInfo(msg);
+    EXPECT_EQ(res.code, STATUS_OK);
+
+    EXPECT_EQ(startClientFlag, true);
+
+    destroyEdgeMessage(msg);
+
+    readNodeFlag = true;
+    testReadWithoutCommand();
+    readNodeFlag = false;
+
+    stop_client();
+    EXPECT_EQ(startClientFlag, false);
+}
+
+TEST_F(OPC_clientTests , ClientWrite_P1)
+{
+    EXPECT_EQ(startClientFlag, false);
+
+    EdgeMessage *msg = createEdgeMessage(endpointUri, 1, CMD_GET_ENDPOINTS);
+    EXPECT_EQ(NULL != msg, true);
+
+    EdgeResult res = getEndpointInfo(msg);
+    EXPECT_EQ(res.code, STATUS_OK);
+
+    EXPECT_EQ(startClientFlag, true);
+
+    destroyEdgeMessage(msg);
+
+    testWrite_P1(endpointUri);
+
+    stop_client();
+    EXPECT_EQ(startClientFlag, false);
+}
+
+TEST_F(OPC_clientTests , ClientWriteChunked_P)
+{
+    EXPECT_EQ(startClientFlag, false);
+
+    EdgeMessage *msg = createEdgeMessage(endpointUri, 1, CMD_GET_ENDPOINTS);
+    EXPECT_EQ(NULL != msg, true);
+
+    EdgeResult res = getEndpointInfo(msg);
+    EXPECT_EQ(res.code, STATUS_OK);
+
+    EXPECT_EQ(startClientFlag, true);
+
+    destroyEdgeMessage(msg);
+
+    testWriteChunked_P(endpointUri);
+
+    stop_client();
+    EXPECT_EQ(startClientFlag, false);
+}
+
+TEST_F(OPC_clientTests , ClientWriteCoalesced_P)
+{
+    EXPECT_EQ(startClientFlag, false);
+
+    EdgeMessage *msg = createEdgeMessage(endpointUri, 1, CMD_GET_ENDPOINTS);
+    EXPECT_EQ(NULL != msg, true);
+
+    EdgeResult res = getEndpointInfo(msg);
+    EXPECT_EQ(res.code, STATUS_OK);
+
+    EXPECT_EQ(startClientFlag, true);
+
+    destroyEdgeMessage(msg);
+
+    testWriteCoalesced_P(endpointUri);
+
+    stop_client();
+    EXPECT_EQ(startClientFlag, false);
+}
+
+TEST_F(OPC_clientTests , ClientSessionPool_N)
+{
+    EdgeResult res = setSessionPoolSize(NULL, 4);
+    EXPECT_EQ(res.code, STATUS_PARAM_INVALID);
+
+    res = setSessionPoolSize(endpointUri, EDGE_MAX_SESSION_POOL_SIZE + 1);
+    EXPECT_EQ(res.code, STATUS_PARAM_INVALID);
+}
+
+TEST_F(OPC_clientTests , ClientSessionPool_P)
+{
+    EXPECT_EQ(startClientFlag, false);
+
+    EdgeResult res = setSessionPoolSize(endpointUri, 4);
+    EXPECT_EQ(res.code, STATUS_OK);
+
+    EdgeMessage *msg = createEdgeMessage(endpointUri, 1, CMD_GET_ENDPOINTS);
+    EXPECT_EQ(NULL != msg, true);
+
+    res = getEndpointInfo(msg);
+    EXPECT_EQ(res.code, STATUS_OK);
+
+    EXPECT_EQ(startClientFlag, true);
+
+    destroyEdgeMessage(msg);
+
+    testRead_P1(endpointUri);
+    testWrite_P1(endpointUri);
+
+    stop_client();
+    EXPECT_EQ(startClientFlag, false);
+
+    res = setSessionPoolSize(endpointUri, 1);
+    EXPECT_EQ(res.code, STATUS_OK);
+}
+
+TEST_F(OPC_clientTests , ClientReconnect_N)
+{
+    EdgeReconnectConfig config;
+    memset(&config, 0, sizeof(EdgeReconnectConfig));
+    config.initialDelayMs = 1000;
+    config.maxDelayMs = 500;
+
+    EdgeResult res = setClientReconnect(&config);
+    EXPECT_EQ(res.code, STATUS_PARAM_INVALID);
+}
+
+TEST_F(OPC_clientTests , ClientReconnect_P)
 {
+    EdgeReconnectConfig config;
+    memset(&config, 0, sizeof(EdgeReconnectConfig));
+    config.initialDelayMs = 100;
+    config.maxDelayMs = 1000;
+    config.requestBufferMs = 500;
+
+    EdgeResult res = setClientReconnect(&config);
+    EXPECT_EQ(res.code, STATUS_OK);
+
     EXPECT_EQ(startClientFlag, false);
 
     EdgeMessage *msg = createEdgeMessage(endpointUri, 1, CMD_GET_ENDPOINTS);
     EXPECT_EQ(NULL != msg, true);
 
-    EdgeResult res = getEndpointInfo(msg);
+    res = getEndpointInfo(msg);
     EXPECT_EQ(res.code, STATUS_OK);
 
     EXPECT_EQ(startClientFlag, true);
 
     destroyEdgeMessage(msg);
 
-    readNodeFlag = true;
-    testReadWithoutEndpoint();
-    readNodeFlag = false;
+    testRead_P1(endpointUri);
 
     stop_client();
     EXPECT_EQ(startClientFlag, false);
+
+    res = setClientReconnect(NULL);
+    EXPECT_EQ(res.code, STATUS_OK);
 }
 
-TEST_F(OPC_clientTests , ClientRead_N2)
+TEST_F(OPC_clientTests , ClientWriteErrorsOnly_P)
 {
     EXPECT_EQ(startClientFlag, false);
 
@@ -3392,15 +4835,13 @@ TEST_F(OPC_clientTests , ClientRead_N2)
 
     destroyEdgeMessage(msg);
 
-    readNodeFlag = true;
-    testReadWithoutValueAlias(endpointUri);
-    readNodeFlag = false;
+    testWriteErrorsOnly_P(endpointUri);
 
     stop_client();
     EXPECT_EQ(startClientFlag, false);
 }
 
-TEST_F(OPC_clientTests , ClientRead_N3)
+TEST_F(OPC_clientTests , ClientWrite_P2)
 {
     EXPECT_EQ(startClientFlag, false);
 
@@ -3414,15 +4855,13 @@ TEST_F(OPC_clientTests , ClientRead_N3)
 
     destroyEdgeMessage(msg);
 
-    readNodeFlag = true;
-    testReadWithoutMessage();
-    readNodeFlag = false;
+    testWrite_P2(endpointUri);
 
     stop_client();
     EXPECT_EQ(startClientFlag, false);
 }
 
-TEST_F(OPC_clientTests , ClientRead_N4)
+TEST_F(OPC_clientTests , ClientWrite_P3)
 {
     EXPECT_EQ(startClientFlag, false);
 
@@ -3436,15 +4875,13 @@ TEST_F(OPC_clientTests , ClientRead_N4)
 
     destroyEdgeMessage(msg);
 
-    readNodeFlag = true;
-    testReadWithoutCommand();
-    readNodeFlag = false;
+    testWrite_P3(endpointUri);
 
     stop_client();
     EXPECT_EQ(startClientFlag, false);
 }
 
-TEST_F(OPC_clientTests , ClientWrite_P1)
+TEST_F(OPC_clientTests , ClientWrite_P4)
 {
     EXPECT_EQ(startClientFlag, false);
 
@@ -3458,13 +4895,13 @@ TEST_F(OPC_clientTests , ClientWrite_P1)
 
     destroyEdgeMessage(msg);
 
-    testWrite_P1(endpointUri);
+    testWrite_P4(endpointUri);
 
     stop_client();
     EXPECT_EQ(startClientFlag, false);
 }
 
-TEST_F(OPC_clientTests , ClientWrite_P2)
+TEST_F(OPC_clientTests , ClientWrite_N1)
 {
     EXPECT_EQ(startClientFlag, false);
 
@@ -3478,13 +4915,13 @@ TEST_F(OPC_clientTests , ClientWrite_P2)
 
     destroyEdgeMessage(msg);
 
-    testWrite_P2(endpointUri);
+    testWriteWithoutEndpoint();
 
     stop_client();
     EXPECT_EQ(startClientFlag, false);
 }
 
-TEST_F(OPC_clientTests , ClientWrite_P3)
+TEST_F(OPC_clientTests , ClientWrite_N2)
 {
     EXPECT_EQ(startClientFlag, false);
 
@@ -3498,13 +4935,13 @@ TEST_F(OPC_clientTests , ClientWrite_P3)
 
     destroyEdgeMessage(msg);
 
-    testWrite_P3(endpointUri);
+    testWriteWithoutValueAlias(endpointUri);
 
     stop_client();
     EXPECT_EQ(startClientFlag, false);
 }
 
-TEST_F(OPC_clientTests , ClientWrite_P4)
+TEST_F(OPC_clientTests , ClientWrite_N3)
 {
     EXPECT_EQ(startClientFlag, false);
 
@@ -3518,13 +4955,13 @@ TEST_F(OPC_clientTests , ClientWrite_P4)
 
     destroyEdgeMessage(msg);
 
-    testWrite_P4(endpointUri);
+    testWriteWithoutMessage();
 
     stop_client();
     EXPECT_EQ(startClientFlag, false);
 }
 
-TEST_F(OPC_clientTests , ClientWrite_N1)
+TEST_F(OPC_clientTests , ClientWrite_N4)
 {
     EXPECT_EQ(startClientFlag, false);
 
@@ -3538,13 +4975,13 @@ TEST_F(OPC_clientTests , ClientWrite_N1)
 
     destroyEdgeMessage(msg);
 
-    testWriteWithoutEndpoint();
+    testWriteWithoutCommand();
 
     stop_client();
     EXPECT_EQ(startClientFlag, false);
 }
 
-TEST_F(OPC_clientTests , ClientWrite_N2)
+TEST_F(OPC_clientTests , ClientBrowse_P)
 {
     EXPECT_EQ(startClientFlag, false);
 
@@ -3558,13 +4995,13 @@ TEST_F(OPC_clientTests , ClientWrite_N2)
 
     destroyEdgeMessage(msg);
 
-    testWriteWithoutValueAlias(endpointUri);
+    browseNode();
 
     stop_client();
     EXPECT_EQ(startClientFlag, false);
 }
 
-TEST_F(OPC_clientTests , ClientWrite_N3)
+TEST_F(OPC_clientTests , ClientBrowseNext_P)
 {
     EXPECT_EQ(startClientFlag, false);
 
@@ -3578,13 +5015,13 @@ TEST_F(OPC_clientTests , ClientWrite_N3)
 
     destroyEdgeMessage(msg);
 
-    testWriteWithoutMessage();
+    browse_next();
 
     stop_client();
     EXPECT_EQ(startClientFlag, false);
 }
 
-TEST_F(OPC_clientTests , ClientWrite_N4)
+TEST_F(OPC_clientTests , ClientBrowseGroup_P)
 {
     EXPECT_EQ(startClientFlag, false);
 
@@ -3598,13 +5035,13 @@ TEST_F(OPC_clientTests , ClientWrite_N4)
 
     destroyEdgeMessage(msg);
 
-    testWriteWithoutCommand();
+    browseNodes();
 
     stop_client();
     EXPECT_EQ(startClientFlag, false);
 }
 
-TEST_F(OPC_clientTests , ClientBrowse_P)
+TEST_F(OPC_clientTests , ClientBrowseViews_P)
 {
     EXPECT_EQ(startClientFlag, false);
 
@@ -3618,13 +5055,13 @@ TEST_F(OPC_clientTests , ClientBrowse_P)
 
     destroyEdgeMessage(msg);
 
-    browseNode();
+    browseViews();
 
     stop_client();
     EXPECT_EQ(startClientFlag, false);
 }
 
-TEST_F(OPC_clientTests , ClientBrowseNext_P)
+TEST_F(OPC_clientTests , ClientBrowseStream_P)
 {
     EXPECT_EQ(startClientFlag, false);
 
@@ -3638,13 +5075,14 @@ TEST_F(OPC_clientTests , ClientBrowseNext_P)
 
     destroyEdgeMessage(msg);
 
-    browse_next();
+    browseNodeStream();
+    browseNodeMaxResults();
 
     stop_client();
     EXPECT_EQ(startClientFlag, false);
 }
 
-TEST_F(OPC_clientTests , ClientBrowseGroup_P)
+TEST_F(OPC_clientTests , ClientBrowseGraph_P)
 {
     EXPECT_EQ(startClientFlag, false);
 
@@ -3658,13 +5096,14 @@ TEST_F(OPC_clientTests , ClientBrowseGroup_P)
 
     destroyEdgeMessage(msg);
 
-    browseNodes();
+    browseNodeGraph();
 
     stop_client();
     EXPECT_EQ(startClientFlag, false);
 }
 
-TEST_F(OPC_clientTests , ClientBrowseViews_P)
+#ifdef ENABLE_ASYNC_SERVICES
+TEST_F(OPC_clientTests , ClientBrowseGraphPipelined_P)
 {
     EXPECT_EQ(startClientFlag, false);
 
@@ -3678,11 +5117,12 @@ TEST_F(OPC_clientTests , ClientBrowseViews_P)
 
     destroyEdgeMessage(msg);
 
-    browseViews();
+    browseNodeGraphPipelined();
 
     stop_client();
     EXPECT_EQ(startClientFlag, false);
 }
+#endif
 
 TEST_F(OPC_clientTests , ClientBrowse_N1)
 {
@@ -3780,6 +5220,8 @@ TEST_F(OPC_clientTests , ClientBrowse_N5)
 
     browseNodeWithoutBrowseParam();
 
+    browseNodeTakeWithoutBrowseParam();
+
     stop_client();
     EXPECT_EQ(startClientFlag, false);
 }
@@ -3933,6 +5375,63 @@ TEST_F(OPC_clientTests , ClientMethodCall_P4)
     EXPECT_EQ(startClientFlag, false);
 }
 
+TEST_F(OPC_clientTests , ClientMethodCallView_P)
+{
+    EXPECT_EQ(startClientFlag, false);
+
+    EdgeMessage *msg = createEdgeMessage(endpointUri, 1, CMD_GET_ENDPOINTS);
+    EXPECT_EQ(NULL != msg, true);
+    EdgeResult res = getEndpointInfo(msg);
+    EXPECT_EQ(res.code, STATUS_OK);
+    EXPECT_EQ(startClientFlag, true);
+    destroyEdgeMessage(msg);
+
+    methodCallFlag = true;
+    testMethodView_P(endpointUri);
+    methodCallFlag = false;
+
+    stop_client();
+    EXPECT_EQ(startClientFlag, false);
+}
+
+TEST_F(OPC_clientTests , ClientMethodCallAsync_P)
+{
+    EXPECT_EQ(startClientFlag, false);
+
+    EdgeMessage *msg = createEdgeMessage(endpointUri, 1, CMD_GET_ENDPOINTS);
+    EXPECT_EQ(NULL != msg, true);
+    EdgeResult res = getEndpointInfo(msg);
+    EXPECT_EQ(res.code, STATUS_OK);
+    EXPECT_EQ(startClientFlag, true);
+    destroyEdgeMessage(msg);
+
+    methodCallFlag = true;
+    testMethodAsync_P(endpointUri);
+    methodCallFlag = false;
+
+    stop_client();
+    EXPECT_EQ(startClientFlag, false);
+}
+
+TEST_F(OPC_clientTests , ClientMethodCallBatch_P)
+{
+    EXPECT_EQ(startClientFlag, false);
+
+    EdgeMessage *msg = createEdgeMessage(endpointUri, 1, CMD_GET_ENDPOINTS);
+    EXPECT_EQ(NULL != msg, true);
+    EdgeResult res = getEndpointInfo(msg);
+    EXPECT_EQ(res.code, STATUS_OK);
+    EXPECT_EQ(startClientFlag, true);
+    destroyEdgeMessage(msg);
+
+    methodCallFlag = true;
+    testMethodBatch_P(endpointUri);
+    methodCallFlag = false;
+
+    stop_client();
+    EXPECT_EQ(startClientFlag, false);
+}
+
 TEST_F(OPC_clientTests , ClientMethodCall_N1)
 {
     EXPECT_EQ(startClientFlag, false);
@@ -4079,6 +5578,108 @@ TEST_F(OPC_clientTests , ClientSubscribe_P3)
     EXPECT_EQ(startClientFlag, false);
 }
 
+TEST_F(OPC_clientTests , ClientSubscribeBulk_P)
+{
+    EXPECT_EQ(startClientFlag, false);
+
+    EdgeMessage *msg = createEdgeMessage(endpointUri, 1, CMD_GET_ENDPOINTS);
+    EXPECT_EQ(NULL != msg, true);
+    EdgeResult res = getEndpointInfo(msg);
+    EXPECT_EQ(res.code, STATUS_OK);
+    EXPECT_EQ(startClientFlag, true);
+    destroyEdgeMessage(msg);
+
+    testSubscriptionBulk_P(endpointUri);
+
+    stop_client();
+    EXPECT_EQ(startClientFlag, false);
+}
+
+TEST_F(OPC_clientTests , ClientSubscribeDeadband_P)
+{
+    EXPECT_EQ(startClientFlag, false);
+
+    EdgeMessage *msg = createEdgeMessage(endpointUri, 1, CMD_GET_ENDPOINTS);
+    EXPECT_EQ(NULL != msg, true);
+    EdgeResult res = getEndpointInfo(msg);
+    EXPECT_EQ(res.code, STATUS_OK);
+    EXPECT_EQ(startClientFlag, true);
+    destroyEdgeMessage(msg);
+
+    testSubscriptionDeadband_P(endpointUri);
+
+    stop_client();
+    EXPECT_EQ(startClientFlag, false);
+}
+
+TEST_F(OPC_clientTests , ClientSubscribeQueue_P)
+{
+    EXPECT_EQ(startClientFlag, false);
+
+    EdgeMessage *msg = createEdgeMessage(endpointUri, 1, CMD_GET_ENDPOINTS);
+    EXPECT_EQ(NULL != msg, true);
+    EdgeResult res = getEndpointInfo(msg);
+    EXPECT_EQ(res.code, STATUS_OK);
+    EXPECT_EQ(startClientFlag, true);
+    destroyEdgeMessage(msg);
+
+    testSubscriptionQueue_P(endpointUri);
+
+    stop_client();
+    EXPECT_EQ(startClientFlag, false);
+}
+
+TEST_F(OPC_clientTests , ClientSubscribeBatchedReports_P)
+{
+    EXPECT_EQ(startClientFlag, false);
+
+    EdgeMessage *msg = createEdgeMessage(endpointUri, 1, CMD_GET_ENDPOINTS);
+    EXPECT_EQ(NULL != msg, true);
+    EdgeResult res = getEndpointInfo(msg);
+    EXPECT_EQ(res.code, STATUS_OK);
+    EXPECT_EQ(startClientFlag, true);
+    destroyEdgeMessage(msg);
+
+    testSubscriptionBatchedReports_P(endpointUri);
+
+    stop_client();
+    EXPECT_EQ(startClientFlag, false);
+}
+
+TEST_F(OPC_clientTests , ClientSubscribePublishInterval_P)
+{
+    EXPECT_EQ(startClientFlag, false);
+
+    EdgeMessage *msg = createEdgeMessage(endpointUri, 1, CMD_GET_ENDPOINTS);
+    EXPECT_EQ(NULL != msg, true);
+    EdgeResult res = getEndpointInfo(msg);
+    EXPECT_EQ(res.code, STATUS_OK);
+    EXPECT_EQ(startClientFlag, true);
+    destroyEdgeMessage(msg);
+
+    testSubscriptionPublishInterval_P(endpointUri);
+
+    stop_client();
+    EXPECT_EQ(startClientFlag, false);
+}
+
+TEST_F(OPC_clientTests , ClientSubscribeSessions_P)
+{
+    EXPECT_EQ(startClientFlag, false);
+
+    EdgeMessage *msg = createEdgeMessage(endpointUri, 1, CMD_GET_ENDPOINTS);
+    EXPECT_EQ(NULL != msg, true);
+    EdgeResult res = getEndpointInfo(msg);
+    EXPECT_EQ(res.code, STATUS_OK);
+    EXPECT_EQ(startClientFlag, true);
+    destroyEdgeMessage(msg);
+
+    testSubscriptionSessions_P(endpointUri, (char *) "opc.tcp://127.0.0.1:12686");
+
+    stop_client();
+    EXPECT_EQ(startClientFlag, false);
+}
+
 TEST_F(OPC_clientTests , ClientSubscribe_N1)
 {
     EXPECT_EQ(startClientFlag, false);
@@ -4164,6 +5765,81 @@ TEST_F(OPC_clientTests , ClientSubscribe_N5)
     EXPECT_EQ(startClientFlag, false);
 }
 
+TEST_F(OPC_clientTests , ClientSubscribe_N6)
+{
+    EXPECT_EQ(startClientFlag, false);
+
+    EdgeMessage *msg = createEdgeMessage(endpointUri, 1, CMD_GET_ENDPOINTS);
+    EXPECT_EQ(NULL != msg, true);
+    EdgeResult res = getEndpointInfo(msg);
+    EXPECT_EQ(res.code, STATUS_OK);
+    EXPECT_EQ(startClientFlag, true);
+    destroyEdgeMessage(msg);
+
+    testSubscriptionInvalidFilter(endpointUri);
+
+    stop_client();
+    EXPECT_EQ(startClientFlag, false);
+}
+
+/* Restarts the server, which keeps only String1 afterwards, so it runs after the tests
+ * which need the other nodes */
+TEST_F(OPC_clientTests , ClientSubscribeRecreate_P)
+{
+    EXPECT_EQ(startClientFlag, false);
+    EdgeMessage *msg = createEdgeMessage(endpointUri, 1, CMD_GET_ENDPOINTS);
+    EXPECT_EQ(NULL != msg, true);
+    EdgeResult res = getEndpointInfo(msg);
+    EXPECT_EQ(res.code, STATUS_OK);
+    EXPECT_EQ(startClientFlag, true);
+    destroyEdgeMessage(msg);
+
+    msg = createEdgeSubMessage(endpointUri, node_arr[0], 1, Edge_Create_Sub);
+    ASSERT_EQ(NULL != msg, true);
+    insertSubParameter(&msg, node_arr[0], Edge_Create_Sub, 100.0, 0.0, 1, 10000, 1, true, 0, 50);
+    EXPECT_EQ(sendRequest(msg).code, STATUS_OK);
+    destroyEdgeMessage(msg);
+    sleep(1);
+
+    EdgeClientStats stats;
+    ASSERT_EQ(getClientStats(endpointUri, &stats).code, STATUS_OK);
+    EXPECT_EQ(stats.subscriptionCount, 1);
+    uint64_t notificationCount = stats.notificationCount;
+    EXPECT_GT(notificationCount, 0);
+
+    /* The new server does not know the subscription, TransferSubscriptions fails for it */
+    cleanCallbacks();
+    stop_server(endpointUri);
+    start_server(12686, (char *) DEFAULT_SERVER_APP_URI_VALUE, EDGE_APPLICATIONTYPE_SERVER);
+    configureCallbacks();
+    EXPECT_EQ(createNamespace(DEFAULT_NAMESPACE_VALUE, DEFAULT_ROOT_NODE_INFO_VALUE,
+            DEFAULT_ROOT_NODE_INFO_VALUE, DEFAULT_ROOT_NODE_INFO_VALUE).code, STATUS_OK);
+    EdgeNodeItem *item = createVariableNodeItem("String1", EDGE_NODEID_STRING, (void *) TEST_STR1_R,
+            VARIABLE_NODE, 100);
+    ASSERT_EQ(NULL != item, true);
+    EXPECT_EQ(createNode(DEFAULT_NAMESPACE_VALUE, item).code, STATUS_OK);
+    deleteNodeItem(item);
+
+    /* The subscription is created again and its item reports the current value */
+    for (int i = 0; i < 100 && stats.notificationCount <= notificationCount; i++)
+    {
+        usleep(100 * 1000);
+        EXPECT_EQ(getClientStats(endpointUri, &stats).code, STATUS_OK);
+    }
+    EXPECT_GT(stats.notificationCount, notificationCount);
+    EXPECT_EQ(stats.subscriptionCount, 1);
+    EXPECT_EQ(stats.monitoredItemCount, 1);
+
+    msg = createEdgeSubMessage(endpointUri, node_arr[0], 0, Edge_Delete_Sub);
+    ASSERT_EQ(NULL != msg, true);
+    EXPECT_EQ(sendRequest(msg).code, STATUS_OK);
+    destroyEdgeMessage(msg);
+    sleep(1);
+
+    stop_client();
+    EXPECT_EQ(startClientFlag, false);
+}
+
 TEST_F(OPC_clientTests , ClientShowNodeList_P)
 {
     showNodeList();
@@ -31,6 +31,12 @@ extern "C"
 #include "edge_logger.h"
 #include "edge_malloc.h"
 #include "open62541.h"
+#include "read.h"
+#include "request_future.h"
+#include "server_capabilities.h"
+#ifdef ENABLE_ASYNC_SERVICES
+#include "async_service.h"
+#endif
 }
 
 #define TAG "readTest"
@@ -140,6 +146,272 @@ void testRead_P5(char *endpointUri)
     sleep(1);
 }
 
+// Double and Guid read through registered NodeIds
+void testReadRegistered_P(char *endpointUri)
+{
+    int num_requests  = 2;
+    EdgeMessage *msg = createEdgeAttributeMessage(endpointUri, num_requests, CMD_REGISTER_NODES);
+    EXPECT_EQ(NULL != msg, true);
+    EXPECT_EQ(insertReadAccessNode(&msg, node_arr[3]).code, STATUS_OK);
+    EXPECT_EQ(insertReadAccessNode(&msg, node_arr[9]).code, STATUS_OK);
+    EdgeResult result = sendRequest(msg);
+    destroyEdgeMessage(msg);
+    ASSERT_EQ(result.code, STATUS_OK);
+    sleep(1);
+
+    testRead_P3(endpointUri);
+
+    msg = createEdgeAttributeMessage(endpointUri, num_requests, CMD_UNREGISTER_NODES);
+    EXPECT_EQ(NULL != msg, true);
+    insertReadAccessNode(&msg, node_arr[3]);
+    insertReadAccessNode(&msg, node_arr[9]);
+    result = sendRequest(msg);
+    destroyEdgeMessage(msg);
+    ASSERT_EQ(result.code, STATUS_OK);
+    sleep(1);
+}
+
+// Double and Guid read through NodeIds resolved from their browse paths
+void testReadTranslated_P(char *endpointUri)
+{
+    int num_requests  = 3;
+    EdgeMessage *msg = createEdgeAttributeMessage(endpointUri, num_requests, CMD_TRANSLATE_BROWSE_PATHS);
+    EXPECT_EQ(NULL != msg, true);
+    EXPECT_EQ(insertReadAccessNode(&msg, node_arr[3]).code, STATUS_OK);
+    EXPECT_EQ(insertReadAccessNode(&msg, node_arr[9]).code, STATUS_OK);
+    EXPECT_EQ(insertReadAccessNode(&msg, "{2;S;v=11}/2:Double/0:Missing").code, STATUS_OK);
+    EdgeResult result = sendRequest(msg);
+    destroyEdgeMessage(msg);
+    ASSERT_EQ(result.code, STATUS_OK);
+    sleep(1);
+
+    testRead_P3(endpointUri);
+
+    /* Resolved nodes are forgotten like registered ones */
+    msg = createEdgeAttributeMessage(endpointUri, 2, CMD_UNREGISTER_NODES);
+    EXPECT_EQ(NULL != msg, true);
+    insertReadAccessNode(&msg, node_arr[3]);
+    insertReadAccessNode(&msg, node_arr[9]);
+    result = sendRequest(msg);
+    destroyEdgeMessage(msg);
+    ASSERT_EQ(result.code, STATUS_OK);
+    sleep(1);
+}
+
+static bool historyChunkCallback(EdgeMessage *result, void *context)
+{
+    (*(int *) context)++;
+    EXPECT_EQ(result->command, CMD_HISTORY_READ);
+    return true;
+}
+
+// History of Double and Guid, the test server keeps none so each node reports an error
+void testHistoryRead_P(char *endpointUri)
+{
+    EdgeHistoryParameter param;
+    memset(&param, 0, sizeof(param));
+    param.kind = EDGE_HISTORY_READ_RAW;
+    param.endTime = 1;
+    param.numValuesPerNode = 100;
+
+    /* Parameters are only taken by history reads */
+    EdgeMessage *msg = createEdgeAttributeMessage(endpointUri, 2, CMD_READ);
+    EXPECT_EQ(NULL != msg, true);
+    EXPECT_EQ(insertHistoryReadParameter(&msg, &param).code, STATUS_PARAM_INVALID);
+    destroyEdgeMessage(msg);
+
+    int chunks = 0;
+    param.resultCallback = historyChunkCallback;
+    param.resultContext = &chunks;
+    msg = createEdgeAttributeMessage(endpointUri, 2, CMD_HISTORY_READ);
+    EXPECT_EQ(NULL != msg, true);
+    EXPECT_EQ(insertHistoryReadParameter(&msg, NULL).code, STATUS_PARAM_INVALID);
+    EXPECT_EQ(insertReadAccessNode(&msg, node_arr[3]).code, STATUS_OK);
+    EXPECT_EQ(insertReadAccessNode(&msg, node_arr[9]).code, STATUS_OK);
+
+    /* A history read needs its parameter */
+    EXPECT_EQ(sendRequest(msg).code, STATUS_PARAM_INVALID);
+    EXPECT_EQ(insertHistoryReadParameter(&msg, &param).code, STATUS_OK);
+    EdgeResult result = sendRequest(msg);
+    destroyEdgeMessage(msg);
+    ASSERT_EQ(result.code, STATUS_OK);
+    sleep(1);
+    EXPECT_EQ(chunks, 0);
+}
+
+// Double and Guid read by a prepared read, once and periodically
+void testReadPrepared_P(char *endpointUri)
+{
+    EXPECT_EQ(NULL == prepareRead(NULL), true);
+
+    int num_requests  = 2;
+    EdgeMessage *msg = createEdgeAttributeMessage(endpointUri, num_requests, CMD_READ);
+    EXPECT_EQ(NULL != msg, true);
+    EXPECT_EQ(insertReadAccessNode(&msg, node_arr[3]).code, STATUS_OK);
+    EXPECT_EQ(insertReadAccessNode(&msg, node_arr[9]).code, STATUS_OK);
+    EdgePreparedRead *read = prepareRead(msg);
+    destroyEdgeMessage(msg);
+    ASSERT_EQ(NULL != read, true);
+
+    EXPECT_EQ(sendPreparedRead(read).code, STATUS_OK);
+    sleep(1);
+
+    EXPECT_EQ(startPeriodicRead(read, 0).code, STATUS_PARAM_INVALID);
+    EXPECT_EQ(startPeriodicRead(read, 200).code, STATUS_OK);
+    EXPECT_EQ(startPeriodicRead(read, 200).code, STATUS_ALREADY_INIT);
+    sleep(1);
+    stopPeriodicRead(read);
+    destroyPreparedRead(read);
+}
+
+// Double and Guid read on the calling thread, directly and through a future
+void testReadAndWait_P(char *endpointUri)
+{
+    EdgeMessage *response = NULL;
+    EXPECT_EQ(sendRequestAndWait(NULL, 1000, &response).code, STATUS_PARAM_INVALID);
+    EXPECT_EQ(NULL == sendRequestAsync(NULL), true);
+    EXPECT_EQ(waitFuture(NULL, 1000).code, STATUS_PARAM_INVALID);
+
+    int num_requests  = 2;
+    EdgeMessage *msg = createEdgeAttributeMessage(endpointUri, num_requests, CMD_READ);
+    EXPECT_EQ(NULL != msg, true);
+    EXPECT_EQ(insertReadAccessNode(&msg, node_arr[3]).code, STATUS_OK);
+    EXPECT_EQ(insertReadAccessNode(&msg, node_arr[9]).code, STATUS_OK);
+    EXPECT_EQ(sendRequestAndWait(msg, 1000, NULL).code, STATUS_PARAM_INVALID);
+
+    ASSERT_EQ(sendRequestAndWait(msg, 5000, &response).code, STATUS_OK);
+    ASSERT_EQ(NULL != response, true);
+    EXPECT_EQ(response->type, GENERAL_RESPONSE);
+    EXPECT_EQ(response->message_id, msg->message_id);
+    EXPECT_EQ(response->responseLength, num_requests);
+    destroyEdgeMessage(response);
+
+    EdgeFuture *future = sendRequestAsync(msg);
+    ASSERT_EQ(NULL != future, true);
+    /* A message has one future at a time */
+    EXPECT_EQ(NULL == sendRequestAsync(msg), true);
+    EXPECT_EQ(waitFuture(future, 5000).code, STATUS_OK);
+    ASSERT_EQ(getFutureResponseCount(future), 1);
+    EXPECT_EQ(getFutureResponse(future, 0)->type, GENERAL_RESPONSE);
+    EXPECT_EQ(NULL == getFutureResponse(future, 1), true);
+    destroyFuture(future);
+    destroyEdgeMessage(msg);
+}
+
+// Value, DisplayName, DataType and AccessLevel of a Double node in one request
+void testReadAttributes_P(char *endpointUri)
+{
+    int num_requests  = 4;
+    EdgeMessage *msg = createEdgeAttributeMessage(endpointUri, num_requests, CMD_READ);
+    EXPECT_EQ(NULL != msg, true);
+    EXPECT_EQ(insertReadAttributeNode(&msg, node_arr[3], EDGE_ATTRIBUTE_VALUE).code, STATUS_OK);
+    EXPECT_EQ(insertReadAttributeNode(&msg, node_arr[3], EDGE_ATTRIBUTE_DISPLAYNAME).code, STATUS_OK);
+    EXPECT_EQ(insertReadAttributeNode(&msg, node_arr[3], EDGE_ATTRIBUTE_DATATYPE).code, STATUS_OK);
+    EXPECT_EQ(insertReadAttributeNode(&msg, node_arr[3], EDGE_ATTRIBUTE_ACCESSLEVEL).code, STATUS_OK);
+    EXPECT_EQ(insertReadAttributeNode(&msg, node_arr[3], (EdgeAttributeId) 0).code, STATUS_PARAM_INVALID);
+    EXPECT_EQ(msg->requestLength, num_requests);
+
+    EdgeResult result = sendRequest(msg);
+    destroyEdgeMessage(msg);
+    ASSERT_EQ(result.code, STATUS_OK);
+    sleep(1);
+
+    msg = createEdgeAttributeMessage(endpointUri, 1, CMD_READ_SAMPLING_INTERVAL);
+    EXPECT_EQ(NULL != msg, true);
+    EXPECT_EQ(insertReadAttributeNode(&msg, node_arr[3], EDGE_ATTRIBUTE_VALUE).code, STATUS_PARAM_INVALID);
+    destroyEdgeMessage(msg);
+}
+
+// Limits are read once for a session, looked up from the cache afterwards and read again
+// once the session dropped them
+void testServerCapabilities_P(char *endpointUri)
+{
+    EdgeServerCapabilities capabilities;
+    getServerCapabilities(NULL, &capabilities);
+    EXPECT_EQ(capabilities.maxBrowseContinuationPoints, 1);
+    EXPECT_EQ(capabilities.maxNodesPerRead, 0);
+    EXPECT_EQ(capabilities.maxNodesPerWrite, 0);
+
+    UA_Client *client = UA_Client_new(UA_ClientConfig_default);
+    ASSERT_EQ(NULL != client, true);
+    ASSERT_EQ(UA_Client_connect(client, endpointUri), UA_STATUSCODE_GOOD);
+
+    ASSERT_EQ(readServerCapabilities(client), true);
+    EdgeServerCapabilities serverLimits;
+    getServerCapabilities(client, &serverLimits);
+    EXPECT_GE(serverLimits.maxBrowseContinuationPoints, 1);
+
+    /* Values no server reports, they are only returned from the cache */
+    EdgeServerCapabilities cached = serverLimits;
+    cached.maxNodesPerRead = 12345;
+    cached.maxNodesPerWrite = 23456;
+    ASSERT_EQ(storeServerCapabilities(client, &cached), true);
+    getServerCapabilities(client, &capabilities);
+    EXPECT_EQ(capabilities.maxNodesPerRead, 12345);
+    EXPECT_EQ(capabilities.maxNodesPerWrite, 23456);
+    getServerCapabilities(client, &capabilities);
+    EXPECT_EQ(capabilities.maxNodesPerRead, 12345);
+
+    removeServerCapabilities(client);
+    getServerCapabilities(client, &capabilities);
+    EXPECT_EQ(capabilities.maxBrowseContinuationPoints, serverLimits.maxBrowseContinuationPoints);
+    EXPECT_EQ(capabilities.maxNodesPerRead, serverLimits.maxNodesPerRead);
+    EXPECT_EQ(capabilities.maxNodesPerWrite, serverLimits.maxNodesPerWrite);
+
+    removeServerCapabilities(client);
+    UA_Client_disconnect(client);
+    UA_Client_delete(client);
+}
+
+// Five nodes read with MaxNodesPerRead 2, the results of the three requests are merged in
+// the order of the nodes, so only the missing node in the second one fails
+void testReadChunked_P(char *endpointUri)
+{
+    UA_Client *client = UA_Client_new(UA_ClientConfig_default);
+    ASSERT_EQ(NULL != client, true);
+    ASSERT_EQ(UA_Client_connect(client, endpointUri), UA_STATUSCODE_GOOD);
+
+    EdgeServerCapabilities capabilities;
+    getServerCapabilities(client, &capabilities);
+    capabilities.maxNodesPerRead = 2;
+    ASSERT_EQ(storeServerCapabilities(client, &capabilities), true);
+
+    int num_requests = 5;
+    const char *aliases[] = { node_arr[3], node_arr[4], "{2;S;v=11}NoSuchNode", node_arr[5], node_arr[22] };
+    EdgeMessage *msg = createEdgeAttributeMessage(endpointUri, num_requests, CMD_READ);
+    ASSERT_EQ(NULL != msg, true);
+    for (int i = 0; i < num_requests; i++)
+    {
+        EXPECT_EQ(insertReadAccessNode(&msg, aliases[i]).code, STATUS_OK);
+    }
+
+    EdgeFuture *future = createRequestFuture(msg->message_id);
+    ASSERT_EQ(NULL != future, true);
+    EXPECT_EQ(executeRead(client, msg).code, STATUS_OK);
+    finishRequestFuture(msg->message_id);
+    EXPECT_EQ(waitRequestFuture(future, 5000), true);
+
+    ASSERT_EQ(getRequestFutureResponseCount(future), 2);
+    EdgeMessage *response = getRequestFutureResponse(future, 0, false);
+    EXPECT_EQ(response->type, ERROR_RESPONSE);
+    EXPECT_EQ(NULL != strstr((char *) response->responses[0]->message->value, "position(2)"), true);
+    response = getRequestFutureResponse(future, 1, false);
+    EXPECT_EQ(response->type, GENERAL_RESPONSE);
+    ASSERT_EQ(response->responseLength, num_requests - 1);
+    for (int i = 0, node = 0; i < response->responseLength; i++, node++)
+    {
+        node += (2 == node) ? 1 : 0;
+        EXPECT_STREQ(response->responses[i]->nodeInfo->valueAlias, aliases[node]);
+        EXPECT_EQ(NULL != response->responses[i]->message, true);
+    }
+    deleteRequestFuture(future);
+    destroyEdgeMessage(msg);
+
+    removeServerCapabilities(client);
+    UA_Client_disconnect(client);
+    UA_Client_delete(client);
+}
+
 void testReadWithoutCommand()
 {
     int num_requests  = 1;
@@ -190,3 +462,149 @@ void testReadWithoutMessage()
     EdgeResult result = sendRequest(NULL);
     ASSERT_EQ(result.code, STATUS_PARAM_INVALID);
 }
+
+#ifdef ENABLE_ASYNC_SERVICES
+#define ASYNC_READ_COUNT (2 * EDGE_ASYNC_MAX_IN_FLIGHT + 1)
+
+static size_t asyncHandledCount = 0;
+static uint32_t asyncHandledIds[ASYNC_READ_COUNT];
+
+static void asyncReadTestHandler(UA_Client *client, const EdgeMessage *msg, const void *data,
+        void *response)
+{
+    size_t index = *(const size_t *) data;
+    EXPECT_EQ(index, asyncHandledCount);
+    EXPECT_EQ(((UA_ReadResponse *) response)->responseHeader.serviceResult, UA_STATUSCODE_GOOD);
+    if (asyncHandledCount < ASYNC_READ_COUNT)
+    {
+        asyncHandledIds[asyncHandledCount] = msg->message_id;
+    }
+    asyncHandledCount++;
+}
+
+static void initCurrentTimeRead(UA_ReadRequest *request, UA_ReadValueId *rv)
+{
+    UA_ReadValueId_init(rv);
+    rv->nodeId = UA_NODEID_NUMERIC(0, UA_NS0ID_SERVER_SERVERSTATUS_CURRENTTIME);
+    rv->attributeId = UA_ATTRIBUTEID_VALUE;
+    UA_ReadRequest_init(request);
+    request->nodesToRead = rv;
+    request->nodesToReadSize = 1;
+}
+
+// Reads of different lengths pipelined on one session, every future gets the response
+// of its own request
+void testReadPipelined_P(char *endpointUri)
+{
+    EdgeMessage *msgs[ASYNC_READ_COUNT];
+    EdgeFuture *futures[ASYNC_READ_COUNT];
+    for (int i = 0; i < ASYNC_READ_COUNT; i++)
+    {
+        int num_requests = i % 4 + 1;
+        msgs[i] = createEdgeAttributeMessage(endpointUri, num_requests, CMD_READ);
+        ASSERT_EQ(NULL != msgs[i], true);
+        for (int j = 0; j < num_requests; j++)
+        {
+            EXPECT_EQ(insertReadAccessNode(&msgs[i], node_arr[3 + j]).code, STATUS_OK);
+        }
+    }
+    /* Queued back to back, they are executed while the earlier ones are in flight */
+    for (int i = 0; i < ASYNC_READ_COUNT; i++)
+    {
+        futures[i] = sendRequestAsync(msgs[i]);
+        ASSERT_EQ(NULL != futures[i], true);
+    }
+    for (int i = 0; i < ASYNC_READ_COUNT; i++)
+    {
+        EXPECT_EQ(waitFuture(futures[i], 5000).code, STATUS_OK);
+        ASSERT_EQ(getFutureResponseCount(futures[i]), 1);
+        EdgeMessage *response = getFutureResponse(futures[i], 0);
+        EXPECT_EQ(response->type, GENERAL_RESPONSE);
+        EXPECT_EQ(response->message_id, msgs[i]->message_id);
+        EXPECT_EQ(response->responseLength, msgs[i]->requestLength);
+        destroyFuture(futures[i]);
+        destroyEdgeMessage(msgs[i]);
+    }
+}
+
+// More requests than EDGE_ASYNC_MAX_IN_FLIGHT on a raw session, sending waits for the
+// oldest responses and every response reaches the handler with the message of its request
+void testAsyncServiceInFlight_P(char *endpointUri)
+{
+    UA_Client *client = UA_Client_new(UA_ClientConfig_default);
+    ASSERT_EQ(NULL != client, true);
+    ASSERT_EQ(UA_Client_connect(client, endpointUri), UA_STATUSCODE_GOOD);
+
+    UA_ReadRequest request;
+    UA_ReadValueId rv;
+    initCurrentTimeRead(&request, &rv);
+
+    EdgeMessage *msgs[ASYNC_READ_COUNT];
+    asyncHandledCount = 0;
+    for (size_t i = 0; i < ASYNC_READ_COUNT; i++)
+    {
+        msgs[i] = createEdgeAttributeMessage(endpointUri, 1, CMD_READ);
+        ASSERT_EQ(NULL != msgs[i], true);
+        EXPECT_EQ(insertReadAccessNode(&msgs[i], node_arr[3]).code, STATUS_OK);
+        EXPECT_EQ(sendAsyncService(client, msgs[i], &request, &UA_TYPES[UA_TYPES_READREQUEST],
+                &UA_TYPES[UA_TYPES_READRESPONSE], asyncReadTestHandler, &i, sizeof(i)), true);
+        EXPECT_LT(i + 1 - asyncHandledCount, (size_t) EDGE_ASYNC_MAX_IN_FLIGHT);
+    }
+    drainAsyncServices(client);
+    EXPECT_EQ(asyncHandledCount, (size_t) ASYNC_READ_COUNT);
+    for (int i = 0; i < ASYNC_READ_COUNT; i++)
+    {
+        EXPECT_EQ(asyncHandledIds[i], msgs[i]->message_id);
+        destroyEdgeMessage(msgs[i]);
+    }
+
+    removeAsyncServices(client);
+    UA_Client_disconnect(client);
+    UA_Client_delete(client);
+}
+
+// Without a session the asynchronous send fails, the read falls back to the blocking
+// service and its error response still finishes the future
+void testAsyncServiceFallback_N(char *endpointUri)
+{
+    UA_Client *client = UA_Client_new(UA_ClientConfig_default);
+    ASSERT_EQ(NULL != client, true);
+
+    UA_ReadRequest request;
+    UA_ReadValueId rv;
+    initCurrentTimeRead(&request, &rv);
+
+    EdgeMessage *msg = createEdgeAttributeMessage(endpointUri, 1, CMD_READ);
+    ASSERT_EQ(NULL != msg, true);
+    EXPECT_EQ(insertReadAccessNode(&msg, node_arr[3]).code, STATUS_OK);
+
+    /* A failed send neither calls the handler nor keeps the future pending */
+    EdgeFuture *future = createRequestFuture(msg->message_id);
+    ASSERT_EQ(NULL != future, true);
+    size_t index = 0;
+    asyncHandledCount = 0;
+    EXPECT_EQ(sendAsyncService(client, msg, &request, &UA_TYPES[UA_TYPES_READREQUEST],
+            &UA_TYPES[UA_TYPES_READRESPONSE], asyncReadTestHandler, &index, sizeof(index)), false);
+    finishRequestFuture(msg->message_id);
+    EXPECT_EQ(waitRequestFuture(future, 1000), true);
+    EXPECT_EQ(asyncHandledCount, 0);
+    EXPECT_EQ(getRequestFutureResponseCount(future), 0);
+    deleteRequestFuture(future);
+
+    future = createRequestFuture(msg->message_id);
+    ASSERT_EQ(NULL != future, true);
+    EXPECT_EQ(executeRead(client, msg).code, STATUS_OK);
+    finishRequestFuture(msg->message_id);
+    EXPECT_EQ(waitRequestFuture(future, 5000), true);
+    ASSERT_EQ(getRequestFutureResponseCount(future), 1);
+    EdgeMessage *response = getRequestFutureResponse(future, 0, false);
+    EXPECT_EQ(response->type, ERROR_RESPONSE);
+    EXPECT_EQ(response->message_id, msg->message_id);
+    deleteRequestFuture(future);
+    destroyEdgeMessage(msg);
+
+    removeServerCapabilities(client);
+    removeAsyncServices(client);
+    UA_Client_delete(client);
+}
+#endif
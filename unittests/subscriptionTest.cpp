@@ -31,11 +31,14 @@ extern "C"
 #include "edge_logger.h"
 #include "edge_malloc.h"
 #include "open62541.h"
+#include "test_common.h"
 }
 
 #define TAG "methodTest"
 
 extern char node_arr[46][30];
+extern int reportCount;
+extern int reportResponseCount;
 
 void testSubscription_P1(char *endpointUri)
 {
@@ -185,6 +188,256 @@ void testSubscription_P3(char *endpointUri)
     sleep(1);
 }
 
+/* Bulk Subscription, the unknown node is reported in the item results */
+void testSubscriptionBulk_P(char *endpointUri)
+{
+    /* Create Subscription */
+    EdgeMessage* msg = createEdgeSubMessage(endpointUri, "{2;S;v=11}Double", 3, Edge_Create_Bulk_Sub);
+    EXPECT_EQ(NULL!=msg, true);
+
+    double samplingInterval = 100.0;
+    int keepalivetime = (1 > (int) (ceil(10000.0 / 0.0))) ? 1 : (int) ceil(10000.0 / 0.0);
+    insertSubParameter(&msg, "{2;S;v=11}Double", Edge_Create_Bulk_Sub, samplingInterval, 0.0, keepalivetime, 10000, 1, true, 0, 50);
+    insertSubParameter(&msg, "{2;S;v=14}Guid", Edge_Create_Bulk_Sub, samplingInterval, 0.0, keepalivetime, 10000, 1, true, 0, 50);
+    insertSubParameter(&msg, "{2;S;v=11}NoSuchNode", Edge_Create_Bulk_Sub, samplingInterval, 0.0, keepalivetime, 10000, 1, true, 0, 50);
+    EXPECT_EQ(msg->requestLength, 3);
+
+    EdgeResult result = sendRequest(msg);
+    EXPECT_EQ(result.code, STATUS_OK);
+    destroyEdgeMessage (msg);
+    sleep(1);
+
+    /* Delete Subscription */
+    msg = createEdgeSubMessage(endpointUri, "{2;S;v=11}Double", 0, Edge_Delete_Sub);
+    EXPECT_EQ(NULL!=msg, true);
+    result = sendRequest(msg);
+    EXPECT_EQ(result.code, STATUS_OK);
+    destroyEdgeMessage(msg);
+    sleep(1);
+
+    /* Delete Subscription */
+    msg = createEdgeSubMessage(endpointUri, "{2;S;v=14}Guid", 0, Edge_Delete_Sub);
+    EXPECT_EQ(NULL!=msg, true);
+    result = sendRequest(msg);
+    EXPECT_EQ(result.code, STATUS_OK);
+    destroyEdgeMessage(msg);
+    sleep(1);
+}
+
+/* Subscription with an absolute deadband, only the larger changes are notified */
+void testSubscriptionDeadband_P(char *endpointUri)
+{
+    /* Create Subscription */
+    EdgeMessage* msg = createEdgeSubMessage(endpointUri, "{2;S;v=11}Double", 1, Edge_Create_Sub);
+    EXPECT_EQ(NULL!=msg, true);
+
+    double samplingInterval = 100.0;
+    int keepalivetime = (1 > (int) (ceil(10000.0 / 0.0))) ? 1 : (int) ceil(10000.0 / 0.0);
+    insertSubParameter(&msg, "{2;S;v=11}Double", Edge_Create_Sub, samplingInterval, 0.0, keepalivetime, 10000, 1, true, 0, 50);
+    EdgeResult ret = insertSubFilter(msg, EDGE_DATACHANGE_TRIGGER_STATUS_VALUE, EDGE_DEADBAND_ABSOLUTE, 0.5);
+    EXPECT_EQ(ret.code, STATUS_OK);
+    EXPECT_EQ(msg->requests[0]->subMsg->deadbandType, EDGE_DEADBAND_ABSOLUTE);
+
+    EdgeResult result = sendRequest(msg);
+    EXPECT_EQ(result.code, STATUS_OK);
+    destroyEdgeMessage (msg);
+    sleep(1);
+
+    /* Modify Subscription, the deadband is removed */
+    msg = createEdgeSubMessage(endpointUri, "{2;S;v=11}Double", 0, Edge_Modify_Sub);
+    EXPECT_EQ(NULL!=msg, true);
+    insertSubParameter(&msg, "{2;S;v=11}Double", Edge_Modify_Sub, samplingInterval, 0.0, keepalivetime, 10000, 1, true, 0, 50);
+    ret = insertSubFilter(msg, EDGE_DATACHANGE_TRIGGER_STATUS_VALUE_TIMESTAMP, EDGE_DEADBAND_NONE, 0.0);
+    EXPECT_EQ(ret.code, STATUS_OK);
+    result = sendRequest(msg);
+    EXPECT_EQ(result.code, STATUS_OK);
+    destroyEdgeMessage(msg);
+    sleep(1);
+
+    /* Delete Subscription */
+    msg = createEdgeSubMessage(endpointUri, "{2;S;v=11}Double", 0, Edge_Delete_Sub);
+    EXPECT_EQ(NULL!=msg, true);
+    result = sendRequest(msg);
+    EXPECT_EQ(result.code, STATUS_OK);
+    destroyEdgeMessage(msg);
+    sleep(1);
+}
+
+/* Subscription which queues the samples of a publishing interval and keeps the oldest ones */
+void testSubscriptionQueue_P(char *endpointUri)
+{
+    /* Create Subscription */
+    EdgeMessage* msg = createEdgeSubMessage(endpointUri, "{2;S;v=11}Double", 1, Edge_Create_Sub);
+    EXPECT_EQ(NULL!=msg, true);
+
+    double samplingInterval = 10.0;
+    int keepalivetime = (1 > (int) (ceil(10000.0 / 500.0))) ? 1 : (int) ceil(10000.0 / 500.0);
+    insertSubParameter(&msg, "{2;S;v=11}Double", Edge_Create_Sub, samplingInterval, 500.0, keepalivetime, 10000, 100, true, 0, 20);
+    msg->requests[0]->subMsg->discardPolicy = EDGE_DISCARD_NEWEST;
+
+    EdgeResult result = sendRequest(msg);
+    EXPECT_EQ(result.code, STATUS_OK);
+    destroyEdgeMessage (msg);
+    sleep(2);
+
+    /* Delete Subscription */
+    msg = createEdgeSubMessage(endpointUri, "{2;S;v=11}Double", 0, Edge_Delete_Sub);
+    EXPECT_EQ(NULL!=msg, true);
+    result = sendRequest(msg);
+    EXPECT_EQ(result.code, STATUS_OK);
+    destroyEdgeMessage(msg);
+    sleep(1);
+}
+
+static void subscribeDouble(char *endpointUri, EdgeNodeType subType, double publishingInterval)
+{
+    EdgeMessage* msg = createEdgeSubMessage(endpointUri, "{2;S;v=11}Double", 1, subType);
+    ASSERT_EQ(NULL!=msg, true);
+    insertSubParameter(&msg, "{2;S;v=11}Double", subType, 10.0, publishingInterval, 20, 10000, 100, true, 0, 50);
+    EdgeResult result = sendRequest(msg);
+    EXPECT_EQ(result.code, STATUS_OK);
+    destroyEdgeMessage(msg);
+    sleep(1);
+}
+
+static void unsubscribeDouble(char *endpointUri)
+{
+    EdgeMessage* msg = createEdgeSubMessage(endpointUri, "{2;S;v=11}Double", 0, Edge_Delete_Sub);
+    ASSERT_EQ(NULL!=msg, true);
+    EdgeResult result = sendRequest(msg);
+    EXPECT_EQ(result.code, STATUS_OK);
+    destroyEdgeMessage(msg);
+    sleep(1);
+}
+
+/* Changes the Double node of the server every 50 ms for durationMs,
+ * returns the REPORT messages received meanwhile */
+static int changeDoubleFor(int durationMs, int *responses)
+{
+    int reports = reportCount;
+    int reportResponses = reportResponseCount;
+    EdgeVersatility message;
+    memset(&message, 0, sizeof(EdgeVersatility));
+    double value = 100.0;
+    for (int elapsed = 0; elapsed < durationMs; elapsed += 50)
+    {
+        value += 1.0;
+        message.value = &value;
+        EXPECT_EQ(modifyVariableNode(DEFAULT_NAMESPACE_VALUE, "Double", &message).code, STATUS_OK);
+        usleep(50 * 1000);
+    }
+    /* Reports of the last publishing interval */
+    sleep(1);
+    if (NULL != responses)
+    {
+        *responses = reportResponseCount - reportResponses;
+    }
+    return reportCount - reports;
+}
+
+/* Notifications of one publish response in one REPORT message, or in a message each */
+void testSubscriptionBatchedReports_P(char *endpointUri)
+{
+    setBatchedReports(true);
+    subscribeDouble(endpointUri, Edge_Create_Sub, 500.0);
+
+    int responses = 0;
+    int reports = changeDoubleFor(2000, &responses);
+    EXPECT_GT(reports, 0);
+    EXPECT_LE(reports, 2000 / 500 + 3);
+    EXPECT_GT(responses, reports);
+
+    setBatchedReports(false);
+    reports = changeDoubleFor(2000, &responses);
+    EXPECT_GT(reports, 2000 / 500 + 3);
+    EXPECT_EQ(responses, reports);
+
+    unsubscribeDouble(endpointUri);
+}
+
+/* Publish requests follow the publishing interval, also after it is modified */
+void testSubscriptionPublishInterval_P(char *endpointUri)
+{
+    /* One REPORT message per publish response */
+    setBatchedReports(true);
+    subscribeDouble(endpointUri, Edge_Create_Sub, 200.0);
+    int fastReports = changeDoubleFor(2000, NULL);
+    EXPECT_GE(fastReports, 2000 / 200 / 2);
+
+    subscribeDouble(endpointUri, Edge_Modify_Sub, 1000.0);
+    int slowReports = changeDoubleFor(3000, NULL);
+    EXPECT_GT(slowReports, 0);
+    EXPECT_LE(slowReports, 3000 / 1000 + 2);
+    EXPECT_LT(slowReports, fastReports);
+
+    unsubscribeDouble(endpointUri);
+    setBatchedReports(false);
+}
+
+/* Subscriptions of two sessions are published by the shared publish reactor together */
+void testSubscriptionSessions_P(char *endpointUri, char *secondEndpointUri)
+{
+    EdgeMessage *msg = createEdgeMessage(secondEndpointUri, 0, CMD_START_CLIENT);
+    ASSERT_EQ(NULL!=msg, true);
+    msg->endpointInfo->endpointConfig = (EdgeEndpointConfig *) EdgeCalloc(1, sizeof(EdgeEndpointConfig));
+    ASSERT_EQ(NULL!=msg->endpointInfo->endpointConfig, true);
+    msg->endpointInfo->endpointConfig->requestTimeout = 60000;
+    EXPECT_EQ(sendRequest(msg).code, STATUS_OK);
+    destroyEdgeMessage(msg);
+    sleep(1);
+
+    subscribeDouble(endpointUri, Edge_Create_Sub, 200.0);
+    subscribeDouble(secondEndpointUri, Edge_Create_Sub, 200.0);
+
+    EdgeClientStats first, second;
+    ASSERT_EQ(getClientStats(endpointUri, &first).code, STATUS_OK);
+    ASSERT_EQ(getClientStats(secondEndpointUri, &second).code, STATUS_OK);
+    EXPECT_EQ(first.subscriptionCount, 1);
+    EXPECT_EQ(second.subscriptionCount, 1);
+    uint64_t firstCount = first.notificationCount;
+    uint64_t secondCount = second.notificationCount;
+
+    changeDoubleFor(2000, NULL);
+    EXPECT_EQ(getClientStats(endpointUri, &first).code, STATUS_OK);
+    EXPECT_EQ(getClientStats(secondEndpointUri, &second).code, STATUS_OK);
+    EXPECT_GT(first.notificationCount, firstCount);
+    EXPECT_GT(second.notificationCount, secondCount);
+
+    unsubscribeDouble(secondEndpointUri);
+    unsubscribeDouble(endpointUri);
+
+    msg = createEdgeMessage(secondEndpointUri, 1, CMD_STOP_CLIENT);
+    ASSERT_EQ(NULL!=msg, true);
+    disconnectClient(msg->endpointInfo);
+    destroyEdgeMessage(msg);
+}
+
+void testSubscriptionInvalidFilter(char *endpointUri)
+{
+    EdgeMessage* msg = createEdgeSubMessage(endpointUri, node_arr[0], 1, Edge_Create_Sub);
+    EXPECT_EQ(NULL!=msg, true);
+
+    /* No monitored item is inserted yet */
+    EdgeResult ret = insertSubFilter(msg, EDGE_DATACHANGE_TRIGGER_STATUS_VALUE, EDGE_DEADBAND_ABSOLUTE, 1.0);
+    EXPECT_EQ(ret.code, STATUS_PARAM_INVALID);
+
+    double samplingInterval = 100.0;
+    int keepalivetime = (1 > (int) (ceil(10000.0 / 0.0))) ? 1 : (int) ceil(10000.0 / 0.0);
+    insertSubParameter(&msg, node_arr[0], Edge_Create_Sub, samplingInterval, 0.0, keepalivetime, 10000, 1, true, 0, 50);
+
+    ret = insertSubFilter(NULL, EDGE_DATACHANGE_TRIGGER_STATUS_VALUE, EDGE_DEADBAND_ABSOLUTE, 1.0);
+    EXPECT_EQ(ret.code, STATUS_PARAM_INVALID);
+    ret = insertSubFilter(msg, EDGE_DATACHANGE_TRIGGER_STATUS_VALUE, EDGE_DEADBAND_ABSOLUTE, -1.0);
+    EXPECT_EQ(ret.code, STATUS_PARAM_INVALID);
+    ret = insertSubFilter(msg, EDGE_DATACHANGE_TRIGGER_STATUS_VALUE, EDGE_DEADBAND_PERCENT, 101.0);
+    EXPECT_EQ(ret.code, STATUS_PARAM_INVALID);
+    ret = insertSubFilter(msg, (EdgeDataChangeTrigger) 3, EDGE_DEADBAND_NONE, 0.0);
+    EXPECT_EQ(ret.code, STATUS_PARAM_INVALID);
+    EXPECT_EQ(msg->requests[0]->subMsg->deadbandType, EDGE_DEADBAND_NONE);
+
+    destroyEdgeMessage (msg);
+}
+
 void testSubscriptionWithoutCommand(char *endpointUri)
 {
     /* Create Subscription */
@@ -21,6 +21,7 @@
 #include <gtest/gtest.h>
 
 #include "uqueue.h"
+#include "upriorityqueue.h"
 
 #include "edge_malloc.h"
 
@@ -193,3 +194,178 @@ TEST_F(UQueueF, Reset)
 
     ASSERT_EQ(static_cast<uint32_t>(0), u_queue_get_size(queue));
 }
+
+TEST_F(UQueueF, Order)
+{
+    int values[1000];
+    for (int i = 0; i < 1000; ++i)
+    {
+        values[i] = i;
+        u_queue_message_t *message = CreateQueueMessage(&values[i], sizeof(int));
+        EXPECT_EQ(CA_STATUS_OK, u_queue_add_element(queue, message));
+    }
+
+    for (int i = 0; i < 1000; ++i)
+    {
+        u_queue_message_t *value = u_queue_get_element(queue);
+        ASSERT_TRUE(value != NULL);
+        EXPECT_EQ(i, *(int *) value->msg);
+        EdgeFree(value);
+    }
+    ASSERT_EQ(static_cast<uint32_t>(0), u_queue_get_size(queue));
+    EXPECT_TRUE(u_queue_get_element(queue) == NULL);
+}
+
+TEST_F(UQueueF, AddAfterDrain)
+{
+    int dummy = 0;
+    EXPECT_EQ(CA_STATUS_OK, u_queue_add_element(queue, CreateQueueMessage(&dummy, sizeof(dummy))));
+    EdgeFree(u_queue_get_element(queue));
+    ASSERT_EQ(static_cast<uint32_t>(0), u_queue_get_size(queue));
+
+    EXPECT_EQ(CA_STATUS_OK, u_queue_add_element(queue, CreateQueueMessage(&dummy, sizeof(dummy))));
+    EXPECT_EQ(CA_STATUS_OK, u_queue_add_element(queue, CreateQueueMessage(&dummy, sizeof(dummy))));
+    ASSERT_EQ(static_cast<uint32_t>(2), u_queue_get_size(queue));
+    EXPECT_EQ(CA_STATUS_OK, u_queue_reset(queue));
+    ASSERT_EQ(static_cast<uint32_t>(0), u_queue_get_size(queue));
+}
+
+TEST(UQueue, Capacity)
+{
+    u_queue_t *queue = u_queue_create_with_capacity(16);
+    ASSERT_TRUE(queue != NULL);
+    EXPECT_EQ(static_cast<uint32_t>(16), queue->freeCount);
+
+    int values[32];
+    for (int i = 0; i < 32; ++i)
+    {
+        values[i] = i;
+        EXPECT_EQ(CA_STATUS_OK, u_queue_add_element(queue, CreateQueueMessage(&values[i], sizeof(int))));
+    }
+    EXPECT_EQ(static_cast<uint32_t>(0), queue->freeCount);
+    ASSERT_EQ(static_cast<uint32_t>(32), u_queue_get_size(queue));
+
+    for (int i = 0; i < 32; ++i)
+    {
+        u_queue_message_t *value = u_queue_get_element(queue);
+        ASSERT_TRUE(value != NULL);
+        EXPECT_EQ(i, *(int *) value->msg);
+        EdgeFree(value);
+    }
+    EXPECT_EQ(static_cast<uint32_t>(16), queue->freeCount);
+
+    EXPECT_EQ(CA_STATUS_OK, u_queue_delete(queue));
+}
+
+TEST(UPriorityQueue, HigherLevelFirst)
+{
+    u_priority_queue_t *queue = u_priority_queue_create();
+    ASSERT_TRUE(queue != NULL);
+
+    int values[4] = { 0, 1, 2, 3 };
+    for (int i = U_PRIORITY_QUEUE_LOWEST; i >= 0; --i)
+    {
+        EXPECT_EQ(CA_STATUS_OK, u_priority_queue_add_element(queue,
+                CreateQueueMessage(&values[i], sizeof(int)), i));
+    }
+    // out of range priority is clamped to the lowest level
+    EXPECT_EQ(CA_STATUS_OK, u_priority_queue_add_element(queue,
+            CreateQueueMessage(&values[3], sizeof(int)), 100));
+    ASSERT_EQ(static_cast<uint32_t>(5), u_priority_queue_get_size(queue));
+
+    int expected[5] = { 0, 1, 2, 3, 3 };
+    for (int i = 0; i < 5; ++i)
+    {
+        u_queue_message_t *value = u_priority_queue_get_element(queue);
+        ASSERT_TRUE(value != NULL);
+        EXPECT_EQ(expected[i], *(int *) value->msg);
+        EdgeFree(value);
+    }
+    EXPECT_TRUE(NULL == u_priority_queue_get_element(queue));
+    EXPECT_EQ(static_cast<uint32_t>(0), u_priority_queue_get_size(queue));
+
+    EXPECT_EQ(CA_STATUS_OK, u_priority_queue_delete(queue));
+}
+
+TEST(UPriorityQueue, LowerLevelNotStarved)
+{
+    u_priority_queue_t *queue = u_priority_queue_create();
+    ASSERT_TRUE(queue != NULL);
+
+    int high = 0;
+    int low = 1;
+    int count = U_PRIORITY_QUEUE_STARVATION_LIMIT * 2;
+    for (int i = 0; i < count; ++i)
+    {
+        EXPECT_EQ(CA_STATUS_OK, u_priority_queue_add_element(queue,
+                CreateQueueMessage(&high, sizeof(int)), 0));
+    }
+    EXPECT_EQ(CA_STATUS_OK, u_priority_queue_add_element(queue,
+            CreateQueueMessage(&low, sizeof(int)), U_PRIORITY_QUEUE_LOWEST));
+
+    // the low level message is served once it has been passed over enough
+    for (int i = 0; i <= U_PRIORITY_QUEUE_STARVATION_LIMIT; ++i)
+    {
+        u_queue_message_t *value = u_priority_queue_get_element(queue);
+        ASSERT_TRUE(value != NULL);
+        EXPECT_EQ(i < U_PRIORITY_QUEUE_STARVATION_LIMIT ? high : low, *(int *) value->msg);
+        EdgeFree(value);
+    }
+    ASSERT_EQ(static_cast<uint32_t>(count - U_PRIORITY_QUEUE_STARVATION_LIMIT),
+            u_priority_queue_get_size(queue));
+
+    EXPECT_EQ(CA_STATUS_OK, u_priority_queue_delete(queue));
+}
+
+TEST(UPriorityQueue, InvalidParam)
+{
+    EXPECT_EQ(CA_STATUS_FAILED, u_priority_queue_delete(NULL));
+    EXPECT_EQ(CA_STATUS_FAILED, u_priority_queue_add_element(NULL, NULL, 0));
+    EXPECT_TRUE(NULL == u_priority_queue_get_element(NULL));
+    EXPECT_EQ(static_cast<uint32_t>(0), u_priority_queue_get_size(NULL));
+}
+
+static bool matchValue(const u_queue_message_t *message, void *ctx)
+{
+    return *(int *) message->msg == *(int *) ctx;
+}
+
+TEST_F(UQueueF, FindAndRemoveMatch)
+{
+    int values[4] = { 0, 1, 2, 3 };
+    for (int i = 0; i < 4; ++i)
+    {
+        EXPECT_EQ(CA_STATUS_OK, u_queue_add_element(queue, CreateQueueMessage(&values[i], sizeof(int))));
+    }
+
+    int key = 2;
+    u_queue_message_t *found = u_queue_find_element(queue, matchValue, &key);
+    ASSERT_TRUE(found != NULL);
+    EXPECT_EQ(&values[2], found->msg);
+    ASSERT_EQ(static_cast<uint32_t>(4), u_queue_get_size(queue));
+
+    // remove the tail, then the middle, then the head
+    key = 3;
+    u_queue_message_t *removed = u_queue_remove_match(queue, matchValue, &key);
+    ASSERT_TRUE(removed != NULL);
+    EdgeFree(removed);
+    key = 1;
+    removed = u_queue_remove_match(queue, matchValue, &key);
+    ASSERT_TRUE(removed != NULL);
+    EdgeFree(removed);
+    removed = u_queue_remove_match(queue, NULL, NULL);
+    ASSERT_TRUE(removed != NULL);
+    EXPECT_EQ(&values[0], removed->msg);
+    EdgeFree(removed);
+    EXPECT_TRUE(NULL == u_queue_remove_match(queue, matchValue, &key));
+    ASSERT_EQ(static_cast<uint32_t>(1), u_queue_get_size(queue));
+
+    // tail is still valid after removing the last element
+    EXPECT_EQ(CA_STATUS_OK, u_queue_add_element(queue, CreateQueueMessage(&values[3], sizeof(int))));
+    u_queue_message_t *value = u_queue_get_element(queue);
+    EXPECT_EQ(&values[2], value->msg);
+    EdgeFree(value);
+    value = u_queue_get_element(queue);
+    EXPECT_EQ(&values[3], value->msg);
+    EdgeFree(value);
+}
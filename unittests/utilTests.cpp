@@ -1,659 +1,1782 @@
-/* ****************************************************************
- *
- * Copyright 2017 Samsung Electronics All Rights Reserved.
- *
- *
- *
- * Licensed under the Apache License, Version 2.0 = the "License";
- * you may not use this file except in compliance with the License.
- * You may obtain a copy of the License at
- *
- *      http://www.apache.org/licenses/LICENSE-2.0
- *
- * Unless required by applicable law or agreed to in writing, software
- * distributed under the License is distributed on an "AS IS" BASIS,
- * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
- * See the License for the specific language governing permissions and
- * limitations under the License.
- *
- ******************************************************************/
-
-#include <gtest/gtest.h>
-#include <iostream>
-
-extern "C"
-{
-#include "opcua_manager.h"
-#include "opcua_common.h"
-#include "edge_identifier.h"
-#include "edge_malloc.h"
-#include "edge_utils.h"
-#include "edge_open62541.h"
-#include "edge_list.h"
-#include "edge_map.h"
-#include "uqueue.h"
-#include "uarraylist.h"
-#include "test_common.h"
-}
-
-#define PRINT(str) std::cout<<str<<std::endl
-
-edgeMap *sampleMap;
-
-class OPC_utilMap: public ::testing::Test
-{
-protected:
-
-    virtual void SetUp()
-    {
-        PRINT("MAP TESTS");
-        sampleMap = NULL;
-    }
-
-    virtual void TearDown()
-    {
-
-    }
-
-};
-
-class OPC_util: public ::testing::Test
-{
-protected:
-
-    virtual void SetUp()
-    {
-        PRINT("UTIL TESTS");
-    }
-
-    virtual void TearDown()
-    {
-
-    }
-
-};
-
-//-----------------------------------------------------------------------------
-//  Tests
-//-----------------------------------------------------------------------------
-
-TEST_F(OPC_utilMap , createMap_P)
-{
-    EXPECT_EQ(sampleMap == NULL, true);
-
-    sampleMap = createMap();
-
-    EXPECT_EQ(sampleMap == NULL, false);
-}
-
-TEST_F(OPC_utilMap , insertMapElement_P)
-{
-    sampleMap = createMap();
-
-    insertMapElement(sampleMap, (keyValue) "key1", (keyValue) "value1");
-    EXPECT_EQ(sampleMap->head == NULL, false);
-    insertMapElement(sampleMap, (keyValue) "key2", (keyValue) "value2");
-    insertMapElement(sampleMap, (keyValue) "key6", (keyValue) "value6");
-    insertMapElement(sampleMap, (keyValue) "key3", (keyValue) "value3");
-
-    EXPECT_EQ((char * )getMapElement(sampleMap, (keyValue ) "key1"), "value1");
-    EXPECT_EQ((char * )getMapElement(sampleMap, (keyValue ) "key2"), "value2");
-    EXPECT_EQ((char * )getMapElement(sampleMap, (keyValue ) "key3"), "value3");
-    EXPECT_EQ((char * )getMapElement(sampleMap, (keyValue ) "key6"), "value6");
-
-    deleteMap(sampleMap);
-
-    EXPECT_EQ(sampleMap->head == NULL, true);
-}
-
-TEST_F(OPC_utilMap , insertMapElement_N)
-{
-    sampleMap = createMap();
-
-    EXPECT_NE((char * )getMapElement(sampleMap, (keyValue ) "key1"), "value1");
-    EXPECT_EQ(getMapElement(sampleMap, (keyValue ) "key1") == NULL, true);
-
-    insertMapElement(sampleMap, (keyValue) "key1", (keyValue) "value1");
-    EXPECT_EQ(sampleMap->head == NULL, false);
-    insertMapElement(sampleMap, (keyValue) "key2", (keyValue) "value2");
-    insertMapElement(sampleMap, (keyValue) "key6", (keyValue) "value6");
-    insertMapElement(sampleMap, (keyValue) "key3", (keyValue) "value3");
-
-    EXPECT_NE((char * )getMapElement(sampleMap, (keyValue ) "key4"), "value4");
-    EXPECT_NE((char * )getMapElement(sampleMap, (keyValue ) "key1"), "value2");
-    EXPECT_NE((char * )getMapElement(sampleMap, (keyValue ) "key2"), "value3");
-    EXPECT_EQ((char * )getMapElement(sampleMap, (keyValue ) "key6"), "value6");
-
-    deleteMap(sampleMap);
-
-    EXPECT_NE((char * )getMapElement(sampleMap, (keyValue ) "key1"), "value1");
-    EXPECT_NE((char * )getMapElement(sampleMap, (keyValue ) "key2"), "value2");
-    EXPECT_NE((char * )getMapElement(sampleMap, (keyValue ) "key3"), "value3");
-    EXPECT_NE((char * )getMapElement(sampleMap, (keyValue ) "key6"), "value6");
-
-    EXPECT_EQ(sampleMap->head == NULL, true);
-}
-
-TEST_F(OPC_utilMap , deleteMap_P)
-{
-    sampleMap = createMap();
-
-    EXPECT_EQ(sampleMap == NULL, false);
-
-    deleteMap(sampleMap);
-
-    EXPECT_EQ(sampleMap->head == NULL, true);
-}
-
-TEST_F(OPC_util , cloneString_P)
-{
-    char *retStr = NULL;
-
-    EXPECT_EQ(retStr == NULL, true);
-
-    retStr = cloneString(WELL_KNOWN_DISCOVERY_VALUE);
-    EXPECT_NE(retStr == NULL, true);
-
-    EXPECT_EQ(strcmp(retStr, WELL_KNOWN_DISCOVERY_VALUE), 0);
-
-    free(retStr);
-    retStr = NULL;
-    EXPECT_EQ(retStr == NULL, true);
-}
-
-TEST_F(OPC_util , cloneString_N)
-{
-    char *retStr = NULL;
-    EXPECT_EQ(retStr == NULL, true);
-
-    retStr = cloneString(NULL);
-    ASSERT_EQ(retStr == NULL, true);
-}
-
-TEST_F(OPC_util , cloneData_DataNull)
-{
-    void *retVal = cloneData(NULL, 10);
-    ASSERT_EQ(retVal == NULL, true);
-}
-
-TEST_F(OPC_util , cloneData_ZeroLength)
-{
-    void *retVal = cloneData(WELL_KNOWN_DISCOVERY_VALUE, 0);
-    ASSERT_EQ(retVal == NULL, true);
-}
-
-TEST_F(OPC_util , addListNode_HeadNull)
-{
-    int dummyData = 10;
-    void *data = (void *) &dummyData;
-    ASSERT_EQ(addListNode(NULL, data), false);
-}
-
-TEST_F(OPC_util , addListNode_DataNull)
-{
-    List list;
-    List *head = &list;
-    ASSERT_EQ(addListNode(&head, NULL), false);
-}
-
-TEST_F(OPC_util , getListSize_NullListPointer)
-{
-    ASSERT_EQ(getListSize(NULL), 0);
-}
-
-TEST_F(OPC_util , freeEdgeResult_P)
-{
-    int dummy = 1;
-    EdgeResult *res = (EdgeResult *) EdgeCalloc(1, sizeof(EdgeResult));
-    freeEdgeResult(res);
-
-    // Control should come here. If it comes here, then there is no problem with freeEdgeResult().
-    ASSERT_EQ(dummy==1, true);
-}
-
-TEST_F(OPC_util , freeEdgeVersatility_P)
-{
-    int dummy = 1;
-    EdgeVersatility *versatileValue = (EdgeVersatility *) EdgeCalloc(1, sizeof(EdgeVersatility));
-    ASSERT_EQ(versatileValue  != NULL, true);
-    versatileValue->value = malloc(1);
-    freeEdgeVersatility(versatileValue);
-
-    // Control should come here. If it comes here, then there is no problem with freeEdgeVersatility().
-    ASSERT_EQ(dummy==1, true);
-}
-
-TEST_F(OPC_util , getEdgeNodeIdType_P)
-{
-    ASSERT_EQ(getEdgeNodeIdType('N'), EDGE_INTEGER);
-    ASSERT_EQ(getEdgeNodeIdType('S'), EDGE_STRING);
-    ASSERT_EQ(getEdgeNodeIdType('B'), EDGE_BYTESTRING);
-    ASSERT_EQ(getEdgeNodeIdType('G'), EDGE_UUID);
-    ASSERT_EQ(getEdgeNodeIdType('X'), EDGE_INTEGER); // Random invalid value.
-}
-
-TEST_F(OPC_util , getCharacterNodeIdType_P)
-{
-    ASSERT_EQ(getCharacterNodeIdType(UA_NODEIDTYPE_NUMERIC), 'N');
-    ASSERT_EQ(getCharacterNodeIdType(UA_NODEIDTYPE_STRING), 'S');
-    ASSERT_EQ(getCharacterNodeIdType(UA_NODEIDTYPE_BYTESTRING), 'B');
-    ASSERT_EQ(getCharacterNodeIdType(UA_NODEIDTYPE_GUID), 'G');
-    ASSERT_EQ(getCharacterNodeIdType(21165), '\0'); // Random invalid value.
-}
-
-TEST_F(OPC_util , get_size_P)
-{
-    ASSERT_EQ(get_size(EDGE_NODEID_BOOLEAN, false) != -1, true);
-    ASSERT_EQ(get_size(EDGE_NODEID_SBYTE, false) != -1, true);
-    ASSERT_EQ(get_size(EDGE_NODEID_BYTE, false) != -1, true);
-    ASSERT_EQ(get_size(EDGE_NODEID_INT16, false) != -1, true);
-    ASSERT_EQ(get_size(EDGE_NODEID_UINT16, false) != -1, true);
-    ASSERT_EQ(get_size(EDGE_NODEID_INT32, false) != -1, true);
-    ASSERT_EQ(get_size(EDGE_NODEID_UINT32, false) != -1, true);
-    ASSERT_EQ(get_size(EDGE_NODEID_INT64, false) != -1, true);
-    ASSERT_EQ(get_size(EDGE_NODEID_UINT64, false) != -1, true);
-    ASSERT_EQ(get_size(EDGE_NODEID_FLOAT, false) != -1, true);
-    ASSERT_EQ(get_size(EDGE_NODEID_DOUBLE, false) != -1, true);
-    ASSERT_EQ(get_size(EDGE_NODEID_STRING, false) != -1, true);
-}
-
-TEST_F(OPC_util , cloneEdgeEndpoint_P)
-{
-    EdgeEndPointInfo *retEndpoint = NULL;
-
-    EdgeEndpointConfig *endpointConfig = (EdgeEndpointConfig *) EdgeCalloc(1, sizeof(EdgeEndpointConfig));
-    endpointConfig->bindAddress = "100.100.100.100";
-    endpointConfig->bindPort = 12686;
-    endpointConfig->serverName = (char *) DEFAULT_SERVER_NAME_VALUE;
-
-    EXPECT_EQ(endpointConfig  != NULL, true);
-
-    EdgeApplicationConfig *appConfig = (EdgeApplicationConfig *) EdgeCalloc(1, sizeof(EdgeApplicationConfig));
-    ASSERT_EQ(appConfig  != NULL, true);
-    appConfig->applicationName = copyString(DEFAULT_SERVER_APP_NAME_VALUE);
-    appConfig->applicationUri = copyString(DEFAULT_SERVER_URI_VALUE);
-    appConfig->productUri = copyString(DEFAULT_PRODUCT_URI_VALUE);
-    appConfig->gatewayServerUri = copyString(DEFAULT_SERVER_URI_VALUE);
-    appConfig->discoveryProfileUri  = copyString(DEFAULT_SERVER_URI_VALUE);
-
-    char *discoveryUrls[1] = {copyString(DEFAULT_SERVER_URI_VALUE)};
-    appConfig->discoveryUrlsSize = 1;
-    appConfig->discoveryUrls = discoveryUrls;
-
-    EdgeEndPointInfo *ep = (EdgeEndPointInfo *) EdgeMalloc(sizeof(EdgeEndPointInfo));
-    ep->endpointUri = "opc.tcp://107.108.81.116:12686/edge-opc-server";
-    ep->endpointConfig = endpointConfig;
-    ep->appConfig = appConfig;
-    ep->securityPolicyUri = NULL;
-    ep->transportProfileUri = NULL;
-
-    EXPECT_EQ(ep  != NULL, true);
-
-    EXPECT_EQ(endpointConfig != NULL, true);
-    EXPECT_EQ(appConfig != NULL, true);
-    EXPECT_EQ(ep != NULL, true);
-    EXPECT_EQ(retEndpoint == NULL, true);
-
-    retEndpoint = cloneEdgeEndpointInfo(ep);
-
-    EXPECT_EQ(retEndpoint != NULL, true);
-    EXPECT_EQ(strcmp(retEndpoint->endpointUri, ep->endpointUri), 0);
-    EXPECT_EQ(strcmp(retEndpoint->endpointConfig->bindAddress, endpointConfig->bindAddress), 0);
-    EXPECT_EQ(strcmp(retEndpoint->endpointConfig->bindAddress, endpointConfig->bindAddress), 0);
-    EXPECT_EQ(strcmp(retEndpoint->appConfig->applicationUri, appConfig->applicationUri), 0);
-    EXPECT_EQ(strcmp(retEndpoint->appConfig->productUri, appConfig->productUri), 0);
-    EXPECT_EQ(strcmp(retEndpoint->endpointConfig->serverName, endpointConfig->serverName), 0);
-    EXPECT_EQ(endpointConfig->bindPort, retEndpoint->endpointConfig->bindPort);
-
-    freeEdgeEndpointInfo(retEndpoint);
-    retEndpoint = NULL;
-    free(endpointConfig);
-    endpointConfig = NULL;
-    free(appConfig);
-    appConfig = NULL;
-    free(ep);
-    ep = NULL;
-
-    EXPECT_EQ(endpointConfig == NULL, true);
-    EXPECT_EQ(appConfig == NULL, true);
-    EXPECT_EQ(ep == NULL, true);
-    EXPECT_EQ(retEndpoint == NULL, true);
-
-}
-
-TEST_F(OPC_util , cloneNode_P)
-{
-    EdgeNodeInfo *nodeInfo = (EdgeNodeInfo *) EdgeCalloc(1, sizeof(EdgeNodeInfo));
-    nodeInfo->nodeId = (EdgeNodeId *) EdgeCalloc(1, sizeof(EdgeNodeId));
-    char* nodeName = "String";
-    nodeInfo->valueAlias = (char *) EdgeMalloc(strlen(nodeName) + 1);
-    strcpy(nodeInfo->valueAlias, nodeName);
-    nodeInfo->valueAlias[strlen(nodeName)] = '\0';
-    nodeInfo->methodName = "methodName";
-    nodeInfo->nodeId->type = EDGE_INTEGER;
-    nodeInfo->nodeId->integerNodeId = EDGE_NODEID_ROOTFOLDER;
-    nodeInfo->nodeId->nameSpace = SYSTEM_NAMESPACE_INDEX;
-
-    EdgeNodeInfo *retNodeInfo = NULL;
-
-    EXPECT_EQ(nodeInfo != NULL, true);
-    EXPECT_EQ(retNodeInfo == NULL, true);
-
-    retNodeInfo = cloneEdgeNodeInfo(nodeInfo);
-
-    EXPECT_EQ(retNodeInfo != NULL, true);
-
-    EXPECT_EQ(strcmp(retNodeInfo->valueAlias, nodeInfo->valueAlias), 0);
-    EXPECT_EQ(strcmp(retNodeInfo->methodName, nodeInfo->methodName), 0);
-
-    EXPECT_EQ(nodeInfo->nodeId->type, retNodeInfo->nodeId->type);
-    EXPECT_EQ(nodeInfo->nodeId->integerNodeId, retNodeInfo->nodeId->integerNodeId);
-    EXPECT_EQ(nodeInfo->nodeId->nameSpace, retNodeInfo->nodeId->nameSpace);
-
-    free(nodeInfo->valueAlias);
-    nodeInfo->valueAlias = NULL;
-    free(nodeInfo);
-    nodeInfo = NULL;
-    freeEdgeNodeInfo(retNodeInfo);
-    retNodeInfo = NULL;
-
-    EXPECT_EQ(nodeInfo == NULL, true);
-    EXPECT_EQ(retNodeInfo == NULL, true);
-}
-
-TEST_F(OPC_util , convertUAStringToString_N)
-{
-    char *retStr = NULL;
-    EXPECT_EQ(retStr == NULL, true);
-
-    retStr = convertUAStringToString(NULL);
-    ASSERT_EQ(retStr == NULL, true);
-}
-
-TEST_F(OPC_util , edgeMalloc_P)
-{
-    int *ptr = (int*) EdgeMalloc(sizeof(int) * 5);
-    ASSERT_EQ(NULL != ptr, true);
-    free(ptr);
-}
-
-TEST_F(OPC_util , edgeMalloc_N)
-{
-    int *ptr = (int*) EdgeMalloc(0);
-    ASSERT_EQ(NULL, ptr);
-}
-
-TEST_F(OPC_util , edgeCalloc_P)
-{
-    int *ptr = (int*) EdgeCalloc(5, sizeof(int));
-    ASSERT_EQ(NULL != ptr, true);
-    free(ptr);
-}
-
-TEST_F(OPC_util , edgeCalloc_N1)
-{
-    int *ptr = (int*) EdgeCalloc(0, sizeof(int));
-    ASSERT_EQ(NULL, ptr);
-}
-
-TEST_F(OPC_util , edgeCalloc_N2)
-{
-    int *ptr = (int*) EdgeCalloc(5, 0);
-    ASSERT_EQ(NULL, ptr);
-}
-
-TEST_F(OPC_util , edgeRealloc_P1)
-{
-    int *ptr = (int*) EdgeRealloc(NULL, sizeof(int) * 5);
-    ASSERT_EQ(NULL != ptr, true);
-    free(ptr);
-}
-
-TEST_F(OPC_util , edgeRealloc_P2)
-{
-    int *ptr = (int*) EdgeMalloc(sizeof(int) * 5);
-    ASSERT_EQ(NULL != ptr, true);
-
-    ptr = (int*) EdgeRealloc((void *) ptr, sizeof(int) * 10);
-    ASSERT_EQ(NULL != ptr, true);
-
-    free(ptr);
-}
-
-TEST_F(OPC_util , edgeStringAlloc_P1)
-{
-    Edge_String str = EdgeStringAlloc("COUNTRY");
-    ASSERT_EQ(str.data != NULL, true);
-    EdgeFree(str.data);
-}
-
-TEST_F(OPC_util , edgeStringAlloc_P2)
-{
-    Edge_String str = EdgeStringAlloc("");
-    ASSERT_EQ(str.data == EDGE_EMPTY_ARRAY_SENTINEL, true);
-}
-
-TEST_F(OPC_util , createQueue_P)
-{
-    u_queue_t *queue = u_queue_create();
-    ASSERT_EQ(queue != NULL, true);
-
-    EdgeFree(queue);
-}
-
-TEST_F(OPC_util , getListSize_P)
-{
-    List *head = NULL;
-    int dummyData = 10;
-    ASSERT_TRUE(addListNode(&head, &dummyData));
-    ASSERT_EQ(getListSize(head), 1);
-    EdgeFree(head);
-}
-
-TEST_F(OPC_util , getListSize_N)
-{
-    ASSERT_EQ(getListSize(NULL), 0);
-}
-
-TEST_F(OPC_util , convertToEdgeApplicationType_P)
-{
-    ASSERT_EQ(convertToEdgeApplicationType(UA_APPLICATIONTYPE_SERVER), EDGE_APPLICATIONTYPE_SERVER);
-    ASSERT_EQ(convertToEdgeApplicationType(UA_APPLICATIONTYPE_CLIENT), EDGE_APPLICATIONTYPE_CLIENT);
-    ASSERT_EQ(convertToEdgeApplicationType(UA_APPLICATIONTYPE_CLIENTANDSERVER), EDGE_APPLICATIONTYPE_CLIENTANDSERVER);
-    ASSERT_EQ(convertToEdgeApplicationType(UA_APPLICATIONTYPE_DISCOVERYSERVER), EDGE_APPLICATIONTYPE_DISCOVERYSERVER);
-}
-
-TEST_F(OPC_util , getEdgeNodeIdByteString_P)
-{
-    uint16_t namespaceIdx = 0;
-    const char *str = "Node1";
-    UA_NodeId node = UA_NODEID_BYTESTRING_ALLOC(namespaceIdx, str);
-
-    EdgeNodeId *edgeNode = getEdgeNodeId(&node);
-    ASSERT_TRUE(edgeNode != NULL);
-    ASSERT_TRUE(edgeNode->nameSpace == namespaceIdx);
-    ASSERT_TRUE(edgeNode->type == EDGE_BYTESTRING);
-    ASSERT_TRUE(edgeNode->nodeId != NULL);
-    ASSERT_TRUE(strcmp(edgeNode->nodeId, str) == 0);
-
-    freeEdgeNodeId(edgeNode);
-    EdgeFree(node.identifier.byteString.data);
-}
-
-TEST_F(OPC_util , getEdgeNodeIdGuid_P)
-{
-    uint16_t namespaceIdx = 0;
-    UA_Guid guid = { 1, 0, 1, { 0, 0, 0, 0, 1, 1, 1, 1 } };
-    const char *str = "00000001-0000-0001-0000-000001010101";
-    UA_NodeId node = UA_NODEID_GUID(namespaceIdx, guid);
-
-    EdgeNodeId *edgeNode = getEdgeNodeId(&node);
-    ASSERT_TRUE(edgeNode != NULL);
-    ASSERT_TRUE(edgeNode->nameSpace == namespaceIdx);
-    ASSERT_TRUE(edgeNode->type == EDGE_UUID);
-    ASSERT_TRUE(edgeNode->nodeId != NULL);
-    ASSERT_TRUE(strcmp(edgeNode->nodeId, str) == 0);
-
-    freeEdgeNodeId(edgeNode);
-}
-
-TEST_F(OPC_util , cloneNodeIdByteString_P)
-{
-    uint16_t namespaceIdx = 0;
-    const char *str = "Node1";
-    UA_NodeId node = UA_NODEID_BYTESTRING_ALLOC(namespaceIdx, str);
-    UA_NodeId *clone = cloneNodeId(&node);
-
-    ASSERT_TRUE(clone != NULL);
-    ASSERT_TRUE(clone->namespaceIndex == namespaceIdx);
-    ASSERT_TRUE(clone->identifierType == UA_NODEIDTYPE_BYTESTRING);
-    ASSERT_TRUE(clone->identifier.byteString.data != NULL);
-    ASSERT_TRUE(strncmp((const char *)clone->identifier.byteString.data, str, strlen(str)) == 0);
-
-    UA_NodeId_delete(clone);
-    EdgeFree(node.identifier.byteString.data);
-}
-
-TEST_F(OPC_util , cloneNodeIdGuid_P)
-{
-    uint16_t namespaceIdx = 0;
-    UA_Guid guid = { 1, 0, 1, { 0, 0, 0, 0, 1, 1, 1, 1 } };
-    UA_NodeId node = UA_NODEID_GUID(namespaceIdx, guid);
-    UA_NodeId *clone = cloneNodeId(&node);
-
-    ASSERT_TRUE(clone != NULL);
-    ASSERT_TRUE(clone->namespaceIndex == namespaceIdx);
-    ASSERT_TRUE(clone->identifierType == UA_NODEIDTYPE_GUID);
-    ASSERT_TRUE(UA_Guid_equal(&clone->identifier.guid, &guid));
-
-    UA_NodeId_delete(clone);
-}
-
-// uarraylist.c - Adding unit tests for missed out cases.
-TEST_F(OPC_util , u_arraylist_add_N)
-{
-    int dummyData = 100;
-    ASSERT_FALSE(u_arraylist_add(NULL, &dummyData));
-}
-
-TEST_F(OPC_util , u_arraylist_length_N)
-{
-    ASSERT_EQ(u_arraylist_length(NULL), 0);
-}
-
-TEST_F(OPC_util , u_arraylist_contains_N)
-{
-    ASSERT_FALSE(u_arraylist_contains(NULL, NULL));
-}
-
-TEST_F(OPC_util , u_arraylist_reserve_P)
-{
-    u_arraylist_t  *list = u_arraylist_create(); // List's initial capacity is 1
-    bool ret = u_arraylist_reserve(list, 2); // Increasing the capacity.
-    ASSERT_TRUE(ret);
-    u_arraylist_free(&list);
-}
-
-TEST_F(OPC_util , u_arraylist_shrink_to_fit_P)
-{
-    u_arraylist_t  *list = u_arraylist_create(); // List's initial capacity is 1
-    ASSERT_TRUE(u_arraylist_reserve(list, 2)); // Increasing the capacity.
-
-    int dummyData = 100;
-    ASSERT_TRUE(u_arraylist_add(list, &dummyData)); // Adding an item to increase the length
-    ASSERT_TRUE(u_arraylist_length(list) == 1);
-    u_arraylist_shrink_to_fit(NULL); // No action
-    u_arraylist_shrink_to_fit(list); // Decreases the capacity by 1.
-    ASSERT_TRUE(u_arraylist_length(list) == 1);
-    ASSERT_TRUE(u_arraylist_remove(list, 0) != NULL);
-
-    u_arraylist_free(&list);
-}
-
-TEST_F(OPC_util , u_arraylist_get_N)
-{
-    u_arraylist_t  *list = u_arraylist_create();
-    ASSERT_TRUE(u_arraylist_get(NULL, 0) == NULL);
-    ASSERT_TRUE(u_arraylist_get(list, 0) == NULL);
-    u_arraylist_free(&list);
-}
-
-TEST_F(OPC_util , u_arraylist_get_index_P)
-{
-    u_arraylist_t  *list = u_arraylist_create(); // List's initial capacity is 1
-
-    int dummyData = 100;
-    ASSERT_TRUE(u_arraylist_add(list, &dummyData)); // Adding an item to increase the length
-    ASSERT_TRUE(u_arraylist_length(list) == 1);
-    uint32_t index = 0;
-    ASSERT_TRUE(u_arraylist_get_index(list, &dummyData, &index));
-    ASSERT_TRUE(index == 0);
-    u_arraylist_free(&list);
-}
-
-TEST_F(OPC_util , u_arraylist_get_index_N)
-{
-    u_arraylist_t  *list = u_arraylist_create();
-    int dummyData = 100;
-    uint32_t index = 0;
-    ASSERT_FALSE(u_arraylist_get_index(NULL, &dummyData, &index));
-    ASSERT_FALSE(u_arraylist_get_index(list, NULL, &index));
-    ASSERT_FALSE(u_arraylist_get_index(list, &dummyData, &index));
-    u_arraylist_free(&list);
-}
-
-TEST_F(OPC_util , u_arraylist_destroy_P)
-{
-    u_arraylist_destroy(NULL);
-    u_arraylist_t  *list = u_arraylist_create();
-    int *dummyData = (int *)EdgeMalloc(sizeof(int));
-    ASSERT_TRUE(u_arraylist_add(list, dummyData)); // Adding an item to increase the length
-    ASSERT_TRUE(u_arraylist_length(list) == 1);
-    u_arraylist_destroy(list);
-}
-
-// uqueue.c - Adding unit tests for missed out cases.
-TEST_F(OPC_util , u_queue_add_element_N)
-{
-    u_queue_t queue;
-    u_queue_message_t msg;
-    ASSERT_EQ(u_queue_add_element(NULL, &msg), CA_STATUS_FAILED); // Queue is NULL
-    ASSERT_EQ(u_queue_add_element(&queue, NULL), CA_STATUS_FAILED); // Msg is NULL
-}
-
-TEST_F(OPC_util , u_queue_get_element_N)
-{
-    u_queue_t queue = {NULL, 0};
-    ASSERT_EQ(u_queue_get_element(NULL), (void *)NULL); // Queue is NULL
-    ASSERT_EQ(u_queue_get_element(&queue), (void *)NULL); // Element is NULL
-}
-
-TEST_F(OPC_util , u_queue_remove_element_N)
-{
-    u_queue_t queue = {NULL, 0};
-    ASSERT_EQ(u_queue_remove_element(NULL), CA_STATUS_FAILED); // Queue is NULL
-    ASSERT_EQ(u_queue_remove_element(&queue), CA_STATUS_OK); // Element is NULL
-}
-
-TEST_F(OPC_util , u_queue_get_size_N)
-{
-    ASSERT_EQ(u_queue_get_size(NULL), 0); // Queue is NULL
-}
-
-TEST_F(OPC_util , u_queue_reset_N)
-{
-    ASSERT_EQ(u_queue_reset(NULL), CA_STATUS_FAILED); // Queue is NULL
-}
-
-TEST_F(OPC_util , u_queue_get_head_N)
-{
-    u_queue_t queue = {NULL, 0};
-    ASSERT_EQ(u_queue_get_head(NULL), (void *)NULL); // Queue is NULL
-    ASSERT_EQ(u_queue_get_head(&queue), (void *)NULL); // Element is NULL
-}
-
-/*
- int main(int argc, char **argv) {
- ::testing::InitGoogleTest(&argc, argv);
- return RUN_ALL_TESTS();
- }*/
+/* ****************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ *
+ *
+ * Licensed under the Apache License, Version 2.0 = the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************/
+
+#include <gtest/gtest.h>
+#include <iostream>
+#include <cmath>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+
+extern "C"
+{
+#include "opcua_manager.h"
+#include "opcua_common.h"
+#include "edge_identifier.h"
+#include "edge_malloc.h"
+#include "edge_utils.h"
+#include "edge_logger.h"
+#include "edge_trace.h"
+#include "edge_open62541.h"
+#include "edge_list.h"
+#include "edge_map.h"
+#include "edge_arena.h"
+#include "edge_report_pool.h"
+#include "edge_intern.h"
+#include "edge_hash_map.h"
+#include "value_cache.h"
+#include "read_share.h"
+#include "report_latency.h"
+#include "browse_snapshot.h"
+#include "edge_bulk_convert.h"
+#include "edge_random.h"
+#include "edge_thread_config.h"
+#include "edge_uadp.h"
+#include "report_spool.h"
+#include "cmd_util.h"
+#include "uqueue.h"
+#include "uarraylist.h"
+#include "test_common.h"
+}
+
+#define PRINT(str) std::cout<<str<<std::endl
+
+edgeMap *sampleMap;
+
+class OPC_utilMap: public ::testing::Test
+{
+protected:
+
+    virtual void SetUp()
+    {
+        PRINT("MAP TESTS");
+        sampleMap = NULL;
+    }
+
+    virtual void TearDown()
+    {
+
+    }
+
+};
+
+class OPC_util: public ::testing::Test
+{
+protected:
+
+    virtual void SetUp()
+    {
+        PRINT("UTIL TESTS");
+    }
+
+    virtual void TearDown()
+    {
+
+    }
+
+};
+
+//-----------------------------------------------------------------------------
+//  Tests
+//-----------------------------------------------------------------------------
+
+TEST_F(OPC_utilMap , createMap_P)
+{
+    EXPECT_EQ(sampleMap == NULL, true);
+
+    sampleMap = createMap();
+
+    EXPECT_EQ(sampleMap == NULL, false);
+}
+
+TEST_F(OPC_utilMap , insertMapElement_P)
+{
+    sampleMap = createMap();
+
+    insertMapElement(sampleMap, (keyValue) "key1", (keyValue) "value1");
+    EXPECT_EQ(sampleMap->head == NULL, false);
+    insertMapElement(sampleMap, (keyValue) "key2", (keyValue) "value2");
+    insertMapElement(sampleMap, (keyValue) "key6", (keyValue) "value6");
+    insertMapElement(sampleMap, (keyValue) "key3", (keyValue) "value3");
+
+    EXPECT_EQ((char * )getMapElement(sampleMap, (keyValue ) "key1"), "value1");
+    EXPECT_EQ((char * )getMapElement(sampleMap, (keyValue ) "key2"), "value2");
+    EXPECT_EQ((char * )getMapElement(sampleMap, (keyValue ) "key3"), "value3");
+    EXPECT_EQ((char * )getMapElement(sampleMap, (keyValue ) "key6"), "value6");
+
+    deleteMap(sampleMap);
+
+    EXPECT_EQ(sampleMap->head == NULL, true);
+}
+
+TEST_F(OPC_utilMap , insertMapElement_N)
+{
+    sampleMap = createMap();
+
+    EXPECT_NE((char * )getMapElement(sampleMap, (keyValue ) "key1"), "value1");
+    EXPECT_EQ(getMapElement(sampleMap, (keyValue ) "key1") == NULL, true);
+
+    insertMapElement(sampleMap, (keyValue) "key1", (keyValue) "value1");
+    EXPECT_EQ(sampleMap->head == NULL, false);
+    insertMapElement(sampleMap, (keyValue) "key2", (keyValue) "value2");
+    insertMapElement(sampleMap, (keyValue) "key6", (keyValue) "value6");
+    insertMapElement(sampleMap, (keyValue) "key3", (keyValue) "value3");
+
+    EXPECT_NE((char * )getMapElement(sampleMap, (keyValue ) "key4"), "value4");
+    EXPECT_NE((char * )getMapElement(sampleMap, (keyValue ) "key1"), "value2");
+    EXPECT_NE((char * )getMapElement(sampleMap, (keyValue ) "key2"), "value3");
+    EXPECT_EQ((char * )getMapElement(sampleMap, (keyValue ) "key6"), "value6");
+
+    deleteMap(sampleMap);
+
+    EXPECT_NE((char * )getMapElement(sampleMap, (keyValue ) "key1"), "value1");
+    EXPECT_NE((char * )getMapElement(sampleMap, (keyValue ) "key2"), "value2");
+    EXPECT_NE((char * )getMapElement(sampleMap, (keyValue ) "key3"), "value3");
+    EXPECT_NE((char * )getMapElement(sampleMap, (keyValue ) "key6"), "value6");
+
+    EXPECT_EQ(sampleMap->head == NULL, true);
+}
+
+TEST_F(OPC_utilMap , deleteMap_P)
+{
+    sampleMap = createMap();
+
+    EXPECT_EQ(sampleMap == NULL, false);
+
+    deleteMap(sampleMap);
+
+    EXPECT_EQ(sampleMap->head == NULL, true);
+}
+
+TEST_F(OPC_util , cloneString_P)
+{
+    char *retStr = NULL;
+
+    EXPECT_EQ(retStr == NULL, true);
+
+    retStr = cloneString(WELL_KNOWN_DISCOVERY_VALUE);
+    EXPECT_NE(retStr == NULL, true);
+
+    EXPECT_EQ(strcmp(retStr, WELL_KNOWN_DISCOVERY_VALUE), 0);
+
+    EdgeFree(retStr);
+    retStr = NULL;
+    EXPECT_EQ(retStr == NULL, true);
+}
+
+TEST_F(OPC_util , cloneString_N)
+{
+    char *retStr = NULL;
+    EXPECT_EQ(retStr == NULL, true);
+
+    retStr = cloneString(NULL);
+    ASSERT_EQ(retStr == NULL, true);
+}
+
+TEST_F(OPC_util , cloneData_DataNull)
+{
+    void *retVal = cloneData(NULL, 10);
+    ASSERT_EQ(retVal == NULL, true);
+}
+
+TEST_F(OPC_util , cloneData_ZeroLength)
+{
+    void *retVal = cloneData(WELL_KNOWN_DISCOVERY_VALUE, 0);
+    ASSERT_EQ(retVal == NULL, true);
+}
+
+TEST_F(OPC_util , addListNode_HeadNull)
+{
+    int dummyData = 10;
+    void *data = (void *) &dummyData;
+    ASSERT_EQ(addListNode(NULL, data), false);
+}
+
+TEST_F(OPC_util , addListNode_DataNull)
+{
+    List list;
+    List *head = &list;
+    ASSERT_EQ(addListNode(&head, NULL), false);
+}
+
+TEST_F(OPC_util , getListSize_NullListPointer)
+{
+    ASSERT_EQ(getListSize(NULL), 0);
+}
+
+TEST_F(OPC_util , freeEdgeResult_P)
+{
+    int dummy = 1;
+    EdgeResult *res = (EdgeResult *) EdgeCalloc(1, sizeof(EdgeResult));
+    freeEdgeResult(res);
+
+    // Control should come here. If it comes here, then there is no problem with freeEdgeResult().
+    ASSERT_EQ(dummy==1, true);
+}
+
+TEST_F(OPC_util , freeEdgeVersatility_P)
+{
+    int dummy = 1;
+    EdgeVersatility *versatileValue = (EdgeVersatility *) EdgeCalloc(1, sizeof(EdgeVersatility));
+    ASSERT_EQ(versatileValue  != NULL, true);
+    versatileValue->value = EdgeMalloc(1);
+    freeEdgeVersatility(versatileValue);
+
+    // Control should come here. If it comes here, then there is no problem with freeEdgeVersatility().
+    ASSERT_EQ(dummy==1, true);
+}
+
+TEST_F(OPC_util , getEdgeNodeIdType_P)
+{
+    ASSERT_EQ(getEdgeNodeIdType('N'), EDGE_INTEGER);
+    ASSERT_EQ(getEdgeNodeIdType('S'), EDGE_STRING);
+    ASSERT_EQ(getEdgeNodeIdType('B'), EDGE_BYTESTRING);
+    ASSERT_EQ(getEdgeNodeIdType('G'), EDGE_UUID);
+    ASSERT_EQ(getEdgeNodeIdType('X'), EDGE_INTEGER); // Random invalid value.
+}
+
+TEST_F(OPC_util , getCharacterNodeIdType_P)
+{
+    ASSERT_EQ(getCharacterNodeIdType(UA_NODEIDTYPE_NUMERIC), 'N');
+    ASSERT_EQ(getCharacterNodeIdType(UA_NODEIDTYPE_STRING), 'S');
+    ASSERT_EQ(getCharacterNodeIdType(UA_NODEIDTYPE_BYTESTRING), 'B');
+    ASSERT_EQ(getCharacterNodeIdType(UA_NODEIDTYPE_GUID), 'G');
+    ASSERT_EQ(getCharacterNodeIdType(21165), '\0'); // Random invalid value.
+}
+
+TEST_F(OPC_util , get_size_P)
+{
+    ASSERT_EQ(get_size(EDGE_NODEID_BOOLEAN, false) != -1, true);
+    ASSERT_EQ(get_size(EDGE_NODEID_SBYTE, false) != -1, true);
+    ASSERT_EQ(get_size(EDGE_NODEID_BYTE, false) != -1, true);
+    ASSERT_EQ(get_size(EDGE_NODEID_INT16, false) != -1, true);
+    ASSERT_EQ(get_size(EDGE_NODEID_UINT16, false) != -1, true);
+    ASSERT_EQ(get_size(EDGE_NODEID_INT32, false) != -1, true);
+    ASSERT_EQ(get_size(EDGE_NODEID_UINT32, false) != -1, true);
+    ASSERT_EQ(get_size(EDGE_NODEID_INT64, false) != -1, true);
+    ASSERT_EQ(get_size(EDGE_NODEID_UINT64, false) != -1, true);
+    ASSERT_EQ(get_size(EDGE_NODEID_FLOAT, false) != -1, true);
+    ASSERT_EQ(get_size(EDGE_NODEID_DOUBLE, false) != -1, true);
+    ASSERT_EQ(get_size(EDGE_NODEID_STRING, false) != -1, true);
+}
+
+TEST_F(OPC_util , cloneEdgeEndpoint_P)
+{
+    EdgeEndPointInfo *retEndpoint = NULL;
+
+    EdgeEndpointConfig *endpointConfig = (EdgeEndpointConfig *) EdgeCalloc(1, sizeof(EdgeEndpointConfig));
+    endpointConfig->bindAddress = "100.100.100.100";
+    endpointConfig->bindPort = 12686;
+    endpointConfig->serverName = (char *) DEFAULT_SERVER_NAME_VALUE;
+
+    EXPECT_EQ(endpointConfig  != NULL, true);
+
+    EdgeApplicationConfig *appConfig = (EdgeApplicationConfig *) EdgeCalloc(1, sizeof(EdgeApplicationConfig));
+    ASSERT_EQ(appConfig  != NULL, true);
+    appConfig->applicationName = copyString(DEFAULT_SERVER_APP_NAME_VALUE);
+    appConfig->applicationUri = copyString(DEFAULT_SERVER_URI_VALUE);
+    appConfig->productUri = copyString(DEFAULT_PRODUCT_URI_VALUE);
+    appConfig->gatewayServerUri = copyString(DEFAULT_SERVER_URI_VALUE);
+    appConfig->discoveryProfileUri  = copyString(DEFAULT_SERVER_URI_VALUE);
+
+    char *discoveryUrls[1] = {copyString(DEFAULT_SERVER_URI_VALUE)};
+    appConfig->discoveryUrlsSize = 1;
+    appConfig->discoveryUrls = discoveryUrls;
+
+    EdgeEndPointInfo *ep = (EdgeEndPointInfo *) EdgeMalloc(sizeof(EdgeEndPointInfo));
+    ep->endpointUri = "opc.tcp://107.108.81.116:12686/edge-opc-server";
+    ep->endpointConfig = endpointConfig;
+    ep->appConfig = appConfig;
+    ep->securityPolicyUri = NULL;
+    ep->transportProfileUri = NULL;
+
+    EXPECT_EQ(ep  != NULL, true);
+
+    EXPECT_EQ(endpointConfig != NULL, true);
+    EXPECT_EQ(appConfig != NULL, true);
+    EXPECT_EQ(ep != NULL, true);
+    EXPECT_EQ(retEndpoint == NULL, true);
+
+    retEndpoint = cloneEdgeEndpointInfo(ep);
+
+    EXPECT_EQ(retEndpoint != NULL, true);
+    EXPECT_EQ(strcmp(retEndpoint->endpointUri, ep->endpointUri), 0);
+    EXPECT_EQ(strcmp(retEndpoint->endpointConfig->bindAddress, endpointConfig->bindAddress), 0);
+    EXPECT_EQ(strcmp(retEndpoint->endpointConfig->bindAddress, endpointConfig->bindAddress), 0);
+    EXPECT_EQ(strcmp(retEndpoint->appConfig->applicationUri, appConfig->applicationUri), 0);
+    EXPECT_EQ(strcmp(retEndpoint->appConfig->productUri, appConfig->productUri), 0);
+    EXPECT_EQ(strcmp(retEndpoint->endpointConfig->serverName, endpointConfig->serverName), 0);
+    EXPECT_EQ(endpointConfig->bindPort, retEndpoint->endpointConfig->bindPort);
+
+    freeEdgeEndpointInfo(retEndpoint);
+    retEndpoint = NULL;
+    EdgeFree(endpointConfig);
+    endpointConfig = NULL;
+    EdgeFree(appConfig);
+    appConfig = NULL;
+    EdgeFree(ep);
+    ep = NULL;
+
+    EXPECT_EQ(endpointConfig == NULL, true);
+    EXPECT_EQ(appConfig == NULL, true);
+    EXPECT_EQ(ep == NULL, true);
+    EXPECT_EQ(retEndpoint == NULL, true);
+
+}
+
+TEST_F(OPC_util , cloneNode_P)
+{
+    EdgeNodeInfo *nodeInfo = (EdgeNodeInfo *) EdgeCalloc(1, sizeof(EdgeNodeInfo));
+    nodeInfo->nodeId = (EdgeNodeId *) EdgeCalloc(1, sizeof(EdgeNodeId));
+    char* nodeName = "String";
+    nodeInfo->valueAlias = (char *) EdgeMalloc(strlen(nodeName) + 1);
+    strcpy(nodeInfo->valueAlias, nodeName);
+    nodeInfo->valueAlias[strlen(nodeName)] = '\0';
+    nodeInfo->methodName = "methodName";
+    nodeInfo->nodeId->type = EDGE_INTEGER;
+    nodeInfo->nodeId->integerNodeId = EDGE_NODEID_ROOTFOLDER;
+    nodeInfo->nodeId->nameSpace = SYSTEM_NAMESPACE_INDEX;
+
+    EdgeNodeInfo *retNodeInfo = NULL;
+
+    EXPECT_EQ(nodeInfo != NULL, true);
+    EXPECT_EQ(retNodeInfo == NULL, true);
+
+    retNodeInfo = cloneEdgeNodeInfo(nodeInfo);
+
+    EXPECT_EQ(retNodeInfo != NULL, true);
+
+    EXPECT_EQ(strcmp(retNodeInfo->valueAlias, nodeInfo->valueAlias), 0);
+    EXPECT_EQ(strcmp(retNodeInfo->methodName, nodeInfo->methodName), 0);
+
+    EXPECT_EQ(nodeInfo->nodeId->type, retNodeInfo->nodeId->type);
+    EXPECT_EQ(nodeInfo->nodeId->integerNodeId, retNodeInfo->nodeId->integerNodeId);
+    EXPECT_EQ(nodeInfo->nodeId->nameSpace, retNodeInfo->nodeId->nameSpace);
+
+    EdgeFree(nodeInfo->valueAlias);
+    nodeInfo->valueAlias = NULL;
+    EdgeFree(nodeInfo);
+    nodeInfo = NULL;
+    freeEdgeNodeInfo(retNodeInfo);
+    retNodeInfo = NULL;
+
+    EXPECT_EQ(nodeInfo == NULL, true);
+    EXPECT_EQ(retNodeInfo == NULL, true);
+}
+
+TEST_F(OPC_util , edgeArena_P)
+{
+    EdgeArena arena;
+    ASSERT_EQ(initEdgeArena(&arena, getEdgeArenaSize(sizeof(int)) + getEdgeArenaStringSize("abc")), true);
+    EXPECT_EQ(getEdgeArenaStringSize(NULL), 0);
+
+    int *value = (int *) allocEdgeArena(&arena, sizeof(int));
+    ASSERT_EQ(value != NULL, true);
+    EXPECT_EQ(*value, 0);
+    EXPECT_EQ(((uintptr_t) value) % EDGE_ARENA_ALIGNMENT, 0);
+
+    char *str = cloneStringInArena(&arena, "abc");
+    ASSERT_EQ(str != NULL, true);
+    EXPECT_EQ(strcmp(str, "abc"), 0);
+    EXPECT_EQ(arena.exhausted, false);
+
+    EXPECT_EQ(allocEdgeArena(&arena, 1) == NULL, true);
+    EXPECT_EQ(arena.exhausted, true);
+    EdgeFree(arena.base);
+}
+
+TEST_F(OPC_util , cloneEdgeMessage_P)
+{
+    int values[3] = { 1, 2, 3 };
+    EdgeMessage *msg = createEdgeMessage("opc.tcp://localhost:12686/edge-opc-server", 2, CMD_WRITE);
+    ASSERT_EQ(msg != NULL, true);
+    EXPECT_EQ(insertWriteAccessNodeWithValueType(&msg, "Int32", values, 3, EDGE_NODEID_INT32).code,
+            STATUS_OK);
+    EXPECT_EQ(insertWriteAccessNodeWithValueType(&msg, "String", (void *) "text", 1,
+            EDGE_NODEID_STRING).code, STATUS_OK);
+
+    EdgeMessage *clone = cloneEdgeMessage(msg);
+    ASSERT_EQ(clone != NULL, true);
+    EXPECT_EQ(EDGE_MESSAGE_BLOCK(clone)->isArenaBlock, true);
+    EXPECT_EQ(strcmp(clone->endpointInfo->endpointUri, msg->endpointInfo->endpointUri), 0);
+    ASSERT_EQ(clone->requestLength, 2);
+    EXPECT_EQ(strcmp(clone->requests[1]->nodeInfo->valueAlias, "String"), 0);
+
+    EdgeVersatility *array = (EdgeVersatility *) clone->requests[0]->value;
+    EXPECT_EQ(array->arrayLength, 3);
+    EXPECT_EQ(((int *) array->value)[2], 3);
+    EXPECT_NE(array->value, (void *) values);
+    EXPECT_EQ(strcmp((char *) ((EdgeVersatility *) clone->requests[1]->value)->value, "text"), 0);
+
+    freeEdgeMessage(clone);
+    for (size_t i = 0; i < msg->requestLength; i++)
+    {
+        // values are owned by the test
+        ((EdgeVersatility *) msg->requests[i]->value)->value = NULL;
+    }
+    freeEdgeMessage(msg);
+}
+
+TEST_F(OPC_util , edgeReportPool_P)
+{
+    EdgeEndPointInfo ep;
+    memset(&ep, 0, sizeof(EdgeEndPointInfo));
+    ep.endpointUri = (char *) "opc.tcp://localhost:12686/edge-opc-server";
+    EdgeReportPool *pool = createEdgeReportPool(&ep);
+    ASSERT_EQ(pool != NULL, true);
+
+    const char *int32Alias = internEdgeString("Int32");
+    const char *doubleAlias = internEdgeString("Double");
+    EdgeMessage *report = acquireEdgeReport(pool, int32Alias);
+    ASSERT_EQ(report != NULL, true);
+    EXPECT_EQ(report->type, REPORT);
+    EXPECT_EQ(strcmp(report->endpointInfo->endpointUri, ep.endpointUri), 0);
+    EXPECT_EQ(strcmp(report->responses[0]->nodeInfo->valueAlias, "Int32"), 0);
+
+    int32_t value = 42;
+    EXPECT_EQ(setEdgeReportScalar(report, EDGE_NODEID_INT32, &value, sizeof(int32_t)), true);
+    EXPECT_EQ(*(int32_t *) report->responses[0]->message->value, 42);
+    EXPECT_EQ(setEdgeReportScalar(report, EDGE_NODEID_INT32, &value, EDGE_REPORT_SCALAR_SIZE + 1),
+            false);
+
+    /* released report is handed out again */
+    freeEdgeMessage(report);
+    EdgeMessage *reused = acquireEdgeReport(pool, doubleAlias);
+    EXPECT_EQ(reused, report);
+    EXPECT_EQ(reused->responses[0]->message == NULL, true);
+    EXPECT_EQ(reused->responses[0]->nodeInfo->valueAlias, doubleAlias);
+    freeEdgeMessage(reused);
+    releaseEdgeString(int32Alias);
+    releaseEdgeString(doubleAlias);
+}
+
+TEST_F(OPC_util , internEdgeString_P)
+{
+    char alias[] = "Temperature";
+    size_t count = getEdgeStringCount();
+    const char *first = internEdgeString(alias);
+    ASSERT_EQ(first != NULL, true);
+    EXPECT_EQ(first != alias, true);
+    EXPECT_EQ(strcmp(first, alias), 0);
+    EXPECT_EQ(getEdgeStringCount(), count + 1);
+
+    /* equal strings share one copy */
+    const char *second = internEdgeString("Temperature");
+    EXPECT_EQ(second, first);
+    EXPECT_EQ(lookupEdgeString("Temperature"), first);
+    EXPECT_EQ(retainEdgeString(first), first);
+    EXPECT_EQ(getEdgeStringCount(), count + 1);
+
+    for (int i = 0; i < 4; i++)
+    {
+        releaseEdgeString(first);
+    }
+    EXPECT_EQ(getEdgeStringCount(), count);
+    EXPECT_EQ(lookupEdgeString("Temperature") == NULL, true);
+}
+
+TEST_F(OPC_util , edgeHashMap_P)
+{
+    EdgeHashMap *map = createEdgeHashMap(EDGE_HASH_STRING_KEY);
+    ASSERT_EQ(map != NULL, true);
+
+    char keys[100][16];
+    for (int i = 0; i < 100; i++)
+    {
+        snprintf(keys[i], sizeof(keys[i]), "node%d", i);
+        EXPECT_EQ(insertEdgeHashMapElement(map, (keyValue) keys[i], (keyValue) &keys[i][0]), true);
+    }
+    EXPECT_EQ(getEdgeHashMapSize(map), 100);
+
+    /* duplicate keys are rejected */
+    EXPECT_EQ(insertEdgeHashMapElement(map, (keyValue) "node42", (keyValue) keys[0]), false);
+    EXPECT_EQ(getEdgeHashMapElement(map, (keyValue) "node42"), (keyValue) keys[42]);
+    EXPECT_EQ(getEdgeHashMapElementByString(map, "node421xyz", 6), (keyValue) keys[42]);
+    EXPECT_EQ(getEdgeHashMapElement(map, (keyValue) "node100") == NULL, true);
+
+    keyValue storedKey = NULL;
+    EXPECT_EQ(removeEdgeHashMapElement(map, (keyValue) "node7", &storedKey), (keyValue) keys[7]);
+    EXPECT_EQ(storedKey, (keyValue) keys[7]);
+    EXPECT_EQ(getEdgeHashMapElement(map, (keyValue) "node7") == NULL, true);
+    EXPECT_EQ(getEdgeHashMapSize(map), 99);
+
+    size_t cursor = 0, visited = 0;
+    keyValue key, value;
+    while (getNextEdgeHashMapElement(map, &cursor, &key, &value))
+    {
+        EXPECT_EQ(key, value);
+        visited++;
+    }
+    EXPECT_EQ(visited, 99);
+
+    deleteEdgeHashMap(map);
+}
+
+TEST_F(OPC_util , valueCache_P)
+{
+    int session;
+    UA_Client *client = (UA_Client *) &session;
+    UA_Int32 temperature = 42;
+    UA_DataValue value;
+    UA_DataValue_init(&value);
+    UA_Variant_setScalar(&value.value, &temperature, &UA_TYPES[UA_TYPES_INT32]);
+    value.hasValue = true;
+
+    UA_DataValue cached;
+    UA_DataValue_init(&cached);
+    EXPECT_EQ(getCachedValue(client, 2, "Temperature", 1000, &cached), false);
+
+    EXPECT_EQ(putCachedValue(client, 2, "Temperature", &value), true);
+    EXPECT_EQ(getCachedValue(client, 2, "Temperature", 1000, &cached), true);
+    EXPECT_EQ(*(UA_Int32 *) cached.value.data, 42);
+    UA_DataValue_deleteMembers(&cached);
+
+    /* other namespace, no age allowed */
+    EXPECT_EQ(getCachedValue(client, 3, "Temperature", 1000, &cached), false);
+    EXPECT_EQ(getCachedValue(client, 2, "Temperature", 0, &cached), false);
+
+    temperature = 43;
+    EXPECT_EQ(putCachedValue(client, 2, "Temperature", &value), true);
+    EXPECT_EQ(getCachedValue(client, 2, "Temperature", 1000, &cached), true);
+    EXPECT_EQ(*(UA_Int32 *) cached.value.data, 43);
+    UA_DataValue_deleteMembers(&cached);
+
+    removeValueCache(client);
+    EXPECT_EQ(getCachedValue(client, 2, "Temperature", 1000, &cached), false);
+}
+
+TEST_F(OPC_util , readShare_P)
+{
+    int session;
+    UA_Client *client = (UA_Client *) &session;
+    EdgeMessage *msg = createEdgeAttributeMessage("opc.tcp://localhost:12686/edge-opc-server", 2,
+            CMD_READ);
+    ASSERT_EQ(NULL != msg, true);
+    EXPECT_EQ(insertReadAccessNode(&msg, "Temperature").code, STATUS_OK);
+    EXPECT_EQ(insertReadAccessNode(&msg, "Pressure").code, STATUS_OK);
+
+    /* Reads are not shared by default */
+    char *key = NULL;
+    EXPECT_EQ(shareRead(client, msg, UA_ATTRIBUTEID_VALUE, &key), false);
+    EXPECT_EQ(NULL == key, true);
+
+    setReadSharingImpl(true);
+    EXPECT_EQ(shareRead(client, msg, UA_ATTRIBUTEID_VALUE, &key), false);
+    ASSERT_EQ(NULL != key, true);
+
+    /* An identical read joins the one in flight, a read of another attribute does not */
+    char *other = NULL;
+    EXPECT_EQ(shareRead(client, msg, UA_ATTRIBUTEID_VALUE, &other), true);
+    EXPECT_EQ(NULL == other, true);
+    EXPECT_EQ(shareRead(client, msg, UA_ATTRIBUTEID_MINIMUMSAMPLINGINTERVAL, &other), false);
+    ASSERT_EQ(NULL != other, true);
+
+    EdgeMessage **readers = NULL;
+    size_t count = completeSharedRead(client, key, &readers);
+    ASSERT_EQ(count, (size_t) 1);
+    EXPECT_EQ(readers[0]->message_id, msg->message_id);
+    EXPECT_EQ(readers[0]->requestLength, (size_t) 2);
+    releaseSharedReaders(readers, count);
+    EXPECT_EQ(completeSharedRead(client, other, &readers), (size_t) 0);
+
+    /* A read is sent again once the shared one is complete, the reads of a session end with it */
+    EXPECT_EQ(shareRead(client, msg, UA_ATTRIBUTEID_VALUE, &key), false);
+    ASSERT_EQ(NULL != key, true);
+    removeSharedReads(client);
+    EXPECT_EQ(completeSharedRead(client, key, &readers), (size_t) 0);
+
+    setReadSharingImpl(false);
+    destroyEdgeMessage(msg);
+}
+
+TEST_F(OPC_util , shareEdgeEndpointInfo_P)
+{
+    EdgeEndPointInfo ep;
+    memset(&ep, 0, sizeof(EdgeEndPointInfo));
+    ep.endpointUri = (char *) "opc.tcp://localhost:12686/edge-opc-server";
+
+    EdgeEndPointInfo *shared = shareEdgeEndpointInfo(&ep);
+    ASSERT_EQ(shared != NULL, true);
+    EXPECT_EQ(shared != &ep, true);
+    EXPECT_EQ(strcmp(shared->endpointUri, ep.endpointUri), 0);
+    EXPECT_EQ(((EdgeSharedEndpoint *) shared)->refCount, 1);
+
+    EXPECT_EQ(retainEdgeEndpointInfo(shared), shared);
+    EXPECT_EQ(((EdgeSharedEndpoint *) shared)->refCount, 2);
+
+    releaseEdgeEndpointInfo(shared);
+    EXPECT_EQ(((EdgeSharedEndpoint *) shared)->refCount, 1);
+    releaseEdgeEndpointInfo(shared);
+}
+
+TEST_F(OPC_util , shareMessageEndpointInfo_P)
+{
+    EdgeEndPointInfo ep;
+    memset(&ep, 0, sizeof(EdgeEndPointInfo));
+    ep.endpointUri = (char *) "opc.tcp://localhost:12686/edge-opc-server";
+
+    /* the shared endpoint held by a message only gains a reference */
+    EdgeMessage *msg = allocEdgeMessage();
+    ASSERT_EQ(msg != NULL, true);
+    setMessageEndpointInfo(msg, shareEdgeEndpointInfo(&ep));
+    ASSERT_EQ(msg->endpointInfo != NULL, true);
+    EdgeEndPointInfo *again = shareMessageEndpointInfo(msg);
+    EXPECT_EQ(again, msg->endpointInfo);
+    EXPECT_EQ(((EdgeSharedEndpoint *) again)->refCount, 2);
+    freeEdgeMessage(msg);
+    EXPECT_EQ(((EdgeSharedEndpoint *) again)->refCount, 1);
+    releaseEdgeEndpointInfo(again);
+
+    /* an endpoint owned by the message is copied */
+    msg = createEdgeMessage(ep.endpointUri, 1, CMD_READ);
+    ASSERT_EQ(msg != NULL, true);
+    EdgeEndPointInfo *copy = shareMessageEndpointInfo(msg);
+    ASSERT_EQ(copy != NULL, true);
+    EXPECT_EQ(copy != msg->endpointInfo, true);
+    EXPECT_EQ(strcmp(copy->endpointUri, ep.endpointUri), 0);
+    releaseEdgeEndpointInfo(copy);
+    freeEdgeMessage(msg);
+}
+
+TEST_F(OPC_util , freeApplicationMessage_P)
+{
+    /* messages allocated by the application carry no message block */
+    EdgeMessage *msg = (EdgeMessage *) EdgeCalloc(1, sizeof(EdgeMessage));
+    ASSERT_EQ(msg != NULL, true);
+    EXPECT_EQ(isEdgeMessageBlock(msg), false);
+    msg->endpointInfo = (EdgeEndPointInfo *) EdgeCalloc(1, sizeof(EdgeEndPointInfo));
+    ASSERT_EQ(msg->endpointInfo != NULL, true);
+    msg->endpointInfo->endpointUri = copyString("opc.tcp://localhost:12686/edge-opc-server");
+    msg->request = (EdgeRequest *) EdgeCalloc(1, sizeof(EdgeRequest));
+    ASSERT_EQ(msg->request != NULL, true);
+    freeEdgeMessage(msg);
+
+    msg = allocEdgeMessage();
+    ASSERT_EQ(msg != NULL, true);
+    EXPECT_EQ(isEdgeMessageBlock(msg), true);
+    freeEdgeMessage(msg);
+}
+
+TEST_F(OPC_util , convertUAStringToString_N)
+{
+    char *retStr = NULL;
+    EXPECT_EQ(retStr == NULL, true);
+
+    retStr = convertUAStringToString(NULL);
+    ASSERT_EQ(retStr == NULL, true);
+}
+
+TEST_F(OPC_util , edgeMalloc_P)
+{
+    int *ptr = (int*) EdgeMalloc(sizeof(int) * 5);
+    ASSERT_EQ(NULL != ptr, true);
+    EdgeFree(ptr);
+}
+
+TEST_F(OPC_util , edgeMalloc_N)
+{
+    int *ptr = (int*) EdgeMalloc(0);
+    ASSERT_EQ(NULL, ptr);
+}
+
+static size_t g_hookMallocs = 0;
+static size_t g_hookFrees = 0;
+
+static void *countingMalloc(size_t size)
+{
+    g_hookMallocs++;
+    return malloc(size);
+}
+
+static void countingFree(void *ptr)
+{
+    g_hookFrees++;
+    free(ptr);
+}
+
+TEST_F(OPC_util , edgeSetAllocator_P)
+{
+    EdgeAllocator allocator = { countingMalloc, NULL, realloc, countingFree };
+    ASSERT_EQ(EdgeSetAllocator(&allocator), true);
+    g_hookMallocs = g_hookFrees = 0;
+
+    int *ptr = (int*) EdgeCalloc(4, sizeof(int));
+    ASSERT_EQ(NULL != ptr, true);
+    EXPECT_EQ(ptr[3], 0);
+    EdgeFree(ptr);
+    EXPECT_EQ(EdgeSetAllocator(NULL), true);
+
+    EXPECT_EQ(g_hookMallocs, 1u);
+    EXPECT_EQ(g_hookFrees, 1u);
+}
+
+TEST_F(OPC_util , edgeSetAllocator_N)
+{
+    EdgeAllocator allocator = { countingMalloc, NULL, NULL, countingFree };
+    EXPECT_EQ(EdgeSetAllocator(&allocator), false);
+}
+
+#ifdef ENABLE_MALLOC_STATS
+TEST_F(OPC_util , edgeAllocStats_P)
+{
+    char *ptr = (char*) EdgeMalloc(100);
+    ASSERT_EQ(NULL != ptr, true);
+
+    EdgeAllocStats stats[EDGE_MALLOC_MAX_TAGS];
+    size_t count = EdgeGetAllocStats(stats, EDGE_MALLOC_MAX_TAGS);
+    size_t liveBytes = 0;
+    for (size_t i = 0; i < count; i++)
+    {
+        if (0 == strcmp(stats[i].tag, __FILE__))
+        {
+            liveBytes = stats[i].liveBytes;
+        }
+    }
+    EXPECT_EQ(liveBytes >= 100, true);
+
+    EdgeFree(ptr);
+    count = EdgeGetAllocStats(stats, EDGE_MALLOC_MAX_TAGS);
+    for (size_t i = 0; i < count; i++)
+    {
+        if (0 == strcmp(stats[i].tag, __FILE__))
+        {
+            EXPECT_EQ(stats[i].liveBytes, liveBytes - 100);
+        }
+    }
+}
+#endif
+
+TEST_F(OPC_util , edgeCalloc_P)
+{
+    int *ptr = (int*) EdgeCalloc(5, sizeof(int));
+    ASSERT_EQ(NULL != ptr, true);
+    EdgeFree(ptr);
+}
+
+TEST_F(OPC_util , edgeCalloc_N1)
+{
+    int *ptr = (int*) EdgeCalloc(0, sizeof(int));
+    ASSERT_EQ(NULL, ptr);
+}
+
+TEST_F(OPC_util , edgeCalloc_N2)
+{
+    int *ptr = (int*) EdgeCalloc(5, 0);
+    ASSERT_EQ(NULL, ptr);
+}
+
+TEST_F(OPC_util , edgeRealloc_P1)
+{
+    int *ptr = (int*) EdgeRealloc(NULL, sizeof(int) * 5);
+    ASSERT_EQ(NULL != ptr, true);
+    EdgeFree(ptr);
+}
+
+TEST_F(OPC_util , edgeRealloc_P2)
+{
+    int *ptr = (int*) EdgeMalloc(sizeof(int) * 5);
+    ASSERT_EQ(NULL != ptr, true);
+
+    ptr = (int*) EdgeRealloc((void *) ptr, sizeof(int) * 10);
+    ASSERT_EQ(NULL != ptr, true);
+
+    EdgeFree(ptr);
+}
+
+TEST_F(OPC_util , edgeStringAlloc_P1)
+{
+    Edge_String str = EdgeStringAlloc("COUNTRY");
+    ASSERT_EQ(str.data != NULL, true);
+    EdgeFree(str.data);
+}
+
+TEST_F(OPC_util , edgeStringAlloc_P2)
+{
+    Edge_String str = EdgeStringAlloc("");
+    ASSERT_EQ(str.data == EDGE_EMPTY_ARRAY_SENTINEL, true);
+}
+
+TEST_F(OPC_util , createQueue_P)
+{
+    u_queue_t *queue = u_queue_create();
+    ASSERT_EQ(queue != NULL, true);
+
+    EdgeFree(queue);
+}
+
+TEST_F(OPC_util , getListSize_P)
+{
+    List *head = NULL;
+    int dummyData = 10;
+    ASSERT_TRUE(addListNode(&head, &dummyData));
+    ASSERT_EQ(getListSize(head), 1);
+    EdgeFree(head);
+}
+
+TEST_F(OPC_util , getListSize_N)
+{
+    ASSERT_EQ(getListSize(NULL), 0);
+}
+
+TEST_F(OPC_util , convertToEdgeApplicationType_P)
+{
+    ASSERT_EQ(convertToEdgeApplicationType(UA_APPLICATIONTYPE_SERVER), EDGE_APPLICATIONTYPE_SERVER);
+    ASSERT_EQ(convertToEdgeApplicationType(UA_APPLICATIONTYPE_CLIENT), EDGE_APPLICATIONTYPE_CLIENT);
+    ASSERT_EQ(convertToEdgeApplicationType(UA_APPLICATIONTYPE_CLIENTANDSERVER), EDGE_APPLICATIONTYPE_CLIENTANDSERVER);
+    ASSERT_EQ(convertToEdgeApplicationType(UA_APPLICATIONTYPE_DISCOVERYSERVER), EDGE_APPLICATIONTYPE_DISCOVERYSERVER);
+}
+
+TEST_F(OPC_util , getEdgeNodeIdByteString_P)
+{
+    uint16_t namespaceIdx = 0;
+    const char *str = "Node1";
+    UA_NodeId node = UA_NODEID_BYTESTRING_ALLOC(namespaceIdx, str);
+
+    EdgeNodeId *edgeNode = getEdgeNodeId(&node);
+    ASSERT_TRUE(edgeNode != NULL);
+    ASSERT_TRUE(edgeNode->nameSpace == namespaceIdx);
+    ASSERT_TRUE(edgeNode->type == EDGE_BYTESTRING);
+    ASSERT_TRUE(edgeNode->nodeId != NULL);
+    ASSERT_TRUE(strcmp(edgeNode->nodeId, str) == 0);
+
+    freeEdgeNodeId(edgeNode);
+    EdgeFree(node.identifier.byteString.data);
+}
+
+TEST_F(OPC_util , getEdgeNodeIdGuid_P)
+{
+    uint16_t namespaceIdx = 0;
+    UA_Guid guid = { 1, 0, 1, { 0, 0, 0, 0, 1, 1, 1, 1 } };
+    const char *str = "00000001-0000-0001-0000-000001010101";
+    UA_NodeId node = UA_NODEID_GUID(namespaceIdx, guid);
+
+    EdgeNodeId *edgeNode = getEdgeNodeId(&node);
+    ASSERT_TRUE(edgeNode != NULL);
+    ASSERT_TRUE(edgeNode->nameSpace == namespaceIdx);
+    ASSERT_TRUE(edgeNode->type == EDGE_UUID);
+    ASSERT_TRUE(edgeNode->nodeId != NULL);
+    ASSERT_TRUE(strcmp(edgeNode->nodeId, str) == 0);
+
+    freeEdgeNodeId(edgeNode);
+}
+
+TEST_F(OPC_util , cloneNodeIdByteString_P)
+{
+    uint16_t namespaceIdx = 0;
+    const char *str = "Node1";
+    UA_NodeId node = UA_NODEID_BYTESTRING_ALLOC(namespaceIdx, str);
+    UA_NodeId *clone = cloneNodeId(&node);
+
+    ASSERT_TRUE(clone != NULL);
+    ASSERT_TRUE(clone->namespaceIndex == namespaceIdx);
+    ASSERT_TRUE(clone->identifierType == UA_NODEIDTYPE_BYTESTRING);
+    ASSERT_TRUE(clone->identifier.byteString.data != NULL);
+    ASSERT_TRUE(strncmp((const char *)clone->identifier.byteString.data, str, strlen(str)) == 0);
+
+    UA_NodeId_delete(clone);
+    EdgeFree(node.identifier.byteString.data);
+}
+
+TEST_F(OPC_util , cloneNodeIdGuid_P)
+{
+    uint16_t namespaceIdx = 0;
+    UA_Guid guid = { 1, 0, 1, { 0, 0, 0, 0, 1, 1, 1, 1 } };
+    UA_NodeId node = UA_NODEID_GUID(namespaceIdx, guid);
+    UA_NodeId *clone = cloneNodeId(&node);
+
+    ASSERT_TRUE(clone != NULL);
+    ASSERT_TRUE(clone->namespaceIndex == namespaceIdx);
+    ASSERT_TRUE(clone->identifierType == UA_NODEIDTYPE_GUID);
+    ASSERT_TRUE(UA_Guid_equal(&clone->identifier.guid, &guid));
+
+    UA_NodeId_delete(clone);
+}
+
+// uarraylist.c - Adding unit tests for missed out cases.
+TEST_F(OPC_util , u_arraylist_add_N)
+{
+    int dummyData = 100;
+    ASSERT_FALSE(u_arraylist_add(NULL, &dummyData));
+}
+
+TEST_F(OPC_util , u_arraylist_length_N)
+{
+    ASSERT_EQ(u_arraylist_length(NULL), 0);
+}
+
+TEST_F(OPC_util , u_arraylist_contains_N)
+{
+    ASSERT_FALSE(u_arraylist_contains(NULL, NULL));
+}
+
+TEST_F(OPC_util , u_arraylist_reserve_P)
+{
+    u_arraylist_t  *list = u_arraylist_create(); // List's initial capacity is 1
+    bool ret = u_arraylist_reserve(list, 2); // Increasing the capacity.
+    ASSERT_TRUE(ret);
+    u_arraylist_free(&list);
+}
+
+TEST_F(OPC_util , u_arraylist_shrink_to_fit_P)
+{
+    u_arraylist_t  *list = u_arraylist_create(); // List's initial capacity is 1
+    ASSERT_TRUE(u_arraylist_reserve(list, 2)); // Increasing the capacity.
+
+    int dummyData = 100;
+    ASSERT_TRUE(u_arraylist_add(list, &dummyData)); // Adding an item to increase the length
+    ASSERT_TRUE(u_arraylist_length(list) == 1);
+    u_arraylist_shrink_to_fit(NULL); // No action
+    u_arraylist_shrink_to_fit(list); // Decreases the capacity by 1.
+    ASSERT_TRUE(u_arraylist_length(list) == 1);
+    ASSERT_TRUE(u_arraylist_remove(list, 0) != NULL);
+
+    u_arraylist_free(&list);
+}
+
+TEST_F(OPC_util , u_arraylist_get_N)
+{
+    u_arraylist_t  *list = u_arraylist_create();
+    ASSERT_TRUE(u_arraylist_get(NULL, 0) == NULL);
+    ASSERT_TRUE(u_arraylist_get(list, 0) == NULL);
+    u_arraylist_free(&list);
+}
+
+TEST_F(OPC_util , u_arraylist_get_index_P)
+{
+    u_arraylist_t  *list = u_arraylist_create(); // List's initial capacity is 1
+
+    int dummyData = 100;
+    ASSERT_TRUE(u_arraylist_add(list, &dummyData)); // Adding an item to increase the length
+    ASSERT_TRUE(u_arraylist_length(list) == 1);
+    uint32_t index = 0;
+    ASSERT_TRUE(u_arraylist_get_index(list, &dummyData, &index));
+    ASSERT_TRUE(index == 0);
+    u_arraylist_free(&list);
+}
+
+TEST_F(OPC_util , u_arraylist_get_index_N)
+{
+    u_arraylist_t  *list = u_arraylist_create();
+    int dummyData = 100;
+    uint32_t index = 0;
+    ASSERT_FALSE(u_arraylist_get_index(NULL, &dummyData, &index));
+    ASSERT_FALSE(u_arraylist_get_index(list, NULL, &index));
+    ASSERT_FALSE(u_arraylist_get_index(list, &dummyData, &index));
+    u_arraylist_free(&list);
+}
+
+TEST_F(OPC_util , u_arraylist_destroy_P)
+{
+    u_arraylist_destroy(NULL);
+    u_arraylist_t  *list = u_arraylist_create();
+    int *dummyData = (int *)EdgeMalloc(sizeof(int));
+    ASSERT_TRUE(u_arraylist_add(list, dummyData)); // Adding an item to increase the length
+    ASSERT_TRUE(u_arraylist_length(list) == 1);
+    u_arraylist_destroy(list);
+}
+
+// uqueue.c - Adding unit tests for missed out cases.
+TEST_F(OPC_util , u_queue_add_element_N)
+{
+    u_queue_t queue;
+    u_queue_message_t msg;
+    ASSERT_EQ(u_queue_add_element(NULL, &msg), CA_STATUS_FAILED); // Queue is NULL
+    ASSERT_EQ(u_queue_add_element(&queue, NULL), CA_STATUS_FAILED); // Msg is NULL
+}
+
+TEST_F(OPC_util , u_queue_get_element_N)
+{
+    u_queue_t queue = {NULL, 0};
+    ASSERT_EQ(u_queue_get_element(NULL), (void *)NULL); // Queue is NULL
+    ASSERT_EQ(u_queue_get_element(&queue), (void *)NULL); // Element is NULL
+}
+
+TEST_F(OPC_util , u_queue_remove_element_N)
+{
+    u_queue_t queue = {NULL, 0};
+    ASSERT_EQ(u_queue_remove_element(NULL), CA_STATUS_FAILED); // Queue is NULL
+    ASSERT_EQ(u_queue_remove_element(&queue), CA_STATUS_OK); // Element is NULL
+}
+
+TEST_F(OPC_util , u_queue_get_size_N)
+{
+    ASSERT_EQ(u_queue_get_size(NULL), 0); // Queue is NULL
+}
+
+TEST_F(OPC_util , u_queue_reset_N)
+{
+    ASSERT_EQ(u_queue_reset(NULL), CA_STATUS_FAILED); // Queue is NULL
+}
+
+TEST_F(OPC_util , u_queue_get_head_N)
+{
+    u_queue_t queue = {NULL, 0};
+    ASSERT_EQ(u_queue_get_head(NULL), (void *)NULL); // Queue is NULL
+    ASSERT_EQ(u_queue_get_head(&queue), (void *)NULL); // Element is NULL
+}
+
+TEST_F(OPC_util , report_latency_P)
+{
+    reset_report_latency();
+    set_report_latency(true);
+
+    EdgeResponse first, second;
+    memset(&first, 0, sizeof(EdgeResponse));
+    memset(&second, 0, sizeof(EdgeResponse));
+    int64_t now = get_report_time_us();
+    first.sourceTimestamp = now - 5000;
+    first.serverTimestamp = now - 4995;
+    first.receiveTimestamp = now - 100;
+    /* Server did not set a source timestamp */
+    second.serverTimestamp = now - 3000;
+    second.receiveTimestamp = now - 200;
+    EdgeResponse *responses[2] = { &first, &second };
+
+    EdgeMessage report;
+    memset(&report, 0, sizeof(EdgeMessage));
+    report.type = REPORT;
+    report.message_id = 42;
+    report.responses = responses;
+    report.responseLength = 2;
+    record_report_latency(&report);
+
+    EdgeReportLatency latency;
+    ASSERT_EQ(get_report_latency(42, &latency), true);
+    EXPECT_EQ(latency.stages[EDGE_LATENCY_SERVER].count, 1u);
+    EXPECT_EQ(latency.stages[EDGE_LATENCY_SERVER].histogram[0], 1u); // 5 us
+    EXPECT_EQ(latency.stages[EDGE_LATENCY_NETWORK].count, 2u);
+    EXPECT_EQ(latency.stages[EDGE_LATENCY_DISPATCH].count, 2u);
+    EXPECT_EQ(latency.stages[EDGE_LATENCY_TOTAL].count, 1u);
+    EXPECT_GE(latency.stages[EDGE_LATENCY_TOTAL].maxUs, 5000u);
+    EXPECT_EQ(get_report_latency(43, &latency), false);
+
+    /* Only REPORT messages are recorded */
+    report.type = GENERAL_RESPONSE;
+    record_report_latency(&report);
+    ASSERT_EQ(get_report_latency(42, &latency), true);
+    EXPECT_EQ(latency.stages[EDGE_LATENCY_NETWORK].count, 2u);
+
+    set_report_latency(false);
+    reset_report_latency();
+    EXPECT_EQ(get_report_latency(42, &latency), false);
+}
+
+TEST_F(OPC_util , report_latency_N)
+{
+    set_report_latency(false);
+    EdgeResponse response;
+    memset(&response, 0, sizeof(EdgeResponse));
+    response.receiveTimestamp = get_report_time_us();
+    EdgeResponse *responses[1] = { &response };
+
+    EdgeMessage report;
+    memset(&report, 0, sizeof(EdgeMessage));
+    report.type = REPORT;
+    report.message_id = 7;
+    report.responses = responses;
+    report.responseLength = 1;
+
+    /* Nothing is recorded while disabled */
+    record_report_latency(&report);
+    EdgeReportLatency latency;
+    EXPECT_EQ(get_report_latency(7, &latency), false);
+    EXPECT_EQ(get_report_latency(7, NULL), false);
+    record_report_latency(NULL);
+}
+
+TEST_F(OPC_util , edge_time_info_P)
+{
+    EdgeTimeInfo first;
+    EdgeTimeInfo second;
+    setEdgeTimeInfo(&first);
+    EXPECT_EQ(first.timeInfo, &first.localTime);
+
+    /* The local time is left to the application when disabled */
+    setEdgeLocalTimeEnabled(false);
+    setEdgeTimeInfo(&second);
+    setEdgeLocalTimeEnabled(true);
+    EXPECT_EQ(NULL, second.timeInfo);
+    EXPECT_GE(second.monotonicTime, first.monotonicTime);
+    EXPECT_GE(second.tv.tv_sec, first.tv.tv_sec);
+}
+
+TEST_F(OPC_util , browse_snapshot_P)
+{
+    const char *endpoint = "opc.tcp://localhost:12686/snapshot";
+    const char *path = "browse_snapshot_test.bin";
+    remove(path);
+    EXPECT_EQ(openBrowseSnapshot(endpoint, "server", "request"), (BrowseSnapshot *) NULL);
+    ASSERT_EQ(setBrowseSnapshotPath(endpoint, path), true);
+    EXPECT_EQ(hasBrowseSnapshotPath(endpoint), true);
+
+    /* There is no file yet, so the browse is recorded */
+    BrowseSnapshot *snapshot = openBrowseSnapshot(endpoint, "server", "request");
+    ASSERT_NE(snapshot, (BrowseSnapshot *) NULL);
+    EXPECT_EQ(isBrowseSnapshotLoaded(snapshot), false);
+    BrowseSnapshotReference reference;
+    memset(&reference, 0, sizeof(BrowseSnapshotReference));
+    reference.requestId = 3;
+    reference.srcNodeId.nameSpace = 2;
+    reference.srcNodeId.type = EDGE_STRING;
+    reference.srcNodeId.nodeId = (char *) "Objects";
+    reference.browseName = "Temperature";
+    reference.browsePath = (const unsigned char *) "/Objects/Temperature";
+    reference.valueAlias = "{2;S;v=0}Temperature";
+    EXPECT_EQ(addBrowseSnapshotReference(snapshot, &reference), true);
+    reference.browseName = "Pressure";
+    reference.browsePath = NULL;
+    EXPECT_EQ(addBrowseSnapshotReference(snapshot, &reference), true);
+    EXPECT_EQ(getBrowseSnapshotSize(snapshot), 2u);
+    EXPECT_EQ(saveBrowseSnapshot(snapshot), true);
+    closeBrowseSnapshot(snapshot);
+
+    snapshot = openBrowseSnapshot(endpoint, "server", "request");
+    ASSERT_NE(snapshot, (BrowseSnapshot *) NULL);
+    EXPECT_EQ(isBrowseSnapshotLoaded(snapshot), true);
+    ASSERT_EQ(getBrowseSnapshotSize(snapshot), 2u);
+    BrowseSnapshotReference loaded;
+    ASSERT_EQ(getBrowseSnapshotReference(snapshot, 0, &loaded), true);
+    EXPECT_EQ(loaded.requestId, 3u);
+    EXPECT_EQ(loaded.srcNodeId.nameSpace, 2);
+    EXPECT_EQ(loaded.srcNodeId.type, EDGE_STRING);
+    EXPECT_STREQ(loaded.srcNodeId.nodeId, "Objects");
+    EXPECT_STREQ(loaded.browseName, "Temperature");
+    EXPECT_STREQ((const char *) loaded.browsePath, "/Objects/Temperature");
+    EXPECT_STREQ(loaded.valueAlias, "{2;S;v=0}Temperature");
+    ASSERT_EQ(getBrowseSnapshotReference(snapshot, 1, &loaded), true);
+    EXPECT_STREQ(loaded.browseName, "Pressure");
+    EXPECT_EQ(loaded.browsePath, (const unsigned char *) NULL);
+    EXPECT_EQ(getBrowseSnapshotReference(snapshot, 2, &loaded), false);
+    EXPECT_EQ(addBrowseSnapshotReference(snapshot, &reference), false);
+    closeBrowseSnapshot(snapshot);
+
+    /* A changed server model is browsed again */
+    snapshot = openBrowseSnapshot(endpoint, "server2", "request");
+    ASSERT_NE(snapshot, (BrowseSnapshot *) NULL);
+    EXPECT_EQ(isBrowseSnapshotLoaded(snapshot), false);
+    EXPECT_EQ(getBrowseSnapshotSize(snapshot), 0u);
+    closeBrowseSnapshot(snapshot);
+
+    EXPECT_EQ(setBrowseSnapshotPath(endpoint, NULL), true);
+    EXPECT_EQ(hasBrowseSnapshotPath(endpoint), false);
+    remove(path);
+}
+
+TEST_F(OPC_util , browse_snapshot_N)
+{
+    const char *endpoint = "opc.tcp://localhost:12686/snapshot";
+    const char *path = "browse_snapshot_test.bin";
+    EXPECT_EQ(setBrowseSnapshotPath(NULL, path), false);
+    EXPECT_EQ(hasBrowseSnapshotPath(NULL), false);
+    EXPECT_EQ(openBrowseSnapshot(endpoint, NULL, "request"), (BrowseSnapshot *) NULL);
+    closeBrowseSnapshot(NULL);
+
+    /* A truncated file is not used */
+    FILE *file = fopen(path, "wb");
+    ASSERT_NE(file, (FILE *) NULL);
+    fputs("EDGESNAP", file);
+    fclose(file);
+    ASSERT_EQ(setBrowseSnapshotPath(endpoint, path), true);
+    BrowseSnapshot *snapshot = openBrowseSnapshot(endpoint, "server", "request");
+    ASSERT_NE(snapshot, (BrowseSnapshot *) NULL);
+    EXPECT_EQ(isBrowseSnapshotLoaded(snapshot), false);
+    BrowseSnapshotReference reference;
+    memset(&reference, 0, sizeof(BrowseSnapshotReference));
+    EXPECT_EQ(addBrowseSnapshotReference(snapshot, &reference), false);
+    closeBrowseSnapshot(snapshot);
+
+    EXPECT_EQ(setBrowseSnapshotPath(endpoint, NULL), true);
+    remove(path);
+}
+
+TEST_F(OPC_util , message_id_P)
+{
+    uint32_t previous = EdgeGetMessageId();
+    EXPECT_NE(previous, (uint32_t) 0);
+    for (int i = 0; i < 1000; i++)
+    {
+        uint32_t id = EdgeGetMessageId();
+        EXPECT_NE(id, (uint32_t) 0);
+        EXPECT_NE(id, previous);
+        previous = id;
+    }
+
+    uint32_t first = EdgeGetFastRandom();
+    bool changed = false;
+    for (int i = 0; i < 16; i++)
+    {
+        changed |= (EdgeGetFastRandom() != first);
+    }
+    EXPECT_EQ(changed, true);
+}
+
+TEST_F(OPC_util , type_conversion_P)
+{
+    EXPECT_EQ(getEdgeTypeIndex(&UA_TYPES[UA_TYPES_STRING]), UA_TYPES_STRING);
+    EXPECT_EQ(getEdgeTypeIndex(&UA_TYPES[UA_TYPES_LOCALIZEDTEXT]), UA_TYPES_LOCALIZEDTEXT);
+    EXPECT_EQ(getEdgeTypeIndex(&UA_TYPES[UA_TYPES_DATAVALUE]), -1);
+    EXPECT_EQ(getEdgeTypeIndex(NULL), -1);
+    EXPECT_EQ(get_size(UA_NS0ID_INT32, false), sizeof(int32_t));
+    EXPECT_EQ(get_size(UA_NS0ID_DATETIME, false), sizeof(UA_DateTime));
+    EXPECT_EQ(get_size(UA_NS0ID_INT32, true), sizeof(void *));
+
+    /* Scalar string from the Edge representation to the stack and back */
+    UA_Variant variant;
+    UA_Variant_init(&variant);
+    char text[] = "conversion";
+    ASSERT_EQ(createScalarVariant(UA_TYPES_STRING, text, &variant), UA_STATUSCODE_GOOD);
+    EXPECT_EQ(((UA_String *) variant.data)->length, strlen(text));
+
+    EdgeResponse response;
+    memset(&response, 0, sizeof(EdgeResponse));
+    EdgeVersatility *value = parseResponse(&response, variant);
+    ASSERT_NE(value, (EdgeVersatility *) NULL);
+    EXPECT_EQ(response.type, UA_NS0ID_STRING);
+    EXPECT_STREQ((char *) value->value, text);
+    freeEdgeVersatilityByType(value, response.type);
+    UA_Variant_deleteMembers(&variant);
+
+    /* String array */
+    char first[] = "first", second[] = "second";
+    char *texts[] = { first, second };
+    ASSERT_EQ(createArrayVariant(UA_TYPES_STRING, texts, 2, &variant), UA_STATUSCODE_GOOD);
+    value = parseResponse(&response, variant);
+    ASSERT_NE(value, (EdgeVersatility *) NULL);
+    EXPECT_EQ(value->arrayLength, 2);
+    EXPECT_STREQ(((char **) value->value)[1], second);
+    freeEdgeVersatilityByType(value, response.type);
+    UA_Variant_deleteMembers(&variant);
+
+    /* Plain values are copied as they are */
+    int32_t number = -42;
+    ASSERT_EQ(createScalarVariant(UA_TYPES_INT32, &number, &variant), UA_STATUSCODE_GOOD);
+    value = parseResponse(&response, variant);
+    ASSERT_NE(value, (EdgeVersatility *) NULL);
+    EXPECT_EQ(*((int32_t *) value->value), number);
+    freeEdgeVersatilityByType(value, response.type);
+    UA_Variant_deleteMembers(&variant);
+}
+
+TEST_F(OPC_util , bulk_convert_P)
+{
+    /* An odd length runs both the vector loop and the remaining elements */
+    const size_t count = 19;
+    int16_t samples[count];
+    uint16_t unsignedSamples[count];
+    float values[count];
+    for (size_t i = 0; i < count; i++)
+    {
+        samples[i] = (int16_t) (i * 3000 - 30000);
+        unsignedSamples[i] = (uint16_t) (i * 3400);
+    }
+
+    edgeInt16ToFloat(samples, values, count, 0.5f, 1.0f);
+    for (size_t i = 0; i < count; i++)
+    {
+        EXPECT_FLOAT_EQ(values[i], samples[i] * 0.5f + 1.0f);
+    }
+    edgeUInt16ToFloat(unsignedSamples, values, count, 2.0f, 0.0f);
+    for (size_t i = 0; i < count; i++)
+    {
+        EXPECT_FLOAT_EQ(values[i], unsignedSamples[i] * 2.0f);
+    }
+
+    /* Round trip, with saturation and NaN */
+    int16_t written[count];
+    edgeInt16ToFloat(samples, values, count, 1.0f, 0.0f);
+    values[3] = NAN;
+    values[4] = 1e10f;
+    values[12] = -1e10f;
+    values[13] = 2.5f;
+    edgeFloatToInt16(values, written, count, 1.0f, 0.0f);
+    for (size_t i = 0; i < count; i++)
+    {
+        int16_t expected = samples[i];
+        if (3 == i || 12 == i)
+        {
+            expected = INT16_MIN;
+        }
+        else if (4 == i)
+        {
+            expected = INT16_MAX;
+        }
+        else if (13 == i)
+        {
+            expected = 2;
+        }
+        EXPECT_EQ(written[i], expected);
+    }
+
+    uint16_t words[count];
+    uint32_t longs[count];
+    uint64_t quads[count];
+    for (size_t i = 0; i < count; i++)
+    {
+        words[i] = (uint16_t) (0x0102 + i);
+        longs[i] = 0x01020304u + (uint32_t) i;
+        quads[i] = 0x0102030405060708ull + i;
+    }
+    edgeSwapBytes16(words, count);
+    edgeSwapBytes32(longs, count);
+    edgeSwapBytes64(quads, count);
+    EXPECT_EQ(words[count - 1], 0x1401);
+    EXPECT_EQ(longs[count - 1], 0x16030201u);
+    EXPECT_EQ(quads[count - 1], 0x1a07060504030201ull);
+    edgeSwapBytes64(quads, count);
+    EXPECT_EQ(quads[0], 0x0102030405060708ull);
+
+    int32_t numbers[count];
+    for (size_t i = 0; i < count; i++)
+    {
+        numbers[i] = (int32_t) i - 9;
+    }
+    EXPECT_EQ(edgeConvertArrayToFloat(numbers, EDGE_NODEID_INT32, values, count, 10.0f, 0.0f),
+            true);
+    EXPECT_FLOAT_EQ(values[0], -90.0f);
+    EXPECT_EQ(edgeConvertArrayToFloat(numbers, EDGE_NODEID_STRING, values, count, 1.0f, 0.0f),
+            false);
+    EXPECT_EQ(edgeConvertArrayToFloat(NULL, EDGE_NODEID_INT32, values, count, 1.0f, 0.0f), false);
+}
+
+TEST_F(OPC_util , zero_copy_array_P)
+{
+    int32_t numbers[] = { 1, 2, 3, 4, 5, 6, 7, 8 };
+    UA_Variant variant;
+    UA_Variant_init(&variant);
+    ASSERT_EQ(createArrayVariant(UA_TYPES_INT32, numbers, 8, &variant), UA_STATUSCODE_GOOD);
+
+    /* Below the threshold the array is copied */
+    setZeroCopyArrayBytes(sizeof(numbers) + 1);
+    EdgeResponse response;
+    memset(&response, 0, sizeof(EdgeResponse));
+    EdgeVersatility *value = takeResponse(&response, &variant);
+    ASSERT_NE(value, (EdgeVersatility *) NULL);
+    EXPECT_EQ(value->adopted, false);
+    EXPECT_NE(value->value, variant.data);
+    freeEdgeVersatilityByType(value, response.type);
+
+    /* From the threshold on the buffer of the variant is handed over */
+    setZeroCopyArrayBytes(sizeof(numbers));
+    void *buffer = variant.data;
+    value = takeResponse(&response, &variant);
+    ASSERT_NE(value, (EdgeVersatility *) NULL);
+    EXPECT_EQ(response.type, UA_NS0ID_INT32);
+    EXPECT_EQ(value->adopted, true);
+    EXPECT_EQ(value->value, buffer);
+    EXPECT_EQ(value->arrayLength, 8);
+    EXPECT_EQ(((int32_t *) value->value)[7], 8);
+    EXPECT_EQ(variant.arrayLength, 0);
+    EXPECT_EQ(variant.data, (void *) NULL);
+    UA_Variant_deleteMembers(&variant);
+    freeEdgeVersatilityByType(value, response.type);
+
+    /* Strings are always converted */
+    char first[] = "first", second[] = "second";
+    char *texts[] = { first, second };
+    ASSERT_EQ(createArrayVariant(UA_TYPES_STRING, texts, 2, &variant), UA_STATUSCODE_GOOD);
+    setZeroCopyArrayBytes(1);
+    value = takeResponse(&response, &variant);
+    ASSERT_NE(value, (EdgeVersatility *) NULL);
+    EXPECT_EQ(value->adopted, false);
+    EXPECT_STREQ(((char **) value->value)[1], second);
+    freeEdgeVersatilityByType(value, response.type);
+    UA_Variant_deleteMembers(&variant);
+    setZeroCopyArrayBytes(0);
+}
+
+static std::vector<std::string> g_logMessages;
+
+static void captureLog(const EdgeLogEntry *entry, void *context)
+{
+    EXPECT_EQ(context, (void *) &g_logMessages);
+    /* Threads of other tests may still log */
+    if (std::string(entry->tag) != "utilTests")
+    {
+        return;
+    }
+    g_logMessages.push_back(std::string(entry->tag) + ":" + entry->message);
+}
+
+TEST_F(OPC_util , log_sink_P)
+{
+    int previousLevel = g_edgeLogLevel;
+    g_logMessages.clear();
+    setLogSink(captureLog, &g_logMessages);
+
+    setLogLevel(EDGE_LOG_LEVEL_WARNING);
+    EDGE_LOG_L(EDGE_LOG_LEVEL_DEBUG, "utilTests", "skipped %d", 1);
+    EDGE_LOG_L(EDGE_LOG_LEVEL_ERROR, "utilTests", "logged %d\n", 2);
+    flushLog();
+    ASSERT_EQ(g_logMessages.size(), (size_t) 1);
+    EXPECT_EQ(g_logMessages[0], "utilTests:logged 2");
+
+    /* Records of other threads reach the sink as well */
+    setLogLevel(EDGE_LOG_LEVEL_DEBUG);
+    std::thread writer([]() { EDGE_LOG("utilTests", "from thread"); });
+    writer.join();
+    flushLog();
+    ASSERT_EQ(g_logMessages.size(), (size_t) 2);
+    EXPECT_EQ(g_logMessages[1], "utilTests:from thread");
+
+    setLogSink(NULL, NULL);
+    setLogLevel((EdgeLogLevel) previousLevel);
+}
+
+static std::vector<std::string> g_traceEvents;
+
+static void captureTraceBegin(const EdgeTraceEvent *event, void *context)
+{
+    EXPECT_EQ(context, (void *) &g_traceEvents);
+    g_traceEvents.push_back("begin:" + std::to_string(event->messageId) + ":"
+            + std::to_string(event->stage));
+}
+
+static void captureTraceEnd(const EdgeTraceEvent *event, void *context)
+{
+    EXPECT_EQ(context, (void *) &g_traceEvents);
+    g_traceEvents.push_back("end:" + std::to_string(event->messageId) + ":"
+            + std::to_string(event->stage));
+}
+
+TEST_F(OPC_util , trace_hooks_P)
+{
+    EdgeMessage msg;
+    memset(&msg, 0, sizeof(EdgeMessage));
+    msg.message_id = 42;
+    msg.command = CMD_READ;
+    msg.type = SEND_REQUEST;
+    g_traceEvents.clear();
+
+    /* Disabled by default */
+    EXPECT_FALSE(EDGE_TRACE_ENABLED());
+    EDGE_TRACE_BEGIN(&msg, EDGE_TRACE_STAGE_EXECUTE);
+    EXPECT_EQ(g_traceEvents.size(), (size_t) 0);
+
+    EdgeTraceHooks hooks;
+    hooks.begin = captureTraceBegin;
+    hooks.end = captureTraceEnd;
+    hooks.context = &g_traceEvents;
+    setTraceHooks(&hooks);
+    EXPECT_TRUE(EDGE_TRACE_ENABLED());
+    EDGE_TRACE_BEGIN(&msg, EDGE_TRACE_STAGE_SERVICE);
+    EDGE_TRACE_END(&msg, EDGE_TRACE_STAGE_SERVICE);
+    ASSERT_EQ(g_traceEvents.size(), (size_t) 2);
+    EXPECT_EQ(g_traceEvents[0], "begin:42:" + std::to_string(EDGE_TRACE_STAGE_SERVICE));
+    EXPECT_EQ(g_traceEvents[1], "end:42:" + std::to_string(EDGE_TRACE_STAGE_SERVICE));
+
+    /* One hook is enough */
+    hooks.begin = NULL;
+    setTraceHooks(&hooks);
+    EDGE_TRACE_BEGIN(&msg, EDGE_TRACE_STAGE_CALLBACK);
+    EDGE_TRACE_END(&msg, EDGE_TRACE_STAGE_CALLBACK);
+    ASSERT_EQ(g_traceEvents.size(), (size_t) 3);
+    EXPECT_EQ(g_traceEvents[2], "end:42:" + std::to_string(EDGE_TRACE_STAGE_CALLBACK));
+
+    setTraceHooks(NULL);
+    EXPECT_FALSE(EDGE_TRACE_ENABLED());
+    EDGE_TRACE_END(&msg, EDGE_TRACE_STAGE_CALLBACK);
+    EXPECT_EQ(g_traceEvents.size(), (size_t) 3);
+}
+
+#ifdef __linux__
+TEST_F(OPC_util , threadConfig_P)
+{
+    EdgeThreadConfig configs[EDGE_THREAD_CLASSES];
+    memset(configs, 0, sizeof(configs));
+    configs[EDGE_THREAD_HELPER].name = "opcua-helper-thread";
+    configs[EDGE_THREAD_HELPER].cpuMask = 1;
+    setEdgeThreadConfig(configs);
+
+    char name[16] = {0};
+    int cpuCount = 0;
+    bool firstCpu = false;
+    std::thread worker([&]() {
+        applyEdgeThreadConfig(EDGE_THREAD_HELPER);
+        pthread_getname_np(pthread_self(), name, sizeof(name));
+        cpu_set_t cpus;
+        CPU_ZERO(&cpus);
+        pthread_getaffinity_np(pthread_self(), sizeof(cpus), &cpus);
+        cpuCount = CPU_COUNT(&cpus);
+        firstCpu = CPU_ISSET(0, &cpus);
+    });
+    worker.join();
+
+    /* The name is cut for the number of the thread */
+    EXPECT_EQ(strncmp(name, "opcua-helpe-", 12), 0);
+    EXPECT_EQ(cpuCount, 1);
+    EXPECT_EQ(firstCpu, true);
+
+    /* Other classes keep their default names */
+    setEdgeThreadConfig(NULL);
+    std::thread server([&]() {
+        applyEdgeThreadConfig(EDGE_THREAD_SERVER);
+        pthread_getname_np(pthread_self(), name, sizeof(name));
+    });
+    server.join();
+    EXPECT_EQ(strncmp(name, "edge-server-", 12), 0);
+}
+#endif
+
+TEST_F(OPC_util , uadp_message_P)
+{
+    double temperature = 21.5;
+    int32_t counts[] = { 1, -2, 3 };
+    UA_String name = UA_STRING((char *) "line1");
+    UA_Variant fields[4];
+    UA_Variant_setScalar(&fields[0], &temperature, &UA_TYPES[UA_TYPES_DOUBLE]);
+    UA_Variant_setArray(&fields[1], counts, 3, &UA_TYPES[UA_TYPES_INT32]);
+    UA_Variant_setScalar(&fields[2], &name, &UA_TYPES[UA_TYPES_STRING]);
+    UA_Variant_init(&fields[3]);
+
+    EdgeUadpHeader header = { 1000, 7, 9, 65535, UA_DateTime_now() };
+    uint8_t buffer[EDGE_UADP_DEFAULT_MESSAGE_SIZE];
+    size_t length = encodeUadpMessage(&header, fields, 4, buffer, sizeof(buffer));
+    ASSERT_GT(length, (size_t) 0);
+    uint8_t small[16];
+    EXPECT_EQ(encodeUadpMessage(&header, fields, 4, small, sizeof(small)), (size_t) 0);
+
+    EdgeUadpHeader decoded;
+    UA_Variant values[4];
+    size_t count = 0;
+    EXPECT_NE(decodeUadpMessage(buffer, length, &decoded, values, 3, &count), UA_STATUSCODE_GOOD);
+    EXPECT_EQ(count, (size_t) 0);
+    ASSERT_EQ(decodeUadpMessage(buffer, length, &decoded, values, 4, &count), UA_STATUSCODE_GOOD);
+    ASSERT_EQ(count, (size_t) 4);
+    EXPECT_EQ(decoded.publisherId, (uint64_t) 1000);
+    EXPECT_EQ(decoded.writerGroupId, 7);
+    EXPECT_EQ(decoded.dataSetWriterId, 9);
+    EXPECT_EQ(decoded.sequenceNumber, 65535);
+    EXPECT_EQ(decoded.timestamp, header.timestamp);
+    EXPECT_EQ(*(double *) values[0].data, temperature);
+    ASSERT_EQ(values[1].arrayLength, (size_t) 3);
+    EXPECT_EQ(((int32_t *) values[1].data)[1], -2);
+    EXPECT_TRUE(UA_String_equal((UA_String *) values[2].data, &name));
+    EXPECT_EQ(values[3].type, (const UA_DataType *) NULL);
+    for (size_t i = 0; i < count; i++)
+    {
+        UA_Variant_deleteMembers(&values[i]);
+    }
+
+    /* Truncated messages are rejected */
+    for (size_t i = 0; i < length; i++)
+    {
+        EXPECT_NE(decodeUadpMessage(buffer, i, &decoded, values, 4, &count), UA_STATUSCODE_GOOD);
+    }
+
+    /* Invalid configurations */
+    EdgePubSubConfig config;
+    memset(&config, 0, sizeof(EdgePubSubConfig));
+    const char *aliases[] = { "temperature" };
+    EXPECT_EQ(createPubSubSubscriber(&config, aliases, 1), (EdgeSubscriber *) NULL);
+    config.address = "not an address";
+    EXPECT_EQ(createPubSubSubscriber(&config, aliases, 1), (EdgeSubscriber *) NULL);
+    config.address = "239.0.0.1";
+    EXPECT_EQ(createPubSubSubscriber(&config, aliases, 0), (EdgeSubscriber *) NULL);
+    EXPECT_EQ(createPubSubPublisher(NULL, 1, &config), (EdgePublisher *) NULL);
+    EXPECT_EQ(deletePubSubPublisher(NULL).code, STATUS_PARAM_INVALID);
+}
+
+static EdgeMessage *createSpoolReport(EdgeEndPointInfo *endpointInfo, int32_t count)
+{
+    EdgeMessage *msg = allocEdgeMessage();
+    msg->type = REPORT;
+    msg->message_id = 5;
+    setMessageEndpointInfo(msg, shareEdgeEndpointInfo(endpointInfo));
+    setEdgeTimeInfo(&msg->serverTime);
+    msg->responses = (EdgeResponse **) EdgeCalloc(2, sizeof(EdgeResponse *));
+    msg->responseLength = 2;
+
+    int32_t counts[] = { count, -count };
+    char first[] = "first", second[] = "second";
+    char *texts[] = { first, second };
+    UA_Variant values[2];
+    createArrayVariant(UA_TYPES_INT32, counts, 2, &values[0]);
+    createArrayVariant(UA_TYPES_STRING, texts, 2, &values[1]);
+    const char *aliases[] = { "counts", "texts" };
+    for (int i = 0; i < 2; i++)
+    {
+        EdgeResponse *response = (EdgeResponse *) EdgeCalloc(1, sizeof(EdgeResponse));
+        response->nodeInfo = (EdgeNodeInfo *) EdgeCalloc(1, sizeof(EdgeNodeInfo));
+        response->nodeInfo->valueAlias = cloneString(aliases[i]);
+        response->message = takeResponse(response, &values[i]);
+        response->sourceTimestamp = count;
+        msg->responses[i] = response;
+        UA_Variant_deleteMembers(&values[i]);
+    }
+    return msg;
+}
+
+TEST_F(OPC_util , report_spool_P)
+{
+    const char *path = "edge_report_spool_test.bin";
+    std::remove(path);
+    EdgeEndPointInfo endpointInfo;
+    memset(&endpointInfo, 0, sizeof(EdgeEndPointInfo));
+    endpointInfo.endpointUri = (char *) "opc.tcp://localhost:12686/edge-opc-server";
+
+    EdgeReportSpool *spool = openReportSpool(path, 4096);
+    ASSERT_NE(spool, (EdgeReportSpool *) NULL);
+    EXPECT_EQ(takeReportSpool(spool), (EdgeMessage *) NULL);
+
+    /* Reports are added until the spool is full */
+    int32_t added = 0;
+    for (;;)
+    {
+        EdgeMessage *msg = createSpoolReport(&endpointInfo, added);
+        bool appended = appendReportSpool(spool, msg);
+        freeEdgeMessage(msg);
+        if (!appended)
+        {
+            break;
+        }
+        added++;
+    }
+    ASSERT_GT(added, 1);
+    EXPECT_EQ(getReportSpoolCount(spool), (uint64_t) added);
+
+    /* Taking the first report makes room at the start of the file, the next one wraps */
+    int32_t taken = 0;
+    EdgeMessage *msg = takeReportSpool(spool);
+    ASSERT_NE(msg, (EdgeMessage *) NULL);
+    freeEdgeMessage(msg);
+    taken++;
+    msg = createSpoolReport(&endpointInfo, added);
+    EXPECT_TRUE(appendReportSpool(spool, msg));
+    freeEdgeMessage(msg);
+    added++;
+
+    /* Reports left in the file are taken in order after it is opened again */
+    closeReportSpool(spool);
+    spool = openReportSpool(path, 4096);
+    ASSERT_NE(spool, (EdgeReportSpool *) NULL);
+    EXPECT_EQ(getReportSpoolCount(spool), (uint64_t) (added - taken));
+    for (; taken < added; taken++)
+    {
+        msg = takeReportSpool(spool);
+        ASSERT_NE(msg, (EdgeMessage *) NULL);
+        EXPECT_EQ(msg->type, REPORT);
+        EXPECT_EQ(msg->message_id, 5);
+        EXPECT_STREQ(msg->endpointInfo->endpointUri, endpointInfo.endpointUri);
+        ASSERT_EQ(msg->responseLength, 2);
+        EXPECT_STREQ(msg->responses[0]->nodeInfo->valueAlias, "counts");
+        EXPECT_EQ(msg->responses[0]->sourceTimestamp, taken);
+        EXPECT_EQ(msg->responses[0]->type, UA_NS0ID_INT32);
+        ASSERT_EQ(msg->responses[0]->message->arrayLength, 2);
+        EXPECT_EQ(((int32_t *) msg->responses[0]->message->value)[1], -taken);
+        EXPECT_STREQ(((char **) msg->responses[1]->message->value)[1], "second");
+        freeEdgeMessage(msg);
+    }
+    EXPECT_EQ(takeReportSpool(spool), (EdgeMessage *) NULL);
+    EXPECT_EQ(getReportSpoolCount(spool), (uint64_t) 0);
+
+    /* Other messages are not spooled */
+    EdgeMessage response;
+    memset(&response, 0, sizeof(EdgeMessage));
+    response.type = GENERAL_RESPONSE;
+    EXPECT_FALSE(appendReportSpool(spool, &response));
+    closeReportSpool(spool);
+
+    /* A file of another size starts empty */
+    spool = openReportSpool(path, 8192);
+    ASSERT_NE(spool, (EdgeReportSpool *) NULL);
+    EXPECT_EQ(getReportSpoolCount(spool), (uint64_t) 0);
+    closeReportSpool(spool);
+    EXPECT_EQ(openReportSpool(NULL, 0), (EdgeReportSpool *) NULL);
+    std::remove(path);
+}
+
+TEST_F(OPC_util , shm_transport_P)
+{
+    const char *name = "/edge_shm_transport_test";
+    EdgeEndPointInfo endpointInfo;
+    memset(&endpointInfo, 0, sizeof(EdgeEndPointInfo));
+    endpointInfo.endpointUri = (char *) "opc.tcp://localhost:12686/edge-opc-server";
+
+    EdgeShmPublisher *publisher = createShmPublisher(name, 64 * 1024);
+    ASSERT_NE(publisher, (EdgeShmPublisher *) NULL);
+    EdgeShmConsumer *consumer = openShmConsumer(name);
+    ASSERT_NE(consumer, (EdgeShmConsumer *) NULL);
+    EXPECT_EQ(readShmMessage(consumer, 0), (const EdgeShmMessage *) NULL);
+    EXPECT_EQ(readShmMessage(consumer, 10), (const EdgeShmMessage *) NULL);
+
+    EdgeMessage *msg = createSpoolReport(&endpointInfo, 7);
+    EXPECT_EQ(publishShmMessage(publisher, msg).code, STATUS_OK);
+    freeEdgeMessage(msg);
+
+    const EdgeShmMessage *shmMsg = readShmMessage(consumer, 0);
+    ASSERT_NE(shmMsg, (const EdgeShmMessage *) NULL);
+    EXPECT_EQ(shmMsg->type, (uint32_t) REPORT);
+    EXPECT_EQ(shmMsg->messageId, 5u);
+    EXPECT_STREQ(getShmString(consumer, shmMsg->endpointUri), endpointInfo.endpointUri);
+    ASSERT_EQ(shmMsg->responseCount, 2u);
+
+    const EdgeShmResponse *response = getShmResponse(consumer, 0);
+    ASSERT_NE(response, (const EdgeShmResponse *) NULL);
+    EXPECT_STREQ(getShmString(consumer, response->valueAlias), "counts");
+    EXPECT_EQ(response->type, UA_NS0ID_INT32);
+    EXPECT_EQ(response->valueKind, (uint32_t) EDGE_SHM_VALUE_PLAIN);
+    EXPECT_EQ(response->sourceTimestamp, 7);
+    ASSERT_EQ(response->arrayLength, 2u);
+    const int32_t *counts = (const int32_t *) getShmValue(consumer, response);
+    ASSERT_NE(counts, (const int32_t *) NULL);
+    EXPECT_EQ(counts[1], -7);
+
+    response = getShmResponse(consumer, 1);
+    ASSERT_NE(response, (const EdgeShmResponse *) NULL);
+    EXPECT_EQ(response->valueKind, (uint32_t) EDGE_SHM_VALUE_STRING);
+    const EdgeShmString *texts = (const EdgeShmString *) getShmValue(consumer, response);
+    ASSERT_NE(texts, (const EdgeShmString *) NULL);
+    EXPECT_STREQ(getShmString(consumer, texts[1]), "second");
+    EXPECT_EQ(getShmResponse(consumer, 2), (const EdgeShmResponse *) NULL);
+    EXPECT_TRUE(releaseShmMessage(consumer));
+
+    /* A consumer which falls behind loses the oldest messages */
+    const int32_t published = 2000;
+    for (int32_t i = 0; i < published; i++)
+    {
+        msg = createSpoolReport(&endpointInfo, i);
+        EXPECT_EQ(publishShmMessage(publisher, msg).code, STATUS_OK);
+        freeEdgeMessage(msg);
+    }
+    int32_t read = 0, last = -1;
+    while (IS_NOT_NULL(shmMsg = readShmMessage(consumer, 0)))
+    {
+        response = getShmResponse(consumer, 0);
+        ASSERT_NE(response, (const EdgeShmResponse *) NULL);
+        EXPECT_GT(response->sourceTimestamp, last);
+        last = (int32_t) response->sourceTimestamp;
+        read++;
+    }
+    EXPECT_GT(read, 0);
+    EXPECT_EQ(last, published - 1);
+    EXPECT_EQ(getShmLostCount(consumer) + read, (uint64_t) published);
+
+    closeShmConsumer(consumer);
+    deleteShmPublisher(publisher);
+    EXPECT_EQ(openShmConsumer(name), (EdgeShmConsumer *) NULL);
+    EXPECT_EQ(createShmPublisher(NULL, 0), (EdgeShmPublisher *) NULL);
+}
+
+/*
+ int main(int argc, char **argv) {
+ ::testing::InitGoogleTest(&argc, argv);
+ return RUN_ALL_TESTS();
+ }*/
@@ -31,6 +31,9 @@ extern "C"
 #include "edge_logger.h"
 #include "edge_malloc.h"
 #include "open62541.h"
+#include "request_future.h"
+#include "server_capabilities.h"
+#include "write.h"
 }
 
 #define TAG "writeTest"
@@ -159,6 +162,96 @@ void testWrite_P4(char *endpointUri)
     sleep(1);
 }
 
+// Double writes sent one by one and coalesced into one write request
+void testWriteCoalesced_P(char *endpointUri)
+{
+    EXPECT_EQ(configureWriteCoalescing(4, 0).code, STATUS_PARAM_INVALID);
+    ASSERT_EQ(configureWriteCoalescing(4, 100).code, STATUS_OK);
+
+    double dVal[3] = { 11.1, 22.2, 33.3 };
+    for (int i = 0; i < 3; i++)
+    {
+        EdgeMessage *msg = createEdgeAttributeMessage(endpointUri, 1, CMD_WRITE);
+        EXPECT_EQ(NULL!=msg, true);
+        insertWriteAccessNode(&msg, node_arr[3], (void *) &dVal[i], 1);
+        EdgeResult result = sendRequest(msg);
+        destroyEdgeMessage(msg);
+        ASSERT_EQ(result.code, STATUS_OK);
+    }
+    sleep(1);
+
+    EXPECT_EQ(configureWriteCoalescing(0, 0).code, STATUS_OK);
+}
+
+// Double writes whose successful nodes are not reported
+void testWriteErrorsOnly_P(char *endpointUri)
+{
+    double dVal[3] = { 44.4, 55.5, 66.6 };
+    for (int i = 0; i < 3; i++)
+    {
+        EdgeMessage *msg = createEdgeAttributeMessage(endpointUri, 1, CMD_WRITE);
+        EXPECT_EQ(NULL!=msg, true);
+        msg->writeErrorsOnly = true;
+        insertWriteAccessNode(&msg, node_arr[3], (void *) &dVal[i], 1);
+        EdgeResult result = sendRequest(msg);
+        destroyEdgeMessage(msg);
+        ASSERT_EQ(result.code, STATUS_OK);
+    }
+    sleep(1);
+}
+
+// Five nodes written with MaxNodesPerWrite 2, the results of the three requests are merged
+// in the order of the nodes, so only the read-only node in the second one fails
+void testWriteChunked_P(char *endpointUri)
+{
+    UA_Client *client = UA_Client_new(UA_ClientConfig_default);
+    ASSERT_EQ(NULL != client, true);
+    ASSERT_EQ(UA_Client_connect(client, endpointUri), UA_STATUSCODE_GOOD);
+
+    EdgeServerCapabilities capabilities;
+    getServerCapabilities(client, &capabilities);
+    capabilities.maxNodesPerWrite = 2;
+    ASSERT_EQ(storeServerCapabilities(client, &capabilities), true);
+
+    int num_requests = 5;
+    EdgeMessage *msg = createEdgeAttributeMessage(endpointUri, num_requests, CMD_WRITE);
+    ASSERT_EQ(NULL != msg, true);
+    double dVal = 12.5;
+    int32_t iVal = 12;
+    uint64_t readonlyVal = 13;
+    uint16_t u16Val = 14;
+    uint32_t u32Val = 15;
+    const char *aliases[] = { node_arr[3], node_arr[4], node_arr[27], node_arr[5], node_arr[22] };
+    EXPECT_EQ(insertWriteAccessNode(&msg, node_arr[3], &dVal, 1).code, STATUS_OK);
+    EXPECT_EQ(insertWriteAccessNode(&msg, node_arr[4], &iVal, 1).code, STATUS_OK);
+    EXPECT_EQ(insertWriteAccessNode(&msg, node_arr[27], &readonlyVal, 1).code, STATUS_OK);
+    EXPECT_EQ(insertWriteAccessNode(&msg, node_arr[5], &u16Val, 1).code, STATUS_OK);
+    EXPECT_EQ(insertWriteAccessNode(&msg, node_arr[22], &u32Val, 1).code, STATUS_OK);
+
+    EdgeFuture *future = createRequestFuture(msg->message_id);
+    ASSERT_EQ(NULL != future, true);
+    EXPECT_EQ(executeWrite(client, msg).code, STATUS_OK);
+    finishRequestFuture(msg->message_id);
+    EXPECT_EQ(waitRequestFuture(future, 5000), true);
+
+    ASSERT_EQ(getRequestFutureResponseCount(future), 2);
+    EXPECT_EQ(getRequestFutureResponse(future, 0, false)->type, ERROR_RESPONSE);
+    EdgeMessage *response = getRequestFutureResponse(future, 1, false);
+    EXPECT_EQ(response->type, GENERAL_RESPONSE);
+    ASSERT_EQ(response->responseLength, num_requests - 1);
+    for (int i = 0, node = 0; i < response->responseLength; i++, node++)
+    {
+        node += (2 == node) ? 1 : 0;
+        EXPECT_STREQ(response->responses[i]->nodeInfo->valueAlias, aliases[node]);
+    }
+    deleteRequestFuture(future);
+    destroyEdgeMessage(msg);
+
+    removeServerCapabilities(client);
+    UA_Client_disconnect(client);
+    UA_Client_delete(client);
+}
+
 void testWriteWithoutCommand()
 {
     /* Invalid command type */